@@ -35,6 +35,11 @@ if __name__ == "__main__":
             True,
             "Found crashes in crashes during when converting svg to png.",
         ),
+        (
+            "result_performance.txt",
+            True,
+            "Found performance regressions in loading or drawing the test resources.",
+        ),
     ]
 
     fail_ci = False
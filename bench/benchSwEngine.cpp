@@ -0,0 +1,438 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Microbenchmarks of the sw engine raster kernels.
+ *
+ * Every case builds a fixed scene, so the numbers are comparable among the builds.
+ * The raster cases measure the drawing only (draw + sync) of the prepared paints,
+ * the rle cases measure the preparation only (update + sync) of the transformed paints.
+ * The results are written in JSON for the trend tracking.
+ *
+ * Usage: tvgBenchmarks [--iterations N] [--threads N] [--filter NAME] [--output FILE]
+ */
+
+#include <thorvg.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "config.h"
+
+using namespace tvg;
+using namespace std;
+
+#ifdef THORVG_SW_RASTER_SUPPORT
+
+#define WIDTH 1024
+#define HEIGHT 1024
+
+struct Bench
+{
+    const char* name;
+    const char* group;
+    void (*setup)(SwCanvas* canvas);
+    void (*step)(uint32_t iteration);  //changes the scene for the preparation cases, null for the raster cases
+};
+
+struct Record
+{
+    const Bench* bench;
+    uint32_t iterations;
+    double mean, median, min, max;  //microseconds
+};
+
+
+/************************************************************************/
+/* Scenes                                                               */
+/************************************************************************/
+
+static Shape* target = nullptr;  //the paint transformed by the preparation cases
+
+
+//a deterministic star with many edges, the rle generator spends its time on the crossings
+static Shape* _star(float cx, float cy, float r, uint32_t points)
+{
+    auto shape = Shape::gen();
+    for (uint32_t i = 0; i < points * 2; ++i) {
+        auto radius = (i % 2) ? r * 0.4f : r;
+        auto angle = float(i) * 3.14159265f / float(points);
+        auto x = cx + radius * cosf(angle);
+        auto y = cy + radius * sinf(angle);
+        if (i == 0) shape->moveTo(x, y);
+        else shape->lineTo(x, y);
+    }
+    shape->close();
+    return shape;
+}
+
+
+static Shape* _circles(uint8_t alpha)
+{
+    auto shape = Shape::gen();
+    for (int y = 0; y < 8; ++y) {
+        for (int x = 0; x < 8; ++x) {
+            shape->appendCircle(64.0f + x * 128.0f, 64.0f + y * 128.0f, 60.0f, 60.0f);
+        }
+    }
+    shape->fill(40, 120, 220, alpha);
+    return shape;
+}
+
+
+static Shape* _background()
+{
+    auto bg = Shape::gen();
+    bg->appendRect(0, 0, WIDTH, HEIGHT);
+    bg->fill(230, 200, 60);
+    return bg;
+}
+
+
+static Shape* _maskCircle()
+{
+    auto mask = Shape::gen();
+    mask->appendCircle(WIDTH * 0.5f, HEIGHT * 0.5f, WIDTH * 0.45f, HEIGHT * 0.45f);
+    mask->fill(255, 255, 255, 200);
+    return mask;
+}
+
+
+static void _rleStar(SwCanvas* canvas)
+{
+    target = _star(WIDTH * 0.5f, HEIGHT * 0.5f, WIDTH * 0.48f, 400);
+    target->fill(255, 0, 0);
+    canvas->push(target);
+}
+
+
+static void _rleStroke(SwCanvas* canvas)
+{
+    target = _star(WIDTH * 0.5f, HEIGHT * 0.5f, WIDTH * 0.45f, 100);
+    target->strokeWidth(6.0f);
+    target->strokeJoin(StrokeJoin::Round);
+    target->strokeFill(0, 0, 255);
+    canvas->push(target);
+}
+
+
+static void _rotate(uint32_t iteration)
+{
+    target->rotate(float(iteration % 360));
+}
+
+
+static void _solid(SwCanvas* canvas)
+{
+    canvas->push(_circles(255));
+}
+
+
+static void _translucent(SwCanvas* canvas)
+{
+    canvas->push(_background());
+    canvas->push(_circles(128));
+}
+
+
+static void _masked(SwCanvas* canvas)
+{
+    canvas->push(_background());
+    auto shape = _circles(255);
+    shape->mask(_maskCircle(), MaskMethod::Alpha);
+    canvas->push(shape);
+}
+
+
+static void _matted(SwCanvas* canvas)
+{
+    canvas->push(_background());
+    auto shape = _circles(255);
+    shape->mask(_maskCircle(), MaskMethod::InvLuma);
+    canvas->push(shape);
+}
+
+
+static void _blended(SwCanvas* canvas)
+{
+    canvas->push(_background());
+    auto shape = _circles(200);
+    shape->blend(BlendMethod::Multiply);
+    canvas->push(shape);
+}
+
+
+static void _colorStops(Fill* fill)
+{
+    Fill::ColorStop stops[3] = {{0.0f, 255, 0, 0, 255}, {0.5f, 0, 255, 0, 160}, {1.0f, 0, 0, 255, 255}};
+    fill->colorStops(stops, 3);
+    fill->spread(FillSpread::Reflect);
+}
+
+
+static void _linear(SwCanvas* canvas)
+{
+    auto shape = Shape::gen();
+    shape->appendRect(0, 0, WIDTH, HEIGHT);
+    auto fill = LinearGradient::gen();
+    fill->linear(0, 0, WIDTH * 0.3f, HEIGHT * 0.2f);
+    _colorStops(fill);
+    shape->fill(fill);
+    canvas->push(shape);
+}
+
+
+static void _radial(SwCanvas* canvas)
+{
+    auto shape = Shape::gen();
+    shape->appendRect(0, 0, WIDTH, HEIGHT);
+    auto fill = RadialGradient::gen();
+    fill->radial(WIDTH * 0.5f, HEIGHT * 0.5f, WIDTH * 0.2f, WIDTH * 0.4f, HEIGHT * 0.4f, 0.0f);
+    _colorStops(fill);
+    shape->fill(fill);
+    canvas->push(shape);
+}
+
+
+static vector<uint32_t> pixels;
+
+static Picture* _picture(uint32_t w, uint32_t h)
+{
+    pixels.resize(w * h);
+    for (uint32_t y = 0; y < h; ++y) {
+        for (uint32_t x = 0; x < w; ++x) {
+            pixels[y * w + x] = 0xff000000 | ((x * 255 / w) << 16) | ((y * 255 / h) << 8) | (((x ^ y) & 0xff));
+        }
+    }
+    auto picture = Picture::gen();
+    picture->load(pixels.data(), w, h, ColorSpace::ARGB8888, true);
+    return picture;
+}
+
+
+static void _imageUp(SwCanvas* canvas)
+{
+    auto picture = _picture(256, 256);
+    picture->size(WIDTH, HEIGHT);
+    canvas->push(picture);
+}
+
+
+static void _imageDown(SwCanvas* canvas)
+{
+    auto picture = _picture(2048, 2048);
+    picture->size(WIDTH, HEIGHT);
+    canvas->push(picture);
+}
+
+
+static void _imageRotated(SwCanvas* canvas)
+{
+    auto picture = _picture(512, 512);
+    picture->size(WIDTH * 0.7f, HEIGHT * 0.7f);
+    picture->translate(WIDTH * 0.5f, 0.0f);
+    picture->rotate(45.0f);
+    canvas->push(picture);
+}
+
+
+static Scene* _effectScene()
+{
+    auto scene = Scene::gen();
+    scene->push(_circles(255));
+    return scene;
+}
+
+
+static void _gaussian(SwCanvas* canvas)
+{
+    auto scene = _effectScene();
+    scene->push(SceneEffect::GaussianBlur, 10.0, 0, 0, 100);
+    canvas->push(scene);
+}
+
+
+static void _dropShadow(SwCanvas* canvas)
+{
+    auto scene = _effectScene();
+    scene->push(SceneEffect::DropShadow, 0, 0, 0, 128, 45.0, 10.0, 5.0, 100);
+    canvas->push(scene);
+}
+
+
+static void _tint(SwCanvas* canvas)
+{
+    auto scene = _effectScene();
+    scene->push(SceneEffect::Tint, 0, 0, 0, 255, 255, 255, 50.0);
+    canvas->push(scene);
+}
+
+
+static const Bench benches[] = {
+    {"rle_star", "rle", _rleStar, _rotate},
+    {"rle_stroke", "rle", _rleStroke, _rotate},
+    {"raster_solid", "raster", _solid, nullptr},
+    {"raster_translucent", "raster", _translucent, nullptr},
+    {"raster_masked", "raster", _masked, nullptr},
+    {"raster_matted", "raster", _matted, nullptr},
+    {"raster_blended", "raster", _blended, nullptr},
+    {"gradient_linear", "gradient", _linear, nullptr},
+    {"gradient_radial", "gradient", _radial, nullptr},
+    {"image_upscale", "image", _imageUp, nullptr},
+    {"image_downscale", "image", _imageDown, nullptr},
+    {"image_transform", "image", _imageRotated, nullptr},
+    {"effect_gaussian", "effect", _gaussian, nullptr},
+    {"effect_dropshadow", "effect", _dropShadow, nullptr},
+    {"effect_tint", "effect", _tint, nullptr},
+};
+
+
+/************************************************************************/
+/* Runner                                                               */
+/************************************************************************/
+
+static uint32_t buffer[WIDTH * HEIGHT];
+
+
+static bool _run(const Bench& bench, uint32_t iterations, Record& result)
+{
+    auto canvas = SwCanvas::gen();
+    if (!canvas || canvas->target(buffer, WIDTH, WIDTH, HEIGHT, ColorSpace::ARGB8888) != Result::Success) {
+        delete(canvas);
+        return false;
+    }
+
+    bench.setup(canvas);
+    canvas->update();
+    canvas->draw(true);
+    canvas->sync();
+
+    auto once = [&](uint32_t i) {
+        if (bench.step) {
+            bench.step(i);
+            canvas->update();
+        } else canvas->draw(true);
+        canvas->sync();
+    };
+
+    //warm up the caches and the memory pools
+    for (uint32_t i = 0; i < 3; ++i) once(i);
+
+    vector<double> samples;
+    samples.reserve(iterations);
+
+    for (uint32_t i = 0; i < iterations; ++i) {
+        auto begin = chrono::steady_clock::now();
+        once(i + 1);
+        samples.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - begin).count());
+    }
+
+    delete(canvas);
+    target = nullptr;
+
+    sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (auto s : samples) sum += s;
+
+    result.bench = &bench;
+    result.iterations = iterations;
+    result.mean = sum / iterations;
+    result.median = samples[iterations / 2];
+    result.min = samples.front();
+    result.max = samples.back();
+
+    return true;
+}
+
+
+static void _report(FILE* out, const vector<Record>& results, uint32_t threads, uint32_t iterations)
+{
+    fprintf(out, "{\n");
+    fprintf(out, "  \"engine\": \"sw\",\n");
+    fprintf(out, "  \"width\": %d,\n  \"height\": %d,\n", WIDTH, HEIGHT);
+    fprintf(out, "  \"threads\": %u,\n  \"iterations\": %u,\n", threads, iterations);
+    fprintf(out, "  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        auto& r = results[i];
+        fprintf(out, "    {\"name\": \"%s\", \"group\": \"%s\", \"unit\": \"us\", \"mean\": %.2f, \"median\": %.2f, \"min\": %.2f, \"max\": %.2f}%s\n",
+                r.bench->name, r.bench->group, r.mean, r.median, r.min, r.max, (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+
+int main(int argc, char** argv)
+{
+    uint32_t iterations = 30;
+    uint32_t threads = 0;
+    const char* filter = nullptr;
+    const char* output = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        auto last = (i + 1 == argc);
+        if (!strcmp(argv[i], "--iterations") && !last) iterations = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--threads") && !last) threads = std::max(0, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--filter") && !last) filter = argv[++i];
+        else if (!strcmp(argv[i], "--output") && !last) output = argv[++i];
+        else {
+            fprintf(stderr, "Usage: %s [--iterations N] [--threads N] [--filter NAME] [--output FILE]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (Initializer::init(threads) != Result::Success) return 1;
+
+    vector<Record> results;
+    auto failed = false;
+
+    for (auto& bench : benches) {
+        if (filter && !strstr(bench.name, filter)) continue;
+        Record result;
+        if (_run(bench, iterations, result)) results.push_back(result);
+        else {
+            fprintf(stderr, "%s: failed to run\n", bench.name);
+            failed = true;
+        }
+    }
+
+    Initializer::term();
+
+    auto out = output ? fopen(output, "w") : stdout;
+    if (!out) return 1;
+    _report(out, results, threads, iterations);
+    if (output) fclose(out);
+
+    return failed ? 1 : 0;
+}
+
+#else
+
+int main()
+{
+    fprintf(stderr, "The sw engine is not enabled\n");
+    return 1;
+}
+
+#endif
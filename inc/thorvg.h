@@ -1,6 +1,7 @@
 #ifndef _THORVG_H_
 #define _THORVG_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <list>
@@ -103,7 +104,8 @@ enum class ColorSpace : uint8_t
     ARGB8888,          ///< The channels are joined in the order: alpha, red, green, blue. Colors are alpha-premultiplied.
     ABGR8888S,         ///< The channels are joined in the order: alpha, blue, green, red. Colors are un-alpha-premultiplied. @since 0.12
     ARGB8888S,         ///< The channels are joined in the order: alpha, red, green, blue. Colors are un-alpha-premultiplied. @since 0.12
-    Grayscale8,        ///< One single channel data.
+    Grayscale8,        ///< One single channel data. As a SwCanvas target, the coverage (alpha) of the drawing is written, e.g. for A8 displays.
+    RGB565,            ///< 16 bits packed channels in the order: red(5), green(6), blue(5). The drawing is composed over black. This is only available for the SwCanvas target. (Experimental API)
     Unknown = 255      ///< Unknown channel data. This is reserved for an initial ColorSpace value. @since 1.0
 };
 
@@ -262,6 +264,34 @@ enum class Type : uint8_t
 };
 
 
+/**
+ * @brief Enumeration specifying the subsystems accounted by the memory statistics.
+ *
+ * @see Initializer::memory()
+ * @note Experimental API
+ */
+enum class MemoryCategory : uint8_t
+{
+    Common = 0,   ///< The paints, the fills and the other allocations not belonging to the below.
+    Loader,       ///< The loaders, including the parsed documents and the decoded images.
+    Engine,       ///< The render data of the raster engines, including the memory pool of the software engine.
+    Compositor    ///< The composition buffers and the retained layers of the raster engines.
+};
+
+
+/**
+ * @brief Enumeration specifying how much of the reusable memory the engine releases.
+ *
+ * @see Initializer::trim()
+ * @note Experimental API
+ */
+enum class TrimLevel : uint8_t
+{
+    Pools = 0,    ///< The working memory pools of the raster engines and their idle composition targets.
+    Caches        ///< The pools along with the caches: the retained decoded images, the retained vector documents (see Picture::cache()) and the rasterized glyphs.
+};
+
+
 /**
  * @brief A data structure representing a point in two-dimensional space.
  */
@@ -286,6 +316,59 @@ struct Matrix
 };
 
 
+/**
+ * @brief A set of the user memory functions replacing the system allocator.
+ *
+ * All the functions are mandatory and must be thread-safe when the engine runs with the worker threads.
+ * The @c data is passed back to every call as given.
+ *
+ * @see Initializer::init()
+ * @note Experimental API
+ */
+struct Allocator
+{
+    void* (*alloc)(size_t size, void* data);                 ///< Allocates @p size bytes aligned for any type.
+    void* (*realloc)(void* ptr, size_t size, void* data);    ///< Resizes the block, @p ptr may be @c nullptr.
+    void (*free)(void* ptr, void* data);                     ///< Releases the block, @p ptr may be @c nullptr.
+    void* data;                                              ///< The user data.
+};
+
+
+/**
+ * @brief The placement and the idle behavior of the worker threads.
+ *
+ * The unsupported controls on the running system are ignored, as well as the requests the system refuses,
+ * e.g. raising the priority without the privilege.
+ *
+ * @see Initializer::init(uint32_t threads, const ThreadOptions& options)
+ * @note Experimental API
+ */
+struct ThreadOptions
+{
+    const uint32_t* cores = nullptr;   ///< The cpu indices the workers are pinned to in turn. @c nullptr lets the system place them.
+    uint32_t coreCnt = 0;              ///< The number of the @c cores.
+    int32_t priority = 0;              ///< The scheduling priority relative to the default one. A positive value raises it, a negative one lowers it.
+    uint32_t spin = 0;                 ///< The time in microseconds an idle worker keeps looking for the new tasks before it sleeps. 0 sleeps at once.
+};
+
+
+/**
+ * @brief A host job system running the engine tasks in place of the built-in worker threads.
+ *
+ * The engine hands over up to @c threads jobs at once, each of them runs the queued tasks until none is left and returns.
+ * The jobs may be executed on any thread in any order, but must not run in place of the @c submit call.
+ *
+ * @see Initializer::init(const Executor& executor)
+ * @note Experimental API
+ */
+struct Executor
+{
+    void (*submit)(void (*job)(void* arg), void* arg, void* data);  ///< Schedules the @p job to be called with the @p arg once on a thread of the host.
+    uint32_t threads;                                               ///< The number of the jobs allowed in flight at once, from 1 to 63. It decides the parallelism of the engine like the worker threads do.
+    void* data;                                                     ///< The user data.
+};
+
+
 /**
  * @class Paint
  *
@@ -437,6 +520,26 @@ public:
      */
     Result bounds(Point* pt4) const noexcept;
 
+    /**
+     * @brief Checks whether the drawing of the paint covers any pixel of the given region in canvas space.
+     *
+     * The test reuses the render data prepared by the last Canvas::update(), so no path is rasterized again.
+     * The software raster engine checks the exact coverage of the fills and the strokes,
+     * while the other engines and the transformed images are tested by their bounding regions.
+     *
+     * @param[in] x The x-coordinate of the region to test.
+     * @param[in] y The y-coordinate of the region to test.
+     * @param[in] w The width of the region, 1 tests a single pixel.
+     * @param[in] h The height of the region, 1 tests a single pixel.
+     *
+     * @return @c true if the paint is drawn in the region, @c false otherwise or if it has not been updated by any canvas.
+     *
+     * @note The changes of the paint after the last Canvas::update() are not reflected.
+     * @see Canvas::update()
+     * @note Experimental API
+     */
+    bool intersects(int32_t x, int32_t y, int32_t w = 1, int32_t h = 1) noexcept;
+
     /**
      * @brief Retrieves the axis-aligned bounding box (AABB) of the paint object in canvas space.
      *
@@ -749,6 +852,8 @@ public:
      *
      * @note Clearing the buffer is unnecessary if the canvas will be fully covered 
      *       with opaque content, which can improve performance.
+     * @note With the partial rendering, only the damaged regions are cleared and redrawn
+     *       while the rest of the target buffer keeps the previous frame.
      * @note Drawing may be asynchronous if the thread count is greater than zero. 
      *       To ensure drawing is complete, call sync() afterwards.
      *
@@ -778,6 +883,23 @@ public:
      */
     Result viewport(int32_t x, int32_t y, int32_t w, int32_t h) noexcept;
 
+    /**
+     * @brief Sets the tolerance of approximating the curves with line segments.
+     *
+     * The curves are flattened on the screen, so the number of the segments follows the drawn size of the paints
+     * rather than their coordinates. A larger tolerance generates fewer segments at the cost of smoothness,
+     * a smaller one gives smoother curves on a large zoom.
+     *
+     * @param[in] tolerance The maximum distance in pixels between a curve and its segments. The default is 0.125.
+     *
+     * @retval Result::InvalidArguments The @p tolerance is not a positive number.
+     * @retval Result::InsufficientCondition The canvas is updating or drawing.
+     *
+     * @note All the paints are prepared again with the next update.
+     * @note Experimental API
+     */
+    Result flatness(float tolerance) noexcept;
+
     /**
      * @brief Guarantees that drawing task is finished.
      *
@@ -790,6 +912,119 @@ public:
      */
     Result sync() noexcept;
 
+    /**
+     * @brief Requests the canvas to render the Paint objects without blocking the calling thread.
+     *
+     * Unlike draw(), the rasterization is performed on a worker thread and this returns right after the submission.
+     * The completion is notified to @p done on the worker thread, or it can be polled with ready().
+     * In any case, sync() must be called before the canvas is used again.
+     *
+     * @param[in] clear If @c true, clears the target buffer to zero before drawing.
+     * @param[in] done The function called once the drawing is finished, with its result. It can be @c nullptr.
+     * @param[in] data The user data passed to @p done.
+     *
+     * @retval Result::InsufficientCondition If the canvas is drawing already, or there is no target or paint to draw.
+     * @retval Result::NonSupport If the rendering engine can't draw off the calling thread. Use draw() instead.
+     *
+     * @warning The paints of the canvas must not be modified until the drawing is finished.
+     *          Build the next frame with another canvas and target meanwhile (double buffering).
+     * @note @p done must not call the canvas back. It's called before this returns if no worker threads are assigned.
+     * @note Currently, only the SwCanvas supports this.
+     *
+     * @see Canvas::ready()
+     * @see Canvas::sync()
+     *
+     * @note Experimental API
+     */
+    Result submit(bool clear = false, void (*done)(Canvas* canvas, Result result, void* data) = nullptr, void* data = nullptr) noexcept;
+
+    /**
+     * @brief Checks whether the drawing requested by submit() is finished, without blocking.
+     *
+     * @retval Result::Success If no drawing is running, so sync() will return immediately.
+     * @retval Result::InsufficientCondition If the drawing is still running.
+     *
+     * @see Canvas::submit()
+     *
+     * @note Experimental API
+     */
+    Result ready() const noexcept;
+
+    /**
+     * @brief Retrieves the regions of the target buffer updated by the last drawing.
+     *
+     * The compositors can present only the changed areas of the buffer with the retrieved regions.
+     * Each region consists of four values in order: left, top, right and bottom coordinates,
+     * where the right and bottom are exclusive.
+     *
+     * @param[out] regions The pointer to the array of the region coordinates. The array size is @p cnt * 4.
+     * @param[out] cnt The number of the regions.
+     *
+     * @retval Result::InsufficientCondition The canvas has not been synced after the drawing.
+     *
+     * @note The regions are valid until the next Canvas::update() or Canvas::draw() call.
+     * @note The engines without the partial rendering support report the whole viewport.
+     * @see Canvas::sync()
+     * @note Experimental API
+     */
+    Result damages(const int32_t** regions, uint32_t* cnt) const noexcept;
+
+    /**
+     * @brief The statistics of a frame collected by the canvas profiling.
+     *
+     * A frame consists of the Canvas::update(), Canvas::draw() and Canvas::sync() calls.
+     * The times are in milliseconds. The preparation time is accumulated over the worker threads.
+     *
+     * @note The engine specific phases and counters are reported by the software engine only.
+     * @note The GPU time is reported by the OpenGL engine only, where the timer queries are supported.
+     * @see Canvas::profiling()
+     * @see Canvas::profile()
+     * @note Experimental API
+     */
+    struct Profile
+    {
+        float update;       ///< The paint tree traversal of the update.
+        float prepare;      ///< The render data preparation, e.g. the outlines, the strokes and the span generation.
+        float preRender;    ///< The rendering preparation, e.g. clearing the damaged regions.
+        float raster;       ///< The rasterization of the shapes and the images.
+        float composite;    ///< The composition of the masks, the blending and the layers.
+        float effect;       ///< The post effects of the scenes.
+        float sync;         ///< The wait for the completion of the drawing.
+        float gpu;          ///< The execution of the drawing on the GPU, the latest one measured as its result arrives a few frames late.
+        uint32_t shapes;    ///< The number of the prepared shapes.
+        uint32_t spans;     ///< The number of the generated spans.
+        uint32_t surfaces;  ///< The number of the allocated composition surfaces.
+        uint32_t cacheHits; ///< The number of the reused composition surfaces and layers.
+    };
+
+    /**
+     * @brief Turns the per-frame profiling of the canvas on or off.
+     *
+     * The profiling costs nearly nothing while it's off.
+     *
+     * @param[in] on If @c true, the canvas collects the statistics of each frame.
+     *
+     * @retval Result::InsufficientCondition The canvas is drawing.
+     *
+     * @see Canvas::profile()
+     * @note Experimental API
+     */
+    Result profiling(bool on) noexcept;
+
+    /**
+     * @brief Retrieves the statistics of the last frame.
+     *
+     * @param[out] profile The statistics of the frame.
+     *
+     * @retval Result::InvalidArguments @p profile is @c nullptr.
+     * @retval Result::InsufficientCondition The profiling is off or the canvas has not been synced after the drawing.
+     *
+     * @see Canvas::profiling()
+     * @see Canvas::sync()
+     * @note Experimental API
+     */
+    Result profile(Profile* profile) const noexcept;
+
     _TVG_DECLARE_PRIVATE_BASE(Canvas);
 };
 
@@ -1066,6 +1301,30 @@ public:
      */
     Result appendPath(const PathCommand* cmds, uint32_t cmdCnt, const Point* pts, uint32_t ptsCnt) noexcept;
 
+    /**
+     * @brief Replaces the path with the given path arrays, without copying them.
+     *
+     * Unlike appendPath(), the shape refers to the caller's arrays, and the renderer reads them directly.
+     * This saves the copy of a large, frequently regenerated geometry (map tiles, plots...).
+     * The arrays must be kept intact until @p release is called, which happens once the engine
+     * no longer refers to them: the path is reset or modified, or the shape and all its duplicates are destroyed.
+     * Any further modification of the path makes a private copy of it first, so the arrays are never written.
+     *
+     * @param[in] cmds The array of the path commands.
+     * @param[in] cmdCnt The length of the @p cmds array.
+     * @param[in] pts The array of the two-dimensional points.
+     * @param[in] ptsCnt The length of the @p pts array.
+     * @param[in] release The function called with the @p data once the arrays are not referred anymore. It can be @c nullptr.
+     * @param[in] data The user data passed to the @p release.
+     *
+     * @retval Result::InvalidArguments In case @p cmds or @p pts is @c nullptr or any count is zero. @p release is not called.
+     *
+     * @note Like with any other change of the shape, the arrays must not be changed while the canvas is drawing.
+     * @see Shape::appendPath()
+     * @note Experimental API
+     */
+    Result attachPath(const PathCommand* cmds, uint32_t cmdCnt, const Point* pts, uint32_t ptsCnt, void (*release)(void* data) = nullptr, void* data = nullptr) noexcept;
+
     /**
      * @brief Sets the stroke width for all of the figures from the path.
      *
@@ -1217,6 +1476,24 @@ public:
      */
     Result path(const PathCommand** cmds, uint32_t* cmdsCnt, const Point** pts, uint32_t* ptsCnt) const noexcept;
 
+    /**
+     * @brief Overwrites the points of the current path in place.
+     *
+     * The path commands are retained, only the coordinates are replaced. This is cheaper than reset() and appending
+     * the whole path again when a path is animated with the same commands every frame (charts, waveforms...).
+     *
+     * @param[in] pts The array of the new two-dimensional points.
+     * @param[in] begin The index of the first point of the path to be overwritten.
+     * @param[in] cnt The length of the @p pts array.
+     *
+     * @retval Result::InvalidArguments In case @p pts is @c nullptr or @p cnt is zero.
+     * @retval Result::InsufficientCondition In case the range exceeds the points of the current path.
+     *
+     * @see Shape::path()
+     * @note Experimental API
+     */
+    Result points(const Point* pts, uint32_t begin, uint32_t cnt) noexcept;
+
     /**
      * @brief Gets the pointer to the gradient fill of the shape.
      *
@@ -1355,6 +1632,7 @@ public:
      * @retval Result::NonSupport When trying to load a file with an unknown extension.
      *
      * @note The Load behavior can be asynchronous if the assigned thread number is greater than zero.
+     * @note Without the threads, an SVG whose size is given by its root element is parsed on the first use, such as the update or the paint() lookup. Only the root attributes are read here for the size().
      * @see Initializer::init()
      */
     Result load(const char* filename) noexcept;
@@ -1391,6 +1669,9 @@ public:
      * @param[in] w A new width of the image in pixels.
      * @param[in] h A new height of the image in pixels.
      *
+     * @note If called before load(), the size is kept and the raster images (JPG, PNG, WEBP) may be decoded
+     *       in a reduced resolution (1/2, 1/4 or 1/8) that still covers it, saving the memory and the drawing cost.
+     *       In that case, scaling the picture up further by its transformation could lose the image details.
      */
     Result size(float w, float h) noexcept;
 
@@ -1421,6 +1702,71 @@ public:
      */
     Result load(uint32_t* data, uint32_t w, uint32_t h, ColorSpace cs, bool copy = false) noexcept;
 
+    /**
+     * @brief Loads raw image data whose rows are apart by the given stride.
+     *
+     * The padded rows of the video frames or the sub-area of a larger buffer can be drawn in place without packing them first.
+     * When @p copy is @c true, the rows are packed into the engine's local buffer.
+     *
+     * @param[in] data A pointer to the memory block where the raw image data is stored.
+     * @param[in] w The width of the image in pixels.
+     * @param[in] h The height of the image in pixels.
+     * @param[in] stride The distance between the beginnings of the two adjacent rows in pixels.
+     * @param[in] cs Specifies how the 32-bit color values should be interpreted.
+     * @param[in] copy If @c true, the data is copied into the engine's local buffer. If @c false, the data is not copied.
+     *
+     * @retval Result::InvalidArguments If no data is given, the size is zero or the @p stride is less than the @p w.
+     *
+     * @note The data not copied is owned by the user. It must be alive while the picture is drawn, use refresh() after modifying it.
+     * @see Picture::load(uint32_t* data, uint32_t w, uint32_t h, ColorSpace cs, bool copy)
+     * @note Experimental API
+     */
+    Result load(uint32_t* data, uint32_t w, uint32_t h, uint32_t stride, ColorSpace cs, bool copy = false) noexcept;
+
+    /**
+     * @brief Loads an image from a texture of the GPU rendering backend without copying it.
+     *
+     * The picture samples the given texture directly when it's drawn on the canvas of the same backend,
+     * so the images produced on the GPU, e.g. by a video decoder or another renderer, don't need to be read back.
+     * For the GlCanvas, @p texture is the name of a 2D texture cast to a pointer, e.g. @c (void*)(uintptr_t)id.
+     * For the WgCanvas, @p texture is a @c WGPUTexture with the texture binding usage.
+     * The first row of the texture is the top of the image.
+     *
+     * @param[in] texture The handle of the texture.
+     * @param[in] w The width of the texture in pixels.
+     * @param[in] h The height of the texture in pixels.
+     * @param[in] cs Specifies how the 32-bit color values of the texture should be interpreted.
+     *
+     * @retval Result::InvalidArguments If the @p texture is @c nullptr or the size is zero.
+     *
+     * @note The texture is not owned by the picture. It must be alive and the same context must be current while the picture is drawn.
+     * @note The SwCanvas can't access the texture, so it skips drawing the picture.
+     * @note Experimental API
+     */
+    Result texture(void* texture, uint32_t w, uint32_t h, ColorSpace cs) noexcept;
+
+    /**
+     * @brief Notifies that the raw image data of the picture has been modified in the given area.
+     *
+     * The picture loaded with its raw image data without copying it reads the data in place, so the data can be
+     * written directly, e.g. by a video decoder. This tells the engine which area of the data changed since
+     * the last drawing, and the engine updates only the area of its own copies, such as the GPU textures.
+     * The areas refreshed before the next drawing are merged.
+     *
+     * @param[in] x The horizontal position of the changed area in pixels.
+     * @param[in] y The vertical position of the changed area in pixels.
+     * @param[in] w The width of the changed area in pixels.
+     * @param[in] h The height of the changed area in pixels.
+     *
+     * @retval Result::InvalidArguments If the @p w or @p h is not positive.
+     * @retval Result::InsufficientCondition If the picture is not loaded with a raw image data.
+     *
+     * @note The other pictures loaded with the same data need their own notification.
+     * @see Picture::load(uint32_t* data, uint32_t w, uint32_t h, ColorSpace cs, bool copy)
+     * @note Experimental API
+     */
+    Result refresh(int32_t x, int32_t y, int32_t w, int32_t h) noexcept;
+
     /**
      * @brief Retrieve a paint object from the Picture scene by its Unique ID.
      *
@@ -1436,6 +1782,60 @@ public:
      */
     const Paint* paint(uint32_t id) noexcept;
 
+    /**
+     * @brief Sets the memory budget for retaining the parsed vector documents across the Picture instances.
+     *
+     * When enabled, the subsequent loads of the same file path or the same data content duplicate the retained
+     * scene instead of parsing the document again. The least recently used documents are evicted once
+     * the retained ones exceed the @p budget. Currently, this applies to the SVG documents only.
+     *
+     * @param[in] budget The approximate memory size in bytes. @c 0 disables the cache and evicts all the retained documents.
+     *
+     * @retval Result::NonSupport If no loader supports the document caching.
+     *
+     * @note The cache is disabled by default.
+     * @note Experimental API
+     */
+    static Result cache(uint32_t budget) noexcept;
+
+    /**
+     * @brief Lowers the priority of the picture loading to prefetch it in the background.
+     *
+     * The prefetched pictures are decoded by the worker threads only when no other tasks are queued,
+     * so the pictures to be drawn right now are loaded ahead of them. A prefetched picture is moved
+     * ahead of the others as soon as it's needed for drawing.
+     *
+     * @param[in] on If @c true, the next load() is prefetched. @c false brings the pending loading ahead of the others.
+     *
+     * @note This takes effect on the next load(), and only when the assigned thread number is greater than zero.
+     * @see Picture::ready()
+     * @see Picture::cancel()
+     * @note Experimental API
+     */
+    Result prefetch(bool on) noexcept;
+
+    /**
+     * @brief Checks whether the picture loading is done, so that drawing it won't wait for the loading.
+     *
+     * @return @c true if the loaded picture is ready to draw, @c false otherwise.
+     *
+     * @note Experimental API
+     */
+    bool ready() const noexcept;
+
+    /**
+     * @brief Cancels the prefetched loading of the picture if it's not started yet.
+     *
+     * The picture keeps the loaded header information such as the size, and it's loaded again on demand
+     * once it's drawn or its data is accessed.
+     *
+     * @retval Result::InsufficientCondition If there is no prefetched loading pending, or the loaded data is shared with the other pictures.
+     *
+     * @see Picture::prefetch()
+     * @note Experimental API
+     */
+    Result cancel() noexcept;
+
     /**
      * @brief Creates a new Picture object.
      *
@@ -1541,6 +1941,21 @@ public:
      */
     Result push(SceneEffect effect, ...) noexcept;
 
+    /**
+     * @brief Retains the rendered result of the scene to reuse it in the next drawings.
+     *
+     * When enabled, the scene is rendered to an intermediate buffer that is kept by the renderer.
+     * As long as nothing in the scene's subtree is changed, the next drawings just composite the buffer
+     * instead of rendering every child again. This is useful for large static scenes under small animated contents.
+     *
+     * @param[in] on @c true to retain the rendered result, @c false to render the scene every time (default).
+     *
+     * @note The post-processing effects are applied before retaining, so a static scene with effects such as a blur is not filtered again.
+     * @note The engines without the support render the scene through an intermediate composition every time.
+     * @note Experimental API
+     */
+    Result cache(bool on) noexcept;
+
     /**
      * @brief Creates a new Scene object.
      *
@@ -1744,25 +2159,194 @@ public:
      * @param[in] stride The stride of the raster image - greater than or equal to @p w.
      * @param[in] w The width of the raster image.
      * @param[in] h The height of the raster image.
-     * @param[in] cs The value specifying the way the 32-bits colors should be read/written.
+     * @param[in] cs The value specifying the way the colors should be read/written.
      *
      * @retval Result::InvalidArguments In case no valid pointer is provided or the width, or the height or the stride is zero.
      * @retval Result::InsufficientCondition if the canvas is performing rendering. Please ensure the canvas is synced.
      * @retval Result::NonSupport In case the software engine is not supported.
      *
+     * @note For ColorSpace::Grayscale8 and ColorSpace::RGB565, @p buffer is a memory block of 8 and 16 bits pixels respectively
+     *       and @p stride counts the pixels as well.
+     * @note ColorSpace::RGB565 is rasterized to an internal 32 bits buffer, and only the updated regions are packed into @p buffer
+     *       at the end of every drawing.
      * @warning Do not access @p buffer during Canvas::push() - Canvas::sync(). It should not be accessed while the engine is writing on it.
      *
      * @see Canvas::viewport()
      * @see Canvas::sync()
+     * @see SwCanvas::dither()
     */
     Result target(uint32_t* buffer, uint32_t stride, uint32_t w, uint32_t h, ColorSpace cs) noexcept;
 
+    /**
+     * @brief Sets the banded drawing target for the rasterization with a small memory budget.
+     *
+     * The target of the size @p w x @p h is drawn in the horizontal bands of @p lines pixel rows from the top to the bottom,
+     * all of them into the same @p buffer. Once a band is drawn, @p flush is called to pass it over, e.g. to a display,
+     * before the next band is drawn into @p buffer again. The paints are prepared once per frame, so only the memory
+     * of the target is reduced from the whole frame to a band.
+     *
+     * @param[in] buffer A pointer to a memory block of the size @p stride x @p lines, where a band of the raster data is stored.
+     * @param[in] stride The stride of the raster image - greater than or equal to @p w.
+     * @param[in] w The width of the raster image.
+     * @param[in] h The height of the raster image.
+     * @param[in] lines The number of the pixel rows of a band.
+     * @param[in] cs The value specifying the way the colors should be read/written.
+     * @param[in] flush The callback called with each drawn band. Its @p buffer holds the @p lines rows of the target from the row @p y.
+     * @param[in] data The user data passed to @p flush.
+     *
+     * @retval Result::InvalidArguments In case no valid pointer is provided or the width, or the height, or the stride or @p lines is zero.
+     * @retval Result::InsufficientCondition if the canvas is performing rendering. Please ensure the canvas is synced.
+     * @retval Result::NonSupport In case the software engine is not supported.
+     *
+     * @note Every band is cleared before its drawing.
+     * @note The partial rendering doesn't apply, the whole target is drawn band by band in every drawing.
+     * @note The scene effects are drawn within the bands, the blurs may be cut at their boundaries.
+     * @note Experimental API
+     *
+     * @see SwCanvas::target()
+    */
+    Result target(uint32_t* buffer, uint32_t stride, uint32_t w, uint32_t h, uint32_t lines, ColorSpace cs, void (*flush)(const uint32_t* buffer, uint32_t y, uint32_t lines, void* data), void* data = nullptr) noexcept;
+
+    /**
+     * @brief Enables the ordered dithering of the packed target colors.
+     *
+     * The colors quantized to a ColorSpace::RGB565 target show banding in the smooth gradients. The dithering spreads
+     * the rounding errors over a 4x4 pattern instead. It has no effect on the other color spaces.
+     *
+     * @param[in] on @c true to dither the colors, @c false to round them to the nearest (default).
+     *
+     * @retval Result::InsufficientCondition if the canvas is performing rendering. Please ensure the canvas is synced.
+     * @retval Result::NonSupport In case the software engine is not supported.
+     *
+     * @note The whole target is packed again with the next drawing.
+     * @note Experimental API
+    */
+    Result dither(bool on) noexcept;
+
+    /**
+     * @brief Rasterizes the fills of the shapes into the fixed size coverage tiles instead of the spans.
+     *
+     * The coverage of a shape is kept in the blocks of 16x4 pixels and the runs of the fully covered ones, which are drawn
+     * by the fixed width kernels. Unlike the spans, the tiles are not limited to the 65535 pixels coordinates, so the shapes
+     * are drawn over the whole area of the larger targets. The result is the same as the one of the spans.
+     *
+     * @param[in] on @c true to rasterize in the tiles, @c false to rasterize in the spans (default).
+     *
+     * @retval Result::InsufficientCondition if the canvas is performing rendering. Please ensure the canvas is synced.
+     * @retval Result::NonSupport In case the software engine is not supported.
+     *
+     * @note The tiles apply to the solid color fills without any clipping. The gradient fills, the strokes, the texts
+     *       and the clippers are rasterized in the spans still.
+     * @note The shapes are prepared again with the next update.
+     * @note Experimental API
+    */
+    Result tiles(bool on) noexcept;
+
+    /**
+     * @brief A drawing request of the batch rendering.
+     *
+     * @see SwCanvas::batch()
+     * @note Experimental API
+     */
+    struct Job
+    {
+        Paint* paint;       ///< The paint to draw. The batch doesn't take over its ownership.
+        uint32_t* buffer;   ///< The target buffer of the size @c stride x @c h.
+        uint32_t stride;    ///< The stride of the target buffer.
+        uint32_t w;         ///< The width of the target buffer.
+        uint32_t h;         ///< The height of the target buffer.
+        Result result;      ///< [out] The result of the drawing.
+    };
+
+    /**
+     * @brief Draws the paints to their own target buffers at once.
+     *
+     * The jobs are spread over the worker threads as a whole, and each thread reuses a single raster engine
+     * for all the jobs it takes. This suits a number of small images, e.g. thumbnails, far better than
+     * drawing them with the separate canvases one by one. The call returns after all the jobs are done.
+     *
+     * @param[in,out] jobs The array of the drawing requests. The result of each is written to its @c result.
+     * @param[in] cnt The number of the @p jobs.
+     * @param[in] cs The color space of all the target buffers.
+     *
+     * @retval Result::InvalidArguments @p jobs is @c nullptr or @p cnt is zero.
+     * @retval Result::InsufficientCondition The engine is not initialized.
+     * @retval Result::NonSupport In case the software engine is not supported.
+     *
+     * @note The paints must not belong to any other canvas or scene, and they stay bound to the engine
+     *       which has drawn them, so a paint can't be drawn again by another batch or canvas.
+     * @note The buffers are cleared before the drawing.
+     * @note Experimental API
+     */
+    static Result batch(Job* jobs, uint32_t cnt, ColorSpace cs) noexcept;
+
+    /**
+     * @brief A target of the multi-resolution rendering.
+     *
+     * @see SwCanvas::render()
+     * @note Experimental API
+     */
+    struct Rendition
+    {
+        uint32_t* buffer;   ///< The target buffer of the size @c stride x @c h.
+        uint32_t stride;    ///< The stride of the target buffer.
+        uint32_t w;         ///< The width of the target buffer.
+        uint32_t h;         ///< The height of the target buffer.
+        float scale;        ///< The scale factor of the paint drawn to this target.
+        Result result;      ///< [out] The result of the drawing.
+    };
+
+    /**
+     * @brief Draws a paint to several target buffers at different scales at once.
+     *
+     * The paint is loaded and built once, e.g. a Picture of an SVG or a Lottie, and only its preparation and rasterization
+     * are repeated for each target with a single raster engine, which reuses its resources, e.g. the gradient color tables.
+     * This suits the renditions of an asset at several sizes, e.g. thumbnails, far better than loading and drawing it per size.
+     * The scale of each target is applied on top of the transformation of the @p paint.
+     *
+     * @param[in] paint The paint to draw. The call doesn't take over its ownership.
+     * @param[in,out] renditions The array of the targets. The result of each is written to its @c result.
+     * @param[in] cnt The number of the @p renditions.
+     * @param[in] cs The color space of all the target buffers.
+     *
+     * @retval Result::InvalidArguments @p paint or @p renditions is @c nullptr or @p cnt is zero.
+     * @retval Result::InsufficientCondition The engine is not initialized or the @p paint belongs to a canvas or a scene.
+     * @retval Result::NonSupport In case the software engine is not supported.
+     *
+     * @note The paint stays bound to the engine which has drawn it, so it can't be drawn again by another canvas.
+     * @note The buffers are cleared before the drawing.
+     * @see SwCanvas::batch()
+     * @note Experimental API
+     */
+    static Result render(Paint* paint, Rendition* renditions, uint32_t cnt, ColorSpace cs) noexcept;
+
     /**
      * @brief Creates a new SwCanvas object.
      * @return A new SwCanvas object.
      */
     static SwCanvas* gen() noexcept;
 
+    /**
+     * @brief Creates a new SwCanvas object with its own rendering resources.
+     *
+     * The isolated canvas owns the memory pools of its raster engine, and it runs its rendering tasks in place
+     * on the thread calling update() and draw() rather than queueing them to the shared worker threads.
+     * This lets the independent canvases be drawn concurrently by separate application threads,
+     * e.g. one per output surface, without waiting for each other, so that N canvases scale across N threads.
+     * The engine states shared by the canvases (the loaded resources, the caches) are locked once an isolated canvas is created,
+     * even when no worker threads are assigned.
+     *
+     * @param[in] isolated @c true to create an isolated canvas, @c false is the same as gen().
+     *
+     * @return A new SwCanvas object.
+     *
+     * @note Each isolated canvas, along with its paints, must be used by only one thread at a time. Paints must not be shared between canvases drawn concurrently.
+     * @note The Initializer must be initialized before and terminated after all the threads are done with the canvases.
+     * @see SwCanvas::gen()
+     * @note Experimental API
+     */
+    static SwCanvas* gen(bool isolated) noexcept;
+
     _TVG_DECLARE_PRIVATE(SwCanvas);
 };
 
@@ -1886,6 +2470,57 @@ public:
      */
     static Result init(uint32_t threads) noexcept;
 
+    /**
+     * @brief Initializes the ThorVG engine with the user memory allocator.
+     *
+     * Every memory allocation of the engine, including its objects, goes through the given @p allocator.
+     *
+     * @param[in] threads The number of worker threads to create. A value of zero indicates that only the main thread will be used.
+     * @param[in] allocator The user memory functions. @c nullptr restores the system allocator.
+     *
+     * @retval Result::InvalidArguments Any function of the @p allocator is missing.
+     * @retval Result::InsufficientCondition The engine has been initialized already with another allocator.
+     *
+     * @note The allocator is installed on the first call and stays in effect after term(), so that the blocks
+     *       released afterwards return to it. It must be given before any ThorVG object is created.
+     * @warning If ThorVG is linked statically, its global new and delete operators serve the application as well.
+     * @see Initializer::init(uint32_t threads)
+     * @note Experimental API
+     */
+    static Result init(uint32_t threads, const Allocator* allocator) noexcept;
+
+    /**
+     * @brief Initializes the ThorVG engine with the worker threads placed and scheduled as given.
+     *
+     * On the hybrid cpus, pinning the workers to the same kind of cores gives the even task durations.
+     * A short @c spin of the idle workers saves their wakeup latency between the close bursts of the tasks in a frame,
+     * at the cost of the cpu time while the workers wait.
+     *
+     * @param[in] threads The number of worker threads to create. A value of zero indicates that only the main thread will be used.
+     * @param[in] options The worker thread options.
+     *
+     * @note The options are applied only on the first call, along with the number of threads.
+     * @see Initializer::init(uint32_t threads)
+     * @note Experimental API
+     */
+    static Result init(uint32_t threads, const ThreadOptions& options) noexcept;
+
+    /**
+     * @brief Initializes the ThorVG engine running its tasks on the given host job system.
+     *
+     * ThorVG spawns no threads of its own then, so that it shares the cpu with the host jobs without oversubscription.
+     * The thread calling init() stays the main thread of the engine and it helps to run the tasks while it waits for them.
+     *
+     * @param[in] executor The host job system.
+     *
+     * @retval Result::InvalidArguments The @c submit function is missing or the @c threads is out of the range.
+     *
+     * @note The executor is applied only on the first call and must stay valid until the last term().
+     * @see Initializer::init(uint32_t threads)
+     * @note Experimental API
+     */
+    static Result init(const Executor& executor) noexcept;
+
     /**
      * @brief Terminates the ThorVG engine.
      *
@@ -1899,6 +2534,52 @@ public:
      */
     static Result term() noexcept;
 
+    /**
+     * @brief Sets the memory budget for retaining the decoded raster images no longer used by any Picture.
+     *
+     * When enabled, the PNG, JPG and WEBP images loaded from the files keep their decoded pixels after their last
+     * Picture is destroyed, so that loading the same file again skips decoding. The least recently used images are
+     * dropped once the retained ones exceed the @p budget, and will be decoded again on demand.
+     *
+     * @param[in] budget The approximate memory size in bytes. @c 0 disables the retention and drops all the retained images.
+     *
+     * @note The retention is disabled by default.
+     * @note Experimental API
+     */
+    static Result cache(uint32_t budget) noexcept;
+
+    /**
+     * @brief Retrieves the memory size currently held by the given subsystem of the engine.
+     *
+     * @param[in] category The subsystem to query.
+     * @param[out] bytes The allocated size in bytes.
+     *
+     * @retval Result::InvalidArguments @p bytes is @c nullptr.
+     * @retval Result::NonSupport The memory statistics are disabled at the build time.
+     *
+     * @note The statistics require the 'memory_stats' extra build option which adds a small header to every allocation.
+     * @note Experimental API
+     */
+    static Result memory(MemoryCategory category, size_t* bytes) noexcept;
+
+    /**
+     * @brief Releases the reusable memory of the engine without terminating it.
+     *
+     * The engine keeps the memory pools, the composition targets and the caches across the frames to avoid the
+     * reallocations. This releases them down to the given @p level, for instance on a memory warning of the system.
+     * They are allocated again on demand by the following frames.
+     *
+     * @param[in] level The extent of the memory to release.
+     *
+     * @retval Result::InsufficientCondition The engine is not initialized.
+     *
+     * @note Call it while no canvas is updating or drawing, e.g. after Canvas::sync().
+     * @note The GPU engines release their idle targets at the beginning of their next frame, with their context current.
+     * @see Initializer::cache()
+     * @note Experimental API
+     */
+    static Result trim(TrimLevel level) noexcept;
+
     /**
      * @brief Retrieves the version of the TVG engine.
      *
@@ -2028,6 +2709,27 @@ public:
      */
     Result segment(float* begin, float* end = nullptr) noexcept;
 
+    /**
+     * @brief Rasterizes all the frames of the animation in advance and plays them back as the image.
+     *
+     * Every frame in the current segment is drawn once at the given size and kept in a compressed form.
+     * After baking, frame() decodes the nearest baked frame instead of building and drawing the vector scene,
+     * which trades the memory for the much cheaper playback of the animations repeated many times.
+     *
+     * @param[in] w The width of the baked frames in pixels. Both zeros release the baked frames.
+     * @param[in] h The height of the baked frames in pixels.
+     *
+     * @retval Result::InsufficientCondition In case the animation is not loaded.
+     * @retval Result::InvalidArguments If only one of @p w and @p h is zero.
+     * @retval Result::NonSupport When it's not animatable, it's not loaded from a file, or the software raster engine is not available.
+     *
+     * @note The baked frames are scaled to the picture size, so the sharpest result is given by baking at the drawing size.
+     * @note Changing the segment releases the baked frames.
+     * @see Animation::frame()
+     * @note Experimental API
+     */
+    Result bake(uint32_t w, uint32_t h) noexcept;
+
     /**
      * @brief Creates a new Animation object.
      *
@@ -2085,6 +2787,7 @@ public:
      * @retval Result::NonSupport When trying to save a file with an unknown extension or in an unsupported format.
      * @retval Result::Unknown In case an empty paint is to be saved.
      *
+     * @note A PNG is always lossless, the lower @p quality only spends less effort on the compression for the faster encoding.
      * @note Saving can be asynchronous if the assigned thread number is greater than zero. To guarantee the saving is done, call sync() afterwards.
      * @see Saver::sync()
      *
@@ -2107,6 +2810,10 @@ public:
      * @retval Result::Unknown if attempting to save an empty paint.
      *
      * @note A higher frames per second (FPS) would result in a larger file size. It is recommended to use the default value.
+     * @note A GIF with a @p quality less than @c 100 uses one palette shared by all the frames, which reduces the file size and the encoding time at the cost of the color fidelity.
+     * @note A WebP is encoded losslessly with the @p quality @c 100, while the lower one rounds off the color values (near lossless) for a smaller file.
+     * @note A Lottie animation loaded from a file can be saved as a compiled model (*.tvglot), which is loaded again without parsing the JSON.
+     *       It's bound to the ThorVG build that saved it and excludes the slots, expressions, texts, and images. @p quality and @p fps are ignored.
      * @note Saving can be asynchronous if the assigned thread number is greater than zero. To guarantee the saving is done, call sync() afterwards.
      *
      * @see Saver::sync()
@@ -2115,6 +2822,48 @@ public:
      */
     Result save(Animation* animation, const char* filename, uint32_t quality = 100, uint32_t fps = 0) noexcept;
 
+    /**
+     * @brief A rendered animation frame handed over to the frame sink.
+     *
+     * @see Saver::save(Animation* animation, bool (*sink)(const Frame* frame, void* data), void* data, ColorSpace cs, uint32_t fps, uint32_t queue)
+     * @note Experimental API
+     */
+    struct Frame
+    {
+        const uint32_t* buffer;   ///< The pixels of the frame, @c w x @c h in the requested color space. Valid only during the sink call.
+        uint32_t w;               ///< The width of the frame.
+        uint32_t h;               ///< The height of the frame.
+        uint32_t index;           ///< The order of the frame in the stream, starting from 0.
+        float no;                 ///< The animation frame number.
+        int32_t damage[4];        ///< The region changed from the previous frame: left, top, right and bottom, where the right and bottom are exclusive. It may be larger than the actual changes, all zeros if nothing changed.
+    };
+
+    /**
+     * @brief Streams the rendered frames of the animation to the given function, e.g. to feed a video encoder.
+     *
+     * The frames are rendered with the same pipelined, multi-threaded rendering as the animation files,
+     * and they're handed over to the @p sink in order, along with the changed regions.
+     * With the worker threads, the @p sink is called on a worker while the next frames are rendered, up to @p queue frames in flight.
+     * The rendering waits for the @p sink beyond that, so a slow consumer holds the memory usage bounded.
+     *
+     * @param[in] animation The animation to be rendered, including all associated properties.
+     * @param[in] sink The function receiving each frame. Returning @c false stops the streaming.
+     * @param[in] data The user data passed to the @p sink.
+     * @param[in] cs The color space of the frame buffers. Only the 32 bits color spaces are allowed.
+     * @param[in] fps The desired frames per second (FPS). Pass 0 to keep the original frame data.
+     * @param[in] queue The maximum number of the rendered frames waiting for the @p sink. @c 0 calls the @p sink in place right after each rendering.
+     *
+     * @retval Result::InvalidArguments In case @p animation or @p sink is @c nullptr, or @p cs is not a 32 bits color space.
+     * @retval Result::InsufficientCondition if there are ongoing resource-saving operations or the animation has no frames.
+     * @retval Result::Unknown if the animation has an empty view size.
+     *
+     * @note The streaming can be asynchronous if the assigned thread number is greater than zero. To guarantee the streaming is done, call sync() afterwards.
+     * @note The @p sink must not call this saver back.
+     * @see Saver::sync()
+     * @note Experimental API
+     */
+    Result save(Animation* animation, bool (*sink)(const Frame* frame, void* data), void* data = nullptr, ColorSpace cs = ColorSpace::ARGB8888, uint32_t fps = 0, uint32_t queue = 2) noexcept;
+
     /**
      * @brief Guarantees that the saving task is finished.
      *
@@ -1,6 +1,7 @@
 #ifndef __THORVG_CAPI_H__
 #define __THORVG_CAPI_H__
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -116,6 +117,8 @@ typedef enum {
     TVG_COLORSPACE_ARGB8888,      ///< The channels are joined in the order: alpha, red, green, blue. Colors are alpha-premultiplied.
     TVG_COLORSPACE_ABGR8888S,     ///< The channels are joined in the order: alpha, blue, green, red. Colors are un-alpha-premultiplied. (since 0.13)
     TVG_COLORSPACE_ARGB8888S,     ///< The channels are joined in the order: alpha, red, green, blue. Colors are un-alpha-premultiplied. (since 0.13)
+    TVG_COLORSPACE_GRAYSCALE8,    ///< One single channel data. As a SwCanvas target, the coverage (alpha) of the drawing is written, e.g. for A8 displays.
+    TVG_COLORSPACE_RGB565,        ///< 16 bits packed channels in the order: red(5), green(6), blue(5). The drawing is composed over black. This is only available for the SwCanvas target. (Experimental API)
     TVG_COLORSPACE_UNKNOWN = 255, ///< Unknown channel data. This is reserved for an initial ColorSpace value. (since 1.0)
 } Tvg_Colorspace;
 
@@ -294,6 +297,74 @@ typedef struct
 } Tvg_Matrix;
 
 
+/**
+ * @brief A data structure storing the statistics of a frame collected by the canvas profiling.
+ *
+ * The times are in milliseconds.
+ *
+ * @see tvg_canvas_get_profile()
+ * @note Experimental API
+ */
+typedef struct
+{
+    float update;       /**< The paint tree traversal of the update. */
+    float prepare;      /**< The render data preparation, accumulated over the worker threads. */
+    float pre_render;   /**< The rendering preparation, e.g. clearing the damaged regions. */
+    float raster;       /**< The rasterization of the shapes and the images. */
+    float composite;    /**< The composition of the masks, the blending and the layers. */
+    float effect;       /**< The post effects of the scenes. */
+    float sync;         /**< The wait for the completion of the drawing. */
+    float gpu;          /**< The execution of the drawing on the GPU, the latest one measured as its result arrives a few frames late. */
+    uint32_t shapes;    /**< The number of the prepared shapes. */
+    uint32_t spans;     /**< The number of the generated spans. */
+    uint32_t surfaces;  /**< The number of the allocated composition surfaces. */
+    uint32_t cache_hits; /**< The number of the reused composition surfaces and layers. */
+} Tvg_Canvas_Profile;
+
+
+/**
+ * @brief Enumeration specifying the subsystems accounted by the memory statistics.
+ *
+ * @see tvg_engine_get_memory()
+ * @note Experimental API
+ */
+typedef enum {
+    TVG_MEMORY_CATEGORY_COMMON = 0,   ///< The paints, the fills and the other allocations not belonging to the below.
+    TVG_MEMORY_CATEGORY_LOADER,       ///< The loaders, including the parsed documents and the decoded images.
+    TVG_MEMORY_CATEGORY_ENGINE,       ///< The render data of the raster engines.
+    TVG_MEMORY_CATEGORY_COMPOSITOR    ///< The composition buffers and the retained layers of the raster engines.
+} Tvg_Memory_Category;
+
+
+/**
+ * @brief Enumeration specifying how much of the reusable memory the engine releases.
+ *
+ * @see tvg_engine_trim()
+ * @note Experimental API
+ */
+typedef enum {
+    TVG_TRIM_LEVEL_POOLS = 0,   ///< The working memory pools of the raster engines and their idle composition targets.
+    TVG_TRIM_LEVEL_CACHES       ///< The pools along with the caches: the retained decoded images and the rasterized glyphs.
+} Tvg_Trim_Level;
+
+
+/**
+ * @brief A set of the user memory functions replacing the system allocator.
+ *
+ * All the functions are mandatory and must be thread-safe when the engine runs with the worker threads.
+ *
+ * @see tvg_engine_init_with_allocator()
+ * @note Experimental API
+ */
+typedef struct
+{
+    void* (*alloc)(size_t size, void* data);                 /**< Allocates @p size bytes aligned for any type. */
+    void* (*realloc)(void* ptr, size_t size, void* data);    /**< Resizes the block, @p ptr may be @c NULL. */
+    void (*free)(void* ptr, void* data);                     /**< Releases the block, @p ptr may be @c NULL. */
+    void* data;                                              /**< The user data passed back to every call. */
+} Tvg_Allocator;
+
+
 /**
 * @defgroup ThorVGCapi_Initializer Initializer
 * @brief A module enabling initialization and termination of the TVG engines.
@@ -337,6 +408,58 @@ TVG_API Tvg_Result tvg_engine_init(unsigned threads);
 TVG_API Tvg_Result tvg_engine_term();
 
 
+/*!
+* @brief Initializes the ThorVG engine with the user memory allocator.
+*
+* Every memory allocation of the engine goes through the given @p allocator.
+*
+* @param[in] threads The number of worker threads to create. A value of zero indicates that only the main thread will be used.
+* @param[in] allocator The user memory functions. @c NULL restores the system allocator.
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_INVALID_ARGUMENT Any function of the @p allocator is missing.
+* @retval TVG_RESULT_INSUFFICIENT_CONDITION The engine has been initialized already with another allocator.
+*
+* @note The allocator is installed on the first call and stays in effect after tvg_engine_term().
+*       It must be given before any ThorVG object is created.
+* @see tvg_engine_init()
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_engine_init_with_allocator(unsigned threads, const Tvg_Allocator* allocator);
+
+
+/*!
+* @brief Retrieves the memory size currently held by the given subsystem of the engine.
+*
+* @param[in] category The subsystem to query.
+* @param[out] bytes The allocated size in bytes.
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_INVALID_ARGUMENT @p bytes is @c NULL.
+* @retval TVG_RESULT_NOT_SUPPORTED The memory statistics are disabled at the build time.
+*
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_engine_get_memory(Tvg_Memory_Category category, size_t* bytes);
+
+
+/*!
+* @brief Releases the reusable memory of the engine without terminating it.
+*
+* The memory pools, the composition targets and the caches are released down to the given @p level,
+* for instance on a memory warning of the system. They are allocated again on demand by the following frames.
+*
+* @param[in] level The extent of the memory to release.
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_INSUFFICIENT_CONDITION The engine is not initialized.
+*
+* @note Call it while no canvas is updating or drawing, e.g. after tvg_canvas_sync().
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_engine_trim(Tvg_Trim_Level level);
+
+
 /**
 * @brief Retrieves the version of the TVG engine.
 *
@@ -399,13 +522,15 @@ TVG_API Tvg_Canvas* tvg_swcanvas_create(void);
 * @param[in] stride The stride of the raster image - in most cases same value as @p w.
 * @param[in] w The width of the raster image.
 * @param[in] h The height of the raster image.
-* @param[in] cs The colorspace value defining the way the 32-bits colors should be read/written.
+* @param[in] cs The colorspace value defining the way the colors should be read/written.
 *
 * @return Tvg_Result enumeration.
 * @retval TVG_RESULT_INVALID_ARGUMENTS An invalid canvas or buffer pointer passed or one of the @p stride, @p w or @p h being zero.
 * @retval TVG_RESULT_INSUFFICIENT_CONDITION if the canvas is performing rendering. Please ensure the canvas is synced.
 * @retval TVG_RESULT_NOT_SUPPORTED The software engine is not supported.
 *
+* @note For TVG_COLORSPACE_GRAYSCALE8 and TVG_COLORSPACE_RGB565, @p buffer is a memory block of 8 and 16 bits pixels respectively
+*       and @p stride counts the pixels as well.
 * @warning Do not access @p buffer during tvg_canvas_draw() - tvg_canvas_sync(). It should not be accessed while the engine is writing on it.
 *
 * @see Tvg_Colorspace
@@ -413,6 +538,65 @@ TVG_API Tvg_Canvas* tvg_swcanvas_create(void);
 TVG_API Tvg_Result tvg_swcanvas_set_target(Tvg_Canvas* canvas, uint32_t* buffer, uint32_t stride, uint32_t w, uint32_t h, Tvg_Colorspace cs);
 
 
+/*!
+* @brief Sets the banded target, the canvas is drawn into the @p buffer in the horizontal bands of @p lines rows one after another.
+*
+* @param[in] canvas The Tvg_Canvas object managing the @p buffer.
+* @param[in] buffer A pointer to the allocated memory block of the size @p stride x @p lines.
+* @param[in] stride The stride of the raster image - in most cases same value as @p w.
+* @param[in] w The width of the raster image.
+* @param[in] h The height of the raster image.
+* @param[in] lines The number of the pixel rows of a band.
+* @param[in] cs The colorspace value defining the way the colors should be read/written.
+* @param[in] flush The callback called with each drawn band, which holds the @p lines rows of the target from the row @p y.
+* @param[in] data The user data passed to @p flush.
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_INVALID_ARGUMENTS An invalid canvas, buffer or flush pointer passed or one of the @p stride, @p w, @p h or @p lines being zero.
+* @retval TVG_RESULT_INSUFFICIENT_CONDITION if the canvas is performing rendering. Please ensure the canvas is synced.
+* @retval TVG_RESULT_NOT_SUPPORTED The software engine is not supported.
+*
+* @see tvg_swcanvas_set_target()
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_swcanvas_set_banded_target(Tvg_Canvas* canvas, uint32_t* buffer, uint32_t stride, uint32_t w, uint32_t h, uint32_t lines, Tvg_Colorspace cs, void (*flush)(const uint32_t* buffer, uint32_t y, uint32_t lines, void* data), void* data);
+
+
+/*!
+* @brief Enables the ordered dithering of the TVG_COLORSPACE_RGB565 target colors.
+*
+* @param[in] canvas The Tvg_Canvas object managing the target buffer.
+* @param[in] on @c true to dither the colors, @c false to round them to the nearest (default).
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_INVALID_ARGUMENT An invalid Tvg_Canvas pointer.
+* @retval TVG_RESULT_INSUFFICIENT_CONDITION if the canvas is performing rendering. Please ensure the canvas is synced.
+* @retval TVG_RESULT_NOT_SUPPORTED The software engine is not supported.
+*
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_swcanvas_set_dither(Tvg_Canvas* canvas, bool on);
+
+
+/*!
+* @brief Rasterizes the fills of the shapes into the fixed size coverage tiles instead of the spans.
+*
+* The tiles are not limited to the 65535 pixels coordinates of the spans, the result is the same otherwise.
+*
+* @param[in] canvas The Tvg_Canvas object managing the target buffer.
+* @param[in] on @c true to rasterize in the tiles, @c false to rasterize in the spans (default).
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_INVALID_ARGUMENT An invalid Tvg_Canvas pointer.
+* @retval TVG_RESULT_INSUFFICIENT_CONDITION if the canvas is performing rendering. Please ensure the canvas is synced.
+* @retval TVG_RESULT_NOT_SUPPORTED The software engine is not supported.
+*
+* @note The tiles apply to the solid color fills without any clipping.
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_swcanvas_set_tiles(Tvg_Canvas* canvas, bool on);
+
+
 /** \} */   // end defgroup ThorVGCapi_SwCanvas
 
 
@@ -635,6 +819,48 @@ TVG_API Tvg_Result tvg_canvas_draw(Tvg_Canvas* canvas, bool clear);
 TVG_API Tvg_Result tvg_canvas_sync(Tvg_Canvas* canvas);
 
 
+/*!
+* @brief Requests the canvas to draw the Tvg_Paint objects without blocking the calling thread.
+*
+* The rasterization is performed on a worker thread and this returns right after the submission.
+* The completion is notified to @p done on the worker thread, or it can be polled with tvg_canvas_ready().
+* In any case, tvg_canvas_sync() must be called before the canvas is used again.
+*
+* @param[in] canvas The Tvg_Canvas object containing elements to be drawn.
+* @param[in] clear If @c true, clears the target buffer to zero before drawing.
+* @param[in] done The function called once the drawing is finished, with its result. It can be @c NULL.
+* @param[in] data The user data passed to @p done.
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_INVALID_ARGUMENT An invalid Tvg_Canvas pointer.
+* @retval TVG_RESULT_INSUFFICIENT_CONDITION The canvas is drawing already, or there is no target or paint to draw.
+* @retval TVG_RESULT_NOT_SUPPORTED The rendering engine can't draw off the calling thread. Use tvg_canvas_draw() instead.
+*
+* @warning The paints of the canvas must not be modified until the drawing is finished.
+* @note @p done must not call the canvas back. It's called before this returns if no worker threads are assigned.
+* @see tvg_canvas_ready()
+* @see tvg_canvas_sync()
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_canvas_submit(Tvg_Canvas* canvas, bool clear, void (*done)(Tvg_Canvas* canvas, Tvg_Result result, void* data), void* data);
+
+
+/*!
+* @brief Checks whether the drawing requested by tvg_canvas_submit() is finished, without blocking.
+*
+* @param[in] canvas The Tvg_Canvas object being drawn.
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_SUCCESS No drawing is running, so tvg_canvas_sync() will return immediately.
+* @retval TVG_RESULT_INVALID_ARGUMENT An invalid Tvg_Canvas pointer.
+* @retval TVG_RESULT_INSUFFICIENT_CONDITION The drawing is still running.
+*
+* @see tvg_canvas_submit()
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_canvas_ready(const Tvg_Canvas* canvas);
+
+
 /*!
 * @brief Sets the drawing region in the canvas.
 *
@@ -657,6 +883,78 @@ TVG_API Tvg_Result tvg_canvas_sync(Tvg_Canvas* canvas);
 */
 TVG_API Tvg_Result tvg_canvas_set_viewport(Tvg_Canvas* canvas, int32_t x, int32_t y, int32_t w, int32_t h);
 
+
+/*!
+* @brief Sets the tolerance of approximating the curves with line segments.
+*
+* The curves are flattened on the screen, so the number of the segments follows the drawn size of the paints.
+*
+* @param[in] canvas The Tvg_Canvas object.
+* @param[in] tolerance The maximum distance in pixels between a curve and its segments. The default is 0.125.
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_INVALID_ARGUMENT An invalid Tvg_Canvas pointer or @p tolerance is not a positive number.
+* @retval TVG_RESULT_INSUFFICIENT_CONDITION The canvas is updating or drawing.
+*
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_canvas_set_flatness(Tvg_Canvas* canvas, float tolerance);
+
+
+/*!
+* @brief Retrieves the regions of the target buffer updated by the last drawing.
+*
+* The compositors can present or upload only the changed areas of the buffer with the retrieved regions,
+* f.e. with eglSwapBuffersWithDamage() or wl_surface_damage_buffer().
+* Each region consists of four values in order: left, top, right and bottom coordinates,
+* where the right and bottom are exclusive.
+*
+* @param[in] canvas The Tvg_Canvas object containing elements which were drawn.
+* @param[out] regions The pointer to the array of the region coordinates. The array size is @p cnt * 4.
+* @param[out] cnt The number of the regions.
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_INVALID_ARGUMENT An invalid Tvg_Canvas pointer or the output arguments are @c NULL.
+* @retval TVG_RESULT_INSUFFICIENT_CONDITION The canvas has not been synced after the drawing.
+*
+* @note The regions are valid until the next tvg_canvas_update() or tvg_canvas_draw() call.
+* @see tvg_canvas_sync()
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_canvas_get_damages(const Tvg_Canvas* canvas, const int32_t** regions, uint32_t* cnt);
+
+
+/*!
+* @brief Turns the per-frame profiling of the canvas on or off.
+*
+* @param[in] canvas The Tvg_Canvas object to be profiled.
+* @param[in] on If @c true, the canvas collects the statistics of each frame.
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_INVALID_ARGUMENT An invalid Tvg_Canvas pointer.
+* @retval TVG_RESULT_INSUFFICIENT_CONDITION The canvas is drawing.
+*
+* @see tvg_canvas_get_profile()
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_canvas_set_profiling(Tvg_Canvas* canvas, bool on);
+
+
+/*!
+* @brief Retrieves the statistics of the last frame.
+*
+* @param[in] canvas The Tvg_Canvas object being profiled.
+* @param[out] profile The statistics of the frame.
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_INVALID_ARGUMENT An invalid Tvg_Canvas pointer or @p profile is @c NULL.
+* @retval TVG_RESULT_INSUFFICIENT_CONDITION The profiling is off or the canvas has not been synced after the drawing.
+*
+* @see tvg_canvas_set_profiling()
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_canvas_get_profile(const Tvg_Canvas* canvas, Tvg_Canvas_Profile* profile);
+
 /** \} */   // end defgroup ThorVGCapi_Canvas
 
 /**
@@ -896,6 +1194,23 @@ TVG_API Tvg_Result tvg_paint_get_aabb(const Tvg_Paint* paint, float* x, float* y
 TVG_API Tvg_Result tvg_paint_get_obb(const Tvg_Paint* paint, Tvg_Point* pt4);
 
 
+/**
+ * @brief Checks whether the drawing of the paint covers any pixel of the given region in canvas space.
+ *
+ * @param[in] paint The Tvg_Paint object to test.
+ * @param[in] x The x-coordinate of the region to test.
+ * @param[in] y The y-coordinate of the region to test.
+ * @param[in] w The width of the region, 1 tests a single pixel.
+ * @param[in] h The height of the region, 1 tests a single pixel.
+ *
+ * @return @c true if the paint is drawn in the region, @c false otherwise or if it has not been updated by any canvas.
+ *
+ * @note The changes of the paint after the last tvg_canvas_update() are not reflected.
+ * @note Experimental API
+ */
+TVG_API bool tvg_paint_intersects(Tvg_Paint* paint, int32_t x, int32_t y, int32_t w, int32_t h);
+
+
 /*!
 * @brief Sets the masking target object and the masking method.
 *
@@ -1189,6 +1504,29 @@ TVG_API Tvg_Result tvg_shape_append_circle(Tvg_Paint* paint, float cx, float cy,
 TVG_API Tvg_Result tvg_shape_append_path(Tvg_Paint* paint, const Tvg_Path_Command* cmds, uint32_t cmdCnt, const Tvg_Point* pts, uint32_t ptsCnt);
 
 
+/*!
+* @brief Replaces the path with the given path arrays, without copying them.
+*
+* The shape refers to the caller's arrays, and the renderer reads them directly. The arrays must be kept intact until
+* @p release is called, which happens once the engine no longer refers to them: the path is reset or modified,
+* or the shape and all its duplicates are destroyed. Any further modification of the path makes a private copy of it first.
+*
+* @param[in] paint A Tvg_Paint pointer to the shape object.
+* @param[in] cmds The array of the commands in the path.
+* @param[in] cmdCnt The length of the @p cmds array.
+* @param[in] pts The array of the two-dimensional points.
+* @param[in] ptsCnt The length of the @p pts array.
+* @param[in] release The function called with the @p data once the arrays are not referred anymore. It can be @c nullptr.
+* @param[in] data The user data passed to the @p release.
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_INVALID_ARGUMENT A @c nullptr passed as the argument or @p cmdCnt or @p ptsCnt equal to zero.
+*
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_shape_attach_path(Tvg_Paint* paint, const Tvg_Path_Command* cmds, uint32_t cmdCnt, const Tvg_Point* pts, uint32_t ptsCnt, void (*release)(void* data), void* data);
+
+
 /*!
 * @brief Retrieves the current path data of the shape.
 *
@@ -1212,6 +1550,26 @@ TVG_API Tvg_Result tvg_shape_append_path(Tvg_Paint* paint, const Tvg_Path_Comman
 TVG_API Tvg_Result tvg_shape_get_path(const Tvg_Paint* paint, const Tvg_Path_Command** cmds, uint32_t* cmdsCnt, const Tvg_Point** pts, uint32_t* ptsCnt);
 
 
+/*!
+* @brief Overwrites the points of the current path in place.
+*
+* The path commands are retained, only the coordinates are replaced. This is cheaper than tvg_shape_reset() and appending
+* the whole path again when a path is animated with the same commands every frame.
+*
+* @param[in] paint A Tvg_Paint pointer to the shape object.
+* @param[in] pts The array of the new two-dimensional points.
+* @param[in] begin The index of the first point of the path to be overwritten.
+* @param[in] cnt The length of the @p pts array.
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_INVALID_ARGUMENT A @c nullptr passed as the argument or @p cnt equal to zero.
+* @retval TVG_RESULT_INSUFFICIENT_CONDITION The range exceeds the points of the current path.
+*
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_shape_set_points(Tvg_Paint* paint, const Tvg_Point* pts, uint32_t begin, uint32_t cnt);
+
+
 /*!
 * @brief Sets the stroke width for all of the figures from the @p paint.
 *
@@ -1915,6 +2273,54 @@ TVG_API Tvg_Result tvg_picture_get_size(const Tvg_Paint* paint, float* w, float*
 TVG_API const Tvg_Paint* tvg_picture_get_paint(Tvg_Paint* paint, uint32_t id);
 
 
+/*!
+* @brief Lowers the priority of the picture loading to prefetch it in the background.
+*
+* The prefetched pictures are decoded by the worker threads only when no other tasks are queued,
+* and a prefetched picture is moved ahead of the others as soon as it's needed for drawing.
+*
+* @param[in] paint A Tvg_Paint pointer to the picture object.
+* @param[in] on If @c true, the next loading is prefetched. @c false brings the pending loading ahead of the others.
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_INVALID_ARGUMENT An invalid Tvg_Paint pointer.
+*
+* @note This takes effect on the next loading, and only when the assigned thread number is greater than zero.
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_picture_set_prefetch(Tvg_Paint* paint, bool on);
+
+
+/*!
+* @brief Checks whether the picture loading is done, so that drawing it won't wait for the loading.
+*
+* @param[in] paint A Tvg_Paint pointer to the picture object.
+* @param[out] ready @c true if the loaded picture is ready to draw, @c false otherwise.
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_INVALID_ARGUMENT An invalid Tvg_Paint pointer or @p ready.
+*
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_picture_get_ready(const Tvg_Paint* paint, bool* ready);
+
+
+/*!
+* @brief Cancels the prefetched loading of the picture if it's not started yet.
+*
+* The picture is loaded again on demand once it's drawn.
+*
+* @param[in] paint A Tvg_Paint pointer to the picture object.
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_INVALID_ARGUMENT An invalid Tvg_Paint pointer.
+* @retval TVG_RESULT_INSUFFICIENT_CONDITION No prefetched loading is pending, or the loaded data is shared with the other pictures.
+*
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_picture_cancel(Tvg_Paint* paint);
+
+
 /** \} */   // end defgroup ThorVGCapi_Picture
 
 
@@ -2512,6 +2918,23 @@ TVG_API Tvg_Result tvg_animation_set_segment(Tvg_Animation* animation, float beg
 TVG_API Tvg_Result tvg_animation_get_segment(Tvg_Animation* animation, float* begin, float* end);
 
 
+/*!
+* @brief Rasterizes all the frames of the animation in advance and plays them back as the image.
+*
+* @param[in] animation The Tvg_Animation pointer to the animation object.
+* @param[in] w The width of the baked frames in pixels. Both zeros release the baked frames.
+* @param[in] h The height of the baked frames in pixels.
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_INSUFFICIENT_CONDITION In case the animation is not loaded.
+* @retval TVG_RESULT_INVALID_ARGUMENT An invalid Tvg_Animation pointer, or only one of @p w and @p h is zero.
+* @retval TVG_RESULT_NOT_SUPPORTED When it's not animatable, it's not loaded from a file, or the software raster engine is not available.
+*
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_animation_bake(Tvg_Animation* animation, uint32_t w, uint32_t h);
+
+
 /*!
 * @brief Deletes the given Tvg_Animation object.
 *
@@ -2638,6 +3061,77 @@ TVG_API Tvg_Animation* tvg_lottie_animation_new(void);
 TVG_API Tvg_Result tvg_lottie_animation_override(Tvg_Animation* animation, const char* slot);
 
 
+/*!
+* @brief Overrides the value of a rotation or an opacity slot directly, without parsing any slot data.
+*
+* @param[in] animation The Tvg_Animation object to override the property with the slot.
+* @param[in] sid The slot id.
+* @param[in] val The rotation in degrees, or the opacity in percent (0 ~ 100), by the slot type.
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_INSUFFICIENT_CONDITION In case the animation is not loaded.
+* @retval TVG_RESULT_INVALID_ARGUMENT An invalid Tvg_Animation pointer or @p sid.
+* @retval TVG_RESULT_NOT_SUPPORTED If no rotation or opacity slot of @p sid is found.
+*
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_lottie_animation_override_value(Tvg_Animation* animation, const char* sid, float val);
+
+
+/*!
+* @brief Overrides the value of a scale or a position slot directly, without parsing any slot data.
+*
+* @param[in] animation The Tvg_Animation object to override the property with the slot.
+* @param[in] sid The slot id.
+* @param[in] x The horizontal scale in percent, or the x coordinate of the position, by the slot type.
+* @param[in] y The vertical scale in percent, or the y coordinate of the position, by the slot type.
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_INSUFFICIENT_CONDITION In case the animation is not loaded.
+* @retval TVG_RESULT_INVALID_ARGUMENT An invalid Tvg_Animation pointer or @p sid.
+* @retval TVG_RESULT_NOT_SUPPORTED If no scale or position slot of @p sid is found.
+*
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_lottie_animation_override_vector(Tvg_Animation* animation, const char* sid, float x, float y);
+
+
+/*!
+* @brief Overrides the value of a color slot directly, without parsing any slot data.
+*
+* @param[in] animation The Tvg_Animation object to override the property with the slot.
+* @param[in] sid The slot id.
+* @param[in] r The red color channel value in the range [0 ~ 255].
+* @param[in] g The green color channel value in the range [0 ~ 255].
+* @param[in] b The blue color channel value in the range [0 ~ 255].
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_INSUFFICIENT_CONDITION In case the animation is not loaded.
+* @retval TVG_RESULT_INVALID_ARGUMENT An invalid Tvg_Animation pointer or @p sid.
+* @retval TVG_RESULT_NOT_SUPPORTED If no color slot of @p sid is found.
+*
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_lottie_animation_override_color(Tvg_Animation* animation, const char* sid, uint8_t r, uint8_t g, uint8_t b);
+
+
+/*!
+* @brief Overrides the text of a text document slot directly, without parsing any slot data.
+*
+* @param[in] animation The Tvg_Animation object to override the property with the slot.
+* @param[in] sid The slot id.
+* @param[in] text The new text in UTF-8.
+*
+* @return Tvg_Result enumeration.
+* @retval TVG_RESULT_INSUFFICIENT_CONDITION In case the animation is not loaded.
+* @retval TVG_RESULT_INVALID_ARGUMENT An invalid Tvg_Animation pointer, @p sid or @p text.
+* @retval TVG_RESULT_NOT_SUPPORTED If no text document slot of @p sid is found.
+*
+* @note Experimental API
+*/
+TVG_API Tvg_Result tvg_lottie_animation_override_text(Tvg_Animation* animation, const char* sid, const char* text);
+
+
 /*!
 * @brief Specifies a segment by marker.
 *
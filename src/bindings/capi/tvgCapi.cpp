@@ -52,6 +52,24 @@ TVG_API Tvg_Result tvg_engine_term()
 }
 
 
+TVG_API Tvg_Result tvg_engine_init_with_allocator(unsigned threads, const Tvg_Allocator* allocator)
+{
+    return (Tvg_Result) Initializer::init(threads, reinterpret_cast<const Allocator*>(allocator));
+}
+
+
+TVG_API Tvg_Result tvg_engine_get_memory(Tvg_Memory_Category category, size_t* bytes)
+{
+    return (Tvg_Result) Initializer::memory((MemoryCategory) category, bytes);
+}
+
+
+TVG_API Tvg_Result tvg_engine_trim(Tvg_Trim_Level level)
+{
+    return (Tvg_Result) Initializer::trim((TrimLevel) level);
+}
+
+
 TVG_API Tvg_Result tvg_engine_version(uint32_t* major, uint32_t* minor, uint32_t* micro, const char** version)
 {
     if (version) *version = Initializer::version(major, minor, micro);
@@ -97,6 +115,27 @@ TVG_API Tvg_Result tvg_swcanvas_set_target(Tvg_Canvas* canvas, uint32_t* buffer,
 }
 
 
+TVG_API Tvg_Result tvg_swcanvas_set_banded_target(Tvg_Canvas* canvas, uint32_t* buffer, uint32_t stride, uint32_t w, uint32_t h, uint32_t lines, Tvg_Colorspace cs, void (*flush)(const uint32_t* buffer, uint32_t y, uint32_t lines, void* data), void* data)
+{
+    if (canvas) return (Tvg_Result) reinterpret_cast<SwCanvas*>(canvas)->target(buffer, stride, w, h, lines, static_cast<ColorSpace>(cs), flush, data);
+    return TVG_RESULT_INVALID_ARGUMENT;
+}
+
+
+TVG_API Tvg_Result tvg_swcanvas_set_dither(Tvg_Canvas* canvas, bool on)
+{
+    if (canvas) return (Tvg_Result) reinterpret_cast<SwCanvas*>(canvas)->dither(on);
+    return TVG_RESULT_INVALID_ARGUMENT;
+}
+
+
+TVG_API Tvg_Result tvg_swcanvas_set_tiles(Tvg_Canvas* canvas, bool on)
+{
+    if (canvas) return (Tvg_Result) reinterpret_cast<SwCanvas*>(canvas)->tiles(on);
+    return TVG_RESULT_INVALID_ARGUMENT;
+}
+
+
 TVG_API Tvg_Result tvg_glcanvas_set_target(Tvg_Canvas* canvas, void* context, int32_t id, uint32_t w, uint32_t h, Tvg_Colorspace cs)
 {
     if (canvas) return (Tvg_Result) reinterpret_cast<GlCanvas*>(canvas)->target(context, id, w, h, static_cast<ColorSpace>(cs));
@@ -153,6 +192,40 @@ TVG_API Tvg_Result tvg_canvas_sync(Tvg_Canvas* canvas)
 }
 
 
+//the C callback of a submitted drawing, released once it's notified
+struct CapiDrawCallback
+{
+    void (*func)(Tvg_Canvas* canvas, Tvg_Result result, void* data);
+    void* data;
+
+    static void notify(Canvas* canvas, Result result, void* data)
+    {
+        auto cb = static_cast<CapiDrawCallback*>(data);
+        cb->func((Tvg_Canvas*) canvas, (Tvg_Result) result, cb->data);
+        delete(cb);
+    }
+};
+
+
+TVG_API Tvg_Result tvg_canvas_submit(Tvg_Canvas* canvas, bool clear, void (*done)(Tvg_Canvas* canvas, Tvg_Result result, void* data), void* data)
+{
+    if (!canvas) return TVG_RESULT_INVALID_ARGUMENT;
+    if (!done) return (Tvg_Result) reinterpret_cast<Canvas*>(canvas)->submit(clear);
+
+    auto cb = new CapiDrawCallback{done, data};
+    auto ret = reinterpret_cast<Canvas*>(canvas)->submit(clear, CapiDrawCallback::notify, cb);
+    if (ret != Result::Success) delete(cb);
+    return (Tvg_Result) ret;
+}
+
+
+TVG_API Tvg_Result tvg_canvas_ready(const Tvg_Canvas* canvas)
+{
+    if (canvas) return (Tvg_Result) reinterpret_cast<const Canvas*>(canvas)->ready();
+    return TVG_RESULT_INVALID_ARGUMENT;
+}
+
+
 TVG_API Tvg_Result tvg_canvas_set_viewport(Tvg_Canvas* canvas, int32_t x, int32_t y, int32_t w, int32_t h)
 {
     if (canvas) return (Tvg_Result) reinterpret_cast<Canvas*>(canvas)->viewport(x, y, w, h);
@@ -160,6 +233,38 @@ TVG_API Tvg_Result tvg_canvas_set_viewport(Tvg_Canvas* canvas, int32_t x, int32_
 }
 
 
+TVG_API Tvg_Result tvg_canvas_get_damages(const Tvg_Canvas* canvas, const int32_t** regions, uint32_t* cnt)
+{
+    if (canvas) return (Tvg_Result) reinterpret_cast<const Canvas*>(canvas)->damages(regions, cnt);
+    return TVG_RESULT_INVALID_ARGUMENT;
+}
+
+
+TVG_API Tvg_Result tvg_canvas_set_flatness(Tvg_Canvas* canvas, float tolerance)
+{
+    if (canvas) return (Tvg_Result) reinterpret_cast<Canvas*>(canvas)->flatness(tolerance);
+    return TVG_RESULT_INVALID_ARGUMENT;
+}
+
+
+TVG_API Tvg_Result tvg_canvas_set_profiling(Tvg_Canvas* canvas, bool on)
+{
+    if (canvas) return (Tvg_Result) reinterpret_cast<Canvas*>(canvas)->profiling(on);
+    return TVG_RESULT_INVALID_ARGUMENT;
+}
+
+
+TVG_API Tvg_Result tvg_canvas_get_profile(const Tvg_Canvas* canvas, Tvg_Canvas_Profile* profile)
+{
+    if (!canvas || !profile) return TVG_RESULT_INVALID_ARGUMENT;
+    Canvas::Profile p;
+    auto ret = reinterpret_cast<const Canvas*>(canvas)->profile(&p);
+    if (ret != Result::Success) return (Tvg_Result) ret;
+    *profile = {p.update, p.prepare, p.preRender, p.raster, p.composite, p.effect, p.sync, p.gpu, p.shapes, p.spans, p.surfaces, p.cacheHits};
+    return TVG_RESULT_SUCCESS;
+}
+
+
 /************************************************************************/
 /* Paint API                                                            */
 /************************************************************************/
@@ -275,6 +380,12 @@ TVG_API Tvg_Result tvg_paint_get_obb(const Tvg_Paint* paint, Tvg_Point* pt4)
     return TVG_RESULT_INVALID_ARGUMENT;
 }
 
+TVG_API bool tvg_paint_intersects(Tvg_Paint* paint, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+    if (paint) return reinterpret_cast<Paint*>(paint)->intersects(x, y, w, h);
+    return false;
+}
+
 TVG_API Tvg_Result tvg_paint_set_mask_method(Tvg_Paint* paint, Tvg_Paint* target, Tvg_Mask_Method method)
 {
     if (paint) return (Tvg_Result) reinterpret_cast<Paint*>(paint)->mask((Paint*)target, (MaskMethod)method);
@@ -389,6 +500,13 @@ TVG_API Tvg_Result tvg_shape_append_path(Tvg_Paint* paint, const Tvg_Path_Comman
 }
 
 
+TVG_API Tvg_Result tvg_shape_attach_path(Tvg_Paint* paint, const Tvg_Path_Command* cmds, uint32_t cmdCnt, const Tvg_Point* pts, uint32_t ptsCnt, void (*release)(void* data), void* data)
+{
+    if (paint) return (Tvg_Result) reinterpret_cast<Shape*>(paint)->attachPath((const PathCommand*)cmds, cmdCnt, (const Point*)pts, ptsCnt, release, data);
+    return TVG_RESULT_INVALID_ARGUMENT;
+}
+
+
 TVG_API Tvg_Result tvg_shape_get_path(const Tvg_Paint* paint, const Tvg_Path_Command** cmds, uint32_t* cmdsCnt, const Tvg_Point** pts, uint32_t* ptsCnt)
 {
     if (paint) return (Tvg_Result) reinterpret_cast<const Shape*>(paint)->path((const PathCommand**)cmds, cmdsCnt, (const Point**)pts, ptsCnt);
@@ -396,6 +514,13 @@ TVG_API Tvg_Result tvg_shape_get_path(const Tvg_Paint* paint, const Tvg_Path_Com
 }
 
 
+TVG_API Tvg_Result tvg_shape_set_points(Tvg_Paint* paint, const Tvg_Point* pts, uint32_t begin, uint32_t cnt)
+{
+    if (paint) return (Tvg_Result) reinterpret_cast<Shape*>(paint)->points((const Point*)pts, begin, cnt);
+    return TVG_RESULT_INVALID_ARGUMENT;
+}
+
+
 TVG_API Tvg_Result tvg_shape_set_stroke_width(Tvg_Paint* paint, float width)
 {
     if (paint) return (Tvg_Result) reinterpret_cast<Shape*>(paint)->strokeWidth(width);
@@ -625,6 +750,28 @@ TVG_API const Tvg_Paint* tvg_picture_get_paint(Tvg_Paint* paint, uint32_t id)
 }
 
 
+TVG_API Tvg_Result tvg_picture_set_prefetch(Tvg_Paint* paint, bool on)
+{
+    if (paint) return (Tvg_Result) reinterpret_cast<Picture*>(paint)->prefetch(on);
+    return TVG_RESULT_INVALID_ARGUMENT;
+}
+
+
+TVG_API Tvg_Result tvg_picture_get_ready(const Tvg_Paint* paint, bool* ready)
+{
+    if (!paint || !ready) return TVG_RESULT_INVALID_ARGUMENT;
+    *ready = reinterpret_cast<const Picture*>(paint)->ready();
+    return TVG_RESULT_SUCCESS;
+}
+
+
+TVG_API Tvg_Result tvg_picture_cancel(Tvg_Paint* paint)
+{
+    if (paint) return (Tvg_Result) reinterpret_cast<Picture*>(paint)->cancel();
+    return TVG_RESULT_INVALID_ARGUMENT;
+}
+
+
 /************************************************************************/
 /* Gradient API                                                         */
 /************************************************************************/
@@ -978,6 +1125,13 @@ TVG_API Tvg_Result tvg_animation_get_segment(Tvg_Animation* animation, float* st
 }
 
 
+TVG_API Tvg_Result tvg_animation_bake(Tvg_Animation* animation, uint32_t w, uint32_t h)
+{
+    if (animation) return (Tvg_Result) reinterpret_cast<Animation*>(animation)->bake(w, h);
+    return TVG_RESULT_INVALID_ARGUMENT;
+}
+
+
 TVG_API Tvg_Result tvg_animation_del(Tvg_Animation* animation)
 {
     if (animation) {
@@ -1045,6 +1199,46 @@ TVG_API Tvg_Result tvg_lottie_animation_override(Tvg_Animation* animation, const
 }
 
 
+TVG_API Tvg_Result tvg_lottie_animation_override_value(Tvg_Animation* animation, const char* sid, float val)
+{
+#ifdef THORVG_LOTTIE_LOADER_SUPPORT
+    if (animation) return (Tvg_Result) reinterpret_cast<LottieAnimation*>(animation)->override(sid, val);
+    return TVG_RESULT_INVALID_ARGUMENT;
+#endif
+    return TVG_RESULT_NOT_SUPPORTED;
+}
+
+
+TVG_API Tvg_Result tvg_lottie_animation_override_vector(Tvg_Animation* animation, const char* sid, float x, float y)
+{
+#ifdef THORVG_LOTTIE_LOADER_SUPPORT
+    if (animation) return (Tvg_Result) reinterpret_cast<LottieAnimation*>(animation)->override(sid, x, y);
+    return TVG_RESULT_INVALID_ARGUMENT;
+#endif
+    return TVG_RESULT_NOT_SUPPORTED;
+}
+
+
+TVG_API Tvg_Result tvg_lottie_animation_override_color(Tvg_Animation* animation, const char* sid, uint8_t r, uint8_t g, uint8_t b)
+{
+#ifdef THORVG_LOTTIE_LOADER_SUPPORT
+    if (animation) return (Tvg_Result) reinterpret_cast<LottieAnimation*>(animation)->override(sid, r, g, b);
+    return TVG_RESULT_INVALID_ARGUMENT;
+#endif
+    return TVG_RESULT_NOT_SUPPORTED;
+}
+
+
+TVG_API Tvg_Result tvg_lottie_animation_override_text(Tvg_Animation* animation, const char* sid, const char* text)
+{
+#ifdef THORVG_LOTTIE_LOADER_SUPPORT
+    if (animation) return (Tvg_Result) reinterpret_cast<LottieAnimation*>(animation)->override(sid, text);
+    return TVG_RESULT_INVALID_ARGUMENT;
+#endif
+    return TVG_RESULT_NOT_SUPPORTED;
+}
+
+
 TVG_API Tvg_Result tvg_lottie_animation_set_marker(Tvg_Animation* animation, const char* marker)
 {
 #ifdef THORVG_LOTTIE_LOADER_SUPPORT
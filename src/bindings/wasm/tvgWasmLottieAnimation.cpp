@@ -20,6 +20,8 @@
  * SOFTWARE.
  */
 
+#include <algorithm>
+#include <thread>
 #include <thorvg.h>
 #include <emscripten.h>
 #include <emscripten/bind.h>
@@ -41,6 +43,10 @@ struct TvgEngineMethod
     {
         return val(typed_memory_view<uint8_t>(0, nullptr));
     }
+    virtual val image(int w, int h)
+    {
+        return val::null();
+    }
 
     void loadFont() {
         Text::load("default", requestFont(), DEFAULT_FONT_SIZE, "ttf", false);
@@ -62,7 +68,12 @@ struct TvgSwEngine : TvgEngineMethod
 
     Canvas* init(string&) override
     {
+#ifdef THORVG_THREAD_SUPPORT
+        //the workers run on the pthread pool(Web Workers) prepared by the module, see cross/wasm32_sw_mt.txt
+        Initializer::init(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+#else
         Initializer::init(0);
+#endif
         loadFont();
         return SwCanvas::gen();
     }
@@ -78,6 +89,21 @@ struct TvgSwEngine : TvgEngineMethod
     {
         return val(typed_memory_view(w * h * 4, buffer));
     }
+
+    //ImageData over the wasm memory, the straight RGBA target is taken as it is
+    val image(int w, int h) override
+    {
+        auto view = val(typed_memory_view(w * h * 4, buffer));
+        auto memory = view["buffer"];
+
+        //the shared memory (threads build) isn't allowed for ImageData, a copy is inevitable then
+        auto shared = val::global("SharedArrayBuffer");
+        auto pixels = val::global("Uint8ClampedArray");
+        if (!shared.isUndefined() && memory.instanceof(shared)) pixels = pixels.new_(view);
+        else pixels = pixels.new_(memory, view["byteOffset"], view["length"]);
+
+        return val::global("ImageData").new_(pixels, w, h);
+    }
 };
 
 #endif
@@ -347,22 +373,27 @@ public:
 
     val render()
     {
-        errorMsg = NoError;
-
-        if (!canvas || !animation) return val(typed_memory_view<uint8_t>(0, nullptr));
-
-        if (!updated) return engine->output(width, height);
-
-        if (canvas->draw(true) != Result::Success) {
-            errorMsg = "draw() fail";
-            return val(typed_memory_view<uint8_t>(0, nullptr));
-        }
-
-        canvas->sync();
+        if (!draw()) return val(typed_memory_view<uint8_t>(0, nullptr));
+        return engine->output(width, height);
+    }
 
-        updated = false;
+    /* The rendered frame as an ImageData viewing the target buffer directly, without copying.
+       It's valid until the next render() or resize(), which may overwrite or reallocate the buffer.
+       Returns null with the engines rendering on the canvas element by themselves. */
+    val imageData()
+    {
+        if (!draw()) return val::null();
+        return engine->image(width, height);
+    }
 
-        return engine->output(width, height);
+    /* Renders and puts the frame on the given 2d context, either of a canvas element or of an OffscreenCanvas
+       transferred to a worker, which presents it without the round trip through the main thread. */
+    bool present(val context)
+    {
+        auto image = imageData();
+        if (image.isNull()) return false;
+        context.call<void>("putImageData", image, 0, 0);
+        return true;
     }
 
     bool update()
@@ -498,6 +529,26 @@ public:
     // TODO: Advanced APIs wrt Interactivity & theme methods...
 
 private:
+    bool draw()
+    {
+        errorMsg = NoError;
+
+        if (!canvas || !animation) return false;
+
+        if (!updated) return true;
+
+        if (canvas->draw(true) != Result::Success) {
+            errorMsg = "draw() fail";
+            return false;
+        }
+
+        canvas->sync();
+
+        updated = false;
+
+        return true;
+    }
+
     string                 errorMsg;
     Canvas*                canvas = nullptr;
     Animation*             animation = nullptr;
@@ -541,6 +592,8 @@ EMSCRIPTEN_BINDINGS(thorvg_bindings)
         .function("totalFrame", &TvgLottieAnimation ::totalFrame)
         .function("curFrame", &TvgLottieAnimation ::curFrame)
         .function("render", &TvgLottieAnimation::render)
+        .function("imageData", &TvgLottieAnimation::imageData)
+        .function("present", &TvgLottieAnimation::present)
         .function("load", &TvgLottieAnimation ::load)
         .function("update", &TvgLottieAnimation ::update)
         .function("frame", &TvgLottieAnimation ::frame)
@@ -39,27 +39,24 @@ struct Array
 {
     T* data = nullptr;
     uint32_t count = 0;
-    uint32_t reserved = 0;
+    uint32_t reserved : 31;
+    uint32_t local : 1;     //data is the inline storage of a SmallArray or the shared elements, not owned
 
-    Array() = default;
+    Array() : reserved(0), local(0) {}
 
-    Array(int32_t size)
+    Array(int32_t size) : reserved(0), local(0)
     {
         reserve(size);
     }
 
-    Array(const Array& rhs)
+    Array(const Array& rhs) : reserved(0), local(0)
     {
-        reset();
         *this = rhs;
     }
 
     void push(T element)
     {
-        if (count + 1 > reserved) {
-            reserved = count + (count + 2) / 2;
-            data = tvg::realloc<T*>(data, sizeof(T) * reserved);
-        }
+        if (count + 1 > reserved) reserve(count + (count + 2) / 2);
         data[count++] = element;
     }
 
@@ -74,8 +71,14 @@ struct Array
     bool reserve(uint32_t size)
     {
         if (size > reserved) {
+            //spill the inline elements to the heap
+            if (local) {
+                auto heap = tvg::malloc<T*>(sizeof(T) * size);
+                if (count > 0) memcpy(heap, data, sizeof(T) * count);
+                data = heap;
+                local = 0;
+            } else data = tvg::realloc<T*>(data, sizeof(T) * size);
             reserved = size;
-            data = tvg::realloc<T*>(data, sizeof(T) * reserved);
         }
         return true;
     }
@@ -105,6 +108,14 @@ struct Array
     void move(Array& to)
     {
         to.reset();
+
+        //the inline storage stays here
+        if (local) {
+            to = *this;
+            count = 0;
+            return;
+        }
+
         to.data = data;
         to.count = count;
         to.reserved = reserved;
@@ -113,6 +124,15 @@ struct Array
         count = reserved = 0;
     }
 
+    //refer to the elements of the other without the copy, they are copied on the first write by the push() or reserve()
+    void share(const Array& rhs)
+    {
+        reset();
+        data = rhs.data;
+        count = rhs.count;
+        local = 1;
+    }
+
     const T* begin() const
     {
         return data;
@@ -166,9 +186,10 @@ struct Array
 
     void reset()
     {
-        tvg::free(data);
+        if (!local) tvg::free(data);
         data = nullptr;
         count = reserved = 0;
+        local = 0;
     }
 
     void clear()
@@ -188,10 +209,34 @@ struct Array
 
     ~Array()
     {
-        tvg::free(data);
+        if (!local) tvg::free(data);
     }
 };
 
+
+//keeps the first N elements inline, for the short-lived small arrays on the hot paths.
+//it spills to the heap beyond N, and can be passed as an Array.
+template<class T, uint32_t N>
+struct SmallArray : Array<T>
+{
+    SmallArray()
+    {
+        this->data = reinterpret_cast<T*>(storage);
+        this->reserved = N;
+        this->local = 1;
+    }
+
+    SmallArray(const SmallArray&) = delete;
+
+    void operator=(const Array<T>& rhs)
+    {
+        Array<T>::operator=(rhs);
+    }
+
+private:
+    alignas(T) char storage[sizeof(T) * N];
+};
+
 }
 
 #endif //_TVG_ARRAY_H_
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "config.h"
+#include <cstdio>
+#include "tvgCommon.h"
+#include "tvgFile.h"
+
+#ifdef THORVG_FILE_IO_SUPPORT
+    #if defined(_WIN32) && (WINAPI_FAMILY == WINAPI_FAMILY_DESKTOP_APP)
+        #include <windows.h>
+        #define TVG_FILE_MAPPING_WIN32
+    #elif defined(__linux__) || defined(__APPLE__) || defined(__unix__)
+        #include <fcntl.h>
+        #include <unistd.h>
+        #include <sys/mman.h>
+        #include <sys/stat.h>
+        #define TVG_FILE_MAPPING_POSIX
+    #endif
+#endif
+
+/************************************************************************/
+/* Internal Class Implementation                                        */
+/************************************************************************/
+
+#ifdef THORVG_FILE_IO_SUPPORT
+
+#if defined(TVG_FILE_MAPPING_WIN32)
+
+static uint8_t* _map(const char* path, uint8_t flags, uint32_t& size, void*& handle)
+{
+    //the tail of the view isn't promised to be zero, the terminated content is read
+    if (flags & FileMap::Terminated) return nullptr;
+
+    auto file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, (flags & FileMap::Random) ? FILE_FLAG_RANDOM_ACCESS : 0, NULL);
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+
+    DWORD high;
+    auto low = GetFileSize(file, &high);
+    if (low == INVALID_FILE_SIZE || low == 0 || high > 0) {
+        CloseHandle(file);
+        return nullptr;
+    }
+
+    auto writable = flags & FileMap::Writable;
+    auto mapping = CreateFileMapping(file, NULL, writable ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping) return nullptr;
+
+    auto data = (uint8_t*) MapViewOfFile(mapping, writable ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(mapping);
+        return nullptr;
+    }
+
+    size = (uint32_t) low;
+    handle = mapping;
+    return data;
+}
+
+
+static void _unmap(uint8_t* data, TVG_UNUSED uint32_t size, void* handle)
+{
+    UnmapViewOfFile(data);
+    CloseHandle(handle);
+}
+
+#elif defined(TVG_FILE_MAPPING_POSIX)
+
+//the pages are read in on demand and shared with the other processes until they are written
+static uint8_t* _map(const char* path, uint8_t flags, uint32_t& size, TVG_UNUSED void*& handle)
+{
+    auto fd = open(path, O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    struct stat info;
+    if (fstat(fd, &info) < 0 || info.st_size <= 0 || info.st_size > UINT32_MAX) {
+        close(fd);
+        return nullptr;
+    }
+
+    //the zero-filled tail of the last page terminates the content, a full page has none
+    auto terminated = flags & FileMap::Terminated;
+    if (terminated && info.st_size % sysconf(_SC_PAGESIZE) == 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    auto prot = (flags & FileMap::Writable) ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    auto data = mmap(nullptr, (size_t) info.st_size + (terminated ? 1 : 0), prot, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return nullptr;
+
+    if (flags & FileMap::Random) madvise(data, (size_t) info.st_size, MADV_RANDOM);
+
+    size = (uint32_t) info.st_size;
+    return (uint8_t*) data;
+}
+
+
+static void _unmap(uint8_t* data, uint32_t size, TVG_UNUSED void* handle)
+{
+    munmap((void*) data, (size_t) size);
+}
+
+#else
+
+static uint8_t* _map(TVG_UNUSED const char* path, TVG_UNUSED uint8_t flags, TVG_UNUSED uint32_t& size, TVG_UNUSED void*& handle)
+{
+    return nullptr;
+}
+
+
+static void _unmap(TVG_UNUSED uint8_t* data, TVG_UNUSED uint32_t size, TVG_UNUSED void* handle)
+{
+}
+
+#endif
+
+
+static uint8_t* _read(const char* path, uint8_t flags, uint32_t& size)
+{
+    auto f = fopen(path, "rb");
+    if (!f) return nullptr;
+
+    fseek(f, 0, SEEK_END);
+    auto len = ftell(f);
+    if (len <= 0 || (unsigned long) len > UINT32_MAX) {
+        fclose(f);
+        return nullptr;
+    }
+
+    auto terminated = (flags & FileMap::Terminated) ? 1 : 0;
+    auto data = tvg::malloc<uint8_t*>(len + terminated);
+    if (!data) {
+        fclose(f);
+        return nullptr;
+    }
+
+    fseek(f, 0, SEEK_SET);
+    size = (uint32_t) fread(data, sizeof(uint8_t), len, f);
+    fclose(f);
+
+    if (size == 0) {
+        tvg::free(data);
+        return nullptr;
+    }
+    if (terminated) data[size] = '\0';
+
+    return data;
+}
+
+#endif //THORVG_FILE_IO_SUPPORT
+
+
+/************************************************************************/
+/* External Class Implementation                                        */
+/************************************************************************/
+
+namespace tvg {
+
+bool FileMap::open(TVG_UNUSED const char* path, TVG_UNUSED uint8_t flags)
+{
+#ifdef THORVG_FILE_IO_SUPPORT
+    close();
+
+    if ((data = _map(path, flags, size, handle))) {
+        mapped = true;
+        return true;
+    }
+
+    data = _read(path, flags, size);
+    return data != nullptr;
+#else
+    return false;
+#endif
+}
+
+
+void FileMap::close()
+{
+    if (!data) return;
+
+#ifdef THORVG_FILE_IO_SUPPORT
+    if (mapped) _unmap(data, size, handle);
+    else tvg::free(data);
+#endif
+
+    data = nullptr;
+    size = 0;
+    handle = nullptr;
+    mapped = false;
+}
+
+}
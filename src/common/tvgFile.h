@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _TVG_FILE_H_
+#define _TVG_FILE_H_
+
+#include <cstdint>
+
+namespace tvg
+{
+
+//the whole content of a file, mapped in where the platform allows or read into the heap otherwise
+struct FileMap
+{
+    enum Flag : uint8_t
+    {
+        None = 0,
+        Writable = 1,       //the writes go to the private copies of the pages, never to the file
+        Terminated = 2,     //a zero byte follows the content
+        Random = 4          //the content is looked up at random, no read-ahead
+    };
+
+    uint8_t* data = nullptr;
+    uint32_t size = 0;
+
+    bool open(const char* path, uint8_t flags = None);
+    void close();
+
+private:
+    void* handle = nullptr;     //the file mapping object (windows)
+    bool mapped = false;        //false if the content is read into the heap
+};
+
+}
+
+#endif //_TVG_FILE_H_
@@ -84,7 +84,8 @@ struct Inlist
         if (!tail) return nullptr;
         auto t = tail;
         tail = t->prev;
-        if (!tail) head = nullptr;
+        if (tail) tail->next = nullptr;
+        else head = nullptr;
         return t;
     }
 
@@ -93,7 +94,8 @@ struct Inlist
         if (!head) return nullptr;
         auto t = head;
         head = t->next;
-        if (!head) tail = nullptr;
+        if (head) head->prev = nullptr;
+        else tail = nullptr;
         return t;
     }
 
@@ -26,6 +26,7 @@
 #ifdef THORVG_THREAD_SUPPORT
 
 #include <mutex>
+#include <shared_mutex>
 #include "tvgTaskScheduler.h"
 
 namespace tvg {
@@ -41,7 +42,7 @@ namespace tvg {
 
         ScopedLock(Key& k)
         {
-            if (TaskScheduler::threads() > 0) {
+            if (TaskScheduler::concurrent()) {
                 k.mtx.lock();
                 key = &k;
             }
@@ -49,10 +50,36 @@ namespace tvg {
 
         ~ScopedLock()
         {
-            if (TaskScheduler::threads() > 0) {
-                key->mtx.unlock();
+            if (key) key->mtx.unlock();
+        }
+    };
+
+    //the readers share it, the writer holds it alone
+    struct SharedKey
+    {
+        std::shared_timed_mutex mtx;
+    };
+
+    struct SharedLock
+    {
+        SharedKey* key = nullptr;
+        bool exclusive;
+
+        SharedLock(SharedKey& k, bool exclusive = false) : exclusive(exclusive)
+        {
+            if (TaskScheduler::concurrent()) {
+                if (exclusive) k.mtx.lock();
+                else k.mtx.lock_shared();
+                key = &k;
             }
         }
+
+        ~SharedLock()
+        {
+            if (!key) return;
+            if (exclusive) key->mtx.unlock();
+            else key->mtx.unlock_shared();
+        }
     };
 
 }
@@ -68,6 +95,13 @@ namespace tvg {
         ScopedLock(Key& key) {}
     };
 
+    struct SharedKey {};
+
+    struct SharedLock
+    {
+        SharedLock(SharedKey& key, bool exclusive = false) {}
+    };
+
 }
 
 #endif //THORVG_THREAD_SUPPORT
@@ -22,6 +22,14 @@
 
 #include "tvgMath.h"
 
+#if defined(THORVG_AVX_VECTOR_SUPPORT) && (defined(__SSE2__) || defined(_M_X64))
+    #include <emmintrin.h>
+    #define MATH_SSE2 1
+#elif defined(THORVG_NEON_VECTOR_SUPPORT)
+    #include <arm_neon.h>
+    #define MATH_NEON 1
+#endif
+
 #define BEZIER_EPSILON 1e-2f
 
 
@@ -143,6 +151,19 @@ float length(const PathCommand* cmds, uint32_t cmdsCnt, const Point* pts, uint32
 }
 
 
+//the sagitta of each segment stays within the tolerance, the radius is on the screen
+uint32_t arcSegments(float radius, float angle, float tolerance)
+{
+    static constexpr float MAX_SEGMENTS = 256.0f;   //a full circle beyond this is smooth enough at any scale
+
+    if (!(radius > tolerance)) return 1;
+    auto step = 2.0f * acosf(1.0f - tolerance / radius);
+    auto cnt = ceilf(fabsf(angle) / step);
+    if (!(cnt < MAX_SEGMENTS)) return uint32_t(MAX_SEGMENTS);
+    return cnt < 1.0f ? 1 : uint32_t(cnt);
+}
+
+
 //https://en.wikipedia.org/wiki/Remez_algorithm
 float atan2(float y, float x)
 {
@@ -246,6 +267,39 @@ void operator*=(Point& pt, const Matrix& m)
 }
 
 
+//two points per vector, in the same operation order as the scalar one for the identical results
+void transform(const Point* in, Point* out, uint32_t cnt, const Matrix& m)
+{
+    uint32_t i = 0;
+
+#if defined(MATH_SSE2)
+    auto m0 = _mm_setr_ps(m.e11, m.e21, m.e11, m.e21);
+    auto m1 = _mm_setr_ps(m.e12, m.e22, m.e12, m.e22);
+    auto m2 = _mm_setr_ps(m.e13, m.e23, m.e13, m.e23);
+    for (; i + 2 <= cnt; i += 2) {
+        auto p = _mm_loadu_ps(&in[i].x);
+        auto x = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+        auto y = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+        _mm_storeu_ps(&out[i].x, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m0), _mm_mul_ps(y, m1)), m2));
+    }
+#elif defined(MATH_NEON)
+    const float c0[] = {m.e11, m.e21, m.e11, m.e21};
+    const float c1[] = {m.e12, m.e22, m.e12, m.e22};
+    const float c2[] = {m.e13, m.e23, m.e13, m.e23};
+    auto m0 = vld1q_f32(c0);
+    auto m1 = vld1q_f32(c1);
+    auto m2 = vld1q_f32(c2);
+    for (; i + 2 <= cnt; i += 2) {
+        auto p = vld1q_f32(&in[i].x);
+        auto xy = vtrnq_f32(p, p);  //{x0, x0, x1, x1}, {y0, y0, y1, y1}
+        vst1q_f32(&out[i].x, vaddq_f32(vaddq_f32(vmulq_f32(xy.val[0], m0), vmulq_f32(xy.val[1], m1)), m2));
+    }
+#endif
+
+    for (; i < cnt; ++i) out[i] = in[i] * m;
+}
+
+
 Point operator*(const Point& pt, const Matrix& m)
 {
     auto tx = pt.x * m.e11 + pt.y * m.e12 + m.e13;
@@ -464,7 +518,7 @@ void Bezier::bounds(Point& min, Point& max) const
     findMinMax(start.y, ctrl1.y, ctrl2.y, end.y, min.y, max.y);
 }
 
-bool Bezier::flatten() const
+bool Bezier::flatten(float tolerance) const
 {
     float diff1_x = fabsf((ctrl1.x * 3.f) - (start.x * 2.f) - end.x);
     float diff1_y = fabsf((ctrl1.y * 3.f) - (start.y * 2.f) - end.y);
@@ -472,17 +526,18 @@ bool Bezier::flatten() const
     float diff2_y = fabsf((ctrl2.y * 3.f) - (end.y * 2.f) - start.y);
     if (diff1_x < diff2_x) diff1_x = diff2_x;
     if (diff1_y < diff2_y) diff1_y = diff2_y;
-    return (diff1_x + diff1_y <= 0.5f);
+    //the distance from the chord is at most a quarter of the sum
+    return (diff1_x + diff1_y <= tolerance * 4.0f);
 }
 
 
 //TODO: Consider to use while() instead of recursive stack calls
-uint32_t Bezier::segments() const
+uint32_t Bezier::segments(float tolerance) const
 {
-    if (flatten()) return 1;
+    if (flatten(tolerance)) return 1;
     Bezier left, right;
     split(left, right);
-    return left.segments() + right.segments();
+    return left.segments(tolerance) + right.segments(tolerance);
 }
 
 
@@ -36,6 +36,7 @@ namespace tvg
 #define MATH_PI2 1.57079632679489661923f
 #define FLOAT_EPSILON 1.0e-06f  //1.192092896e-07f
 #define PATH_KAPPA 0.552284f
+#define FLATNESS_TOLERANCE 0.125f  //the default max distance in pixels between a curve and its flattened segments
 
 /************************************************************************/
 /* General functions                                                    */
@@ -43,6 +44,7 @@ namespace tvg
 
 float atan2(float y, float x);
 float length(const PathCommand* cmds, uint32_t cmdsCnt, const Point* pts, uint32_t ptsCnt);
+uint32_t arcSegments(float radius, float angle, float tolerance);
 
 
 static inline float deg2rad(float degree)
@@ -186,6 +188,7 @@ static inline void log(const Matrix& m)
 
 void operator*=(Point& pt, const Matrix& m);
 Point operator*(const Point& pt, const Matrix& m);
+void transform(const Point* in, Point* out, uint32_t cnt, const Matrix& m);
 Point normal(const Point& p1, const Point& p2);
 void normalize(Point& pt);
 
@@ -406,8 +409,8 @@ struct Bezier
     Point at(float t) const;
     float angle(float t) const;
     void bounds(Point& min, Point& max) const;
-    bool flatten() const;
-    uint32_t segments() const;
+    bool flatten(float tolerance = FLATNESS_TOLERANCE) const;
+    uint32_t segments(float tolerance = FLATNESS_TOLERANCE) const;
 
     Bezier operator*(const Matrix& m);
 };
@@ -23,6 +23,7 @@
 #ifndef _TVG_JPG_LOADER_H_
 #define _TVG_JPG_LOADER_H_
 
+#include "tvgFile.h"
 #include "tvgLoader.h"
 
 using tjhandle = void*;
@@ -42,6 +43,7 @@ private:
     void clear();
 
     tjhandle jpegDecompressor;
+    FileMap file;
     unsigned char* data = nullptr;
     unsigned long size = 0;
     bool freeData = false;
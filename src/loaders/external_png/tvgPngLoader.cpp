@@ -31,6 +31,7 @@ void PngLoader::clear()
     png_image_free(image);
     tvg::free(image);
     image = nullptr;
+    file.close();
 }
 
 /************************************************************************/
@@ -53,14 +54,20 @@ PngLoader::~PngLoader()
 
 bool PngLoader::open(const char* path)
 {
+#ifdef THORVG_FILE_IO_SUPPORT
+    if (!file.open(path)) return false;
+
     image->opaque = NULL;
 
-    if (!png_image_begin_read_from_file(image, path)) return false;
+    if (!png_image_begin_read_from_memory(image, file.data, file.size)) return false;
 
     w = (float)image->width;
     h = (float)image->height;
 
     return true;
+#else
+    return false;
+#endif
 }
 
 
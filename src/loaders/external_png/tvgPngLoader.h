@@ -24,6 +24,7 @@
 #define _TVG_PNG_LOADER_H_
 
 #include <png.h>
+#include "tvgFile.h"
 #include "tvgLoader.h"
 
 class PngLoader : public ImageLoader
@@ -40,6 +41,7 @@ private:
     void clear();
 
     png_imagep image = nullptr;
+    FileMap file;
 };
 
 #endif //_TVG_PNG_LOADER_H_
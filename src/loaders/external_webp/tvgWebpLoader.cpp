@@ -32,6 +32,8 @@
 
 void WebpLoader::run(unsigned tid)
 {
+    MemoryScope scope(MemoryCategory::Loader);
+
     //TODO: acquire the current colorspace format & pre-multiplied alpha image.
     surface.buf8 = WebPDecodeBGRA(data, size, nullptr, nullptr);
     surface.stride = (uint32_t)w;
@@ -58,6 +60,7 @@ WebpLoader::~WebpLoader()
     done();
 
     if (freeData) tvg::free(data);
+    file.close();
     data = nullptr;
     size = 0;
     freeData = false;
@@ -68,34 +71,18 @@ WebpLoader::~WebpLoader()
 bool WebpLoader::open(const char* path)
 {
 #ifdef THORVG_FILE_IO_SUPPORT
-    auto webpFile = fopen(path, "rb");
-    if (!webpFile) return false;
-
-    auto ret = false;
-
-    //determine size
-    if (fseek(webpFile, 0, SEEK_END) < 0) goto finalize;
-    if (((size = ftell(webpFile)) < 1)) goto finalize;
-    if (fseek(webpFile, 0, SEEK_SET)) goto finalize;
-
-    data = tvg::malloc<unsigned char*>(size);
-    if (!data) goto finalize;
+    if (!file.open(path)) return false;
 
-    freeData = true;
-
-    if (fread(data, size, 1, webpFile) < 1) goto finalize;
+    data = file.data;
+    size = file.size;
 
     int width, height;
-    if (!WebPGetInfo(data, size, &width, &height)) goto finalize;
+    if (!WebPGetInfo(data, size, &width, &height)) return false;
 
     w = static_cast<float>(width);
     h = static_cast<float>(height);
 
-    ret = true;
-
-finalize:
-    fclose(webpFile);
-    return ret;
+    return true;
 #else
     return false;
 #endif
@@ -131,7 +118,7 @@ bool WebpLoader::read()
 
     if (!data || w == 0 || h == 0) return false;
 
-    TaskScheduler::request(this);
+    request(this);
 
     return true;
 }
@@ -23,6 +23,7 @@
 #ifndef _TVG_WEBP_LOADER_H_
 #define _TVG_WEBP_LOADER_H_
 
+#include "tvgFile.h"
 #include "tvgLoader.h"
 #include "tvgTaskScheduler.h"
 
@@ -41,6 +42,7 @@ public:
 private:
     void run(unsigned tid) override;
 
+    FileMap file;
     unsigned char* data = nullptr;
     unsigned long size = 0;
     bool freeData = false;
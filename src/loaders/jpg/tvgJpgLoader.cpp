@@ -30,6 +30,7 @@ void JpgLoader::clear()
 {
     jpgdDelete(decoder);
     if (freeData) tvg::free(data);
+    file.close();
     decoder = nullptr;
     data = nullptr;
     freeData = false;
@@ -38,10 +39,12 @@ void JpgLoader::clear()
 
 void JpgLoader::run(unsigned tid)
 {
-    surface.buf8 = jpgdDecompress(decoder);
-    surface.stride = static_cast<uint32_t>(w);
-    surface.w = static_cast<uint32_t>(w);
-    surface.h = static_cast<uint32_t>(h);
+    MemoryScope scope(MemoryCategory::Loader);
+
+    surface.buf8 = jpgdDecompress(decoder, reduction);
+    surface.w = (static_cast<uint32_t>(w) + (1 << reduction) - 1) >> reduction;
+    surface.h = (static_cast<uint32_t>(h) + (1 << reduction) - 1) >> reduction;
+    surface.stride = surface.w;
     surface.cs = ColorSpace::ARGB8888;
     surface.channelSize = sizeof(uint32_t);
     surface.premultiplied = true;
@@ -71,8 +74,12 @@ JpgLoader::~JpgLoader()
 bool JpgLoader::open(const char* path)
 {
 #ifdef THORVG_FILE_IO_SUPPORT
+    if (!file.open(path)) return false;
+
+    data = (char*)file.data;
+
     int width, height;
-    decoder = jpgdHeader(path, &width, &height);
+    decoder = jpgdHeader(data, file.size, &width, &height);
     if (!decoder) return false;
 
     w = static_cast<float>(width);
@@ -115,7 +122,7 @@ bool JpgLoader::read()
 
     if (!decoder || w == 0 || h == 0) return false;
 
-    TaskScheduler::request(this);
+    request(this);
 
     return true;
 }
@@ -23,6 +23,7 @@
 #ifndef _TVG_JPG_LOADER_H_
 #define _TVG_JPG_LOADER_H_
 
+#include "tvgFile.h"
 #include "tvgLoader.h"
 #include "tvgTaskScheduler.h"
 #include "tvgJpgd.h"
@@ -31,6 +32,7 @@ class JpgLoader : public ImageLoader, public Task
 {
 private:
     jpeg_decoder* decoder = nullptr;
+    FileMap file;
     char* data = nullptr;
     bool freeData = false;
 
@@ -36,6 +36,7 @@
 #include <stdint.h>
 
 #include "tvgCommon.h"
+#include "tvgTaskScheduler.h"
 #include "tvgJpgd.h"
 
 /************************************************************************/
@@ -130,6 +131,8 @@ public:
 };
 
 
+struct jpgd_band;
+
 class jpeg_decoder
 {
 public:
@@ -139,15 +142,21 @@ public:
     ~jpeg_decoder();
 
     // Call this method after constructing the object to begin decompression.
-    // If JPGD_SUCCESS is returned you may then call decode() on each scanline.
+    // If JPGD_SUCCESS is returned you may then call decode_rows() for the MCU rows in order.
     int begin_decoding();
-    // Returns the next scan line.
-    // For grayscale images, pScan_line will point to a buffer containing 8-bit pixels (get_bytes_per_pixel() will return 1).
-    // Otherwise, it will always point to a buffer containing 32-bit RGBA pixels (A will always be 255, and get_bytes_per_pixel() will return 4).
-    // Returns JPGD_SUCCESS if a scan line has been returned.
-    // Returns JPGD_DONE if all scan lines have been returned.
-    // Returns JPGD_FAILED if an error occurred. Call get_error_code() for a more info.
-    int decode(const void** pScan_line, uint32_t* pScan_line_len);
+    // Decodes (or loads, if progressive) the dequantized coefficients of the next MCU rows into the band.
+    // This is sequential since it consumes the stream. Returns false if an error occurred.
+    bool decode_rows(jpgd_band* pBand);
+    // Reconstructs the pixels of the band's MCU rows. The bands are independent of each other and of the decoder,
+    // so this can run on any thread once their coefficients are decoded.
+    void reconstruct(jpgd_band* pBand) const;
+    // Sizes of the band buffers per MCU row.
+    int get_coeffs_per_row() const { return m_mcus_per_row * m_blocks_per_mcu * 64; }
+    int get_blocks_per_row() const { return m_mcus_per_row * m_blocks_per_mcu; }
+    int get_samples_per_row() const { return (m_freq_domain_chroma_upsample ? m_expanded_blocks_per_row : m_max_blocks_per_row) * 64; }
+    int get_scan_line_size() const { return m_dest_bytes_per_scan_line; }
+    inline int get_mcu_rows() const { return m_max_mcus_per_col; }
+    inline int get_mcu_height() const { return m_max_mcu_y_size; }
     inline jpgd_status get_error_code() const { return m_error_code; }
     inline int get_width() const { return m_image_x_size; }
     inline int get_height() const { return m_image_y_size; }
@@ -219,8 +228,6 @@ private:
     int m_max_blocks_per_row;
     int m_mcus_per_row, m_mcus_per_col;
     int m_mcu_org[JPGD_MAX_BLOCKS_PER_MCU];
-    int m_total_lines_left;                       // total # lines left in image
-    int m_mcu_lines_left;                         // total # lines left in this MCU
     int m_real_dest_bytes_per_scan_line;
     int m_dest_bytes_per_scan_line;               // rounded up
     int m_dest_bytes_per_pixel;                   // 4 (RGB) or 1 (Y)
@@ -249,15 +256,11 @@ private:
     bool  m_freq_domain_chroma_upsample;
     int m_max_mcus_per_col;
     uint32_t m_last_dc_val[JPGD_MAX_COMPONENTS];
-    jpgd_block_t* m_pMCU_coefficients;
-    int m_mcu_block_max_zag[JPGD_MAX_BLOCKS_PER_MCU];
-    uint8_t* m_pSample_buf;
+    int m_mcu_rows_decoded;
     int m_crr[256];
     int m_cbb[256];
     int m_crg[256];
     int m_cbg[256];
-    uint8_t* m_pScan_line_0;
-    uint8_t* m_pScan_line_1;
     jpgd_status m_error_code;
     bool m_ready_flag;
     int m_total_bytes_read;
@@ -281,12 +284,12 @@ private:
     void init(jpeg_decoder_stream * pStream);
     void create_look_ups();
     void fix_in_buffer();
-    void transform_mcu(int mcu_row);
-    void transform_mcu_expand(int mcu_row);
+    void transform_mcu(const jpgd_block_t* pSrc_ptr, const int* pMax_zag, uint8_t* pDst_ptr) const;
+    void transform_mcu_expand(const jpgd_block_t* pSrc_ptr, const int* pMax_zag, uint8_t* pDst_ptr) const;
     coeff_buf* coeff_buf_open(int block_num_x, int block_num_y, int block_len_x, int block_len_y);
     inline jpgd_block_t *coeff_buf_getp(coeff_buf *cb, int block_x, int block_y);
-    void load_next_row();
-    bool decode_next_row();
+    void load_next_row(jpgd_block_t* pCoeffs, int* pMax_zag);
+    bool decode_next_row(jpgd_block_t* pCoeffs, int* pMax_zag);
     void make_huff_table(int index, huff_tables *pH);
     bool check_quant_tables();
     bool check_huff_tables();
@@ -299,12 +302,13 @@ private:
     bool init_sequential();
     bool decode_start();
     void decode_init(jpeg_decoder_stream * pStream);
-    void H2V2Convert();
-    void H2V1Convert();
-    void H1V2Convert();
-    void H1V1Convert();
-    void gray_convert();
-    void expanded_convert();
+    void H2V2Convert(int row, const uint8_t* pSample_buf, uint8_t* d0, uint8_t* d1) const;
+    void H2V1Convert(int row, const uint8_t* pSample_buf, uint8_t* d0) const;
+    void H1V2Convert(int row, const uint8_t* pSample_buf, uint8_t* d0, uint8_t* d1) const;
+    void H1V1Convert(int row, const uint8_t* pSample_buf, uint8_t* d0) const;
+    void gray_convert(int row, const uint8_t* pSample_buf, uint8_t* d0) const;
+    void expanded_convert(int row, const uint8_t* pSample_buf, uint8_t* d0) const;
+    const uint8_t* convert(int row, const uint8_t* pSample_buf, uint8_t* d0, uint8_t* d1) const;
     void find_eoi();
     inline uint32_t get_char();
     inline uint32_t get_char(bool *pPadding_flag);
@@ -315,6 +319,7 @@ private:
     inline int huff_decode(huff_tables *pH);
     inline int huff_decode(huff_tables *pH, int& extrabits);
     static inline uint8_t clamp(int i);
+    static void emit(const jpgd_band* pBand, int y, const uint8_t* pScan_line, int width, int height);
     static bool decode_block_dc_first(jpeg_decoder *pD, int component_id, int block_x, int block_y);
     static bool decode_block_dc_refine(jpeg_decoder *pD, int component_id, int block_x, int block_y);
     static bool decode_block_ac_first(jpeg_decoder *pD, int component_id, int block_x, int block_y);
@@ -322,6 +327,27 @@ private:
 };
 
 
+// A run of MCU rows. The coefficients are decoded in order, then the pixels are reconstructed in parallel.
+struct jpgd_band : Task
+{
+    const jpeg_decoder* decoder = nullptr;
+    jpgd_block_t* coeffs = nullptr;     // dequantized coefficients of the MCU rows
+    int* max_zag = nullptr;             // number of the coefficients in zigzag order of each block
+    uint8_t* samples = nullptr;         // IDCT output of a MCU row
+    uint8_t* lines[2] = {};             // converted scan lines
+    uint8_t* pixels = nullptr;          // BGRA scan line to be averaged, if reduced
+    uint32_t* sums = nullptr;           // box sums of the reduced scan line
+    uint8_t* image = nullptr;           // BGRA destination
+    int shift = 0;                      // the power of two reduction
+    int mcu_row = 0, mcu_rows = 0;
+
+    void run(TVG_UNUSED unsigned tid) override
+    {
+        decoder->reconstruct(this);
+    }
+};
+
+
 // DCT coefficients are stored in this sequence.
 static int g_ZAG[64] = {  0,1,8,16,9,2,3,10,17,24,32,25,18,11,4,5,12,19,26,33,40,48,41,34,27,20,13,6,7,14,21,28,35,42,49,56,57,50,43,36,29,22,15,23,30,37,44,51,58,59,52,45,38,31,39,46,53,60,61,54,47,55,62,63 };
 
@@ -1527,8 +1553,6 @@ void jpeg_decoder::init(jpeg_decoder_stream *pStream)
 
     memset(m_mcu_org, 0, sizeof(m_mcu_org));
 
-    m_total_lines_left = 0;
-    m_mcu_lines_left = 0;
     m_real_dest_bytes_per_scan_line = 0;
     m_dest_bytes_per_scan_line = 0;
     m_dest_bytes_per_pixel = 0;
@@ -1561,14 +1585,10 @@ void jpeg_decoder::init(jpeg_decoder_stream *pStream)
     m_max_mcus_per_col = 0;
 
     memset(m_last_dc_val, 0, sizeof(m_last_dc_val));
-    m_pMCU_coefficients = nullptr;
-    m_pSample_buf = nullptr;
+    m_mcu_rows_decoded = 0;
 
     m_total_bytes_read = 0;
 
-    m_pScan_line_0 = nullptr;
-    m_pScan_line_1 = nullptr;
-
     // Ready the input buffer.
     prep_in_buffer();
 
@@ -1578,10 +1598,6 @@ void jpeg_decoder::init(jpeg_decoder_stream *pStream)
 
     get_bits(16);
     get_bits(16);
-
-    for (int i = 0; i < JPGD_MAX_BLOCKS_PER_MCU; i++) {
-        m_mcu_block_max_zag[i] = 64;
-    }
 }
 
 #define SCALEBITS 16
@@ -1621,13 +1637,10 @@ void jpeg_decoder::fix_in_buffer()
 }
 
 
-void jpeg_decoder::transform_mcu(int mcu_row)
+void jpeg_decoder::transform_mcu(const jpgd_block_t* pSrc_ptr, const int* pMax_zag, uint8_t* pDst_ptr) const
 {
-    jpgd_block_t* pSrc_ptr = m_pMCU_coefficients;
-    uint8_t* pDst_ptr = m_pSample_buf + mcu_row * m_blocks_per_mcu * 64;
-
     for (int mcu_block = 0; mcu_block < m_blocks_per_mcu; mcu_block++) {
-        idct(pSrc_ptr, pDst_ptr, m_mcu_block_max_zag[mcu_block]);
+        idct(pSrc_ptr, pDst_ptr, pMax_zag[mcu_block]);
         pSrc_ptr += 64;
         pDst_ptr += 64;
     }
@@ -1643,15 +1656,12 @@ static const uint8_t s_max_rc[64] =
 };
 
 
-void jpeg_decoder::transform_mcu_expand(int mcu_row)
+void jpeg_decoder::transform_mcu_expand(const jpgd_block_t* pSrc_ptr, const int* pMax_zag, uint8_t* pDst_ptr) const
 {
-    jpgd_block_t* pSrc_ptr = m_pMCU_coefficients;
-    uint8_t* pDst_ptr = m_pSample_buf + mcu_row * m_expanded_blocks_per_mcu * 64;
-
     // Y IDCT
     int mcu_block;
     for (mcu_block = 0; mcu_block < m_expanded_blocks_per_component; mcu_block++) {
-        idct(pSrc_ptr, pDst_ptr, m_mcu_block_max_zag[mcu_block]);
+        idct(pSrc_ptr, pDst_ptr, pMax_zag[mcu_block]);
         pSrc_ptr += 64;
         pDst_ptr += 64;
     }
@@ -1661,10 +1671,10 @@ void jpeg_decoder::transform_mcu_expand(int mcu_row)
 
     for (int i = 0; i < 2; i++) {
         DCT_Upsample::Matrix44 P, Q, R, S;
-        JPGD_ASSERT(m_mcu_block_max_zag[mcu_block] >= 1);
-        JPGD_ASSERT(m_mcu_block_max_zag[mcu_block] <= 64);
+        JPGD_ASSERT(pMax_zag[mcu_block] >= 1);
+        JPGD_ASSERT(pMax_zag[mcu_block] <= 64);
 
-        int max_zag = m_mcu_block_max_zag[mcu_block++] - 1;
+        int max_zag = pMax_zag[mcu_block++] - 1;
         if (max_zag <= 0) max_zag = 0; // should never happen, only here to shut up static analysis
 
         switch (s_max_rc[max_zag]) {
@@ -1759,7 +1769,7 @@ void jpeg_decoder::transform_mcu_expand(int mcu_row)
 
 // Loads and dequantizes the next row of (already decoded) coefficients.
 // Progressive images only.
-void jpeg_decoder::load_next_row()
+void jpeg_decoder::load_next_row(jpgd_block_t* pCoeffs, int* pMax_zag)
 {
     int i;
     jpgd_block_t *p;
@@ -1776,7 +1786,7 @@ void jpeg_decoder::load_next_row()
         for (mcu_block = 0; mcu_block < m_blocks_per_mcu; mcu_block++) {
             component_id = m_mcu_org[mcu_block];
             q = m_quant[m_comp_quant[component_id]];
-            p = m_pMCU_coefficients + 64 * mcu_block;
+            p = pCoeffs + 64 * mcu_block;
 
             jpgd_block_t* pAC = coeff_buf_getp(m_ac_coeffs[component_id], block_x_mcu[component_id] + block_x_mcu_ofs, m_block_y_mcu[component_id] + block_y_mcu_ofs);
             jpgd_block_t* pDC = coeff_buf_getp(m_dc_coeffs[component_id], block_x_mcu[component_id] + block_x_mcu_ofs, m_block_y_mcu[component_id] + block_y_mcu_ofs);
@@ -1787,7 +1797,7 @@ void jpeg_decoder::load_next_row()
                 if (p[g_ZAG[i]]) break;
             }
 
-            m_mcu_block_max_zag[mcu_block] = i + 1;
+            pMax_zag[mcu_block] = i + 1;
 
             for ( ; i >= 0; i--) {
                 if (p[g_ZAG[i]]) {
@@ -1797,15 +1807,18 @@ void jpeg_decoder::load_next_row()
 
             if (m_comps_in_scan == 1) block_x_mcu[component_id]++;
             else {
-                if (++block_x_mcu_ofs == m_comp_h_samp[component_id]) block_x_mcu_ofs = 0;
-                if (++block_y_mcu_ofs == m_comp_v_samp[component_id]) {
-                    block_y_mcu_ofs = 0;
-                    block_x_mcu[component_id] += m_comp_h_samp[component_id];
+                if (++block_x_mcu_ofs == m_comp_h_samp[component_id]) {
+                    block_x_mcu_ofs = 0;
+
+                    if (++block_y_mcu_ofs == m_comp_v_samp[component_id]) {
+                        block_y_mcu_ofs = 0;
+                        block_x_mcu[component_id] += m_comp_h_samp[component_id];
+                    }
                 }
             }
         }
-        if (m_freq_domain_chroma_upsample) transform_mcu_expand(mcu_row);
-        else transform_mcu(mcu_row);
+        pCoeffs += m_blocks_per_mcu * 64;
+        pMax_zag += m_blocks_per_mcu;
     }
     if (m_comps_in_scan == 1) m_block_y_mcu[m_comp_list[0]]++;
     else {
@@ -1865,14 +1878,16 @@ static inline int dequantize_ac(int c, int q)
 }
 
 // Decodes and dequantizes the next row of coefficients.
-bool jpeg_decoder::decode_next_row()
+// The coefficients of the previous use of the buffer are cleared as far as its max_zag tells.
+bool jpeg_decoder::decode_next_row(jpgd_block_t* pCoeffs, int* pMax_zag)
 {
     for (int mcu_row = 0; mcu_row < m_mcus_per_row; mcu_row++) {
         if ((m_restart_interval) && (m_restarts_left == 0)) {
             if (!process_restart()) return false;
         }
 
-        jpgd_block_t* p = m_pMCU_coefficients;
+        jpgd_block_t* p = pCoeffs + mcu_row * m_blocks_per_mcu * 64;
+        int* pZag = pMax_zag + mcu_row * m_blocks_per_mcu;
 
         for (int mcu_block = 0; mcu_block < m_blocks_per_mcu; mcu_block++, p += 64) {
             int component_id = m_mcu_org[mcu_block];
@@ -1886,7 +1901,7 @@ bool jpeg_decoder::decode_next_row()
 
             p[0] = static_cast<jpgd_block_t>(s * q[0]);
 
-            int prev_num_set = m_mcu_block_max_zag[mcu_block];
+            int prev_num_set = pZag[mcu_block];
             huff_tables *pH = m_pHuff_tabs[m_comp_ac_tab[component_id]];
             int k;
             for (k = 1; k < 64; k++) {
@@ -1930,10 +1945,8 @@ bool jpeg_decoder::decode_next_row()
                 while (kt < prev_num_set) p[g_ZAG[kt++]] = 0;
             }
 
-            m_mcu_block_max_zag[mcu_block] = k;
+            pZag[mcu_block] = k;
         }
-        if (m_freq_domain_chroma_upsample) transform_mcu_expand(mcu_row);
-        else transform_mcu(mcu_row);
         m_restarts_left--;
     }
     return true;
@@ -1941,11 +1954,10 @@ bool jpeg_decoder::decode_next_row()
 
 
 // YCbCr H1V1 (1x1:1:1, 3 m_blocks per MCU) to RGB
-void jpeg_decoder::H1V1Convert()
+void jpeg_decoder::H1V1Convert(int row, const uint8_t* pSample_buf, uint8_t* d0) const
 {
-    int row = m_max_mcu_y_size - m_mcu_lines_left;
-    uint8_t *d = m_pScan_line_0;
-    uint8_t *s = m_pSample_buf + row * 8;
+    uint8_t *d = d0;
+    const uint8_t *s = pSample_buf + row * 8;
 
     for (int i = m_max_mcus_per_row; i > 0; i--) {
         for (int j = 0; j < 8; j++) {
@@ -1965,12 +1977,10 @@ void jpeg_decoder::H1V1Convert()
 
 
 // YCbCr H2V1 (2x1:1:1, 4 m_blocks per MCU) to RGB
-void jpeg_decoder::H2V1Convert()
+void jpeg_decoder::H2V1Convert(int row, const uint8_t* pSample_buf, uint8_t* d0) const
 {
-    int row = m_max_mcu_y_size - m_mcu_lines_left;
-    uint8_t *d0 = m_pScan_line_0;
-    uint8_t *y = m_pSample_buf + row * 8;
-    uint8_t *c = m_pSample_buf + 2*64 + row * 8;
+    const uint8_t *y = pSample_buf + row * 8;
+    const uint8_t *c = pSample_buf + 2*64 + row * 8;
 
     for (int i = m_max_mcus_per_row; i > 0; i--) {
         for (int l = 0; l < 2; l++) {
@@ -2005,18 +2015,15 @@ void jpeg_decoder::H2V1Convert()
 
 
 // YCbCr H2V1 (1x2:1:1, 4 m_blocks per MCU) to RGB
-void jpeg_decoder::H1V2Convert()
+void jpeg_decoder::H1V2Convert(int row, const uint8_t* pSample_buf, uint8_t* d0, uint8_t* d1) const
 {
-    int row = m_max_mcu_y_size - m_mcu_lines_left;
-    uint8_t *d0 = m_pScan_line_0;
-    uint8_t *d1 = m_pScan_line_1;
-    uint8_t *y;
-    uint8_t *c;
+    const uint8_t *y;
+    const uint8_t *c;
 
-    if (row < 8) y = m_pSample_buf + row * 8;
-    else y = m_pSample_buf + 64*1 + (row & 7) * 8;
+    if (row < 8) y = pSample_buf + row * 8;
+    else y = pSample_buf + 64*1 + (row & 7) * 8;
 
-    c = m_pSample_buf + 64*2 + (row >> 1) * 8;
+    c = pSample_buf + 64*2 + (row >> 1) * 8;
 
     for (int i = m_max_mcus_per_row; i > 0; i--) {
         for (int j = 0; j < 8; j++) {
@@ -2049,18 +2056,15 @@ void jpeg_decoder::H1V2Convert()
 
 
 // YCbCr H2V2 (2x2:1:1, 6 m_blocks per MCU) to RGB
-void jpeg_decoder::H2V2Convert()
+void jpeg_decoder::H2V2Convert(int row, const uint8_t* pSample_buf, uint8_t* d0, uint8_t* d1) const
 {
-    int row = m_max_mcu_y_size - m_mcu_lines_left;
-    uint8_t *d0 = m_pScan_line_0;
-    uint8_t *d1 = m_pScan_line_1;
-    uint8_t *y;
-    uint8_t *c;
+    const uint8_t *y;
+    const uint8_t *c;
 
-    if (row < 8) y = m_pSample_buf + row * 8;
-    else y = m_pSample_buf + 64*2 + (row & 7) * 8;
+    if (row < 8) y = pSample_buf + row * 8;
+    else y = pSample_buf + 64*2 + (row & 7) * 8;
 
-    c = m_pSample_buf + 64*4 + (row >> 1) * 8;
+    c = pSample_buf + 64*4 + (row >> 1) * 8;
 
     for (int i = m_max_mcus_per_row; i > 0; i--) {
         for (int l = 0; l < 2; l++) {
@@ -2110,26 +2114,24 @@ void jpeg_decoder::H2V2Convert()
 
 
 // Y (1 block per MCU) to 8-bit grayscale
-void jpeg_decoder::gray_convert()
+void jpeg_decoder::gray_convert(int row, const uint8_t* pSample_buf, uint8_t* d0) const
 {
-    int row = m_max_mcu_y_size - m_mcu_lines_left;
-    uint8_t *d = m_pScan_line_0;
-    uint8_t *s = m_pSample_buf + row * 8;
+    uint8_t *d = d0;
+    const uint8_t *s = pSample_buf + row * 8;
 
     for (int i = m_max_mcus_per_row; i > 0; i--) {
-        *(uint32_t *)d = *(uint32_t *)s;
-        *(uint32_t *)(&d[4]) = *(uint32_t *)(&s[4]);
+        *(uint32_t *)d = *(const uint32_t *)s;
+        *(uint32_t *)(&d[4]) = *(const uint32_t *)(&s[4]);
         s += 64;
         d += 8;
     }
 }
 
 
-void jpeg_decoder::expanded_convert()
+void jpeg_decoder::expanded_convert(int row, const uint8_t* pSample_buf, uint8_t* d0) const
 {
-    int row = m_max_mcu_y_size - m_mcu_lines_left;
-    uint8_t* Py = m_pSample_buf + (row / 8) * 64 * m_comp_h_samp[0] + (row & 7) * 8;
-    uint8_t* d = m_pScan_line_0;
+    const uint8_t* Py = pSample_buf + (row / 8) * 64 * m_comp_h_samp[0] + (row & 7) * 8;
+    uint8_t* d = d0;
 
     for (int i = m_max_mcus_per_row; i > 0; i--) {
         for (int k = 0; k < m_max_mcu_x_size; k += 8) {
@@ -2173,61 +2175,147 @@ void jpeg_decoder::find_eoi()
 }
 
 
-int jpeg_decoder::decode(const void** pScan_line, uint32_t* pScan_line_len)
+bool jpeg_decoder::decode_rows(jpgd_band* pBand)
 {
-    if ((m_error_code) || (!m_ready_flag)) return JPGD_FAILED;
-    if (m_total_lines_left == 0) return JPGD_DONE;
-    if (m_mcu_lines_left == 0) {
-        if (m_progressive_flag) load_next_row();
-        else if (!decode_next_row()) return JPGD_FAILED;
+    if ((m_error_code) || (!m_ready_flag)) return false;
+
+    for (int i = 0; i < pBand->mcu_rows; i++) {
+        auto pCoeffs = pBand->coeffs + i * get_coeffs_per_row();
+        auto pMax_zag = pBand->max_zag + i * get_blocks_per_row();
+        if (m_progressive_flag) load_next_row(pCoeffs, pMax_zag);
+        else if (!decode_next_row(pCoeffs, pMax_zag)) return false;
         // Find the EOI marker if that was the last row.
-        if (m_total_lines_left <= m_max_mcu_y_size) find_eoi();
-        m_mcu_lines_left = m_max_mcu_y_size;
+        if (++m_mcu_rows_decoded == m_max_mcus_per_col) find_eoi();
     }
+    return true;
+}
+
 
+// Converts the row of the MCU samples. Returns the 32-bit RGBA (or 8-bit grayscale) scan line.
+const uint8_t* jpeg_decoder::convert(int row, const uint8_t* pSample_buf, uint8_t* d0, uint8_t* d1) const
+{
     if (m_freq_domain_chroma_upsample) {
-        expanded_convert();
-        *pScan_line = m_pScan_line_0;
-    } else {
-        switch (m_scan_type) {
-            case JPGD_YH2V2: {
-                if ((m_mcu_lines_left & 1) == 0) {
-                    H2V2Convert();
-                    *pScan_line = m_pScan_line_0;
-                }
-              else *pScan_line = m_pScan_line_1;
-              break;
-            }
-            case JPGD_YH2V1: {
-                H2V1Convert();
-                *pScan_line = m_pScan_line_0;
-                break;
-            }
-            case JPGD_YH1V2: {
-                if ((m_mcu_lines_left & 1) == 0) {
-                    H1V2Convert();
-                    *pScan_line = m_pScan_line_0;
-                } else *pScan_line = m_pScan_line_1;
-                break;
-            }
-            case JPGD_YH1V1: {
-                H1V1Convert();
-                *pScan_line = m_pScan_line_0;
-                break;
+        expanded_convert(row, pSample_buf, d0);
+        return d0;
+    }
+
+    switch (m_scan_type) {
+        case JPGD_YH2V2: {
+            if ((row & 1) == 0) {
+                H2V2Convert(row, pSample_buf, d0, d1);
+                return d0;
             }
-            case JPGD_GRAYSCALE: {
-                gray_convert();
-                *pScan_line = m_pScan_line_0;
-                break;
+            return d1;
+        }
+        case JPGD_YH2V1: {
+            H2V1Convert(row, pSample_buf, d0);
+            return d0;
+        }
+        case JPGD_YH1V2: {
+            if ((row & 1) == 0) {
+                H1V2Convert(row, pSample_buf, d0, d1);
+                return d0;
             }
+            return d1;
+        }
+        case JPGD_YH1V1: {
+            H1V1Convert(row, pSample_buf, d0);
+            return d0;
+        }
+        default: {
+            gray_convert(row, pSample_buf, d0);
+            return d0;
         }
     }
+}
 
-    *pScan_line_len = m_real_dest_bytes_per_scan_line;
-    m_mcu_lines_left--;
-    m_total_lines_left--;
 
-    return JPGD_SUCCESS;
+//accumulate the scanline into the box of 2^shift x 2^shift pixels per the reduced one
+static void _accumulate(uint32_t* pSum, const uint8_t* pSrc, int width, int shift)
+{
+    for (int x = 0; x < width; x++) {
+        auto pBox = pSum + (x >> shift) * 4;
+        for (int c = 0; c < 4; c++) pBox[c] += *pSrc++;
+    }
+}
+
+
+static void _average(uint8_t* pDst, uint32_t* pSum, int width, int rows, int shift)
+{
+    auto box = 1 << shift;
+    auto reduced_width = (width + box - 1) >> shift;
+    for (int x = 0; x < reduced_width; x++) {
+        auto cols = (width - x * box) < box ? (width - x * box) : box;
+        auto count = static_cast<uint32_t>(cols * rows);
+        for (int c = 0; c < 4; c++) {
+            *pDst++ = static_cast<uint8_t>((*pSum + count / 2) / count);
+            *pSum++ = 0;
+        }
+    }
+}
+
+
+// Writes the scan line y as BGRA, or averages it into the reduced image.
+void jpeg_decoder::emit(const jpgd_band* pBand, int y, const uint8_t* pScan_line, int width, int height)
+{
+    auto shift = pBand->shift;
+    auto box = 1 << shift;
+    auto reduced_width = (width + box - 1) >> shift;
+    auto pDst = shift > 0 ? pBand->pixels : pBand->image + y * width * 4;
+    auto comps = (pBand->decoder->get_num_components() == 3) ? 4 : 1;
+
+    if (comps == 4) {
+        for (int x = 0; x < width; x++) {
+            pDst[0] = pScan_line[x*4+2];
+            pDst[1] = pScan_line[x*4+1];
+            pDst[2] = pScan_line[x*4+0];
+            pDst[3] = 255;
+            pDst += 4;
+        }
+    } else {
+        for (int x = 0; x < width; x++) {
+            uint8_t luma = pScan_line[x];
+            pDst[0] = luma;
+            pDst[1] = luma;
+            pDst[2] = luma;
+            pDst[3] = 255;
+            pDst += 4;
+        }
+    }
+
+    if (shift > 0) {
+        _accumulate(pBand->sums, pBand->pixels, width, shift);
+        auto rows = (y & (box - 1)) + 1;
+        if (rows == box || y == height - 1) {
+            _average(pBand->image + (y >> shift) * reduced_width * 4, pBand->sums, width, rows, shift);
+        }
+    }
+}
+
+
+void jpeg_decoder::reconstruct(jpgd_band* pBand) const
+{
+    auto samples_per_mcu = (m_freq_domain_chroma_upsample ? m_expanded_blocks_per_mcu : m_blocks_per_mcu) * 64;
+
+    for (int i = 0; i < pBand->mcu_rows; i++) {
+        auto pCoeffs = pBand->coeffs + i * get_coeffs_per_row();
+        auto pMax_zag = pBand->max_zag + i * get_blocks_per_row();
+        auto pSamples = pBand->samples;
+
+        for (int mcu = 0; mcu < m_mcus_per_row; mcu++) {
+            if (m_freq_domain_chroma_upsample) transform_mcu_expand(pCoeffs, pMax_zag, pSamples);
+            else transform_mcu(pCoeffs, pMax_zag, pSamples);
+            pCoeffs += m_blocks_per_mcu * 64;
+            pMax_zag += m_blocks_per_mcu;
+            pSamples += samples_per_mcu;
+        }
+
+        auto y = (pBand->mcu_row + i) * m_max_mcu_y_size;
+        for (int row = 0; row < m_max_mcu_y_size && y < m_image_y_size; row++, y++) {
+            auto pScan_line = convert(row, pBand->samples, pBand->lines[0], pBand->lines[1]);
+            emit(pBand, y, pScan_line, m_image_x_size, m_image_y_size);
+        }
+    }
 }
 
 
@@ -2433,8 +2521,6 @@ int jpeg_decoder::init_scan()
 // are supported.
 bool jpeg_decoder::init_frame()
 {
-    int i;
-
     if (m_comps_in_frame == 1) {
         if ((m_comp_h_samp[0] != 1) || (m_comp_v_samp[0] != 1)) return stop_decoding(JPGD_UNSUPPORTED_SAMP_FACTORS);
         m_scan_type = JPGD_GRAYSCALE;
@@ -2479,24 +2565,11 @@ bool jpeg_decoder::init_frame()
     m_dest_bytes_per_scan_line = ((m_image_x_size + 15) & 0xFFF0) * m_dest_bytes_per_pixel;
     m_real_dest_bytes_per_scan_line = (m_image_x_size * m_dest_bytes_per_pixel);
 
-    // Initialize two scan line buffers.
-    m_pScan_line_0 = (uint8_t *)alloc(m_dest_bytes_per_scan_line, true);
-    if ((m_scan_type == JPGD_YH1V2) || (m_scan_type == JPGD_YH2V2)) {
-        m_pScan_line_1 = (uint8_t *)alloc(m_dest_bytes_per_scan_line, true);
-    }
-
     m_max_blocks_per_row = m_max_mcus_per_row * m_max_blocks_per_mcu;
 
     // Should never happen
     if (m_max_blocks_per_row > JPGD_MAX_BLOCKS_PER_ROW) return stop_decoding(JPGD_ASSERTION_ERROR);
 
-    // Allocate the coefficient buffer, enough for one MCU
-    m_pMCU_coefficients = (jpgd_block_t*)alloc(m_max_blocks_per_mcu * 64 * sizeof(jpgd_block_t));
-
-    for (i = 0; i < m_max_blocks_per_mcu; i++) {
-        m_mcu_block_max_zag[i] = 64;
-    }
-
     m_expanded_blocks_per_component = m_comp_h_samp[0] * m_comp_v_samp[0];
     m_expanded_blocks_per_mcu = m_expanded_blocks_per_component * m_comps_in_frame;
     m_expanded_blocks_per_row = m_max_mcus_per_row * m_expanded_blocks_per_mcu;
@@ -2506,13 +2579,6 @@ bool jpeg_decoder::init_frame()
     m_freq_domain_chroma_upsample = (m_expanded_blocks_per_mcu == 4*3);
 #endif
 
-    if (m_freq_domain_chroma_upsample)
-        m_pSample_buf = (uint8_t *)alloc(m_expanded_blocks_per_row * 64);
-    else
-        m_pSample_buf = (uint8_t *)alloc(m_max_blocks_per_row * 64);
-
-    m_total_lines_left = m_image_y_size;
-    m_mcu_lines_left = 0;
     create_look_ups();
 
     return true;
@@ -2909,6 +2975,66 @@ int jpeg_decoder_mem_stream::read(uint8_t *pBuf, int max_bytes_to_read, bool *pE
 }
 
 
+#define JPGD_BAND_PIXELS 65536   //the minimum pixels of a band, so that a task is worth it
+
+
+static bool _allocBands(jpgd_band* bands, int count, jpeg_decoder* decoder, uint8_t* image, int shift, int mcu_rows)
+{
+    auto width = decoder->get_width();
+    auto reduced_width = (width + (1 << shift) - 1) >> shift;
+
+    for (int i = 0; i < count; i++) {
+        auto& band = bands[i];
+        band.decoder = decoder;
+        band.image = image;
+        band.shift = shift;
+        band.coeffs = tvg::calloc<jpgd_block_t*>(decoder->get_coeffs_per_row() * mcu_rows, sizeof(jpgd_block_t));
+        band.max_zag = tvg::malloc<int*>(decoder->get_blocks_per_row() * mcu_rows * sizeof(int));
+        band.samples = tvg::malloc<uint8_t*>(decoder->get_samples_per_row());
+        band.lines[0] = tvg::calloc<uint8_t*>(decoder->get_scan_line_size(), 1);
+        band.lines[1] = tvg::calloc<uint8_t*>(decoder->get_scan_line_size(), 1);
+        if (!band.coeffs || !band.max_zag || !band.samples || !band.lines[0] || !band.lines[1]) return false;
+        for (int j = 0; j < decoder->get_blocks_per_row() * mcu_rows; j++) band.max_zag[j] = 64;
+        if (shift > 0) {
+            band.pixels = tvg::malloc<uint8_t*>(width * 4);
+            band.sums = tvg::calloc<uint32_t*>(reduced_width * 4, sizeof(uint32_t));
+            if (!band.pixels || !band.sums) return false;
+        }
+    }
+    return true;
+}
+
+
+static void _freeBands(jpgd_band* bands, int count)
+{
+    for (int i = 0; i < count; i++) {
+        tvg::free(bands[i].coeffs);
+        tvg::free(bands[i].max_zag);
+        tvg::free(bands[i].samples);
+        tvg::free(bands[i].lines[0]);
+        tvg::free(bands[i].lines[1]);
+        tvg::free(bands[i].pixels);
+        tvg::free(bands[i].sums);
+    }
+    delete[] bands;
+}
+
+
+//decode the coefficients of the next bands in order, returns the number of them or -1 if failed
+static int _decodeBands(jpeg_decoder* decoder, jpgd_band* bands, int count, int mcu_rows, int& next)
+{
+    int i = 0;
+    for (; i < count && next < decoder->get_mcu_rows(); i++) {
+        auto& band = bands[i];
+        band.mcu_row = next;
+        band.mcu_rows = JPGD_MIN(mcu_rows, decoder->get_mcu_rows() - next);
+        if (!decoder->decode_rows(&band)) return -1;
+        next += band.mcu_rows;
+    }
+    return i;
+}
+
+
 /************************************************************************/
 /* External Class Implementation                                        */
 /************************************************************************/
@@ -2957,81 +3083,48 @@ void jpgdDelete(jpeg_decoder* decoder)
 }
 
 
-unsigned char* jpgdDecompress(jpeg_decoder* decoder)
+unsigned char* jpgdDecompress(jpeg_decoder* decoder, int shift)
 {
     if (!decoder) return nullptr;
 
-    int req_comps = 4;  //TODO: fixed 4 channel components now?
-    if ((req_comps != 1) && (req_comps != 3) && (req_comps != 4)) return nullptr;
-
-    auto image_width = decoder->get_width();
-    auto image_height = decoder->get_height();
-    //auto actual_comps = decoder->get_num_components();
-
     if (decoder->begin_decoding() != JPGD_SUCCESS) return nullptr;
 
-    const int dst_bpl = image_width * req_comps;
-    uint8_t *pImage_data = tvg::malloc<uint8_t*>(dst_bpl * image_height);
+    //the bands of a wave are reconstructed in parallel while the coefficients of the next wave are being decoded
+    auto box = 1 << shift;
+    auto reduced_width = (decoder->get_width() + box - 1) >> shift;
+    auto reduced_height = (decoder->get_height() + box - 1) >> shift;
+
+    auto pImage_data = tvg::malloc<uint8_t*>(reduced_width * 4 * reduced_height);
     if (!pImage_data) return nullptr;
 
-    for (int y = 0; y < image_height; y++) {
-        const uint8_t* pScan_line = nullptr;
-        uint32_t scan_line_len;
-        if (decoder->decode((const void**)&pScan_line, &scan_line_len) != JPGD_SUCCESS) {
-            tvg::free(pImage_data);
-            return nullptr;
-        }
+    auto row_pixels = decoder->get_width() * decoder->get_mcu_height();
+    auto mcu_rows = JPGD_MAX(1, (JPGD_BAND_PIXELS + row_pixels - 1) / row_pixels);
+    auto count = static_cast<int>(TaskScheduler::threads()) + 1;
+    auto bands = new jpgd_band[count * 2];
 
-        uint8_t *pDst = pImage_data + y * dst_bpl;
+    if (!_allocBands(bands, count * 2, decoder, pImage_data, shift, mcu_rows)) {
+        _freeBands(bands, count * 2);
+        tvg::free(pImage_data);
+        return nullptr;
+    }
 
-        //Return as BGRA
-        if ((req_comps == 4) && (decoder->get_num_components() == 3)) {
-            for (int x = 0; x < image_width; x++) {
-                pDst[0] = pScan_line[x*4+2];
-                pDst[1] = pScan_line[x*4+1];
-                pDst[2] = pScan_line[x*4+0];
-                pDst[3] = 255;
-                pDst += 4;
-            }
-        } else if (((req_comps == 1) && (decoder->get_num_components() == 1)) || ((req_comps == 4) && (decoder->get_num_components() == 3))) {
-            memcpy(pDst, pScan_line, dst_bpl);
-        } else if (decoder->get_num_components() == 1) {
-            if (req_comps == 3) {
-                for (int x = 0; x < image_width; x++) {
-                    uint8_t luma = pScan_line[x];
-                    pDst[0] = luma;
-                    pDst[1] = luma;
-                    pDst[2] = luma;
-                    pDst += 3;
-                }
-            } else {
-                for (int x = 0; x < image_width; x++) {
-                    uint8_t luma = pScan_line[x];
-                    pDst[0] = luma;
-                    pDst[1] = luma;
-                    pDst[2] = luma;
-                    pDst[3] = 255;
-                    pDst += 4;
-                }
-            }
-        } else if (decoder->get_num_components() == 3) {
-            if (req_comps == 1) {
-                const int YR = 19595, YG = 38470, YB = 7471;
-                for (int x = 0; x < image_width; x++) {
-                    int r = pScan_line[x*4+0];
-                    int g = pScan_line[x*4+1];
-                    int b = pScan_line[x*4+2];
-                    *pDst++ = static_cast<uint8_t>((r * YR + g * YG + b * YB + 32768) >> 16);
-                }
-            } else {
-                for (int x = 0; x < image_width; x++) {
-                    pDst[0] = pScan_line[x*4+0];
-                    pDst[1] = pScan_line[x*4+1];
-                    pDst[2] = pScan_line[x*4+2];
-                    pDst += 3;
-                }
-            }
-        }
+    TaskGroup group;
+    jpgd_band* waves[2] = {bands, bands + count};
+    auto next = 0;
+    auto cnt = _decodeBands(decoder, waves[0], count, mcu_rows, next);
+
+    for (auto wave = 0; cnt > 0; wave ^= 1) {
+        for (int i = 0; i < cnt; i++) group.request(&waves[wave][i]);
+        auto cnt2 = _decodeBands(decoder, waves[wave ^ 1], count, mcu_rows, next);
+        group.wait();
+        cnt = cnt2;
+    }
+
+    _freeBands(bands, count * 2);
+
+    if (cnt < 0) {
+        tvg::free(pImage_data);
+        return nullptr;
     }
     return pImage_data;
 }
@@ -144,6 +144,23 @@ jerry_cleanup (void)
 #endif /* JERRY_EXTERNAL_CONTEXT */
 } /* jerry_cleanup */
 
+/**
+ * Get heap memory stats.
+ *
+ * Note:
+ *      the peak allocation is not tracked, it is left zero.
+ */
+void
+jerry_heap_stats (jerry_heap_stats_t *out_stats_p) /**< [out] heap memory stats */
+{
+  memset (out_stats_p, 0, sizeof (jerry_heap_stats_t));
+  out_stats_p->version = 1;
+#if !JERRY_SYSTEM_ALLOCATOR
+  out_stats_p->size = JMEM_HEAP_AREA_SIZE;
+#endif /* !JERRY_SYSTEM_ALLOCATOR */
+  out_stats_p->allocated_bytes = JERRY_CONTEXT (jmem_heap_allocated_size);
+} /* jerry_heap_stats */
+
 /**
  * Perform eval
  *
@@ -164,6 +181,59 @@ jerry_eval (const jerry_char_t *source_p, /**< source code */
   return jerry_return (ecma_op_eval_chars_buffer ((void *) &source_char, flags));
 } /* jerry_eval */
 
+/**
+ * Compile the eval code once, so it can be run multiple times with jerry_eval_run
+ *
+ * Note:
+ *      returned byte-code must be freed with jerry_eval_free, when it is no longer needed.
+ *
+ * @return compiled byte-code, NULL on syntax error
+ */
+void *
+jerry_eval_compile (const jerry_char_t *source_p, /**< source code */
+                    size_t source_size, /**< length of source code */
+                    uint32_t flags) /**< jerry_parse_opts_t flags */
+{
+  parser_source_char_t source_char;
+  source_char.source_p = source_p;
+  source_char.source_size = source_size;
+
+  ecma_compiled_code_t *bytecode_p = ecma_op_eval_compile ((void *) &source_char, flags);
+
+  if (JERRY_UNLIKELY (bytecode_p == NULL))
+  {
+    jcontext_release_exception ();
+  }
+
+  return bytecode_p;
+} /* jerry_eval_compile */
+
+/**
+ * Run the byte-code compiled by jerry_eval_compile
+ *
+ * Note:
+ *      returned value must be freed with jerry_value_free, when it is no longer needed.
+ *
+ * @return result of eval, may be error value.
+ */
+jerry_value_t
+jerry_eval_run (void *bytecode_p) /**< compiled byte-code */
+{
+  return jerry_return (ecma_op_eval_bytecode ((ecma_compiled_code_t *) bytecode_p));
+} /* jerry_eval_run */
+
+/**
+ * Release the byte-code compiled by jerry_eval_compile
+ */
+void
+jerry_eval_free (void *bytecode_p) /**< compiled byte-code */
+{
+  if (bytecode_p != NULL)
+  {
+    ecma_bytecode_deref ((ecma_compiled_code_t *) bytecode_p);
+  }
+} /* jerry_eval_free */
+
 /**
  * Get global object
  *
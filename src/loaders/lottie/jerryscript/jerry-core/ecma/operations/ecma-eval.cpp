@@ -57,17 +57,17 @@ ecma_op_eval (ecma_value_t source_code, /**< source code */
 } /* ecma_op_eval */
 
 /**
- * Perform 'eval' with code stored in continuous character buffer
+ * Compile 'eval' code stored in continuous character buffer
  *
- * See also:
- *          ecma_op_eval
- *          ECMA-262 v5, 15.1.2.1 (steps 2 to 8)
+ * Note:
+ *      the returned byte-code can be run multiple times with ecma_op_eval_bytecode,
+ *      and must be released with ecma_bytecode_deref, when it is no longer needed.
  *
- * @return ecma value
+ * @return compiled byte-code, NULL on syntax error (the error is set in the context)
  */
-ecma_value_t
-ecma_op_eval_chars_buffer (void *source_p, /**< source code */
-                           uint32_t parse_opts) /**< ecma_parse_opts_t option bits */
+ecma_compiled_code_t *
+ecma_op_eval_compile (void *source_p, /**< source code */
+                      uint32_t parse_opts) /**< ecma_parse_opts_t option bits */
 {
 #if JERRY_PARSER
   JERRY_ASSERT (source_p != NULL);
@@ -83,7 +83,43 @@ ecma_op_eval_chars_buffer (void *source_p, /**< source code */
 
   ECMA_CLEAR_LOCAL_PARSE_OPTS ();
 
-  ecma_compiled_code_t *bytecode_p = parser_parse_script (source_p, parse_opts, NULL);
+  return parser_parse_script (source_p, parse_opts, NULL);
+#endif /* JERRY_PARSER */
+} /* ecma_op_eval_compile */
+
+/**
+ * Run 'eval' byte-code compiled by ecma_op_eval_compile
+ *
+ * Note:
+ *      the byte-code is kept alive, so it can be run again.
+ *
+ * @return ecma value
+ */
+ecma_value_t
+ecma_op_eval_bytecode (ecma_compiled_code_t *bytecode_p) /**< byte-code data */
+{
+  JERRY_ASSERT (bytecode_p != NULL);
+
+  /* vm_run_eval releases the byte-code after the run */
+  ecma_bytecode_ref (bytecode_p);
+
+  return vm_run_eval (bytecode_p, ECMA_PARSE_EVAL);
+} /* ecma_op_eval_bytecode */
+
+/**
+ * Perform 'eval' with code stored in continuous character buffer
+ *
+ * See also:
+ *          ecma_op_eval
+ *          ECMA-262 v5, 15.1.2.1 (steps 2 to 8)
+ *
+ * @return ecma value
+ */
+ecma_value_t
+ecma_op_eval_chars_buffer (void *source_p, /**< source code */
+                           uint32_t parse_opts) /**< ecma_parse_opts_t option bits */
+{
+  ecma_compiled_code_t *bytecode_p = ecma_op_eval_compile (source_p, parse_opts);
 
   if (JERRY_UNLIKELY (bytecode_p == NULL))
   {
@@ -91,7 +127,6 @@ ecma_op_eval_chars_buffer (void *source_p, /**< source code */
   }
 
   return vm_run_eval (bytecode_p, parse_opts);
-#endif /* JERRY_PARSER */
 } /* ecma_op_eval_chars_buffer */
 
 /**
@@ -29,6 +29,10 @@ ecma_value_t ecma_op_eval (ecma_value_t source_code, uint32_t parse_opts);
 
 ecma_value_t ecma_op_eval_chars_buffer (void *source_p, uint32_t parse_opts);
 
+ecma_compiled_code_t *ecma_op_eval_compile (void *source_p, uint32_t parse_opts);
+
+ecma_value_t ecma_op_eval_bytecode (ecma_compiled_code_t *bytecode_p);
+
 /**
  * @}
  * @}
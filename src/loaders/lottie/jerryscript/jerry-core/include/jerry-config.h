@@ -84,14 +84,14 @@
  *  0: Disable external context.
  *  1: Enable external context support.
  *
- * Default value: 0
+ * Default value: 1, each lottie animation runs its own engine context
  */
 #ifndef JERRY_EXTERNAL_CONTEXT
-#define JERRY_EXTERNAL_CONTEXT 0
+#define JERRY_EXTERNAL_CONTEXT 1
 #endif /* !defined (JERRY_EXTERNAL_CONTEXT) */
 
 /**
- * Maximum size of heap in kilobytes
+ * Maximum size of heap in kilobytes, unused with the external context
  *
  * Default value: 512 KiB
  */
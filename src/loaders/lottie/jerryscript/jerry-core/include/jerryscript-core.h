@@ -22,9 +22,13 @@ JERRY_C_API_BEGIN
 
 void jerry_init (jerry_init_flag_t flags);
 void jerry_cleanup (void);
+void jerry_heap_stats (jerry_heap_stats_t *out_stats_p);
 jerry_value_t jerry_current_realm (void);
 jerry_value_t jerry_set_realm (jerry_value_t realm);
 jerry_value_t jerry_eval (const jerry_char_t *source_p, size_t source_size, uint32_t flags);
+void *jerry_eval_compile (const jerry_char_t *source_p, size_t source_size, uint32_t flags);
+jerry_value_t jerry_eval_run (void *bytecode_p);
+void jerry_eval_free (void *bytecode_p);
 jerry_value_t jerry_run (const jerry_value_t script);
 bool jerry_value_is_undefined (const jerry_value_t value);
 bool jerry_value_is_number (const jerry_value_t value);
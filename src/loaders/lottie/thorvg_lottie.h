@@ -33,6 +33,71 @@ public:
      */
     Result override(const char* slot) noexcept;
 
+    /**
+     * @brief Overrides the value of a rotation or an opacity slot directly, without parsing any slot data.
+     *
+     * @param[in] sid The slot id.
+     * @param[in] val The rotation in degrees, or the opacity in percent (0 ~ 100), by the slot type.
+     *
+     * @retval Result::InsufficientCondition In case the animation is not loaded.
+     * @retval Result::InvalidArguments If @p sid is @c nullptr.
+     * @retval Result::NonSupport If no rotation or opacity slot of @p sid is found.
+     *
+     * @note The overridden values are reset by override(nullptr).
+     * @note Experimental API
+     */
+    Result override(const char* sid, float val) noexcept;
+
+    /**
+     * @brief Overrides the value of a scale or a position slot directly, without parsing any slot data.
+     *
+     * @param[in] sid The slot id.
+     * @param[in] x The horizontal scale in percent, or the x coordinate of the position, by the slot type.
+     * @param[in] y The vertical scale in percent, or the y coordinate of the position, by the slot type.
+     *
+     * @retval Result::InsufficientCondition In case the animation is not loaded.
+     * @retval Result::InvalidArguments If @p sid is @c nullptr.
+     * @retval Result::NonSupport If no scale or position slot of @p sid is found.
+     *
+     * @note The overridden values are reset by override(nullptr).
+     * @note Experimental API
+     */
+    Result override(const char* sid, float x, float y) noexcept;
+
+    /**
+     * @brief Overrides the value of a color slot directly, without parsing any slot data.
+     *
+     * @param[in] sid The slot id.
+     * @param[in] r The red color channel value in the range [0 ~ 255].
+     * @param[in] g The green color channel value in the range [0 ~ 255].
+     * @param[in] b The blue color channel value in the range [0 ~ 255].
+     *
+     * @retval Result::InsufficientCondition In case the animation is not loaded.
+     * @retval Result::InvalidArguments If @p sid is @c nullptr.
+     * @retval Result::NonSupport If no color slot of @p sid is found.
+     *
+     * @note The overridden values are reset by override(nullptr).
+     * @note Experimental API
+     */
+    Result override(const char* sid, uint8_t r, uint8_t g, uint8_t b) noexcept;
+
+    /**
+     * @brief Overrides the text of a text document slot directly, without parsing any slot data.
+     *
+     * The other document properties, such as the font and the size, are kept as they are at the current frame.
+     *
+     * @param[in] sid The slot id.
+     * @param[in] text The new text in UTF-8.
+     *
+     * @retval Result::InsufficientCondition In case the animation is not loaded.
+     * @retval Result::InvalidArguments If @p sid or @p text is @c nullptr.
+     * @retval Result::NonSupport If no text document slot of @p sid is found.
+     *
+     * @note The overridden values are reset by override(nullptr).
+     * @note Experimental API
+     */
+    Result override(const char* sid, const char* text) noexcept;
+
     /**
     * @brief Specifies a segment by marker. 
     * 
@@ -110,6 +175,80 @@ public:
      */
     Result assign(const char* layer, uint32_t ix, const char* var, float val);
 
+    /**
+     * @brief Retains the built frames to replay them without interpolating the animation again.
+     *
+     * Once a frame is built, its paints are kept until the given memory budget is used up.
+     * Revisiting a retained frame, as in a looping animation, reuses the paints instead of rebuilding the scene.
+     *
+     * @param[in] budget The memory budget of the retained frames in bytes. @c 0 disables the cache (default).
+     *
+     * @retval Result::InsufficientCondition If the animation is not loaded.
+     *
+     * @note The retained frames are discarded when the slots or the expression variables are changed.
+     * @note The tweening frames are not retained.
+     * @note Experimental API
+     */
+    Result cache(uint32_t budget) noexcept;
+
+    /**
+     * @brief Adapts the rendering quality of the animation to keep its frames within the time budget.
+     *
+     * The time spent on updating and drawing the animation picture is measured over the frames. While it exceeds the budget,
+     * the quality of the costly effects is lowered step by step: the blurs and the shadows are first drawn in a lower quality
+     * and then skipped. The quality is recovered as the measured time falls well below the budget again.
+     * This prefers a smooth playback to the fidelity, e.g. on a throttled device.
+     *
+     * @param[in] budget The time budget of a frame in milliseconds. @c 0 turns the adaptation off and restores the full quality (default).
+     *
+     * @retval Result::InvalidArguments If the @p budget is negative.
+     * @retval Result::InsufficientCondition If the animation is not loaded.
+     *
+     * @note The quality changes apply from the next frame and discard the retained frames, see cache().
+     * @note Experimental API
+     */
+    Result adapt(float budget) noexcept;
+
+    /**
+     * @brief Sets the heap size of the expressions engines.
+     *
+     * Every animation with expressions evaluates them in its own engine, isolated from the other animations,
+     * so that the animations could be updated on the different threads. An engine running short of its heap
+     * collects the garbage over and over in the middle of the frames, which a larger heap avoids for the heavy
+     * expressions. A smaller heap saves the memory of the simple ones.
+     *
+     * @param[in] heap The heap size in bytes. @c 0 sets the default size, 512 KB. It's raised to 64 KB at least.
+     *
+     * @retval Result::NonSupport If the expressions are not supported by this build.
+     *
+     * @note The size applies to the animations loaded after this call.
+     * @note Experimental API
+     */
+    static Result expressions(uint32_t heap) noexcept;
+
+    /**
+     * @brief Loads the Lottie data chunk by chunk as it arrives from a data source.
+     *
+     * The first chunk opens the picture of this animation and the following chunks are appended to it.
+     * The animation info, such as the picture size, the total frame count and the duration, becomes available
+     * as soon as the received data contains the composition header. The animation is parsed and built once
+     * the last chunk is fed, and its frames can be updated from then on.
+     *
+     * @param[in] data A chunk of the Lottie data. The chunk is copied.
+     * @param[in] size The size of the chunk in bytes.
+     * @param[in] last @c true when @p data is the final chunk of the Lottie data.
+     * @param[in] rpath A resource directory path for the external assets, taken with the first chunk. @c nullptr for the current directory.
+     *
+     * @retval Result::InvalidArguments In case @c nullptr or zero size is passed.
+     * @retval Result::InsufficientCondition If the picture is already loaded by any other means.
+     * @retval Result::Unknown If the completed data is not a valid Lottie data.
+     *
+     * @note Animation::frame() returns Result::InsufficientCondition until the last chunk is fed.
+     * @see Picture::load(const char* data, uint32_t size, const char* mimeType, const char* rpath, bool copy)
+     * @note Experimental API
+     */
+    Result feed(const char* data, uint32_t size, bool last, const char* rpath = nullptr) noexcept;
+
     /**
      * @brief Creates a new LottieAnimation object.
      *
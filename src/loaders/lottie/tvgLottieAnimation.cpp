@@ -23,6 +23,7 @@
 #include "tvgCommon.h"
 #include "thorvg_lottie.h"
 #include "tvgLottieLoader.h"
+#include "tvgLottieExpressions.h"
 #include "tvgAnimation.h"
 
 
@@ -43,6 +44,47 @@ Result LottieAnimation::override(const char* slot) noexcept
 }
 
 
+template<typename... Args>
+static Result _override(Picture* picture, const char* sid, Args... args)
+{
+    if (!sid) return Result::InvalidArguments;
+
+    auto loader = PICTURE(picture)->loader;
+    if (!loader) return Result::InsufficientCondition;
+
+    if (static_cast<LottieLoader*>(loader)->override(sid, args...)) {
+        PAINT(picture)->mark(RenderUpdateFlag::All);
+        return Result::Success;
+    }
+    return Result::NonSupport;
+}
+
+
+Result LottieAnimation::override(const char* sid, float val) noexcept
+{
+    return _override(pImpl->picture, sid, val);
+}
+
+
+Result LottieAnimation::override(const char* sid, float x, float y) noexcept
+{
+    return _override(pImpl->picture, sid, Point{x, y});
+}
+
+
+Result LottieAnimation::override(const char* sid, uint8_t r, uint8_t g, uint8_t b) noexcept
+{
+    return _override(pImpl->picture, sid, r, g, b);
+}
+
+
+Result LottieAnimation::override(const char* sid, const char* text) noexcept
+{
+    if (!text) return Result::InvalidArguments;
+    return _override(pImpl->picture, sid, text);
+}
+
+
 Result LottieAnimation::segment(const char* marker) noexcept
 {
     auto loader = PICTURE(pImpl->picture)->loader;
@@ -100,6 +142,76 @@ Result LottieAnimation::assign(const char* layer, uint32_t ix, const char* var,
 }
 
 
+Result LottieAnimation::cache(uint32_t budget) noexcept
+{
+    auto loader = PICTURE(pImpl->picture)->loader;
+    if (!loader) return Result::InsufficientCondition;
+    if (!static_cast<LottieLoader*>(loader)->cache(budget)) return Result::InsufficientCondition;
+    return Result::Success;
+}
+
+
+Result LottieAnimation::adapt(float budget) noexcept
+{
+    if (!(budget >= 0.0f)) return Result::InvalidArguments;
+
+    auto loader = PICTURE(pImpl->picture)->loader;
+    if (!loader) return Result::InsufficientCondition;
+    if (!static_cast<LottieLoader*>(loader)->adapt(budget)) return Result::InsufficientCondition;
+    return Result::Success;
+}
+
+
+Result LottieAnimation::expressions(uint32_t heap) noexcept
+{
+    if (!LottieExpressions::supported()) return Result::NonSupport;
+    LottieExpressions::heap(heap);
+    return Result::Success;
+}
+
+
+Result LottieAnimation::feed(const char* data, uint32_t size, bool last, const char* rpath) noexcept
+{
+    if (!data || size == 0) return Result::InvalidArguments;
+
+    auto picture = PICTURE(pImpl->picture);
+    auto loader = static_cast<LottieLoader*>(picture->loader);
+
+    //the first chunk opens the stream
+    if (!loader) {
+        loader = new LottieLoader;
+        loader->stream(rpath);
+        picture->load(loader);
+    } else if (loader->type != FileType::Lot || !loader->streaming) {
+        return Result::InsufficientCondition;
+    }
+
+    auto known = loader->frameRate > 0.0f;
+
+    if (!loader->feed(data, size, last)) {
+        //drop the broken stream
+        if (last) {
+            picture->loader = nullptr;
+            LoaderMgr::retrieve(loader);
+        }
+        return Result::Unknown;
+    }
+
+    //the header has just arrived
+    if (!known && loader->frameRate > 0.0f && !picture->resizing) {
+        picture->w = loader->w;
+        picture->h = loader->h;
+    }
+
+    if (last) {
+        loader->read();
+        PAINT(picture)->mark(RenderUpdateFlag::All);
+    }
+
+    return Result::Success;
+}
+
+
 LottieAnimation* LottieAnimation::gen() noexcept
 {
     return new LottieAnimation;
@@ -26,6 +26,7 @@
 #include "tvgScene.h"
 #include "tvgLottieModel.h"
 #include "tvgLottieBuilder.h"
+#include "tvgLottieParser.h"
 #include "tvgLottieExpressions.h"
 
 
@@ -33,8 +34,11 @@
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
-static bool _buildComposition(LottieComposition* comp, LottieLayer* parent);
-static bool _draw(LottieGroup* parent, LottieShape* shape, RenderContext* ctx);
+static constexpr uint32_t LAYER_GROUPS_MIN = 8;   //not worth to fork the small compositions
+
+static bool _buildComposition(LottieComposition* comp, LottieLayer* parent, bool expressions, bool defer = false);
+static void _buildReference(LottieComposition* comp, LottieLayer* layer, bool expressions, bool defer = false);
+static bool _draw(LottieGroup* parent, LottieShape* shape, RenderContext* ctx, const void* owner);
 
 
 static void _rotate(LottieTransform* transform, float frameNo, Matrix& m, float angle, Tween& tween, LottieExpressions* exps)
@@ -153,7 +157,8 @@ void LottieBuilder::updateTransform(LottieLayer* layer, float frameNo)
 
     if (parent) layer->cache.matrix = parent->cache.matrix * matrix;
 
-    layer->cache.frameNo = frameNo;
+    //the tweened transform is never reused by the next frames
+    layer->cache.frameNo = tweening() ? -1.0f : frameNo;
 }
 
 
@@ -209,10 +214,10 @@ void LottieBuilder::updateGroup(LottieGroup* parent, LottieObject** child, float
     group->reqFragment |= ctx->reqFragment;
 
     //generate a merging shape to consolidate partial shapes into a single entity
-    if (group->mergeable()) _draw(group, nullptr, ctx);
+    if (group->mergeable()) _draw(group, nullptr, ctx, this);
 
     Inlist<RenderContext> contexts;
-    auto propagator = group->mergeable() ? ctx->propagator : static_cast<Shape*>(PAINT(ctx->propagator)->duplicate(group->pooling()));
+    auto propagator = group->mergeable() ? ctx->propagator : static_cast<Shape*>(PAINT(ctx->propagator)->duplicate(group->pooling(this)));
     contexts.back(new RenderContext(*ctx, propagator, group->mergeable()));
 
     updateChildren(group, frameNo, contexts);
@@ -241,7 +246,7 @@ bool LottieBuilder::fragmented(LottieGroup* parent, LottieObject** child, Inlist
     if (ctx->fragment) return true;
     if (!ctx->reqFragment) return false;
 
-    contexts.back(new RenderContext(*ctx, (Shape*)(PAINT(ctx->propagator)->duplicate(parent->pooling()))));
+    contexts.back(new RenderContext(*ctx, (Shape*)(PAINT(ctx->propagator)->duplicate(parent->pooling(this)))));
 
     contexts.tail->begin = child - 1;
     ctx->fragment = fragment;
@@ -326,12 +331,12 @@ bool LottieBuilder::updateGradientFill(LottieGroup* parent, LottieObject** child
 }
 
 
-static bool _draw(LottieGroup* parent, LottieShape* shape, RenderContext* ctx)
+static bool _draw(LottieGroup* parent, LottieShape* shape, RenderContext* ctx, const void* owner)
 {
     if (ctx->merging) return false;
 
     if (shape) {
-        ctx->merging = shape->pooling();
+        ctx->merging = shape->pooling(owner);
         PAINT(ctx->propagator)->duplicate(ctx->merging);
     } else {
         ctx->merging = static_cast<Shape*>(ctx->propagator->duplicate());
@@ -345,30 +350,33 @@ static bool _draw(LottieGroup* parent, LottieShape* shape, RenderContext* ctx)
 
 static void _repeat(LottieGroup* parent, Shape* path, RenderContext* ctx)
 {
-    Array<Shape*> propagators;
+    SmallArray<Shape*, 16> propagators;
     propagators.push(ctx->propagator);
-    Array<Shape*> shapes;
+    SmallArray<Shape*, 16> shapes;
 
     ARRAY_REVERSE_FOREACH(repeater, ctx->repeaters) {
-        shapes.reserve(repeater->cnt);
+        shapes.reserve(repeater->cnt * propagators.count);
+
+        Matrix inv;
+        inverse(&repeater->transform, &inv);
 
         for (int i = 0; i < repeater->cnt; ++i) {
             auto multiplier = repeater->offset + static_cast<float>(i);
+            auto opacity = tvg::lerp<uint8_t>(repeater->startOpacity, repeater->endOpacity, static_cast<float>(i + 1) / repeater->cnt);
+
+            auto m = tvg::identity();
+            translate(&m, repeater->position * multiplier + repeater->anchor);
+            scale(&m, {powf(repeater->scale.x * 0.01f, multiplier), powf(repeater->scale.y * 0.01f, multiplier)});
+            rotate(&m, repeater->rotation * multiplier);
+            translateR(&m, -repeater->anchor);
+            m = repeater->transform * m;
+
             ARRAY_FOREACH(p, propagators) {
                 auto shape = static_cast<Shape*>((*p)->duplicate());
-                SHAPE(shape)->rs.path = SHAPE(path)->rs.path;
-                auto opacity = tvg::lerp<uint8_t>(repeater->startOpacity, repeater->endOpacity, static_cast<float>(i + 1) / repeater->cnt);
+                //the copies refer to the same path data, the source shape takes its own one when it's rebuilt
+                SHAPE(path)->rs.path.share(SHAPE(shape)->rs.path);
                 shape->opacity(MULTIPLY((*p)->opacity(), opacity));
-
-                auto m = tvg::identity();
-                translate(&m, repeater->position * multiplier + repeater->anchor);
-                scale(&m, {powf(repeater->scale.x * 0.01f, multiplier), powf(repeater->scale.y * 0.01f, multiplier)});
-                rotate(&m, repeater->rotation * multiplier);
-                translateR(&m, -repeater->anchor);
-
-                Matrix inv;
-                inverse(&repeater->transform, &inv);
-                shape->transform((repeater->transform * m) * (inv * shape->transform()));
+                shape->transform(m * (inv * shape->transform()));
                 shapes.push(shape);
             }
         }
@@ -427,10 +435,10 @@ void LottieBuilder::updateRect(LottieGroup* parent, LottieObject** child, float
     }
 
     if (ctx->repeaters.empty()) {
-        _draw(parent, rect, ctx);
+        _draw(parent, rect, ctx, this);
         appendRect(ctx->merging, pos, size, r, rect->clockwise, ctx);
     } else {
-        auto shape = rect->pooling();
+        auto shape = rect->pooling(this);
         shape->reset();
         appendRect(shape, pos, size, r, rect->clockwise, ctx);
         _repeat(parent, shape, ctx);
@@ -461,10 +469,10 @@ void LottieBuilder::updateEllipse(LottieGroup* parent, LottieObject** child, flo
     auto size = ellipse->size(frameNo, tween, exps) * 0.5f;
 
     if (ctx->repeaters.empty()) {
-        _draw(parent, ellipse, ctx);
+        _draw(parent, ellipse, ctx, this);
         _appendCircle(ctx->merging, pos, size, ellipse->clockwise, ctx);
     } else {
-        auto shape = ellipse->pooling();
+        auto shape = ellipse->pooling(this);
         shape->reset();
         _appendCircle(shape, pos, size, ellipse->clockwise, ctx);
         _repeat(parent, shape, ctx);
@@ -477,12 +485,12 @@ void LottieBuilder::updatePath(LottieGroup* parent, LottieObject** child, float
     auto path = static_cast<LottiePath*>(*child);
 
     if (ctx->repeaters.empty()) {
-        _draw(parent, path, ctx);
+        _draw(parent, path, ctx, this);
         if (path->pathset(frameNo, SHAPE(ctx->merging)->rs.path, ctx->transform, tween, exps, ctx->modifier)) {
             PAINT(ctx->merging)->mark(RenderUpdateFlag::Path);
         }
     } else {
-        auto shape = path->pooling();
+        auto shape = path->pooling(this);
         shape->reset();
         path->pathset(frameNo, SHAPE(shape)->rs.path, ctx->transform, tween, exps, ctx->modifier);
         _repeat(parent, shape, ctx);
@@ -520,7 +528,7 @@ void LottieBuilder::updateStar(LottiePolyStar* star, float frameNo, Matrix* tran
 
     Shape* shape;
     if (roundedCorner || ctx->offset) {
-        shape = star->pooling();
+        shape = star->pooling(this);
         shape->reset();
     } else {
         shape = merging;
@@ -632,7 +640,7 @@ void LottieBuilder::updatePolygon(LottieGroup* parent, LottiePolyStar* star, flo
 
     Shape* shape;
     if (roundedCorner || ctx->offset) {
-        shape = star->pooling();
+        shape = star->pooling(this);
         shape->reset();
     } else {
         shape = merging;
@@ -696,12 +704,12 @@ void LottieBuilder::updatePolystar(LottieGroup* parent, LottieObject** child, fl
     auto identity = tvg::identity((const Matrix*)&matrix);
 
     if (ctx->repeaters.empty()) {
-        _draw(parent, star, ctx);
+        _draw(parent, star, ctx, this);
         if (star->type == LottiePolyStar::Star) updateStar(star, frameNo, (identity ? nullptr : &matrix), ctx->merging, ctx, tween, exps);
         else updatePolygon(parent, star, frameNo, (identity  ? nullptr : &matrix), ctx->merging, ctx, tween, exps);
         PAINT(ctx->merging)->mark(RenderUpdateFlag::Path);
     } else {
-        auto shape = star->pooling();
+        auto shape = star->pooling(this);
         shape->reset();
         if (star->type == LottiePolyStar::Star) updateStar(star, frameNo, (identity ? nullptr : &matrix), shape, ctx, tween, exps);
         else updatePolygon(parent, star, frameNo, (identity  ? nullptr : &matrix), shape, ctx, tween, exps);
@@ -716,7 +724,7 @@ void LottieBuilder::updateRoundedCorner(TVG_UNUSED LottieGroup* parent, LottieOb
     auto r = roundedCorner->radius(frameNo, tween, exps);
     if (r < LottieRoundnessModifier::ROUNDNESS_EPSILON) return;
 
-    if (!ctx->roundness) ctx->roundness = new LottieRoundnessModifier(&buffer, r);
+    if (!ctx->roundness) ctx->roundness = new LottieRoundnessModifier(r);
     else if (ctx->roundness->r < r) ctx->roundness->r = r;
 
     ctx->update(ctx->roundness);
@@ -851,19 +859,49 @@ void LottieBuilder::updateChildren(LottieGroup* parent, float frameNo, Inlist<Re
 }
 
 
+/* The references of a precomp asset at the same local frame build the same content.
+   The first one of the update builds it, and the others take its copy instead of interpolating it again. */
+bool LottieBuilder::instantiate(LottieComposition* comp, LottieLayer* precomp, float frameNo)
+{
+    //the expressions and the tweening could tell the references apart
+    if (tweening() || comp->expressions) return false;
+
+    //the asset layer parents the shared children
+    auto& instance = static_cast<LottieLayer*>(precomp->children.first())->comp->instance;
+
+    if (instance.builder == this && instance.pass == pass && equal(instance.frameNo, frameNo) && instance.w == precomp->w && instance.h == precomp->h) {
+        for (auto paint : SCENE(instance.scene)->paints) {
+            precomp->scene->push(paint->duplicate());
+        }
+        return true;
+    }
+
+    instance.builder = this;
+    instance.scene = precomp->scene;
+    instance.pass = pass;
+    instance.frameNo = frameNo;
+    instance.w = precomp->w;
+    instance.h = precomp->h;
+
+    return false;
+}
+
+
 void LottieBuilder::updatePrecomp(LottieComposition* comp, LottieLayer* precomp, float frameNo)
 {
     if (precomp->children.empty()) return;
 
     frameNo = precomp->remap(comp, frameNo, exps);
 
-    ARRAY_REVERSE_FOREACH(c, precomp->children) {
-        auto child = static_cast<LottieLayer*>(*c);
-        if (!child->matteSrc) updateLayer(comp, precomp->scene, child, frameNo);
+    if (!instantiate(comp, precomp, frameNo)) {
+        ARRAY_REVERSE_FOREACH(c, precomp->children) {
+            auto child = static_cast<LottieLayer*>(*c);
+            if (!child->matteSrc) updateLayer(comp, precomp->scene, child, frameNo, {precomp->w, precomp->h});
+        }
     }
 
     //clip the layer viewport
-    auto clipper = precomp->statical.pooling(true);
+    auto clipper = precomp->statical.pooling(this, true);
     clipper->transform(precomp->cache.matrix);
     precomp->scene->clip(clipper);
 }
@@ -883,7 +921,7 @@ void LottieBuilder::updatePrecomp(LottieComposition* comp, LottieLayer* precomp,
 
 void LottieBuilder::updateSolid(LottieLayer* layer)
 {
-    auto solidFill = layer->statical.pooling(true);
+    auto solidFill = layer->statical.pooling(this, true);
     solidFill->opacity(layer->cache.opacity);
     layer->scene->push(solidFill);
 }
@@ -892,7 +930,7 @@ void LottieBuilder::updateSolid(LottieLayer* layer)
 void LottieBuilder::updateImage(LottieGroup* layer)
 {
     auto image = static_cast<LottieImage*>(layer->children.first());
-    layer->scene->push(image->pooling(true));
+    layer->scene->push(image->pooling(this, true));
 }
 
 
@@ -932,6 +970,30 @@ static void _fontText(TextDocument& doc, Scene* scene)
 }
 
 
+//the pooled shape keeps the shared outline of the same glyph over the frames, only its transform and colors are updated
+void LottieBuilder::updateGlyph(LottieGlyph* glyph, Shape* shape, float frameNo)
+{
+    auto& path = SHAPE(shape)->rs.path;
+
+    if (glyph->statical) {
+        if (path.shared && path.shared == glyph->path.shared) return;
+        shape->reset();
+        glyph->path.share(path);
+        return;
+    }
+
+    shape->reset();
+    ARRAY_FOREACH(p, glyph->children) {
+        auto group = static_cast<LottieGroup*>(*p);
+        ARRAY_FOREACH(p, group->children) {
+            if (static_cast<LottiePath*>(*p)->pathset(frameNo, path, nullptr, tween, exps)) {
+                PAINT(shape)->mark(RenderUpdateFlag::Path);
+            }
+        }
+    }
+}
+
+
 void LottieBuilder::updateText(LottieLayer* layer, float frameNo)
 {
     auto text = static_cast<LottieText*>(layer->children.first());
@@ -1009,167 +1071,143 @@ void LottieBuilder::updateText(LottieLayer* layer, float frameNo)
 
         /* all lowercase letters are converted to uppercase in the "t" text field, making the "ca" value irrelevant, thus AllCaps is nothing to do.
            So only convert lowercase letters to uppercase (for 'SmallCaps' an extra scaling factor applied) */
-        auto code = p;
         auto capScale = 1.0f;
-        char capCode;
-        if ((unsigned char)(p[0]) < 0x80 && doc.caps) {
-            if (*p >= 'a' && *p <= 'z') {
-                capCode = *p + 'A' - 'a';
-                code = &capCode;
-                if (doc.caps == 2) capScale = 0.7f;
-            }
+        if (doc.caps == 2 && *p >= 'a' && *p <= 'z') capScale = 0.7f;
+
+        //the glyphs are resolved once per document
+        auto glyph = text->glyph(doc, p);
+        if (!glyph) {
+            ++p;
+            ++idx;
+            continue;
         }
 
-        //find the glyph
-        bool found = false;
-        ARRAY_FOREACH(g, text->font->chars) {
-            auto glyph = *g;
-            //draw matched glyphs
-            if (!strncmp(glyph->code, code, glyph->len)) {
-                if (textGrouping == LottieText::AlignOption::Group::Chars || textGrouping == LottieText::AlignOption::Group::All) {
-                    //new text group, single scene for each characters
-                    scene->push(textGroup);
-                    textGroup = Scene::gen();
-                    textGroup->translate(cursor.x, cursor.y);
-                }
+        if (textGrouping == LottieText::AlignOption::Group::Chars || textGrouping == LottieText::AlignOption::Group::All) {
+            //new text group, single scene for each characters
+            scene->push(textGroup);
+            textGroup = Scene::gen();
+            textGroup->translate(cursor.x, cursor.y);
+        }
 
-                auto& textGroupMatrix = textGroup->transform();
-                auto shape = text->pooling();
-                shape->reset();
-                ARRAY_FOREACH(p, glyph->children) {
-                    auto group = static_cast<LottieGroup*>(*p);
-                    ARRAY_FOREACH(p, group->children) {
-                        if (static_cast<LottiePath*>(*p)->pathset(frameNo, SHAPE(shape)->rs.path, nullptr, tween, exps)) {
-                            PAINT(shape)->mark(RenderUpdateFlag::Path);
-                        }
-                    }
-                }
-                shape->fill(doc.color.r, doc.color.g, doc.color.b);
-                shape->translate(cursor.x - textGroupMatrix.e13, cursor.y - textGroupMatrix.e23);
-                shape->opacity(255);
-
-                if (doc.stroke.width > 0.0f) {
-                    shape->strokeJoin(StrokeJoin::Round);
-                    shape->strokeWidth(doc.stroke.width / scale);
-                    shape->strokeFill(doc.stroke.color.r, doc.stroke.color.g, doc.stroke.color.b);
+        auto& textGroupMatrix = textGroup->transform();
+        auto shape = text->pooling(this);
+        updateGlyph(glyph, shape, frameNo);
+        shape->fill(doc.color.r, doc.color.g, doc.color.b);
+        shape->translate(cursor.x - textGroupMatrix.e13, cursor.y - textGroupMatrix.e23);
+        shape->opacity(255);
+
+        if (doc.stroke.width > 0.0f) {
+            shape->strokeJoin(StrokeJoin::Round);
+            shape->strokeWidth(doc.stroke.width / scale);
+            shape->strokeFill(doc.stroke.color.r, doc.stroke.color.g, doc.stroke.color.b);
+            shape->order(doc.stroke.below);
+        }
+
+        auto needGroup = false;
+        //text range process
+        if (!text->ranges.empty()) {
+            Point scaling = {1.0f, 1.0f};
+            auto rotation = 0.0f;
+            Point translation = {0.0f, 0.0f};
+            auto color = doc.color;
+            auto strokeColor = doc.stroke.color;
+            uint8_t opacity = 255;
+            uint8_t fillOpacity = 255;
+            uint8_t strokeOpacity = 255;
+
+            ARRAY_FOREACH(p, text->ranges) {
+                auto range = *p;
+                auto basedIdx = idx;
+                if (range->based == LottieTextRange::Based::CharsExcludingSpaces) basedIdx = idx - space;
+                else if (range->based == LottieTextRange::Based::Words) basedIdx = line + space;
+                else if (range->based == LottieTextRange::Based::Lines) basedIdx = line;
+
+                auto f = range->factor(frameNo, float(totalChars), (float)basedIdx);
+                if (tvg::zero(f)) continue;
+                needGroup = true;
+
+                translation = translation + f * range->style.position(frameNo, tween, exps);
+                scaling = scaling * (f * (range->style.scale(frameNo, tween, exps) * 0.01f - Point{1.0f, 1.0f}) + Point{1.0f, 1.0f});
+                rotation += f * range->style.rotation(frameNo, tween, exps);
+
+                opacity = (uint8_t)(opacity - f * (opacity - range->style.opacity(frameNo, tween, exps)));
+                shape->opacity(opacity);
+
+                range->color(frameNo, color, strokeColor, f, tween, exps);
+
+                fillOpacity = (uint8_t)(fillOpacity - f * (fillOpacity - range->style.fillOpacity(frameNo, tween, exps)));
+                shape->fill(color.r, color.g, color.b, fillOpacity);
+
+                if (range->style.flags.strokeWidth) shape->strokeWidth(f * range->style.strokeWidth(frameNo, tween, exps) / scale);
+                if (shape->strokeWidth() > 0.0f) {
+                    strokeOpacity = (uint8_t)(strokeOpacity - f * (strokeOpacity - range->style.strokeOpacity(frameNo, tween, exps)));
+                    shape->strokeFill(strokeColor.r, strokeColor.g, strokeColor.b, strokeOpacity);
                     shape->order(doc.stroke.below);
                 }
+                cursor.x += f * range->style.letterSpacing(frameNo, tween, exps);
 
-                auto needGroup = false;
-                //text range process
-                if (!text->ranges.empty()) {
-                    Point scaling = {1.0f, 1.0f};
-                    auto rotation = 0.0f;
-                    Point translation = {0.0f, 0.0f};
-                    auto color = doc.color;
-                    auto strokeColor = doc.stroke.color;
-                    uint8_t opacity = 255;
-                    uint8_t fillOpacity = 255;
-                    uint8_t strokeOpacity = 255;
-
-                    ARRAY_FOREACH(p, text->ranges) {
-                        auto range = *p;
-                        auto basedIdx = idx;
-                        if (range->based == LottieTextRange::Based::CharsExcludingSpaces) basedIdx = idx - space;
-                        else if (range->based == LottieTextRange::Based::Words) basedIdx = line + space;
-                        else if (range->based == LottieTextRange::Based::Lines) basedIdx = line;
-
-                        auto f = range->factor(frameNo, float(totalChars), (float)basedIdx);
-                        if (tvg::zero(f)) continue;
-                        needGroup = true;
-
-                        translation = translation + f * range->style.position(frameNo, tween, exps);
-                        scaling = scaling * (f * (range->style.scale(frameNo, tween, exps) * 0.01f - Point{1.0f, 1.0f}) + Point{1.0f, 1.0f});
-                        rotation += f * range->style.rotation(frameNo, tween, exps);
-
-                        opacity = (uint8_t)(opacity - f * (opacity - range->style.opacity(frameNo, tween, exps)));
-                        shape->opacity(opacity);
-
-                        range->color(frameNo, color, strokeColor, f, tween, exps);
-
-                        fillOpacity = (uint8_t)(fillOpacity - f * (fillOpacity - range->style.fillOpacity(frameNo, tween, exps)));
-                        shape->fill(color.r, color.g, color.b, fillOpacity);
-
-                        if (range->style.flags.strokeWidth) shape->strokeWidth(f * range->style.strokeWidth(frameNo, tween, exps) / scale);
-                        if (shape->strokeWidth() > 0.0f) {
-                            strokeOpacity = (uint8_t)(strokeOpacity - f * (strokeOpacity - range->style.strokeOpacity(frameNo, tween, exps)));
-                            shape->strokeFill(strokeColor.r, strokeColor.g, strokeColor.b, strokeOpacity);
-                            shape->order(doc.stroke.below);
-                        }
-                        cursor.x += f * range->style.letterSpacing(frameNo, tween, exps);
-
-                        auto spacing = f * range->style.lineSpacing(frameNo, tween, exps);
-                        if (spacing > lineSpacing) lineSpacing = spacing;
-                    }
-
-                    // TextGroup transformation is performed once
-                    if (textGroup->paints().size() == 0 && needGroup) {
-                        tvg::identity(&textGroupMatrix);
-                        translate(&textGroupMatrix, cursor);
-
-                        auto alignment = text->alignOption.anchor(frameNo, tween, exps);
-
-                        // center pivoting
-                        textGroupMatrix.e13 += alignment.x;
-                        textGroupMatrix.e23 += alignment.y;
-
-                        rotate(&textGroupMatrix, rotation);
-
-                        //center pivoting
-                        auto pivot = alignment * -1;
-                        textGroupMatrix.e13 += (pivot.x * textGroupMatrix.e11 + pivot.x * textGroupMatrix.e12);
-                        textGroupMatrix.e23 += (pivot.y * textGroupMatrix.e21 + pivot.y * textGroupMatrix.e22);
-
-                        textGroup->transform(textGroupMatrix);
-                    }
-
-                    auto& matrix = shape->transform();
-                    tvg::identity(&matrix);
-                    translate(&matrix, (translation / scale + cursor) - Point{textGroupMatrix.e13, textGroupMatrix.e23});
-                    tvg::scale(&matrix, scaling * capScale);
-                    shape->transform(matrix);
-                }
+                auto spacing = f * range->style.lineSpacing(frameNo, tween, exps);
+                if (spacing > lineSpacing) lineSpacing = spacing;
+            }
 
-                if (needGroup) {
-                    textGroup->push(shape);
-                } else {
-                    // When text isn't selected, exclude the shape from the text group
-                    // Cases with matrix scaling factors =! 1 handled in the 'needGroup' scenario
-                    auto& matrix = shape->transform();
-
-                    if (followPath) {
-                        tvg::identity(&matrix);
-                        auto angle = 0.0f;
-                        auto halfGlyphWidth = glyph->width * 0.5f;
-                        auto position = followPath->position(cursor.x + halfGlyphWidth + firstMargin, angle);
-                        matrix.e11 = matrix.e22 = capScale;
-                        matrix.e13 = position.x - halfGlyphWidth * matrix.e11;
-                        matrix.e23 = position.y - halfGlyphWidth * matrix.e21;
-                    } else {
-                        matrix.e11 = matrix.e22 = capScale;
-                        matrix.e13 = cursor.x;
-                        matrix.e23 = cursor.y;
-                    }
-
-                    shape->transform(matrix);
-                    scene->push(shape);
-                }
+            // TextGroup transformation is performed once
+            if (textGroup->paints().size() == 0 && needGroup) {
+                tvg::identity(&textGroupMatrix);
+                translate(&textGroupMatrix, cursor);
 
-                p += glyph->len;
-                idx += glyph->len;
+                auto alignment = text->alignOption.anchor(frameNo, tween, exps);
 
-                //advance the cursor position horizontally
-                cursor.x += (glyph->width + doc.tracking) * capScale;
+                // center pivoting
+                textGroupMatrix.e13 += alignment.x;
+                textGroupMatrix.e23 += alignment.y;
 
-                found = true;
-                break;
+                rotate(&textGroupMatrix, rotation);
+
+                //center pivoting
+                auto pivot = alignment * -1;
+                textGroupMatrix.e13 += (pivot.x * textGroupMatrix.e11 + pivot.x * textGroupMatrix.e12);
+                textGroupMatrix.e23 += (pivot.y * textGroupMatrix.e21 + pivot.y * textGroupMatrix.e22);
+
+                textGroup->transform(textGroupMatrix);
             }
+
+            auto& matrix = shape->transform();
+            tvg::identity(&matrix);
+            translate(&matrix, (translation / scale + cursor) - Point{textGroupMatrix.e13, textGroupMatrix.e23});
+            tvg::scale(&matrix, scaling * capScale);
+            shape->transform(matrix);
         }
 
-        if (!found) {
-            ++p;
-            ++idx;
+        if (needGroup) {
+            textGroup->push(shape);
+        } else {
+            // When text isn't selected, exclude the shape from the text group
+            // Cases with matrix scaling factors =! 1 handled in the 'needGroup' scenario
+            auto& matrix = shape->transform();
+
+            if (followPath) {
+                tvg::identity(&matrix);
+                auto angle = 0.0f;
+                auto halfGlyphWidth = glyph->width * 0.5f;
+                auto position = followPath->position(cursor.x + halfGlyphWidth + firstMargin, angle);
+                matrix.e11 = matrix.e22 = capScale;
+                matrix.e13 = position.x - halfGlyphWidth * matrix.e11;
+                matrix.e23 = position.y - halfGlyphWidth * matrix.e21;
+            } else {
+                matrix.e11 = matrix.e22 = capScale;
+                matrix.e13 = cursor.x;
+                matrix.e23 = cursor.y;
+            }
+
+            shape->transform(matrix);
+            scene->push(shape);
         }
+
+        p += glyph->len;
+        idx += glyph->len;
+
+        //advance the cursor position horizontally
+        cursor.x += (glyph->width + doc.tracking) * capScale;
     }
 
     delete(scene);
@@ -1202,7 +1240,7 @@ void LottieBuilder::updateMasks(LottieLayer* layer, float frameNo)
 
         //the first mask
         if (!pShape) {
-            pShape = layer->pooling();
+            pShape = layer->pooling(this);
             SHAPE(pShape)->reset();
             auto compMethod = (method == MaskMethod::Subtract || method == MaskMethod::InvAlpha) ? MaskMethod::InvAlpha : MaskMethod::Alpha;
             //Cheaper. Replace the masking with a clipper
@@ -1214,7 +1252,7 @@ void LottieBuilder::updateMasks(LottieLayer* layer, float frameNo)
             }
         //Chain mask composition
         } else if (pMethod != method || pOpacity != opacity || (method != MaskMethod::Subtract && method != MaskMethod::Difference)) {
-            auto shape = layer->pooling();
+            auto shape = layer->pooling(this);
             SHAPE(shape)->reset();
             pShape->mask(shape, method);
             pShape = shape;
@@ -1238,12 +1276,12 @@ void LottieBuilder::updateMasks(LottieLayer* layer, float frameNo)
 }
 
 
-bool LottieBuilder::updateMatte(LottieComposition* comp, float frameNo, Scene* scene, LottieLayer* layer)
+bool LottieBuilder::updateMatte(LottieComposition* comp, float frameNo, Scene* scene, LottieLayer* layer, const Point& viewport)
 {
     auto target = layer->matteTarget;
     if (!target || target->type == LottieLayer::Null) return true;
 
-    updateLayer(comp, scene, target, frameNo);
+    updateLayer(comp, scene, target, frameNo, viewport);
 
     if (target->scene) {
         layer->scene->mask(target->scene, layer->matteType);
@@ -1261,7 +1299,7 @@ void LottieBuilder::updateStrokeEffect(LottieLayer* layer, LottieFxStroke* effec
 {
     if (layer->masks.count == 0) return;
 
-    auto shape = layer->pooling();
+    auto shape = layer->pooling(this);
     shape->reset();
 
     //FIXME: all mask
@@ -1312,11 +1350,14 @@ void LottieBuilder::updateStrokeEffect(LottieLayer* layer, LottieFxStroke* effec
 
 void LottieBuilder::updateEffect(LottieLayer* layer, float frameNo)
 {
-    constexpr int QUALITY = 35;
+    constexpr int QUALITIES[] = {35, 10};   //the blurs by the degrade steps, skipped beyond
     constexpr float BLUR_TO_SIGMA = 0.3f;
 
     if (layer->effects.count == 0) return;
 
+    auto blurring = degrade < sizeof(QUALITIES) / sizeof(QUALITIES[0]);
+    auto quality = blurring ? QUALITIES[degrade] : 0;
+
     ARRAY_FOREACH(p, layer->effects) {
         if (!(*p)->enable) continue;
         switch ((*p)->type) {
@@ -1347,15 +1388,17 @@ void LottieBuilder::updateEffect(LottieLayer* layer, float frameNo)
                 break;
             }
             case LottieEffect::DropShadow: {
+                if (!blurring) break;
                 auto effect = static_cast<LottieFxDropShadow*>(*p);
                 auto color = effect->color(frameNo);
                 //seems the opacity range in dropshadow is 0 ~ 256
-                layer->scene->push(SceneEffect::DropShadow, color.r, color.g, color.b, std::min(255, (int)effect->opacity(frameNo)), (double)effect->angle(frameNo), double(effect->distance(frameNo) * 0.5f), (double)(effect->blurness(frameNo) * BLUR_TO_SIGMA), QUALITY);
+                layer->scene->push(SceneEffect::DropShadow, color.r, color.g, color.b, std::min(255, (int)effect->opacity(frameNo)), (double)effect->angle(frameNo), double(effect->distance(frameNo) * 0.5f), (double)(effect->blurness(frameNo) * BLUR_TO_SIGMA), quality);
                 break;
             }
             case LottieEffect::GaussianBlur: {
+                if (!blurring) break;
                 auto effect = static_cast<LottieFxGaussianBlur*>(*p);
-                layer->scene->push(SceneEffect::GaussianBlur, (double)(effect->blurness(frameNo) * BLUR_TO_SIGMA), effect->direction(frameNo) - 1, effect->wrap(frameNo), QUALITY);
+                layer->scene->push(SceneEffect::GaussianBlur, (double)(effect->blurness(frameNo) * BLUR_TO_SIGMA), effect->direction(frameNo) - 1, effect->wrap(frameNo), quality);
                 break;
             }
             default: break;
@@ -1364,18 +1407,139 @@ void LottieBuilder::updateEffect(LottieLayer* layer, float frameNo)
 }
 
 
-void LottieBuilder::updateLayer(LottieComposition* comp, Scene* scene, LottieLayer* layer, float frameNo)
+//the layers bounded by their size are tested against the viewport, the others are too costly to measure
+static bool _culled(LottieLayer* layer, const Point& viewport)
+{
+    //the effects could spread out of the layer bounds
+    if (!layer->effects.empty()) return false;
+
+    Point size;
+    switch (layer->type) {
+        case LottieLayer::Precomp:
+        case LottieLayer::Solid: {
+            size = {layer->w, layer->h};
+            break;
+        }
+        case LottieLayer::Image: {
+            auto image = static_cast<LottieImage*>(layer->children.first());
+            size = {image->data.width, image->data.height};
+            break;
+        }
+        default: return false;
+    }
+
+    if (size.x <= 0.0f || size.y <= 0.0f || viewport.x <= 0.0f || viewport.y <= 0.0f) return false;
+
+    Point pts[4] = {{0.0f, 0.0f}, {size.x, 0.0f}, {size.x, size.y}, {0.0f, size.y}};
+    Point min = {FLT_MAX, FLT_MAX}, max = {-FLT_MAX, -FLT_MAX};
+    for (int i = 0; i < 4; ++i) {
+        auto pt = pts[i] * layer->cache.matrix;
+        if (pt.x < min.x) min.x = pt.x;
+        if (pt.y < min.y) min.y = pt.y;
+        if (pt.x > max.x) max.x = pt.x;
+        if (pt.y > max.y) max.y = pt.y;
+    }
+    return (max.x <= 0.0f || max.y <= 0.0f || min.x >= viewport.x || min.y >= viewport.y);
+}
+
+
+/* The scene of a shape layer with a single paint is merely a transformation of it.
+   Hand it over to the paint, the renderer gets a shallower tree to traverse every frame. */
+static Paint* _flatten(LottieLayer* layer)
+{
+    auto scene = layer->scene;
+    auto impl = SCENE(scene);
+
+    if (layer->type != LottieLayer::Shape || impl->paints.size() != 1 || impl->effects || PAINT(scene)->clipper || PAINT(scene)->maskData) return scene;
+    if (PAINT(scene)->blendMethod != BlendMethod::Normal) return scene;
+
+    //the blending paint is composed within the scene
+    auto paint = impl->paints.front();
+    if (PAINT(paint)->blendMethod != BlendMethod::Normal || PAINT(paint)->clipper || PAINT(paint)->maskData) return scene;
+
+    paint->ref();
+    scene->remove(paint);
+    paint->transform(scene->transform() * paint->transform());
+    paint->opacity(MULTIPLY(scene->opacity(), paint->opacity()));
+    //still reachable by the layer name
+    if (paint->id == 0) paint->id = scene->id;
+    paint->unref(false);
+
+    delete(scene);
+    layer->scene = nullptr;
+
+    return paint;
+}
+
+
+/* The root layer without any keyframes and expressions in its parenting chain is built once.
+   Its paint stays in the root scene over the next frames, the renderer finds nothing to update. */
+static Paint* _retain(LottieLayer* layer, bool retainable)
+{
+    auto paint = _flatten(layer);
+
+    if (!retainable || layer->matteTarget) return paint;
+    if (layer->type == LottieLayer::Precomp || layer->type == LottieLayer::Null) return paint;
+
+    for (auto p = layer; p; p = p->parent) {
+        if (p->animated) return paint;
+    }
+
+    paint->ref();
+    layer->retained = paint;
+    return paint;
+}
+
+
+//push the root layer in the drawing order, the others are inserted before the retained paints staying in the scene
+static void _place(Scene* scene, LottieLayer* layer, list<Paint*>::iterator& anchor, bool retainable)
+{
+    auto impl = SCENE(scene);
+    auto retained = layer->retained;
+
+    //the retained paint is the anchor if it stays in the scene
+    if (retained && retained->parent() == scene) {
+        if (layer->reusing) {
+            ++anchor;
+            return;
+        }
+        //not shown or tweened in this frame
+        anchor = impl->remove(anchor);
+    }
+
+    if (layer->reusing) {
+        impl->insert(retained, anchor);
+    } else if (layer->scene) {
+        auto paint = _retain(layer, retainable);
+        //the pooled paints are rewritten without their own marks
+        PAINT(paint)->mark(RenderUpdateFlag::All);
+        impl->insert(paint, anchor);
+    }
+}
+
+
+void LottieBuilder::updateLayer(LottieComposition* comp, Scene* scene, LottieLayer* layer, float frameNo, const Point& viewport)
 {
     layer->scene = nullptr;
+    layer->reusing = false;
 
     //visibility
     if (frameNo < layer->inFrame || frameNo >= layer->outFrame) return;
 
+    //the root layers are placed after the updates, the retained one is still valid
+    if (!scene && layer->retained && !tweening()) {
+        layer->reusing = true;
+        return;
+    }
+
     updateTransform(layer, frameNo);
 
     //full transparent scene. no need to perform
     if (layer->type != LottieLayer::Null && layer->cache.opacity == 0) return;
 
+    //out of the composition viewport. no need to interpolate the contents
+    if (_culled(layer, viewport)) return;
+
     //Prepare render data
     layer->scene = Scene::gen();
     layer->scene->id = layer->id;
@@ -1385,7 +1549,7 @@ void LottieBuilder::updateLayer(LottieComposition* comp, Scene* scene, LottieLay
 
     layer->scene->transform(layer->cache.matrix);
 
-    if (!updateMatte(comp, frameNo, scene, layer)) return;
+    if (!updateMatte(comp, frameNo, scene, layer, viewport)) return;
 
     switch (layer->type) {
         case LottieLayer::Precomp: {
@@ -1408,7 +1572,7 @@ void LottieBuilder::updateLayer(LottieComposition* comp, Scene* scene, LottieLay
         default: {
             if (!layer->children.empty()) {
                 Inlist<RenderContext> contexts;
-                contexts.back(new RenderContext(layer->pooling()));
+                contexts.back(new RenderContext(layer->pooling(this)));
                 updateChildren(layer, frameNo, contexts);
                 contexts.free();
             }
@@ -1422,17 +1586,140 @@ void LottieBuilder::updateLayer(LottieComposition* comp, Scene* scene, LottieLay
 
     updateEffect(layer, frameNo);
 
-    if (!layer->matteSrc) scene->push(layer->scene);
+    if (!layer->matteSrc && scene) scene->push(_flatten(layer));
+}
+
+
+//collect the shared resources which prevent the layer from being built concurrently with others
+static void _dependencies(LottieLayer* layer, Array<uintptr_t>& keys)
+{
+    //the text building is not reentrant (strtok, the glyph outlines shared by the characters)
+    if (layer->type == LottieLayer::Text) keys.push(1);
+
+    if (layer->matteTarget) {
+        keys.push((uintptr_t)layer->matteTarget);
+        _dependencies(layer->matteTarget, keys);
+    }
+
+    //the precomp children and the image assets are shared by the references
+    if (!layer->rid) return;
+    ARRAY_FOREACH(p, keys) {
+        if (*p == (uintptr_t)layer->rid) return;
+    }
+    keys.push((uintptr_t)layer->rid);
+
+    if (layer->type != LottieLayer::Precomp) return;
+    ARRAY_FOREACH(p, layer->children) {
+        _dependencies(static_cast<LottieLayer*>(*p), keys);
+    }
+}
+
+
+static uint32_t _find(Array<uint32_t>& parents, uint32_t i)
+{
+    while (parents[i] != i) i = parents[i] = parents[parents[i]];
+    return i;
+}
+
+
+void LottieLayerTask::run(TVG_UNUSED unsigned tid)
+{
+    builder->updateLayers(comp, frameNo, bin, bins);
+}
+
+
+//attach the deferred precomps which come into the view
+bool LottieBuilder::resolve(LottieComposition* comp, float frameNo)
+{
+    auto resolved = false;
+    for (uint32_t i = 0; i < deferred.count;) {
+        auto layer = deferred[i];
+        if (frameNo < layer->inFrame || frameNo >= layer->outFrame) {
+            ++i;
+            continue;
+        }
+        _buildReference(comp, layer, expressions());
+        deferred[i] = deferred.last();
+        deferred.pop();
+        resolved = true;
+    }
+    return resolved;
+}
+
+
+//group the root layers sharing any resources, each group can be built independently
+void LottieBuilder::partition(LottieComposition* comp)
+{
+    auto& children = comp->root->children;
+
+    Array<uint32_t> parents(children.count);
+    Array<uintptr_t> keys, owners;   //resource, the first layer index using it
+    Array<uintptr_t> deps;
+
+    for (uint32_t i = 0; i < children.count; ++i) {
+        parents.push(i);
+        auto layer = static_cast<LottieLayer*>(children[i]);
+        if (layer->matteSrc) continue;
+        deps.clear();
+        _dependencies(layer, deps);
+        ARRAY_FOREACH(d, deps) {
+            auto found = false;
+            for (uint32_t k = 0; k < keys.count; ++k) {
+                if (keys[k] != *d) continue;
+                parents[_find(parents, i)] = _find(parents, owners[k]);
+                found = true;
+                break;
+            }
+            if (!found) {
+                keys.push(*d);
+                owners.push(i);
+            }
+        }
+    }
+
+    //compact the group indices
+    groups.clear();
+    groupCnt = 0;
+    for (uint32_t i = 0; i < children.count; ++i) {
+        groups.push(-1);
+        if (static_cast<LottieLayer*>(children[i])->matteSrc) continue;
+        auto root = _find(parents, i);
+        groups[i] = (root == i) ? int32_t(groupCnt++) : groups[root];
+    }
 }
 
 
-static void _buildReference(LottieComposition* comp, LottieLayer* layer)
+void LottieBuilder::updateLayers(LottieComposition* comp, float frameNo, uint32_t bin, uint32_t bins)
+{
+    if (exps) exps->bind(bin);
+
+    auto& children = comp->root->children;
+    for (auto i = int32_t(children.count) - 1; i >= 0; --i) {
+        if (groups[i] < 0 || uint32_t(groups[i]) % bins != bin) continue;
+        updateLayer(comp, nullptr, static_cast<LottieLayer*>(children[i]), frameNo, {comp->w, comp->h});
+    }
+
+    if (exps) exps->bind(0);
+}
+
+
+static void _buildReference(LottieComposition* comp, LottieLayer* layer, bool expressions, bool defer)
 {
     ARRAY_FOREACH(p, comp->assets) {
         if (layer->rid != (*p)->id) continue;
         if (layer->type == LottieLayer::Precomp) {
             auto assetLayer = static_cast<LottieLayer*>(*p);
-            if (_buildComposition(comp, assetLayer)) {
+            auto& deferred = assetLayer->deferred;
+            if (deferred.begin) {
+                if (defer) return;
+                //the main parsing is over, terminate the layers there
+                *(deferred.end + 1) = '\0';
+                LottieParser parser(deferred.begin, nullptr, expressions);
+                parser.comp = comp;
+                if (!parser.parse(assetLayer)) TVGERR("LOTTIE", "Invalid Precomp!");
+                deferred.begin = deferred.end = nullptr;
+            }
+            if (_buildComposition(comp, assetLayer, expressions)) {
                 layer->children = assetLayer->children;
                 layer->reqFragment = assetLayer->reqFragment;
             }
@@ -1488,7 +1775,7 @@ static void _attachFont(LottieComposition* comp, LottieLayer* parent)
 }
 
 
-static bool _buildComposition(LottieComposition* comp, LottieLayer* parent)
+static bool _buildComposition(LottieComposition* comp, LottieLayer* parent, bool expressions, bool defer)
 {
     if (parent->children.count == 0) return false;
     if (parent->buildDone) return true;
@@ -1498,7 +1785,7 @@ static bool _buildComposition(LottieComposition* comp, LottieLayer* parent)
         auto child = static_cast<LottieLayer*>(*p);
 
         //attach the precomp layer.
-        if (child->rid) _buildReference(comp, child);
+        if (child->rid) _buildReference(comp, child, expressions, defer);
 
         if (child->matteType != MaskMethod::None) {
             //no index of the matte layer is provided: the layer above is used as the matte source
@@ -1515,7 +1802,7 @@ static bool _buildComposition(LottieComposition* comp, LottieLayer* parent)
             //parenting
             _buildHierarchy(parent, child->matteTarget);
             //precomp referencing
-            if (child->matteTarget->rid) _buildReference(comp, child->matteTarget);
+            if (child->matteTarget->rid) _buildReference(comp, child->matteTarget, expressions, defer);
         }
         _buildHierarchy(parent, child);
 
@@ -1526,6 +1813,46 @@ static bool _buildComposition(LottieComposition* comp, LottieLayer* parent)
 }
 
 
+static void _retrieve(LottieGroup* parent, const void* owner)
+{
+    parent->retrieve(owner);
+
+    ARRAY_FOREACH(p, parent->children) {
+        auto child = *p;
+        switch (child->type) {
+            case LottieObject::Layer: {
+                auto layer = static_cast<LottieLayer*>(child);
+                layer->statical.retrieve(owner);
+                //the precomp children are visited with the assets
+                if (layer->rid) layer->retrieve(owner);
+                else _retrieve(layer, owner);
+                break;
+            }
+            case LottieObject::Group: {
+                _retrieve(static_cast<LottieGroup*>(child), owner);
+                break;
+            }
+            case LottieObject::Rect:
+            case LottieObject::Ellipse:
+            case LottieObject::Path:
+            case LottieObject::Polystar: {
+                static_cast<LottieShape*>(child)->retrieve(owner);
+                break;
+            }
+            case LottieObject::Text: {
+                static_cast<LottieText*>(child)->retrieve(owner);
+                break;
+            }
+            case LottieObject::Image: {
+                static_cast<LottieImage*>(child)->retrieve(owner);
+                break;
+            }
+            default: break;
+        }
+    }
+}
+
+
 /************************************************************************/
 /* External Class Implementation                                        */
 /************************************************************************/
@@ -1535,6 +1862,7 @@ bool LottieBuilder::update(LottieComposition* comp, float frameNo)
     if (comp->root->children.empty()) return false;
 
     comp->clamp(frameNo);
+    ++pass;
 
     if (tweening()) {
         comp->clamp(tween.frameNo);
@@ -1542,33 +1870,137 @@ bool LottieBuilder::update(LottieComposition* comp, float frameNo)
         if (equal(frameNo, tween.frameNo)) offTween();
     }
 
-    if (exps && comp->expressions) exps->update(comp->timeAtFrame(frameNo));
+    auto resolved = resolve(comp, frameNo);
+    if (resolved) partition(comp);
+
+    //the sampled easing is not precise enough to tween
+    if (comp->exact != tweening() || resolved) {
+        comp->exact = tweening();
+        ARRAY_FOREACH(p, comp->interpolators) (*p)->exact = comp->exact;
+    }
+
+    if (comp->expressions) {
+        if (!exps) exps = LottieExpressions::gen();
+        if (exps) exps->update(comp->timeAtFrame(frameNo));
+    }
+
+    auto& children = comp->root->children;
+    auto bins = std::min(groupCnt, TaskScheduler::threads() + 1);
+    auto anchor = SCENE(scene)->paints.begin();
+
+    /* update children layers, the tweening and the expressions referring to the other layers share their states among the layers.
+       the shared model is built under the lock of its instances, which must not wait for the workers. */
+    if (shared || bins < 2 || groupCnt < LAYER_GROUPS_MIN || tweening() || (exps && comp->entangled)) {
+        ARRAY_REVERSE_FOREACH(child, children) {
+            auto layer = static_cast<LottieLayer*>(*child);
+            if (layer->matteSrc) continue;
+            updateLayer(comp, nullptr, layer, frameNo, {comp->w, comp->h});
+            _place(scene, layer, anchor, !tweening() && !shared);
+        }
+        return true;
+    }
+
+    //the parent transforms could be referred by any groups
+    ARRAY_FOREACH(child, children) {
+        updateTransform(static_cast<LottieLayer*>(*child), frameNo);
+    }
 
-    //update children layers
-    ARRAY_REVERSE_FOREACH(child, comp->root->children) {
+    //fork the independent groups, the current thread takes the first bin
+    while (tasks.count < bins - 1) tasks.push(new LottieLayerTask);
+    if (exps) exps->prepare(bins);
+
+    TaskGroup group;
+    for (uint32_t i = 1; i < bins; ++i) {
+        auto task = tasks[i - 1];
+        task->builder = this;
+        task->comp = comp;
+        task->frameNo = frameNo;
+        task->bin = i;
+        task->bins = bins;
+        group.request(task);
+    }
+    updateLayers(comp, frameNo, 0, bins);
+    group.wait();
+
+    ARRAY_REVERSE_FOREACH(child, children) {
         auto layer = static_cast<LottieLayer*>(*child);
-        if (!layer->matteSrc) updateLayer(comp, comp->root->scene, layer, frameNo);
+        if (!layer->matteSrc) _place(scene, layer, anchor, true);
     }
 
     return true;
 }
 
 
+/* drop the retained layers, their properties could be changed by the slots or the expressions.
+   the detached ones are removed from the scene, the others are cleared with the shown frame. */
+void LottieBuilder::invalidate(LottieComposition* comp, bool detach)
+{
+    ARRAY_FOREACH(p, comp->root->children) {
+        auto layer = static_cast<LottieLayer*>(*p);
+        if (!layer->retained) continue;
+        if (detach && layer->retained->parent() == scene) scene->remove(layer->retained);
+        layer->retained->unref();
+        layer->retained = nullptr;
+    }
+}
+
+
+//remove the paints of the last frame but the retained ones, which are in the order of the root layers
+void LottieBuilder::clear(LottieComposition* comp)
+{
+    if (!scene) return;
+
+    auto impl = SCENE(scene);
+    auto it = impl->paints.begin();
+
+    ARRAY_REVERSE_FOREACH(p, comp->root->children) {
+        auto retained = static_cast<LottieLayer*>(*p)->retained;
+        if (!retained || retained->parent() != scene) continue;
+        while (*it != retained) it = impl->remove(it);
+        ++it;
+    }
+    while (it != impl->paints.end()) it = impl->remove(it);
+}
+
+
 void LottieBuilder::build(LottieComposition* comp)
 {
     if (!comp) return;
 
-    comp->root->scene = Scene::gen();
+    scene = Scene::gen();
+
+    //the root precomps are parsed on their first appearance
+    _buildComposition(comp, comp->root, expressions(), true);
+
+    ARRAY_FOREACH(p, comp->root->children) {
+        auto layer = static_cast<LottieLayer*>(*p);
+        if (layer->rid && layer->type == LottieLayer::Precomp && layer->children.empty()) deferred.push(layer);
+    }
 
-    _buildComposition(comp, comp->root);
+    partition(comp);
 
     if (!update(comp, 0)) return;
 
     //viewport clip
     auto clip = Shape::gen();
     clip->appendRect(0, 0, comp->w, comp->h);
-    comp->root->scene->clip(clip);
+    scene->clip(clip);
 
     //turn off partial rendering for children
-    SCENE(comp->root->scene)->size({comp->w, comp->h});
-}
\ No newline at end of file
+    SCENE(scene)->size({comp->w, comp->h});
+}
+
+
+//release the pooled paints of this instance, the model is still used by the other instances
+void LottieBuilder::retrieve(LottieComposition* comp)
+{
+    _retrieve(comp->root, this);
+
+    ARRAY_FOREACH(p, comp->assets) {
+        if ((*p)->type == LottieObject::Layer) {
+            auto layer = static_cast<LottieLayer*>(*p);
+            layer->statical.retrieve(this);
+            _retrieve(layer, this);
+        } else if ((*p)->type == LottieObject::Image) static_cast<LottieImage*>(*p)->retrieve(this);
+    }
+}
@@ -25,6 +25,7 @@
 
 #include "tvgCommon.h"
 #include "tvgInlist.h"
+#include "tvgTaskScheduler.h"
 #include "tvgShape.h"
 #include "tvgLottieExpressions.h"
 #include "tvgLottieModifier.h"
@@ -84,7 +85,7 @@ struct RenderContext
         repeaters = rhs.repeaters;
         fragment = rhs.fragment;
         if (rhs.roundness) {
-            roundness = new LottieRoundnessModifier(rhs.roundness->buffer, rhs.roundness->r);
+            roundness = new LottieRoundnessModifier(rhs.roundness->r);
             update(roundness);
         }
         if (rhs.offset) {
@@ -104,21 +105,36 @@ struct RenderContext
     }
 };
 
+struct LottieBuilder;
+
+//builds a bin of the independent root layers
+struct LottieLayerTask : Task
+{
+    LottieBuilder* builder;
+    LottieComposition* comp;
+    float frameNo;
+    uint32_t bin, bins;
+
+    void run(unsigned tid) override;
+};
+
 struct LottieBuilder
 {
-    LottieBuilder()
+    ~LottieBuilder()
     {
-        exps = LottieExpressions::instance();
+        if (!initiated) delete(scene);
+        ARRAY_FOREACH(p, tasks) delete(*p);
+        LottieExpressions::retrieve(exps);
     }
 
-    ~LottieBuilder()
+    void clear()
     {
-        LottieExpressions::retrieve(exps);
+        if (scene) scene->remove();
     }
 
     bool expressions()
     {
-        return exps ? true : false;
+        return LottieExpressions::supported();
     }
 
     void offTween()
@@ -138,21 +154,41 @@ struct LottieBuilder
         return tween.active;
     }
 
+    bool deferring()
+    {
+        return deferred.count > 0;
+    }
+
     bool update(LottieComposition* comp, float progress);
     void build(LottieComposition* comp);
+    void retrieve(LottieComposition* comp);
+    void invalidate(LottieComposition* comp, bool detach = true);
+    void clear(LottieComposition* comp);
+
+    Scene* scene = nullptr;   //the root scene of this instance
+    bool initiated = false;   //the scene is handed over to the picture
+    bool shared = false;      //the model is built by the other instances in turn
+    uint8_t degrade = 0;      //the quality step lowered under the load, see LottieLoader::adapt()
+    uint32_t pass = 0;        //the count of the updates, which tells the precomp instances of the current one
+    LottieExpressions* exps = nullptr;   //prepared with the first frame of the expressions
 
 private:
     void appendRect(Shape* shape, Point& pos, Point& size, float r, bool clockwise, RenderContext* ctx);
     bool fragmented(LottieGroup* parent, LottieObject** child, Inlist<RenderContext>& contexts, RenderContext* ctx, RenderFragment fragment);
 
+    bool resolve(LottieComposition* comp, float frameNo);
+    void partition(LottieComposition* comp);
+    void updateLayers(LottieComposition* comp, float frameNo, uint32_t bin, uint32_t bins);
     void updateStrokeEffect(LottieLayer* layer, LottieFxStroke* effect, float frameNo);
     void updateEffect(LottieLayer* layer, float frameNo);
-    void updateLayer(LottieComposition* comp, Scene* scene, LottieLayer* layer, float frameNo);
-    bool updateMatte(LottieComposition* comp, float frameNo, Scene* scene, LottieLayer* layer);
+    void updateLayer(LottieComposition* comp, Scene* scene, LottieLayer* layer, float frameNo, const Point& viewport);
+    bool updateMatte(LottieComposition* comp, float frameNo, Scene* scene, LottieLayer* layer, const Point& viewport);
+    bool instantiate(LottieComposition* comp, LottieLayer* precomp, float frameNo);
     void updatePrecomp(LottieComposition* comp, LottieLayer* precomp, float frameNo);
     void updatePrecomp(LottieComposition* comp, LottieLayer* precomp, float frameNo, Tween& tween);
     void updateSolid(LottieLayer* layer);
     void updateImage(LottieGroup* layer);
+    void updateGlyph(LottieGlyph* glyph, Shape* shape, float frameNo);
     void updateText(LottieLayer* layer, float frameNo);
     void updateMasks(LottieLayer* layer, float frameNo);
     void updateTransform(LottieLayer* layer, float frameNo);
@@ -174,9 +210,13 @@ private:
     void updateRoundedCorner(LottieGroup* parent, LottieObject** child, float frameNo, Inlist<RenderContext>& contexts, RenderContext* ctx);
     void updateOffsetPath(LottieGroup* parent, LottieObject** child, float frameNo, Inlist<RenderContext>& contexts, RenderContext* ctx);
 
-    RenderPath buffer;   //resusable path
-    LottieExpressions* exps;
+    Array<LottieLayer*> deferred;   //the root precomp layers not parsed yet
+    Array<LottieLayerTask*> tasks;
+    Array<int32_t> groups;    //independent group index per root layer, -1 for the matte sources
+    uint32_t groupCnt = 0;
     Tween tween;
+
+    friend struct LottieLayerTask;
 };
 
 #endif //_TVG_LOTTIE_BUILDER_H
\ No newline at end of file
@@ -0,0 +1,945 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstddef>
+#include "tvgLottieCompiler.h"
+#include "tvgLottieModel.h"
+
+/************************************************************************/
+/* Internal Class Implementation                                        */
+/************************************************************************/
+
+#define LOTTIE_COMPILER_SIGNATURE "TVGLOT"
+#define LOTTIE_COMPILER_SIGNATURE_LENGTH 6
+#define LOTTIE_COMPILER_VERSION 1
+
+
+//the keyframes are stored as they are, any change of their memory layout invalidates the compiled data
+static uint32_t _layout()
+{
+    const uint32_t endian = 1;
+
+    const uint32_t layout[] = {
+        *reinterpret_cast<const uint8_t*>(&endian),
+        sizeof(void*),
+        sizeof(unsigned long),
+        sizeof(LottieScalarFrame<float>),
+        sizeof(LottieScalarFrame<int8_t>),
+        sizeof(LottieScalarFrame<uint8_t>),
+        sizeof(LottieScalarFrame<Point>),
+        sizeof(LottieScalarFrame<RGB32>),
+        sizeof(LottieScalarFrame<PathSet>),
+        sizeof(LottieScalarFrame<ColorStop>),
+        sizeof(LottieVectorFrame<Point>),
+        sizeof(Fill::ColorStop),
+        sizeof(PathCommand),
+        offsetof(LottieScalarFrame<float>, interpolator),
+        offsetof(LottieScalarFrame<PathSet>, interpolator),
+        offsetof(LottieVectorFrame<Point>, interpolator),
+        offsetof(LottieVectorFrame<Point>, length)
+    };
+
+    uint32_t hash = 5381;
+    for (auto v : layout) hash = hash * 33 + v;
+    return hash;
+}
+
+
+//FNV-1a, a damaged file would pass the bounds checks with the broken values otherwise
+static uint32_t _checksum(const uint8_t* data, uint32_t size)
+{
+    uint32_t hash = 2166136261u;
+    for (auto p = data; p < data + size; ++p) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+
+static uint32_t _align(uint32_t size)
+{
+    return (size + 7) & ~7u;
+}
+
+
+//the pointers in the stored keyframes are the 1-based indices or offsets, 0 is null
+template<typename T>
+static T* _encode(uint32_t val)
+{
+    return reinterpret_cast<T*>(uintptr_t(val) + 1);
+}
+
+
+//the keyframes in the compiled data, not owned by the model
+template<typename T>
+static void _borrow(Array<T>& arr, T* data, uint32_t cnt)
+{
+    arr.data = data;
+    arr.count = cnt;
+    arr.local = 1;
+}
+
+
+static LottieObject* _object(LottieObject::Type type)
+{
+    LottieObject* obj;
+
+    switch (type) {
+        case LottieObject::Layer: obj = new LottieLayer; break;
+        case LottieObject::Group: obj = new LottieGroup; break;
+        case LottieObject::Transform: obj = new LottieTransform; break;
+        case LottieObject::SolidFill: obj = new LottieSolidFill; break;
+        case LottieObject::SolidStroke: obj = new LottieSolidStroke; break;
+        case LottieObject::GradientFill: obj = new LottieGradientFill; break;
+        case LottieObject::GradientStroke: obj = new LottieGradientStroke; break;
+        case LottieObject::Rect: obj = new LottieRect; break;
+        case LottieObject::Ellipse: obj = new LottieEllipse; break;
+        case LottieObject::Path: obj = new LottiePath; break;
+        case LottieObject::Polystar: obj = new LottiePolyStar; break;
+        case LottieObject::Trimpath: obj = new LottieTrimpath; break;
+        case LottieObject::Repeater: obj = new LottieRepeater; break;
+        case LottieObject::RoundedCorner: obj = new LottieRoundedCorner; break;
+        case LottieObject::OffsetPath: obj = new LottieOffsetPath; break;
+        default: return nullptr;
+    }
+    //the groups are typed by their prepare() otherwise
+    obj->type = type;
+    return obj;
+}
+
+
+static LottieEffect* _effect(LottieEffect::Type type)
+{
+    switch (type) {
+        case LottieEffect::Tint: return new LottieFxTint;
+        case LottieEffect::Fill: return new LottieFxFill;
+        case LottieEffect::Stroke: return new LottieFxStroke;
+        case LottieEffect::Tritone: return new LottieFxTritone;
+        case LottieEffect::DropShadow: return new LottieFxDropShadow;
+        case LottieEffect::GaussianBlur: return new LottieFxGaussianBlur;
+        default: return nullptr;
+    }
+}
+
+
+struct LottieWriter
+{
+    static constexpr bool reading = false;
+
+    LottieComposition* comp;
+    Array<uint8_t> keyframes, data, objects;
+    bool invalid = false;
+
+    LottieWriter(LottieComposition* comp) : comp(comp) {}
+
+    bool valid()
+    {
+        return !invalid;
+    }
+
+    void write(Array<uint8_t>& section, const void* src, uint32_t size)
+    {
+        if (size == 0) return;
+        section.grow(size);
+        memcpy(section.data + section.count, src, size);
+        section.count += size;
+    }
+
+    //append the data at the aligned offset of the section
+    uint32_t append(Array<uint8_t>& section, const void* src, uint32_t size)
+    {
+        auto offset = _align(section.count);
+        section.grow(offset - section.count + size);
+        memset(section.data + section.count, 0x00, offset - section.count);
+        section.count = offset;
+        write(section, src, size);
+        return offset;
+    }
+
+    template<typename T>
+    void value(const T& val)
+    {
+        write(objects, &val, sizeof(T));
+    }
+
+    template<typename T>
+    void array(T*& arr, uint32_t cnt)
+    {
+        if (cnt > 0 && !arr) invalid = true;
+        else write(objects, arr, sizeof(T) * cnt);
+    }
+
+    void string(char*& str)
+    {
+        uint32_t len = str ? strlen(str) : 0;
+        value(len);
+        write(objects, str, len);
+    }
+
+    uint32_t index(LottieInterpolator* interpolator)
+    {
+        for (uint32_t i = 0; i < comp->interpolators.count; ++i) {
+            if (comp->interpolators[i] == interpolator) return i;
+        }
+        invalid = true;
+        return 0;
+    }
+
+    template<typename Frame>
+    void relocate(TVG_UNUSED Frame& frame, TVG_UNUSED uint16_t cnt)
+    {
+    }
+
+    void relocate(LottieScalarFrame<PathSet>& frame, TVG_UNUSED uint16_t cnt)
+    {
+        auto& path = frame.value;
+        if ((path.ptsCnt > 0 && !path.pts) || (path.cmdsCnt > 0 && !path.cmds)) invalid = true;
+        path.pts = _encode<Point>(append(data, path.pts, sizeof(Point) * path.ptsCnt));
+        path.cmds = _encode<PathCommand>(append(data, path.cmds, sizeof(PathCommand) * path.cmdsCnt));
+    }
+
+    void relocate(LottieScalarFrame<ColorStop>& frame, uint16_t cnt)
+    {
+        auto& stops = frame.value;
+        if (cnt > 0 && !stops.data) invalid = true;
+        stops.data = _encode<Fill::ColorStop>(append(data, stops.data, sizeof(Fill::ColorStop) * cnt));
+        stops.input = nullptr;
+    }
+
+    //store the keyframes in their memory layout, the pointers are relocated on the loading
+    template<typename Frame>
+    uint32_t frames(const Frame* src, uint32_t cnt, uint16_t stops = 0)
+    {
+        auto offset = append(keyframes, src, sizeof(Frame) * cnt);
+        for (uint32_t i = 0; i < cnt; ++i) {
+            auto& frame = reinterpret_cast<Frame*>(keyframes.data + offset)[i];
+            if (frame.interpolator) frame.interpolator = _encode<LottieInterpolator>(index(frame.interpolator));
+            relocate(frame, stops);
+        }
+        return offset;
+    }
+
+    template<typename Frame, typename Value, LottieProperty::Type PType, bool Scalar>
+    void property(LottieGenericProperty<Frame, Value, PType, Scalar>& prop)
+    {
+        uint32_t cnt = prop.frames ? prop.frames->count : 0;
+        if (prop.exp) invalid = true;
+        value(prop.ix);
+        value(cnt);
+        if (cnt == 0) value(prop.value);
+        else value(frames(prop.frames->data, cnt));
+    }
+
+    void property(LottiePathSet& prop)
+    {
+        uint32_t cnt = prop.frames ? prop.frames->count : 0;
+        if (prop.exp) invalid = true;
+        value(prop.ix);
+        value(cnt);
+        if (cnt == 0) {
+            value(prop.value.ptsCnt);
+            value(prop.value.cmdsCnt);
+            array(prop.value.pts, prop.value.ptsCnt);
+            array(prop.value.cmds, prop.value.cmdsCnt);
+        } else value(frames(prop.frames->data, cnt));
+    }
+
+    void property(LottieColorStop& prop)
+    {
+        uint32_t cnt = prop.frames ? prop.frames->count : 0;
+        if (prop.exp || !prop.populated) invalid = true;
+        value(prop.ix);
+        value(prop.count);
+        value(cnt);
+        if (cnt == 0) array(prop.value.data, prop.count);
+        else value(frames(prop.frames->data, cnt, prop.count));
+    }
+};
+
+
+struct LottieReader
+{
+    static constexpr bool reading = true;
+
+    struct Section
+    {
+        uint8_t* data;
+        uint32_t size;
+    };
+
+    LottieComposition* comp;
+    Section keyframes, data;
+    const uint8_t* objects;
+    uint32_t pos = 0, end;
+    bool invalid = false;
+
+    LottieReader(LottieComposition* comp, uint8_t* base, const LottieCompiler::Header* header) : comp(comp)
+    {
+        keyframes = {base + header->keyframes, header->data - header->keyframes};
+        data = {base + header->data, header->objects - header->data};
+        objects = base + header->objects;
+        end = header->size - header->objects;
+    }
+
+    bool valid()
+    {
+        return !invalid;
+    }
+
+    void read(void* dst, uint32_t size)
+    {
+        if (invalid || size > end - pos) {
+            invalid = true;
+            return;
+        }
+        memcpy(dst, objects + pos, size);
+        pos += size;
+    }
+
+    template<typename T>
+    void value(T& val)
+    {
+        read(&val, sizeof(T));
+    }
+
+    template<typename T>
+    void array(T*& arr, uint32_t cnt)
+    {
+        if (cnt == 0) return;
+        if (uint64_t(cnt) * sizeof(T) > end - pos) {
+            invalid = true;
+            return;
+        }
+        arr = tvg::malloc<T*>(sizeof(T) * cnt);
+        read(arr, sizeof(T) * cnt);
+    }
+
+    void string(char*& str)
+    {
+        uint32_t len = 0;
+        value(len);
+        if (len == 0) return;
+        if (len > end - pos) {
+            invalid = true;
+            return;
+        }
+        str = tvg::malloc<char*>(len + 1);
+        read(str, len);
+        str[len] = '\0';
+    }
+
+    //the pointer to the cnt elements in the section
+    template<typename T>
+    T* pointer(T* encoded, const Section& section, uint32_t cnt)
+    {
+        auto offset = uintptr_t(encoded);
+        if (offset == 0 || (offset - 1) % alignof(T) || offset - 1 + uint64_t(cnt) * sizeof(T) > section.size) {
+            invalid = true;
+            return nullptr;
+        }
+        return reinterpret_cast<T*>(section.data + offset - 1);
+    }
+
+    template<typename Frame>
+    void relocate(TVG_UNUSED Frame& frame, TVG_UNUSED uint16_t cnt)
+    {
+    }
+
+    void relocate(LottieScalarFrame<PathSet>& frame, TVG_UNUSED uint16_t cnt)
+    {
+        auto& path = frame.value;
+        path.pts = pointer(path.pts, data, path.ptsCnt);
+        path.cmds = pointer(path.cmds, data, path.cmdsCnt);
+    }
+
+    void relocate(LottieScalarFrame<ColorStop>& frame, uint16_t cnt)
+    {
+        frame.value.data = pointer(frame.value.data, data, cnt);
+    }
+
+    //the keyframes are used in place, only their pointers are written
+    template<typename Frame>
+    Frame* frames(uint32_t cnt, uint16_t stops = 0)
+    {
+        uint32_t offset = 0;
+        value(offset);
+
+        auto frames = pointer(_encode<Frame>(offset), keyframes, cnt);
+
+        for (uint32_t i = 0; i < cnt && valid(); ++i) {
+            auto& frame = frames[i];
+            if (auto idx = uintptr_t(frame.interpolator)) {
+                if (idx > comp->interpolators.count) invalid = true;
+                else frame.interpolator = comp->interpolators[idx - 1];
+            }
+            relocate(frame, stops);
+        }
+        return valid() ? frames : nullptr;
+    }
+
+    template<typename Frame, typename Value, LottieProperty::Type PType, bool Scalar>
+    void property(LottieGenericProperty<Frame, Value, PType, Scalar>& prop)
+    {
+        uint32_t cnt = 0;
+        value(prop.ix);
+        value(cnt);
+        if (cnt == 0) value(prop.value);
+        else if (auto frames = this->frames<Frame>(cnt)) {
+            prop.frames = new Array<Frame>;
+            _borrow(*prop.frames, frames, cnt);
+        }
+    }
+
+    void property(LottiePathSet& prop)
+    {
+        uint32_t cnt = 0;
+        value(prop.ix);
+        value(cnt);
+        if (cnt == 0) {
+            value(prop.value.ptsCnt);
+            value(prop.value.cmdsCnt);
+            array(prop.value.pts, prop.value.ptsCnt);
+            array(prop.value.cmds, prop.value.cmdsCnt);
+        } else if (auto frames = this->frames<LottieScalarFrame<PathSet>>(cnt)) {
+            prop.frames = tvg::calloc<Array<LottieScalarFrame<PathSet>>*>(1, sizeof(Array<LottieScalarFrame<PathSet>>));
+            _borrow(*prop.frames, frames, cnt);
+        }
+    }
+
+    void property(LottieColorStop& prop)
+    {
+        uint32_t cnt = 0;
+        value(prop.ix);
+        value(prop.count);
+        value(cnt);
+        prop.populated = true;
+        if (cnt == 0) array(prop.value.data, prop.count);
+        else if (auto frames = this->frames<LottieScalarFrame<ColorStop>>(cnt, prop.count)) {
+            prop.frames = tvg::calloc<Array<LottieScalarFrame<ColorStop>>*>(1, sizeof(Array<LottieScalarFrame<ColorStop>>));
+            _borrow(*prop.frames, frames, cnt);
+        }
+    }
+};
+
+
+/* The model is written and read by the same visitors below, the streams tell the direction.
+   The reader creates the objects and prepares them as the parser does. */
+
+template<typename Stream> static void _object(Stream& s, LottieObject* obj);
+
+
+template<typename Stream>
+static void _children(Stream& s, LottieGroup* parent)
+{
+    auto cnt = parent->children.count;
+    s.value(cnt);
+
+    for (uint32_t i = 0; i < cnt && s.valid(); ++i) {
+        LottieObject* child = Stream::reading ? nullptr : parent->children[i];
+        auto type = Stream::reading ? LottieObject::Composition : child->type;
+        s.value(type);
+        if (Stream::reading) {
+            if (!(child = _object(type))) {
+                s.invalid = true;
+                return;
+            }
+            parent->children.push(child);
+            if (type == LottieObject::Layer) static_cast<LottieLayer*>(child)->comp = static_cast<LottieLayer*>(parent);
+        }
+        _object(s, child);
+    }
+}
+
+
+template<typename Stream>
+static void _transform(Stream& s, LottieTransform* transform)
+{
+    s.property(transform->position);
+    s.property(transform->rotation);
+    s.property(transform->scale);
+    s.property(transform->anchor);
+    s.property(transform->opacity);
+    s.property(transform->skewAngle);
+    s.property(transform->skewAxis);
+
+    auto separated = (transform->coords != nullptr);
+    s.value(separated);
+    if (separated) {
+        auto coords = transform->separateCoord();
+        s.property(coords->x);
+        s.property(coords->y);
+    }
+
+    auto rotated = (transform->rotationEx != nullptr);
+    s.value(rotated);
+    if (rotated) {
+        if (Stream::reading) transform->rotationEx = new LottieTransform::RotationEx;
+        s.property(transform->rotationEx->x);
+        s.property(transform->rotationEx->y);
+    }
+}
+
+
+template<typename Stream>
+static void _stroke(Stream& s, LottieStroke* stroke)
+{
+    s.property(stroke->width);
+    s.value(stroke->miterLimit);
+    s.value(stroke->cap);
+    s.value(stroke->join);
+
+    auto dashed = (stroke->dashattr != nullptr);
+    s.value(dashed);
+    if (!dashed) return;
+
+    s.property(stroke->dashOffset());
+    auto cnt = stroke->dashattr->size;
+    s.value(cnt);
+    for (uint8_t i = 0; i < cnt && s.valid(); ++i) {
+        s.property(Stream::reading ? stroke->dashValue() : stroke->dashattr->values[i]);
+    }
+}
+
+
+template<typename Stream>
+static void _gradient(Stream& s, LottieGradient* gradient)
+{
+    s.property(gradient->start);
+    s.property(gradient->end);
+    s.property(gradient->height);
+    s.property(gradient->angle);
+    s.property(gradient->opacity);
+    s.property(gradient->colorStops);
+    s.value(gradient->id);
+    s.value(gradient->opaque);
+}
+
+
+template<typename Stream>
+static void _masks(Stream& s, LottieLayer* layer)
+{
+    auto cnt = layer->masks.count;
+    s.value(cnt);
+
+    for (uint32_t i = 0; i < cnt && s.valid(); ++i) {
+        auto mask = Stream::reading ? new LottieMask : layer->masks[i];
+        if (Stream::reading) layer->masks.push(mask);
+        s.property(mask->pathset);
+        s.property(mask->expand);
+        s.property(mask->opacity);
+        s.value(mask->method);
+        s.value(mask->inverse);
+    }
+}
+
+
+template<typename Stream>
+static void _effects(Stream& s, LottieLayer* layer)
+{
+    auto cnt = layer->effects.count;
+    s.value(cnt);
+
+    for (uint32_t i = 0; i < cnt && s.valid(); ++i) {
+        LottieEffect* effect = Stream::reading ? nullptr : layer->effects[i];
+        auto type = Stream::reading ? LottieEffect::Custom : effect->type;
+        s.value(type);
+        if (Stream::reading) {
+            if (!(effect = _effect(type))) {
+                s.invalid = true;
+                return;
+            }
+            layer->effects.push(effect);
+        }
+        s.value(effect->nm);
+        s.value(effect->mn);
+        s.value(effect->ix);
+        s.value(effect->enable);
+
+        switch (effect->type) {
+            case LottieEffect::Tint: {
+                auto fx = static_cast<LottieFxTint*>(effect);
+                s.property(fx->black);
+                s.property(fx->white);
+                s.property(fx->intensity);
+                break;
+            }
+            case LottieEffect::Fill: {
+                auto fx = static_cast<LottieFxFill*>(effect);
+                s.property(fx->color);
+                s.property(fx->opacity);
+                break;
+            }
+            case LottieEffect::Stroke: {
+                auto fx = static_cast<LottieFxStroke*>(effect);
+                s.property(fx->mask);
+                s.property(fx->allMask);
+                s.property(fx->color);
+                s.property(fx->size);
+                s.property(fx->opacity);
+                s.property(fx->begin);
+                s.property(fx->end);
+                break;
+            }
+            case LottieEffect::Tritone: {
+                auto fx = static_cast<LottieFxTritone*>(effect);
+                s.property(fx->bright);
+                s.property(fx->midtone);
+                s.property(fx->dark);
+                s.property(fx->blend);
+                break;
+            }
+            case LottieEffect::DropShadow: {
+                auto fx = static_cast<LottieFxDropShadow*>(effect);
+                s.property(fx->color);
+                s.property(fx->opacity);
+                s.property(fx->angle);
+                s.property(fx->distance);
+                s.property(fx->blurness);
+                break;
+            }
+            case LottieEffect::GaussianBlur: {
+                auto fx = static_cast<LottieFxGaussianBlur*>(effect);
+                s.property(fx->blurness);
+                s.property(fx->direction);
+                s.property(fx->wrap);
+                break;
+            }
+            //the custom effects bind their properties dynamically
+            default: {
+                s.invalid = true;
+                break;
+            }
+        }
+    }
+}
+
+
+template<typename Stream>
+static void _layer(Stream& s, LottieLayer* layer)
+{
+    //the deferred precomps are not parsed yet
+    if (layer->deferred.begin) s.invalid = true;
+
+    s.value(layer->type);
+    s.value(layer->blendMethod);
+    s.value(layer->timeStretch);
+    s.value(layer->w);
+    s.value(layer->h);
+    s.value(layer->inFrame);
+    s.value(layer->outFrame);
+    s.value(layer->startFrame);
+    s.value(layer->rid);
+    s.value(layer->mix);
+    s.value(layer->pix);
+    s.value(layer->ix);
+    s.value(layer->matteType);
+    s.value(layer->autoOrient);
+    s.value(layer->matteSrc);
+    s.value(layer->animated);
+    s.property(layer->timeRemap);
+
+    auto transformed = (layer->transform != nullptr);
+    s.value(transformed);
+    if (transformed) {
+        if (Stream::reading) layer->transform = new LottieTransform;
+        _object(s, layer->transform);
+    }
+
+    _masks(s, layer);
+    _effects(s, layer);
+
+    //the solid color is given to the prepared shape
+    RGB32 color = {0, 0, 0};
+    if (layer->type == LottieLayer::Solid) {
+        if (!Stream::reading && layer->statical.pooler.count > 0) {
+            uint8_t r, g, b;
+            layer->statical.pooler.first().paint->fill(&r, &g, &b);
+            color = {r, g, b};
+        }
+        s.value(color);
+    }
+
+    _children(s, layer);
+
+    if (Stream::reading && s.valid()) layer->prepare(&color);
+}
+
+
+template<typename Stream>
+static void _object(Stream& s, LottieObject* obj)
+{
+    s.value(obj->id);
+    s.value(obj->hidden);
+
+    switch (obj->type) {
+        case LottieObject::Layer: {
+            _layer(s, static_cast<LottieLayer*>(obj));
+            break;
+        }
+        case LottieObject::Group: {
+            auto group = static_cast<LottieGroup*>(obj);
+            s.value(group->blendMethod);
+            _children(s, group);
+            if (Stream::reading && s.valid()) group->prepare();
+            break;
+        }
+        case LottieObject::Transform: {
+            _transform(s, static_cast<LottieTransform*>(obj));
+            break;
+        }
+        case LottieObject::SolidFill: {
+            auto fill = static_cast<LottieSolidFill*>(obj);
+            s.property(fill->color);
+            s.property(fill->opacity);
+            s.value(fill->rule);
+            break;
+        }
+        case LottieObject::SolidStroke: {
+            auto stroke = static_cast<LottieSolidStroke*>(obj);
+            s.property(stroke->color);
+            s.property(stroke->opacity);
+            _stroke(s, stroke);
+            break;
+        }
+        case LottieObject::GradientFill: {
+            auto fill = static_cast<LottieGradientFill*>(obj);
+            _gradient(s, fill);
+            s.value(fill->rule);
+            break;
+        }
+        case LottieObject::GradientStroke: {
+            auto stroke = static_cast<LottieGradientStroke*>(obj);
+            _gradient(s, stroke);
+            _stroke(s, stroke);
+            break;
+        }
+        case LottieObject::Rect: {
+            auto rect = static_cast<LottieRect*>(obj);
+            s.value(rect->clockwise);
+            s.property(rect->position);
+            s.property(rect->size);
+            s.property(rect->radius);
+            break;
+        }
+        case LottieObject::Ellipse: {
+            auto ellipse = static_cast<LottieEllipse*>(obj);
+            s.value(ellipse->clockwise);
+            s.property(ellipse->position);
+            s.property(ellipse->size);
+            break;
+        }
+        case LottieObject::Path: {
+            auto path = static_cast<LottiePath*>(obj);
+            s.value(path->clockwise);
+            s.property(path->pathset);
+            break;
+        }
+        case LottieObject::Polystar: {
+            auto star = static_cast<LottiePolyStar*>(obj);
+            s.value(star->clockwise);
+            s.value(star->type);
+            s.property(star->position);
+            s.property(star->innerRadius);
+            s.property(star->outerRadius);
+            s.property(star->innerRoundness);
+            s.property(star->outerRoundness);
+            s.property(star->rotation);
+            s.property(star->ptsCnt);
+            break;
+        }
+        case LottieObject::Trimpath: {
+            auto trim = static_cast<LottieTrimpath*>(obj);
+            s.value(trim->type);
+            s.property(trim->start);
+            s.property(trim->end);
+            s.property(trim->offset);
+            break;
+        }
+        case LottieObject::Repeater: {
+            auto repeater = static_cast<LottieRepeater*>(obj);
+            s.value(repeater->inorder);
+            s.property(repeater->copies);
+            s.property(repeater->offset);
+            s.property(repeater->position);
+            s.property(repeater->rotation);
+            s.property(repeater->scale);
+            s.property(repeater->anchor);
+            s.property(repeater->startOpacity);
+            s.property(repeater->endOpacity);
+            break;
+        }
+        case LottieObject::RoundedCorner: {
+            s.property(static_cast<LottieRoundedCorner*>(obj)->radius);
+            break;
+        }
+        case LottieObject::OffsetPath: {
+            auto offset = static_cast<LottieOffsetPath*>(obj);
+            s.value(offset->join);
+            s.property(offset->offset);
+            s.property(offset->miterLimit);
+            break;
+        }
+        //the images and the texts refer to the external resources
+        default: {
+            s.invalid = true;
+            break;
+        }
+    }
+}
+
+
+template<typename Stream>
+static void _composition(Stream& s, LottieComposition* comp)
+{
+    s.value(comp->w);
+    s.value(comp->h);
+    s.value(comp->frameRate);
+
+    //interpolators, the keyframes refer to them by the indices
+    auto cnt = comp->interpolators.count;
+    s.value(cnt);
+    for (uint32_t i = 0; i < cnt && s.valid(); ++i) {
+        auto interpolator = Stream::reading ? tvg::calloc<LottieInterpolator*>(1, sizeof(LottieInterpolator)) : comp->interpolators[i];
+        if (Stream::reading) comp->interpolators.push(interpolator);
+        s.value(interpolator->inTangent);
+        s.value(interpolator->outTangent);
+        s.value(interpolator->lutCnt);
+        s.array(interpolator->lut, interpolator->lutCnt);
+        if (Stream::reading) interpolator->set(nullptr, interpolator->inTangent, interpolator->outTangent);
+    }
+
+    //markers
+    cnt = comp->markers.count;
+    s.value(cnt);
+    for (uint32_t i = 0; i < cnt && s.valid(); ++i) {
+        auto marker = Stream::reading ? new LottieMarker : comp->markers[i];
+        if (Stream::reading) comp->markers.push(marker);
+        s.string(marker->name);
+        s.value(marker->time);
+        s.value(marker->duration);
+    }
+
+    //layers
+    if (Stream::reading) comp->root = static_cast<LottieLayer*>(_object(LottieObject::Layer));
+    _object(s, comp->root);
+
+    //precomp assets
+    cnt = comp->assets.count;
+    s.value(cnt);
+    for (uint32_t i = 0; i < cnt && s.valid(); ++i) {
+        auto asset = Stream::reading ? _object(LottieObject::Layer) : comp->assets[i];
+        if (Stream::reading) {
+            comp->assets.push(asset);
+            static_cast<LottieLayer*>(asset)->comp = comp->root;
+        } else if (asset->type != LottieObject::Layer) {
+            s.invalid = true;
+            return;
+        }
+        _object(s, asset);
+    }
+}
+
+
+/************************************************************************/
+/* External Class Implementation                                        */
+/************************************************************************/
+
+bool LottieCompiler::compiled(const char* data, uint32_t size)
+{
+    return data && size >= LOTTIE_COMPILER_SIGNATURE_LENGTH && !memcmp(data, LOTTIE_COMPILER_SIGNATURE, LOTTIE_COMPILER_SIGNATURE_LENGTH);
+}
+
+
+const LottieCompiler::Header* LottieCompiler::header(const char* data, uint32_t size)
+{
+    if (!compiled(data, size) || size < sizeof(Header)) return nullptr;
+
+    auto header = reinterpret_cast<const Header*>(data);
+
+    if (header->version != LOTTIE_COMPILER_VERSION || header->layout != _layout()) {
+        TVGLOG("LOTTIE", "The compiled lottie is built for another version, compile it again.");
+        return nullptr;
+    }
+
+    auto sections = reinterpret_cast<const uint8_t*>(data) + header->keyframes;
+    if (header->size > size || header->keyframes < sizeof(Header) || header->keyframes % 8 || header->keyframes > header->data || header->data > header->objects || header->objects > header->size || header->checksum != _checksum(sections, header->size - header->keyframes)) {
+        TVGERR("LOTTIE", "Corrupted compiled lottie!");
+        return nullptr;
+    }
+    return header;
+}
+
+
+bool LottieCompiler::compile(LottieComposition* comp, Array<uint8_t>& out)
+{
+    if (!comp || !comp->root || comp->expressions || comp->slots.count > 0 || comp->fonts.count > 0) return false;
+
+    LottieWriter writer(comp);
+    _composition(writer, comp);
+    if (!writer.valid()) return false;
+
+    Header header;
+    memcpy(header.signature, LOTTIE_COMPILER_SIGNATURE, LOTTIE_COMPILER_SIGNATURE_LENGTH);
+    header.version = LOTTIE_COMPILER_VERSION;
+    header.layout = _layout();
+    header.w = comp->w;
+    header.h = comp->h;
+    header.frameRate = comp->frameRate;
+    header.frameCnt = comp->frameCnt();
+    header.keyframes = _align(sizeof(Header));
+    header.data = _align(header.keyframes + writer.keyframes.count);
+    header.objects = _align(header.data + writer.data.count);
+    header.size = header.objects + writer.objects.count;
+
+    out.reset();
+    out.reserve(header.size);
+    memset(out.data, 0x00, header.size);
+    memcpy(out.data, &header, sizeof(Header));
+    if (writer.keyframes.count > 0) memcpy(out.data + header.keyframes, writer.keyframes.data, writer.keyframes.count);
+    if (writer.data.count > 0) memcpy(out.data + header.data, writer.data.data, writer.data.count);
+    memcpy(out.data + header.objects, writer.objects.data, writer.objects.count);
+    out.count = header.size;
+
+    reinterpret_cast<Header*>(out.data)->checksum = _checksum(out.data + header.keyframes, header.size - header.keyframes);
+
+    return true;
+}
+
+
+LottieComposition* LottieCompiler::load(char* data, uint32_t size)
+{
+    auto header = LottieCompiler::header(data, size);
+    if (!header || uintptr_t(data) % 8) return nullptr;
+
+    auto comp = new LottieComposition;
+
+    LottieReader reader(comp, reinterpret_cast<uint8_t*>(data), header);
+    _composition(reader, comp);
+
+    if (!reader.valid()) {
+        TVGERR("LOTTIE", "Corrupted compiled lottie!");
+        delete(comp);
+        return nullptr;
+    }
+    return comp;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _TVG_LOTTIE_COMPILER_H_
+#define _TVG_LOTTIE_COMPILER_H_
+
+#include "tvgCommon.h"
+#include "tvgArray.h"
+
+struct LottieComposition;
+
+/* The parsed model in a binary form (.tvglot), which is loaded without the json parsing.
+   The keyframes are stored in their memory layout and used in place of the loaded data,
+   so the compiled file is bound to the build which made it. The expressions, slots,
+   texts and images are not compiled. */
+struct LottieCompiler
+{
+    struct Header
+    {
+        char signature[6];      //"TVGLOT"
+        uint16_t version;
+        uint32_t layout;        //the memory layout of the keyframes
+        uint32_t size;          //the whole size
+        float w, h;
+        float frameRate;
+        float frameCnt;
+        uint32_t keyframes;     //offsets of the sections in order: keyframes, data, objects
+        uint32_t data;
+        uint32_t objects;
+        uint32_t checksum;      //of the sections, the model is trusted once it matches
+    };
+
+    //the data starts with the signature, it may be built for another layout though
+    static bool compiled(const char* data, uint32_t size);
+    //the header of the compiled data to be loaded by this build, nullptr otherwise
+    static const Header* header(const char* data, uint32_t size);
+    static bool compile(LottieComposition* comp, Array<uint8_t>& out);
+    //the loaded model refers to the keyframes in the data, which must be writable and outlive the model
+    static LottieComposition* load(char* data, uint32_t size);
+};
+
+#endif //_TVG_LOTTIE_COMPILER_H_
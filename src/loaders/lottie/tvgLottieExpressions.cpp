@@ -21,6 +21,7 @@
  */
 
 
+#include <atomic>
 #include "tvgMath.h"
 #include "tvgCompressor.h"
 #include "tvgLottieModel.h"
@@ -28,6 +29,8 @@
 
 #ifdef THORVG_LOTTIE_EXPRESSIONS_SUPPORT
 
+#include "jerryscript-port.h"
+
 /************************************************************************/
 /* Internal Class Implementation                                        */
 /************************************************************************/
@@ -59,7 +62,15 @@ static const char* EXP_VALUE = "value";
 static const char* EXP_INDEX = "index";
 static const char* EXP_EFFECT= "effect";
 
-static LottieExpressions* exps = nullptr;   //singleton instance engine
+static constexpr uint32_t EXP_HEAP_SIZE = 512 * 1024;      //default heap of an engine
+static constexpr uint32_t EXP_HEAP_SIZE_MIN = 64 * 1024;   //room for the builtins and the light expressions
+
+/* Every animation runs its own engine context. The context is bound to the calling thread
+   before any engine call, so that the animations could be updated on the worker threads. */
+static thread_local jerry_context_t* _context = nullptr;
+static thread_local LottieExpressions* _bound = nullptr;   //the engine of the layer bin on this thread
+static thread_local uint32_t _alloc = 0;   //the heap size of the context in allocation
+static std::atomic<uint32_t> _heap{EXP_HEAP_SIZE};
 
 
 static ExpContent* _expcontent(LottieExpression* exp, float frameNo, void* obj, size_t refCnt = 1)
@@ -147,7 +158,6 @@ static void contentFree(void *native_p, struct jerry_object_native_info_t *info_
 }
 
 static jerry_object_native_info_t freeCb {contentFree, 0, 0};
-static uint32_t engineRefCnt = 0;  //Expressions Engine reference count
 
 
 static char* _name(jerry_value_t args)
@@ -1262,6 +1272,104 @@ static void _buildMath(jerry_value_t context)
 }
 
 
+//the identifiers that never depend on the frame: the language, the pure math and the property value
+static const char* _invariants[] = {
+    "var", "let", "const", "if", "else", "return", "true", "false", "null", "undefined", "typeof", "new", "Array",
+    "Math", "value", "$bm_rt", "$bm_mul", "$bm_sum", "$bm_add", "$bm_sub", "$bm_div", "mul", "sum", "add", "sub", "div",
+    "clamp", "dot", "cross", "normalize", "length", "degreesToRadians", "radiansToDegrees", "linear", "ease", "easeIn", "easeOut"
+};
+
+//the members that may resolve to the frame or to a non-deterministic value
+static const char* _variants[] = {"random", "valueAtTime", "velocity", "velocityAtTime", "speed", "speedAtTime", "wiggle", "temporalWiggle", "loopIn", "loopOut", "loopInDuration", "loopOutDuration", "key", "nearestKey", "numKeys"};
+
+
+static bool _identifier(char c)
+{
+    return isalnum(c) || c == '_' || c == '$';
+}
+
+
+static bool _match(const char* names[], size_t cnt, const char* id, size_t len)
+{
+    for (size_t i = 0; i < cnt; ++i) {
+        if (strlen(names[i]) == len && !strncmp(names[i], id, len)) return true;
+    }
+    return false;
+}
+
+
+//scan the identifiers in the code, the declared variables are collected at the first pass and accepted at the second pass
+static bool _scan(const char* code, Array<const char*>& locals, Array<size_t>& lens, bool declare)
+{
+    auto p = code;
+    auto member = false;
+    auto declaring = false;
+
+    while (*p) {
+        //comments
+        if (p[0] == '/' && p[1] == '/') {
+            while (*p && *p != '\n') ++p;
+            continue;
+        }
+        if (p[0] == '/' && p[1] == '*') {
+            p += 2;
+            while (*p && !(p[0] == '*' && p[1] == '/')) ++p;
+            if (*p) p += 2;
+            continue;
+        }
+        //strings, the template literals may embed any code
+        if (*p == '`') return false;
+        if (*p == '\'' || *p == '"') {
+            auto quote = *p++;
+            while (*p && *p != quote) {
+                if (*p == '\\' && p[1]) ++p;
+                ++p;
+            }
+            if (*p) ++p;
+            member = false;
+            continue;
+        }
+        //numbers with their exponent and suffix characters
+        if (isdigit(*p)) {
+            while (_identifier(*p) || *p == '.') ++p;
+            member = false;
+            continue;
+        }
+        if (_identifier(*p)) {
+            auto id = p;
+            while (_identifier(*p)) ++p;
+            auto len = size_t(p - id);
+            if (declare) {
+                if (declaring) {
+                    locals.push(id);
+                    lens.push(len);
+                }
+                declaring = (len == 3 && (!strncmp(id, "var", 3) || !strncmp(id, "let", 3))) || (len == 5 && !strncmp(id, "const", 5));
+            } else if (member) {
+                if (_match(_variants, sizeof(_variants) / sizeof(_variants[0]), id, len)) return false;
+            } else if (!_match(_invariants, sizeof(_invariants) / sizeof(_invariants[0]), id, len)) {
+                auto found = false;
+                for (uint32_t i = 0; i < locals.count; ++i) {
+                    if (lens[i] == len && !strncmp(locals[i], id, len)) {
+                        found = true;
+                        break;
+                    }
+                }
+                if (!found) return false;
+            }
+            member = false;
+            continue;
+        }
+        if (!isspace(*p)) {
+            member = (*p == '.');
+            declaring = false;
+        }
+        ++p;
+    }
+    return true;
+}
+
+
 void LottieExpressions::buildGlobal(float frameNo, LottieExpression* exp)
 {
     tvg::free(static_cast<ExpContent*>(jerry_object_get_native_ptr(comp, &freeCb)));
@@ -1381,6 +1489,25 @@ jerry_value_t LottieExpressions::evaluate(float frameNo, LottieExpression* exp)
 {
     if (exp->disabled && exp->writables.empty()) return jerry_undefined();
 
+    //the layer bins are evaluated with their own engines
+    if (_bound && _bound != this) return _bound->evaluate(frameNo, exp);
+
+    //the layer moved to another bin, its bytecode belongs to the previous engine
+    if (exp->bytecode && exp->engine != this) discard(exp);
+
+    _context = context;
+
+    //compile the code once, the bytecode is reused for the following frames
+    if (!exp->bytecode) {
+        exp->engine = this;
+        exp->bytecode = jerry_eval_compile((jerry_char_t *) exp->code, strlen(exp->code), JERRY_PARSE_NO_OPTS);
+        if (!exp->bytecode) {
+            TVGERR("LOTTIE", "Failed to compile the expressions!");
+            exp->disabled = true;
+            return jerry_undefined();
+        }
+    }
+
     buildGlobal(frameNo, exp);
 
     //main composition
@@ -1407,7 +1534,7 @@ jerry_value_t LottieExpressions::evaluate(float frameNo, LottieExpression* exp)
     buildWritables(exp);
 
     //evaluate the code
-    auto eval = jerry_eval((jerry_char_t *) exp->code, strlen(exp->code), JERRY_PARSE_NO_OPTS);
+    auto eval = jerry_eval_run(exp->bytecode);
 
     if (jerry_value_is_exception(eval)) {
         TVGERR("LOTTIE", "Failed to dispatch the expressions!");
@@ -1425,8 +1552,33 @@ jerry_value_t LottieExpressions::evaluate(float frameNo, LottieExpression* exp)
 /* External Class Implementation                                        */
 /************************************************************************/
 
+//jerryscript port, the engine context with its heap
+size_t jerry_port_context_alloc(size_t size)
+{
+    size += _alloc;
+    _context = tvg::malloc<jerry_context_t*>(size);
+    return size;
+}
+
+
+jerry_context_t* jerry_port_context_get()
+{
+    return _context;
+}
+
+
+void jerry_port_context_free()
+{
+    tvg::free(_context);
+    _context = nullptr;
+}
+
+
 LottieExpressions::~LottieExpressions()
 {
+    ARRAY_FOREACH(p, bins) delete(*p);
+
+    _context = context;
     jerry_value_free(thisProperty);
     jerry_value_free(thisLayer);
     jerry_value_free(thisComp);
@@ -1438,43 +1590,99 @@ LottieExpressions::~LottieExpressions()
 
 LottieExpressions::LottieExpressions()
 {
+    _alloc = _heap;
     jerry_init(JERRY_INIT_EMPTY);
+    context = _context;
     _buildMath(buildGlobal());
 }
 
 
 void LottieExpressions::update(float curTime)
 {
+    ARRAY_FOREACH(p, bins) (*p)->update(curTime);
+
+    _context = context;
+    time = curTime;
+
     //time, #current time in seconds
     auto time = jerry_number(curTime);
     jerry_object_set_sz(global, EXP_TIME, time);
     jerry_value_free(time);
-}
 
+    //the collections get frequent as the heap fills up, which spikes the frame time
+    jerry_heap_stats_t stats;
+    jerry_heap_stats(&stats);
+    if (!warned && stats.allocated_bytes > stats.size / 4 * 3) {
+        TVGLOG("LOTTIE", "Expressions heap is running out (%zu / %zu bytes), see LottieAnimation::expressions()", stats.allocated_bytes, stats.size);
+        warned = true;
+    }
+}
 
-//FIXME: Threads support
-#include "tvgTaskScheduler.h"
 
-LottieExpressions* LottieExpressions::instance()
+void LottieExpressions::prepare(uint32_t bins)
 {
-    //FIXME: Threads support
-    if (TaskScheduler::threads() > 1) {
-        TVGLOG("LOTTIE", "Lottie Expressions are not supported with tvg threads");
-        return nullptr;
+    //the current thread takes the first bin with this engine
+    while (this->bins.count < bins - 1) {
+        auto engine = new LottieExpressions;
+        engine->update(time);
+        this->bins.push(engine);
     }
+}
+
 
-    if (!exps) exps = new LottieExpressions;
-    ++engineRefCnt;
-    return exps;
+void LottieExpressions::bind(uint32_t bin)
+{
+    _bound = (bin > 0) ? bins[bin - 1] : nullptr;
+}
+
+
+LottieExpressions* LottieExpressions::gen()
+{
+    return new LottieExpressions;
+}
+
+
+void LottieExpressions::heap(uint32_t size)
+{
+    _heap = (size == 0) ? EXP_HEAP_SIZE : std::max(size, EXP_HEAP_SIZE_MIN);
 }
 
 
 void LottieExpressions::retrieve(LottieExpressions* instance)
 {
-    if (--engineRefCnt == 0) {
-        delete(instance);
-        exps = nullptr;
+    delete(instance);
+}
+
+
+bool LottieExpressions::constant(const char* code)
+{
+    Array<const char*> locals;
+    Array<size_t> lens;
+    _scan(code, locals, lens, true);
+    return _scan(code, locals, lens, false);
+}
+
+
+//the references to the other layers, evaluated with the states of any layers
+static const char* _crossings[] = {"comp", "layer", "parent", "toComp", "fromComp", "toWorld", "fromWorld"};
+
+bool LottieExpressions::isolated(const char* code)
+{
+    for (size_t i = 0; i < sizeof(_crossings) / sizeof(_crossings[0]); ++i) {
+        if (strstr(code, _crossings[i])) return false;
+    }
+    return true;
+}
+
+
+void LottieExpressions::discard(LottieExpression* exp)
+{
+    //the bytecode belongs to the heap of its engine
+    if (exp->bytecode) {
+        _context = exp->engine->context;
+        jerry_eval_free(exp->bytecode);
     }
+    exp->bytecode = nullptr;
 }
 
 
@@ -126,10 +126,17 @@ public:
     }
 
     void update(float curTime);
+    void prepare(uint32_t bins);   //the engines of the layer bins updated concurrently
+    void bind(uint32_t bin);       //the calling thread evaluates with the engine of the bin
 
-    //singleton (no thread safety)
-    static LottieExpressions* instance();
+    //an engine per animation
+    static LottieExpressions* gen();
+    static void heap(uint32_t size);   //the heap of the engines prepared from now on, 0 for the default
     static void retrieve(LottieExpressions* instance);
+    static void discard(LottieExpression* exp);
+    static bool constant(const char* code);
+    static bool isolated(const char* code);
+    static bool supported() { return true; }
 
 private:
     LottieExpressions();
@@ -152,6 +159,11 @@ private:
     jerry_value_t thisComp;
     jerry_value_t thisLayer;
     jerry_value_t thisProperty;
+
+    jerry_context_t* context;   //the engine state with its heap, isolated from the other animations
+    Array<LottieExpressions*> bins;   //the engines of the other layer bins, see prepare()
+    float time = 0.0f;          //the current time in seconds
+    bool warned = false;        //the heap shortage is reported once
 };
 
 #else
@@ -165,8 +177,15 @@ struct LottieExpressions
     template<typename Property> bool result(TVG_UNUSED float, TVG_UNUSED RenderPath&, TVG_UNUSED Matrix*, TVG_UNUSED LottieModifier*, TVG_UNUSED LottieExpression*) { return false; }
     bool result(TVG_UNUSED float, TVG_UNUSED TextDocument& doc, TVG_UNUSED LottieExpression*) { return false; }
     void update(TVG_UNUSED float) {}
-    static LottieExpressions* instance() { return nullptr; }
+    void prepare(TVG_UNUSED uint32_t bins) {}
+    void bind(TVG_UNUSED uint32_t bin) {}
+    static LottieExpressions* gen() { return nullptr; }
+    static void heap(TVG_UNUSED uint32_t size) {}
     static void retrieve(TVG_UNUSED LottieExpressions* instance) {}
+    static void discard(TVG_UNUSED LottieExpression* exp) {}
+    static bool constant(TVG_UNUSED const char* code) { return false; }
+    static bool isolated(TVG_UNUSED const char* code) { return true; }
+    static bool supported() { return false; }
 };
 
 #endif //THORVG_LOTTIE_EXPRESSIONS_SUPPORT
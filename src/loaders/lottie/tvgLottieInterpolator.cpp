@@ -37,6 +37,9 @@
 #define NEWTON_ITERATIONS 4
 #define SUBDIVISION_PRECISION 0.0000001f
 #define SUBDIVISION_MAX_ITERATIONS 10
+#define LUT_FRAME_SAMPLES 4
+#define LUT_MIN_SAMPLES 64
+#define LUT_MAX_SAMPLES 1024
 
 
 static inline float _constA(float aA1, float aA2) { return 1.0f - 3.0f * aA2 + 3.0f * aA1; }
@@ -120,10 +123,44 @@ float LottieInterpolator::NewtonRaphsonIterate(float aX, float aGuessT)
 float LottieInterpolator::progress(float t)
 {
     if (outTangent.x == outTangent.y && inTangent.x == inTangent.y) return t;
+
+    if (lut && !exact) {
+        t = tvg::clamp(t, 0.0f, 1.0f);
+        auto x = t * float(lutCnt - 1);
+        auto i = uint32_t(x);
+        if (i >= lutCnt - 1) return _calcBezier(lut[lutCnt - 1], outTangent.y, inTangent.y);
+        //a single newton step on the interpolated guess is enough
+        auto guessForT = lut[i] + (lut[i + 1] - lut[i]) * (x - float(i));
+        auto slope = _getSlope(guessForT, outTangent.x, inTangent.x);
+        if (slope >= NEWTON_MIN_SLOPE) guessForT -= (_calcBezier(guessForT, outTangent.x, inTangent.x) - t) / slope;
+        return _calcBezier(guessForT, outTangent.y, inTangent.y);
+    }
+
     return _calcBezier(getTForX(t), outTangent.y, inTangent.y);
 }
 
 
+//sample the curve parameters by the keyframe duration (in frames) so that the playback skips solving the curve
+void LottieInterpolator::sample(float duration)
+{
+    if (outTangent.x == outTangent.y && inTangent.x == inTangent.y) return;
+    if (duration <= 0.0f) return;
+
+    auto cnt = uint32_t(ceilf(tvg::clamp(duration * LUT_FRAME_SAMPLES, float(LUT_MIN_SAMPLES), float(LUT_MAX_SAMPLES)))) + 1;
+
+    //shared with the longer keyframes already
+    if (lut && lutCnt >= cnt) return;
+
+    lut = tvg::realloc<float*>(lut, sizeof(float) * cnt);
+    lutCnt = cnt;
+
+    for (uint32_t i = 0; i < cnt; ++i) {
+        auto x = float(i) / float(cnt - 1);
+        lut[i] = getTForX(x);
+    }
+}
+
+
 void LottieInterpolator::set(const char* key, Point& inTangent, Point& outTangent)
 {
     if (key) this->key = duplicate(key);
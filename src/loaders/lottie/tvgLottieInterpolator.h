@@ -29,9 +29,13 @@ struct LottieInterpolator
 {
     char* key;
     Point outTangent, inTangent;
+    float* lut;         //sampled curve parameters, optional
+    uint32_t lutCnt;
+    bool exact;         //bypass the lut
 
     float progress(float t);
     void set(const char* key, Point& inTangent, Point& outTangent);
+    void sample(float duration);
 
 private:
     static constexpr float SAMPLE_STEP_SIZE = 1.0f / float(SPLINE_TABLE_SIZE - 1);
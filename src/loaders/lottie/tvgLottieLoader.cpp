@@ -21,49 +21,338 @@
  */
 
 #include "tvgStr.h"
- #include "tvgLottieLoader.h"
+#include "tvgShape.h"
+#include "tvgTrace.h"
+#include "tvgLottieLoader.h"
 #include "tvgLottieModel.h"
 #include "tvgLottieParser.h"
+#include "tvgLottieCompiler.h"
 #include "tvgLottieBuilder.h"
 
 /************************************************************************/
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
-void LottieLoader::run(unsigned tid)
+//the parsed model of a lottie file shared by its instances
+struct LottieShared
+{
+    INLIST_ITEM(LottieShared);
+
+    char* path;
+    const char* content;                //lottie file data, alive until the deferred precomps are parsed
+    uint32_t size;
+    FileMap file;                       //the file data, if it's not a copy
+    LottieComposition* comp;
+    float w, h, frameCnt, frameRate;    //animation info for the joining instances
+    uint32_t refCnt = 1;
+    bool parsed = false;                //the first built instance has parsed the model
+    Key key;                            //the instances build their scenes over the model in turn
+};
+
+static Inlist<LottieShared> _shares;
+static Key _key;
+
+
+static void _free(const char* content, FileMap& file)
+{
+    if (file.data) file.close();
+    else tvg::free((char*)content);
+}
+
+
+//the slots and the expressions modify the model per instance
+static bool _sharable(const char* content)
+{
+    if (strstr(content, "\"sid\"")) return false;
+
+    //an expression is a string of the "x" key, the others are the easing handles
+    auto p = content;
+    while ((p = strstr(p, "\"x\""))) {
+        p += 3;
+        while (isspace(*p)) ++p;
+        if (*p != ':') continue;
+        ++p;
+        while (isspace(*p)) ++p;
+        if (*p == '"') return false;
+    }
+    return true;
+}
+
+//rough memory footprint of the paint tree
+static uint32_t _footprint(const Paint* paint)
+{
+    auto pimpl = PAINT(paint);
+    uint32_t size = 256;  //paint instance
+
+    if (paint->type() == tvg::Type::Shape) {
+        auto& path = CONST_SHAPE(paint)->rs.path;
+        size += path.pts.count * sizeof(Point) + path.cmds.count * sizeof(PathCommand);
+    }
+    if (pimpl->clipper) size += _footprint(pimpl->clipper);
+    if (pimpl->maskData) size += _footprint(pimpl->maskData->target);
+
+    if (auto it = pimpl->iterator()) {
+        while (auto child = it->next()) size += _footprint(child);
+        delete(it);
+    }
+    return size;
+}
+
+
+//release the render data of the hidden paints, they would be prepared again anyway
+static void _reclaim(Paint* paint)
+{
+    auto pimpl = PAINT(paint);
+    if (pimpl->renderer && pimpl->rd) {
+        pimpl->renderer->dispose(pimpl->rd);
+        pimpl->rd = nullptr;
+    }
+    if (pimpl->clipper) _reclaim(pimpl->clipper);
+    if (pimpl->maskData) _reclaim(pimpl->maskData->target);
+
+    if (auto it = pimpl->iterator()) {
+        while (auto child = it->next()) _reclaim(const_cast<Paint*>(child));
+        delete(it);
+    }
+}
+
+
+//retain the current frame for the next visits
+void LottieLoader::record()
+{
+    if (budget == 0 || usage >= budget) return;
+
+    auto frame = new LottieFrame;
+    frame->no = frameNo;
+    frame->size = 0;
+
+    for (auto paint : builder->scene->paints()) {
+        auto dup = paint->duplicate();
+        dup->ref();
+        frame->paints.push(dup);
+        frame->size += _footprint(dup);
+    }
+
+    frames.push(frame);
+    usage += frame->size;
+}
+
+
+//restore the retained frame instead of building it again
+bool LottieLoader::replay(float no)
+{
+    if (!comp) return false;
+
+    if (shown) {
+        ARRAY_FOREACH(paint, shown->paints) _reclaim(*paint);
+        shown = nullptr;
+    }
+
+    if (builder->tweening()) return false;
+
+    ARRAY_FOREACH(p, frames) {
+        if (fabsf((*p)->no - no) > 0.0009f) continue;
+        //the retained layers are recorded as well
+        builder->clear();
+        ARRAY_FOREACH(paint, (*p)->paints) {
+            auto recorded = *paint;
+            PAINT(recorded)->mark(RenderUpdateFlag::All);
+            builder->scene->push(recorded);
+        }
+        shown = *p;
+        return true;
+    }
+    return false;
+}
+
+
+void LottieLoader::discard()
+{
+    ARRAY_FOREACH(p, frames) {
+        ARRAY_FOREACH(paint, (*p)->paints) (*paint)->unref();
+        delete(*p);
+    }
+    frames.clear();
+    usage = 0;
+    shown = nullptr;
+}
+
+
+bool LottieLoader::parse()
+{
+    //the model is parsed once by the first built instance
+    if (shared && shared->parsed) {
+        ScopedLock lock(key);
+        comp = shared->comp;
+        return comp ? true : false;
+    }
+
+    auto data = shared ? shared->content : content;
+    auto size = shared ? shared->size : this->size;
+
+    //the compiled model is loaded without the parsing
+    if (LottieCompiler::compiled(data, size)) {
+        auto comp = LottieCompiler::load(const_cast<char*>(data), size);
+        if (shared) {
+            shared->comp = comp;
+            shared->parsed = true;
+        }
+        ScopedLock lock(key);
+        this->comp = comp;
+        return comp ? true : false;
+    }
+
+    LottieParser parser(data, dirName, builder->expressions());
+    parser.deferrable = copy || shared;
+    auto ret = parser.parse();
+    if (shared) {
+        shared->comp = ret ? parser.comp : nullptr;
+        shared->parsed = true;
+    }
+    if (!ret) return false;
+    {
+        ScopedLock lock(key);
+        comp = parser.comp;
+    }
+    if (parser.slots) {
+        override(parser.slots, true);
+        parser.slots = nullptr;
+    }
+    return true;
+}
+
+
+void LottieLoader::build()
 {
     //update frame
     if (comp) {
+        TVG_TRACE("LottieLoader::update");
+        auto tweening = builder->tweening();
+        if (rebuild) builder->invalidate(comp);
         builder->update(comp, frameNo);
+        if (!tweening && !rebuild) record();
     //initial loading
     } else {
-        LottieParser parser(content, dirName, builder->expressions());
-        if (!parser.parse()) return;
         {
-            ScopedLock lock(key);
-            comp = parser.comp;
-        }
-        if (parser.slots) {
-            override(parser.slots, true);
-            parser.slots = nullptr;
+            TVG_TRACE("LottieLoader::parse");
+            if (!parse()) return;
         }
+        TVG_TRACE("LottieLoader::build");
         builder->build(comp);
-
-        release();
     }
+    //all the deferred precomps are parsed
+    if (!builder->deferring()) release();
     rebuild = false;
 }
 
 
+void LottieLoader::run(unsigned tid)
+{
+    TVG_TRACE("LottieLoader::run");
+    MemoryScope scope(MemoryCategory::Loader);
+
+    if (shared) {
+        ScopedLock lock(shared->key);
+        build();
+    } else build();
+}
+
+
+//clear synchronously
+void LottieLoader::clear()
+{
+    if (!comp) return;
+
+    //the pooled paints are released while the other instances may build the model
+    if (shared) {
+        ScopedLock lock(shared->key);
+        builder->clear(comp);
+    } else builder->clear(comp);
+}
+
+
 void LottieLoader::release()
 {
-    if (copy) {
-        tvg::free((char*)content);
+    //the shared model is fully parsed once any of its instances parsed all the deferred precomps
+    if (shared) {
+        if (LottieCompiler::compiled(shared->content, shared->size)) return;
+        if (shared->content) _free(shared->content, shared->file);
+        shared->content = nullptr;
+        return;
+    }
+    //the compiled model refers to its data until it's deleted
+    if (copy && !LottieCompiler::compiled(content, size)) {
+        _free(content, file);
         content = nullptr;
     }
 }
 
 
+//join the instances of the same file, which share the parsed model
+bool LottieLoader::share(const char* path)
+{
+    ScopedLock lock(_key);
+
+    INLIST_FOREACH(_shares, p) {
+        if (strcmp(p->path, path)) continue;
+        ++p->refCnt;
+        shared = p;
+        builder->shared = true;
+        dirName = tvg::dirname(path);
+        w = p->w;
+        h = p->h;
+        segmentEnd = frameCnt = p->frameCnt;
+        frameRate = p->frameRate;
+        return true;
+    }
+    return false;
+}
+
+
+//hand over the file data and the model (if parsed already) to the next instances
+void LottieLoader::publish(const char* path)
+{
+    auto p = new LottieShared;
+    p->path = duplicate(path);
+    p->content = content;
+    p->size = size;
+    p->file = file;
+    p->comp = comp;
+    p->parsed = (comp != nullptr);
+    p->w = w;
+    p->h = h;
+    p->frameCnt = frameCnt;
+    p->frameRate = frameRate;
+
+    content = nullptr;
+    file = {};
+    copy = false;
+    shared = p;
+    builder->shared = true;
+
+    //the first frame could be built already, the model doesn't retain the paints of an instance
+    if (comp) builder->invalidate(comp, false);
+
+    ScopedLock lock(_key);
+    _shares.back(p);
+}
+
+
+//the last instance frees the shared model
+void LottieLoader::unshare()
+{
+    ScopedLock lock(_key);
+
+    if (--shared->refCnt > 0) return;
+
+    _shares.remove(shared);
+    delete(shared->comp);
+    if (shared->content) _free(shared->content, shared->file);
+    tvg::free(shared->path);
+    delete(shared);
+}
+
+
 /************************************************************************/
 /* External Class Implementation                                        */
 /************************************************************************/
@@ -78,41 +367,68 @@ LottieLoader::~LottieLoader()
 {
     done();
 
-    release();
+    discard();
 
-    //TODO: correct position?
-    delete(comp);
-    delete(builder);
+    if (shared) {
+        //the pooled paints of this instance are bound to its renderer
+        {
+            ScopedLock lock(shared->key);
+            if (comp) builder->retrieve(comp);
+            delete(builder);
+        }
+        unshare();
+    } else {
+        release();
+        //TODO: correct position?
+        delete(comp);
+        delete(builder);
+        if (copy && content) _free(content, file);
+    }
 
     tvg::free(dirName);
 }
 
 
-bool LottieLoader::header()
+//the value of a header key, which must be terminated within the received data
+static const char* _value(const char* p, const char* end, float& out)
 {
-    //A single thread doesn't need to perform intensive tasks.
-    if (TaskScheduler::threads() == 0) {
-        LoadModule::read();
-        run(0);
-        if (comp) {
-            w = static_cast<float>(comp->w);
-            h = static_cast<float>(comp->h);
-            segmentEnd = frameCnt = comp->frameCnt();
-            frameRate = comp->frameRate;
-            return true;
-        } else {
-            return false;
-        }
+    auto e = p;
+    while (e < end && *e != ',' && *e != '}') ++e;
+    if (e == end) return nullptr;
+    out = toFloat(p, nullptr);
+    return e;
+}
+
+
+/* Quickly validate the given Lottie data without parsing in order to get the animation info.
+   The partial data of a stream is accepted once all the header keys have arrived. */
+bool LottieLoader::probe(bool whole)
+{
+    enum : uint8_t {FrameRate = 1, Start = 2, End = 4, Width = 8, Height = 16, All = 31};
+
+    //the compiled data has the info in its header
+    if (LottieCompiler::compiled(content, size)) {
+        if (!whole) return false;
+        auto header = LottieCompiler::header(content, size);
+        if (!header || header->frameRate < FLOAT_EPSILON) return false;
+        this->frameRate = header->frameRate;
+        this->w = header->w;
+        this->h = header->h;
+        segmentEnd = frameCnt = header->frameCnt;
+        return true;
     }
 
-    //Quickly validate the given Lottie file without parsing in order to get the animation info.
     auto startFrame = 0.0f;
     auto endFrame = 0.0f;
+    auto frameRate = 0.0f;
+    auto w = 0.0f, h = 0.0f;
+    uint8_t found = 0;
     uint32_t depth = 0;
 
     auto p = content;
+    auto end = content + size;
 
-    while (*p != '\0') {
+    while (p && p < end) {
         if (*p == '{') {
             ++depth;
             ++p;
@@ -132,63 +448,46 @@ bool LottieLoader::header()
             p += 4;
             continue;
         }
-
         //framerate
         if (!strncmp(p, "\"fr\":", 5)) {
-            p += 5;
-            auto e = strstr(p, ",");
-            if (!e) e = strstr(p, "}");
-            frameRate = toFloat(p, nullptr);
-            p = e;
+            p = _value(p + 5, end, frameRate);
+            found |= FrameRate;
             continue;
         }
-
         //start frame
         if (!strncmp(p, "\"ip\":", 5)) {
-            p += 5;
-            auto e = strstr(p, ",");
-            if (!e) e = strstr(p, "}");
-            startFrame = toFloat(p, nullptr);
-            p = e;
+            p = _value(p + 5, end, startFrame);
+            found |= Start;
             continue;
         }
-
         //end frame
         if (!strncmp(p, "\"op\":", 5)) {
-            p += 5;
-            auto e = strstr(p, ",");
-            if (!e) e = strstr(p, "}");
-            endFrame = toFloat(p, nullptr);
-            p = e;
+            p = _value(p + 5, end, endFrame);
+            found |= End;
             continue;
         }
-
         //width
         if (!strncmp(p, "\"w\":", 4)) {
-            p += 4;
-            auto e = strstr(p, ",");
-            if (!e) e = strstr(p, "}");
-            w = toFloat(p, nullptr);
-            p = e;
+            p = _value(p + 4, end, w);
+            found |= Width;
             continue;
         }
         //height
         if (!strncmp(p, "\"h\":", 4)) {
-            p += 4;
-            auto e = strstr(p, ",");
-            if (!e) e = strstr(p, "}");
-            h = toFloat(p, nullptr);
-            p = e;
+            p = _value(p + 4, end, h);
+            found |= Height;
             continue;
         }
         ++p;
     }
 
-    if (frameRate < FLOAT_EPSILON) {
-        TVGLOG("LOTTIE", "Not a Lottie file? Frame rate is 0!");
-        return false;
-    }
+    //a value is cut at the end of the received data
+    if (!whole && (!p || found != All)) return false;
+    if (frameRate < FLOAT_EPSILON) return false;
 
+    this->frameRate = frameRate;
+    this->w = w;
+    this->h = h;
     segmentEnd = frameCnt = (endFrame - startFrame);
 
     TVGLOG("LOTTIE", "info: frame rate = %f, duration = %f size = %f x %f", frameRate, frameCnt / frameRate, w, h);
@@ -197,8 +496,36 @@ bool LottieLoader::header()
 }
 
 
+bool LottieLoader::header()
+{
+    //A single thread doesn't need to perform intensive tasks.
+    if (TaskScheduler::threads() == 0) {
+        LoadModule::read();
+        run(0);
+        if (comp) {
+            w = static_cast<float>(comp->w);
+            h = static_cast<float>(comp->h);
+            segmentEnd = frameCnt = comp->frameCnt();
+            frameRate = comp->frameRate;
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    if (!probe(true)) {
+        TVGLOG("LOTTIE", "Not a Lottie file? Frame rate is 0!");
+        return false;
+    }
+    return true;
+}
+
+
 bool LottieLoader::open(const char* data, uint32_t size, const char* rpath, bool copy)
 {
+    //the compiled data is relocated in place
+    if (LottieCompiler::compiled(data, size)) copy = true;
+
     if (copy) {
         content = tvg::malloc<char*>(size + 1);
         if (!content) return false;
@@ -219,35 +546,62 @@ bool LottieLoader::open(const char* data, uint32_t size, const char* rpath, bool
 bool LottieLoader::open(const char* path)
 {
 #ifdef THORVG_FILE_IO_SUPPORT
-    auto f = fopen(path, "r");
-    if (!f) return false;
-
-    fseek(f, 0, SEEK_END);
-
-    size = ftell(f);
-    if (size == 0) {
-        fclose(f);
-        return false;
-    }
+    if (share(path)) return true;
 
-    auto content = tvg::malloc<char*>(sizeof(char) * size + 1);
-    fseek(f, 0, SEEK_SET);
-    size = fread(content, sizeof(char), size, f);
-    content[size] = '\0';
+    //the in-situ parsing writes its own copies of the touched pages only
+    if (!file.open(path, FileMap::Writable | FileMap::Terminated)) return false;
 
-    fclose(f);
+    content = (char*)file.data;
+    size = file.size;
 
     this->dirName = tvg::dirname(path);
-    this->content = content;
     this->copy = true;
 
-    return header();
+    //the raw data must be examined before its in-situ parsing
+    auto sharable = LottieCompiler::compiled(content, size) || _sharable(content);
+
+    if (!header()) return false;
+
+    if (sharable) publish(path);
+
+    return true;
 #else
     return false;
 #endif
 }
 
 
+bool LottieLoader::stream(const char* rpath)
+{
+    streaming = true;
+    copy = true;
+    dirName = duplicate(rpath ? rpath : ".");
+    return true;
+}
+
+
+//append a chunk of the streamed data, the whole data is validated with the last one
+bool LottieLoader::feed(const char* data, uint32_t size, bool last)
+{
+    if (!streaming) return false;
+
+    auto content = tvg::realloc<char*>((char*)this->content, this->size + size + 1);
+    if (!content) return false;
+    memcpy(content + this->size, data, size);
+    this->size += size;
+    content[this->size] = '\0';
+    this->content = content;
+
+    if (!last) {
+        if (frameRate < FLOAT_EPSILON) probe(false);
+        return true;
+    }
+
+    streaming = false;
+    return header();
+}
+
+
 bool LottieLoader::resize(Paint* paint, float w, float h)
 {
     if (!paint) return false;
@@ -267,12 +621,15 @@ bool LottieLoader::resize(Paint* paint, float w, float h)
 
 bool LottieLoader::read()
 {
+    //parse it once the stream is completed
+    if (streaming) return true;
+
     //the loading has been already completed
     if (!LoadModule::read()) return true;
 
-    if (!content || size == 0) return false;
+    if (!shared && (!content || size == 0)) return false;
 
-    TaskScheduler::request(this);
+    request(this);
 
     return true;
 }
@@ -283,8 +640,8 @@ Paint* LottieLoader::paint()
     done();
 
     if (!comp) return nullptr;
-    comp->initiated = true;
-    return comp->root->scene;
+    builder->initiated = true;
+    return builder->scene;
 }
 
 
@@ -304,29 +661,111 @@ bool LottieLoader::override(const char* slots, bool byDefault)
         auto idx = 0;
         auto succeed = false;
         while (auto sid = parser.sid(idx == 0)) {
-            auto applied = false;
-            ARRAY_FOREACH(p, comp->slots) {
-                if (strcmp((*p)->sid, sid)) continue;
-                if (parser.apply(*p, byDefault)) succeed = applied = true;
-                break;
-            }
-            if (!applied) parser.skip();
+            auto slot = comp->slotById(sid);
+            if (slot && parser.apply(slot, byDefault)) {
+                comp->invalidate(slot);
+                succeed = true;
+            } else parser.skip();
             ++idx;
         }
         tvg::free((char*)temp);
         rebuild = succeed;
         overridden |= succeed;
+        if (succeed) discard();
         return rebuild;
     //reset slots
     } else if (overridden) {
-        ARRAY_FOREACH(p, comp->slots) (*p)->reset();
+        ARRAY_FOREACH(p, comp->slots) {
+            if (!(*p)->overridden) continue;
+            (*p)->reset();
+            comp->invalidate(*p);
+        }
         overridden = false;
         rebuild = true;
+        discard();
     }
     return true;
 }
 
 
+LottieSlot* LottieLoader::slot(const char* sid)
+{
+    if (!ready()) return nullptr;
+    return comp->slotById(sid);
+}
+
+
+//apply the value of the target object to the slot without any json parsing
+void LottieLoader::override(LottieSlot* slot, LottieObject* target)
+{
+    slot->assign(target, false);
+    comp->invalidate(slot);
+    overridden = true;
+    rebuild = true;
+    discard();
+}
+
+
+bool LottieLoader::override(const char* sid, float val)
+{
+    auto slot = this->slot(sid);
+    if (!slot) return false;
+
+    if (slot->type == LottieProperty::Type::Float) {
+        LottieTransform target;
+        target.rotation.value = val;
+        override(slot, &target);
+    } else if (slot->type == LottieProperty::Type::Opacity) {
+        LottieSolid target;
+        target.opacity.value = (uint8_t)(tvg::clamp(val, 0.0f, 100.0f) * 2.55f);
+        override(slot, &target);
+    } else return false;
+    return true;
+}
+
+
+bool LottieLoader::override(const char* sid, const Point& val)
+{
+    auto slot = this->slot(sid);
+    if (!slot) return false;
+
+    LottieTransform target;
+    if (slot->type == LottieProperty::Type::Scalar) target.scale.value = val;
+    else if (slot->type == LottieProperty::Type::Vector) target.position.value = val;
+    else return false;
+    override(slot, &target);
+    return true;
+}
+
+
+bool LottieLoader::override(const char* sid, uint8_t r, uint8_t g, uint8_t b)
+{
+    auto slot = this->slot(sid);
+    if (!slot || slot->type != LottieProperty::Type::Color) return false;
+
+    LottieSolid target;
+    target.color.value = {r, g, b};
+    override(slot, &target);
+    return true;
+}
+
+
+bool LottieLoader::override(const char* sid, const char* text)
+{
+    auto slot = this->slot(sid);
+    if (!slot || slot->type != LottieProperty::Type::TextDoc) return false;
+
+    //keep the current document style, replace the text only
+    LottieText target;
+    auto& doc = target.doc.value;
+    doc = static_cast<LottieText*>(slot->pairs.first().obj)->doc(frameNo);
+    doc.text = duplicate(text);
+    doc.name = duplicate(doc.name);
+    override(slot, &target);
+    return true;
+}
+
+
 float LottieLoader::shorten(float frameNo)
 {
     //This ensures that the target frame number is reached.
@@ -336,6 +775,8 @@ float LottieLoader::shorten(float frameNo)
 
 bool LottieLoader::frame(float no)
 {
+    if (streaming) return false;
+
     no = shorten(no);
 
     //Skip update if frame diff is too small.
@@ -343,11 +784,15 @@ bool LottieLoader::frame(float no)
 
     this->done();
 
+    regulate();
+
     this->frameNo = no;
 
     builder->offTween();
 
-    if (comp) comp->clear();     //clear synchronously
+    clear();
+
+    if (replay(no)) return true;
 
     TaskScheduler::request(this);
 
@@ -383,7 +828,11 @@ void LottieLoader::sync()
 {
     done();
 
-    if (rebuild) run(0);
+    //build the current frame again in place of the previous one
+    if (rebuild) {
+        clear();
+        run(0);
+    }
 }
 
 
@@ -415,6 +864,13 @@ Result LottieLoader::segment(float begin, float end)
 }
 
 
+//the shared model has no slots nor expressions, so that the instances of the file animate the same
+const char* LottieLoader::origin()
+{
+    return shared ? shared->path : nullptr;
+}
+
+
 bool LottieLoader::segment(const char* marker, float& begin, float& end)
 {
     if (!ready() || comp->markers.count == 0) return false;
@@ -454,7 +910,7 @@ bool LottieLoader::tween(float from, float to, float progress)
 
     builder->onTween(shorten(to), progress);
 
-    if (comp) comp->clear();     //clear synchronously
+    clear();
 
     TaskScheduler::request(this);
 
@@ -466,6 +922,73 @@ bool LottieLoader::assign(const char* layer, uint32_t ix, const char* var, float
 {
     if (!ready() || !comp->expressions) return false;
     comp->root->assign(layer, ix, var, val);
+    discard();
+
+    return true;
+}
+
+
+//steps the quality down or up by the measured time of the last frames
+void LottieLoader::regulate()
+{
+    constexpr uint8_t DEGRADE_MAX = 2;  //see LottieBuilder::updateEffect()
+    constexpr uint8_t SETTLING = 8;
+
+    if (!timing || elapsed == 0) return;
+
+    auto ms = float(elapsed) * 0.000001f;
+    elapsed = 0;
+
+    //smooth out the spikes, the playback prefers a steady quality
+    cost = (cost > 0.0f) ? (cost * 0.75f + ms * 0.25f) : ms;
+
+    if (settle > 0) {
+        --settle;
+        return;
+    }
+
+    auto degrade = builder->degrade;
+    if (cost > allowance && degrade < DEGRADE_MAX) ++degrade;
+    else if (cost < allowance * 0.5f && degrade > 0) --degrade;
+    else return;
+
+    TVGLOG("LOTTIE", "Quality step %d by the frame time (%f ms)", degrade, cost);
+
+    builder->degrade = degrade;
+    settle = SETTLING;
+    cost = 0.0f;
+    rebuild = true;
+    discard();
+}
+
+
+bool LottieLoader::adapt(float budget)
+{
+    if (!ready()) return false;
+
+    allowance = budget;
+    timing = budget > 0.0f;
+    elapsed = 0;
+    cost = 0.0f;
+    settle = 0;
+
+    //back to the full quality
+    if (!timing && builder->degrade > 0) {
+        builder->degrade = 0;
+        rebuild = true;
+        discard();
+    }
+
+    return true;
+}
+
+
+bool LottieLoader::cache(uint32_t budget)
+{
+    if (!ready()) return false;
+
+    this->budget = budget;
+    if (usage > budget) discard();
 
     return true;
 }
\ No newline at end of file
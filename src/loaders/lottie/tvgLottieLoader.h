@@ -24,11 +24,23 @@
 #define _TVG_LOTTIE_LOADER_H_
 
 #include "tvgCommon.h"
+#include "tvgFile.h"
 #include "tvgFrameModule.h"
 #include "tvgTaskScheduler.h"
 
 struct LottieComposition;
+struct LottieObject;
+struct LottieSlot;
 struct LottieBuilder;
+struct LottieShared;
+
+//retained paints of the built frame
+struct LottieFrame
+{
+    Array<Paint*> paints;   //duplicates of the root scene children
+    float no;               //shortened frame number
+    uint32_t size;          //estimated memory footprint
+};
 
 class LottieLoader : public FrameModule, public Task
 {
@@ -41,12 +53,23 @@ public:
 
     LottieBuilder* builder;
     LottieComposition* comp = nullptr;
+    LottieShared* shared = nullptr;     //the model shared by the instances of the same file
 
+    Array<LottieFrame*> frames;         //frame cache, see cache()
+    LottieFrame* shown = nullptr;       //the retained frame on the root scene
+    uint32_t budget = 0;                //memory budget of the frame cache
+    uint32_t usage = 0;                 //memory footprint of the frame cache
+    float allowance = 0.0f;             //time budget of a frame in milliseconds, see adapt()
+    float cost = 0.0f;                  //smoothed time of updating and drawing a frame in milliseconds
+    uint8_t settle = 0;                 //frames to wait for the measure after a quality change
+
+    FileMap file;                       //"content" loaded from a file, see open()
     Key key;
     char* dirName = nullptr;            //base resource directory
     bool copy = false;                  //"content" is owned by this loader
     bool overridden = false;            //overridden properties with slots
     bool rebuild = false;               //require building the lottie scene
+    bool streaming = false;             //"content" is still being fed, see feed()
 
     LottieLoader();
     ~LottieLoader();
@@ -57,6 +80,10 @@ public:
     bool read() override;
     Paint* paint() override;
     bool override(const char* slot, bool byDefault = false);
+    bool override(const char* sid, float val);
+    bool override(const char* sid, const Point& val);
+    bool override(const char* sid, uint8_t r, uint8_t g, uint8_t b);
+    bool override(const char* sid, const char* text);
 
     //Frame Controls
     bool frame(float no) override;
@@ -70,18 +97,37 @@ public:
     const char* markers(uint32_t index);
     bool segment(const char* marker, float& begin, float& end);
     Result segment(float begin, float end) override;
+    const char* origin() override;
 
     float shorten(float frameNo);  //Reduce the accuracy for performance
     bool tween(float from, float to, float progress);
     bool assign(const char* layer, uint32_t ix, const char* var, float val);
+    bool cache(uint32_t budget);
+    bool adapt(float budget);
+
+    //Streaming Supports
+    bool stream(const char* rpath);
+    bool feed(const char* data, uint32_t size, bool last);
 
 private:
     bool ready();
     bool header();
+    bool probe(bool whole);
+    bool parse();
+    void build();
     void clear();
     float startFrame();
     void run(unsigned tid) override;
     void release();
+    bool share(const char* path);
+    void publish(const char* path);
+    void unshare();
+    bool replay(float no);
+    void record();
+    void discard();
+    void regulate();
+    LottieSlot* slot(const char* sid);
+    void override(LottieSlot* slot, LottieObject* target);
 };
 
 
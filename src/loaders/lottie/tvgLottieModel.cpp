@@ -22,6 +22,7 @@
 
 #include "tvgMath.h"
 #include "tvgTaskScheduler.h"
+#include "tvgPicture.h"
 #include "tvgLottieModel.h"
 #include "tvgCompressor.h"
 
@@ -57,10 +58,67 @@ Point LottieTextFollowPath::split(float dLen, float lenSearched, float& angle)
     return {};
 }
 
+
+static LottieGlyph* _glyph(LottieFont* font, const char* p, uint8_t caps)
+{
+    //the small letters are matched to the capital ones, see LottieBuilder::updateText()
+    char capCode[2] = {*p, '\0'};
+    if (caps && *p >= 'a' && *p <= 'z') {
+        capCode[0] = *p + 'A' - 'a';
+        p = capCode;
+    }
+
+    ARRAY_FOREACH(g, font->chars) {
+        if (!strncmp((*g)->code, p, (*g)->len)) return *g;
+    }
+    return nullptr;
+}
+
 /************************************************************************/
 /* External Class Implementation                                        */
 /************************************************************************/
 
+void LottieGlyph::prepare()
+{
+    len = strlen(code);
+
+    //the outline without keyframes and expressions is built once and shared by the characters
+    ARRAY_FOREACH(p, children) {
+        if ((*p)->type != LottieObject::Group) return;
+        ARRAY_FOREACH(q, static_cast<LottieGroup*>(*p)->children) {
+            if ((*q)->type != LottieObject::Path) return;
+            auto& pathset = static_cast<LottiePath*>(*q)->pathset;
+            if (pathset.frames || pathset.exp) return;
+        }
+    }
+
+    ARRAY_FOREACH(p, children) {
+        ARRAY_FOREACH(q, static_cast<LottieGroup*>(*p)->children) {
+            static_cast<LottiePath*>(*q)->pathset(0.0f, path, nullptr, nullptr);
+        }
+    }
+    statical = true;
+}
+
+
+//the document given by an expression could be another one every frame, it's not resolved
+LottieGlyph* LottieText::glyph(const TextDocument& doc, const char* p)
+{
+    if (this->doc.exp) return _glyph(font, p, doc.caps);
+
+    if (resolved.text != doc.text) {
+        auto len = strlen(doc.text);
+        resolved.text = doc.text;
+        resolved.glyphs.clear();
+        resolved.glyphs.reserve(len);
+        for (uint32_t i = 0; i < len; ++i) {
+            resolved.glyphs.push(_glyph(font, doc.text + i, doc.caps));
+        }
+    }
+    return resolved.glyphs[p - doc.text];
+}
+
+
 float LottieTextFollowPath::prepare(LottieMask* mask, float frameNo, float scale, Tween& tween, LottieExpressions* exps)
 {
     this->mask = mask;
@@ -358,14 +416,15 @@ void LottieImage::prepare()
 
     auto picture = Picture::gen();
 
-    //force to load a picture on the same thread
-    if (data.size > 0) picture->load((const char*)data.b64Data, data.size, data.mimeType);
-    else picture->load(data.path);
+    //force to load a picture on the same thread, the embedded one is decoded on its first appearance
+    if (data.size > 0) {
+        PICTURE(picture)->lazy = true;
+        picture->load((const char*)data.b64Data, data.size, data.mimeType);
+    } else picture->load(data.path);
 
     picture->size(data.width, data.height);
-    picture->ref();
 
-    pooler.push(picture);
+    push(picture);
 }
 
 
@@ -373,9 +432,9 @@ void LottieImage::update()
 {
     //Update the picture data
     ARRAY_FOREACH(p, pooler) {
-        if (data.size > 0) (*p)->load((const char*)data.b64Data, data.size, data.mimeType);
-        else (*p)->load(data.path);
-        (*p)->size(data.width, data.height);
+        if (data.size > 0) p->paint->load((const char*)data.b64Data, data.size, data.mimeType);
+        else p->paint->load(data.path);
+        p->paint->size(data.width, data.height);
     }
 }
 
@@ -647,6 +706,8 @@ LottieLayer::~LottieLayer()
 
     delete(transform);
     tvg::free(name);
+
+    if (retained) retained->unref();
 }
 
 
@@ -675,15 +736,13 @@ void LottieLayer::prepare(RGB32* color)
     if (type == LottieLayer::Precomp) {
         auto clipper = Shape::gen();
         clipper->appendRect(0.0f, 0.0f, w, h);
-        clipper->ref();
-        statical.pooler.push(clipper);
+        statical.push(clipper);
     //prepare solid fill in advance if it is a layer type.
     } else if (color && type == LottieLayer::Solid) {
         auto solidFill = Shape::gen();
         solidFill->appendRect(0, 0, static_cast<float>(w), static_cast<float>(h));
         solidFill->fill(color->r, color->g, color->b);
-        solidFill->ref();
-        statical.pooler.push(solidFill);
+        statical.push(solidFill);
     }
 
     LottieGroup::prepare(LottieObject::Layer);
@@ -715,16 +774,88 @@ bool LottieLayer::assign(const char* layer, uint32_t ix, const char* var, float
 }
 
 
-LottieComposition::~LottieComposition()
+//drop the cached transforms of the target layer and the ones parented to it
+static void _invalidate(LottieLayer* parent, LottieLayer* target)
 {
-    if (!initiated && root) delete(root->scene);
+    ARRAY_FOREACH(p, parent->children) {
+        if ((*p)->type != LottieObject::Type::Layer) continue;
+        auto layer = static_cast<LottieLayer*>(*p);
+        for (auto p = layer; p; p = p->parent) {
+            if (p != target) continue;
+            layer->cache.frameNo = -1.0f;
+            break;
+        }
+        if (layer->type == LottieLayer::Precomp) _invalidate(layer, target);
+    }
+}
+
+
+LottieSlot* LottieComposition::slotById(const char* sid)
+{
+    if (slotTable.empty()) return nullptr;
+
+    auto hash = djb2Encode(sid);
+    auto mask = slotTable.count - 1;
+    for (auto i = hash & mask; slotTable[i]; i = (i + 1) & mask) {
+        auto slot = slotTable[i];
+        if (slot->hash == hash && !strcmp(slot->sid, sid)) return slot;
+    }
+    return nullptr;
+}
+
+
+void LottieComposition::append(LottieSlot* slot)
+{
+    slots.push(slot);
+
+    //keep the load factor under a half
+    if (slots.count * 2 > slotTable.count) {
+        auto capacity = slotTable.empty() ? 16 : slotTable.count * 2;
+        slotTable.clear();
+        slotTable.reserve(capacity);
+        for (uint32_t i = 0; i < capacity; ++i) slotTable.push(nullptr);
+        ARRAY_FOREACH(p, slots) {
+            auto mask = capacity - 1;
+            auto i = (*p)->hash & mask;
+            while (slotTable[i]) i = (i + 1) & mask;
+            slotTable[i] = *p;
+        }
+        return;
+    }
+
+    auto mask = slotTable.count - 1;
+    auto i = slot->hash & mask;
+    while (slotTable[i]) i = (i + 1) & mask;
+    slotTable[i] = slot;
+}
+
+
+//the layers cache their transforms per frame, drop the ones the slot overrides
+void LottieComposition::invalidate(LottieSlot* slot)
+{
+    switch (slot->type) {
+        case LottieProperty::Type::Float:
+        case LottieProperty::Type::Scalar:
+        case LottieProperty::Type::Vector:
+        case LottieProperty::Type::Opacity: break;
+        default: return;
+    }
+
+    ARRAY_FOREACH(pair, slot->pairs) {
+        if (pair->layer && pair->obj == pair->layer->transform) _invalidate(root, pair->layer);
+    }
+}
 
+
+LottieComposition::~LottieComposition()
+{
     delete(root);
     tvg::free(version);
     tvg::free(name);
 
     ARRAY_FOREACH(p, interpolators) {
         tvg::free((*p)->key);
+        tvg::free((*p)->lut);
         tvg::free(*p);
     }
 
@@ -294,17 +294,16 @@ struct LottieObject
 struct LottieGlyph
 {
     Array<LottieObject*> children;   //glyph shapes.
+    RenderPath path;                 //the outline shared by the characters, built once if it's not animated
     float width;
     char* code;
     char* family = nullptr;
     char* style = nullptr;
     uint16_t size;
     uint8_t len;
+    bool statical = false;
 
-    void prepare()
-    {
-        len = strlen(code);
-    }
+    void prepare();
 
     ~LottieGlyph()
     {
@@ -467,6 +466,7 @@ struct LottieText : LottieObject, LottieRenderPooler<tvg::Shape>
     {
         if (release) doc.release();
         doc.copy(*static_cast<LottieTextDoc*>(prop), shallow);
+        resolved.text = nullptr;
     }
 
     LottieProperty* property(uint16_t ix) override
@@ -475,11 +475,19 @@ struct LottieText : LottieObject, LottieRenderPooler<tvg::Shape>
         return nullptr;
     }
 
+    LottieGlyph* glyph(const TextDocument& doc, const char* p);
+
     LottieTextDoc doc;
     LottieFont* font = nullptr;
     LottieTextFollowPath* followPath = nullptr;
     Array<LottieTextRange*> ranges;
 
+    //the glyph of each character, resolved once per document
+    struct {
+        const char* text = nullptr;
+        Array<LottieGlyph*> glyphs;
+    } resolved;
+
     ~LottieText()
     {
         ARRAY_FOREACH(p, ranges) delete(*p);
@@ -988,8 +996,13 @@ struct LottieLayer : LottieGroup
     Array<LottieMask*> masks;
     Array<LottieEffect*> effects;
     LottieLayer* matteTarget = nullptr;
+    struct {
+        char* begin = nullptr;
+        char* end = nullptr;
+    } deferred;                   //the raw precomp layers in the json, parsed once it's referred
 
     LottieRenderPooler<tvg::Shape> statical;  //static pooler for solid fill and clipper
+    Paint* retained = nullptr;  //the paint of the static top layer, built once and reused by the next frames
 
     float timeStretch = 1.0f;
     float w = 0.0f, h = 0.0f;
@@ -1007,10 +1020,21 @@ struct LottieLayer : LottieGroup
         uint8_t opacity;
     } cache;
 
+    //the content of the precomp asset built by its first reference in an update, see LottieBuilder::instantiate()
+    struct {
+        const void* builder = nullptr;
+        Scene* scene = nullptr;
+        uint32_t pass = 0;
+        float frameNo;
+        float w, h;
+    } instance;
+
     MaskMethod matteType = MaskMethod::None;
     Type type = Null;
     bool autoOrient = false;
     bool matteSrc = false;
+    bool animated = false;      //any keyframes, expressions or slots are given to the layer
+    bool reusing = false;       //the retained paint is taken by the current frame
 
     LottieEffect* effectById(unsigned long id)
     {
@@ -1055,15 +1079,16 @@ struct LottieSlot
 {
     struct Pair {
         LottieObject* obj;
+        LottieLayer* layer;      //the layer the object belongs to
         LottieProperty* prop;
     };
 
     void assign(LottieObject* target, bool byDefault);
     void reset();
 
-    LottieSlot(LottieLayer* layer, LottieObject* parent, char* sid, LottieObject* obj, LottieProperty::Type type) : context{layer, parent}, sid(sid), type(type)
+    LottieSlot(LottieLayer* layer, LottieObject* parent, char* sid, LottieObject* obj, LottieProperty::Type type) : context{layer, parent}, sid(sid), hash(djb2Encode(sid)), type(type)
     {
-        pairs.push({obj});
+        pairs.push({obj, layer});
     }
 
     ~LottieSlot()
@@ -1079,6 +1104,7 @@ struct LottieSlot
     } context;
 
     char* sid;
+    unsigned long hash;
     Array<Pair> pairs;
     LottieProperty::Type type;
 
@@ -1090,11 +1116,6 @@ struct LottieComposition
 {
     ~LottieComposition();
 
-    void clear()
-    {
-        if (root && root->scene) root->scene->remove();
-    }
-
     float duration() const
     {
         return frameCnt() / frameRate;  // in second
@@ -1126,6 +1147,10 @@ struct LottieComposition
         return nullptr;
     }
 
+    LottieSlot* slotById(const char* sid);
+    void append(LottieSlot* slot);
+    void invalidate(LottieSlot* slot);
+
     void clamp(float& frameNo)
     {
         frameNo += root->inFrame;
@@ -1142,9 +1167,11 @@ struct LottieComposition
     Array<LottieInterpolator*> interpolators;
     Array<LottieFont*> fonts;
     Array<LottieSlot*> slots;
+    Array<LottieSlot*> slotTable;   //open addressing index of the slots by their ids
     Array<LottieMarker*> markers;
     bool expressions = false;
-    bool initiated = false;
+    bool entangled = false;   //any expressions refer to the other layers
+    bool exact = false;       //easing without the lookup tables
 };
 
 #endif //_TVG_LOTTIE_MODEL_H_
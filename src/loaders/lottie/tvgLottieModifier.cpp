@@ -160,9 +160,9 @@ void LottieOffsetModifier::line(RenderPath& out, PathCommand* inCmds, uint32_t i
 
 bool LottieRoundnessModifier::modifyPath(PathCommand* inCmds, uint32_t inCmdsCnt, Point* inPts, uint32_t inPtsCnt, Matrix* transform, RenderPath& out)
 {
-    buffer->clear();
+    buffer.clear();
 
-    auto& path = (next) ? *buffer : out;
+    auto& path = (next) ? buffer : out;
     path.cmds.reserve(inCmdsCnt * 2);
     path.pts.reserve((uint32_t)(inPtsCnt * 1.5));
     auto pivot = path.pts.count;
@@ -217,9 +217,9 @@ bool LottieRoundnessModifier::modifyPolystar(RenderPath& in, RenderPath& out, fl
 {
     constexpr auto ROUNDED_POLYSTAR_MAGIC_NUMBER = 0.47829f;
 
-    buffer->clear();
+    buffer.clear();
 
-    auto& path = (next) ? *buffer : out;
+    auto& path = (next) ? buffer : out;
 
     auto len = length(in.pts[1] - in.pts[2]);
     auto r = len > 0.0f ? ROUNDED_POLYSTAR_MAGIC_NUMBER * std::min(len * 0.5f, this->r) / len : 0.0f;
@@ -294,7 +294,7 @@ bool LottieOffsetModifier::modifyPath(PathCommand* inCmds, uint32_t inCmdsCnt, P
     out.cmds.reserve(inCmdsCnt * 2);
     out.pts.reserve(inPtsCnt * (join == StrokeJoin::Round ? 4 : 2));
 
-    Array<Bezier> stack{5};
+    SmallArray<Bezier, 5> stack;
     State state;
     auto offset = _clockwise(inPts, inPtsCnt) ? this->offset : -this->offset;
     auto threshold = 1.0f / fabsf(offset) + 1.0f;
@@ -62,10 +62,10 @@ struct LottieRoundnessModifier : LottieModifier
 {
     static constexpr float ROUNDNESS_EPSILON = 1.0f;
 
-    RenderPath* buffer;
+    RenderPath buffer;   //reusable path
     float r;
 
-    LottieRoundnessModifier(RenderPath* buffer, float r) : buffer(buffer), r(r)
+    LottieRoundnessModifier(float r) : r(r)
     {
         type = Roundness;
     }
@@ -45,6 +45,8 @@ static unsigned long _int2str(int num)
 LottieExpression* LottieParser::getExpression(char* code, LottieComposition* comp, LottieLayer* layer, LottieObject* object, LottieProperty* property)
 {
     if (!comp->expressions) comp->expressions = true;
+    if (!comp->entangled && !LottieExpressions::isolated(code)) comp->entangled = true;
+    if (layer) layer->animated = true;
 
     auto inst = new LottieExpression;
     inst->code = code;
@@ -52,6 +54,7 @@ LottieExpression* LottieParser::getExpression(char* code, LottieComposition* com
     inst->layer = layer;
     inst->object = object;
     inst->property = property;
+    inst->constant = LottieExpressions::constant(code);
 
     return inst;
 }
@@ -151,7 +154,12 @@ bool LottieParser::getValue(TextDocument& doc)
 
 bool LottieParser::getValue(PathSet& path)
 {
-    Array<Point> outs, ins, pts;
+    auto& outs = vertices.outs;
+    auto& ins = vertices.ins;
+    auto& pts = vertices.pts;
+    outs.clear();
+    ins.clear();
+    pts.clear();
     bool closed = false;
 
     /* The shape object could be wrapped by a array
@@ -381,7 +389,7 @@ LottieInterpolator* LottieParser::getInterpolator(const char* key, Point& in, Po
 
     //new interpolator
     if (!interpolator) {
-        interpolator = tvg::malloc<LottieInterpolator*>(sizeof(LottieInterpolator));
+        interpolator = tvg::calloc<LottieInterpolator*>(1, sizeof(LottieInterpolator));
         interpolator->set(key, in, out);
         comp->interpolators.push(interpolator);
     }
@@ -398,6 +406,8 @@ void LottieParser::parseKeyFrame(T& prop)
     auto& frame = prop.newFrame();
     auto interpolator = false;
 
+    if (context.layer) context.layer->animated = true;
+
     enterObject();
 
     while (auto key = nextObjectKey()) {
@@ -457,13 +467,12 @@ void LottieParser::parsePropertyInternal(T& prop)
 
 void LottieParser::registerSlot(LottieObject* obj, const char* sid, LottieProperty::Type type)
 {
+    //the slot could be overridden by the animated properties
+    if (context.layer) context.layer->animated = true;
+
     //append object if the slot already exists.
-    ARRAY_FOREACH(p, comp->slots) {
-        if (strcmp((*p)->sid, sid)) continue;
-        (*p)->pairs.push({obj});
-        return;
-    }
-    comp->slots.push(new LottieSlot(context.layer, context.parent, duplicate(sid), obj, type));
+    if (auto slot = comp->slotById(sid)) slot->pairs.push({obj, context.layer});
+    else comp->append(new LottieSlot(context.layer, context.parent, duplicate(sid), obj, type));
 }
 
 
@@ -652,6 +661,7 @@ void LottieParser::getPathSet(LottiePathSet& path)
             if (peekType() == kArrayType) {
                 enterArray();
                 while (nextArrayValue()) parseKeyFrame(path);
+                path.prepare();
             } else {
                 getValue(path.value);
             }
@@ -935,7 +945,7 @@ LottieObject* LottieParser::parseAsset()
                 id = _int2str(getInt());
             }
         }
-        else if (KEY_AS("layers")) obj = parseLayers(comp->root);
+        else if (KEY_AS("layers")) obj = deferrable ? deferLayers(comp->root) : parseLayers(comp->root);
         else if (KEY_AS("u")) subPath = getString();
         else if (KEY_AS("p")) data = getString();
         else if (KEY_AS("w")) width = getFloat();
@@ -1134,7 +1144,7 @@ void LottieParser::parseTextRange(LottieText* text)
                     else if (KEY_AS("xe"))
                     {
                         parseProperty(selector->maxEase);
-                        selector->interpolator = tvg::malloc<LottieInterpolator*>(sizeof(LottieInterpolator));
+                        selector->interpolator = tvg::calloc<LottieInterpolator*>(1, sizeof(LottieInterpolator));
                     }
                     else if (KEY_AS("ne")) parseProperty(selector->minEase);
                     else if (KEY_AS("a")) parseProperty(selector->maxAmount);
@@ -1449,8 +1459,10 @@ LottieLayer* LottieParser::parseLayer(LottieLayer* precomp)
     while (auto key = nextObjectKey()) {
         if (KEY_AS("nm"))
         {
-            layer->name = getStringCopy();
-            layer->id = djb2Encode(layer->name);
+            //the layers are identified by the hashed ids, only the expressions refer to the names
+            auto name = getString();
+            layer->id = djb2Encode(name);
+            if (expressions && name) layer->name = duplicate(name);
         }
         else if (KEY_AS("ddd")) ddd = getInt();  //3d layer
         else if (KEY_AS("ind")) layer->ix = getInt();
@@ -1489,6 +1501,17 @@ LottieLayer* LottieParser::parseLayer(LottieLayer* precomp)
 }
 
 
+void LottieParser::parsePrecomp(LottieLayer* precomp)
+{
+    enterArray();
+    while (nextArrayValue()) {
+        precomp->children.push(parseLayer(precomp));
+    }
+
+    precomp->prepare();
+}
+
+
 LottieLayer* LottieParser::parseLayers(LottieLayer* root)
 {
     auto precomp = new LottieLayer;
@@ -1496,12 +1519,49 @@ LottieLayer* LottieParser::parseLayers(LottieLayer* root)
     precomp->type = LottieLayer::Precomp;
     precomp->comp = root;
 
-    enterArray();
-    while (nextArrayValue()) {
-        precomp->children.push(parseLayer(precomp));
+    parsePrecomp(precomp);
+
+    return precomp;
+}
+
+
+//find the end of the array, the string values could contain the brackets
+static char* _arrayEnd(char* p)
+{
+    auto depth = 1;
+    auto quoted = false;
+
+    while ((p = strpbrk(p, quoted ? "\"\\" : "\"[]"))) {
+        if (quoted) {
+            if (*p == '"') quoted = false;
+            else if (!*(++p)) break;  //skip the escaped one
+        } else if (*p == '"') quoted = true;
+        else if (*p == '[') ++depth;
+        else if (--depth == 0) return p;
+        ++p;
     }
+    return nullptr;
+}
+
+
+//leave the precomp layers in the json to parse them on demand, the unused precomps never cost more than their text
+LottieLayer* LottieParser::deferLayers(LottieLayer* root)
+{
+    //the opening bracket has been consumed already
+    auto begin = getPos();
+    auto end = _arrayEnd(begin);
+    if (!end) return parseLayers(root);
+
+    auto precomp = new LottieLayer;
+    precomp->type = LottieLayer::Precomp;
+    precomp->comp = root;
+    precomp->deferred.begin = begin - 1;
+    precomp->deferred.end = end;
+
+    //jump to the closing bracket as if it's an empty array
+    iss.src_ = end;
+    skip();
 
-    precomp->prepare();
     return precomp;
 }
 
@@ -1650,8 +1710,21 @@ void LottieParser::captureSlots(const char* key)
 }
 
 
+bool LottieParser::parse(LottieLayer* precomp)
+{
+    if (!parseNext()) return false;
+
+    parsePrecomp(precomp);
+
+    return !Invalid();
+}
+
+
 bool LottieParser::parse()
 {
+    //the slots must be bound to the objects up front
+    if (deferrable) deferrable = !strstr(getPos(), "\"sid\"");
+
     //verify json.
     if (!parseNext()) return false;
 
@@ -37,6 +37,7 @@ public:
     }
 
     bool parse();
+    bool parse(LottieLayer* precomp);
     bool apply(LottieSlot* slot, bool byDefault);
     const char* sid(bool first = false);
     void captureSlots(const char* key);
@@ -46,6 +47,7 @@ public:
     const char* dirName = nullptr;       //base resource directory
     char* slots = nullptr;
     bool expressions = false;            //support expressions?
+    bool deferrable = false;             //defer the precomp assets parsing? the json must be alive until they're parsed.
 
 private:
     RGB32 getColor(const char *str);
@@ -91,6 +93,8 @@ private:
     LottieRoundedCorner* parseRoundedCorner();
     LottieGradientFill* parseGradientFill();
     LottieLayer* parseLayers(LottieLayer* root);
+    LottieLayer* deferLayers(LottieLayer* root);
+    void parsePrecomp(LottieLayer* precomp);
     LottieMask* parseMask();
     LottieTrimpath* parseTrimpath();
     LottieRepeater* parseRepeater();
@@ -134,6 +138,11 @@ private:
         LottieLayer* layer = nullptr;
         LottieObject* parent = nullptr;
     } context;
+
+    //Scratch vertices of the path sets, reused over the whole parsing
+    struct Vertices {
+        Array<Point> ins, outs, pts;
+    } vertices;
 };
 
 #endif //_TVG_LOTTIE_PARSER_H_
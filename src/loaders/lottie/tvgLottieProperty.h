@@ -45,8 +45,8 @@ struct LottieProperty;
 template<typename T>
 struct LottieScalarFrame
 {
+    float no;                   //frame number, leads the keyframe for the lookups
     T value;                    //keyframe value
-    float no;                   //frame number
     LottieInterpolator* interpolator;
     bool hold = false;           //do not interpolate.
 
@@ -76,8 +76,8 @@ struct LottieScalarFrame
 template<typename T>
 struct LottieVectorFrame
 {
+    float no;                   //frame number, leads the keyframe for the lookups
     T value;                    //keyframe value
-    float no;                   //frame number
     LottieInterpolator* interpolator;
     T outTangent, inTangent;
     float length;
@@ -140,6 +140,9 @@ struct LottieExpression
     LottieObject* object;
     LottieProperty* property;
     Array<Writable> writables;
+    void* bytecode = nullptr;   //compiled code, reused across the frames
+    LottieExpressions* engine = nullptr;   //the engine holding the bytecode
+    bool constant = false;      //time-invariant code, folded into the property after the first evaluation
     bool disabled = false;
 
     struct {
@@ -157,6 +160,7 @@ struct LottieExpression
         layer = rhs->layer;
         object = rhs->object;
         property = rhs->property;
+        constant = rhs->constant;
         disabled = rhs->disabled;
     }
 
@@ -165,6 +169,7 @@ struct LottieExpression
         ARRAY_FOREACH(p, writables) {
             tvg::free(p->var);
         }
+        LottieExpressions::discard(this);
         tvg::free(code);
     }
 
@@ -191,6 +196,7 @@ struct LottieProperty
     LottieExpression* exp = nullptr;
     Type type;
     uint8_t ix;  //property index
+    uint32_t cursor = 0;  //the last keyframe looked up
 
     LottieProperty(Type type = Type::Invalid) : type(type) {}
     virtual ~LottieProperty() {}
@@ -243,21 +249,65 @@ static void _copy(PathSet* pathset, Array<PathCommand>& out)
 }
 
 
+//the last key not after the frame number, halving the range without a branch to the data
+//blend the points of two keyframes into the destination at once, the plain loops are left to the auto vectorization
+static void _lerp(const Point* s, const Point* e, Point* out, uint32_t cnt, float t, const Matrix* transform)
+{
+    if (transform) {
+        auto m = *transform;
+        for (uint32_t i = 0; i < cnt; ++i) {
+            auto x = s[i].x + (e[i].x - s[i].x) * t;
+            auto y = s[i].y + (e[i].y - s[i].y) * t;
+            out[i].x = x * m.e11 + y * m.e12 + m.e13;
+            out[i].y = x * m.e21 + y * m.e22 + m.e23;
+        }
+    } else {
+        auto from = &s->x;
+        auto to = &e->x;
+        auto dst = &out->x;
+        for (uint32_t i = 0; i < cnt * 2; ++i) {
+            dst[i] = from[i] + (to[i] - from[i]) * t;
+        }
+    }
+}
+
+
 template<typename T>
 uint32_t _bsearch(T* frames, float frameNo)
 {
-    int32_t low = 0;
-    int32_t high = int32_t(frames->count) - 1;
-
-    while (low <= high) {
-        auto mid = low + (high - low) / 2;
-        auto frame = frames->data + mid;
-        if (frameNo < frame->no) high = mid - 1;
-        else low = mid + 1;
-    }
-    if (high < low) low = high;
-    if (low < 0) low = 0;
-    return low;
+    auto base = frames->data;
+    auto n = frames->count;
+
+    while (n > 1) {
+        auto half = n / 2;
+        base = (frameNo < base[half].no) ? base : (base + half);
+        n -= half;
+    }
+    return uint32_t(base - frames->data);
+}
+
+
+//the playback mostly stays in or moves to the next segment of the last lookup, seeking falls back to the binary search
+template<typename T>
+uint32_t _lookup(T* frames, float frameNo, uint32_t& cursor)
+{
+    auto key = cursor;
+    if (key + 1 < frames->count && frameNo >= frames->data[key].no) {
+        if (frameNo < frames->data[key + 1].no) return key;
+        if (key + 2 >= frames->count || frameNo < frames->data[key + 2].no) return (cursor = key + 1);
+    }
+    return (cursor = _bsearch(frames, frameNo));
+}
+
+
+template<typename T>
+void _sample(T* frames)
+{
+    if (!frames) return;
+    for (auto frame = frames->begin() + 1; frame < frames->end(); ++frame) {
+        auto prev = frame - 1;
+        if (prev->interpolator && !prev->hold) prev->interpolator->sample(frame->no - prev->no);
+    }
 }
 
 
@@ -389,14 +439,17 @@ struct LottieGenericProperty : LottieProperty
         if (exps && exp) {
             Value out{};
             frameNo = _loop(frames, frameNo, exp);
-            if (exps->result<MyProperty>(frameNo, out, exp)) return out;
+            if (exps->result<MyProperty>(frameNo, out, exp)) {
+                if (exp->constant) fold(out);
+                return out;
+            }
         }
 
         if (!frames) return value;
         if (frames->count == 1 || frameNo <= frames->first().no) return frames->first().value;
         if (frameNo >= frames->last().no) return frames->last().value;
 
-        auto frame = frames->data + _bsearch(frames, frameNo);
+        auto frame = frames->data + _lookup(frames, frameNo, cursor);
         if (tvg::equal(frame->no, frameNo)) return frame->value;
         return frame->interpolate(frame + 1, frameNo);
     }
@@ -407,6 +460,20 @@ struct LottieGenericProperty : LottieProperty
         return tvg::lerp(operator()(frameNo, exps), operator()(tween.frameNo, exps), tween.progress);
     }
 
+    //replace the expression of a static property with its result
+    void fold(const Value& out)
+    {
+        if ((frames && frames->count > 1) || !exp->writables.empty()) {
+            exp->constant = false;
+            return;
+        }
+        delete(frames);
+        frames = nullptr;
+        value = out;
+        delete(exp);
+        exp = nullptr;
+    }
+
     void copy(MyProperty& rhs, bool shallow = true)
     {
         if (LottieProperty::copy(&rhs, shallow)) return;
@@ -435,7 +502,7 @@ struct LottieGenericProperty : LottieProperty
             return frame->angle(frame + 1, frames->last().no);
         }
 
-        auto frame = frames->data + _bsearch(frames, frameNo);
+        auto frame = frames->data + _lookup(frames, frameNo, cursor);
         return frame->angle(frame + 1, frameNo);
     }
 
@@ -447,6 +514,7 @@ struct LottieGenericProperty : LottieProperty
 
     void prepare()
     {
+        _sample(frames);
         if (Scalar) return;
         if (!frames || frames->count < 2) return;
         for (auto frame = frames->begin() + 1; frame < frames->end(); ++frame) {
@@ -480,11 +548,14 @@ struct LottiePathSet : LottieProperty
 
         if (!frames) return;
 
-        ARRAY_FOREACH(p, *frames) {
-            tvg::free((*p).value.cmds);
-            tvg::free((*p).value.pts);
+        //the compiled keyframes are borrowed from the loaded data
+        if (!frames->local) {
+            ARRAY_FOREACH(p, *frames) {
+                tvg::free((*p).value.cmds);
+                tvg::free((*p).value.pts);
+            }
+            tvg::free(frames->data);
         }
-        tvg::free(frames->data);
         tvg::free(frames);
     }
 
@@ -503,6 +574,11 @@ struct LottiePathSet : LottieProperty
         return _frameNo(frames, key);
     }
 
+    void prepare()
+    {
+        _sample(frames);
+    }
+
     LottieScalarFrame<PathSet>& newFrame()
     {
         if (!frames) {
@@ -529,7 +605,7 @@ struct LottiePathSet : LottieProperty
         else if (frames->count == 1 || frameNo <= frames->first().no) path = &frames->first().value;
         else if (frameNo >= frames->last().no) path = &frames->last().value;
         else {
-            frame = frames->data + _bsearch(frames, frameNo);
+            frame = frames->data + _lookup(frames, frameNo, cursor);
             if (tvg::equal(frame->no, frameNo)) path = &frame->value;
             else if (frame->value.ptsCnt != (frame + 1)->value.ptsCnt) {
                 path = &frame->value;
@@ -558,15 +634,8 @@ struct LottiePathSet : LottieProperty
         }
 
         //interpolate 2 frames
-        auto s = frame->value.pts;
-        auto e = (frame + 1)->value.pts;
         auto interpPts = tvg::malloc<Point*>(frame->value.ptsCnt * sizeof(Point));
-        auto p = interpPts;
-
-        for (auto i = 0; i < frame->value.ptsCnt; ++i, ++s, ++e, ++p) {
-            *p = tvg::lerp(*s, *e, t);
-            if (transform) *p *= *transform;
-        }
+        _lerp(frame->value.pts, (frame + 1)->value.pts, interpPts, frame->value.ptsCnt, t, transform);
 
         if (modifier) modifier->modifyPath(frame->value.cmds, frame->value.cmdsCnt, interpPts, frame->value.ptsCnt, nullptr, out);
 
@@ -587,15 +656,10 @@ struct LottiePathSet : LottieProperty
             return true;
         }
 
-        //interpolate 2 frames
-        auto s = frame->value.pts;
-        auto e = (frame + 1)->value.pts;
-
-        for (auto i = 0; i < frame->value.ptsCnt; ++i, ++s, ++e) {
-            auto pt = tvg::lerp(*s, *e, t);
-            if (transform) pt *= *transform;
-            out.pts.push(pt);
-        }
+        //interpolate 2 frames right into the path
+        out.pts.grow(frame->value.ptsCnt);
+        _lerp(frame->value.pts, (frame + 1)->value.pts, out.pts.end(), frame->value.ptsCnt, t, transform);
+        out.pts.count += frame->value.ptsCnt;
         _copy(&frame->value, out.cmds);
         return true;
     }
@@ -610,9 +674,7 @@ struct LottiePathSet : LottieProperty
         auto from = out.pts.data + pivot;
         if (to.pts.count != out.pts.count - pivot) TVGLOG("LOTTIE", "Tweening has different numbers of points in consecutive frames.");
 
-        for (uint32_t i = 0; i < std::min(to.pts.count, (out.pts.count - pivot)); ++i) {
-            from[i] = tvg::lerp(from[i], to.pts[i], tween.progress);
-        }
+        _lerp(from, to.pts.data, from, std::min(to.pts.count, (out.pts.count - pivot)), tween.progress, nullptr);
 
         if (!modifier) return true;
 
@@ -674,10 +736,12 @@ struct LottieColorStop : LottieProperty
 
         if (!frames) return;
 
-        ARRAY_FOREACH(p, *frames) {
-            tvg::free((*p).value.data);
+        if (!frames->local) {
+            ARRAY_FOREACH(p, *frames) {
+                tvg::free((*p).value.data);
+            }
+            tvg::free(frames->data);
         }
-        tvg::free(frames->data);
         tvg::free(frames);
         frames = nullptr;
     }
@@ -718,7 +782,7 @@ struct LottieColorStop : LottieProperty
 
     Result tweening(float frameNo, Fill* fill, Tween& tween, LottieExpressions* exps)
     {
-        auto frame = frames->data + _bsearch(frames, frameNo);
+        auto frame = frames->data + _lookup(frames, frameNo, cursor);
         if (tvg::equal(frame->no, frameNo)) return fill->colorStops(frame->value.data, count);
 
         //from
@@ -764,7 +828,7 @@ struct LottieColorStop : LottieProperty
 
         if (frameNo >= frames->last().no) return fill->colorStops(frames->last().value.data, count);
 
-        auto frame = frames->data + _bsearch(frames, frameNo);
+        auto frame = frames->data + _lookup(frames, frameNo, cursor);
         if (tvg::equal(frame->no, frameNo)) return fill->colorStops(frame->value.data, count);
 
         //interpolate
@@ -819,7 +883,10 @@ struct LottieColorStop : LottieProperty
         count = rhs.count;
     }
 
-    void prepare() {}
+    void prepare()
+    {
+        _sample(frames);
+    }
 };
 
 
@@ -904,7 +971,7 @@ struct LottieTextDoc : LottieProperty
         if (frames->count == 1 || frameNo <= frames->first().no) return frames->first().value;
         if (frameNo >= frames->last().no) return frames->last().value;
 
-        auto frame = frames->data + _bsearch(frames, frameNo);
+        auto frame = frames->data + _lookup(frames, frameNo, cursor);
         return frame->value;
     }
 
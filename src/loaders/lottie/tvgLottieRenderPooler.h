@@ -31,28 +31,75 @@
 template<typename T>
 struct LottieRenderPooler
 {
-    Array<T*> pooler;
+    struct Item
+    {
+        T* paint;
+        const void* owner;  //the builder taking the paint, which is bound to the renderer of its instance
+    };
+
+    Array<Item> pooler;
+    uint32_t cursor = 0;    //the next one of the last taken, the paints are taken in the same order every frame
 
     ~LottieRenderPooler()
     {
         ARRAY_FOREACH(p, pooler) {
-            (*p)->unref();
+            p->paint->unref();
         }
     }
 
-    T* pooling(bool copy = false)
+    void push(T* paint, const void* owner = nullptr)
     {
-        //return available one.
-        ARRAY_FOREACH(p, pooler) {
-            if ((*p)->refCnt() == 1) return *p;
+        paint->ref();
+        pooler.push({paint, owner});
+    }
+
+    T* pooling(const void* owner, bool copy = false)
+    {
+        //return available one, the search starts from the cursor to take the paints without rescanning the taken ones
+        for (uint32_t i = 0; i < pooler.count; ++i) {
+            auto idx = cursor + i;
+            if (idx >= pooler.count) idx -= pooler.count;
+            auto p = &pooler[idx];
+            if ((p->owner && p->owner != owner) || p->paint->refCnt() != 1) continue;
+            //the prepared one is taken by the first owner
+            p->owner = owner;
+            //the id could be given by the layer it was flattened into, see _flatten()
+            p->paint->id = 0;
+            cursor = idx + 1;
+            return p->paint;
         }
 
         //no empty, generate a new one.
-        auto p = copy ? static_cast<T*>(pooler[0]->duplicate()) : T::gen();
-        p->ref();
-        pooler.push(p);
+        auto p = copy ? static_cast<T*>(pooler[0].paint->duplicate()) : T::gen();
+        push(p, owner);
+        cursor = pooler.count;
         return p;
     }
+
+    //drop the paints of the leaving owner, the first one remains unbound for the copies
+    void retrieve(const void* owner)
+    {
+        for (uint32_t i = 0; i < pooler.count;) {
+            auto& p = pooler[i];
+            if (p.owner != owner) {
+                ++i;
+                continue;
+            }
+            if (i == 0) {
+                auto prepared = p.paint;
+                p.paint = static_cast<T*>(prepared->duplicate());
+                p.paint->ref();
+                p.owner = nullptr;
+                prepared->unref();
+                ++i;
+            } else {
+                p.paint->unref();
+                p = pooler.last();
+                pooler.pop();
+            }
+        }
+        cursor = 0;
+    }
 };
 
 
@@ -75,6 +75,11 @@
     #define LODEPNG_RESTRICT /* not available */
 #endif
 
+#if defined(THORVG_AVX_VECTOR_SUPPORT) && (defined(__SSE2__) || defined(_M_X64))
+    #include <emmintrin.h>
+    #define LODEPNG_SSE2 1
+#endif
+
 #define LODEPNG_MAX(a, b) (((a) > (b)) ? (a) : (b))
 #define LODEPNG_MIN(a, b) (((a) < (b)) ? (a) : (b))
 #define LODEPNG_ABS(x) ((x) < 0 ? -(x) : (x))
@@ -223,7 +228,7 @@ struct LodePNGBitReader
     size_t size; /*size of data in bytes*/
     size_t bitsize; /*size of data in bits, end of valid bp values, should be 8*size*/
     size_t bp;
-    unsigned buffer; /*buffer for reading bits. NOTE: 'unsigned' must support at least 32 bits*/
+    uint64_t buffer; /*buffer for reading bits, 64 bits wide to allow the refills of ensureBits56*/
 };
 
 
@@ -336,11 +341,26 @@ static LODEPNG_INLINE unsigned ensureBits32(LodePNGBitReader* reader, size_t nbi
 }
 
 
+/*See ensureBits documentation above. This one ensures up to 56 bits, but only succeeds if 8 more bytes are
+  available. Returns 0 at the tail of the stream, the caller should fall back to the smaller variants then. */
+static LODEPNG_INLINE unsigned ensureBits56(LodePNGBitReader* reader)
+{
+    size_t start = reader->bp >> 3u;
+    const unsigned char* p;
+    if (start + 8u > reader->size) return 0;
+    p = reader->data + start;
+    reader->buffer = (uint64_t)p[0] | ((uint64_t)p[1] << 8u) | ((uint64_t)p[2] << 16u) | ((uint64_t)p[3] << 24u) |
+                     ((uint64_t)p[4] << 32u) | ((uint64_t)p[5] << 40u) | ((uint64_t)p[6] << 48u) | ((uint64_t)p[7] << 56u);
+    reader->buffer >>= (reader->bp & 7u);
+    return 1;
+}
+
+
 /* Get bits without advancing the bit pointer. Must have enough bits available with ensureBits. Max nbits is 31. */
 static unsigned peekBits(LodePNGBitReader* reader, size_t nbits)
 {
     /* The shift allows nbits to be only up to 31. */
-    return reader->buffer & ((1u << nbits) - 1u);
+    return (unsigned)(reader->buffer & ((1u << nbits) - 1u));
 }
 
 
@@ -869,9 +889,28 @@ static unsigned inflateHuffmanBlock(ucvector* out, LodePNGBitReader* reader, uns
     while (!error) /*decode all symbols until end reached, breaks at end code*/ {
         /*code_ll is literal, length or end code*/
         unsigned code_ll;
-        ensureBits25(reader, 20); /* up to 15 for the huffman symbol, up to 5 for the length extra bits */
-        code_ll = huffmanDecodeSymbol(reader, &tree_ll);
-        if (code_ll <= 255) /*literal symbol*/ {
+        if (out->size + 3u <= out->allocsize && ensureBits56(reader)) {
+            /*fast path: one refill holds three symbols of up to 15 bits each, so runs of literals are decoded
+            and stored straight into the reserved output without any further refill or bounds check. The length
+            extra bits of a length code ending the run still fit in it (3 * 15 + 5 bits)*/
+            code_ll = huffmanDecodeSymbol(reader, &tree_ll);
+            if (code_ll <= 255) {
+                out->data[out->size++] = (unsigned char)code_ll;
+                code_ll = huffmanDecodeSymbol(reader, &tree_ll);
+                if (code_ll <= 255) {
+                    out->data[out->size++] = (unsigned char)code_ll;
+                    code_ll = huffmanDecodeSymbol(reader, &tree_ll);
+                    if (code_ll <= 255) {
+                        out->data[out->size++] = (unsigned char)code_ll;
+                        continue;
+                    }
+                }
+            }
+        } else {
+            ensureBits25(reader, 20); /* up to 15 for the huffman symbol, up to 5 for the length extra bits */
+            code_ll = huffmanDecodeSymbol(reader, &tree_ll);
+        }
+        if (code_ll <= 255) /*literal symbol, only left over by the slow path*/ {
             if (!ucvector_resize(out, out->size + 1)) ERROR_BREAK(83 /*alloc fail*/);
             out->data[out->size - 1] = (unsigned char)code_ll;
         } else if (code_ll >= FIRST_LENGTH_CODE_INDEX && code_ll <= LAST_LENGTH_CODE_INDEX) /*length code*/ {
@@ -914,12 +953,16 @@ static unsigned inflateHuffmanBlock(ucvector* out, LodePNGBitReader* reader, uns
             backward = start - distance;
 
             if (!ucvector_resize(out, out->size + length)) ERROR_BREAK(83 /*alloc fail*/);
-            if (distance < length) {
-                size_t forward;
-                lodepng_memcpy(out->data + start, out->data + backward, distance);
-                start += distance;
-                for (forward = distance; forward < length; ++forward) {
-                  out->data[start++] = out->data[backward++];
+            if (distance == 1) {
+                /*run of a single byte, very common in the flat areas of the filtered scanlines*/
+                lodepng_memset(out->data + start, out->data[backward], length);
+            } else if (distance < length) {
+                /*overlapping copy: the source repeats with a period of distance, copy it in growing chunks*/
+                size_t forward = 0;
+                while (forward < length) {
+                    size_t chunk = LODEPNG_MIN(start + forward - backward, length - forward);
+                    lodepng_memcpy(out->data + start + forward, out->data + backward, chunk);
+                    forward += chunk;
                 }
             } else {
                 lodepng_memcpy(out->data + start, out->data + backward, length);
@@ -2074,6 +2117,120 @@ static void Adam7_getpassvalues(unsigned passw[7], unsigned passh[7], size_t fil
 /* / PNG Decoder                                                            / */
 /* ////////////////////////////////////////////////////////////////////////// */
 
+#ifdef LODEPNG_SSE2
+
+/* loads and stores a 3 or 4 byte pixel into the low lanes of a vector. 3 byte pixels are moved as 2 + 1 bytes,
+   never touching the memory past the pixel */
+static LODEPNG_INLINE __m128i loadPixelSSE2(const unsigned char* p, size_t bytewidth)
+{
+    uint32_t v;
+    if (bytewidth == 4) memcpy(&v, p, 4);
+    else {
+        uint16_t t;
+        memcpy(&t, p, 2);
+        v = t | ((uint32_t)p[2] << 16);
+    }
+    return _mm_cvtsi32_si128((int)v);
+}
+
+
+static LODEPNG_INLINE void storePixelSSE2(unsigned char* p, __m128i v, size_t bytewidth)
+{
+    uint32_t t = (uint32_t)_mm_cvtsi128_si32(v);
+    if (bytewidth == 4) memcpy(p, &t, 4);
+    else {
+        uint16_t t2 = (uint16_t)t;
+        memcpy(p, &t2, 2);
+        p[2] = (unsigned char)(t >> 16);
+    }
+}
+
+
+/* Sub, Average and Paeth carry a dependency from one pixel to the next, so for the common 8-bit RGB and RGBA
+   scanlines all channels of a pixel are reconstructed at once. Up has no such dependency and is done 16 bytes
+   at a time for any bytewidth. Returns 1 if the scanline was handled, 0 if the scalar code should do it. */
+static LODEPNG_INLINE unsigned unfilterScanlineSSE2(unsigned char* recon, const unsigned char* scanline, const unsigned char* precon, size_t bytewidth, unsigned char filterType, size_t length)
+{
+    size_t i;
+
+    if (filterType == 2) {
+        if (!precon) return 0;
+        for (i = 0; i + 16 <= length; i += 16) {
+            __m128i x = _mm_loadu_si128((const __m128i*)(scanline + i));
+            __m128i b = _mm_loadu_si128((const __m128i*)(precon + i));
+            _mm_storeu_si128((__m128i*)(recon + i), _mm_add_epi8(x, b));
+        }
+        for (; i != length; ++i) recon[i] = scanline[i] + precon[i];
+        return 1;
+    }
+
+    if (bytewidth != 3 && bytewidth != 4) return 0;
+
+    if (filterType == 1 || (filterType == 4 && !precon)) {
+        /* Paeth without the previous scanline is always the left pixel */
+        __m128i a = _mm_setzero_si128();
+        for (i = 0; i != length; i += bytewidth) {
+            a = _mm_add_epi8(a, loadPixelSSE2(scanline + i, bytewidth));
+            storePixelSSE2(recon + i, a, bytewidth);
+        }
+        return 1;
+    }
+
+    if (!precon) return 0;
+
+    if (filterType == 3) {
+        /* the floor of (a + b) / 2 is the rounded up average minus the dropped low bit */
+        __m128i a = _mm_setzero_si128();
+        __m128i one = _mm_set1_epi8(1);
+        for (i = 0; i != length; i += bytewidth) {
+            __m128i b = loadPixelSSE2(precon + i, bytewidth);
+            __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+            a = _mm_add_epi8(loadPixelSSE2(scanline + i, bytewidth), avg);
+            storePixelSSE2(recon + i, a, bytewidth);
+        }
+        return 1;
+    }
+
+    if (filterType == 4) {
+        /* a is the left, b the above and c the upper left pixel, widened to 16 bits to compute
+           pa = |b - c|, pb = |a - c| and pc = |a + b - 2c| without overflow.
+           The first pixel has no left context: zero a and c make it predict b. */
+        __m128i zero = _mm_setzero_si128();
+        __m128i a = zero, b = zero, c, d = zero;
+        for (i = 0; i != length; i += bytewidth) {
+            __m128i pa, pb, pc, smallest, nearest, pick;
+            c = b;
+            b = _mm_unpacklo_epi8(loadPixelSSE2(precon + i, bytewidth), zero);
+            a = d;
+            d = _mm_unpacklo_epi8(loadPixelSSE2(scanline + i, bytewidth), zero);
+
+            pa = _mm_sub_epi16(b, c);
+            pb = _mm_sub_epi16(a, c);
+            pc = _mm_add_epi16(pa, pb);
+            pa = _mm_max_epi16(pa, _mm_sub_epi16(zero, pa));
+            pb = _mm_max_epi16(pb, _mm_sub_epi16(zero, pb));
+            pc = _mm_max_epi16(pc, _mm_sub_epi16(zero, pc));
+
+            /* pick a, then b, then c on ties, like paethPredictor() */
+            smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+            pick = _mm_cmpeq_epi16(smallest, pb);
+            nearest = _mm_or_si128(_mm_and_si128(pick, b), _mm_andnot_si128(pick, c));
+            pick = _mm_cmpeq_epi16(smallest, pa);
+            nearest = _mm_or_si128(_mm_and_si128(pick, a), _mm_andnot_si128(pick, nearest));
+
+            /* the high bytes are zero, so a byte wise add keeps the reconstruction modulo 256 in each lane */
+            d = _mm_add_epi8(d, nearest);
+            storePixelSSE2(recon + i, _mm_packus_epi16(d, d), bytewidth);
+        }
+        return 1;
+    }
+
+    return 0;
+}
+
+#endif
+
+
 static unsigned unfilterScanline(unsigned char* recon, const unsigned char* scanline, const unsigned char* precon, size_t bytewidth, unsigned char filterType, size_t length)
 {
     /* For PNG filter method 0
@@ -2084,6 +2241,16 @@ static unsigned unfilterScanline(unsigned char* recon, const unsigned char* scan
        recon and scanline MAY be the same memory address! precon must be disjoint. */
 
     size_t i;
+
+#ifdef LODEPNG_SSE2
+    /* the constant bytewidths let the pixel loads and stores compile to plain moves */
+    if (bytewidth == 4) {
+        if (unfilterScanlineSSE2(recon, scanline, precon, 4, filterType, length)) return 0;
+    } else if (bytewidth == 3) {
+        if (unfilterScanlineSSE2(recon, scanline, precon, 3, filterType, length)) return 0;
+    } else if (unfilterScanlineSSE2(recon, scanline, precon, bytewidth, filterType, length)) return 0;
+#endif
+
     switch (filterType) {
         case 0:
             for (i = 0; i != length; ++i) recon[i] = scanline[i];
@@ -2500,6 +2667,8 @@ static void decodeGeneric(unsigned char** out, unsigned* w, unsigned* h, LodePNG
 static void lodepng_decoder_settings_init(LodePNGDecoderSettings* settings)
 {
     settings->color_convert = 1;
+    settings->premultiply = 0;
+    settings->swap_rb = 0;
     settings->ignore_crc = 0;
     settings->ignore_critical = 0;
     settings->ignore_end = 0;
@@ -2577,6 +2746,29 @@ unsigned lodepng_inspect(unsigned* w, unsigned* h, LodePNGState* state, const un
 }
 
 
+/* premultiplies and/or swizzles the final RGBA8 pixels in place, see LodePNGDecoderSettings.
+   Each color becomes (color * alpha) >> 8, the same as the renderer does for straight alpha images. */
+static void finalizeRGBA8(unsigned char* out, size_t numpixels, unsigned premultiply, unsigned swap_rb)
+{
+    size_t i;
+    for (i = 0; i != numpixels; ++i, out += 4) {
+        unsigned char r = out[0], b = out[2], a = out[3];
+        if (premultiply && a != 255) {
+            r = (unsigned char)((r * a) >> 8);
+            out[1] = (unsigned char)((out[1] * a) >> 8);
+            b = (unsigned char)((b * a) >> 8);
+        }
+        if (swap_rb) {
+            out[0] = b;
+            out[2] = r;
+        } else {
+            out[0] = r;
+            out[2] = b;
+        }
+    }
+}
+
+
 unsigned lodepng_decode(unsigned char** out, unsigned* w, unsigned* h, LodePNGState* state, const unsigned char* in, size_t insize)
 {
     *out = 0;
@@ -2608,6 +2800,9 @@ unsigned lodepng_decode(unsigned char** out, unsigned* w, unsigned* h, LodePNGSt
         else state->error = lodepng_convert(*out, data, &state->info_raw, &state->info_png.color, *w, *h);
         tvg::free(data);
     }
+    if (!state->error && (state->decoder.premultiply || state->decoder.swap_rb) && state->info_raw.colortype == LCT_RGBA && state->info_raw.bitdepth == 8) {
+        finalizeRGBA8(*out, (size_t)(*w) * (size_t)(*h), state->decoder.premultiply, state->decoder.swap_rb);
+    }
     return state->error;
 }
 
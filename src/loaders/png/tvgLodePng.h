@@ -155,6 +155,11 @@ struct LodePNGDecoderSettings
        in string keys, etc... */
 
     unsigned color_convert; /*whether to convert the PNG to the color type you want. Default: yes*/
+
+    /* Only for the 8-bit RGBA output, applied while the decoded pixels are still in cache so that the
+       image can be uploaded as is, without a conversion pass in the renderer. */
+    unsigned premultiply; /*multiply the colors by their alpha. Default: no*/
+    unsigned swap_rb; /*swap the red and blue channels to output BGRA. Default: no*/
 };
 
 /*The settings, state and information for extended encoding and decoding.*/
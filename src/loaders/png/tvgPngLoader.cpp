@@ -29,23 +29,83 @@
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
+//box filter the straight alpha pixels by 2^shift, the colors are weighted by their alphas.
+//the result is written premultiplied in the rgba or bgra (swap) order as the lodepng direct decoding does.
+static uint8_t* _downscale(uint8_t* src, unsigned& width, unsigned& height, uint8_t shift, bool swap)
+{
+    auto box = 1u << shift;
+    auto rw = (width + box - 1) >> shift;
+    auto rh = (height + box - 1) >> shift;
+
+    auto dst = tvg::malloc<uint8_t*>(rw * rh * 4);
+    if (!dst) return src;
+
+    auto out = dst;
+    for (unsigned y = 0; y < rh; ++y) {
+        auto y1 = (y + 1) * box < height ? (y + 1) * box : height;
+        for (unsigned x = 0; x < rw; ++x) {
+            auto x1 = (x + 1) * box < width ? (x + 1) * box : width;
+            uint32_t r = 0, g = 0, b = 0, a = 0, cnt = 0;
+            for (auto sy = y * box; sy < y1; ++sy) {
+                auto p = src + (sy * width + x * box) * 4;
+                for (auto sx = x * box; sx < x1; ++sx, p += 4, ++cnt) {
+                    r += p[0] * p[3];
+                    g += p[1] * p[3];
+                    b += p[2] * p[3];
+                    a += p[3];
+                }
+            }
+            auto alpha = (a + cnt / 2) / cnt;
+            r = a ? (r + a / 2) / a : 0;
+            g = a ? (g + a / 2) / a : 0;
+            b = a ? (b + a / 2) / a : 0;
+            if (alpha < 255) {
+                r = (r * alpha) >> 8;
+                g = (g * alpha) >> 8;
+                b = (b * alpha) >> 8;
+            }
+            out[0] = swap ? b : r;
+            out[1] = g;
+            out[2] = swap ? r : b;
+            out[3] = alpha;
+            out += 4;
+        }
+    }
+    tvg::free(src);
+    width = rw;
+    height = rh;
+    return dst;
+}
+
+
 void PngLoader::run(unsigned tid)
 {
+    MemoryScope scope(MemoryCategory::Loader);
+
     auto width = static_cast<unsigned>(w);
     auto height = static_cast<unsigned>(h);
 
+    //decode straight into the premultiplied target colorspace, no conversion is left for the renderer
+    auto swap = (surface.cs == ColorSpace::ARGB8888 || surface.cs == ColorSpace::ARGB8888S);
+
     state.info_raw.colortype = LCT_RGBA;   //request this image format
+    //the box filter needs the straight colors, it premultiplies the reduced image by itself
+    state.decoder.premultiply = (reduction == 0);
+    state.decoder.swap_rb = swap && (reduction == 0);
 
     if (lodepng_decode(&surface.buf8, &width, &height, &state, data, size)) {
         TVGERR("PNG", "Failed to decode image");
+    } else if (reduction > 0) {
+        surface.buf8 = _downscale(surface.buf8, width, height, reduction, swap);
     }
 
     //setup the surface
     surface.stride = width;
     surface.w = width;
     surface.h = height;
-    surface.cs = ColorSpace::ABGR8888S;
+    surface.cs = swap ? ColorSpace::ARGB8888 : ColorSpace::ABGR8888;
     surface.channelSize = sizeof(uint32_t);
+    surface.premultiplied = true;
 }
 
 
@@ -63,6 +123,7 @@ PngLoader::~PngLoader()
 {
     done();
     if (freeData) tvg::free(data);
+    file.close();
     tvg::free(surface.buf8);
     lodepng_state_cleanup(&state);
 }
@@ -71,38 +132,18 @@ PngLoader::~PngLoader()
 bool PngLoader::open(const char* path)
 {
 #ifdef THORVG_FILE_IO_SUPPORT
-    auto pngFile = fopen(path, "rb");
-    if (!pngFile) return false;
-
-    auto ret = false;
-
-    //determine size
-    if (fseek(pngFile, 0, SEEK_END) < 0) goto finalize;
-    if (((size = ftell(pngFile)) < 1)) goto finalize;
-    if (fseek(pngFile, 0, SEEK_SET)) goto finalize;
+    if (!file.open(path)) return false;
 
-    data = tvg::malloc<unsigned char*>(size);
-    if (!data) goto finalize;
-
-    freeData = true;
-
-    if (fread(data, size, 1, pngFile) < 1) goto finalize;
-
-    lodepng_state_init(&state);
+    data = file.data;
+    size = file.size;
 
     unsigned int width, height;
-    if (lodepng_inspect(&width, &height, &state, data, size) > 0) goto finalize;
+    if (lodepng_inspect(&width, &height, &state, data, size) > 0) return false;
 
     w = static_cast<float>(width);
     h = static_cast<float>(height);
 
-    ret = true;
-
-    goto finalize;
-
-finalize:
-    fclose(pngFile);
-    return ret;
+    return true;
 #else
     return false;
 #endif
@@ -138,7 +179,9 @@ bool PngLoader::read()
 
     if (!LoadModule::read()) return true;
 
-    TaskScheduler::request(this);
+    surface.cs = ImageLoader::cs;
+
+    request(this);
 
     return true;
 }
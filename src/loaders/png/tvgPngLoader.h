@@ -23,6 +23,7 @@
 #ifndef _TVG_PNG_LOADER_H_
 #define _TVG_PNG_LOADER_H_
 
+#include "tvgFile.h"
 #include "tvgLodePng.h"
 #include "tvgTaskScheduler.h"
 
@@ -31,6 +32,7 @@ class PngLoader : public ImageLoader, public Task
 {
 private:
     LodePNGState state;
+    FileMap file;
     unsigned char* data = nullptr;
     unsigned long size = 0;
     bool freeData = false;
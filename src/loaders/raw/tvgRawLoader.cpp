@@ -36,30 +36,60 @@ RawLoader::~RawLoader()
 }
 
 
-bool RawLoader::open(const uint32_t* data, uint32_t w, uint32_t h, ColorSpace cs, bool copy)
+bool RawLoader::open(const uint32_t* data, uint32_t w, uint32_t h, uint32_t stride, ColorSpace cs, bool copy)
 {
     if (!LoadModule::read()) return true;
 
-    if (!data || w == 0 || h == 0) return false;
+    if (!data || w == 0 || h == 0 || stride < w) return false;
 
     this->w = (float)w;
     this->h = (float)h;
     this->copy = copy;
 
+    //the copy is packed, otherwise the rows are read in place
     if (copy) {
         surface.buf32 = tvg::malloc<uint32_t*>(sizeof(uint32_t) * w * h);
         if (!surface.buf32) return false;
-        memcpy((void*)surface.buf32, data, sizeof(uint32_t) * w * h);
+        if (stride == w) memcpy((void*)surface.buf32, data, sizeof(uint32_t) * w * h);
+        else {
+            for (uint32_t y = 0; y < h; ++y) {
+                memcpy((void*)(surface.buf32 + y * w), data + y * stride, sizeof(uint32_t) * w);
+            }
+        }
+        stride = w;
     }
     else surface.buf32 = const_cast<uint32_t*>(data);
 
     //setup the surface
+    surface.stride = stride;
+    surface.w = w;
+    surface.h = h;
+    surface.cs = cs;
+    surface.channelSize = sizeof(uint32_t);
+    surface.premultiplied = (cs == ColorSpace::ABGR8888 || cs == ColorSpace::ARGB8888) ? true : false;
+
+    return true;
+}
+
+
+//wrap a texture of the gpu engines, the engines sample it in place
+bool RawLoader::open(void* texture, uint32_t w, uint32_t h, ColorSpace cs)
+{
+    if (!LoadModule::read()) return true;
+
+    if (!texture || w == 0 || h == 0) return false;
+
+    this->w = (float)w;
+    this->h = (float)h;
+
+    surface.data = (pixel_t*)texture;
     surface.stride = w;
     surface.w = w;
     surface.h = h;
     surface.cs = cs;
     surface.channelSize = sizeof(uint32_t);
     surface.premultiplied = (cs == ColorSpace::ABGR8888 || cs == ColorSpace::ARGB8888) ? true : false;
+    surface.native = true;
 
     return true;
 }
@@ -32,7 +32,8 @@ public:
     ~RawLoader();
 
     using LoadModule::open;
-    bool open(const uint32_t* data, uint32_t w, uint32_t h, ColorSpace cs, bool copy);
+    bool open(const uint32_t* data, uint32_t w, uint32_t h, uint32_t stride, ColorSpace cs, bool copy);
+    bool open(void* texture, uint32_t w, uint32_t h, ColorSpace cs);
     bool read() override;
 };
 
@@ -21,12 +21,101 @@
  */
 
 #include "tvgStr.h"
+#include "tvgCompressor.h"
 #include "tvgSvgCssStyle.h"
 
 /************************************************************************/
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
+//open addressing table of the style rules keyed by their selectors (the element type and the class name)
+struct SvgCssIndex
+{
+    struct Slot
+    {
+        SvgNode* rule;
+        uint32_t hash;
+    };
+
+    Slot* slots = nullptr;
+    uint32_t capacity = 0;     //power of 2
+    uint32_t count = 0;
+    uint32_t indexed = 0;      //the number of the rules of the style node indexed so far
+
+    ~SvgCssIndex()
+    {
+        tvg::free(slots);
+    }
+
+    static uint32_t hash(SvgNodeType type, const char* id)
+    {
+        auto h = id ? (uint32_t)djb2Encode(id) : 0;
+        return (h ^ ((uint32_t)type * 0x9e3779b1u)) | 1;  //never 0
+    }
+
+    static bool match(const SvgNode* rule, SvgNodeType type, const char* id)
+    {
+        if (rule->type != type) return false;
+        if (!id || !rule->id) return !id && !rule->id;
+        return !strcmp(rule->id, id);
+    }
+
+    SvgNode* find(SvgNodeType type, const char* id) const
+    {
+        if (count == 0) return nullptr;
+        auto h = hash(type, id);
+        for (auto i = h & (capacity - 1); slots[i].rule; i = (i + 1) & (capacity - 1)) {
+            if (slots[i].hash == h && match(slots[i].rule, type, id)) return slots[i].rule;
+        }
+        return nullptr;
+    }
+
+    void insert(SvgNode* rule)
+    {
+        //the first declared one wins like the linear search did
+        if (find(rule->type, rule->id)) return;
+
+        if ((count + 1) * 2 > capacity) grow();
+
+        auto h = hash(rule->type, rule->id);
+        auto i = h & (capacity - 1);
+        while (slots[i].rule) i = (i + 1) & (capacity - 1);
+        slots[i] = {rule, h};
+        ++count;
+    }
+
+    void grow()
+    {
+        auto old = slots;
+        auto oldCapacity = capacity;
+
+        capacity = capacity ? capacity * 2 : 16;
+        slots = tvg::calloc<Slot*>(capacity, sizeof(Slot));
+
+        for (uint32_t i = 0; i < oldCapacity; ++i) {
+            if (!old[i].rule) continue;
+            auto j = old[i].hash & (capacity - 1);
+            while (slots[j].rule) j = (j + 1) & (capacity - 1);
+            slots[j] = old[i];
+        }
+        tvg::free(old);
+    }
+};
+
+
+//the rules are appended while parsing, index the new ones on demand
+static SvgCssIndex* _index(const SvgNode* style)
+{
+    auto& index = const_cast<SvgNode*>(style)->node.cssStyle.index;
+    if (!index) index = new SvgCssIndex;
+
+    for (; index->indexed < style->child.count; ++index->indexed) {
+        index->insert(style->child[index->indexed]);
+    }
+    return index;
+}
+
+
 static bool _isImportanceApplicable(SvgStyleFlags &toFlagsImportance, SvgStyleFlags fromFlagsImportance, SvgStyleFlags flag)
 {
     if (!(toFlagsImportance & flag) && (fromFlagsImportance & flag)) {
@@ -71,8 +160,9 @@ static void _copyStyle(SvgStyleProperty* to, const SvgStyleProperty* from)
         to->fill.paint.none = from->fill.paint.none;
         to->fill.paint.curColor = from->fill.paint.curColor;
         if (from->fill.paint.url) {
-            if (to->fill.paint.url) tvg::free(to->fill.paint.url);
+            if (!to->fill.paint.shared) tvg::free(to->fill.paint.url);
             to->fill.paint.url = duplicate(from->fill.paint.url);
+            to->fill.paint.shared = false;
         }
         to->fill.flags = (to->fill.flags | SvgFillFlags::Paint);
         to->flags = (to->flags | SvgStyleFlags::Fill);
@@ -105,8 +195,9 @@ static void _copyStyle(SvgStyleProperty* to, const SvgStyleProperty* from)
         to->stroke.paint.none = from->stroke.paint.none;
         to->stroke.paint.curColor = from->stroke.paint.curColor;
         if (from->stroke.paint.url) {
-            if (to->stroke.paint.url) tvg::free(to->stroke.paint.url);
+            if (!to->stroke.paint.shared) tvg::free(to->stroke.paint.url);
             to->stroke.paint.url = duplicate(from->stroke.paint.url);
+            to->stroke.paint.shared = false;
         }
         to->stroke.flags = (to->stroke.flags | SvgStrokeFlags::Paint);
         to->flags = (to->flags | SvgStyleFlags::Stroke);
@@ -210,12 +301,7 @@ SvgNode* cssFindStyleNode(const SvgNode* style, const char* title, SvgNodeType t
 {
     if (!style) return nullptr;
 
-    ARRAY_FOREACH(p, style->child) {
-        if ((*p)->type == type) {
-            if ((!title && !(*p)->id) || (title && (*p)->id && !strcmp((*p)->id, title))) return *p;
-        }
-    }
-    return nullptr;
+    return _index(style)->find(type, title);
 }
 
 
@@ -223,12 +309,7 @@ SvgNode* cssFindStyleNode(const SvgNode* style, const char* title)
 {
     if (!style || !title) return nullptr;
 
-    ARRAY_FOREACH(p, style->child) {
-        if ((*p)->type == SvgNodeType::CssStyle) {
-            if ((*p)->id && !strcmp((*p)->id, title)) return *p;
-        }
-    }
-    return nullptr;
+    return _index(style)->find(SvgNodeType::CssStyle, title);
 }
 
 
@@ -258,3 +339,10 @@ void cssApplyStyleToPostponeds(Array<SvgNodeIdPair>& postponeds, SvgNode* style)
         }
     }
 }
+
+
+void cssFreeIndex(SvgNode* style)
+{
+    delete(style->node.cssStyle.index);
+    style->node.cssStyle.index = nullptr;
+}
@@ -30,5 +30,6 @@ SvgNode* cssFindStyleNode(const SvgNode* style, const char* title, SvgNodeType t
 SvgNode* cssFindStyleNode(const SvgNode* style, const char* title);
 void cssUpdateStyle(SvgNode* doc, SvgNode* style);
 void cssApplyStyleToPostponeds(Array<SvgNodeIdPair>& postponeds, SvgNode* style);
+void cssFreeIndex(SvgNode* style);
 
 #endif //_TVG_SVG_CSS_STYLE_H_
@@ -20,14 +20,17 @@
  * SOFTWARE.
  */
 
-#include <fstream>
 #include "tvgStr.h"
 #include "tvgMath.h"
 #include "tvgColor.h"
 #include "tvgLoader.h"
+#include "tvgLock.h"
+#include "tvgShape.h"
+#include "tvgTrace.h"
 #include "tvgXmlParser.h"
 #include "tvgSvgLoader.h"
 #include "tvgSvgSceneBuilder.h"
+#include "tvgSvgUtil.h"
 #include "tvgSvgCssStyle.h"
 
 /************************************************************************/
@@ -82,7 +85,7 @@ static bool _parseNumber(const char** content, const char** end, float* number)
 {
     auto _end = end ? *end : nullptr;
 
-    *number = toFloat(*content, (char**)&_end);
+    *number = svgUtilToFloat(*content, (char**)&_end);
     //If the start of string is not number
     if ((*content) == _end) {
         if (end) *end = _end;
@@ -1134,7 +1137,10 @@ static bool _parseStyleAttr(void* data, const char* key, const char* value, bool
                 while (size > 0 && isspace(value[size - 1])) {
                     size--;
                 }
-                value = duplicate(value, size);
+                auto trimmed = (char*)alloca(size + 1);
+                memcpy(trimmed, value, size);
+                trimmed[size] = '\0';
+                value = trimmed;
                 importance = true;
             }
             if (style) {
@@ -1145,10 +1151,7 @@ static bool _parseStyleAttr(void* data, const char* key, const char* value, bool
             } else if (!(node->style->flags & styleTags[i].flag)) {
                 styleTags[i].tagHandler(loader, node, value);
             }
-            if (importance) {
-                node->style->flagsImportance = (node->style->flags | styleTags[i].flag);
-                tvg::free(const_cast<char*>(value));
-            }
+            if (importance) node->style->flagsImportance = (node->style->flags | styleTags[i].flag);
             return true;
         }
     }
@@ -3036,7 +3039,8 @@ static SvgStyleGradient* _cloneGradient(SvgStyleGradient* from)
 }
 
 
-static void _styleInherit(SvgStyleProperty* child, const SvgStyleProperty* parent)
+//share: refer to the heap data of the parent rather than the copies, the parent must stay unchanged until the end
+static void _styleInherit(SvgStyleProperty* child, const SvgStyleProperty* parent, bool share)
 {
     if (parent == nullptr) return;
     //Inherit the property of parent if not present in child.
@@ -3053,8 +3057,9 @@ static void _styleInherit(SvgStyleProperty* child, const SvgStyleProperty* paren
         child->fill.paint.none = parent->fill.paint.none;
         child->fill.paint.curColor = parent->fill.paint.curColor;
         if (parent->fill.paint.url) {
-            tvg::free(child->fill.paint.url);
-            child->fill.paint.url = _copyId(parent->fill.paint.url);
+            if (!child->fill.paint.shared) tvg::free(child->fill.paint.url);
+            child->fill.paint.url = share ? parent->fill.paint.url : _copyId(parent->fill.paint.url);
+            child->fill.paint.shared = share;
         }
     }
     if (!(child->fill.flags & SvgFillFlags::Opacity)) {
@@ -3069,8 +3074,9 @@ static void _styleInherit(SvgStyleProperty* child, const SvgStyleProperty* paren
         child->stroke.paint.none = parent->stroke.paint.none;
         child->stroke.paint.curColor = parent->stroke.paint.curColor;
         if (parent->stroke.paint.url) {
-            tvg::free(child->stroke.paint.url);
-            child->stroke.paint.url = _copyId(parent->stroke.paint.url);
+            if (!child->stroke.paint.shared) tvg::free(child->stroke.paint.url);
+            child->stroke.paint.url = share ? parent->stroke.paint.url : _copyId(parent->stroke.paint.url);
+            child->stroke.paint.shared = share;
         }
     }
     if (!(child->stroke.flags & SvgStrokeFlags::Opacity)) {
@@ -3081,11 +3087,8 @@ static void _styleInherit(SvgStyleProperty* child, const SvgStyleProperty* paren
     }
     if (!(child->stroke.flags & SvgStrokeFlags::Dash)) {
         if (parent->stroke.dash.array.count > 0) {
-            child->stroke.dash.array.clear();
-            child->stroke.dash.array.reserve(parent->stroke.dash.array.count);
-            ARRAY_FOREACH(p, parent->stroke.dash.array) {
-                child->stroke.dash.array.push(*p);
-            }
+            if (share) child->stroke.dash.array.share(parent->stroke.dash.array);
+            else child->stroke.dash.array = parent->stroke.dash.array;
         }
     }
     if (!(child->stroke.flags & SvgStrokeFlags::DashOffset)) {
@@ -3127,8 +3130,9 @@ static void _styleCopy(SvgStyleProperty* to, const SvgStyleProperty* from)
         to->fill.paint.none = from->fill.paint.none;
         to->fill.paint.curColor = from->fill.paint.curColor;
         if (from->fill.paint.url) {
-            tvg::free(to->fill.paint.url);
+            if (!to->fill.paint.shared) tvg::free(to->fill.paint.url);
             to->fill.paint.url = _copyId(from->fill.paint.url);
+            to->fill.paint.shared = false;
         }
     }
     if (from->fill.flags & SvgFillFlags::Opacity) {
@@ -3144,8 +3148,9 @@ static void _styleCopy(SvgStyleProperty* to, const SvgStyleProperty* from)
         to->stroke.paint.none = from->stroke.paint.none;
         to->stroke.paint.curColor = from->stroke.paint.curColor;
         if (from->stroke.paint.url) {
-            tvg::free(to->stroke.paint.url);
+            if (!to->stroke.paint.shared) tvg::free(to->stroke.paint.url);
             to->stroke.paint.url = _copyId(from->stroke.paint.url);
+            to->stroke.paint.shared = false;
         }
     }
     if (from->stroke.flags & SvgStrokeFlags::Opacity) {
@@ -3295,7 +3300,7 @@ static void _cloneNode(SvgNode* from, SvgNode* parent, int depth)
     newNode = _createNode(parent, from->type);
     if (!newNode) return;
 
-    _styleInherit(newNode->style, parent->style);
+    _styleInherit(newNode->style, parent->style, false);
     _copyAttr(newNode, from);
 
     ARRAY_FOREACH(p, from->child) {
@@ -3496,6 +3501,14 @@ static void _svgLoaderParserText(SvgLoaderData* loader, const char* content, uns
 }
 
 
+//the node takes over the parsed name of the css selector rather than a copy of it
+static void _takeName(SvgNode* node, char** name)
+{
+    node->id = *name;
+    *name = nullptr;
+}
+
+
 static void _svgLoaderParserXmlCssStyle(SvgLoaderData* loader, const char* content, unsigned int length)
 {
     char* tag;
@@ -3509,15 +3522,15 @@ static void _svgLoaderParserXmlCssStyle(SvgLoaderData* loader, const char* conte
 
     while (auto next = xmlParseCSSAttribute(content, length, &tag, &name, &attrs, &attrsLength)) {
         if ((method = _findGroupFactory(tag))) {
-            if ((node = method(loader, loader->cssStyle, attrs, attrsLength, xmlParseW3CAttribute))) node->id = _copyId(name);
+            if ((node = method(loader, loader->cssStyle, attrs, attrsLength, xmlParseW3CAttribute))) _takeName(node, &name);
         } else if ((method = _findGraphicsFactory(tag))) {
-            if ((node = method(loader, loader->cssStyle, attrs, attrsLength, xmlParseW3CAttribute))) node->id = _copyId(name);
+            if ((node = method(loader, loader->cssStyle, attrs, attrsLength, xmlParseW3CAttribute))) _takeName(node, &name);
         } else if ((gradientMethod = _findGradientFactory(tag))) {
             TVGLOG("SVG", "Unsupported elements used in the internal CSS style sheets [Elements: %s]", tag);
         } else if (STR_AS(tag, "stop")) {
             TVGLOG("SVG", "Unsupported elements used in the internal CSS style sheets [Elements: %s]", tag);
         } else if (STR_AS(tag, "all")) {
-            if ((node = _createCssStyleNode(loader, loader->cssStyle, attrs, attrsLength, xmlParseW3CAttribute))) node->id = _copyId(name);
+            if ((node = _createCssStyleNode(loader, loader->cssStyle, attrs, attrsLength, xmlParseW3CAttribute))) _takeName(node, &name);
         } else if (STR_AS(tag, "@font-face")) { //css at-rule specifying font
             _createFontFace(loader, attrs, attrsLength, xmlParseW3CAttribute);
         } else if (!isIgnoreUnsupportedLogElements(tag)) {
@@ -3576,59 +3589,55 @@ static bool _svgLoaderParser(void* data, XMLType type, const char* content, unsi
 
 static void _updateStyle(SvgNode* node, SvgStyleProperty* parentStyle)
 {
-    _styleInherit(node->style, parentStyle);
+    _styleInherit(node->style, parentStyle, true);
     ARRAY_FOREACH(p, node->child) {
         _updateStyle(*p, node->style);
     }
 }
 
 
-static void _updateGradient(SvgLoaderData* loader, SvgNode* node, Array<SvgStyleGradient*>* gradients)
+//resolve the gradient of the id once, the nodes referring to it share the result. the resolved ones of the given gradients begin from the index.
+static SvgStyleGradient* _resolveGradient(SvgLoaderData* loader, Array<SvgStyleGradient*>* gradients, uint32_t begin, const char* id)
 {
-    auto duplicate = [&](SvgLoaderData* loader, Array<SvgStyleGradient*>* gradients, const char* id) -> SvgStyleGradient* {
-        SvgStyleGradient* result = nullptr;
+    for (auto p = loader->resolved.begin() + begin; p < loader->resolved.end(); ++p) {
+        if (STR_AS((*p)->id, id)) return *p;
+    }
+
+    SvgStyleGradient* result = nullptr;
 
+    ARRAY_FOREACH(p, *gradients) {
+        if ((*p)->id && STR_AS((*p)->id, id)) {
+            result = _cloneGradient(*p);
+            break;
+        }
+    }
+    if (!result) return nullptr;
+
+    if (result->ref) {
         ARRAY_FOREACH(p, *gradients) {
-            if ((*p)->id && STR_AS((*p)->id, id)) {
-                result = _cloneGradient(*p);
+            if ((*p)->id && STR_AS((*p)->id, result->ref)) {
+                _inheritGradient(loader, result, *p);
                 break;
             }
         }
-        if (result && result->ref) {
-            ARRAY_FOREACH(p, *gradients) {
-                if ((*p)->id && STR_AS((*p)->id, result->ref)) {
-                    _inheritGradient(loader, result, *p);
-                    break;
-                }
-            }
-        }
-        return result;
-    };
+    }
+    loader->resolved.push(result);
+    return result;
+}
 
+
+static void _updateGradient(SvgLoaderData* loader, SvgNode* node, Array<SvgStyleGradient*>* gradients, uint32_t begin)
+{
     if (node->child.count > 0) {
         ARRAY_FOREACH(p, node->child) {
-            _updateGradient(loader, *p, gradients);
+            _updateGradient(loader, *p, gradients, begin);
         }
     } else {
         if (node->style->fill.paint.url) {
-            auto newGrad = duplicate(loader, gradients, node->style->fill.paint.url);
-            if (newGrad) {
-                if (node->style->fill.paint.gradient) {
-                    node->style->fill.paint.gradient->clear();
-                    tvg::free(node->style->fill.paint.gradient);
-                }
-                node->style->fill.paint.gradient = newGrad;
-            }
+            if (auto grad = _resolveGradient(loader, gradients, begin, node->style->fill.paint.url)) node->style->fill.paint.gradient = grad;
         }
         if (node->style->stroke.paint.url) {
-            auto newGrad = duplicate(loader, gradients, node->style->stroke.paint.url);
-            if (newGrad) {
-                if (node->style->stroke.paint.gradient) {
-                    node->style->stroke.paint.gradient->clear();
-                    tvg::free(node->style->stroke.paint.gradient);
-                }
-                node->style->stroke.paint.gradient = newGrad;
-            }
+            if (auto grad = _resolveGradient(loader, gradients, begin, node->style->stroke.paint.url)) node->style->stroke.paint.gradient = grad;
         }
     }
 }
@@ -3673,16 +3682,9 @@ static void _freeNodeStyle(SvgStyleProperty* style)
     tvg::free(style->filter.url);
     tvg::free(style->cssClass);
 
-    if (style->fill.paint.gradient) {
-        style->fill.paint.gradient->clear();
-        tvg::free(style->fill.paint.gradient);
-    }
-    if (style->stroke.paint.gradient) {
-        style->stroke.paint.gradient->clear();
-        tvg::free(style->stroke.paint.gradient);
-    }
-    tvg::free(style->fill.paint.url);
-    tvg::free(style->stroke.paint.url);
+    //the gradients belong to the loader, the shared url to the parent
+    if (!style->fill.paint.shared) tvg::free(style->fill.paint.url);
+    if (!style->stroke.paint.shared) tvg::free(style->stroke.paint.url);
     style->stroke.dash.array.reset();
     tvg::free(style);
 }
@@ -3733,6 +3735,10 @@ static void _freeNode(SvgNode* node)
              tvg::free(node->node.text.fontFamily);
              break;
          }
+         case SvgNodeType::CssStyle: {
+             cssFreeIndex(node);
+             break;
+         }
          default: {
              break;
          }
@@ -3793,6 +3799,185 @@ static bool _svgLoaderParserForValidCheck(void* data, XMLType type, const char*
 }
 
 
+//the built scene of an svg document, duplicated by the next loads of the same document
+struct SvgShared
+{
+    INLIST_ITEM(SvgShared);
+
+    char* path = nullptr;           //the key of a file
+    char* data = nullptr;           //the key of a memory data
+    uint32_t size = 0;
+    Scene* scene = nullptr;         //the template scene, never handed over to the pictures
+    Array<char*> images;            //the embedded images referred by the scene
+    Array<FontFace> fonts;          //the embedded fonts used by the scene
+    Box vbox;
+    float w, h;
+    SvgViewFlag viewFlag;
+    AspectRatioAlign align;
+    AspectRatioMeetOrSlice meetOrSlice;
+    uint32_t footprint = 0;         //estimated memory usage of the template
+    uint32_t refCnt = 0;            //the loaders referring to the images and the fonts
+    bool cached = true;             //retained in the cache list
+};
+
+static Inlist<SvgShared> _shares;   //the least recently used first
+static uint32_t _budget = 0;        //disabled by default
+static uint32_t _usage = 0;
+static Key _key;
+
+
+//rough memory footprint of the paint tree
+static uint32_t _footprint(const Paint* paint)
+{
+    auto pimpl = PAINT(paint);
+    uint32_t size = 256;  //paint instance
+
+    if (paint->type() == tvg::Type::Shape) {
+        auto& path = CONST_SHAPE(paint)->rs.path;
+        size += path.pts.count * sizeof(Point) + path.cmds.count * sizeof(PathCommand);
+    }
+    if (pimpl->clipper) size += _footprint(pimpl->clipper);
+    if (pimpl->maskData) size += _footprint(pimpl->maskData->target);
+
+    if (auto it = pimpl->iterator()) {
+        while (auto child = it->next()) size += _footprint(child);
+        delete(it);
+    }
+    return size;
+}
+
+
+//the duplicates don't take over the ids, which are looked up by Picture::paint() and the Accessor
+static void _identify(const Paint* src, Paint* dst)
+{
+    dst->id = src->id;
+
+    auto sit = PAINT(src)->iterator();
+    auto dit = PAINT(dst)->iterator();
+    if (sit && dit) {
+        while (auto child = sit->next()) {
+            auto dup = dit->next();
+            if (!dup) break;
+            _identify(child, const_cast<Paint*>(dup));
+        }
+    }
+    delete(sit);
+    delete(dit);
+}
+
+
+static Scene* _duplicate(const Scene* scene)
+{
+    auto dup = static_cast<Scene*>(scene->duplicate());
+    _identify(scene, dup);
+    return dup;
+}
+
+
+static void _free(SvgShared* shared)
+{
+    ARRAY_FOREACH(p, shared->images) tvg::free(*p);
+    ARRAY_FOREACH(p, shared->fonts) {
+        Text::unload(p->name);
+        tvg::free(p->decoded);
+        tvg::free(p->name);
+    }
+    tvg::free(shared->path);
+    tvg::free(shared->data);
+    delete(shared);
+}
+
+
+//drop the least recently used documents over the budget, the loaders in use keep their resources
+static void _evict(uint32_t budget)
+{
+    while (_usage > budget && _shares.head) {
+        auto p = _shares.head;
+        _shares.remove(p);
+        _usage -= p->footprint;
+        delete(p->scene);
+        p->scene = nullptr;
+        p->cached = false;
+        if (p->refCnt == 0) _free(p);
+    }
+}
+
+
+//join the loads of the same document, which duplicate its built scene instead of parsing it again
+bool SvgLoader::share(const char* path, const char* data, uint32_t size)
+{
+    ScopedLock lock(_key);
+
+    if (_budget == 0) return false;
+
+    INLIST_FOREACH(_shares, p) {
+        if (path) {
+            if (!p->path || strcmp(p->path, path)) continue;
+        } else if (!p->data || p->size != size || memcmp(p->data, data, size)) continue;
+
+        root = _duplicate(p->scene);
+        vbox = p->vbox;
+        w = p->w;
+        h = p->h;
+        viewFlag = p->viewFlag;
+        align = p->align;
+        meetOrSlice = p->meetOrSlice;
+
+        ++p->refCnt;
+        shared = p;
+
+        //the most recently used one goes last
+        _shares.remove(p);
+        _shares.back(p);
+        return true;
+    }
+    return false;
+}
+
+
+//retain the built scene with the resources it refers to for the next loads
+void SvgLoader::publish()
+{
+    ScopedLock lock(_key);
+
+    if (_budget == 0 || !root || !content) return;
+
+    auto p = new SvgShared;
+    if (!svgPath.empty()) p->path = duplicate(svgPath.c_str());
+    else {
+        p->data = tvg::malloc<char*>(size);
+        memcpy(p->data, content, size);
+        p->size = size;
+    }
+    p->scene = _duplicate(root);
+    loaderData.images.move(p->images);
+    loaderData.fonts.move(p->fonts);
+    p->vbox = vbox;
+    p->w = w;
+    p->h = h;
+    p->viewFlag = viewFlag;
+    p->align = align;
+    p->meetOrSlice = meetOrSlice;
+    p->footprint = _footprint(p->scene) + size;
+    p->refCnt = 1;
+    shared = p;
+
+    _shares.back(p);
+    _usage += p->footprint;
+    _evict(_budget);
+}
+
+
+void SvgLoader::unshare()
+{
+    if (!shared) return;
+
+    ScopedLock lock(_key);
+    if (--shared->refCnt == 0 && !shared->cached) _free(shared);
+    shared = nullptr;
+}
+
+
 void SvgLoader::clear(bool all)
 {
     //flush out the intermediate data
@@ -3806,12 +3991,20 @@ void SvgLoader::clear(bool all)
     loaderData.gradients.reset();
     loaderData.gradientStack.reset();
 
+    ARRAY_FOREACH(p, loaderData.resolved) {
+        (*p)->clear();
+        tvg::free(*p);
+    }
+    loaderData.resolved.reset();
+
     _freeNode(loaderData.doc);
     loaderData.doc = nullptr;
     loaderData.stack.reset();
 
     if (!all) return;
 
+    unshare();
+
     ARRAY_FOREACH(p, loaderData.images) tvg::free(*p);
     loaderData.images.reset();
 
@@ -3823,6 +4016,7 @@ void SvgLoader::clear(bool all)
     loaderData.fonts.reset();
 
     if (copy) tvg::free((char*)content);
+    file.close();
 
     delete(root);
     root = nullptr;
@@ -3851,6 +4045,9 @@ SvgLoader::~SvgLoader()
 
 void SvgLoader::run(unsigned tid)
 {
+    TVG_TRACE("SvgLoader::run");
+    MemoryScope scope(MemoryCategory::Loader);
+
     //According to the SVG standard the value of the width/height of the viewbox set to 0 disables rendering
     if ((viewFlag & SvgViewFlag::Viewbox) && (fabsf(vbox.w) <= FLOAT_EPSILON || fabsf(vbox.h) <= FLOAT_EPSILON)) {
         TVGLOG("SVG", "The <viewBox> width and/or height set to 0 - rendering disabled.");
@@ -3858,7 +4055,10 @@ void SvgLoader::run(unsigned tid)
         return;
     }
 
-    if (!xmlParse(content, size, true, _svgLoaderParser, &(loaderData))) return;
+    {
+        TVG_TRACE("SvgLoader::parse");
+        if (!xmlParse(content, size, true, _svgLoaderParser, &(loaderData))) return;
+    }
 
     if (loaderData.doc) {
         auto defs = loaderData.doc->node.doc.defs;
@@ -3877,9 +4077,10 @@ void SvgLoader::run(unsigned tid)
         _updateStyle(loaderData.doc, nullptr);
         if (defs) _updateStyle(defs, nullptr);
 
-        if (loaderData.gradients.count > 0) _updateGradient(&loaderData, loaderData.doc, &loaderData.gradients);
-        if (defs) _updateGradient(&loaderData, loaderData.doc, &defs->node.defs.gradients);
+        if (loaderData.gradients.count > 0) _updateGradient(&loaderData, loaderData.doc, &loaderData.gradients, loaderData.resolved.count);
+        if (defs) _updateGradient(&loaderData, loaderData.doc, &defs->node.defs.gradients, loaderData.resolved.count);
 
+        TVG_TRACE("SvgLoader::build");
         root = svgSceneBuild(loaderData, vbox, w, h, align, meetOrSlice, svgPath, viewFlag);
 
         //In case no viewbox and width/height data is provided the completion of loading
@@ -3890,6 +4091,8 @@ void SvgLoader::run(unsigned tid)
             w = loaderData.doc->node.doc.w;
             h = loaderData.doc->node.doc.h;
         }
+
+        publish();
     }
 
     clear(false);
@@ -3904,6 +4107,7 @@ bool SvgLoader::header()
     loaderData.svgParse = tvg::malloc<SvgParser*>(sizeof(SvgParser));
     loaderData.svgParse->flags = SvgStopStyleFlags::StopDefault;
     viewFlag = SvgViewFlag::None;
+    deferrable = false;
 
     xmlParse(content, size, true, _svgLoaderParserForValidCheck, &(loaderData));
 
@@ -3937,6 +4141,8 @@ bool SvgLoader::header()
             }
             viewFlag = (viewFlag | SvgViewFlag::Height);
         }
+        //only the root attributes are parsed so far, the rest can wait for the first use
+        deferrable = true;
     //In case no viewbox and width/height data is provided the completion of loading
     //has to be forced, in order to establish this data based on the whole picture.
     } else {
@@ -3970,6 +4176,8 @@ bool SvgLoader::open(const char* data, uint32_t size, TVG_UNUSED const char* rpa
 {
     clear();
 
+    if (share(nullptr, data, size)) return true;
+
     if (copy) {
         content = tvg::malloc<char*>(size + 1);
         if (!content) return false;
@@ -3989,19 +4197,14 @@ bool SvgLoader::open(const char* path)
 #ifdef THORVG_FILE_IO_SUPPORT
     clear();
 
-    ifstream f;
-    f.open(path);
-
-    if (!f.is_open()) return false;
-
     svgPath = path;
-    getline(f, filePath, '\0');
-    f.close();
 
-    if (filePath.empty()) return false;
+    if (share(path, nullptr, 0)) return true;
 
-    content = (char*)filePath.c_str();
-    size = filePath.size();
+    if (!file.open(path, FileMap::Terminated)) return false;
+
+    content = (char*)file.data;
+    size = file.size;
 
     return header();
 #else
@@ -4025,12 +4228,17 @@ bool SvgLoader::resize(Paint* paint, float w, float h)
 
 bool SvgLoader::read()
 {
+    //the loading has been already completed in header() or by the cached document
+    if (root) {
+        readied = true;
+        return true;
+    }
+
     if (!content || size == 0) return false;
 
-    //the loading has been already completed in header()
-    if (root || !LoadModule::read()) return true;
+    if (!LoadModule::read()) return true;
 
-    TaskScheduler::request(this);
+    request(this);
 
     return true;
 }
@@ -4045,6 +4253,22 @@ bool SvgLoader::close()
 }
 
 
+void SvgLoader::cache(uint32_t budget)
+{
+    ScopedLock lock(_key);
+    _budget = budget;
+    _evict(budget);
+}
+
+
+//drop the retained documents, the budget stays for the next ones
+void SvgLoader::trim()
+{
+    ScopedLock lock(_key);
+    _evict(0);
+}
+
+
 Paint* SvgLoader::paint()
 {
     this->done();
@@ -23,19 +23,23 @@
 #ifndef _TVG_SVG_LOADER_H_
 #define _TVG_SVG_LOADER_H_
 
+#include "tvgFile.h"
 #include "tvgTaskScheduler.h"
 #include "tvgSvgLoaderCommon.h"
 
+struct SvgShared;
+
 class SvgLoader : public ImageLoader, public Task
 {
 public:
-    string filePath;
+    FileMap file;
     string svgPath = "";
     char* content = nullptr;
     uint32_t size = 0;
 
     SvgLoaderData loaderData;
     Scene* root = nullptr;
+    SvgShared* shared = nullptr;    //the cached document of this loader, see cache()
 
     bool copy = false;
 
@@ -50,6 +54,9 @@ public:
 
     Paint* paint() override;
 
+    static void cache(uint32_t budget);
+    static void trim();
+
 private:
     SvgViewFlag viewFlag = SvgViewFlag::None;
     AspectRatioAlign align = AspectRatioAlign::XMidYMid;
@@ -57,6 +64,9 @@ private:
     Box vbox{};
 
     bool header();
+    bool share(const char* path, const char* data, uint32_t size);
+    void publish();
+    void unshare();
     void clear(bool all = true);
     void run(unsigned tid) override;
 };
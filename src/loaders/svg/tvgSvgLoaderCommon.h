@@ -375,8 +375,11 @@ struct SvgMaskNode
     bool userSpace;
 };
 
+struct SvgCssIndex;
+
 struct SvgCssStyleNode
 {
+    SvgCssIndex* index;    //the rules hashed by the selector, see cssFindStyleNode()
 };
 
 struct SvgTextNode
@@ -433,11 +436,12 @@ struct SvgComposite
 
 struct SvgPaint
 {
-    SvgStyleGradient* gradient;
+    SvgStyleGradient* gradient;   //resolved by the url, shared among the nodes. see SvgLoaderData::resolved
     char *url;
     SvgColor color;
     bool none;
     bool curColor;
+    bool shared;                  //the url is shared with the parent's
 };
 
 struct SvgDash
@@ -592,6 +596,7 @@ struct SvgLoaderData
     SvgNode* cssStyle = nullptr;
     Array<SvgStyleGradient*> gradients;
     Array<SvgStyleGradient*> gradientStack; //For stops
+    Array<SvgStyleGradient*> resolved;      //the gradients resolved by the urls, the nodes refer to them
     SvgParser* svgParse = nullptr;
     Inlist<SvgNodeIdPair> cloneNodes;
     Array<SvgNodeIdPair> nodesToStyle;
@@ -27,6 +27,7 @@
 #include "tvgMath.h"
 #include "tvgSvgLoaderCommon.h"
 #include "tvgSvgPath.h"
+#include "tvgSvgUtil.h"
 #include "tvgStr.h"
 
 /************************************************************************/
@@ -46,7 +47,7 @@ static char* _skipComma(const char* content)
 static bool _parseNumber(char** content, float* number)
 {
     char* end = NULL;
-    *number = toFloat(*content, &end);
+    *number = svgUtilToFloat(*content, &end);
     //If the start of string is not number
     if ((*content) == end) return false;
     //Skip comma if any
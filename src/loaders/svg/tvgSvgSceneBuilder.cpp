@@ -24,8 +24,10 @@
 #include "tvgShape.h"
 #include "tvgCompressor.h"
 #include "tvgFill.h"
+#include "tvgPicture.h"
 #include "tvgStr.h"
 #include "tvgShape.h"
+#include "tvgTaskScheduler.h"
 #include "tvgSvgLoaderCommon.h"
 #include "tvgSvgSceneBuilder.h"
 #include "tvgSvgPath.h"
@@ -35,6 +37,9 @@
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
+#define PARALLEL_BUILD_MIN 64    //the minimum number of the independent children to build them in parallel
+#define PARALLEL_BUILD_DEPTH 2   //fork only the upper levels, the workers are busy enough below
+
 static bool _appendClipShape(SvgLoaderData& loaderData, SvgNode* node, Shape* shape, const Box& vBox, const string& svgPath, const Matrix* transform);
 static Scene* _sceneBuildHelper(SvgLoaderData& loaderData, const SvgNode* node, const Box& vBox, const string& svgPath, bool mask, int depth);
 
@@ -68,7 +73,8 @@ static void _transformMultiply(const Matrix* mBBox, Matrix* gradTransf)
 }
 
 
-static LinearGradient* _applyLinearGradientProperty(SvgStyleGradient* g, const Box& vBox, int opacity)
+//the gradient is shared among the nodes, it stays as it is
+static LinearGradient* _applyLinearGradientProperty(const SvgStyleGradient* g, const Box& vBox, int opacity)
 {
     Fill::ColorStop* stops;
     auto fillGrad = LinearGradient::gen();
@@ -76,18 +82,19 @@ static LinearGradient* _applyLinearGradientProperty(SvgStyleGradient* g, const B
     auto& finalTransform = fillGrad->transform();
     if (isTransform) finalTransform = *g->transform;
 
+    auto linear = *g->linear;
     if (g->userSpace) {
-        g->linear->x1 = g->linear->x1 * vBox.w;
-        g->linear->y1 = g->linear->y1 * vBox.h;
-        g->linear->x2 = g->linear->x2 * vBox.w;
-        g->linear->y2 = g->linear->y2 * vBox.h;
+        linear.x1 = linear.x1 * vBox.w;
+        linear.y1 = linear.y1 * vBox.h;
+        linear.x2 = linear.x2 * vBox.w;
+        linear.y2 = linear.y2 * vBox.h;
     } else {
         Matrix m = {vBox.w, 0, vBox.x, 0, vBox.h, vBox.y, 0, 0, 1};
         if (isTransform) _transformMultiply(&m, &finalTransform);
         else finalTransform = m;
     }
 
-    fillGrad->linear(g->linear->x1, g->linear->y1, g->linear->x2, g->linear->y2);
+    fillGrad->linear(linear.x1, linear.y1, linear.x2, linear.y2);
     fillGrad->spread(g->spread);
 
     //Update the stops
@@ -114,7 +121,7 @@ static LinearGradient* _applyLinearGradientProperty(SvgStyleGradient* g, const B
 }
 
 
-static RadialGradient* _applyRadialGradientProperty(SvgStyleGradient* g, const Box& vBox, int opacity)
+static RadialGradient* _applyRadialGradientProperty(const SvgStyleGradient* g, const Box& vBox, int opacity)
 {
     Fill::ColorStop *stops;
     auto fillGrad = RadialGradient::gen();
@@ -122,22 +129,23 @@ static RadialGradient* _applyRadialGradientProperty(SvgStyleGradient* g, const B
     auto& finalTransform = fillGrad->transform();
     if (isTransform) finalTransform = *g->transform;
 
+    auto radial = *g->radial;
     if (g->userSpace) {
         //The radius scaling is done according to the Units section:
         //https://www.w3.org/TR/2015/WD-SVG2-20150915/coords.html
-        g->radial->cx = g->radial->cx * vBox.w;
-        g->radial->cy = g->radial->cy * vBox.h;
-        g->radial->r = g->radial->r * sqrtf(powf(vBox.w, 2.0f) + powf(vBox.h, 2.0f)) / sqrtf(2.0f);
-        g->radial->fx = g->radial->fx * vBox.w;
-        g->radial->fy = g->radial->fy * vBox.h;
-        g->radial->fr = g->radial->fr * sqrtf(powf(vBox.w, 2.0f) + powf(vBox.h, 2.0f)) / sqrtf(2.0f);
+        radial.cx = radial.cx * vBox.w;
+        radial.cy = radial.cy * vBox.h;
+        radial.r = radial.r * sqrtf(powf(vBox.w, 2.0f) + powf(vBox.h, 2.0f)) / sqrtf(2.0f);
+        radial.fx = radial.fx * vBox.w;
+        radial.fy = radial.fy * vBox.h;
+        radial.fr = radial.fr * sqrtf(powf(vBox.w, 2.0f) + powf(vBox.h, 2.0f)) / sqrtf(2.0f);
     } else {
         Matrix m = {vBox.w, 0, vBox.x, 0, vBox.h, vBox.y, 0, 0, 1};
         if (isTransform) _transformMultiply(&m, &finalTransform);
         else finalTransform = m;
     }
 
-    fillGrad->radial(g->radial->cx, g->radial->cy, g->radial->r, g->radial->fx, g->radial->fy, g->radial->fr);
+    fillGrad->radial(radial.cx, radial.cy, radial.r, radial.fx, radial.fy, radial.fr);
     fillGrad->spread(g->spread);
 
     //Update the stops
@@ -637,6 +645,8 @@ static Paint* _imageBuildHelper(SvgLoaderData& loaderData, SvgNode* node, const
         imageMimeTypeEncoding encoding;
         if (!_isValidImageMimeTypeAndEncoding(&href, &mimetype, &encoding)) return nullptr; //not allowed mime type or encoding
         char *decoded = nullptr;
+        //the embedded images might be never drawn, decode them on demand
+        PICTURE(picture)->lazy = true;
         if (encoding == imageMimeTypeEncoding::base64) {
             auto size = b64Decode(href, strlen(href), &decoded);
             if (picture->load(decoded, size, mimetype) != Result::Success) {
@@ -886,6 +896,118 @@ static Paint* _textBuildHelper(SvgLoaderData& loaderData, const SvgNode* node, c
 }
 
 
+static Paint* _childBuildHelper(SvgLoaderData& loaderData, const SvgNode* node, SvgNode* child, const Box& vBox, const string& svgPath, int depth)
+{
+    if (_isGroupType(child->type)) {
+        if (child->type == SvgNodeType::Use) return _useBuildHelper(loaderData, child, vBox, svgPath, depth + 1);
+        if (!(child->type == SvgNodeType::Symbol && node->type != SvgNodeType::Use)) return _sceneBuildHelper(loaderData, child, vBox, svgPath, false, depth + 1);
+        return nullptr;
+    }
+
+    Paint* paint = nullptr;
+    if (child->type == SvgNodeType::Image) paint = _imageBuildHelper(loaderData, child, vBox, svgPath);
+    else if (child->type == SvgNodeType::Text) paint = _textBuildHelper(loaderData, child, vBox, svgPath);
+    else if (child->type != SvgNodeType::Mask) paint = _shapeBuildHelper(loaderData, child, vBox, svgPath);
+    if (paint && child->id) paint->id = djb2Encode(child->id);
+    return paint;
+}
+
+
+/* A subtree is built independently if it doesn't touch the shared states while building:
+   the compositions flag their referred nodes, the images and the texts register the loader resources
+   and the use elements refer to the other subtrees. */
+static bool _independent(const SvgNode* node)
+{
+    if (node->type == SvgNodeType::Image || node->type == SvgNodeType::Text || node->type == SvgNodeType::Use) return false;
+    if (node->style && (node->style->clipPath.node || node->style->mask.node)) return false;
+
+    ARRAY_FOREACH(p, node->child) {
+        if (!_independent(*p)) return false;
+    }
+    return true;
+}
+
+
+struct SvgBuildTask : Task
+{
+    SvgLoaderData* loaderData;
+    const SvgNode* node;
+    const Box* vBox;
+    const string* svgPath;
+    const bool* independents;
+    Paint** paints;
+    uint32_t bin, bins;
+    int depth;
+
+    void run(TVG_UNUSED unsigned tid) override
+    {
+        //the independent children are dealt out to the bins in turn
+        uint32_t idx = 0;
+        for (uint32_t i = 0; i < node->child.count; ++i) {
+            if (!independents[i]) continue;
+            if (idx++ % bins == bin) paints[i] = _childBuildHelper(*loaderData, node, node->child[i], *vBox, *svgPath, depth);
+        }
+    }
+};
+
+
+//build the children over the workers, returns false if it's not worth it
+static bool _parallelBuildHelper(SvgLoaderData& loaderData, const SvgNode* node, Scene* scene, const Box& vBox, const string& svgPath, int depth)
+{
+    if (depth > PARALLEL_BUILD_DEPTH || node->child.count < PARALLEL_BUILD_MIN || TaskScheduler::threads() == 0) return false;
+
+    auto independents = tvg::malloc<bool*>(node->child.count * sizeof(bool));
+    uint32_t cnt = 0;
+    for (uint32_t i = 0; i < node->child.count; ++i) {
+        independents[i] = _independent(node->child[i]);
+        if (independents[i]) ++cnt;
+    }
+
+    if (cnt < PARALLEL_BUILD_MIN) {
+        tvg::free(independents);
+        return false;
+    }
+
+    auto paints = tvg::calloc<Paint**>(node->child.count, sizeof(Paint*));
+    auto bins = TaskScheduler::threads() + 1;
+    auto tasks = new SvgBuildTask[bins];
+
+    //fork the independent children, the current thread takes the first bin with the others
+    TaskGroup group;
+    for (uint32_t i = 0; i < bins; ++i) {
+        tasks[i].loaderData = &loaderData;
+        tasks[i].node = node;
+        tasks[i].vBox = &vBox;
+        tasks[i].svgPath = &svgPath;
+        tasks[i].independents = independents;
+        tasks[i].paints = paints;
+        tasks[i].bin = i;
+        tasks[i].bins = bins;
+        tasks[i].depth = depth;
+        if (i > 0) group.request(&tasks[i]);
+    }
+
+    for (uint32_t i = 0; i < node->child.count; ++i) {
+        if (!independents[i]) paints[i] = _childBuildHelper(loaderData, node, node->child[i], vBox, svgPath, depth);
+    }
+    tasks[0].run(0);
+    group.wait();
+
+    //merge in the document order
+    for (uint32_t i = 0; i < node->child.count; ++i) {
+        auto child = node->child[i];
+        if (paints[i]) scene->push(paints[i]);
+        if (_isGroupType(child->type) && child->id) scene->id = djb2Encode(child->id);
+    }
+
+    delete[] tasks;
+    tvg::free(paints);
+    tvg::free(independents);
+
+    return true;
+}
+
+
 static Scene* _sceneBuildHelper(SvgLoaderData& loaderData, const SvgNode* node, const Box& vBox, const string& svgPath, bool mask, int depth)
 {
     /* Exception handling: Prevent invalid SVG data input.
@@ -905,23 +1027,11 @@ static Scene* _sceneBuildHelper(SvgLoaderData& loaderData, const SvgNode* node,
 
     if (!node->style->display || node->style->opacity == 0) return scene;
 
-    ARRAY_FOREACH(p, node->child) {
-        auto child = *p;
-        if (_isGroupType(child->type)) {
-            if (child->type == SvgNodeType::Use)
-                scene->push(_useBuildHelper(loaderData, child, vBox, svgPath, depth + 1));
-            else if (!(child->type == SvgNodeType::Symbol && node->type != SvgNodeType::Use))
-                scene->push(_sceneBuildHelper(loaderData, child, vBox, svgPath, false, depth + 1));
-            if (child->id) scene->id = djb2Encode(child->id);
-        } else {
-            Paint* paint = nullptr;
-            if (child->type == SvgNodeType::Image) paint = _imageBuildHelper(loaderData, child, vBox, svgPath);
-            else if (child->type == SvgNodeType::Text) paint = _textBuildHelper(loaderData, child, vBox, svgPath);
-            else if (child->type != SvgNodeType::Mask) paint = _shapeBuildHelper(loaderData, child, vBox, svgPath);
-            if (paint) {
-                if (child->id) paint->id = djb2Encode(child->id);
-                scene->push(paint);
-            }
+    if (mask || !_parallelBuildHelper(loaderData, node, scene, vBox, svgPath, depth)) {
+        ARRAY_FOREACH(p, node->child) {
+            auto child = *p;
+            if (auto paint = _childBuildHelper(loaderData, node, child, vBox, svgPath, depth)) scene->push(paint);
+            if (_isGroupType(child->type) && child->id) scene->id = djb2Encode(child->id);
         }
     }
     scene->opacity(node->style->opacity);
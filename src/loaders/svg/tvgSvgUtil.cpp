@@ -20,6 +20,7 @@
  * SOFTWARE.
  */
 
+#include <cmath>
 #include "tvgSvgUtil.h"
 
 /************************************************************************/
@@ -34,6 +35,19 @@ static uint8_t _hexCharToDec(const char c)
 }
 
 
+//the powers of ten exactly representable in double
+static const double _pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+
+static inline bool _digit(char c)
+{
+    return (unsigned char)(c - '0') < 10;
+}
+
+
 /************************************************************************/
 /* External Class Implementation                                        */
 /************************************************************************/
@@ -68,3 +82,84 @@ size_t svgUtilURLDecode(const char *src, char** dst)
     return idx + 1;
 }
 
+
+
+/*
+ * A locale free number parser for the svg number grammar (no inf/nan, no units).
+ * The significant digits are accumulated into an integer and scaled once by an exact power of ten,
+ * which is correctly rounded for up to 15 digits and |exponent| <= 22 (Clinger's fast path).
+ */
+float svgUtilToFloat(const char* str, char** end)
+{
+    auto p = str;
+    auto minus = false;
+
+    while (isspace((unsigned char)*p)) ++p;
+
+    if (*p == '-') {
+        minus = true;
+        ++p;
+    } else if (*p == '+') ++p;
+
+    uint64_t mantissa = 0;
+    int digits = 0;     //significant digits in the mantissa
+    int exponent = 0;
+    auto begin = p;
+
+    for (; _digit(*p); ++p) {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa > 0) ++digits;
+        } else ++exponent;
+    }
+    auto valid = (p > begin);
+
+    if (*p == '.') {
+        auto frac = ++p;
+        for (; _digit(*p); ++p) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa > 0) ++digits;
+                --exponent;
+            }
+        }
+        if (p > frac) valid = true;
+    }
+
+    if (!valid) {
+        if (end) *end = (char*)str;
+        return 0.0f;
+    }
+
+    //Optional: exponent, not consumed without any digit (ex: "1e" or "5em")
+    if (*p == 'e' || *p == 'E') {
+        auto q = p + 1;
+        auto minusE = false;
+        if (*q == '-') {
+            minusE = true;
+            ++q;
+        } else if (*q == '+') ++q;
+
+        if (_digit(*q)) {
+            int e = 0;
+            for (; _digit(*q); ++q) {
+                if (e < 10000) e = e * 10 + (*q - '0');
+            }
+            exponent += minusE ? -e : e;
+            p = q;
+        }
+    }
+
+    if (end) *end = (char*)p;
+
+    double val = (double)mantissa;
+    if (mantissa > 0) {
+        if (mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+            val = (exponent < 0) ? (val / _pow10[-exponent]) : (val * _pow10[exponent]);
+        } else val *= pow(10.0, exponent);
+    }
+
+    auto ret = static_cast<float>(minus ? -val : val);
+    if (!std::isfinite(ret)) return 0.0f;
+    return ret;
+}
@@ -26,5 +26,6 @@
 #include "tvgCommon.h"
 
 size_t svgUtilURLDecode(const char *src, char** dst);
+float svgUtilToFloat(const char* str, char** end);
 
 #endif //_TVG_SVG_UTIL_H_
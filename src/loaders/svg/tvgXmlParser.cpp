@@ -24,6 +24,14 @@
 #include "tvgStr.h"
 #include "tvgXmlParser.h"
 
+#if defined(THORVG_AVX_VECTOR_SUPPORT) && (defined(__SSE2__) || defined(_M_X64))
+    #include <emmintrin.h>
+    #define XML_SSE2 1
+#elif defined(THORVG_NEON_VECTOR_SUPPORT)
+    #include <arm_neon.h>
+    #define XML_NEON 1
+#endif
+
 
 /************************************************************************/
 /* Internal Class Implementation                                        */
@@ -59,15 +67,113 @@ bool _unsupported(TVG_UNUSED const char* tagAttribute, TVG_UNUSED const char* ta
 }
 
 
-static const char* _xmlFindWhiteSpace(const char* itr, const char* itrEnd)
+static inline int _ctz(uint32_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    int n = 0;
+    while (!(mask & 1)) { mask >>= 1; ++n; }
+    return n;
+#endif
+}
+
+
+#ifdef XML_SSE2
+
+//the positions of the bytes equal to any of the four characters in the 16 bytes block
+static inline uint32_t _xmlMatch(const char* itr, char c0, char c1, char c2, char c3)
+{
+    auto v = _mm_loadu_si128((const __m128i*)itr);
+    auto m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(c0)), _mm_cmpeq_epi8(v, _mm_set1_epi8(c1))),
+                          _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(c2)), _mm_cmpeq_epi8(v, _mm_set1_epi8(c3))));
+    return (uint32_t)_mm_movemask_epi8(m);
+}
+
+
+//the positions of the white spaces (' ', \t, \n, \v, \f, \r) or the given character in the 16 bytes block
+static inline uint32_t _xmlMatchSpace(const char* itr, char c)
+{
+    auto v = _mm_loadu_si128((const __m128i*)itr);
+    auto d = _mm_sub_epi8(v, _mm_set1_epi8('\t'));
+    auto ctrl = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(4)), d);
+    auto m = _mm_or_si128(ctrl, _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8(c))));
+    return (uint32_t)_mm_movemask_epi8(m);
+}
+
+#elif defined(XML_NEON)
+
+//narrow the byte mask to 4 bits per byte, the position is the count of the trailing zeros divided by 4
+static inline uint64_t _xmlMask(uint8x16_t m)
+{
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+}
+
+
+static inline uint64_t _xmlMatch(const char* itr, char c0, char c1, char c2, char c3)
+{
+    auto v = vld1q_u8((const uint8_t*)itr);
+    auto m = vorrq_u8(vorrq_u8(vceqq_u8(v, vdupq_n_u8(c0)), vceqq_u8(v, vdupq_n_u8(c1))),
+                      vorrq_u8(vceqq_u8(v, vdupq_n_u8(c2)), vceqq_u8(v, vdupq_n_u8(c3))));
+    return _xmlMask(m);
+}
+
+
+static inline uint64_t _xmlMatchSpace(const char* itr, char c)
+{
+    auto v = vld1q_u8((const uint8_t*)itr);
+    auto ctrl = vcleq_u8(vsubq_u8(v, vdupq_n_u8('\t')), vdupq_n_u8(4));
+    auto m = vorrq_u8(ctrl, vorrq_u8(vceqq_u8(v, vdupq_n_u8(' ')), vceqq_u8(v, vdupq_n_u8(c))));
+    return _xmlMask(m);
+}
+
+#endif
+
+
+//find the first one of the four structural characters, 16 bytes at once if the simd is available
+static const char* _xmlFind(const char* itr, const char* itrEnd, char c0, char c1, char c2, char c3)
+{
+#if defined(XML_SSE2)
+    for (; itr + 16 <= itrEnd; itr += 16) {
+        if (auto mask = _xmlMatch(itr, c0, c1, c2, c3)) return itr + _ctz(mask);
+    }
+#elif defined(XML_NEON)
+    for (; itr + 16 <= itrEnd; itr += 16) {
+        if (auto mask = _xmlMatch(itr, c0, c1, c2, c3)) return itr + (__builtin_ctzll(mask) >> 2);
+    }
+#endif
+    for (; itr < itrEnd; itr++) {
+        if (*itr == c0 || *itr == c1 || *itr == c2 || *itr == c3) break;
+    }
+    return itr;
+}
+
+
+//find the first white space or the given character
+static const char* _xmlFindSpace(const char* itr, const char* itrEnd, char c)
 {
+#if defined(XML_SSE2)
+    for (; itr + 16 <= itrEnd; itr += 16) {
+        if (auto mask = _xmlMatchSpace(itr, c)) return itr + _ctz(mask);
+    }
+#elif defined(XML_NEON)
+    for (; itr + 16 <= itrEnd; itr += 16) {
+        if (auto mask = _xmlMatchSpace(itr, c)) return itr + (__builtin_ctzll(mask) >> 2);
+    }
+#endif
     for (; itr < itrEnd; itr++) {
-        if (isspace((unsigned char)*itr)) break;
+        if (*itr == c || isspace((unsigned char)*itr)) break;
     }
     return itr;
 }
 
 
+static const char* _xmlFindWhiteSpace(const char* itr, const char* itrEnd)
+{
+    return _xmlFindSpace(itr, itrEnd, ' ');
+}
+
+
 static const char* _xmlSkipWhiteSpace(const char* itr, const char* itrEnd)
 {
     for (; itr < itrEnd; itr++) {
@@ -157,43 +263,47 @@ static const char* _xmlFindStartTag(const char* itr, const char* itrEnd)
 
 static const char* _xmlFindEndTag(const char* itr, const char* itrEnd)
 {
-    bool insideQuote[2] = {false, false}; // 0: ", 1: '
     for (; itr < itrEnd; itr++) {
-        if (*itr == '"' && !insideQuote[1]) insideQuote[0] = !insideQuote[0];
-        if (*itr == '\'' && !insideQuote[0]) insideQuote[1] = !insideQuote[1];
-        if (!insideQuote[0] && !insideQuote[1]) {
-            if ((*itr == '>') || (*itr == '<'))
-                return itr;
-        }
+        itr = _xmlFind(itr, itrEnd, '"', '\'', '<', '>');
+        if (itr == itrEnd) break;
+        if ((*itr == '>') || (*itr == '<')) return itr;
+        //skip the quoted value, the other quote and the brackets inside are not structural
+        itr = (const char*)memchr(itr + 1, *itr, itrEnd - itr - 1);
+        if (!itr) break;
     }
     return nullptr;
 }
 
 
-static const char* _xmlFindEndCommentTag(const char* itr, const char* itrEnd)
+//find the given 3 characters terminator, returns its last character
+static const char* _xmlFindTerminator(const char* itr, const char* itrEnd, const char* term)
 {
-    for (; itr < itrEnd; itr++) {
-        if ((*itr == '-') && ((itr + 1 < itrEnd) && (*(itr + 1) == '-')) && ((itr + 2 < itrEnd) && (*(itr + 2) == '>'))) return itr + 2;
+    while (itr + 2 < itrEnd) {
+        itr = (const char*)memchr(itr, term[0], itrEnd - itr - 2);
+        if (!itr) break;
+        if (itr[1] == term[1] && itr[2] == term[2]) return itr + 2;
+        ++itr;
     }
     return nullptr;
 }
 
 
+static const char* _xmlFindEndCommentTag(const char* itr, const char* itrEnd)
+{
+    return _xmlFindTerminator(itr, itrEnd, "-->");
+}
+
+
 static const char* _xmlFindEndCdataTag(const char* itr, const char* itrEnd)
 {
-    for (; itr < itrEnd; itr++) {
-        if ((*itr == ']') && ((itr + 1 < itrEnd) && (*(itr + 1) == ']')) && ((itr + 2 < itrEnd) && (*(itr + 2) == '>'))) return itr + 2;
-    }
-    return nullptr;
+    return _xmlFindTerminator(itr, itrEnd, "]]>");
 }
 
 
 static const char* _xmlFindDoctypeChildEndTag(const char* itr, const char* itrEnd)
 {
-    for (; itr < itrEnd; itr++) {
-        if (*itr == '>') return itr;
-    }
-    return nullptr;
+    if (itr >= itrEnd) return nullptr;
+    return (const char*)memchr(itr, '>', itrEnd - itr);
 }
 
 
@@ -286,7 +396,10 @@ bool isIgnoreUnsupportedLogElements(TVG_UNUSED const char* tagName)
 bool xmlParseAttributes(const char* buf, unsigned bufLength, xmlAttributeCb func, const void* data)
 {
     const char *itr = buf, *itrEnd = buf + bufLength;
-    char* tmpBuf = tvg::malloc<char*>(bufLength + 1);
+
+    //the key/value pairs are terminated in this buffer, the long ones such as the path data only go to the heap
+    char stackBuf[512];
+    char* tmpBuf = (bufLength < sizeof(stackBuf)) ? stackBuf : tvg::malloc<char*>(bufLength + 1);
 
     if (!buf || !func || !tmpBuf) goto error;
 
@@ -298,9 +411,7 @@ bool xmlParseAttributes(const char* buf, unsigned bufLength, xmlAttributeCb func
         if (p == itrEnd) goto success;
 
         key = p;
-        for (keyEnd = key; keyEnd < itrEnd; keyEnd++) {
-            if ((*keyEnd == '=') || (isspace((unsigned char)*keyEnd))) break;
-        }
+        keyEnd = _xmlFindSpace(key, itrEnd, '=');
         if (keyEnd == itrEnd) goto error;
         if (keyEnd == key) {  // There is no key. This case is invalid, but explores the following syntax.
             itr = keyEnd + 1;
@@ -351,11 +462,11 @@ bool xmlParseAttributes(const char* buf, unsigned bufLength, xmlAttributeCb func
     }
 
 success:
-    tvg::free(tmpBuf);
+    if (tmpBuf != stackBuf) tvg::free(tmpBuf);
     return true;
 
 error:
-    tvg::free(tmpBuf);
+    if (tmpBuf != stackBuf) tvg::free(tmpBuf);
     return false;
 }
 
@@ -21,146 +21,15 @@
  */
 
 
+#include <atomic>
 #include "tvgStr.h"
+#include "tvgShape.h"
 #include "tvgTtfLoader.h"
 
-#if defined(_WIN32) && (WINAPI_FAMILY == WINAPI_FAMILY_DESKTOP_APP)
-    #include <windows.h>
-#elif defined(__linux__)
-    #include <fcntl.h>
-    #include <unistd.h>
-    #include <sys/mman.h>
-    #include <sys/stat.h>
-#endif
-
 /************************************************************************/
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
-#ifdef THORVG_FILE_IO_SUPPORT
-
-#if defined(_WIN32) && (WINAPI_FAMILY == WINAPI_FAMILY_DESKTOP_APP)
-
-static bool _map(TtfLoader* loader, const string& path)
-{
-    auto& reader = loader->reader;
-
-	auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
-	if (file == INVALID_HANDLE_VALUE) return false;
-
-	DWORD high;
-	auto low = GetFileSize(file, &high);
-	if (low == INVALID_FILE_SIZE) {
-		CloseHandle(file);
-		return false;
-	}
-
-	reader.size = (uint32_t)((size_t)high << (8 * sizeof(DWORD)) | low);
-
-	loader->mapping = (uint8_t*)CreateFileMapping(file, NULL, PAGE_READONLY, high, low, NULL);
-
-	CloseHandle(file);
-
-	if (!loader->mapping) return false;
-
-	loader->reader.data = (uint8_t*) MapViewOfFile(loader->mapping, FILE_MAP_READ, 0, 0, 0);
-	if (!loader->reader.data) {
-		CloseHandle(loader->mapping);
-		loader->mapping = nullptr;
-		return false;
-	}
-	return true;
-}
-
-static void _unmap(TtfLoader* loader)
-{
-    auto& reader = loader->reader;
-
-	if (reader.data) {
-		UnmapViewOfFile(reader.data);
-		reader.data = nullptr;
-	}
-	if (loader->mapping) {
-		CloseHandle(loader->mapping);
-		loader->mapping = nullptr;
-	}
-}
-
-#elif defined(__linux__)
-
-static bool _map(TtfLoader* loader, const char* path)
-{
-    auto& reader = loader->reader;
-
-    auto fd = open(path, O_RDONLY);
-    if (fd < 0) return false;
-
-    struct stat info;
-    if (fstat(fd, &info) < 0) {
-        close(fd);
-        return false;
-    }
-
-    reader.data = (uint8_t*)mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
-    if (reader.data == (uint8_t*)-1) return false;
-    reader.size = (uint32_t) info.st_size;
-    close(fd);
-
-    return true;
-}
-
-
-static void _unmap(TtfLoader* loader)
-{
-    auto& reader = loader->reader;
-    if (reader.data == (uint8_t*) -1) return;
-    munmap((void *) reader.data, reader.size);
-    reader.data = (uint8_t*)-1;
-    reader.size = 0;
-}
-#else
-static bool _map(TtfLoader* loader, const char* path)
-{
-    auto& reader = loader->reader;
-
-    auto f = fopen(path, "rb");
-    if (!f) return false;
-
-    fseek(f, 0, SEEK_END);
-
-    reader.size = ftell(f);
-    if (reader.size == 0) {
-        fclose(f);
-        return false;
-    }
-
-    reader.data = tvg::malloc<uint8_t*>(reader.size);
-
-    fseek(f, 0, SEEK_SET);
-    auto ret = fread(reader.data, sizeof(char), reader.size, f);
-    if (ret < reader.size) {
-        fclose(f);
-        return false;
-    }
-
-    fclose(f);
-
-    return true;
-}
-
-
-static void _unmap(TtfLoader* loader)
-{
-    auto& reader = loader->reader;
-    tvg::free(reader.data);
-    reader.data = nullptr;
-    reader.size = 0;
-}
-#endif
-
-#endif //THORVG_FILE_IO_SUPPORT
-
-
 static uint32_t* _codepoints(const char* text, size_t n)
 {
     uint32_t c;
@@ -196,6 +65,78 @@ static uint32_t* _codepoints(const char* text, size_t n)
 }
 
 
+static atomic<uint32_t> glyphUids{0};
+
+
+static inline uint32_t _hash(uint32_t idx)
+{
+    return idx * 0x9e3779b1u;
+}
+
+
+//append the cached glyph outline moved to its place in the text
+static void _append(RenderPath& out, const RenderPath& in, const Point& offset)
+{
+    out.cmds.push(in.cmds);
+    out.pts.grow(in.pts.count);
+    auto dst = out.pts.end();
+    for (auto p = in.pts.begin(); p < in.pts.end(); ++p, ++dst) {
+        *dst = *p + offset;
+    }
+    out.pts.count += in.pts.count;
+}
+
+
+TtfGlyphCache::~TtfGlyphCache()
+{
+    clear();
+}
+
+
+TtfGlyph* TtfGlyphCache::find(uint32_t idx) const
+{
+    if (count == 0) return nullptr;
+    for (auto i = _hash(idx) & (capacity - 1); slots[i]; i = (i + 1) & (capacity - 1)) {
+        if (slots[i]->idx == idx) return slots[i];
+    }
+    return nullptr;
+}
+
+
+void TtfGlyphCache::insert(TtfGlyph* glyph)
+{
+    if ((count + 1) * 2 > capacity) {
+        auto old = slots;
+        auto oldCapacity = capacity;
+
+        capacity = capacity ? capacity * 2 : 64;
+        slots = tvg::calloc<TtfGlyph**>(capacity, sizeof(TtfGlyph*));
+
+        for (uint32_t i = 0; i < oldCapacity; ++i) {
+            if (!old[i]) continue;
+            auto j = _hash(old[i]->idx) & (capacity - 1);
+            while (slots[j]) j = (j + 1) & (capacity - 1);
+            slots[j] = old[i];
+        }
+        tvg::free(old);
+    }
+
+    auto i = _hash(glyph->idx) & (capacity - 1);
+    while (slots[i]) i = (i + 1) & (capacity - 1);
+    slots[i] = glyph;
+    ++count;
+}
+
+
+void TtfGlyphCache::clear()
+{
+    for (uint32_t i = 0; i < capacity; ++i) delete(slots[i]);
+    tvg::free(slots);
+    slots = nullptr;
+    capacity = count = 0;
+}
+
+
 void TtfLoader::clear()
 {
     if (nomap) {
@@ -205,14 +146,16 @@ void TtfLoader::clear()
         freeData = false;
         nomap = false;
     } else {
-#ifdef THORVG_FILE_IO_SUPPORT
-        _unmap(this);
-#endif
+        file.close();
+        reader.data = nullptr;
+        reader.size = 0;
     }
 
     tvg::free(name);
     name = nullptr;
     shape = nullptr;
+
+    glyphs.clear();
 }
 
 
@@ -249,7 +192,11 @@ bool TtfLoader::open(const char* path)
 {
 #ifdef THORVG_FILE_IO_SUPPORT
     clear();
-    if (!_map(this, path)) return false;
+
+    //the pages are read in on demand, glyphs are looked up all over the file
+    if (!file.open(path, FileMap::Random)) return false;
+    reader.data = file.data;
+    reader.size = file.size;
 
     name = tvg::filename(path);
 
@@ -276,6 +223,35 @@ bool TtfLoader::open(const char* data, uint32_t size, TVG_UNUSED const char* rpa
 }
 
 
+//decode the glyph of the codepoint on its first use, later strings only copy its outline
+TtfGlyph* TtfLoader::glyph(uint32_t codepoint)
+{
+    auto idx = reader.glyph(codepoint);
+    if (idx == INVALID_GLYPH) {
+        TVGERR("TTF", "invalid glyph id, codepoint(0x%x)", codepoint);
+        return nullptr;
+    }
+
+    if (auto glyph = glyphs.find(idx)) return glyph;
+
+    TtfGlyphMetrics gmetrics;
+    if (!reader.glyphMetrics(idx, gmetrics)) {
+        TVGERR("TTF", "invalid glyph id, codepoint(0x%x)", codepoint);
+        return nullptr;
+    }
+
+    auto glyph = new TtfGlyph;
+    glyph->metrics = gmetrics;
+    glyph->idx = idx;
+    glyph->uid = glyphUids++;
+    glyph->broken = !reader.convert(glyph->path, glyph->metrics, {0.0f, 0.0f}, {0.0f, 0.0f}, 1U);
+    if (glyph->broken) glyph->path.clear();
+    glyphs.insert(glyph);
+
+    return glyph;
+}
+
+
 bool TtfLoader::read(Shape* shape, char* text, FontMetrics& out)
 {
     if (!text) return false;
@@ -286,8 +262,12 @@ bool TtfLoader::read(Shape* shape, char* text, FontMetrics& out)
     auto code = _codepoints(text, n);
     if (!code) return false;
 
-    //TODO: optimize with the texture-atlas?
-    TtfGlyphMetrics gmetrics;
+    //the same font could be shared by texts updated in parallel
+    ScopedLock lock(key);
+
+    auto& path = SHAPE(shape)->rs.path;
+    auto run = SHAPE(shape)->rs.glyphs = new RenderGlyphRun;
+    run->em = reader.metrics.unitsPerEm;
     Point offset = {0.0f, reader.metrics.hhea.ascent};
     Point kerning = {0.0f, 0.0f};
     auto lglyph = INVALID_GLYPH;
@@ -295,15 +275,16 @@ bool TtfLoader::read(Shape* shape, char* text, FontMetrics& out)
 
     size_t idx = 0;
     while (code[idx] && idx < n) {
-        auto rglyph = reader.glyph(code[idx], gmetrics);
-        if (rglyph != INVALID_GLYPH) {
-            if (lglyph != INVALID_GLYPH) reader.kerning(lglyph, rglyph, kerning);
-            if (!reader.convert(shape, gmetrics, offset, kerning, 1U)) break;
-            offset.x += (gmetrics.advanceWidth + kerning.x);
-            lglyph = rglyph;
+        if (auto glyph = this->glyph(code[idx])) {
+            if (lglyph != INVALID_GLYPH) reader.kerning(lglyph, glyph->idx, kerning);
+            if (glyph->broken) break;
+            _append(path, glyph->path, offset + kerning);
+            if (!glyph->path.cmds.empty()) run->glyphs.push({offset + kerning, glyph->uid, glyph->path.cmds.count, glyph->path.pts.count});
+            offset.x += (glyph->metrics.advanceWidth + kerning.x);
+            lglyph = glyph->idx;
             //store the first glyph with outline min size for italic transform.
-            if (loadMinw && gmetrics.outline) {
-                out.minw = gmetrics.minw;
+            if (loadMinw && glyph->metrics.outline) {
+                out.minw = glyph->metrics.minw;
                 loadMinw = false;
             }
         }
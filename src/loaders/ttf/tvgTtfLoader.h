@@ -23,17 +23,43 @@
 #ifndef _TVG_TTF_LOADER_H_
 #define _TVG_TTF_LOADER_H_
 
+#include "tvgFile.h"
 #include "tvgLoader.h"
+#include "tvgLock.h"
 #include "tvgTaskScheduler.h"
 #include "tvgTtfReader.h"
 
 
+struct TtfGlyph
+{
+    RenderPath path;            //outline placed at the origin
+    TtfGlyphMetrics metrics;
+    uint32_t idx;               //glyph id
+    uint32_t uid;               //unique among the fonts, see RenderGlyphRun
+    bool broken;                //failed to convert the outline
+};
+
+
+//the decoded glyphs of a font keyed by their glyph ids, open addressing
+struct TtfGlyphCache
+{
+    TtfGlyph** slots = nullptr;
+    uint32_t capacity = 0;     //power of 2
+    uint32_t count = 0;
+
+    ~TtfGlyphCache();
+    TtfGlyph* find(uint32_t idx) const;
+    void insert(TtfGlyph* glyph);
+    void clear();
+};
+
+
 struct TtfLoader : public FontLoader
 {
-#if defined(_WIN32) && (WINAPI_FAMILY == WINAPI_FAMILY_DESKTOP_APP)
-    void* mapping = nullptr;
-#endif
+    FileMap file;
     TtfReader reader;
+    TtfGlyphCache glyphs;
+    Key key;
     char* text = nullptr;
     Shape* shape = nullptr;
     bool nomap = false;
@@ -49,6 +75,7 @@ struct TtfLoader : public FontLoader
     bool open(const char *data, uint32_t size, const char* rpath, bool copy) override;
     float transform(Paint* paint, FontMetrics& metrices, float fontSize, bool italic) override;
     bool read(Shape* shape, char* text, FontMetrics& out) override;
+    TtfGlyph* glyph(uint32_t codepoint);
     void clear();
 };
 
@@ -22,7 +22,6 @@
 
 #include "tvgTtfReader.h"
 #include "tvgMath.h"
-#include "tvgShape.h"
 
 /************************************************************************/
 /* Internal Class Implementation                                        */
@@ -86,39 +85,75 @@ uint32_t TtfReader::table(const char* tag)
 }
 
 
-uint32_t TtfReader::cmap_12_13(uint32_t table, uint32_t codepoint, int fmt) const
+#define BMP_INVALID 0xffff    //glyph ids stop at 0xfffe, numGlyphs is 16 bits
+
+
+static inline uint32_t _kernHash(uint32_t key)
+{
+    auto h = (key ^ (key >> 15)) * 0x9e3779b1u;
+    return h ^ (h >> 16);
+}
+
+
+static inline uint16_t _bmpGlyph(uint32_t idx)
+{
+    return (idx < BMP_INVALID) ? idx : BMP_INVALID;
+}
+
+
+bool TtfReader::cmap_12_13(uint32_t table, int fmt)
 {
     //A minimal header is 16 bytes
     auto len = _u32(data, table + 4);
-    if (len < 16) return -1;
+    if (len < 16) return false;
 
-    if (!validate(table, len)) return -1;
+    if (!validate(table, len)) return false;
 
     auto entryCnt = _u32(data, table + 12);
+    if (entryCnt > (len - 16) / 12) entryCnt = (len - 16) / 12;
+
+    bmp = tvg::malloc<uint16_t*>(0x10000 * sizeof(uint16_t));
+    for (uint32_t code = 0; code < 0x10000; ++code) bmp[code] = BMP_INVALID;
+
+    //the first group of a codepoint wins, so fill the BMP backwards.
+    for (auto i = entryCnt; i > 0; --i) {
+        auto entry = table + ((i - 1) * 12) + 16;
+        auto firstCode = _u32(data, entry);
+        auto lastCode = _u32(data, entry + 4);
+        auto glyphOffset = _u32(data, entry + 8);
+        if (firstCode > lastCode || firstCode > 0xffff) continue;
+        if (lastCode > 0xffff) lastCode = 0xffff;
+        for (auto code = firstCode; code <= lastCode; ++code) {
+            bmp[code] = _bmpGlyph((fmt == 12) ? (code - firstCode) + glyphOffset : glyphOffset);
+        }
+    }
 
+    //the supplementary planes are kept as groups sorted for the binary search
     for (uint32_t i = 0; i < entryCnt; ++i) {
-        auto firstCode = _u32(data, table + (i * 12) + 16);
-        auto lastCode = _u32(data, table + (i * 12) + 16 + 4);
-        if (codepoint < firstCode || codepoint > lastCode) continue;
-        auto glyphOffset = _u32(data, table + (i * 12) + 16 + 8);
-        if (fmt == 12) return (codepoint - firstCode) + glyphOffset;
-        else return glyphOffset;
+        auto entry = table + (i * 12) + 16;
+        TtfCmapGroup group = {_u32(data, entry), _u32(data, entry + 4), _u32(data, entry + 8), fmt == 13};
+        if (group.last <= 0xffff || group.first > group.last) continue;
+        if (group.first <= 0xffff) {
+            if (!group.constant) group.glyph += 0x10000 - group.first;
+            group.first = 0x10000;
+        }
+        //fonts keep them in order, this only shifts the odd one.
+        groups.push(group);
+        for (auto j = groups.count - 1; j > 0 && groups[j - 1].first > group.first; --j) {
+            groups[j] = groups[j - 1];
+            groups[j - 1] = group;
+        }
     }
-    return -1;
+    return true;
 }
 
 
-uint32_t TtfReader::cmap_4(uint32_t table, uint32_t codepoint) const
+bool TtfReader::cmap_4(uint32_t table)
 {
-    //cmap format 4 only supports the Unicode BMP.
-    if (codepoint > 0xffff) return -1;
-
-    auto shortCode = static_cast<uint16_t>(codepoint);
-
-    if (!validate(table, 8)) return -1;
+    if (!validate(table, 8)) return false;
 
     auto segmentCnt = _u16(data, table);
-    if ((segmentCnt & 1) || segmentCnt == 0) return -1;
+    if ((segmentCnt & 1) || segmentCnt == 0) return false;
 
     //find starting positions of the relevant arrays.
     auto endCodes = table + 8;
@@ -126,65 +161,168 @@ uint32_t TtfReader::cmap_4(uint32_t table, uint32_t codepoint) const
     auto idDeltas = startCodes + segmentCnt;
     auto idRangeOffsets = idDeltas + segmentCnt;
 
-    if (!validate(idRangeOffsets, segmentCnt)) return -1;
-
-    //find the segment that contains shortCode by binary searching over the highest codes in the segments.
-    //binary search, but returns the next highest element if key could not be found.
-    uint8_t* segment = nullptr;
-    auto n = segmentCnt / 2;
-    if (n > 0) {
-        uint8_t key[2] = {(uint8_t)(codepoint >> 8), (uint8_t)codepoint};
-        auto bytes = data + endCodes;
-        auto low = 0;
-        auto high = n - 1;
-        while (low != high) {
-            auto mid = low + (high - low) / 2;
-            auto sample = bytes + mid * 2;
-            if (memcmp(key, sample, 2) > 0) {
-                low = mid + 1;
-            } else {
-                high = mid;
+    if (!validate(idRangeOffsets, segmentCnt)) return false;
+
+    //the codes out of the segments map to the missing glyph.
+    bmp = tvg::calloc<uint16_t*>(0x10000, sizeof(uint16_t));
+
+    //segments are sorted by their end codes, the first one containing a code wins.
+    for (auto segmentIdx = static_cast<uint32_t>(segmentCnt); segmentIdx > 0; ) {
+        segmentIdx -= 2;
+        auto endCode = _u16(data, endCodes + segmentIdx);
+        auto startCode = _u16(data, startCodes + segmentIdx);
+        auto delta = _u16(data, idDeltas + segmentIdx);
+        auto idRangeOffset = _u16(data, idRangeOffsets + segmentIdx);
+
+        for (uint32_t code = startCode; code <= endCode; ++code) {
+            //intentional integer under- and overflow.
+            if (idRangeOffset == 0) {
+                bmp[code] = _bmpGlyph((code + delta) & 0xffff);
+                continue;
             }
+            //calculate offset into glyph array and determine ultimate value.
+            auto offset = idRangeOffsets + segmentIdx + idRangeOffset + 2U * (code - startCode);
+            if (offset > size || size - offset < 2) {
+                bmp[code] = BMP_INVALID;
+                continue;
+            }
+            auto id = _u16(data, offset);
+            //intentional integer under- and overflow.
+            bmp[code] = (id > 0) ? _bmpGlyph((id + delta) & 0xffff) : 0;
         }
-        segment = (bytes + low * 2);
     }
+    return true;
+}
+
+
+bool TtfReader::cmap_6(uint32_t table)
+{
+    auto firstCode  = _u16(data, table);
+    auto entryCnt = _u16(data, table + 2);
+    if (!validate(table, 4 + 2 * entryCnt)) return false;
+
+    bmp = tvg::malloc<uint16_t*>(0x10000 * sizeof(uint16_t));
+    for (uint32_t code = 0; code < 0x10000; ++code) {
+        auto i = code - firstCode;
+        bmp[code] = (code >= firstCode && i < entryCnt) ? _bmpGlyph(_u16(data, table + 4 + 2 * i)) : BMP_INVALID;
+    }
+    return true;
+}
+
 
-    auto segmentIdx = static_cast<uint32_t>(segment - (data + endCodes));
+//build the codepoint lookup from the preferred unicode map of the font.
+bool TtfReader::mapCodepoints()
+{
+    auto cmap = table("cmap");
+    if (!cmap || !validate(cmap, 4)) return false;
 
-    //look up segment info from the arrays & short circuit if the spec requires.
-    auto startCode = _u16(data, startCodes + segmentIdx);
-    if (startCode > shortCode) return 0;
+    auto entryCnt = _u16(data, cmap + 2);
+    if (!validate(cmap, 4 + entryCnt * 8)) return false;
 
-    auto delta = _u16(data, idDeltas + segmentIdx);
-    auto idRangeOffset = _u16(data, idRangeOffsets + segmentIdx);
-    //intentional integer under- and overflow.
-    if (idRangeOffset == 0) return (shortCode + delta) & 0xffff;
+    //full repertory (non-BMP map).
+    for (auto idx = 0; idx < entryCnt; ++idx) {
+        auto entry = cmap + 4 + idx * 8;
+        auto type = _u16(data, entry) * 0100 + _u16(data, entry + 2);
+        //unicode map
+        if (type == 0004 || type == 0312) {
+            auto table = cmap + _u32(data, entry + 4);
+            if (!validate(table, 8)) return false;
+            //dispatch based on cmap format.
+            auto format = _u16(data, table);
+            switch (format) {
+                case 12: return cmap_12_13(table, 12);
+                default: return false;
+            }
+        }
+    }
 
-    //calculate offset into glyph array and determine ultimate value.
-    auto offset = idRangeOffsets + segmentIdx + idRangeOffset + 2U * (unsigned int)(shortCode - startCode);
-    if (!validate(offset, 2)) return -1;
+    //Try looking for a BMP map.
+    for (auto idx = 0; idx < entryCnt; ++idx) {
+        auto entry = cmap + 4 + idx * 8;
+        auto type = _u16(data, entry) * 0100 + _u16(data, entry + 2);
+        //Unicode BMP
+        if (type == 0003 || type == 0301) {
+            auto table = cmap + _u32(data, entry + 4);
+            if (!validate(table, 6)) return false;
+            //Dispatch based on cmap format.
+            switch (_u16(data, table)) {
+                case 4: return cmap_4(table + 6);
+                case 6: return cmap_6(table + 6);
+                default: return false;
+            }
+        }
+    }
+    return false;
+}
 
-    auto id = _u16(data, offset);
-    //intentional integer under- and overflow.
-    if (id > 0) return (id + delta) & 0xffff;
 
-    return 0;
+void TtfReader::addKerning(uint32_t key, float value, bool crossStream)
+{
+    auto i = _kernHash(key) & (kernCapacity - 1);
+    while (kernPairs[i].key != key && kernPairs[i].key != UINT32_MAX) i = (i + 1) & (kernCapacity - 1);
+    auto& pair = kernPairs[i];
+    if (pair.key == UINT32_MAX) pair = {key, {0.0f, 0.0f}};
+    if (crossStream) pair.value.y += value;
+    else pair.value.x += value;
 }
 
 
-uint32_t TtfReader::cmap_6(uint32_t table, uint32_t codepoint) const
+//merge the horizontal kerning subtables into one pair map.
+void TtfReader::mapKerning()
 {
-    //cmap format 6 only supports the Unicode BMP.
-    if (codepoint > 0xFFFF) return 0;
+    #define HORIZONTAL_KERNING 0x01
+    #define MINIMUM_KERNING 0x02
+    #define CROSS_STREAM_KERNING 0x04
+
+    auto tableCnt = _u16(data, kern + 2);
+    uint32_t total = 0;
+
+    //count the pairs first to size the map at once.
+    for (auto pass = 0; pass < 2; ++pass) {
+        auto offset = kern + 4;
+        for (auto i = 0; i < tableCnt; ++i) {
+            //read subtable header.
+            if (!validate(offset, 6)) break;
+            auto length = _u16(data, offset + 2);
+            auto format = _u8(data, offset + 4);
+            auto flags = _u8(data, offset + 5);
+            if (format == 0) {
+                //read format 0 header.
+                if (!validate(offset + 6, 8)) break;
+                auto pairCnt = _u16(data, offset + 6);
+                auto pairs = offset + 14;
+                if (!validate(pairs, pairCnt * 6)) break;
+                if ((flags & HORIZONTAL_KERNING) && !(flags & MINIMUM_KERNING)) {
+                    if (pass == 0) total += pairCnt;
+                    else {
+                        for (uint32_t j = 0; j < pairCnt; ++j) {
+                            addKerning(_u32(data, pairs + j * 6), _i16(data, pairs + j * 6 + 4), flags & CROSS_STREAM_KERNING);
+                        }
+                    }
+                }
+                //the 16 bits length overflows with the large subtables.
+                offset = pairs + pairCnt * 6;
+            } else offset += length;
+        }
+        if (total == 0) return;
+        if (pass == 0) {
+            kernCapacity = 64;
+            while (kernCapacity < total * 2) kernCapacity *= 2;
+            kernPairs = tvg::malloc<TtfKernPair*>(kernCapacity * sizeof(TtfKernPair));
+            for (uint32_t j = 0; j < kernCapacity; ++j) kernPairs[j].key = UINT32_MAX;
+        }
+    }
+}
 
-    auto firstCode  = _u16(data, table);
-    auto entryCnt = _u16(data, table + 2);
-    if (!validate(table, 4 + 2 * entryCnt)) return -1;
 
-    if (codepoint < firstCode) return -1;
-    codepoint -= firstCode;
-    if (codepoint >= entryCnt) return -1;
-    return _u16(data, table + 4 + 2 * codepoint);
+void TtfReader::clear()
+{
+    tvg::free(bmp);
+    bmp = nullptr;
+    groups.reset();
+    tvg::free(kernPairs);
+    kernPairs = nullptr;
+    kernCapacity = 0;
 }
 
 
@@ -294,8 +432,16 @@ bool TtfReader::flags(uint32_t *outline, uint8_t* flags, uint32_t flagsCnt)
 /* External Class Implementation                                        */
 /************************************************************************/
 
+TtfReader::~TtfReader()
+{
+    clear();
+}
+
+
 bool TtfReader::header()
 {
+    clear();
+
     if (!validate(0, 12)) return false;
 
     //verify ttf(scalable font)
@@ -323,70 +469,38 @@ bool TtfReader::header()
     if (kern) {
         if (!validate(kern, 4)) return false;
         if (_u16(data, kern) != 0) return false;
+        mapKerning();
     }
 
+    mapCodepoints();
+
     return true;
 }
 
 
 uint32_t TtfReader::glyph(uint32_t codepoint)
 {
-    auto cmap = this->cmap.load();
-    if (cmap == 0) {
-        this->cmap = cmap = table("cmap");
-        if (!validate(cmap, 4)) return -1;
+    if (codepoint <= 0xffff) {
+        if (!bmp || bmp[codepoint] == BMP_INVALID) return INVALID_GLYPH;
+        return bmp[codepoint];
     }
 
-    auto entryCnt = _u16(data, cmap + 2);
-    if (!validate(cmap, 4 + entryCnt * 8)) return -1;
-
-    //full repertory (non-BMP map).
-    for (auto idx = 0; idx < entryCnt; ++idx) {
-        auto entry = cmap + 4 + idx * 8;
-        auto type = _u16(data, entry) * 0100 + _u16(data, entry + 2);
-        //unicode map
-        if (type == 0004 || type == 0312) {
-            auto table = cmap + _u32(data, entry + 4);
-            if (!validate(table, 8)) return -1;
-            //dispatch based on cmap format.
-            auto format = _u16(data, table);
-            switch (format) {
-                case 12: return cmap_12_13(table, codepoint, 12);
-                default: return -1;
-            }
-        }
+    //binary search the last group starting at or before the codepoint.
+    uint32_t low = 0;
+    uint32_t high = groups.count;
+    while (low < high) {
+        auto mid = low + (high - low) / 2;
+        if (groups[mid].first <= codepoint) low = mid + 1;
+        else high = mid;
     }
+    if (low == 0) return INVALID_GLYPH;
 
-    //Try looking for a BMP map.
-    for (auto idx = 0; idx < entryCnt; ++idx) {
-        auto entry = cmap + 4 + idx * 8;
-        auto type = _u16(data, entry) * 0100 + _u16(data, entry + 2);
-        //Unicode BMP
-        if (type == 0003 || type == 0301) {
-            auto table = cmap + _u32(data, entry + 4);
-            if (!validate(table, 6)) return -1;
-            //Dispatch based on cmap format.
-            switch (_u16(data, table)) {
-                case 4: return cmap_4(table + 6, codepoint);
-                case 6: return cmap_6(table + 6, codepoint);
-                default: return -1;
-            }
-        }
-    }
-    return -1;
+    auto& group = groups[low - 1];
+    if (codepoint > group.last) return INVALID_GLYPH;
+    return group.constant ? group.glyph : group.glyph + (codepoint - group.first);
 }
 
 
-uint32_t TtfReader::glyph(uint32_t codepoint, TtfGlyphMetrics& gmetrics)
-{
-    auto glyph = this->glyph(codepoint);
-    if (glyph == INVALID_GLYPH || !glyphMetrics(glyph, gmetrics)) {
-        TVGERR("TTF", "invalid glyph id, codepoint(0x%x)", codepoint);
-        return INVALID_GLYPH;
-    }
-    return glyph;
-}
-
 bool TtfReader::glyphMetrics(uint32_t glyphIndex, TtfGlyphMetrics& gmetrics)
 {
     //horizontal metrics
@@ -436,7 +550,7 @@ bool TtfReader::glyphMetrics(uint32_t glyphIndex, TtfGlyphMetrics& gmetrics)
     return true;
 }
 
-bool TtfReader::convert(Shape* shape, TtfGlyphMetrics& gmetrics, const Point& offset, const Point& kerning, uint16_t componentDepth)
+bool TtfReader::convert(RenderPath& path, TtfGlyphMetrics& gmetrics, const Point& offset, const Point& kerning, uint16_t componentDepth)
 {
     #define ON_CURVE 0x01
 
@@ -451,7 +565,7 @@ bool TtfReader::convert(Shape* shape, TtfGlyphMetrics& gmetrics, const Point& of
             maxComponentDepth = _u16(data, maxp + 30);
         }
         if (componentDepth > maxComponentDepth) return false;
-        return convertComposite(shape, gmetrics, offset, kerning, componentDepth + 1);
+        return convertComposite(path, gmetrics, offset, kerning, componentDepth + 1);
     }
     auto cntrsCnt = (uint32_t) outlineCnt;
 
@@ -474,9 +588,8 @@ bool TtfReader::convert(Shape* shape, TtfGlyphMetrics& gmetrics, const Point& of
     if (!this->points(outline, flags, pts, ptsCnt, offset + kerning)) return false;
 
     //generate tvg paths.
-    auto& path = SHAPE(shape)->rs.path;
-    path.cmds.reserve(ptsCnt);
-    path.pts.reserve(ptsCnt);
+    path.cmds.grow(ptsCnt);
+    path.pts.grow(ptsCnt);
 
     uint32_t begin = 0;
 
@@ -514,7 +627,7 @@ bool TtfReader::convert(Shape* shape, TtfGlyphMetrics& gmetrics, const Point& of
     return true;
 }
 
-bool TtfReader::convertComposite(Shape* shape, TtfGlyphMetrics& gmetrics, const Point& offset, const Point& kerning, uint16_t componentDepth)
+bool TtfReader::convertComposite(RenderPath& path, TtfGlyphMetrics& gmetrics, const Point& offset, const Point& kerning, uint16_t componentDepth)
 {
     #define ARG_1_AND_2_ARE_WORDS 0x0001
     #define ARGS_ARE_XY_VALUES 0x0002
@@ -576,7 +689,7 @@ bool TtfReader::convertComposite(Shape* shape, TtfGlyphMetrics& gmetrics, const
             pointer += 8U;
         }
         if (!glyphMetrics(glyphIndex, componentGmetrics)) return false;
-        if (!convert(shape, componentGmetrics, offset + componentOffset, kerning, componentDepth)) return false;
+        if (!convert(path, componentGmetrics, offset + componentOffset, kerning, componentDepth)) return false;
     } while (flags & MORE_COMPONENTS);
     return true;
 }
@@ -584,50 +697,17 @@ bool TtfReader::convertComposite(Shape* shape, TtfGlyphMetrics& gmetrics, const
 
 void TtfReader::kerning(uint32_t lglyph, uint32_t rglyph, Point& out)
 {
-    #define HORIZONTAL_KERNING 0x01
-    #define MINIMUM_KERNING 0x02
-    #define CROSS_STREAM_KERNING 0x04
-
     if (!kern) return;
 
-    auto kern = this->kern.load();
-
     out.x = out.y = 0.0f;
 
-    //kern tables
-    auto tableCnt = _u16(data, kern + 2);
-    kern += 4;
-
-    while (tableCnt > 0) {
-        //read subtable header.
-        if (!validate(kern, 6)) return;
-        auto length = _u16(data, kern + 2);
-        auto format = _u8(data, kern + 4);
-        auto flags = _u8(data, kern + 5);
-        kern += 6;
-
-        if (format == 0 && (flags & HORIZONTAL_KERNING) && !(flags & MINIMUM_KERNING)) {
-            //read format 0 header.
-            if (!validate(kern, 8)) return;
-            auto pairCnt = _u16(data, kern);
-            kern += 8;
-
-            //look up character code pair via binary search.
-            uint8_t key[4];
-            key[0] = (lglyph >> 8) & 0xff;
-            key[1] = lglyph & 0xff;
-            key[2] = (rglyph >> 8) & 0xff;
-            key[3] = rglyph & 0xff;
-
-            auto match = bsearch(key, data + kern, pairCnt, 6, _cmpu32);
-
-            if (match) {
-                auto value = _i16(data, (uint32_t)((uint8_t *) match - data + 4));
-                if (flags & CROSS_STREAM_KERNING) out.y += value;
-                else out.x += value;
-            }
+    if (!kernPairs || lglyph > 0xffff || rglyph > 0xffff) return;
+
+    auto key = (lglyph << 16) | rglyph;
+    for (auto i = _kernHash(key) & (kernCapacity - 1); kernPairs[i].key != UINT32_MAX; i = (i + 1) & (kernCapacity - 1)) {
+        if (kernPairs[i].key == key) {
+            out = kernPairs[i].value;
+            return;
         }
-        kern += length;
-        --tableCnt;
     }
 }
@@ -26,6 +26,7 @@
 #include <atomic>
 #include "tvgCommon.h"
 #include "tvgArray.h"
+#include "tvgRender.h"
 
 #define INVALID_GLYPH ((uint32_t)-1)
 
@@ -41,6 +42,23 @@ struct TtfGlyphMetrics
 };
 
 
+//a cmap group of the codepoints beyond the Unicode BMP
+struct TtfCmapGroup
+{
+    uint32_t first;
+    uint32_t last;
+    uint32_t glyph;      //glyph id of the first codepoint
+    bool constant;       //format 13, the whole group maps to one glyph
+};
+
+
+struct TtfKernPair
+{
+    uint32_t key;        //left glyph << 16 | right glyph
+    Point value;
+};
+
+
 struct TtfReader
 {
 public:
@@ -61,29 +79,39 @@ public:
         uint8_t locaFormat;    //0 for short offsets, 1 for long
     } metrics;
 
+    ~TtfReader();
+
     bool header();
-    uint32_t glyph(uint32_t codepoint, TtfGlyphMetrics& gmetrics);
+    uint32_t glyph(uint32_t codepoint);
+    bool glyphMetrics(uint32_t glyphIndex, TtfGlyphMetrics& gmetrics);
     void kerning(uint32_t lglyph, uint32_t rglyph, Point& out);
-    bool convert(Shape* shape, TtfGlyphMetrics& gmetrics, const Point& offset, const Point& kerning, uint16_t componentDepth);
+    bool convert(RenderPath& path, TtfGlyphMetrics& gmetrics, const Point& offset, const Point& kerning, uint16_t componentDepth);
 
 private:
+    //codepoint and kerning lookups, built once by header()
+    uint16_t* bmp = nullptr;             //glyph ids of the BMP codepoints
+    Array<TtfCmapGroup> groups;          //sorted by their first codepoints
+    TtfKernPair* kernPairs = nullptr;    //open addressing
+    uint32_t kernCapacity = 0;           //power of 2
+
     //table offsets
-    atomic<uint32_t> cmap{};
     atomic<uint32_t> hmtx{};
     atomic<uint32_t> loca{};
     atomic<uint32_t> glyf{};
     atomic<uint32_t> kern{};
     atomic<uint32_t> maxp{};
 
-    uint32_t cmap_12_13(uint32_t table, uint32_t codepoint, int which) const;
-    uint32_t cmap_4(uint32_t table, uint32_t codepoint) const;
-    uint32_t cmap_6(uint32_t table, uint32_t codepoint) const;
+    bool cmap_12_13(uint32_t table, int fmt);
+    bool cmap_4(uint32_t table);
+    bool cmap_6(uint32_t table);
+    bool mapCodepoints();
+    void mapKerning();
+    void addKerning(uint32_t key, float value, bool crossStream);
+    void clear();
     bool validate(uint32_t offset, uint32_t margin) const;
     uint32_t table(const char* tag);
     uint32_t outlineOffset(uint32_t glyph);
-    uint32_t glyph(uint32_t codepoint);
-    bool glyphMetrics(uint32_t glyphIndex, TtfGlyphMetrics& gmetrics);
-    bool convertComposite(Shape* shape, TtfGlyphMetrics& gmetrics, const Point& offset, const Point& kerning, uint16_t componentDepth);
+    bool convertComposite(RenderPath& path, TtfGlyphMetrics& gmetrics, const Point& offset, const Point& kerning, uint16_t componentDepth);
     bool genPath(uint8_t* flags, uint16_t basePoint, uint16_t count);
     bool genSimpleOutline(Shape* shape, uint32_t outline, uint32_t cntrsCnt);
     bool points(uint32_t outline, uint8_t* flags, Point* pts, uint32_t ptsCnt, const Point& offset);
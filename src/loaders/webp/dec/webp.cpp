@@ -536,13 +536,15 @@ static VP8StatusCode DecodeInto(const uint8_t* const data, size_t data_size,
 
 static uint8_t* Decode(WEBP_CSP_MODE mode, const uint8_t* const data,
                        size_t data_size, int* const width, int* const height,
-                       WebPDecBuffer* const keep_info) {
+                       WebPDecBuffer* const keep_info,
+                       const WebPDecoderOptions* const options) {
   WebPDecParams params;
   WebPDecBuffer output;
 
   WebPInitDecBuffer(&output);
   memset(&params, 0, sizeof(params));
   params.output = &output;
+  params.options = options;
   output.colorspace = mode;
 
   // Retrieve (and report back) the required dimensions from bitstream.
@@ -651,12 +653,33 @@ int WebPIoInitFromOptions(const WebPDecoderOptions* const options,
 
 uint8_t* WebPDecodeBGRA(const uint8_t* data, size_t data_size,
                         int* width, int* height) {
-  return Decode(MODE_bgrA, data, data_size, width, height, NULL);
+  return Decode(MODE_bgrA, data, data_size, width, height, NULL, NULL);
 }
 
 uint8_t* WebPDecodeRGBA(const uint8_t* data, size_t data_size,
                         int* width, int* height) {
-  return Decode(MODE_rgbA, data, data_size, width, height, NULL);
+  return Decode(MODE_rgbA, data, data_size, width, height, NULL, NULL);
+}
+
+static uint8_t* DecodeScaled(WEBP_CSP_MODE mode, const uint8_t* data,
+                             size_t data_size, int scaled_width,
+                             int scaled_height) {
+  WebPDecoderOptions options;
+  memset(&options, 0, sizeof(options));
+  options.use_scaling = 1;
+  options.scaled_width = scaled_width;
+  options.scaled_height = scaled_height;
+  return Decode(mode, data, data_size, NULL, NULL, NULL, &options);
+}
+
+uint8_t* WebPDecodeScaledBGRA(const uint8_t* data, size_t data_size,
+                              int scaled_width, int scaled_height) {
+  return DecodeScaled(MODE_bgrA, data, data_size, scaled_width, scaled_height);
+}
+
+uint8_t* WebPDecodeScaledRGBA(const uint8_t* data, size_t data_size,
+                              int scaled_width, int scaled_height) {
+  return DecodeScaled(MODE_rgbA, data, data_size, scaled_width, scaled_height);
 }
 
 int WebPGetInfo(const uint8_t* data, size_t data_size,
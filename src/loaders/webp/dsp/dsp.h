@@ -18,6 +18,8 @@
 #include "../webp/config.h"
 #endif
 
+#include "config.h"
+
 #include "../webp/types.h"
 
 #ifdef __cplusplus
@@ -56,8 +58,10 @@ extern "C" {
 // files without intrinsics, allowing the corresponding Init() to be called.
 // Files containing intrinsics will need to be built targeting the instruction
 // set so should succeed on one of the earlier tests.
-#if defined(__SSE2__) || defined(WEBP_MSC_SSE2) || defined(WEBP_HAVE_SSE2)
-//#define WEBP_USE_SSE2
+// The SIMD paths follow thorvg's simd option.
+#if defined(THORVG_AVX_VECTOR_SUPPORT) && \
+    (defined(__SSE2__) || defined(WEBP_MSC_SSE2) || defined(WEBP_HAVE_SSE2))
+#define WEBP_USE_SSE2
 #endif
 
 // This macro prevents thread_sanitizer from reporting known concurrent writes.
@@ -0,0 +1,130 @@
+// Copyright 2015 Google Inc. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the COPYING file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS. All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+// -----------------------------------------------------------------------------
+//
+// SSE2 variant of alpha filters
+//
+// Author: Skal (pascal.massimino@gmail.com)
+
+#include "./dsp.h"
+
+#if defined(WEBP_USE_SSE2)
+
+#include <assert.h>
+#include <emmintrin.h>
+
+//------------------------------------------------------------------------------
+// Helpful macro.
+
+# define SANITY_CHECK(in, out)                                                 \
+  assert(in != NULL);                                                          \
+  assert(out != NULL);                                                         \
+  assert(width > 0);                                                           \
+  assert(height > 0);                                                          \
+  assert(stride >= width);                                                     \
+  assert(row >= 0 && num_rows > 0 && row + num_rows <= height);                \
+  (void)height;  // Silence unused warning.
+
+// out[i] = in[i] + pred[i]
+static void PredictLineAdd(const uint8_t* in, const uint8_t* pred,
+                           uint8_t* out, int length) {
+  int i;
+  for (i = 0; i + 16 <= length; i += 16) {
+    const __m128i A = _mm_loadu_si128((const __m128i*)&in[i]);
+    const __m128i B = _mm_loadu_si128((const __m128i*)&pred[i]);
+    _mm_storeu_si128((__m128i*)&out[i], _mm_add_epi8(A, B));
+  }
+  for (; i < length; ++i) out[i] = in[i] + pred[i];
+}
+
+// out[i] = in[i] + out[i - 1], with 'prev' standing for out[-1].
+// The running sum is computed 16 bytes at a time with a log-step prefix sum.
+static void PredictLineLeftAdd(const uint8_t* in, uint8_t* out, int length,
+                               uint8_t prev) {
+  int i;
+  __m128i last = _mm_set1_epi8((char)prev);
+  for (i = 0; i + 16 <= length; i += 16) {
+    __m128i A = _mm_loadu_si128((const __m128i*)&in[i]);
+    A = _mm_add_epi8(A, _mm_slli_si128(A, 1));
+    A = _mm_add_epi8(A, _mm_slli_si128(A, 2));
+    A = _mm_add_epi8(A, _mm_slli_si128(A, 4));
+    A = _mm_add_epi8(A, _mm_slli_si128(A, 8));
+    A = _mm_add_epi8(A, last);
+    _mm_storeu_si128((__m128i*)&out[i], A);
+    prev = out[i + 15];
+    last = _mm_set1_epi8((char)prev);
+  }
+  for (; i < length; ++i) {
+    out[i] = in[i] + prev;
+    prev = out[i];
+  }
+}
+
+//------------------------------------------------------------------------------
+// Inverse transforms
+
+static void HorizontalUnfilter(int width, int height, int stride, int row,
+                               int num_rows, uint8_t* data) {
+  const int last_row = row + num_rows;
+  SANITY_CHECK(data, data);
+  data += row * stride;
+
+  if (row == 0) {
+    // Leftmost pixel is the same as input for topmost scanline.
+    PredictLineLeftAdd(data + 1, data + 1, width - 1, data[0]);
+    row = 1;
+    data += stride;
+  }
+
+  // Filter line-by-line: the leftmost pixel is predicted from above.
+  while (row < last_row) {
+    PredictLineLeftAdd(data, data, width, data[-stride]);
+    ++row;
+    data += stride;
+  }
+}
+
+static void VerticalUnfilter(int width, int height, int stride, int row,
+                             int num_rows, uint8_t* data) {
+  const int last_row = row + num_rows;
+  SANITY_CHECK(data, data);
+  data += row * stride;
+
+  if (row == 0) {
+    // Very first top-left pixel is copied, the rest of top scan-line is
+    // left-predicted.
+    PredictLineLeftAdd(data + 1, data + 1, width - 1, data[0]);
+    row = 1;
+    data += stride;
+  }
+
+  // Filter line-by-line.
+  while (row < last_row) {
+    PredictLineAdd(data, data - stride, data, width);
+    ++row;
+    data += stride;
+  }
+}
+
+#undef SANITY_CHECK
+
+//------------------------------------------------------------------------------
+// Entry point
+
+extern void VP8FiltersInitSSE2(void);
+
+WEBP_TSAN_IGNORE_FUNCTION void VP8FiltersInitSSE2(void) {
+  WebPUnfilters[WEBP_FILTER_HORIZONTAL] = HorizontalUnfilter;
+  WebPUnfilters[WEBP_FILTER_VERTICAL] = VerticalUnfilter;
+}
+
+#else  // !WEBP_USE_SSE2
+
+WEBP_DSP_INIT_STUB(VP8FiltersInitSSE2)
+
+#endif  // WEBP_USE_SSE2
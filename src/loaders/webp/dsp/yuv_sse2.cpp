@@ -0,0 +1,159 @@
+// Copyright 2014 Google Inc. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the COPYING file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS. All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+// -----------------------------------------------------------------------------
+//
+// YUV->RGB conversion functions
+//
+// Author: Skal (pascal.massimino@gmail.com)
+
+#include "./yuv.h"
+
+#if defined(WEBP_USE_SSE2)
+
+#include <emmintrin.h>
+#include "../utils/utils.h"
+
+//-----------------------------------------------------------------------------
+// Convert spans of 8 pixels to various RGB formats.
+// The computation is bit-exact with the plain-C VP8YUVToR/G/B().
+
+// Converts 8 pixels of y/u/v (already widened to 16b) to 16b r/g/b values.
+// Results are not clipped yet.
+static WEBP_INLINE void ConvertYUV444ToRGB(const __m128i* const Y0,
+                                           const __m128i* const U0,
+                                           const __m128i* const V0,
+                                           __m128i* const R,
+                                           __m128i* const G,
+                                           __m128i* const B) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i kY = _mm_set_epi16(0, kYScale, 0, kYScale,
+                                   0, kYScale, 0, kYScale);
+  const __m128i kR = _mm_set_epi16(0, kVToR, 0, kVToR, 0, kVToR, 0, kVToR);
+  const __m128i kG = _mm_set_epi16(-kVToG, -kUToG, -kVToG, -kUToG,
+                                   -kVToG, -kUToG, -kVToG, -kUToG);
+  // kUToB doesn't fit in a signed 16b lane: split it in two equal halves.
+  const __m128i kB = _mm_set1_epi16(kUToB / 2);
+  const __m128i kRCst4 = _mm_set1_epi32(kRCst);
+  const __m128i kGCst4 = _mm_set1_epi32(kGCst);
+  const __m128i kBCst4 = _mm_set1_epi32(kBCst);
+
+  const __m128i Y_lo = _mm_madd_epi16(_mm_unpacklo_epi16(*Y0, zero), kY);
+  const __m128i Y_hi = _mm_madd_epi16(_mm_unpackhi_epi16(*Y0, zero), kY);
+
+  const __m128i R0_lo = _mm_madd_epi16(_mm_unpacklo_epi16(*V0, zero), kR);
+  const __m128i R0_hi = _mm_madd_epi16(_mm_unpackhi_epi16(*V0, zero), kR);
+  const __m128i G0_lo = _mm_madd_epi16(_mm_unpacklo_epi16(*U0, *V0), kG);
+  const __m128i G0_hi = _mm_madd_epi16(_mm_unpackhi_epi16(*U0, *V0), kG);
+  const __m128i B0_lo = _mm_madd_epi16(_mm_unpacklo_epi16(*U0, *U0), kB);
+  const __m128i B0_hi = _mm_madd_epi16(_mm_unpackhi_epi16(*U0, *U0), kB);
+
+  const __m128i R1_lo = _mm_add_epi32(_mm_add_epi32(Y_lo, R0_lo), kRCst4);
+  const __m128i R1_hi = _mm_add_epi32(_mm_add_epi32(Y_hi, R0_hi), kRCst4);
+  const __m128i G1_lo = _mm_add_epi32(_mm_add_epi32(Y_lo, G0_lo), kGCst4);
+  const __m128i G1_hi = _mm_add_epi32(_mm_add_epi32(Y_hi, G0_hi), kGCst4);
+  const __m128i B1_lo = _mm_add_epi32(_mm_add_epi32(Y_lo, B0_lo), kBCst4);
+  const __m128i B1_hi = _mm_add_epi32(_mm_add_epi32(Y_hi, B0_hi), kBCst4);
+
+  *R = _mm_packs_epi32(_mm_srai_epi32(R1_lo, YUV_FIX2),
+                       _mm_srai_epi32(R1_hi, YUV_FIX2));
+  *G = _mm_packs_epi32(_mm_srai_epi32(G1_lo, YUV_FIX2),
+                       _mm_srai_epi32(G1_hi, YUV_FIX2));
+  *B = _mm_packs_epi32(_mm_srai_epi32(B1_lo, YUV_FIX2),
+                       _mm_srai_epi32(B1_hi, YUV_FIX2));
+}
+
+// Load 8 y values and the 4 u/v values shared by pairs of them.
+static WEBP_INLINE void YUV420ToRGB(const uint8_t* const y,
+                                    const uint8_t* const u,
+                                    const uint8_t* const v,
+                                    __m128i* const R, __m128i* const G,
+                                    __m128i* const B) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i y0 = _mm_loadl_epi64((const __m128i*)y);
+  const __m128i u0 = _mm_cvtsi32_si128(WebPMemToUint32(u));
+  const __m128i v0 = _mm_cvtsi32_si128(WebPMemToUint32(v));
+  const __m128i Y0 = _mm_unpacklo_epi8(y0, zero);
+  const __m128i U0 = _mm_unpacklo_epi8(_mm_unpacklo_epi8(u0, u0), zero);
+  const __m128i V0 = _mm_unpacklo_epi8(_mm_unpacklo_epi8(v0, v0), zero);
+  ConvertYUV444ToRGB(&Y0, &U0, &V0, R, G, B);
+}
+
+// Clip and interleave 8 pixels of 16b 'a', 'b', 'c' values with an opaque
+// alpha, as 32 bytes of 'a b c 0xff' quadruplets.
+static WEBP_INLINE void PackAndStore4(const __m128i* const A,
+                                      const __m128i* const B,
+                                      const __m128i* const C,
+                                      uint8_t* const dst) {
+  const __m128i kAlpha = _mm_set1_epi16(255);
+  const __m128i AB = _mm_packus_epi16(*A, *B);   // a0..a7 b0..b7
+  const __m128i CD = _mm_packus_epi16(*C, kAlpha);
+  const __m128i AB_lo = _mm_unpacklo_epi8(AB, _mm_srli_si128(AB, 8));
+  const __m128i CD_lo = _mm_unpacklo_epi8(CD, _mm_srli_si128(CD, 8));
+  _mm_storeu_si128((__m128i*)(dst +  0), _mm_unpacklo_epi16(AB_lo, CD_lo));
+  _mm_storeu_si128((__m128i*)(dst + 16), _mm_unpackhi_epi16(AB_lo, CD_lo));
+}
+
+static void YuvToRgbaRow(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                         uint8_t* dst, int len) {
+  int n;
+  for (n = 0; n + 8 <= len; n += 8) {
+    __m128i R, G, B;
+    YUV420ToRGB(y, u, v, &R, &G, &B);
+    PackAndStore4(&R, &G, &B, dst);
+    y += 8;
+    u += 4;
+    v += 4;
+    dst += 32;
+  }
+  for (; n < len; ++n) {   // Finish off
+    VP8YuvToRgba(y[0], u[0], v[0], dst);
+    dst += 4;
+    y += 1;
+    u += (n & 1);
+    v += (n & 1);
+  }
+}
+
+static void YuvToBgraRow(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                         uint8_t* dst, int len) {
+  int n;
+  for (n = 0; n + 8 <= len; n += 8) {
+    __m128i R, G, B;
+    YUV420ToRGB(y, u, v, &R, &G, &B);
+    PackAndStore4(&B, &G, &R, dst);
+    y += 8;
+    u += 4;
+    v += 4;
+    dst += 32;
+  }
+  for (; n < len; ++n) {   // Finish off
+    VP8YuvToBgra(y[0], u[0], v[0], dst);
+    dst += 4;
+    y += 1;
+    u += (n & 1);
+    v += (n & 1);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Entry point
+
+extern void WebPInitSamplersSSE2(void);
+
+WEBP_TSAN_IGNORE_FUNCTION void WebPInitSamplersSSE2(void) {
+  WebPSamplers[MODE_RGBA] = YuvToRgbaRow;
+  WebPSamplers[MODE_BGRA] = YuvToBgraRow;
+  WebPSamplers[MODE_rgbA] = YuvToRgbaRow;
+  WebPSamplers[MODE_bgrA] = YuvToBgraRow;
+}
+
+#else  // !WEBP_USE_SSE2
+
+WEBP_DSP_INIT_STUB(WebPInitSamplersSSE2)
+
+#endif  // WEBP_USE_SSE2
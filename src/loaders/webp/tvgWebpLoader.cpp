@@ -28,6 +28,7 @@
 void WebpLoader::clear()
 {
     if (freeData) tvg::free(data);
+    file.close();
     data = nullptr;
     freeData = false;
 }
@@ -35,17 +36,23 @@ void WebpLoader::clear()
 
 void WebpLoader::run(unsigned tid)
 {
+    MemoryScope scope(MemoryCategory::Loader);
+
+    //rescaled within the decoding
+    surface.w = (static_cast<uint32_t>(w) + (1 << reduction) - 1) >> reduction;
+    surface.h = (static_cast<uint32_t>(h) + (1 << reduction) - 1) >> reduction;
+
     if (surface.cs == ColorSpace::ARGB8888 || surface.cs == ColorSpace::ARGB8888S) {
-        surface.buf8 = WebPDecodeBGRA(data, size, nullptr, nullptr);
+        if (reduction > 0) surface.buf8 = WebPDecodeScaledBGRA(data, size, surface.w, surface.h);
+        else surface.buf8 = WebPDecodeBGRA(data, size, nullptr, nullptr);
         surface.cs = ColorSpace::ARGB8888;
     } else  {
-        surface.buf8 = WebPDecodeRGBA(data, size, nullptr, nullptr);
+        if (reduction > 0) surface.buf8 = WebPDecodeScaledRGBA(data, size, surface.w, surface.h);
+        else surface.buf8 = WebPDecodeRGBA(data, size, nullptr, nullptr);
         surface.cs = ColorSpace::ABGR8888;
     }
 
-    surface.stride = static_cast<uint32_t>(w);
-    surface.w = static_cast<uint32_t>(w);
-    surface.h = static_cast<uint32_t>(h);
+    surface.stride = surface.w;
     surface.channelSize = sizeof(uint32_t);
     surface.premultiplied = true;
 
@@ -73,34 +80,16 @@ WebpLoader::~WebpLoader()
 bool WebpLoader::open(const char* path)
 {
 #ifdef THORVG_FILE_IO_SUPPORT
-    auto f = fopen(path, "rb");
-    if (!f) return false;
-
-    fseek(f, 0, SEEK_END);
-
-    size = ftell(f);
-    if (size == 0) {
-        fclose(f);
-        return false;
-    }
-
-    data = tvg::malloc<uint8_t*>(size);
-
-    fseek(f, 0, SEEK_SET);
-    auto ret = fread(data, sizeof(char), size, f);
-    if (ret < size) {
-        fclose(f);
-        return false;
-    }
+    if (!file.open(path)) return false;
 
-    fclose(f);
+    data = file.data;
+    size = file.size;
 
     int width, height;
     if (!WebPGetInfo(data, size, &width, &height)) return false;
 
     w = static_cast<float>(width);
     h = static_cast<float>(height);
-    freeData = true;
 
     return true;
 #else
@@ -140,7 +129,7 @@ bool WebpLoader::read()
 
     surface.cs = ImageLoader::cs;
 
-    TaskScheduler::request(this);
+    request(this);
 
     return true;
 }
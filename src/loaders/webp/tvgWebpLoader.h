@@ -20,12 +20,14 @@
 #ifndef _TVG_WEBP_LOADER_H_
 #define _TVG_WEBP_LOADER_H_
 
+#include "tvgFile.h"
 #include "tvgLoader.h"
 #include "tvgTaskScheduler.h"
 
 class WebpLoader : public ImageLoader, public Task
 {
 private:
+    FileMap file;
     uint8_t* data = nullptr;
     uint32_t size = 0;
     bool freeData = false;
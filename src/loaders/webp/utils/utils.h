@@ -71,6 +71,11 @@ static WEBP_INLINE uint32_t WebPMemToUint32(const uint8_t* const ptr) {
   return A;
 }
 
+// Store 32 bits at the possibly-unaligned location 'ptr'.
+static WEBP_INLINE void WebPUint32ToMem(uint8_t* const ptr, uint32_t val) {
+  memcpy(ptr, &val, sizeof(val));
+}
+
 //------------------------------------------------------------------------------
 
 #ifdef __cplusplus
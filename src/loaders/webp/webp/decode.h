@@ -57,6 +57,17 @@ WEBP_EXTERN(uint8_t*) WebPDecodeRGBA(const uint8_t* data, size_t data_size,
 WEBP_EXTERN(uint8_t*) WebPDecodeBGRA(const uint8_t* data, size_t data_size,
                                      int* width, int* height);
 
+// Same as WebPDecodeRGBA, but rescaling the image to the given dimensions
+// while decoding it.
+WEBP_EXTERN(uint8_t*) WebPDecodeScaledRGBA(const uint8_t* data,
+                                           size_t data_size,
+                                           int scaled_width, int scaled_height);
+
+// Same as WebPDecodeScaledRGBA, but returning B, G, R, A... ordered data.
+WEBP_EXTERN(uint8_t*) WebPDecodeScaledBGRA(const uint8_t* data,
+                                           size_t data_size,
+                                           int scaled_width, int scaled_height);
+
 
 //------------------------------------------------------------------------------
 // Output colorspaces and buffer
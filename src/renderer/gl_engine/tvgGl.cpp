@@ -188,12 +188,12 @@ PFNGLVIEWPORTPROC               glViewport;
 //PFNGLTEXPARAMETERFVPROC         glTexParameterfv;
 //PFNGLTEXPARAMETERIVPROC         glTexParameteriv;
 //PFNGLTEXIMAGE1DPROC             glTexImage1D;
-//PFNGLSTENCILMASKPROC            glStencilMask;
+PFNGLSTENCILMASKPROC            glStencilMask;
 //PFNGLFINISHPROC                 glFinish;
 //PFNGLFLUSHPROC                  glFlush;
 //PFNGLLOGICOPPROC                glLogicOp = nullptr
 //PFNGLPIXELSTOREFPROC            glPixelStoref;
-//PFNGLPIXELSTOREIPROC            glPixelStorei;
+PFNGLPIXELSTOREIPROC            glPixelStorei;
 //PFNGLREADBUFFERPROC             glReadBuffer;
 //PFNGLREADPIXELSPROC             glReadPixels;
 //PFNGLGETBOOLEANVPROC            glGetBooleanv;
@@ -220,7 +220,7 @@ PFNGLGENTEXTURESPROC       glGenTextures;
 //PFNGLCOPYTEXSUBIMAGE1DPROC glCopyTexSubImage1D;
 //PFNGLCOPYTEXSUBIMAGE2DPROC glCopyTexSubImage2D;
 //PFNGLTEXSUBIMAGE1DPROC     glTexSubImage1D;
-//PFNGLTEXSUBIMAGE2DPROC     glTexSubImage2D;
+PFNGLTEXSUBIMAGE2DPROC     glTexSubImage2D;
 //PFNGLISTEXTUREPROC         glIsTexture;
 
 //GL_VERSION_1_2
@@ -256,19 +256,19 @@ PFNGLBINDBUFFERPROC           glBindBuffer;
 PFNGLDELETEBUFFERSPROC        glDeleteBuffers;
 PFNGLGENBUFFERSPROC           glGenBuffers;
 PFNGLBUFFERDATAPROC           glBufferData;
-//PFNGLGENQUERIESPROC           glGenQueries;
-//PFNGLDELETEQUERIESPROC        glDeleteQueries;
+PFNGLGENQUERIESPROC           glGenQueries;
+PFNGLDELETEQUERIESPROC        glDeleteQueries;
 //PFNGLISQUERYPROC              glIsQuery;
-//PFNGLBEGINQUERYPROC           glBeginQuery;
-//PFNGLENDQUERYPROC             glEndQuery;
+PFNGLBEGINQUERYPROC           glBeginQuery;
+PFNGLENDQUERYPROC             glEndQuery;
 //PFNGLGETQUERYIVPROC           glGetQueryiv;
 //PFNGLGETQUERYOBJECTIVPROC     glGetQueryObjectiv;
-//PFNGLGETQUERYOBJECTUIVPROC    glGetQueryObjectuiv;
+PFNGLGETQUERYOBJECTUIVPROC    glGetQueryObjectuiv;
 //PFNGLISBUFFERPROC             glIsBuffer;
-//PFNGLBUFFERSUBDATAPROC        glBufferSubData;
+PFNGLBUFFERSUBDATAPROC          glBufferSubData;
 //PFNGLGETBUFFERSUBDATAPROC     glGetBufferSubData;
 //PFNGLMAPBUFFERPROC            glMapBuffer;
-//PFNGLUNMAPBUFFERPROC          glUnmapBuffer;
+PFNGLUNMAPBUFFERPROC            glUnmapBuffer;
 //PFNGLGETBUFFERPARAMETERIVPROC glGetBufferParameteriv;
 //PFNGLGETBUFFERPOINTERVPROC    glGetBufferPointerv;
 
@@ -456,9 +456,9 @@ PFNGLGENVERTEXARRAYSPROC                     glGenVertexArrays;
 //PFNGLFRAMEBUFFERTEXTURE1DPROC                glFramebufferTexture1D;
 //PFNGLFRAMEBUFFERTEXTURE3DPROC                glFramebufferTexture3D;
 //PFNGLGETFRAMEBUFFERATTACHMENTPARAMETERIVPROC glGetFramebufferAttachmentParameteriv;
-//PFNGLGENERATEMIPMAPPROC                      glGenerateMipmap;
+PFNGLGENERATEMIPMAPPROC                        glGenerateMipmap;
 //PFNGLFRAMEBUFFERTEXTURELAYERPROC             glFramebufferTextureLayer;
-//PFNGLMAPBUFFERRANGEPROC                      glMapBufferRange;
+PFNGLMAPBUFFERRANGEPROC                        glMapBufferRange;
 //PFNGLFLUSHMAPPEDBUFFERRANGEPROC              glFlushMappedBufferRange;
 //PFNGLISVERTEXARRAYPROC                       glIsVertexArray;
 
@@ -476,6 +476,16 @@ PFNGLUNIFORMBLOCKBINDINGPROC       glUniformBlockBinding;
 //PFNGLGETACTIVEUNIFORMBLOCKIVPROC   glGetActiveUniformBlockiv;
 //PFNGLGETACTIVEUNIFORMBLOCKNAMEPROC glGetActiveUniformBlockName;
 
+//GL_VERSION_3_2
+PFNGLFENCESYNCPROC                 glFenceSync;
+PFNGLDELETESYNCPROC                glDeleteSync;
+PFNGLCLIENTWAITSYNCPROC            glClientWaitSync;
+
+//GL_VERSION_4_1
+PFNGLGETPROGRAMBINARYPROC          glGetProgramBinary;
+PFNGLPROGRAMBINARYPROC             glProgramBinary;
+PFNGLPROGRAMPARAMETERIPROC         glProgramParameteri;
+
 bool glInit()
 {
     if (!_glLoad()) return false;
@@ -505,7 +515,7 @@ bool glInit()
 #else
     GL_FUNCTION_FETCH(glClearDepth, PFNGLCLEARDEPTHPROC);
 #endif
-    // GL_FUNCTION_FETCH(glStencilMask, PFNGLSTENCILMASKPROC);
+    GL_FUNCTION_FETCH(glStencilMask, PFNGLSTENCILMASKPROC);
     GL_FUNCTION_FETCH(glColorMask, PFNGLCOLORMASKPROC);
     GL_FUNCTION_FETCH(glDepthMask, PFNGLDEPTHMASKPROC);
     GL_FUNCTION_FETCH(glDisable, PFNGLDISABLEPROC);
@@ -518,7 +528,7 @@ bool glInit()
     GL_FUNCTION_FETCH(glStencilOp, PFNGLSTENCILOPPROC);
     GL_FUNCTION_FETCH(glDepthFunc, PFNGLDEPTHFUNCPROC);
     // GL_FUNCTION_FETCH(glPixelStoref, PFNGLPIXELSTOREFPROC);
-    // GL_FUNCTION_FETCH(glPixelStorei, PFNGLPIXELSTOREIPROC);
+    GL_FUNCTION_FETCH(glPixelStorei, PFNGLPIXELSTOREIPROC);
     // GL_FUNCTION_FETCH(glReadBuffer, PFNGLREADBUFFERPROC);
     // GL_FUNCTION_FETCH(glReadPixels, PFNGLREADPIXELSPROC);
     // GL_FUNCTION_FETCH(glGetBooleanv, PFNGLGETBOOLEANVPROC);
@@ -546,7 +556,7 @@ bool glInit()
     // GL_FUNCTION_FETCH(glCopyTexSubImage1D, PFNGLCOPYTEXSUBIMAGE1DPROC);
     // GL_FUNCTION_FETCH(glCopyTexSubImage2D, PFNGLCOPYTEXSUBIMAGE2DPROC);
     // GL_FUNCTION_FETCH(glTexSubImage1D, PFNGLTEXSUBIMAGE1DPROC);
-    // GL_FUNCTION_FETCH(glTexSubImage2D, PFNGLTEXSUBIMAGE2DPROC);
+    GL_FUNCTION_FETCH(glTexSubImage2D, PFNGLTEXSUBIMAGE2DPROC);
     GL_FUNCTION_FETCH(glBindTexture, PFNGLBINDTEXTUREPROC);
     GL_FUNCTION_FETCH(glDeleteTextures, PFNGLDELETETEXTURESPROC);
     GL_FUNCTION_FETCH(glGenTextures, PFNGLGENTEXTURESPROC);
@@ -581,23 +591,23 @@ bool glInit()
     GL_FUNCTION_FETCH(glBlendEquation, PFNGLBLENDEQUATIONPROC);
 
     // GL_VERSION_1_5
-    // GL_FUNCTION_FETCH(glGenQueries, PFNGLGENQUERIESPROC);
-    // GL_FUNCTION_FETCH(glDeleteQueries, PFNGLDELETEQUERIESPROC);
+    GL_FUNCTION_FETCH(glGenQueries, PFNGLGENQUERIESPROC);
+    GL_FUNCTION_FETCH(glDeleteQueries, PFNGLDELETEQUERIESPROC);
     // GL_FUNCTION_FETCH(glIsQuery, PFNGLISQUERYPROC);
-    // GL_FUNCTION_FETCH(glBeginQuery, PFNGLBEGINQUERYPROC);
-    // GL_FUNCTION_FETCH(glEndQuery, PFNGLENDQUERYPROC);
+    GL_FUNCTION_FETCH(glBeginQuery, PFNGLBEGINQUERYPROC);
+    GL_FUNCTION_FETCH(glEndQuery, PFNGLENDQUERYPROC);
     // GL_FUNCTION_FETCH(glGetQueryiv, PFNGLGETQUERYIVPROC);
     // GL_FUNCTION_FETCH(glGetQueryObjectiv, PFNGLGETQUERYOBJECTIVPROC);
-    // GL_FUNCTION_FETCH(glGetQueryObjectuiv, PFNGLGETQUERYOBJECTUIVPROC);
+    GL_FUNCTION_FETCH(glGetQueryObjectuiv, PFNGLGETQUERYOBJECTUIVPROC);
     GL_FUNCTION_FETCH(glBindBuffer, PFNGLBINDBUFFERPROC);
     GL_FUNCTION_FETCH(glDeleteBuffers, PFNGLDELETEBUFFERSPROC);
     GL_FUNCTION_FETCH(glGenBuffers, PFNGLGENBUFFERSPROC);
     // GL_FUNCTION_FETCH(glIsBuffer, PFNGLISBUFFERPROC);
     GL_FUNCTION_FETCH(glBufferData, PFNGLBUFFERDATAPROC);
-    // GL_FUNCTION_FETCH(glBufferSubData, PFNGLBUFFERSUBDATAPROC);
+    GL_FUNCTION_FETCH(glBufferSubData, PFNGLBUFFERSUBDATAPROC);
     // GL_FUNCTION_FETCH(glGetBufferSubData, PFNGLGETBUFFERSUBDATAPROC);
     // GL_FUNCTION_FETCH(glMapBuffer, PFNGLMAPBUFFERPROC);
-    // GL_FUNCTION_FETCH(glUnmapBuffer, PFNGLUNMAPBUFFERPROC);
+    GL_FUNCTION_FETCH(glUnmapBuffer, PFNGLUNMAPBUFFERPROC);
     // GL_FUNCTION_FETCH(glGetBufferParameteriv, PFNGLGETBUFFERPARAMETERIVPROC);
     // GL_FUNCTION_FETCH(glGetBufferPointerv, PFNGLGETBUFFERPOINTERVPROC);
 
@@ -784,11 +794,11 @@ bool glInit()
     // GL_FUNCTION_FETCH(glFramebufferTexture3D, PFNGLFRAMEBUFFERTEXTURE3DPROC);
     GL_FUNCTION_FETCH(glFramebufferRenderbuffer, PFNGLFRAMEBUFFERRENDERBUFFERPROC);
     // GL_FUNCTION_FETCH(glGetFramebufferAttachmentParameteriv, PFNGLGETFRAMEBUFFERATTACHMENTPARAMETERIVPROC);
-    // GL_FUNCTION_FETCH(glGenerateMipmap, PFNGLGENERATEMIPMAPPROC);
+    GL_FUNCTION_FETCH(glGenerateMipmap, PFNGLGENERATEMIPMAPPROC);
     GL_FUNCTION_FETCH(glBlitFramebuffer, PFNGLBLITFRAMEBUFFERPROC);
     GL_FUNCTION_FETCH(glRenderbufferStorageMultisample, PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC);
     // GL_FUNCTION_FETCH(glFramebufferTextureLayer, PFNGLFRAMEBUFFERTEXTURELAYERPROC);
-    // GL_FUNCTION_FETCH(glMapBufferRange, PFNGLMAPBUFFERRANGEPROC);
+    GL_FUNCTION_FETCH(glMapBufferRange, PFNGLMAPBUFFERRANGEPROC);
     // GL_FUNCTION_FETCH(glFlushMappedBufferRange, PFNGLFLUSHMAPPEDBUFFERRANGEPROC);
     GL_FUNCTION_FETCH(glBindVertexArray, PFNGLBINDVERTEXARRAYPROC);
     GL_FUNCTION_FETCH(glDeleteVertexArrays, PFNGLDELETEVERTEXARRAYSPROC);
@@ -809,6 +819,16 @@ bool glInit()
     // GL_FUNCTION_FETCH(glGetActiveUniformBlockName, PFNGLGETACTIVEUNIFORMBLOCKNAMEPROC);
     GL_FUNCTION_FETCH(glUniformBlockBinding, PFNGLUNIFORMBLOCKBINDINGPROC);
 
+    // GL_VERSION_3_2
+    GL_FUNCTION_FETCH(glFenceSync, PFNGLFENCESYNCPROC);
+    GL_FUNCTION_FETCH(glDeleteSync, PFNGLDELETESYNCPROC);
+    GL_FUNCTION_FETCH(glClientWaitSync, PFNGLCLIENTWAITSYNCPROC);
+
+    // GL_VERSION_4_1, the program binaries are optional on the desktop gl 3.3
+    glGetProgramBinary = (PFNGLGETPROGRAMBINARYPROC)_getProcAddress("glGetProgramBinary");
+    glProgramBinary = (PFNGLPROGRAMBINARYPROC)_getProcAddress("glProgramBinary");
+    glProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC)_getProcAddress("glProgramParameteri");
+
     //Confirm the version
     GLint vMajor, vMinor;
     glGetIntegerv(GL_MAJOR_VERSION, &vMajor);
@@ -285,12 +285,12 @@
         //typedef void (*PFNGLTEXPARAMETERFVPROC)(GLenum target, GLenum pname, const GLfloat *params);
         //typedef void (*PFNGLTEXPARAMETERIVPROC)(GLenum target, GLenum pname, const GLint *params);
         //typedef void (*PFNGLTEXIMAGE1DPROC)(GLenum target, GLint level, GLint internalformat, GLsizei width, GLint border, GLenum format, GLenum type, const void *pixels);
-        //typedef void (*PFNGLSTENCILMASKPROC) (GLuint mask);
+        typedef void (*PFNGLSTENCILMASKPROC)(GLuint mask);
         //typedef void (*PFNGLFINISHPROC)(void);
         //typedef void (*PFNGLFLUSHPROC)(void);
         //typedef void (*PFNGLLOGICOPPROC)(GLenum opcode);
         //typedef void (*PFNGLPIXELSTOREFPROC)(GLenum pname, GLfloat param);
-        //typedef void (*PFNGLPIXELSTOREIPROC)(GLenum pname, GLint param);
+        typedef void (*PFNGLPIXELSTOREIPROC)(GLenum pname, GLint param);
         //typedef void (*PFNGLREADBUFFERPROC)(GLenum src);
         //typedef void (*PFNGLREADPIXELSPROC)(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void *pixels);
         //typedef void (*PFNGLGETBOOLEANVPROC)(GLenum pname, GLboolean *data);
@@ -352,7 +352,7 @@
         //typedef void (*PFNGLCOPYTEXSUBIMAGE1DPROC)(GLenum target, GLint level, GLint xoffset, GLint x, GLint y, GLsizei width);
         //typedef void (*PFNGLCOPYTEXSUBIMAGE2DPROC)(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height);
         //typedef void (*PFNGLTEXSUBIMAGE1DPROC)(GLenum target, GLint level, GLint xoffset, GLsizei width, GLenum format, GLenum type, const void *pixels);
-        //typedef void (*PFNGLTEXSUBIMAGE2DPROC)(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels);
+        typedef void (*PFNGLTEXSUBIMAGE2DPROC)(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels);
         //typedef GLboolean (*PFNGLISTEXTUREPROC)(GLuint texture);
     #endif /* GL_VERSION_1_1 */
 
@@ -548,19 +548,19 @@
         typedef void (*PFNGLDELETEBUFFERSPROC)(GLsizei n, const GLuint *buffers);
         typedef void (*PFNGLGENBUFFERSPROC)(GLsizei n, GLuint *buffers);
         typedef void (*PFNGLBUFFERDATAPROC)(GLenum target, GLsizeiptr size, const void *data, GLenum usage);
-        //typedef void (*PFNGLGENQUERIESPROC)(GLsizei n, GLuint *ids);
-        //typedef void (*PFNGLDELETEQUERIESPROC)(GLsizei n, const GLuint *ids);
+        typedef void (*PFNGLGENQUERIESPROC)(GLsizei n, GLuint *ids);
+        typedef void (*PFNGLDELETEQUERIESPROC)(GLsizei n, const GLuint *ids);
         //typedef GLboolean (*PFNGLISQUERYPROC)(GLuint id);
-        //typedef void (*PFNGLBEGINQUERYPROC)(GLenum target, GLuint id);
-        //typedef void (*PFNGLENDQUERYPROC)(GLenum target);
+        typedef void (*PFNGLBEGINQUERYPROC)(GLenum target, GLuint id);
+        typedef void (*PFNGLENDQUERYPROC)(GLenum target);
         //typedef void (*PFNGLGETQUERYIVPROC)(GLenum target, GLenum pname, GLint *params);
         //typedef void (*PFNGLGETQUERYOBJECTIVPROC)(GLuint id, GLenum pname, GLint *params);
-        //typedef void (*PFNGLGETQUERYOBJECTUIVPROC)(GLuint id, GLenum pname, GLuint *params);
+        typedef void (*PFNGLGETQUERYOBJECTUIVPROC)(GLuint id, GLenum pname, GLuint *params);
         //typedef GLboolean (*PFNGLISBUFFERPROC)(GLuint buffer);
-        //typedef void (*PFNGLBUFFERSUBDATAPROC)(GLenum target, GLintptr offset, GLsizeiptr size, const void *data);
+        typedef void (*PFNGLBUFFERSUBDATAPROC)(GLenum target, GLintptr offset, GLsizeiptr size, const void *data);
         //typedef void (*PFNGLGETBUFFERSUBDATAPROC)(GLenum target, GLintptr offset, GLsizeiptr size, void *data);
         //typedef void *(*PFNGLMAPBUFFERPROC)(GLenum target, GLenum access);
-        //typedef GLboolean (*PFNGLUNMAPBUFFERPROC)(GLenum target);
+        typedef GLboolean (*PFNGLUNMAPBUFFERPROC)(GLenum target);
         //typedef void (*PFNGLGETBUFFERPARAMETERIVPROC)(GLenum target, GLenum pname, GLint *params);
         //typedef void (*PFNGLGETBUFFERPOINTERVPROC)(GLenum target, GLenum pname, void **params);
     #endif /* GL_VERSION_1_5 */
@@ -1086,9 +1086,9 @@
         //typedef void (*PFNGLFRAMEBUFFERTEXTURE1DPROC)(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level);
         //typedef void (*PFNGLFRAMEBUFFERTEXTURE3DPROC)(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level, GLint zoffset);
         //typedef void (*PFNGLGETFRAMEBUFFERATTACHMENTPARAMETERIVPROC)(GLenum target, GLenum attachment, GLenum pname, GLint *params);
-        //typedef void (*PFNGLGENERATEMIPMAPPROC)(GLenum target);
+        typedef void (*PFNGLGENERATEMIPMAPPROC)(GLenum target);
         //typedef void (*PFNGLFRAMEBUFFERTEXTURELAYERPROC)(GLenum target, GLenum attachment, GLuint texture, GLint level, GLint layer);
-        //typedef void *(*PFNGLMAPBUFFERRANGEPROC)(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+        typedef void *(*PFNGLMAPBUFFERRANGEPROC)(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
         //typedef void (*PFNGLFLUSHMAPPEDBUFFERRANGEPROC)(GLenum target, GLintptr offset, GLsizeiptr length);
         //typedef GLboolean (*PFNGLISVERTEXARRAYPROC)(GLuint array);
     #endif /* GL_VERSION_3_0 */
@@ -1170,6 +1170,39 @@
         //typedef void (*PFNGLGETACTIVEUNIFORMBLOCKNAMEPROC)(GLuint program, GLuint uniformBlockIndex, GLsizei bufSize, GLsizei *length, GLchar *uniformBlockName);
     #endif /* GL_VERSION_3_1 */
 
+    #ifndef GL_VERSION_3_2
+        #define GL_VERSION_3_2 1
+        typedef struct __GLsync *GLsync;
+        typedef unsigned long long GLuint64;
+        #define GL_SYNC_GPU_COMMANDS_COMPLETE     0x9117
+        #define GL_ALREADY_SIGNALED               0x911A
+        #define GL_TIMEOUT_EXPIRED                0x911B
+        #define GL_CONDITION_SATISFIED            0x911C
+        #define GL_WAIT_FAILED                    0x911D
+        #define GL_SYNC_FLUSH_COMMANDS_BIT        0x00000001
+        typedef GLsync (*PFNGLFENCESYNCPROC)(GLenum condition, GLbitfield flags);
+        typedef void (*PFNGLDELETESYNCPROC)(GLsync sync);
+        typedef GLenum (*PFNGLCLIENTWAITSYNCPROC)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+    #endif /* GL_VERSION_3_2 */
+
+    #ifndef GL_VERSION_3_3
+        #define GL_VERSION_3_3 1
+        #define GL_TEXTURE_SWIZZLE_R              0x8E42
+        #define GL_TEXTURE_SWIZZLE_G              0x8E43
+        #define GL_TEXTURE_SWIZZLE_B              0x8E44
+        #define GL_TEXTURE_SWIZZLE_A              0x8E45
+    #endif /* GL_VERSION_3_3 */
+
+    #ifndef GL_VERSION_4_1
+        #define GL_VERSION_4_1 1
+        #define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+        #define GL_PROGRAM_BINARY_LENGTH          0x8741
+        #define GL_NUM_PROGRAM_BINARY_FORMATS     0x87FE
+        typedef void (*PFNGLGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary);
+        typedef void (*PFNGLPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length);
+        typedef void (*PFNGLPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+    #endif /* GL_VERSION_4_1 */
+
     //GL_VERSION_1_0
     extern PFNGLCULLFACEPROC               glCullFace;
     extern PFNGLFRONTFACEPROC              glFrontFace;
@@ -1203,12 +1236,12 @@
     //extern PFNGLTEXPARAMETERFVPROC         glTexParameterfv;
     //extern PFNGLTEXPARAMETERIVPROC         glTexParameteriv;
     //extern PFNGLTEXIMAGE1DPROC             glTexImage1D;
-    //extern PFNGLSTENCILMASKPROC            glStencilMask;
+    extern PFNGLSTENCILMASKPROC            glStencilMask;
     //extern PFNGLFINISHPROC                 glFinish;
     //extern PFNGLFLUSHPROC                  glFlush;
     //extern PFNGLLOGICOPPROC                glLogicOp;
     //extern PFNGLPIXELSTOREFPROC            glPixelStoref;
-    //extern PFNGLPIXELSTOREIPROC            glPixelStorei;
+    extern PFNGLPIXELSTOREIPROC            glPixelStorei;
     //extern PFNGLREADBUFFERPROC             glReadBuffer;
     //extern PFNGLREADPIXELSPROC             glReadPixels;
     //extern PFNGLGETBOOLEANVPROC            glGetBooleanv;
@@ -1235,7 +1268,7 @@
     //extern PFNGLCOPYTEXSUBIMAGE1DPROC glCopyTexSubImage1D;
     //extern PFNGLCOPYTEXSUBIMAGE2DPROC glCopyTexSubImage2D;
     //extern PFNGLTEXSUBIMAGE1DPROC     glTexSubImage1D;
-    //extern PFNGLTEXSUBIMAGE2DPROC     glTexSubImage2D;
+    extern PFNGLTEXSUBIMAGE2DPROC     glTexSubImage2D;
     //extern PFNGLISTEXTUREPROC         glIsTexture;
 
     //GL_VERSION_1_2
@@ -1271,19 +1304,19 @@
     extern PFNGLDELETEBUFFERSPROC        glDeleteBuffers;
     extern PFNGLGENBUFFERSPROC           glGenBuffers;
     extern PFNGLBUFFERDATAPROC           glBufferData;
-    //extern PFNGLGENQUERIESPROC           glGenQueries;
-    //extern PFNGLDELETEQUERIESPROC        glDeleteQueries;
+    extern PFNGLGENQUERIESPROC           glGenQueries;
+    extern PFNGLDELETEQUERIESPROC        glDeleteQueries;
     //extern PFNGLISQUERYPROC              glIsQuery;
-    //extern PFNGLBEGINQUERYPROC           glBeginQuery;
-    //extern PFNGLENDQUERYPROC             glEndQuery;
+    extern PFNGLBEGINQUERYPROC           glBeginQuery;
+    extern PFNGLENDQUERYPROC             glEndQuery;
     //extern PFNGLGETQUERYIVPROC           glGetQueryiv;
     //extern PFNGLGETQUERYOBJECTIVPROC     glGetQueryObjectiv;
-    //extern PFNGLGETQUERYOBJECTUIVPROC    glGetQueryObjectuiv;
+    extern PFNGLGETQUERYOBJECTUIVPROC    glGetQueryObjectuiv;
     //extern PFNGLISBUFFERPROC             glIsBuffer;
-    //extern PFNGLBUFFERSUBDATAPROC        glBufferSubData;
+    extern PFNGLBUFFERSUBDATAPROC          glBufferSubData;
     //extern PFNGLGETBUFFERSUBDATAPROC     glGetBufferSubData;
     //extern PFNGLMAPBUFFERPROC            glMapBuffer;
-    //extern PFNGLUNMAPBUFFERPROC          glUnmapBuffer;
+    extern PFNGLUNMAPBUFFERPROC            glUnmapBuffer;
     //extern PFNGLGETBUFFERPARAMETERIVPROC glGetBufferParameteriv;
     //extern PFNGLGETBUFFERPOINTERVPROC    glGetBufferPointerv;
 
@@ -1471,9 +1504,9 @@
     //extern PFNGLFRAMEBUFFERTEXTURE1DPROC                glFramebufferTexture1D;
     //extern PFNGLFRAMEBUFFERTEXTURE3DPROC                glFramebufferTexture3D;
     //extern PFNGLGETFRAMEBUFFERATTACHMENTPARAMETERIVPROC glGetFramebufferAttachmentParameteriv;
-    //extern PFNGLGENERATEMIPMAPPROC                      glGenerateMipmap;
+    extern PFNGLGENERATEMIPMAPPROC                        glGenerateMipmap;
     //extern PFNGLFRAMEBUFFERTEXTURELAYERPROC             glFramebufferTextureLayer;
-    //extern PFNGLMAPBUFFERRANGEPROC                      glMapBufferRange;
+    extern PFNGLMAPBUFFERRANGEPROC                        glMapBufferRange;
     //extern PFNGLFLUSHMAPPEDBUFFERRANGEPROC              glFlushMappedBufferRange;
     //extern PFNGLISVERTEXARRAYPROC                       glIsVertexArray;
 
@@ -1490,6 +1523,16 @@
     //extern PFNGLGETACTIVEUNIFORMNAMEPROC      glGetActiveUniformName;
     //extern PFNGLGETACTIVEUNIFORMBLOCKIVPROC   glGetActiveUniformBlockiv;
     //extern PFNGLGETACTIVEUNIFORMBLOCKNAMEPROC glGetActiveUniformBlockName;
+
+    //GL_VERSION_3_2
+    extern PFNGLFENCESYNCPROC                 glFenceSync;
+    extern PFNGLDELETESYNCPROC                glDeleteSync;
+    extern PFNGLCLIENTWAITSYNCPROC            glClientWaitSync;
+
+    //GL_VERSION_4_1 (GLES 3.0), optional: null if not supported
+    extern PFNGLGETPROGRAMBINARYPROC          glGetProgramBinary;
+    extern PFNGLPROGRAMBINARYPROC             glProgramBinary;
+    extern PFNGLPROGRAMPARAMETERIPROC         glProgramParameteri;
 #endif // __EMSCRIPTEN__
 
 bool glInit();
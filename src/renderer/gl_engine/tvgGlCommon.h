@@ -27,9 +27,16 @@
 #include "tvgGl.h"
 #include "tvgRender.h"
 #include "tvgMath.h"
+#include "tvgTaskScheduler.h"
 
 #define MIN_GL_STROKE_WIDTH 1.0f
 
+#ifdef THORVG_GL_ANALYTIC_AA_SUPPORT
+    #define GL_MSAA_SAMPLES 0   //single sampled, the edges are smoothed by the coverage fringes
+#else
+    #define GL_MSAA_SAMPLES 4
+#endif
+
 #define MVP_MATRIX(w, h)                \
     float mvp[4*4] = {                  \
         2.f / w,      0.0,  0.0f, 0.0f, \
@@ -91,6 +98,7 @@ enum class GlStencilMode {
 
 class GlStageBuffer;
 class GlRenderTask;
+namespace tvg { class GlGlyphCache; }
 
 struct GlGeometryBuffer {
     Array<float> vertex;
@@ -106,32 +114,52 @@ struct GlGeometryBuffer {
 
 struct GlGeometry
 {
-    bool tesselate(const RenderShape& rshape, RenderUpdateFlag flag);
+    bool tesselate(const RenderShape& rshape, RenderUpdateFlag flag, RenderUpdateFlag changed, GlGlyphCache& glyphs);
     bool tesselate(const RenderSurface* image, RenderUpdateFlag flag);
     bool draw(GlRenderTask* task, GlStageBuffer* gpuBuffer, RenderUpdateFlag flag);
+    bool drawFringe(GlRenderTask* task, GlStageBuffer* gpuBuffer, RenderUpdateFlag flag);
     GlStencilMode getStencilMode(RenderUpdateFlag flag);
+    bool stencilFree(RenderUpdateFlag flag, uint8_t alpha) const;
     RenderRegion getBounds() const;
 
     GlGeometryBuffer fill, stroke;
+    GlGeometryBuffer fillFringe, strokeFringe;  //the anti-aliasing edges, empty with the multisampling
     Matrix matrix = {};
     RenderRegion viewport = {};
     RenderRegion bounds = {};
+    RenderRegion fillBounds = {};
+    RenderRegion strokeBounds = {};
+    float fillScale = 0.0f;     //the matrix scale the meshes were built with, zero if not built
+    float strokeScale = 0.0f;
+    float tolerance = FLATNESS_TOLERANCE;  //the curve flattening tolerance in pixels
     FillRule fillRule = FillRule::NonZero;
+    bool fillConvex = false;    //the fill fan doesn't overlap itself
 };
 
 
-struct GlShape
+//the shape geometry is tessellated on the worker threads, the gl resources stay on the context thread
+struct GlShape : Task
 {
   const RenderShape* rshape = nullptr;
   float viewWd;
   float viewHt;
   uint32_t opacity = 0;
   GLuint texId = 0;
+  bool texExternal = false;  //the texture is owned by the user
   uint32_t texFlipY = 0;
   ColorSpace texColorSpace = ColorSpace::ABGR8888;
   RenderUpdateFlag updateFlag = None;
+  RenderUpdateFlag changed = None;  //the properties changed since the last tessellation
   GlGeometry geometry;
   Array<RenderData> clips;
+  RenderRegion box = {};  //drawing area for the partial rendering
+  RenderRegion prvBox = {};  //drawing area of the previous update
+  GlGlyphCache* glyphs = nullptr;
+  RenderDirtyRegion* dirtyRegion = nullptr;  //null if the shape doesn't damage the target
+  RenderDirtyRegion::Scope dirtyScope;  //the damages spread out by the post effects of the ancestors
+
+protected:
+  void run(unsigned tid) override;
 };
 
 #define MAX_GRADIENT_STOPS 16
@@ -157,6 +185,7 @@ struct GlRadialGradientBlock
 struct GlCompositor : RenderCompositor
 {
     RenderRegion bbox = {};
+    bool alpha = false;    //the mask content needs the coverage only, see GlRenderer::beginComposite()
 
     GlCompositor(const RenderRegion& box) : bbox(box) {}
 };
@@ -147,20 +147,21 @@ void GlEffect::update(RenderEffectDropShadow* effect, const Matrix& transform)
 
 GlRenderTask* GlEffect::render(RenderEffectDropShadow* effect, GlRenderTarget* dstFbo, Array<GlRenderTargetPool*>& blendPool, const RenderRegion& vp, uint32_t voffset, uint32_t ioffset)
 {
-    if (!pBlurV) pBlurV = new GlProgram(EFFECT_VERTEX, GAUSSIAN_VERTICAL);
-    if (!pBlurH) pBlurH = new GlProgram(EFFECT_VERTEX, GAUSSIAN_HORIZONTAL);
+    if (!pShadowV) pShadowV = new GlProgram(EFFECT_VERTEX, SHADOW_VERTICAL);
+    if (!pShadowH) pShadowH = new GlProgram(EFFECT_VERTEX, SHADOW_HORIZONTAL);
     if (!pDropShadow) pDropShadow = new GlProgram(EFFECT_VERTEX, EFFECT_DROPSHADOW);
 
-    // get current and intermidiate framebuffers
-    auto dstCopyFbo0 = blendPool[0]->getRenderTarget(vp);
-    auto dstCopyFbo1 = blendPool[1]->getRenderTarget(vp);
+    // get the copy of the current framebuffer, and the single channel ones for blurring the alpha
+    auto dstCopyFbo = blendPool[0]->getRenderTarget(vp);
+    auto alphaFbo0 = blendPool[0]->getRenderTarget(vp, 0, true);
+    auto alphaFbo1 = blendPool[1]->getRenderTarget(vp, 0, true);
 
     // add uniform data
     GlDropShadow* params = (GlDropShadow*)(effect->rd);
     auto paramsOffset = gpuBuffer->push(params, sizeof(GlDropShadow), true);
 
     // create gaussian blur tasks
-    auto task = new GlEffectDropShadowTask(pDropShadow, dstFbo, dstCopyFbo0, dstCopyFbo1);
+    auto task = new GlEffectDropShadowTask(pDropShadow, dstFbo, dstCopyFbo, alphaFbo0, alphaFbo1);
     task->effect = (RenderEffectDropShadow*)effect;
     task->setViewport({{0, 0}, {vp.sw(), vp.sh()}});
     task->addBindResource(GlBindingResource{0, pDropShadow->getUniformBlockIndex("DropShadow"), gpuBuffer->getBufferId(), paramsOffset, sizeof(GlDropShadow)});
@@ -168,14 +169,14 @@ GlRenderTask* GlEffect::render(RenderEffectDropShadow* effect, GlRenderTarget* d
     task->setDrawRange(ioffset, 6);
 
     // horizontal blur task and geometry
-    task->horzTask = new GlRenderTask(pBlurH);
-    task->horzTask->addBindResource(GlBindingResource{0, pBlurH->getUniformBlockIndex("Gaussian"), gpuBuffer->getBufferId(), paramsOffset, sizeof(GlGaussianBlur)});
+    task->horzTask = new GlRenderTask(pShadowH);
+    task->horzTask->addBindResource(GlBindingResource{0, pShadowH->getUniformBlockIndex("Gaussian"), gpuBuffer->getBufferId(), paramsOffset, sizeof(GlGaussianBlur)});
     task->horzTask->addVertexLayout(GlVertexLayout{0, 2, 2 * sizeof(float), voffset});
     task->horzTask->setDrawRange(ioffset, 6);
 
     // vertical blur task and geometry
-    task->vertTask = new GlRenderTask(pBlurV);
-    task->vertTask->addBindResource(GlBindingResource{0, pBlurV->getUniformBlockIndex("Gaussian"), gpuBuffer->getBufferId(), paramsOffset, sizeof(GlGaussianBlur)});
+    task->vertTask = new GlRenderTask(pShadowV);
+    task->vertTask->addBindResource(GlBindingResource{0, pShadowV->getUniformBlockIndex("Gaussian"), gpuBuffer->getBufferId(), paramsOffset, sizeof(GlGaussianBlur)});
     task->vertTask->addVertexLayout(GlVertexLayout{0, 2, 2 * sizeof(float), voffset});
     task->vertTask->setDrawRange(ioffset, 6);
 
@@ -284,6 +285,41 @@ GlRenderTask* GlEffect::render(RenderEffect* effect, GlRenderTarget* dstFbo, Arr
 }
 
 
+#define GL_EFFECT_COLORS_MAX 8  //keep in sync with EFFECT_COLORS
+
+struct GlEffectColors {
+    float header[4];  // [0]: steps count
+    float steps[GL_EFFECT_COLORS_MAX][4 + sizeof(GlEffectParams) / sizeof(float)];  // [0]: type, [4..15]: GlEffectParams
+};
+
+
+GlRenderTask* GlEffect::render(const RenderEffect* const* effects, uint32_t cnt, GlRenderTarget* dstFbo, Array<GlRenderTargetPool*>& blendPool, const RenderRegion& vp, uint32_t voffset, uint32_t ioffset)
+{
+    if (!pColors) pColors = new GlProgram(EFFECT_VERTEX, EFFECT_COLORS);
+
+    GlEffectColors colors{};
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < cnt; ++i) {
+        if (!effects[i]->valid) continue;
+        auto& step = colors.steps[n++];
+        step[0] = (effects[i]->type == SceneEffect::Fill) ? 0.0f : ((effects[i]->type == SceneEffect::Tint) ? 1.0f : 2.0f);
+        memcpy(step + 4, effects[i]->rd, sizeof(GlEffectParams));
+    }
+    colors.header[0] = float(n);
+
+    auto dstCopyFbo = blendPool[0]->getRenderTarget(vp);
+    auto paramsOffset = gpuBuffer->push(&colors, sizeof(GlEffectColors), true);
+
+    auto task = new GlEffectColorTransformTask(pColors, dstFbo, dstCopyFbo);
+    task->setViewport({{0, 0}, {vp.sw(), vp.sh()}});
+    task->addBindResource(GlBindingResource{0, pColors->getUniformBlockIndex("Params"), gpuBuffer->getBufferId(), paramsOffset, sizeof(GlEffectColors)});
+    task->addVertexLayout(GlVertexLayout{0, 2, 2 * sizeof(float), voffset});
+    task->setDrawRange(ioffset, 6);
+
+    return task;
+}
+
+
 /************************************************************************/
 /* External Class Implementation                                        */
 /************************************************************************/
@@ -338,6 +374,24 @@ bool GlEffect::render(RenderEffect* effect, GlRenderPass* pass, Array<GlRenderTa
 }
 
 
+bool GlEffect::fuse(const RenderEffect* const* effects, uint32_t cnt, GlRenderPass* pass, Array<GlRenderTargetPool*>& blendPool)
+{
+    if (pass->isEmpty()) return false;
+    auto vp = pass->getViewport();
+
+    const float vdata[] = {-1.0f, +1.0f, +1.0f, +1.0f, +1.0f, -1.0f, -1.0f, -1.0f};
+    const uint32_t idata[] = { 0, 1, 2, 0, 2, 3 };
+    auto voffset = gpuBuffer->push((void*)vdata, sizeof(vdata));
+    auto ioffset = gpuBuffer->pushIndex((void*)idata, sizeof(idata));
+
+    //one transform task per the shader capacity
+    for (uint32_t i = 0; i < cnt; i += GL_EFFECT_COLORS_MAX) {
+        pass->addRenderTask(render(effects + i, std::min(cnt - i, uint32_t(GL_EFFECT_COLORS_MAX)), pass->getFbo(), blendPool, vp, voffset, ioffset));
+    }
+    return true;
+}
+
+
 GlEffect::GlEffect(GlStageBuffer* buffer) : gpuBuffer(buffer)
 {
 }
@@ -347,8 +401,11 @@ GlEffect::~GlEffect()
 {
     delete(pBlurV);
     delete(pBlurH);
+    delete(pShadowV);
+    delete(pShadowH);
     delete(pDropShadow);
     delete(pFill);
     delete(pTint);
     delete(pTritone);
+    delete(pColors);
 }
\ No newline at end of file
@@ -34,10 +34,13 @@ private:
 
     GlProgram* pBlurV{};
     GlProgram* pBlurH{};
+    GlProgram* pShadowV{};
+    GlProgram* pShadowH{};
     GlProgram* pDropShadow{};
     GlProgram* pFill{};
     GlProgram* pTint{};
     GlProgram* pTritone{};
+    GlProgram* pColors{};
 
     void update(RenderEffectGaussianBlur* effect, const Matrix& transform);
     void update(RenderEffectDropShadow* effect, const Matrix& transform);
@@ -51,6 +54,7 @@ private:
     GlRenderTask* render(RenderEffectGaussianBlur* effect, GlRenderTarget* dstFbo, Array<GlRenderTargetPool*>& blendPool, const RenderRegion& vp, uint32_t voffset, uint32_t ioffset);
     GlRenderTask* render(RenderEffectDropShadow* effect, GlRenderTarget* dstFbo, Array<GlRenderTargetPool*>& blendPool, const RenderRegion& vp, uint32_t voffset, uint32_t ioffset);
     GlRenderTask* render(RenderEffect* effect, GlRenderTarget* dstFbo, Array<GlRenderTargetPool*>& blendPool, const RenderRegion& vp, uint32_t voffset, uint32_t ioffset);
+    GlRenderTask* render(const RenderEffect* const* effects, uint32_t cnt, GlRenderTarget* dstFbo, Array<GlRenderTargetPool*>& blendPool, const RenderRegion& vp, uint32_t voffset, uint32_t ioffset);
 
 public:
     GlEffect(GlStageBuffer* buffer);
@@ -59,6 +63,7 @@ public:
     void update(RenderEffect* effect, const Matrix& transform);
     bool region(RenderEffect* effect);
     bool render(RenderEffect* effect, GlRenderPass* pass, Array<GlRenderTargetPool*>& blendPool);
+    bool fuse(const RenderEffect* const* effects, uint32_t cnt, GlRenderPass* pass, Array<GlRenderTargetPool*>& blendPool);
 };
 
 #endif /* _TVG_GL_EFFECT_H_ */
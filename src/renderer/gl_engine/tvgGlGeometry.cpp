@@ -26,28 +26,132 @@
 #include "tvgGlRenderTask.h"
 
 
-bool GlGeometry::tesselate(const RenderShape& rshape, RenderUpdateFlag flag)
+//the larger axis scale decides the curve segments
+static float _meshScale(const Matrix& m)
 {
-    if (flag & (RenderUpdateFlag::Color | RenderUpdateFlag::Gradient | RenderUpdateFlag::Transform | RenderUpdateFlag::Path)) {
-        fill.clear();
+    return std::max(sqrtf(m.e11 * m.e11 + m.e21 * m.e21), sqrtf(m.e12 * m.e12 + m.e22 * m.e22));
+}
+
+
+//the local space meshes are transformed by the shader, they are kept while the curves stay smooth enough on the screen
+static bool _reusable(float meshScale, float scale)
+{
+    return meshScale > 0.0f && scale <= meshScale * 1.25f && scale >= meshScale * 0.5f;
+}
 
-        BWTessellator bwTess{&fill};
-        if (rshape.trimpath()) {
-            RenderPath trimmedPath;
-            if (rshape.stroke->trim.trim(rshape.path, trimmedPath)) bwTess.tessellate(trimmedPath, matrix);
-            else return true;
-        } else bwTess.tessellate(rshape.path, matrix);
 
+#ifdef THORVG_GL_ANALYTIC_AA_SUPPORT
+
+#define FRINGE_STRIDE 6  //x, y, edge direction, offset in pixels, coverage
+
+//a strip across the edge, its sides are pushed half a pixel away on the screen by the shader
+static void _fringe(GlGeometryBuffer& fringe, const Point& p0, const Point& p1)
+{
+    auto dir = p1 - p0;
+    if (tvg::zero(dir)) return;
+
+    auto base = fringe.vertex.count / FRINGE_STRIDE;
+    const float offsets[] = {-0.5f, 0.0f, 0.5f};
+
+    for (auto p : {p0, p1}) {
+        for (auto offset : offsets) {
+            fringe.vertex.push(p.x);
+            fringe.vertex.push(p.y);
+            fringe.vertex.push(dir.x);
+            fringe.vertex.push(dir.y);
+            fringe.vertex.push(offset);
+            fringe.vertex.push(0.5f - fabsf(offset));  //the pixel centered on the edge is half covered
+        }
+    }
+
+    /*  0 - 1 - 2
+     *  |   |   |
+     *  3 - 4 - 5  */
+    const uint32_t quads[] = {0, 3, 1, 1, 3, 4, 1, 4, 2, 2, 4, 5};
+    for (auto i : quads) fringe.index.push(base + i);
+}
+
+
+//the stencil lets the fringes out of the shape only, the inner edges are dropped there
+static void _fringe(const GlGeometryBuffer& mesh, GlGeometryBuffer& fringe, bool fan)
+{
+    fringe.clear();
+
+    auto pts = reinterpret_cast<const Point*>(mesh.vertex.data);
+    auto idx = mesh.index.data;
+    auto cnt = mesh.index.count;
+
+    //a fan has an outer edge per triangle, a stroke takes all of them
+    auto edges = fan ? cnt / 3 + 2 : cnt;
+    fringe.vertex.reserve(edges * 6 * FRINGE_STRIDE);
+    fringe.index.reserve(edges * 12);
+
+    for (uint32_t i = 0; i < cnt; i += 3) {
+        auto first = idx[i], prev = idx[i + 1], curr = idx[i + 2];
+        if (fan) {
+            //the contours of the fans (first, prev, curr)
+            if (i == 0 || idx[i - 3] != first) _fringe(fringe, pts[first], pts[prev]);
+            _fringe(fringe, pts[prev], pts[curr]);
+            if (i + 3 >= cnt || idx[i + 3] != first) _fringe(fringe, pts[curr], pts[first]);
+        } else {
+            _fringe(fringe, pts[first], pts[prev]);
+            _fringe(fringe, pts[prev], pts[curr]);
+            _fringe(fringe, pts[curr], pts[first]);
+        }
+    }
+}
+
+#endif
+
+
+bool GlGeometry::tesselate(const RenderShape& rshape, RenderUpdateFlag flag, RenderUpdateFlag changed, GlGlyphCache& glyphs)
+{
+    auto scale = _meshScale(matrix);
+
+    if (flag & (RenderUpdateFlag::Color | RenderUpdateFlag::Gradient | RenderUpdateFlag::Path)) {
+        if ((changed & RenderUpdateFlag::Path) || !_reusable(fillScale, scale)) {
+            fill.clear();
+
+            BWTessellator bwTess{&fill, tolerance};
+            if (rshape.trimpath()) {
+                RenderPath trimmedPath;
+                if (rshape.stroke->trim.trim(rshape.path, trimmedPath)) bwTess.tessellate(trimmedPath, matrix);
+            } else if (rshape.glyphs && rshape.glyphs->valid(rshape.path)) {
+                bwTess.tessellate(rshape.path, *rshape.glyphs, matrix, glyphs);
+            } else bwTess.tessellate(rshape.path, matrix);
+
+            fillBounds = fill.index.empty() ? RenderRegion{} : bwTess.bounds();
+            fillConvex = bwTess.convex();
+            fillScale = scale;
+#ifdef THORVG_GL_ANALYTIC_AA_SUPPORT
+            _fringe(fill, fillFringe, true);
+#endif
+        }
         fillRule = rshape.rule;
-        bounds = bwTess.bounds();
+        bounds = fillBounds;
+    } else {
+        fill.clear();
+        fillFringe.clear();
+        fillScale = 0.0f;
     }
 
-    if (flag & (RenderUpdateFlag::Stroke | RenderUpdateFlag::GradientStroke | RenderUpdateFlag::Transform)) {
+    if (flag & (RenderUpdateFlag::Stroke | RenderUpdateFlag::GradientStroke)) {
+        if ((changed & (RenderUpdateFlag::Path | RenderUpdateFlag::Stroke)) || !_reusable(strokeScale, scale)) {
+            stroke.clear();
+
+            Stroker stroker{&stroke, matrix, tolerance};
+            stroker.stroke(&rshape);
+            strokeBounds = stroker.bounds();
+            strokeScale = scale;
+#ifdef THORVG_GL_ANALYTIC_AA_SUPPORT
+            _fringe(stroke, strokeFringe, false);
+#endif
+        }
+        bounds = strokeBounds;
+    } else {
         stroke.clear();
-
-        Stroker stroker{&stroke, matrix};
-        stroker.stroke(&rshape);
-        bounds = stroker.bounds();
+        strokeFringe.clear();
+        strokeScale = 0.0f;
     }
 
     return true;
@@ -129,12 +233,33 @@ bool GlGeometry::draw(GlRenderTask* task, GlStageBuffer* gpuBuffer, RenderUpdate
 }
 
 
+bool GlGeometry::drawFringe(GlRenderTask* task, GlStageBuffer* gpuBuffer, RenderUpdateFlag flag)
+{
+    auto buffer = ((flag & RenderUpdateFlag::Stroke) || (flag & RenderUpdateFlag::GradientStroke)) ? &strokeFringe : &fillFringe;
+    if (buffer->index.empty()) return false;
+
+    auto vertexOffset = gpuBuffer->push(buffer->vertex.data, buffer->vertex.count * sizeof(float));
+    auto indexOffset = gpuBuffer->pushIndex(buffer->index.data, buffer->index.count * sizeof(uint32_t));
+
+    // [pos, edge direction, offset, coverage]
+    task->addVertexLayout(GlVertexLayout{0, 2, 6 * sizeof(float), vertexOffset});
+    task->addVertexLayout(GlVertexLayout{1, 4, 6 * sizeof(float), vertexOffset + 2 * sizeof(float)});
+    task->setDrawRange(indexOffset, buffer->index.count);
+    return true;
+}
+
+
 GlStencilMode GlGeometry::getStencilMode(RenderUpdateFlag flag)
 {
     if (flag & RenderUpdateFlag::Stroke) return GlStencilMode::Stroke;
     if (flag & RenderUpdateFlag::GradientStroke) return GlStencilMode::Stroke;
     if (flag & RenderUpdateFlag::Image) return GlStencilMode::None;
 
+#ifndef THORVG_GL_ANALYTIC_AA_SUPPORT
+    //the convex fan covers every pixel once, the fill is drawn in a single pass
+    if (fillConvex) return GlStencilMode::None;
+#endif
+
     if (fillRule == FillRule::NonZero) return GlStencilMode::FillNonZero;
     if (fillRule == FillRule::EvenOdd) return GlStencilMode::FillEvenOdd;
 
@@ -142,6 +267,18 @@ GlStencilMode GlGeometry::getStencilMode(RenderUpdateFlag flag)
 }
 
 
+//the mesh covers every pixel once, or overlaps with an opaque color
+bool GlGeometry::stencilFree(RenderUpdateFlag flag, uint8_t alpha) const
+{
+#ifdef THORVG_GL_ANALYTIC_AA_SUPPORT
+    return false;  //the fringes stay out of the shapes by the stencil
+#endif
+    if (flag & RenderUpdateFlag::Stroke) return alpha == 255;
+    if (flag & RenderUpdateFlag::Color) return fillConvex;
+    return false;
+}
+
+
 RenderRegion GlGeometry::getBounds() const
 {
     if (tvg::identity(&matrix)) return bounds;
@@ -44,7 +44,23 @@ static GLint _getGpuBufferAlign()
 
 void GlGpuBuffer::updateBufferData(Target target, uint32_t size, const void* data)
 {
-    GL_CHECK(glBufferData(static_cast<uint32_t>(target), size, data, GL_STATIC_DRAW));
+    auto type = static_cast<uint32_t>(target);
+
+    //the storage is kept over the frames, it's reallocated only when growing or orphaned
+    if (size > mCapacity || mOrphan) {
+        mCapacity = max(size, mCapacity);
+        mOrphan = false;
+        GL_CHECK(glBufferData(type, mCapacity, nullptr, GL_DYNAMIC_DRAW));
+    }
+
+#ifndef __EMSCRIPTEN__
+    //the gpu doesn't use this storage anymore (see GlStageBuffer::flushToGPU()), skip the driver synchronization
+    if (auto ptr = glMapBufferRange(type, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT)) {
+        memcpy(ptr, data, size);
+        if (glUnmapBuffer(type)) return;
+    }
+#endif
+    GL_CHECK(glBufferSubData(type, 0, size, data));
 }
 
 
@@ -79,7 +95,7 @@ GlGpuBuffer::~GlGpuBuffer()
 /* GlStageBuffer Implementation                                         */
 /************************************************************************/
 
-GlStageBuffer::GlStageBuffer() : mVao(0), mGpuBuffer(), mGpuIndexBuffer()
+GlStageBuffer::GlStageBuffer() : mVao(0)
 {
     GL_CHECK(glGenVertexArrays(1, &mVao));
 }
@@ -87,6 +103,10 @@ GlStageBuffer::GlStageBuffer() : mVao(0), mGpuBuffer(), mGpuIndexBuffer()
 
 GlStageBuffer::~GlStageBuffer()
 {
+    for (auto& slot : mSlots) {
+        if (slot.fence) glDeleteSync(slot.fence);
+    }
+
     if (mVao) {
         glDeleteVertexArrays(1, &mVao);
         mVao = 0;
@@ -94,11 +114,32 @@ GlStageBuffer::~GlStageBuffer()
 }
 
 
+bool GlStageBuffer::reuse(const void* data, uint32_t size, uint32_t& offset)
+{
+    auto cnt = mUniformCnt < GL_STAGE_UNIFORM_HISTORY ? mUniformCnt : GL_STAGE_UNIFORM_HISTORY;
+    for (uint32_t i = 0; i < cnt; ++i) {
+        auto& uniform = mUniforms[i];
+        if (uniform.size == size && !memcmp(mStageBuffer.data + uniform.offset, data, size)) {
+            offset = uniform.offset;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+//the aligned ones are the uniform blocks, an identical block of the frame is bound again instead of being copied
 uint32_t GlStageBuffer::push(void *data, uint32_t size, bool alignGpuOffset)
 {
-    if (alignGpuOffset) alignOffset(size);
+    uint32_t offset;
+
+    if (alignGpuOffset) {
+        if (reuse(data, size, offset)) return offset;
+        alignOffset(size);
+        mUniforms[mUniformCnt++ % GL_STAGE_UNIFORM_HISTORY] = {mStageBuffer.count, size};
+    }
 
-    uint32_t offset = mStageBuffer.count;
+    offset = mStageBuffer.count;
 
     if (this->mStageBuffer.reserved - this->mStageBuffer.count < size) {
         this->mStageBuffer.grow(max(size, this->mStageBuffer.reserved));
@@ -133,20 +174,36 @@ bool GlStageBuffer::flushToGPU()
     if (mStageBuffer.empty() || mIndexBuffer.empty()) {
         mStageBuffer.clear();
         mIndexBuffer.clear();
+        mUniformCnt = 0;
         return false;
     }
 
 
-    mGpuBuffer.bind(GlGpuBuffer::Target::ARRAY_BUFFER);
-    mGpuBuffer.updateBufferData(GlGpuBuffer::Target::ARRAY_BUFFER, mStageBuffer.count, mStageBuffer.data);
-    mGpuBuffer.unbind(GlGpuBuffer::Target::ARRAY_BUFFER);
+    auto& slot = mSlots[mCurrent];
 
-    mGpuIndexBuffer.bind(GlGpuBuffer::Target::ELEMENT_ARRAY_BUFFER);
-    mGpuIndexBuffer.updateBufferData(GlGpuBuffer::Target::ELEMENT_ARRAY_BUFFER, mIndexBuffer.count, mIndexBuffer.data);
-    mGpuIndexBuffer.unbind(GlGpuBuffer::Target::ELEMENT_ARRAY_BUFFER);
+    /* The slot was drawn a ring ago, the gpu is usually done with it. Otherwise its storage is orphaned
+       rather than waiting, the client wait can't block on the web anyway. */
+    if (slot.fence) {
+        auto ret = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (ret != GL_ALREADY_SIGNALED && ret != GL_CONDITION_SATISFIED) {
+            slot.vertex.orphan();
+            slot.index.orphan();
+        }
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+    }
+
+    slot.vertex.bind(GlGpuBuffer::Target::ARRAY_BUFFER);
+    slot.vertex.updateBufferData(GlGpuBuffer::Target::ARRAY_BUFFER, mStageBuffer.count, mStageBuffer.data);
+    slot.vertex.unbind(GlGpuBuffer::Target::ARRAY_BUFFER);
+
+    slot.index.bind(GlGpuBuffer::Target::ELEMENT_ARRAY_BUFFER);
+    slot.index.updateBufferData(GlGpuBuffer::Target::ELEMENT_ARRAY_BUFFER, mIndexBuffer.count, mIndexBuffer.data);
+    slot.index.unbind(GlGpuBuffer::Target::ELEMENT_ARRAY_BUFFER);
 
     mStageBuffer.clear();
     mIndexBuffer.clear();
+    mUniformCnt = 0;
 
     return true;
 }
@@ -154,25 +211,36 @@ bool GlStageBuffer::flushToGPU()
 
 void GlStageBuffer::bind()
 {
+    auto& slot = mSlots[mCurrent];
     glBindVertexArray(mVao);
-    mGpuBuffer.bind(GlGpuBuffer::Target::ARRAY_BUFFER);
-    mGpuBuffer.bind(GlGpuBuffer::Target::UNIFORM_BUFFER);
-    mGpuIndexBuffer.bind(GlGpuBuffer::Target::ELEMENT_ARRAY_BUFFER);
+    slot.vertex.bind(GlGpuBuffer::Target::ARRAY_BUFFER);
+    slot.vertex.bind(GlGpuBuffer::Target::UNIFORM_BUFFER);
+    slot.index.bind(GlGpuBuffer::Target::ELEMENT_ARRAY_BUFFER);
+    mBound = true;
 }
 
 
 void GlStageBuffer::unbind()
 {
+    auto& slot = mSlots[mCurrent];
     glBindVertexArray(0);
-    mGpuBuffer.unbind(GlGpuBuffer::Target::ARRAY_BUFFER);
-    mGpuBuffer.unbind(GlGpuBuffer::Target::UNIFORM_BUFFER);
-    mGpuIndexBuffer.unbind(GlGpuBuffer::Target::ELEMENT_ARRAY_BUFFER);
+    slot.vertex.unbind(GlGpuBuffer::Target::ARRAY_BUFFER);
+    slot.vertex.unbind(GlGpuBuffer::Target::UNIFORM_BUFFER);
+    slot.index.unbind(GlGpuBuffer::Target::ELEMENT_ARRAY_BUFFER);
+
+    //the frame is submitted, fence its slot and move on to the next one
+    if (mBound) {
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        mCurrent = (mCurrent + 1) % GL_STAGE_RING_SIZE;
+        mBound = false;
+    }
 }
 
 
+//the buffer of the frame being recorded, the draw commands refer to it before the flush
 GLuint GlStageBuffer::getBufferId()
 {
-    return mGpuBuffer.getBufferId();
+    return mSlots[mCurrent].vertex.getBufferId();
 }
 
 
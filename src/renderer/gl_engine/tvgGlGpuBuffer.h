@@ -25,6 +25,9 @@
 
 #include "tvgGlCommon.h"
 
+#define GL_STAGE_RING_SIZE 3    //the frames the gpu may lag behind
+#define GL_STAGE_UNIFORM_HISTORY 8  //the recent uniform blocks an identical one reuses
+
 class GlGpuBuffer
 {
 public:
@@ -42,8 +45,13 @@ public:
     void unbind(Target target);
     uint32_t getBufferId() { return mGlBufferId; }
 
+    //let the next update take a fresh storage, the current one is still in use by the gpu
+    void orphan() { mOrphan = true; }
+
 private:
     uint32_t    mGlBufferId = 0;
+    uint32_t    mCapacity = 0;      //the allocated storage in bytes
+    bool        mOrphan = false;
 
 };
 
@@ -54,6 +62,8 @@ public:
 
     uint32_t push(void* data, uint32_t size, bool alignGpuOffset = false);
     uint32_t pushIndex(void* data, uint32_t size);
+    uint32_t offset() const { return mStageBuffer.count; }      //where the next push goes
+    uint32_t indexOffset() const { return mIndexBuffer.count; }
     bool flushToGPU();
     void bind();
     void unbind();
@@ -61,12 +71,27 @@ public:
 
 private:
     void alignOffset(uint32_t size);
+    bool reuse(const void* data, uint32_t size, uint32_t& offset);
+
+    //the buffers of a frame, reused once the gpu signals its fence
+    struct Slot
+    {
+        GlGpuBuffer vertex;     //vertices and uniforms
+        GlGpuBuffer index;
+        GLsync fence = nullptr;
+    };
 
     GLuint mVao = 0;
-    GlGpuBuffer mGpuBuffer = {};
-    GlGpuBuffer mGpuIndexBuffer = {};
+    Slot mSlots[GL_STAGE_RING_SIZE];
+    uint32_t mCurrent = 0;
+    bool mBound = false;
     Array<uint8_t> mStageBuffer = {};
     Array<uint8_t> mIndexBuffer = {};
+    //the uniform blocks pushed lately, the draws of a kind often repeat their parameters
+    struct {
+        uint32_t offset, size;
+    } mUniforms[GL_STAGE_UNIFORM_HISTORY];
+    uint32_t mUniformCnt = 0;
 };
 
 #endif /* _TVG_GL_GPU_BUFFER_H_ */
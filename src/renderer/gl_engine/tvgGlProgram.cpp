@@ -21,6 +21,9 @@
  */
 
 #include "tvgGlProgram.h"
+#include "tvgCompressor.h"
+#include "tvgLock.h"
+#include "tvgStr.h"
 
 /************************************************************************/
 /* Internal Class Implementation                                        */
@@ -29,18 +32,109 @@
 uint32_t GlProgram::mCurrentProgram = 0;
 
 
-/************************************************************************/
-/* External Class Implementation                                        */
-/************************************************************************/
+//the linked binaries of the process, a renderer or a context made later skips the shader compilation
+struct GlProgramBinary
+{
+    unsigned long vert, frag;  //the source hashes
+    GLenum format;
+    GLsizei size;
+    void* data;
+};
+
+static Array<GlProgramBinary> _binaries;
+static Key _key;
 
-GlProgram::GlProgram(const char* vertSrc, const char* fragSrc)
+
+static bool _supportBinary()
 {
-    auto shader = GlShader(vertSrc, fragSrc);
+#ifdef __EMSCRIPTEN__
+    return false;
+#else
+    static GLint formats = -1;
+    if (formats < 0) {
+        formats = 0;
+        if (glGetProgramBinary && glProgramBinary && glProgramParameteri) glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    }
+    return formats > 0;
+#endif
+}
+
+
+static uint32_t _load(unsigned long vert, unsigned long frag)
+{
+#ifndef __EMSCRIPTEN__
+    ScopedLock lock(_key);
+
+    ARRAY_FOREACH(p, _binaries) {
+        if (p->vert != vert || p->frag != frag) continue;
+
+        auto progObj = glCreateProgram();
+        glProgramBinary(progObj, p->format, p->data, p->size);
+
+        //a driver update may reject the binary
+        GLint linked;
+        glGetProgramiv(progObj, GL_LINK_STATUS, &linked);
+        if (linked) return progObj;
+
+        glDeleteProgram(progObj);
+        tvg::free(p->data);
+        *p = _binaries.last();
+        _binaries.pop();
+        break;
+    }
+#endif
+    return 0;
+}
+
+
+static void _save(uint32_t progObj, unsigned long vert, unsigned long frag)
+{
+#ifndef __EMSCRIPTEN__
+    GLint size = 0;
+    glGetProgramiv(progObj, GL_PROGRAM_BINARY_LENGTH, &size);
+    if (size <= 0) return;
+
+    GlProgramBinary binary{vert, frag, 0, 0, tvg::malloc<void*>(size)};
+    glGetProgramBinary(progObj, size, &binary.size, &binary.format, binary.data);
+    if (binary.size <= 0) {
+        tvg::free(binary.data);
+        return;
+    }
+
+    ScopedLock lock(_key);
+    _binaries.push(binary);
+#endif
+}
+
+
+uint32_t GlProgram::id()
+{
+    if (mProgramObj == 0) mProgramObj = link();
+    return mProgramObj;
+}
+
+
+uint32_t GlProgram::link()
+{
+    unsigned long vert = 0, frag = 0;
+    auto binary = _supportBinary();
+
+    if (binary) {
+        vert = djb2Encode(mVertSrc);
+        frag = djb2Encode(mFragSrc);
+        if (auto progObj = _load(vert, frag)) return progObj;
+    }
+
+    auto shader = GlShader(mVertSrc, mFragSrc);
 
     // Create the program object
     uint32_t progObj = glCreateProgram();
     assert(progObj);
 
+#ifndef __EMSCRIPTEN__
+    if (binary) glProgramParameteri(progObj, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+
     glAttachShader(progObj, shader.getVertexShader());
     glAttachShader(progObj, shader.getFragmentShader());
 
@@ -66,26 +160,52 @@ GlProgram::GlProgram(const char* vertSrc, const char* fragSrc)
         progObj = 0;
         assert(0);
     }
-    mProgramObj = progObj;
+
+    if (progObj && binary) _save(progObj, vert, frag);
+
+    return progObj;
+}
+
+
+/************************************************************************/
+/* External Class Implementation                                        */
+/************************************************************************/
+
+//the sources may be temporal, the program is linked on demand
+GlProgram::GlProgram(const char* vertSrc, const char* fragSrc) : mVertSrc(duplicate(vertSrc)), mFragSrc(duplicate(fragSrc))
+{
+    memset(mBlockPoints, 0xff, sizeof(mBlockPoints));
 }
 
 
 GlProgram::~GlProgram()
 {
-    if (mCurrentProgram == mProgramObj) unload();
-    glDeleteProgram(mProgramObj);
+    if (mProgramObj) {
+        if (mCurrentProgram == mProgramObj) unload();
+        glDeleteProgram(mProgramObj);
+    }
+    tvg::free(mVertSrc);
+    tvg::free(mFragSrc);
 }
 
 
 void GlProgram::load()
 {
-    if (mCurrentProgram == mProgramObj) return;
+    if (mCurrentProgram == id()) return;
     mCurrentProgram = mProgramObj;
     GL_CHECK(glUseProgram(mProgramObj));
 
 }
 
 
+void GlProgram::term()
+{
+    ScopedLock lock(_key);
+    ARRAY_FOREACH(p, _binaries) tvg::free(p->data);
+    _binaries.reset();
+}
+
+
 void GlProgram::unload()
 {
     mCurrentProgram = 0;
@@ -99,21 +219,50 @@ int32_t GlProgram::getAttributeLocation(const char* name)
 }
 
 
+//the names are the literals of the callers, compared by their contents as the pointers may differ over the units
+int32_t GlProgram::lookup(Array<GlLocation>& cache, const char* name, bool block)
+{
+    ARRAY_FOREACH(p, cache) {
+        if (p->name == name || !strcmp(p->name, name)) return p->value;
+    }
+    int32_t value;
+    if (block) {
+        GL_CHECK(value = glGetUniformBlockIndex(id(), name));
+    } else {
+        GL_CHECK(value = glGetUniformLocation(id(), name));
+    }
+    cache.push({name, value});
+    return value;
+}
+
+
 int32_t GlProgram::getUniformLocation(const char* name)
 {
-    GL_CHECK(int32_t location = glGetUniformLocation(mProgramObj, name));
-    return location;
+    return lookup(mUniforms, name, false);
 }
 
+
 int32_t GlProgram::getUniformBlockIndex(const char* name)
 {
-    GL_CHECK(int32_t index = glGetUniformBlockIndex(mProgramObj, name));
-    return index;
+    return lookup(mBlocks, name, true);
+}
+
+
+//the binding is a state of the program object, it survives the frames
+void GlProgram::bindUniformBlock(int32_t index, uint32_t bindPoint)
+{
+    if (index < 0) return;
+    if (index < GL_PROGRAM_MAX_BLOCKS) {
+        if (mBlockPoints[index] == bindPoint) return;
+        mBlockPoints[index] = bindPoint;
+    }
+    GL_CHECK(glUniformBlockBinding(id(), index, bindPoint));
 }
 
+
 uint32_t GlProgram::getProgramId()
 {
-    return mProgramObj;
+    return id();
 }
 
 void GlProgram::setUniform1Value(int32_t location, int count, const int* values)
@@ -25,6 +25,15 @@
 
 #include "tvgGlShader.h"
 
+#define GL_PROGRAM_MAX_BLOCKS 8    //the uniform blocks whose bindings are tracked
+
+struct GlLocation
+{
+    const char* name;
+    int32_t value;
+};
+
+//the program is built on its first use, from the binary of an identical one built before if possible
 class GlProgram
 {
 public:
@@ -33,9 +42,11 @@ public:
 
     void load();
     static void unload();
+    static void term();  //releases the program binaries
     int32_t getAttributeLocation(const char* name);
     int32_t getUniformLocation(const char* name);
     int32_t getUniformBlockIndex(const char* name);
+    void bindUniformBlock(int32_t index, uint32_t bindPoint);
     uint32_t getProgramId();
     void setUniform1Value(int32_t location, int count, const int* values);
     void setUniform2Value(int32_t location, int count, const int* values);
@@ -48,7 +59,17 @@ public:
     void setUniform4x4Value(int32_t location, int count, const float* values);
 
 private:
-    uint32_t mProgramObj;
+    uint32_t id();
+    uint32_t link();
+    int32_t lookup(Array<GlLocation>& cache, const char* name, bool block);
+
+    char* mVertSrc;
+    char* mFragSrc;
+    uint32_t mProgramObj = 0;
+    //the draws query the same few names over and over, the driver is asked once
+    Array<GlLocation> mUniforms;
+    Array<GlLocation> mBlocks;
+    uint8_t mBlockPoints[GL_PROGRAM_MAX_BLOCKS];
     static uint32_t mCurrentProgram;
 };
 
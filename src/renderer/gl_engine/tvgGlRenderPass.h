@@ -41,6 +41,8 @@ public:
 
     void addRenderTask(GlRenderTask* task);
 
+    GlRenderTask* lastTask() { return mTasks.empty() ? nullptr : mTasks.last(); }
+
     GLuint getFboId() { return mFbo->getFboId(); }
 
     GLuint getTextureId() { return mFbo->getColorTexture(); }
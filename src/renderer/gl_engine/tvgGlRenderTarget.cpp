@@ -29,12 +29,15 @@ GlRenderTarget::~GlRenderTarget()
     reset();
 }
 
-void GlRenderTarget::init(uint32_t width, uint32_t height, GLint resolveId)
+void GlRenderTarget::init(uint32_t width, uint32_t height, GLint resolveId, bool alpha)
 {
     if (width == 0 || height == 0) return;
 
     mWidth = width;
     mHeight = height;
+    mAlpha = alpha;
+
+    auto format = alpha ? GL_R8 : GL_RGBA8;
 
     //TODO: fbo is used. maybe we can consider the direct rendering with resolveId as well.
     GL_CHECK(glGenFramebuffers(1, &mFbo));
@@ -43,13 +46,13 @@ void GlRenderTarget::init(uint32_t width, uint32_t height, GLint resolveId)
 
     GL_CHECK(glGenRenderbuffers(1, &mColorBuffer));
     GL_CHECK(glBindRenderbuffer(GL_RENDERBUFFER, mColorBuffer));
-    GL_CHECK(glRenderbufferStorageMultisample(GL_RENDERBUFFER, 4, GL_RGBA8, mWidth, mHeight));
+    GL_CHECK(glRenderbufferStorageMultisample(GL_RENDERBUFFER, GL_MSAA_SAMPLES, format, mWidth, mHeight));
 
     GL_CHECK(glGenRenderbuffers(1, &mDepthStencilBuffer));
 
     GL_CHECK(glBindRenderbuffer(GL_RENDERBUFFER, mDepthStencilBuffer));
 
-    GL_CHECK(glRenderbufferStorageMultisample(GL_RENDERBUFFER, 4, GL_DEPTH24_STENCIL8, mWidth, mHeight));
+    GL_CHECK(glRenderbufferStorageMultisample(GL_RENDERBUFFER, GL_MSAA_SAMPLES, GL_DEPTH24_STENCIL8, mWidth, mHeight));
 
     GL_CHECK(glBindRenderbuffer(GL_RENDERBUFFER, 0));
 
@@ -60,7 +63,15 @@ void GlRenderTarget::init(uint32_t width, uint32_t height, GLint resolveId)
     GL_CHECK(glGenTextures(1, &mColorTex));
 
     GL_CHECK(glBindTexture(GL_TEXTURE_2D, mColorTex));
-    GL_CHECK(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, mWidth, mHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+    GL_CHECK(glTexImage2D(GL_TEXTURE_2D, 0, format, mWidth, mHeight, 0, alpha ? GL_RED : GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+
+    //the coverage is read as (a, a, a, a) by the shaders made for the color targets
+    if (alpha) {
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, GL_RED));
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_RED));
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_RED));
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_RED));
+    }
 
     GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
     GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
@@ -94,9 +105,7 @@ GlRenderTargetPool::GlRenderTargetPool(uint32_t maxWidth, uint32_t maxHeight): m
 
 GlRenderTargetPool::~GlRenderTargetPool()
 {
-    for (uint32_t i = 0; i < mPool.count; i++) {
-        delete mPool[i];
-    }
+    ARRAY_FOREACH(p, mPool) delete(p->target);
 }
 
 uint32_t alignPow2(uint32_t value)
@@ -108,7 +117,16 @@ uint32_t alignPow2(uint32_t value)
     return ret;
 }
 
-GlRenderTarget* GlRenderTargetPool::getRenderTarget(const RenderRegion& vp, GLuint resolveId)
+//multisampled color and depth-stencil, and the resolved texture
+static size_t _size(const GlRenderTarget* rt)
+{
+    size_t bpp = rt->alpha() ? 1 : 4;
+    return size_t(rt->getWidth()) * rt->getHeight() * (max(GL_MSAA_SAMPLES, 1) * (bpp + 4) + bpp);
+}
+
+/* The compositions of a pass take the distinct targets up to GL_TARGET_MAX_SIBLINGS of a size,
+   they're drawn ahead of the pass in a row then. see GlComposeTask::run() */
+GlRenderTarget* GlRenderTargetPool::getRenderTarget(const RenderRegion& vp, GLuint resolveId, bool alpha, const void* owner)
 {
     auto width = vp.w();
     auto height = vp.h();
@@ -122,17 +140,69 @@ GlRenderTarget* GlRenderTargetPool::getRenderTarget(const RenderRegion& vp, GLui
     else height = alignPow2(height);
     if (height >= mMaxHeight) height = mMaxHeight;
 
-    for (uint32_t i = 0; i < mPool.count; i++) {
-        auto rt = mPool[i];
-        if (rt->getWidth() == width && rt->getHeight() == height) {
+    Entry* sibling = nullptr;
+    auto siblings = 0;
+
+    ARRAY_FOREACH(p, mPool) {
+        auto rt = p->target;
+        if (rt->getWidth() == width && rt->getHeight() == height && rt->alpha() == alpha) {
+            if (owner && p->owner == owner && p->frame == mFrame) {
+                if (!sibling) sibling = p;
+                ++siblings;
+                continue;
+            }
             rt->setViewport(vp);
+            p->frame = mFrame;
+            p->owner = owner;
+            ++hits;
             return rt;
         }
     }
 
+    //the siblings share a target beyond the limit, they're drawn in the separate rows
+    if (siblings >= GL_TARGET_MAX_SIBLINGS) {
+        sibling->target->setViewport(vp);
+        ++hits;
+        return sibling->target;
+    }
+
     auto rt = new GlRenderTarget();
-    rt->init(width, height, resolveId);
+    rt->init(width, height, resolveId, alpha);
     rt->setViewport(vp);
-    mPool.push(rt);
+    mPool.push({rt, mFrame, owner});
+    mSize += _size(rt);
+    ++misses;
     return rt;
 }
+
+void GlRenderTargetPool::remove(uint32_t idx)
+{
+    mSize -= _size(mPool[idx].target);
+    delete(mPool[idx].target);
+    mPool[idx] = mPool.last();
+    mPool.pop();
+}
+
+void GlRenderTargetPool::reclaim()
+{
+    //drop the targets out of use for a while
+    for (uint32_t i = 0; i < mPool.count; ) {
+        if (mFrame - mPool[i].frame > GL_TARGET_MAX_AGE) remove(i);
+        else ++i;
+    }
+
+    //over the budget, the least recently used go first. the ones of this frame stay for the next one
+    while (mSize > GL_TARGET_POOL_BUDGET) {
+        uint32_t oldest = 0;
+        for (uint32_t i = 1; i < mPool.count; ++i) {
+            if (mPool[i].frame < mPool[oldest].frame) oldest = i;
+        }
+        if (mPool.empty() || mPool[oldest].frame == mFrame) break;
+        remove(oldest);
+    }
+
+    if (misses > 0) TVGLOG("GL_ENGINE", "Render target pool(%p): hits = %u, misses = %u, targets = %u, size = %zu KB", this, hits, misses, mPool.count, mSize / 1024);
+
+    hits = misses = 0;
+    ++mFrame;
+}
@@ -31,7 +31,7 @@ public:
     GlRenderTarget();
     ~GlRenderTarget();
 
-    void init(uint32_t width, uint32_t height, GLint resolveId);
+    void init(uint32_t width, uint32_t height, GLint resolveId, bool alpha = false);
     void reset();
 
     GLuint getFboId() { return mFbo; }
@@ -45,6 +45,7 @@ public:
     const RenderRegion& getViewport() const { return mViewport; }
 
     bool invalid() const { return mFbo == 0; }
+    bool alpha() const { return mAlpha; }
 
 private:
     uint32_t mWidth = 0;
@@ -55,18 +56,41 @@ private:
     GLuint mDepthStencilBuffer = 0;
     GLuint mResolveFbo = 0;
     GLuint mColorTex = 0;
+    bool mAlpha = false;  //single channel(R8) coverage of the alpha masks, it's sampled in all the components
 };
 
+#define GL_TARGET_MAX_AGE 60                   //frames an unused target is kept for
+#define GL_TARGET_POOL_BUDGET (64 * 1024 * 1024)  //bytes of a pool beyond which the stale targets go first
+#define GL_TARGET_MAX_SIBLINGS 4               //the same sized targets a pass takes at once for its compositions
+
+//the targets are bucketed by the power of two sizes and the formats, they live until they're unused for a while
 class GlRenderTargetPool {
 public:
     GlRenderTargetPool(uint32_t maxWidth, uint32_t maxHeight);
     ~GlRenderTargetPool();
 
-    GlRenderTarget* getRenderTarget(const RenderRegion& vp, GLuint resolveId = 0);
+    GlRenderTarget* getRenderTarget(const RenderRegion& vp, GLuint resolveId = 0, bool alpha = false, const void* owner = nullptr);
+    void reclaim();  //ends a frame
+
+    size_t size() const { return mSize; }
+
+    uint32_t hits = 0;
+    uint32_t misses = 0;
 private:
+    struct Entry
+    {
+        GlRenderTarget* target;
+        uint32_t frame;  //the last used
+        const void* owner;  //the pass composing the target in the frame
+    };
+
+    void remove(uint32_t idx);
+
     uint32_t mMaxWidth = 0;
     uint32_t mMaxHeight = 0;
-    Array<GlRenderTarget*> mPool;
+    uint32_t mFrame = 0;
+    size_t mSize = 0;  //video memory in bytes
+    Array<Entry> mPool;
 };
 
 #endif //_TVG_GL_RENDER_RENDER_TARGET_H_
\ No newline at end of file
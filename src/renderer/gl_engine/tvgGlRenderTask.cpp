@@ -37,6 +37,27 @@ GlRenderTask::GlRenderTask(GlProgram* program, GlRenderTask* other): mProgram(pr
 }
 
 
+//the uniform ranges bound to the points, the consecutive draws mostly share them
+static GlBindingResource _ranges[GL_UNIFORM_BIND_POINTS];
+
+
+void GlRenderTask::resetBindings()
+{
+    for (auto& range : _ranges) range = {};
+}
+
+
+void GlRenderTask::bindRange(const GlBindingResource& binding)
+{
+    if (binding.bindPoint < GL_UNIFORM_BIND_POINTS) {
+        auto& range = _ranges[binding.bindPoint];
+        if (range.gBufferId == binding.gBufferId && range.bufferOffset == binding.bufferOffset && range.bufferRange == binding.bufferRange) return;
+        range = binding;
+    }
+    GL_CHECK(glBindBufferRange(GL_UNIFORM_BUFFER, binding.bindPoint, binding.gBufferId, binding.bufferOffset, binding.bufferRange));
+}
+
+
 void GlRenderTask::run()
 {
     // bind shader
@@ -70,9 +91,8 @@ void GlRenderTask::run()
             mProgram->setUniform1Value(binding.location, 1, (int32_t*)&binding.bindPoint);
         } else if (binding.type == GlBindingType::kUniformBuffer) {
 
-            GL_CHECK(glUniformBlockBinding(mProgram->getProgramId(), binding.location, binding.bindPoint));
-            GL_CHECK(glBindBufferRange(GL_UNIFORM_BUFFER, binding.bindPoint, binding.gBufferId,
-                                       binding.bufferOffset, binding.bufferRange));
+            mProgram->bindUniformBlock(binding.location, binding.bindPoint);
+            bindRange(binding);
         }
     }
 
@@ -117,8 +137,8 @@ void GlRenderTask::setViewport(const RenderRegion &viewport)
 /* GlStencilCoverTask Class Implementation                              */
 /************************************************************************/
 
-GlStencilCoverTask::GlStencilCoverTask(GlRenderTask* stencil, GlRenderTask* cover, GlStencilMode mode)
- :GlRenderTask(nullptr), mStencilTask(stencil), mCoverTask(cover), mStencilMode(mode)
+GlStencilCoverTask::GlStencilCoverTask(GlRenderTask* stencil, GlRenderTask* cover, GlStencilMode mode, GlRenderTask* fringe)
+ :GlRenderTask(nullptr), mStencilTask(stencil), mCoverTask(cover), mFringeTask(fringe), mStencilMode(mode)
  {
 
  }
@@ -128,6 +148,7 @@ GlStencilCoverTask::~GlStencilCoverTask()
 {
     delete mStencilTask;
     delete mCoverTask;
+    delete mFringeTask;
 }
 
 
@@ -149,18 +170,40 @@ void GlStencilCoverTask::run()
 
     mStencilTask->run();
 
+    GL_CHECK(glColorMask(1, 1, 1, 1));
+
+    // the fringes blend once around the shape, the pixels are marked by the top bit
+    if (mFringeTask) {
+        GL_CHECK(glStencilFunc(GL_EQUAL, 0x0, mStencilMode == GlStencilMode::FillEvenOdd ? 0x81 : 0xFF));
+        GL_CHECK(glStencilOp(GL_KEEP, GL_KEEP, GL_INVERT));
+        GL_CHECK(glStencilMask(0x80));
+
+        mFringeTask->run();
+
+        GL_CHECK(glStencilMask(0xFF));
+    }
+
     if (mStencilMode == GlStencilMode::FillEvenOdd) {
         GL_CHECK(glStencilFunc(GL_NOTEQUAL, 0x00, 0x01));
         GL_CHECK(glStencilOp(GL_REPLACE, GL_KEEP, GL_REPLACE));
     } else {
-        GL_CHECK(glStencilFunc(GL_NOTEQUAL, 0x0, 0xFF));
+        GL_CHECK(glStencilFunc(GL_NOTEQUAL, 0x0, mFringeTask ? 0x7F : 0xFF));
         GL_CHECK(glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE));
     }
 
-    GL_CHECK(glColorMask(1, 1, 1, 1));
-
     mCoverTask->run();
 
+    // clear the marks out of the shape
+    if (mFringeTask) {
+        GL_CHECK(glColorMask(0, 0, 0, 0));
+        GL_CHECK(glStencilFunc(GL_NOTEQUAL, 0x0, 0x80));
+        GL_CHECK(glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE));
+
+        mFringeTask->run();
+
+        GL_CHECK(glColorMask(1, 1, 1, 1));
+    }
+
     GL_CHECK(glDisable(GL_STENCIL_TEST));
 }
 
@@ -169,6 +212,35 @@ void GlStencilCoverTask::normalizeDrawDepth(int32_t maxDepth)
 {
     mCoverTask->normalizeDrawDepth(maxDepth);
     mStencilTask->normalizeDrawDepth(maxDepth);
+    if (mFringeTask) mFringeTask->normalizeDrawDepth(maxDepth);
+}
+
+
+/************************************************************************/
+/* GlBatchTask Class Implementation                                     */
+/************************************************************************/
+
+GlBatchTask::GlBatchTask(GlProgram* program, uint32_t vertexOffset, uint32_t indexOffset)
+ : GlRenderTask(program), mVertexOffset(vertexOffset), mIndexOffset(indexOffset)
+{
+    addVertexLayout(GlVertexLayout{0, 3, STRIDE, vertexOffset});
+    addVertexLayout(GlVertexLayout{1, 4, STRIDE, vertexOffset + 3 * sizeof(float)});
+}
+
+
+bool GlBatchTask::joinable(uint32_t vertexOffset, uint32_t indexOffset, const RenderRegion& viewport) const
+{
+    if (mVertexOffset + mVertexCount * STRIDE != vertexOffset) return false;
+    if (mIndexOffset + mIndexCount * sizeof(uint32_t) != indexOffset) return false;
+    return getViewport() == viewport;
+}
+
+
+void GlBatchTask::join(uint32_t vertexCount, uint32_t indexCount)
+{
+    mVertexCount += vertexCount;
+    mIndexCount += indexCount;
+    setDrawRange(mIndexOffset, mIndexCount);
 }
 
 
@@ -191,30 +263,82 @@ GlComposeTask::~GlComposeTask()
 }
 
 
-void GlComposeTask::run()
+void GlComposeTask::bind(bool clear)
 {
     GL_CHECK(glBindFramebuffer(GL_FRAMEBUFFER, getSelfFbo()));
 
-    // we must clear all area of fbo
-    GL_CHECK(glViewport(0, 0, mFbo->getWidth(), mFbo->getHeight()));
-    GL_CHECK(glScissor(0, 0, mFbo->getWidth(), mFbo->getHeight()));
-    GL_CHECK(glClearColor(0, 0, 0, 0));
-    GL_CHECK(glClearStencil(0));
+    if (clear) {
+        // we must clear all area of fbo
+        GL_CHECK(glViewport(0, 0, mFbo->getWidth(), mFbo->getHeight()));
+        GL_CHECK(glScissor(0, 0, mFbo->getWidth(), mFbo->getHeight()));
+        GL_CHECK(glClearColor(0, 0, 0, 0));
+        GL_CHECK(glClearStencil(0));
 #ifdef THORVG_GL_TARGET_GLES
-    GL_CHECK(glClearDepthf(0.0));
+        GL_CHECK(glClearDepthf(0.0));
 #else
-    GL_CHECK(glClearDepth(0.0));
+        GL_CHECK(glClearDepth(0.0));
 #endif
-    GL_CHECK(glDepthMask(1));
+        GL_CHECK(glDepthMask(1));
 
-    GL_CHECK(glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
-    GL_CHECK(glDepthMask(0));
+        GL_CHECK(glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+        GL_CHECK(glDepthMask(0));
+    }
 
     GL_CHECK(glViewport(0, 0, mRenderWidth, mRenderHeight));
     GL_CHECK(glScissor(0, 0, mRenderWidth, mRenderHeight));
+}
+
 
+//draws the compositions of a row ahead, returns the task ending the row
+uint32_t GlComposeTask::hoist(uint32_t from, Array<GlRenderTarget*>& targets)
+{
+    targets.clear();
+    targets.push(mFbo);
+
+    auto i = from;
+    for (; i < mTasks.count; ++i) {
+        if (mTasks[i]->offscreen() && !mTasks[i]->hoist(targets)) break;
+    }
+    return i;
+}
+
+
+//a leaf composition draws into its own target only, it's free to go ahead of the parent pass
+bool GlComposeTask::hoist(Array<GlRenderTarget*>& targets)
+{
     ARRAY_FOREACH(p, mTasks) {
-        (*p)->run();
+        if ((*p)->offscreen()) return false;
+    }
+    ARRAY_FOREACH(p, targets) {
+        if (*p == mFbo) return false;
+    }
+
+    GlComposeTask::run();
+    mHoisted = true;
+    targets.push(mFbo);
+
+    return true;
+}
+
+
+void GlComposeTask::run()
+{
+    if (mHoisted) return;
+
+    /* The compositions are drawn ahead in rows, and the target is bound once for a row
+       instead of every one of them. The tiled gpus store and reload the target on every bind.
+       A row ends at the task interrupting the pass, or at the target taken in the row already. */
+    Array<GlRenderTarget*> targets;
+    auto row = hoist(0, targets);
+
+    bind(true);
+
+    for (uint32_t i = 0; i < mTasks.count; ++i) {
+        if (i >= row) {
+            row = hoist(i, targets);
+            if (targets.count > 1) bind(false);
+        }
+        mTasks[i]->run();
     }
 
 #if defined(THORVG_GL_TARGET_GLES)
@@ -266,6 +390,8 @@ void GlBlitTask::run()
     GL_CHECK(glViewport(mTargetViewport.x(), mTargetViewport.y(), mTargetViewport.w(), mTargetViewport.h()));
 
     if (mClearBuffer) {
+        const auto& vp = getViewport();
+        GL_CHECK(glScissor(vp.sx(), vp.sy(), vp.sw(), vp.sh()));
         GL_CHECK(glClearColor(0, 0, 0, 0));
         GL_CHECK(glClear(GL_COLOR_BUFFER_BIT));
     }
@@ -296,6 +422,14 @@ GlDrawBlitTask::~GlDrawBlitTask()
 }
 
 
+bool GlDrawBlitTask::hoist(Array<GlRenderTarget*>& targets)
+{
+    //the mask goes first as it does in run()
+    if (mPrevTask && !mPrevTask->hoist(targets)) return false;
+    return GlComposeTask::hoist(targets);
+}
+
+
 void GlDrawBlitTask::run()
 {
     if (mPrevTask) mPrevTask->run();
@@ -410,15 +544,17 @@ void GlComplexBlendTask::run()
 {
     mComposeTask->run();
 
-    // copy the current fbo to the dstCopyFbo
-    GL_CHECK(glBindFramebuffer(GL_READ_FRAMEBUFFER, mDstFbo->getFboId()));
-    GL_CHECK(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mDstCopyFbo->getResolveFboId()));
+    // copy the current fbo to the dstCopyFbo, the framebuffer fetch reads it in place without it
+    if (mDstCopyFbo) {
+        GL_CHECK(glBindFramebuffer(GL_READ_FRAMEBUFFER, mDstFbo->getFboId()));
+        GL_CHECK(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mDstCopyFbo->getResolveFboId()));
+
+        GL_CHECK(glViewport(0, 0, mDstFbo->getViewport().w(), mDstFbo->getViewport().h()));
+        GL_CHECK(glScissor(0, 0, mDstFbo->getViewport().w(), mDstFbo->getViewport().h()));
 
-    GL_CHECK(glViewport(0, 0, mDstFbo->getViewport().w(), mDstFbo->getViewport().h()));
-    GL_CHECK(glScissor(0, 0, mDstFbo->getViewport().w(), mDstFbo->getViewport().h()));
-    
-    const auto& vp = getViewport();
-    GL_CHECK(glBlitFramebuffer(vp.min.x, vp.min.y, vp.max.x, vp.max.y, 0, 0, vp.w(), vp.h(), GL_COLOR_BUFFER_BIT, GL_LINEAR));
+        const auto& vp = getViewport();
+        GL_CHECK(glBlitFramebuffer(vp.min.x, vp.min.y, vp.max.x, vp.max.y, 0, 0, vp.w(), vp.h(), GL_COLOR_BUFFER_BIT, GL_LINEAR));
+    }
 
     GL_CHECK(glBindFramebuffer(GL_FRAMEBUFFER, mDstFbo->getFboId()));
 
@@ -519,8 +655,7 @@ void GlEffectDropShadowTask::run()
     const auto height = mDstFbo->getHeight();
 
     // get targets handles
-    GLuint dstCopyTexId0 = mDstCopyFbo0->getColorTexture();
-    GLuint dstCopyTexId1 = mDstCopyFbo1->getColorTexture();
+    GLuint dstCopyTexId = mDstCopyFbo->getColorTexture();
     // get programs properties
     GlProgram* programHorz = horzTask->getProgram();
     GlProgram* programVert = vertTask->getProgram();
@@ -529,39 +664,34 @@ void GlEffectDropShadowTask::run()
 
     GLint srcTextureLoc = getProgram()->getUniformLocation("uSrcTexture");
     GLint blrTextureLoc = getProgram()->getUniformLocation("uBlrTexture");
-    addBindResource({ 0, dstCopyTexId0, srcTextureLoc });
-    addBindResource({ 1, dstCopyTexId1, blrTextureLoc });
 
     GL_CHECK(glViewport(0, 0, width, height));
     GL_CHECK(glScissor(0, 0, width, height));
 
-    // we need to make a full copy of dst to intermediate buffers to be sure that they don’t contain prev data.
+    // the copy of dst is the original image and the source of the shadow alpha as well, it stays intact.
     GL_CHECK(glBindFramebuffer(GL_READ_FRAMEBUFFER, mDstFbo->getFboId()));
-    GL_CHECK(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mDstCopyFbo0->getResolveFboId()));
-    GL_CHECK(glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST));
-    GL_CHECK(glBindFramebuffer(GL_READ_FRAMEBUFFER, mDstFbo->getFboId()));
-    GL_CHECK(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mDstCopyFbo1->getResolveFboId()));
+    GL_CHECK(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mDstCopyFbo->getResolveFboId()));
     GL_CHECK(glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST));
-    
+
     GL_CHECK(glDisable(GL_BLEND));
     // when sigma is 0, no blur is applied, and the original image is used directly as the shadow.
+    auto blrTexId = dstCopyTexId;
     if (!tvg::zero(effect->sigma)) {
-        // horizontal blur
-        GL_CHECK(glBindFramebuffer(GL_FRAMEBUFFER, mDstCopyFbo0->getResolveFboId()));
+        // horizontal blur of the alpha into the single channel target
+        GL_CHECK(glBindFramebuffer(GL_FRAMEBUFFER, mAlphaFbo0->getResolveFboId()));
         horzTask->setViewport(vp);
-        horzTask->addBindResource({ 0, dstCopyTexId1, horzSrcTextureLoc });
+        horzTask->addBindResource({ 0, dstCopyTexId, horzSrcTextureLoc });
         horzTask->run();
-        // vertical blur
-        GL_CHECK(glBindFramebuffer(GL_FRAMEBUFFER, mDstCopyFbo1->getResolveFboId()));
+        // vertical blur, the single channel texture is read as (a, a, a, a)
+        GL_CHECK(glBindFramebuffer(GL_FRAMEBUFFER, mAlphaFbo1->getResolveFboId()));
         vertTask->setViewport(vp);
-        vertTask->addBindResource({ 0, dstCopyTexId0, vertSrcTextureLoc });
+        vertTask->addBindResource({ 0, mAlphaFbo0->getColorTexture(), vertSrcTextureLoc });
         vertTask->run();
-        // copy original image to intermediate buffer
-        GL_CHECK(glBindFramebuffer(GL_READ_FRAMEBUFFER, mDstFbo->getFboId()));
-        GL_CHECK(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mDstCopyFbo0->getResolveFboId()));
-        GL_CHECK(glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST));
+        blrTexId = mAlphaFbo1->getColorTexture();
     }
-    // run drop shadow effect
+    // run drop shadow effect, colorizing the blurred alpha
+    addBindResource({ 0, dstCopyTexId, srcTextureLoc });
+    addBindResource({ 1, blrTexId, blrTextureLoc });
     GL_CHECK(glBindFramebuffer(GL_FRAMEBUFFER, mDstFbo->getFboId()));
     GlRenderTask::run();
     GL_CHECK(glEnable(GL_BLEND));
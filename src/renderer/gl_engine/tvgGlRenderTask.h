@@ -26,6 +26,7 @@
 #include "tvgGlCommon.h"
 #include "tvgGlProgram.h"
 
+#define GL_UNIFORM_BIND_POINTS 8    //the uniform buffer bindings whose ranges are tracked
 
 struct GlVertexLayout
 {
@@ -69,6 +70,8 @@ struct GlBindingResource
     }
 };
 
+class GlRenderTarget;
+
 class GlRenderTask
 {
 public:
@@ -78,6 +81,8 @@ public:
     virtual ~GlRenderTask() = default;
 
     virtual void run();
+    //forgets the uniform ranges bound in the former frame
+    static void resetBindings();
 
     void addVertexLayout(const GlVertexLayout& layout);
     void addBindResource(const GlBindingResource& binding);
@@ -85,11 +90,17 @@ public:
     void setViewport(const RenderRegion& viewport);
     void setDrawDepth(int32_t depth) { mDrawDepth = static_cast<float>(depth); }
     virtual void normalizeDrawDepth(int32_t maxDepth) { mDrawDepth /= static_cast<float>(maxDepth);  }
+    //the task binds the other targets than the one of its pass, the pass is interrupted by it
+    virtual bool offscreen() const { return false; }
+    //draws the offscreen content ahead of the pass, unless the targets are taken by the others in the row
+    virtual bool hoist(TVG_UNUSED Array<GlRenderTarget*>& targets) { return false; }
 
     GlProgram* getProgram() { return mProgram; }
     const RenderRegion& getViewport() const { return mViewport; }
     float getDrawDepth() const { return mDrawDepth; }
 private:
+    static void bindRange(const GlBindingResource& binding);
+
     GlProgram* mProgram;
     RenderRegion mViewport = {};
     uint32_t mIndexOffset = {};
@@ -102,7 +113,7 @@ private:
 class GlStencilCoverTask : public GlRenderTask
 {
 public:
-    GlStencilCoverTask(GlRenderTask* stencil, GlRenderTask* cover, GlStencilMode mode);
+    GlStencilCoverTask(GlRenderTask* stencil, GlRenderTask* cover, GlStencilMode mode, GlRenderTask* fringe = nullptr);
     ~GlStencilCoverTask() override;
 
     void run() override;
@@ -111,10 +122,27 @@ public:
 private:
     GlRenderTask* mStencilTask;
     GlRenderTask* mCoverTask;
+    GlRenderTask* mFringeTask;  //the anti-aliasing edges, optional
     GlStencilMode mStencilMode;
 };
 
-class GlRenderTarget;
+//the consecutive stencil free solid meshes in one draw call, their vertices lie in a row in the stage buffer
+class GlBatchTask : public GlRenderTask
+{
+public:
+    GlBatchTask(GlProgram* program, uint32_t vertexOffset, uint32_t indexOffset);
+
+    bool joinable(uint32_t vertexOffset, uint32_t indexOffset, const RenderRegion& viewport) const;
+    void join(uint32_t vertexCount, uint32_t indexCount);
+    uint32_t vertexCount() const { return mVertexCount; }
+
+    static constexpr uint32_t STRIDE = 7 * sizeof(float);  //x, y, depth, r, g, b, a
+private:
+    uint32_t mVertexOffset;
+    uint32_t mIndexOffset;
+    uint32_t mVertexCount = 0;
+    uint32_t mIndexCount = 0;
+};
 
 class GlComposeTask : public GlRenderTask 
 {
@@ -123,6 +151,8 @@ public:
     ~GlComposeTask() override;
 
     void run() override;
+    bool offscreen() const override { return true; }
+    bool hoist(Array<GlRenderTarget*>& targets) override;
 
     void setRenderSize(uint32_t width, uint32_t height) { mRenderWidth = width; mRenderHeight = height; }
 
@@ -135,11 +165,15 @@ protected:
     void onResolve();
 
 private:
+    uint32_t hoist(uint32_t from, Array<GlRenderTarget*>& targets);
+    void bind(bool clear);
+
     GLuint mTargetFbo;
     GlRenderTarget* mFbo;
     Array<GlRenderTask*> mTasks;
     uint32_t mRenderWidth = 0;
     uint32_t mRenderHeight = 0;
+    bool mHoisted = false;  //drawn ahead of the parent pass already
 };
 
 class GlBlitTask : public GlComposeTask
@@ -169,6 +203,7 @@ public:
     void setParentSize(uint32_t width, uint32_t height) { mParentWidth = width; mParentHeight = height; }
 
     void run() override;
+    bool hoist(Array<GlRenderTarget*>& targets) override;
 
 private:
     GlRenderTask* mPrevTask = nullptr;
@@ -208,11 +243,12 @@ public:
     ~GlComplexBlendTask() override;
 
     void run() override;
+    bool offscreen() const override { return true; }
 
     void normalizeDrawDepth(int32_t maxDepth) override;
 private:
     GlRenderTarget* mDstFbo;
-    GlRenderTarget* mDstCopyFbo;
+    GlRenderTarget* mDstCopyFbo;  //null if the destination is read by the framebuffer fetch
     GlRenderTask* mStencilTask;
     GlComposeTask* mComposeTask;
 };
@@ -225,6 +261,7 @@ public:
     ~GlGaussianBlurTask(){ delete horzTask; delete vertTask; };
 
     void run() override;
+    bool offscreen() const override { return true; }
 
     GlRenderTask* horzTask;
     GlRenderTask* vertTask;
@@ -238,19 +275,21 @@ private:
 class GlEffectDropShadowTask: public GlRenderTask
 {
 public:
-    GlEffectDropShadowTask(GlProgram* program, GlRenderTarget* dstFbo, GlRenderTarget* dstCopyFbo0, GlRenderTarget* dstCopyFbo1): 
-        GlRenderTask(program), mDstFbo(dstFbo), mDstCopyFbo0(dstCopyFbo0), mDstCopyFbo1(dstCopyFbo1) {};
+    GlEffectDropShadowTask(GlProgram* program, GlRenderTarget* dstFbo, GlRenderTarget* dstCopyFbo, GlRenderTarget* alphaFbo0, GlRenderTarget* alphaFbo1):
+        GlRenderTask(program), mDstFbo(dstFbo), mDstCopyFbo(dstCopyFbo), mAlphaFbo0(alphaFbo0), mAlphaFbo1(alphaFbo1) {};
     ~GlEffectDropShadowTask(){ delete horzTask; delete vertTask; };
 
     void run() override;
+    bool offscreen() const override { return true; }
 
     GlRenderTask* horzTask;
     GlRenderTask* vertTask;
     RenderEffectDropShadow* effect;
 private:
     GlRenderTarget* mDstFbo;
-    GlRenderTarget* mDstCopyFbo0;
-    GlRenderTarget* mDstCopyFbo1;
+    GlRenderTarget* mDstCopyFbo;
+    GlRenderTarget* mAlphaFbo0;     //single channel targets blurring the alpha only
+    GlRenderTarget* mAlphaFbo1;
 };
 
 class GlEffectColorTransformTask: public GlRenderTask
@@ -261,6 +300,7 @@ public:
     ~GlEffectColorTransformTask() {};
 
     void run() override;
+    bool offscreen() const override { return true; }
 private:
     GlRenderTarget* mDstFbo;
     GlRenderTarget* mDstCopyFbo;
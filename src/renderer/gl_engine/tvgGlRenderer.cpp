@@ -37,6 +37,45 @@
 #define NOISE_LEVEL 0.5f
 
 static atomic<int32_t> rendererCnt{-1};
+static atomic<uint32_t> trimCnt{0};    //the requests of releasing the idle targets, see trim()
+static atomic<uint32_t> cacheCnt{0};   //the requests of releasing the glyph meshes as well
+
+
+#ifndef GL_TIME_ELAPSED
+    #define GL_TIME_ELAPSED 0x88BF  //GL_TIME_ELAPSED_EXT as well
+#endif
+
+#if defined (THORVG_GL_TARGET_GLES)
+
+#ifndef GL_FETCH_PER_SAMPLE_ARM
+    #define GL_FETCH_PER_SAMPLE_ARM 0x8F65
+#endif
+
+#ifndef GL_GPU_DISJOINT_EXT
+    #define GL_GPU_DISJOINT_EXT 0x8FBB
+#endif
+
+//the whole name in the space separated list, not a prefix of a longer one
+static bool _extension(const char* exts, const char* name)
+{
+    if (!exts) return false;
+    auto len = strlen(name);
+    for (auto p = strstr(exts, name); p; p = strstr(p + len, name)) {
+        if ((p == exts || p[-1] == ' ') && (p[len] == ' ' || p[len] == '\0')) return true;
+    }
+    return false;
+}
+
+#endif
+
+
+void GlShape::run(TVG_UNUSED unsigned tid)
+{
+    if (geometry.tesselate(*rshape, updateFlag, changed, *glyphs)) box = RenderRegion::intersect(geometry.getBounds(), geometry.viewport);
+    else box.reset();
+
+    if (dirtyRegion) dirtyRegion->add(prvBox, box, dirtyScope);
+}
 
 void GlRenderer::clearDisposes()
 {
@@ -88,21 +127,29 @@ GlRenderer::GlRenderer() : mEffect(GlEffect(&mGpuBuffer))
 
 GlRenderer::~GlRenderer()
 {
+    mGroup.wait();
+
     --rendererCnt;
 
     flush();
 
     ARRAY_FOREACH(p, mPrograms) delete(*p);
+    ARRAY_FOREACH(p, mAlphaPrograms) delete(*p);
+    ARRAY_FOREACH(p, mFetchPrograms) delete(*p);
+
+#ifndef __EMSCRIPTEN__
+    if (mTimeQueries[0]) glDeleteQueries(GL_STAGE_RING_SIZE, mTimeQueries);
+#endif
 }
 
 
-void GlRenderer::initShaders()
+/* The shader sources of the programs in the RenderTypes order,
+   they are kept for the variants made on demand, see GlRenderer::program() */
+struct GlProgramSources
 {
-    mPrograms.reserve((int)RT_None);
-
 #if 1  //for optimization
-    #define LINEAR_TOTAL_LENGTH 2770
-    #define RADIAL_TOTAL_LENGTH 5272
+    #define LINEAR_TOTAL_LENGTH 2816
+    #define RADIAL_TOTAL_LENGTH 5318
 #else
     #define COMMON_TOTAL_LENGTH strlen(STR_GRADIENT_FRAG_COMMON_VARIABLES) + strlen(STR_GRADIENT_FRAG_COMMON_FUNCTIONS) + 1
     #define LINEAR_TOTAL_LENGTH strlen(STR_LINEAR_GRADIENT_VARIABLES) + strlen(STR_LINEAR_GRADIENT_MAIN) + COMMON_TOTAL_LENGTH
@@ -110,54 +157,129 @@ void GlRenderer::initShaders()
 #endif
 
     char linearGradientFragShader[LINEAR_TOTAL_LENGTH];
-    snprintf(linearGradientFragShader, LINEAR_TOTAL_LENGTH, "%s%s%s%s",
-        STR_GRADIENT_FRAG_COMMON_VARIABLES,
-        STR_LINEAR_GRADIENT_VARIABLES,
-        STR_GRADIENT_FRAG_COMMON_FUNCTIONS,
-        STR_LINEAR_GRADIENT_MAIN
-    );
-
     char radialGradientFragShader[RADIAL_TOTAL_LENGTH];
-    snprintf(radialGradientFragShader, RADIAL_TOTAL_LENGTH, "%s%s%s%s",
-        STR_GRADIENT_FRAG_COMMON_VARIABLES,
-        STR_RADIAL_GRADIENT_VARIABLES,
-        STR_GRADIENT_FRAG_COMMON_FUNCTIONS,
-        STR_RADIAL_GRADIENT_MAIN
-    );
-
-    mPrograms.push(new GlProgram(COLOR_VERT_SHADER, COLOR_FRAG_SHADER));
-    mPrograms.push(new GlProgram(GRADIENT_VERT_SHADER, linearGradientFragShader));
-    mPrograms.push(new GlProgram(GRADIENT_VERT_SHADER, radialGradientFragShader));
-    mPrograms.push(new GlProgram(IMAGE_VERT_SHADER, IMAGE_FRAG_SHADER));
-
-    // compose Renderer
-    mPrograms.push(new GlProgram(MASK_VERT_SHADER, MASK_ALPHA_FRAG_SHADER));
-    mPrograms.push(new GlProgram(MASK_VERT_SHADER, MASK_INV_ALPHA_FRAG_SHADER));
-    mPrograms.push(new GlProgram(MASK_VERT_SHADER, MASK_LUMA_FRAG_SHADER));
-    mPrograms.push(new GlProgram(MASK_VERT_SHADER, MASK_INV_LUMA_FRAG_SHADER));
-    mPrograms.push(new GlProgram(MASK_VERT_SHADER, MASK_ADD_FRAG_SHADER));
-    mPrograms.push(new GlProgram(MASK_VERT_SHADER, MASK_SUB_FRAG_SHADER));
-    mPrograms.push(new GlProgram(MASK_VERT_SHADER, MASK_INTERSECT_FRAG_SHADER));
-    mPrograms.push(new GlProgram(MASK_VERT_SHADER, MASK_DIFF_FRAG_SHADER));
-    mPrograms.push(new GlProgram(MASK_VERT_SHADER, MASK_LIGHTEN_FRAG_SHADER));
-    mPrograms.push(new GlProgram(MASK_VERT_SHADER, MASK_DARKEN_FRAG_SHADER));
-
-    // stencil Renderer
-    mPrograms.push(new GlProgram(STENCIL_VERT_SHADER, STENCIL_FRAG_SHADER));
-
-    // blit Renderer
-    mPrograms.push(new GlProgram(BLIT_VERT_SHADER, BLIT_FRAG_SHADER));
-
-    // complex blending Renderer
-    mPrograms.push(new GlProgram(MASK_VERT_SHADER, MULTIPLY_BLEND_FRAG));
-    mPrograms.push(new GlProgram(MASK_VERT_SHADER, SCREEN_BLEND_FRAG));
-    mPrograms.push(new GlProgram(MASK_VERT_SHADER, OVERLAY_BLEND_FRAG));
-    mPrograms.push(new GlProgram(MASK_VERT_SHADER, COLOR_DODGE_BLEND_FRAG));
-    mPrograms.push(new GlProgram(MASK_VERT_SHADER, COLOR_BURN_BLEND_FRAG));
-    mPrograms.push(new GlProgram(MASK_VERT_SHADER, HARD_LIGHT_BLEND_FRAG));
-    mPrograms.push(new GlProgram(MASK_VERT_SHADER, SOFT_LIGHT_BLEND_FRAG));
-    mPrograms.push(new GlProgram(MASK_VERT_SHADER, DIFFERENCE_BLEND_FRAG));
-    mPrograms.push(new GlProgram(MASK_VERT_SHADER, EXCLUSION_BLEND_FRAG));
+    const char* vert[GlRenderer::RT_None];
+    const char* frag[GlRenderer::RT_None];
+
+    GlProgramSources()
+    {
+        snprintf(linearGradientFragShader, LINEAR_TOTAL_LENGTH, "%s%s%s%s",
+            STR_GRADIENT_FRAG_COMMON_VARIABLES,
+            STR_LINEAR_GRADIENT_VARIABLES,
+            STR_GRADIENT_FRAG_COMMON_FUNCTIONS,
+            STR_LINEAR_GRADIENT_MAIN
+        );
+
+        snprintf(radialGradientFragShader, RADIAL_TOTAL_LENGTH, "%s%s%s%s",
+            STR_GRADIENT_FRAG_COMMON_VARIABLES,
+            STR_RADIAL_GRADIENT_VARIABLES,
+            STR_GRADIENT_FRAG_COMMON_FUNCTIONS,
+            STR_RADIAL_GRADIENT_MAIN
+        );
+
+        set(GlRenderer::RT_Color, COLOR_VERT_SHADER, COLOR_FRAG_SHADER);
+        set(GlRenderer::RT_LinGradient, GRADIENT_VERT_SHADER, linearGradientFragShader);
+        set(GlRenderer::RT_RadGradient, GRADIENT_VERT_SHADER, radialGradientFragShader);
+        set(GlRenderer::RT_Image, IMAGE_VERT_SHADER, IMAGE_FRAG_SHADER);
+
+        // compose Renderer
+        set(GlRenderer::RT_MaskAlpha, MASK_VERT_SHADER, MASK_ALPHA_FRAG_SHADER);
+        set(GlRenderer::RT_MaskAlphaInv, MASK_VERT_SHADER, MASK_INV_ALPHA_FRAG_SHADER);
+        set(GlRenderer::RT_MaskLuma, MASK_VERT_SHADER, MASK_LUMA_FRAG_SHADER);
+        set(GlRenderer::RT_MaskLumaInv, MASK_VERT_SHADER, MASK_INV_LUMA_FRAG_SHADER);
+        set(GlRenderer::RT_MaskAdd, MASK_VERT_SHADER, MASK_ADD_FRAG_SHADER);
+        set(GlRenderer::RT_MaskSub, MASK_VERT_SHADER, MASK_SUB_FRAG_SHADER);
+        set(GlRenderer::RT_MaskIntersect, MASK_VERT_SHADER, MASK_INTERSECT_FRAG_SHADER);
+        set(GlRenderer::RT_MaskDifference, MASK_VERT_SHADER, MASK_DIFF_FRAG_SHADER);
+        set(GlRenderer::RT_MaskLighten, MASK_VERT_SHADER, MASK_LIGHTEN_FRAG_SHADER);
+        set(GlRenderer::RT_MaskDarken, MASK_VERT_SHADER, MASK_DARKEN_FRAG_SHADER);
+
+        // stencil Renderer
+        set(GlRenderer::RT_Stencil, STENCIL_VERT_SHADER, STENCIL_FRAG_SHADER);
+
+        // blit Renderer
+        set(GlRenderer::RT_Blit, BLIT_VERT_SHADER, BLIT_FRAG_SHADER);
+
+        // complex blending Renderer
+        set(GlRenderer::RT_MultiplyBlend, MASK_VERT_SHADER, MULTIPLY_BLEND_FRAG);
+        set(GlRenderer::RT_ScreenBlend, MASK_VERT_SHADER, SCREEN_BLEND_FRAG);
+        set(GlRenderer::RT_OverlayBlend, MASK_VERT_SHADER, OVERLAY_BLEND_FRAG);
+        set(GlRenderer::RT_ColorDodgeBlend, MASK_VERT_SHADER, COLOR_DODGE_BLEND_FRAG);
+        set(GlRenderer::RT_ColorBurnBlend, MASK_VERT_SHADER, COLOR_BURN_BLEND_FRAG);
+        set(GlRenderer::RT_HardLightBlend, MASK_VERT_SHADER, HARD_LIGHT_BLEND_FRAG);
+        set(GlRenderer::RT_SoftLightBlend, MASK_VERT_SHADER, SOFT_LIGHT_BLEND_FRAG);
+        set(GlRenderer::RT_DifferenceBlend, MASK_VERT_SHADER, DIFFERENCE_BLEND_FRAG);
+        set(GlRenderer::RT_ExclusionBlend, MASK_VERT_SHADER, EXCLUSION_BLEND_FRAG);
+
+        // batched solid colors
+        set(GlRenderer::RT_ColorBatch, COLOR_BATCH_VERT_SHADER, COLOR_BATCH_FRAG_SHADER);
+
+        // edge fringes
+        set(GlRenderer::RT_ColorFringe, FRINGE_COLOR_VERT_SHADER, COLOR_FRAG_SHADER);
+        set(GlRenderer::RT_LinGradientFringe, FRINGE_GRADIENT_VERT_SHADER, linearGradientFragShader);
+        set(GlRenderer::RT_RadGradientFringe, FRINGE_GRADIENT_VERT_SHADER, radialGradientFragShader);
+    }
+
+    void set(GlRenderer::RenderTypes type, const char* vs, const char* fs)
+    {
+        vert[type] = vs;
+        frag[type] = fs;
+    }
+
+    static const GlProgramSources& get()
+    {
+        static GlProgramSources sources;
+        return sources;
+    }
+};
+
+
+void GlRenderer::initShaders()
+{
+    auto& sources = GlProgramSources::get();
+
+    mPrograms.reserve((int)RT_None);
+    for (int i = 0; i < RT_None; ++i) {
+        mPrograms.push(new GlProgram(sources.vert[i], sources.frag[i]));
+    }
+
+    //the blend programs read the destination in place instead of its copy
+#if defined (THORVG_GL_TARGET_GLES)
+    auto exts = (const char*) glGetString(GL_EXTENSIONS);
+    mTimerSupport = _extension(exts, "GL_EXT_disjoint_timer_query");
+    if (_extension(exts, "GL_EXT_shader_framebuffer_fetch")) mFetchHeader = FETCH_EXT_FRAG_HEADER;
+    else if (_extension(exts, "GL_ARM_shader_framebuffer_fetch")) {
+        mFetchHeader = FETCH_ARM_FRAG_HEADER;
+        //the samples of the multisampled targets are blended one by one
+        GL_CHECK(glEnable(GL_FETCH_PER_SAMPLE_ARM));
+    }
+#elif !defined(__EMSCRIPTEN__)
+    mTimerSupport = true;  //the core of the desktop gl 3.3
+#endif
+}
+
+
+/* The program drawing into the current pass. The single channel target of the alpha masks
+   takes the variant writing the coverage only, it's compiled on the first use. */
+GlProgram* GlRenderer::program(RenderTypes type)
+{
+    auto pass = currentPass();
+    if (!pass || !pass->getFbo() || !pass->getFbo()->alpha()) return mPrograms[type];
+
+    if (mAlphaPrograms.empty()) {
+        mAlphaPrograms.reserve((int)RT_None);
+        for (int i = 0; i < RT_None; ++i) mAlphaPrograms.push(nullptr);
+    }
+
+    if (!mAlphaPrograms[type]) {
+        auto& sources = GlProgramSources::get();
+        auto len = strlen(ALPHA_FRAG_HEADER) + strlen(sources.frag[type]) + strlen(ALPHA_FRAG_FOOTER) + 1;
+        auto frag = tvg::malloc<char*>(len);
+        snprintf(frag, len, "%s%s%s", ALPHA_FRAG_HEADER, sources.frag[type], ALPHA_FRAG_FOOTER);
+        mAlphaPrograms[type] = new GlProgram(sources.vert[type], frag);
+        tvg::free(frag);
+    }
+    return mAlphaPrograms[type];
 }
 
 
@@ -180,9 +302,26 @@ void GlRenderer::drawPrimitive(GlShape& sdata, const RenderColor& c, RenderUpdat
     auto w = bbox.sw();
     auto h = bbox.sh();
 
+    y = vp.sh() - y - h;
+
+    auto a = MULTIPLY(c.a, sdata.opacity);
+
+    if (flag & RenderUpdateFlag::Stroke) {
+        float strokeWidth = sdata.rshape->strokeWidth() * scaling(sdata.geometry.matrix);
+        if (strokeWidth < MIN_GL_STROKE_WIDTH) {
+            float alpha = strokeWidth / MIN_GL_STROKE_WIDTH;
+            a = MULTIPLY(a, static_cast<uint8_t>(alpha * 255));
+        }
+    }
+
+    if (mBlendMethod == BlendMethod::Normal && sdata.geometry.stencilFree(flag, a)) {
+        drawBatch(sdata, {c.r, c.g, c.b, a}, flag, {{x, y}, {x + w, y + h}}, depth);
+        return;
+    }
+
     GlRenderTask* task = nullptr;
-    if (mBlendMethod != BlendMethod::Normal && !complexBlend) task = new GlSimpleBlendTask(mBlendMethod, mPrograms[RT_Color]);
-    else task = new GlRenderTask(mPrograms[RT_Color]);
+    if (mBlendMethod != BlendMethod::Normal && !complexBlend) task = new GlSimpleBlendTask(mBlendMethod, program(RT_Color));
+    else task = new GlRenderTask(program(RT_Color));
 
     task->setDrawDepth(depth);
 
@@ -191,7 +330,6 @@ void GlRenderer::drawPrimitive(GlShape& sdata, const RenderColor& c, RenderUpdat
         return;
     }
 
-    y = vp.sh() - y - h;
     task->setViewport({{x, y}, {x + w, y + h}});
 
     GlRenderTask* stencilTask = nullptr;
@@ -202,16 +340,6 @@ void GlRenderer::drawPrimitive(GlShape& sdata, const RenderColor& c, RenderUpdat
         stencilTask->setDrawDepth(depth);
     }
 
-    auto a = MULTIPLY(c.a, sdata.opacity);
-
-    if (flag & RenderUpdateFlag::Stroke) {
-        float strokeWidth = sdata.rshape->strokeWidth() * scaling(sdata.geometry.matrix);
-        if (strokeWidth < MIN_GL_STROKE_WIDTH) {
-            float alpha = strokeWidth / MIN_GL_STROKE_WIDTH;
-            a = MULTIPLY(a, static_cast<uint8_t>(alpha * 255));
-        }
-    }
-
     // matrix buffer
     float matrix44[16];
     currentPass()->getMatrix(matrix44, sdata.geometry.matrix);
@@ -225,6 +353,8 @@ void GlRenderer::drawPrimitive(GlShape& sdata, const RenderColor& c, RenderUpdat
         16 * sizeof(float),
     });
 
+    GlRenderTask* fringeTask = nullptr;
+
     if (stencilTask) {
         stencilTask->addBindResource(GlBindingResource{
             0,
@@ -233,20 +363,35 @@ void GlRenderer::drawPrimitive(GlShape& sdata, const RenderColor& c, RenderUpdat
             viewOffset,
             16 * sizeof(float),
         });
+        // the simple blending is set by the cover task only
+        if (mBlendMethod == BlendMethod::Normal || complexBlend) {
+            fringeTask = drawFringe(sdata, program(RT_ColorFringe), flag, {{x, y}, {x + w, y + h}}, depth, viewOffset);
+        }
     }
 
     // color
     float color[] = {c.r / 255.f, c.g / 255.f, c.b / 255.f, a / 255.f};
+    auto colorOffset = mGpuBuffer.push(color, 4 * sizeof(float), true);
 
     task->addBindResource(GlBindingResource{
         1,
         task->getProgram()->getUniformBlockIndex("ColorInfo"),
         mGpuBuffer.getBufferId(),
-        mGpuBuffer.push(color, 4 * sizeof(float), true),
+        colorOffset,
          4 * sizeof(float),
     });
 
-    if (stencilTask) currentPass()->addRenderTask(new GlStencilCoverTask(stencilTask, task, stencilMode));
+    if (fringeTask) {
+        fringeTask->addBindResource(GlBindingResource{
+            1,
+            fringeTask->getProgram()->getUniformBlockIndex("ColorInfo"),
+            mGpuBuffer.getBufferId(),
+            colorOffset,
+            4 * sizeof(float),
+        });
+    }
+
+    if (stencilTask) currentPass()->addRenderTask(new GlStencilCoverTask(stencilTask, task, stencilMode, fringeTask));
     else currentPass()->addRenderTask(task);
 
     if (complexBlend) {
@@ -257,6 +402,95 @@ void GlRenderer::drawPrimitive(GlShape& sdata, const RenderColor& c, RenderUpdat
 }
 
 
+//append the mesh to the last batch of the pass, the draw calls shrink to the runs of the simple shapes
+void GlRenderer::drawBatch(GlShape& sdata, const RenderColor& c, RenderUpdateFlag flag, const RenderRegion& viewport, int32_t depth)
+{
+    auto& mesh = (flag & RenderUpdateFlag::Stroke) ? sdata.geometry.stroke : sdata.geometry.fill;
+    if (mesh.index.empty()) return;
+
+    auto pass = currentPass();
+    auto program = this->program(RT_ColorBatch);
+    auto last = pass->lastTask();
+    auto batch = (last && last->getProgram() == program) ? static_cast<GlBatchTask*>(last) : nullptr;
+
+    if (!batch || !batch->joinable(mGpuBuffer.offset(), mGpuBuffer.indexOffset(), viewport)) {
+        Matrix identity;
+        tvg::identity(&identity);
+        float matrix44[16];
+        pass->getMatrix(matrix44, identity);
+        auto viewOffset = mGpuBuffer.push(matrix44, 16 * sizeof(float), true);
+
+        batch = new GlBatchTask(program, mGpuBuffer.offset(), mGpuBuffer.indexOffset());
+        batch->setViewport(viewport);
+        batch->setDrawDepth(1);  //scales the vertex depths on the normalization
+        batch->addBindResource(GlBindingResource{0, program->getUniformBlockIndex("Matrix"), mGpuBuffer.getBufferId(), viewOffset, 16 * sizeof(float)});
+        pass->addRenderTask(batch);
+    }
+
+    //the vertices are moved to the pass space here, the batch shares a single matrix
+    auto a = c.a / 255.f;
+    float color[] = {c.r / 255.f * a, c.g / 255.f * a, c.b / 255.f * a, a};
+    auto cnt = mesh.vertex.count / 2;
+
+    mBatchPoints.reserve(cnt);
+    tvg::transform(reinterpret_cast<const Point*>(mesh.vertex.data), mBatchPoints.data, cnt, sdata.geometry.matrix);
+
+    mBatchVertices.clear();
+    mBatchVertices.reserve(cnt * GlBatchTask::STRIDE / sizeof(float));
+    for (uint32_t i = 0; i < cnt; ++i) {
+        mBatchVertices.push(mBatchPoints[i].x);
+        mBatchVertices.push(mBatchPoints[i].y);
+        mBatchVertices.push(float(depth));
+        for (int j = 0; j < 4; ++j) mBatchVertices.push(color[j]);
+    }
+
+    auto base = batch->vertexCount();
+    mBatchIndices.clear();
+    mBatchIndices.reserve(mesh.index.count);
+    ARRAY_FOREACH(p, mesh.index) mBatchIndices.push(base + *p);
+
+    mGpuBuffer.push(mBatchVertices.data, mBatchVertices.count * sizeof(float));
+    mGpuBuffer.pushIndex(mBatchIndices.data, mBatchIndices.count * sizeof(uint32_t));
+    batch->join(cnt, mesh.index.count);
+}
+
+
+GlRenderTask* GlRenderer::drawFringe(GlShape& sdata, GlProgram* program, RenderUpdateFlag flag, const RenderRegion& viewport, int32_t depth, uint32_t matrixOffset)
+{
+    auto task = new GlRenderTask(program);
+    task->setDrawDepth(depth);
+
+    if (!sdata.geometry.drawFringe(task, &mGpuBuffer, flag)) {
+        delete task;
+        return nullptr;
+    }
+
+    task->setViewport(viewport);
+
+    task->addBindResource(GlBindingResource{
+        0,
+        program->getUniformBlockIndex("Matrix"),
+        mGpuBuffer.getBufferId(),
+        matrixOffset,
+        16 * sizeof(float),
+    });
+
+    // the pass size, the fringes are pushed aside in pixels
+    auto vp = currentPass()->getViewport();
+    float size[] = {float(vp.w()), float(vp.h()), 0.0f, 0.0f};
+
+    task->addBindResource(GlBindingResource{
+        3,
+        program->getUniformBlockIndex("ViewInfo"),
+        mGpuBuffer.getBufferId(),
+        mGpuBuffer.push(size, 4 * sizeof(float), true),
+        4 * sizeof(float),
+    });
+
+    return task;
+}
+
+
 void GlRenderer::drawPrimitive(GlShape& sdata, const Fill* fill, RenderUpdateFlag flag, int32_t depth)
 {
     auto vp = currentPass()->getViewport();
@@ -269,8 +503,8 @@ void GlRenderer::drawPrimitive(GlShape& sdata, const Fill* fill, RenderUpdateFla
 
     GlRenderTask* task = nullptr;
 
-    if (fill->type() == Type::LinearGradient) task = new GlRenderTask(mPrograms[RT_LinGradient]);
-    else if (fill->type() == Type::RadialGradient) task = new GlRenderTask(mPrograms[RT_RadGradient]);
+    if (fill->type() == Type::LinearGradient) task = new GlRenderTask(program(RT_LinGradient));
+    else if (fill->type() == Type::RadialGradient) task = new GlRenderTask(program(RT_RadGradient));
     else return;
 
     task->setDrawDepth(depth);
@@ -313,6 +547,8 @@ void GlRenderer::drawPrimitive(GlShape& sdata, const Fill* fill, RenderUpdateFla
         16 * sizeof(float),
     });
 
+    GlRenderTask* fringeTask = nullptr;
+
     if (stencilTask) {
         stencilTask->addBindResource(GlBindingResource{
             0,
@@ -321,6 +557,8 @@ void GlRenderer::drawPrimitive(GlShape& sdata, const Fill* fill, RenderUpdateFla
             viewOffset,
             16 * sizeof(float),
         });
+        auto program = this->program(fill->type() == Type::LinearGradient ? RT_LinGradientFringe : RT_RadGradientFringe);
+        fringeTask = drawFringe(sdata, program, flag, {{x, y}, {x + bbox.sw(), y + bbox.sh()}}, depth, viewOffset);
     }
 
     viewOffset = mGpuBuffer.push(invMat4, 16 * sizeof(float), true);
@@ -333,6 +571,16 @@ void GlRenderer::drawPrimitive(GlShape& sdata, const Fill* fill, RenderUpdateFla
         16 * sizeof(float),
     });
 
+    if (fringeTask) {
+        fringeTask->addBindResource(GlBindingResource{
+            1,
+            fringeTask->getProgram()->getUniformBlockIndex("InvMatrix"),
+            mGpuBuffer.getBufferId(),
+            viewOffset,
+            16 * sizeof(float),
+        });
+    }
+
     auto alpha = sdata.opacity / 255.f;
 
     if (flag & RenderUpdateFlag::GradientStroke) {
@@ -424,8 +672,13 @@ void GlRenderer::drawPrimitive(GlShape& sdata, const Fill* fill, RenderUpdateFla
 
     task->addBindResource(gradientBinding);
 
+    if (fringeTask) {
+        gradientBinding.location = fringeTask->getProgram()->getUniformBlockIndex("GradientInfo");
+        fringeTask->addBindResource(gradientBinding);
+    }
+
     if (stencilTask) {
-        currentPass()->addRenderTask(new GlStencilCoverTask(stencilTask, task, stencilMode));
+        currentPass()->addRenderTask(new GlStencilCoverTask(stencilTask, task, stencilMode, fringeTask));
     } else {
         currentPass()->addRenderTask(task);
     }
@@ -440,7 +693,7 @@ void GlRenderer::drawPrimitive(GlShape& sdata, const Fill* fill, RenderUpdateFla
 
 void GlRenderer::drawClip(Array<RenderData>& clips)
 {
-    Array<float> identityVertex(4 * 2);
+    SmallArray<float, 4 * 2> identityVertex;
     float left = -1.f;
     float top = 1.f;
     float right = 1.f;
@@ -455,7 +708,7 @@ void GlRenderer::drawClip(Array<RenderData>& clips)
     identityVertex.push(right);
     identityVertex.push(bottom);
 
-    Array<uint32_t> identityIndex(6);
+    SmallArray<uint32_t, 6> identityIndex;
     identityIndex.push(0);
     identityIndex.push(1);
     identityIndex.push(2);
@@ -474,7 +727,8 @@ void GlRenderer::drawClip(Array<RenderData>& clips)
     auto identityIndexOffset = mGpuBuffer.pushIndex(identityIndex.data, 6 * sizeof(uint32_t));
     auto mat4Offset = mGpuBuffer.push(mat4, 16 * sizeof(float), true);
 
-    Array<int32_t> clipDepths(clips.count);
+    SmallArray<int32_t, 8> clipDepths;
+    clipDepths.reserve(clips.count);
     clipDepths.count = clips.count;
 
     for (int32_t i = clips.count - 1; i >= 0; i--) {
@@ -535,7 +789,8 @@ bool GlRenderer::beginComplexBlending(const RenderRegion& vp, RenderRegion bound
 
     if (mBlendPool.empty()) mBlendPool.push(new GlRenderTargetPool(surface.w, surface.h));
 
-    auto blendFbo = mBlendPool[0]->getRenderTarget(bounds);
+    //the blending in the alpha mask target stays in the coverage
+    auto blendFbo = mBlendPool[0]->getRenderTarget(bounds, 0, currentPass()->getFbo()->alpha());
 
     mRenderPassStack.push(new GlRenderPass(blendFbo));
 
@@ -552,8 +807,15 @@ void GlRenderer::endBlendingCompose(GlRenderTask* stencilTask, const Matrix& mat
     auto composeTask = blendPass->endRenderPass<GlComposeTask>(nullptr, currentPass()->getFboId());
 
     const auto& vp = blendPass->getViewport();
-    if (mBlendPool.count < 2) mBlendPool.push(new GlRenderTargetPool(surface.w, surface.h));
-    auto dstCopyFbo = mBlendPool[1]->getRenderTarget(vp);
+
+    //the destination is copied unless the blend program reads it in place
+    auto blendProgram = getBlendProgram(true);
+    GlRenderTarget* dstCopyFbo = nullptr;
+    if (!blendProgram) {
+        blendProgram = getBlendProgram(false);
+        if (mBlendPool.count < 2) mBlendPool.push(new GlRenderTargetPool(surface.w, surface.h));
+        dstCopyFbo = mBlendPool[1]->getRenderTarget(vp, 0, currentPass()->getFbo()->alpha());
+    }
 
     auto x = vp.sx();
     auto y = currentPass()->getViewport().sh() - vp.sy() - vp.sh();
@@ -573,33 +835,55 @@ void GlRenderer::endBlendingCompose(GlRenderTask* stencilTask, const Matrix& mat
         16 * sizeof(float),
     });
 
-    auto task = new GlComplexBlendTask(getBlendProgram(), currentPass()->getFbo(), dstCopyFbo, stencilTask, composeTask);
+    auto task = new GlComplexBlendTask(blendProgram, currentPass()->getFbo(), dstCopyFbo, stencilTask, composeTask);
     prepareCmpTask(task, vp, blendPass->getFboWidth(), blendPass->getFboHeight());
     task->setDrawDepth(currentPass()->nextDrawDepth());
 
     // src and dst texture
     task->addBindResource(GlBindingResource{1, blendPass->getFbo()->getColorTexture(), task->getProgram()->getUniformLocation("uSrcTexture")});
-    task->addBindResource(GlBindingResource{2, dstCopyFbo->getColorTexture(), task->getProgram()->getUniformLocation("uDstTexture")});
+    if (dstCopyFbo) task->addBindResource(GlBindingResource{2, dstCopyFbo->getColorTexture(), task->getProgram()->getUniformLocation("uDstTexture")});
 
     currentPass()->addRenderTask(task);
 
     delete(blendPass);
 }
 
-GlProgram* GlRenderer::getBlendProgram()
+/* The fetch variant reads the destination in place, it's compiled on the first use.
+   It's null if the framebuffer fetch is unsupported or the pass is an alpha mask target. */
+GlProgram* GlRenderer::getBlendProgram(bool fetch)
 {
+    RenderTypes type;
+
     switch (mBlendMethod) {
-        case BlendMethod::Multiply: return mPrograms[RT_MultiplyBlend];
-        case BlendMethod::Screen: return mPrograms[RT_ScreenBlend];
-        case BlendMethod::Overlay: return mPrograms[RT_OverlayBlend];
-        case BlendMethod::ColorDodge: return mPrograms[RT_ColorDodgeBlend];
-        case BlendMethod::ColorBurn: return mPrograms[RT_ColorBurnBlend];
-        case BlendMethod::HardLight: return mPrograms[RT_HardLightBlend];
-        case BlendMethod::SoftLight: return mPrograms[RT_SoftLightBlend];
-        case BlendMethod::Difference: return mPrograms[RT_DifferenceBlend];
-        case BlendMethod::Exclusion: return mPrograms[RT_ExclusionBlend];
+        case BlendMethod::Multiply: type = RT_MultiplyBlend; break;
+        case BlendMethod::Screen: type = RT_ScreenBlend; break;
+        case BlendMethod::Overlay: type = RT_OverlayBlend; break;
+        case BlendMethod::ColorDodge: type = RT_ColorDodgeBlend; break;
+        case BlendMethod::ColorBurn: type = RT_ColorBurnBlend; break;
+        case BlendMethod::HardLight: type = RT_HardLightBlend; break;
+        case BlendMethod::SoftLight: type = RT_SoftLightBlend; break;
+        case BlendMethod::Difference: type = RT_DifferenceBlend; break;
+        case BlendMethod::Exclusion: type = RT_ExclusionBlend; break;
         default: return nullptr;
     }
+
+    if (!fetch) return program(type);
+    if (!mFetchHeader || currentPass()->getFbo()->alpha()) return nullptr;
+
+    if (mFetchPrograms.empty()) {
+        mFetchPrograms.reserve((int)RT_None);
+        for (int i = 0; i < RT_None; ++i) mFetchPrograms.push(nullptr);
+    }
+
+    if (!mFetchPrograms[type]) {
+        auto& sources = GlProgramSources::get();
+        auto len = strlen(mFetchHeader) + strlen(sources.frag[type]) + 1;
+        auto frag = tvg::malloc<char*>(len);
+        snprintf(frag, len, "%s%s", mFetchHeader, sources.frag[type]);
+        mFetchPrograms[type] = new GlProgram(sources.vert[type], frag);
+        tvg::free(frag);
+    }
+    return mFetchPrograms[type];
 }
 
 
@@ -613,7 +897,7 @@ void GlRenderer::prepareBlitTask(GlBlitTask* task)
 void GlRenderer::prepareCmpTask(GlRenderTask* task, const RenderRegion& vp, uint32_t cmpWidth, uint32_t cmpHeight)
 {
     // we use 1:1 blit mapping since compositor fbo is same size as root fbo
-    Array<float> vertices(4 * 4);
+    SmallArray<float, 4 * 4> vertices;
 
     const auto& passVp = currentPass()->getViewport();
     
@@ -663,7 +947,7 @@ void GlRenderer::prepareCmpTask(GlRenderTask* task, const RenderRegion& vp, uint
     vertices.push(uw);
     vertices.push(0.f);
 
-    Array<uint32_t> indices(6);
+    SmallArray<uint32_t, 6> indices;
 
     indices.push(0);
     indices.push(1);
@@ -696,16 +980,16 @@ void GlRenderer::endRenderPass(RenderCompositor* cmp)
 
         GlProgram* program = nullptr;
         switch(cmp->method) {
-            case MaskMethod::Alpha: program = mPrograms[RT_MaskAlpha]; break;
-            case MaskMethod::InvAlpha: program = mPrograms[RT_MaskAlphaInv]; break;
-            case MaskMethod::Luma: program = mPrograms[RT_MaskLuma]; break;
-            case MaskMethod::InvLuma: program = mPrograms[RT_MaskLumaInv]; break;
-            case MaskMethod::Add: program = mPrograms[RT_MaskAdd]; break;
-            case MaskMethod::Subtract: program = mPrograms[RT_MaskSub]; break;
-            case MaskMethod::Intersect: program = mPrograms[RT_MaskIntersect]; break;
-            case MaskMethod::Difference: program = mPrograms[RT_MaskDifference]; break;
-            case MaskMethod::Lighten: program = mPrograms[RT_MaskLighten]; break;
-            case MaskMethod::Darken: program = mPrograms[RT_MaskDarken]; break;
+            case MaskMethod::Alpha: program = this->program(RT_MaskAlpha); break;
+            case MaskMethod::InvAlpha: program = this->program(RT_MaskAlphaInv); break;
+            case MaskMethod::Luma: program = this->program(RT_MaskLuma); break;
+            case MaskMethod::InvLuma: program = this->program(RT_MaskLumaInv); break;
+            case MaskMethod::Add: program = this->program(RT_MaskAdd); break;
+            case MaskMethod::Subtract: program = this->program(RT_MaskSub); break;
+            case MaskMethod::Intersect: program = this->program(RT_MaskIntersect); break;
+            case MaskMethod::Difference: program = this->program(RT_MaskDifference); break;
+            case MaskMethod::Lighten: program = this->program(RT_MaskLighten); break;
+            case MaskMethod::Darken: program = this->program(RT_MaskDarken); break;
             default: break;
         }
 
@@ -737,7 +1021,7 @@ void GlRenderer::endRenderPass(RenderCompositor* cmp)
         mRenderPassStack.pop();
 
         if (!renderPass->isEmpty()) {
-            auto task = renderPass->endRenderPass<GlDrawBlitTask>(mPrograms[RT_Image], currentPass()->getFboId());
+            auto task = renderPass->endRenderPass<GlDrawBlitTask>(program(RT_Image), currentPass()->getFboId());
             task->setRenderSize(glCmp->bbox.w(), glCmp->bbox.h());
             prepareCmpTask(task, glCmp->bbox, renderPass->getFboWidth(), renderPass->getFboHeight());
             task->setDrawDepth(currentPass()->nextDrawDepth());
@@ -783,6 +1067,7 @@ bool GlRenderer::clear()
     if (mRootTarget.invalid()) return false;
 
     mClearBuffer = true;
+    mFullDraw = true;
     return true;
 }
 
@@ -808,10 +1093,63 @@ bool GlRenderer::target(void* context, int32_t id, uint32_t w, uint32_t h)
     mRootTarget.setViewport({{0, 0}, {int32_t(surface.w), int32_t(surface.h)}});
     mRootTarget.init(surface.w, surface.h, mTargetFboId);
 
+    mDirtyRegion.init(w, h);
+    mFullDraw = true;
+
     return true;
 }
 
 
+/* The elapsed time of the frame on the gpu while profiling. The results are collected without
+   waiting, the profile takes the latest one ready, usually the one of a few frames before. */
+bool GlRenderer::beginGpuTime()
+{
+#ifndef __EMSCRIPTEN__
+    if (!profile || !mTimerSupport) return false;
+
+    if (!mTimeQueries[0]) GL_CHECK(glGenQueries(GL_STAGE_RING_SIZE, mTimeQueries));
+
+#if defined (THORVG_GL_TARGET_GLES)
+    //the measures are meaningless over a disjoint operation, e.g. a power state change
+    GLint disjoint = 0;
+    glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+#else
+    GLint disjoint = 0;
+#endif
+
+    for (uint32_t i = 0; i < GL_STAGE_RING_SIZE; ++i) {
+        auto idx = (mTimeQuery + i) % GL_STAGE_RING_SIZE;  //from the oldest
+        if (!mTimePending[idx]) continue;
+        GLuint ready = 0;
+        GL_CHECK(glGetQueryObjectuiv(mTimeQueries[idx], GL_QUERY_RESULT_AVAILABLE, &ready));
+        if (!ready) continue;
+        GLuint ns = 0;
+        GL_CHECK(glGetQueryObjectuiv(mTimeQueries[idx], GL_QUERY_RESULT, &ns));
+        if (!disjoint) profile->times[RenderProfile::Gpu].store(ns, memory_order_relaxed);
+        mTimePending[idx] = false;
+    }
+
+    //the gpu lags behind the whole ring, the frame goes unmeasured
+    if (mTimePending[mTimeQuery]) return false;
+
+    GL_CHECK(glBeginQuery(GL_TIME_ELAPSED, mTimeQueries[mTimeQuery]));
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+void GlRenderer::endGpuTime()
+{
+#ifndef __EMSCRIPTEN__
+    GL_CHECK(glEndQuery(GL_TIME_ELAPSED));
+    mTimePending[mTimeQuery] = true;
+    mTimeQuery = (mTimeQuery + 1) % GL_STAGE_RING_SIZE;
+#endif
+}
+
+
 bool GlRenderer::sync()
 {
     //nothing to be done.
@@ -832,12 +1170,23 @@ bool GlRenderer::sync()
 
     prepareBlitTask(task);
 
-    task->mClearBuffer = mClearBuffer;
     task->setTargetViewport({{0, 0}, {int32_t(surface.w), int32_t(surface.h)}});
 
-    if (mGpuBuffer.flushToGPU()) {
+    //partial rendering: replace only the damaged area of the target
+    auto damage = damaged();
+    if (mFullDraw || mDirtyRegion.deactivated()) {
+        task->mClearBuffer = mClearBuffer;
+    } else {
+        task->mClearBuffer = true;
+        task->setViewport({{damage.min.x, int32_t(surface.h) - damage.max.y}, {damage.max.x, int32_t(surface.h) - damage.min.y}});
+    }
+
+    if (damage.valid() && mGpuBuffer.flushToGPU()) {
         mGpuBuffer.bind();
+        GlRenderTask::resetBindings();
+        auto timed = beginGpuTime();
         task->run();
+        if (timed) endGpuTime();
     }
 
     mGpuBuffer.unbind();
@@ -846,8 +1195,13 @@ bool GlRenderer::sync()
 
     clearDisposes();
 
+    ARRAY_FOREACH(p, mComposePool) (*p)->reclaim();
+    ARRAY_FOREACH(p, mBlendPool) (*p)->reclaim();
+
     // Reset clear buffer flag to default (false) after use.    
     mClearBuffer = false; 
+    mFullDraw = false;
+    mDirtyRegion.clear();
 
     delete task;
 
@@ -861,6 +1215,7 @@ RenderRegion GlRenderer::region(RenderData data)
     if (!data || !pass || pass->isEmpty()) return {};
 
     auto shape = reinterpret_cast<GlShape*>(data);
+    shape->done();
     auto bounds = shape->geometry.getBounds();
 
     auto const& vp = pass->getViewport();
@@ -874,8 +1229,26 @@ bool GlRenderer::preRender()
 {
     if (mRootTarget.invalid()) return false;
 
+    //the geometries and the dirty regions are ready to draw
+    mGroup.wait();
+
     currentContext();
     if (mPrograms.empty()) initShaders();
+
+    //release the idle targets as requested, the context is current here
+    if (mTrimmed != trimCnt) {
+        ARRAY_FOREACH(p, mComposePool) delete(*p);
+        mComposePool.clear();
+        ARRAY_FOREACH(p, mBlendPool) delete(*p);
+        mBlendPool.clear();
+        mTrimmed = trimCnt;
+    }
+
+    if (mCacheTrimmed != cacheCnt) {
+        mGlyphCache.clear();
+        mCacheTrimmed = cacheCnt;
+    }
+
     mRenderPassStack.push(new GlRenderPass(&mRootTarget));
 
     return true;
@@ -888,15 +1261,22 @@ bool GlRenderer::postRender()
 }
 
 
-RenderCompositor* GlRenderer::target(const RenderRegion& region, TVG_UNUSED ColorSpace cs, TVG_UNUSED CompositionFlag flags)
+RenderCompositor* GlRenderer::target(const RenderRegion& region, ColorSpace cs, CompositionFlag flags)
 {
+    MemoryScope scope(MemoryCategory::Compositor);
+
     auto vp = region;
     if (currentPass()->isEmpty()) return nullptr;
 
     vp.intersect(currentPass()->getViewport());
 
-    mComposeStack.push(new GlCompositor(vp));
-    return mComposeStack.last();
+    auto cmp = new GlCompositor(vp);
+    //WebGL can't swizzle the textures, the masks keep the color targets there
+#ifndef __EMSCRIPTEN__
+    cmp->alpha = (cs == ColorSpace::Grayscale8 && (flags & CompositionFlag::Masking));
+#endif
+    mComposeStack.push(cmp);
+    return cmp;
 }
 
 
@@ -910,8 +1290,15 @@ bool GlRenderer::beginComposite(RenderCompositor* cmp, MaskMethod method, uint8_
     uint32_t index = mRenderPassStack.count - 1;
     if (index >= mComposePool.count) mComposePool.push( new GlRenderTargetPool(surface.w, surface.h));
 
+    /* The mask content is drawn first, with no method. The alpha masks need the coverage only,
+       it goes to the single channel target that quarters the bandwidth of the color one. */
     auto glCmp = static_cast<GlCompositor*>(cmp);
-    if (glCmp->bbox.valid()) mRenderPassStack.push(new GlRenderPass(mComposePool[index]->getRenderTarget(glCmp->bbox)));
+    auto alpha = glCmp->alpha && method == MaskMethod::None;
+
+    //the pass composing the target, the masked content is composed with its mask into the pass under the mask
+    auto owner = (method != MaskMethod::None && mRenderPassStack.count > 1) ? mRenderPassStack[mRenderPassStack.count - 2] : currentPass();
+
+    if (glCmp->bbox.valid()) mRenderPassStack.push(new GlRenderPass(mComposePool[index]->getRenderTarget(glCmp->bbox, 0, alpha, owner)));
     else mRenderPassStack.push(new GlRenderPass(nullptr));
 
     return true;
@@ -959,6 +1346,12 @@ bool GlRenderer::render(TVG_UNUSED RenderCompositor* cmp, const RenderEffect* ef
 }
 
 
+bool GlRenderer::fuse(TVG_UNUSED RenderCompositor* cmp, const RenderEffect* const* effects, uint32_t cnt)
+{
+    return mEffect.fuse(effects, cnt, currentPass(), mBlendPool);
+}
+
+
 void GlRenderer::dispose(RenderEffect* effect)
 {
     tvg::free(effect->rd);
@@ -1009,7 +1402,7 @@ bool GlRenderer::renderImage(void* data)
 
     if (!sdata->clips.empty()) drawClip(sdata->clips);
 
-    auto task = new GlRenderTask(mPrograms[RT_Image]);
+    auto task = new GlRenderTask(program(RT_Image));
     task->setDrawDepth(drawDepth);
 
     if (!sdata->geometry.draw(task, &mGpuBuffer, RenderUpdateFlag::Image)) {
@@ -1119,9 +1512,12 @@ bool GlRenderer::renderShape(RenderData data)
 void GlRenderer::dispose(RenderData data)
 {
     auto sdata = static_cast<GlShape*>(data);
+    sdata->done();
+
+    if (!mDirtyRegion.deactivated()) mDirtyRegion.add(sdata->box, sdata->dirtyScope);
 
     //dispose the non thread-safety resources on clearDisposes() call
-    if (sdata->texId) {
+    if (sdata->texId && !sdata->texExternal) {
         ScopedLock lock(mDisposed.key);
         mDisposed.textures.push(sdata->texId);
     }
@@ -1136,11 +1532,15 @@ static GLuint _genTexture(RenderSurface* image)
     GL_CHECK(glGenTextures(1, &tex));
 
     GL_CHECK(glBindTexture(GL_TEXTURE_2D, tex));
+    GL_CHECK(glPixelStorei(GL_UNPACK_ROW_LENGTH, image->stride));
     GL_CHECK(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, image->w, image->h, 0, GL_RGBA, GL_UNSIGNED_BYTE, image->data));
+    GL_CHECK(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+    GL_CHECK(glGenerateMipmap(GL_TEXTURE_2D));
 
+    //trilinear filtering for the downscaled images
     GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
     GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
-    GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+    GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
     GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
 
     GL_CHECK(glBindTexture(GL_TEXTURE_2D, 0));
@@ -1149,22 +1549,45 @@ static GLuint _genTexture(RenderSurface* image)
 }
 
 
+//upload the changed pixels only, the texture storage is kept
+static void _updateTexture(GLuint tex, RenderSurface* image)
+{
+    auto& region = image->refreshed;
+
+    GL_CHECK(glBindTexture(GL_TEXTURE_2D, tex));
+    GL_CHECK(glPixelStorei(GL_UNPACK_ROW_LENGTH, image->stride));
+    GL_CHECK(glTexSubImage2D(GL_TEXTURE_2D, 0, region.sx(), region.sy(), region.sw(), region.sh(), GL_RGBA, GL_UNSIGNED_BYTE, image->buf32 + region.y() * image->stride + region.x()));
+    GL_CHECK(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+    GL_CHECK(glGenerateMipmap(GL_TEXTURE_2D));
+    GL_CHECK(glBindTexture(GL_TEXTURE_2D, 0));
+}
+
+
 RenderData GlRenderer::prepare(RenderSurface* image, RenderData data, const Matrix& transform, Array<RenderData>& clips, uint8_t opacity, RenderUpdateFlag flags)
 {
+    MemoryScope scope(MemoryCategory::Engine);
+
     auto sdata = static_cast<GlShape*>(data);
 
     if (!sdata) sdata = new GlShape;
 
+    auto prv = sdata->box;
+
     sdata->viewWd = static_cast<float>(surface.w);
     sdata->viewHt = static_cast<float>(surface.h);
     sdata->updateFlag = RenderUpdateFlag::Image;
 
     if (sdata->texId == 0) {
-        sdata->texId = _genTexture(image);
+        if (image->native) {
+            sdata->texId = (GLuint)(uintptr_t)image->data;
+            sdata->texExternal = true;
+        } else sdata->texId = _genTexture(image);
         sdata->opacity = opacity;
         sdata->texColorSpace = image->cs;
         sdata->texFlipY = 1;
         sdata->geometry = GlGeometry();
+    } else if (!sdata->texExternal && image->refreshed.valid()) {
+        _updateTexture(sdata->texId, image);
     }
 
     sdata->geometry.matrix = transform;
@@ -1177,26 +1600,42 @@ RenderData GlRenderer::prepare(RenderSurface* image, RenderData data, const Matr
         sdata->clips.push(clips);
     }
 
-    return sdata;
+    return dirty(sdata, prv);
 }
 
 
 RenderData GlRenderer::prepare(const RenderShape& rshape, RenderData data, const Matrix& transform, Array<RenderData>& clips, uint8_t opacity, RenderUpdateFlag flags, bool clipper)
 {
+    MemoryScope scope(MemoryCategory::Engine);
+
     // If prepare for clip, only path is meaningful.
+    auto changed = flags;
     if (clipper) flags = RenderUpdateFlag::Path;
 
     //prepare shape data
     GlShape* sdata = static_cast<GlShape*>(data);
-    if (!sdata) {
+    if (sdata) sdata->done();
+    else {
         sdata = new GlShape;
         sdata->rshape = &rshape;
     }
 
+    //clippers are not drawn, their changes damage the clipped paints
+    auto prv = sdata->box;
+    auto done = [&]() -> RenderData {
+        return clipper ? sdata : dirty(sdata, prv);
+    };
+
+    //the retained meshes are dropped along with the visibility
+    auto invisible = [&]() -> RenderData {
+        sdata->geometry = GlGeometry();
+        return done();
+    };
+
     sdata->viewWd = static_cast<float>(surface.w);
     sdata->viewHt = static_cast<float>(surface.h);
+    auto last = sdata->updateFlag;
     sdata->updateFlag = RenderUpdateFlag::None;
-    sdata->geometry = GlGeometry();
     sdata->opacity = opacity;
 
     //invisible?
@@ -1204,7 +1643,7 @@ RenderData GlRenderer::prepare(const RenderShape& rshape, RenderData data, const
     auto alphaS = rshape.stroke ? rshape.stroke->color.a : 0;
 
     if ((flags & RenderUpdateFlag::Gradient) == 0 && ((flags & RenderUpdateFlag::Color) && alphaF == 0) && ((flags & RenderUpdateFlag::Stroke) && alphaS == 0)) {
-        return sdata;
+        return invisible();
     }
 
     if (clipper) {
@@ -1216,20 +1655,31 @@ RenderData GlRenderer::prepare(const RenderShape& rshape, RenderData data, const
         if (rshape.strokeFill()) sdata->updateFlag = (RenderUpdateFlag::GradientStroke | sdata->updateFlag);
     }
 
-    if (sdata->updateFlag == RenderUpdateFlag::None) return sdata;
+    if (sdata->updateFlag == RenderUpdateFlag::None) return invisible();
 
     sdata->geometry.matrix = transform;
     sdata->geometry.viewport = vport;
-
-    if (sdata->updateFlag & (RenderUpdateFlag::Color | RenderUpdateFlag::Stroke | RenderUpdateFlag::Gradient | RenderUpdateFlag::GradientStroke | RenderUpdateFlag::Transform | RenderUpdateFlag::Path)) {
-        if (!sdata->geometry.tesselate(rshape, sdata->updateFlag)) return sdata;
-    }
+    sdata->geometry.tolerance = tolerance;
 
     if (flags & RenderUpdateFlag::Clip) {
         sdata->clips.clear();
         sdata->clips.push(clips);
     }
 
+    /* The tessellation runs on the worker threads, the drawing box and the damage are given by the task.
+       The meshes are in the local space, so a transformation alone mostly reuses them. */
+    sdata->changed = changed;
+    sdata->prvBox = prv;
+    sdata->glyphs = &mGlyphCache;
+    sdata->dirtyRegion = (clipper || mDirtyRegion.deactivated()) ? nullptr : &mDirtyRegion;
+    sdata->dirtyScope = mDirtyRegion.scope;
+
+    //the color only change reuses all the meshes and their bounds, no need to schedule it
+    if (changed == RenderUpdateFlag::Color && sdata->updateFlag == last && prv.valid()) {
+        sdata->box = RenderRegion::intersect(sdata->geometry.getBounds(), vport);
+        if (sdata->dirtyRegion) sdata->dirtyRegion->add(prv, sdata->box, sdata->dirtyScope);
+    } else mGroup.request(sdata);
+
     return sdata;
 }
 
@@ -1249,16 +1699,75 @@ bool GlRenderer::postUpdate()
 }
 
 
-void GlRenderer::damage(TVG_UNUSED RenderData rd, TVG_UNUSED const RenderRegion& region)
+void GlRenderer::damage(RenderData rd, const RenderRegion& region)
 {
-    //TODO
+    auto sdata = static_cast<GlShape*>(rd);
+    if (mDirtyRegion.deactivated() || (sdata && sdata->opacity == 0)) return;
+    mDirtyRegion.add(region, sdata ? sdata->dirtyScope : mDirtyRegion.scope);
 }
 
 
 bool GlRenderer::partial(bool disable)
 {
-    //TODO
-    return false;
+    return mDirtyRegion.deactivate(disable);
+}
+
+
+RenderDirtyRegion::Scope GlRenderer::scope(const RenderRegion& extend, const RenderRegion* clip)
+{
+    return mDirtyRegion.push(extend, clip);
+}
+
+
+void GlRenderer::scope(const RenderDirtyRegion::Scope& former)
+{
+    mDirtyRegion.pop(former);
+}
+
+
+bool GlRenderer::damages(const RenderRegion** regions, uint32_t* cnt)
+{
+    *regions = mDamages.data;
+    *cnt = mDamages.count;
+    return true;
+}
+
+
+RenderData GlRenderer::dirty(GlShape* sdata, const RenderRegion& prv)
+{
+    if (sdata->updateFlag == RenderUpdateFlag::None) sdata->box.reset();
+    else sdata->box = RenderRegion::intersect(sdata->geometry.getBounds(), vport);
+
+    sdata->dirtyScope = mDirtyRegion.scope;
+    if (!mDirtyRegion.deactivated()) mDirtyRegion.add(prv, sdata->box, sdata->dirtyScope);
+
+    return sdata;
+}
+
+
+//collect the damaged regions of this frame and return their union
+RenderRegion GlRenderer::damaged()
+{
+    mDamages.clear();
+
+    RenderRegion full = {{0, 0}, {int32_t(surface.w), int32_t(surface.h)}};
+    if (mFullDraw || mDirtyRegion.deactivated()) {
+        mDamages.push(full);
+        return full;
+    }
+
+    mDirtyRegion.commit();
+
+    RenderRegion ret{};
+    for (uint32_t idx = 0; idx < mDirtyRegion.count(); ++idx) {
+        ARRAY_FOREACH(p, mDirtyRegion.get(idx)) {
+            if (ret.valid()) ret.add(*p);
+            else ret = *p;
+            mDamages.push(*p);
+        }
+    }
+    ret.intersect(full);
+    return ret;
 }
 
 
@@ -1266,6 +1775,7 @@ bool GlRenderer::term()
 {
     if (rendererCnt > 0) return false;
 
+    GlProgram::term();
     glTerm();
 
     rendererCnt = -1;
@@ -1274,6 +1784,14 @@ bool GlRenderer::term()
 }
 
 
+void GlRenderer::trim(bool caches)
+{
+    //the renderers release them at their next frame, with their contexts current
+    ++trimCnt;
+    if (caches) ++cacheCnt;
+}
+
+
 GlRenderer* GlRenderer::gen(TVG_UNUSED uint32_t threads)
 {
     //initialize engine
@@ -29,6 +29,7 @@
 #include "tvgGlGpuBuffer.h"
 #include "tvgGlRenderPass.h"
 #include "tvgGlEffect.h"
+#include "tvgGlTessellator.h"
 
 class GlRenderer : public RenderMethod
 {
@@ -60,6 +61,10 @@ public:
         RT_SoftLightBlend,
         RT_DifferenceBlend,
         RT_ExclusionBlend,
+        RT_ColorBatch,
+        RT_ColorFringe,
+        RT_LinGradientFringe,
+        RT_RadGradientFringe,
 
         RT_None,
     };
@@ -91,49 +96,74 @@ public:
     void prepare(RenderEffect* effect, const Matrix& transform) override;
     bool region(RenderEffect* effect) override;
     bool render(RenderCompositor* cmp, const RenderEffect* effect, bool direct) override;
+    bool fuse(RenderCompositor* cmp, const RenderEffect* const* effects, uint32_t cnt) override;
     void dispose(RenderEffect* effect) override;
 
     //partial rendering
     void damage(RenderData rd, const RenderRegion& region) override;
     bool partial(bool disable) override;
+    RenderDirtyRegion::Scope scope(const RenderRegion& extend, const RenderRegion* clip) override;
+    void scope(const RenderDirtyRegion::Scope& former) override;
+    bool damages(const RenderRegion** regions, uint32_t* cnt) override;
 
     static GlRenderer* gen(uint32_t threads);
     static bool term();
+    static void trim(bool caches);
 
 private:
     GlRenderer(); 
     ~GlRenderer();
 
     void initShaders();
+    GlProgram* program(RenderTypes type);
     void drawPrimitive(GlShape& sdata, const RenderColor& c, RenderUpdateFlag flag, int32_t depth);
     void drawPrimitive(GlShape& sdata, const Fill* fill, RenderUpdateFlag flag, int32_t depth);
+    void drawBatch(GlShape& sdata, const RenderColor& c, RenderUpdateFlag flag, const RenderRegion& viewport, int32_t depth);
+    GlRenderTask* drawFringe(GlShape& sdata, GlProgram* program, RenderUpdateFlag flag, const RenderRegion& viewport, int32_t depth, uint32_t matrixOffset);
     void drawClip(Array<RenderData>& clips);
 
     GlRenderPass* currentPass();
 
     bool beginComplexBlending(const RenderRegion& vp, RenderRegion bounds);
     void endBlendingCompose(GlRenderTask* stencilTask, const Matrix& matrix);
-    GlProgram* getBlendProgram();
+    GlProgram* getBlendProgram(bool fetch);
 
     void prepareBlitTask(GlBlitTask* task);
     void prepareCmpTask(GlRenderTask* task, const RenderRegion& vp, uint32_t cmpWidth, uint32_t cmpHeight);
     void endRenderPass(RenderCompositor* cmp);
 
+    RenderData dirty(GlShape* sdata, const RenderRegion& prv);
+    RenderRegion damaged();
+
     void flush();
     void clearDisposes();
     void currentContext();
+    bool beginGpuTime();
+    void endGpuTime();
 
     void* mContext = nullptr;
     RenderSurface surface;
     GLint mTargetFboId = 0;
     GlStageBuffer mGpuBuffer;
+    GlGlyphCache mGlyphCache;
     GlRenderTarget mRootTarget;
     GlEffect mEffect;
     Array<GlProgram*> mPrograms;
+    Array<GlProgram*> mAlphaPrograms;  //the variants drawing into the alpha mask targets, see program()
+    Array<GlProgram*> mFetchPrograms;  //the blend variants reading the destination in place, see getBlendProgram()
+    const char* mFetchHeader = nullptr;  //the framebuffer fetch extension of the blend variants, null if unsupported
+    //the gpu times of the frames in flight while profiling, a result is read once it's ready
+    GLuint mTimeQueries[GL_STAGE_RING_SIZE] = {};
+    bool mTimePending[GL_STAGE_RING_SIZE] = {};
+    uint32_t mTimeQuery = 0;
+    bool mTimerSupport = false;
     Array<GlRenderTargetPool*> mComposePool;
     Array<GlRenderTargetPool*> mBlendPool;
     Array<GlRenderPass*> mRenderPassStack;
     Array<GlCompositor*> mComposeStack;
+    Array<float> mBatchVertices;     //scratch buffers of the batched meshes
+    Array<uint32_t> mBatchIndices;
+    Array<Point> mBatchPoints;
 
     //Disposed resources. They should be released on synced call.
     struct {
@@ -141,8 +171,15 @@ private:
         Key key;
     } mDisposed;
 
+    RenderDirtyRegion mDirtyRegion;
+    Array<RenderRegion> mDamages;  //the regions updated by the last sync
+    TaskGroup mGroup;              //completion of the tessellation tasks
+
     BlendMethod mBlendMethod = BlendMethod::Normal;
+    uint32_t mTrimmed = 0;       //the last trim requests handled, see trim()
+    uint32_t mCacheTrimmed = 0;
     bool mClearBuffer = false;
+    bool mFullDraw = true;  //the target content is unknown, redraw the full screen
 };
 
 #endif /* _TVG_GL_RENDERER_H_ */
@@ -20,6 +20,7 @@
  * SOFTWARE.
  */
 
+#include <cstring>
 #include "tvgGlShader.h"
 
 /************************************************************************/
@@ -36,21 +37,31 @@ uint32_t GlShader::compileShader(uint32_t type, char* shaderSrc)
 
     /**
      * [0] shader version string
-     * [1] precision declaration
-     * [2] shader source
+     * [1] extension directive leading the shader source, it precedes the other tokens
+     * [2] precision declaration
+     * [3] shader source
      */
-    const char* shaderPack[3];
+    const char* shaderPack[4];
+    GLint shaderLens[4] = {-1, 0, -1, -1};
     // but in general All Desktop GPU should use OpenGL version ( #version 330 core )
 #if defined (THORVG_GL_TARGET_GLES)
     shaderPack[0] ="#version 300 es\n";
 #else
     shaderPack[0] ="#version 330 core\n";
 #endif
-    shaderPack[1] = "precision highp float;\n precision highp int;\n";
-    shaderPack[2] = shaderSrc;
+    shaderPack[1] = shaderSrc;
+    if (!strncmp(shaderSrc, "#extension", 10)) {
+        auto eol = strchr(shaderSrc, '\n');
+        if (eol) {
+            shaderLens[1] = GLint(eol - shaderSrc + 1);
+            shaderSrc = eol + 1;
+        }
+    }
+    shaderPack[2] = "precision highp float;\n precision highp int;\n";
+    shaderPack[3] = shaderSrc;
 
     // Load the shader source
-    glShaderSource(shader, 3, shaderPack, NULL);
+    glShaderSource(shader, 4, shaderPack, shaderLens);
 
     // Compile the shader
     glCompileShader(shader);
@@ -30,12 +30,14 @@ const char* COLOR_VERT_SHADER = TVG_COMPOSE_SHADER(
     layout(std140) uniform Matrix {                                 \n
         mat4 transform;                                             \n
     } uMatrix;                                                      \n
+    out float vCoverage;                                            \n
                                                                     \n
     void main()                                                     \n
     {                                                               \n
         vec4 pos = uMatrix.transform * vec4(aLocation, 0.0, 1.0);   \n
         pos.z = uDepth;                                             \n
         gl_Position = pos;                                          \n
+        vCoverage = 1.0;                                            \n
     }                                                               \n
 );
 
@@ -43,12 +45,68 @@ const char* COLOR_FRAG_SHADER = TVG_COMPOSE_SHADER(
     layout(std140) uniform ColorInfo {                       \n
         vec4 solidColor;                                     \n
     } uColorInfo;                                            \n
+    in float vCoverage;                                      \n
     out vec4 FragColor;                                      \n
                                                              \n
     void main()                                              \n
     {                                                        \n
        vec4 uColor = uColorInfo.solidColor;                  \n
-       FragColor =  vec4(uColor.rgb * uColor.a, uColor.a);   \n
+       float a = uColor.a * vCoverage;                       \n
+       FragColor =  vec4(uColor.rgb * a, a);                 \n
+    }                                                        \n
+);
+
+//the edge fringes, pushed aside by the given pixels on the screen. see: GlGeometry::drawFringe()
+const char* FRINGE_COLOR_VERT_SHADER = TVG_COMPOSE_SHADER(
+    uniform float uDepth;                                                               \n
+    layout(location = 0) in vec2 aLocation;                                             \n
+    layout(location = 1) in vec4 aEdge;                                                 \n
+    layout(std140) uniform Matrix {                                                     \n
+        mat4 transform;                                                                 \n
+    } uMatrix;                                                                          \n
+    layout(std140) uniform ViewInfo {                                                   \n
+        vec4 size;                                                                      \n
+    } uViewInfo;                                                                        \n
+    out float vCoverage;                                                                \n
+                                                                                        \n
+    void main()                                                                         \n
+    {                                                                                   \n
+        vec4 pos = uMatrix.transform * vec4(aLocation, 0.0, 1.0);                       \n
+        vec2 dir = (uMatrix.transform * vec4(aEdge.xy, 0.0, 0.0)).xy * uViewInfo.size.xy; \n
+        float len = length(dir);                                                        \n
+        if (len > 0.0) pos.xy += vec2(-dir.y, dir.x) * (2.0 * aEdge.z / len) / uViewInfo.size.xy; \n
+        pos.z = uDepth;                                                                 \n
+        gl_Position = pos;                                                              \n
+        vCoverage = aEdge.w;                                                            \n
+    }                                                                                   \n
+);
+
+//the vertices carry their draw depth and premultiplied color, the transform is applied in advance
+const char* COLOR_BATCH_VERT_SHADER = TVG_COMPOSE_SHADER(
+    uniform float uDepth;                                               \n
+    layout(location = 0) in vec3 aLocation;                             \n
+    layout(location = 1) in vec4 aColor;                                \n
+    layout(std140) uniform Matrix {                                     \n
+        mat4 transform;                                                 \n
+    } uMatrix;                                                          \n
+    out vec4 vColor;                                                    \n
+                                                                        \n
+    void main()                                                         \n
+    {                                                                   \n
+        vec4 pos = uMatrix.transform * vec4(aLocation.xy, 0.0, 1.0);    \n
+        pos.z = aLocation.z * uDepth;                                   \n
+        gl_Position = pos;                                              \n
+        vColor = aColor;                                                \n
+    }                                                                   \n
+);
+
+const char* COLOR_BATCH_FRAG_SHADER = TVG_COMPOSE_SHADER(
+    in vec4 vColor;                                          \n
+    out vec4 FragColor;                                      \n
+                                                             \n
+    void main()                                              \n
+    {                                                        \n
+       FragColor = vColor;                                   \n
     }                                                        \n
 );
 
@@ -56,6 +114,7 @@ const char* GRADIENT_VERT_SHADER = TVG_COMPOSE_SHADER(
     uniform float uDepth;                                                           \n
     layout(location = 0) in vec2 aLocation;                                         \n
     out vec2 vPos;                                                                  \n
+    out float vCoverage;                                                            \n
     layout(std140) uniform Matrix {                                                 \n
         mat4 transform;                                                             \n
     } uMatrix;                                                                      \n
@@ -70,14 +129,46 @@ const char* GRADIENT_VERT_SHADER = TVG_COMPOSE_SHADER(
         gl_Position = glPos;                                                        \n
         vec4 pos =  uInvMatrix.transform * vec4(aLocation, 0.0, 1.0);               \n
         vPos = pos.xy / pos.w;                                                      \n
+        vCoverage = 1.0;                                                            \n
     }                                                                               \n
 );
 
+const char* FRINGE_GRADIENT_VERT_SHADER = TVG_COMPOSE_SHADER(
+    uniform float uDepth;                                                               \n
+    layout(location = 0) in vec2 aLocation;                                             \n
+    layout(location = 1) in vec4 aEdge;                                                 \n
+    out vec2 vPos;                                                                      \n
+    out float vCoverage;                                                                \n
+    layout(std140) uniform Matrix {                                                     \n
+        mat4 transform;                                                                 \n
+    } uMatrix;                                                                          \n
+    layout(std140) uniform InvMatrix {                                                  \n
+        mat4 transform;                                                                 \n
+    } uInvMatrix;                                                                       \n
+    layout(std140) uniform ViewInfo {                                                   \n
+        vec4 size;                                                                      \n
+    } uViewInfo;                                                                        \n
+                                                                                        \n
+    void main()                                                                         \n
+    {                                                                                   \n
+        vec4 glPos = uMatrix.transform * vec4(aLocation, 0.0, 1.0);                     \n
+        vec2 dir = (uMatrix.transform * vec4(aEdge.xy, 0.0, 0.0)).xy * uViewInfo.size.xy; \n
+        float len = length(dir);                                                        \n
+        if (len > 0.0) glPos.xy += vec2(-dir.y, dir.x) * (2.0 * aEdge.z / len) / uViewInfo.size.xy; \n
+        glPos.z = uDepth;                                                               \n
+        gl_Position = glPos;                                                            \n
+        vec4 pos =  uInvMatrix.transform * vec4(aLocation, 0.0, 1.0);                   \n
+        vPos = pos.xy / pos.w;                                                          \n
+        vCoverage = aEdge.w;                                                            \n
+    }                                                                                   \n
+);
+
 
 //See: GlRenderer::initShaders()
 const char* STR_GRADIENT_FRAG_COMMON_VARIABLES = TVG_COMPOSE_SHADER(
     const int MAX_STOP_COUNT = 16;                                                                          \n
     in vec2 vPos;                                                                                           \n
+    in float vCoverage;                                                                                     \n
 );
 
 //See: GlRenderer::initShaders()
@@ -194,6 +285,7 @@ const char* STR_LINEAR_GRADIENT_MAIN = TVG_COMPOSE_SHADER(
         float d = dot(pos - st, ba) / dot(ba, ba);                                                          \n
         float t = gradientWrap(d);                                                                          \n
         vec4 color = gradient(t, d, length(pos - st));                                                      \n
+        color.a *= vCoverage;                                                                               \n
         FragColor =  vec4(color.rgb * color.a, color.a);                                                    \n
     }                                                                                                       \n
 );
@@ -315,6 +407,7 @@ const char* STR_RADIAL_GRADIENT_MAIN = TVG_COMPOSE_SHADER(
         }                                                                                                   \n
         float t = gradientWrap(res.x);                                                                      \n
         vec4 color = gradient(t, res.x, length(pos - uGradientInfo.centerPos.xy));                          \n
+        color.a *= vCoverage;                                                                               \n
         FragColor =  vec4(color.rgb * color.a, color.a);                                                    \n
     }
 );
@@ -592,19 +685,31 @@ const char* BLIT_FRAG_SHADER = TVG_COMPOSE_SHADER(
     }
 );
 
-#define COMPLEX_BLEND_HEADER R"( \
-    uniform sampler2D uSrcTexture; \
-    uniform sampler2D uDstTexture; \
-    \
-    in vec2 vUV; \
-    out vec4 FragColor; \
-)"
+/* The destination is sampled from its copy, or read in place where the framebuffer fetch
+   is supported, see FETCH_EXT_FRAG_HEADER and FETCH_ARM_FRAG_HEADER */
+#define COMPLEX_BLEND_HEADER \
+    "uniform sampler2D uSrcTexture;\n" \
+    "in vec2 vUV;\n" \
+    "#if defined(TVG_FETCH_EXT)\n" \
+    "    inout vec4 FragColor;\n" \
+    "    #define DST_COLOR FragColor\n" \
+    "#elif defined(TVG_FETCH_ARM)\n" \
+    "    out vec4 FragColor;\n" \
+    "    #define DST_COLOR gl_LastFragColorARM\n" \
+    "#else\n" \
+    "    uniform sampler2D uDstTexture;\n" \
+    "    out vec4 FragColor;\n" \
+    "    #define DST_COLOR texture(uDstTexture, vUV)\n" \
+    "#endif\n"
+
+const char* FETCH_EXT_FRAG_HEADER = "#extension GL_EXT_shader_framebuffer_fetch : require\n#define TVG_FETCH_EXT\n";
+const char* FETCH_ARM_FRAG_HEADER = "#extension GL_ARM_shader_framebuffer_fetch : require\n#define TVG_FETCH_ARM\n";
 
 const char* MULTIPLY_BLEND_FRAG = COMPLEX_BLEND_HEADER  R"(
     void main()
     {
         vec4 srcColor = texture(uSrcTexture, vUV);
-        vec4 dstColor = texture(uDstTexture, vUV);
+        vec4 dstColor = DST_COLOR;
         FragColor = srcColor * dstColor;
     }
 )";
@@ -638,7 +743,7 @@ const char* SCREEN_BLEND_FRAG = COMPLEX_BLEND_HEADER SCREEN_BLEND_FUNC R"(
     void main()
     {
         vec4 srcColor = texture(uSrcTexture, vUV);
-        vec4 dstColor = texture(uDstTexture, vUV);
+        vec4 dstColor = DST_COLOR;
         FragColor = screenBlend(srcColor, dstColor);
     }
 )";
@@ -647,7 +752,7 @@ const char* OVERLAY_BLEND_FRAG = COMPLEX_BLEND_HEADER HARD_LIGHT_BLEND_FUNC R"(
     void main()
     {
         vec4 srcColor = texture(uSrcTexture, vUV);
-        vec4 dstColor = texture(uDstTexture, vUV);
+        vec4 dstColor = DST_COLOR;
         FragColor = hardLightBlend(dstColor, srcColor);
     }
 )";
@@ -656,7 +761,7 @@ const char* COLOR_DODGE_BLEND_FRAG = COMPLEX_BLEND_HEADER R"(
     void main()
     {
         vec4 srcColor = texture(uSrcTexture, vUV);
-        vec4 dstColor = texture(uDstTexture, vUV);
+        vec4 dstColor = DST_COLOR;
 
         FragColor = vec4(
             srcColor.r < 1.0 ? dstColor.r / (1.0 - srcColor.r) : (dstColor.r > 0.0 ? 1.0 : 0.0),
@@ -671,7 +776,7 @@ const char* COLOR_BURN_BLEND_FRAG = COMPLEX_BLEND_HEADER R"(
     void main()
     {
         vec4 srcColor = texture(uSrcTexture, vUV);
-        vec4 dstColor = texture(uDstTexture, vUV);
+        vec4 dstColor = DST_COLOR;
 
         FragColor = vec4(
             srcColor.r > 0.0 ? (1.0 - (1.0 - dstColor.r) / srcColor.r) : (dstColor.r < 1.0 ? 0.0 : 1.0),
@@ -686,7 +791,7 @@ const char* HARD_LIGHT_BLEND_FRAG = COMPLEX_BLEND_HEADER HARD_LIGHT_BLEND_FUNC R
     void main()
     {
         vec4 srcColor = texture(uSrcTexture, vUV);
-        vec4 dstColor = texture(uDstTexture, vUV);
+        vec4 dstColor = DST_COLOR;
         FragColor = hardLightBlend(srcColor, dstColor);
     }
 )";
@@ -695,7 +800,7 @@ const char* SOFT_LIGHT_BLEND_FRAG = COMPLEX_BLEND_HEADER SOFT_LIGHT_BLEND_FUNC R
     void main()
     {
         vec4 srcColor = texture(uSrcTexture, vUV);
-        vec4 dstColor = texture(uDstTexture, vUV);
+        vec4 dstColor = DST_COLOR;
 
         FragColor = vec4(
             srcColor.r <= 0.5 ? dstColor.r - (1.0 - 2.0 * srcColor.r) * dstColor.r * (1.0 - dstColor.r) : dstColor.r + (2.0 * srcColor.r - 1.0) * (softLightD(dstColor.r) - dstColor.r),
@@ -710,7 +815,7 @@ const char* DIFFERENCE_BLEND_FRAG = COMPLEX_BLEND_HEADER R"(
     void main()
     {
         vec4 srcColor = texture(uSrcTexture, vUV);
-        vec4 dstColor = texture(uDstTexture, vUV);
+        vec4 dstColor = DST_COLOR;
 
         FragColor = abs(dstColor - srcColor);
     }
@@ -720,12 +825,25 @@ const char* EXCLUSION_BLEND_FRAG = COMPLEX_BLEND_HEADER R"(
     void main()
     {
         vec4 srcColor = texture(uSrcTexture, vUV);
-        vec4 dstColor = texture(uDstTexture, vUV);
+        vec4 dstColor = DST_COLOR;
 
         FragColor = dstColor + srcColor - (2.0 * dstColor * srcColor);
     }
 )";
 
+/* The variants of the fragment shaders drawing into the single channel target of the alpha masks.
+   The original main() is renamed, its result is reduced to the coverage. */
+const char* ALPHA_FRAG_HEADER = "#define main tvgColorMain\n";
+
+const char* ALPHA_FRAG_FOOTER = R"(
+#undef main
+void main()
+{
+    tvgColorMain();
+    FragColor = vec4(FragColor.a);
+}
+)";
+
 const char* EFFECT_VERTEX = R"(
 layout(location = 0) in vec2 aLocation;
 out vec2 vUV;
@@ -809,6 +927,79 @@ void main()
 } 
 )";
 
+//the single channel variants for the drop shadow, only the alpha is blurred into the R8 targets
+const char* SHADOW_VERTICAL = R"(
+uniform sampler2D uSrcTexture;
+layout(std140) uniform Gaussian {
+    float sigma;
+    float scale;
+    float extend;
+    float dummy0;
+} uGaussian;
+
+in vec2 vUV;
+out vec4 FragColor;
+
+float gaussian(float x, float sigma) {
+    float exponent = -x * x / (2.0 * sigma * sigma);
+    return exp(exponent) / (sqrt(2.0 * 3.141592) * sigma);
+}
+
+void main()
+{
+    vec2 texelSize = 1.0 / vec2(textureSize(uSrcTexture, 0));
+    float alphaSum = 0.0;
+    float sigma = uGaussian.sigma * uGaussian.scale;
+    float weightSum = 0.0;
+    int radius = int(uGaussian.extend);
+
+    for (int y = -radius; y <= radius; ++y) {
+        float weight = gaussian(float(y), sigma);
+        vec2 offset = vec2(0.0, float(y) * texelSize.y);
+        alphaSum += texture(uSrcTexture, vUV + offset).a * weight;
+        weightSum += weight;
+    }
+
+    FragColor = vec4(alphaSum / weightSum);
+}
+)";
+
+const char* SHADOW_HORIZONTAL = R"(
+uniform sampler2D uSrcTexture;
+layout(std140) uniform Gaussian {
+    float sigma;
+    float scale;
+    float extend;
+    float dummy0;
+} uGaussian;
+
+in vec2 vUV;
+out vec4 FragColor;
+
+float gaussian(float x, float sigma) {
+    float exponent = -x * x / (2.0 * sigma * sigma);
+    return exp(exponent) / (sqrt(2.0 * 3.141592) * sigma);
+}
+
+void main()
+{
+    vec2 texelSize = 1.0 / vec2(textureSize(uSrcTexture, 0));
+    float alphaSum = 0.0;
+    float sigma = uGaussian.sigma * uGaussian.scale;
+    float weightSum = 0.0;
+    int radius = int(uGaussian.extend);
+
+    for (int y = -radius; y <= radius; ++y) {
+        float weight = gaussian(float(y), sigma);
+        vec2 offset = vec2(float(y) * texelSize.x, 0.0);
+        alphaSum += texture(uSrcTexture, vUV + offset).a * weight;
+        weightSum += weight;
+    }
+
+    FragColor = vec4(alphaSum / weightSum);
+}
+)";
+
 const char* EFFECT_DROPSHADOW = R"(
 uniform sampler2D uSrcTexture;
 uniform sampler2D uBlrTexture;
@@ -892,3 +1083,52 @@ void main()
     FragColor = tmp * orig.a;
 } 
 )";
+
+const char* EFFECT_COLORS = R"(
+uniform sampler2D uSrcTexture;
+layout(std140) uniform Params {
+    vec4 header;        // [0]: steps count
+    vec4 steps[4 * 8];  // [0].x: type (0: fill, 1: tint, 2: tritone), [1..3]: the effect params
+} uParams;
+
+in vec2 vUV;
+out vec4 FragColor;
+
+vec4 fill(vec4 orig, int i)
+{
+    vec4 fill = uParams.steps[i + 1];
+    return fill * orig.a * fill.a;
+}
+
+vec4 tint(vec4 orig, int i)
+{
+    float luma = dot(orig.rgb, vec3(0.2126, 0.7152, 0.0722));
+    return vec4(mix(orig.rgb, mix(uParams.steps[i + 1].rgb, uParams.steps[i + 2].rgb, luma), uParams.steps[i + 3].r) * orig.a, orig.a);
+}
+
+vec4 tritone(vec4 orig, int i)
+{
+    float luma = dot(orig.rgb, vec3(0.2126, 0.7152, 0.0722));
+    bool isBright = luma >= 0.5f;
+    float t = isBright ? (luma - 0.5f) * 2.0f : luma * 2.0f;
+    vec3 from = isBright ? uParams.steps[i + 2].rgb : uParams.steps[i + 1].rgb;
+    vec3 to = isBright ? uParams.steps[i + 3].rgb : uParams.steps[i + 2].rgb;
+    vec4 tmp = vec4(mix(from, to, t), 1.0f);
+
+    if (uParams.steps[i + 3].a > 0.0f) tmp = mix(tmp, orig, uParams.steps[i + 3].a);
+    return tmp * orig.a;
+}
+
+void main()
+{
+    vec4 color = texture(uSrcTexture, vUV);
+    int cnt = int(uParams.header.x);
+    for (int i = 0; i < cnt * 4; i += 4) {
+        int type = int(uParams.steps[i].x);
+        if (type == 0) color = fill(color, i);
+        else if (type == 1) color = tint(color, i);
+        else color = tritone(color, i);
+    }
+    FragColor = color;
+}
+)";
@@ -25,7 +25,11 @@
 
 extern const char* COLOR_VERT_SHADER;
 extern const char* COLOR_FRAG_SHADER;
+extern const char* COLOR_BATCH_VERT_SHADER;
+extern const char* COLOR_BATCH_FRAG_SHADER;
+extern const char* FRINGE_COLOR_VERT_SHADER;
 extern const char* GRADIENT_VERT_SHADER;
+extern const char* FRINGE_GRADIENT_VERT_SHADER;
 extern const char* STR_GRADIENT_FRAG_COMMON_VARIABLES;
 extern const char* STR_GRADIENT_FRAG_COMMON_FUNCTIONS;
 extern const char* STR_LINEAR_GRADIENT_VARIABLES;
@@ -58,13 +62,21 @@ extern const char* HARD_LIGHT_BLEND_FRAG;
 extern const char* SOFT_LIGHT_BLEND_FRAG;
 extern const char* DIFFERENCE_BLEND_FRAG;
 extern const char* EXCLUSION_BLEND_FRAG;
+extern const char* FETCH_EXT_FRAG_HEADER;
+extern const char* FETCH_ARM_FRAG_HEADER;
+
+extern const char* ALPHA_FRAG_HEADER;
+extern const char* ALPHA_FRAG_FOOTER;
 
 extern const char* EFFECT_VERTEX;
 extern const char* GAUSSIAN_VERTICAL;
 extern const char* GAUSSIAN_HORIZONTAL;
+extern const char* SHADOW_VERTICAL;
+extern const char* SHADOW_HORIZONTAL;
 extern const char* EFFECT_DROPSHADOW;
 extern const char* EFFECT_FILL;
 extern const char* EFFECT_TINT;
 extern const char* EFFECT_TRITONE;
+extern const char* EFFECT_COLORS;
 
 #endif /* _TVG_GL_SHADERSRC_H_ */
@@ -34,8 +34,9 @@ static uint32_t _pushVertex(Array<float>& array, float x, float y)
 }
 
 
-Stroker::Stroker(GlGeometryBuffer* buffer, const Matrix& matrix) : mBuffer(buffer), mMatrix(matrix)
+Stroker::Stroker(GlGeometryBuffer* buffer, const Matrix& matrix, float tolerance) : mBuffer(buffer), mMatrix(matrix), mTolerance(tolerance)
 {
+    mScale = std::max(sqrtf(matrix.e11 * matrix.e11 + matrix.e21 * matrix.e21), sqrtf(matrix.e12 * matrix.e12 + matrix.e22 * matrix.e22));
 }
 
 
@@ -192,7 +193,7 @@ void Stroker::strokeCubicTo(const Point& cnt1, const Point& cnt2, const Point& e
 {
     Bezier curve{ mStrokeState.prevPt, cnt1, cnt2, end };
 
-    auto count = (curve * mMatrix).segments();
+    auto count = (curve * mMatrix).segments(mTolerance);
     auto step = 1.f / count;
 
     for (uint32_t i = 0; i <= count; i++) {
@@ -257,8 +258,9 @@ void Stroker::strokeRound(const Point &prev, const Point& curr, const Point& cen
     mRightBottom.x = std::max(mRightBottom.x, std::max(center.x, std::max(prev.x, curr.x)));
     mRightBottom.y = std::max(mRightBottom.y, std::max(center.y, std::max(prev.y, curr.y)));
 
-    // Fixme: just use bezier curve to calculate step count
-    auto count = Bezier(prev, curr, strokeRadius()).segments();
+    //the arc is segmented on the screen
+    auto angle = acosf(tvg::clamp(dot(prev - center, curr - center) / (strokeRadius() * strokeRadius()), -1.0f, 1.0f));
+    auto count = arcSegments(strokeRadius() * mScale, angle, mTolerance) + 1;
     auto c = _pushVertex(mBuffer->vertex, center.x, center.y);
     auto pi = _pushVertex(mBuffer->vertex, prev.x, prev.y);
     auto step = 1.f / (count - 1);
@@ -289,8 +291,7 @@ void Stroker::strokeRound(const Point &prev, const Point& curr, const Point& cen
 
 void Stroker::strokeRoundPoint(const Point &p)
 {
-    // Fixme: just use bezier curve to calculate step count
-    auto count = Bezier(p, p, strokeRadius()).segments() * 2;
+    auto count = arcSegments(strokeRadius() * mScale, 2.0f * MATH_PI, mTolerance) + 1;
     auto c = _pushVertex(mBuffer->vertex, p.x, p.y);
     auto step = 2 * MATH_PI / (count - 1);
 
@@ -432,7 +433,105 @@ void Stroker::strokeRound(const Point& p, const Point& outDir)
 }
 
 
-BWTessellator::BWTessellator(GlGeometryBuffer* buffer): mBuffer(buffer)
+static constexpr uint32_t GLYPH_CACHE_BUDGET = 1024 * 1024;   //the vertices kept in total, the cache is flushed beyond
+
+
+static uint32_t _hash(uint32_t id, const float* m)
+{
+    uint32_t bits[4];
+    memcpy(bits, m, sizeof(bits));
+
+    auto h = id * 0x9e3779b1u;
+    for (int i = 0; i < 4; ++i) h = (h ^ bits[i]) * 0x85ebca6bu;
+    return h ^ (h >> 15);
+}
+
+
+GlGlyphCache::~GlGlyphCache()
+{
+    clear();
+    tvg::free(mSlots);
+}
+
+
+GlGlyphCache::Entry* GlGlyphCache::find(uint32_t id, const float* m, float tolerance, uint32_t hash) const
+{
+    if (mCount == 0) return nullptr;
+    for (auto i = hash & (mCapacity - 1); mSlots[i]; i = (i + 1) & (mCapacity - 1)) {
+        auto entry = mSlots[i];
+        if (entry->id == id && entry->tolerance == tolerance && !memcmp(entry->m, m, sizeof(entry->m))) return entry;
+    }
+    return nullptr;
+}
+
+
+void GlGlyphCache::insert(Entry* entry, uint32_t hash)
+{
+    auto vertices = entry->mesh.vertex.count / 2;
+    if (mVertices + vertices > GLYPH_CACHE_BUDGET) clear();
+
+    if ((mCount + 1) * 2 > mCapacity) {
+        auto old = mSlots;
+        auto oldCapacity = mCapacity;
+
+        mCapacity = mCapacity ? mCapacity * 2 : 256;
+        mSlots = tvg::calloc<Entry**>(mCapacity, sizeof(Entry*));
+
+        for (uint32_t i = 0; i < oldCapacity; ++i) {
+            if (!old[i]) continue;
+            auto j = _hash(old[i]->id, old[i]->m) & (mCapacity - 1);
+            while (mSlots[j]) j = (j + 1) & (mCapacity - 1);
+            mSlots[j] = old[i];
+        }
+        tvg::free(old);
+    }
+
+    auto i = hash & (mCapacity - 1);
+    while (mSlots[i]) i = (i + 1) & (mCapacity - 1);
+    mSlots[i] = entry;
+    ++mCount;
+    mVertices += vertices;
+}
+
+
+const GlGeometryBuffer* GlGlyphCache::mesh(const RenderGlyphRun::Glyph& glyph, const PathCommand* cmds, const Point* pts, const Matrix& matrix, float tolerance)
+{
+    float m[4] = {matrix.e11, matrix.e12, matrix.e21, matrix.e22};
+    auto hash = _hash(glyph.id, m);
+    if (auto entry = find(glyph.id, m, tolerance, hash)) return &entry->mesh;
+
+    //the glyph outline moved to the origin
+    RenderPath path;
+    path.cmds.reserve(glyph.cmdCnt);
+    memcpy(path.cmds.data, cmds, sizeof(PathCommand) * glyph.cmdCnt);
+    path.cmds.count = glyph.cmdCnt;
+    path.pts.reserve(glyph.ptsCnt);
+    for (uint32_t i = 0; i < glyph.ptsCnt; ++i) path.pts.push(pts[i] - glyph.offset);
+
+    auto entry = new Entry;
+    memcpy(entry->m, m, sizeof(entry->m));
+    entry->tolerance = tolerance;
+    entry->id = glyph.id;
+
+    BWTessellator bwTess{&entry->mesh, tolerance};
+    bwTess.tessellate(path, matrix);
+
+    insert(entry, hash);
+    return &entry->mesh;
+}
+
+
+void GlGlyphCache::clear()
+{
+    for (uint32_t i = 0; i < mCapacity; ++i) {
+        delete(mSlots[i]);
+        mSlots[i] = nullptr;
+    }
+    mCount = mVertices = 0;
+}
+
+
+BWTessellator::BWTessellator(GlGeometryBuffer* buffer, float tolerance): mBuffer(buffer), mTolerance(tolerance)
 {
 }
 
@@ -457,6 +556,7 @@ void BWTessellator::tessellate(const RenderPath& path, const Matrix& matrix)
             case PathCommand::MoveTo: {
                 firstIndex = pushVertex(pts->x, pts->y);
                 prevIndex = 0;
+                ++mContours;
                 pts++;
             } break;
             case PathCommand::LineTo: {
@@ -473,7 +573,7 @@ void BWTessellator::tessellate(const RenderPath& path, const Matrix& matrix)
             case PathCommand::CubicTo: {
                 Bezier curve{pts[-1], pts[0], pts[1], pts[2]};
 
-                auto stepCount = (curve * matrix).segments();
+                auto stepCount = (curve * matrix).segments(mTolerance);
                 if (stepCount <= 1) stepCount = 2;
 
                 float step = 1.f / stepCount;
@@ -501,12 +601,68 @@ void BWTessellator::tessellate(const RenderPath& path, const Matrix& matrix)
 }
 
 
+//the same meshes to tessellate(path, matrix), the glyph meshes are reused
+void BWTessellator::tessellate(const RenderPath& path, const RenderGlyphRun& run, const Matrix& matrix, GlGlyphCache& cache)
+{
+    auto cmds = path.cmds.data;
+    auto pts = path.pts.data;
+
+    ScopedLock lock(cache.key);
+
+    ARRAY_FOREACH(p, run.glyphs) {
+        auto mesh = cache.mesh(*p, cmds, pts, matrix, mTolerance);
+        auto base = mBuffer->vertex.count / 2;
+
+        mBuffer->vertex.grow(mesh->vertex.count);
+        for (uint32_t i = 0; i < mesh->vertex.count; i += 2) {
+            pushVertex(mesh->vertex[i] + p->offset.x, mesh->vertex[i + 1] + p->offset.y);
+        }
+        mBuffer->index.grow(mesh->index.count);
+        ARRAY_FOREACH(idx, mesh->index) mBuffer->index.push(base + *idx);
+
+        cmds += p->cmdCnt;
+        pts += p->ptsCnt;
+    }
+}
+
+
 RenderRegion BWTessellator::bounds() const
 {
     return {{int32_t(floor(bbox.min.x)), int32_t(floor(bbox.min.y))}, {int32_t(ceil(bbox.max.x)), int32_t(ceil(bbox.max.y))}};
 }
 
 
+//a single contour turning to one side and winding once, its fan triangles never overlap
+bool BWTessellator::convex() const
+{
+    if (mContours != 1) return false;
+
+    auto pts = reinterpret_cast<const Point*>(mBuffer->vertex.data);
+    auto cnt = mBuffer->vertex.count / 2;
+    if (cnt < 3) return false;
+
+    auto turn = 0.0f;
+    auto dx = 0.0f;
+    auto flips = 0;
+
+    for (uint32_t i = 0; i < cnt; ++i) {
+        auto d1 = pts[(i + 1) % cnt] - pts[i];
+        auto d2 = pts[(i + 2) % cnt] - pts[(i + 1) % cnt];
+        auto c = cross(d1, d2);
+        if (fabsf(c) > FLOAT_EPSILON) {
+            if (turn * c < 0.0f) return false;
+            turn = c;
+        }
+        //the x direction of a convex contour turns back twice at most
+        if (d1.x != 0.0f) {
+            if (dx * d1.x < 0.0f && ++flips > 2) return false;
+            dx = d1.x;
+        }
+    }
+    return true;
+}
+
+
 uint32_t BWTessellator::pushVertex(float x, float y)
 {
     auto index = _pushVertex(mBuffer->vertex, x, y);
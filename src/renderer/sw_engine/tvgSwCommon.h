@@ -34,6 +34,18 @@
 #define SW_ANGLE_PI (180L << 16)
 #define SW_ANGLE_2PI (SW_ANGLE_PI << 1)
 #define SW_ANGLE_PI2 (SW_ANGLE_PI >> 1)
+#define SW_PRIMITIVE_RADIUS 256    //the largest corner radius of the analytic primitives, the cubic approximations deviate beyond
+#define SW_TILE_W 16               //the coverage tile size in pixels, see SwTiles
+#define SW_TILE_H 4
+
+//the avx paths are built per function and selected at runtime, see rasterInit()
+#if defined(THORVG_AVX_VECTOR_SUPPORT) && (defined(__GNUC__) || defined(__clang__))
+    #define SW_AVX_TARGET __attribute__((target("avx")))
+#else
+    #define SW_AVX_TARGET
+#endif
+
+enum class SwSimd : uint8_t {None = 0, Avx, Neon, Wasm};
 
 
 static inline float TO_FLOAT(int32_t val)
@@ -163,6 +175,41 @@ struct SwRle
     SwSpan* data() const { return spans.data; }
 };
 
+//the coverages of a block at the multiples of its size, a row fits in a vector register
+struct alignas(16) SwTile
+{
+    uint8_t coverage[SW_TILE_H][SW_TILE_W];
+    int32_t x, y;
+};
+
+//the adjacent fully covered tiles of a tile row
+struct SwTileFill
+{
+    int32_t x, y;
+    int32_t len;
+};
+
+/* The alternative of the rle in the fixed size tiles. The coordinates are not limited to the span ones,
+   and the kernels work on the 16 pixels rows instead of the variable spans. */
+struct SwTiles
+{
+    Array<SwTile> tiles;            //partially covered, sorted by y, then x
+    Array<SwTileFill> fills;        //sorted by y, then x
+
+    //the tile rows overlapping the region
+    template<typename T>
+    static const T* fetch(const Array<T>& arr, const RenderRegion& bbox, const T** end)
+    {
+        auto begin = lower_bound(arr.begin(), arr.end(), bbox.min.y, [](const T& t, int32_t y) { return t.y + SW_TILE_H <= y; });
+        *end = upper_bound(begin, arr.end(), bbox.max.y, [](int32_t y, const T& t) { return y <= t.y; });
+        return begin;
+    }
+
+    bool invalid() const { return tiles.empty() && fills.empty(); }
+    bool valid() const { return !invalid(); }
+    uint32_t size() const { return tiles.count + fills.count; }
+};
+
 struct SwFill
 {
     struct SwLinear {
@@ -176,6 +223,7 @@ struct SwFill
         float fx, fy, fr;
         float dx, dy, dr;
         float invA, a;
+        bool concentric;   //no focal offset, see _fetchConcentric()
     };
 
     union {
@@ -183,7 +231,9 @@ struct SwFill
         SwRadial radial;
     };
 
-    uint32_t* ctable;
+    uint32_t* ctable;              //the color table of the shared one
+    uint32_t csize;                //the color table size, a power of two
+    struct SwColorTable* shared;   //shared among the fills of the same color stops, see fillGenColorTable()
     FillSpread spread;
 
     bool solid = false; //solid color fill with the last color from colorStops
@@ -212,7 +262,7 @@ struct SwStroke
     int64_t width;
     int64_t miterlimit;
     SwFill* fill = nullptr;
-    SwStrokeBorder borders[2];
+    SwStrokeBorder* borders;  //borrowed from the mpool while stroking
     float sx, sy;
     StrokeCap cap;
     StrokeJoin join;
@@ -230,11 +280,30 @@ struct SwDashStroke
     Point ptStart = {0, 0};
     Point ptCur = {0, 0};
     float* pattern = nullptr;
+    Array<Point> arcs;          //(t, length) at the ends of the flat pieces of the current curve
     uint32_t cnt = 0;
     bool curOpGap = false;
     bool move = true;
 };
 
+//axis-aligned (rounded) rectangle or ellipse in the device space
+struct SwPrimitive
+{
+    Point min, max;
+    Point radius;     //the corner radii, the half of the size for an ellipse
+};
+
+//the thin (<= 1px) stroke of the paths, its coverage is generated without the stroke outline
+struct SwHairline
+{
+    const RenderPath* path;
+    const Matrix* transform;
+    float hw;         //the half of the width in the device space
+    float miterlimit;
+    StrokeCap cap;
+    StrokeJoin join;
+};
+
 struct SwShape
 {
     SwOutline* outline = nullptr;
@@ -242,9 +311,12 @@ struct SwShape
     SwFill* fill = nullptr;
     SwRle* rle = nullptr;
     SwRle* strokeRle = nullptr;
+    SwTiles* tiles = nullptr;    //the fill coverage in the tiles instead of the rle, see SwCanvas::tiles()
     RenderRegion bbox;           //Keep it boundary without stroke region. Using for optimal filling.
 
+    SwPrimitive prim;
     bool fastTrack = false;   //Fast Track: axis-aligned rectangle without any clips?
+    bool primitive = false;   //the prim spans are generated without the outline
 };
 
 struct SwImage
@@ -266,9 +338,18 @@ struct SwImage
     bool         scaled = false;  //draw scaled image
 };
 
+//the successively halved copies of a downscaled image, built on demand
+struct SwMipmap
+{
+    Array<uint32_t*> levels;    //levels[0] is the half size of the image
+    uint32_t level = 0;         //the level to sample, 0 is the image itself
+};
+
 typedef uint8_t(*SwMask)(uint8_t s, uint8_t d, uint8_t a);                  //src, dst, alpha
 typedef uint32_t(*SwBlender)(uint32_t s, uint32_t d);                       //src, dst
 typedef uint32_t(*SwBlenderA)(uint32_t s, uint32_t d, uint8_t a);           //src, dst, alpha
+typedef void(*SwColorBlender)(uint32_t* dst, uint32_t color, uint32_t len, uint8_t a);       //span ver. of the blender with a solid color
+typedef void(*SwImageBlender)(uint32_t* dst, const uint32_t* src, uint32_t len, uint8_t a);  //span ver. of the blender with premultiplied pixels
 typedef uint32_t(*SwJoin)(uint8_t r, uint8_t g, uint8_t b, uint8_t a);      //color channel join
 typedef uint8_t(*SwAlpha)(uint8_t*);                                        //blending alpha
 
@@ -279,8 +360,12 @@ struct SwSurface : RenderSurface
     SwJoin  join;
     SwAlpha alphas[4];                    //Alpha:2, InvAlpha:3, Luma:4, InvLuma:5
     SwBlender blender = nullptr;          //blender (optional)
+    SwColorBlender colorBlender = nullptr;
+    SwImageBlender imageBlender = nullptr;
     SwCompositor* compositor = nullptr;   //compositor (optional)
     BlendMethod blendMethod = BlendMethod::Normal;
+    RenderRegion area;                    //backed region of the buffer, a compositor may cover a part of the target (w, h) only
+    RenderRegion dirty = {{0, 0}, {0, 0}};  //written region since the last clearing, the pooled compositors clear it on their reuse
 
     SwAlpha alpha(MaskMethod method)
     {
@@ -297,8 +382,11 @@ struct SwSurface : RenderSurface
         join = rhs->join;
         memcpy(alphas, rhs->alphas, sizeof(alphas));
         blender = rhs->blender;
+        colorBlender = rhs->colorBlender;
+        imageBlender = rhs->imageBlender;
         compositor = rhs->compositor;
         blendMethod = rhs->blendMethod;
+        area = rhs->area;
     }
 };
 
@@ -308,7 +396,32 @@ struct SwCompositor : RenderCompositor
     SwCompositor* recoverCmp;               //Recover compositor when composition is done
     SwImage image;
     RenderRegion bbox;
+    pixel_t* buffer = nullptr;              //pooled memory of the region sized compositor, null if the image owns the data
+    uint32_t capacity = 0;                  //pixels of the pooled memory
+    uint32_t epoch = 0;                     //render target generation of the retained layer
     bool valid;
+    bool retained = false;                  //retained layer, not in the compositors cache
+    bool partial = false;                   //recover the partial rendering condition
+    bool isolated = false;                  //drawn fully for the post effects, composited within the dirty regions
+    bool luma8 = false;                     //the luma mask is extracted into the 8-bit channels, see rasterLuma8()
+};
+
+struct SwCell
+{
+    int32_t x;
+    int32_t cover;
+    long area;
+    int32_t next;                   //the next cell index of the same scanline, -1 if none
+};
+
+//growable cell storage of the rle renderer
+struct SwCellPool
+{
+    Array<SwCell> cells;
+    Array<int32_t> yCells;          //the first and the last visited cell indices of each scanline, -1 if none
+    Array<uint8_t> strip;           //the coverage rows of a tile row, see tilesRender()
+    uint32_t renders;               //statistics: rendered outlines
+    uint32_t grows;                 //statistics: cell buffer reallocations
 };
 
 struct SwMpool
@@ -316,9 +429,13 @@ struct SwMpool
     SwOutline* outline;
     SwOutline* strokeOutline;
     SwOutline* dashOutline;
+    SwStrokeBorder* strokeBorders;  //2 borders per thread
+    SwCellPool* cellPools;
     unsigned allocSize;
 };
 
+struct SwGlyphAtlas;   //see tvgSwGlyph.cpp
+
 static inline int32_t TO_SWCOORD(float val)
 {
     return int32_t(val * 64.0f);
@@ -655,15 +772,17 @@ int64_t mathLength(const SwPoint& pt);
 int mathCubicAngle(const SwPoint* base, int64_t& angleIn, int64_t& angleMid, int64_t& angleOut);
 int64_t mathMean(int64_t angle1, int64_t angle2);
 SwPoint mathTransform(const Point* to, const Matrix& transform);
+void mathTransform(const Point* in, SwPoint* out, uint32_t cnt, const Matrix& transform);
 bool mathUpdateOutlineBBox(const SwOutline* outline, const RenderRegion& clipBox, RenderRegion& renderBox, bool fastTrack);
 
 void shapeReset(SwShape* shape);
-bool shapePrepare(SwShape* shape, const RenderShape* rshape, const Matrix& transform, const RenderRegion& clipBox, RenderRegion& renderBox, SwMpool* mpool, unsigned tid, bool hasComposite);
+void shapeGenOutline(SwOutline* outline, const PathCommand* cmds, uint32_t cmdCnt, const Point* pts, uint32_t ptsCnt, const Matrix& transform);
+bool shapePrepare(SwShape* shape, const RenderShape* rshape, const Matrix& transform, const RenderRegion& clipBox, RenderRegion& renderBox, float tolerance, SwMpool* mpool, unsigned tid, bool hasComposite);
 bool shapePrepared(const SwShape* shape);
-bool shapeGenRle(SwShape* shape, const RenderShape* rshape, bool antiAlias);
+bool shapeGenRle(SwShape* shape, const RenderShape* rshape, bool antiAlias, float tolerance, bool tiles, SwMpool* mpool, unsigned tid);
 void shapeDelOutline(SwShape* shape, SwMpool* mpool, uint32_t tid);
 void shapeResetStroke(SwShape* shape, const RenderShape* rshape, const Matrix& transform);
-bool shapeGenStrokeRle(SwShape* shape, const RenderShape* rshape, const Matrix& transform, const RenderRegion& clipBox, RenderRegion& renderBox, SwMpool* mpool, unsigned tid);
+bool shapeGenStrokeRle(SwShape* shape, const RenderShape* rshape, const Matrix& transform, const RenderRegion& clipBox, RenderRegion& renderBox, float tolerance, SwMpool* mpool, unsigned tid);
 void shapeFree(SwShape* shape);
 void shapeDelStroke(SwShape* shape);
 bool shapeGenFillColors(SwShape* shape, const Fill* fill, const Matrix& transform, SwSurface* surface, uint8_t opacity, bool ctable);
@@ -673,21 +792,32 @@ void shapeResetStrokeFill(SwShape* shape);
 void shapeDelFill(SwShape* shape);
 void shapeDelStrokeFill(SwShape* shape);
 
+SwGlyphAtlas* glyphAtlasInit();
+void glyphAtlasTerm(SwGlyphAtlas* atlas);
+void glyphAtlasClear(SwGlyphAtlas* atlas);
+bool glyphCacheable(const RenderShape* rshape, const Matrix& transform);
+bool glyphGenRle(SwGlyphAtlas* atlas, SwShape* shape, const RenderShape* rshape, const Matrix& transform, const RenderRegion& clipBox, RenderRegion& renderBox, SwMpool* mpool, unsigned tid);
+
 void strokeReset(SwStroke* stroke, const RenderShape* shape, const Matrix& transform);
 bool strokeParseOutline(SwStroke* stroke, const SwOutline& outline);
 SwOutline* strokeExportOutline(SwStroke* stroke, SwMpool* mpool, unsigned tid);
 void strokeFree(SwStroke* stroke);
 
 bool imagePrepare(SwImage* image, const Matrix& transform, const RenderRegion& clipBox, RenderRegion& renderBox, SwMpool* mpool, unsigned tid);
-bool imageGenRle(SwImage* image, const RenderRegion& bbox, bool antiAlias);
+bool imageGenRle(SwImage* image, const RenderRegion& bbox, bool antiAlias, SwMpool* mpool, unsigned tid);
 void imageDelOutline(SwImage* image, SwMpool* mpool, uint32_t tid);
 void imageReset(SwImage* image);
 void imageFree(SwImage* image);
+void imageGenMipmap(const SwImage* image, SwMipmap* mipmap);
+void imageSelectMipmap(const SwMipmap* mipmap, SwImage& image, Matrix& transform);
+void imageFreeMipmap(SwMipmap* mipmap);
 
+void fillInit(SwSimd simd);
 bool fillGenColorTable(SwFill* fill, const Fill* fdata, const Matrix& transform, SwSurface* surface, uint8_t opacity, bool ctable);
 const Fill::ColorStop* fillFetchSolid(const SwFill* fill, const Fill* fdata);
 void fillReset(SwFill* fill);
 void fillFree(SwFill* fill);
+void fillTerm();
 
 //OPTIMIZE_ME: Skip the function pointer access
 void fillLinear(const SwFill* fill, uint8_t* dst, uint32_t y, uint32_t x, uint32_t len, SwMask maskOp, uint8_t opacity);                                   //composite masking ver.
@@ -702,13 +832,23 @@ void fillRadial(const SwFill* fill, uint32_t* dst, uint32_t y, uint32_t x, uint3
 void fillRadial(const SwFill* fill, uint32_t* dst, uint32_t y, uint32_t x, uint32_t len, SwBlenderA op, SwBlender op2, uint8_t a);                         //blending + BlendingMethod(op2) ver.
 void fillRadial(const SwFill* fill, uint32_t* dst, uint32_t y, uint32_t x, uint32_t len, uint8_t* cmp, SwAlpha alpha, uint8_t csize, uint8_t opacity);     //matting ver.
 
-SwRle* rleRender(SwRle* rle, const SwOutline* outline, const RenderRegion& bbox, bool antiAlias);
+SwRle* rleRender(SwRle* rle, const SwOutline* outline, const RenderRegion& bbox, SwCellPool* pool, bool antiAlias, float tolerance);
 SwRle* rleRender(const RenderRegion* bbox);
+SwRle* rleRender(SwRle* rle, const SwPrimitive& prim, const RenderRegion& bbox, bool antiAlias);
+SwRle* rleRender(SwRle* rle, const SwHairline& line, const RenderRegion& bbox, SwCellPool* pool);
+SwRle* rleRender(SwRle* rle, const SwTiles* tiles);
 void rleFree(SwRle* rle);
 void rleReset(SwRle* rle);
+void rleTranslate(SwRle* rle, int32_t x, int32_t y);
 void rleMerge(SwRle* rle, SwRle* clip1, SwRle* clip2);
 bool rleClip(SwRle* rle, const SwRle* clip);
 bool rleClip(SwRle* rle, const RenderRegion* clip);
+bool rleIntersects(const SwRle* rle, const RenderRegion& region);
+
+SwTiles* tilesRender(SwTiles* tiles, const SwOutline* outline, const RenderRegion& bbox, SwCellPool* pool, bool antiAlias, float tolerance);
+void tilesFree(SwTiles* tiles);
+void tilesReset(SwTiles* tiles);
+bool tilesIntersects(const SwTiles* tiles, const RenderRegion& region);
 
 SwMpool* mpoolInit(uint32_t threads);
 bool mpoolTerm(SwMpool* mpool);
@@ -719,13 +859,19 @@ SwOutline* mpoolReqStrokeOutline(SwMpool* mpool, unsigned idx);
 void mpoolRetStrokeOutline(SwMpool* mpool, unsigned idx);
 SwOutline* mpoolReqDashOutline(SwMpool* mpool, unsigned idx);
 void mpoolRetDashOutline(SwMpool* mpool, unsigned idx);
+SwStrokeBorder* mpoolReqStrokeBorders(SwMpool* mpool, unsigned idx);
+void mpoolRetStrokeBorders(SwMpool* mpool, unsigned idx);
+SwCellPool* mpoolReqCellPool(SwMpool* mpool, unsigned idx);
 
+void rasterInit();
+void rasterBlender(SwSurface* surface, BlendMethod method);
 bool rasterCompositor(SwSurface* surface);
 bool rasterShape(SwSurface* surface, SwShape* shape, const RenderRegion& bbox, RenderColor& c);
 bool rasterTexmapPolygon(SwSurface* surface, const SwImage& image, const Matrix& transform, const RenderRegion& bbox, uint8_t opacity);
 bool rasterScaledImage(SwSurface* surface, const SwImage& image, const Matrix& transform, const RenderRegion& bbox, uint8_t opacity);
 bool rasterDirectImage(SwSurface* surface, const SwImage& image, const RenderRegion& bbox, uint8_t opacity);
 bool rasterScaledRleImage(SwSurface* surface, const SwImage& image, const Matrix& transform, const RenderRegion& bbox, uint8_t opacity);
+bool rasterTransformedRleImage(SwSurface* surface, const SwImage& image, const Matrix& transform, const RenderRegion& bbox, uint8_t opacity);
 bool rasterDirectRleImage(SwSurface* surface, const SwImage& image, const RenderRegion& bbox, uint8_t opacity);
 bool rasterStroke(SwSurface* surface, SwShape* shape, const RenderRegion& bbox, RenderColor& c);
 bool rasterGradientShape(SwSurface* surface, SwShape* shape, const RenderRegion& bbox, const Fill* fdata, uint8_t opacity);
@@ -736,9 +882,12 @@ void rasterTranslucentPixel32(uint32_t* dst, uint32_t* src, uint32_t len, uint8_
 void rasterPixel32(uint32_t* dst, uint32_t* src, uint32_t len, uint8_t opacity);
 void rasterGrayscale8(uint8_t *dst, uint8_t val, uint32_t offset, int32_t len);
 void rasterXYFlip(uint32_t* src, uint32_t* dst, int32_t stride, int32_t w, int32_t h, const RenderRegion& bbox, bool flipped);
-void rasterUnpremultiply(RenderSurface* surface);
+void rasterXYFlip(uint8_t* src, uint8_t* dst, int32_t stride, int32_t w, int32_t h, const RenderRegion& bbox, bool flipped);
+bool rasterLuma8(SwSurface* surface);
+void rasterUnpremultiply(SwSurface* surface);
 void rasterPremultiply(RenderSurface* surface);
 bool rasterConvertCS(RenderSurface* surface, ColorSpace to);
+void rasterPack565(SwSurface* surface, uint16_t* dst, uint32_t stride, const RenderRegion& region, bool dither);
 uint32_t rasterUnpremultiply(uint32_t data);
 
 bool effectGaussianBlur(SwCompositor* cmp, SwSurface* surface, const RenderEffectGaussianBlur* params);
@@ -753,5 +902,6 @@ void effectTintUpdate(RenderEffectTint* effect);
 bool effectTint(SwCompositor* cmp, const RenderEffectTint* params, bool direct);
 void effectTritoneUpdate(RenderEffectTritone* effect);
 bool effectTritone(SwCompositor* cmp, const RenderEffectTritone* params, bool direct);
+bool effectColors(SwCompositor* cmp, const RenderEffect* const* effects, uint32_t cnt);
 
 #endif /* _TVG_SW_COMMON_H_ */
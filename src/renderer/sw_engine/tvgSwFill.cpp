@@ -22,15 +22,53 @@
 
 #include "tvgSwCommon.h"
 #include "tvgFill.h"
+#include "tvgInlist.h"
+#include "tvgLock.h"
 
 /************************************************************************/
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
 #define RADIAL_A_THRESHOLD 0.0005f
-#define GRADIENT_STOP_SIZE 1024
+#define GRADIENT_STOP_SIZE 1024     //the default color table size, the anti-aliasing margins are tuned on
+#define GRADIENT_STOP_MIN 256
+#define GRADIENT_STOP_MAX 4096
 #define FIXPT_BITS 8
 #define FIXPT_SIZE (1<<FIXPT_BITS)
+#define FETCH_CHUNK_SIZE 64u
+#define COLOR_TABLE_BUCKETS 64
+#define COLOR_TABLE_SPARES 16    //the released tables kept for the reuse, e.g. the looping opacity animations
+
+//the color table generated once for the fills of the same color stops, opacity and target color space
+struct SwColorTable
+{
+    INLIST_ITEM(SwColorTable);
+
+    uint32_t* ctable;
+    Fill::ColorStop* stops;
+    uint32_t cnt;
+    uint32_t size;        //the table resolution, a power of two, see _tableSize()
+    uint32_t hash;
+    uint32_t margin;      //the anti-aliasing margin of the repeat spread
+    uint32_t refCnt;
+    SwJoin join;
+    FillSpread spread;
+    uint8_t opacity;
+    bool translucent;
+    bool spare;           //queued in the spares, see _releaseColorTable()
+
+    bool match(const Fill::ColorStop* stops, uint32_t cnt, uint32_t size, FillSpread spread, uint8_t opacity, uint32_t margin, SwJoin join) const
+    {
+        return this->cnt == cnt && this->size == size && this->spread == spread && this->opacity == opacity && this->margin == margin && this->join == join &&
+               !memcmp(this->stops, stops, cnt * sizeof(Fill::ColorStop));
+    }
+};
+
+static Inlist<SwColorTable> _tables[COLOR_TABLE_BUCKETS];
+static SwColorTable* _spares[COLOR_TABLE_SPARES];   //ring of the released tables in the released order
+static uint32_t _sparesHead = 0;
+static uint32_t _sparesCnt = 0;
+static Key _tableKey;
 
 /*
  * quadratic equation with the following coefficients (rx and ry defined in the _calculateCoefficients()):
@@ -79,10 +117,10 @@ static uint32_t _estimateAAMargin(const Fill* fdata)
 }
 
 
-static void _adjustAAMargin(uint32_t& iMargin, uint32_t index)
+static void _adjustAAMargin(uint32_t& iMargin, uint32_t index, uint32_t size)
 {
     constexpr float threshold = 0.1f;
-    constexpr uint32_t iMarginMax = 40;
+    auto iMarginMax = 40 * size / GRADIENT_STOP_SIZE;
 
     auto iThreshold = static_cast<uint32_t>(index * threshold);
     if (iMargin > iThreshold) iMargin = iThreshold;
@@ -103,61 +141,54 @@ static inline uint32_t _alphaUnblend(uint32_t c)
 }
 
 
-static void _applyAA(const SwFill* fill, uint32_t begin, uint32_t end)
+static void _applyAA(uint32_t* ctable, uint32_t size, uint32_t begin, uint32_t end)
 {
     if (begin == 0 || end == 0) return;
 
-    auto i = GRADIENT_STOP_SIZE - end;
-    auto rgbaEnd = _alphaUnblend(fill->ctable[i]);
-    auto rgbaBegin = _alphaUnblend(fill->ctable[begin]);
+    auto i = size - end;
+    auto rgbaEnd = _alphaUnblend(ctable[i]);
+    auto rgbaBegin = _alphaUnblend(ctable[begin]);
 
     auto dt = 1.0f / (begin + end + 1.0f);
     float t = dt;
     while (i != begin) {
         auto dist = 255 - static_cast<int32_t>(255 * t);
         auto color = INTERPOLATE(rgbaEnd, rgbaBegin, dist);
-        fill->ctable[i++] = ALPHA_BLEND((color | 0xff000000), (color >> 24));
+        ctable[i++] = ALPHA_BLEND((color | 0xff000000), (color >> 24));
 
-        if (i == GRADIENT_STOP_SIZE) i = 0;
+        if (i == size) i = 0;
         t += dt;
     }
 }
 
 
-static bool _updateColorTable(SwFill* fill, const Fill* fdata, const SwSurface* surface, uint8_t opacity)
+static void _genColorTable(SwColorTable* table, const Fill::ColorStop* colors, uint32_t cnt, const SwSurface* surface)
 {
-    if (fill->solid) return true;
-
-    if (!fill->ctable) {
-        fill->ctable = tvg::malloc<uint32_t*>(GRADIENT_STOP_SIZE * sizeof(uint32_t));
-    }
-
-    const Fill::ColorStop* colors;
-    auto cnt = fdata->colorStops(&colors);
-    if (cnt == 0 || !colors) return false;
-
+    auto ctable = table->ctable;
+    auto size = table->size;
+    auto opacity = table->opacity;
     auto pColors = colors;
 
     auto a = MULTIPLY(pColors->a, opacity);
-    if (a < 255) fill->translucent = true;
+    if (a < 255) table->translucent = true;
 
     auto r = pColors->r;
     auto g = pColors->g;
     auto b = pColors->b;
     auto rgba = surface->join(r, g, b, a);
-    auto inc = 1.0f / static_cast<float>(GRADIENT_STOP_SIZE);
+    auto inc = 1.0f / static_cast<float>(size);
     auto pos = 1.5f * inc;
     uint32_t i = 0;
 
     //If repeat is true, anti-aliasing must be applied between the last and the first colors.
-    auto repeat = fill->spread == FillSpread::Repeat;
-    uint32_t iAABegin = repeat ? _estimateAAMargin(fdata) : 0;
+    auto repeat = table->spread == FillSpread::Repeat;
+    uint32_t iAABegin = table->margin;
     uint32_t iAAEnd = 0;
 
-    fill->ctable[i++] = ALPHA_BLEND(rgba | 0xff000000, a);
+    ctable[i++] = ALPHA_BLEND(rgba | 0xff000000, a);
 
     while (pos <= pColors->offset) {
-        fill->ctable[i] = fill->ctable[i - 1];
+        ctable[i] = ctable[i - 1];
         ++i;
         pos += inc;
     }
@@ -165,7 +196,7 @@ static bool _updateColorTable(SwFill* fill, const Fill* fdata, const SwSurface*
     for (uint32_t j = 0; j < cnt - 1; ++j) {
         if (repeat && j == cnt - 2 && iAAEnd == 0) {
             iAAEnd = iAABegin;
-            _adjustAAMargin(iAAEnd, GRADIENT_STOP_SIZE - i);
+            _adjustAAMargin(iAAEnd, size - i, size);
         }
 
         auto curr = colors + j;
@@ -173,34 +204,150 @@ static bool _updateColorTable(SwFill* fill, const Fill* fdata, const SwSurface*
         auto delta = 1.0f / (next->offset - curr->offset);
         auto a2 = MULTIPLY(next->a, opacity);
 
-        if (!fill->translucent && a2 < 255) fill->translucent = true;
+        if (!table->translucent && a2 < 255) table->translucent = true;
 
         auto rgba2 = surface->join(next->r, next->g, next->b, a2);
 
-        while (pos < next->offset && i < GRADIENT_STOP_SIZE) {
+        while (pos < next->offset && i < size) {
             auto t = (pos - curr->offset) * delta;
             auto dist = static_cast<int32_t>(255 * t);
             auto dist2 = 255 - dist;
             auto color = INTERPOLATE(rgba, rgba2, dist2);
-            fill->ctable[i] = ALPHA_BLEND((color | 0xff000000), (color >> 24));
+            ctable[i] = ALPHA_BLEND((color | 0xff000000), (color >> 24));
             ++i;
             pos += inc;
         }
         rgba = rgba2;
         a = a2;
 
-        if (repeat && j == 0) _adjustAAMargin(iAABegin, i - 1);
+        if (repeat && j == 0) _adjustAAMargin(iAABegin, i - 1, size);
     }
     rgba = ALPHA_BLEND((rgba | 0xff000000), a);
 
-    for (; i < GRADIENT_STOP_SIZE; ++i) {
-        fill->ctable[i] = rgba;
+    for (; i < size; ++i) {
+        ctable[i] = rgba;
     }
 
     //For repeat fill spread apply anti-aliasing between the last and first colors,
     //othewise make sure the last color stop is represented at the end of the table.
-    if (repeat) _applyAA(fill, iAABegin, iAAEnd);
-    else fill->ctable[GRADIENT_STOP_SIZE - 1] = rgba;
+    if (repeat) _applyAA(ctable, size, iAABegin, iAAEnd);
+    else ctable[size - 1] = rgba;
+}
+
+
+static uint32_t _hash(const Fill::ColorStop* stops, uint32_t cnt, uint32_t size, FillSpread spread, uint8_t opacity, uint32_t margin)
+{
+    //FNV-1a over the color stops and the other conditions
+    uint32_t hash = 2166136261u;
+    auto p = reinterpret_cast<const uint8_t*>(stops);
+    for (uint32_t i = 0; i < cnt * sizeof(Fill::ColorStop); ++i) hash = (hash ^ p[i]) * 16777619u;
+    hash = (hash ^ size) * 16777619u;
+    hash = (hash ^ (uint32_t)spread) * 16777619u;
+    hash = (hash ^ opacity) * 16777619u;
+    return (hash ^ margin) * 16777619u;
+}
+
+
+static SwColorTable* _findColorTable(uint32_t hash, const Fill::ColorStop* stops, uint32_t cnt, uint32_t size, FillSpread spread, uint8_t opacity, uint32_t margin, SwJoin join)
+{
+    INLIST_FOREACH(_tables[hash % COLOR_TABLE_BUCKETS], p) {
+        if (p->hash == hash && p->match(stops, cnt, size, spread, opacity, margin, join)) {
+            ++p->refCnt;
+            return p;
+        }
+    }
+    return nullptr;
+}
+
+
+static void _freeColorTable(SwColorTable* table)
+{
+    tvg::free(table->stops);
+    tvg::free(table->ctable);
+    delete(table);
+}
+
+
+//the caller must hold the lock
+static void _evictColorTable()
+{
+    auto table = _spares[_sparesHead];
+    _sparesHead = (_sparesHead + 1) % COLOR_TABLE_SPARES;
+    --_sparesCnt;
+    table->spare = false;
+
+    //it's been taken again meanwhile, it's queued again with the next release
+    if (table->refCnt > 0) return;
+
+    _tables[table->hash % COLOR_TABLE_BUCKETS].remove(table);
+    _freeColorTable(table);
+}
+
+
+//the caller must hold the lock, the unused table is kept in the cache until it's evicted by the later ones
+static void _releaseColorTable(SwColorTable* table)
+{
+    if (!table || --table->refCnt > 0 || table->spare) return;
+
+    if (_sparesCnt == COLOR_TABLE_SPARES) _evictColorTable();
+    _spares[(_sparesHead + _sparesCnt) % COLOR_TABLE_SPARES] = table;
+    ++_sparesCnt;
+    table->spare = true;
+}
+
+
+static bool _updateColorTable(SwFill* fill, const Fill* fdata, const SwSurface* surface, uint8_t opacity, uint32_t size)
+{
+    if (fill->solid) return true;
+
+    const Fill::ColorStop* colors;
+    auto cnt = fdata->colorStops(&colors);
+    if (cnt == 0 || !colors) return false;
+
+    auto margin = (fill->spread == FillSpread::Repeat) ? _estimateAAMargin(fdata) * size / GRADIENT_STOP_SIZE : 0;
+    auto hash = _hash(colors, cnt, size, fill->spread, opacity, margin);
+
+    SwColorTable* table;
+    {
+        ScopedLock lock(_tableKey);
+        table = _findColorTable(hash, colors, cnt, size, fill->spread, opacity, margin, surface->join);
+    }
+
+    //generate it out of the lock, the other threads might do the same meanwhile
+    if (!table) {
+        auto gen = new SwColorTable;
+        gen->stops = tvg::malloc<Fill::ColorStop*>(cnt * sizeof(Fill::ColorStop));
+        memcpy(gen->stops, colors, cnt * sizeof(Fill::ColorStop));
+        gen->ctable = tvg::malloc<uint32_t*>(size * sizeof(uint32_t));
+        gen->cnt = cnt;
+        gen->size = size;
+        gen->hash = hash;
+        gen->margin = margin;
+        gen->refCnt = 1;
+        gen->join = surface->join;
+        gen->spread = fill->spread;
+        gen->opacity = opacity;
+        gen->translucent = false;
+        gen->spare = false;
+        _genColorTable(gen, colors, cnt, surface);
+
+        ScopedLock lock(_tableKey);
+        if ((table = _findColorTable(hash, colors, cnt, size, fill->spread, opacity, margin, surface->join))) _freeColorTable(gen);
+        else {
+            _tables[hash % COLOR_TABLE_BUCKETS].back(gen);
+            table = gen;
+        }
+    }
+
+    if (fill->shared) {
+        ScopedLock lock(_tableKey);
+        _releaseColorTable(fill->shared);
+    }
+
+    fill->shared = table;
+    fill->ctable = table->ctable;
+    fill->csize = table->size;
+    fill->translucent = table->translucent;
 
     return true;
 }
@@ -257,6 +404,8 @@ bool _prepareRadial(SwFill* fill, const RadialGradient* radial, const Matrix& pT
     constexpr float precision = 0.01f;
     if (fill->radial.a < precision) fill->radial.a = precision;
     fill->radial.invA = 1.0f / fill->radial.a;
+    //the focal point at the center, the position grows with the distance only regardless of the (elliptical) transform
+    fill->radial.concentric = tvg::zero(fill->radial.dx) && tvg::zero(fill->radial.dy);
 
     const auto& transform = pTransform * radial->transform();
 
@@ -274,24 +423,47 @@ bool _prepareRadial(SwFill* fill, const RadialGradient* radial, const Matrix& pT
 }
 
 
+//the table resolution by the projected gradient length, the small ones don't need the full table and the large ones band with it
+static uint32_t _tableSize(const SwFill* fill, const Fill* fdata)
+{
+    //pixels per the gradient length
+    auto len = 0.0f;
+    if (fdata->type() == Type::LinearGradient) {
+        auto inc = sqrtf(fill->linear.dx * fill->linear.dx + fill->linear.dy * fill->linear.dy);
+        if (inc > FLOAT_EPSILON) len = 1.0f / inc;
+    } else {
+        auto sx = sqrtf(fill->radial.a11 * fill->radial.a11 + fill->radial.a21 * fill->radial.a21);
+        auto sy = sqrtf(fill->radial.a12 * fill->radial.a12 + fill->radial.a22 * fill->radial.a22);
+        auto inc = std::min(sx, sy);
+        if (inc > FLOAT_EPSILON) len = fill->radial.dr / inc;
+    }
+
+    //four entries per pixel at least for the small ones, the hard stops stay on the same pixels
+    if (len * 4.0f <= GRADIENT_STOP_MIN) return GRADIENT_STOP_MIN;
+    if (len <= GRADIENT_STOP_SIZE) return GRADIENT_STOP_SIZE;
+    return GRADIENT_STOP_MAX;
+}
+
+
 static inline uint32_t _clamp(const SwFill* fill, int32_t pos)
 {
+    int32_t size = fill->csize;
     switch (fill->spread) {
         case FillSpread::Pad: {
-            if (pos >= GRADIENT_STOP_SIZE) pos = GRADIENT_STOP_SIZE - 1;
+            if (pos >= size) pos = size - 1;
             else if (pos < 0) pos = 0;
             break;
         }
         case FillSpread::Repeat: {
-            pos = pos % GRADIENT_STOP_SIZE;
-            if (pos < 0) pos = GRADIENT_STOP_SIZE + pos;
+            pos = pos % size;
+            if (pos < 0) pos = size + pos;
             break;
         }
         case FillSpread::Reflect: {
-            auto limit = GRADIENT_STOP_SIZE * 2;
+            auto limit = size * 2;
             pos = pos % limit;
             if (pos < 0) pos = limit + pos;
-            if (pos >= GRADIENT_STOP_SIZE) pos = (limit - pos - 1);
+            if (pos >= size) pos = (limit - pos - 1);
             break;
         }
     }
@@ -308,11 +480,117 @@ static inline uint32_t _fixedPixel(const SwFill* fill, int32_t pos)
 
 static inline uint32_t _pixel(const SwFill* fill, float pos)
 {
-    auto i = static_cast<int32_t>(pos * (GRADIENT_STOP_SIZE - 1) + 0.5f);
+    auto i = static_cast<int32_t>(pos * (fill->csize - 1) + 0.5f);
     return fill->ctable[_clamp(fill, i)];
 }
 
 
+#include "tvgSwFillAvx.h"
+#include "tvgSwFillNeon.h"
+
+
+//the vectorized color fetchers available on this cpu, see fillInit()
+static struct {
+    uint32_t (*linear)(const SwFill* fill, uint32_t* dst, int32_t& t, int32_t inc, uint32_t len);
+    uint32_t (*radial)(const SwFill* fill, uint32_t* dst, float& b, float deltaB, float& det, float& deltaDet, float deltaDeltaDet, uint32_t len);
+} _simd = {nullptr, nullptr};
+
+
+static void _fetchLinear(const SwFill* fill, uint32_t* dst, int32_t& t, int32_t inc, uint32_t len)
+{
+    uint32_t i = 0;
+    if (_simd.linear) i = _simd.linear(fill, dst, t, inc, len);
+    for (; i < len; ++i, t += inc) dst[i] = _fixedPixel(fill, t);
+}
+
+
+//b is constant (deltaB = 0) and det is convex along the span, the pixels out of (1 + b)^2 are padded without the sqrt
+static void _fetchConcentric(const SwFill* fill, uint32_t* dst, float b, float& det, float& deltaDet, float deltaDeltaDet, uint32_t len)
+{
+    auto pad = (fill->spread == FillSpread::Pad);
+    auto limit = (1.0f + b) * (1.0f + b);
+    auto last = fill->ctable[fill->csize - 1];
+    auto cnt = len;
+    uint32_t i = 0;
+
+    if (pad) {
+        //the leading outer pixels
+        for (; i < len && det >= limit; ++i) {
+            dst[i] = last;
+            det += deltaDet;
+            deltaDet += deltaDeltaDet;
+        }
+        //the inner pixels, det(n) = det + n * deltaDet + n * (n - 1) / 2 * deltaDeltaDet reaches the limit. a bit early for the accumulated errors
+        if (deltaDeltaDet > 0.0f) {
+            auto qa = 0.5f * deltaDeltaDet;
+            auto qb = deltaDet - qa;
+            auto n = (-qb + sqrtf(qb * qb - 4.0f * qa * (det - limit))) / (2.0f * qa) - 2.0f;
+            if (n < float(len - i)) cnt = i + (n > 0.0f ? uint32_t(n) : 0);
+        }
+    }
+
+    if (_simd.radial) i += _simd.radial(fill, dst + i, b, 0.0f, det, deltaDet, deltaDeltaDet, cnt - i);
+
+    for (; i < len; ++i) {
+        if (pad && det >= limit && deltaDet >= 0.0f) {
+            rasterPixel32(dst, last, i, len - i);
+            return;
+        }
+        dst[i] = _pixel(fill, sqrtf(det) - b);
+        det += deltaDet;
+        deltaDet += deltaDeltaDet;
+    }
+}
+
+
+static void _fetchRadial(const SwFill* fill, uint32_t* dst, float& b, float deltaB, float& det, float& deltaDet, float deltaDeltaDet, uint32_t len)
+{
+    if (fill->radial.concentric) {
+        _fetchConcentric(fill, dst, b, det, deltaDet, deltaDeltaDet, len);
+        return;
+    }
+
+    uint32_t i = 0;
+    if (_simd.radial) i = _simd.radial(fill, dst, b, deltaB, det, deltaDet, deltaDeltaDet, len);
+    for (; i < len; ++i) {
+        dst[i] = _pixel(fill, sqrtf(det) - b);
+        det += deltaDet;
+        deltaDet += deltaDeltaDet;
+        b += deltaB;
+    }
+}
+
+
+//the gradient colors of a span are fetched chunk by chunk, then passed to the blender
+template<typename Blender>
+static void _linearSpan(const SwFill* fill, int32_t t, int32_t inc, uint32_t len, Blender blend)
+{
+    uint32_t buf[FETCH_CHUNK_SIZE];
+    while (len > 0) {
+        auto cnt = std::min(len, FETCH_CHUNK_SIZE);
+        _fetchLinear(fill, buf, t, inc, cnt);
+        blend(buf, cnt);
+        len -= cnt;
+    }
+}
+
+
+template<typename Blender>
+static void _radialSpan(const SwFill* fill, uint32_t x, uint32_t y, uint32_t len, Blender blend)
+{
+    float b, deltaB, det, deltaDet, deltaDeltaDet;
+    _calculateCoefficients(fill, x, y, b, deltaB, det, deltaDet, deltaDeltaDet);
+
+    uint32_t buf[FETCH_CHUNK_SIZE];
+    while (len > 0) {
+        auto cnt = std::min(len, FETCH_CHUNK_SIZE);
+        _fetchRadial(fill, buf, b, deltaB, det, deltaDet, deltaDeltaDet, cnt);
+        blend(buf, cnt);
+        len -= cnt;
+    }
+}
+
+
 /************************************************************************/
 /* External Class Implementation                                        */
 /************************************************************************/
@@ -342,23 +620,18 @@ void fillRadial(const SwFill* fill, uint32_t* dst, uint32_t y, uint32_t x, uint3
             }
         }
     } else {
-        float b, deltaB, det, deltaDet, deltaDeltaDet;
-        _calculateCoefficients(fill, x, y, b, deltaB, det, deltaDet, deltaDeltaDet);
-
         if (opacity == 255) {
-            for (uint32_t i = 0 ; i < len ; ++i, ++dst, cmp += csize) {
-                *dst = opBlendNormal(_pixel(fill, sqrtf(det) - b), *dst, alpha(cmp));
-                det += deltaDet;
-                deltaDet += deltaDeltaDet;
-                b += deltaB;
-            }
+            _radialSpan(fill, x, y, len, [&](const uint32_t* src, uint32_t cnt) {
+                for (uint32_t i = 0; i < cnt; ++i, ++dst, cmp += csize) {
+                    *dst = opBlendNormal(src[i], *dst, alpha(cmp));
+                }
+            });
         } else {
-            for (uint32_t i = 0 ; i < len ; ++i, ++dst, cmp += csize) {
-                *dst = opBlendNormal(_pixel(fill, sqrtf(det) - b), *dst, MULTIPLY(opacity, alpha(cmp)));
-                det += deltaDet;
-                deltaDet += deltaDeltaDet;
-                b += deltaB;
-            }
+            _radialSpan(fill, x, y, len, [&](const uint32_t* src, uint32_t cnt) {
+                for (uint32_t i = 0; i < cnt; ++i, ++dst, cmp += csize) {
+                    *dst = opBlendNormal(src[i], *dst, MULTIPLY(opacity, alpha(cmp)));
+                }
+            });
         }
     }
 }
@@ -377,15 +650,11 @@ void fillRadial(const SwFill* fill, uint32_t* dst, uint32_t y, uint32_t x, uint3
             ry += radial->a21;
         }
     } else {
-        float b, deltaB, det, deltaDet, deltaDeltaDet;
-        _calculateCoefficients(fill, x, y, b, deltaB, det, deltaDet, deltaDeltaDet);
-
-        for (uint32_t i = 0; i < len; ++i, ++dst) {
-            *dst = op(_pixel(fill, sqrtf(det) - b), *dst, a);
-            det += deltaDet;
-            deltaDet += deltaDeltaDet;
-            b += deltaB;
-        }
+        _radialSpan(fill, x, y, len, [&](const uint32_t* src, uint32_t cnt) {
+            for (uint32_t i = 0; i < cnt; ++i, ++dst) {
+                *dst = op(src[i], *dst, a);
+            }
+        });
     }
 }
 
@@ -404,16 +673,12 @@ void fillRadial(const SwFill* fill, uint8_t* dst, uint32_t y, uint32_t x, uint32
             ry += radial->a21;
         }
     } else {
-        float b, deltaB, det, deltaDet, deltaDeltaDet;
-        _calculateCoefficients(fill, x, y, b, deltaB, det, deltaDet, deltaDeltaDet);
-
-        for (uint32_t i = 0 ; i < len ; ++i, ++dst) {
-            auto src = MULTIPLY(a, A(_pixel(fill, sqrtf(det) - b)));
-            *dst = maskOp(src, *dst, ~src);
-            det += deltaDet;
-            deltaDet += deltaDeltaDet;
-            b += deltaB;
-        }
+        _radialSpan(fill, x, y, len, [&](const uint32_t* colors, uint32_t cnt) {
+            for (uint32_t i = 0; i < cnt; ++i, ++dst) {
+                auto src = MULTIPLY(a, A(colors[i]));
+                *dst = maskOp(src, *dst, ~src);
+            }
+        });
     }
 }
 
@@ -433,17 +698,13 @@ void fillRadial(const SwFill* fill, uint8_t* dst, uint32_t y, uint32_t x, uint32
             ry += radial->a21;
         }
     } else {
-        float b, deltaB, det, deltaDet, deltaDeltaDet;
-        _calculateCoefficients(fill, x, y, b, deltaB, det, deltaDet, deltaDeltaDet);
-
-        for (uint32_t i = 0 ; i < len ; ++i, ++dst, ++cmp) {
-            auto src = MULTIPLY(A(_pixel(fill, sqrtf(det))), a);
-            auto tmp = maskOp(src, *cmp, 0);
-            *dst = tmp + MULTIPLY(*dst, ~tmp);
-            det += deltaDet;
-            deltaDet += deltaDeltaDet;
-            b += deltaB;
-        }
+        _radialSpan(fill, x, y, len, [&](const uint32_t* colors, uint32_t cnt) {
+            for (uint32_t i = 0; i < cnt; ++i, ++dst, ++cmp) {
+                auto src = MULTIPLY(A(colors[i]), a);
+                auto tmp = maskOp(src, *cmp, 0);
+                *dst = tmp + MULTIPLY(*dst, ~tmp);
+            }
+        });
     }
 }
 
@@ -474,25 +735,21 @@ void fillRadial(const SwFill* fill, uint32_t* dst, uint32_t y, uint32_t x, uint3
             }
         }
     } else {
-        float b, deltaB, det, deltaDet, deltaDeltaDet;
-        _calculateCoefficients(fill, x, y, b, deltaB, det, deltaDet, deltaDeltaDet);
         if (a == 255) {
-            for (uint32_t i = 0 ; i < len ; ++i, ++dst) {
-                auto tmp = op(_pixel(fill, sqrtf(det) - b), *dst, 255);
-                *dst = op2(tmp, *dst);
-                det += deltaDet;
-                deltaDet += deltaDeltaDet;
-                b += deltaB;
-            }
+            _radialSpan(fill, x, y, len, [&](const uint32_t* src, uint32_t cnt) {
+                for (uint32_t i = 0; i < cnt; ++i, ++dst) {
+                    auto tmp = op(src[i], *dst, 255);
+                    *dst = op2(tmp, *dst);
+                }
+            });
         } else {
-            for (uint32_t i = 0 ; i < len ; ++i, ++dst) {
-                auto tmp = op(_pixel(fill, sqrtf(det) - b), *dst, 255);
-                auto tmp2 = op2(tmp, *dst);
-                *dst = INTERPOLATE(tmp2, *dst, a);
-                det += deltaDet;
-                deltaDet += deltaDeltaDet;
-                b += deltaB;
-            }
+            _radialSpan(fill, x, y, len, [&](const uint32_t* src, uint32_t cnt) {
+                for (uint32_t i = 0; i < cnt; ++i, ++dst) {
+                    auto tmp = op(src[i], *dst, 255);
+                    auto tmp2 = op2(tmp, *dst);
+                    *dst = INTERPOLATE(tmp2, *dst, a);
+                }
+            });
         }
     }
 }
@@ -503,8 +760,8 @@ void fillLinear(const SwFill* fill, uint32_t* dst, uint32_t y, uint32_t x, uint3
     //Rotation
     float rx = x + 0.5f;
     float ry = y + 0.5f;
-    float t = (fill->linear.dx * rx + fill->linear.dy * ry + fill->linear.offset) * (GRADIENT_STOP_SIZE - 1);
-    float inc = (fill->linear.dx) * (GRADIENT_STOP_SIZE - 1);
+    float t = (fill->linear.dx * rx + fill->linear.dy * ry + fill->linear.offset) * (fill->csize - 1);
+    float inc = (fill->linear.dx) * (fill->csize - 1);
 
     if (opacity == 255) {
         if (tvg::zero(inc)) {
@@ -523,15 +780,16 @@ void fillLinear(const SwFill* fill, uint32_t* dst, uint32_t y, uint32_t x, uint3
         if (v < vMax && v > vMin) {
             auto t2 = static_cast<int32_t>(t * FIXPT_SIZE);
             auto inc2 = static_cast<int32_t>(inc * FIXPT_SIZE);
-            for (uint32_t j = 0; j < len; ++j, ++dst, cmp += csize) {
-                *dst = opBlendNormal(_fixedPixel(fill, t2), *dst, alpha(cmp));
-                t2 += inc2;
-            }
+            _linearSpan(fill, t2, inc2, len, [&](const uint32_t* src, uint32_t cnt) {
+                for (uint32_t j = 0; j < cnt; ++j, ++dst, cmp += csize) {
+                    *dst = opBlendNormal(src[j], *dst, alpha(cmp));
+                }
+            });
         //we have to fallback to float math
         } else {
             uint32_t counter = 0;
             while (counter++ < len) {
-                *dst = opBlendNormal(_pixel(fill, t / GRADIENT_STOP_SIZE), *dst, alpha(cmp));
+                *dst = opBlendNormal(_pixel(fill, t / fill->csize), *dst, alpha(cmp));
                 ++dst;
                 t += inc;
                 cmp += csize;
@@ -554,15 +812,16 @@ void fillLinear(const SwFill* fill, uint32_t* dst, uint32_t y, uint32_t x, uint3
         if (v < vMax && v > vMin) {
             auto t2 = static_cast<int32_t>(t * FIXPT_SIZE);
             auto inc2 = static_cast<int32_t>(inc * FIXPT_SIZE);
-            for (uint32_t j = 0; j < len; ++j, ++dst, cmp += csize) {
-                *dst = opBlendNormal(_fixedPixel(fill, t2), *dst, MULTIPLY(alpha(cmp), opacity));
-                t2 += inc2;
-            }
+            _linearSpan(fill, t2, inc2, len, [&](const uint32_t* src, uint32_t cnt) {
+                for (uint32_t j = 0; j < cnt; ++j, ++dst, cmp += csize) {
+                    *dst = opBlendNormal(src[j], *dst, MULTIPLY(alpha(cmp), opacity));
+                }
+            });
         //we have to fallback to float math
         } else {
             uint32_t counter = 0;
             while (counter++ < len) {
-                *dst = opBlendNormal(_pixel(fill, t / GRADIENT_STOP_SIZE), *dst, MULTIPLY(opacity, alpha(cmp)));
+                *dst = opBlendNormal(_pixel(fill, t / fill->csize), *dst, MULTIPLY(opacity, alpha(cmp)));
                 ++dst;
                 t += inc;
                 cmp += csize;
@@ -577,8 +836,8 @@ void fillLinear(const SwFill* fill, uint8_t* dst, uint32_t y, uint32_t x, uint32
     //Rotation
     float rx = x + 0.5f;
     float ry = y + 0.5f;
-    float t = (fill->linear.dx * rx + fill->linear.dy * ry + fill->linear.offset) * (GRADIENT_STOP_SIZE - 1);
-    float inc = (fill->linear.dx) * (GRADIENT_STOP_SIZE - 1);
+    float t = (fill->linear.dx * rx + fill->linear.dy * ry + fill->linear.offset) * (fill->csize - 1);
+    float inc = (fill->linear.dx) * (fill->csize - 1);
 
     if (tvg::zero(inc)) {
         auto src = MULTIPLY(a, A(_fixedPixel(fill, static_cast<int32_t>(t * FIXPT_SIZE))));
@@ -596,16 +855,17 @@ void fillLinear(const SwFill* fill, uint8_t* dst, uint32_t y, uint32_t x, uint32
     if (v < vMax && v > vMin) {
         auto t2 = static_cast<int32_t>(t * FIXPT_SIZE);
         auto inc2 = static_cast<int32_t>(inc * FIXPT_SIZE);
-        for (uint32_t j = 0; j < len; ++j, ++dst) {
-            auto src = MULTIPLY(A(_fixedPixel(fill, t2)), a);
-            *dst = maskOp(src, *dst, ~src);
-            t2 += inc2;
-        }
+        _linearSpan(fill, t2, inc2, len, [&](const uint32_t* colors, uint32_t cnt) {
+            for (uint32_t j = 0; j < cnt; ++j, ++dst) {
+                auto src = MULTIPLY(A(colors[j]), a);
+                *dst = maskOp(src, *dst, ~src);
+            }
+        });
     //we have to fallback to float math
     } else {
         uint32_t counter = 0;
         while (counter++ < len) {
-            auto src = MULTIPLY(A(_pixel(fill, t / GRADIENT_STOP_SIZE)), a);
+            auto src = MULTIPLY(A(_pixel(fill, t / fill->csize)), a);
             *dst = maskOp(src, *dst, ~src);
             ++dst;
             t += inc;
@@ -619,8 +879,8 @@ void fillLinear(const SwFill* fill, uint8_t* dst, uint32_t y, uint32_t x, uint32
     //Rotation
     float rx = x + 0.5f;
     float ry = y + 0.5f;
-    float t = (fill->linear.dx * rx + fill->linear.dy * ry + fill->linear.offset) * (GRADIENT_STOP_SIZE - 1);
-    float inc = (fill->linear.dx) * (GRADIENT_STOP_SIZE - 1);
+    float t = (fill->linear.dx * rx + fill->linear.dy * ry + fill->linear.offset) * (fill->csize - 1);
+    float inc = (fill->linear.dx) * (fill->csize - 1);
 
     if (tvg::zero(inc)) {
         auto src = A(_fixedPixel(fill, static_cast<int32_t>(t * FIXPT_SIZE)));
@@ -640,17 +900,18 @@ void fillLinear(const SwFill* fill, uint8_t* dst, uint32_t y, uint32_t x, uint32
     if (v < vMax && v > vMin) {
         auto t2 = static_cast<int32_t>(t * FIXPT_SIZE);
         auto inc2 = static_cast<int32_t>(inc * FIXPT_SIZE);
-        for (uint32_t j = 0; j < len; ++j, ++dst, ++cmp) {
-            auto src = MULTIPLY(a, A(_fixedPixel(fill, t2)));
-            auto tmp = maskOp(src, *cmp, 0);
-            *dst = tmp + MULTIPLY(*dst, ~tmp);
-            t2 += inc2;
-        }
+        _linearSpan(fill, t2, inc2, len, [&](const uint32_t* colors, uint32_t cnt) {
+            for (uint32_t j = 0; j < cnt; ++j, ++dst, ++cmp) {
+                auto src = MULTIPLY(a, A(colors[j]));
+                auto tmp = maskOp(src, *cmp, 0);
+                *dst = tmp + MULTIPLY(*dst, ~tmp);
+            }
+        });
     //we have to fallback to float math
     } else {
         uint32_t counter = 0;
         while (counter++ < len) {
-            auto src = MULTIPLY(A(_pixel(fill, t / GRADIENT_STOP_SIZE)), a);
+            auto src = MULTIPLY(A(_pixel(fill, t / fill->csize)), a);
             auto tmp = maskOp(src, *cmp, 0);
             *dst = tmp + MULTIPLY(*dst, ~tmp);
             ++dst;
@@ -666,8 +927,8 @@ void fillLinear(const SwFill* fill, uint32_t* dst, uint32_t y, uint32_t x, uint3
     //Rotation
     float rx = x + 0.5f;
     float ry = y + 0.5f;
-    float t = (fill->linear.dx * rx + fill->linear.dy * ry + fill->linear.offset) * (GRADIENT_STOP_SIZE - 1);
-    float inc = (fill->linear.dx) * (GRADIENT_STOP_SIZE - 1);
+    float t = (fill->linear.dx * rx + fill->linear.dy * ry + fill->linear.offset) * (fill->csize - 1);
+    float inc = (fill->linear.dx) * (fill->csize - 1);
 
     if (tvg::zero(inc)) {
         auto color = _fixedPixel(fill, static_cast<int32_t>(t * FIXPT_SIZE));
@@ -685,15 +946,16 @@ void fillLinear(const SwFill* fill, uint32_t* dst, uint32_t y, uint32_t x, uint3
     if (v < vMax && v > vMin) {
         auto t2 = static_cast<int32_t>(t * FIXPT_SIZE);
         auto inc2 = static_cast<int32_t>(inc * FIXPT_SIZE);
-        for (uint32_t j = 0; j < len; ++j, ++dst) {
-            *dst = op(_fixedPixel(fill, t2), *dst, a);
-            t2 += inc2;
-        }
+        _linearSpan(fill, t2, inc2, len, [&](const uint32_t* src, uint32_t cnt) {
+            for (uint32_t j = 0; j < cnt; ++j, ++dst) {
+                *dst = op(src[j], *dst, a);
+            }
+        });
     //we have to fallback to float math
     } else {
         uint32_t counter = 0;
         while (counter++ < len) {
-            *dst = op(_pixel(fill, t / GRADIENT_STOP_SIZE), *dst, a);
+            *dst = op(_pixel(fill, t / fill->csize), *dst, a);
             ++dst;
             t += inc;
         }
@@ -706,8 +968,8 @@ void fillLinear(const SwFill* fill, uint32_t* dst, uint32_t y, uint32_t x, uint3
     //Rotation
     float rx = x + 0.5f;
     float ry = y + 0.5f;
-    float t = (fill->linear.dx * rx + fill->linear.dy * ry + fill->linear.offset) * (GRADIENT_STOP_SIZE - 1);
-    float inc = (fill->linear.dx) * (GRADIENT_STOP_SIZE - 1);
+    float t = (fill->linear.dx * rx + fill->linear.dy * ry + fill->linear.offset) * (fill->csize - 1);
+    float inc = (fill->linear.dx) * (fill->csize - 1);
 
     if (tvg::zero(inc)) {
         auto color = _fixedPixel(fill, static_cast<int32_t>(t * FIXPT_SIZE));
@@ -735,16 +997,17 @@ void fillLinear(const SwFill* fill, uint32_t* dst, uint32_t y, uint32_t x, uint3
         if (v < vMax && v > vMin) {
             auto t2 = static_cast<int32_t>(t * FIXPT_SIZE);
             auto inc2 = static_cast<int32_t>(inc * FIXPT_SIZE);
-            for (uint32_t j = 0; j < len; ++j, ++dst) {
-                auto tmp = op(_fixedPixel(fill, t2), *dst, 255);
-                *dst = op2(tmp, *dst);
-                t2 += inc2;
-            }
+            _linearSpan(fill, t2, inc2, len, [&](const uint32_t* src, uint32_t cnt) {
+                for (uint32_t j = 0; j < cnt; ++j, ++dst) {
+                    auto tmp = op(src[j], *dst, 255);
+                    *dst = op2(tmp, *dst);
+                }
+            });
         //we have to fallback to float math
         } else {
             uint32_t counter = 0;
             while (counter++ < len) {
-                auto tmp = op(_pixel(fill, t / GRADIENT_STOP_SIZE), *dst, 255);
+                auto tmp = op(_pixel(fill, t / fill->csize), *dst, 255);
                 *dst = op2(tmp, *dst);
                 ++dst;
                 t += inc;
@@ -755,17 +1018,18 @@ void fillLinear(const SwFill* fill, uint32_t* dst, uint32_t y, uint32_t x, uint3
         if (v < vMax && v > vMin) {
             auto t2 = static_cast<int32_t>(t * FIXPT_SIZE);
             auto inc2 = static_cast<int32_t>(inc * FIXPT_SIZE);
-            for (uint32_t j = 0; j < len; ++j, ++dst) {
-                auto tmp = op(_fixedPixel(fill, t2), *dst, 255);
-                auto tmp2 = op2(tmp, *dst);
-                *dst = INTERPOLATE(tmp2, *dst, a);
-                t2 += inc2;
-            }
+            _linearSpan(fill, t2, inc2, len, [&](const uint32_t* src, uint32_t cnt) {
+                for (uint32_t j = 0; j < cnt; ++j, ++dst) {
+                    auto tmp = op(src[j], *dst, 255);
+                    auto tmp2 = op2(tmp, *dst);
+                    *dst = INTERPOLATE(tmp2, *dst, a);
+                }
+            });
         //we have to fallback to float math
         } else {
             uint32_t counter = 0;
             while (counter++ < len) {
-                auto tmp = op(_pixel(fill, t / GRADIENT_STOP_SIZE), *dst, 255);
+                auto tmp = op(_pixel(fill, t / fill->csize), *dst, 255);
                 auto tmp2 = op2(tmp, *dst);
                 *dst = INTERPOLATE(tmp2, *dst, a);
                 ++dst;
@@ -776,6 +1040,22 @@ void fillLinear(const SwFill* fill, uint32_t* dst, uint32_t y, uint32_t x, uint3
 }
 
 
+void fillInit(TVG_UNUSED SwSimd simd)
+{
+#if defined(THORVG_AVX_VECTOR_SUPPORT)
+    if (simd == SwSimd::Avx) {
+        _simd.linear = avxFetchLinear;
+        _simd.radial = avxFetchRadial;
+    }
+#elif defined(THORVG_NEON_VECTOR_SUPPORT)
+    if (simd == SwSimd::Neon) {
+        _simd.linear = neonFetchLinear;
+        _simd.radial = neonFetchRadial;
+    }
+#endif
+}
+
+
 bool fillGenColorTable(SwFill* fill, const Fill* fdata, const Matrix& transform, SwSurface* surface, uint8_t opacity, bool ctable)
 {
     if (!fill) return false;
@@ -788,7 +1068,11 @@ bool fillGenColorTable(SwFill* fill, const Fill* fdata, const Matrix& transform,
         if (!_prepareRadial(fill, static_cast<const RadialGradient*>(fdata), transform)) return false;
     }
 
-    if (ctable) return _updateColorTable(fill, fdata, surface, opacity);
+    if (fill->solid) return true;
+
+    //the opacity or the scale may change alone, take the table of the new condition then
+    auto size = _tableSize(fill, fdata);
+    if (ctable || (fill->shared && (fill->shared->opacity != opacity || fill->shared->size != size))) return _updateColorTable(fill, fdata, surface, opacity, size);
     return true;
 }
 
@@ -807,10 +1091,7 @@ const Fill::ColorStop* fillFetchSolid(const SwFill* fill, const Fill* fdata)
 
 void fillReset(SwFill* fill)
 {
-    if (fill->ctable) {
-        tvg::free(fill->ctable);
-        fill->ctable = nullptr;
-    }
+    //keep the color table, it's released when the next update takes over another one
     fill->translucent = false;
     fill->solid = false;
 }
@@ -820,7 +1101,17 @@ void fillFree(SwFill* fill)
 {
     if (!fill) return;
 
-    if (fill->ctable) tvg::free(fill->ctable);
+    if (fill->shared) {
+        ScopedLock lock(_tableKey);
+        _releaseColorTable(fill->shared);
+    }
 
     tvg::free(fill);
 }
+
+
+void fillTerm()
+{
+    ScopedLock lock(_tableKey);
+    while (_sparesCnt > 0) _evictColorTable();
+}
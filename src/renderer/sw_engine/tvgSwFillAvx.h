@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef THORVG_AVX_VECTOR_SUPPORT
+
+#include <immintrin.h>
+
+#define N_32BITS_IN_256REG 8
+
+SW_AVX_TARGET static inline __m128i _avxClamp(const SwFill* fill, __m128i pos)
+{
+    switch (fill->spread) {
+        case FillSpread::Pad: {
+            pos = _mm_max_epi32(pos, _mm_setzero_si128());
+            return _mm_min_epi32(pos, _mm_set1_epi32(fill->csize - 1));
+        }
+        //the table size is a power of two, masking matches the modulo with the negative correction
+        case FillSpread::Repeat: {
+            return _mm_and_si128(pos, _mm_set1_epi32(fill->csize - 1));
+        }
+        case FillSpread::Reflect: {
+            auto limit = _mm_set1_epi32(fill->csize * 2 - 1);
+            pos = _mm_and_si128(pos, limit);
+            auto over = _mm_cmpgt_epi32(pos, _mm_set1_epi32(fill->csize - 1));
+            return _mm_blendv_epi8(pos, _mm_sub_epi32(limit, pos), over);
+        }
+    }
+    return pos;
+}
+
+
+SW_AVX_TARGET static inline void _avxLookup(const SwFill* fill, uint32_t* dst, __m128i idx)
+{
+    dst[0] = fill->ctable[_mm_cvtsi128_si32(idx)];
+    dst[1] = fill->ctable[_mm_extract_epi32(idx, 1)];
+    dst[2] = fill->ctable[_mm_extract_epi32(idx, 2)];
+    dst[3] = fill->ctable[_mm_extract_epi32(idx, 3)];
+}
+
+
+//fetch the fixed point linear positions t, t + inc, ... , 8 pixels per iteration. returns the fetched count.
+SW_AVX_TARGET static uint32_t avxFetchLinear(const SwFill* fill, uint32_t* dst, int32_t& t, int32_t inc, uint32_t len)
+{
+    auto iterations = len / N_32BITS_IN_256REG;
+    if (iterations == 0) return 0;
+
+    auto vInc = _mm_set1_epi32(inc);
+    auto lo = _mm_add_epi32(_mm_set1_epi32(t), _mm_mullo_epi32(vInc, _mm_setr_epi32(0, 1, 2, 3)));
+    auto hi = _mm_add_epi32(lo, _mm_slli_epi32(vInc, 2));
+    auto step = _mm_slli_epi32(vInc, 3);
+    auto half = _mm_set1_epi32(FIXPT_SIZE / 2);
+
+    for (uint32_t i = 0; i < iterations; ++i, dst += N_32BITS_IN_256REG) {
+        _avxLookup(fill, dst, _avxClamp(fill, _mm_srai_epi32(_mm_add_epi32(lo, half), FIXPT_BITS)));
+        _avxLookup(fill, dst + 4, _avxClamp(fill, _mm_srai_epi32(_mm_add_epi32(hi, half), FIXPT_BITS)));
+        lo = _mm_add_epi32(lo, step);
+        hi = _mm_add_epi32(hi, step);
+    }
+    t = _mm_cvtsi128_si32(lo);
+
+    return iterations * N_32BITS_IN_256REG;
+}
+
+
+//fetch the radial positions sqrt(det) - b, 8 pixels per iteration. returns the fetched count.
+SW_AVX_TARGET static uint32_t avxFetchRadial(const SwFill* fill, uint32_t* dst, float& b, float deltaB, float& det, float& deltaDet, float deltaDeltaDet, uint32_t len)
+{
+    auto iterations = len / N_32BITS_IN_256REG;
+    if (iterations == 0) return 0;
+
+    float dets[N_32BITS_IN_256REG], bs[N_32BITS_IN_256REG];
+    auto scale = _mm256_set1_ps(fill->csize - 1);
+    auto half = _mm256_set1_ps(0.5f);
+
+    for (uint32_t i = 0; i < iterations; ++i, dst += N_32BITS_IN_256REG) {
+        //keep the forward differencing sequential, the same as the scalar path
+        for (int k = 0; k < N_32BITS_IN_256REG; ++k) {
+            dets[k] = det;
+            bs[k] = b;
+            det += deltaDet;
+            deltaDet += deltaDeltaDet;
+            b += deltaB;
+        }
+        auto pos = _mm256_sub_ps(_mm256_sqrt_ps(_mm256_loadu_ps(dets)), _mm256_loadu_ps(bs));
+        auto idx = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(pos, scale), half));
+        _avxLookup(fill, dst, _avxClamp(fill, _mm256_castsi256_si128(idx)));
+        _avxLookup(fill, dst + 4, _avxClamp(fill, _mm256_extractf128_si256(idx, 1)));
+    }
+
+    return iterations * N_32BITS_IN_256REG;
+}
+
+#endif
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef THORVG_NEON_VECTOR_SUPPORT
+
+#include <arm_neon.h>
+
+#ifndef TVG_AARCH64
+    #if defined(__ARM_64BIT_STATE) || defined(_M_ARM64)
+        #define TVG_AARCH64 1
+    #else
+        #define TVG_AARCH64 0
+    #endif
+#endif
+
+static inline int32x4_t _neonClamp(const SwFill* fill, int32x4_t pos)
+{
+    switch (fill->spread) {
+        case FillSpread::Pad: {
+            pos = vmaxq_s32(pos, vdupq_n_s32(0));
+            return vminq_s32(pos, vdupq_n_s32(fill->csize - 1));
+        }
+        //the table size is a power of two, masking matches the modulo with the negative correction
+        case FillSpread::Repeat: {
+            return vandq_s32(pos, vdupq_n_s32(fill->csize - 1));
+        }
+        case FillSpread::Reflect: {
+            auto limit = vdupq_n_s32(fill->csize * 2 - 1);
+            pos = vandq_s32(pos, limit);
+            auto over = vcgtq_s32(pos, vdupq_n_s32(fill->csize - 1));
+            return vbslq_s32(over, vsubq_s32(limit, pos), pos);
+        }
+    }
+    return pos;
+}
+
+
+static inline void _neonLookup(const SwFill* fill, uint32_t* dst, int32x4_t idx)
+{
+    dst[0] = fill->ctable[vgetq_lane_s32(idx, 0)];
+    dst[1] = fill->ctable[vgetq_lane_s32(idx, 1)];
+    dst[2] = fill->ctable[vgetq_lane_s32(idx, 2)];
+    dst[3] = fill->ctable[vgetq_lane_s32(idx, 3)];
+}
+
+
+//fetch the fixed point linear positions t, t + inc, ... , 4 pixels per iteration. returns the fetched count.
+static uint32_t neonFetchLinear(const SwFill* fill, uint32_t* dst, int32_t& t, int32_t inc, uint32_t len)
+{
+    auto iterations = len / 4;
+    if (iterations == 0) return 0;
+
+    const int32_t lanes[4] = {0, 1, 2, 3};
+    auto pos = vmlaq_s32(vdupq_n_s32(t), vld1q_s32(lanes), vdupq_n_s32(inc));
+    auto step = vdupq_n_s32(inc * 4);
+    auto half = vdupq_n_s32(FIXPT_SIZE / 2);
+
+    for (uint32_t i = 0; i < iterations; ++i, dst += 4) {
+        _neonLookup(fill, dst, _neonClamp(fill, vshrq_n_s32(vaddq_s32(pos, half), FIXPT_BITS)));
+        pos = vaddq_s32(pos, step);
+    }
+    t = vgetq_lane_s32(pos, 0);
+
+    return iterations * 4;
+}
+
+
+//fetch the radial positions sqrt(det) - b, 4 pixels per iteration. returns the fetched count.
+static uint32_t neonFetchRadial(const SwFill* fill, uint32_t* dst, float& b, float deltaB, float& det, float& deltaDet, float deltaDeltaDet, uint32_t len)
+{
+#if TVG_AARCH64
+    auto iterations = len / 4;
+    if (iterations == 0) return 0;
+
+    float dets[4], bs[4];
+    auto scale = vdupq_n_f32(fill->csize - 1);
+    auto half = vdupq_n_f32(0.5f);
+
+    for (uint32_t i = 0; i < iterations; ++i, dst += 4) {
+        //keep the forward differencing sequential, the same as the scalar path
+        for (int k = 0; k < 4; ++k) {
+            dets[k] = det;
+            bs[k] = b;
+            det += deltaDet;
+            deltaDet += deltaDeltaDet;
+            b += deltaB;
+        }
+        auto pos = vsubq_f32(vsqrtq_f32(vld1q_f32(dets)), vld1q_f32(bs));
+        auto idx = vcvtq_s32_f32(vaddq_f32(vmulq_f32(pos, scale), half));
+        _neonLookup(fill, dst, _neonClamp(fill, idx));
+    }
+
+    return iterations * 4;
+#else
+    //no vector square root on armv7
+    return 0;
+#endif
+}
+
+#endif
@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <limits.h>
+#include "tvgSwCommon.h"
+#include "tvgLock.h"
+
+/************************************************************************/
+/* Internal Class Implementation                                        */
+/************************************************************************/
+
+static constexpr float GLYPH_MAX_EM = 64.0f;              //the largest glyphs to keep in pixels per em
+static constexpr uint32_t GLYPH_ATLAS_BUDGET = 262144;   //the spans kept in total, the atlas is flushed beyond
+
+
+//the coverage of a glyph outline at a quarter pixel phase of the pen position
+struct SwGlyph
+{
+    SwRle* rle;                 //the spans from the top-left pixel of the glyph
+    int32_t x, y;               //the top-left pixel from the pen pixel
+    int32_t w, h;
+    float m[4];                 //the linear part of the transform
+    uint32_t id;                //see RenderGlyphRun
+    uint32_t phase;             //the pen offset in quarter pixels, (y << 2) | x
+};
+
+
+//the glyph coverages shared by the renderers, open addressing
+struct SwGlyphAtlas
+{
+    SwGlyph** slots = nullptr;
+    uint32_t capacity = 0;      //power of 2
+    uint32_t count = 0;
+    uint32_t spans = 0;         //the spans of the glyphs in total
+    Key key;
+};
+
+
+static uint32_t _hash(uint32_t id, uint32_t phase, const float* m)
+{
+    uint32_t bits[4];
+    memcpy(bits, m, sizeof(bits));
+
+    auto h = (id * 0x9e3779b1u) ^ phase;
+    for (int i = 0; i < 4; ++i) h = (h ^ bits[i]) * 0x85ebca6bu;
+    return h ^ (h >> 15);
+}
+
+
+static SwGlyph* _find(const SwGlyphAtlas* atlas, uint32_t id, uint32_t phase, const float* m, uint32_t hash)
+{
+    if (atlas->count == 0) return nullptr;
+    for (auto i = hash & (atlas->capacity - 1); atlas->slots[i]; i = (i + 1) & (atlas->capacity - 1)) {
+        auto glyph = atlas->slots[i];
+        if (glyph->id == id && glyph->phase == phase && !memcmp(glyph->m, m, sizeof(glyph->m))) return glyph;
+    }
+    return nullptr;
+}
+
+
+static void _flush(SwGlyphAtlas* atlas)
+{
+    for (uint32_t i = 0; i < atlas->capacity; ++i) {
+        if (auto glyph = atlas->slots[i]) {
+            rleFree(glyph->rle);
+            delete(glyph);
+            atlas->slots[i] = nullptr;
+        }
+    }
+    atlas->count = atlas->spans = 0;
+}
+
+
+static void _insert(SwGlyphAtlas* atlas, SwGlyph* glyph, uint32_t hash)
+{
+    auto spans = glyph->rle ? glyph->rle->spans.count : 0;
+    if (atlas->spans + spans > GLYPH_ATLAS_BUDGET) _flush(atlas);
+
+    if ((atlas->count + 1) * 2 > atlas->capacity) {
+        auto old = atlas->slots;
+        auto oldCapacity = atlas->capacity;
+
+        atlas->capacity = atlas->capacity ? atlas->capacity * 2 : 256;
+        atlas->slots = tvg::calloc<SwGlyph**>(atlas->capacity, sizeof(SwGlyph*));
+
+        for (uint32_t i = 0; i < oldCapacity; ++i) {
+            if (!old[i]) continue;
+            auto j = _hash(old[i]->id, old[i]->phase, old[i]->m) & (atlas->capacity - 1);
+            while (atlas->slots[j]) j = (j + 1) & (atlas->capacity - 1);
+            atlas->slots[j] = old[i];
+        }
+        tvg::free(old);
+    }
+
+    auto i = hash & (atlas->capacity - 1);
+    while (atlas->slots[i]) i = (i + 1) & (atlas->capacity - 1);
+    atlas->slots[i] = glyph;
+    ++atlas->count;
+    atlas->spans += spans;
+}
+
+
+static SwGlyph* _gen(const RenderGlyphRun::Glyph* g, const PathCommand* cmds, const Point* pts, uint32_t id, uint32_t phase, const float* m, SwMpool* mpool, unsigned tid)
+{
+    //the glyph outline moved from its place in the text to the pen phase
+    auto& o = g->offset;
+    Matrix transform = {m[0], m[1], (phase & 3) * 0.25f - m[0] * o.x - m[1] * o.y, m[2], m[3], (phase >> 2) * 0.25f - m[2] * o.x - m[3] * o.y, 0.0f, 0.0f, 1.0f};
+
+    auto outline = mpoolReqOutline(mpool, tid);
+    shapeGenOutline(outline, cmds, g->cmdCnt, pts, g->ptsCnt, transform);
+    outline->fillRule = FillRule::NonZero;
+
+    auto glyph = new SwGlyph;
+    glyph->rle = nullptr;
+    glyph->x = glyph->y = glyph->w = glyph->h = 0;
+    memcpy(glyph->m, m, sizeof(glyph->m));
+    glyph->id = id;
+    glyph->phase = phase;
+
+    RenderRegion box;
+    static constexpr RenderRegion limit = {{-SHRT_MAX, -SHRT_MAX}, {SHRT_MAX, SHRT_MAX}};
+
+    if (mathUpdateOutlineBBox(outline, limit, box, false)) {
+        //the spans are unsigned, render it from the origin
+        ARRAY_FOREACH(p, outline->pts) {
+            p->x -= box.min.x * 64;
+            p->y -= box.min.y * 64;
+        }
+        glyph->x = box.min.x;
+        glyph->y = box.min.y;
+        glyph->w = box.w();
+        glyph->h = box.h();
+        glyph->rle = rleRender(nullptr, outline, {{0, 0}, {glyph->w, glyph->h}}, mpoolReqCellPool(mpool, tid), true, FLATNESS_TOLERANCE);
+    }
+
+    mpoolRetOutline(mpool, tid);
+
+    return glyph;
+}
+
+
+static void _place(const SwGlyph* glyph, int32_t px, int32_t py, const RenderRegion& clipBox, Array<SwSpan>& out, RenderRegion& bbox)
+{
+    auto x = px + glyph->x;
+    auto y = py + glyph->y;
+    RenderRegion box = {{x, y}, {x + glyph->w, y + glyph->h}};
+
+    if (box.max.x <= clipBox.min.x || box.max.y <= clipBox.min.y || box.min.x >= clipBox.max.x || box.min.y >= clipBox.max.y) return;
+
+    auto cnt = out.count + glyph->rle->spans.count;
+    if (cnt > out.reserved) out.reserve(std::max(cnt, out.reserved * 2u));
+    auto dst = out.end();
+
+    //fast track: not clipped
+    if (box.min.x >= clipBox.min.x && box.min.y >= clipBox.min.y && box.max.x <= clipBox.max.x && box.max.y <= clipBox.max.y) {
+        ARRAY_FOREACH(p, glyph->rle->spans) {
+            *dst++ = {uint16_t(p->x + x), uint16_t(p->y + y), p->len, p->coverage};
+        }
+    } else {
+        ARRAY_FOREACH(p, glyph->rle->spans) {
+            auto sy = p->y + y;
+            if (sy < clipBox.min.y || sy >= clipBox.max.y) continue;
+            auto sx = std::max(p->x + x, clipBox.min.x);
+            auto len = std::min(p->x + x + p->len, clipBox.max.x) - sx;
+            if (len <= 0) continue;
+            *dst++ = {uint16_t(sx), uint16_t(sy), uint16_t(len), p->coverage};
+        }
+        box.intersect(clipBox);
+    }
+
+    out.count = dst - out.data;
+    bbox.add(box);
+}
+
+
+//the spans of a row in order, the overlapped coverages among the glyphs are accumulated
+static void _merge(const SwSpan* begin, const SwSpan* end, int32_t offset, uint16_t* acc, Array<SwSpan>& out)
+{
+    auto disjoint = true;
+    auto minx = begin->x;
+    auto maxx = begin->x + begin->len;
+
+    for (auto p = begin + 1; p < end; ++p) {
+        if (p->x < maxx) disjoint = false;
+        if (p->x < minx) minx = p->x;
+        maxx = std::max(maxx, p->x + p->len);
+    }
+
+    if (disjoint) {
+        out.grow(end - begin);
+        memcpy(out.end(), begin, sizeof(SwSpan) * (end - begin));
+        out.count += end - begin;
+        return;
+    }
+
+    acc -= offset;
+    memset(acc + minx, 0, sizeof(uint16_t) * (maxx - minx));
+    for (auto p = begin; p < end; ++p) {
+        for (auto x = p->x; x < p->x + p->len; ++x) acc[x] += p->coverage;
+    }
+
+    auto y = begin->y;
+    for (auto x = int32_t(minx); x < maxx; ) {
+        auto coverage = std::min(acc[x], uint16_t(255));
+        if (coverage == 0) {
+            ++x;
+            continue;
+        }
+        auto start = x;
+        while (++x < maxx && std::min(acc[x], uint16_t(255)) == coverage);
+        out.push({uint16_t(start), y, uint16_t(x - start), uint8_t(coverage)});
+    }
+}
+
+
+/************************************************************************/
+/* External Class Implementation                                        */
+/************************************************************************/
+
+SwGlyphAtlas* glyphAtlasInit()
+{
+    return new SwGlyphAtlas;
+}
+
+
+void glyphAtlasTerm(SwGlyphAtlas* atlas)
+{
+    if (!atlas) return;
+    _flush(atlas);
+    tvg::free(atlas->slots);
+    delete(atlas);
+}
+
+
+void glyphAtlasClear(SwGlyphAtlas* atlas)
+{
+    if (!atlas) return;
+    ScopedLock lock(atlas->key);
+    _flush(atlas);
+    tvg::free(atlas->slots);
+    atlas->slots = nullptr;
+    atlas->capacity = 0;
+}
+
+
+bool glyphCacheable(const RenderShape* rshape, const Matrix& transform)
+{
+    auto run = rshape->glyphs;
+    if (!run || rshape->rule != FillRule::NonZero || rshape->trimpath()) return false;
+    if (!tvg::zero(transform.e31) || !tvg::zero(transform.e32) || !tvg::equal(transform.e33, 1.0f)) return false;
+
+    //the large glyphs are not worth keeping
+    auto scale = sqrtf(fabsf(transform.e11 * transform.e22 - transform.e12 * transform.e21));
+    if (tvg::zero(scale) || run->em * scale > GLYPH_MAX_EM) return false;
+
+    return run->valid(rshape->path);
+}
+
+
+bool glyphGenRle(SwGlyphAtlas* atlas, SwShape* shape, const RenderShape* rshape, const Matrix& transform, const RenderRegion& clipBox, RenderRegion& renderBox, SwMpool* mpool, unsigned tid)
+{
+    float m[4] = {transform.e11, transform.e12, transform.e21, transform.e22};
+    auto cmds = rshape->path.cmds.data;
+    auto pts = rshape->path.pts.data;
+
+    Array<SwSpan> spans;
+    RenderRegion bbox = {{INT32_MAX, INT32_MAX}, {INT32_MIN, INT32_MIN}};
+
+    ARRAY_FOREACH(g, rshape->glyphs->glyphs) {
+        //the pen position rounded to the quarter pixels
+        auto px = int32_t(floorf((g->offset.x * transform.e11 + g->offset.y * transform.e12 + transform.e13) * 4.0f + 0.5f));
+        auto py = int32_t(floorf((g->offset.x * transform.e21 + g->offset.y * transform.e22 + transform.e23) * 4.0f + 0.5f));
+        auto phase = uint32_t(((py & 3) << 2) | (px & 3));
+        auto hash = _hash(g->id, phase, m);
+
+        {
+            ScopedLock lock(atlas->key);
+            auto glyph = _find(atlas, g->id, phase, m, hash);
+            if (!glyph) {
+                glyph = _gen(g, cmds, pts, g->id, phase, m, mpool, tid);
+                _insert(atlas, glyph, hash);
+            }
+            if (glyph->rle && glyph->rle->valid()) _place(glyph, px >> 2, py >> 2, clipBox, spans, bbox);
+        }
+
+        cmds += g->cmdCnt;
+        pts += g->ptsCnt;
+    }
+
+    if (spans.empty()) {
+        renderBox.reset();
+        return false;
+    }
+
+    //sort the spans by rows, each glyph spans are already in order
+    auto h = bbox.sh();
+    auto rows = tvg::calloc<uint32_t*>(h + 1, sizeof(uint32_t));
+    ARRAY_FOREACH(p, spans) ++rows[p->y - bbox.min.y + 1];
+    for (int32_t i = 0; i < h; ++i) rows[i + 1] += rows[i];
+
+    auto sorted = tvg::malloc<SwSpan*>(sizeof(SwSpan) * spans.count);
+    ARRAY_FOREACH(p, spans) sorted[rows[p->y - bbox.min.y]++] = *p;
+
+    if (!shape->rle) shape->rle = new SwRle;
+    shape->rle->spans.clear();
+    shape->rle->spans.reserve(spans.count);
+
+    uint16_t* acc = nullptr;
+    auto begin = sorted;
+    auto end = sorted + spans.count;
+    while (begin < end) {
+        auto row = begin + 1;
+        while (row < end && row->y == begin->y) ++row;
+        if (row - begin == 1) {
+            shape->rle->spans.push(*begin);
+        } else {
+            if (!acc) acc = tvg::malloc<uint16_t*>(sizeof(uint16_t) * bbox.w());
+            _merge(begin, row, bbox.min.x, acc, shape->rle->spans);
+        }
+        begin = row;
+    }
+
+    tvg::free(acc);
+    tvg::free(sorted);
+    tvg::free(rows);
+
+    renderBox = bbox;
+    shape->bbox = bbox;
+    shape->fastTrack = false;
+
+    return true;
+}
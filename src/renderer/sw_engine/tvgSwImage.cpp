@@ -68,6 +68,27 @@ static bool _genOutline(SwImage* image, const Matrix& transform, SwMpool* mpool,
 }
 
 
+//2 x 2 box filter of the premultiplied pixels, the odd edges are repeated
+static void _halve(const uint32_t* src, uint32_t stride, uint32_t w, uint32_t h, uint32_t* dst)
+{
+    auto dw = (w + 1) / 2;
+    auto dh = (h + 1) / 2;
+
+    for (uint32_t y = 0; y < dh; ++y) {
+        auto r0 = src + (y * 2) * stride;
+        auto r1 = (y * 2 + 1 < h) ? r0 + stride : r0;
+        for (uint32_t x = 0; x < dw; ++x, ++dst) {
+            auto x0 = x * 2;
+            auto x1 = (x0 + 1 < w) ? x0 + 1 : x0;
+            //two channels per 16 bits lane, the sum of the four fits in 10 bits
+            auto lo = (r0[x0] & 0x00ff00ff) + (r0[x1] & 0x00ff00ff) + (r1[x0] & 0x00ff00ff) + (r1[x1] & 0x00ff00ff) + 0x00020002;
+            auto hi = ((r0[x0] >> 8) & 0x00ff00ff) + ((r0[x1] >> 8) & 0x00ff00ff) + ((r1[x0] >> 8) & 0x00ff00ff) + ((r1[x1] >> 8) & 0x00ff00ff) + 0x00020002;
+            *dst = ((lo >> 2) & 0x00ff00ff) | (((hi >> 2) & 0x00ff00ff) << 8);
+        }
+    }
+}
+
+
 /************************************************************************/
 /* External Class Implementation                                        */
 /************************************************************************/
@@ -95,9 +116,9 @@ bool imagePrepare(SwImage* image, const Matrix& transform, const RenderRegion& c
 }
 
 
-bool imageGenRle(SwImage* image, const RenderRegion& renderBox, bool antiAlias)
+bool imageGenRle(SwImage* image, const RenderRegion& renderBox, bool antiAlias, SwMpool* mpool, unsigned tid)
 {
-    if ((image->rle = rleRender(image->rle, image->outline, renderBox, antiAlias))) return true;
+    if ((image->rle = rleRender(image->rle, image->outline, renderBox, mpoolReqCellPool(mpool, tid), antiAlias, FLATNESS_TOLERANCE))) return true;
 
     return false;
 }
@@ -120,3 +141,59 @@ void imageFree(SwImage* image)
 {
     rleFree(image->rle);
 }
+
+
+//pick the level which leaves the scale in [0.5, 1) for the bilinear sampling, instead of averaging the wide areas of the image per pixel
+void imageGenMipmap(const SwImage* image, SwMipmap* mipmap)
+{
+    mipmap->level = 0;
+
+    if (!image->scaled || image->channelSize != sizeof(uint32_t)) return;
+
+    auto src = image->buf32;
+    auto stride = image->stride;
+    auto w = image->w;
+    auto h = image->h;
+
+    for (auto scale = image->scale; scale < 0.5f && (w > 1 || h > 1); scale *= 2.0f) {
+        if (mipmap->level == mipmap->levels.count) {
+            auto dst = tvg::malloc<uint32_t*>(sizeof(uint32_t) * ((w + 1) / 2) * ((h + 1) / 2));
+            if (!dst) return;
+            _halve(src, stride, w, h, dst);
+            mipmap->levels.push(dst);
+        }
+        src = mipmap->levels[mipmap->level++];
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+        stride = w;
+    }
+}
+
+
+void imageSelectMipmap(const SwMipmap* mipmap, SwImage& image, Matrix& transform)
+{
+    if (mipmap->level == 0) return;
+
+    for (uint32_t i = 0; i < mipmap->level; ++i) {
+        image.w = (image.w + 1) / 2;
+        image.h = (image.h + 1) / 2;
+    }
+    image.buf32 = mipmap->levels[mipmap->level - 1];
+    image.stride = image.w;
+
+    //the level pixel covers the 2^level source pixels
+    auto factor = float(1 << mipmap->level);
+    image.scale *= factor;
+    transform.e11 *= factor;
+    transform.e21 *= factor;
+    transform.e12 *= factor;
+    transform.e22 *= factor;
+}
+
+
+void imageFreeMipmap(SwMipmap* mipmap)
+{
+    ARRAY_FOREACH(p, mipmap->levels) tvg::free(*p);
+    mipmap->levels.clear();
+    mipmap->level = 0;
+}
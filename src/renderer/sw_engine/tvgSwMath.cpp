@@ -23,6 +23,14 @@
 #include "tvgMath.h"
 #include "tvgSwCommon.h"
 
+#if defined(THORVG_AVX_VECTOR_SUPPORT) && (defined(__SSE2__) || defined(_M_X64))
+    #include <emmintrin.h>
+    #define SW_MATH_SSE2 1
+#elif defined(THORVG_NEON_VECTOR_SUPPORT)
+    #include <arm_neon.h>
+    #define SW_MATH_NEON 1
+#endif
+
 
 /************************************************************************/
 /* Internal Class Implementation                                        */
@@ -271,6 +279,42 @@ SwPoint mathTransform(const Point* to, const Matrix& transform)
 }
 
 
+//the batch version of the above, two points per vector with the same results
+void mathTransform(const Point* in, SwPoint* out, uint32_t cnt, const Matrix& transform)
+{
+    uint32_t i = 0;
+
+#if defined(SW_MATH_SSE2)
+    auto m0 = _mm_setr_ps(transform.e11, transform.e21, transform.e11, transform.e21);
+    auto m1 = _mm_setr_ps(transform.e12, transform.e22, transform.e12, transform.e22);
+    auto m2 = _mm_setr_ps(transform.e13, transform.e23, transform.e13, transform.e23);
+    auto scale = _mm_set1_ps(64.0f);
+    for (; i + 2 <= cnt; i += 2) {
+        auto p = _mm_loadu_ps(&in[i].x);
+        auto x = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+        auto y = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+        auto t = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m0), _mm_mul_ps(y, m1)), m2);
+        _mm_storeu_si128((__m128i*)&out[i], _mm_cvttps_epi32(_mm_mul_ps(t, scale)));
+    }
+#elif defined(SW_MATH_NEON)
+    const float c0[] = {transform.e11, transform.e21, transform.e11, transform.e21};
+    const float c1[] = {transform.e12, transform.e22, transform.e12, transform.e22};
+    const float c2[] = {transform.e13, transform.e23, transform.e13, transform.e23};
+    auto m0 = vld1q_f32(c0);
+    auto m1 = vld1q_f32(c1);
+    auto m2 = vld1q_f32(c2);
+    for (; i + 2 <= cnt; i += 2) {
+        auto p = vld1q_f32(&in[i].x);
+        auto xy = vtrnq_f32(p, p);
+        auto t = vaddq_f32(vaddq_f32(vmulq_f32(xy.val[0], m0), vmulq_f32(xy.val[1], m1)), m2);
+        vst1q_s32(&out[i].x, vcvtq_s32_f32(vmulq_n_f32(t, 64.0f)));
+    }
+#endif
+
+    for (; i < cnt; ++i) out[i] = mathTransform(in + i, transform);
+}
+
+
 bool mathUpdateOutlineBBox(const SwOutline* outline, const RenderRegion& clipBox, RenderRegion& renderBox, bool fastTrack)
 {
     if (!outline) return false;
@@ -77,14 +77,42 @@ void mpoolRetDashOutline(SwMpool* mpool, unsigned idx)
 }
 
 
+SwStrokeBorder* mpoolReqStrokeBorders(SwMpool* mpool, unsigned idx)
+{
+    auto borders = mpool->strokeBorders + idx * 2;
+    for (int i = 0; i < 2; ++i) {
+        borders[i].ptsCnt = 0;
+        borders[i].start = -1;
+        borders[i].movable = false;
+    }
+    return borders;
+}
+
+
+void mpoolRetStrokeBorders(TVG_UNUSED SwMpool* mpool, TVG_UNUSED unsigned idx)
+{
+    //keep the buffers for the next stroke on this thread
+}
+
+
+SwCellPool* mpoolReqCellPool(SwMpool* mpool, unsigned idx)
+{
+    return &mpool->cellPools[idx];
+}
+
+
 SwMpool* mpoolInit(uint32_t threads)
 {
+    MemoryScope scope(MemoryCategory::Engine);
+
     auto allocSize = threads + 1;
 
     auto mpool = tvg::calloc<SwMpool*>(1, sizeof(SwMpool));
     mpool->outline = tvg::calloc<SwOutline*>(1, sizeof(SwOutline) * allocSize);
     mpool->strokeOutline = tvg::calloc<SwOutline*>(1, sizeof(SwOutline) * allocSize);
     mpool->dashOutline = tvg::calloc<SwOutline*>(1, sizeof(SwOutline) * allocSize);
+    mpool->strokeBorders = tvg::calloc<SwStrokeBorder*>(1, sizeof(SwStrokeBorder) * allocSize * 2);
+    mpool->cellPools = tvg::calloc<SwCellPool*>(1, sizeof(SwCellPool) * allocSize);
     mpool->allocSize = allocSize;
 
     return mpool;
@@ -108,6 +136,21 @@ bool mpoolClear(SwMpool* mpool)
         mpool->dashOutline[i].cntrs.reset();
         mpool->dashOutline[i].types.reset();
         mpool->dashOutline[i].closed.reset();
+
+        auto pool = mpool->cellPools + i;
+        if (pool->renders > 0) TVGLOG("SW_ENGINE", "Rle cell pool[%u]: outlines = %u, grows = %u, cells = %u", i, pool->renders, pool->grows, pool->cells.reserved);
+        pool->cells.reset();
+        pool->yCells.reset();
+        pool->renders = pool->grows = 0;
+    }
+
+    for (unsigned i = 0; i < mpool->allocSize * 2; ++i) {
+        auto border = mpool->strokeBorders + i;
+        tvg::free(border->pts);
+        tvg::free(border->tags);
+        border->pts = nullptr;
+        border->tags = nullptr;
+        border->ptsCnt = border->maxPts = 0;
     }
 
     return true;
@@ -123,6 +166,8 @@ bool mpoolTerm(SwMpool* mpool)
     tvg::free(mpool->outline);
     tvg::free(mpool->strokeOutline);
     tvg::free(mpool->dashOutline);
+    tvg::free(mpool->strokeBorders);
+    tvg::free(mpool->cellPools);
     tvg::free(mpool);
 
     return true;
@@ -21,6 +21,7 @@
  */
 
 #include "tvgMath.h"
+#include "tvgTaskScheduler.h"
 #include "tvgSwCommon.h"
 
 /************************************************************************/
@@ -33,6 +34,7 @@ struct SwGaussianBlur
     int level;
     int kernel[MAX_LEVEL];
     int extends;
+    int scale;      //downscaling level, blur on the 1/2^scale sized image
 };
 
 
@@ -59,55 +61,209 @@ static inline int _gaussianRemap(int end, int idx)
 }
 
 
-//TODO: SIMD OPTIMIZATION?
-template<int border = 0>
-static void _gaussianFilter(uint8_t* dst, uint8_t* src, int32_t stride, int32_t w, int32_t h, const RenderRegion& bbox, int32_t dimension, bool flipped)
+//sliding accumulation of a row. [x, to) must be free from the edges.
+template<int channels>
+static inline void _gaussianSlide(uint8_t* dst, const uint8_t* rsrc, const uint8_t* lsrc, int32_t x, int32_t to, int acc[channels], float iarr)
+{
+    for (; x < to; ++x, rsrc += channels, lsrc += channels, dst += channels) {
+        for (int c = 0; c < channels; ++c) {
+            acc[c] += rsrc[c] - lsrc[c];
+            //ignored rounding for the performance. It should be originally: acc[idx] * iarr + 0.5f
+            dst[c] = static_cast<uint8_t>(acc[c] * iarr);
+        }
+    }
+}
+
+
+//channels: 4 for the rgba pixels, 1 for the alpha planes
+template<int border = 0, int channels = 4>
+static void _gaussianFilter(uint8_t* dst, uint8_t* src, int32_t stride, int32_t w, int32_t begin, int32_t finish, const RenderRegion& bbox, int32_t dimension, bool flipped)
 {
     if (flipped) {
-        src += (bbox.min.x * stride + bbox.min.y) << 2;
-        dst += (bbox.min.x * stride + bbox.min.y) << 2;
+        src += (bbox.min.x * stride + bbox.min.y) * channels;
+        dst += (bbox.min.x * stride + bbox.min.y) * channels;
     } else {
-        src += (bbox.min.y * stride + bbox.min.x) << 2;
-        dst += (bbox.min.y * stride + bbox.min.x) << 2;
+        src += (bbox.min.y * stride + bbox.min.x) * channels;
+        dst += (bbox.min.y * stride + bbox.min.x) * channels;
     }
 
     auto iarr = 1.0f / (dimension + dimension + 1);
     auto end = w - 1;
 
-    #pragma omp parallel for
-    for (int y = 0; y < h; ++y) {
+    //the range that doesn't touch the edges
+    auto from = std::min(dimension + 1, w);
+    auto to = std::max(from, end - dimension + 1);
+
+    for (int y = begin; y < finish; ++y) {
         auto p = y * stride;
-        auto i = p * 4;                 //current index
         auto l = -(dimension + 1);      //left index
         auto r = dimension;             //right index
-        int acc[4] = {0, 0, 0, 0};      //sliding accumulator
+        int acc[channels] = {};         //sliding accumulator
 
         //initial accumulation
         for (int x = l; x < r; ++x) {
-            auto id = (_gaussianRemap<border>(end, x) + p) * 4;
-            acc[0] += src[id++];
-            acc[1] += src[id++];
-            acc[2] += src[id++];
-            acc[3] += src[id];
+            auto id = (_gaussianRemap<border>(end, x) + p) * channels;
+            for (int c = 0; c < channels; ++c) acc[c] += src[id + c];
         }
+
+        auto edge = [&](int32_t x, int32_t to) {
+            for (; x < to; ++x) {
+                auto rid = (_gaussianRemap<border>(end, x + r) + p) * channels;
+                auto lid = (_gaussianRemap<border>(end, x + l) + p) * channels;
+                _gaussianSlide<channels>(dst + (p + x) * channels, src + rid, src + lid, 0, 1, acc, iarr);
+            }
+        };
+
         //perform filtering
-        for (int x = 0; x < w; ++x, ++r, ++l) {
-            auto rid = (_gaussianRemap<border>(end, r) + p) * 4;
-            auto lid = (_gaussianRemap<border>(end, l) + p) * 4;
-            acc[0] += src[rid++] - src[lid++];
-            acc[1] += src[rid++] - src[lid++];
-            acc[2] += src[rid++] - src[lid++];
-            acc[3] += src[rid] - src[lid];
-            //ignored rounding for the performance. It should be originally: acc[idx] * iarr + 0.5f
-            dst[i++] = static_cast<uint8_t>(acc[0] * iarr);
-            dst[i++] = static_cast<uint8_t>(acc[1] * iarr);
-            dst[i++] = static_cast<uint8_t>(acc[2] * iarr);
-            dst[i++] = static_cast<uint8_t>(acc[3] * iarr);
+        edge(0, from);
+        _gaussianSlide<channels>(dst + (p + from) * channels, src + (p + from + r) * channels, src + (p + from + l) * channels, from, to, acc, iarr);
+        edge(to, w);
+    }
+}
+
+
+//a chunk of the rows for the box filters
+struct SwFilterTask : Task
+{
+    uint8_t* dst;
+    uint8_t* src;
+    const RenderRegion* bbox;
+    int32_t stride, w, begin, finish;
+    int32_t dimension;
+    bool alpha;
+    bool flipped;
+
+    void run(TVG_UNUSED unsigned tid) override
+    {
+        if (alpha) _gaussianFilter<0, 1>(dst, src, stride, w, begin, finish, *bbox, dimension, flipped);
+        else _gaussianFilter(dst, src, stride, w, begin, finish, *bbox, dimension, flipped);
+    }
+};
+
+
+//the rows are filtered independently, split them among the workers
+static void _filter(uint8_t* dst, uint8_t* src, int32_t stride, int32_t w, int32_t h, const RenderRegion& bbox, int32_t dimension, bool alpha, bool flipped)
+{
+    static constexpr int32_t MAX_CHUNKS = 16;
+    static constexpr int32_t MIN_ROWS = 32;   //not worth to split the small works
+
+    auto cnt = std::min(std::min(int32_t(TaskScheduler::threads()) + 1, MAX_CHUNKS), h / MIN_ROWS);
+    if (cnt < 1 || TaskScheduler::onthread()) cnt = 1;
+    auto rows = (h + cnt - 1) / cnt;
+
+    SwFilterTask tasks[MAX_CHUNKS];
+    TaskGroup group;
+
+    for (int32_t i = 0; i < cnt; ++i) {
+        auto& task = tasks[i];
+        task.dst = dst;
+        task.src = src;
+        task.bbox = &bbox;
+        task.stride = stride;
+        task.w = w;
+        task.begin = i * rows;
+        task.finish = std::min(h, task.begin + rows);
+        task.dimension = dimension;
+        task.alpha = alpha;
+        task.flipped = flipped;
+        if (i > 0) group.request(&task);
+    }
+
+    //the calling thread takes the first chunk
+    tasks[0].run(0);
+    group.wait();
+}
+
+
+static void _filter(uint32_t* dst, uint32_t* src, int32_t stride, int32_t w, int32_t h, const RenderRegion& bbox, int32_t dimension, bool flipped)
+{
+    _filter(reinterpret_cast<uint8_t*>(dst), reinterpret_cast<uint8_t*>(src), stride, w, h, bbox, dimension, false, flipped);
+}
+
+
+//box averaging of the 2^scale sized blocks
+static void _gaussianDownscale(uint32_t* dst, uint32_t* src, int32_t stride, int32_t w, int32_t h, const RenderRegion& bbox, int scale)
+{
+    src += (bbox.min.y * stride + bbox.min.x);
+    dst += (bbox.min.y * stride + bbox.min.x);
+
+    auto size = 1 << scale;
+
+    for (int32_t y = 0; y < h; y += size) {
+        auto bh = std::min(size, h - y);
+        auto d = dst + (y >> scale) * stride;
+        for (int32_t x = 0; x < w; x += size) {
+            auto bw = std::min(size, w - x);
+            uint32_t acc[4] = {0, 0, 0, 0};
+            auto s = src + y * stride + x;
+            for (int32_t yy = 0; yy < bh; ++yy, s += stride) {
+                for (int32_t xx = 0; xx < bw; ++xx) {
+                    acc[0] += s[xx] & 0xff;
+                    acc[1] += (s[xx] >> 8) & 0xff;
+                    acc[2] += (s[xx] >> 16) & 0xff;
+                    acc[3] += s[xx] >> 24;
+                }
+            }
+            auto cnt = uint32_t(bw * bh);
+            *d++ = (acc[3] / cnt) << 24 | (acc[2] / cnt) << 16 | (acc[1] / cnt) << 8 | (acc[0] / cnt);
+        }
+    }
+}
+
+
+//bilinear magnification of the downscaled image (lw x lh) to the original size (w x h)
+static void _gaussianUpscale(uint32_t* dst, uint32_t* src, int32_t stride, int32_t w, int32_t h, int32_t lw, int32_t lh, const RenderRegion& bbox, int scale)
+{
+    src += (bbox.min.y * stride + bbox.min.x);
+    dst += (bbox.min.y * stride + bbox.min.x);
+
+    //sampling position of the pixel center in 1/256 pixel unit
+    auto sample = [&](int32_t v, int32_t max, int32_t& idx, uint8_t& frac) {
+        auto pos = (((2 * v + 1) << 8) >> (scale + 1)) - 128;
+        if (pos < 0) pos = 0;
+        idx = pos >> 8;
+        frac = pos & 0xff;
+        if (idx >= max - 1) {
+            idx = max - 1;
+            frac = 0;
+        }
+    };
+
+    for (int32_t y = 0; y < h; ++y) {
+        int32_t sy;
+        uint8_t fy;
+        sample(y, lh, sy, fy);
+        auto row0 = src + sy * stride;
+        auto row1 = (sy + 1 < lh) ? row0 + stride : row0;
+        auto d = dst + y * stride;
+        for (int32_t x = 0; x < w; ++x) {
+            int32_t sx;
+            uint8_t fx;
+            sample(x, lw, sx, fx);
+            auto nx = (sx + 1 < lw) ? sx + 1 : sx;
+            auto top = INTERPOLATE(row0[nx], row0[sx], fx);
+            auto bottom = INTERPOLATE(row1[nx], row1[sx], fx);
+            d[x] = INTERPOLATE(bottom, top, fy);
         }
     }
 }
 
 
+//the number of halvings for the large kernels. the lower quality allows the more.
+static int _gaussianScale(float sigma, int quality, int direction)
+{
+    static constexpr float MIN_SIGMA = 8.0f;    //keep the blur on the downscaled image wide enough
+
+    //only for the both directions, the other axis would lose the details
+    if (direction != 0 || quality >= 75) return 0;
+
+    auto max = std::min((74 - quality) / 25 + 1, 3);
+    auto scale = 0;
+    while (scale < max && sigma / float(1 << (scale + 1)) >= MIN_SIGMA) ++scale;
+    return scale;
+}
+
+
 //Fast Almost-Gaussian Filtering Method by Peter Kovesi
 static int _gaussianInit(SwGaussianBlur* data, float sigma, int quality)
 {
@@ -160,7 +316,9 @@ void effectGaussianBlurUpdate(RenderEffectGaussianBlur* params, const Matrix& tr
 
     //compute box kernel sizes
     auto scale = sqrt(transform.e11 * transform.e11 + transform.e12 * transform.e12);
-    rd->extends = _gaussianInit(rd, std::pow(params->sigma * scale, 2), params->quality);
+    auto sigma = params->sigma * scale;
+    rd->scale = _gaussianScale(sigma, params->quality, params->direction);
+    rd->extends = _gaussianInit(rd, std::pow(sigma / float(1 << rd->scale), 2), params->quality) << rd->scale;
 
     //invalid
     if (rd->extends == 0) {
@@ -172,6 +330,52 @@ void effectGaussianBlurUpdate(RenderEffectGaussianBlur* params, const Matrix& tr
 }
 
 
+//downscale, blur on the small image, then upscale it back
+static bool _gaussianBlurScaled(SwCompositor* cmp, SwSurface* surface, const SwGaussianBlur* data)
+{
+    auto& buffer = surface->compositor->image;
+    auto& bbox = cmp->bbox;
+    auto w = (bbox.max.x - bbox.min.x);
+    auto h = (bbox.max.y - bbox.min.y);
+    auto lw = (w + (1 << data->scale) - 1) >> data->scale;
+    auto lh = (h + (1 << data->scale) - 1) >> data->scale;
+    RenderRegion lbox = {bbox.min, {bbox.min.x + lw, bbox.min.y + lh}};
+    auto stride = cmp->image.stride;
+    auto front = cmp->image.buf32;
+    auto back = buffer.buf32;
+    auto swapped = false;
+
+    _gaussianDownscale(back, front, stride, w, h, bbox, data->scale);
+    std::swap(front, back);
+    swapped = !swapped;
+
+    for (int i = 0; i < data->level; ++i) {
+        _filter(back, front, stride, lw, lh, lbox, data->kernel[i], false);
+        std::swap(front, back);
+        swapped = !swapped;
+    }
+
+    rasterXYFlip(front, back, stride, lw, lh, lbox, false);
+    std::swap(front, back);
+
+    for (int i = 0; i < data->level; ++i) {
+        _filter(back, front, stride, lh, lw, lbox, data->kernel[i], true);
+        std::swap(front, back);
+        swapped = !swapped;
+    }
+
+    rasterXYFlip(front, back, stride, lh, lw, lbox, true);
+    std::swap(front, back);
+
+    _gaussianUpscale(back, front, stride, w, h, lw, lh, bbox, data->scale);
+    swapped = !swapped;
+
+    if (swapped) std::swap(cmp->image.buf8, buffer.buf8);
+
+    return true;
+}
+
+
 bool effectGaussianBlur(SwCompositor* cmp, SwSurface* surface, const RenderEffectGaussianBlur* params)
 {
     auto& buffer = surface->compositor->image;
@@ -184,7 +388,9 @@ bool effectGaussianBlur(SwCompositor* cmp, SwSurface* surface, const RenderEffec
     auto back = buffer.buf32;
     auto swapped = false;
 
-    TVGLOG("SW_ENGINE", "GaussianFilter region(%d, %d, %d, %d) params(%f %d %d), level(%d)", bbox.min.x, bbox.min.y, bbox.max.x, bbox.max.y, params->sigma, params->direction, params->border, data->level);
+    TVGLOG("SW_ENGINE", "GaussianFilter region(%d, %d, %d, %d) params(%f %d %d), level(%d), scale(%d)", bbox.min.x, bbox.min.y, bbox.max.x, bbox.max.y, params->sigma, params->direction, params->border, data->level, data->scale);
+
+    if (data->scale > 0) return _gaussianBlurScaled(cmp, surface, data);
 
     /* It is best to take advantage of the Gaussian blur’s separable property
        by dividing the process into two passes. horizontal and vertical.
@@ -193,7 +399,7 @@ bool effectGaussianBlur(SwCompositor* cmp, SwSurface* surface, const RenderEffec
     //horizontal
     if (params->direction != 2) {
         for (int i = 0; i < data->level; ++i) {
-            _gaussianFilter(reinterpret_cast<uint8_t*>(back), reinterpret_cast<uint8_t*>(front), stride, w, h, bbox, data->kernel[i], false);
+            _filter(back, front, stride, w, h, bbox, data->kernel[i], false);
             std::swap(front, back);
             swapped = !swapped;
         }
@@ -205,7 +411,7 @@ bool effectGaussianBlur(SwCompositor* cmp, SwSurface* surface, const RenderEffec
         std::swap(front, back);
 
         for (int i = 0; i < data->level; ++i) {
-            _gaussianFilter(reinterpret_cast<uint8_t*>(back), reinterpret_cast<uint8_t*>(front), stride, h, w, bbox, data->kernel[i], true);
+            _filter(back, front, stride, h, w, bbox, data->kernel[i], true);
             std::swap(front, back);
             swapped = !swapped;
         }
@@ -229,73 +435,39 @@ struct SwDropShadow : SwGaussianBlur
 };
 
 
-//TODO: SIMD OPTIMIZATION?
-static void _dropShadowFilter(uint32_t* dst, uint32_t* src, int stride, int w, int h, const RenderRegion& bbox, int32_t dimension, uint32_t color, bool flipped)
+//clip: the backed region of the destination
+template<typename PIXEL_T>
+static void _shift(uint32_t** dst, PIXEL_T** src, int dstride, int sstride, const RenderRegion& clip, const RenderRegion& bbox, const SwPoint& offset, SwSize& size)
 {
-    if (flipped) {
-        src += (bbox.min.x * stride + bbox.min.y);
-        dst += (bbox.min.x * stride + bbox.min.y);
-    } else {
-        src += (bbox.min.y * stride + bbox.min.x);
-        dst += (bbox.min.y * stride + bbox.min.x);
-    }
-    auto iarr = 1.0f / (dimension + dimension + 1);
-    auto end = w - 1;
+    //the shifted bbox within the clip, the source stays in the bbox
+    auto region = RenderRegion::intersect({{bbox.min.x + offset.x, bbox.min.y + offset.y}, {bbox.max.x + offset.x, bbox.max.y + offset.y}}, clip);
+    size.w = region.sw();
+    size.h = region.sh();
 
-    #pragma omp parallel for
-    for (int y = 0; y < h; ++y) {
-        auto p = y * stride;
-        auto i = p;                     //current index
-        auto l = -(dimension + 1);      //left index
-        auto r = dimension;             //right index
-        int acc = 0;                    //sliding accumulator
-
-        //initial accumulation
-        for (int x = l; x < r; ++x) {
-            auto id = _gaussianEdgeExtend(end, x) + p;
-            acc += A(src[id]);
-        }
-        //perform filtering
-        for (int x = 0; x < w; ++x, ++r, ++l) {
-            auto rid = _gaussianEdgeExtend(end, r) + p;
-            auto lid = _gaussianEdgeExtend(end, l) + p;
-            acc += A(src[rid]) - A(src[lid]);
-            //ignored rounding for the performance. It should be originally: acc * iarr
-            dst[i++] = ALPHA_BLEND(color, static_cast<uint8_t>(acc * iarr));
-        }
-    }
+    *dst += (region.min.y - bbox.min.y) * dstride + (region.min.x - bbox.min.x);
+    *src += (region.min.y - offset.y - bbox.min.y) * sstride + (region.min.x - offset.x - bbox.min.x);
 }
 
-static void _shift(uint32_t** dst, uint32_t** src, int dstride, int sstride, int wmax, int hmax, const RenderRegion& bbox, const SwPoint& offset, SwSize& size)
-{
-    size.w = bbox.max.x - bbox.min.x;
-    size.h = bbox.max.y - bbox.min.y;
-
-    //shift
-    if (bbox.min.x + offset.x < 0) *src -= offset.x;
-    else *dst += offset.x;
 
-    if (bbox.min.y + offset.y < 0) *src -= (offset.y * sstride);
-    else *dst += (offset.y * dstride);
-
-    if (size.w + bbox.min.x + offset.x > wmax) size.w -= (size.w + bbox.min.x + offset.x - wmax);
-    if (size.h + bbox.min.y + offset.y > hmax) size.h -= (size.h + bbox.min.y + offset.y - hmax);
-}
+static inline uint8_t _alpha(uint32_t c) { return A(c); }
+static inline uint8_t _alpha(uint8_t a) { return a; }
 
 
-static void _dropShadowNoFilter(uint32_t* dst, uint32_t* src, int dstride, int sstride, int dw, int dh, const RenderRegion& bbox, const SwPoint& offset, uint32_t color, uint8_t opacity, bool direct)
+//the shadow color is applied to the alpha of the source pixels or the alpha plane, shifted by the offset
+template<typename PIXEL_T>
+static void _dropShadowColorize(uint32_t* dst, PIXEL_T* src, int dstride, int sstride, const RenderRegion& clip, const RenderRegion& bbox, const SwPoint& offset, uint32_t color, uint8_t opacity, bool direct)
 {
     src += (bbox.min.y * sstride + bbox.min.x);
     dst += (bbox.min.y * dstride + bbox.min.x);
 
     SwSize size;
-    _shift(&dst, &src, dstride, sstride, dw, dh, bbox, offset, size);
+    _shift(&dst, &src, dstride, sstride, clip, bbox, offset, size);
 
     for (auto y = 0; y < size.h; ++y) {
         auto s2 = src;
         auto d2 = dst;
         for (int x = 0; x < size.w; ++x, ++d2, ++s2) {
-            auto a = MULTIPLY(opacity, A(*s2));
+            auto a = MULTIPLY(opacity, _alpha(*s2));
             if (!direct || a == 255) *d2 = ALPHA_BLEND(color, a);
             else *d2 = INTERPOLATE(color, *d2, a);
         }
@@ -305,43 +477,28 @@ static void _dropShadowNoFilter(uint32_t* dst, uint32_t* src, int dstride, int s
 }
 
 
-static void _dropShadowNoFilter(SwImage* dimg, SwImage* simg, const RenderRegion& bbox, const SwPoint& offset, uint32_t color)
+//overlays the original image on the shadow
+static void _dropShadowOverlay(SwImage* dimg, SwImage* simg, const RenderRegion& bbox)
 {
-    int dstride = dimg->stride;
-    int sstride = simg->stride;
-
-    //shadow image
-    _dropShadowNoFilter(dimg->buf32, simg->buf32, dstride, sstride, dimg->w, dimg->h, bbox, offset, color, 255, false);
-
-    //original image
-    auto src = simg->buf32 + (bbox.min.y * sstride + bbox.min.x);
-    auto dst = dimg->buf32 + (bbox.min.y * dstride + bbox.min.x);
+    auto src = simg->buf32 + (bbox.min.y * simg->stride + bbox.min.x);
+    auto dst = dimg->buf32 + (bbox.min.y * dimg->stride + bbox.min.x);
 
     for (auto y = 0; y < (bbox.max.y - bbox.min.y); ++y) {
-        auto s = src;
-        auto d = dst;
-        for (int x = 0; x < (bbox.max.x - bbox.min.x); ++x, ++d, ++s) {
-            *d = *s + ALPHA_BLEND(*d, IA(*s));
-        }
-        src += sstride;
-        dst += dstride;
+        rasterTranslucentPixel32(dst, src, bbox.max.x - bbox.min.x, 255);
+        src += simg->stride;
+        dst += dimg->stride;
     }
 }
 
 
-static void _dropShadowShift(uint32_t* dst, uint32_t* src, int dstride, int sstride, int dw, int dh, const RenderRegion& bbox, const SwPoint& offset, uint8_t opacity, bool direct)
+//the alpha channel of the region into the plane
+static void _dropShadowAlpha(uint8_t* dst, const uint32_t* src, int stride, const RenderRegion& bbox)
 {
-    src += (bbox.min.y * sstride + bbox.min.x);
-    dst += (bbox.min.y * dstride + bbox.min.x);
-
-    SwSize size;
-    _shift(&dst, &src, dstride, sstride, dw, dh, bbox, offset, size);
+    src += (bbox.min.y * stride + bbox.min.x);
+    dst += (bbox.min.y * stride + bbox.min.x);
 
-    for (auto y = 0; y < size.h; ++y) {
-        if (direct) rasterTranslucentPixel32(dst, src, size.w, opacity);
-        else rasterPixel32(dst, src, size.w, opacity);
-        src += sstride;
-        dst += dstride;
+    for (auto y = 0; y < (bbox.max.y - bbox.min.y); ++y, src += stride, dst += stride) {
+        for (auto x = 0; x < (bbox.max.x - bbox.min.x); ++x) dst[x] = A(src[x]);
     }
 }
 
@@ -394,8 +551,8 @@ void effectDropShadowUpdate(RenderEffectDropShadow* params, const Matrix& transf
 
 
 //A quite same integration with effectGaussianBlur(). See it for detailed comments.
-//surface[0]: the original image, to overlay it into the filtered image.
-//surface[1]: temporary buffer for generating the filtered image.
+//surface[0]: scratch memory for the alpha planes of the shadow.
+//surface[1]: temporary buffer for compositing the shadow and the original image.
 bool effectDropShadow(SwCompositor* cmp, SwSurface* surface[2], const RenderEffectDropShadow* params, bool direct)
 {
     //FIXME: if the body is partially visible due to clipping, the shadow also becomes partially visible.
@@ -411,9 +568,6 @@ bool effectDropShadow(SwCompositor* cmp, SwSurface* surface[2], const RenderEffe
     SwImage* buffer[] = {&surface[0]->compositor->image, &surface[1]->compositor->image};
     auto color = cmp->recoverSfc->join(params->color[0], params->color[1], params->color[2], 255);
     auto stride = cmp->image.stride;
-    auto front = cmp->image.buf32;
-    auto back = buffer[1]->buf32;
-
     auto opacity = direct ? MULTIPLY(params->color[3], cmp->opacity) : params->color[3];
 
     TVGLOG("SW_ENGINE", "DropShadow region(%d, %d, %d, %d) params(%f %f %f), level(%d)", bbox.min.x, bbox.min.y, bbox.max.x, bbox.max.y, params->angle, params->distance, params->sigma, data->level);
@@ -421,22 +575,27 @@ bool effectDropShadow(SwCompositor* cmp, SwSurface* surface[2], const RenderEffe
     //no filter required
     if (params->sigma == 0.0f)  {
         if (direct) {
-            _dropShadowNoFilter(cmp->recoverSfc->buf32, cmp->image.buf32, cmp->recoverSfc->stride, cmp->image.stride, cmp->recoverSfc->w, cmp->recoverSfc->h, bbox, data->offset, color, opacity, direct);
+            _dropShadowColorize(cmp->recoverSfc->buf32, cmp->image.buf32, cmp->recoverSfc->stride, stride, RenderRegion::intersect(cmp->recoverSfc->area, bbox), bbox, data->offset, color, opacity, direct);
         } else {
-            _dropShadowNoFilter(buffer[1], &cmp->image, bbox, data->offset, color);
+            rasterClear(surface[1], bbox.min.x, bbox.min.y, w, h);
+            _dropShadowColorize(buffer[1]->buf32, cmp->image.buf32, buffer[1]->stride, stride, RenderRegion::intersect(surface[1]->area, bbox), bbox, data->offset, color, 255, false);
+            _dropShadowOverlay(buffer[1], &cmp->image, bbox);
             std::swap(cmp->image.buf32, buffer[1]->buf32);
         }
         return true;
     }
 
-    //saving the original image in order to overlay it into the filtered image.
-    _dropShadowFilter(back, front, stride, w, h, bbox, data->kernel[0], color, false);
-    std::swap(front, buffer[0]->buf32);
-    std::swap(front, back);
+    /* Only the alpha channel matters to the shadow, it's blurred in the 8 bits planes
+       taken from the first buffer (4 planes of the square size fit in it) and colorized at the end.
+       The original image stays intact to be overlaid on the shadow. */
+    auto front = buffer[0]->buf8;
+    auto back = front + size_t(stride) * buffer[0]->h;
+
+    _dropShadowAlpha(front, cmp->image.buf32, stride, bbox);
 
     //horizontal
-    for (int i = 1; i < data->level; ++i) {
-        _dropShadowFilter(back, front, stride, w, h, bbox, data->kernel[i], color, false);
+    for (int i = 0; i < data->level; ++i) {
+        _filter(back, front, stride, w, h, bbox, data->kernel[i], true, false);
         std::swap(front, back);
     }
 
@@ -445,33 +604,23 @@ bool effectDropShadow(SwCompositor* cmp, SwSurface* surface[2], const RenderEffe
     std::swap(front, back);
 
     for (int i = 0; i < data->level; ++i) {
-        _dropShadowFilter(back, front, stride, h, w, bbox, data->kernel[i], color, true);
+        _filter(back, front, stride, h, w, bbox, data->kernel[i], true, true);
         std::swap(front, back);
     }
 
     rasterXYFlip(front, back, stride, h, w, bbox, true);
-    std::swap(cmp->image.buf32, back);
 
     //draw to the main surface directly
     if (direct) {
-        _dropShadowShift(cmp->recoverSfc->buf32, cmp->image.buf32, cmp->recoverSfc->stride, cmp->image.stride, cmp->recoverSfc->w, cmp->recoverSfc->h, bbox, data->offset, opacity, direct);
-        std::swap(cmp->image.buf32, buffer[0]->buf32);
+        _dropShadowColorize(cmp->recoverSfc->buf32, back, cmp->recoverSfc->stride, stride, RenderRegion::intersect(cmp->recoverSfc->area, bbox), bbox, data->offset, color, opacity, direct);
         return true;
     }
 
-    //draw to the intermediate surface
+    //draw to the intermediate surface, then compositing shadow and body
     rasterClear(surface[1], bbox.min.x, bbox.min.y, w, h);
-    _dropShadowShift(buffer[1]->buf32, cmp->image.buf32, buffer[1]->stride, cmp->image.stride, buffer[1]->w, buffer[1]->h, bbox, data->offset, opacity, direct);
-
-    //compositing shadow and body
-    auto s = buffer[0]->buf32 + (bbox.min.y * buffer[0]->stride + bbox.min.x);
-    auto d = cmp->image.buf32 + (bbox.min.y * cmp->image.stride + bbox.min.x);
-
-    for (auto y = 0; y < h; ++y) {
-        rasterTranslucentPixel32(d, s, w, 255);
-        s += buffer[0]->stride;
-        d += cmp->image.stride;
-    }
+    _dropShadowColorize(buffer[1]->buf32, back, buffer[1]->stride, stride, RenderRegion::intersect(surface[1]->area, bbox), bbox, data->offset, color, opacity, direct);
+    _dropShadowOverlay(buffer[1], &cmp->image, bbox);
+    std::swap(cmp->image.buf32, buffer[1]->buf32);
 
     return true;
 }
@@ -481,6 +630,12 @@ bool effectDropShadow(SwCompositor* cmp, SwSurface* surface[2], const RenderEffe
 /* Fill Implementation                                                  */
 /************************************************************************/
 
+static inline uint32_t _fill(uint32_t c, uint32_t color, uint8_t opacity)
+{
+    return ALPHA_BLEND(color, MULTIPLY(opacity, A(c)));
+}
+
+
 void effectFillUpdate(RenderEffectFill* params)
 {
     params->valid = true;
@@ -518,7 +673,7 @@ bool effectFill(SwCompositor* cmp, const RenderEffectFill* params, bool direct)
         for (size_t y = 0; y < h; ++y) {
             auto dst = dbuffer;
             for (size_t x = 0; x < w; ++x, ++dst) {
-                *dst = ALPHA_BLEND(color, MULTIPLY(opacity, A(*dst)));
+                *dst = _fill(*dst, color, opacity);
             }
             dbuffer += cmp->image.stride;
         }
@@ -531,6 +686,14 @@ bool effectFill(SwCompositor* cmp, const RenderEffectFill* params, bool direct)
 /* Tint Implementation                                                  */
 /************************************************************************/
 
+static inline uint32_t _tint(uint32_t c, uint32_t black, uint32_t white, uint8_t intensity, uint8_t opacity, SwAlpha luma)
+{
+    auto val = INTERPOLATE(white, black, luma((uint8_t*)&c));
+    if (intensity < 255) val = INTERPOLATE(val, c, intensity);
+    return ALPHA_BLEND(val, MULTIPLY(opacity, A(c)));
+}
+
+
 void effectTintUpdate(RenderEffectTint* params)
 {
     params->valid = (params->intensity > 0);
@@ -569,9 +732,7 @@ bool effectTint(SwCompositor* cmp, const RenderEffectTint* params, bool direct)
         for (size_t y = 0; y < h; ++y) {
             auto dst = dbuffer;
             for (size_t x = 0; x < w; ++x, ++dst) {
-                auto val = INTERPOLATE(white, black, luma((uint8_t*)&dst));
-                if (params->intensity < 255) val = INTERPOLATE(val, *dst, params->intensity);
-                *dst = ALPHA_BLEND(val, MULTIPLY(opacity, A(*dst)));
+                *dst = _tint(*dst, black, white, params->intensity, opacity, luma);
             }
             dbuffer += cmp->image.stride;
         }
@@ -597,6 +758,14 @@ static uint32_t _trintone(uint32_t s, uint32_t m, uint32_t h, int l)
 }
 
 
+static inline uint32_t _tritone(uint32_t c, uint32_t shadow, uint32_t midtone, uint32_t highlight, uint8_t blender, uint8_t opacity, SwAlpha luma)
+{
+    auto val = _trintone(shadow, midtone, highlight, luma((uint8_t*)&c));
+    if (blender > 0) val = INTERPOLATE(c, val, blender);
+    return ALPHA_BLEND(val, MULTIPLY(A(c), opacity));
+}
+
+
 void effectTritoneUpdate(RenderEffectTritone* params)
 {
     params->valid = (params->blender < 255);
@@ -639,18 +808,87 @@ bool effectTritone(SwCompositor* cmp, const RenderEffectTritone* params, bool di
         auto dbuffer = cmp->image.buf32 + (bbox.min.y * cmp->image.stride + bbox.min.x);
         for (size_t y = 0; y < h; ++y) {
             auto dst = dbuffer;
-            if (params->blender == 0) {
-                for (size_t x = 0; x < w; ++x, ++dst) {
-                    *dst = ALPHA_BLEND(_trintone(shadow, midtone, highlight, luma((uint8_t*)dst)), MULTIPLY(A(*dst), opacity));
-                }
-            } else {
-                for (size_t x = 0; x < w; ++x, ++dst) {
-                    *dst = ALPHA_BLEND(INTERPOLATE(*dst, _trintone(shadow, midtone, highlight, luma((uint8_t*)dst)), params->blender), MULTIPLY(A(*dst), opacity));
-                }
+            for (size_t x = 0; x < w; ++x, ++dst) {
+                *dst = _tritone(*dst, shadow, midtone, highlight, params->blender, opacity, luma);
             }
             dbuffer += cmp->image.stride;
         }
     }
 
     return true;
-}
\ No newline at end of file
+}
+
+
+/************************************************************************/
+/* Color Effects Fusion Implementation                                  */
+/************************************************************************/
+
+struct SwColorStep
+{
+    SceneEffect type;
+    uint32_t c0, c1, c2;  //joined colors
+    uint8_t param;        //fill opacity, tint intensity or tritone blender
+};
+
+
+bool effectColors(SwCompositor* cmp, const RenderEffect* const* effects, uint32_t cnt)
+{
+    auto& bbox = cmp->bbox;
+    auto w = size_t(bbox.max.x - bbox.min.x);
+    auto h = size_t(bbox.max.y - bbox.min.y);
+    auto sfc = cmp->recoverSfc;
+    auto opacity = cmp->opacity;
+    auto luma = sfc->alphas[2];  //luma function
+
+    //translate the effects into the per-pixel steps once, then run them in a single pass
+    auto steps = tvg::malloc<SwColorStep*>(sizeof(SwColorStep) * cnt);
+    uint32_t n = 0;
+
+    for (uint32_t i = 0; i < cnt; ++i) {
+        auto effect = effects[i];
+        if (!effect->valid) continue;
+        auto& step = steps[n++];
+        step.type = effect->type;
+        if (effect->type == SceneEffect::Fill) {
+            auto params = static_cast<const RenderEffectFill*>(effect);
+            step.c0 = sfc->join(params->color[0], params->color[1], params->color[2], 255);
+            step.param = params->color[3];
+        } else if (effect->type == SceneEffect::Tint) {
+            auto params = static_cast<const RenderEffectTint*>(effect);
+            step.c0 = sfc->join(params->black[0], params->black[1], params->black[2], 255);
+            step.c1 = sfc->join(params->white[0], params->white[1], params->white[2], 255);
+            step.param = params->intensity;
+        } else if (effect->type == SceneEffect::Tritone) {
+            auto params = static_cast<const RenderEffectTritone*>(effect);
+            step.c0 = sfc->join(params->shadow[0], params->shadow[1], params->shadow[2], 255);
+            step.c1 = sfc->join(params->midtone[0], params->midtone[1], params->midtone[2], 255);
+            step.c2 = sfc->join(params->highlight[0], params->highlight[1], params->highlight[2], 255);
+            step.param = params->blender;
+        } else {
+            --n;
+        }
+    }
+
+    TVGLOG("SW_ENGINE", "Color effects region(%d, %d, %d, %d), steps(%u)", bbox.min.x, bbox.min.y, bbox.max.x, bbox.max.y, n);
+
+    auto dbuffer = cmp->image.buf32 + (bbox.min.y * cmp->image.stride + bbox.min.x);
+    for (size_t y = 0; y < h; ++y) {
+        auto dst = dbuffer;
+        for (size_t x = 0; x < w; ++x, ++dst) {
+            auto c = *dst;
+            if (A(c) == 0) continue;  //every step keeps the transparent pixels as they are
+            for (auto step = steps; step < steps + n; ++step) {
+                switch (step->type) {
+                    case SceneEffect::Fill: c = _fill(c, step->c0, step->param); break;
+                    case SceneEffect::Tint: c = _tint(c, step->c0, step->c1, step->param, opacity, luma); break;
+                    default: c = _tritone(c, step->c0, step->c1, step->c2, step->param, opacity, luma); break;
+                }
+            }
+            *dst = c;
+        }
+        dbuffer += cmp->image.stride;
+    }
+
+    tvg::free(steps);
+    return true;
+}
@@ -29,6 +29,7 @@
 /************************************************************************/
 
 constexpr auto DOWN_SCALE_TOLERANCE = 0.5f;
+constexpr int32_t SCALE_CHUNK_SIZE = 64;
 
 struct FillLinear
 {
@@ -158,6 +159,30 @@ static inline bool _matting(const SwSurface* surface)
     else return false;
 }
 
+
+//the matting alpha as a type, the raster loops are instantiated per mask method & colorspace to inline it
+template<SwAlpha op>
+struct SwMatte
+{
+    uint8_t operator()(uint8_t* c) const
+    {
+        return op(c);
+    }
+};
+
+
+template<typename Raster>
+static bool _matte(SwSurface* surface, Raster raster)
+{
+    auto alpha = surface->alpha(surface->compositor->method);
+    if (alpha == _alpha) return raster(SwMatte<_alpha>());
+    if (alpha == _ialpha) return raster(SwMatte<_ialpha>());
+    if (alpha == _abgrLuma) return raster(SwMatte<_abgrLuma>());
+    if (alpha == _abgrInvLuma) return raster(SwMatte<_abgrInvLuma>());
+    if (alpha == _argbLuma) return raster(SwMatte<_argbLuma>());
+    return raster(SwMatte<_argbInvLuma>());
+}
+
 static inline uint8_t _opMaskNone(uint8_t s, TVG_UNUSED uint8_t d, TVG_UNUSED uint8_t a)
 {
     return s;
@@ -242,6 +267,79 @@ static bool _compositeMaskImage(SwSurface* surface, const SwImage& image, const
 #include "tvgSwRasterC.h"
 #include "tvgSwRasterAvx.h"
 #include "tvgSwRasterNeon.h"
+#include "tvgSwRasterWasm.h"
+
+
+//the vectorized rasterizers available on this cpu, see rasterInit()
+static struct {
+    bool (*translucentRect)(SwSurface* surface, const RenderRegion& bbox, const RenderColor& c);
+    bool (*translucentRle)(SwSurface* surface, const SwRle* rle, const RenderRegion& bbox, const RenderColor& c);
+    void (*grayscale8)(uint8_t* dst, uint8_t val, uint32_t offset, int32_t len);
+    void (*pixel32)(uint32_t* dst, uint32_t val, uint32_t offset, int32_t len);
+    uint32_t (*upScaleRow)(const uint32_t* img, uint32_t stride, uint32_t w, uint32_t h, float e11, float e13, float sy, int32_t x, uint32_t len, uint32_t* out);
+    void (*blender)(SwSurface* surface, BlendMethod method);
+    void (*premultiply)(uint32_t* buf, uint32_t len);
+    void (*unpremultiply)(uint32_t* buf, uint32_t len);
+    void (*swapRB)(uint32_t* buf, uint32_t len);
+} _simd = {cRasterTranslucentRect, cRasterTranslucentRle, cRasterPixels, cRasterPixels, nullptr, nullptr, cRasterPremultiply, cRasterUnpremultiply, cRasterSwapRB};
+
+
+//span blenders, the blender is inlined per blend method
+template<SwBlender op>
+static void _blendColorSpan(uint32_t* dst, uint32_t color, uint32_t len, uint8_t a)
+{
+    if (a == 255) {
+        for (uint32_t x = 0; x < len; ++x, ++dst) {
+            *dst = op(color, *dst);
+        }
+    } else {
+        for (uint32_t x = 0; x < len; ++x, ++dst) {
+            *dst = INTERPOLATE(op(color, *dst), *dst, a);
+        }
+    }
+}
+
+
+template<SwBlender op>
+static void _blendImageSpan(uint32_t* dst, const uint32_t* src, uint32_t len, uint8_t a)
+{
+    for (uint32_t x = 0; x < len; ++x, ++dst, ++src) {
+        *dst = INTERPOLATE(op(rasterUnpremultiply(*src), *dst), *dst, MULTIPLY(a, A(*src)));
+    }
+}
+
+
+template<SwBlender op>
+static void _blender(SwSurface* surface)
+{
+    surface->blender = op;
+    surface->colorBlender = _blendColorSpan<op>;
+    surface->imageBlender = _blendImageSpan<op>;
+}
+
+
+static SwSimd _simdSupport()
+{
+#if defined(THORVG_AVX_VECTOR_SUPPORT)
+    #if defined(_MSC_VER) && !defined(__clang__)
+        //avx, sse4.1 and the os saving the ymm registers
+        int info[4];
+        __cpuid(info, 1);
+        auto avx = (info[2] & (1 << 28)) && (info[2] & (1 << 27)) && (info[2] & (1 << 19));
+        if (avx && (_xgetbv(0) & 0x6) == 0x6) return SwSimd::Avx;
+    #else
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx") && __builtin_cpu_supports("sse4.1")) return SwSimd::Avx;
+    #endif
+#elif defined(THORVG_NEON_VECTOR_SUPPORT)
+    //neon is a build requirement
+    return SwSimd::Neon;
+#elif defined(THORVG_WASM_VECTOR_SUPPORT)
+    //simd128 is a build requirement, the runtime fails to instantiate the module without it
+    return SwSimd::Wasm;
+#endif
+    return SwSimd::None;
+}
 
 
 static inline uint32_t _sampleSize(float scale)
@@ -254,7 +352,7 @@ static inline uint32_t _sampleSize(float scale)
 
 //Bilinear Interpolation
 //OPTIMIZE_ME: Skip the function pointer access
-static uint32_t _interpUpScaler(const uint32_t *img, TVG_UNUSED uint32_t stride, uint32_t w, uint32_t h, float sx, float sy, TVG_UNUSED int32_t miny, TVG_UNUSED int32_t maxy, TVG_UNUSED int32_t n)
+static uint32_t _interpUpScaler(const uint32_t *img, uint32_t stride, uint32_t w, uint32_t h, float sx, float sy, TVG_UNUSED int32_t miny, TVG_UNUSED int32_t maxy, TVG_UNUSED int32_t n)
 {
     auto rx = (size_t)(sx);
     auto ry = (size_t)(sy);
@@ -266,10 +364,10 @@ static uint32_t _interpUpScaler(const uint32_t *img, TVG_UNUSED uint32_t stride,
     auto dx = (sx > 0.0f) ? static_cast<uint8_t>((sx - rx) * 255.0f) : 0;
     auto dy = (sy > 0.0f) ? static_cast<uint8_t>((sy - ry) * 255.0f) : 0;
 
-    auto c1 = img[rx + ry * w];
-    auto c2 = img[rx2 + ry * w];
-    auto c3 = img[rx + ry2 * w];
-    auto c4 = img[rx2 + ry2 * w];
+    auto c1 = img[rx + ry * stride];
+    auto c2 = img[rx2 + ry * stride];
+    auto c3 = img[rx + ry2 * stride];
+    auto c4 = img[rx2 + ry2 * stride];
 
     return INTERPOLATE(INTERPOLATE(c4, c3, dx), INTERPOLATE(c2, c1, dx), dy);
 }
@@ -313,6 +411,37 @@ static uint32_t _interpDownScaler(const uint32_t *img, uint32_t stride, uint32_t
 }
 
 
+//Bilinear interpolation of a row, the samples out of the image are transparent
+static void _interpUpScaleRow(const SwImage& image, const Matrix* itransform, float sy, int32_t x, uint32_t len, uint32_t* out)
+{
+    uint32_t i = 0;
+    if (_simd.upScaleRow) i = _simd.upScaleRow(image.buf32, image.stride, image.w, image.h, itransform->e11, itransform->e13, sy, x, len, out);
+    for (; i < len; ++i) {
+        auto sx = (x + static_cast<int32_t>(i)) * itransform->e11 + itransform->e13 - 0.49f;
+        if (sx <= -0.5f || (uint32_t)(sx + 0.5f) >= image.w) out[i] = 0;
+        else out[i] = _interpUpScaler(image.buf32, image.stride, image.w, image.h, sx, sy, 0, 0, 0);
+    }
+}
+
+
+static void _rasterUpScaledRow(uint32_t* dst, const SwImage& image, const Matrix* itransform, float sy, int32_t x, int32_t len, uint8_t a)
+{
+    uint32_t buf[SCALE_CHUNK_SIZE];
+
+    while (len > 0) {
+        auto cnt = std::min(len, SCALE_CHUNK_SIZE);
+        _interpUpScaleRow(image, itransform, sy, x, cnt, buf);
+        for (int32_t i = 0; i < cnt; ++i, ++dst) {
+            auto src = buf[i];
+            if (a < 255) src = ALPHA_BLEND(src, a);
+            *dst = src + ALPHA_BLEND(*dst, IA(src));
+        }
+        x += cnt;
+        len -= cnt;
+    }
+}
+
+
 /************************************************************************/
 /* Rect                                                                 */
 /************************************************************************/
@@ -367,11 +496,11 @@ static bool _rasterMaskedRect(SwSurface* surface, const RenderRegion& bbox, cons
 }
 
 
-static bool _rasterMattedRect(SwSurface* surface, const RenderRegion& bbox, const RenderColor& c)
+template<typename Alpha>
+static bool _rasterMattedRect(SwSurface* surface, const RenderRegion& bbox, const RenderColor& c, Alpha alpha)
 {
     auto csize = surface->compositor->image.channelSize;
     auto cbuffer = surface->compositor->image.buf8 + ((bbox.min.y * surface->compositor->image.stride + bbox.min.x) * csize);   //compositor buffer
-    auto alpha = surface->alpha(surface->compositor->method);
 
     TVGLOG("SW_ENGINE", "Matted(%d) Rect [Region: %u %u %u %u]", (int)surface->compositor->method, bbox.x(), bbox.y(), bbox.w(), bbox.h());
 
@@ -394,7 +523,8 @@ static bool _rasterMattedRect(SwSurface* surface, const RenderRegion& bbox, cons
             auto dst = &buffer[y * surface->stride];
             auto cmp = &cbuffer[y * surface->compositor->image.stride * csize];
             for (uint32_t x = 0; x < bbox.w(); ++x, ++dst, cmp += csize) {
-                *dst = INTERPOLATE8(c.a, *dst, alpha(cmp));
+                auto tmp = MULTIPLY(c.a, alpha(cmp));
+                *dst = tmp + MULTIPLY(*dst, 255 - tmp);
             }
         }
     }
@@ -410,10 +540,7 @@ static bool _rasterBlendingRect(SwSurface* surface, const RenderRegion& bbox, co
     auto buffer = surface->buf32 + (bbox.min.y * surface->stride) + bbox.min.x;
 
     for (uint32_t y = 0; y < bbox.h(); ++y) {
-        auto dst = &buffer[y * surface->stride];
-        for (uint32_t x = 0; x < bbox.w(); ++x, ++dst) {
-            *dst = surface->blender(color, *dst);
-        }
+        surface->colorBlender(&buffer[y * surface->stride], color, bbox.w(), 255);
     }
     return true;
 }
@@ -421,13 +548,7 @@ static bool _rasterBlendingRect(SwSurface* surface, const RenderRegion& bbox, co
 
 static bool _rasterTranslucentRect(SwSurface* surface, const RenderRegion& bbox, const RenderColor& c)
 {
-#if defined(THORVG_AVX_VECTOR_SUPPORT)
-    return avxRasterTranslucentRect(surface, bbox, c);
-#elif defined(THORVG_NEON_VECTOR_SUPPORT)
-    return neonRasterTranslucentRect(surface, bbox, c);
-#else
-    return cRasterTranslucentRect(surface, bbox, c);
-#endif
+    return _simd.translucentRect(surface, bbox, c);
 }
 
 
@@ -456,7 +577,7 @@ static bool _rasterSolidRect(SwSurface* surface, const RenderRegion& bbox, const
 static bool _rasterRect(SwSurface* surface, const RenderRegion& bbox, const RenderColor& c)
 {
     if (_compositing(surface)) {
-        if (_matting(surface)) return _rasterMattedRect(surface, bbox, c);
+        if (_matting(surface)) return _matte(surface, [&](auto alpha) { return _rasterMattedRect(surface, bbox, c, alpha); });
         else return _rasterMaskedRect(surface, bbox, c);
     } else if (_blending(surface)) {
         return _rasterBlendingRect(surface, bbox, c);
@@ -531,13 +652,13 @@ static bool _rasterMaskedRle(SwSurface* surface, SwRle* rle, const RenderRegion&
 }
 
 
-static bool _rasterMattedRle(SwSurface* surface, SwRle* rle, const RenderRegion& bbox, const RenderColor& c)
+template<typename Alpha>
+static bool _rasterMattedRle(SwSurface* surface, SwRle* rle, const RenderRegion& bbox, const RenderColor& c, Alpha alpha)
 {
     TVGLOG("SW_ENGINE", "Matted(%d) Rle", (int)surface->compositor->method);
 
     auto cbuffer = surface->compositor->image.buf8;
     auto csize = surface->compositor->image.channelSize;
-    auto alpha = surface->alpha(surface->compositor->method);
     const SwSpan* end;
     int32_t x, len;
 
@@ -566,7 +687,8 @@ static bool _rasterMattedRle(SwSurface* surface, SwRle* rle, const RenderRegion&
             if (span->coverage == 255) src = c.a;
             else src = MULTIPLY(c.a, span->coverage);
             for (auto x = 0; x < len; ++x, ++dst, cmp += csize) {
-                *dst = INTERPOLATE8(src, *dst, alpha(cmp));
+                auto tmp = MULTIPLY(src, alpha(cmp));
+                *dst = tmp + MULTIPLY(*dst, 255 - tmp);
             }
         }
     }
@@ -584,16 +706,7 @@ static bool _rasterBlendingRle(SwSurface* surface, const SwRle* rle, const Rende
 
     for (auto span = rle->fetch(bbox, &end); span < end; ++span) {
         if (!span->fetch(bbox, x, len)) continue;
-        auto dst = &surface->buf32[span->y * surface->stride + x];
-        if (span->coverage == 255) {
-            for (auto x = 0; x < len; ++x, ++dst) {
-                *dst = surface->blender(color, *dst);
-            }
-        } else {
-            for (auto x = 0; x < len; ++x, ++dst) {
-                *dst = INTERPOLATE(surface->blender(color, *dst), *dst, span->coverage);
-            }
-        }
+        surface->colorBlender(&surface->buf32[span->y * surface->stride + x], color, len, span->coverage);
     }
     return true;
 }
@@ -601,13 +714,7 @@ static bool _rasterBlendingRle(SwSurface* surface, const SwRle* rle, const Rende
 
 static bool _rasterTranslucentRle(SwSurface* surface, const SwRle* rle, const RenderRegion& bbox, const RenderColor& c)
 {
-#if defined(THORVG_AVX_VECTOR_SUPPORT)
-    return avxRasterTranslucentRle(surface, rle, bbox, c);
-#elif defined(THORVG_NEON_VECTOR_SUPPORT)
-    return neonRasterTranslucentRle(surface, rle, bbox, c);
-#else
-    return cRasterTranslucentRle(surface, rle, bbox, c);
-#endif
+    return _simd.translucentRle(surface, rle, bbox, c);
 }
 
 
@@ -654,7 +761,7 @@ static bool _rasterRle(SwSurface* surface, SwRle* rle, const RenderRegion& bbox,
     if (!rle || rle->invalid()) return false;
 
     if (_compositing(surface)) {
-        if (_matting(surface)) return _rasterMattedRle(surface, rle, bbox, c);
+        if (_matting(surface)) return _matte(surface, [&](auto alpha) { return _rasterMattedRle(surface, rle, bbox, c, alpha); });
         else return _rasterMaskedRle(surface, rle, bbox, c);
     } else if (_blending(surface)) {
         return _rasterBlendingRle(surface, rle, bbox, c);
@@ -666,6 +773,126 @@ static bool _rasterRle(SwSurface* surface, SwRle* rle, const RenderRegion& bbox,
 }
 
 
+/************************************************************************/
+/* Tiles                                                                */
+/************************************************************************/
+
+//the fills are drawn as the rectangles, and the tile rows with their coverages
+template<typename Rect, typename Row>
+static void _fetchTiles(const SwTiles* tiles, const RenderRegion& bbox, Rect rect, Row row)
+{
+    const SwTileFill* fend;
+    for (auto p = SwTiles::fetch(tiles->fills, bbox, &fend); p < fend; ++p) {
+        auto region = RenderRegion::intersect({{p->x, p->y}, {p->x + p->len, p->y + SW_TILE_H}}, bbox);
+        if (region.valid()) rect(region);
+    }
+
+    const SwTile* tend;
+    for (auto p = SwTiles::fetch(tiles->tiles, bbox, &tend); p < tend; ++p) {
+        auto x1 = std::max(p->x, bbox.min.x);
+        auto x2 = std::min(p->x + SW_TILE_W, bbox.max.x);
+        if (x1 >= x2) continue;
+        auto y2 = std::min(p->y + SW_TILE_H, bbox.max.y);
+        for (auto y = std::max(p->y, bbox.min.y); y < y2; ++y) {
+            row(y, x1, &p->coverage[y - p->y][x1 - p->x], x2 - x1);
+        }
+    }
+}
+
+
+static bool _rasterBlendingTiles(SwSurface* surface, const SwTiles* tiles, const RenderRegion& bbox, const RenderColor& c)
+{
+    if (surface->channelSize != sizeof(uint32_t)) return false;
+
+    auto color = surface->join(c.r, c.g, c.b, c.a);
+
+    auto rect = [&](const RenderRegion& region) { _rasterBlendingRect(surface, region, c); };
+    _fetchTiles(tiles, bbox, rect, [&](int32_t y, int32_t x, const uint8_t* cov, int32_t len) {
+        auto dst = &surface->buf32[y * surface->stride + x];
+        //the runs of the same coverage
+        for (int32_t i = 0, j; i < len; i = j) {
+            for (j = i + 1; j < len && cov[j] == cov[i]; ++j);
+            if (cov[i] > 0) surface->colorBlender(dst + i, color, j - i, cov[i]);
+        }
+    });
+    return true;
+}
+
+
+static bool _rasterTranslucentTiles(SwSurface* surface, const SwTiles* tiles, const RenderRegion& bbox, const RenderColor& c)
+{
+    auto rect = [&](const RenderRegion& region) { _rasterTranslucentRect(surface, region, c); };
+
+    //32bit channels
+    if (surface->channelSize == sizeof(uint32_t)) {
+        auto color = surface->join(c.r, c.g, c.b, c.a);
+        _fetchTiles(tiles, bbox, rect, [&](int32_t y, int32_t x, const uint8_t* cov, int32_t len) {
+            auto dst = &surface->buf32[y * surface->stride + x];
+            for (auto i = 0; i < len; ++i, ++dst) {
+                if (cov[i] == 0) continue;
+                auto src = (cov[i] < 255) ? ALPHA_BLEND(color, cov[i]) : color;
+                *dst = src + ALPHA_BLEND(*dst, IA(src));
+            }
+        });
+    //8bit grayscale
+    } else if (surface->channelSize == sizeof(uint8_t)) {
+        _fetchTiles(tiles, bbox, rect, [&](int32_t y, int32_t x, const uint8_t* cov, int32_t len) {
+            auto dst = &surface->buf8[y * surface->stride + x];
+            for (auto i = 0; i < len; ++i, ++dst) {
+                if (cov[i] == 0) continue;
+                uint8_t src = (cov[i] < 255) ? MULTIPLY(cov[i], c.a) : c.a;
+                *dst = src + MULTIPLY(*dst, ~src);
+            }
+        });
+    }
+    return true;
+}
+
+
+static bool _rasterSolidTiles(SwSurface* surface, const SwTiles* tiles, const RenderRegion& bbox, const RenderColor& c)
+{
+    auto rect = [&](const RenderRegion& region) { _rasterSolidRect(surface, region, c); };
+
+    //32bit channels
+    if (surface->channelSize == sizeof(uint32_t)) {
+        auto color = surface->join(c.r, c.g, c.b, 255);
+        _fetchTiles(tiles, bbox, rect, [&](int32_t y, int32_t x, const uint8_t* cov, int32_t len) {
+            auto dst = &surface->buf32[y * surface->stride + x];
+            for (auto i = 0; i < len; ++i, ++dst) {
+                if (cov[i] == 255) *dst = color;
+                else if (cov[i] > 0) *dst = ALPHA_BLEND(color, cov[i]) + ALPHA_BLEND(*dst, 255 - cov[i]);
+            }
+        });
+    //8bit grayscale
+    } else if (surface->channelSize == sizeof(uint8_t)) {
+        _fetchTiles(tiles, bbox, rect, [&](int32_t y, int32_t x, const uint8_t* cov, int32_t len) {
+            auto dst = &surface->buf8[y * surface->stride + x];
+            for (auto i = 0; i < len; ++i, ++dst) {
+                if (cov[i] > 0) *dst = cov[i] + MULTIPLY(*dst, 255 - cov[i]);
+            }
+        });
+    }
+    return true;
+}
+
+
+static bool _rasterTiles(SwSurface* surface, const SwTiles* tiles, const RenderRegion& bbox, const RenderColor& c)
+{
+    //the compositions are done with the spans of the tiles
+    if (_compositing(surface)) {
+        SwRle rle;
+        rleRender(&rle, tiles);
+        return _rasterRle(surface, &rle, bbox, c);
+    } else if (_blending(surface)) {
+        return _rasterBlendingTiles(surface, tiles, bbox, c);
+    } else {
+        if (c.a == 255) return _rasterSolidTiles(surface, tiles, bbox, c);
+        else return _rasterTranslucentTiles(surface, tiles, bbox, c);
+    }
+    return false;
+}
+
+
 /************************************************************************/
 /* RLE Scaled Image                                                     */
 /************************************************************************/
@@ -692,22 +919,26 @@ static bool _rasterScaledMaskedRleImage(SwSurface* surface, const SwImage& image
 }
 
 
-static bool _rasterScaledMattedRleImage(SwSurface* surface, const SwImage& image, const Matrix* itransform, const RenderRegion& bbox, uint8_t opacity)
+template<typename Alpha>
+static bool _rasterScaledMattedRleImage(SwSurface* surface, const SwImage& image, const Matrix* itransform, const RenderRegion& bbox, uint8_t opacity, Alpha alpha)
 {
     TVGLOG("SW_ENGINE", "Scaled Matted(%d) Rle Image", (int)surface->compositor->method);
 
     auto csize = surface->compositor->image.channelSize;
-    auto alpha = surface->alpha(surface->compositor->method);
     auto scaleMethod = image.scale < DOWN_SCALE_TOLERANCE ? _interpDownScaler : _interpUpScaler;
     auto sampleSize = _sampleSize(image.scale);
     int32_t miny = 0, maxy = 0;
 
-    ARRAY_FOREACH(span, image.rle->spans) {
+    const SwSpan* end;
+    int32_t minx, len;
+
+    for (auto span = image.rle->fetch(bbox, &end); span < end; ++span) {
+        if (!span->fetch(bbox, minx, len)) continue;
         SCALED_IMAGE_RANGE_Y(span->y)
-        auto dst = &surface->buf32[span->y * surface->stride + span->x];
-        auto cmp = &surface->compositor->image.buf8[(span->y * surface->compositor->image.stride + span->x) * csize];
+        auto dst = &surface->buf32[span->y * surface->stride + minx];
+        auto cmp = &surface->compositor->image.buf8[(span->y * surface->compositor->image.stride + minx) * csize];
         auto a = MULTIPLY(span->coverage, opacity);
-        for (uint32_t x = static_cast<uint32_t>(span->x); x < static_cast<uint32_t>(span->x) + span->len; ++x, ++dst, cmp += csize) {
+        for (auto x = minx; x < minx + len; ++x, ++dst, cmp += csize) {
             SCALED_IMAGE_RANGE_X
             auto src = scaleMethod(image.buf32, image.stride, image.w, image.h, sx, sy, miny, maxy, sampleSize);
             src = ALPHA_BLEND(src, (a == 255) ? alpha(cmp) : MULTIPLY(alpha(cmp), a));
@@ -724,18 +955,22 @@ static bool _rasterScaledBlendingRleImage(SwSurface* surface, const SwImage& ima
     auto sampleSize = _sampleSize(image.scale);
     int32_t miny = 0, maxy = 0;
 
-    ARRAY_FOREACH(span, image.rle->spans) {
+    const SwSpan* end;
+    int32_t minx, len;
+
+    for (auto span = image.rle->fetch(bbox, &end); span < end; ++span) {
+        if (!span->fetch(bbox, minx, len)) continue;
         SCALED_IMAGE_RANGE_Y(span->y)
-        auto dst = &surface->buf32[span->y * surface->stride + span->x];
+        auto dst = &surface->buf32[span->y * surface->stride + minx];
         auto alpha = MULTIPLY(span->coverage, opacity);
         if (alpha == 255) {
-            for (uint32_t x = static_cast<uint32_t>(span->x); x < static_cast<uint32_t>(span->x) + span->len; ++x, ++dst) {
+            for (auto x = minx; x < minx + len; ++x, ++dst) {
                 SCALED_IMAGE_RANGE_X
                 auto src = scaleMethod(image.buf32, image.stride, image.w, image.h, sx, sy, miny, maxy, sampleSize);
                 *dst = INTERPOLATE(surface->blender(rasterUnpremultiply(src), *dst), *dst, A(src));
             }
         } else {
-            for (uint32_t x = static_cast<uint32_t>(span->x); x < static_cast<uint32_t>(span->x) + span->len; ++x, ++dst) {
+            for (auto x = minx; x < minx + len; ++x, ++dst) {
                 SCALED_IMAGE_RANGE_X
                 auto src = scaleMethod(image.buf32, image.stride, image.w, image.h, sx, sy, miny, maxy, sampleSize);
                 *dst = INTERPOLATE(surface->blender(rasterUnpremultiply(src), *dst), *dst, MULTIPLY(alpha, A(src)));
@@ -752,11 +987,19 @@ static bool _rasterScaledRleImage(SwSurface* surface, const SwImage& image, cons
     auto sampleSize = _sampleSize(image.scale);
     int32_t miny = 0, maxy = 0;
 
-    ARRAY_FOREACH(span, image.rle->spans) {
+    const SwSpan* end;
+    int32_t minx, len;
+
+    for (auto span = image.rle->fetch(bbox, &end); span < end; ++span) {
+        if (!span->fetch(bbox, minx, len)) continue;
         SCALED_IMAGE_RANGE_Y(span->y)
-        auto dst = &surface->buf32[span->y * surface->stride + span->x];
+        auto dst = &surface->buf32[span->y * surface->stride + minx];
         auto alpha = MULTIPLY(span->coverage, opacity);
-        for (uint32_t x = static_cast<uint32_t>(span->x); x < static_cast<uint32_t>(span->x) + span->len; ++x, ++dst) {
+        if (scaleMethod == _interpUpScaler) {
+            _rasterUpScaledRow(dst, image, itransform, sy, minx, len, alpha);
+            continue;
+        }
+        for (auto x = minx; x < minx + len; ++x, ++dst) {
             SCALED_IMAGE_RANGE_X
             auto src = scaleMethod(image.buf32, image.stride, image.w, image.h, sx, sy, miny, maxy, sampleSize);
             if (alpha < 255) src = ALPHA_BLEND(src, alpha);
@@ -767,17 +1010,146 @@ static bool _rasterScaledRleImage(SwSurface* surface, const SwImage& image, cons
 }
 
 
+/************************************************************************/
+/* RLE Transformed Image                                                */
+/************************************************************************/
+
+//the inversely transformed samples of a row. the anti-aliased rle covers the image edges, the border pixels are taken for the positions out of the image
+static void _transformedRow(const SwImage& image, const Matrix* itransform, int32_t x, int32_t y, int32_t len, uint32_t* out)
+{
+    auto sx = x * itransform->e11 + y * itransform->e12 + itransform->e13 - 0.49f;
+    auto sy = x * itransform->e21 + y * itransform->e22 + itransform->e23 - 0.49f;
+    auto w = int32_t(image.w);
+    auto h = int32_t(image.h);
+
+    if (image.scale < DOWN_SCALE_TOLERANCE) {
+        auto n = int32_t(_sampleSize(image.scale));
+        for (int32_t i = 0; i < len; ++i, sx += itransform->e11, sy += itransform->e21) {
+            auto cx = tvg::clamp(sx, 0.0f, float(w - 1));
+            auto my = (int32_t)nearbyint(tvg::clamp(sy, 0.0f, float(h - 1)));
+            out[i] = _interpDownScaler(image.buf32, image.stride, image.w, image.h, cx, 0.0f, std::max(my - n, 0), std::min(my + n, h), n);
+        }
+        return;
+    }
+
+    //bilinear interpolation stepping in 16.16 fixed point
+    auto u = int32_t(sx * 65536.0f);
+    auto v = int32_t(sy * 65536.0f);
+    auto du = int32_t(itransform->e11 * 65536.0f);
+    auto dv = int32_t(itransform->e21 * 65536.0f);
+    auto umax = (w - 1) << 16;
+    auto vmax = (h - 1) << 16;
+
+    for (int32_t i = 0; i < len; ++i, u += du, v += dv) {
+        auto cu = tvg::clamp(u, 0, umax);
+        auto cv = tvg::clamp(v, 0, vmax);
+        auto rx = cu >> 16;
+        auto ry = cv >> 16;
+        auto rx2 = std::min(rx + 1, w - 1);
+        auto row = image.buf32 + ry * image.stride;
+        auto row2 = image.buf32 + std::min(ry + 1, h - 1) * image.stride;
+        auto dx = uint8_t(((cu & 0xffff) * 255) >> 16);
+        auto dy = uint8_t(((cv & 0xffff) * 255) >> 16);
+        out[i] = INTERPOLATE(INTERPOLATE(row2[rx2], row2[rx], dx), INTERPOLATE(row[rx2], row[rx], dx), dy);
+    }
+}
+
+
+static bool _rasterTransformedMaskedRleImage(SwSurface* surface, const SwImage& image, const Matrix* itransform, const RenderRegion& bbox, uint8_t opacity)
+{
+    TVGERR("SW_ENGINE", "Not Supported Transformed Masked(%d) Rle Image", (int)surface->compositor->method);
+    return false;
+}
+
+
+template<typename Alpha>
+static bool _rasterTransformedMattedRleImage(SwSurface* surface, const SwImage& image, const Matrix* itransform, const RenderRegion& bbox, uint8_t opacity, Alpha alpha)
+{
+    TVGLOG("SW_ENGINE", "Transformed Matted(%d) Rle Image", (int)surface->compositor->method);
+
+    auto csize = surface->compositor->image.channelSize;
+    uint32_t buf[SCALE_CHUNK_SIZE];
+    const SwSpan* end;
+    int32_t x, len;
+
+    for (auto span = image.rle->fetch(bbox, &end); span < end; ++span) {
+        if (!span->fetch(bbox, x, len)) continue;
+        auto dst = &surface->buf32[span->y * surface->stride + x];
+        auto cmp = &surface->compositor->image.buf8[(span->y * surface->compositor->image.stride + x) * csize];
+        auto a = MULTIPLY(span->coverage, opacity);
+        while (len > 0) {
+            auto cnt = std::min(len, SCALE_CHUNK_SIZE);
+            _transformedRow(image, itransform, x, span->y, cnt, buf);
+            for (int32_t i = 0; i < cnt; ++i, ++dst, cmp += csize) {
+                auto src = ALPHA_BLEND(buf[i], (a == 255) ? alpha(cmp) : MULTIPLY(alpha(cmp), a));
+                *dst = src + ALPHA_BLEND(*dst, IA(src));
+            }
+            x += cnt;
+            len -= cnt;
+        }
+    }
+    return true;
+}
+
+
+static bool _rasterTransformedBlendingRleImage(SwSurface* surface, const SwImage& image, const Matrix* itransform, const RenderRegion& bbox, uint8_t opacity)
+{
+    uint32_t buf[SCALE_CHUNK_SIZE];
+    const SwSpan* end;
+    int32_t x, len;
+
+    for (auto span = image.rle->fetch(bbox, &end); span < end; ++span) {
+        if (!span->fetch(bbox, x, len)) continue;
+        auto dst = &surface->buf32[span->y * surface->stride + x];
+        auto alpha = MULTIPLY(span->coverage, opacity);
+        while (len > 0) {
+            auto cnt = std::min(len, SCALE_CHUNK_SIZE);
+            _transformedRow(image, itransform, x, span->y, cnt, buf);
+            for (int32_t i = 0; i < cnt; ++i, ++dst) {
+                *dst = INTERPOLATE(surface->blender(rasterUnpremultiply(buf[i]), *dst), *dst, MULTIPLY(alpha, A(buf[i])));
+            }
+            x += cnt;
+            len -= cnt;
+        }
+    }
+    return true;
+}
+
+
+static bool _rasterTransformedRleImage(SwSurface* surface, const SwImage& image, const Matrix* itransform, const RenderRegion& bbox, uint8_t opacity)
+{
+    uint32_t buf[SCALE_CHUNK_SIZE];
+    const SwSpan* end;
+    int32_t x, len;
+
+    for (auto span = image.rle->fetch(bbox, &end); span < end; ++span) {
+        if (!span->fetch(bbox, x, len)) continue;
+        auto dst = &surface->buf32[span->y * surface->stride + x];
+        auto alpha = MULTIPLY(span->coverage, opacity);
+        while (len > 0) {
+            auto cnt = std::min(len, SCALE_CHUNK_SIZE);
+            _transformedRow(image, itransform, x, span->y, cnt, buf);
+            rasterTranslucentPixel32(dst, buf, cnt, alpha);
+            dst += cnt;
+            x += cnt;
+            len -= cnt;
+        }
+    }
+    return true;
+}
+
+
 /************************************************************************/
 /* RLE Direct Image                                                     */
 /************************************************************************/
 
-static bool _rasterDirectMattedRleImage(SwSurface* surface, const SwImage& image, const RenderRegion& bbox, uint8_t opacity)
+template<typename Alpha>
+static bool _rasterDirectMattedRleImage(SwSurface* surface, const SwImage& image, const RenderRegion& bbox, uint8_t opacity, Alpha alpha)
 {
     TVGLOG("SW_ENGINE", "Direct Matted(%d) Rle Image", (int)surface->compositor->method);
 
     auto csize = surface->compositor->image.channelSize;
     auto cbuffer = surface->compositor->image.buf8;
-    auto alpha = surface->alpha(surface->compositor->method);
     const SwSpan* end;
     int32_t x, len;
 
@@ -812,16 +1184,7 @@ static bool _rasterDirectBlendingRleImage(SwSurface* surface, const SwImage& ima
         if (!span->fetch(bbox, x, len)) continue;
         auto dst = &surface->buf32[span->y * surface->stride + x];
         auto src = image.buf32 + (span->y + image.oy) * image.stride + (x + image.ox);
-        auto alpha = MULTIPLY(span->coverage, opacity);
-        if (alpha == 255) {
-            for (auto x = 0; x < len; ++x, ++dst, ++src) {
-                *dst = surface->blender(rasterUnpremultiply(*src), *dst);
-            }
-        } else {
-            for (auto x = 0; x < len; ++x, ++dst, ++src) {
-                *dst = INTERPOLATE(surface->blender(rasterUnpremultiply(*src), *dst), *dst, MULTIPLY(alpha, A(*src)));
-            }
-        }
+        surface->imageBlender(dst, src, len, MULTIPLY(span->coverage, opacity));
     }
     return true;
 }
@@ -861,7 +1224,8 @@ static bool _rasterScaledMaskedImage(SwSurface* surface, const SwImage& image, c
 }
 
 
-static bool _rasterScaledMattedImage(SwSurface* surface, const SwImage& image, const Matrix* itransform, const RenderRegion& bbox, uint8_t opacity)
+template<typename Alpha>
+static bool _rasterScaledMattedImage(SwSurface* surface, const SwImage& image, const Matrix* itransform, const RenderRegion& bbox, uint8_t opacity, Alpha alpha)
 {
     if (surface->channelSize == sizeof(uint8_t)) {
         TVGERR("SW_ENGINE", "Not supported grayscale scaled matted image!");
@@ -871,7 +1235,6 @@ static bool _rasterScaledMattedImage(SwSurface* surface, const SwImage& image, c
     auto dbuffer = surface->buf32 + (bbox.min.y * surface->stride + bbox.min.x);
     auto csize = surface->compositor->image.channelSize;
     auto cbuffer = surface->compositor->image.buf8 + (bbox.min.y * surface->compositor->image.stride + bbox.min.x) * csize;
-    auto alpha = surface->alpha(surface->compositor->method);
 
     TVGLOG("SW_ENGINE", "Scaled Matted(%d) Image [Region: %d %d %d %d]", (int)surface->compositor->method, bbox.min.x, bbox.min.y, bbox.max.x - bbox.min.x, bbox.max.y - bbox.min.y);
 
@@ -933,6 +1296,10 @@ static bool _rasterScaledImage(SwSurface* surface, const SwImage& image, const M
         for (auto y = bbox.min.y; y < bbox.max.y; ++y, buffer += surface->stride) {
             SCALED_IMAGE_RANGE_Y(y)
             auto dst = buffer;
+            if (scaleMethod == _interpUpScaler) {
+                _rasterUpScaledRow(dst, image, itransform, sy, bbox.min.x, bbox.sw(), opacity);
+                continue;
+            }
             for (auto x = bbox.min.x; x < bbox.max.x; ++x, ++dst) {
                 SCALED_IMAGE_RANGE_X
                 auto src = scaleMethod(image.buf32, image.stride, image.w, image.h, sx, sy, miny, maxy, sampleSize);
@@ -947,8 +1314,8 @@ static bool _rasterScaledImage(SwSurface* surface, const SwImage& image, const M
             auto dst = buffer;
             for (auto x = bbox.min.x; x < bbox.max.x; ++x, ++dst) {
                 SCALED_IMAGE_RANGE_X
-                auto src = scaleMethod(image.buf32, image.stride, image.w, image.h, sx, sy, miny, maxy, sampleSize);
-                *dst = MULTIPLY(A(src), opacity);
+                auto src = MULTIPLY(A(scaleMethod(image.buf32, image.stride, image.w, image.h, sx, sy, miny, maxy, sampleSize)), opacity);
+                *dst = src + MULTIPLY(*dst, 255 - src);
             }
         }
     }
@@ -967,10 +1334,10 @@ static bool _rasterDirectMaskedImage(SwSurface* surface, const SwImage& image, c
 }
 
 
-static bool _rasterDirectMattedImage(SwSurface* surface, const SwImage& image, const RenderRegion& bbox, int32_t w, int32_t h, uint8_t opacity)
+template<typename Alpha>
+static bool _rasterDirectMattedImage(SwSurface* surface, const SwImage& image, const RenderRegion& bbox, int32_t w, int32_t h, uint8_t opacity, Alpha alpha)
 {
     auto csize = surface->compositor->image.channelSize;
-    auto alpha = surface->alpha(surface->compositor->method);
     auto sbuffer = image.buf32 + (bbox.min.y + image.oy) * image.stride + (bbox.min.x + image.ox);
     auto cbuffer = surface->compositor->image.buf8 + (bbox.min.y * surface->compositor->image.stride + bbox.min.x) * csize; //compositor buffer
 
@@ -995,6 +1362,19 @@ static bool _rasterDirectMattedImage(SwSurface* surface, const SwImage& image, c
             }
             cbuffer += surface->compositor->image.stride * csize;
         }
+    //8 bits, from the 8 bits composition of the grayscale target
+    } else if (surface->channelSize == sizeof(uint8_t) && image.channelSize == sizeof(uint8_t)) {
+        auto dbuffer = surface->buf8 + (bbox.min.y * surface->stride) + bbox.min.x;
+        auto sbuffer8 = image.buf8 + (bbox.min.y + image.oy) * image.stride + (bbox.min.x + image.ox);
+        for (auto y = 0; y < h; ++y, dbuffer += surface->stride, sbuffer8 += image.stride) {
+            auto cmp = cbuffer;
+            auto src = sbuffer8;
+            for (auto dst = dbuffer; dst < dbuffer + w; ++dst, ++src, cmp += csize) {
+                auto tmp = MULTIPLY(*src, MULTIPLY(opacity, alpha(cmp)));
+                *dst = tmp + MULTIPLY(*dst, 255 - tmp);
+            }
+            cbuffer += surface->compositor->image.stride * csize;
+        }
     //8 bits
     } else if (surface->channelSize == sizeof(uint8_t)) {
         auto dbuffer = surface->buf8 + (bbox.min.y * surface->stride) + bbox.min.x;
@@ -1030,16 +1410,7 @@ static bool _rasterDirectBlendingImage(SwSurface* surface, const SwImage& image,
     auto sbuffer = image.buf32 + (bbox.min.y + image.oy) * image.stride + (bbox.min.x + image.ox);
 
     for (auto y = 0; y < h; ++y, dbuffer += surface->stride, sbuffer += image.stride) {
-        auto src = sbuffer;
-        if (opacity == 255) {
-            for (auto dst = dbuffer; dst < dbuffer + w; dst++, src++) {
-                *dst = INTERPOLATE(surface->blender(rasterUnpremultiply(*src), *dst), *dst, A(*src));
-            }
-        } else {
-            for (auto dst = dbuffer; dst < dbuffer + w; dst++, src++) {
-                *dst = INTERPOLATE(surface->blender(rasterUnpremultiply(*src), *dst), *dst, MULTIPLY(opacity, A(*src)));
-            }
-        }
+        surface->imageBlender(dbuffer, sbuffer, w, opacity);
     }
     return true;
 }
@@ -1055,6 +1426,17 @@ static bool _rasterDirectImage(SwSurface* surface, const SwImage& image, const R
         for (auto y = 0; y < h; ++y, dbuffer += surface->stride, sbuffer += image.stride) {
             rasterTranslucentPixel32(dbuffer, sbuffer, w, opacity);
         }
+    //8bits grayscale, from the 8 bits composition of the grayscale target
+    } else if (surface->channelSize == sizeof(uint8_t) && image.channelSize == sizeof(uint8_t)) {
+        auto dbuffer = &surface->buf8[bbox.min.y * surface->stride + bbox.min.x];
+        auto sbuffer8 = image.buf8 + (bbox.min.y + image.oy) * image.stride + (bbox.min.x + image.ox);
+        for (auto y = 0; y < h; ++y, dbuffer += surface->stride, sbuffer8 += image.stride) {
+            auto src = sbuffer8;
+            for (auto dst = dbuffer; dst < dbuffer + w; dst++, src++) {
+                auto tmp = MULTIPLY(*src, opacity);
+                *dst = tmp + MULTIPLY(*dst, 255 - tmp);
+            }
+        }
     //8bits grayscale
     } else if (surface->channelSize == sizeof(uint8_t)) {
         auto dbuffer = &surface->buf8[bbox.min.y * surface->stride + bbox.min.x];
@@ -1062,11 +1444,12 @@ static bool _rasterDirectImage(SwSurface* surface, const SwImage& image, const R
             auto src = sbuffer;
             if (opacity == 255) {
                 for (auto dst = dbuffer; dst < dbuffer + w; dst++, src++) {
-                    *dst = *src + MULTIPLY(*dst, IA(*src));
+                    *dst = A(*src) + MULTIPLY(*dst, IA(*src));
                 }
             } else {
                 for (auto dst = dbuffer; dst < dbuffer + w; dst++, src++) {
-                    *dst = INTERPOLATE8(A(*src), *dst, opacity);
+                    auto tmp = MULTIPLY(A(*src), opacity);
+                    *dst = tmp + MULTIPLY(*dst, 255 - tmp);
                 }
             }
         }
@@ -1075,7 +1458,8 @@ static bool _rasterDirectImage(SwSurface* surface, const SwImage& image, const R
 }
 
 
-static bool _rasterDirectMattedBlendingImage(SwSurface* surface, const SwImage& image, const RenderRegion& bbox, int32_t w, int32_t h, uint8_t opacity)
+template<typename Alpha>
+static bool _rasterDirectMattedBlendingImage(SwSurface* surface, const SwImage& image, const RenderRegion& bbox, int32_t w, int32_t h, uint8_t opacity, Alpha alpha)
 {
     if (surface->channelSize == sizeof(uint8_t)) {
         TVGERR("SW_ENGINE", "Not supported grayscale image!");
@@ -1083,7 +1467,6 @@ static bool _rasterDirectMattedBlendingImage(SwSurface* surface, const SwImage&
     }
 
     auto csize = surface->compositor->image.channelSize;
-    auto alpha = surface->alpha(surface->compositor->method);
     auto sbuffer = image.buf32 + (bbox.min.y + image.oy) * image.stride + (bbox.min.x + image.ox);
     auto cbuffer = surface->compositor->image.buf8 + (bbox.min.y * surface->compositor->image.stride + bbox.min.x) * csize; //compositor buffer
     auto dbuffer = surface->buf32 + (bbox.min.y * surface->stride) + bbox.min.x;
@@ -1169,7 +1552,7 @@ static bool _rasterGradientMattedRect(SwSurface* surface, const RenderRegion& bb
     for (uint32_t y = 0; y < bbox.h(); ++y) {
         fillMethod()(fill, buffer, bbox.min.y + y, bbox.min.x, bbox.w(), cbuffer, alpha, csize, 255);
         buffer += surface->stride;
-        cbuffer += surface->stride * csize;
+        cbuffer += surface->compositor->image.stride * csize;
     }
     return true;
 }
@@ -1271,39 +1654,43 @@ static bool _rasterRadialGradientRect(SwSurface* surface, const RenderRegion& bb
 /************************************************************************/
 
 template<typename fillMethod>
-static bool _rasterCompositeGradientMaskedRle(SwSurface* surface, const SwRle* rle, const SwFill* fill, SwMask maskOp)
+static bool _rasterCompositeGradientMaskedRle(SwSurface* surface, const SwRle* rle, const RenderRegion& bbox, const SwFill* fill, SwMask maskOp)
 {
-    auto span = rle->data();
+    const SwSpan* end;
+    int32_t x, len;
     auto cstride = surface->compositor->image.stride;
     auto cbuffer = surface->compositor->image.buf8;
 
-    for (uint32_t i = 0; i < rle->size(); ++i, ++span) {
-        auto cmp = &cbuffer[span->y * cstride + span->x];
-        fillMethod()(fill, cmp, span->y, span->x, span->len, maskOp, span->coverage);
+    for (auto span = rle->fetch(bbox, &end); span < end; ++span) {
+        if (!span->fetch(bbox, x, len)) continue;
+        auto cmp = &cbuffer[span->y * cstride + x];
+        fillMethod()(fill, cmp, span->y, x, len, maskOp, span->coverage);
     }
     return _compositeMaskImage(surface, surface->compositor->image, surface->compositor->bbox);
 }
 
 
 template<typename fillMethod>
-static bool _rasterDirectGradientMaskedRle(SwSurface* surface, const SwRle* rle, const SwFill* fill, SwMask maskOp)
+static bool _rasterDirectGradientMaskedRle(SwSurface* surface, const SwRle* rle, const RenderRegion& bbox, const SwFill* fill, SwMask maskOp)
 {
-    auto span = rle->data();
+    const SwSpan* end;
+    int32_t x, len;
     auto cstride = surface->compositor->image.stride;
     auto cbuffer = surface->compositor->image.buf8;
     auto dbuffer = surface->buf8;
 
-    for (uint32_t i = 0; i < rle->size(); ++i, ++span) {
-        auto cmp = &cbuffer[span->y * cstride + span->x];
-        auto dst = &dbuffer[span->y * surface->stride + span->x];
-        fillMethod()(fill, dst, span->y, span->x, span->len, cmp, maskOp, span->coverage);
+    for (auto span = rle->fetch(bbox, &end); span < end; ++span) {
+        if (!span->fetch(bbox, x, len)) continue;
+        auto cmp = &cbuffer[span->y * cstride + x];
+        auto dst = &dbuffer[span->y * surface->stride + x];
+        fillMethod()(fill, dst, span->y, x, len, cmp, maskOp, span->coverage);
     }
     return true;
 }
 
 
 template<typename fillMethod>
-static bool _rasterGradientMaskedRle(SwSurface* surface, const SwRle* rle, const SwFill* fill)
+static bool _rasterGradientMaskedRle(SwSurface* surface, const SwRle* rle, const RenderRegion& bbox, const SwFill* fill)
 {
     auto method = surface->compositor->method;
 
@@ -1311,61 +1698,68 @@ static bool _rasterGradientMaskedRle(SwSurface* surface, const SwRle* rle, const
 
     auto maskOp = _getMaskOp(method);
 
-    if (_direct(method)) return _rasterDirectGradientMaskedRle<fillMethod>(surface, rle, fill, maskOp);
-    else return _rasterCompositeGradientMaskedRle<fillMethod>(surface, rle, fill, maskOp);
+    if (_direct(method)) return _rasterDirectGradientMaskedRle<fillMethod>(surface, rle, bbox, fill, maskOp);
+    else return _rasterCompositeGradientMaskedRle<fillMethod>(surface, rle, bbox, fill, maskOp);
     return false;
 }
 
 
 template<typename fillMethod>
-static bool _rasterGradientMattedRle(SwSurface* surface, const SwRle* rle, const SwFill* fill)
+static bool _rasterGradientMattedRle(SwSurface* surface, const SwRle* rle, const RenderRegion& bbox, const SwFill* fill)
 {
     TVGLOG("SW_ENGINE", "Matted(%d) Rle Linear Gradient", (int)surface->compositor->method);
 
-    auto span = rle->data();
+    const SwSpan* end;
+    int32_t x, len;
     auto csize = surface->compositor->image.channelSize;
     auto cbuffer = surface->compositor->image.buf8;
     auto alpha = surface->alpha(surface->compositor->method);
 
-    for (uint32_t i = 0; i < rle->size(); ++i, ++span) {
-        auto dst = &surface->buf32[span->y * surface->stride + span->x];
-        auto cmp = &cbuffer[(span->y * surface->compositor->image.stride + span->x) * csize];
-        fillMethod()(fill, dst, span->y, span->x, span->len, cmp, alpha, csize, span->coverage);
+    for (auto span = rle->fetch(bbox, &end); span < end; ++span) {
+        if (!span->fetch(bbox, x, len)) continue;
+        auto dst = &surface->buf32[span->y * surface->stride + x];
+        auto cmp = &cbuffer[(span->y * surface->compositor->image.stride + x) * csize];
+        fillMethod()(fill, dst, span->y, x, len, cmp, alpha, csize, span->coverage);
     }
     return true;
 }
 
 
 template<typename fillMethod>
-static bool _rasterBlendingGradientRle(SwSurface* surface, const SwRle* rle, const SwFill* fill)
+static bool _rasterBlendingGradientRle(SwSurface* surface, const SwRle* rle, const RenderRegion& bbox, const SwFill* fill)
 {
-    auto span = rle->data();
+    const SwSpan* end;
+    int32_t x, len;
 
-    for (uint32_t i = 0; i < rle->size(); ++i, ++span) {
-        auto dst = &surface->buf32[span->y * surface->stride + span->x];
-        fillMethod()(fill, dst, span->y, span->x, span->len, opBlendPreNormal, surface->blender, span->coverage);
+    for (auto span = rle->fetch(bbox, &end); span < end; ++span) {
+        if (!span->fetch(bbox, x, len)) continue;
+        auto dst = &surface->buf32[span->y * surface->stride + x];
+        fillMethod()(fill, dst, span->y, x, len, opBlendPreNormal, surface->blender, span->coverage);
     }
     return true;
 }
 
 
 template<typename fillMethod>
-static bool _rasterTranslucentGradientRle(SwSurface* surface, const SwRle* rle, const SwFill* fill)
+static bool _rasterTranslucentGradientRle(SwSurface* surface, const SwRle* rle, const RenderRegion& bbox, const SwFill* fill)
 {
-    auto span = rle->data();
+    const SwSpan* end;
+    int32_t x, len;
 
     //32 bits
     if (surface->channelSize == sizeof(uint32_t)) {
-        for (uint32_t i = 0; i < rle->size(); ++i, ++span) {
-            auto dst = &surface->buf32[span->y * surface->stride + span->x];
-            if (span->coverage == 255) fillMethod()(fill, dst, span->y, span->x, span->len, opBlendPreNormal, 255);
-            else fillMethod()(fill, dst, span->y, span->x, span->len, opBlendNormal, span->coverage);
+        for (auto span = rle->fetch(bbox, &end); span < end; ++span) {
+            if (!span->fetch(bbox, x, len)) continue;
+            auto dst = &surface->buf32[span->y * surface->stride + x];
+            if (span->coverage == 255) fillMethod()(fill, dst, span->y, x, len, opBlendPreNormal, 255);
+            else fillMethod()(fill, dst, span->y, x, len, opBlendNormal, span->coverage);
         }
     //8 bits
     } else if (surface->channelSize == sizeof(uint8_t)) {
-        for (uint32_t i = 0; i < rle->size(); ++i, ++span) {
-            auto dst = &surface->buf8[span->y * surface->stride + span->x];
-            fillMethod()(fill, dst, span->y, span->x, span->len, _opMaskAdd, span->coverage);
+        for (auto span = rle->fetch(bbox, &end); span < end; ++span) {
+            if (!span->fetch(bbox, x, len)) continue;
+            auto dst = &surface->buf8[span->y * surface->stride + x];
+            fillMethod()(fill, dst, span->y, x, len, _opMaskAdd, span->coverage);
         }
     }
     return true;
@@ -1373,23 +1767,26 @@ static bool _rasterTranslucentGradientRle(SwSurface* surface, const SwRle* rle,
 
 
 template<typename fillMethod>
-static bool _rasterSolidGradientRle(SwSurface* surface, const SwRle* rle, const SwFill* fill)
+static bool _rasterSolidGradientRle(SwSurface* surface, const SwRle* rle, const RenderRegion& bbox, const SwFill* fill)
 {
-    auto span = rle->data();
+    const SwSpan* end;
+    int32_t x, len;
 
     //32 bits
     if (surface->channelSize == sizeof(uint32_t)) {
-        for (uint32_t i = 0; i < rle->size(); ++i, ++span) {
-            auto dst = &surface->buf32[span->y * surface->stride + span->x];
-            if (span->coverage == 255) fillMethod()(fill, dst, span->y, span->x, span->len, opBlendSrcOver, 255);
-            else fillMethod()(fill, dst, span->y, span->x, span->len, opBlendInterp, span->coverage);
+        for (auto span = rle->fetch(bbox, &end); span < end; ++span) {
+            if (!span->fetch(bbox, x, len)) continue;
+            auto dst = &surface->buf32[span->y * surface->stride + x];
+            if (span->coverage == 255) fillMethod()(fill, dst, span->y, x, len, opBlendSrcOver, 255);
+            else fillMethod()(fill, dst, span->y, x, len, opBlendInterp, span->coverage);
         }
     //8 bits
     } else if (surface->channelSize == sizeof(uint8_t)) {
-        for (uint32_t i = 0; i < rle->size(); ++i, ++span) {
-            auto dst = &surface->buf8[span->y * surface->stride + span->x];
-            if (span->coverage == 255) fillMethod()(fill, dst, span->y, span->x, span->len, _opMaskNone, 255);
-            else fillMethod()(fill, dst, span->y, span->x, span->len, _opMaskAdd, span->coverage);
+        for (auto span = rle->fetch(bbox, &end); span < end; ++span) {
+            if (!span->fetch(bbox, x, len)) continue;
+            auto dst = &surface->buf8[span->y * surface->stride + x];
+            if (span->coverage == 255) fillMethod()(fill, dst, span->y, x, len, _opMaskNone, 255);
+            else fillMethod()(fill, dst, span->y, x, len, _opMaskAdd, span->coverage);
         }
     }
 
@@ -1397,31 +1794,31 @@ static bool _rasterSolidGradientRle(SwSurface* surface, const SwRle* rle, const
 }
 
 
-static bool _rasterLinearGradientRle(SwSurface* surface, const SwRle* rle, const SwFill* fill)
+static bool _rasterLinearGradientRle(SwSurface* surface, const SwRle* rle, const RenderRegion& bbox, const SwFill* fill)
 {
     if (_compositing(surface)) {
-        if (_matting(surface)) return _rasterGradientMattedRle<FillLinear>(surface, rle, fill);
-        else return _rasterGradientMaskedRle<FillLinear>(surface, rle, fill);
+        if (_matting(surface)) return _rasterGradientMattedRle<FillLinear>(surface, rle, bbox, fill);
+        else return _rasterGradientMaskedRle<FillLinear>(surface, rle, bbox, fill);
     } else if (_blending(surface)) {
-        return _rasterBlendingGradientRle<FillLinear>(surface, rle, fill);
+        return _rasterBlendingGradientRle<FillLinear>(surface, rle, bbox, fill);
     } else {
-        if (fill->translucent) return _rasterTranslucentGradientRle<FillLinear>(surface, rle, fill);
-        else return _rasterSolidGradientRle<FillLinear>(surface, rle, fill);
+        if (fill->translucent) return _rasterTranslucentGradientRle<FillLinear>(surface, rle, bbox, fill);
+        else return _rasterSolidGradientRle<FillLinear>(surface, rle, bbox, fill);
     }
     return false;
 }
 
 
-static bool _rasterRadialGradientRle(SwSurface* surface, const SwRle* rle, const SwFill* fill)
+static bool _rasterRadialGradientRle(SwSurface* surface, const SwRle* rle, const RenderRegion& bbox, const SwFill* fill)
 {
     if (_compositing(surface)) {
-        if (_matting(surface)) return _rasterGradientMattedRle<FillRadial>(surface, rle, fill);
-        else return _rasterGradientMaskedRle<FillRadial>(surface, rle, fill);
+        if (_matting(surface)) return _rasterGradientMattedRle<FillRadial>(surface, rle, bbox, fill);
+        else return _rasterGradientMaskedRle<FillRadial>(surface, rle, bbox, fill);
     } else if (_blending(surface)) {
-        return _rasterBlendingGradientRle<FillRadial>(surface, rle, fill);
+        return _rasterBlendingGradientRle<FillRadial>(surface, rle, bbox, fill);
     } else {
-        if (fill->translucent) return _rasterTranslucentGradientRle<FillRadial>(surface, rle, fill);
-        else return _rasterSolidGradientRle<FillRadial>(surface, rle, fill);
+        if (fill->translucent) return _rasterTranslucentGradientRle<FillRadial>(surface, rle, bbox, fill);
+        else return _rasterSolidGradientRle<FillRadial>(surface, rle, bbox, fill);
     }
     return false;
 }
@@ -1447,25 +1844,130 @@ void rasterPixel32(uint32_t* dst, uint32_t* src, uint32_t len, uint8_t opacity)
 
 void rasterGrayscale8(uint8_t *dst, uint8_t val, uint32_t offset, int32_t len)
 {
-#if defined(THORVG_AVX_VECTOR_SUPPORT)
-    avxRasterGrayscale8(dst, val, offset, len);
-#elif defined(THORVG_NEON_VECTOR_SUPPORT)
-    neonRasterGrayscale8(dst, val, offset, len);
-#else
-    cRasterPixels(dst, val, offset, len);
-#endif
+    _simd.grayscale8(dst, val, offset, len);
 }
 
 
 void rasterPixel32(uint32_t *dst, uint32_t val, uint32_t offset, int32_t len)
 {
+    _simd.pixel32(dst, val, offset, len);
+}
+
+
+void rasterInit()
+{
+    auto simd = _simdSupport();
+
 #if defined(THORVG_AVX_VECTOR_SUPPORT)
-    avxRasterPixel32(dst, val, offset, len);
+    if (simd == SwSimd::Avx) {
+        _simd.translucentRect = avxRasterTranslucentRect;
+        _simd.translucentRle = avxRasterTranslucentRle;
+        _simd.grayscale8 = avxRasterGrayscale8;
+        _simd.pixel32 = avxRasterPixel32;
+        _simd.upScaleRow = avxInterpUpScaleRow;
+        _simd.blender = avxRasterBlender;
+        _simd.premultiply = avxRasterPremultiply;
+        _simd.unpremultiply = avxRasterUnpremultiply;
+        _simd.swapRB = avxRasterSwapRB;
+    }
 #elif defined(THORVG_NEON_VECTOR_SUPPORT)
-    neonRasterPixel32(dst, val, offset, len);
-#else
-    cRasterPixels(dst, val, offset, len);
+    if (simd == SwSimd::Neon) {
+        _simd.translucentRect = neonRasterTranslucentRect;
+        _simd.translucentRle = neonRasterTranslucentRle;
+        _simd.grayscale8 = neonRasterGrayscale8;
+        _simd.pixel32 = neonRasterPixel32;
+        _simd.upScaleRow = neonInterpUpScaleRow;
+        _simd.premultiply = neonRasterPremultiply;
+        _simd.unpremultiply = neonRasterUnpremultiply;
+        _simd.swapRB = neonRasterSwapRB;
+    }
+#elif defined(THORVG_WASM_VECTOR_SUPPORT)
+    if (simd == SwSimd::Wasm) {
+        _simd.translucentRect = wasmRasterTranslucentRect;
+        _simd.translucentRle = wasmRasterTranslucentRle;
+        _simd.grayscale8 = wasmRasterGrayscale8;
+        _simd.pixel32 = wasmRasterPixel32;
+        _simd.swapRB = wasmRasterSwapRB;
+    }
 #endif
+
+    fillInit(simd);
+}
+
+
+void rasterBlender(SwSurface* surface, BlendMethod method)
+{
+    //the single channel has the coverage only, it's composed same as the normal
+    if (surface->channelSize == sizeof(uint8_t)) method = BlendMethod::Normal;
+
+    switch (method) {
+        case BlendMethod::Normal:
+        case BlendMethod::Composition:
+            surface->blender = nullptr;
+            surface->colorBlender = nullptr;
+            surface->imageBlender = nullptr;
+            return;
+        case BlendMethod::Multiply:
+            _blender<opBlendMultiply>(surface);
+            break;
+        case BlendMethod::Screen:
+            _blender<opBlendScreen>(surface);
+            break;
+        case BlendMethod::Overlay:
+            _blender<opBlendOverlay>(surface);
+            break;
+        case BlendMethod::Darken:
+            _blender<opBlendDarken>(surface);
+            break;
+        case BlendMethod::Lighten:
+            _blender<opBlendLighten>(surface);
+            break;
+        case BlendMethod::ColorDodge:
+            _blender<opBlendColorDodge>(surface);
+            break;
+        case BlendMethod::ColorBurn:
+            _blender<opBlendColorBurn>(surface);
+            break;
+        case BlendMethod::HardLight:
+            _blender<opBlendHardLight>(surface);
+            break;
+        case BlendMethod::SoftLight:
+            _blender<opBlendSoftLight>(surface);
+            break;
+        case BlendMethod::Difference:
+            _blender<opBlendDifference>(surface);
+            break;
+        case BlendMethod::Exclusion:
+            _blender<opBlendExclusion>(surface);
+            break;
+        case BlendMethod::Hue:
+            _blender<opBlendHue>(surface);
+            break;
+        case BlendMethod::Saturation:
+            _blender<opBlendSaturation>(surface);
+            break;
+        case BlendMethod::Color:
+            _blender<opBlendColor>(surface);
+            break;
+        case BlendMethod::Luminosity:
+            _blender<opBlendLuminosity>(surface);
+            break;
+        case BlendMethod::Add:
+            _blender<opBlendAdd>(surface);
+            break;
+        case BlendMethod::HardMix:
+            _blender<opBlendHardMix>(surface);
+            break;
+        default:
+            TVGLOG("SW_ENGINE", "Non supported blending option = %d", (int) method);
+            surface->blender = nullptr;
+            surface->colorBlender = nullptr;
+            surface->imageBlender = nullptr;
+            return;
+    }
+
+    //replace the span blenders with the vectorized ones if any
+    if (_simd.blender) _simd.blender(surface, method);
 }
 
 
@@ -1483,6 +1985,11 @@ bool rasterCompositor(SwSurface* surface)
         surface->join = _argbJoin;
         surface->alphas[2] = _argbLuma;
         surface->alphas[3] = _argbInvLuma;
+    //the single channel target, its luma masks are drawn in ARGB8888
+    } else if (surface->cs == ColorSpace::Grayscale8) {
+        surface->join = _argbJoin;
+        surface->alphas[2] = _argbLuma;
+        surface->alphas[3] = _argbInvLuma;
     } else {
         TVGERR("SW_ENGINE", "Unsupported Colorspace(%d) is expected!", (int)surface->cs);
         return false;
@@ -1500,7 +2007,7 @@ bool rasterClear(SwSurface* surface, uint32_t x, uint32_t y, uint32_t w, uint32_
         uint32_t val = 0;
         //full clear
         if (w == surface->stride) {
-            rasterPixel32(surface->buf32, val, surface->stride * y, w * h);
+            rasterPixel32(surface->buf32, val, surface->stride * y + x, w * h);
         //partial clear
         } else {
             for (uint32_t i = 0; i < h; i++) {
@@ -1511,7 +2018,7 @@ bool rasterClear(SwSurface* surface, uint32_t x, uint32_t y, uint32_t w, uint32_
     } else if (surface->channelSize == sizeof(uint8_t)) {
         //full clear
         if (w == surface->stride) {
-            rasterGrayscale8(surface->buf8, 0x00, surface->stride * y, w * h);
+            rasterGrayscale8(surface->buf8, 0x00, surface->stride * y + x, w * h);
         //partial clear
         } else {
             for (uint32_t i = 0; i < h; i++) {
@@ -1528,26 +2035,49 @@ uint32_t rasterUnpremultiply(uint32_t data)
     auto a = A(data);
     if (a == 255 || a == 0) return data;
 
-    uint8_t r = std::min(C1(data) * 255u / a, 255u);
-    uint8_t g = std::min(C2(data) * 255u / a, 255u);
-    uint8_t b = std::min(C3(data) * 255u / a, 255u);
+    return JOIN(a, cUnpremultiply(C1(data), a), cUnpremultiply(C2(data), a), cUnpremultiply(C3(data), a));
+}
 
-    return JOIN(a, r, g, b);
+
+/* Extract the luma of the mask into the 8-bit channels in place, so that the matting reads a byte per pixel
+   instead of computing the luma of every 32-bit pixel per access. The i-th byte never passes over the i-th pixel. */
+bool rasterLuma8(SwSurface* surface)
+{
+    auto cmp = surface->compositor;
+    if (surface->channelSize != sizeof(uint32_t) || !cmp->buffer) return false;
+
+    auto& area = surface->area;
+    auto size = area.w() * area.h();
+
+    TVGLOG("SW_ENGINE", "Luma8 [Region: %d %d %d %d]", area.x(), area.y(), area.w(), area.h());
+
+    auto luma = surface->alphas[2];
+    auto src = (uint8_t*)cmp->buffer;
+    auto dst = src;
+    for (uint32_t i = 0; i < size; ++i, src += sizeof(uint32_t)) dst[i] = luma(src);
+
+    //the bytes written are in the top quarter of the 32-bit pixels, the reuse must clear them as well
+    RenderRegion written = {{area.min.x, area.min.y}, {area.max.x, area.min.y + int32_t((area.h() + 3) / 4)}};
+    if (surface->dirty.invalid()) surface->dirty = written;
+    else surface->dirty.add(written);
+
+    cmp->image.data = (pixel_t*)((uint8_t*)cmp->buffer - (area.min.y * area.sw() + area.min.x));
+    cmp->image.channelSize = sizeof(uint8_t);
+    return true;
 }
 
 
-void rasterUnpremultiply(RenderSurface* surface)
+void rasterUnpremultiply(SwSurface* surface)
 {
     if (surface->channelSize != sizeof(uint32_t)) return;
 
-    TVGLOG("SW_ENGINE", "Unpremultiply [Size: %d x %d]", surface->w, surface->h);
+    auto& area = surface->area;
 
-    //OPTIMIZE_ME: +SIMD
-    for (uint32_t y = 0; y < surface->h; y++) {
-        auto buffer = surface->buf32 + surface->stride * y;
-        for (uint32_t x = 0; x < surface->w; ++x) {
-            buffer[x] = rasterUnpremultiply(buffer[x]);
-        }
+    TVGLOG("SW_ENGINE", "Unpremultiply [Region: %d %d %d %d]", area.x(), area.y(), area.w(), area.h());
+
+    auto buffer = surface->buf32 + area.min.y * surface->stride + area.min.x;
+    for (auto y = area.min.y; y < area.max.y; ++y, buffer += surface->stride) {
+        _simd.unpremultiply(buffer, area.w());
     }
     surface->premultiplied = false;
 }
@@ -1561,15 +2091,9 @@ void rasterPremultiply(RenderSurface* surface)
 
     TVGLOG("SW_ENGINE", "Premultiply [Size: %d x %d]", surface->w, surface->h);
 
-    //OPTIMIZE_ME: +SIMD
     auto buffer = surface->buf32;
     for (uint32_t y = 0; y < surface->h; ++y, buffer += surface->stride) {
-        auto dst = buffer;
-        for (uint32_t x = 0; x < surface->w; ++x, ++dst) {
-            auto c = *dst;
-            if (A(c) == 255) continue;
-            *dst = PREMULTIPLY(c, A(c));
-        }
+        _simd.premultiply(buffer, surface->w);
     }
 }
 
@@ -1581,7 +2105,7 @@ bool rasterScaledImage(SwSurface* surface, const SwImage& image, const Matrix& t
     if (!inverse(&transform, &itransform)) return true;
 
     if (_compositing(surface)) {
-        if (_matting(surface)) return _rasterScaledMattedImage(surface, image, &itransform, bbox, opacity);
+        if (_matting(surface)) return _matte(surface, [&](auto alpha) { return _rasterScaledMattedImage(surface, image, &itransform, bbox, opacity, alpha); });
         else return _rasterScaledMaskedImage(surface, image, &itransform, bbox, opacity);
     } else if (_blending(surface)) {
         return _rasterScaledBlendingImage(surface, image, &itransform, bbox, opacity);
@@ -1600,8 +2124,8 @@ bool rasterDirectImage(SwSurface* surface, const SwImage& image, const RenderReg
 
     if (_compositing(surface)) {
         if (_matting(surface)) {
-            if (_blending(surface)) return _rasterDirectMattedBlendingImage(surface, image, bbox, w, h, opacity);
-            else return _rasterDirectMattedImage(surface, image, bbox, w, h, opacity);
+            if (_blending(surface)) return _matte(surface, [&](auto alpha) { return _rasterDirectMattedBlendingImage(surface, image, bbox, w, h, opacity, alpha); });
+            else return _matte(surface, [&](auto alpha) { return _rasterDirectMattedImage(surface, image, bbox, w, h, opacity, alpha); });
         } else return _rasterDirectMaskedImage(surface, image, bbox, w, h, opacity);
     } else if (_blending(surface)) {
         return _rasterDirectBlendingImage(surface, image, bbox, w, h, opacity);
@@ -1624,7 +2148,7 @@ bool rasterScaledRleImage(SwSurface* surface, const SwImage& image, const Matrix
     if (!inverse(&transform, &itransform)) return true;
 
     if (_compositing(surface)) {
-        if (_matting(surface)) return _rasterScaledMattedRleImage(surface, image, &itransform, bbox, opacity);
+        if (_matting(surface)) return _matte(surface, [&](auto alpha) { return _rasterScaledMattedRleImage(surface, image, &itransform, bbox, opacity, alpha); });
         else return _rasterScaledMaskedRleImage(surface, image, &itransform, bbox, opacity);
     } else if (_blending(surface)) {
         return _rasterScaledBlendingRleImage(surface, image, &itransform, bbox, opacity);
@@ -1635,6 +2159,29 @@ bool rasterScaledRleImage(SwSurface* surface, const SwImage& image, const Matrix
 }
 
 
+bool rasterTransformedRleImage(SwSurface* surface, const SwImage& image, const Matrix& transform, const RenderRegion& bbox, uint8_t opacity)
+{
+    if (surface->channelSize == sizeof(uint8_t)) {
+        TVGERR("SW_ENGINE", "Not supported grayscale transformed rle image!");
+        return false;
+    }
+
+    Matrix itransform;
+
+    if (!inverse(&transform, &itransform)) return true;
+
+    if (_compositing(surface)) {
+        if (_matting(surface)) return _matte(surface, [&](auto alpha) { return _rasterTransformedMattedRleImage(surface, image, &itransform, bbox, opacity, alpha); });
+        else return _rasterTransformedMaskedRleImage(surface, image, &itransform, bbox, opacity);
+    } else if (_blending(surface)) {
+        return _rasterTransformedBlendingRleImage(surface, image, &itransform, bbox, opacity);
+    } else {
+        return _rasterTransformedRleImage(surface, image, &itransform, bbox, opacity);
+    }
+    return false;
+}
+
+
 bool rasterDirectRleImage(SwSurface* surface, const SwImage& image, const RenderRegion& bbox, uint8_t opacity)
 {
     if (surface->channelSize == sizeof(uint8_t)) {
@@ -1643,7 +2190,7 @@ bool rasterDirectRleImage(SwSurface* surface, const SwImage& image, const Render
     }
 
     if (_compositing(surface)) {
-        if (_matting(surface)) return _rasterDirectMattedRleImage(surface, image, bbox, opacity);
+        if (_matting(surface)) return _matte(surface, [&](auto alpha) { return _rasterDirectMattedRleImage(surface, image, bbox, opacity, alpha); });
         else return _rasterDirectMaskedRleImage(surface, image, bbox, opacity);
     } else if (_blending(surface)) {
         return _rasterDirectBlendingRleImage(surface, image, bbox, opacity);
@@ -1669,8 +2216,8 @@ bool rasterGradientShape(SwSurface* surface, SwShape* shape, const RenderRegion&
         if (type == Type::LinearGradient) return _rasterLinearGradientRect(surface, bbox, shape->fill);
         else if (type == Type::RadialGradient)return _rasterRadialGradientRect(surface, bbox, shape->fill);
     } else if (shape->rle && shape->rle->valid()) {
-        if (type == Type::LinearGradient) return _rasterLinearGradientRle(surface, shape->rle, shape->fill);
-        else if (type == Type::RadialGradient) return _rasterRadialGradientRle(surface, shape->rle, shape->fill);
+        if (type == Type::LinearGradient) return _rasterLinearGradientRle(surface, shape->rle, bbox, shape->fill);
+        else if (type == Type::RadialGradient) return _rasterRadialGradientRle(surface, shape->rle, bbox, shape->fill);
     } return false;
 }
 
@@ -1686,8 +2233,8 @@ bool rasterGradientStroke(SwSurface* surface, SwShape* shape, const RenderRegion
     }
 
     auto type = fdata->type();
-    if (type == Type::LinearGradient) return _rasterLinearGradientRle(surface, shape->strokeRle, shape->stroke->fill);
-    else if (type == Type::RadialGradient) return _rasterRadialGradientRle(surface, shape->strokeRle, shape->stroke->fill);
+    if (type == Type::LinearGradient) return _rasterLinearGradientRle(surface, shape->strokeRle, bbox, shape->stroke->fill);
+    else if (type == Type::RadialGradient) return _rasterRadialGradientRle(surface, shape->strokeRle, bbox, shape->stroke->fill);
     return false;
 }
 
@@ -1700,6 +2247,7 @@ bool rasterShape(SwSurface* surface, SwShape* shape, const RenderRegion& bbox, R
         c.b = MULTIPLY(c.b, c.a);
     }
     if (shape->fastTrack) return _rasterRect(surface, bbox, c);
+    else if (shape->tiles && shape->tiles->valid()) return _rasterTiles(surface, shape->tiles, bbox, c);
     else return _rasterRle(surface, shape->rle, bbox, c);
 }
 
@@ -1721,23 +2269,39 @@ bool rasterConvertCS(RenderSurface* surface, ColorSpace to)
     ScopedLock lock(surface->key);
     if (surface->cs == to) return true;
 
-    //TODO: Support SIMD accelerations
     auto from = surface->cs;
-
-    if (((from == ColorSpace::ABGR8888) || (from == ColorSpace::ABGR8888S)) && ((to == ColorSpace::ARGB8888) || (to == ColorSpace::ARGB8888S))) {
-        surface->cs = to;
-        return cRasterABGRtoARGB(surface);
-    }
-    if (((from == ColorSpace::ARGB8888) || (from == ColorSpace::ARGB8888S)) && ((to == ColorSpace::ABGR8888) || (to == ColorSpace::ABGR8888S))) {
+    auto abgr = [](ColorSpace cs) { return cs == ColorSpace::ABGR8888 || cs == ColorSpace::ABGR8888S; };
+    auto argb = [](ColorSpace cs) { return cs == ColorSpace::ARGB8888 || cs == ColorSpace::ARGB8888S; };
+
+    if ((abgr(from) && argb(to)) || (argb(from) && abgr(to))) {
+        TVGLOG("SW_ENGINE", "Convert ColorSpace ABGR - ARGB [Size: %d x %d]", surface->w, surface->h);
+        auto buffer = surface->buf32;
+        for (uint32_t y = 0; y < surface->h; ++y, buffer += surface->stride) {
+            _simd.swapRB(buffer, surface->w);
+        }
         surface->cs = to;
-        return cRasterARGBtoABGR(surface);
+        return true;
     }
     return false;
 }
 
 
+void rasterPack565(SwSurface* surface, uint16_t* dst, uint32_t stride, const RenderRegion& region, bool dither)
+{
+    auto bbox = RenderRegion::intersect(region, surface->area);
+    if (bbox.invalid()) return;
+
+    TVGLOG("SW_ENGINE", "Pack RGB565 [Region: %d %d %d %d]", bbox.x(), bbox.y(), bbox.w(), bbox.h());
+
+    for (auto y = bbox.min.y; y < bbox.max.y; ++y) {
+        cRasterPack565(dst + y * stride + bbox.min.x, surface->buf32 + y * surface->stride + bbox.min.x, bbox.w(), bbox.min.x, y, dither);
+    }
+}
+
+
 //TODO: SIMD OPTIMIZATION?
-void rasterXYFlip(uint32_t* src, uint32_t* dst, int32_t stride, int32_t w, int32_t h, const RenderRegion& bbox, bool flipped)
+template<typename PIXEL_T>
+static void _rasterXYFlip(PIXEL_T* src, PIXEL_T* dst, int32_t stride, int32_t w, int32_t h, const RenderRegion& bbox, bool flipped)
 {
     constexpr int32_t BLOCK = 8;  //experimental decision
 
@@ -1772,6 +2336,18 @@ void rasterXYFlip(uint32_t* src, uint32_t* dst, int32_t stride, int32_t w, int32
 }
 
 
+void rasterXYFlip(uint32_t* src, uint32_t* dst, int32_t stride, int32_t w, int32_t h, const RenderRegion& bbox, bool flipped)
+{
+    _rasterXYFlip(src, dst, stride, w, h, bbox, flipped);
+}
+
+
+void rasterXYFlip(uint8_t* src, uint8_t* dst, int32_t stride, int32_t w, int32_t h, const RenderRegion& bbox, bool flipped)
+{
+    _rasterXYFlip(src, dst, stride, w, h, bbox, flipped);
+}
+
+
 //TODO: can be moved in tvgColor
 void rasterRGB2HSL(uint8_t r, uint8_t g, uint8_t b, float* h, float* s, float* l)
 {
@@ -23,11 +23,14 @@
 #ifdef THORVG_AVX_VECTOR_SUPPORT
 
 #include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
 
 #define N_32BITS_IN_128REG 4
 #define N_32BITS_IN_256REG 8
 
-static inline __m128i ALPHA_BLEND(__m128i c, __m128i a)
+SW_AVX_TARGET static inline __m128i ALPHA_BLEND(__m128i c, __m128i a)
 {
     //1. set the masks for the A/G and R/B channels
     auto AG = _mm_set1_epi32(0xff00ff00);
@@ -62,7 +65,27 @@ static inline __m128i ALPHA_BLEND(__m128i c, __m128i a)
 }
 
 
-static void avxRasterGrayscale8(uint8_t* dst, uint8_t val, uint32_t offset, int32_t len) 
+//the same 32 bits arithmetic with the scalar INTERPOLATE() for the bit exact results
+SW_AVX_TARGET static inline __m128i INTERPOLATE(__m128i s, __m128i d, __m128i a)
+{
+    auto AG = _mm_set1_epi32(0xff00ff00);
+    auto RB = _mm_set1_epi32(0x00ff00ff);
+
+    //1. the 1st and 3rd channels
+    auto odd = _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(s, 8), RB), _mm_and_si128(_mm_srli_epi32(d, 8), RB));
+    odd = _mm_mullo_epi32(odd, a);
+    odd = _mm_and_si128(_mm_add_epi32(odd, _mm_and_si128(d, AG)), AG);
+
+    //2. the 2nd and 4th channels
+    auto even = _mm_sub_epi32(_mm_and_si128(s, RB), _mm_and_si128(d, RB));
+    even = _mm_srli_epi32(_mm_mullo_epi32(even, a), 8);
+    even = _mm_and_si128(_mm_add_epi32(even, _mm_and_si128(d, RB)), RB);
+
+    return _mm_add_epi32(odd, even);
+}
+
+
+SW_AVX_TARGET static void avxRasterGrayscale8(uint8_t* dst, uint8_t val, uint32_t offset, int32_t len) 
 {
     dst += offset; 
 
@@ -79,7 +102,7 @@ static void avxRasterGrayscale8(uint8_t* dst, uint8_t val, uint32_t offset, int3
 }
 
 
-static void avxRasterPixel32(uint32_t *dst, uint32_t val, uint32_t offset, int32_t len)
+SW_AVX_TARGET static void avxRasterPixel32(uint32_t *dst, uint32_t val, uint32_t offset, int32_t len)
 {
     //1. calculate how many iterations we need to cover the length
     uint32_t iterations = len / N_32BITS_IN_256REG;
@@ -99,7 +122,7 @@ static void avxRasterPixel32(uint32_t *dst, uint32_t val, uint32_t offset, int32
 }
 
 
-static bool avxRasterTranslucentRect(SwSurface* surface, const RenderRegion& bbox, const RenderColor& c)
+SW_AVX_TARGET static bool avxRasterTranslucentRect(SwSurface* surface, const RenderRegion& bbox, const RenderColor& c)
 {
     auto h = bbox.h();
     auto w = bbox.w();
@@ -158,7 +181,7 @@ static bool avxRasterTranslucentRect(SwSurface* surface, const RenderRegion& bbo
 }
 
 
-static bool avxRasterTranslucentRle(SwSurface* surface, const SwRle* rle, const RenderRegion& bbox, const RenderColor& c)
+SW_AVX_TARGET static bool avxRasterTranslucentRle(SwSurface* surface, const SwRle* rle, const RenderRegion& bbox, const RenderColor& c)
 {
     const SwSpan* end;
     int32_t x, len;
@@ -217,7 +240,7 @@ static bool avxRasterTranslucentRle(SwSurface* surface, const SwRle* rle, const
             auto dst = &surface->buf8[span->y * surface->stride + x];
             if (span->coverage < 255) src = MULTIPLY(span->coverage, c.a);
             else src = c.a;
-            auto ialpha = ~c.a;
+            auto ialpha = ~src;
             for (auto x = 0; x < len; ++x, ++dst) {
                 *dst = src + MULTIPLY(*dst, ialpha);
             }
@@ -227,4 +250,303 @@ static bool avxRasterTranslucentRle(SwSurface* surface, const SwRle* rle, const
 }
 
 
+//bilinear interpolation of a scaled image row, 4 pixels per iteration. The samples out of the image are 0.
+SW_AVX_TARGET static uint32_t avxInterpUpScaleRow(const uint32_t* img, uint32_t stride, uint32_t w, uint32_t h, float e11, float e13, float sy, int32_t x, uint32_t len, uint32_t* out)
+{
+    auto iterations = len / N_32BITS_IN_128REG;
+    if (iterations == 0) return 0;
+
+    auto ry = (size_t)(sy);
+    auto ry2 = ry + 1;
+    if (ry2 >= h) ry2 = h - 1;
+    auto row1 = img + ry * stride;
+    auto row2 = img + ry2 * stride;
+    auto dy = _mm_set1_epi32((sy > 0.0f) ? static_cast<uint8_t>((sy - ry) * 255.0f) : 0);
+
+    auto xs = _mm_add_epi32(_mm_set1_epi32(x), _mm_setr_epi32(0, 1, 2, 3));
+    auto step = _mm_set1_epi32(N_32BITS_IN_128REG);
+    auto scale = _mm_set1_ps(e11);
+    auto offset = _mm_set1_ps(e13);
+    auto bias = _mm_set1_ps(0.49f);
+    auto lower = _mm_set1_ps(-0.5f);
+    auto half = _mm_set1_ps(0.5f);
+    auto zero = _mm_setzero_ps();
+    auto width = _mm_set1_epi32(w);
+    auto last = _mm_set1_epi32(w - 1);
+
+    for (uint32_t i = 0; i < iterations; ++i, out += N_32BITS_IN_128REG, xs = _mm_add_epi32(xs, step)) {
+        auto sx = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(xs), scale), offset), bias);
+
+        //1. the samples must be inside the image
+        auto ix = _mm_cvttps_epi32(_mm_add_ps(sx, half));
+        auto valid = _mm_castps_si128(_mm_cmpgt_ps(sx, lower));
+        valid = _mm_and_si128(valid, _mm_cmpgt_epi32(ix, _mm_set1_epi32(-1)));
+        valid = _mm_and_si128(valid, _mm_cmplt_epi32(ix, width));
+        if (_mm_testz_si128(valid, valid)) {
+            _mm_storeu_si128((__m128i*)out, _mm_setzero_si128());
+            continue;
+        }
+
+        //2. the sampling positions and the weights, the invalid ones fetch the first pixel
+        auto rx = _mm_and_si128(_mm_cvttps_epi32(sx), valid);
+        auto rx2 = _mm_min_epi32(_mm_add_epi32(rx, _mm_set1_epi32(1)), last);
+        auto dx = _mm_cvttps_epi32(_mm_mul_ps(_mm_sub_ps(sx, _mm_cvtepi32_ps(rx)), _mm_set1_ps(255.0f)));
+        dx = _mm_and_si128(dx, _mm_castps_si128(_mm_cmpgt_ps(sx, zero)));
+
+        //3. interpolate
+        uint32_t p1[N_32BITS_IN_128REG], p2[N_32BITS_IN_128REG];
+        _mm_storeu_si128((__m128i*)p1, rx);
+        _mm_storeu_si128((__m128i*)p2, rx2);
+        auto c1 = _mm_setr_epi32(row1[p1[0]], row1[p1[1]], row1[p1[2]], row1[p1[3]]);
+        auto c2 = _mm_setr_epi32(row1[p2[0]], row1[p2[1]], row1[p2[2]], row1[p2[3]]);
+        auto c3 = _mm_setr_epi32(row2[p1[0]], row2[p1[1]], row2[p1[2]], row2[p1[3]]);
+        auto c4 = _mm_setr_epi32(row2[p2[0]], row2[p2[1]], row2[p2[2]], row2[p2[3]]);
+        auto ret = INTERPOLATE(INTERPOLATE(c4, c3, dx), INTERPOLATE(c2, c1, dx), dy);
+        _mm_storeu_si128((__m128i*)out, _mm_and_si128(ret, valid));
+    }
+
+    return iterations * N_32BITS_IN_128REG;
+}
+
+
+//the same 32 bits arithmetic with the scalar ALPHA_BLEND()
+SW_AVX_TARGET static inline __m128i _avxAlphaBlend(__m128i c, __m128i a)
+{
+    auto RB = _mm_set1_epi32(0x00ff00ff);
+    a = _mm_add_epi32(a, _mm_set1_epi32(1));
+    auto odd = _mm_and_si128(_mm_mullo_epi32(_mm_and_si128(_mm_srli_epi32(c, 8), RB), a), _mm_set1_epi32(0xff00ff00));
+    auto even = _mm_and_si128(_mm_srli_epi32(_mm_mullo_epi32(_mm_and_si128(c, RB), a), 8), RB);
+    return _mm_add_epi32(odd, even);
+}
+
+
+//MULTIPLY() of the 16 bits channels
+SW_AVX_TARGET static inline __m128i _avxMultiply16(__m128i c, __m128i a)
+{
+    return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(c, a), _mm_set1_epi16(0xff)), 8);
+}
+
+
+SW_AVX_TARGET static inline __m128i _avxUnpremultiply(__m128i c, __m128 a, int shift)
+{
+    auto v = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(c, shift), _mm_set1_epi32(0xff)));
+    v = _mm_div_ps(_mm_mul_ps(v, _mm_set1_ps(255.0f)), a);
+    return _mm_slli_epi32(_mm_min_epi32(_mm_cvttps_epi32(v), _mm_set1_epi32(255)), shift);
+}
+
+
+//rasterUnpremultiply() of 4 pixels, the division is exact enough to truncate.
+SW_AVX_TARGET static inline __m128i _avxUnpremultiply(__m128i c)
+{
+    auto a = _mm_srli_epi32(c, 24);
+    auto fa = _mm_cvtepi32_ps(a);
+    auto ret = _mm_or_si128(_mm_slli_epi32(a, 24), _avxUnpremultiply(c, fa, 16));
+    ret = _mm_or_si128(ret, _mm_or_si128(_avxUnpremultiply(c, fa, 8), _avxUnpremultiply(c, fa, 0)));
+
+    //the opaque and the transparent ones stay as they are
+    auto keep = _mm_or_si128(_mm_cmpeq_epi32(a, _mm_set1_epi32(255)), _mm_cmpeq_epi32(a, _mm_setzero_si128()));
+    return _mm_blendv_epi8(ret, c, keep);
+}
+
+
+//the blenders work on the 16 bits channels. UPRE: blending with the unpremultiplied destination
+struct AvxBlendMultiply
+{
+    static constexpr bool UPRE = true;
+    SW_AVX_TARGET static inline __m128i op(__m128i s, __m128i d) { return _avxMultiply16(s, d); }
+    static inline uint32_t scalar(uint32_t s, uint32_t d) { return opBlendMultiply(s, d); }
+};
+
+struct AvxBlendScreen
+{
+    static constexpr bool UPRE = false;
+    SW_AVX_TARGET static inline __m128i op(__m128i s, __m128i d) { return _mm_sub_epi16(_mm_add_epi16(s, d), _avxMultiply16(s, d)); }
+    static inline uint32_t scalar(uint32_t s, uint32_t d) { return opBlendScreen(s, d); }
+};
+
+struct AvxBlendOverlay
+{
+    static constexpr bool UPRE = true;
+    SW_AVX_TARGET static inline __m128i op(__m128i s, __m128i d)
+    {
+        auto full = _mm_set1_epi16(255);
+        auto lo = _mm_min_epi16(full, _mm_slli_epi16(_avxMultiply16(s, d), 1));
+        auto hi = _mm_sub_epi16(full, _mm_min_epi16(full, _mm_slli_epi16(_avxMultiply16(_mm_sub_epi16(full, s), _mm_sub_epi16(full, d)), 1)));
+        return _mm_blendv_epi8(hi, lo, _mm_cmplt_epi16(d, _mm_set1_epi16(128)));
+    }
+    static inline uint32_t scalar(uint32_t s, uint32_t d) { return opBlendOverlay(s, d); }
+};
+
+struct AvxBlendDarken
+{
+    static constexpr bool UPRE = true;
+    SW_AVX_TARGET static inline __m128i op(__m128i s, __m128i d) { return _mm_min_epi16(s, d); }
+    static inline uint32_t scalar(uint32_t s, uint32_t d) { return opBlendDarken(s, d); }
+};
+
+struct AvxBlendLighten
+{
+    static constexpr bool UPRE = false;
+    SW_AVX_TARGET static inline __m128i op(__m128i s, __m128i d) { return _mm_max_epi16(s, d); }
+    static inline uint32_t scalar(uint32_t s, uint32_t d) { return opBlendLighten(s, d); }
+};
+
+struct AvxBlendAdd
+{
+    static constexpr bool UPRE = false;
+    SW_AVX_TARGET static inline __m128i op(__m128i s, __m128i d) { return _mm_min_epi16(_mm_add_epi16(s, d), _mm_set1_epi16(255)); }
+    static inline uint32_t scalar(uint32_t s, uint32_t d) { return opBlendAdd(s, d); }
+};
+
+struct AvxBlendDifference
+{
+    static constexpr bool UPRE = false;
+    SW_AVX_TARGET static inline __m128i op(__m128i s, __m128i d) { return _mm_abs_epi16(_mm_sub_epi16(s, d)); }
+    static inline uint32_t scalar(uint32_t s, uint32_t d) { return opBlendDifference(s, d); }
+};
+
+struct AvxBlendExclusion
+{
+    static constexpr bool UPRE = false;
+    SW_AVX_TARGET static inline __m128i op(__m128i s, __m128i d)
+    {
+        auto ret = _mm_sub_epi16(_mm_add_epi16(s, d), _mm_slli_epi16(_avxMultiply16(s, d), 1));
+        return _mm_min_epi16(_mm_max_epi16(ret, _mm_setzero_si128()), _mm_set1_epi16(255));
+    }
+    static inline uint32_t scalar(uint32_t s, uint32_t d) { return opBlendExclusion(s, d); }
+};
+
+
+//4 pixels of the scalar blender K::scalar()
+template<typename K>
+SW_AVX_TARGET static inline __m128i _avxBlend(__m128i s, __m128i d)
+{
+    auto o = K::UPRE ? _avxUnpremultiply(d) : d;
+
+    auto zero = _mm_setzero_si128();
+    auto mask = _mm_set1_epi16(0xff);
+    auto lo = _mm_and_si128(K::op(_mm_cvtepu8_epi16(s), _mm_cvtepu8_epi16(o)), mask);
+    auto hi = _mm_and_si128(K::op(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(o, zero)), mask);
+    auto c = _mm_or_si128(_mm_packus_epi16(lo, hi), _mm_set1_epi32(0xff000000));
+
+    if (K::UPRE) {
+        //BLEND_PRE() with the destination alpha
+        auto oa = _mm_srli_epi32(d, 24);
+        auto full = _mm_set1_epi32(255);
+        auto pre = _mm_add_epi32(_avxAlphaBlend(c, oa), _avxAlphaBlend(s, _mm_sub_epi32(full, oa)));
+        c = _mm_blendv_epi8(pre, c, _mm_cmpeq_epi32(oa, full));
+        return _mm_blendv_epi8(c, s, _mm_cmpeq_epi32(oa, zero));
+    }
+    return _mm_blendv_epi8(c, s, _mm_cmpeq_epi32(d, zero));
+}
+
+
+template<typename K>
+SW_AVX_TARGET static void avxBlendColorSpan(uint32_t* dst, uint32_t color, uint32_t len, uint8_t a)
+{
+    auto s = _mm_set1_epi32(color);
+    auto va = _mm_set1_epi32(a);
+    auto iterations = len / N_32BITS_IN_128REG;
+
+    for (uint32_t i = 0; i < iterations; ++i, dst += N_32BITS_IN_128REG) {
+        auto d = _mm_loadu_si128((__m128i*)dst);
+        auto c = _avxBlend<K>(s, d);
+        if (a < 255) c = INTERPOLATE(c, d, va);
+        _mm_storeu_si128((__m128i*)dst, c);
+    }
+
+    for (uint32_t x = iterations * N_32BITS_IN_128REG; x < len; ++x, ++dst) {
+        *dst = (a == 255) ? K::scalar(color, *dst) : INTERPOLATE(K::scalar(color, *dst), *dst, a);
+    }
+}
+
+
+template<typename K>
+SW_AVX_TARGET static void avxBlendImageSpan(uint32_t* dst, const uint32_t* src, uint32_t len, uint8_t a)
+{
+    auto va = _mm_set1_epi32(a);
+    auto iterations = len / N_32BITS_IN_128REG;
+
+    for (uint32_t i = 0; i < iterations; ++i, dst += N_32BITS_IN_128REG, src += N_32BITS_IN_128REG) {
+        auto s = _mm_loadu_si128((__m128i*)src);
+        auto d = _mm_loadu_si128((__m128i*)dst);
+        //MULTIPLY(a, A(src))
+        auto sa = _mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi32(va, _mm_srli_epi32(s, 24)), _mm_set1_epi32(0xff)), 8);
+        _mm_storeu_si128((__m128i*)dst, INTERPOLATE(_avxBlend<K>(_avxUnpremultiply(s), d), d, sa));
+    }
+
+    for (uint32_t x = iterations * N_32BITS_IN_128REG; x < len; ++x, ++dst, ++src) {
+        *dst = INTERPOLATE(K::scalar(rasterUnpremultiply(*src), *dst), *dst, MULTIPLY(a, A(*src)));
+    }
+}
+
+
+template<typename K>
+static void _avxBlender(SwSurface* surface)
+{
+    surface->colorBlender = avxBlendColorSpan<K>;
+    surface->imageBlender = avxBlendImageSpan<K>;
+}
+
+
+//override the span blenders of the methods that have the vectorized one
+static void avxRasterBlender(SwSurface* surface, BlendMethod method)
+{
+    switch (method) {
+        case BlendMethod::Multiply: _avxBlender<AvxBlendMultiply>(surface); break;
+        case BlendMethod::Screen: _avxBlender<AvxBlendScreen>(surface); break;
+        case BlendMethod::Overlay: _avxBlender<AvxBlendOverlay>(surface); break;
+        case BlendMethod::Darken: _avxBlender<AvxBlendDarken>(surface); break;
+        case BlendMethod::Lighten: _avxBlender<AvxBlendLighten>(surface); break;
+        case BlendMethod::Add: _avxBlender<AvxBlendAdd>(surface); break;
+        case BlendMethod::Difference: _avxBlender<AvxBlendDifference>(surface); break;
+        case BlendMethod::Exclusion: _avxBlender<AvxBlendExclusion>(surface); break;
+        default: break;
+    }
+}
+
+
+//the same 32 bits arithmetic with the scalar PREMULTIPLY(), the opaque ones stay as they are
+SW_AVX_TARGET static void avxRasterPremultiply(uint32_t* buf, uint32_t len)
+{
+    auto RB = _mm_set1_epi32(0x00ff00ff);
+    auto G = _mm_set1_epi32(0x0000ff00);
+    auto AA = _mm_set1_epi32(0xff000000);
+    uint32_t x = 0;
+
+    for (; x + N_32BITS_IN_128REG <= len; x += N_32BITS_IN_128REG) {
+        auto c = _mm_loadu_si128((__m128i*)(buf + x));
+        auto a = _mm_srli_epi32(c, 24);
+        auto g = _mm_and_si128(_mm_mullo_epi32(_mm_and_si128(_mm_srli_epi32(c, 8), _mm_set1_epi32(0xff)), a), G);
+        auto rb = _mm_and_si128(_mm_srli_epi32(_mm_mullo_epi32(_mm_and_si128(c, RB), a), 8), RB);
+        auto ret = _mm_or_si128(_mm_and_si128(c, AA), _mm_or_si128(g, rb));
+        _mm_storeu_si128((__m128i*)(buf + x), _mm_blendv_epi8(ret, c, _mm_cmpeq_epi32(a, _mm_set1_epi32(0xff))));
+    }
+    cRasterPremultiply(buf + x, len - x);
+}
+
+
+SW_AVX_TARGET static void avxRasterUnpremultiply(uint32_t* buf, uint32_t len)
+{
+    uint32_t x = 0;
+    for (; x + N_32BITS_IN_128REG <= len; x += N_32BITS_IN_128REG) {
+        auto c = _mm_loadu_si128((__m128i*)(buf + x));
+        _mm_storeu_si128((__m128i*)(buf + x), _avxUnpremultiply(c));
+    }
+    cRasterUnpremultiply(buf + x, len - x);
+}
+
+
+SW_AVX_TARGET static void avxRasterSwapRB(uint32_t* buf, uint32_t len)
+{
+    auto swap = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    uint32_t x = 0;
+    for (; x + N_32BITS_IN_128REG <= len; x += N_32BITS_IN_128REG) {
+        auto c = _mm_loadu_si128((__m128i*)(buf + x));
+        _mm_storeu_si128((__m128i*)(buf + x), _mm_shuffle_epi8(c, swap));
+    }
+    cRasterSwapRB(buf + x, len - x);
+}
+
+
 #endif
@@ -119,7 +119,7 @@ static bool inline cRasterTranslucentRle(SwSurface* surface, const SwRle* rle, c
             auto dst = &surface->buf8[span->y * surface->stride + x];
             if (span->coverage < 255) src = MULTIPLY(span->coverage, c.a);
             else src = c.a;
-            auto ialpha = ~c.a;
+            auto ialpha = ~src;
             for (auto x = 0; x < len; ++x, ++dst) {
                 *dst = src + MULTIPLY(*dst, ialpha);
             }
@@ -157,39 +157,64 @@ static bool inline cRasterTranslucentRect(SwSurface* surface, const RenderRegion
 }
 
 
-static bool inline cRasterABGRtoARGB(RenderSurface* surface)
+//reciprocals of the alpha in 16.16 fixed point, (c * table[a]) >> 16 is exactly c * 255 / a
+struct UnpremultiplyTable
 {
-    TVGLOG("SW_ENGINE", "Convert ColorSpace ABGR - ARGB [Size: %d x %d]", surface->w, surface->h);
-
-    //64bits faster converting
-    if (surface->w % 2 == 0) {
-        auto buffer = reinterpret_cast<uint64_t*>(surface->buf32);
-        for (uint32_t y = 0; y < surface->h; ++y, buffer += surface->stride / 2) {
-            auto dst = buffer;
-            for (uint32_t x = 0; x < surface->w / 2; ++x, ++dst) {
-                auto c = *dst;
-                //flip Blue, Red channels
-                *dst = (c & 0xff000000ff000000) + ((c & 0x00ff000000ff0000) >> 16) + (c & 0x0000ff000000ff00) + ((c & 0x000000ff000000ff) << 16);
-            }
-        }
-    //default converting
-    } else {
-        auto buffer = surface->buf32;
-        for (uint32_t y = 0; y < surface->h; ++y, buffer += surface->stride) {
-            auto dst = buffer;
-            for (uint32_t x = 0; x < surface->w; ++x, ++dst) {
-                auto c = *dst;
-                //flip Blue, Red channels
-                *dst = (c & 0xff000000) + ((c & 0x00ff0000) >> 16) + (c & 0x0000ff00) + ((c & 0x000000ff) << 16);
-            }
-        }
+    uint32_t recip[256];
+
+    constexpr UnpremultiplyTable() : recip()
+    {
+        for (uint32_t a = 1; a < 256; ++a) recip[a] = (255u * 65536u + a - 1) / a;
     }
-    return true;
+};
+
+static constexpr UnpremultiplyTable _unpremultiplyTable;
+
+
+static inline uint32_t cUnpremultiply(uint32_t c, uint32_t a)
+{
+    return std::min((c * _unpremultiplyTable.recip[a]) >> 16, 255u);
 }
 
 
-static bool inline cRasterARGBtoABGR(RenderSurface* surface)
+static void inline cRasterPremultiply(uint32_t* buf, uint32_t len)
 {
-    //exactly same with ABGRtoARGB
-    return cRasterABGRtoARGB(surface);
+    for (uint32_t x = 0; x < len; ++x, ++buf) {
+        auto c = *buf;
+        if (A(c) == 255) continue;
+        *buf = PREMULTIPLY(c, A(c));
+    }
+}
+
+
+static void inline cRasterUnpremultiply(uint32_t* buf, uint32_t len)
+{
+    for (uint32_t x = 0; x < len; ++x, ++buf) {
+        *buf = rasterUnpremultiply(*buf);
+    }
+}
+
+
+//ARGB to RGB565, the thresholds of the ordered dithering are 0 ~ 255 over the 4x4 bayer matrix.
+static void inline cRasterPack565(uint16_t* dst, const uint32_t* src, uint32_t len, uint32_t x, uint32_t y, bool dither)
+{
+    static constexpr uint8_t bayer[4][4] = {{8, 136, 40, 168}, {200, 72, 232, 104}, {56, 184, 24, 152}, {248, 120, 216, 88}};
+
+    for (uint32_t i = 0; i < len; ++i, ++dst, ++src) {
+        auto t = dither ? bayer[y & 3][(x + i) & 3] : 127u;
+        auto r = (C1(*src) * 31u + t) / 255u;
+        auto g = (C2(*src) * 63u + t) / 255u;
+        auto b = (C3(*src) * 31u + t) / 255u;
+        *dst = uint16_t((r << 11) | (g << 5) | b);
+    }
+}
+
+
+//ABGR <-> ARGB, flip Blue, Red channels
+static void inline cRasterSwapRB(uint32_t* buf, uint32_t len)
+{
+    for (uint32_t x = 0; x < len; ++x, ++buf) {
+        auto c = *buf;
+        *buf = (c & 0xff00ff00) + ((c & 0x00ff0000) >> 16) + ((c & 0x000000ff) << 16);
+    }
 }
\ No newline at end of file
@@ -40,6 +40,22 @@ static inline uint8x8_t ALPHA_BLEND(uint8x8_t c, uint8x8_t a)
 }
 
 
+//the same 32 bits arithmetic with the scalar INTERPOLATE() for the bit exact results
+static inline uint32x4_t INTERPOLATE(uint32x4_t s, uint32x4_t d, uint32x4_t a)
+{
+    auto AG = vdupq_n_u32(0xff00ff00);
+    auto RB = vdupq_n_u32(0x00ff00ff);
+
+    auto odd = vsubq_u32(vandq_u32(vshrq_n_u32(s, 8), RB), vandq_u32(vshrq_n_u32(d, 8), RB));
+    odd = vandq_u32(vaddq_u32(vmulq_u32(odd, a), vandq_u32(d, AG)), AG);
+
+    auto even = vsubq_u32(vandq_u32(s, RB), vandq_u32(d, RB));
+    even = vandq_u32(vaddq_u32(vshrq_n_u32(vmulq_u32(even, a), 8), vandq_u32(d, RB)), RB);
+
+    return vaddq_u32(odd, even);
+}
+
+
 static void neonRasterGrayscale8(uint8_t* dst, uint8_t val, uint32_t offset, int32_t len)
 {
     dst += offset;
@@ -137,7 +153,7 @@ static bool neonRasterTranslucentRle(SwSurface* surface, const SwRle* rle, const
             auto dst = &surface->buf8[span->y * surface->stride + x];
             if (span->coverage < 255) src = MULTIPLY(span->coverage, c.a);
             else src = c.a;
-            auto ialpha = ~c.a;
+            auto ialpha = ~src;
             for (auto x = 0; x < len; ++x, ++dst) {
                 *dst = src + MULTIPLY(*dst, ialpha);
             }
@@ -198,4 +214,117 @@ static bool neonRasterTranslucentRect(SwSurface* surface, const RenderRegion& bb
     return true;
 }
 
+
+//bilinear interpolation of a scaled image row, 4 pixels per iteration. The samples out of the image are 0.
+static uint32_t neonInterpUpScaleRow(const uint32_t* img, uint32_t stride, uint32_t w, uint32_t h, float e11, float e13, float sy, int32_t x, uint32_t len, uint32_t* out)
+{
+    auto iterations = len / 4;
+    if (iterations == 0) return 0;
+
+    auto ry = (size_t)(sy);
+    auto ry2 = ry + 1;
+    if (ry2 >= h) ry2 = h - 1;
+    auto row1 = img + ry * stride;
+    auto row2 = img + ry2 * stride;
+    auto dy = vdupq_n_u32((sy > 0.0f) ? static_cast<uint8_t>((sy - ry) * 255.0f) : 0);
+
+    const int32_t lanes[4] = {0, 1, 2, 3};
+    auto xs = vaddq_s32(vdupq_n_s32(x), vld1q_s32(lanes));
+    auto step = vdupq_n_s32(4);
+    auto scale = vdupq_n_f32(e11);
+    auto offset = vdupq_n_f32(e13);
+    auto bias = vdupq_n_f32(0.49f);
+    auto lower = vdupq_n_f32(-0.5f);
+    auto half = vdupq_n_f32(0.5f);
+    auto width = vdupq_n_s32(w);
+    auto last = vdupq_n_u32(w - 1);
+
+    for (uint32_t i = 0; i < iterations; ++i, out += 4, xs = vaddq_s32(xs, step)) {
+        auto sx = vsubq_f32(vaddq_f32(vmulq_f32(vcvtq_f32_s32(xs), scale), offset), bias);
+
+        //1. the samples must be inside the image
+        auto ix = vcvtq_s32_f32(vaddq_f32(sx, half));
+        auto valid = vandq_u32(vcgtq_f32(sx, lower), vandq_u32(vcgeq_s32(ix, vdupq_n_s32(0)), vcltq_s32(ix, width)));
+
+        //2. the sampling positions and the weights, the invalid ones fetch the first pixel
+        auto rx = vandq_u32(vreinterpretq_u32_s32(vcvtq_s32_f32(sx)), valid);
+        auto rx2 = vminq_u32(vaddq_u32(rx, vdupq_n_u32(1)), last);
+        auto dx = vreinterpretq_u32_s32(vcvtq_s32_f32(vmulq_f32(vsubq_f32(sx, vcvtq_f32_u32(rx)), vdupq_n_f32(255.0f))));
+        dx = vandq_u32(dx, vcgtq_f32(sx, vdupq_n_f32(0.0f)));
+
+        //3. interpolate
+        uint32_t p1[4], p2[4], c[4][4];
+        vst1q_u32(p1, rx);
+        vst1q_u32(p2, rx2);
+        for (int k = 0; k < 4; ++k) {
+            c[0][k] = row1[p1[k]];
+            c[1][k] = row1[p2[k]];
+            c[2][k] = row2[p1[k]];
+            c[3][k] = row2[p2[k]];
+        }
+        auto ret = INTERPOLATE(INTERPOLATE(vld1q_u32(c[3]), vld1q_u32(c[2]), dx), INTERPOLATE(vld1q_u32(c[1]), vld1q_u32(c[0]), dx), dy);
+        vst1q_u32(out, vandq_u32(ret, valid));
+    }
+
+    return iterations * 4;
+}
+
+
+//the same arithmetic with the scalar PREMULTIPLY(), 8 pixels per iteration. The opaque ones stay as they are
+static void neonRasterPremultiply(uint32_t* buf, uint32_t len)
+{
+    auto opaque = vdup_n_u8(255);
+    uint32_t x = 0;
+
+    for (; x + 8 <= len; x += 8) {
+        auto px = vld4_u8((uint8_t*)(buf + x));
+        auto keep = vceq_u8(px.val[3], opaque);
+        for (int i = 0; i < 3; ++i) {
+            px.val[i] = vbsl_u8(keep, px.val[i], ALPHA_BLEND(px.val[i], px.val[3]));
+        }
+        vst4_u8((uint8_t*)(buf + x), px);
+    }
+    cRasterPremultiply(buf + x, len - x);
+}
+
+
+//the reciprocal table lookups of rasterUnpremultiply(), 8 pixels per iteration
+static void neonRasterUnpremultiply(uint32_t* buf, uint32_t len)
+{
+    uint8_t alpha[8];
+    uint32_t recip[8];
+    uint32_t x = 0;
+
+    for (; x + 8 <= len; x += 8) {
+        auto px = vld4_u8((uint8_t*)(buf + x));
+        vst1_u8(alpha, px.val[3]);
+        for (int k = 0; k < 8; ++k) recip[k] = _unpremultiplyTable.recip[alpha[k]];
+        auto lo = vld1q_u32(recip);
+        auto hi = vld1q_u32(recip + 4);
+        auto keep = vceq_u8(px.val[3], vdup_n_u8(0));
+        for (int i = 0; i < 3; ++i) {
+            auto c = vmovl_u8(px.val[i]);
+            auto cl = vshrq_n_u32(vmulq_u32(vmovl_u16(vget_low_u16(c)), lo), 16);
+            auto ch = vshrq_n_u32(vmulq_u32(vmovl_u16(vget_high_u16(c)), hi), 16);
+            px.val[i] = vbsl_u8(keep, px.val[i], vqmovn_u16(vcombine_u16(vmovn_u32(cl), vmovn_u32(ch))));
+        }
+        vst4_u8((uint8_t*)(buf + x), px);
+    }
+    cRasterUnpremultiply(buf + x, len - x);
+}
+
+
+static void neonRasterSwapRB(uint32_t* buf, uint32_t len)
+{
+    uint32_t x = 0;
+    for (; x + 16 <= len; x += 16) {
+        auto px = vld4q_u8((uint8_t*)(buf + x));
+        auto tmp = px.val[0];
+        px.val[0] = px.val[2];
+        px.val[2] = tmp;
+        vst4q_u8((uint8_t*)(buf + x), px);
+    }
+    cRasterSwapRB(buf + x, len - x);
+}
+
 #endif
@@ -658,7 +658,9 @@ static void _calcAAEdge(AASpans *aaSpans, int32_t eidx)
 
 static void _apply(SwSurface* surface, AASpans* aaSpans)
 {
-    auto end = surface->buf32 + surface->h * surface->stride;
+    //the memory bounds of the target, the compositors and the bands are backed by their regions only
+    auto begin = surface->buf32 + surface->area.min.y * surface->stride;
+    auto end = surface->buf32 + surface->area.max.y * surface->stride;
     auto buf = surface->buf32 + surface->stride * aaSpans->yStart;
     auto y = aaSpans->yStart;
     auto line = aaSpans->lines;
@@ -693,7 +695,7 @@ static void _apply(SwSurface* surface, AASpans* aaSpans)
             pos = line->length[1];
 
             //exceptional handling. out of memory bound.
-            if (dst - pos < surface->buf32) --pos;
+            if (dst - pos < begin) --pos;
 
             while (pos > 0) {
                 *dst = INTERPOLATE(*dst, pix, 255 - (line->coverage[1] * pos));
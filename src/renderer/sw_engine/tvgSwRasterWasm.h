@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifdef THORVG_WASM_VECTOR_SUPPORT
+
+#include <wasm_simd128.h>
+
+#define N_32BITS_IN_128REG 4
+
+//the same 32 bits arithmetic with the scalar ALPHA_BLEND() for the bit exact results
+static inline v128_t ALPHA_BLEND(v128_t c, v128_t a)
+{
+    auto AG = wasm_i32x4_const_splat(0xff00ff00);
+    auto RB = wasm_i32x4_const_splat(0x00ff00ff);
+
+    a = wasm_i32x4_add(a, wasm_i32x4_const_splat(1));
+    auto odd = wasm_v128_and(wasm_i32x4_mul(wasm_v128_and(wasm_u32x4_shr(c, 8), RB), a), AG);
+    auto even = wasm_v128_and(wasm_u32x4_shr(wasm_i32x4_mul(wasm_v128_and(c, RB), a), 8), RB);
+    return wasm_v128_or(odd, even);
+}
+
+
+static void wasmRasterGrayscale8(uint8_t* dst, uint8_t val, uint32_t offset, int32_t len)
+{
+    dst += offset;
+
+    auto vVal = wasm_i8x16_splat(val);
+    int32_t i = 0;
+    for (; i <= len - 16; i += 16) {
+        wasm_v128_store(dst + i, vVal);
+    }
+    for (; i < len; ++i) {
+        dst[i] = val;
+    }
+}
+
+
+static void wasmRasterPixel32(uint32_t* dst, uint32_t val, uint32_t offset, int32_t len)
+{
+    dst += offset;
+
+    auto vVal = wasm_i32x4_splat(val);
+    int32_t i = 0;
+    for (; i <= len - N_32BITS_IN_128REG; i += N_32BITS_IN_128REG) {
+        wasm_v128_store(dst + i, vVal);
+    }
+    for (; i < len; ++i) {
+        dst[i] = val;
+    }
+}
+
+
+//the wasm memory has no alignment requirement, the spans are blended from their beginning
+static inline void _wasmBlendSpan(uint32_t* dst, uint32_t src, int32_t len)
+{
+    auto ialpha = IA(src);
+    int32_t x = 0;
+    if (len >= N_32BITS_IN_128REG) {
+        auto vSrc = wasm_i32x4_splat(src);
+        auto vIalpha = wasm_i32x4_splat(ialpha);
+        for (; x <= len - N_32BITS_IN_128REG; x += N_32BITS_IN_128REG) {
+            wasm_v128_store(dst + x, wasm_i32x4_add(vSrc, ALPHA_BLEND(wasm_v128_load(dst + x), vIalpha)));
+        }
+    }
+    for (; x < len; ++x) {
+        dst[x] = src + ALPHA_BLEND(dst[x], ialpha);
+    }
+}
+
+
+static bool wasmRasterTranslucentRect(SwSurface* surface, const RenderRegion& bbox, const RenderColor& c)
+{
+    auto h = bbox.h();
+    auto w = bbox.w();
+
+    //32bits channels
+    if (surface->channelSize == sizeof(uint32_t)) {
+        auto color = surface->join(c.r, c.g, c.b, c.a);
+        auto buffer = surface->buf32 + (bbox.min.y * surface->stride) + bbox.min.x;
+        for (uint32_t y = 0; y < h; ++y) {
+            _wasmBlendSpan(buffer + y * surface->stride, color, w);
+        }
+    //8bit grayscale
+    } else if (surface->channelSize == sizeof(uint8_t)) {
+        TVGLOG("SW_ENGINE", "Require WASM Optimization, Channel Size = %d", surface->channelSize);
+        auto buffer = surface->buf8 + (bbox.min.y * surface->stride) + bbox.min.x;
+        auto ialpha = ~c.a;
+        for (uint32_t y = 0; y < h; ++y) {
+            auto dst = &buffer[y * surface->stride];
+            for (uint32_t x = 0; x < w; ++x, ++dst) {
+                *dst = c.a + MULTIPLY(*dst, ialpha);
+            }
+        }
+    }
+    return true;
+}
+
+
+static bool wasmRasterTranslucentRle(SwSurface* surface, const SwRle* rle, const RenderRegion& bbox, const RenderColor& c)
+{
+    const SwSpan* end;
+    int32_t x, len;
+
+    //32bit channels
+    if (surface->channelSize == sizeof(uint32_t)) {
+        auto color = surface->join(c.r, c.g, c.b, c.a);
+        for (auto span = rle->fetch(bbox, &end); span < end; ++span) {
+            if (!span->fetch(bbox, x, len)) continue;
+            auto src = (span->coverage < 255) ? ALPHA_BLEND(color, span->coverage) : color;
+            _wasmBlendSpan(&surface->buf32[span->y * surface->stride + x], src, len);
+        }
+    //8bit grayscale
+    } else if (surface->channelSize == sizeof(uint8_t)) {
+        TVGLOG("SW_ENGINE", "Require WASM Optimization, Channel Size = %d", surface->channelSize);
+        uint8_t src;
+        for (auto span = rle->fetch(bbox, &end); span < end; ++span) {
+            if (!span->fetch(bbox, x, len)) continue;
+            auto dst = &surface->buf8[span->y * surface->stride + x];
+            if (span->coverage < 255) src = MULTIPLY(span->coverage, c.a);
+            else src = c.a;
+            auto ialpha = ~src;
+            for (auto x = 0; x < len; ++x, ++dst) {
+                *dst = src + MULTIPLY(*dst, ialpha);
+            }
+        }
+    }
+    return true;
+}
+
+
+static void wasmRasterSwapRB(uint32_t* buf, uint32_t len)
+{
+    uint32_t x = 0;
+    for (; x + N_32BITS_IN_128REG <= len; x += N_32BITS_IN_128REG) {
+        auto px = wasm_v128_load(buf + x);
+        wasm_v128_store(buf + x, wasm_i8x16_shuffle(px, px, 2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15));
+    }
+    cRasterSwapRB(buf + x, len - x);
+}
+
+#endif
@@ -27,6 +27,8 @@
 #include <atomic>
 #include "tvgSwCommon.h"
 #include "tvgTaskScheduler.h"
+#include "tvgLock.h"
+#include "tvgTrace.h"
 #include "tvgSwRenderer.h"
 
 /************************************************************************/
@@ -34,7 +36,13 @@
 /************************************************************************/
 static atomic<int32_t> rendererCnt{-1};
 static SwMpool* globalMpool = nullptr;
+static SwGlyphAtlas* globalAtlas = nullptr;
 static uint32_t threadsCnt = 0;
+static atomic<uint32_t> trimCnt{0};   //the requests of releasing the idle memory, see trim()
+static Key engineKey;                 //the renderers come and go on the multiple threads with the isolated canvases
+
+static constexpr uint32_t TILING_SIZE = 1024 * 1024;   //minimum surface size(w * h) for the tiled rasterization
+static constexpr int32_t STROKE_FORK_SIZE = 256 * 256;  //minimum shape size(w * h) to generate its stroke on another worker
 
 struct SwTask : Task
 {
@@ -45,13 +53,15 @@ struct SwTask : Task
     Matrix transform;
     Array<RenderData> clips;
     RenderDirtyRegion* dirtyRegion;
+    RenderDirtyRegion::Scope dirtyScope;  //the damages spread out by the post effects of the ancestors
+    RenderProfile* profile = nullptr;
     RenderUpdateFlag flags = RenderUpdateFlag::None;
     uint8_t opacity;
     bool pushed : 1;                  //Pushed into task list?
     bool disposed : 1;                //Disposed task?
     bool nodirty : 1;                 //target for partial rendering?
 
-    SwTask() : pushed(false), disposed(false) {}
+    SwTask() : pushed(false), disposed(false), nodirty(true) {}
 
     const RenderRegion& bounds()
     {
@@ -62,9 +72,15 @@ struct SwTask : Task
     void invisible()
     {
         curBox.reset();
-        if (!nodirty) dirtyRegion->add(prvBox, curBox);
+        if (!nodirty) dirtyRegion->add(prvBox, curBox, dirtyScope);
     }
 
+    //apply the change in place if it doesn't need the task run, see SwRenderer::prepareCommon()
+    virtual bool recolor() { return false; }
+    //the drawing fully covers the current region with the opaque pixels, see SwRenderer::occluder()
+    virtual bool opaque() { return false; }
+    //the drawing covers the region within the current one, see SwRenderer::intersects()
+    virtual bool intersects(TVG_UNUSED const RenderRegion& region) { return true; }
     virtual void dispose() = 0;
     virtual bool clip(SwRle* target) = 0;
     virtual ~SwTask() {}
@@ -73,9 +89,40 @@ struct SwTask : Task
 
 struct SwShapeTask : SwTask
 {
+    //generates the stroke on another worker along with the fill, see run()
+    struct Stroker : Task
+    {
+        SwShapeTask* owner;
+        RenderRegion renderBox;
+        bool ret;
+        bool clipped;  //survived all the clippers
+
+        void run(unsigned tid) override
+        {
+            MemoryScope memory(MemoryCategory::Engine);
+            ret = owner->stroke(renderBox, tid);
+            clipped = true;
+            if (!ret || !owner->shape.strokeRle) return;
+            ARRAY_FOREACH(p, owner->clips) {
+                if (!static_cast<SwTask*>(*p)->clip(owner->shape.strokeRle)) clipped = false;
+            }
+        }
+    };
+
     SwShape shape;
+    Stroker stroker;
     const RenderShape* rshape = nullptr;
+    Matrix rleTransform;               //the transform of the current rle
+    RenderRegion rleBox;               //the rendering region of the current rle
+    RenderRegion rleArea;              //the target region(curBox) of the current rle, invalid if the rle is outdated
     bool clipper = false;
+    bool translatable = false;         //the current rle is not clipped, see translate()
+    bool rleFill = false;              //the current rle has the fill
+    bool rleStroke = false;            //the current rle has the stroke
+    bool rleAntiAlias = false;         //the current rle is antialiased
+    bool rleTiles = false;             //the current fill is generated in the tiles
+    bool coverTiles = false;           //the fill is rasterized in the tiles if possible, see SwCanvas::tiles()
+    float tolerance = FLATNESS_TOLERANCE;  //the curve flattening tolerance of the renderer
 
     /* We assume that if the stroke width is greater than 2,
        the shape's outline beneath the stroke could be adequately covered by the stroke drawing.
@@ -99,6 +146,39 @@ struct SwShapeTask : SwTask
         return (width * sqrt(transform.e11 * transform.e11 + transform.e12 * transform.e12));
     }
 
+    static bool inside(const RenderRegion& box, const RenderRegion& clipBox)
+    {
+        return box.min.x > clipBox.min.x && box.min.y > clipBox.min.y && box.max.x < clipBox.max.x && box.max.y < clipBox.max.y;
+    }
+
+    //fast track: the translation by whole pixels just moves the current rles
+    bool translate(RenderRegion& renderBox, bool fill, bool stroke)
+    {
+        if (!translatable || rleTiles || clipper || clips.count > 0 || fill != rleFill || stroke != rleStroke) return false;
+        if (!(flags & RenderUpdateFlag::Transform) || (flags & (RenderUpdateFlag::Path | RenderUpdateFlag::Clip | RenderUpdateFlag::Stroke))) return false;
+
+        auto& m = rleTransform;
+        if (m.e11 != transform.e11 || m.e12 != transform.e12 || m.e21 != transform.e21 || m.e22 != transform.e22) return false;
+        if (m.e31 != transform.e31 || m.e32 != transform.e32 || m.e33 != transform.e33) return false;
+
+        auto dx = transform.e13 - m.e13;
+        auto dy = transform.e23 - m.e23;
+        if (dx != floorf(dx) || dy != floorf(dy) || fabsf(dx) > float(curBox.w()) || fabsf(dy) > float(curBox.h())) return false;
+
+        auto x = int32_t(dx);
+        auto y = int32_t(dy);
+        RenderRegion box = {{rleBox.min.x + x, rleBox.min.y + y}, {rleBox.max.x + x, rleBox.max.y + y}};
+
+        //the moved rles must not be clipped as well
+        if (!inside(box, curBox)) return false;
+
+        rleTranslate(shape.rle, x, y);
+        rleTranslate(shape.strokeRle, x, y);
+        shape.bbox = {{shape.bbox.min.x + x, shape.bbox.min.y + y}, {shape.bbox.max.x + x, shape.bbox.max.y + y}};
+        renderBox = box;
+        return true;
+    }
+
     bool clip(SwRle* target) override
     {
         if (shape.strokeRle) return rleClip(target, shape.strokeRle);
@@ -107,71 +187,212 @@ struct SwShapeTask : SwTask
         return false;
     }
 
+    bool intersects(const RenderRegion& region) override
+    {
+        if (rleFill) {
+            if (shape.fastTrack) {
+                if (region.intersected(shape.bbox)) return true;
+            } else if (rleIntersects(shape.rle, region) || tilesIntersects(shape.tiles, region)) return true;
+        }
+        return rleStroke && rleIntersects(shape.strokeRle, region);
+    }
+
+    //the solid opaque rectangle without the stroke
+    bool opaque() override
+    {
+        if (opacity < 255 || clipper || clips.count > 0 || !shape.fastTrack || !rleFill || shape.strokeRle) return false;
+        return !rshape->fill && rshape->color.a == 255;
+    }
+
+    //the color only change of the solid shape keeps the current rles, same as run() does
+    bool recolor() override
+    {
+        if (flags != RenderUpdateFlag::Color || clipper) return false;
+
+        if (opacity == 0) {
+            invisible();
+            translatable = false;
+            rleArea.reset();
+            return true;
+        }
+
+        if (rshape->fill || (shape.strokeRle && rshape->strokeFill())) return false;
+
+        auto strokeWidth = validStrokeWidth(false);
+        auto antiAlias = antialiasing(strokeWidth);
+        auto fill = MULTIPLY(rshape->color.a, opacity) > 0;
+        if (!fill || fill != rleFill || antiAlias != rleAntiAlias || !rleArea.valid() || !(rleArea == curBox)) return false;
+
+        translatable = false;
+        rleTransform = transform;
+        rleStroke = strokeWidth > 0.0f;
+
+        curBox = rleBox;
+        if (!nodirty) dirtyRegion->add(prvBox, curBox, dirtyScope);
+
+        if (profile) {
+            profile->count(RenderProfile::Shapes);
+            profile->count(RenderProfile::Spans, spans());
+        }
+        return true;
+    }
+
+    //the spans and the tiles of the current rles
+    uint32_t spans() const
+    {
+        return (shape.rle ? shape.rle->size() : 0) + (shape.tiles ? shape.tiles->size() : 0) + (shape.strokeRle ? shape.strokeRle->size() : 0);
+    }
+
+    //the stroke rle and its fill. it only reads the outline of the fill, if any
+    bool stroke(RenderRegion& renderBox, unsigned tid)
+    {
+        shapeResetStroke(&shape, rshape, transform);
+        if (!shapeGenStrokeRle(&shape, rshape, transform, curBox, renderBox, tolerance, mpool, tid)) return false;
+        if (auto fill = rshape->strokeFill()) {
+            auto ctable = ((flags & RenderUpdateFlag::GradientStroke) || !shape.stroke->fill) ? true : false;
+            if (ctable) shapeResetStrokeFill(&shape);
+            if (!shapeGenStrokeFillColors(&shape, fill, transform, surface, opacity, ctable)) return false;
+        }
+        return true;
+    }
+
+    //the stroke of the large shape is worth another worker while the fill rle is generated
+    bool forkable(const RenderRegion& renderBox)
+    {
+        if (TaskScheduler::threads() == 0 || !shape.outline || shape.fastTrack || shape.primitive) return false;
+        return renderBox.w() * renderBox.h() >= STROKE_FORK_SIZE;
+    }
+
     void run(unsigned tid) override
     {
+        RenderProfileScope scope(profile, RenderProfile::Prepare);
+        MemoryScope memory(MemoryCategory::Engine);
+        TaskGroup group;
+        auto forked = false;
+
         //invisible
         if (opacity == 0 && !clipper) {
             if (flags & RenderUpdateFlag::Color) invisible();
+            translatable = false;
+            rleArea.reset();
             return;
         }
 
         auto strokeWidth = validStrokeWidth(clipper);
         RenderRegion renderBox{};
-        auto updateShape = flags & (RenderUpdateFlag::Path | RenderUpdateFlag::Transform | RenderUpdateFlag::Clip);
+        auto translated = translate(renderBox, MULTIPLY(rshape->color.a, opacity) || rshape->fill, strokeWidth > 0.0f);
+        auto updateShape = !translated && (flags & (RenderUpdateFlag::Path | RenderUpdateFlag::Transform | RenderUpdateFlag::Clip));
+        auto updateStroke = updateShape || (flags & RenderUpdateFlag::Stroke);
         auto updateFill = false;
+        auto antiAlias = antialiasing(strokeWidth);
+        auto tiles = coverTiles && !clipper && clips.count == 0 && !rshape->fill;   //the tiles are drawn by the solid color kernels only
+        auto clipFill = false;     //the newly generated rles are clipped
+        auto clipStroke = false;
 
         //Shape
-        if (updateShape || flags & (RenderUpdateFlag::Color | RenderUpdateFlag::Gradient)) {
+        if (translated) {
+            updateFill = rleFill;
+        } else if (updateShape || flags & (RenderUpdateFlag::Color | RenderUpdateFlag::Gradient)) {
             updateFill = (MULTIPLY(rshape->color.a, opacity) || rshape->fill);
-            if (updateShape) shapeReset(&shape);
-            if (updateFill || clipper) {
-                if (shapePrepare(&shape, rshape, transform, curBox, renderBox, mpool, tid, clips.count > 0 ? true : false)) {
-                    if (!shapeGenRle(&shape, rshape, antialiasing(strokeWidth))) goto err;
-                } else {
-                    updateFill = false;
-                    renderBox.reset();
+            //the geometry is unchanged, the current (clipped) rle is still valid
+            if (!updateShape && (updateFill || clipper) && updateFill == rleFill && antiAlias == rleAntiAlias && tiles == rleTiles && rleArea.valid() && rleArea == curBox) {
+                renderBox = rleBox;
+            } else {
+                shapeReset(&shape);   //rleRender() appends the spans to the current rle
+                rleArea.reset();
+                rleTiles = false;
+                if (updateFill || clipper) {
+                    clipFill = true;
+                    if (globalAtlas && strokeWidth == 0.0f && glyphCacheable(rshape, transform)) {
+                        tiles = false;
+                        if (!glyphGenRle(globalAtlas, &shape, rshape, transform, curBox, renderBox, mpool, tid)) updateFill = false;
+                    } else if (shapePrepare(&shape, rshape, transform, curBox, renderBox, tolerance, mpool, tid, clips.count > 0 ? true : false)) {
+                        if (updateStroke && strokeWidth > 0.0f && forkable(renderBox)) {
+                            stroker.owner = this;
+                            stroker.renderBox = renderBox;
+                            group.request(&stroker);
+                            forked = true;
+                        }
+                        if (!shapeGenRle(&shape, rshape, antiAlias, tolerance, tiles, mpool, tid)) goto err;
+                    } else {
+                        updateFill = false;
+                        renderBox.reset();
+                    }
+                    rleArea = curBox;
+                    rleTiles = tiles;
                 }
             }
+        //the composition only changes (blending, masking), the current rles are kept
+        } else {
+            updateFill = rleFill;
+            renderBox = rleBox;
         }
         //Fill
         if (updateFill) {
             if (auto fill = rshape->fill) {
-                auto ctable = (flags & RenderUpdateFlag::Gradient) ? true : false;
+                //no fill yet if the former preparations were out of the surface
+                auto ctable = ((flags & RenderUpdateFlag::Gradient) || !shape.fill) ? true : false;
                 if (ctable) shapeResetFill(&shape);
                 if (!shapeGenFillColors(&shape, fill, transform, surface, opacity, ctable)) goto err;
             }
         }
         //Stroke
-        if (updateShape || flags & RenderUpdateFlag::Stroke) {
+        if (forked) {
+            group.wait();
+            if (!stroker.ret) goto err;
+            renderBox = stroker.renderBox;
+        } else if (updateStroke) {
             if (strokeWidth > 0.0f) {
-                shapeResetStroke(&shape, rshape, transform);
-                if (!shapeGenStrokeRle(&shape, rshape, transform, curBox, renderBox, mpool, tid)) goto err;
-                if (auto fill = rshape->strokeFill()) {
-                    auto ctable = (flags & RenderUpdateFlag::GradientStroke) ? true : false;
-                    if (ctable) shapeResetStrokeFill(&shape);
-                    if (!shapeGenStrokeFillColors(&shape, fill, transform, surface, opacity, ctable)) goto err;
-                }
+                if (!stroke(renderBox, tid)) goto err;
+                clipStroke = true;
             } else {
                 shapeDelStroke(&shape);
             }
+        } else if ((translated || (flags & RenderUpdateFlag::Color)) && shape.strokeRle) {
+            //the kept stroke follows the moved gradient or the changed opacity, it still covers the last region
+            if (!translated) renderBox = rleBox;
+            if (auto fill = rshape->strokeFill()) {
+                if (!shapeGenStrokeFillColors(&shape, fill, transform, surface, opacity, false)) goto err;
+            }
         }
 
         //Clear current task memorypool here if the clippers would use the same memory pool
         shapeDelOutline(&shape, mpool, tid);
 
-        //Clip Path
-        ARRAY_FOREACH(p, clips) {
-            auto clipper = static_cast<SwTask*>(*p);
-            auto clipShapeRle = shape.rle ? clipper->clip(shape.rle) : true;
-            auto clipStrokeRle = shape.strokeRle ? clipper->clip(shape.strokeRle) : true;
-            if (!clipShapeRle && !clipStrokeRle) goto err;
+        //Clip Path, the kept rles were clipped already
+        if (clipFill || clipStroke) {
+            auto fillClipped = true;
+            ARRAY_FOREACH(p, clips) {
+                auto clipper = static_cast<SwTask*>(*p);
+                auto clipShapeRle = (clipFill && shape.rle) ? clipper->clip(shape.rle) : true;
+                auto clipStrokeRle = (clipStroke && shape.strokeRle) ? clipper->clip(shape.strokeRle) : true;
+                if (!clipShapeRle && !clipStrokeRle) goto err;
+                if (!clipShapeRle) fillClipped = false;
+            }
+            //the forked stroke was clipped by itself
+            if (forked && !fillClipped && !stroker.clipped) goto err;
         }
 
+        translatable = ((updateShape || translated) && clips.count == 0 && inside(renderBox, curBox));
+        rleTransform = transform;
+        rleBox = renderBox;
+        rleFill = updateFill;
+        rleStroke = strokeWidth > 0.0f;
+        rleAntiAlias = antiAlias;
+
         curBox = renderBox; //sync
-        if (!nodirty) dirtyRegion->add(prvBox, curBox);
+        if (!nodirty) dirtyRegion->add(prvBox, curBox, dirtyScope);
+
+        if (profile) {
+            profile->count(RenderProfile::Shapes);
+            profile->count(RenderProfile::Spans, spans());
+        }
         return;
 
     err:
+        group.wait();
+        translatable = false;
+        rleArea.reset();
         shapeReset(&shape);
         rleReset(shape.strokeRle);
         shapeDelOutline(&shape, mpool, tid);
@@ -188,22 +409,46 @@ struct SwShapeTask : SwTask
 struct SwImageTask : SwTask
 {
     SwImage image;
+    SwMipmap mipmap;
     RenderSurface* source;                //Image source
 
+    bool recolor() override
+    {
+        if (flags != RenderUpdateFlag::Color || opacity > 0) return false;
+        invisible();
+        return true;
+    }
+
     bool clip(SwRle* target) override
     {
         TVGERR("SW_ENGINE", "Image is used as ClipPath?");
         return true;
     }
 
+    //the clipped or rotated image has its coverage, otherwise it fills the current region
+    bool intersects(const RenderRegion& region) override
+    {
+        if (image.rle) return rleIntersects(image.rle, region);
+        return true;
+    }
+
     void run(unsigned tid) override
     {
+        RenderProfileScope scope(profile, RenderProfile::Prepare);
+        MemoryScope memory(MemoryCategory::Engine);
+
         //invisible
         if (opacity == 0) {
             if (flags & RenderUpdateFlag::Color) invisible();
             return;
         }
 
+        //gpu textures are not accessible
+        if (source->native) {
+            invisible();
+            return;
+        }
+
         auto clipBox = curBox;
 
         //Convert colorspace if it's not aligned.
@@ -219,10 +464,15 @@ struct SwImageTask : SwTask
         //Invisible shape turned to visible by alpha.
         if ((flags & (RenderUpdateFlag::Image | RenderUpdateFlag::Transform | RenderUpdateFlag::Color)) && (opacity > 0)) {
             imageReset(&image);
+            if (flags & RenderUpdateFlag::Image) imageFreeMipmap(&mipmap);
+            mipmap.level = 0;
             if (!image.data || image.w == 0 || image.h == 0) goto end;
             if (!imagePrepare(&image, transform, clipBox, curBox, mpool, tid)) goto end;
-            if (clips.count > 0) {
-                if (!imageGenRle(&image, curBox, false)) goto end;
+            imageGenMipmap(&image, &mipmap);
+            //the rotated or skewed image is sampled along its anti-aliased spans
+            auto transformed = !image.direct && !image.scaled;
+            if (clips.count > 0 || transformed) {
+                if (!imageGenRle(&image, curBox, transformed, mpool, tid)) goto end;
                 if (image.rle) {
                     //Clear current task memorypool here if the clippers would use the same memory pool
                     imageDelOutline(&image, mpool, tid);
@@ -230,9 +480,13 @@ struct SwImageTask : SwTask
                         auto clipper = static_cast<SwTask*>(*p);
                         if (!clipper->clip(image.rle)) goto err;
                     }
-                    if (!nodirty) dirtyRegion->add(prvBox, curBox);
+                    if (!nodirty) dirtyRegion->add(prvBox, curBox, dirtyScope);
                     return;
                 }
+            //the rle of the previous condition must not be taken
+            } else if (image.rle) {
+                imageFree(&image);
+                image.rle = nullptr;
             }
         }
         goto end;
@@ -241,12 +495,113 @@ struct SwImageTask : SwTask
         rleReset(image.rle);
     end:
         imageDelOutline(&image, mpool, tid);
-        if (!nodirty) dirtyRegion->add(prvBox, curBox);
+        if (!nodirty) dirtyRegion->add(prvBox, curBox, dirtyScope);
     }
 
     void dispose() override
     {
        imageFree(&image);
+       imageFreeMipmap(&mipmap);
+    }
+};
+
+
+static void _rasterFill(SwShapeTask* task, SwSurface* surface, const RenderRegion& bbox)
+{
+    if (auto fill = task->rshape->fill) {
+        rasterGradientShape(surface, &task->shape, bbox, fill, task->opacity);
+    } else {
+        RenderColor c;
+        task->rshape->fillColor(&c.r, &c.g, &c.b, &c.a);
+        c.a = MULTIPLY(task->opacity, c.a);
+        if (c.a > 0) rasterShape(surface, &task->shape, bbox, c);
+    }
+}
+
+
+static void _rasterStroke(SwShapeTask* task, SwSurface* surface, const RenderRegion& bbox)
+{
+    if (auto strokeFill = task->rshape->strokeFill()) {
+        rasterGradientStroke(surface, &task->shape, bbox, strokeFill, task->opacity);
+    } else {
+        RenderColor c;
+        if (task->rshape->strokeFill(&c.r, &c.g, &c.b, &c.a)) {
+            c.a = MULTIPLY(task->opacity, c.a);
+            if (c.a > 0) rasterStroke(surface, &task->shape, bbox, c);
+        }
+    }
+}
+
+
+//the region to rasterize on the current target, the compositors are backed by their regions only
+static RenderRegion _clip(const SwSurface* surface, const RenderRegion& bbox)
+{
+    auto ret = RenderRegion::intersect(bbox, surface->area);
+    //the masking reads the compositor at the same positions
+    if (surface->compositor && surface->compositor->method != MaskMethod::None) ret = RenderRegion::intersect(ret, surface->compositor->bbox);
+    return ret;
+}
+
+
+//the region to be drawn in the current frame?
+static bool _damaged(RenderDirtyRegion& dirtyRegion, const RenderRegion& bbox, bool fulldraw)
+{
+    if (fulldraw || dirtyRegion.deactivated()) return true;
+
+    for (uint32_t idx = 0; idx < dirtyRegion.count(); ++idx) {
+        if (!dirtyRegion.partition(idx).intersected(bbox)) continue;
+        ARRAY_FOREACH(p, dirtyRegion.get(idx)) {
+            if (bbox.max.x <= p->min.x) break;   //dirtyRegion is sorted in x order
+            if (bbox.intersected(*p)) return true;
+        }
+    }
+    return false;
+}
+
+
+//accumulate the written region of the target, see request()
+static void _mark(SwSurface* surface, const RenderRegion& bbox)
+{
+    //the masking may compose the whole compositor region into the target
+    auto& region = (surface->compositor && (int)surface->compositor->method >= (int)MaskMethod::Add) ? surface->compositor->bbox : bbox;
+    if (surface->dirty.invalid()) surface->dirty = region;
+    else surface->dirty.add(region);
+}
+
+
+//pixels of the pooled compositor memory, rounded up to the power of two size classes
+static uint32_t _sizeClass(uint32_t size)
+{
+    uint32_t ret = 4096;
+    while (ret < size) ret <<= 1;
+    return ret;
+}
+
+
+//deferred shape rasterization command for the tiled mode
+struct SwRasterCmd
+{
+    SwShapeTask* task;
+    RenderRegion bbox;
+    bool stroke;
+};
+
+
+//rasterize the deferred commands in painter's order within a disjoint band of the surface
+struct SwRasterTask : Task
+{
+    const Array<SwRasterCmd>* cmds;
+    SwSurface* surface;
+    RenderRegion band;
+
+    void run(TVG_UNUSED unsigned tid) override
+    {
+        ARRAY_FOREACH(p, *cmds) {
+            if (!p->bbox.intersected(band)) continue;
+            auto bbox = RenderRegion::intersect(p->bbox, band);
+            if (p->stroke) _rasterStroke(p->task, surface, bbox);
+            else _rasterFill(p->task, surface, bbox);
+        }
     }
 };
 
@@ -255,10 +610,11 @@ struct SwImageTask : SwTask
 /* External Class Implementation                                        */
 /************************************************************************/
 
-SwRenderer::SwRenderer()
+SwRenderer::SwRenderer(bool isolated)
 {
-    if (TaskScheduler::onthread()) {
-        TVGLOG("SW_RENDERER", "Running on a non-dominant thread!, Renderer(%p)", this);
+    //the shared pool is indexed by the thread of the tasks, the other threads drawing at once would conflict
+    if (isolated || TaskScheduler::onthread()) {
+        if (!isolated) TVGLOG("SW_RENDERER", "Running on a non-dominant thread!, Renderer(%p)", this);
         mpool = mpoolInit(threadsCnt);
         sharedMpool = false;
     } else {
@@ -272,9 +628,19 @@ SwRenderer::SwRenderer()
 
 SwRenderer::~SwRenderer()
 {
+    flush();
     clearCompositors();
 
+    ARRAY_FOREACH(p, retains) {
+        tvg::free((*p)->compositor->image.data);
+        delete((*p)->compositor);
+        delete(*p);
+    }
+
+    ARRAY_FOREACH(p, bins) delete(*p);
+
     delete(surface);
+    tvg::free(packed.work);
 
     if (!sharedMpool) mpoolTerm(mpool);
 
@@ -284,23 +650,37 @@ SwRenderer::~SwRenderer()
 
 bool SwRenderer::clear()
 {
-    if (surface) {
+    flush();
+
+    if (!surface) return false;
+
+    //the bands are cleared one by one, see preRender()
+    if (banded.callback) {
         fulldraw = true;
-        return rasterClear(surface, 0, 0, surface->w, surface->h);
+        return true;
     }
-    return false;
+
+    //the partial frame keeps the rest of the previous one, only the damaged regions are cleared in preRender()
+    if (!fulldraw && !dirtyRegion.deactivated()) {
+        clearing = true;
+        return true;
+    }
+
+    fulldraw = true;
+    return rasterClear(surface, 0, 0, surface->w, surface->h);
 }
 
 
 bool SwRenderer::sync()
 {
+    group.wait();
+
+    banded.y = 0;
+
     //clear if the rendering was not triggered.
     ARRAY_FOREACH(p, tasks) {
         if ((*p)->disposed) delete(*p);
-        else {
-            (*p)->done();
-            (*p)->pushed = false;
-        }
+        else (*p)->pushed = false;
     }
     tasks.clear();
 
@@ -308,11 +688,59 @@ bool SwRenderer::sync()
 }
 
 
-bool SwRenderer::target(pixel_t* data, uint32_t stride, uint32_t w, uint32_t h, ColorSpace cs)
+bool SwRenderer::detach()
+{
+    //the worker drawing this must not block on the preparations queued by the calling thread
+    group.wait();
+    return true;
+}
+
+
+bool SwRenderer::next()
+{
+    if (!banded.callback) return false;
+
+    banded.y += banded.lines;
+    if (banded.y < int32_t(surface->h)) return true;
+
+    banded.y = 0;
+    return false;
+}
+
+
+bool SwRenderer::target(pixel_t* data, uint32_t stride, uint32_t w, uint32_t h, ColorSpace cs, uint32_t lines, BandFlush callback, void* userData)
 {
     if (!data || stride == 0 || w == 0 || h == 0 || w > stride) return false;
+    if (callback && lines == 0) return false;
 
+    flush();
     clearCompositors();
+    ++epoch;
+
+    //the main surface is backed by a band only in the banded mode
+    auto rows = callback ? std::min(lines, h) : h;
+
+    banded.target = data;
+    banded.callback = callback;
+    banded.data = userData;
+    banded.lines = rows;
+    banded.y = 0;
+
+    tvg::free(packed.work);
+    packed.work = nullptr;
+    packed.buf = nullptr;
+
+    if (cs == ColorSpace::RGB565) {
+        packed.buf = reinterpret_cast<uint16_t*>(data);
+        packed.stride = stride;
+        packed.work = tvg::calloc<pixel_t*>(w * rows, sizeof(pixel_t));
+        packed.full = true;
+        data = packed.work;
+        stride = w;
+        cs = ColorSpace::ARGB8888;
+    }
+
+    banded.buf = data;
 
     if (!surface) surface = new SwSurface;
 
@@ -323,17 +751,43 @@ bool SwRenderer::target(pixel_t* data, uint32_t stride, uint32_t w, uint32_t h,
     surface->cs = cs;
     surface->channelSize = CHANNEL_SIZE(cs);
     surface->premultiplied = true;
+    surface->area = {{0, 0}, {int32_t(w), int32_t(rows)}};
 
     dirtyRegion.init(w, h);
 
     fulldraw = true;  //reset the screen
+    tiling = (threadsCnt > 0 && w * rows >= TILING_SIZE);
 
     return rasterCompositor(surface);
 }
 
 
+void SwRenderer::dither(bool on)
+{
+    if (packed.dither == on) return;
+    packed.dither = on;
+    packed.full = true;
+}
+
+
+//the shapes generate their coverage again with the next update
+bool SwRenderer::tiles(bool on)
+{
+    if (coverTiles == on) return false;
+    coverTiles = on;
+    return true;
+}
+
+
 bool SwRenderer::preUpdate()
 {
+    //release the idle memory of this renderer as requested, no task is using it in between the frames
+    if (trimmed != trimCnt && tasks.empty()) {
+        clearCompositors();
+        if (!sharedMpool) mpoolClear(mpool);
+        trimmed = trimCnt;
+    }
+
     return surface != nullptr;
 }
 
@@ -347,16 +801,42 @@ bool SwRenderer::postUpdate()
 bool SwRenderer::preRender()
 {
     if (!surface) return false;
-    if (fulldraw || dirtyRegion.deactivated()) return true;
 
-    ARRAY_FOREACH(p, tasks) (*p)->done();
+    /* Select the current band. The origin is shifted by the band as the compositors,
+       so that the raster paths address it in the target coordinates, see request(). */
+    if (banded.callback) {
+        auto y = banded.y;
+        if (y == 0) {
+            damaged.clear();
+            damaged.push(RenderRegion::intersect(vport, {{0, 0}, {int32_t(surface->w), int32_t(surface->h)}}));
+        }
+        surface->data = (pixel_t*)((uint8_t*)banded.buf - y * surface->stride * surface->channelSize);
+        surface->area = {{0, y}, {int32_t(surface->w), std::min(y + int32_t(banded.lines), int32_t(surface->h))}};
+        fulldraw = true;
+        return rasterClear(surface, 0, y, surface->w, surface->area.h());
+    }
+
+    damaged.clear();
+
+    auto clearing = this->clearing;
+    this->clearing = false;
+
+    if (fulldraw || dirtyRegion.deactivated()) {
+        //the partial rendering is turned off during the update
+        if (clearing && !fulldraw) rasterClear(surface, 0, 0, surface->w, surface->h);
+        damaged.push(RenderRegion::intersect(vport, {{0, 0}, {int32_t(surface->w), int32_t(surface->h)}}));
+        return true;
+    }
+
+    group.wait();
 
     dirtyRegion.commit();
 
     //clear buffer for partial regions
-    for (int idx = 0; idx < RenderDirtyRegion::PARTITIONING; ++idx) {
+    for (uint32_t idx = 0; idx < dirtyRegion.count(); ++idx) {
         ARRAY_FOREACH(p, dirtyRegion.get(idx)) {
             rasterClear(surface, p->x(), p->y(), p->w(), p->h());
+            damaged.push(*p);
         }
     }
 
@@ -368,7 +848,8 @@ void SwRenderer::clearCompositors()
 {
     //Free Composite Caches
     ARRAY_FOREACH(p, compositors) {
-        tvg::free((*p)->compositor->image.data);
+        auto cmp = (*p)->compositor;
+        tvg::free(cmp->buffer ? cmp->buffer : cmp->image.data);
         delete((*p)->compositor);
         delete(*p);
     }
@@ -378,11 +859,26 @@ void SwRenderer::clearCompositors()
 
 bool SwRenderer::postRender()
 {
+    flush();
+
     //Unmultiply alpha if needed
     if (surface->cs == ColorSpace::ABGR8888S || surface->cs == ColorSpace::ARGB8888S) {
         rasterUnpremultiply(surface);
     }
 
+    //Pack the updated regions into the user target, which is shifted by the band as well
+    if (packed.buf) {
+        auto dst = packed.buf - surface->area.min.y * packed.stride;
+        if (fulldraw || packed.full) {
+            rasterPack565(surface, dst, packed.stride, surface->area, packed.dither);
+        } else {
+            ARRAY_FOREACH(p, damaged) rasterPack565(surface, dst, packed.stride, *p, packed.dither);
+        }
+        packed.full = false;
+    }
+
+    if (banded.callback) banded.callback(banded.target, surface->area.min.y, surface->area.h(), banded.data);
+
     dirtyRegion.clear();
     fulldraw = false;
 
@@ -394,7 +890,7 @@ void SwRenderer::damage(RenderData rd, const RenderRegion& region)
 {
     SwTask* task = static_cast<SwTask*>(rd);
     if (dirtyRegion.deactivated() || (task && task->opacity == 0)) return;
-    dirtyRegion.add(region);
+    dirtyRegion.add(region, task ? task->dirtyScope : dirtyRegion.scope);
 }
 
 
@@ -404,30 +900,47 @@ bool SwRenderer::partial(bool disable)
 }
 
 
+RenderDirtyRegion::Scope SwRenderer::scope(const RenderRegion& extend, const RenderRegion* clip)
+{
+    return dirtyRegion.push(extend, clip);
+}
+
+
+void SwRenderer::scope(const RenderDirtyRegion::Scope& former)
+{
+    dirtyRegion.pop(former);
+}
+
+
+bool SwRenderer::damages(const RenderRegion** regions, uint32_t* cnt)
+{
+    *regions = damaged.data;
+    *cnt = damaged.count;
+    return true;
+}
+
+
 bool SwRenderer::renderImage(RenderData data)
 {
     auto task = static_cast<SwImageTask*>(data);
     task->done();
 
-    if (task->opacity == 0) return true;
+    if (task->opacity == 0 || task->source->native) return true;
+
+    flush();
 
-    auto raster = [&](SwSurface* surface, const SwImage& image, const Matrix& transform, const RenderRegion& bbox, uint8_t opacity) {
+    RenderProfileScope scope(profile, RenderProfile::Raster);
+
+    auto raster = [&](SwSurface* surface, const SwImage& image, const Matrix& transform, const RenderRegion& region, uint8_t opacity) {
+        auto bbox = _clip(surface, region);
         if (bbox.invalid() || bbox.x() >= surface->w || bbox.y() >= surface->h) return true;
+        _mark(surface, bbox);
 
         //RLE Image
         if (image.rle) {
             if (image.direct) return rasterDirectRleImage(surface, image, bbox, opacity);
             else if (image.scaled) return rasterScaledRleImage(surface, image, transform, bbox, opacity);
-            else {
-                //create a intermediate buffer for rle clipping
-                auto cmp = request(sizeof(pixel_t), false);
-                cmp->compositor->method = MaskMethod::None;
-                cmp->compositor->valid = true;
-                cmp->compositor->image.rle = image.rle;
-                rasterClear(cmp, bbox.x(), bbox.y(), bbox.w(), bbox.h());
-                rasterTexmapPolygon(cmp, image, transform, bbox, 255);
-                return rasterDirectRleImage(surface, cmp->compositor->image, bbox, opacity);
-            }
+            else return rasterTransformedRleImage(surface, image, transform, bbox, opacity);
         //Whole Image
         } else {
             if (image.direct) return rasterDirectImage(surface, image, bbox, opacity);
@@ -436,17 +949,22 @@ bool SwRenderer::renderImage(RenderData data)
         }
     };
 
+    //the downscaled image samples its smaller copy
+    auto image = task->image;
+    auto transform = task->transform;
+    imageSelectMipmap(&task->mipmap, image, transform);
+
     //full scene or partial rendering
     if (fulldraw || task->nodirty || task->pushed || dirtyRegion.deactivated()) {
-        raster(surface, task->image, task->transform, task->curBox, task->opacity);
+        raster(surface, image, transform, task->curBox, task->opacity);
     } else {
-        for (int idx = 0; idx < RenderDirtyRegion::PARTITIONING; ++idx) {
+        for (uint32_t idx = 0; idx < dirtyRegion.count(); ++idx) {
             if (!dirtyRegion.partition(idx).intersected(task->curBox)) continue;
             ARRAY_FOREACH(p, dirtyRegion.get(idx)) {
-                if (task->curBox.min.x >= p->max.x) break;  //dirtyRegion is sorted in x order
+                if (task->curBox.max.x <= p->min.x) break;  //dirtyRegion is sorted in x order
                 if (task->curBox.intersected(*p)) {
                     auto bbox = RenderRegion::intersect(task->curBox, *p);
-                    raster(surface, task->image, task->transform, bbox, task->opacity);
+                    raster(surface, image, transform, bbox, task->opacity);
                 }
             }
         }
@@ -467,27 +985,26 @@ bool SwRenderer::renderShape(RenderData data)
 
     if (task->opacity == 0) return true;
 
-    auto fill = [](SwShapeTask* task, SwSurface* surface, const RenderRegion& bbox) {
-        if (auto fill = task->rshape->fill) {
-            rasterGradientShape(surface, &task->shape, bbox, fill, task->opacity);
-        } else {
-            RenderColor c;
-            task->rshape->fillColor(&c.r, &c.g, &c.b, &c.a);
-            c.a = MULTIPLY(task->opacity, c.a);
-            if (c.a > 0) rasterShape(surface, &task->shape, bbox, c);
-        }
+    //defer the rasterization in the tiled mode
+    auto deferred = deferrable();
+    if (!deferred) flush();
+
+    RenderProfileScope scope(profile, RenderProfile::Raster);
+
+    auto fill = [&](SwShapeTask* task, SwSurface* surface, const RenderRegion& region) {
+        auto bbox = _clip(surface, region);
+        if (bbox.invalid()) return;
+        _mark(surface, bbox);
+        if (deferred) cmds.push({task, bbox, false});
+        else _rasterFill(task, surface, bbox);
     };
 
-    auto stroke = [](SwShapeTask* task, SwSurface* surface, const RenderRegion& bbox) {
-        if (auto strokeFill = task->rshape->strokeFill()) {
-            rasterGradientStroke(surface, &task->shape, bbox, strokeFill, task->opacity);
-        } else {
-            RenderColor c;
-            if (task->rshape->strokeFill(&c.r, &c.g, &c.b, &c.a)) {
-                c.a = MULTIPLY(task->opacity, c.a);
-                if (c.a > 0) rasterStroke(surface, &task->shape, bbox, c);
-            }
-        }
+    auto stroke = [&](SwShapeTask* task, SwSurface* surface, const RenderRegion& region) {
+        auto bbox = _clip(surface, region);
+        if (bbox.invalid()) return;
+        _mark(surface, bbox);
+        if (deferred) cmds.push({task, bbox, true});
+        else _rasterStroke(task, surface, bbox);
     };
 
     //full scene or partial rendering
@@ -500,10 +1017,10 @@ bool SwRenderer::renderShape(RenderData data)
             stroke(task, surface, task->curBox);
         }
     } else {
-        for (int idx = 0; idx < RenderDirtyRegion::PARTITIONING; ++idx) {
+        for (uint32_t idx = 0; idx < dirtyRegion.count(); ++idx) {
             if (!dirtyRegion.partition(idx).intersected(task->curBox)) continue;
             ARRAY_FOREACH(p, dirtyRegion.get(idx)) {
-                if (task->curBox.min.x >= p->max.x) break;   //dirtyRegion is sorted in x order
+                if (task->curBox.max.x <= p->min.x) break;   //dirtyRegion is sorted in x order
                 if (task->rshape->strokeFirst()) {
                     if (task->rshape->stroke && task->curBox.intersected(*p)) stroke(task, surface, RenderRegion::intersect(task->curBox, *p));
                     if (task->shape.bbox.intersected(*p)) fill(task, surface, RenderRegion::intersect(task->shape.bbox, *p));
@@ -524,69 +1041,11 @@ bool SwRenderer::renderShape(RenderData data)
 bool SwRenderer::blend(BlendMethod method)
 {
     if (surface->blendMethod == method) return true;
+
+    flush();
     surface->blendMethod = method;
 
-    switch (method) {
-        case BlendMethod::Normal:
-        case BlendMethod::Composition:
-            surface->blender = nullptr;
-            break;
-        case BlendMethod::Multiply:
-            surface->blender = opBlendMultiply;
-            break;
-        case BlendMethod::Screen:
-            surface->blender = opBlendScreen;
-            break;
-        case BlendMethod::Overlay:
-            surface->blender = opBlendOverlay;
-            break;
-        case BlendMethod::Darken:
-            surface->blender = opBlendDarken;
-            break;
-        case BlendMethod::Lighten:
-            surface->blender = opBlendLighten;
-            break;
-        case BlendMethod::ColorDodge:
-            surface->blender = opBlendColorDodge;
-            break;
-        case BlendMethod::ColorBurn:
-            surface->blender = opBlendColorBurn;
-            break;
-        case BlendMethod::HardLight:
-            surface->blender = opBlendHardLight;
-            break;
-        case BlendMethod::SoftLight:
-            surface->blender = opBlendSoftLight;
-            break;
-        case BlendMethod::Difference:
-            surface->blender = opBlendDifference;
-            break;
-        case BlendMethod::Exclusion:
-            surface->blender = opBlendExclusion;
-            break;
-        case BlendMethod::Hue:
-            surface->blender = opBlendHue;
-            break;
-        case BlendMethod::Saturation:
-            surface->blender = opBlendSaturation;
-            break;
-        case BlendMethod::Color:
-            surface->blender = opBlendColor;
-            break;
-        case BlendMethod::Luminosity:
-            surface->blender = opBlendLuminosity;
-            break;
-        case BlendMethod::Add:
-            surface->blender = opBlendAdd;
-            break;
-        case BlendMethod::HardMix:
-            surface->blender = opBlendHardMix;
-            break;
-        default:
-            TVGLOG("SW_ENGINE", "Non supported blending option = %d", (int) method);
-            surface->blender = nullptr;
-            break;
-    }
+    rasterBlender(surface, method);
     return false;
 }
 
@@ -598,16 +1057,52 @@ RenderRegion SwRenderer::region(RenderData data)
 }
 
 
+bool SwRenderer::occluder(RenderData data, RenderRegion& region)
+{
+    auto task = static_cast<SwTask*>(data);
+    if (!task || !surface) return false;
+
+    //the masking composes the drawings with the mask coverage, they don't replace the pixels beneath
+    if (surface->compositor && surface->compositor->method != MaskMethod::None) return false;
+
+    task->done();
+    if (!task->opaque() || task->curBox.invalid()) return false;
+
+    region = task->curBox;
+    return true;
+}
+
+
+bool SwRenderer::intersects(RenderData data, const RenderRegion& region)
+{
+    auto task = static_cast<SwTask*>(data);
+    if (!task) return false;
+
+    task->done();
+    if (task->curBox.invalid() || !region.intersected(task->curBox)) return false;
+
+    return task->intersects(region);
+}
+
+
 bool SwRenderer::beginComposite(RenderCompositor* cmp, MaskMethod method, uint8_t opacity)
 {
     if (!cmp) return false;
     auto p = static_cast<SwCompositor*>(cmp);
 
+    flush();
+
     p->method = method;
     p->opacity = opacity;
 
     //Current Context?
     if (p->method != MaskMethod::None) {
+        if ((int)p->method >= (int)MaskMethod::Add) _mark(surface, p->bbox);  //may be written along with the target
+        //the luma is computed once, the target is matted with it as with an alpha mask
+        else if ((p->method == MaskMethod::Luma || p->method == MaskMethod::InvLuma) && surface->compositor == p && rasterLuma8(surface)) {
+            p->method = (p->method == MaskMethod::Luma) ? MaskMethod::Alpha : MaskMethod::InvAlpha;
+            p->luma8 = true;
+        }
         surface = p->recoverSfc;
         surface->compositor = p;
     }
@@ -616,54 +1111,110 @@ bool SwRenderer::beginComposite(RenderCompositor* cmp, MaskMethod method, uint8_
 }
 
 
+bool SwRenderer::alphaClip()
+{
+    //rleClip() multiplies the coverage of the spans
+    return true;
+}
+
+
 const RenderSurface* SwRenderer::mainSurface()
 {
     return surface;
 }
 
 
-SwSurface* SwRenderer::request(int channelSize, bool square)
+SwSurface* SwRenderer::request(int channelSize, const RenderRegion& region, bool square)
 {
+    MemoryScope memory(MemoryCategory::Compositor);
+
     SwSurface* cmp = nullptr;
-    uint32_t w, h;
 
+    //Same Dimensional Size is demanded for the Post Processing Fast Flipping
     if (square) {
-        //Same Dimensional Size is demanded for the Post Processing Fast Flipping
-        w = h = std::max(surface->w, surface->h);
-    } else {
-        w = surface->w;
-        h = surface->h;
+        auto size = std::max(surface->w, surface->h);
+
+        //Use cached data
+        ARRAY_FOREACH(p, compositors) {
+            auto cur = *p;
+            if (cur->compositor->valid && !cur->compositor->buffer && cur->compositor->image.channelSize == channelSize) {
+                if (size == cur->w && size == cur->h) {
+                    cmp = *p;
+                    if (profile) profile->count(RenderProfile::CacheHits);
+                    break;
+                }
+            }
+        }
+
+        //New Composition
+        if (!cmp) {
+            //Inherits attributes from main surface
+            cmp = new SwSurface(surface);
+            cmp->compositor = new SwCompositor;
+            cmp->compositor->image.data = tvg::malloc<pixel_t*>(channelSize * size * size);
+            cmp->w = cmp->compositor->image.w = size;
+            cmp->h = cmp->compositor->image.h = size;
+            cmp->stride = cmp->compositor->image.stride = size;
+            cmp->compositor->image.direct = true;
+            cmp->compositor->valid = true;
+            cmp->channelSize = cmp->compositor->image.channelSize = channelSize;
+            cmp->area = {{0, 0}, {int32_t(size), int32_t(size)}};
+
+            compositors.push(cmp);
+            if (profile) profile->count(RenderProfile::Surfaces);
+        }
+
+        //Sync. This may have been modified by post-processing.
+        cmp->data = cmp->compositor->image.data;
+
+        return cmp;
     }
 
-    //Use cached data
+    //Use the best fitting pooled memory, or grow the largest spare one rather than piling up the others
+    auto size = region.w() * region.h();
+    SwSurface* spare = nullptr;
+
     ARRAY_FOREACH(p, compositors) {
         auto cur = *p;
-        if (cur->compositor->valid && cur->compositor->image.channelSize == channelSize) {
-            if (w == cur->w && h == cur->h) {
-                cmp = *p;
-                break;
-            }
+        if (!cur->compositor->valid || !cur->compositor->buffer || cur->compositor->image.channelSize != channelSize) continue;
+        if (cur->compositor->capacity >= size) {
+            if (!cmp || cur->compositor->capacity < cmp->compositor->capacity) cmp = cur;
+        } else if (!spare || cur->compositor->capacity > spare->compositor->capacity) {
+            spare = cur;
         }
     }
 
-    //New Composition
-    if (!cmp) {
-        //Inherits attributes from main surface
-        cmp = new SwSurface(surface);
-        cmp->compositor = new SwCompositor;
-        cmp->compositor->image.data = tvg::malloc<pixel_t*>(channelSize * w * h);
-        cmp->w = cmp->compositor->image.w = w;
-        cmp->h = cmp->compositor->image.h = h;
-        cmp->stride = cmp->compositor->image.stride = w;
-        cmp->compositor->image.direct = true;
-        cmp->compositor->valid = true;
-        cmp->channelSize = cmp->compositor->image.channelSize = channelSize;
-
-        compositors.push(cmp);
+    //the pooled memory is kept zeroed except the region written last time, clear it only
+    if (cmp) {
+        if (cmp->dirty.valid()) rasterClear(cmp, cmp->dirty.x(), cmp->dirty.y(), cmp->dirty.w(), cmp->dirty.h());
+        if (profile) profile->count(RenderProfile::CacheHits);
+    } else {
+        if (spare) {
+            cmp = spare;
+            tvg::free(cmp->compositor->buffer);
+        //New Composition, inherits attributes from main surface
+        } else {
+            cmp = new SwSurface(surface);
+            cmp->compositor = new SwCompositor;
+            cmp->compositor->image.direct = true;
+            cmp->compositor->valid = true;
+            cmp->channelSize = cmp->compositor->image.channelSize = channelSize;
+            compositors.push(cmp);
+        }
+        cmp->compositor->capacity = _sizeClass(size);
+        cmp->compositor->buffer = tvg::calloc<pixel_t*>(cmp->compositor->capacity, channelSize);
+        if (profile) profile->count(RenderProfile::Surfaces);
     }
 
-    //Sync. This may have been modified by post-processing.
-    cmp->data = cmp->compositor->image.data;
+    /* The origin is shifted by the region, so that the raster paths address the compositor
+       in the target coordinates as they are. Only the region is backed by the memory. */
+    auto offset = (region.min.y * region.sw() + region.min.x) * channelSize;
+    cmp->data = cmp->compositor->image.data = (pixel_t*)((uint8_t*)cmp->compositor->buffer - offset);
+    cmp->stride = cmp->compositor->image.stride = region.w();
+    cmp->w = cmp->compositor->image.w = surface->w;
+    cmp->h = cmp->compositor->image.h = surface->h;
+    cmp->area = region;
+    cmp->dirty.reset();
 
     return cmp;
 }
@@ -671,18 +1222,31 @@ SwSurface* SwRenderer::request(int channelSize, bool square)
 
 RenderCompositor* SwRenderer::target(const RenderRegion& region, ColorSpace cs, CompositionFlag flags)
 {
-    auto bbox = RenderRegion::intersect(region, {{0, 0}, {int32_t(surface->w), int32_t(surface->h)}});
+    auto bbox = RenderRegion::intersect(region, surface->area);
     if (bbox.invalid()) return nullptr;
 
-    auto cmp = request(CHANNEL_SIZE(cs), (flags & CompositionFlag::PostProcessing));
+    flush();
+
+    RenderProfileScope scope(profile, RenderProfile::Composite);
+
+    auto square = (flags & CompositionFlag::PostProcessing);
+
+    //the post effects out of the dirty regions change nothing
+    if (square && !_damaged(dirtyRegion, bbox, fulldraw)) return nullptr;
+
+    auto cmp = request(CHANNEL_SIZE(cs), bbox, square);
     cmp->compositor->recoverSfc = surface;
     cmp->compositor->recoverCmp = surface->compositor;
     cmp->compositor->valid = false;
     cmp->compositor->bbox = bbox;
 
+    //the post effects read the neighbors of the dirty regions, the source must be drawn fully
+    cmp->compositor->isolated = square;
+    if (square) cmp->compositor->partial = dirtyRegion.deactivate(true);
+
     /* TODO: Currently, only blending might work.
        Blending and composition must be handled together. */
-    rasterClear(cmp, bbox.x(), bbox.y(), bbox.w(), bbox.h());
+    if (square) rasterClear(cmp, bbox.x(), bbox.y(), bbox.w(), bbox.h());
 
     //Switch render target
     surface = cmp;
@@ -697,23 +1261,165 @@ bool SwRenderer::endComposite(RenderCompositor* cmp)
 
     auto p = static_cast<SwCompositor*>(cmp);
 
+    flush();
+
+    RenderProfileScope scope(profile, RenderProfile::Composite);
+
     //Recover Context
     surface = p->recoverSfc;
     surface->compositor = p->recoverCmp;
 
+    //back to the 32-bit layout of the pooled memory
+    if (p->luma8) {
+        p->image.channelSize = sizeof(uint32_t);
+        p->image.data = (pixel_t*)((uint8_t*)p->buffer - (p->bbox.min.y * p->bbox.sw() + p->bbox.min.x) * sizeof(uint32_t));
+        p->luma8 = false;
+    }
+
+    //back to the partial rendering after the full drawing
+    if (p->retained || p->isolated) dirtyRegion.deactivate(p->partial);
+
     //only invalid (currently used) surface can be composited
     if (p->valid) return true;
     p->valid = true;
 
+    if (p->retained || p->isolated) return composite(p);
+
     //Default is alpha blending
     if (p->method == MaskMethod::None) {
-        return rasterDirectImage(surface, p->image, p->bbox, p->opacity);
+        auto bbox = _clip(surface, p->bbox);
+        if (bbox.invalid()) return true;
+        _mark(surface, bbox);
+        return rasterDirectImage(surface, p->image, bbox, p->opacity);
     }
 
     return true;
 }
 
 
+bool SwRenderer::composite(SwCompositor* cmp)
+{
+    //the retained layer may be recalled on a compositor of the other region
+    auto bbox = _clip(surface, cmp->bbox);
+    if (bbox.invalid()) return true;
+    _mark(surface, bbox);
+
+    //full scene or partial rendering
+    if (fulldraw || dirtyRegion.deactivated()) return rasterDirectImage(surface, cmp->image, bbox, cmp->opacity);
+
+    for (uint32_t idx = 0; idx < dirtyRegion.count(); ++idx) {
+        if (!dirtyRegion.partition(idx).intersected(bbox)) continue;
+        ARRAY_FOREACH(p, dirtyRegion.get(idx)) {
+            if (bbox.max.x <= p->min.x) break;   //dirtyRegion is sorted in x order
+            if (bbox.intersected(*p)) rasterDirectImage(surface, cmp->image, RenderRegion::intersect(bbox, *p), cmp->opacity);
+        }
+    }
+    return true;
+}
+
+
+RenderCompositor* SwRenderer::retain(RenderCompositor* cmp, const RenderRegion& region, ColorSpace cs, CompositionFlag flags)
+{
+    MemoryScope memory(MemoryCategory::Compositor);
+
+    //the layers of the whole frame would outweigh the bands
+    if (banded.callback) return nullptr;
+
+    auto bbox = RenderRegion::intersect(region, surface->area);
+    if (bbox.invalid()) return nullptr;
+
+    flush();
+
+    RenderProfileScope scope(profile, RenderProfile::Composite);
+
+    auto channelSize = CHANNEL_SIZE(cs);
+    SwSurface* sfc = nullptr;
+
+    //the post effects swap the buffers with the square compositors
+    auto w = surface->w;
+    auto h = surface->h;
+    if (flags & CompositionFlag::PostProcessing) w = h = std::max(surface->w, surface->h);
+
+    ARRAY_FOREACH(p, retains) {
+        if ((*p)->compositor == cmp) {
+            sfc = *p;
+            break;
+        }
+    }
+
+    //the target has been changed
+    if (sfc && (sfc->compositor->epoch != epoch || sfc->w != w || sfc->h != h || sfc->channelSize != channelSize)) {
+        dispose(cmp);
+        sfc = nullptr;
+    }
+
+    //new retained layer, inherits attributes from the main surface
+    if (!sfc) {
+        sfc = new SwSurface(surface);
+        sfc->compositor = new SwCompositor;
+        sfc->compositor->image.data = tvg::malloc<pixel_t*>(channelSize * w * h);
+        sfc->w = sfc->compositor->image.w = w;
+        sfc->h = sfc->compositor->image.h = h;
+        sfc->stride = sfc->compositor->image.stride = w;
+        sfc->compositor->image.direct = true;
+        sfc->compositor->retained = true;
+        sfc->channelSize = sfc->compositor->image.channelSize = channelSize;
+        sfc->area = {{0, 0}, {int32_t(w), int32_t(h)}};
+        retains.push(sfc);
+        if (profile) profile->count(RenderProfile::Surfaces);
+    }
+
+    auto p = sfc->compositor;
+    sfc->data = p->image.data;
+    p->recoverSfc = surface;
+    p->recoverCmp = surface->compositor;
+    p->valid = false;
+    p->bbox = bbox;
+    p->epoch = epoch;
+
+    //the retained layer must be rendered fully regardless of the dirty regions
+    p->partial = dirtyRegion.deactivate(true);
+
+    rasterClear(sfc, bbox.x(), bbox.y(), bbox.w(), bbox.h());
+
+    //Switch render target
+    surface = sfc;
+
+    return p;
+}
+
+
+bool SwRenderer::recall(RenderCompositor* cmp, uint8_t opacity)
+{
+    auto p = static_cast<SwCompositor*>(cmp);
+    if (!p || !p->valid || p->epoch != epoch) return false;
+
+    flush();
+
+    RenderProfileScope scope(profile, RenderProfile::Composite);
+    if (profile) profile->count(RenderProfile::CacheHits);
+
+    p->method = MaskMethod::None;
+    p->opacity = opacity;
+
+    return composite(p);
+}
+
+
+void SwRenderer::dispose(RenderCompositor* cmp)
+{
+    ARRAY_FOREACH(p, retains) {
+        if ((*p)->compositor != cmp) continue;
+        tvg::free((*p)->compositor->image.data);
+        delete((*p)->compositor);
+        delete(*p);
+        *p = retains.last();
+        retains.pop();
+        return;
+    }
+}
+
+
 void SwRenderer::prepare(RenderEffect* effect, const Matrix& transform)
 {
     switch (effect->type) {
@@ -741,19 +1447,27 @@ bool SwRenderer::render(RenderCompositor* cmp, const RenderEffect* effect, bool
 {
     auto p = static_cast<SwCompositor*>(cmp);
 
+    flush();
+
+    RenderProfileScope scope(profile, RenderProfile::Effect);
+
     if (p->image.channelSize != sizeof(uint32_t)) {
         TVGERR("SW_ENGINE", "Not supported grayscale Gaussian Blur!");
         return false;
     }
+
+    //the direct result must not go beyond the dirty regions
+    if (direct && !fulldraw && !p->partial) direct = false;
+    if (direct) _mark(p->recoverSfc, p->recoverSfc->area);
     
     switch (effect->type) {
         case SceneEffect::GaussianBlur: {
-            return effectGaussianBlur(p, request(surface->channelSize, true), static_cast<const RenderEffectGaussianBlur*>(effect));
+            return effectGaussianBlur(p, request(surface->channelSize, p->bbox, true), static_cast<const RenderEffectGaussianBlur*>(effect));
         }
         case SceneEffect::DropShadow: {
-            auto cmp1 = request(surface->channelSize, true);
+            auto cmp1 = request(surface->channelSize, p->bbox, true);
             cmp1->compositor->valid = false;
-            auto cmp2 = request(surface->channelSize, true);
+            auto cmp2 = request(surface->channelSize, p->bbox, true);
             SwSurface* surfaces[] = {cmp1, cmp2};
             auto ret = effectDropShadow(p, surfaces, static_cast<const RenderEffectDropShadow*>(effect), direct);
             cmp1->compositor->valid = true;
@@ -773,6 +1487,20 @@ bool SwRenderer::render(RenderCompositor* cmp, const RenderEffect* effect, bool
 }
 
 
+bool SwRenderer::fuse(RenderCompositor* cmp, const RenderEffect* const* effects, uint32_t cnt)
+{
+    auto p = static_cast<SwCompositor*>(cmp);
+
+    if (p->image.channelSize != sizeof(uint32_t)) return false;
+
+    flush();
+
+    RenderProfileScope scope(profile, RenderProfile::Effect);
+
+    return effectColors(p, effects, cnt);
+}
+
+
 void SwRenderer::dispose(RenderEffect* effect) 
 {
     tvg::free(effect->rd);
@@ -790,14 +1518,69 @@ ColorSpace SwRenderer::colorSpace()
 void SwRenderer::dispose(RenderData data)
 {
     auto task = static_cast<SwTask*>(data);
+    flush();
     task->done();
     task->dispose();
 
+    //the region drawn in the last frame must be restored
+    if (!task->nodirty && !dirtyRegion.deactivated()) dirtyRegion.add(task->prvBox, task->dirtyScope);
+
     if (task->pushed) task->disposed = true;
     else delete(task);
 }
 
 
+bool SwRenderer::deferrable()
+{
+    if (!tiling) return false;
+
+    //the masking composes the whole region at once, leave it to the immediate rasterization.
+    if (surface->compositor && surface->compositor->method != MaskMethod::None) return false;
+
+    return true;
+}
+
+
+void SwRenderer::flush()
+{
+    if (cmds.empty()) return;
+
+    TVG_TRACE("SwRenderer::flush");
+    RenderProfileScope scope(profile, RenderProfile::Raster);
+
+    //vertical range to rasterize
+    auto miny = cmds.first().bbox.min.y;
+    auto maxy = cmds.first().bbox.max.y;
+    ARRAY_FOREACH(p, cmds) {
+        miny = std::min(miny, p->bbox.min.y);
+        maxy = std::max(maxy, p->bbox.max.y);
+    }
+
+    //more bands than the threads for the load balancing
+    if (bins.empty()) {
+        auto cnt = (threadsCnt + 1) * 2;
+        bins.reserve(cnt);
+        for (uint32_t i = 0; i < cnt; ++i) bins.push(new SwRasterTask);
+    }
+
+    auto height = (maxy - miny + int32_t(bins.count) - 1) / int32_t(bins.count);
+    auto y = miny;
+
+    ARRAY_FOREACH(p, bins) {
+        if (y >= maxy) break;
+        auto bin = *p;
+        bin->cmds = &cmds;
+        bin->surface = surface;
+        bin->band = {{0, y}, {int32_t(surface->w), std::min(y + height, maxy)}};
+        group.request(bin);
+        y += height;
+    }
+
+    group.wait();
+    cmds.clear();
+}
+
+
 void* SwRenderer::prepareCommon(SwTask* task, const Matrix& transform, const Array<RenderData>& clips, uint8_t opacity, RenderUpdateFlag flags)
 {
     if (!surface || (transform.e11 == 0.0f && transform.e12 == 0.0f) || (transform.e21 == 0.0f && transform.e22 == 0.0f)) return task;  //invalid
@@ -808,6 +1591,8 @@ void* SwRenderer::prepareCommon(SwTask* task, const Matrix& transform, const Arr
     task->transform = transform;
     task->clips = clips;
     task->dirtyRegion = &dirtyRegion;
+    task->dirtyScope = dirtyRegion.scope;
+    task->profile = profile;
     task->opacity = opacity;
     task->nodirty = dirtyRegion.deactivated();
     task->flags = flags;
@@ -817,23 +1602,29 @@ void* SwRenderer::prepareCommon(SwTask* task, const Matrix& transform, const Arr
         tasks.push(task);
     }
 
-    //TODO: Failed threading them. It would be better if it's possible.
-    //See: https://github.com/thorvg/thorvg/issues/1409
-    //Guarantee composition targets get ready.
-    if (flags & RenderUpdateFlag::Clip) {
+    //the light changes don't need the task run
+    if (!flags || task->recolor()) return task;
+
+    //Guarantee composition targets get ready before the clipping.
+    if (clips.count > 0) {
+        SmallArray<Task*, 8> deps;
+        deps.reserve(clips.count);
         ARRAY_FOREACH(p, clips) {
-            static_cast<SwTask*>(*p)->done();
+            deps.push(static_cast<SwTask*>(*p));
         }
+        group.request(task, deps.data, deps.count);
+    } else {
+        group.request(task);
     }
 
-    if (flags) TaskScheduler::request(task);
-
     return task;
 }
 
 
 RenderData SwRenderer::prepare(RenderSurface* surface, RenderData data, const Matrix& transform, Array<RenderData>& clips, uint8_t opacity, RenderUpdateFlag flags)
 {
+    MemoryScope memory(MemoryCategory::Engine);
+
     auto task = static_cast<SwImageTask*>(data);
     if (task) task->done();
     else {
@@ -847,6 +1638,8 @@ RenderData SwRenderer::prepare(RenderSurface* surface, RenderData data, const Ma
 
 RenderData SwRenderer::prepare(const RenderShape& rshape, RenderData data, const Matrix& transform, Array<RenderData>& clips, uint8_t opacity, RenderUpdateFlag flags, bool clipper)
 {
+    MemoryScope memory(MemoryCategory::Engine);
+
     auto task = static_cast<SwShapeTask*>(data);
     if (task) task->done();
     else {
@@ -855,6 +1648,8 @@ RenderData SwRenderer::prepare(const RenderShape& rshape, RenderData data, const
     }
 
     task->clipper = clipper;
+    task->tolerance = tolerance;
+    task->coverTiles = coverTiles;
 
     return prepareCommon(task, transform, clips, opacity, flags);
 }
@@ -862,18 +1657,37 @@ RenderData SwRenderer::prepare(const RenderShape& rshape, RenderData data, const
 
 bool SwRenderer::term()
 {
+    ScopedLock lock(engineKey);
+
     if (rendererCnt > 0) return false;
 
     mpoolTerm(globalMpool);
     globalMpool = nullptr;
+    glyphAtlasTerm(globalAtlas);
+    globalAtlas = nullptr;
+    fillTerm();
     rendererCnt = -1;
 
     return true;
 }
 
 
-SwRenderer* SwRenderer::gen(uint32_t threads)
+void SwRenderer::trim(bool caches)
 {
+    if (rendererCnt == -1) return;
+
+    mpoolClear(globalMpool);
+    if (caches) glyphAtlasClear(globalAtlas);
+
+    //the compositors are released by each renderer at its next update
+    ++trimCnt;
+}
+
+
+SwRenderer* SwRenderer::gen(uint32_t threads, bool isolated)
+{
+    ScopedLock lock(engineKey);
+
     //initialize engine
     if (rendererCnt == -1) {
 #ifdef THORVG_SW_OPENMP_SUPPORT
@@ -881,9 +1695,14 @@ SwRenderer* SwRenderer::gen(uint32_t threads)
 #endif
         //Share the memory pool among the renderer
         globalMpool = mpoolInit(threads);
+#ifdef THORVG_GLYPH_ATLAS_SUPPORT
+        //Share the rasterized glyphs among the renderers
+        globalAtlas = glyphAtlasInit();
+#endif
         threadsCnt = threads;
         rendererCnt = 0;
+        rasterInit();
     }
 
-    return new SwRenderer;
+    return new SwRenderer(isolated);
 }
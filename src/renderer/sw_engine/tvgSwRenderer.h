@@ -24,9 +24,12 @@
 #define _TVG_SW_RENDERER_H_
 
 #include "tvgRender.h"
+#include "tvgTaskScheduler.h"
 
 struct SwSurface;
 struct SwTask;
+struct SwRasterCmd;
+struct SwRasterTask;
 struct SwCompositor;
 struct SwMpool;
 
@@ -36,6 +39,8 @@ namespace tvg
 class SwRenderer : public RenderMethod
 {
 public:
+    using BandFlush = void(*)(const uint32_t* buffer, uint32_t y, uint32_t lines, void* data);
+
     //main features
     bool preUpdate() override;
     RenderData prepare(const RenderShape& rshape, RenderData data, const Matrix& transform, Array<RenderData>& clips, uint8_t opacity, RenderUpdateFlag flags, bool clipper) override;
@@ -52,41 +57,90 @@ public:
     const RenderSurface* mainSurface() override;
     bool clear() override;
     bool sync() override;
-    bool target(pixel_t* data, uint32_t stride, uint32_t w, uint32_t h, ColorSpace cs);
+    bool detach() override;
+    bool next() override;
+    bool occluder(RenderData data, RenderRegion& region) override;
+    bool intersects(RenderData data, const RenderRegion& region) override;
+    bool target(pixel_t* data, uint32_t stride, uint32_t w, uint32_t h, ColorSpace cs, uint32_t lines = 0, BandFlush callback = nullptr, void* userData = nullptr);
+    void dither(bool on);
+    bool tiles(bool on);
 
     //composition
-    SwSurface* request(int channelSize, bool square);
+    SwSurface* request(int channelSize, const RenderRegion& region, bool square = false);
     RenderCompositor* target(const RenderRegion& region, ColorSpace cs, CompositionFlag flags) override;
     bool beginComposite(RenderCompositor* cmp, MaskMethod method, uint8_t opacity) override;
     bool endComposite(RenderCompositor* cmp) override;
+    bool alphaClip() override;
     void clearCompositors();
 
+    //retained layers
+    RenderCompositor* retain(RenderCompositor* cmp, const RenderRegion& region, ColorSpace cs, CompositionFlag flags) override;
+    bool recall(RenderCompositor* cmp, uint8_t opacity) override;
+    void dispose(RenderCompositor* cmp) override;
+
     //post effects
     void prepare(RenderEffect* effect, const Matrix& transform) override;
     bool region(RenderEffect* effect) override;
     bool render(RenderCompositor* cmp, const RenderEffect* effect, bool direct) override;
+    bool fuse(RenderCompositor* cmp, const RenderEffect* const* effects, uint32_t cnt) override;
     void dispose(RenderEffect* effect) override;
 
     //partial rendering
     void damage(RenderData rd, const RenderRegion& region) override;
     bool partial(bool disable) override;
+    RenderDirtyRegion::Scope scope(const RenderRegion& extend, const RenderRegion* clip) override;
+    void scope(const RenderDirtyRegion::Scope& former) override;
+    bool damages(const RenderRegion** regions, uint32_t* cnt) override;
 
-    static SwRenderer* gen(uint32_t threads);
+    static SwRenderer* gen(uint32_t threads, bool isolated = false);
     static bool term();
+    static void trim(bool caches);
 
 private:
     SwSurface*           surface = nullptr;           //active surface
     Array<SwTask*>       tasks;                       //async task list
+    TaskGroup            group;                       //completion of the async tasks
+    Array<SwRasterCmd>   cmds;                        //deferred rasterization commands (tiled mode)
+    Array<SwRasterTask*> bins;                        //band rasterization tasks (tiled mode)
     Array<SwSurface*>    compositors;                 //render targets cache list
+    Array<SwSurface*>    retains;                     //retained layers
     RenderDirtyRegion    dirtyRegion;                 //partial rendering support
+    Array<RenderRegion>  damaged;                     //the regions updated by the last draw
     SwMpool*             mpool;                       //private memory pool
+    uint32_t             epoch = 0;                   //main target generation, outdates the retained layers
+    uint32_t             trimmed = 0;                 //the last trim request handled, see trim()
     bool                 sharedMpool;                 //memory-pool behavior policy
     bool                 fulldraw = true;             //buffer is cleared (need to redraw full screen)
-
-    SwRenderer();
+    bool                 clearing = false;            //the requested clear is deferred to the damaged regions, see preRender()
+    bool                 tiling = false;              //rasterize the shapes on the disjoint bands in parallel
+    bool                 coverTiles = false;          //the fills are rasterized in the coverage tiles instead of the spans
+
+    //the packed target (RGB565) is rendered to the 32 bits working buffer, then packed by the updated regions
+    struct {
+        uint16_t* buf = nullptr;                      //user target buffer
+        uint32_t stride = 0;
+        pixel_t* work = nullptr;                      //working buffer of the main surface
+        bool dither = false;                          //ordered dithering
+        bool full = false;                            //pack the whole target at the next draw
+    } packed;
+
+    //the banded target draws the scene band by band into the buffer of a few rows
+    struct {
+        pixel_t* buf = nullptr;                       //band buffer of the main surface
+        pixel_t* target = nullptr;                    //user target buffer
+        BandFlush callback = nullptr;                 //passes the drawn bands over, valid in the banded mode only
+        void* data = nullptr;                         //user data of the callback
+        uint32_t lines = 0;                           //rows of a band
+        int32_t y = 0;                                //top row of the current band
+    } banded;
+
+    SwRenderer(bool isolated);
     ~SwRenderer();
 
     RenderData prepareCommon(SwTask* task, const Matrix& transform, const Array<RenderData>& clips, uint8_t opacity, RenderUpdateFlag flags);
+    bool deferrable();
+    void flush();
+    bool composite(SwCompositor* cmp);
 };
 
 }
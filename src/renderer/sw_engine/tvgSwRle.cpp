@@ -189,6 +189,7 @@
 */
 
 #include <limits.h>
+#include "tvgTaskScheduler.h"
 #include "tvgSwCommon.h"
 
 /************************************************************************/
@@ -199,19 +200,7 @@ constexpr auto PIXEL_BITS = 8;   //must be at least 6 bits!
 constexpr auto ONE_PIXEL = (1 << PIXEL_BITS);
 
 using Area = long;
-
-struct Band
-{
-    int32_t min, max;
-};
-
-struct Cell
-{
-    int32_t x;
-    int32_t cover;
-    Area area;
-    Cell *next;
-};
+using Cell = SwCell;
 
 struct RleWorker
 {
@@ -226,9 +215,8 @@ struct RleWorker
     Area area;
     int32_t cover;
 
+    SwCellPool* pool;
     Cell* cells;
-    ptrdiff_t maxCells;
-    ptrdiff_t cellsCnt;
 
     SwPoint pos;
 
@@ -237,15 +225,20 @@ struct RleWorker
     int levStack[32];
 
     SwOutline* outline;
+    FillRule fillRule;
 
-    int bandSize;
-    int bandShoot;
+    int32_t* yCells;
+    int32_t* xCells;   //the last visited cell index of each scanline, along with yCells
 
-    void* buffer;
-    long bufferSize;
+    SwTiles* tiles;     //the tiles instead of the rle, see _tileLine()
+    uint8_t* strip;     //the coverage rows of the current tile row
+    int32_t stripX;     //the left of the strip at a multiple of the tile width
+    int32_t stripW;
+    int32_t tileY;      //the top of the current tile row
+    int32_t touchMin;   //the touched pixels of the strip
+    int32_t touchMax;
 
-    Cell** yCells;
-    int32_t yCnt;
+    int32_t flatness;   //the chord distance limit of the curve control points, 4/3 of the tolerance
 
     bool invalid;
     bool antiAlias;
@@ -290,20 +283,14 @@ static inline int32_t HYPOT(SwPoint pt)
 }
 
 
-static void _horizLine(RleWorker& rw, int32_t x, int32_t y, int32_t area, int32_t aCount)
+static inline int32_t _coverage(const RleWorker& rw, int32_t area)
 {
-    x += rw.cellMin.x;
-    y += rw.cellMin.y;
-
-    //Clip Y range
-    if (y < rw.cellMin.y || y >= rw.cellMax.y) return;
-
     /* compute the coverage line's coverage, depending on the outline fill rule */
     /* the coverage percentage is area/(PIXEL_BITS*PIXEL_BITS*2) */
     auto coverage = static_cast<int>(area >> (PIXEL_BITS * 2 + 1 - 8));    //range 0 - 255
     if (coverage < 0) coverage = -coverage;
 
-    if (rw.outline->fillRule == FillRule::EvenOdd) {
+    if (rw.fillRule == FillRule::EvenOdd) {
         coverage &= 511;
         if (coverage > 255) coverage = 511 - coverage;
     } else {
@@ -311,18 +298,31 @@ static void _horizLine(RleWorker& rw, int32_t x, int32_t y, int32_t area, int32_
         if (coverage > 255) coverage = 255;
     }
 
+    if (coverage > 0 && !rw.antiAlias) coverage = 255;
+
+    return coverage;
+}
+
+
+static void _horizLine(RleWorker& rw, int32_t x, int32_t y, int32_t area, int32_t aCount)
+{
+    x += rw.cellMin.x;
+    y += rw.cellMin.y;
+
+    //Clip Y range
+    if (y < rw.cellMin.y || y >= rw.cellMax.y) return;
+
+    auto coverage = _coverage(rw, area);
     if (coverage == 0) return;
 
     //span has ushort coordinates. check limit overflow
-    if (x >= SHRT_MAX || y >= SHRT_MAX) {
+    if (x >= USHRT_MAX || y >= USHRT_MAX) {
         TVGERR("SW_ENGINE", "XY-coordinate overflow!");
         return;
     }
 
     auto rle = rw.rle;
 
-    if (!rw.antiAlias) coverage = 255;
-
     //see whether we can add this span to the current list
     if (!rle->spans.empty()) {
         auto& span = rle->spans.last();
@@ -352,26 +352,111 @@ static void _horizLine(RleWorker& rw, int32_t x, int32_t y, int32_t area, int32_
 }
 
 
+//the coverages are written to the strip of the current tile row, see _flushTiles()
+static void _tileLine(RleWorker& rw, int32_t x, int32_t y, int32_t area, int32_t aCount)
+{
+    x += rw.cellMin.x;
+    y += rw.cellMin.y;
+
+    //Clip Y range
+    if (y < rw.cellMin.y || y >= rw.cellMax.y) return;
+
+    auto coverage = _coverage(rw, area);
+    if (coverage == 0) return;
+
+    //Clip x range
+    auto x2 = std::min(x + aCount, rw.cellMax.x);
+    if (x < rw.cellMin.x) x = rw.cellMin.x;
+    if (x >= x2) return;
+
+    memset(rw.strip + (y - rw.tileY) * rw.stripW + (x - rw.stripX), coverage, x2 - x);
+    if (x < rw.touchMin) rw.touchMin = x;
+    if (x2 > rw.touchMax) rw.touchMax = x2;
+}
+
+
+//classify the touched tiles of the strip: the empty ones are skipped, the full ones are merged into the fills
+static void _flushTiles(RleWorker& rw)
+{
+    if (rw.touchMin >= rw.touchMax) return;
+
+    auto begin = (rw.touchMin - rw.stripX) & ~(SW_TILE_W - 1);
+    auto end = ((rw.touchMax - rw.stripX) + SW_TILE_W - 1) & ~(SW_TILE_W - 1);
+
+    for (auto x = begin; x < end; x += SW_TILE_W) {
+        uint64_t all = ~uint64_t(0), any = 0;
+        for (int r = 0; r < SW_TILE_H; ++r) {
+            uint64_t w[SW_TILE_W / sizeof(uint64_t)];
+            memcpy(w, rw.strip + r * rw.stripW + x, SW_TILE_W);
+            for (auto v : w) {
+                all &= v;
+                any |= v;
+            }
+        }
+        if (any == 0) continue;
+
+        auto tx = rw.stripX + x;
+        if (all == ~uint64_t(0)) {
+            auto& fills = rw.tiles->fills;
+            if (!fills.empty() && fills.last().y == rw.tileY && fills.last().x + fills.last().len == tx) fills.last().len += SW_TILE_W;
+            else fills.push({tx, rw.tileY, SW_TILE_W});
+            continue;
+        }
+        auto& tile = rw.tiles->tiles.next();
+        for (int r = 0; r < SW_TILE_H; ++r) {
+            memcpy(tile.coverage[r], rw.strip + r * rw.stripW + x, SW_TILE_W);
+        }
+        tile.x = tx;
+        tile.y = rw.tileY;
+    }
+
+    for (int r = 0; r < SW_TILE_H; ++r) {
+        memset(rw.strip + r * rw.stripW + begin, 0, end - begin);
+    }
+    rw.touchMin = INT32_MAX;
+    rw.touchMax = INT32_MIN;
+}
+
+
+static inline void _line(RleWorker& rw, int32_t x, int32_t y, int32_t area, int32_t aCount)
+{
+    if (rw.tiles) _tileLine(rw, x, y, area, aCount);
+    else _horizLine(rw, x, y, area, aCount);
+}
+
+
 static void _sweep(RleWorker& rw)
 {
-    if (rw.cellsCnt == 0) return;
+    if (rw.pool->cells.count == 0) return;
+
+    for (int y = 0; y < rw.cellYCnt; ++y) {
+        //the next tile row
+        if (rw.tiles) {
+            auto tileY = (rw.cellMin.y + y) & ~(SW_TILE_H - 1);
+            if (tileY != rw.tileY) {
+                _flushTiles(rw);
+                rw.tileY = tileY;
+            }
+        }
 
-    for (int y = 0; y < rw.yCnt; ++y) {
         auto cover = 0;
         auto x = 0;
-        auto cell = rw.yCells[y];
+        auto idx = rw.yCells[y];
 
-        while (cell) {
-            if (cell->x > x && cover != 0) _horizLine(rw, x, y, cover * (ONE_PIXEL * 2), cell->x - x);
+        while (idx >= 0) {
+            auto cell = rw.cells + idx;
+            if (cell->x > x && cover != 0) _line(rw, x, y, cover * (ONE_PIXEL * 2), cell->x - x);
             cover += cell->cover;
             auto area = cover * (ONE_PIXEL * 2) - cell->area;
-            if (area != 0 && cell->x >= 0) _horizLine(rw, cell->x, y, area, 1);
+            if (area != 0 && cell->x >= 0) _line(rw, cell->x, y, area, 1);
             x = cell->x + 1;
-            cell = cell->next;
+            idx = cell->next;
         }
 
-        if (cover != 0) _horizLine(rw, x, y, cover * (ONE_PIXEL * 2), rw.cellXCnt - x);
+        if (cover != 0) _line(rw, x, y, cover * (ONE_PIXEL * 2), rw.cellXCnt - x);
     }
+
+    if (rw.tiles) _flushTiles(rw);
 }
 
 
@@ -380,23 +465,47 @@ static Cell* _findCell(RleWorker& rw)
     auto x = rw.cellPos.x;
     if (x > rw.cellXCnt) x = rw.cellXCnt;
 
-    auto pcell = &rw.yCells[rw.cellPos.y];
+    //the cells are linked by the indices since the buffer can be reallocated
+    auto prev = -1;
+    auto idx = rw.yCells[rw.cellPos.y];
+
+    //resume from the last visited cell of the row, the edges mostly go on in the same direction
+    auto& last = rw.xCells[rw.cellPos.y];
+    if (last >= 0 && rw.cells[last].x <= x) {
+        if (rw.cells[last].x == x) return rw.cells + last;
+        prev = last;
+        idx = rw.cells[prev].next;
+    }
 
-    while(true) {
-        auto cell = *pcell;
-        if (!cell || cell->x > x) break;
-        if (cell->x == x) return cell;
-        pcell = &cell->next;
+    while (idx >= 0) {
+        auto cell = rw.cells + idx;
+        if (cell->x > x) break;
+        if (cell->x == x) {
+            last = idx;
+            return cell;
+        }
+        prev = idx;
+        idx = cell->next;
     }
 
-    if (rw.cellsCnt >= rw.maxCells) return nullptr;
+    auto& cells = rw.pool->cells;
+    if (cells.count >= cells.reserved) {
+        cells.grow(cells.count);
+        rw.cells = cells.data;
+        ++rw.pool->grows;
+    }
 
-    auto cell = rw.cells + rw.cellsCnt++;
+    auto cur = int32_t(cells.count++);
+    auto cell = rw.cells + cur;
     cell->x = x;
     cell->area = 0;
     cell->cover = 0;
-    cell->next = *pcell;
-    *pcell = cell;
+    cell->next = idx;
+
+    if (prev < 0) rw.yCells[rw.cellPos.y] = cur;
+    else rw.cells[prev].next = cur;
+
+    last = cur;
 
     return cell;
 }
@@ -637,7 +746,7 @@ static bool _cubicTo(RleWorker& rw, const SwPoint& ctrl1, const SwPoint& ctrl2,
             if (L > SHRT_MAX) goto split;
 
             //max deviation may be as much as (s/L) * 3/4 (if Hain's v = 1)
-            auto sLimit = L * (ONE_PIXEL / 6);
+            auto sLimit = L * rw.flatness;
 
             auto diff1 = arc[1] - arc[0];
             auto s = diff.y * diff1.x - diff.x * diff1.y;
@@ -723,126 +832,494 @@ static bool _genRle(RleWorker& rw)
 }
 
 
-/************************************************************************/
-/* External Class Implementation                                        */
-/************************************************************************/
+static inline SwPoint UPSCALE(const Point& pt)
+{
+    return UPSCALE(SwPoint{TO_SWCOORD(pt.x), TO_SWCOORD(pt.y)});
+}
 
-SwRle* rleRender(SwRle* rle, const SwOutline* outline, const RenderRegion& bbox, bool antiAlias)
+
+//the pieces of the hairline overlap each other, they are emitted in the same winding not to cancel out
+static bool _polygon(RleWorker& rw, Point* pts, int cnt)
 {
-    if (!outline) return nullptr;
+    auto area = 0.0f;
+    for (int i = 0; i < cnt; ++i) {
+        auto& a = pts[i];
+        auto& b = pts[(i + 1) % cnt];
+        area += a.x * b.y - b.x * a.y;
+    }
+    if (area > 0.0f) std::reverse(pts, pts + cnt);
 
-    constexpr auto RENDER_POOL_SIZE = 16384L;
-    constexpr auto BAND_SIZE = 40;
+    auto start = UPSCALE(pts[0]);
+    if (!_moveTo(rw, start)) return false;
+    for (int i = 1; i < cnt; ++i) {
+        if (!_lineTo(rw, UPSCALE(pts[i]))) return false;
+    }
+    return _lineTo(rw, start);
+}
 
-    //TODO: We can preserve several static workers in advance
-    RleWorker rw;
-    Cell buffer[RENDER_POOL_SIZE / sizeof(Cell)];
+
+//the cap at the end point p, toward the unit direction d
+static bool _hairlineCap(RleWorker& rw, const SwHairline& line, const Point& p, const Point& d)
+{
+    Point n = {-d.y * line.hw, d.x * line.hw};
+
+    if (line.cap == StrokeCap::Square) {
+        Point e = d * line.hw;
+        Point pts[] = {p + n, p + n + e, p - n + e, p - n};
+        return _polygon(rw, pts, 4);
+    }
+
+    //the half disc, a few chords are enough for the radius under a pixel
+    constexpr int ARCS = 4;
+    Point pts[ARCS + 1];
+    for (int i = 0; i <= ARCS; ++i) {
+        auto t = MATH_PI * float(i) / float(ARCS);
+        pts[i] = p + n * cosf(t) + d * (line.hw * sinf(t));
+    }
+    return _polygon(rw, pts, ARCS + 1);
+}
+
+
+//the outer corner at the point p, in between the unit directions d1 and d2
+static bool _hairlineJoin(RleWorker& rw, const SwHairline& line, StrokeJoin join, const Point& p, const Point& d1, const Point& d2)
+{
+    auto cross = d1.x * d2.y - d1.y * d2.x;
+    auto dot = d1.x * d2.x + d1.y * d2.y;
+    if (fabsf(cross) < FLOAT_EPSILON && dot > 0.0f) return true;   //straight
+
+    //the outer side is against the turn
+    auto s = (cross > 0.0f) ? -line.hw : line.hw;
+    Point n1 = {-d1.y * s, d1.x * s};
+    Point n2 = {-d2.y * s, d2.x * s};
+
+    if (join == StrokeJoin::Round) {
+        //the arc from n1 to n2 around p
+        constexpr int ARCS = 4;
+        auto angle = acosf(std::max(-1.0f, std::min(1.0f, dot))) / float(ARCS);
+        auto c = cosf(angle);
+        auto sn = (cross > 0.0f) ? sinf(angle) : -sinf(angle);
+        Point pts[ARCS + 2];
+        pts[0] = p;
+        auto n = n1;
+        for (int i = 1; i <= ARCS + 1; ++i) {
+            pts[i] = p + n;
+            n = {n.x * c - n.y * sn, n.x * sn + n.y * c};
+        }
+        return _polygon(rw, pts, ARCS + 2);
+    }
+
+    //the miter ratio, 1 / cos(half of the turn)
+    if (join == StrokeJoin::Miter && dot > -1.0f) {
+        auto ratio = 1.0f / sqrtf((1.0f + dot) * 0.5f);
+        if (ratio <= line.miterlimit) {
+            auto m = n1 + n2;
+            auto len = sqrtf(m.x * m.x + m.y * m.y);
+            if (len > FLOAT_EPSILON) {
+                Point pts[] = {p, p + n1, p + m * (line.hw * ratio / len), p + n2};
+                return _polygon(rw, pts, 4);
+            }
+        }
+    }
+
+    //bevel
+    Point pts[] = {p, p + n1, p + n2};
+    return _polygon(rw, pts, 3);
+}
+
+
+//the upper side of the strip goes forward, the lower side comes back
+static inline void _stripAdd(Point* sides, int cnt, const Point& upper, const Point& lower)
+{
+    memmove(sides + cnt + 2, sides + cnt, sizeof(Point) * cnt);
+    sides[cnt] = upper;
+    sides[cnt + 1] = lower;
+}
+
+
+/* Each line of the hairline is a thin quad, each curve is a strip of its flattened pieces, the joins and the caps
+   are the small polygons of their own. They go to the cells directly, the non-zero rule merges the overlaps. */
+static bool _genHairline(RleWorker& rw, const SwHairline& line)
+{
+    auto& path = *line.path;
+    auto& m = *line.transform;
+    auto pt = path.pts.data;
+
+    Point start{}, cur{}, startDir{}, curDir{};
+    auto segs = 0;
+
+    //the flattened pieces of a curve share a strip, its sides are offset along the bisectors of the pieces
+    constexpr int STRIP = 16;
+    Point sides[(STRIP + 1) * 2];
+    auto strip = 0;
+
+    auto flush = [&]() {
+        if (strip == 0) return true;
+        Point n = {-curDir.y * line.hw, curDir.x * line.hw};
+        _stripAdd(sides, strip, cur + n, cur - n);
+        auto cnt = (strip + 1) * 2;
+        strip = 0;
+        return _polygon(rw, sides, cnt);
+    };
+
+    auto lineTo = [&](const Point& to) {
+        if (!flush()) return false;
+        auto d = to - cur;
+        auto len = sqrtf(d.x * d.x + d.y * d.y);
+        if (len < FLOAT_EPSILON) return true;
+        d = d * (1.0f / len);
+        if (segs == 0) startDir = d;
+        else if (!_hairlineJoin(rw, line, line.join, cur, curDir, d)) return false;
+        Point n = {-d.y * line.hw, d.x * line.hw};
+        Point pts[] = {cur + n, to + n, to - n, cur - n};
+        if (!_polygon(rw, pts, 4)) return false;
+        cur = to;
+        curDir = d;
+        ++segs;
+        return true;
+    };
+
+    auto curveTo = [&](const Point& to) {
+        auto d = to - cur;
+        auto len = sqrtf(d.x * d.x + d.y * d.y);
+        if (len < FLOAT_EPSILON) return true;
+        d = d * (1.0f / len);
+        Point n = {-d.y * line.hw, d.x * line.hw};
+        if (strip > 0) {
+            //a sharp turn breaks the strip, a bevel fills the gap
+            if (strip == STRIP || (d.x * curDir.x + d.y * curDir.y) < 0.9f) {
+                if (!flush() || !_hairlineJoin(rw, line, StrokeJoin::Bevel, cur, curDir, d)) return false;
+            } else {
+                Point b = {n.x - curDir.y * line.hw, n.y + curDir.x * line.hw};
+                b = b * (line.hw * line.hw / (b.x * n.x + b.y * n.y));
+                _stripAdd(sides, strip, cur + b, cur - b);
+            }
+        } else if (segs == 0) startDir = d;
+        else if (!_hairlineJoin(rw, line, line.join, cur, curDir, d)) return false;
+        if (strip == 0) {
+            sides[0] = cur + n;
+            sides[1] = cur - n;
+        }
+        ++strip;
+        cur = to;
+        curDir = d;
+        ++segs;
+        return true;
+    };
+
+    auto end = [&](bool closed) {
+        if (!flush()) return false;
+        if (segs == 0) return true;
+        if (closed) return _hairlineJoin(rw, line, line.join, start, curDir, startDir);
+        if (line.cap == StrokeCap::Butt) return true;
+        return _hairlineCap(rw, line, start, -startDir) && _hairlineCap(rw, line, cur, curDir);
+    };
+
+    ARRAY_FOREACH(cmd, path.cmds) {
+        switch (*cmd) {
+            case PathCommand::MoveTo: {
+                if (!end(false)) return false;
+                start = cur = *pt * m;
+                segs = 0;
+                ++pt;
+                break;
+            }
+            case PathCommand::LineTo: {
+                if (!lineTo(*pt * m)) return false;
+                ++pt;
+                break;
+            }
+            case PathCommand::Close: {
+                if (!lineTo(start) || !end(true)) return false;
+                cur = start;
+                segs = 0;
+                break;
+            }
+            case PathCommand::CubicTo: {
+                Bezier bz = {cur, pt[0] * m, pt[1] * m, pt[2] * m};
+                auto cnt = bz.segments();
+                for (uint32_t i = 1; i < cnt; ++i) {
+                    if (!curveTo(bz.at(float(i) / float(cnt)))) return false;
+                }
+                if (!curveTo(bz.end)) return false;
+                pt += 3;
+                break;
+            }
+        }
+    }
+    if (!end(false)) return false;
+    if (!rw.invalid && !_recordCell(rw)) return false;
+    return true;
+}
+
+
+static void _init(RleWorker& rw, SwRle* rle, SwTiles* tiles, const RenderRegion& bbox, SwCellPool* pool, bool antiAlias)
+{
+    constexpr auto CELL_POOL_SIZE = 1024;
 
     //Init Cells
-    rw.buffer = buffer;
-    rw.bufferSize = sizeof(buffer);
-    rw.yCells = reinterpret_cast<Cell**>(buffer);
-    rw.cells = nullptr;
-    rw.maxCells = 0;
-    rw.cellsCnt = 0;
+    rw.pool = pool;
     rw.area = 0;
     rw.cover = 0;
     rw.invalid = true;
     rw.cellMin = {bbox.min.x, bbox.min.y};
-    rw.cellMax = {bbox.max.x, bbox.max.y};
-    rw.cellXCnt = rw.cellMax.x - rw.cellMin.x;
-    rw.cellYCnt = rw.cellMax.y - rw.cellMin.y;
-    rw.outline = const_cast<SwOutline*>(outline);
-    rw.bandSize = rw.bufferSize / (sizeof(Cell) * 2);  //bandSize: 256
-    rw.bandShoot = 0;
+    if (tiles) rw.cellMax = {bbox.max.x, bbox.max.y};
+    else rw.cellMax = {std::min(bbox.max.x, int32_t(USHRT_MAX)), std::min(bbox.max.y, int32_t(USHRT_MAX))};  //the span coordinates limit
+    rw.cellXCnt = std::max(rw.cellMax.x - rw.cellMin.x, 0);
+    rw.cellYCnt = std::max(rw.cellMax.y - rw.cellMin.y, 0);
     rw.antiAlias = antiAlias;
 
-    if (!rle) rw.rle = new SwRle;
-    else rw.rle = rle;
-    rw.rle->spans.reserve(256);
+    //the cells of the whole area are kept at once, it grows on demand instead of splitting into the smaller bands
+    pool->cells.clear();
+    pool->cells.reserve(CELL_POOL_SIZE);
+    pool->yCells.clear();
+    pool->yCells.reserve(rw.cellYCnt * 2);
+    rw.cells = pool->cells.data;
+    rw.yCells = pool->yCells.data;
+    rw.xCells = pool->yCells.data + rw.cellYCnt;
+    for (int y = 0; y < rw.cellYCnt * 2; ++y) {
+        rw.yCells[y] = -1;
+    }
+    ++pool->renders;
+
+    rw.tiles = tiles;
+    if (tiles) {
+        rw.rle = nullptr;
+        rw.stripX = rw.cellMin.x & ~(SW_TILE_W - 1);
+        rw.stripW = std::max(((rw.cellMax.x + SW_TILE_W - 1) & ~(SW_TILE_W - 1)) - rw.stripX, 0);
+        rw.tileY = rw.cellMin.y & ~(SW_TILE_H - 1);
+        rw.touchMin = INT32_MAX;
+        rw.touchMax = INT32_MIN;
+        pool->strip.reserve(rw.stripW * SW_TILE_H);
+        rw.strip = pool->strip.data;
+        memset(rw.strip, 0, rw.stripW * SW_TILE_H);
+        tiles->tiles.reserve(64);
+    } else {
+        if (!rle) rw.rle = new SwRle;
+        else rw.rle = rle;
+        rw.rle->spans.reserve(256);
+    }
+}
+
+
+static bool _render(SwRle* rle, SwTiles* tiles, const SwOutline* outline, const RenderRegion& bbox, SwCellPool* pool, bool antiAlias, float tolerance)
+{
+    RleWorker rw;
+    _init(rw, rle, tiles, bbox, pool, antiAlias);
+    rw.outline = const_cast<SwOutline*>(outline);
+    rw.fillRule = outline->fillRule;
+    rw.flatness = std::max(int32_t(ONE_PIXEL * tolerance * (4.0f / 3.0f)), 1);
 
     //Generate RLE
-    Band bands[BAND_SIZE];
-    Band* band;
+    if (!_genRle(rw)) return false;
+    _sweep(rw);
 
-    /* set up vertical bands */
-    auto bandCnt = static_cast<int>((rw.cellMax.y - rw.cellMin.y) / rw.bandSize);
-    if (bandCnt == 0) bandCnt = 1;
-    else if (bandCnt >= BAND_SIZE) bandCnt = (BAND_SIZE - 1);
+    return true;
+}
 
-    auto min = rw.cellMin.y;
-    auto yMax = rw.cellMax.y;
-    int32_t max;
 
-    for (int n = 0; n < bandCnt; ++n, min = max) {
-        max = min + rw.bandSize;
-        if (n == bandCnt -1 || max > yMax) max = yMax;
+/* A band of the rows rasterized on its own. The whole outline is walked again, but the edges out of the band are skipped
+   cheaply by the vertical clipping and the cells of the band come out exactly the same. */
+struct RleBandTask : Task
+{
+    SwRle rle;
+    SwTiles tiles;
+    SwCellPool pool{};     //the cell pools of the threads might be in use by the suspended ones
+    RenderRegion bbox;
+    const SwOutline* outline;
+    float tolerance;
+    bool antiAlias;
+    bool tiled;            //generates the tiles instead of the rle
+    bool ret;
 
-        bands[0].min = min;
-        bands[0].max = max;
-        band = bands;
+    void run(TVG_UNUSED unsigned tid) override
+    {
+        if (tiled) ret = _render(nullptr, &tiles, outline, bbox, &pool, antiAlias, tolerance);
+        else ret = _render(&rle, nullptr, outline, bbox, &pool, antiAlias, tolerance);
+    }
+};
 
-        while (band >= bands) {
-            rw.yCells = static_cast<Cell**>(rw.buffer);
-            rw.yCnt = band->max - band->min;
 
-            int cellStart = sizeof(Cell*) * (int)rw.yCnt;
-            int cellMod = cellStart % sizeof(Cell);
+//the number of the bands for the available workers, 1 if not worth it
+static int32_t _bands(const RenderRegion& bbox)
+{
+    static constexpr int32_t MIN_ROWS = 64;
+    static constexpr int32_t BAND_SIZE = 512 * 512;   //not worth to walk the outline again for the small ones
 
-            if (cellMod > 0) cellStart += sizeof(Cell) - cellMod;
+    if (TaskScheduler::threads() > 0 && bbox.w() * bbox.h() >= BAND_SIZE) return std::min(int32_t(TaskScheduler::threads()) + 1, bbox.sh() / MIN_ROWS);
+    return 1;
+}
 
-            auto cellsMax = reinterpret_cast<Cell*>((char*)rw.buffer + rw.bufferSize);
-            rw.cells = reinterpret_cast<Cell*>((char*)rw.buffer + cellStart);
 
-            if (rw.cells >= cellsMax) goto reduce_bands;
+/* split the rows into the bands among the workers, the calling thread takes the first one and the others follow it in order.
+   the bands of the tiles begin at the tile rows, so that they don't share any. */
+static bool _render(SwRle* rle, SwTiles* tiles, const SwOutline* outline, const RenderRegion& bbox, SwCellPool* pool, bool antiAlias, float tolerance, int32_t cnt)
+{
+    static constexpr int32_t MAX_BANDS = 16;
+
+    if (cnt > MAX_BANDS) cnt = MAX_BANDS;
+    auto top = bbox.min.y;
+    auto rows = (bbox.sh() + cnt - 1) / cnt;
+    if (tiles) {
+        top &= ~(SW_TILE_H - 1);
+        rows = (((bbox.max.y - top + cnt - 1) / cnt) + SW_TILE_H - 1) & ~(SW_TILE_H - 1);
+    }
 
-            rw.maxCells = cellsMax - rw.cells;
-            if (rw.maxCells < 2) goto reduce_bands;
+    RleBandTask tasks[MAX_BANDS - 1];
+    TaskGroup group;
+
+    for (int32_t i = 1; i < cnt; ++i) {
+        auto& task = tasks[i - 1];
+        task.bbox = bbox;
+        task.bbox.min.y = std::min(bbox.max.y, top + i * rows);
+        task.bbox.max.y = std::min(bbox.max.y, top + (i + 1) * rows);
+        task.outline = outline;
+        task.tolerance = tolerance;
+        task.antiAlias = antiAlias;
+        task.tiled = tiles ? true : false;
+        group.request(&task);
+    }
 
-            for (int y = 0; y < rw.yCnt; ++y)
-                rw.yCells[y] = nullptr;
+    auto band = bbox;
+    band.max.y = std::min(bbox.max.y, top + rows);
+    auto ret = _render(rle, tiles, outline, band, pool, antiAlias, tolerance);
+    group.wait();
+
+    //the bands don't share any scanline, their spans are simply concatenated
+    for (int32_t i = 1; i < cnt; ++i) {
+        auto& task = tasks[i - 1];
+        if (!task.ret) ret = false;
+        else if (ret) {
+            if (tiles) {
+                tiles->tiles.push(task.tiles.tiles);
+                tiles->fills.push(task.tiles.fills);
+            } else rle->spans.push(task.rle.spans);
+        }
+    }
+    return ret;
+}
 
-            rw.cellsCnt = 0;
-            rw.invalid = true;
-            rw.cellMin.y = band->min;
-            rw.cellMax.y = band->max;
-            rw.cellYCnt = band->max - band->min;
 
-            if (_genRle(rw)) {
-                _sweep(rw);
-                --band;
-                continue;
-            }
+/************************************************************************/
+/* External Class Implementation                                        */
+/************************************************************************/
 
-        reduce_bands:
-            /* render pool overflow: we will reduce the render band by half */
-            auto bottom = band->min;
-            auto top = band->max;
-            auto middle = bottom + ((top - bottom) >> 1);
-
-            /* This is too complex for a single scanline; there must
-               be some problems */
-            if (middle == bottom) {
-                rleFree(rw.rle);
-                return nullptr;
-            }
+SwRle* rleRender(SwRle* rle, const SwOutline* outline, const RenderRegion& bbox, SwCellPool* pool, bool antiAlias, float tolerance)
+{
+    if (!outline) return nullptr;
+    if (!rle) rle = new SwRle;
 
-            if (bottom - top >= rw.bandSize) ++rw.bandShoot;
+    auto cnt = _bands(bbox);
 
-            band[1].min = bottom;
-            band[1].max = middle;
-            band[0].min = middle;
-            band[0].max = top;
-            ++band;
-        }
+    auto ret = false;
+    if (cnt > 1) ret = _render(rle, nullptr, outline, bbox, pool, antiAlias, tolerance, cnt);
+    else ret = _render(rle, nullptr, outline, bbox, pool, antiAlias, tolerance);
+
+    if (!ret) {
+        rleFree(rle);
+        return nullptr;
+    }
+    return rle;
+}
+
+
+SwTiles* tilesRender(SwTiles* tiles, const SwOutline* outline, const RenderRegion& bbox, SwCellPool* pool, bool antiAlias, float tolerance)
+{
+    if (!outline) return nullptr;
+    if (!tiles) tiles = new SwTiles;
+
+    auto cnt = _bands(bbox);
+
+    auto ret = false;
+    if (cnt > 1) ret = _render(nullptr, tiles, outline, bbox, pool, antiAlias, tolerance, cnt);
+    else ret = _render(nullptr, tiles, outline, bbox, pool, antiAlias, tolerance);
+
+    if (!ret) {
+        tilesFree(tiles);
+        return nullptr;
     }
-    if (rw.bandShoot > 8 && rw.bandSize > 16) {
-        rw.bandSize = (rw.bandSize >> 1);
+    return tiles;
+}
+
+
+SwRle* rleRender(SwRle* rle, const SwHairline& line, const RenderRegion& bbox, SwCellPool* pool)
+{
+    RleWorker rw;
+    _init(rw, rle, nullptr, bbox, pool, true);
+    rw.outline = nullptr;
+    rw.fillRule = FillRule::NonZero;
+    rw.flatness = 1;
+
+    if (!_genHairline(rw, line)) {
+        rleFree(rw.rle);
+        return nullptr;
     }
+    _sweep(rw);
+
     return rw.rle;
 }
 
 
+//appends the pixels to the last span if they continue it
+static inline void _span(Array<SwSpan>& spans, int32_t x, int32_t y, int32_t len, uint8_t coverage)
+{
+    if (x >= USHRT_MAX) return;
+    len = std::min(len, USHRT_MAX - x);
+    if (!spans.empty()) {
+        auto& span = spans.last();
+        if (span.coverage == coverage && span.y == y && span.x + span.len == x && span.len + len <= USHRT_MAX) {
+            span.len += len;
+            return;
+        }
+    }
+    spans.push({uint16_t(x), uint16_t(y), uint16_t(len), coverage});
+}
+
+
+//the spans of the tiles within the span coordinates, for the kernels of the spans only
+SwRle* rleRender(SwRle* rle, const SwTiles* tiles)
+{
+    if (!rle) rle = new SwRle;
+    rle->spans.clear();
+    if (!tiles) return rle;
+
+    auto tile = tiles->tiles.begin();
+    auto tend = tiles->tiles.end();
+    auto fill = tiles->fills.begin();
+    auto fend = tiles->fills.end();
+
+    while (tile < tend || fill < fend) {
+        //the next tile row
+        auto y = INT32_MAX;
+        if (tile < tend) y = tile->y;
+        if (fill < fend && fill->y < y) y = fill->y;
+        if (y >= USHRT_MAX) break;
+
+        auto tbegin = tile;
+        auto fbegin = fill;
+        while (tile < tend && tile->y == y) ++tile;
+        while (fill < fend && fill->y == y) ++fill;
+
+        for (auto r = 0; r < SW_TILE_H && y + r < USHRT_MAX; ++r) {
+            auto t = tbegin;
+            auto f = fbegin;
+            //both are sorted by x, and never overlap
+            while (t < tile || f < fill) {
+                if (f < fill && (t == tile || f->x < t->x)) {
+                    _span(rle->spans, f->x, y + r, f->len, 255);
+                    ++f;
+                    continue;
+                }
+                for (auto i = 0; i < SW_TILE_W; ++i) {
+                    if (auto coverage = t->coverage[r][i]) _span(rle->spans, t->x + i, y + r, 1, coverage);
+                }
+                ++t;
+            }
+        }
+    }
+    return rle;
+}
+
+
 SwRle* rleRender(const RenderRegion* bbox)
 {
     auto rle = tvg::calloc<SwRle*>(sizeof(SwRle), 1);
@@ -862,12 +1339,140 @@ SwRle* rleRender(const RenderRegion* bbox)
 }
 
 
+static inline int32_t _floor(float v)
+{
+    auto i = int32_t(v);
+    return (float(i) > v) ? (i - 1) : i;
+}
+
+
+static inline int32_t _ceil(float v)
+{
+    auto i = int32_t(v);
+    return (float(i) < v) ? (i + 1) : i;
+}
+
+
+SwRle* rleRender(SwRle* rle, const SwPrimitive& prim, const RenderRegion& bbox, bool antiAlias)
+{
+    if (!rle) rle = new SwRle;
+    rle->spans.reserve(rle->spans.count + 3 * bbox.h());
+
+    auto xMin = bbox.min.x;
+    auto xMax = std::min(bbox.max.x, int32_t(USHRT_MAX));
+    auto yMax = std::min(bbox.max.y, int32_t(USHRT_MAX));
+
+    //the straight parts in between the corners
+    auto left = prim.min.x + prim.radius.x;
+    auto right = prim.max.x - prim.radius.x;
+    auto top = prim.min.y + prim.radius.y;
+    auto bottom = prim.max.y - prim.radius.y;
+    auto corner = prim.radius.x > 0.0f;
+    auto irx = corner ? 1.0f / prim.radius.x : 0.0f;
+    auto iry = corner ? 1.0f / prim.radius.y : 0.0f;
+
+    //the horizontal offset of the corner at the vertical distance from the straight part
+    auto offset = [&](float dy) {
+        if (dy <= 0.0f) return 0.0f;
+        auto t = dy * iry;
+        return prim.radius.x * (1.0f - sqrtf(std::max(1.0f - t * t, 0.0f)));
+    };
+
+    auto span = [&](int32_t x, int32_t y, int32_t len, float area) {
+        auto coverage = int32_t(area * 256.0f);
+        if (coverage <= 0) return;
+        if (coverage > 255 || !antiAlias) coverage = 255;
+        if (x < xMin) {
+            len -= (xMin - x);
+            x = xMin;
+        }
+        if (x + len > xMax) len = xMax - x;
+        if (len <= 0) return;
+        if (!rle->spans.empty()) {
+            auto& last = rle->spans.last();
+            if (last.coverage == coverage && last.y == y && last.x + last.len == x) {
+                last.len += len;
+                return;
+            }
+        }
+        rle->spans.next() = {uint16_t(x), uint16_t(y), uint16_t(len), uint8_t(coverage)};
+    };
+
+    for (auto y = bbox.min.y; y < yMax; ++y) {
+        auto y1 = std::max(float(y), prim.min.y);
+        auto y2 = std::min(float(y + 1), prim.max.y);
+        if (y1 >= y2) continue;
+        auto h = y2 - y1;
+
+        //the range of the corner curves in this scanline
+        auto dy1 = std::max(top - y1, y2 - bottom);
+        auto dy2 = (y2 <= top) ? (top - y2) : ((y1 >= bottom) ? (y1 - bottom) : 0.0f);
+        auto off1 = offset(dy1);
+        auto off2 = offset(dy2);
+        auto l = _floor(prim.min.x + off2);
+        auto il = _ceil(prim.min.x + off1);
+        auto ir = _floor(prim.max.x - off1);
+        auto r = _ceil(prim.max.x - off2);
+        if (il >= ir) il = ir = r;
+
+        //the vertical distance of the pixel centers from the straight part
+        auto cy = float(y) + 0.5f;
+        auto v = (cy < top) ? (top - cy) : ((cy > bottom) ? (cy - bottom) : 0.0f);
+
+        /* the exact area of the straight parts,
+           the approximated distance from the ellipse of the corners */
+        auto area = [&](int32_t x) {
+            auto cx = float(x) + 0.5f;
+            auto u = (cx < left) ? (left - cx) : ((cx > right) ? (cx - right) : 0.0f);
+            if (corner && u > 0.0f && v > 0.0f) {
+                auto pu = u * irx, pv = v * iry;
+                auto k0 = sqrtf(pu * pu + pv * pv);
+                auto k1 = sqrtf(pu * pu * irx * irx + pv * pv * iry * iry);
+                return std::min(std::max(0.5f - k0 * (k0 - 1.0f) / k1, 0.0f), 1.0f);
+            }
+            return std::max(std::min(prim.max.x, float(x + 1)) - std::max(prim.min.x, float(x)), 0.0f) * h;
+        };
+
+        for (auto x = l; x < il; ++x) span(x, y, 1, area(x));
+        if (il < ir) span(il, y, ir - il, h);
+        for (auto x = ir; x < r; ++x) span(x, y, 1, area(x));
+    }
+
+    return rle;
+}
+
+
 void rleReset(SwRle* rle)
 {
     if (rle) rle->spans.clear();
 }
 
 
+void rleTranslate(SwRle* rle, int32_t x, int32_t y)
+{
+    if (!rle) return;
+
+    ARRAY_FOREACH(p, rle->spans) {
+        p->x = uint16_t(p->x + x);
+        p->y = uint16_t(p->y + y);
+    }
+}
+
+
+//any coverage of the spans in the region? the spans are sorted by y, then x
+bool rleIntersects(const SwRle* rle, const RenderRegion& region)
+{
+    if (!rle || rle->invalid()) return false;
+
+    const SwSpan* end;
+    int32_t x, len;
+    for (auto span = rle->fetch(region, &end); span < end; ++span) {
+        if (span->coverage > 0 && span->fetch(region, x, len)) return true;
+    }
+    return false;
+}
+
+
 void rleFree(SwRle* rle)
 {
     delete(rle);
@@ -902,21 +1507,19 @@ bool rleClip(SwRle *rle, const SwRle *clip)
             ++cspans;
             continue;
         }
-        //try clipping with all clip spans which have a same y-coordinate.
-        auto temp = cspans;
-        while(temp < cend && temp->y == cspans->y) {
-            //span must be left(x1) to right(x2) direction. Not intersected.
-            if ((spans->x + spans->len) < spans->x || (temp->x + temp->len) < temp->x) {
-                ++temp;
-                continue;
-            }
-            //clip span region
-            auto x = std::max(spans->x, temp->x);
-            auto len = std::min((spans->x + spans->len), (temp->x + temp->len)) - x;
-            if (len > 0) out.next() = {uint16_t(x), temp->y, uint16_t(len), (uint8_t)(((spans->coverage * temp->coverage) + 0xff) >> 8)};
-            ++temp;
+        //both spans are sorted by x-coordinate in a line, sweep them together from left to right.
+        auto y = spans->y;
+        while (spans < end && cspans < cend && spans->y == y && cspans->y == y) {
+            auto x1 = spans->x + spans->len;
+            auto x2 = cspans->x + cspans->len;
+            auto x = std::max(spans->x, cspans->x);
+            auto len = std::min(x1, x2) - x;
+            if (len > 0) out.next() = {uint16_t(x), y, uint16_t(len), (uint8_t)(((spans->coverage * cspans->coverage) + 0xff) >> 8)};
+            if (x1 < x2) ++spans;
+            else ++cspans;
         }
-        ++spans;
+        while (spans < end && spans->y == y) ++spans;
+        while (cspans < cend && cspans->y == y) ++cspans;
     }
     out.move(rle->spans);
     return true;
@@ -956,3 +1559,44 @@ bool rleClip(SwRle *rle, const RenderRegion* clip)
     out.move(rle->spans);
     return true;
 }
+
+
+void tilesReset(SwTiles* tiles)
+{
+    if (!tiles) return;
+    tiles->tiles.clear();
+    tiles->fills.clear();
+}
+
+
+void tilesFree(SwTiles* tiles)
+{
+    delete(tiles);
+}
+
+
+//any coverage of the tiles in the region?
+bool tilesIntersects(const SwTiles* tiles, const RenderRegion& region)
+{
+    if (!tiles || tiles->invalid()) return false;
+
+    //the fills are covered in all their rows
+    const SwTileFill* fend;
+    for (auto fill = SwTiles::fetch(tiles->fills, region, &fend); fill < fend; ++fill) {
+        if (fill->x < region.max.x && fill->x + fill->len > region.min.x) return true;
+    }
+
+    const SwTile* tend;
+    for (auto tile = SwTiles::fetch(tiles->tiles, region, &tend); tile < tend; ++tile) {
+        auto x1 = std::max(tile->x, region.min.x) - tile->x;
+        auto x2 = std::min(tile->x + SW_TILE_W, region.max.x) - tile->x;
+        auto y1 = std::max(tile->y, region.min.y) - tile->y;
+        auto y2 = std::min(tile->y + SW_TILE_H, region.max.y) - tile->y;
+        for (auto y = y1; y < y2; ++y) {
+            for (auto x = x1; x < x2; ++x) {
+                if (tile->coverage[y][x] > 0) return true;
+            }
+        }
+    }
+    return false;
+}
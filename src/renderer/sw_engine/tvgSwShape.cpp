@@ -20,6 +20,7 @@
  * SOFTWARE.
  */
 
+#include <limits.h>
 #include "tvgSwCommon.h"
 
 /************************************************************************/
@@ -47,37 +48,56 @@ static bool _outlineEnd(SwOutline& outline)
 }
 
 
-static bool _outlineMoveTo(SwOutline& outline, const Point* to, const Matrix& transform, bool closed = false)
+static bool _outlineMoveTo(SwOutline& outline, const SwPoint& to, bool closed = false)
 {
     //make it a contour, if the last contour is not closed yet.
     if (!closed) _outlineEnd(outline);
 
-    outline.pts.push(mathTransform(to, transform));
+    outline.pts.push(to);
     outline.types.push(SW_CURVE_TYPE_POINT);
     return false;
 }
 
 
-static void _outlineLineTo(SwOutline& outline, const Point* to, const Matrix& transform)
+static void _outlineLineTo(SwOutline& outline, const SwPoint& to)
 {
-    outline.pts.push(mathTransform(to, transform));
+    outline.pts.push(to);
     outline.types.push(SW_CURVE_TYPE_POINT);
 }
 
 
-static void _outlineCubicTo(SwOutline& outline, const Point* ctrl1, const Point* ctrl2, const Point* to, const Matrix& transform)
+static void _outlineCubicTo(SwOutline& outline, const SwPoint* pts)
 {
-    outline.pts.push(mathTransform(ctrl1, transform));
+    outline.pts.push(pts[0]);
     outline.types.push(SW_CURVE_TYPE_CUBIC);
 
-    outline.pts.push(mathTransform(ctrl2, transform));
-    outline.types.push(SW_CURVE_TYPE_CUBIC);    
+    outline.pts.push(pts[1]);
+    outline.types.push(SW_CURVE_TYPE_CUBIC);
 
-    outline.pts.push(mathTransform(to, transform));
+    outline.pts.push(pts[2]);
     outline.types.push(SW_CURVE_TYPE_POINT);
 }
 
 
+static bool _outlineMoveTo(SwOutline& outline, const Point* to, const Matrix& transform, bool closed = false)
+{
+    return _outlineMoveTo(outline, mathTransform(to, transform), closed);
+}
+
+
+static void _outlineLineTo(SwOutline& outline, const Point* to, const Matrix& transform)
+{
+    _outlineLineTo(outline, mathTransform(to, transform));
+}
+
+
+static void _outlineCubicTo(SwOutline& outline, const Point* ctrl1, const Point* ctrl2, const Point* to, const Matrix& transform)
+{
+    SwPoint pts[] = {mathTransform(ctrl1, transform), mathTransform(ctrl2, transform), mathTransform(to, transform)};
+    _outlineCubicTo(outline, pts);
+}
+
+
 static bool _outlineClose(SwOutline& outline)
 {
     uint32_t i;
@@ -168,10 +188,76 @@ static void _dashLineTo(SwDashStroke& dash, const Point* to, const Matrix& trans
 }
 
 
+//measure the curve piece by piece as Bezier::length() does, keeping the (t, length) at the end of each flat piece
+static void _arcs(Array<Point>& arcs, const Bezier& cur, float t1, float t2, float& len)
+{
+    auto poly = length(cur.ctrl1 - cur.start) + length(cur.ctrl2 - cur.ctrl1) + length(cur.end - cur.ctrl2);
+    auto chord = length(cur.end - cur.start);
+
+    if (fabsf(poly - chord) > 1e-2f) {
+        Bezier left, right;
+        cur.split(left, right);
+        auto t = (t1 + t2) * 0.5f;
+        _arcs(arcs, left, t1, t, len);
+        _arcs(arcs, right, t, t2, len);
+        return;
+    }
+    len += poly;
+    arcs.push({t2, len});
+}
+
+
+//the parameter t at the length, the flat piece containing it is measured by its chord
+static float _arcAt(const Bezier& cur, const Array<Point>& arcs, float at)
+{
+    uint32_t lo = 0, hi = arcs.count - 1;
+    while (lo < hi) {
+        auto mid = (lo + hi) / 2;
+        if (arcs[mid].y < at) lo = mid + 1;
+        else hi = mid;
+    }
+
+    auto t1 = lo > 0 ? arcs[lo - 1].x : 0.0f;
+    auto t2 = arcs[lo].x;
+    at -= lo > 0 ? arcs[lo - 1].y : 0.0f;
+
+    auto pt = cur.at(t1);
+    auto t = t2;
+    for (int i = 0; i < 16; ++i) {
+        t = (t1 + t2) * 0.5f;
+        auto d = length(cur.at(t) - pt) - at;
+        if (fabsf(d) < 1e-3f) break;
+        if (d < 0.0f) t1 = t;
+        else t2 = t;
+    }
+    return t;
+}
+
+
+//the piece of the curve between t1 and t2
+static Bezier _arcPiece(const Bezier& cur, float t1, float t2)
+{
+    auto ret = cur;
+    if (t2 < 1.0f) {
+        auto right = cur;
+        right.split(t2, ret);
+    }
+    if (t1 > 0.0f) {
+        Bezier left;
+        ret.split(t1 / t2, left);
+    }
+    return ret;
+}
+
+
 static void _dashCubicTo(SwDashStroke& dash, const Point* ctrl1, const Point* ctrl2, const Point* to, const Matrix& transform, bool validPoint)
 {
     Bezier cur = {dash.ptCur, *ctrl1, *ctrl2, *to};
-    auto len = cur.length();
+
+    //the dashes are cut at the lengths along the curve without measuring the rest of it again
+    auto len = 0.0f;
+    dash.arcs.clear();
+    _arcs(dash.arcs, cur, 0.0f, 1.0f, len);
 
     //draw the current line fully
     if (tvg::zero(len)) {
@@ -187,37 +273,40 @@ static void _dashCubicTo(SwDashStroke& dash, const Point* ctrl1, const Point* ct
         }
     //draw the current line partially
     } else {
+        auto pos = 0.0f;   //the cut length and parameter on the curve
+        auto t = 0.0f;
         while ((len - dash.curLen) > DASH_PATTERN_THRESHOLD) {
-            Bezier left, right;
             if (dash.curLen > 0) {
                 len -= dash.curLen;
-                cur.split(dash.curLen, left, right);
+                pos += dash.curLen;
+                auto t2 = _arcAt(cur, dash.arcs, pos);
                 if (!dash.curOpGap) {
+                    auto left = _arcPiece(cur, t, t2);
                     if (dash.move || dash.pattern[dash.curIdx] - dash.curLen < FLOAT_EPSILON) {
                         _outlineMoveTo(*dash.outline, &left.start, transform);
                         dash.move = false;
                     }
                     _outlineCubicTo(*dash.outline, &left.ctrl1, &left.ctrl2, &left.end, transform);
                 }
+                t = t2;
+                dash.ptCur = cur.at(t);
             } else {
-                if (validPoint && !dash.curOpGap) _drawPoint(dash, &cur.start, transform);
-                right = cur;
+                if (validPoint && !dash.curOpGap) _drawPoint(dash, &dash.ptCur, transform);
             }
             dash.curIdx = (dash.curIdx + 1) % dash.cnt;
             dash.curLen = dash.pattern[dash.curIdx];
             dash.curOpGap = !dash.curOpGap;
-            cur = right;
-            dash.ptCur = right.start;
             dash.move = true;
         }
         //leftovers
         dash.curLen -= len;
         if (!dash.curOpGap) {
+            auto right = _arcPiece(cur, t, 1.0f);
             if (dash.move) {
-                _outlineMoveTo(*dash.outline, &cur.start, transform);
+                _outlineMoveTo(*dash.outline, &right.start, transform);
                 dash.move = false;
             }
-            _outlineCubicTo(*dash.outline, &cur.ctrl1, &cur.ctrl2, &cur.end, transform);
+            _outlineCubicTo(*dash.outline, &right.ctrl1, &right.ctrl2, &right.end, transform);
         }
         if (dash.curLen < 0.1f && TO_SWCOORD(len) > 1) {
             //move to next dash
@@ -339,26 +428,249 @@ static SwOutline* _genDashOutline(const RenderShape* rshape, const Matrix& trans
 }
 
 
+static bool _axisAlignedRect(const SwPoint* pts)
+{
+    auto a = SwPoint{pts[0].x, pts[2].y};
+    auto b = SwPoint{pts[2].x, pts[0].y};
+
+    if ((pts[1] == a && pts[3] == b) || (pts[1] == b && pts[3] == a)) return true;
+
+    return false;
+}
+
+
 static bool _axisAlignedRect(const SwOutline* outline)
 {
     //Fast Track: axis-aligned rectangle?
     if (outline->pts.count != 5) return false;
     if (outline->types[2] == SW_CURVE_TYPE_CUBIC) return false;
 
-    auto pt1 = outline->pts.data + 0;
-    auto pt2 = outline->pts.data + 1;
-    auto pt3 = outline->pts.data + 2;
-    auto pt4 = outline->pts.data + 3;
+    return _axisAlignedRect(outline->pts.data);
+}
 
-    auto a = SwPoint{pt1->x, pt3->y};
-    auto b = SwPoint{pt3->x, pt1->y};
 
-    if ((*pt2 == a && *pt4 == b) || (*pt2 == b && *pt4 == a)) return true;
+static inline bool _equal(float a, float b)
+{
+    return fabsf(a - b) < 1.0f / 64.0f;   //within a subpixel of the rasterizer
+}
+
+
+//the corners of the too sharp curvature are left to the rasterizer, the distance approximation is no longer valid
+static bool _curvature(const Point& radius)
+{
+    if (radius.x > SW_PRIMITIVE_RADIUS || radius.y > SW_PRIMITIVE_RADIUS) return false;
+    auto rmin = std::min(radius.x, radius.y);
+    return rmin * rmin >= std::max(radius.x, radius.y);
+}
 
+
+//is the line on an edge of the bounds?
+static bool _edge(const Point& p1, const Point& p2, const SwPrimitive& prim)
+{
+    if (_equal(p1.x, p2.x) && (_equal(p1.x, prim.min.x) || _equal(p1.x, prim.max.x))) return true;
+    if (_equal(p1.y, p2.y) && (_equal(p1.y, prim.min.y) || _equal(p1.y, prim.max.y))) return true;
     return false;
 }
 
 
+//is the cubic a quarter of an ellipse at a corner of the bounds? return the corner bit
+static int _corner(const Point* pts, const SwPrimitive& prim, Point& radius)
+{
+    auto horiz = [&](const Point& pt) { return _equal(pt.y, prim.min.y) || _equal(pt.y, prim.max.y); };
+    auto vert = [&](const Point& pt) { return _equal(pt.x, prim.min.x) || _equal(pt.x, prim.max.x); };
+
+    //the end points on the horizontal and the vertical edges with their control points
+    const Point *h, *hc, *v, *vc;
+    if (horiz(pts[0]) && vert(pts[3])) {
+        h = pts; hc = pts + 1; vc = pts + 2; v = pts + 3;
+    } else if (vert(pts[0]) && horiz(pts[3])) {
+        v = pts; vc = pts + 1; hc = pts + 2; h = pts + 3;
+    } else return 0;
+
+    auto corner = Point{v->x, h->y};
+    auto r = Point{fabsf(corner.x - h->x), fabsf(corner.y - v->y)};
+    if (r.x < 1.0f / 64.0f || r.y < 1.0f / 64.0f) return 0;
+
+    //the control points of the kappa approximation
+    if (!_equal(hc->y, h->y) || !_equal(hc->x, h->x + (corner.x - h->x) * PATH_KAPPA)) return 0;
+    if (!_equal(vc->x, v->x) || !_equal(vc->y, v->y + (corner.y - v->y) * PATH_KAPPA)) return 0;
+
+    //all corners share the radii
+    if (radius.x > 0.0f && (!_equal(radius.x, r.x) || !_equal(radius.y, r.y))) return 0;
+    radius = r;
+
+    return 1 << ((_equal(corner.x, prim.min.x) ? 0 : 1) + (_equal(corner.y, prim.min.y) ? 0 : 2));
+}
+
+
+/* Primitives: the axis-aligned rectangle, the rounded rectangle and the ellipse of a single contour,
+   like the ones of appendRect() and appendCircle() in either direction. The rectangle is drawn by the fast track,
+   the others generate the spans analytically, the outline is not required for both. */
+static bool _primitive(SwShape* shape, const RenderPath& path, const Matrix& transform, bool hasComposite, float tolerance, SwPoint& min, SwPoint& max)
+{
+    constexpr uint32_t MAX_PTS = 20;
+
+    auto cmds = path.cmds.data;
+    auto cmdCnt = path.cmds.count;
+    auto ptsCnt = path.pts.count;
+
+    if (cmdCnt < 5 || ptsCnt < 4 || ptsCnt > MAX_PTS || cmds[0] != PathCommand::MoveTo) return false;
+    if (cmds[cmdCnt - 1] == PathCommand::Close) --cmdCnt;
+
+    //the device space points
+    Point pts[MAX_PTS];
+    SwPoint spts[MAX_PTS];
+    for (uint32_t i = 0; i < ptsCnt; ++i) {
+        auto pt = path.pts.data + i;
+        pts[i] = {pt->x * transform.e11 + pt->y * transform.e12 + transform.e13, pt->x * transform.e21 + pt->y * transform.e22 + transform.e23};
+        spts[i] = {TO_SWCOORD(pts[i].x), TO_SWCOORD(pts[i].y)};
+    }
+
+    min = max = spts[0];
+    auto& prim = shape->prim;
+    prim.min = prim.max = pts[0];
+    for (uint32_t i = 1; i < ptsCnt; ++i) {
+        if (spts[i].x < min.x) min.x = spts[i].x;
+        if (spts[i].y < min.y) min.y = spts[i].y;
+        if (spts[i].x > max.x) max.x = spts[i].x;
+        if (spts[i].y > max.y) max.y = spts[i].y;
+        if (pts[i].x < prim.min.x) prim.min.x = pts[i].x;
+        if (pts[i].y < prim.min.y) prim.min.y = pts[i].y;
+        if (pts[i].x > prim.max.x) prim.max.x = pts[i].x;
+        if (pts[i].y > prim.max.y) prim.max.y = pts[i].y;
+    }
+
+    //Fast Track, the same condition as the outline of the closed rectangle
+    if (cmdCnt == 4 && path.cmds.count == 5 && ptsCnt == 4) {
+        if (hasComposite || cmds[1] != PathCommand::LineTo || cmds[2] != PathCommand::LineTo || cmds[3] != PathCommand::LineTo) return false;
+        return (shape->fastTrack = _axisAlignedRect(spts));
+    }
+
+    //the coarse flatness is requested, the curves are flattened by the rasterizer
+    if (tolerance > FLATNESS_TOLERANCE) return false;
+
+    auto pt = pts;
+    auto corners = 0;
+    prim.radius = {0.0f, 0.0f};
+
+    auto end = pts + ptsCnt - 1;
+
+    for (uint32_t i = 1; i < cmdCnt; ++i) {
+        if (cmds[i] == PathCommand::LineTo) {
+            if (pt + 1 > end || !_edge(pt[0], pt[1], prim)) return false;
+            ++pt;
+        } else if (cmds[i] == PathCommand::CubicTo) {
+            if (pt + 3 > end) return false;
+            auto corner = _corner(pt, prim, prim.radius);
+            if (!corner || (corners & corner)) return false;
+            corners |= corner;
+            pt += 3;
+        } else return false;
+    }
+
+    //closing back to the start
+    if (corners != 15 || pt != end || !_edge(pt[0], pts[0], prim)) return false;
+
+    auto hsize = Point{(prim.max.x - prim.min.x) * 0.5f, (prim.max.y - prim.min.y) * 0.5f};
+    if (prim.radius.x > hsize.x + 1.0f / 64.0f || prim.radius.y > hsize.y + 1.0f / 64.0f) return false;
+    prim.radius = {std::min(prim.radius.x, hsize.x), std::min(prim.radius.y, hsize.y)};
+    if (!_curvature(prim.radius)) return false;
+
+    return (shape->primitive = true);
+}
+
+
+//is the stroke an axis-aligned line? its stroke region becomes the primitive
+static bool _primitive(const SwStroke* stroke, const RenderShape* rshape, const Matrix& transform, float tolerance, SwPrimitive& prim)
+{
+    auto& path = rshape->path;
+    if (path.cmds.count != 2 || path.pts.count != 2 || path.cmds[0] != PathCommand::MoveTo || path.cmds[1] != PathCommand::LineTo) return false;
+
+    //the stroke width in the device space
+    if (fabsf(stroke->sx - stroke->sy) > FLOAT_EPSILON * stroke->sx) return false;
+    auto hw = rshape->strokeWidth() * 0.5f * stroke->sx;
+
+    auto p1 = path.pts[0] * transform;
+    auto p2 = path.pts[1] * transform;
+    if (_equal(p1.x, p2.x) && _equal(p1.y, p2.y)) return false;
+
+    auto cap = (stroke->cap == StrokeCap::Butt) ? 0.0f : hw;
+    if (stroke->cap == StrokeCap::Round) {
+        if (tolerance > FLATNESS_TOLERANCE) return false;
+        prim.radius = {hw, hw};
+        if (!_curvature(prim.radius)) return false;
+    } else prim.radius = {0.0f, 0.0f};
+
+    if (_equal(p1.y, p2.y)) {
+        auto y = (p1.y + p2.y) * 0.5f;
+        prim.min = {std::min(p1.x, p2.x) - cap, y - hw};
+        prim.max = {std::max(p1.x, p2.x) + cap, y + hw};
+    } else if (_equal(p1.x, p2.x)) {
+        auto x = (p1.x + p2.x) * 0.5f;
+        prim.min = {x - hw, std::min(p1.y, p2.y) - cap};
+        prim.max = {x + hw, std::max(p1.y, p2.y) + cap};
+    } else return false;
+
+    return true;
+}
+
+
+//the paths stroked within a pixel width
+static bool _hairline(const SwStroke* stroke, const RenderShape* rshape, const Matrix& transform, SwHairline& line, RenderRegion& renderBox)
+{
+    if (fabsf(stroke->sx - stroke->sy) > FLOAT_EPSILON * stroke->sx) return false;
+    auto hw = rshape->strokeWidth() * 0.5f * stroke->sx;
+    if (hw > 0.5f) return false;
+
+    auto& path = rshape->path;
+    if (path.pts.empty()) return false;
+
+    //no dots of the zero length subpaths
+    Point min = {FLT_MAX, FLT_MAX}, max = {-FLT_MAX, -FLT_MAX};
+    Point start{}, cur{};
+    auto pt = path.pts.data;
+    auto lines = 0;
+
+    ARRAY_FOREACH(cmd, path.cmds) {
+        if (*cmd == PathCommand::MoveTo || *cmd == PathCommand::LineTo) {
+            auto p = *pt * transform;
+            if (*cmd == PathCommand::MoveTo) {
+                if (cmd > path.cmds.data && lines == 0) return false;
+                start = p;
+                lines = 0;
+            } else if (!_equal(p.x, cur.x) || !_equal(p.y, cur.y)) ++lines;
+            cur = p;
+            min = {std::min(min.x, p.x), std::min(min.y, p.y)};
+            max = {std::max(max.x, p.x), std::max(max.y, p.y)};
+            ++pt;
+        } else if (*cmd == PathCommand::CubicTo) {
+            Bezier bz = {cur, pt[0] * transform, pt[1] * transform, pt[2] * transform};
+            if (!_equal(bz.end.x, cur.x) || !_equal(bz.end.y, cur.y) || !_equal(bz.ctrl1.x, cur.x) || !_equal(bz.ctrl1.y, cur.y) || !_equal(bz.ctrl2.x, cur.x) || !_equal(bz.ctrl2.y, cur.y)) ++lines;
+            bz.bounds(min, max);
+            cur = bz.end;
+            pt += 3;
+        } else if (*cmd == PathCommand::Close) {
+            if (!_equal(start.x, cur.x) || !_equal(start.y, cur.y)) ++lines;
+            cur = start;
+        }
+    }
+    if (lines == 0) return false;
+
+    line.path = &path;
+    line.transform = &transform;
+    line.hw = hw;
+    line.miterlimit = rshape->stroke->miterlimit;
+    line.cap = stroke->cap;
+    line.join = stroke->join;
+
+    //the miters may reach out of the half width
+    auto ext = (line.join == StrokeJoin::Miter) ? hw * std::max(line.miterlimit, 1.0f) : hw;
+    renderBox.min = {int32_t(floorf(min.x - ext)), int32_t(floorf(min.y - ext))};
+    renderBox.max = {int32_t(ceilf(max.x + ext)), int32_t(ceilf(max.y + ext))};
+    return true;
+}
+
+
 static SwOutline* _genOutline(SwShape* shape, const RenderShape* rshape, const Matrix& transform, SwMpool* mpool, unsigned tid, bool hasComposite, bool trimmed = false)
 {
     PathCommand *cmds, *trimmedCmds = nullptr;
@@ -387,8 +699,32 @@ static SwOutline* _genOutline(SwShape* shape, const RenderShape* rshape, const M
     if (cmdCnt == 0 || ptsCnt == 0) return nullptr;
 
     auto outline = mpoolReqOutline(mpool, tid);
+    shapeGenOutline(outline, cmds, cmdCnt, pts, ptsCnt, transform);
+
+    outline->fillRule = rshape->rule;
+
+    tvg::free(trimmedCmds);
+    tvg::free(trimmedPts);
+
+    shape->fastTrack = (!hasComposite && _axisAlignedRect(outline));
+    return outline;
+}
+
+
+/************************************************************************/
+/* External Class Implementation                                        */
+/************************************************************************/
+
+void shapeGenOutline(SwOutline* outline, const PathCommand* cmds, uint32_t cmdCnt, const Point* pts, uint32_t ptsCnt, const Matrix& transform)
+{
     auto closed = false;
 
+    /* Transform the points at once into the tail of the reserved area. The outline grows from its head by
+       at most one point more than it takes per command, so it never overtakes the points not taken yet. */
+    outline->pts.reserve(outline->pts.count + ptsCnt + cmdCnt);
+    auto src = outline->pts.data + outline->pts.reserved - ptsCnt;
+    mathTransform(pts, src, ptsCnt, transform);
+
     //Generate Outlines
     while (cmdCnt-- > 0) {
         switch (*cmds) {
@@ -397,20 +733,20 @@ static SwOutline* _genOutline(SwShape* shape, const RenderShape* rshape, const M
                 break;
             }
             case PathCommand::MoveTo: {
-                closed = _outlineMoveTo(*outline, pts, transform, closed);
-                ++pts;
+                closed = _outlineMoveTo(*outline, *src, closed);
+                ++src;
                 break;
             }
             case PathCommand::LineTo: {
                 if (closed) closed = _outlineBegin(*outline);
-                _outlineLineTo(*outline, pts, transform);
-                ++pts;
+                _outlineLineTo(*outline, *src);
+                ++src;
                 break;
             }
             case PathCommand::CubicTo: {
                 if (closed) closed = _outlineBegin(*outline);
-                _outlineCubicTo(*outline, pts, pts + 1, pts + 2, transform);
-                pts += 3;
+                _outlineCubicTo(*outline, src);
+                src += 3;
                 break;
             }
         }
@@ -418,23 +754,31 @@ static SwOutline* _genOutline(SwShape* shape, const RenderShape* rshape, const M
     }
 
     if (!closed) _outlineEnd(*outline);
-
-    outline->fillRule = rshape->rule;
-
-    tvg::free(trimmedCmds);
-    tvg::free(trimmedPts);
-
-    shape->fastTrack = (!hasComposite && _axisAlignedRect(outline));
-    return outline;
 }
 
 
-/************************************************************************/
-/* External Class Implementation                                        */
-/************************************************************************/
-
-bool shapePrepare(SwShape* shape, const RenderShape* rshape, const Matrix& transform, const RenderRegion& clipBox, RenderRegion& renderBox, SwMpool* mpool, unsigned tid, bool hasComposite)
+bool shapePrepare(SwShape* shape, const RenderShape* rshape, const Matrix& transform, const RenderRegion& clipBox, RenderRegion& renderBox, float tolerance, SwMpool* mpool, unsigned tid, bool hasComposite)
 {
+    SwPoint min, max;
+    if (!rshape->trimpath() && _primitive(shape, rshape->path, transform, hasComposite, tolerance, min, max)) {
+        //see mathUpdateOutlineBBox()
+        if (shape->fastTrack) {
+            renderBox.min = {int32_t(round(min.x / 64.0f)), int32_t(round(min.y / 64.0f))};
+            renderBox.max = {int32_t(round(max.x / 64.0f)), int32_t(round(max.y / 64.0f))};
+        } else {
+            renderBox.min = {min.x >> 6, min.y >> 6};
+            renderBox.max = {(max.x + 63) >> 6, (max.y + 63) >> 6};
+        }
+        renderBox.intersect(clipBox);
+        if (!renderBox.valid()) return false;
+        //the analytic spans are limited to the span coordinates, the outline takes over beyond them (see tilesRender())
+        if (shape->fastTrack || (renderBox.max.x < USHRT_MAX && renderBox.max.y < USHRT_MAX)) {
+            shape->bbox = renderBox;
+            return true;
+        }
+        shape->primitive = false;
+    }
+
     if (auto out = _genOutline(shape, rshape, transform, mpool, tid, hasComposite, rshape->trimpath())) shape->outline = out;
     else return false;
     if (!mathUpdateOutlineBBox(shape->outline, clipBox, renderBox, shape->fastTrack)) return false;
@@ -450,13 +794,19 @@ bool shapePrepared(const SwShape* shape)
 }
 
 
-bool shapeGenRle(SwShape* shape, TVG_UNUSED const RenderShape* rshape, bool antiAlias)
+bool shapeGenRle(SwShape* shape, TVG_UNUSED const RenderShape* rshape, bool antiAlias, float tolerance, bool tiles, SwMpool* mpool, unsigned tid)
 {
     //Case A: Fast Track Rectangle Drawing
     if (shape->fastTrack) return true;
 
-    //Case B: Normal Shape RLE Drawing
-    if ((shape->rle = rleRender(shape->rle, shape->outline, shape->bbox, antiAlias))) return true;
+    //Case B: Primitive Shape Drawing
+    if (shape->primitive) return (shape->rle = rleRender(shape->rle, shape->prim, shape->bbox, antiAlias)) ? true : false;
+
+    //Case C: Coverage Tiles Drawing
+    if (tiles) return (shape->tiles = tilesRender(shape->tiles, shape->outline, shape->bbox, mpoolReqCellPool(mpool, tid), antiAlias, tolerance)) ? true : false;
+
+    //Case D: Normal Shape RLE Drawing
+    if ((shape->rle = rleRender(shape->rle, shape->outline, shape->bbox, mpoolReqCellPool(mpool, tid), antiAlias, tolerance))) return true;
 
     return false;
 }
@@ -472,7 +822,9 @@ void shapeDelOutline(SwShape* shape, SwMpool* mpool, uint32_t tid)
 void shapeReset(SwShape* shape)
 {
     rleReset(shape->rle);
+    tilesReset(shape->tiles);
     shape->fastTrack = false;
+    shape->primitive = false;
     shape->bbox.reset();
 }
 
@@ -481,6 +833,8 @@ void shapeFree(SwShape* shape)
 {
     rleFree(shape->rle);
     shape->rle = nullptr;
+    tilesFree(shape->tiles);
+    shape->tiles = nullptr;
 
     shapeDelFill(shape);
 
@@ -514,13 +868,33 @@ void shapeResetStroke(SwShape* shape, const RenderShape* rshape, const Matrix& t
 }
 
 
-bool shapeGenStrokeRle(SwShape* shape, const RenderShape* rshape, const Matrix& transform, const RenderRegion& clipBox, RenderRegion& renderBox, SwMpool* mpool, unsigned tid)
+bool shapeGenStrokeRle(SwShape* shape, const RenderShape* rshape, const Matrix& transform, const RenderRegion& clipBox, RenderRegion& renderBox, float tolerance, SwMpool* mpool, unsigned tid)
 {
     SwOutline* shapeOutline = nullptr;
     SwOutline* strokeOutline = nullptr;
     auto dashStroking = false;
     auto ret = true;
 
+    //Primitive: axis-aligned line
+    SwPrimitive prim;
+    if (rshape->stroke->dash.length <= DASH_PATTERN_THRESHOLD && !rshape->trimpath() && _primitive(shape->stroke, rshape, transform, tolerance, prim)) {
+        renderBox.min = {TO_SWCOORD(prim.min.x) >> 6, TO_SWCOORD(prim.min.y) >> 6};
+        renderBox.max = {(TO_SWCOORD(prim.max.x) + 63) >> 6, (TO_SWCOORD(prim.max.y) + 63) >> 6};
+        renderBox.intersect(clipBox);
+        if (!renderBox.valid()) return false;
+        shape->strokeRle = rleRender(shape->strokeRle, prim, renderBox, true);
+        return true;
+    }
+
+    //Hairline: thin polylines, no stroke outline
+    SwHairline line;
+    if (rshape->stroke->dash.length <= DASH_PATTERN_THRESHOLD && !rshape->trimpath() && _hairline(shape->stroke, rshape, transform, line, renderBox)) {
+        renderBox.intersect(clipBox);
+        if (!renderBox.valid()) return false;
+        shape->strokeRle = rleRender(shape->strokeRle, line, renderBox, mpoolReqCellPool(mpool, tid));
+        return shape->strokeRle != nullptr;
+    }
+
     //Dash style with/without trimming
     if (rshape->stroke->dash.length > DASH_PATTERN_THRESHOLD) {
         shapeOutline = _genDashOutline(rshape, transform, mpool, tid, rshape->trimpath());
@@ -529,12 +903,16 @@ bool shapeGenStrokeRle(SwShape* shape, const RenderShape* rshape, const Matrix&
     //Trimming & Normal style
     } else {
         if (!shape->outline) {
+            auto fastTrack = shape->fastTrack;  //keep the condition of the current fill
             if (auto out = _genOutline(shape, rshape, transform, mpool, tid, false, rshape->trimpath())) shape->outline = out;
             else return false;
+            shape->fastTrack = fastTrack;
         }
         shapeOutline = shape->outline;
     }
 
+    shape->stroke->borders = mpoolReqStrokeBorders(mpool, tid);
+
     if (!strokeParseOutline(shape->stroke, *shapeOutline)) {
         ret = false;
         goto clear;
@@ -547,11 +925,13 @@ bool shapeGenStrokeRle(SwShape* shape, const RenderShape* rshape, const Matrix&
         goto clear;
     }
 
-    shape->strokeRle = rleRender(shape->strokeRle, strokeOutline, renderBox, true);
+    shape->strokeRle = rleRender(shape->strokeRle, strokeOutline, renderBox, mpoolReqCellPool(mpool, tid), true, tolerance);
 
 clear:
     if (dashStroking) mpoolRetDashOutline(mpool, tid);
     mpoolRetStrokeOutline(mpool, tid);
+    mpoolRetStrokeBorders(mpool, tid);
+    shape->stroke->borders = nullptr;
 
     return ret;
 }
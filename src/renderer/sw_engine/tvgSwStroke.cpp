@@ -55,7 +55,6 @@ static void _growBorder(SwStrokeBorder* border, uint32_t newPts)
 
     while (maxCur < maxNew)
         maxCur += (maxCur >> 1) + 16;
-    //OPTIMIZE: use mempool!
     border->pts = tvg::realloc<SwPoint*>(border->pts, maxCur * sizeof(SwPoint));
     border->tags = tvg::realloc<uint8_t*>(border->tags, maxCur * sizeof(uint8_t));
     border->maxPts = maxCur;
@@ -803,12 +802,6 @@ void strokeFree(SwStroke* stroke)
 {
     if (!stroke) return;
 
-    //free borders
-    if (stroke->borders[0].pts) tvg::free(stroke->borders[0].pts);
-    if (stroke->borders[0].tags) tvg::free(stroke->borders[0].tags);
-    if (stroke->borders[1].pts) tvg::free(stroke->borders[1].pts);
-    if (stroke->borders[1].tags) tvg::free(stroke->borders[1].tags);
-
     fillFree(stroke->fill);
     stroke->fill = nullptr;
 
@@ -826,11 +819,6 @@ void strokeReset(SwStroke* stroke, const RenderShape* rshape, const Matrix& tran
 
     //Save line join: it can be temporarily changed when stroking curves...
     stroke->joinSaved = stroke->join = rshape->strokeJoin();
-
-    stroke->borders[0].ptsCnt = 0;
-    stroke->borders[0].start = -1;
-    stroke->borders[1].ptsCnt = 0;
-    stroke->borders[1].start = -1;
 }
 
 
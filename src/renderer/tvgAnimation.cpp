@@ -20,9 +20,114 @@
  * SOFTWARE.
  */
 
+#include <cstring>
+#include "tvgMath.h"
 #include "tvgFrameModule.h"
 #include "tvgAnimation.h"
 
+/************************************************************************/
+/* Internal Class Implementation                                        */
+/************************************************************************/
+
+#define BAKE_KEY_INTERVAL 16         //a frame out of these is coded by itself, so seeking decodes this many frames at most
+#define BAKE_RUN 0x80000000          //the run header flag, the count of the repeated word follows otherwise the literal words
+#define BAKE_MIN_RUN 3
+
+AnimationBake::AnimationBake(uint32_t w, uint32_t h)
+{
+    surface.buf32 = tvg::calloc<uint32_t*>(w * h, sizeof(uint32_t));
+    surface.stride = surface.w = w;
+    surface.h = h;
+    surface.cs = ColorSpace::ARGB8888;
+    surface.channelSize = sizeof(uint32_t);
+    surface.premultiplied = true;
+    offsets.push(0);
+}
+
+
+AnimationBake::~AnimationBake()
+{
+    tvg::free(surface.buf32);
+}
+
+
+void AnimationBake::encode(const uint32_t* frame, const uint32_t* prev)
+{
+    auto cnt = surface.w * surface.h;
+    auto diff = [&](uint32_t k) { return prev ? frame[k] ^ prev[k] : frame[k]; };
+
+    uint32_t k = 0;
+    while (k < cnt) {
+        //the same words, mostly the unchanged pixels
+        auto v = diff(k);
+        uint32_t n = 1;
+        while (k + n < cnt && n < ~BAKE_RUN && diff(k + n) == v) ++n;
+        if (n >= BAKE_MIN_RUN) {
+            stream.push(BAKE_RUN | n);
+            stream.push(v);
+            k += n;
+            continue;
+        }
+        //the literal words up to the next run
+        auto head = stream.count;
+        stream.push(0);
+        while (k < cnt) {
+            v = diff(k);
+            if (k + 2 < cnt && diff(k + 1) == v && diff(k + 2) == v) break;
+            stream.push(v);
+            ++k;
+        }
+        stream[head] = stream.count - head - 1;
+    }
+    offsets.push(stream.count);
+}
+
+
+void AnimationBake::apply(uint32_t idx)
+{
+    auto p = stream.data + offsets[idx];
+    auto end = stream.data + offsets[idx + 1];
+    auto dst = surface.buf32;
+
+    while (p < end) {
+        auto head = *p++;
+        auto n = head & ~BAKE_RUN;
+        if (head & BAKE_RUN) {
+            if (auto v = *p++) {
+                for (uint32_t k = 0; k < n; ++k) dst[k] ^= v;
+            }
+        } else {
+            for (uint32_t k = 0; k < n; ++k) dst[k] ^= p[k];
+            p += n;
+        }
+        dst += n;
+    }
+}
+
+
+bool AnimationBake::show(float no)
+{
+    this->no = no;
+
+    auto idx = int32_t(nearbyintf(no));
+    idx = tvg::clamp(idx, 0, int32_t(count()) - 1);
+    if (idx == shown) return false;
+
+    //the differences are stacked from the key frame, which is coded against the cleared one
+    auto key = idx - idx % BAKE_KEY_INTERVAL;
+    if (shown < key || shown > idx) {
+        memset(surface.buf32, 0, sizeof(uint32_t) * surface.stride * surface.h);
+        shown = key - 1;
+    }
+    while (shown < idx) apply(++shown);
+
+    return true;
+}
+
+/************************************************************************/
+/* External Class Implementation                                        */
+/************************************************************************/
+
 
 Animation::~Animation()
 {
@@ -42,8 +147,15 @@ Result Animation::frame(float no) noexcept
     if (!loader) return Result::InsufficientCondition;
     if (!loader->animatable()) return Result::NonSupport;
 
+    if (auto bake = pImpl->bake) {
+        if (fabsf(bake->no - no) <= 0.0009f) return Result::InsufficientCondition;
+        if (bake->show(no)) PICTURE(pImpl->picture)->rebaked();
+        return Result::Success;
+    }
+
     if (static_cast<FrameModule*>(loader)->frame(no)) {
-        PAINT(pImpl->picture)->mark(RenderUpdateFlag::All);
+        //the frame marks its changed paints by itself, see PictureImpl::update()
+        PAINT(pImpl->picture)->mark(RenderUpdateFlag::Image);
         return Result::Success;
     }
     return Result::InsufficientCondition;
@@ -62,6 +174,7 @@ float Animation::curFrame() const noexcept
 
     if (!loader) return 0;
     if (!loader->animatable()) return 0;
+    if (pImpl->bake) return pImpl->bake->no;
 
     return static_cast<FrameModule*>(loader)->curFrame();
 }
@@ -95,6 +208,9 @@ Result Animation::segment(float begin, float end) noexcept
     if (!loader) return Result::InsufficientCondition;
     if (!loader->animatable()) return Result::NonSupport;
 
+    //the baked frames belong to the former segment
+    pImpl->unbake();
+
     return static_cast<FrameModule*>(loader)->segment(begin, end);
 }
 
@@ -112,6 +228,68 @@ Result Animation::segment(float *begin, float *end) noexcept
 }
 
 
+Result Animation::bake(uint32_t w, uint32_t h) noexcept
+{
+    auto loader = PICTURE(pImpl->picture)->loader;
+    if (!loader) return Result::InsufficientCondition;
+    if (!loader->animatable()) return Result::NonSupport;
+
+    pImpl->unbake();
+    if (w == 0 && h == 0) return Result::Success;
+    if (w == 0 || h == 0) return Result::InvalidArguments;
+
+    //another instance of the same file draws the frames, so the picture is left as it is
+    auto module = static_cast<FrameModule*>(loader);
+    auto origin = module->origin();
+    if (!origin) return Result::NonSupport;
+
+    auto canvas = SwCanvas::gen();
+    if (!canvas) return Result::NonSupport;
+
+    auto twin = Animation::gen();
+    if (twin->picture()->load(origin) != Result::Success) {
+        delete(twin);
+        delete(canvas);
+        return Result::NonSupport;
+    }
+
+    float begin, end;
+    module->segment(&begin, &end);
+    twin->segment(begin, end);
+    twin->picture()->size(float(w), float(h));
+
+    MemoryScope scope(MemoryCategory::Loader);
+
+    auto bake = new AnimationBake(w, h);
+    auto buffer = tvg::malloc<uint32_t*>(sizeof(uint32_t) * w * h);
+    auto prev = tvg::malloc<uint32_t*>(sizeof(uint32_t) * w * h);
+
+    canvas->target(buffer, w, w, h, ColorSpace::ARGB8888);
+    canvas->push(twin->picture());
+
+    auto cnt = uint32_t(module->totalFrame()) + 1;
+    for (uint32_t i = 0; i < cnt; ++i) {
+        twin->frame(float(i));
+        canvas->update();
+        canvas->draw(true);
+        canvas->sync();
+        bake->encode(buffer, (i % BAKE_KEY_INTERVAL) ? prev : nullptr);
+        memcpy(prev, buffer, sizeof(uint32_t) * w * h);
+    }
+
+    delete(canvas);
+    delete(twin);
+    tvg::free(buffer);
+    tvg::free(prev);
+
+    bake->show(module->curFrame());
+    pImpl->bake = bake;
+    PICTURE(pImpl->picture)->bake(&bake->surface);
+
+    return Result::Success;
+}
+
+
 Animation* Animation::gen() noexcept
 {
     return new Animation;
@@ -26,9 +26,31 @@
 #include "tvgCommon.h"
 #include "tvgPicture.h"
 
+//the frames rasterized in advance, each one is kept as the run-length coded difference to the former frame
+struct AnimationBake
+{
+    RenderSurface surface;           //the decoded frame the picture shows
+    Array<uint32_t> stream;          //the coded frames in a row
+    Array<uint32_t> offsets;         //the beginning of each frame in the stream, followed by the end of the last one
+    float no = 0.0f;                 //the current frame number
+    int32_t shown = -1;              //the frame decoded in the surface
+
+    AnimationBake(uint32_t w, uint32_t h);
+    ~AnimationBake();
+
+    uint32_t count() const { return offsets.count - 1; }
+    void encode(const uint32_t* frame, const uint32_t* prev);
+    bool show(float no);
+
+private:
+    void apply(uint32_t idx);
+};
+
+
 struct Animation::Impl
 {
     Picture* picture = nullptr;
+    AnimationBake* bake = nullptr;
 
     Impl()
     {
@@ -38,8 +60,19 @@ struct Animation::Impl
 
     ~Impl()
     {
+        unbake(false);
         picture->unref();
     }
+
+    void unbake(bool restore = true)
+    {
+        if (!bake) return;
+        PICTURE(picture)->bake(nullptr);
+        //the vector continues from the last baked frame
+        if (restore) static_cast<FrameModule*>(PICTURE(picture)->loader)->frame(bake->no);
+        delete(bake);
+        bake = nullptr;
+    }
 };
 
 #endif //_TVG_ANIMATION_H_
@@ -22,6 +22,19 @@
 
 #include "tvgCanvas.h"
 
+void CanvasDrawTask::run(TVG_UNUSED unsigned tid)
+{
+    auto impl = canvas->pImpl;
+
+    result = Result::Success;
+    if (clear && !impl->renderer->clear()) result = Result::InsufficientCondition;
+    if (result == Result::Success) result = impl->render();
+
+    if (callback) callback(canvas, result, data);
+    finished.store(true, memory_order_release);
+}
+
+
 Canvas::Canvas():pImpl(new Impl)
 {
 }
@@ -55,6 +68,19 @@ Result Canvas::draw(bool clear) noexcept
 }
 
 
+Result Canvas::submit(bool clear, void (*done)(Canvas* canvas, Result result, void* data), void* data) noexcept
+{
+    TVGLOG("RENDERER", "Submit. -------------------------------- Canvas(%p)", this);
+    return pImpl->submit(this, clear, done, data);
+}
+
+
+Result Canvas::ready() const noexcept
+{
+    return pImpl->ready();
+}
+
+
 Result Canvas::update() noexcept
 {
     TVGLOG("RENDERER", "Update S. ------------------------------ Canvas(%p)", this);
@@ -78,7 +104,33 @@ Result Canvas::viewport(int32_t x, int32_t y, int32_t w, int32_t h) noexcept
 }
 
 
+Result Canvas::flatness(float tolerance) noexcept
+{
+    return pImpl->flatness(tolerance);
+}
+
+
 Result Canvas::sync() noexcept
 {
     return pImpl->sync();
-}
\ No newline at end of file
+}
+
+
+Result Canvas::damages(const int32_t** regions, uint32_t* cnt) const noexcept
+{
+    if (!regions || !cnt) return Result::InvalidArguments;
+    return pImpl->damages(regions, cnt);
+}
+
+
+Result Canvas::profiling(bool on) noexcept
+{
+    return pImpl->profiling(on);
+}
+
+
+Result Canvas::profile(Profile* profile) const noexcept
+{
+    if (!profile) return Result::InvalidArguments;
+    return pImpl->report(profile);
+}
@@ -24,15 +24,36 @@
 #define _TVG_CANVAS_H_
 
 #include "tvgPaint.h"
+#include "tvgTaskScheduler.h"
+#include "tvgTrace.h"
 
 enum Status : uint8_t {Synced = 0, Updating, Drawing, Damaged};
 
+using DrawCallback = void (*)(Canvas* canvas, Result result, void* data);
+
+//the drawing submitted to a worker thread
+struct CanvasDrawTask : Task
+{
+    Canvas* canvas;
+    DrawCallback callback = nullptr;
+    void* data = nullptr;
+    bool clear = false;
+    Result result = Result::Success;
+    atomic<bool> finished{true};
+
+    void run(unsigned tid) override;
+};
+
 struct Canvas::Impl
 {
     Scene* scene;
     RenderMethod* renderer;
     RenderRegion vport = {{0, 0}, {INT32_MAX, INT32_MAX}};
+    RenderRegion whole;  //damage of the engines without the partial rendering
+    RenderProfile* profile = nullptr;  //valid while the profiling is on
+    CanvasDrawTask* detached = nullptr;  //the last submitted drawing
     Status status = Status::Synced;
+    bool inplace = false;  //the tasks run on the calling thread, see SwCanvas::gen(bool)
 
     Impl() : scene(Scene::gen())
     {
@@ -42,10 +63,20 @@ struct Canvas::Impl
     ~Impl()
     {
         //make it sure any deferred jobs
+        if (detached) detached->done();
         renderer->sync();
 
         scene->unref();
+        if (renderer->profile == profile) renderer->profile = nullptr;
         if (renderer->unref() == 0) delete(renderer);
+        delete(profile);
+        delete(detached);
+    }
+
+    //a new frame begins with the first update or draw after the sync
+    void frame()
+    {
+        if (profile && (status == Status::Synced || status == Status::Damaged)) profile->reset();
     }
 
     Result push(Paint* target, Paint* at)
@@ -67,15 +98,23 @@ struct Canvas::Impl
 
     Result update(Paint* paint, bool force)
     {
-        Array<RenderData> clips;
+        SmallArray<RenderData, 8> clips;
         auto flag = RenderUpdateFlag::None;
         if (status == Status::Damaged || force) flag = RenderUpdateFlag::All;
 
+        TaskInlining inlining(inplace);
+
         if (!renderer->preUpdate()) return Result::InsufficientCondition;
 
-        auto m = tvg::identity();
-        if (paint) PAINT(paint)->update(renderer, m, clips, 255, flag);
-        else PAINT(scene)->update(renderer, m, clips, 255, flag);
+        frame();
+
+        {
+            TVG_TRACE("Canvas::update");
+            RenderProfileScope scope(profile, RenderProfile::Update);
+            auto m = tvg::identity();
+            if (paint) PAINT(paint)->update(renderer, m, clips, 255, flag);
+            else PAINT(scene)->update(renderer, m, clips, 255, flag);
+        }
 
         if (!renderer->postUpdate()) return Result::InsufficientCondition;
 
@@ -89,27 +128,148 @@ struct Canvas::Impl
         if (clear && !renderer->clear()) return Result::InsufficientCondition;
         if (scene->paints().empty()) return Result::InsufficientCondition;
         if (status == Status::Damaged) update(nullptr, false);
-        if (!renderer->preRender()) return Result::InsufficientCondition;
 
-        if (!PAINT(scene)->render(renderer) || !renderer->postRender()) return Result::InsufficientCondition;
+        frame();
+
+        auto ret = render();
+        if (ret == Result::Success) status = Status::Drawing;
+
+        return ret;
+    }
+
+    Result render()
+    {
+        TaskInlining inlining(inplace);
+
+        do {
+            {
+                TVG_TRACE("Canvas::preRender");
+                RenderProfileScope scope(profile, RenderProfile::PreRender);
+                if (!renderer->preRender()) return Result::InsufficientCondition;
+            }
+
+            {
+                TVG_TRACE("Canvas::render");
+                if (!PAINT(scene)->render(renderer) || !renderer->postRender()) return Result::InsufficientCondition;
+            }
+        } while (renderer->next());
+
+        return Result::Success;
+    }
+
+    Result submit(Canvas* canvas, bool clear, DrawCallback done, void* data)
+    {
+        if (status == Status::Drawing) return Result::InsufficientCondition;
+        if (!renderer->mainSurface() || scene->paints().empty()) return Result::InsufficientCondition;
+        if (status == Status::Damaged) update(nullptr, false);
+
+        //the worker thread takes over the drawing once the preparations are done
+        if (!renderer->detach()) return Result::NonSupport;
+
+        frame();
+
+        if (!detached) detached = new CanvasDrawTask;
+        detached->canvas = canvas;
+        detached->callback = done;
+        detached->data = data;
+        detached->clear = clear;
+        detached->finished.store(false, memory_order_relaxed);
 
         status = Status::Drawing;
+        TaskScheduler::request(detached);
 
         return Result::Success;
     }
 
+    Result ready() const
+    {
+        if (detached && !detached->finished.load(memory_order_acquire)) return Result::InsufficientCondition;
+        return Result::Success;
+    }
+
     Result sync()
     {
         if (status == Status::Synced || status == Status::Damaged) return Result::InsufficientCondition;
 
+        TVG_TRACE("Canvas::sync");
+        RenderProfileScope scope(profile, RenderProfile::Sync);
+
+        auto ret = Result::Success;
+        if (detached) {
+            detached->done();
+            ret = detached->result;
+            detached->result = Result::Success;
+        }
+
         if (renderer->sync()) {
             status = Status::Synced;
-            return Result::Success;
+            return ret;
         }
 
         return Result::Unknown;
     }
 
+    Result damages(const int32_t** regions, uint32_t* cnt)
+    {
+        static_assert(sizeof(RenderRegion) == sizeof(int32_t) * 4, "RenderRegion must be laid out as four coordinates");
+
+        if (status != Status::Synced) return Result::InsufficientCondition;
+
+        const RenderRegion* list;
+        if (!renderer->damages(&list, cnt)) {
+            whole = vport;
+            auto surface = renderer->mainSurface();
+            if (surface) whole.intersect({{0, 0}, {(int32_t)surface->w, (int32_t)surface->h}});
+            list = &whole;
+            *cnt = 1;
+        }
+        *regions = reinterpret_cast<const int32_t*>(list);
+        return Result::Success;
+    }
+
+    Result profiling(bool on)
+    {
+        if (status == Status::Drawing) return Result::InsufficientCondition;
+
+        if (on) {
+            if (!profile) profile = new RenderProfile;
+            //the canvases sharing the renderer may profile one by one
+            renderer->profile = profile;
+        } else if (profile) {
+            if (renderer->profile == profile) renderer->profile = nullptr;
+            delete(profile);
+            profile = nullptr;
+        }
+        return Result::Success;
+    }
+
+    Result report(Canvas::Profile* out) const
+    {
+        if (!profile || status != Status::Synced) return Result::InsufficientCondition;
+
+        auto ms = [&](RenderProfile::Phase phase) {
+            return float(profile->times[phase].load(memory_order_relaxed)) * 1e-6f;
+        };
+        auto cnt = [&](RenderProfile::Counter counter) {
+            return profile->counters[counter].load(memory_order_relaxed);
+        };
+
+        out->update = ms(RenderProfile::Update);
+        out->prepare = ms(RenderProfile::Prepare);
+        out->preRender = ms(RenderProfile::PreRender);
+        out->raster = ms(RenderProfile::Raster);
+        out->composite = ms(RenderProfile::Composite);
+        out->effect = ms(RenderProfile::Effect);
+        out->sync = ms(RenderProfile::Sync);
+        out->gpu = ms(RenderProfile::Gpu);
+        out->shapes = cnt(RenderProfile::Shapes);
+        out->spans = cnt(RenderProfile::Spans);
+        out->surfaces = cnt(RenderProfile::Surfaces);
+        out->cacheHits = cnt(RenderProfile::CacheHits);
+
+        return Result::Success;
+    }
+
     Result viewport(int32_t x, int32_t y, int32_t w, int32_t h)
     {
         if (status != Status::Damaged && status != Status::Synced) return Result::InsufficientCondition;
@@ -126,6 +286,17 @@ struct Canvas::Impl
         status = Status::Damaged;
         return Result::Success;
     }
+
+    Result flatness(float tolerance)
+    {
+        if (!(tolerance > 0.0f) || std::isinf(tolerance)) return Result::InvalidArguments;
+        if (status != Status::Damaged && status != Status::Synced) return Result::InsufficientCondition;
+
+        if (renderer->tolerance == tolerance) return Result::Success;
+        renderer->tolerance = tolerance;
+        status = Status::Damaged;
+        return Result::Success;
+    }
 };
 
 #endif /* _TVG_CANVAS_H_ */
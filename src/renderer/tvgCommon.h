@@ -90,29 +90,76 @@ namespace tvg {
     #define TVG_DELETE(PAINT) \
     if (PAINT->refCnt() == 0) delete(PAINT)
 
+    //the user allocator given by Initializer::init(), nullptr for the system one
+    extern Allocator* userAllocator;
+
+#ifdef THORVG_MEMORY_STATS_SUPPORT
+    //allocations with a header recording their sizes and categories
+    void* memAlloc(size_t size, bool zero);
+    void* memRealloc(void* ptr, size_t size);
+    void memFree(void* ptr);
+
+    //accounts the allocations of the current thread to the category while alive
+    struct MemoryScope
+    {
+        MemoryCategory prv;
+        MemoryScope(MemoryCategory category);
+        ~MemoryScope();
+    };
+#else
+    struct MemoryScope
+    {
+        MemoryScope(TVG_UNUSED MemoryCategory category) {}
+    };
+#endif
+
     //custom memory allocators
     template<typename T = void*>
     static inline T malloc(size_t size)
     {
+#ifdef THORVG_MEMORY_STATS_SUPPORT
+        return static_cast<T>(memAlloc(size, false));
+#else
+        if (userAllocator) return static_cast<T>(userAllocator->alloc(size, userAllocator->data));
         return static_cast<T>(std::malloc(size));
+#endif
     }
 
     template<typename T = void*>
     static inline T calloc(size_t nmem, size_t size)
     {
+#ifdef THORVG_MEMORY_STATS_SUPPORT
+        return static_cast<T>(memAlloc(nmem * size, true));
+#else
+        if (userAllocator) {
+            auto ptr = userAllocator->alloc(nmem * size, userAllocator->data);
+            if (ptr) memset(ptr, 0, nmem * size);
+            return static_cast<T>(ptr);
+        }
         return static_cast<T>(std::calloc(nmem, size));
+#endif
     }
 
     template<typename T = void*>
     static inline T realloc(void* ptr, size_t size)
     {
+#ifdef THORVG_MEMORY_STATS_SUPPORT
+        return static_cast<T>(memRealloc(ptr, size));
+#else
+        if (userAllocator) return static_cast<T>(userAllocator->realloc(ptr, size, userAllocator->data));
         return static_cast<T>(std::realloc(ptr, size));
+#endif
     }
 
     template<typename T = void*>
     static inline void free(void* ptr)
     {
-        std::free(ptr);
+#ifdef THORVG_MEMORY_STATS_SUPPORT
+        memFree(ptr);
+#else
+        if (userAllocator) userAllocator->free(ptr, userAllocator->data);
+        else std::free(ptr);
+#endif
     }
 
     extern int engineInit;
@@ -23,6 +23,7 @@
 #ifndef _TVG_FRAME_MODULE_H_
 #define _TVG_FRAME_MODULE_H_
 
+#include <chrono>
 #include "tvgLoadModule.h"
 
 namespace tvg
@@ -33,6 +34,8 @@ class FrameModule: public ImageLoader
 public:
     float segmentBegin = 0.0f;
     float segmentEnd;             //Initialize the value with the total frame number
+    uint64_t elapsed = 0;         //nanoseconds of updating and drawing the frames, accumulated while timing
+    bool timing = false;          //measure the elapsed time for the adaptive playback
 
     FrameModule(FileType type) : ImageLoader(type) {}
     virtual ~FrameModule() {}
@@ -42,6 +45,7 @@ public:
     virtual float curFrame() = 0;           //return the current frame number
     virtual float duration() = 0;           //return the animation duration in seconds
     virtual Result segment(float begin, float end) = 0;
+    virtual const char* origin() { return nullptr; }  //the file which another instance loads as the same animation, if any
 
     void segment(float* begin, float* end)
     {
@@ -52,6 +56,27 @@ public:
     virtual bool animatable() override { return true; }
 };
 
+
+//accumulates the scope duration to the elapsed time, nothing without the timing
+struct FrameTimingScope
+{
+    FrameModule* module = nullptr;
+    std::chrono::steady_clock::time_point begin;
+
+    FrameTimingScope(ImageLoader* loader)
+    {
+        if (!loader || !loader->animatable() || !static_cast<FrameModule*>(loader)->timing) return;
+        module = static_cast<FrameModule*>(loader);
+        begin = std::chrono::steady_clock::now();
+    }
+
+    ~FrameTimingScope()
+    {
+        if (!module) return;
+        module->elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+    }
+};
+
 }
 
 #endif //_TVG_FRAME_MODULE_H_
@@ -20,9 +20,11 @@
  * SOFTWARE.
  */
 
+#include <atomic>
 #include "tvgCommon.h"
 #include "tvgTaskScheduler.h"
 #include "tvgLoader.h"
+#include "tvgTrace.h"
 
 #ifdef THORVG_SW_RASTER_SUPPORT
     #include "tvgSwRenderer.h"
@@ -43,9 +45,101 @@
 
 namespace tvg {
     int engineInit = 0;
+    Allocator* userAllocator = nullptr;
 }
 
 static uint16_t _version = 0;
+static Allocator _allocator;
+
+
+#ifdef THORVG_MEMORY_STATS_SUPPORT
+
+static constexpr size_t MEM_HEADER_SIZE = 16;   //keeps the blocks aligned for any type
+
+struct MemHeader
+{
+    size_t size;
+    MemoryCategory category;
+};
+
+static atomic<size_t> _usage[int(MemoryCategory::Compositor) + 1];
+static thread_local MemoryCategory _category = MemoryCategory::Common;
+
+
+static void _account(MemoryCategory category, size_t size, bool add)
+{
+    if (add) _usage[int(category)].fetch_add(size, memory_order_relaxed);
+    else _usage[int(category)].fetch_sub(size, memory_order_relaxed);
+}
+
+
+void* tvg::memAlloc(size_t size, bool zero)
+{
+    auto block = static_cast<uint8_t*>(userAllocator ? userAllocator->alloc(size + MEM_HEADER_SIZE, userAllocator->data) : std::malloc(size + MEM_HEADER_SIZE));
+    if (!block) return nullptr;
+
+    auto header = reinterpret_cast<MemHeader*>(block);
+    header->size = size;
+    header->category = _category;
+    _account(header->category, size, true);
+
+    if (zero) memset(block + MEM_HEADER_SIZE, 0, size);
+    return block + MEM_HEADER_SIZE;
+}
+
+
+void* tvg::memRealloc(void* ptr, size_t size)
+{
+    if (!ptr) return memAlloc(size, false);
+
+    auto block = static_cast<uint8_t*>(ptr) - MEM_HEADER_SIZE;
+    auto prv = *reinterpret_cast<MemHeader*>(block);
+
+    block = static_cast<uint8_t*>(userAllocator ? userAllocator->realloc(block, size + MEM_HEADER_SIZE, userAllocator->data) : std::realloc(block, size + MEM_HEADER_SIZE));
+    if (!block) return nullptr;
+
+    //the block stays in its original category
+    reinterpret_cast<MemHeader*>(block)->size = size;
+    _account(prv.category, prv.size, false);
+    _account(prv.category, size, true);
+
+    return block + MEM_HEADER_SIZE;
+}
+
+
+void tvg::memFree(void* ptr)
+{
+    if (!ptr) return;
+
+    auto block = static_cast<uint8_t*>(ptr) - MEM_HEADER_SIZE;
+    auto header = reinterpret_cast<MemHeader*>(block);
+    _account(header->category, header->size, false);
+
+    if (userAllocator) userAllocator->free(block, userAllocator->data);
+    else std::free(block);
+}
+
+
+MemoryScope::MemoryScope(MemoryCategory category) : prv(_category)
+{
+    _category = category;
+}
+
+
+MemoryScope::~MemoryScope()
+{
+    _category = prv;
+}
+
+#endif //THORVG_MEMORY_STATS_SUPPORT
+
+
+static bool _installed(const Allocator* allocator)
+{
+    if (!allocator) return !userAllocator;
+    if (!userAllocator) return false;
+    return userAllocator->alloc == allocator->alloc && userAllocator->realloc == allocator->realloc && userAllocator->free == allocator->free && userAllocator->data == allocator->data;
+}
 
 
 static bool _buildVersionInfo(uint32_t* major, uint32_t* minor, uint32_t* micro)
@@ -80,7 +174,7 @@ static bool _buildVersionInfo(uint32_t* major, uint32_t* minor, uint32_t* micro)
 /* External Class Implementation                                        */
 /************************************************************************/
 
-Result Initializer::init(uint32_t threads) noexcept
+static Result _init(uint32_t threads, const ThreadOptions* options, const Executor* executor = nullptr)
 {
     if (engineInit++ > 0) return Result::Success;
 
@@ -88,12 +182,53 @@ Result Initializer::init(uint32_t threads) noexcept
 
     if (!LoaderMgr::init()) return Result::Unknown;
 
-    TaskScheduler::init(threads);
+    #ifdef THORVG_TRACE_SUPPORT
+        Trace::init();
+    #endif
+
+    if (executor) TaskScheduler::init(*executor);
+    else TaskScheduler::init(threads, options);
 
     return Result::Success;
 }
 
 
+Result Initializer::init(uint32_t threads) noexcept
+{
+    return _init(threads, nullptr);
+}
+
+
+Result Initializer::init(uint32_t threads, const ThreadOptions& options) noexcept
+{
+    return _init(threads, &options);
+}
+
+
+Result Initializer::init(const Executor& executor) noexcept
+{
+    if (!executor.submit || executor.threads == 0 || executor.threads > 63) return Result::InvalidArguments;
+    return _init(executor.threads, nullptr, &executor);
+}
+
+
+Result Initializer::init(uint32_t threads, const Allocator* allocator) noexcept
+{
+    if (engineInit > 0) {
+        if (!_installed(allocator)) return Result::InsufficientCondition;
+        return init(threads);
+    }
+
+    if (allocator) {
+        if (!allocator->alloc || !allocator->realloc || !allocator->free) return Result::InvalidArguments;
+        _allocator = *allocator;
+        userAllocator = &_allocator;
+    } else userAllocator = nullptr;
+
+    return init(threads);
+}
+
+
 Result Initializer::term() noexcept
 {
     if (engineInit == 0) return Result::InsufficientCondition;
@@ -114,12 +249,61 @@ Result Initializer::term() noexcept
 
     TaskScheduler::term();
 
+    #ifdef THORVG_TRACE_SUPPORT
+        Trace::term();
+    #endif
+
     if (!LoaderMgr::term()) return Result::Unknown;
 
     return Result::Success;
 }
 
 
+Result Initializer::cache(uint32_t budget) noexcept
+{
+    LoaderMgr::retain(budget);
+    return Result::Success;
+}
+
+
+Result Initializer::trim(TrimLevel level) noexcept
+{
+    if (engineInit == 0) return Result::InsufficientCondition;
+
+    auto caches = (level == TrimLevel::Caches);
+
+    #ifdef THORVG_SW_RASTER_SUPPORT
+        SwRenderer::trim(caches);
+    #endif
+
+    #ifdef THORVG_GL_RASTER_SUPPORT
+        GlRenderer::trim(caches);
+    #endif
+
+    #ifdef THORVG_WG_RASTER_SUPPORT
+        WgRenderer::trim(caches);
+    #endif
+
+    if (caches) LoaderMgr::trim();
+
+    return Result::Success;
+}
+
+
+Result Initializer::memory(TVG_UNUSED MemoryCategory category, size_t* bytes) noexcept
+{
+    if (!bytes) return Result::InvalidArguments;
+
+#ifdef THORVG_MEMORY_STATS_SUPPORT
+    *bytes = _usage[int(category)].load(memory_order_relaxed);
+    return Result::Success;
+#else
+    *bytes = 0;
+    return Result::NonSupport;
+#endif
+}
+
+
 const char* Initializer::version(uint32_t* major, uint32_t* minor, uint32_t* micro) noexcept
 {
     if ((!major && ! minor && !micro) || _buildVersionInfo(major, minor, micro)) return THORVG_VERSION_STRING;
@@ -27,6 +27,7 @@
 #include "tvgCommon.h"
 #include "tvgRender.h"
 #include "tvgInlist.h"
+#include "tvgTaskScheduler.h"
 
 
 struct LoadModule
@@ -37,6 +38,10 @@ struct LoadModule
     uintptr_t hashkey = 0;
     char* hashpath = nullptr;
 
+    //the bucket chains of the cache indices, see LoaderMgr
+    LoadModule* chain[2] = {};
+    uint32_t digest[2] = {};
+
     FileType type;                                  //current loader file type
     atomic<uint16_t> sharing{};                     //reference count
     bool readied = false;                           //read done already.
@@ -87,9 +92,51 @@ struct ImageLoader : LoadModule
 
     float w = 0, h = 0;                             //default image size
     RenderSurface surface;
+    uint8_t reduction = 0;                          //the power of two downscale of the decoded surface (0 ~ 3)
+    Task* task = nullptr;                           //the decoding task requested by read()
+    bool prefetching = false;                       //decode in the background with the lowest priority
+    bool deferrable = false;                        //the header gives the size, the body could be read on the first use
 
     ImageLoader(FileType type) : LoadModule(type) {}
 
+    void request(Task* task)
+    {
+        this->task = task;
+        if (prefetching) TaskScheduler::prefetch(task);
+        else TaskScheduler::request(task);
+    }
+
+    void promote()
+    {
+        if (task) TaskScheduler::promote(task);
+    }
+
+    //read and nothing left to wait for
+    bool completed() const
+    {
+        return readied && !(task && task->busy());
+    }
+
+    //drop the decoding not started yet, it's requested again by the next read()
+    bool cancel()
+    {
+        if (!task || !TaskScheduler::cancel(task)) return false;
+        readied = false;
+        return true;
+    }
+
+    //the drawing size before reading, the raster image could be decoded in a reduced resolution still covering it
+    void hint(float w, float h)
+    {
+        if (type != FileType::Png && type != FileType::Jpg && type != FileType::Webp) return;
+        if (readied || sharing > 0 || w <= 0.0f || h <= 0.0f || this->w <= 0.0f || this->h <= 0.0f) return;
+        auto sx = w / this->w;
+        auto sy = h / this->h;
+        auto scale = sx < sy ? sx : sy;
+        reduction = 0;
+        while (reduction < 3 && scale * float(2 << reduction) <= 1.0f) ++reduction;
+    }
+
     virtual bool animatable() { return false; }  //true if this loader supports animation.
     virtual Paint* paint() { return nullptr; }
 
@@ -23,6 +23,7 @@
 #include <atomic>
 #include "tvgInlist.h"
 #include "tvgStr.h"
+#include "tvgCompressor.h"
 #include "tvgLoader.h"
 #include "tvgLock.h"
 
@@ -65,8 +66,118 @@ uintptr_t HASH_KEY(const char* data)
 //TODO: remove it.
 atomic<ColorSpace> ImageLoader::cs{ColorSpace::ARGB8888};
 
-static Key _key;
+//the hash index of the cached loaders, chained through the loaders in the given slot
+struct LoaderIndex
+{
+    LoadModule** buckets = nullptr;
+    uint32_t capacity = 0;      //power of 2
+    uint32_t count = 0;
+    uint8_t slot;
+
+    LoaderIndex(uint8_t slot) : slot(slot) {}
+
+    LoadModule* first(uint32_t hash) const
+    {
+        return capacity ? buckets[hash & (capacity - 1)] : nullptr;
+    }
+
+    void insert(LoadModule* loader, uint32_t hash)
+    {
+        if ((count + 1) * 2 > capacity) grow();
+        auto& head = buckets[hash & (capacity - 1)];
+        loader->digest[slot] = hash;
+        loader->chain[slot] = head;
+        head = loader;
+        ++count;
+    }
+
+    void remove(LoadModule* loader)
+    {
+        if (capacity == 0) return;
+        for (auto p = &buckets[loader->digest[slot] & (capacity - 1)]; *p; p = &(*p)->chain[slot]) {
+            if (*p != loader) continue;
+            *p = loader->chain[slot];
+            loader->chain[slot] = nullptr;
+            --count;
+            return;
+        }
+    }
+
+    void grow()
+    {
+        auto old = buckets;
+        auto oldCapacity = capacity;
+
+        capacity = capacity ? capacity * 2 : 64;
+        buckets = tvg::calloc<LoadModule**>(capacity, sizeof(LoadModule*));
+
+        for (uint32_t i = 0; i < oldCapacity; ++i) {
+            for (auto loader = old[i]; loader;) {
+                auto next = loader->chain[slot];
+                auto& head = buckets[loader->digest[slot] & (capacity - 1)];
+                loader->chain[slot] = head;
+                head = loader;
+                loader = next;
+            }
+        }
+        tvg::free(old);
+    }
+
+    void reset()
+    {
+        if (count > 0) return;
+        tvg::free(buckets);
+        buckets = nullptr;
+        capacity = 0;
+    }
+};
+
+//the lookups of the cached loaders share the key, the changes of the lists hold it alone
+static SharedKey _key;
 static Inlist<LoadModule> _activeLoaders;
+static Inlist<LoadModule> _idleLoaders;    //the decoded images released by the pictures, the least recently used first
+static LoaderIndex _keys(0);               //the active loaders by their paths or data
+static LoaderIndex _fonts(1);              //the active font loaders by their names
+static uint32_t _budget = 0;               //the memory budget of the idle loaders, disabled by default
+static uint32_t _usage = 0;
+
+
+static uint32_t _hash(const char* str)
+{
+    return uint32_t(djb2Encode(str));
+}
+
+
+static uint32_t _hash(uintptr_t key)
+{
+    return uint32_t((uint64_t(key) * 0x9e3779b97f4a7c15ull) >> 32);
+}
+
+
+static uint32_t _hash(const LoadModule* loader)
+{
+    return loader->hashpath ? _hash(loader->hashpath) : _hash(loader->hashkey);
+}
+
+
+//the caller must hold the key alone
+static void _list(LoadModule* loader)
+{
+    _activeLoaders.back(loader);
+    _keys.insert(loader, _hash(loader));
+    if (loader->type == FileType::Ttf) {
+        if (auto name = static_cast<FontLoader*>(loader)->name) _fonts.insert(loader, _hash(name));
+    }
+}
+
+
+//the caller must hold the key alone
+static void _unlist(LoadModule* loader)
+{
+    _activeLoaders.remove(loader);
+    _keys.remove(loader);
+    if (loader->type == FileType::Ttf) _fonts.remove(loader);
+}
 
 
 static LoadModule* _find(FileType type)
@@ -166,7 +277,7 @@ static LoadModule* _findByPath(const char* filename)
     if (!ext) return nullptr;
 
     if (!strcmp(ext, "svg")) return _find(FileType::Svg);
-    if (!strcmp(ext, "lot") || !strcmp(ext, "json")) return _find(FileType::Lot);
+    if (!strcmp(ext, "lot") || !strcmp(ext, "json") || !strcmp(ext, "tvglot")) return _find(FileType::Lot);
     if (!strcmp(ext, "png")) return _find(FileType::Png);
     if (!strcmp(ext, "jpg")) return _find(FileType::Jpg);
     if (!strcmp(ext, "webp")) return _find(FileType::Webp);
@@ -202,11 +313,62 @@ static LoadModule* _findByType(const char* mimeType)
 }
 
 
-static LoadModule* _findFromCache(const char* filename)
+//the images decoded in a reduced resolution are not for the others
+static bool _reduced(const LoadModule* loader)
 {
-    ScopedLock lock(_key);
-    INLIST_FOREACH(_activeLoaders, loader) {
-        if (loader->cached && loader->hashpath && !strcmp(loader->hashpath, filename)) {
+    if (loader->type == FileType::Ttf) return false;
+    return static_cast<const ImageLoader*>(loader)->reduction > 0;
+}
+
+
+static bool _retainable(const LoadModule* loader)
+{
+    //the data pointers could be released or reused by the users once the pictures are gone
+    if (!loader->hashpath || _reduced(loader)) return false;
+    return loader->type == FileType::Png || loader->type == FileType::Jpg || loader->type == FileType::Webp;
+}
+
+
+static uint32_t _footprint(const LoadModule* loader)
+{
+    auto& surface = static_cast<const ImageLoader*>(loader)->surface;
+    return surface.stride * surface.h * surface.channelSize;
+}
+
+
+//drop the least recently used images over the budget, they will be decoded again on demand
+static void _evict(uint32_t budget)
+{
+    while (_usage > budget && _idleLoaders.head) {
+        auto loader = _idleLoaders.head;
+        _idleLoaders.remove(loader);
+        _usage -= _footprint(loader);
+        delete(loader);
+    }
+}
+
+
+//keep the decoded image of the released loader within the budget, the caller must hold the lock
+static bool _retain(LoadModule* loader)
+{
+    if (_budget == 0 || !_retainable(loader) || !loader->readied) return false;
+    if (!static_cast<ImageLoader*>(loader)->bitmap()) return false;
+
+    auto size = _footprint(loader);
+    if (size > _budget) return false;
+
+    _idleLoaders.back(loader);
+    _usage += size;
+    _evict(_budget);
+    return true;
+}
+
+
+//the caller must hold the key
+static LoadModule* _findActive(const char* filename, uint32_t hash)
+{
+    for (auto loader = _keys.first(hash); loader; loader = loader->chain[0]) {
+        if (loader->digest[0] == hash && loader->hashpath && !strcmp(loader->hashpath, filename) && !_reduced(loader)) {
             ++loader->sharing;
             return loader;
         }
@@ -215,17 +377,43 @@ static LoadModule* _findFromCache(const char* filename)
 }
 
 
+static LoadModule* _findFromCache(const char* filename)
+{
+    auto hash = _hash(filename);
+    {
+        SharedLock lock(_key);
+        if (auto loader = _findActive(filename, hash)) return loader;
+        if (!_idleLoaders.head) return nullptr;
+    }
+
+    SharedLock lock(_key, true);
+    if (auto loader = _findActive(filename, hash)) return loader;
+
+    //revive the idle one, it's used by the only one picture again
+    INLIST_FOREACH(_idleLoaders, loader) {
+        if (!strcmp(loader->hashpath, filename)) {
+            _idleLoaders.remove(loader);
+            _usage -= _footprint(loader);
+            _list(loader);
+            return loader;
+        }
+    }
+    return nullptr;
+}
+
+
 static LoadModule* _findFromCache(const char* data, uint32_t size, const char* mimeType)
 {
     auto type = _convert(mimeType);
     if (type == FileType::Unknown) return nullptr;
 
     auto key = HASH_KEY(data);
+    auto hash = _hash(key);
 
-    ScopedLock lock(_key);
+    SharedLock lock(_key);
 
-    INLIST_FOREACH(_activeLoaders, loader) {
-        if (loader->type == type && loader->hashkey == key) {
+    for (auto loader = _keys.first(hash); loader; loader = loader->chain[0]) {
+        if (loader->type == type && loader->hashkey == key && !loader->hashpath && !_reduced(loader)) {
             ++loader->sharing;
             return loader;
         }
@@ -247,13 +435,23 @@ bool LoaderMgr::init()
 
 bool LoaderMgr::term()
 {
+#ifdef THORVG_SVG_LOADER_SUPPORT
+    //release the retained svg documents along with their embedded fonts
+    SvgLoader::cache(0);
+#endif
+
+    retain(0);
+
     //clean up the remained font loaders which is globally used.
+    SharedLock lock(_key, true);
     INLIST_SAFE_FOREACH(_activeLoaders, loader) {
         if (loader->type != FileType::Ttf) continue;
         auto ret = loader->close();
-        _activeLoaders.remove(loader);
+        _unlist(loader);
         if (ret) delete(loader);
     }
+    _keys.reset();
+    _fonts.reset();
     return true;
 }
 
@@ -262,9 +460,20 @@ bool LoaderMgr::retrieve(LoadModule* loader)
 {
     if (!loader) return false;
 
+    //the last user unlists it before closing, so that no lookup shares the loader being released
+    if (loader->cached) {
+        SharedLock lock(_key, true);
+        if (loader->sharing > 0) {
+            --loader->sharing;
+            return true;
+        }
+        _unlist(loader);
+    }
+
     if (loader->close()) {
         if (loader->cached) {
-            _activeLoaders.remove(loader);
+            SharedLock lock(_key, true);
+            if (_retain(loader)) return true;
         }
         delete(loader);
     }
@@ -272,15 +481,37 @@ bool LoaderMgr::retrieve(LoadModule* loader)
 }
 
 
+void LoaderMgr::retain(uint32_t budget)
+{
+    SharedLock lock(_key, true);
+    _budget = budget;
+    _evict(budget);
+}
+
+
+//drop the retained images and documents, the budgets stay for the next ones
+void LoaderMgr::trim()
+{
+#ifdef THORVG_SVG_LOADER_SUPPORT
+    SvgLoader::trim();
+#endif
+
+    SharedLock lock(_key, true);
+    _evict(0);
+}
+
+
 LoadModule* LoaderMgr::loader(const char* filename, bool* invalid)
 {
+    MemoryScope scope(MemoryCategory::Loader);
+
 #ifdef THORVG_FILE_IO_SUPPORT
     *invalid = false;
 
     //TODO: svg & lottie is not sharable.
     auto allowCache = true;
     auto ext = fileext(filename);
-    if (ext && (!strcmp(ext, "svg") || !strcmp(ext, "json") || !strcmp(ext, "lot"))) allowCache = false;
+    if (ext && (!strcmp(ext, "svg") || !strcmp(ext, "json") || !strcmp(ext, "lot") || !strcmp(ext, "tvglot"))) allowCache = false;
 
     if (allowCache) {
         if (auto loader = _findFromCache(filename)) return loader;
@@ -291,8 +522,8 @@ LoadModule* LoaderMgr::loader(const char* filename, bool* invalid)
             if (allowCache) {
                 loader->cache(duplicate(filename));
                 {
-                    ScopedLock lock(_key);
-                    _activeLoaders.back(loader);
+                    SharedLock lock(_key, true);
+                    _list(loader);
                 }
             }
             return loader;
@@ -306,8 +537,8 @@ LoadModule* LoaderMgr::loader(const char* filename, bool* invalid)
                 if (allowCache) {
                     loader->cache(duplicate(filename));
                     {
-                        ScopedLock lock(_key);
-                        _activeLoaders.back(loader);
+                        SharedLock lock(_key, true);
+                        _list(loader);
                     }
                 }
                 return loader;
@@ -321,6 +552,17 @@ LoadModule* LoaderMgr::loader(const char* filename, bool* invalid)
 }
 
 
+bool LoaderMgr::cache(uint32_t budget)
+{
+#ifdef THORVG_SVG_LOADER_SUPPORT
+    SvgLoader::cache(budget);
+    return true;
+#else
+    return false;
+#endif
+}
+
+
 bool LoaderMgr::retrieve(const char* filename)
 {
     return retrieve(_findFromCache(filename));
@@ -329,6 +571,8 @@ bool LoaderMgr::retrieve(const char* filename)
 
 LoadModule* LoaderMgr::loader(const char* data, uint32_t size, const char* mimeType, const char* rpath, bool copy)
 {
+    MemoryScope scope(MemoryCategory::Loader);
+
     //Note that users could use the same data pointer with the different content.
     //Thus caching is only valid for shareable.
     auto allowCache = !copy;
@@ -349,8 +593,8 @@ LoadModule* LoaderMgr::loader(const char* data, uint32_t size, const char* mimeT
             if (loader->open(data, size, rpath, copy)) {
                 if (allowCache) {
                     loader->cache(HASH_KEY(data));
-                    ScopedLock lock(_key);
-                    _activeLoaders.back(loader);
+                    SharedLock lock(_key, true);
+                    _list(loader);
                 }
                 return loader;
             } else {
@@ -366,8 +610,8 @@ LoadModule* LoaderMgr::loader(const char* data, uint32_t size, const char* mimeT
             if (loader->open(data, size, rpath, copy)) {
                 if (allowCache) {
                     loader->cache(HASH_KEY(data));
-                    ScopedLock lock(_key);
-                    _activeLoaders.back(loader);
+                    SharedLock lock(_key, true);
+                    _list(loader);
                 }
                 return loader;
             }
@@ -378,8 +622,10 @@ LoadModule* LoaderMgr::loader(const char* data, uint32_t size, const char* mimeT
 }
 
 
-LoadModule* LoaderMgr::loader(const uint32_t *data, uint32_t w, uint32_t h, ColorSpace cs, bool copy)
+LoadModule* LoaderMgr::loader(const uint32_t *data, uint32_t w, uint32_t h, uint32_t stride, ColorSpace cs, bool copy)
 {
+    MemoryScope scope(MemoryCategory::Loader);
+
     //Note that users could use the same data pointer with the different content.
     //Thus caching is only valid for shareable.
     if (!copy) {
@@ -389,11 +635,11 @@ LoadModule* LoaderMgr::loader(const uint32_t *data, uint32_t w, uint32_t h, Colo
 
     //function is dedicated for raw images only
     auto loader = new RawLoader;
-    if (loader->open(data, w, h, cs, copy)) {
+    if (loader->open(data, w, h, stride, cs, copy)) {
         if (!copy) {
             loader->cache(HASH_KEY((const char*)data));
-            ScopedLock lock(_key);
-            _activeLoaders.back(loader);
+            SharedLock lock(_key, true);
+            _list(loader);
         }
         return loader;
     }
@@ -402,9 +648,23 @@ LoadModule* LoaderMgr::loader(const uint32_t *data, uint32_t w, uint32_t h, Colo
 }
 
 
+//wraps a gpu texture, which isn't cached for its content is owned by the user
+LoadModule* LoaderMgr::loader(void* texture, uint32_t w, uint32_t h, ColorSpace cs)
+{
+    MemoryScope scope(MemoryCategory::Loader);
+
+    auto loader = new RawLoader;
+    if (loader->open(texture, w, h, cs)) return loader;
+    delete(loader);
+    return nullptr;
+}
+
+
 //loads fonts from memory - loader is cached (regardless of copy value) in order to access it while setting font
 LoadModule* LoaderMgr::loader(const char* name, const char* data, uint32_t size, TVG_UNUSED const char* mimeType, bool copy)
 {
+    MemoryScope scope(MemoryCategory::Loader);
+
 #ifdef THORVG_TTF_LOADER_SUPPORT
     //TODO: add check for mimetype ?
     if (auto loader = font(name)) return loader;
@@ -414,8 +674,8 @@ LoadModule* LoaderMgr::loader(const char* name, const char* data, uint32_t size,
     if (loader->open(data, size, "", copy)) {
         loader->name = duplicate(name);
         loader->cached = true;  //force it.
-        ScopedLock lock(_key);
-        _activeLoaders.back(loader);
+        SharedLock lock(_key, true);
+        _list(loader);
         return loader;
     }
 
@@ -428,10 +688,13 @@ LoadModule* LoaderMgr::loader(const char* name, const char* data, uint32_t size,
 
 LoadModule* LoaderMgr::font(const char* name)
 {
-    ScopedLock lock(_key);
-    INLIST_FOREACH(_activeLoaders, loader) {
-        if (loader->type != FileType::Ttf) continue;
-        if (loader->cached && tvg::equal(name, static_cast<FontLoader*>(loader)->name)) {
+    if (!name) return nullptr;
+
+    auto hash = _hash(name);
+
+    SharedLock lock(_key);
+    for (auto loader = _fonts.first(hash); loader; loader = loader->chain[1]) {
+        if (loader->digest[1] == hash && loader->cached && tvg::equal(name, static_cast<FontLoader*>(loader)->name)) {
             ++loader->sharing;
             return loader;
         }
@@ -442,7 +705,7 @@ LoadModule* LoaderMgr::font(const char* name)
 
 LoadModule* LoaderMgr::anyfont()
 {
-    ScopedLock lock(_key);
+    SharedLock lock(_key);
     INLIST_FOREACH(_activeLoaders, loader) {
         if (loader->cached && loader->type == FileType::Ttf) {
             ++loader->sharing;
@@ -31,12 +31,16 @@ struct LoaderMgr
     static bool term();
     static LoadModule* loader(const char* filename, bool* invalid);
     static LoadModule* loader(const char* data, uint32_t size, const char* mimeType, const char* rpath, bool copy);
-    static LoadModule* loader(const uint32_t* data, uint32_t w, uint32_t h, ColorSpace cs, bool copy);
+    static LoadModule* loader(const uint32_t* data, uint32_t w, uint32_t h, uint32_t stride, ColorSpace cs, bool copy);
+    static LoadModule* loader(void* texture, uint32_t w, uint32_t h, ColorSpace cs);
     static LoadModule* loader(const char* name, const char* data, uint32_t size, const char* mimeType, bool copy);
     static LoadModule* font(const char* name);
     static LoadModule* anyfont();
     static bool retrieve(const char* filename);
     static bool retrieve(LoadModule* loader);
+    static bool cache(uint32_t budget);
+    static void retain(uint32_t budget);
+    static void trim();
 };
 
 #endif //_TVG_LOADER_H_
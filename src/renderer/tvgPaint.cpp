@@ -73,6 +73,53 @@ static Result _clipRect(RenderMethod* renderer, const Point* pts, const Matrix&
 }
 
 
+//the alpha masking of a shape by a single opaque shape is the clipping by the mask shape
+static bool _maskClip(RenderMethod* renderer, Paint* paint, Paint* target, MaskMethod method)
+{
+    if (method != MaskMethod::Alpha || target->type() != Type::Shape || !renderer->alphaClip()) return false;
+
+    auto shape = static_cast<Shape*>(target);
+    auto timpl = PAINT(target);
+    if (timpl->opacity < 255 || timpl->maskData || timpl->blendMethod != BlendMethod::Normal) return false;
+    if (shape->fill() || SHAPE(shape)->rs.strokeWidth() > 0.0f) return false;
+
+    uint8_t a;
+    shape->fill(nullptr, nullptr, nullptr, &a);
+    if (a < 255) return false;
+
+    //overlapped coverages, such as a stroke over its fill, would be masked twice
+    if (paint->type() != Type::Shape || SHAPE(paint)->rs.strokeWidth() > 0.0f) return false;
+    return PAINT(paint)->blendMethod == BlendMethod::Normal;
+}
+
+
+//the masked drawing is visible within the masking shape only, its damages don't go beyond
+static bool _maskRegion(Paint* target, MaskMethod method, const Matrix& pm, RenderRegion& region)
+{
+    if (method != MaskMethod::Alpha && method != MaskMethod::Luma && method != MaskMethod::Intersect) return false;
+
+    //the chained maskings may expand the masking region
+    if (target->type() != Type::Shape || PAINT(target)->maskData) return false;
+
+    Point pt4[4];
+    auto m = pm;
+    if (PAINT(target)->bounds(pt4, &m, false, true) != Result::Success) return false;
+
+    Point min = {FLT_MAX, FLT_MAX};
+    Point max = {-FLT_MAX, -FLT_MAX};
+    for (int i = 0; i < 4; ++i) {
+        if (pt4[i].x < min.x) min.x = pt4[i].x;
+        if (pt4[i].x > max.x) max.x = pt4[i].x;
+        if (pt4[i].y < min.y) min.y = pt4[i].y;
+        if (pt4[i].y > max.y) max.y = pt4[i].y;
+    }
+
+    //a pixel margin for the anti-aliasing
+    region = {{int32_t(floorf(min.x)) - 1, int32_t(floorf(min.y)) - 1}, {int32_t(ceilf(max.x)) + 1, int32_t(ceilf(max.y)) + 1}};
+    return true;
+}
+
+
 static Result _compFastTrack(RenderMethod* renderer, Paint* cmpTarget, const Matrix& pm, RenderRegion& before)
 {
     /* Access Shape class by Paint is bad... but it's ok still it's an internal usage. */
@@ -147,6 +194,22 @@ RenderRegion Paint::Impl::bounds(RenderMethod* renderer) const
 }
 
 
+bool Paint::Impl::intersects(const RenderRegion& region)
+{
+    if (!renderer || opacity == 0) return false;
+
+    //the masked out area isn't drawn, the fast tracked masks have clipped the render data already
+    if (maskData && !(PAINT(maskData->target)->ctxFlag & ContextFlag::FastTrack)) {
+        auto method = maskData->method;
+        if ((method == MaskMethod::Alpha || method == MaskMethod::Luma) && !PAINT(maskData->target)->intersects(region)) return false;
+    }
+
+    bool ret;
+    PAINT_METHOD(ret, intersects(region));
+    return ret;
+}
+
+
 Iterator* Paint::Impl::iterator()
 {
     Iterator* ret;
@@ -155,6 +218,13 @@ Iterator* Paint::Impl::iterator()
 }
 
 
+//notify the change to the spatial index of the parent scene
+void Paint::Impl::touch()
+{
+    SCENE(parent)->index->touch(indexed - 1);
+}
+
+
 Paint* Paint::Impl::duplicate(Paint* ret)
 {
     if (ret) ret->mask(nullptr, MaskMethod::None);
@@ -166,6 +236,7 @@ Paint* Paint::Impl::duplicate(Paint* ret)
     ret->pImpl->mark(RenderUpdateFlag::Transform);
 
     ret->pImpl->opacity = opacity;
+    ret->pImpl->blend(blendMethod);
 
     if (maskData) ret->mask(maskData->target->duplicate(), maskData->method);
     if (clipper) ret->clip(static_cast<Shape*>(clipper->duplicate()));
@@ -208,8 +279,48 @@ bool Paint::Impl::render(RenderMethod* renderer)
 }
 
 
+/* Switch the render data over to the given renderer. The current one is retained along with the changes since then,
+   so that the paint going back and forth between the canvases is not prepared from scratch every time. */
+void Paint::Impl::retarget(RenderMethod* renderer)
+{
+    if (this->renderer) {
+        RenderUpdateFlag flag;
+        PAINT_METHOD(flag, retarget());
+        if (!slots) slots = new Array<RenderSlot>;
+        slots->push({this->renderer, rd, renderFlag | flag});
+        this->renderer = nullptr;
+        rd = nullptr;
+    }
+
+    //back to the former renderer, it takes over the reference of the slot
+    if (slots) {
+        for (auto p = slots->begin(); p < slots->end(); ++p) {
+            if (p->renderer != renderer) continue;
+            this->renderer = renderer;
+            rd = p->rd;
+            renderFlag = p->flag;
+            *p = slots->last();
+            slots->pop();
+            return;
+        }
+        //prepared already by the others, nothing is ready here
+        renderFlag = RenderUpdateFlag::All;
+    }
+
+    renderer->ref();
+    this->renderer = renderer;
+}
+
+
 RenderData Paint::Impl::update(RenderMethod* renderer, const Matrix& pm, Array<RenderData>& clips, uint8_t opacity, RenderUpdateFlag flag, bool clipper)
 {
+    if (this->renderer != renderer) retarget(renderer);
+
+    //the rles are clipped by the mask, they follow its changes. Otherwise, the masked region is redrawn.
+    if (maskData && PAINT(maskData->target)->renderFlag) {
+        mark((PAINT(maskData->target)->ctxFlag & ContextFlag::Clipping) ? RenderUpdateFlag::Clip : RenderUpdateFlag::Blend);
+    }
+
     bool ret;
     PAINT_METHOD(ret, skip((flag | renderFlag)));
 
@@ -217,23 +328,19 @@ RenderData Paint::Impl::update(RenderMethod* renderer, const Matrix& pm, Array<R
 
     cmpFlag = CompositionFlag::Invalid;  //must clear after the rendering
 
-    if (this->renderer != renderer) {
-        if (this->renderer) TVGERR("RENDERER", "paint's renderer has been changed!");
-        renderer->ref();
-        this->renderer = renderer;
-    }
-
     if (renderFlag & RenderUpdateFlag::Transform) tr.update();
 
     /* 1. Composition Pre Processing */
     RenderData trd = nullptr;                 //composite target render data
     RenderRegion viewport;
     Result compFastTrack = Result::InsufficientCondition;
+    auto maskClip = false;
 
     if (maskData) {
         auto target = maskData->target;
         auto method = maskData->method;
-        PAINT(target)->ctxFlag &= ~ContextFlag::FastTrack;   //reset
+        auto clipping = PAINT(target)->ctxFlag & ContextFlag::Clipping;
+        PAINT(target)->ctxFlag &= ~(ContextFlag::FastTrack | ContextFlag::Clipping);   //reset
 
         /* If the transformation has no rotational factors and the Alpha(InvAlpha) Masking involves a simple rectangle,
            we can optimize by using the viewport instead of the regular Alphaing sequence for improved performance. */
@@ -252,8 +359,18 @@ RenderData Paint::Impl::update(RenderMethod* renderer, const Matrix& pm, Array<R
             }
         }
         if (compFastTrack == Result::InsufficientCondition) {
-            trd = PAINT(target)->update(renderer, pm, clips, 255, flag, false);
+            //clip the rles by the masking shape directly without any intermediate compositions
+            if ((maskClip = _maskClip(renderer, paint, target, method))) {
+                if (!clipping || PAINT(target)->renderFlag) mark(RenderUpdateFlag::Clip);
+                trd = PAINT(target)->update(renderer, pm, clips, 255, flag, true);
+                clips.push(trd);
+                PAINT(target)->ctxFlag |= (ContextFlag::FastTrack | ContextFlag::Clipping);
+            } else {
+                trd = PAINT(target)->update(renderer, pm, clips, 255, flag, false);
+            }
         }
+        //the rles were clipped by the mask
+        if (clipping && !maskClip) mark(RenderUpdateFlag::Clip);
     }
 
     /* 2. Clipping */
@@ -275,12 +392,21 @@ RenderData Paint::Impl::update(RenderMethod* renderer, const Matrix& pm, Array<R
     }
 
     /* 3. Main Update */
+    //the damages of the composited drawing are clipped by the masking region
+    RenderRegion maskRegion;
+    auto scoped = (maskData && compFastTrack == Result::InsufficientCondition && !maskClip && _maskRegion(maskData->target, maskData->method, pm, maskRegion));
+    RenderDirtyRegion::Scope former;
+    if (scoped) former = renderer->scope({}, &maskRegion);
+
     opacity = MULTIPLY(opacity, this->opacity);
     PAINT_METHOD(ret, update(renderer, pm * tr.m, clips, opacity, (flag | renderFlag), clipper));
 
+    if (scoped) renderer->scope(former);
+
     /* 4. Composition Post Processing */
     if (compFastTrack == Result::Success) renderer->viewport(viewport);
     else if (this->clipper) clips.pop();
+    if (maskClip) clips.pop();
 
     renderFlag = RenderUpdateFlag::None;
 
@@ -316,8 +442,22 @@ Result Paint::Impl::bounds(Point* pt4, Matrix* pm, bool obb, bool stroking)
     auto m = this->transform();
     if (pm) m = *pm * m;
 
+    //the shapes and the scenes retain the last result until their geometry is changed
+    auto type = paint->type();
+    auto caching = (type == Type::Shape || type == Type::Scene);
+
+    if (caching && bcache && bcache->valid && bcache->obb == obb && bcache->stroking == stroking && !memcmp(&bcache->m, &m, sizeof(Matrix))) {
+        memcpy(pt4, bcache->pt4, sizeof(bcache->pt4));
+        return bcache->ret;
+    }
+
     Result ret;
     PAINT_METHOD(ret, bounds(pt4, m, obb, stroking));
+
+    if (caching) {
+        if (!bcache) bcache = new BoundsCache;
+        *bcache = {m, {pt4[0], pt4[1], pt4[2], pt4[3]}, ret, obb, stroking, true};
+    }
     return ret;
 }
 
@@ -371,6 +511,13 @@ Result Paint::bounds(float* x, float* y, float* w, float* h) const noexcept
 }
 
 
+bool Paint::intersects(int32_t x, int32_t y, int32_t w, int32_t h) noexcept
+{
+    if (w <= 0 || h <= 0) return false;
+    return pImpl->intersects({{x, y}, {x + w, y + h}});
+}
+
+
 Result Paint::bounds(Point* pt4) const noexcept
 {
     if (!pt4) return Result::InvalidArguments;
@@ -32,7 +32,7 @@
 
 namespace tvg
 {
-    enum ContextFlag : uint8_t {Default = 0, FastTrack = 1};
+    enum ContextFlag : uint8_t {Default = 0, FastTrack = 1, Clipping = 2};
 
     struct Iterator
     {
@@ -49,6 +49,25 @@ namespace tvg
         MaskMethod method;
     };
 
+    //the last result of the geometric bounds query, see Paint::Impl::bounds()
+    struct BoundsCache
+    {
+        Matrix m;             //the query transform
+        Point pt4[4];
+        Result ret;
+        bool obb;
+        bool stroking;
+        bool valid;
+    };
+
+    //the render data of a renderer the paint left, see Paint::Impl::retarget()
+    struct RenderSlot
+    {
+        RenderMethod* renderer;
+        RenderData rd;
+        RenderUpdateFlag flag;   //the changes since it was left
+    };
+
     struct Paint::Impl
     {
         Paint* paint = nullptr;
@@ -57,6 +76,8 @@ namespace tvg
         Shape* clipper = nullptr;
         RenderMethod* renderer = nullptr;
         RenderData rd = nullptr;
+        BoundsCache* bcache = nullptr;
+        Array<RenderSlot>* slots = nullptr;   //the retained render data of the other renderers
 
         struct {
             Matrix m;                 //input matrix
@@ -81,7 +102,9 @@ namespace tvg
         RenderUpdateFlag renderFlag = RenderUpdateFlag::None;
         CompositionFlag cmpFlag = CompositionFlag::Invalid;
         BlendMethod blendMethod;
+        uint32_t indexed = 0;      //entry of the parent's SceneIndex + 1, if any
         uint16_t refCnt = 0;       //reference count
+        bool hidden = false;       //occluded by the later siblings in the current drawing, see SceneImpl::occlude()
         uint8_t ctxFlag;           //See enum ContextFlag
         uint8_t opacity;
 
@@ -100,10 +123,20 @@ namespace tvg
 
             if (clipper) PAINT(clipper)->unref();
 
+            delete(bcache);
+
             if (renderer) {
                 if (rd) renderer->dispose(rd);
                 if (renderer->unref() == 0) delete(renderer);
             }
+
+            if (slots) {
+                ARRAY_FOREACH(p, *slots) {
+                    if (p->rd) p->renderer->dispose(p->rd);
+                    if (p->renderer->unref() == 0) delete(p->renderer);
+                }
+                delete(slots);
+            }
         }
 
         uint16_t ref()
@@ -157,6 +190,21 @@ namespace tvg
         void mark(RenderUpdateFlag flag)
         {
             renderFlag |= flag;
+            if (slots) {
+                ARRAY_FOREACH(p, *slots) p->flag |= flag;
+            }
+            if (flag & (RenderUpdateFlag::Path | RenderUpdateFlag::Stroke | RenderUpdateFlag::Transform | RenderUpdateFlag::Image)) {
+                unbound();
+                if (indexed) touch();
+            }
+        }
+
+        //drop the cached bounds of this and the ancestors, their bounds cover this
+        void unbound()
+        {
+            for (auto impl = this; impl; impl = impl->parent ? PAINT(impl->parent) : nullptr) {
+                if (impl->bcache) impl->bcache->valid = false;
+            }
         }
 
         bool transform(const Matrix& m)
@@ -189,7 +237,11 @@ namespace tvg
         Result clip(Shape* clp)
         {
             if (clp && PAINT(clp)->parent) return Result::InsufficientCondition;
-            if (clipper) PAINT(clipper)->unref(clipper != clp);
+            if (indexed) touch();   //not a plain shape anymore
+            if (clipper) {
+                mark(RenderUpdateFlag::Clip);   //the rles were clipped by the previous clipper
+                PAINT(clipper)->unref(clipper != clp);
+            }
             clipper = clp;
             if (clp) {
                 clp->ref();
@@ -201,8 +253,12 @@ namespace tvg
         Result mask(Paint* target, MaskMethod method)
         {
             if (target && PAINT(target)->parent) return Result::InsufficientCondition;
+            if (indexed) touch();   //not a plain shape anymore
 
             if (maskData) {
+                //the rles were clipped by the previous mask
+                if (PAINT(maskData->target)->ctxFlag & ContextFlag::Clipping) mark(RenderUpdateFlag::Clip);
+                else mark(RenderUpdateFlag::Blend);   //the unmasked region must be redrawn
                 PAINT(maskData->target)->unref(maskData->target != target);
                 tvg::free(maskData);
                 maskData = nullptr;
@@ -287,6 +343,14 @@ namespace tvg
             return true;
         }
 
+        //the opaque shape drawn as it is, which hides the former siblings beneath the region
+        bool occluder(RenderMethod* renderer, RenderRegion& region)
+        {
+            if (opacity < 255 || maskData || clipper || cmpFlag || blendMethod != BlendMethod::Normal) return false;
+            if (!rd || this->renderer != renderer || paint->type() != Type::Shape) return false;
+            return renderer->occluder(rd, region);
+        }
+
         void blend(BlendMethod method)
         {
             if (blendMethod != method) {
@@ -296,7 +360,10 @@ namespace tvg
         }
 
         RenderRegion bounds(RenderMethod* renderer) const;
+        bool intersects(const RenderRegion& region);
         Iterator* iterator();
+        void touch();
+        void retarget(RenderMethod* renderer);
         Result bounds(float* x, float* y, float* w, float* h, Matrix* pm, bool stroking);
         Result bounds(Point* pt4, Matrix* pm, bool obb, bool stroking);
         RenderData update(RenderMethod* renderer, const Matrix& pm, Array<RenderData>& clips, uint8_t opacity, RenderUpdateFlag pFlag, bool clipper = false);
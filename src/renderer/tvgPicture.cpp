@@ -21,8 +21,60 @@
  */
 
 #include "tvgPaint.h"
+#include "tvgScene.h"
 #include "tvgPicture.h"
 
+/************************************************************************/
+/* Internal Class Implementation                                        */
+/************************************************************************/
+
+void PictureIndex::build(const Paint* vector, uint32_t revision)
+{
+    this->vector = vector;
+    this->revision = revision;
+
+    Array<Slot> named;
+
+    auto cb = [](const tvg::Paint* paint, void* data) -> bool
+    {
+        if (paint->id) static_cast<Array<Slot>*>(data)->push({paint->id, paint});
+        return true;
+    };
+
+    auto accessor = tvg::Accessor::gen();
+    accessor->set(const_cast<Paint*>(vector), cb, &named);
+    delete(accessor);
+
+    auto capacity = 16u;
+    while (capacity < named.count * 2) capacity <<= 1;
+    if (capacity != this->capacity) {
+        tvg::free(slots);
+        slots = tvg::malloc<Slot*>(sizeof(Slot) * capacity);
+        this->capacity = capacity;
+    }
+    memset(slots, 0, sizeof(Slot) * capacity);
+
+    //the ids are hashed already, the first one in the preorder is taken among the same ids
+    ARRAY_FOREACH(p, named) {
+        auto i = p->id & (capacity - 1);
+        while (slots[i].id && slots[i].id != p->id) i = (i + 1) & (capacity - 1);
+        if (!slots[i].id) slots[i] = *p;
+    }
+}
+
+
+const Paint* PictureIndex::find(uint32_t id) const
+{
+    for (auto i = id & (capacity - 1); slots[i].id; i = (i + 1) & (capacity - 1)) {
+        if (slots[i].id == id) return slots[i].paint;
+    }
+    return nullptr;
+}
+
+/************************************************************************/
+/* External Class Implementation                                        */
+/************************************************************************/
+
 Picture::Picture() = default;
 
 
@@ -58,7 +110,39 @@ Result Picture::load(const char* data, uint32_t size, const char* mimeType, cons
 
 Result Picture::load(uint32_t* data, uint32_t w, uint32_t h, ColorSpace cs, bool copy) noexcept
 {
-    return PICTURE(this)->load(data, w, h, cs, copy);
+    return PICTURE(this)->load(data, w, h, w, cs, copy);
+}
+
+
+Result Picture::load(uint32_t* data, uint32_t w, uint32_t h, uint32_t stride, ColorSpace cs, bool copy) noexcept
+{
+    return PICTURE(this)->load(data, w, h, stride, cs, copy);
+}
+
+
+Result Picture::cache(uint32_t budget) noexcept
+{
+    if (LoaderMgr::cache(budget)) return Result::Success;
+    return Result::NonSupport;
+}
+
+
+Result Picture::prefetch(bool on) noexcept
+{
+    PICTURE(this)->prefetch(on);
+    return Result::Success;
+}
+
+
+bool Picture::ready() const noexcept
+{
+    return CONST_PICTURE(this)->ready();
+}
+
+
+Result Picture::cancel() noexcept
+{
+    return PICTURE(this)->cancel();
 }
 
 
@@ -75,27 +159,33 @@ Result Picture::size(float* w, float* h) const noexcept
 }
 
 
+Result Picture::texture(void* texture, uint32_t w, uint32_t h, ColorSpace cs) noexcept
+{
+    return PICTURE(this)->load(texture, w, h, cs);
+}
+
+
+Result Picture::refresh(int32_t x, int32_t y, int32_t w, int32_t h) noexcept
+{
+    if (w <= 0 || h <= 0) return Result::InvalidArguments;
+    return PICTURE(this)->refresh({{x, y}, {x + w, y + h}});
+}
+
+
 const Paint* Picture::paint(uint32_t id) noexcept
 {
-    struct Value
-    {
-        uint32_t id;
-        const Paint* ret;
-    } value = {id, nullptr};
+    if (id == this->id) return this;
 
-    auto cb = [](const tvg::Paint* paint, void* data) -> bool
-    {
-        auto p = static_cast<Value*>(data);
-        if (p->id == paint->id) {
-            p->ret = paint;
-            return false;
-        }
-        return true;
-    };
+    auto picture = PICTURE(this);
+    picture->load();
+    auto vector = picture->vector;
+    if (!id || !vector) return nullptr;
 
-    auto accessor = tvg::Accessor::gen();
-    accessor->set(this, cb, &value);
-    delete(accessor);
+    //the loaders replace the children of the vector scene only, such as the frames of the animation
+    auto revision = (vector->type() == Type::Scene) ? SCENE(vector)->revision : 0;
+    if (!picture->index) picture->index = new PictureIndex;
+    auto index = picture->index;
+    if (index->vector != vector || index->revision != revision || !index->slots) index->build(vector, revision);
 
-    return value.ret;
+    return index->find(id);
 }
\ No newline at end of file
@@ -25,6 +25,7 @@
 
 #include "tvgPaint.h"
 #include "tvgLoader.h"
+#include "tvgFrameModule.h"
 
 #define PICTURE(A) static_cast<PictureImpl*>(A)
 #define CONST_PICTURE(A) static_cast<const PictureImpl*>(A)
@@ -56,14 +57,43 @@ struct PictureIterator : Iterator
 };
 
 
+//the paints of the vector by their ids, built again once the vector is changed, see Picture::paint()
+struct PictureIndex
+{
+    struct Slot
+    {
+        uint32_t id;
+        const Paint* paint;
+    };
+
+    Slot* slots = nullptr;
+    uint32_t capacity = 0;            //the power of two, twice the ids at least
+    const Paint* vector = nullptr;    //the indexed tree
+    uint32_t revision = 0;            //the children changes of the indexed tree
+
+    ~PictureIndex()
+    {
+        tvg::free(slots);
+    }
+
+    void build(const Paint* vector, uint32_t revision);
+    const Paint* find(uint32_t id) const;
+};
+
+
 struct PictureImpl : Picture
 {
     Paint::Impl impl;
     ImageLoader* loader = nullptr;
     Paint* vector = nullptr;          //vector picture uses
     RenderSurface* bitmap = nullptr;  //bitmap picture uses
+    RenderSurface* baked = nullptr;   //the prerendered frame shown instead of the vector, see Animation::bake()
+    RenderRegion refreshed{};         //the changed area of the bitmap since the last update, see refresh()
+    PictureIndex* index = nullptr;    //the paints of the vector by their ids, see Picture::paint()
     float w = 0, h = 0;
     bool resizing = false;
+    bool lazy = false;                //defer reading (decoding) the loader until it's needed for drawing
+    bool prefetching = false;         //read the loader in the background with the lowest priority
 
     PictureImpl() : impl(Paint::Impl(this))
     {
@@ -73,6 +103,7 @@ struct PictureImpl : Picture
     {
         LoaderMgr::retrieve(loader);
         delete(vector);
+        delete(index);
     }
 
     bool skip(RenderUpdateFlag flag)
@@ -81,24 +112,35 @@ struct PictureImpl : Picture
         return false;
     }
 
+    RenderUpdateFlag retarget()
+    {
+        return RenderUpdateFlag::None;
+    }
+
     bool update(RenderMethod* renderer, const Matrix& transform, Array<RenderData>& clips, uint8_t opacity, RenderUpdateFlag flag, TVG_UNUSED bool clipper)
     {
         load();
 
-        if (bitmap) {
+        if (auto image = baked ? baked : bitmap) {
             //Overriding Transformation by the desired image size
-            auto sx = w / loader->w;
-            auto sy = h / loader->h;
+            auto sx = w / image->w;
+            auto sy = h / image->h;
             auto scale = sx < sy ? sx : sy;
             auto m = transform * Matrix{scale, 0, 0, 0, scale, 0, 0, 0, 1};
-            impl.rd = renderer->prepare(bitmap, impl.rd, m, clips, opacity, flag);
+            image->refreshed = refreshed;
+            impl.rd = renderer->prepare(image, impl.rd, m, clips, opacity, flag);
+            image->refreshed.reset();
+            refreshed.reset();
         } else if (vector) {
+            FrameTimingScope timing(loader);
             if (resizing) {
                 loader->resize(vector, w, h);
                 resizing = false;
             }
             needComposition(opacity);
             vector->blend(pImpl->blendMethod); //propagate blend method to nested vector scene
+            //a new frame of the animation only, its unchanged paints are left as they are
+            if (flag == RenderUpdateFlag::Image) flag = RenderUpdateFlag::None;
             return vector->pImpl->update(renderer, transform, clips, opacity, flag, false);
         }
         return true;
@@ -109,6 +151,42 @@ struct PictureImpl : Picture
         this->w = w;
         this->h = h;
         resizing = true;
+        impl.unbound();
+    }
+
+    Result refresh(const RenderRegion& region)
+    {
+        load();
+        if (!bitmap || bitmap->native) return Result::InsufficientCondition;
+
+        auto changed = RenderRegion::intersect(region, {{0, 0}, {int32_t(bitmap->w), int32_t(bitmap->h)}});
+        if (changed.invalid()) return Result::Success;
+
+        if (refreshed.valid()) refreshed.add(changed);
+        else refreshed = changed;
+        impl.mark(RenderUpdateFlag::Image);
+
+        return Result::Success;
+    }
+
+    //switch between the vector and the baked frames of the animation
+    void bake(RenderSurface* surface)
+    {
+        //the image data isn't compatible with the vector one
+        if (!surface && impl.rd && impl.renderer) {
+            impl.damage();
+            impl.renderer->dispose(impl.rd);
+            impl.rd = nullptr;
+        }
+        baked = surface;
+        impl.mark(RenderUpdateFlag::All);
+    }
+
+    //a new baked frame has been decoded
+    void rebaked()
+    {
+        refreshed = {{0, 0}, {int32_t(baked->w), int32_t(baked->h)}};
+        impl.mark(RenderUpdateFlag::Image);
     }
 
     Result size(float* w, float* h) const
@@ -119,6 +197,25 @@ struct PictureImpl : Picture
         return Result::Success;
     }
 
+    void prefetch(bool on)
+    {
+        prefetching = on;
+        if (!on && loader) loader->promote();
+    }
+
+    bool ready() const
+    {
+        return loader && !lazy && loader->completed();
+    }
+
+    Result cancel()
+    {
+        if (!loader || lazy || loader->sharing > 0 || !loader->cancel()) return Result::InsufficientCondition;
+        //read it again once it's needed
+        lazy = true;
+        return Result::Success;
+    }
+
     Result bounds(Point* pt4, Matrix& m, TVG_UNUSED bool obb, TVG_UNUSED bool stroking) const
     {
         pt4[0] = Point{0.0f, 0.0f} * m;
@@ -150,12 +247,23 @@ struct PictureImpl : Picture
         return load(loader);
     }
 
-    Result load(uint32_t* data, uint32_t w, uint32_t h, ColorSpace cs, bool copy)
+    Result load(uint32_t* data, uint32_t w, uint32_t h, uint32_t stride, ColorSpace cs, bool copy)
     {
-        if (!data || w <= 0 || h <= 0 || cs == ColorSpace::Unknown)  return Result::InvalidArguments;
+        if (!data || w <= 0 || h <= 0 || stride < w || cs == ColorSpace::Unknown)  return Result::InvalidArguments;
         if (vector || bitmap) return Result::InsufficientCondition;
 
-        auto loader = static_cast<ImageLoader*>(LoaderMgr::loader(data, w, h, cs, copy));
+        auto loader = static_cast<ImageLoader*>(LoaderMgr::loader(data, w, h, stride, cs, copy));
+        if (!loader) return Result::FailedAllocation;
+
+        return load(loader);
+    }
+
+    Result load(void* texture, uint32_t w, uint32_t h, ColorSpace cs)
+    {
+        if (!texture || w <= 0 || h <= 0 || cs == ColorSpace::Unknown)  return Result::InvalidArguments;
+        if (vector || bitmap) return Result::InsufficientCondition;
+
+        auto loader = static_cast<ImageLoader*>(LoaderMgr::loader(texture, w, h, cs));
         if (!loader) return Result::FailedAllocation;
 
         return load(loader);
@@ -165,7 +273,8 @@ struct PictureImpl : Picture
     {
         if (ret) TVGERR("RENDERER", "TODO: duplicate()");
 
-        load();
+        //the lazy one shares its loader to be read by any of them
+        if (!lazy) load();
 
         auto picture = Picture::gen();
         auto dup = PICTURE(picture);
@@ -185,6 +294,8 @@ struct PictureImpl : Picture
         dup->w = w;
         dup->h = h;
         dup->resizing = resizing;
+        dup->lazy = lazy;
+        dup->prefetching = prefetching;
 
         return picture;
     }
@@ -200,20 +311,28 @@ struct PictureImpl : Picture
         //Try it, If not loaded yet.
         load();
 
-        if (loader) {
+        if (bitmap) {
+            if (w) *w = bitmap->w;
+            if (h) *h = bitmap->h;
+        } else if (loader) {
             if (w) *w = static_cast<uint32_t>(loader->w);
             if (h) *h = static_cast<uint32_t>(loader->h);
         } else {
             if (w) *w = 0;
             if (h) *h = 0;
         }
-        if (bitmap) return bitmap->buf32;
+        if (bitmap && !bitmap->native) return bitmap->buf32;
         else return nullptr;
     }
 
     void load()
     {
         if (loader) {
+            if (lazy) {
+                MemoryScope scope(MemoryCategory::Loader);
+                loader->read();
+                lazy = false;
+            }
             if (vector) {
                 loader->sync();
             } else if ((vector = loader->paint())) {
@@ -222,6 +341,7 @@ struct PictureImpl : Picture
                     if (!resizing) {
                         w = loader->w;
                         h = loader->h;
+                        impl.unbound();
                     }
                     loader->resize(vector, w, h);
                     resizing = false;
@@ -250,7 +370,7 @@ struct PictureImpl : Picture
     {
         auto ret = true;
 
-        if (bitmap) {
+        if (bitmap || baked) {
             renderer->blend(impl.blendMethod);
             return renderer->renderImage(impl.rd);
         } else if (vector) {
@@ -259,15 +379,23 @@ struct PictureImpl : Picture
                 cmp = renderer->target(bounds(renderer), renderer->colorSpace(), impl.cmpFlag);
                 renderer->beginComposite(cmp, MaskMethod::None, 255);
             }
+            FrameTimingScope timing(loader);
             ret = vector->pImpl->render(renderer);
             if (cmp) renderer->endComposite(cmp);
         }
         return ret;
     }
 
+    bool intersects(const RenderRegion& region)
+    {
+        if (bitmap || baked) return impl.renderer->intersects(impl.rd, region);
+        if (vector) return PAINT(vector)->intersects(region);
+        return false;
+    }
+
     RenderRegion bounds(RenderMethod* renderer)
     {
-        if (vector) return vector->pImpl->bounds(renderer);
+        if (vector && !baked) return vector->pImpl->bounds(renderer);
         return renderer->region(impl.rd);
     }
 
@@ -283,10 +411,24 @@ struct PictureImpl : Picture
 
         this->loader = loader;
 
-        if (!loader->read()) return Result::Unknown;
+        //the size requested in advance is kept, and the image doesn't need to be decoded larger than it
+        if (resizing) loader->hint(w, h);
+
+        if (prefetching) loader->prefetching = true;
+
+        //without the workers the reading blocks here, it's deferred until the first use such as the update
+        if (loader->deferrable && TaskScheduler::threads() == 0) lazy = true;
 
-        this->w = loader->w;
-        this->h = loader->h;
+        //the header is enough for the size, the body is read on the first update
+        if (!lazy) {
+            MemoryScope scope(MemoryCategory::Loader);
+            if (!loader->read()) return Result::Unknown;
+        }
+
+        if (!resizing) {
+            this->w = loader->w;
+            this->h = loader->h;
+        }
 
         impl.mark(RenderUpdateFlag::All);
 
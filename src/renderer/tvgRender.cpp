@@ -134,25 +134,47 @@ void RenderRegion::intersect(const RenderRegion& rhs)
 
 #include <algorithm>
 
+RenderDirtyRegion::~RenderDirtyRegion()
+{
+    delete[](partitions);
+}
+
+
 void RenderDirtyRegion::init(uint32_t w, uint32_t h)
 {
-    auto cnt = int(sqrt(PARTITIONING));
-    auto px = int32_t(w / cnt);
-    auto py = int32_t(h / cnt);
-    auto lx = int32_t(w % cnt);
-    auto ly = int32_t(h % cnt);
-
-    //space partitioning
-    for (int y = 0; y < cnt; ++y) {
-        for (int x = 0; x < cnt; ++x) {
-            auto& partition = partitions[y * cnt + x];
+    //adaptive space partitioning, keep each partition around the tile size
+    auto split = [](uint32_t len) {
+        auto n = int32_t(len / TILE);
+        if (n < MIN_SPLIT) return MIN_SPLIT;
+        if (n > MAX_SPLIT) return MAX_SPLIT;
+        return n;
+    };
+    auto cx = split(w);
+    auto cy = split(h);
+
+    if (uint32_t(cx * cy) != cnt) {
+        delete[](partitions);
+        cnt = cx * cy;
+        partitions = new Partition[cnt];
+    }
+
+    auto px = int32_t(w / cx);
+    auto py = int32_t(h / cy);
+    auto lx = int32_t(w % cx);
+    auto ly = int32_t(h % cy);
+
+    for (int y = 0; y < cy; ++y) {
+        for (int x = 0; x < cx; ++x) {
+            auto& partition = partitions[y * cx + x];
+            partition.list[0].clear();
+            partition.list[1].clear();
             partition.list[0].reserve(64);
             auto& region = partition.region;
             region.min = {x * px, y * py};
             region.max = {region.min.x + px, region.min.y + py};
             //leftovers
-            if (x == cnt -1) region.max.x += lx;
-            if (y == cnt -1) region.max.y += ly;
+            if (x == cx -1) region.max.x += lx;
+            if (y == cy -1) region.max.y += ly;
         }
     }
 }
@@ -160,7 +182,7 @@ void RenderDirtyRegion::init(uint32_t w, uint32_t h)
 
 bool RenderDirtyRegion::add(const RenderRegion& bbox)
 {
-    for (int idx = 0; idx < PARTITIONING; ++idx) {
+    for (uint32_t idx = 0; idx < cnt; ++idx) {
         auto& partition = partitions[idx];
         if (bbox.max.y <= partition.region.min.y) break;
         if (bbox.intersected(partition.region)) {
@@ -176,7 +198,7 @@ bool RenderDirtyRegion::add(const RenderRegion& prv, const RenderRegion& cur)
 {
     if (prv == cur) return add(prv);
 
-    for (int idx = 0; idx < PARTITIONING; ++idx) {
+    for (uint32_t idx = 0; idx < cnt; ++idx) {
         auto& partition = partitions[idx];
         if (prv.intersected(partition.region)) {
             ScopedLock lock(key);
@@ -193,7 +215,7 @@ bool RenderDirtyRegion::add(const RenderRegion& prv, const RenderRegion& cur)
 
 void RenderDirtyRegion::clear()
 {
-    for (int idx = 0; idx < PARTITIONING; ++idx) {
+    for (uint32_t idx = 0; idx < cnt; ++idx) {
         partitions[idx].list[0].clear();
         partitions[idx].list[1].clear();
     }
@@ -256,11 +278,33 @@ void RenderDirtyRegion::subdivide(Array<RenderRegion>& targets, uint32_t idx, Re
 }
 
 
+//merge the scattered regions into their bounding box when it's cheaper to repaint it at once
+void RenderDirtyRegion::coalesce(Array<RenderRegion>& output)
+{
+    //fixed overhead per region (clear, task clipping and raster setup) in pixels
+    static constexpr const int64_t OVERHEAD = 32 * 32;
+
+    if (output.count < 2) return;
+
+    auto bbox = output.first();
+    int64_t area = 0;
+    ARRAY_FOREACH(p, output) {
+        bbox.add(*p);
+        area += int64_t(p->w()) * int64_t(p->h());
+    }
+
+    if (int64_t(bbox.w()) * int64_t(bbox.h()) > area + OVERHEAD * int64_t(output.count)) return;
+
+    output.clear();
+    output.push(bbox);
+}
+
+
 void RenderDirtyRegion::commit()
 {
     if (disabled) return;
 
-    for (int idx = 0; idx < PARTITIONING; ++idx) {
+    for (uint32_t idx = 0; idx < cnt; ++idx) {
         auto current = partitions[idx].current;
         auto& targets = partitions[idx].list[current];
         if (targets.empty()) continue;
@@ -327,6 +371,7 @@ void RenderDirtyRegion::commit()
             if (!merged) output.push(lhs);  //this region is complete isolated
             lhs = {};
         }
+        coalesce(output);
     }
 }
 
@@ -433,7 +478,39 @@ static void _add(const PathCommand* cmds, const Point* pts, const Point& moveTo,
 }
 
 
-static void _trimPath(const PathCommand* inCmds, uint32_t inCmdsCnt, const Point* inPts, TVG_UNUSED uint32_t inPtsCnt, float trimStart, float trimEnd, RenderPath& out, bool connect = false)
+static float _length(const PathCommand* cmds, uint32_t cmdsCnt, const Point* pts, const float* lengths)
+{
+    auto start = pts;
+    auto length = 0.0f;
+
+    for (uint32_t i = 0; i < cmdsCnt; ++i) {
+        switch (cmds[i]) {
+            case PathCommand::Close: {
+                length += tvg::length(pts - 1, start);
+                break;
+            }
+            case PathCommand::MoveTo: {
+                start = pts;
+                ++pts;
+                break;
+            }
+            case PathCommand::LineTo: {
+                length += lengths[i];
+                ++pts;
+                break;
+            }
+            case PathCommand::CubicTo: {
+                length += lengths[i];
+                pts += 3;
+                break;
+            }
+        }
+    }
+    return length;
+}
+
+
+static void _trimPath(const PathCommand* inCmds, uint32_t inCmdsCnt, const Point* inPts, const float* lengths, float trimStart, float trimEnd, RenderPath& out, bool connect = false)
 {
     auto cmds = const_cast<PathCommand*>(inCmds);
     auto pts = const_cast<Point*>(inPts);
@@ -444,8 +521,8 @@ static void _trimPath(const PathCommand* inCmds, uint32_t inCmdsCnt, const Point
     auto _length = [&]() -> float {
         switch (*cmds) {
             case PathCommand::MoveTo: return 0.0f;
-            case PathCommand::LineTo: return tvg::length(pts - 1, pts);
-            case PathCommand::CubicTo: return Bezier{*(pts - 1), *pts, *(pts + 1), *(pts + 2)}.length();
+            case PathCommand::LineTo:
+            case PathCommand::CubicTo: return lengths[cmds - inCmds];
             case PathCommand::Close: return tvg::length(pts - 1, &moveTo);
         }
         return 0.0f;
@@ -502,18 +579,58 @@ static void _trimPath(const PathCommand* inCmds, uint32_t inCmdsCnt, const Point
 }
 
 
-static void _trim(const PathCommand* inCmds, uint32_t inCmdsCnt, const Point* inPts, uint32_t inPtsCnt, float begin, float end, bool connect, RenderPath& out)
+static void _trim(const PathCommand* inCmds, uint32_t inCmdsCnt, const Point* inPts, uint32_t inPtsCnt, const float* lengths, float begin, float end, bool connect, RenderPath& out)
 {
-    auto totalLength = tvg::length(inCmds, inCmdsCnt, inPts, inPtsCnt);
+    auto totalLength = (inPtsCnt < 2) ? 0.0f : _length(inCmds, inCmdsCnt, inPts, lengths);
     auto trimStart = begin * totalLength;
     auto trimEnd = end * totalLength;
 
     if (begin >= end) {
-        _trimPath(inCmds, inCmdsCnt, inPts, inPtsCnt, trimStart, totalLength, out);
-        _trimPath(inCmds, inCmdsCnt, inPts, inPtsCnt, 0.0f, trimEnd, out, connect);
+        _trimPath(inCmds, inCmdsCnt, inPts, lengths, trimStart, totalLength, out);
+        _trimPath(inCmds, inCmdsCnt, inPts, lengths, 0.0f, trimEnd, out, connect);
     } else {
-        _trimPath(inCmds, inCmdsCnt, inPts, inPtsCnt, trimStart, trimEnd, out);
+        _trimPath(inCmds, inCmdsCnt, inPts, lengths, trimStart, trimEnd, out);
+    }
+}
+
+
+const float* RenderTrimPath::Lengths::get(const RenderPath& in)
+{
+    //unchanged path, the trimming values are likely animated only
+    if (in.cmds.count == path.cmds.count && in.pts.count == path.pts.count) {
+        if (!memcmp(in.cmds.data, path.cmds.data, sizeof(PathCommand) * in.cmds.count) && !memcmp(in.pts.data, path.pts.data, sizeof(Point) * in.pts.count)) return data.data;
+    }
+
+    path.cmds = in.cmds;
+    path.pts = in.pts;
+    data.reserve(in.cmds.count);
+    data.count = in.cmds.count;
+
+    auto pts = in.pts.data;
+    for (uint32_t i = 0; i < in.cmds.count; ++i) {
+        switch (in.cmds[i]) {
+            case PathCommand::MoveTo: {
+                data[i] = 0.0f;
+                ++pts;
+                break;
+            }
+            case PathCommand::LineTo: {
+                data[i] = tvg::length(pts - 1, pts);
+                ++pts;
+                break;
+            }
+            case PathCommand::CubicTo: {
+                data[i] = Bezier{*(pts - 1), *pts, *(pts + 1), *(pts + 2)}.length();
+                pts += 3;
+                break;
+            }
+            case PathCommand::Close: {
+                data[i] = 0.0f;
+                break;
+            }
+        }
     }
+    return data.data;
 }
 
 
@@ -544,6 +661,7 @@ bool RenderTrimPath::trim(const RenderPath& in, RenderPath& out) const
     out.cmds.reserve(in.cmds.count * 2);
     out.pts.reserve(in.pts.count * 2);
 
+    auto lengths = this->lengths.get(in);
     auto pts = in.pts.data;
     auto cmds = in.cmds.data;
 
@@ -554,7 +672,7 @@ bool RenderTrimPath::trim(const RenderPath& in, RenderPath& out) const
         while (i < in.cmds.count) {
             switch (in.cmds[i]) {
                 case PathCommand::MoveTo: {
-                    if (startCmds != cmds) _trim(startCmds, cmds - startCmds, startPts, pts - startPts, begin, end, *(cmds - 1) == PathCommand::Close, out);
+                    if (startCmds != cmds) _trim(startCmds, cmds - startCmds, startPts, pts - startPts, lengths + (startCmds - in.cmds.data), begin, end, *(cmds - 1) == PathCommand::Close, out);
                     startPts = pts;
                     startCmds = cmds;
                     ++pts;
@@ -573,7 +691,7 @@ bool RenderTrimPath::trim(const RenderPath& in, RenderPath& out) const
                 }
                 case PathCommand::Close: {
                     ++cmds;
-                    if (startCmds != cmds) _trim(startCmds, cmds - startCmds, startPts, pts - startPts, begin, end, *(cmds - 1) == PathCommand::Close, out);
+                    if (startCmds != cmds) _trim(startCmds, cmds - startCmds, startPts, pts - startPts, lengths + (startCmds - in.cmds.data), begin, end, *(cmds - 1) == PathCommand::Close, out);
                     startPts = pts;
                     startCmds = cmds;
                     break;
@@ -581,9 +699,9 @@ bool RenderTrimPath::trim(const RenderPath& in, RenderPath& out) const
             }
             i++;
         }
-        if (startCmds != cmds) _trim(startCmds, cmds - startCmds, startPts, pts - startPts, begin, end, *(cmds - 1) == PathCommand::Close, out);
+        if (startCmds != cmds) _trim(startCmds, cmds - startCmds, startPts, pts - startPts, lengths + (startCmds - in.cmds.data), begin, end, *(cmds - 1) == PathCommand::Close, out);
     } else {
-        _trim(in.cmds.data, in.cmds.count, in.pts.data, in.pts.count, begin, end, false, out);
+        _trim(in.cmds.data, in.cmds.count, in.pts.data, in.pts.count, lengths, begin, end, false, out);
     }
 
     return out.pts.count >= 2;
@@ -25,10 +25,13 @@
 
 #include <math.h>
 #include <cstdarg>
+#include <atomic>
+#include <chrono>
 #include "tvgCommon.h"
 #include "tvgArray.h"
 #include "tvgLock.h"
 #include "tvgColor.h"
+#include "tvgMath.h"
 
 namespace tvg
 {
@@ -41,7 +44,7 @@ using pixel_t = uint32_t;
 
 //TODO: Separate Color & Opacity for more detailed conditional check
 enum RenderUpdateFlag : uint16_t {None = 0, Path = 1, Color = 2, Gradient = 4, Stroke = 8, Transform = 16, Image = 32, GradientStroke = 64, Blend = 128, Clip = 256, All = 0xffff};
-enum CompositionFlag : uint8_t {Invalid = 0, Opacity = 1, Blending = 2, Masking = 4, PostProcessing = 8};  //Composition Purpose
+enum CompositionFlag : uint8_t {Invalid = 0, Opacity = 1, Blending = 2, Masking = 4, PostProcessing = 8, Caching = 16};  //Composition Purpose
 
 static inline void operator|=(RenderUpdateFlag& a, const RenderUpdateFlag b)
 {
@@ -53,42 +56,6 @@ static inline RenderUpdateFlag operator|(const RenderUpdateFlag a, const RenderU
     return RenderUpdateFlag(uint16_t(a) | uint16_t(b));
 }
 
-struct RenderSurface
-{
-    union {
-        pixel_t* data = nullptr;    //system based data pointer
-        uint32_t* buf32;            //for explicit 32bits channels
-        uint8_t*  buf8;             //for explicit 8bits grayscale
-    };
-    Key key;                        //a reserved lock for the thread safety
-    uint32_t stride = 0;
-    uint32_t w = 0, h = 0;
-    ColorSpace cs = ColorSpace::Unknown;
-    uint8_t channelSize = 0;
-    bool premultiplied = false;         //Alpha-premultiplied
-
-    RenderSurface()
-    {
-    }
-
-    RenderSurface(const RenderSurface* rhs)
-    {
-        data = rhs->data;
-        stride = rhs->stride;
-        w = rhs->w;
-        h = rhs->h;
-        cs = rhs->cs;
-        channelSize = rhs->channelSize;
-        premultiplied = rhs->premultiplied;
-    }
-};
-
-struct RenderCompositor
-{
-    MaskMethod method;
-    uint8_t opacity;
-};
-
 struct RenderRegion
 {
     struct {
@@ -153,12 +120,72 @@ struct RenderRegion
     uint32_t h() const { return (uint32_t) sh(); }
 };
 
+struct RenderSurface
+{
+    union {
+        pixel_t* data = nullptr;    //system based data pointer
+        uint32_t* buf32;            //for explicit 32bits channels
+        uint8_t*  buf8;             //for explicit 8bits grayscale
+    };
+    Key key;                        //a reserved lock for the thread safety
+    uint32_t stride = 0;
+    uint32_t w = 0, h = 0;
+    ColorSpace cs = ColorSpace::Unknown;
+    uint8_t channelSize = 0;
+    bool premultiplied = false;         //Alpha-premultiplied
+    bool native = false;                //data is a texture handle of the gpu engines, not the pixels
+    RenderRegion refreshed{};           //the changed pixels of a picture, given to its preparation only, see Picture::refresh()
+
+    RenderSurface()
+    {
+    }
+
+    RenderSurface(const RenderSurface* rhs)
+    {
+        data = rhs->data;
+        stride = rhs->stride;
+        w = rhs->w;
+        h = rhs->h;
+        cs = rhs->cs;
+        channelSize = rhs->channelSize;
+        premultiplied = rhs->premultiplied;
+        native = rhs->native;
+    }
+};
+
+struct RenderCompositor
+{
+    MaskMethod method;
+    uint8_t opacity;
+};
 
 #ifdef THORVG_PARTIAL_RENDER_SUPPORT
     struct RenderDirtyRegion
     {
     public:
-        static constexpr const int PARTITIONING = 16;   //must be N*N
+        static constexpr const int32_t TILE = 480;      //preferred partition size in pixels
+        static constexpr const int32_t MIN_SPLIT = 4;   //partitions per axis
+        static constexpr const int32_t MAX_SPLIT = 16;  //partitions per axis
+
+        //the damages under the post effects and the compositions, the render data record it in the update
+        struct Scope
+        {
+            RenderRegion extend{};  //expansion by the post effects
+            RenderRegion clip{};    //visible area of the composition, valid if clipping
+            bool clipping = false;
+
+            RenderRegion apply(const RenderRegion& region) const
+            {
+                if (region.invalid()) return region;
+                RenderRegion ret = {{region.min.x + extend.min.x, region.min.y + extend.min.y}, {region.max.x + extend.max.x, region.max.y + extend.max.y}};
+                if (clipping) ret.intersect(clip);
+                return ret;
+            }
+        };
+
+        Scope scope;  //current scope of the updates
+
+        ~RenderDirtyRegion();
 
         void init(uint32_t w, uint32_t h);
         void commit();
@@ -166,6 +193,36 @@ struct RenderRegion
         bool add(const RenderRegion& prv, const RenderRegion& cur);  //collect the old and new dirty regions together
         void clear();
 
+        bool add(const RenderRegion& bbox, const Scope& scope)
+        {
+            return add(scope.apply(bbox));
+        }
+
+        bool add(const RenderRegion& prv, const RenderRegion& cur, const Scope& scope)
+        {
+            return add(scope.apply(prv), scope.apply(cur));
+        }
+
+        //enter the subtree scope, the damages in it spread out by the extend within the clip. returns the former scope.
+        Scope push(const RenderRegion& extend, const RenderRegion* clip)
+        {
+            auto former = scope;
+            if (clip) {
+                scope.clip = former.apply(*clip);
+                scope.clipping = true;
+            }
+            scope.extend.min.x += extend.min.x;
+            scope.extend.min.y += extend.min.y;
+            scope.extend.max.x += extend.max.x;
+            scope.extend.max.y += extend.max.y;
+            return former;
+        }
+
+        void pop(const Scope& former)
+        {
+            scope = former;
+        }
+
         bool deactivate(bool on)
         {
             std::swap(on, disabled);
@@ -177,6 +234,11 @@ struct RenderRegion
             return disabled;
         }
 
+        uint32_t count() const
+        {
+            return cnt;
+        }
+
         const RenderRegion& partition(int idx)
         {
             return partitions[idx].region;
@@ -189,6 +251,7 @@ struct RenderRegion
 
     private:
         void subdivide(Array<RenderRegion>& targets, uint32_t idx, RenderRegion& lhs, RenderRegion& rhs);
+        void coalesce(Array<RenderRegion>& output);
 
         struct Partition
         {
@@ -198,34 +261,138 @@ struct RenderRegion
         };
 
         Key key;
-        Partition partitions[PARTITIONING];
+        Partition* partitions = nullptr;
+        uint32_t cnt = 0;
         bool disabled = false;
     };
 #else
     struct RenderDirtyRegion
     {
-        static constexpr const int PARTITIONING = 16;   //must be N*N
+        struct Scope {};
+        Scope scope;
 
         void init(uint32_t w, uint32_t h) {}
         void commit() {}
         bool add(TVG_UNUSED const RenderRegion& bbox) { return true; }
         bool add(TVG_UNUSED const RenderRegion& prv, TVG_UNUSED const RenderRegion& cur) { return true; }
+        bool add(TVG_UNUSED const RenderRegion& bbox, TVG_UNUSED const Scope& scope) { return true; }
+        bool add(TVG_UNUSED const RenderRegion& prv, TVG_UNUSED const RenderRegion& cur, TVG_UNUSED const Scope& scope) { return true; }
+        Scope push(TVG_UNUSED const RenderRegion& extend, TVG_UNUSED const RenderRegion* clip) { return {}; }
+        void pop(TVG_UNUSED const Scope& former) {}
         void clear() {}
         bool deactivate(TVG_UNUSED bool on) { return true; }
         bool deactivated() { return true; }
+        uint32_t count() const { return 0; }
         const RenderRegion& partition(TVG_UNUSED int idx) { static RenderRegion tmp{}; return tmp; }
         const Array<RenderRegion>& get(TVG_UNUSED int idx) { static Array<RenderRegion> tmp; return tmp; }
     };
 #endif
 
 
+//the path data shared by the duplicates until any of them is changed, see RenderPath::share()
+struct RenderPathData
+{
+    Array<PathCommand> cmds;
+    Array<Point> pts;
+    uint32_t refCnt = 0;
+
+    //the arrays belong to the user, they are handed back by the release callback
+    void (*release)(void* data) = nullptr;
+    void* data = nullptr;
+    bool external = false;
+
+    ~RenderPathData()
+    {
+        if (!external) return;
+        cmds.data = nullptr;
+        pts.data = nullptr;
+        if (release) release(data);
+    }
+};
+
 struct RenderPath
 {
     Array<PathCommand> cmds;
     Array<Point> pts;
+    RenderPathData* shared = nullptr;   //the arrays refer to the shared data, read only
+
+    RenderPath() = default;
+
+    RenderPath(const RenderPath& rhs)
+    {
+        *this = rhs;
+    }
+
+    ~RenderPath()
+    {
+        release();
+    }
+
+    void operator=(const RenderPath& rhs)
+    {
+        if (this == &rhs) return;
+        release();
+        cmds = rhs.cmds;
+        pts = rhs.pts;
+    }
+
+    //both refer to the same data until any of them is changed
+    void share(RenderPath& dup)
+    {
+        dup.release();
+        dup.cmds.reset();
+        dup.pts.reset();
+
+        if (!shared) {
+            shared = new RenderPathData;
+            shared->refCnt = 1;
+            cmds.move(shared->cmds);
+            pts.move(shared->pts);
+            borrow();
+        }
+        ++shared->refCnt;
+        dup.shared = shared;
+        dup.borrow();
+    }
+
+    //refer to the user arrays, read only, until the path is changed
+    void attach(const PathCommand* cmds, uint32_t cmdCnt, const Point* pts, uint32_t ptsCnt, void (*release)(void* data), void* data)
+    {
+        this->release();
+        this->cmds.reset();
+        this->pts.reset();
+
+        shared = new RenderPathData;
+        shared->refCnt = 1;
+        shared->cmds.data = const_cast<PathCommand*>(cmds);
+        shared->cmds.count = shared->cmds.reserved = cmdCnt;
+        shared->pts.data = const_cast<Point*>(pts);
+        shared->pts.count = shared->pts.reserved = ptsCnt;
+        shared->release = release;
+        shared->data = data;
+        shared->external = true;
+        borrow();
+    }
+
+    //the path is about to be changed, take its own data
+    void own()
+    {
+        if (!shared) return;
+        auto data = shared;
+        unborrow();
+        if (data->refCnt == 1 && !data->external) {
+            data->cmds.move(cmds);
+            data->pts.move(pts);
+        } else {
+            cmds = data->cmds;
+            pts = data->pts;
+        }
+        if (--data->refCnt == 0) delete(data);
+    }
 
     void clear()
     {
+        release();
         pts.clear();
         cmds.clear();
     }
@@ -234,23 +401,27 @@ struct RenderPath
     {
         //Don't close multiple times.
         if (cmds.count > 0 && cmds.last() == PathCommand::Close) return;
+        own();
         cmds.push(PathCommand::Close);
     }
 
     void moveTo(const Point& pt)
     {
+        own();
         pts.push(pt);
         cmds.push(PathCommand::MoveTo);
     }
 
     void lineTo(const Point& pt)
     {
+        own();
         pts.push(pt);
         cmds.push(PathCommand::LineTo);
     }
 
     void cubicTo(const Point& cnt1, const Point& cnt2, const Point& end)
     {
+        own();
         pts.push(cnt1);
         pts.push(cnt2);
         pts.push(end);
@@ -258,6 +429,33 @@ struct RenderPath
     }
 
     bool bounds(Matrix* m, float* x, float* y, float* w, float* h);
+
+private:
+    void borrow()
+    {
+        cmds.data = shared->cmds.data;
+        cmds.count = cmds.reserved = shared->cmds.count;
+        pts.data = shared->pts.data;
+        pts.count = pts.reserved = shared->pts.count;
+    }
+
+    void unborrow()
+    {
+        cmds.data = nullptr;
+        cmds.count = cmds.reserved = 0;
+        pts.data = nullptr;
+        pts.count = pts.reserved = 0;
+        shared = nullptr;
+    }
+
+    //drop the shared data, the path becomes empty
+    void release()
+    {
+        if (!shared) return;
+        auto data = shared;
+        unborrow();
+        if (--data->refCnt == 0) delete(data);
+    }
 };
 
 struct RenderTrimPath
@@ -266,6 +464,18 @@ struct RenderTrimPath
     float end = 1.0f;
     bool simultaneous = true;
 
+    //segment lengths of the last trimmed path, they are reused while the path is unchanged
+    struct Lengths
+    {
+        RenderPath path;
+        Array<float> data;   //per command, lineTo and cubicTo only
+
+        Lengths() {}
+        Lengths(const Lengths&) {}
+        void operator=(const Lengths&) {}   //belongs to the trimmed path, not to the trimming values
+        const float* get(const RenderPath& in);
+    } mutable lengths{};
+
     bool valid()
     {
         if (begin != 0.0f || end != 1.0f) return true;
@@ -325,18 +535,45 @@ struct RenderStroke
     }
 };
 
+//the glyphs composing a text path in order, engines could reuse the rasterized glyphs by their ids
+struct RenderGlyphRun
+{
+    struct Glyph
+    {
+        Point offset;              //the glyph origin in the path
+        uint32_t id;               //unique per glyph outline of a font
+        uint32_t cmdCnt, ptsCnt;   //the glyph outline range in the path
+    };
+
+    Array<Glyph> glyphs;
+    float em;                      //the font units per em
+
+    //the path could be modified after the glyphs were placed
+    bool valid(const RenderPath& path) const
+    {
+        uint32_t cmdCnt = 0, ptsCnt = 0;
+        ARRAY_FOREACH(p, glyphs) {
+            cmdCnt += p->cmdCnt;
+            ptsCnt += p->ptsCnt;
+        }
+        return (!glyphs.empty() && cmdCnt == path.cmds.count && ptsCnt == path.pts.count);
+    }
+};
+
 struct RenderShape
 {
     RenderPath path;
     Fill *fill = nullptr;
     RenderColor color{};
     RenderStroke *stroke = nullptr;
+    RenderGlyphRun* glyphs = nullptr;
     FillRule rule = FillRule::NonZero;
 
     ~RenderShape()
     {
         delete(fill);
         delete(stroke);
+        delete(glyphs);
     }
 
     void fillColor(uint8_t* r, uint8_t* g, uint8_t* b, uint8_t* a) const
@@ -421,6 +658,12 @@ struct RenderEffect
     virtual ~RenderEffect() {}
 };
 
+//the per-pixel color replacements, the engines may fuse the consecutive ones
+static inline bool COLOR_EFFECT(SceneEffect type)
+{
+    return type == SceneEffect::Fill || type == SceneEffect::Tint || type == SceneEffect::Tritone;
+}
+
 struct RenderEffectGaussianBlur : RenderEffect
 {
     float sigma;
@@ -526,6 +769,54 @@ struct RenderEffectTritone : RenderEffect
     }
 };
 
+//the statistics of a frame, collected only while the canvas profiling is on
+struct RenderProfile
+{
+    enum Phase : uint8_t {Update = 0, Prepare, PreRender, Raster, Composite, Effect, Sync, Gpu, PhaseCnt};
+    enum Counter : uint8_t {Shapes = 0, Spans, Surfaces, CacheHits, CounterCnt};
+
+    atomic<uint64_t> times[PhaseCnt];       //nanoseconds, the worker threads accumulate them as well
+    atomic<uint32_t> counters[CounterCnt];
+
+    RenderProfile()
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& t : times) t.store(0, memory_order_relaxed);
+        for (auto& c : counters) c.store(0, memory_order_relaxed);
+    }
+
+    void count(Counter counter, uint32_t n = 1)
+    {
+        counters[counter].fetch_add(n, memory_order_relaxed);
+    }
+};
+
+
+//accumulates the scope duration to the phase, nothing without the profile
+struct RenderProfileScope
+{
+    RenderProfile* profile;
+    RenderProfile::Phase phase;
+    chrono::steady_clock::time_point begin;
+
+    RenderProfileScope(RenderProfile* profile, RenderProfile::Phase phase) : profile(profile), phase(phase)
+    {
+        if (profile) begin = chrono::steady_clock::now();
+    }
+
+    ~RenderProfileScope()
+    {
+        if (!profile) return;
+        auto ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin).count();
+        profile->times[phase].fetch_add(uint64_t(ns), memory_order_relaxed);
+    }
+};
+
+
 class RenderMethod
 {
 private:
@@ -536,6 +827,9 @@ protected:
     RenderRegion vport;         //viewport
 
 public:
+    RenderProfile* profile = nullptr;  //valid while the canvas profiling is on
+    float tolerance = FLATNESS_TOLERANCE;  //the curve flattening tolerance in pixels
+
     //common implementation
     uint32_t ref();
     uint32_t unref();
@@ -559,21 +853,40 @@ public:
     virtual const RenderSurface* mainSurface() = 0;
     virtual bool clear() = 0;
     virtual bool sync() = 0;
+    virtual bool detach() { return false; }  //optional, completes the preparations so that the drawing can run on a worker thread
+    virtual bool next() { return false; }  //optional, the banded target draws the scene again for the next band
+    virtual bool occluder(TVG_UNUSED RenderData data, TVG_UNUSED RenderRegion& region) { return false; }  //optional, the region fully covered by the opaque drawing of the data
+    virtual bool intersects(RenderData data, const RenderRegion& region)  //optional, the drawing of the data covers the region, its bounds by default
+    {
+        if (!data) return false;
+        auto bounds = this->region(data);
+        return bounds.valid() && region.intersected(bounds);
+    }
 
     //composition
     virtual RenderCompositor* target(const RenderRegion& region, ColorSpace cs, CompositionFlag flags) = 0;
     virtual bool beginComposite(RenderCompositor* cmp, MaskMethod method, uint8_t opacity) = 0;
     virtual bool endComposite(RenderCompositor* cmp) = 0;
+    virtual bool alphaClip() { return false; }  //optional, the clipping multiplies the coverage, it may replace the alpha masking of an opaque shape
+
+    //retained layers (optional), the engines without the support compose the content every time.
+    virtual RenderCompositor* retain(TVG_UNUSED RenderCompositor* cmp, TVG_UNUSED const RenderRegion& region, TVG_UNUSED ColorSpace cs, TVG_UNUSED CompositionFlag flags) { return nullptr; }
+    virtual bool recall(TVG_UNUSED RenderCompositor* cmp, TVG_UNUSED uint8_t opacity) { return false; }
+    virtual void dispose(TVG_UNUSED RenderCompositor* cmp) {}
 
     //post effects
     virtual void prepare(RenderEffect* effect, const Matrix& transform) = 0;
     virtual bool region(RenderEffect* effect) = 0;
     virtual bool render(RenderCompositor* cmp, const RenderEffect* effect, bool direct) = 0;
+    virtual bool fuse(TVG_UNUSED RenderCompositor* cmp, TVG_UNUSED const RenderEffect* const* effects, TVG_UNUSED uint32_t cnt) { return false; }  //optional, applies the consecutive color effects(Fill, Tint, Tritone) in a single pass
     virtual void dispose(RenderEffect* effect) = 0;
 
     //partial rendering
     virtual void damage(RenderData rd, const RenderRegion& region) = 0;
     virtual bool partial(bool disable) = 0;
+    virtual RenderDirtyRegion::Scope scope(TVG_UNUSED const RenderRegion& extend, TVG_UNUSED const RenderRegion* clip) { return {}; }  //optional, the damages of the following updates spread out by the extend within the clip, returns the former scope
+    virtual void scope(TVG_UNUSED const RenderDirtyRegion::Scope& former) {}  //optional, back to the former scope
+    virtual bool damages(TVG_UNUSED const RenderRegion** regions, TVG_UNUSED uint32_t* cnt) { return false; }  //optional, the regions updated by the last draw
 };
 
 static inline bool MASK_REGION_MERGING(MaskMethod method)
@@ -606,6 +919,8 @@ static inline uint8_t CHANNEL_SIZE(ColorSpace cs)
         case ColorSpace::ARGB8888:
         case ColorSpace::ARGB8888S:
             return sizeof(uint32_t);
+        case ColorSpace::RGB565:
+            return sizeof(uint16_t);
         case ColorSpace::Grayscale8:
             return sizeof(uint8_t);
         case ColorSpace::Unknown:
@@ -629,8 +944,11 @@ static inline ColorSpace MASK_TO_COLORSPACE(RenderMethod* renderer, MaskMethod m
             return ColorSpace::Grayscale8;
         //TODO: Optimize Luma/InvLuma colorspace to Grayscale8
         case MaskMethod::Luma:
-        case MaskMethod::InvLuma:
-            return renderer->colorSpace();
+        case MaskMethod::InvLuma: {
+            //the luma needs the colors which the single channel target doesn't have
+            auto cs = renderer->colorSpace();
+            return (cs == ColorSpace::Grayscale8) ? ColorSpace::ARGB8888 : cs;
+        }
         default:
             TVGERR("RENDERER", "Unsupported Masking Size! = %d", (int)method);
             return ColorSpace::Unknown;
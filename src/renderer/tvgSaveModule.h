@@ -38,6 +38,38 @@ public:
     virtual bool close() = 0;
 };
 
+
+/* Renders the animation frames of the savers in order. With the worker threads, a twin instance of the same file
+   takes turns with the given one, so that the next frame is built while the current one is rasterized. */
+class FramePipeline
+{
+public:
+    FramePipeline(Animation* animation, Paint* bg, uint32_t w, uint32_t h, ColorSpace cs);
+    ~FramePipeline();
+
+    bool valid() const { return stages[0].canvas; }
+    //the frame buffer of no, the next frame to be drawn is prepared meanwhile. damage receives the region changed from the previously drawn frame
+    const uint32_t* draw(float no, float next = -1.0f, RenderRegion* damage = nullptr);
+
+private:
+    struct Stage
+    {
+        SwCanvas* canvas = nullptr;
+        Animation* animation = nullptr;
+        uint32_t* buffer = nullptr;
+        float no = -1.0f;                     //the updated frame waiting for the drawing
+        uint32_t seq = 0;                     //the order of the frame in the buffer, 0 if none
+    };
+
+    Stage stages[2];
+    Animation* twin = nullptr;
+    RenderRegion whole;
+    uint32_t seq = 0;                         //the frames drawn so far
+    uint8_t cur = 0;
+
+    void prepare(Stage& stage, float no);
+};
+
 }
 
 #endif //_TVG_SAVE_MODULE_H_
@@ -21,13 +21,27 @@
  */
 
 #include <cstring>
+#include <atomic>
 #include "tvgCommon.h"
 #include "tvgStr.h"
+#include "tvgMath.h"
+#include "tvgPicture.h"
+#include "tvgFrameModule.h"
+#include "tvgTaskScheduler.h"
 #include "tvgSaveModule.h"
 
 #ifdef THORVG_GIF_SAVER_SUPPORT
     #include "tvgGifSaver.h"
 #endif
+#ifdef THORVG_WEBP_SAVER_SUPPORT
+    #include "tvgWebpSaver.h"
+#endif
+#ifdef THORVG_PNG_SAVER_SUPPORT
+    #include "tvgPngSaver.h"
+#endif
+#ifdef THORVG_LOTTIE_SAVER_SUPPORT
+    #include "tvgLottieSaver.h"
+#endif
 
 /************************************************************************/
 /* Internal Class Implementation                                        */
@@ -46,12 +60,337 @@ struct Saver::Impl
 };
 
 
+//another instance of the animation file which reproduces the same frames
+static Animation* _twin(Animation* animation)
+{
+    auto picture = animation->picture();
+    auto pimpl = PAINT(picture);
+
+    //the attributes which the twin can't follow
+    if (pimpl->clipper || pimpl->maskData || pimpl->blendMethod != BlendMethod::Normal) return nullptr;
+
+    auto loader = PICTURE(picture)->loader;
+    if (!loader || !loader->animatable()) return nullptr;
+    auto origin = static_cast<FrameModule*>(loader)->origin();
+    if (!origin) return nullptr;
+
+    auto twin = Animation::gen();
+    auto dup = twin->picture();
+    if (dup->load(origin) != Result::Success) {
+        delete(twin);
+        return nullptr;
+    }
+
+    float w, h, begin, end;
+    picture->size(&w, &h);
+    dup->size(w, h);
+    dup->transform(picture->transform());
+    dup->opacity(picture->opacity());
+    animation->segment(&begin, &end);
+    twin->segment(begin, end);
+
+    return twin;
+}
+
+
+//the bounding box of the pixels differing between the frames
+static RenderRegion _diff(const uint32_t* a, const uint32_t* b, uint32_t w, uint32_t h)
+{
+    RenderRegion ret = {{int32_t(w), int32_t(h)}, {0, 0}};
+    for (uint32_t y = 0; y < h; ++y, a += w, b += w) {
+        if (!memcmp(a, b, sizeof(uint32_t) * w)) continue;
+        uint32_t l = 0, r = w;
+        while (a[l] == b[l]) ++l;
+        while (a[r - 1] == b[r - 1]) --r;
+        if (int32_t(l) < ret.min.x) ret.min.x = l;
+        if (int32_t(r) > ret.max.x) ret.max.x = r;
+        if (ret.min.y > int32_t(y)) ret.min.y = y;
+        ret.max.y = y + 1;
+    }
+    if (ret.invalid()) ret.reset();
+    return ret;
+}
+
+
+//the bounding box of the regions updated by the last drawing of the canvas
+static RenderRegion _damage(SwCanvas* canvas, const RenderRegion& whole)
+{
+    const int32_t* regions;
+    uint32_t cnt;
+    if (canvas->damages(&regions, &cnt) != Result::Success) return whole;
+
+    RenderRegion ret{};
+    auto list = reinterpret_cast<const RenderRegion*>(regions);
+    for (uint32_t i = 0; i < cnt; ++i) {
+        if (list[i].invalid()) continue;
+        if (ret.valid()) ret.add(list[i]);
+        else ret = list[i];
+    }
+    return ret;
+}
+
+
+FramePipeline::FramePipeline(Animation* animation, Paint* bg, uint32_t w, uint32_t h, ColorSpace cs) : whole{{0, 0}, {int32_t(w), int32_t(h)}}
+{
+    //the builder and the rasterizer run on the different workers, the saver task occupies one of them
+    if (TaskScheduler::threads() > 1) twin = _twin(animation);
+
+    for (uint32_t i = 0; i < (twin ? 2u : 1u); ++i) {
+        auto& stage = stages[i];
+        stage.canvas = SwCanvas::gen();
+        if (!stage.canvas) return;
+        stage.animation = i ? twin : animation;
+        stage.buffer = tvg::malloc<uint32_t*>(sizeof(uint32_t) * w * h);
+        stage.canvas->target(stage.buffer, w, w, h, cs);
+        if (bg) stage.canvas->push(i ? bg->duplicate() : bg);
+        stage.canvas->push(stage.animation->picture());
+    }
+}
+
+
+FramePipeline::~FramePipeline()
+{
+    for (auto& stage : stages) {
+        delete(stage.canvas);
+        tvg::free(stage.buffer);
+    }
+    delete(twin);
+}
+
+
+void FramePipeline::prepare(Stage& stage, float no)
+{
+    stage.animation->frame(no);
+    stage.canvas->update();
+    stage.no = no;
+}
+
+
+const uint32_t* FramePipeline::draw(float no, float next, RenderRegion* damage)
+{
+    auto& stage = stages[cur];
+    auto& other = stages[cur ^ 1];
+    if (stage.no < 0.0f || !tvg::equal(stage.no, no)) prepare(stage, no);
+    stage.no = -1.0f;
+
+    auto drawn = false;
+
+    //the other instance builds the next frame while this one is rasterized
+    if (twin && next >= 0.0f) {
+        auto submitted = (stage.canvas->submit(true) == Result::Success);
+        prepare(other, next);
+        if (submitted) drawn = (stage.canvas->sync() == Result::Success);
+        cur ^= 1;
+    } else if (stage.canvas->draw(true) == Result::Success) {
+        drawn = (stage.canvas->sync() == Result::Success);
+    }
+
+    /* The canvas tracks the changes against its own last frame. If the twin has drawn the previous one,
+       it's still intact in the other buffer since the next frame is only prepared so far. */
+    if (damage) {
+        if (!drawn || seq == 0) *damage = whole;
+        else if (stage.seq == seq) *damage = _damage(stage.canvas, whole);
+        else if (twin && other.seq == seq) *damage = _diff(stage.buffer, other.buffer, whole.max.x, whole.max.y);
+        else *damage = whole;
+    }
+    ++seq;
+    stage.seq = drawn ? seq : 0;
+
+    return stage.buffer;
+}
+
+
+//hands the rendered frames over to the user sink in order, see Saver::save(Animation*, sink, ...)
+class FrameSaver : public SaveModule, public Task
+{
+private:
+    //a frame waiting for the sink, delivered after the previous one
+    struct Slot : Task
+    {
+        FrameSaver* saver;
+        Saver::Frame frame;
+        uint32_t* image = nullptr;
+
+        ~Slot()
+        {
+            done();
+            tvg::free(image);
+        }
+
+        void run(TVG_UNUSED unsigned tid) override
+        {
+            saver->deliver(frame);
+        }
+    };
+
+    Animation* animation = nullptr;
+    Paint* bg = nullptr;
+    bool (*sink)(const Saver::Frame* frame, void* data) = nullptr;
+    void* data = nullptr;
+    float vsize[2] = {0.0f, 0.0f};
+    float fps = 0.0f;
+    uint32_t queue = 0;
+    ColorSpace cs = ColorSpace::ARGB8888;
+    atomic<bool> stopped{false};
+
+    void deliver(const Saver::Frame& frame)
+    {
+        if (stopped.load(memory_order_relaxed)) return;
+        if (!sink(&frame, data)) stopped.store(true, memory_order_relaxed);
+    }
+
+    void run(TVG_UNUSED unsigned tid) override
+    {
+        auto w = static_cast<uint32_t>(vsize[0]);
+        auto h = static_cast<uint32_t>(vsize[1]);
+
+        FramePipeline pipeline(animation, bg, w, h, cs);
+        if (!pipeline.valid()) return;
+
+        //the canvas holds the background now
+        if (bg) bg->unref();
+        bg = nullptr;
+
+        //use the default fps
+        if (fps > 60.0f) fps = 60.0f;   // just in case
+        else if (tvg::zero(fps) || fps < 0.0f) {
+            fps = (animation->totalFrame() / animation->duration());
+        }
+
+        auto delay = (1.0f / fps);
+        auto duration = animation->duration();
+        uint32_t idx = 0;
+
+        /* The sink takes the frames on the other workers while the next ones are rendered, up to the queue size.
+           The rendering waits for the oldest one to be taken beyond that. This worker blocks on them, so one more is necessary to run them. */
+        if (queue > 0 && TaskScheduler::threads() > 1) {
+            auto slots = new Slot[queue];
+            for (uint32_t i = 0; i < queue; ++i) {
+                slots[i].saver = this;
+                slots[i].image = tvg::malloc<uint32_t*>(sizeof(uint32_t) * w * h);
+            }
+
+            Slot* prev = nullptr;
+            for (auto p = 0.0f; p < duration && !stopped.load(memory_order_relaxed); p += delay, ++idx) {
+                auto no = animation->totalFrame() * (p / duration);
+                auto next = (p + delay < duration) ? animation->totalFrame() * ((p + delay) / duration) : -1.0f;
+                RenderRegion damage;
+                auto buffer = pipeline.draw(no, next, &damage);
+
+                auto& slot = slots[idx % queue];
+                slot.done();
+                memcpy(slot.image, buffer, sizeof(uint32_t) * w * h);
+                slot.frame = {slot.image, w, h, idx, no, {damage.min.x, damage.min.y, damage.max.x, damage.max.y}};
+
+                if (prev) {
+                    Task* deps[] = {prev};
+                    TaskScheduler::request(&slot, deps, 1);
+                } else TaskScheduler::request(&slot);
+                prev = &slot;
+            }
+            delete[](slots);
+        //the sink takes the rendered buffer in place
+        } else {
+            for (auto p = 0.0f; p < duration && !stopped.load(memory_order_relaxed); p += delay, ++idx) {
+                auto no = animation->totalFrame() * (p / duration);
+                auto next = (p + delay < duration) ? animation->totalFrame() * ((p + delay) / duration) : -1.0f;
+                RenderRegion damage;
+                auto buffer = pipeline.draw(no, next, &damage);
+                deliver({buffer, w, h, idx, no, {damage.min.x, damage.min.y, damage.max.x, damage.max.y}});
+            }
+        }
+    }
+
+public:
+    ~FrameSaver()
+    {
+        close();
+    }
+
+    bool save(TVG_UNUSED Paint* paint, TVG_UNUSED Paint* bg, TVG_UNUSED const char* filename, TVG_UNUSED uint32_t quality) override
+    {
+        return false;
+    }
+
+    bool save(TVG_UNUSED Animation* animation, TVG_UNUSED Paint* bg, TVG_UNUSED const char* filename, TVG_UNUSED uint32_t quality, TVG_UNUSED uint32_t fps) override
+    {
+        return false;
+    }
+
+    bool save(Animation* animation, Paint* bg, bool (*sink)(const Saver::Frame* frame, void* data), void* data, ColorSpace cs, uint32_t fps, uint32_t queue)
+    {
+        close();
+
+        float x = 0.0f, y = 0.0f;
+        animation->picture()->bounds(&x, &y, &vsize[0], &vsize[1]);
+
+        //cut off the negative space
+        if (x < 0) vsize[0] += x;
+        if (y < 0) vsize[1] += y;
+
+        if (vsize[0] < FLOAT_EPSILON || vsize[1] < FLOAT_EPSILON) {
+            TVGLOG("RENDERER", "Streaming animation(%p) has zero view size.", animation);
+            return false;
+        }
+
+        this->animation = animation;
+
+        if (bg) {
+            bg->ref();
+            this->bg = bg;
+        }
+        this->sink = sink;
+        this->data = data;
+        this->cs = cs;
+        this->fps = static_cast<float>(fps);
+        this->queue = queue;
+        stopped.store(false, memory_order_relaxed);
+
+        TaskScheduler::request(this);
+
+        return true;
+    }
+
+    bool close() override
+    {
+        this->done();
+
+        if (bg) bg->unref();
+        bg = nullptr;
+
+        //animation holds the picture, it must be 1 at the bottom.
+        if (animation && animation->picture()->refCnt() <= 1) delete(animation);
+        animation = nullptr;
+
+        return true;
+    }
+};
+
+
 static SaveModule* _find(FileType type)
 {
     switch(type) {
         case FileType::Gif: {
 #ifdef THORVG_GIF_SAVER_SUPPORT
             return new GifSaver;
+#endif
+            break;
+        }
+        case FileType::Webp: {
+#ifdef THORVG_WEBP_SAVER_SUPPORT
+            return new WebpSaver;
+#endif
+            break;
+        }
+        case FileType::Png: {
+#ifdef THORVG_PNG_SAVER_SUPPORT
+            return new PngSaver;
+#endif
+            break;
+        }
+        case FileType::Lot: {
+#ifdef THORVG_LOTTIE_SAVER_SUPPORT
+            return new LottieSaver;
 #endif
             break;
         }
@@ -67,6 +406,18 @@ static SaveModule* _find(FileType type)
             format = "GIF";
             break;
         }
+        case FileType::Webp: {
+            format = "WEBP";
+            break;
+        }
+        case FileType::Png: {
+            format = "PNG";
+            break;
+        }
+        case FileType::Lot: {
+            format = "TVGLOT";
+            break;
+        }
         default: {
             format = "???";
             break;
@@ -82,6 +433,9 @@ static SaveModule* _find(const char* filename)
 {
     auto ext = fileext(filename);
     if (ext && !strcmp(ext, "gif")) return _find(FileType::Gif);
+    if (ext && !strcmp(ext, "webp")) return _find(FileType::Webp);
+    if (ext && !strcmp(ext, "png")) return _find(FileType::Png);
+    if (ext && !strcmp(ext, "tvglot")) return _find(FileType::Lot);
     return nullptr;
 }
 
@@ -171,6 +525,35 @@ Result Saver::save(Animation* animation, const char* filename, uint32_t quality,
 }
 
 
+Result Saver::save(Animation* animation, bool (*sink)(const Frame* frame, void* data), void* data, ColorSpace cs, uint32_t fps, uint32_t queue) noexcept
+{
+    if (!animation) return Result::InvalidArguments;
+
+    //animation holds the picture, it must be 1 at the bottom.
+    auto remove = animation->picture()->refCnt() <= 1 ? true : false;
+
+    if (!sink || (cs != ColorSpace::ABGR8888 && cs != ColorSpace::ARGB8888 && cs != ColorSpace::ABGR8888S && cs != ColorSpace::ARGB8888S)) {
+        if (remove) delete(animation);
+        return Result::InvalidArguments;
+    }
+
+    //Already on saving another resource.
+    if (tvg::zero(animation->totalFrame()) || pImpl->saveModule) {
+        if (remove) delete(animation);
+        return Result::InsufficientCondition;
+    }
+
+    auto saveModule = new FrameSaver;
+    if (saveModule->save(animation, pImpl->bg, sink, data, cs, fps, queue)) {
+        pImpl->saveModule = saveModule;
+        return Result::Success;
+    }
+    if (remove) delete(animation);
+    delete(saveModule);
+    return Result::Unknown;
+}
+
+
 Result Saver::sync() noexcept
 {
     if (!pImpl->saveModule) return Result::InsufficientCondition;
@@ -65,3 +65,10 @@ Result Scene::push(SceneEffect effect, ...) noexcept
     va_end(args);
     return ret;
 }
+
+
+Result Scene::cache(bool on) noexcept
+{
+    SCENE(this)->caching(on);
+    return Result::Success;
+}
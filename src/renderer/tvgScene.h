@@ -26,6 +26,7 @@
 #include <algorithm>
 #include "tvgMath.h"
 #include "tvgPaint.h"
+#include "tvgSceneIndex.h"
 
 #define SCENE(A) static_cast<SceneImpl*>(A)
 #define CONST_SCENE(A) static_cast<const SceneImpl*>(A)
@@ -65,9 +66,18 @@ struct SceneImpl : Scene
     list<Paint*> paints;     //children list
     RenderRegion vport = {};
     Array<RenderEffect*>* effects = nullptr;
+    SceneIndex* index = nullptr;        //spatial index of the large scene
+    RenderCompositor* cache = nullptr;  //retained rendering result
+    RenderRegion cacheBox = {};         //region of the retained result
+    RenderRegion extend = {};           //expansion by the effects in the last update
+    RenderDirtyRegion::Scope scope;     //damage scope of the ancestors in the last update
     Point fsize;          //fixed scene size
     bool fixed = false;   //true: fixed scene size, false: dynamic size
     bool vdirty = false;
+    bool retain = false;  //keep the rendering result, see Scene::cache()
+    bool cdirty = true;   //the retained result is outdated
+    bool edirty = false;  //the effects have been changed
+    uint32_t revision = 0;  //the count of the children changes, see Picture::paint()
     uint8_t opacity;      //for composition
 
     SceneImpl() : impl(Paint::Impl(this))
@@ -78,6 +88,34 @@ struct SceneImpl : Scene
     {
         clearPaints();
         resetEffects();
+        caching(false);
+    }
+
+    void caching(bool on)
+    {
+        retain = on;
+        cdirty = true;
+        if (on || !cache) return;
+        if (impl.renderer) impl.renderer->dispose(cache);
+        cache = nullptr;
+    }
+
+    //any changes in the subtree since the last update?
+    static bool changed(const Paint* paint)
+    {
+        auto pimpl = PAINT(paint);
+        if (pimpl->renderFlag) return true;
+        if (pimpl->clipper && changed(pimpl->clipper)) return true;
+        if (pimpl->maskData && changed(pimpl->maskData->target)) return true;
+
+        auto ret = false;
+        if (auto it = pimpl->iterator()) {
+            while (auto child = it->next()) {
+                if ((ret = changed(child))) break;
+            }
+            delete(it);
+        }
+        return ret;
     }
 
     void size(const Point& size)
@@ -94,6 +132,7 @@ struct SceneImpl : Scene
         if (effects) impl.mark(CompositionFlag::PostProcessing);
         if (PAINT(this)->mask(nullptr) != MaskMethod::None) impl.mark(CompositionFlag::Masking);
         if (impl.blendMethod != BlendMethod::Normal) impl.mark(CompositionFlag::Blending);
+        if (retain) impl.mark(CompositionFlag::Caching);
 
         //Half translucent requires intermediate composition.
         if (opacity == 255) return impl.cmpFlag;
@@ -114,10 +153,35 @@ struct SceneImpl : Scene
         return false;
     }
 
+    //the retained result, the effects and the spatial index are bound to the leaving renderer
+    RenderUpdateFlag retarget()
+    {
+        if (cache) {
+            impl.renderer->dispose(cache);
+            cache = nullptr;
+        }
+        cdirty = true;
+
+        if (effects) {
+            ARRAY_FOREACH(p, *effects) impl.renderer->dispose(*p);
+        }
+
+        delete(index);
+        index = nullptr;
+
+        return RenderUpdateFlag::None;
+    }
+
     bool update(RenderMethod* renderer, const Matrix& transform, Array<RenderData>& clips, uint8_t opacity, RenderUpdateFlag flag, TVG_UNUSED bool clipper)
     {
         if (paints.empty()) return true;
 
+        if (retain && !cdirty && flag == RenderUpdateFlag::None) {
+            for (auto paint : paints) {
+                if ((cdirty = changed(paint))) break;
+            }
+        } else cdirty = true;
+
         if (needComposition(opacity)) {
             /* Overriding opacity value. If this scene is half-translucent,
                It must do intermediate composition with that opacity value. */
@@ -128,19 +192,50 @@ struct SceneImpl : Scene
         //allow partial rendering?
         auto recover = fixed ? renderer->partial(true) : false;
 
-        for (auto paint : paints) {
-            PAINT(paint)->update(renderer, transform, clips, opacity, flag, false);
+        //the damages of the children spread out by the post effects
+        auto spread = true;
+        RenderRegion extend{};
+        if (effects) {
+            ARRAY_FOREACH(p, *effects) {
+                auto effect = *p;
+                renderer->prepare(effect, transform);
+                if (!effect->valid || !renderer->region(effect)) continue;
+                extend.min.x += effect->extend.min.x;
+                extend.min.y += effect->extend.min.y;
+                extend.max.x += effect->extend.max.x;
+                extend.max.y += effect->extend.max.y;
+                //the wrapped blur carries the damages to the opposite side
+                if (effect->type == SceneEffect::GaussianBlur && static_cast<RenderEffectGaussianBlur*>(effect)->border == 1) spread = false;
+            }
+        }
+        //the changed effects alter the whole drawing, the children take over the new spread
+        if (edirty || !(extend == this->extend)) {
+            spread = false;
+            flag |= RenderUpdateFlag::Blend;
         }
+        edirty = false;
+        this->extend = extend;
 
-        //recover the condition
-        if (fixed) renderer->partial(recover);
+        scope = renderer->scope(extend, nullptr);
 
-        if (effects) {
-            ARRAY_FOREACH(p, *effects) {
-                renderer->prepare(*p, transform);
+        //the large scene visits the children in the viewport only
+        if (!index && paints.size() >= SceneIndex::THRESHOLD) index = new SceneIndex;
+        else if (index && paints.size() < SceneIndex::THRESHOLD / 2) {
+            delete(index);
+            index = nullptr;
+        }
+
+        if (index) index->update(renderer, paints, transform, clips, opacity, flag);
+        else {
+            for (auto paint : paints) {
+                PAINT(paint)->update(renderer, transform, clips, opacity, flag, false);
             }
         }
 
+        //recover the condition
+        renderer->scope(scope);
+        if (fixed) renderer->partial(recover);
+
         //this viewport update is more performant than in bounds(). No idea.
         vport = renderer->viewport();
 
@@ -151,13 +246,27 @@ struct SceneImpl : Scene
             vdirty = true;
         }
 
-        //bounds(renderer) here hinders parallelization
-        //TODO: we can bring the precise effects region here
-        if (fixed || effects) impl.damage(vport);
+        //bounds(renderer) here hinders parallelization, the damages of the children were spread out by the effects instead
+        if (fixed || !spread) impl.damage(vport);
 
         return true;
     }
 
+    bool intersects(const RenderRegion& region)
+    {
+        //the index tells the children drawn by the last update
+        if (index) {
+            ARRAY_FOREACH(p, index->visible) {
+                if (PAINT((*p))->intersects(region)) return true;
+            }
+        } else {
+            for (auto paint : paints) {
+                if (PAINT(paint)->intersects(region)) return true;
+            }
+        }
+        return false;
+    }
+
     bool render(RenderMethod* renderer)
     {
         if (paints.empty()) return true;
@@ -167,21 +276,49 @@ struct SceneImpl : Scene
 
         renderer->blend(impl.blendMethod);
 
-        if (impl.cmpFlag) {
-            cmp = renderer->target(bounds(renderer), renderer->colorSpace(), impl.cmpFlag);
-            renderer->beginComposite(cmp, MaskMethod::None, opacity);
+        //reuse the retained result or render it again
+        if (impl.marked(CompositionFlag::Caching)) {
+            auto region = bounds(renderer);
+            if (!cdirty && region == cacheBox && renderer->recall(cache, opacity)) return true;
+            if (auto p = renderer->retain(cache, region, renderer->colorSpace(), impl.cmpFlag)) {
+                cmp = cache = p;
+                cacheBox = region;
+                cdirty = false;
+            }
         }
 
-        for (auto paint : paints) {
-            ret &= paint->pImpl->render(renderer);
+        if (!cmp && impl.cmpFlag) cmp = renderer->target(bounds(renderer), renderer->colorSpace(), impl.cmpFlag);
+        if (cmp) renderer->beginComposite(cmp, MaskMethod::None, opacity);
+
+        auto draw = [&](Paint* paint) {
+            if (PAINT(paint)->hidden) PAINT(paint)->hidden = false;
+            else ret &= paint->pImpl->render(renderer);
+        };
+
+        occlude(renderer);
+
+        if (index) {
+            ARRAY_FOREACH(p, index->visible) draw(*p);
+        } else {
+            for (auto paint : paints) draw(paint);
         }
 
         if (cmp) {
             //Apply post effects if any.
             if (effects) {
                 //Notify the possiblity of the direct composition of the effect result to the origin surface.
-                auto direct = (effects->count == 1) & (impl.marked(CompositionFlag::PostProcessing));
-                ARRAY_FOREACH(p, *effects) {
+                //The retained layer must keep the effect result for the next drawings.
+                auto direct = (effects->count == 1) & (impl.marked(CompositionFlag::PostProcessing)) & (cmp != cache);
+                for (auto p = effects->begin(); p < effects->end(); ++p) {
+                    //the run of the color effects goes through the surface once
+                    if (!direct && COLOR_EFFECT((*p)->type)) {
+                        auto q = p + 1;
+                        while (q < effects->end() && COLOR_EFFECT((*q)->type)) ++q;
+                        if (q - p > 1 && renderer->fuse(cmp, p, uint32_t(q - p))) {
+                            p = q - 1;
+                            continue;
+                        }
+                    }
                     if ((*p)->valid) renderer->render(cmp, *p, direct);
                 }
             }
@@ -191,6 +328,37 @@ struct SceneImpl : Scene
         return ret;
     }
 
+    /* Front-to-back occlusion: the children entirely hidden under the later opaque shapes
+       are marked to be skipped in the current drawing. A few occluders are enough for the UI-like
+       scenes (backgrounds, cards), the children before the first occluder cost nothing. */
+    void occlude(RenderMethod* renderer)
+    {
+        static constexpr uint32_t OCCLUDERS = 8;
+        RenderRegion occluders[OCCLUDERS];
+        uint32_t cnt = 0;
+
+        auto check = [&](Paint* paint) {
+            auto p = PAINT(paint);
+            if (p->opacity == 0) return;
+            if (cnt > 0) {
+                auto region = p->bounds(renderer);
+                for (uint32_t i = 0; i < cnt; ++i) {
+                    if (region.valid() && occluders[i].contained(region)) {
+                        p->hidden = true;
+                        return;
+                    }
+                }
+            }
+            if (cnt < OCCLUDERS && p->occluder(renderer, occluders[cnt])) ++cnt;
+        };
+
+        if (index) {
+            for (auto p = index->visible.end(); p > index->visible.begin();) check(*--p);
+        } else {
+            for (auto p = paints.rbegin(); p != paints.rend(); ++p) check(*p);
+        }
+    }
+
     RenderRegion bounds(RenderMethod* renderer)
     {
         if (paints.empty()) return {};
@@ -199,12 +367,19 @@ struct SceneImpl : Scene
 
         //Merge regions
         RenderRegion pRegion = {{INT32_MAX, INT32_MAX}, {0, 0}};
-        for (auto paint : paints) {
+        auto merge = [&](const Paint* paint) {
             auto region = paint->pImpl->bounds(renderer);
             if (region.min.x < pRegion.min.x) pRegion.min.x = region.min.x;
             if (pRegion.max.x < region.max.x) pRegion.max.x = region.max.x;
             if (region.min.y < pRegion.min.y) pRegion.min.y = region.min.y;
             if (pRegion.max.y < region.max.y) pRegion.max.y = region.max.y;
+        };
+
+        //the culled out children have no regions
+        if (index) {
+            ARRAY_FOREACH(p, index->visible) merge(*p);
+        } else {
+            for (auto paint : paints) merge(paint);
         }
 
         //Extends the render region if post effects require
@@ -310,8 +485,31 @@ struct SceneImpl : Scene
         return scene;
     }
 
+    //damage the region in the scope of the last update, the ancestor effects spread it out
+    void damage(const RenderRegion& region)
+    {
+        auto renderer = impl.renderer;
+        if (!renderer) return;
+        auto cur = renderer->scope({}, nullptr);
+        renderer->scope(scope);
+        impl.damage(region);
+        renderer->scope(cur);
+    }
+
+    //damage the child region, the render data of the child keeps its own scope
+    void damage(Paint* paint)
+    {
+        if (paint->type() == Type::Scene) {
+            auto renderer = PAINT(paint)->renderer;
+            if (renderer) SCENE(paint)->damage(PAINT(paint)->bounds(renderer));
+        } else PAINT(paint)->damage();
+    }
+
     Result clearPaints()
     {
+        delete(index);
+        index = nullptr;
+
         if (paints.empty()) return Result::Success;
 
         //Don't need to damage for children
@@ -322,12 +520,15 @@ struct SceneImpl : Scene
         while (itr != paints.end()) {
             auto paint = PAINT((*itr));
             //when the paint is destroyed damage will be triggered
-            if (paint->refCnt > 1 && partialDmg) paint->damage();
+            if (paint->refCnt > 1 && partialDmg) damage(*itr);
             paint->unref();
             paints.erase(itr++);
         }
+        ++revision;
+        cdirty = true;
+        impl.unbound();
         if (fixed && impl.renderer) impl.renderer->partial(recover);
-        if (effects || fixed) impl.damage(vport);  //redraw scene full region
+        if (effects || fixed) damage(vport);  //redraw scene full region
 
         return Result::Success;
     }
@@ -335,16 +536,42 @@ struct SceneImpl : Scene
     Result remove(Paint* paint)
     {
         if (PAINT(paint)->parent != this) return Result::InsufficientCondition;
+        remove(find(paints.begin(), paints.end(), paint));
+        return Result::Success;
+    }
+
+    //remove the child at the position without searching, returns the next position
+    list<Paint*>::iterator remove(list<Paint*>::iterator itr)
+    {
+        auto paint = *itr;
         //when the paint is destroyed damage will be triggered
-        if (PAINT(paint)->refCnt > 1) PAINT(paint)->damage();
+        if (PAINT(paint)->refCnt > 1) damage(paint);
+        //the effects spread out its drawing, redraw the scene region
+        if (effects) damage(vport);
+        if (index) index->remove(paint);
         PAINT(paint)->unref();
-        paints.remove(paint);
-        return Result::Success;
+        ++revision;
+        cdirty = true;
+        impl.unbound();
+        return paints.erase(itr);
     }
 
     Result insert(Paint* target, Paint* at)
     {
         if (!target) return Result::InvalidArguments;
+        if (PAINT(target)->parent) return Result::InsufficientCondition;
+
+        if (!at) return insert(target, paints.end());
+
+        //OPTIMIZE: Remove searching?
+        auto itr = find_if(paints.begin(), paints.end(),[&at](const Paint* paint){ return at == paint; });
+        if (itr == paints.end()) return Result::InvalidArguments;
+        return insert(target, itr);
+    }
+
+    //insert the child before the position without searching
+    Result insert(Paint* target, list<Paint*>::iterator itr)
+    {
         auto timpl = PAINT(target);
         if (timpl->parent) return Result::InsufficientCondition;
 
@@ -353,15 +580,12 @@ struct SceneImpl : Scene
         //Relocated the paint to the current scene space
         timpl->mark(RenderUpdateFlag::Transform);
 
-        if (!at) {
-            paints.push_back(target);
-        } else {
-            //OPTIMIZE: Remove searching?
-            auto itr = find_if(paints.begin(), paints.end(),[&at](const Paint* paint){ return at == paint; });
-            if (itr == paints.end()) return Result::InvalidArguments;
-            paints.insert(itr, target);
-        }
+        auto last = (itr == paints.end());
+        paints.insert(itr, target);
+        ++revision;
         timpl->parent = this;
+        impl.unbound();
+        if (index) index->add(target, last);
         if (timpl->clipper) PAINT(timpl->clipper)->parent = this;
         if (timpl->maskData) PAINT(timpl->maskData->target)->parent = this;
         return Result::Success;
@@ -374,7 +598,9 @@ struct SceneImpl : Scene
 
     Result resetEffects()
     {
+        cdirty = true;
         if (effects) {
+            edirty = true;
             ARRAY_FOREACH(p, *effects) {
                 if (impl.renderer) impl.renderer->dispose(*p);
                 delete(*p);
@@ -420,6 +646,7 @@ struct SceneImpl : Scene
         if (!re) return Result::InvalidArguments;
 
         this->effects->push(re);
+        cdirty = edirty = true;
 
         return Result::Success;
     }
@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include "tvgMath.h"
+#include "tvgSceneIndex.h"
+#include "tvgShape.h"
+
+/************************************************************************/
+/* Internal Class Implementation                                        */
+/************************************************************************/
+
+static inline float _norm(const Matrix& m)
+{
+    //the upper bound of the scale factor in any direction
+    return sqrtf(m.e11 * m.e11 + m.e12 * m.e12 + m.e21 * m.e21 + m.e22 * m.e22);
+}
+
+
+static bool _outside(const SceneIndex::Node& node, const Matrix& m, const RenderRegion& vport, float scale)
+{
+    Point pt[4] = {node.min, {node.max.x, node.min.y}, node.max, {node.min.x, node.max.y}};
+    auto min = pt[0] * m;
+    auto max = min;
+    for (int i = 1; i < 4; ++i) {
+        auto p = pt[i] * m;
+        if (p.x < min.x) min.x = p.x;
+        if (p.y < min.y) min.y = p.y;
+        if (p.x > max.x) max.x = p.x;
+        if (p.y > max.y) max.y = p.y;
+    }
+    //plus the antialiasing
+    auto margin = node.reach * scale + 1.0f;
+    return (max.x + margin < float(vport.min.x) || min.x - margin > float(vport.max.x) || max.y + margin < float(vport.min.y) || min.y - margin > float(vport.max.y));
+}
+
+
+/************************************************************************/
+/* External Class Implementation                                        */
+/************************************************************************/
+
+SceneIndex::~SceneIndex()
+{
+    if (!nodes.empty()) flush(0, RenderUpdateFlag::None);
+    release();
+}
+
+
+void SceneIndex::release()
+{
+    ARRAY_FOREACH(p, entries) {
+        if (p->paint) PAINT(p->paint)->indexed = 0;
+    }
+}
+
+
+void SceneIndex::touch(uint32_t idx)
+{
+    auto& entry = entries[idx];
+    if (entry.touched) return;
+    entry.touched = true;
+    touched.push(idx);
+}
+
+
+void SceneIndex::add(Paint* paint, bool last)
+{
+    //the children in the middle shuffle the drawing orders
+    if (!last || dirty) {
+        dirty = true;
+        return;
+    }
+    others.push({paint, {}, {}, 0.0f, order++, 0, RenderUpdateFlag::None, false});
+    if (++appended > entries.count / 8 + LEAF_SIZE) dirty = true;
+}
+
+
+void SceneIndex::remove(Paint* paint)
+{
+    if (auto idx = PAINT(paint)->indexed) {
+        entries[idx - 1].paint = nullptr;
+        PAINT(paint)->indexed = 0;
+    } else {
+        for (auto p = others.begin(); p < others.end(); ++p) {
+            if (p->paint != paint) continue;
+            p->paint = nullptr;
+            break;
+        }
+    }
+    if (++removed > (entries.count + others.count) / 2) dirty = true;
+
+    //the last drawings may refer to it before the next update
+    for (auto p = visible.begin(); p < visible.end(); ++p) {
+        if (*p != paint) continue;
+        for (auto q = p + 1; q < visible.end(); ++q) *(q - 1) = *q;
+        visible.pop();
+        break;
+    }
+}
+
+
+//the conservative scene space bounds of the shape, false if it's not a plain shape
+bool SceneIndex::bounds(Entry& entry)
+{
+    auto paint = entry.paint;
+    if (paint->type() != Type::Shape || PAINT(paint)->clipper || PAINT(paint)->maskData) return false;
+
+    auto shape = SHAPE(paint);
+    auto& m = PAINT(paint)->transform();
+    float x, y, w, h;
+
+    //no path, no culling
+    if (!shape->rs.path.bounds(&m, &x, &y, &w, &h)) {
+        entry.min = entry.max = {0.0f, 0.0f};
+        entry.reach = INFINITY;
+        return true;
+    }
+
+    entry.min = {x, y};
+    entry.max = {x + w, y + h};
+    entry.reach = 0.0f;
+
+    //stroke with the longest miter or the square caps, see ShapeImpl::culled()
+    if (auto stroke = shape->rs.stroke) {
+        auto reach = (stroke->join == StrokeJoin::Miter) ? std::max(stroke->miterlimit, 1.5f) : 1.5f;
+        if (stroke->width > 0.0f) entry.reach = stroke->width * 0.5f * reach * _norm(m);
+    }
+    return true;
+}
+
+
+void SceneIndex::refit(Entry& entry)
+{
+    if (!bounds(entry)) {
+        dirty = true;
+        return;
+    }
+
+    //the bounds only grow until the next build, the shape's nodes must be visited again
+    auto idx = entry.node;
+    while (true) {
+        auto& node = nodes[idx];
+        if (entry.min.x < node.min.x) node.min.x = entry.min.x;
+        if (entry.min.y < node.min.y) node.min.y = entry.min.y;
+        if (entry.max.x > node.max.x) node.max.x = entry.max.x;
+        if (entry.max.y > node.max.y) node.max.y = entry.max.y;
+        if (entry.reach > node.reach) node.reach = entry.reach;
+        node.dormant = false;
+        if (idx == 0) break;
+        idx = node.parent;
+    }
+
+    if (++refits > entries.count) dirty = true;
+}
+
+
+void SceneIndex::flush(uint32_t idx, RenderUpdateFlag flag)
+{
+    auto& node = nodes[idx];
+    flag |= node.pending;
+    node.pending = RenderUpdateFlag::None;
+
+    if (node.leaf) {
+        if (flag == RenderUpdateFlag::None) return;
+        for (auto p = entries.begin() + node.begin; p < entries.begin() + node.end; ++p) {
+            if (p->paint) SHAPE(p->paint)->pending |= flag;
+        }
+        return;
+    }
+    flush(node.begin, flag);
+    flush(node.end, flag);
+}
+
+
+uint32_t SceneIndex::build(uint32_t begin, uint32_t end, uint32_t parent)
+{
+    auto idx = nodes.count;
+    nodes.next();
+
+    Point min = {FLT_MAX, FLT_MAX}, max = {-FLT_MAX, -FLT_MAX};
+    auto reach = 0.0f;
+    for (auto p = entries.begin() + begin; p < entries.begin() + end; ++p) {
+        if (p->min.x < min.x) min.x = p->min.x;
+        if (p->min.y < min.y) min.y = p->min.y;
+        if (p->max.x > max.x) max.x = p->max.x;
+        if (p->max.y > max.y) max.y = p->max.y;
+        if (p->reach > reach) reach = p->reach;
+    }
+
+    auto leaf = (end - begin) <= LEAF_SIZE;
+
+    if (leaf) {
+        for (auto i = begin; i < end; ++i) entries[i].node = idx;
+    } else {
+        //median split along the longer axis
+        auto mid = begin + (end - begin) / 2;
+        auto first = entries.begin() + begin;
+        if (max.x - min.x > max.y - min.y) {
+            std::nth_element(first, entries.begin() + mid, entries.begin() + end, [](const Entry& a, const Entry& b) { return a.min.x + a.max.x < b.min.x + b.max.x; });
+        } else {
+            std::nth_element(first, entries.begin() + mid, entries.begin() + end, [](const Entry& a, const Entry& b) { return a.min.y + a.max.y < b.min.y + b.max.y; });
+        }
+        begin = build(begin, mid, idx);
+        end = build(mid, end, idx);
+    }
+
+    nodes[idx] = {min, max, reach, parent, begin, end, RenderUpdateFlag::None, leaf, false, false};
+    return idx;
+}
+
+
+void SceneIndex::build(const list<Paint*>& paints)
+{
+    //hand over the held flags to the shapes
+    if (!nodes.empty()) flush(0, RenderUpdateFlag::None);
+    release();
+
+    entries.clear();
+    others.clear();
+    nodes.clear();
+    touched.clear();
+    order = appended = removed = refits = 0;
+
+    for (auto paint : paints) {
+        Entry entry = {paint, {}, {}, 0.0f, order++, 0, RenderUpdateFlag::None, false};
+        if (bounds(entry)) entries.push(entry);
+        else others.push(entry);
+    }
+
+    if (!entries.empty()) {
+        nodes.reserve(2 * (entries.count / LEAF_SIZE + 1));
+        build(0, entries.count, 0);
+    }
+
+    for (uint32_t i = 0; i < entries.count; ++i) {
+        PAINT(entries[i].paint)->indexed = i + 1;
+    }
+
+    dirty = false;
+}
+
+
+void SceneIndex::collect(uint32_t idx, RenderUpdateFlag pending, const Matrix& transform, const RenderRegion& vport, float scale, RenderUpdateFlag flag)
+{
+    auto& node = nodes[idx];
+    node.pending |= pending;
+
+    //still culled out, hold the flags for the next visit
+    if (node.dormant && _outside(node, transform, vport, scale)) {
+        node.pending |= flag;
+        return;
+    }
+
+    pending = node.pending;
+    node.pending = RenderUpdateFlag::None;
+    node.visited = true;
+    if (pending) held = true;
+
+    if (node.leaf) {
+        for (auto p = entries.begin() + node.begin; p < entries.begin() + node.end; ++p) {
+            if (!p->paint) continue;
+            p->pending = pending;
+            drawings.push(p);
+        }
+        return;
+    }
+    collect(node.begin, pending, transform, vport, scale, flag);
+    collect(node.end, pending, transform, vport, scale, flag);
+}
+
+
+bool SceneIndex::settle(uint32_t idx)
+{
+    auto& node = nodes[idx];
+    if (!node.visited) return node.dormant;
+    node.visited = false;
+
+    if (node.leaf) {
+        node.dormant = true;
+        for (auto p = entries.begin() + node.begin; p < entries.begin() + node.end; ++p) {
+            if (p->paint && !SHAPE(p->paint)->dormant) {
+                node.dormant = false;
+                break;
+            }
+        }
+        return node.dormant;
+    }
+    auto left = settle(node.begin);
+    auto right = settle(node.end);
+    return (node.dormant = left && right);
+}
+
+
+void SceneIndex::update(RenderMethod* renderer, const list<Paint*>& paints, const Matrix& transform, Array<RenderData>& clips, uint8_t opacity, RenderUpdateFlag flag)
+{
+    //the changed shapes could move into the viewport
+    ARRAY_FOREACH(p, touched) {
+        auto& entry = entries[*p];
+        entry.touched = false;
+        if (entry.paint && !dirty) refit(entry);
+    }
+    touched.clear();
+
+    if (dirty) build(paints);
+
+    //the children to be updated
+    drawings.clear();
+    held = false;
+    ARRAY_FOREACH(p, others) {
+        if (p->paint) drawings.push(p);
+    }
+    if (!nodes.empty()) collect(0, RenderUpdateFlag::None, transform, renderer->viewport(), _norm(transform), flag);
+
+    visible.clear();
+    visible.reserve(drawings.count);
+
+    /* update them in the drawing order, not in the spatial order,
+       the engines allocate the render data along and draw them in the drawing order. */
+    if (drawings.count == paints.size()) {
+        //nothing is skipped, take the order of the scene as it is
+        for (auto paint : paints) {
+            auto idx = PAINT(paint)->indexed;
+            PAINT(paint)->update(renderer, transform, clips, opacity, (idx && held) ? (flag | entries[idx - 1].pending) : flag, false);
+            if (!idx || !SHAPE(paint)->dormant) visible.push(paint);
+        }
+    } else {
+        std::sort(drawings.begin(), drawings.end(), [](const Entry* a, const Entry* b) { return a->order < b->order; });
+        ARRAY_FOREACH(p, drawings) {
+            auto paint = (*p)->paint;
+            PAINT(paint)->update(renderer, transform, clips, opacity, flag | (*p)->pending, false);
+            if (!PAINT(paint)->indexed || !SHAPE(paint)->dormant) visible.push(paint);
+        }
+    }
+
+    if (!nodes.empty()) settle(0);
+}
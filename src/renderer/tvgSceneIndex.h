@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _TVG_SCENE_INDEX_H_
+#define _TVG_SCENE_INDEX_H_
+
+#include "tvgCommon.h"
+#include "tvgRender.h"
+
+/* Bounding volume hierarchy over the plain shapes(no clipper, no mask) of a large scene.
+   The subtrees out of the viewport whose shapes are all culled already are not visited at all,
+   their update flags are held in the nodes and handed over once they are visited again.
+   The other children are updated in the drawing order every update. See SceneImpl::update() */
+
+struct SceneIndex
+{
+    static constexpr uint32_t THRESHOLD = 256;    //minimum children count to build the index
+    static constexpr uint32_t LEAF_SIZE = 8;      //shapes per leaf node
+
+    struct Entry
+    {
+        Paint* paint;         //nullptr if removed
+        Point min, max;       //scene space bounds of the path
+        float reach;          //the stroke reach in the scene space
+        uint32_t order;       //drawing order in the scene
+        uint32_t node;        //owner leaf node
+        RenderUpdateFlag pending;   //the held flags handed over in the current update
+        bool touched;         //changed since the last update
+    };
+
+    struct Node
+    {
+        Point min, max;
+        float reach;
+        uint32_t parent;
+        uint32_t begin, end;  //entries if leaf, otherwise the child nodes
+        RenderUpdateFlag pending;   //the update flags held for the dormant shapes
+        bool leaf;
+        bool dormant;         //all shapes are culled already
+        bool visited;         //visited in the current update
+    };
+
+    Array<Entry> entries;     //indexed shapes, ordered by the nodes
+    Array<Entry> others;      //the children out of the index
+    Array<Node> nodes;
+    Array<uint32_t> touched;  //entries to be refit
+    Array<Entry*> drawings;   //the children to be updated in the drawing order
+    Array<Paint*> visible;    //the children to be drawn of the last update in the drawing order
+    uint32_t order = 0;       //next drawing order
+    uint32_t appended = 0;    //children appended since the build
+    uint32_t removed = 0;     //removed entries
+    uint32_t refits = 0;      //refit count since the build
+    bool dirty = true;        //rebuild required
+    bool held = false;        //any held flags are handed over in the current update
+
+    ~SceneIndex();
+
+    void touch(uint32_t idx);
+    void add(Paint* paint, bool last);
+    void remove(Paint* paint);
+    void update(RenderMethod* renderer, const list<Paint*>& paints, const Matrix& transform, Array<RenderData>& clips, uint8_t opacity, RenderUpdateFlag flag);
+
+private:
+    void build(const list<Paint*>& paints);
+    uint32_t build(uint32_t begin, uint32_t end, uint32_t parent);
+    void flush(uint32_t idx, RenderUpdateFlag flag);
+    bool bounds(Entry& entry);
+    void refit(Entry& entry);
+    void collect(uint32_t idx, RenderUpdateFlag pending, const Matrix& transform, const RenderRegion& vport, float scale, RenderUpdateFlag flag);
+    bool settle(uint32_t idx);
+    void release();
+};
+
+#endif //_TVG_SCENE_INDEX_H_
@@ -58,12 +58,24 @@ Result Shape::path(const PathCommand** cmds, uint32_t* cmdsCnt, const Point** pt
 }
 
 
+Result Shape::points(const Point* pts, uint32_t begin, uint32_t cnt) noexcept
+{
+    return SHAPE(this)->points(pts, begin, cnt);
+}
+
+
 Result Shape::appendPath(const PathCommand *cmds, uint32_t cmdCnt, const Point* pts, uint32_t ptsCnt) noexcept
 {
     return SHAPE(this)->appendPath(cmds, cmdCnt, pts, ptsCnt);
 }
 
 
+Result Shape::attachPath(const PathCommand *cmds, uint32_t cmdCnt, const Point* pts, uint32_t ptsCnt, void (*release)(void* data), void* data) noexcept
+{
+    return SHAPE(this)->attachPath(cmds, cmdCnt, pts, ptsCnt, release, data);
+}
+
+
 Result Shape::moveTo(float x, float y) noexcept
 {
     SHAPE(this)->rs.path.moveTo({x, y});
@@ -34,15 +34,26 @@ struct ShapeImpl : Shape
 {
     Paint::Impl impl;
     RenderShape rs;
+    Point local[2];     //path bounds(min, max) for the viewport culling, refreshed with the path changes
+    RenderUpdateFlag pending = RenderUpdateFlag::None;   //changes held while it's dormant
     uint8_t opacity;    //for composition
+    bool cullable = false;
+    bool dormant = false;   //culled out, the engine keeps it invisible
 
     ShapeImpl() : impl(Paint::Impl(this))
     {
     }
 
+    bool intersects(const RenderRegion& region)
+    {
+        if (!impl.rd || dormant) return false;
+        return impl.renderer->intersects(impl.rd, region);
+    }
+
     bool render(RenderMethod* renderer)
     {
         if (!impl.rd) return false;
+        if (dormant) return true;
 
         RenderCompositor* cmp = nullptr;
 
@@ -100,8 +111,72 @@ struct ShapeImpl : Shape
         return false;
     }
 
+    //the culling belongs to the leaving renderer, its held changes are left to it
+    RenderUpdateFlag retarget()
+    {
+        auto ret = dormant ? (pending | RenderUpdateFlag::Color) : RenderUpdateFlag::None;
+        pending = RenderUpdateFlag::None;
+        dormant = false;
+        return ret;
+    }
+
+    //conservative test whether the shape is totally outside of the viewport
+    bool culled(RenderMethod* renderer, const Matrix& transform)
+    {
+        if (!cullable) return false;
+
+        Point pt[4] = {local[0], {local[1].x, local[0].y}, local[1], {local[0].x, local[1].y}};
+        auto min = pt[0] * transform;
+        auto max = min;
+        for (int i = 1; i < 4; ++i) {
+            auto p = pt[i] * transform;
+            if (p.x < min.x) min.x = p.x;
+            if (p.y < min.y) min.y = p.y;
+            if (p.x > max.x) max.x = p.x;
+            if (p.y > max.y) max.y = p.y;
+        }
+
+        //stroke with the longest miter or the square caps, plus the antialiasing
+        auto margin = 1.0f;
+        if (rs.stroke && rs.stroke->width > 0.0f) {
+            auto sx = sqrtf(transform.e11 * transform.e11 + transform.e21 * transform.e21);
+            auto sy = sqrtf(transform.e12 * transform.e12 + transform.e22 * transform.e22);
+            auto reach = (rs.stroke->join == StrokeJoin::Miter) ? std::max(rs.stroke->miterlimit, 1.5f) : 1.5f;
+            margin += rs.stroke->width * 0.5f * reach * std::max(sx, sy);
+        }
+
+        auto vport = renderer->viewport();
+        return (max.x + margin < float(vport.min.x) || min.x - margin > float(vport.max.x) || max.y + margin < float(vport.min.y) || min.y - margin > float(vport.max.y));
+    }
+
     bool update(RenderMethod* renderer, const Matrix& transform, Array<RenderData>& clips, uint8_t opacity, RenderUpdateFlag flag, bool clipper)
     {
+        //the local bounds follow the path changes whether the culling is tried or not
+        if (flag & RenderUpdateFlag::Path) {
+            float x, y, w, h;
+            if ((cullable = rs.path.bounds(nullptr, &x, &y, &w, &h))) {
+                local[0] = {x, y};
+                local[1] = {x + w, y + h};
+            }
+        }
+
+        /* Skip the preparation of the shapes out of the viewport, they are treated as the invisible ones.
+           The clippers are excluded since they still define the clipped areas. */
+        if (!clipper && opacity > 0 && culled(renderer, transform)) {
+            //invisible already, the preparation is postponed until it's visible again
+            if (dormant && impl.rd) {
+                pending |= flag;
+                return true;
+            }
+            dormant = true;
+            opacity = 0;
+            flag |= RenderUpdateFlag::Color;
+        } else if (dormant) {
+            flag |= pending;
+            pending = RenderUpdateFlag::None;
+            dormant = false;
+        }
+
         if (needComposition(opacity)) {
             /* Overriding opacity value. If this scene is half-translucent,
                It must do intermediate composition with that opacity value. */ 
@@ -153,16 +228,19 @@ struct ShapeImpl : Shape
 
     void reserveCmd(uint32_t cmdCnt)
     {
+        rs.path.own();
         rs.path.cmds.reserve(cmdCnt);
     }
 
     void reservePts(uint32_t ptsCnt)
     {
+        rs.path.own();
         rs.path.pts.reserve(ptsCnt);
     }
 
     void grow(uint32_t cmdCnt, uint32_t ptsCnt)
     {
+        rs.path.own();
         rs.path.cmds.grow(cmdCnt);
         rs.path.pts.grow(ptsCnt);
     }
@@ -327,8 +405,9 @@ struct ShapeImpl : Shape
 
     void resetPath()
     {
-        rs.path.cmds.clear();
-        rs.path.pts.clear();
+        rs.path.clear();
+        delete(rs.glyphs);
+        rs.glyphs = nullptr;
         impl.mark(RenderUpdateFlag::Path);
     }
 
@@ -343,11 +422,43 @@ struct ShapeImpl : Shape
         return Result::Success;
     }
 
+    Result attachPath(const PathCommand *cmds, uint32_t cmdCnt, const Point* pts, uint32_t ptsCnt, void (*release)(void* data), void* data)
+    {
+        if (cmdCnt == 0 || ptsCnt == 0 || !cmds || !pts) return Result::InvalidArguments;
+
+        rs.path.attach(cmds, cmdCnt, pts, ptsCnt, release, data);
+
+        //the glyph outlines are not the path anymore
+        delete(rs.glyphs);
+        rs.glyphs = nullptr;
+
+        impl.mark(RenderUpdateFlag::Path);
+        return Result::Success;
+    }
+
+    Result points(const Point* pts, uint32_t begin, uint32_t cnt)
+    {
+        if (!pts || cnt == 0) return Result::InvalidArguments;
+        if (begin > rs.path.pts.count || cnt > rs.path.pts.count - begin) return Result::InsufficientCondition;
+
+        //the commands are intact, no reallocation
+        rs.path.own();
+        memcpy(rs.path.pts.data + begin, pts, sizeof(Point) * cnt);
+
+        //the glyph outlines are not the path anymore
+        delete(rs.glyphs);
+        rs.glyphs = nullptr;
+
+        impl.mark(RenderUpdateFlag::Path);
+        return Result::Success;
+    }
+
     void appendCircle(float cx, float cy, float rx, float ry, bool cw)
     {
         auto rxKappa = rx * PATH_KAPPA;
         auto ryKappa = ry * PATH_KAPPA;
 
+        rs.path.own();
         rs.path.cmds.grow(6);
         auto cmds = rs.path.cmds.end();
 
@@ -379,6 +490,8 @@ struct ShapeImpl : Shape
 
     void appendRect(float x, float y, float w, float h, float rx, float ry, bool cw)
     {
+        rs.path.own();
+
         //sharp rect
         if (tvg::zero(rx) && tvg::zero(ry)) {
             rs.path.cmds.grow(5);
@@ -466,9 +579,15 @@ struct ShapeImpl : Shape
         dup->rs.rule = rs.rule;
         dup->rs.color = rs.color;
 
-        //Path
-        dup->rs.path.cmds.push(rs.path.cmds);
-        dup->rs.path.pts.push(rs.path.pts);
+        //Path, shared until any of them is changed
+        if (rs.path.cmds.empty()) dup->rs.path.clear();
+        else rs.path.share(dup->rs.path);
+
+        if (rs.glyphs) {
+            dup->rs.glyphs = new RenderGlyphRun;
+            dup->rs.glyphs->glyphs.push(rs.glyphs->glyphs);
+            dup->rs.glyphs->em = rs.glyphs->em;
+        }
 
         //Stroke
         if (rs.stroke) {
@@ -489,8 +608,9 @@ struct ShapeImpl : Shape
     void reset()
     {
         PAINT(this)->reset();
-        rs.path.cmds.clear();
-        rs.path.pts.clear();
+        rs.path.clear();
+        delete(rs.glyphs);
+        rs.glyphs = nullptr;
 
         rs.color.a = 0;
         rs.rule = FillRule::NonZero;
@@ -29,6 +29,83 @@
 #endif
 
 
+/************************************************************************/
+/* Internal Class Implementation                                        */
+/************************************************************************/
+
+#ifdef THORVG_SW_RASTER_SUPPORT
+
+static Result _target(SwCanvas* canvas, uint32_t* buffer, uint32_t stride, uint32_t w, uint32_t h, ColorSpace cs, uint32_t lines, SwRenderer::BandFlush flush, void* data)
+{
+    if (cs == ColorSpace::Unknown) return Result::InvalidArguments;
+
+    auto impl = canvas->pImpl;
+
+    if (impl->status != Status::Damaged && impl->status != Status::Synced) {
+        return Result::InsufficientCondition;
+    }
+
+    //We know renderer type, avoid dynamic_cast for performance.
+    auto renderer = static_cast<SwRenderer*>(impl->renderer);
+    if (!renderer) return Result::MemoryCorruption;
+
+    if (!renderer->target(buffer, stride, w, h, cs, lines, flush, data)) return Result::InvalidArguments;
+    impl->vport = {{0, 0}, {(int32_t)w, (int32_t)h}};
+    renderer->viewport(impl->vport);
+
+    //FIXME: The value must be associated with an individual canvas instance.
+    //the images of the packed and the single channel targets are decoded into the 32 bits working colors
+    ImageLoader::cs = (CHANNEL_SIZE(cs) == sizeof(uint32_t)) ? cs : ColorSpace::ARGB8888;
+
+    //Paints must be updated again with this new target.
+    impl->status = Status::Damaged;
+
+    return Result::Success;
+}
+
+
+static Result _draw(SwCanvas* canvas, SwCanvas::Job& job, ColorSpace cs)
+{
+    if (!job.paint) return Result::InvalidArguments;
+
+    auto ret = canvas->target(job.buffer, job.stride, job.w, job.h, cs);
+    if (ret != Result::Success) return ret;
+
+    //keep the paint alive over the removal
+    job.paint->ref();
+
+    ret = canvas->push(job.paint);
+    if (ret == Result::Success) {
+        ret = canvas->draw(true);
+        if (ret == Result::Success) ret = canvas->sync();
+        canvas->remove(job.paint);
+    }
+
+    job.paint->unref(false);
+
+    return ret;
+}
+
+
+//draws a job with the canvas of the running thread
+struct SwBatchTask : Task
+{
+    SwCanvas** canvases;
+    SwCanvas::Job* job;
+    ColorSpace cs;
+
+    void run(unsigned tid) override
+    {
+        //the whole job stays on this thread, the nested waits could stall the busy workers otherwise
+        auto prv = TaskScheduler::inlining(tid);
+        job->result = _draw(canvases[tid], *job, cs);
+        TaskScheduler::inlining(prv);
+    }
+};
+
+#endif
+
+
 SwCanvas::SwCanvas() = default;
 
 SwCanvas::~SwCanvas()
@@ -42,26 +119,123 @@ SwCanvas::~SwCanvas()
 Result SwCanvas::target(uint32_t* buffer, uint32_t stride, uint32_t w, uint32_t h, ColorSpace cs) noexcept
 {
 #ifdef THORVG_SW_RASTER_SUPPORT
-    if (cs == ColorSpace::Unknown) return Result::InvalidArguments;
-    if (cs == ColorSpace::Grayscale8) return Result::NonSupport;
+    return _target(this, buffer, stride, w, h, cs, 0, nullptr, nullptr);
+#endif
+    return Result::NonSupport;
+}
 
+
+Result SwCanvas::target(uint32_t* buffer, uint32_t stride, uint32_t w, uint32_t h, uint32_t lines, ColorSpace cs, void (*flush)(const uint32_t* buffer, uint32_t y, uint32_t lines, void* data), void* data) noexcept
+{
+#ifdef THORVG_SW_RASTER_SUPPORT
+    if (lines == 0 || !flush) return Result::InvalidArguments;
+    return _target(this, buffer, stride, w, h, cs, lines, flush, data);
+#endif
+    return Result::NonSupport;
+}
+
+
+Result SwCanvas::dither(bool on) noexcept
+{
+#ifdef THORVG_SW_RASTER_SUPPORT
     if (pImpl->status != Status::Damaged && pImpl->status != Status::Synced) {
         return Result::InsufficientCondition;
     }
 
-    //We know renderer type, avoid dynamic_cast for performance.
     auto renderer = static_cast<SwRenderer*>(pImpl->renderer);
     if (!renderer) return Result::MemoryCorruption;
 
-    if (!renderer->target(buffer, stride, w, h, cs)) return Result::InvalidArguments;
-    pImpl->vport = {{0, 0}, {(int32_t)w, (int32_t)h}};
-    renderer->viewport(pImpl->vport);
+    renderer->dither(on);
 
-    //FIXME: The value must be associated with an individual canvas instance.
-    ImageLoader::cs = static_cast<ColorSpace>(cs);
+    return Result::Success;
+#endif
+    return Result::NonSupport;
+}
 
-    //Paints must be updated again with this new target.
-    pImpl->status = Status::Damaged;
+
+Result SwCanvas::tiles(bool on) noexcept
+{
+#ifdef THORVG_SW_RASTER_SUPPORT
+    if (pImpl->status != Status::Damaged && pImpl->status != Status::Synced) {
+        return Result::InsufficientCondition;
+    }
+
+    auto renderer = static_cast<SwRenderer*>(pImpl->renderer);
+    if (!renderer) return Result::MemoryCorruption;
+
+    if (renderer->tiles(on)) pImpl->status = Status::Damaged;
+
+    return Result::Success;
+#endif
+    return Result::NonSupport;
+}
+
+
+Result SwCanvas::batch(Job* jobs, uint32_t cnt, ColorSpace cs) noexcept
+{
+#ifdef THORVG_SW_RASTER_SUPPORT
+    if (!jobs || cnt == 0) return Result::InvalidArguments;
+    if (engineInit == 0) return Result::InsufficientCondition;
+
+    //a canvas per thread, the task scheduler gives the index of the running thread
+    auto threads = TaskScheduler::threads() + 1;
+    auto canvases = tvg::malloc<SwCanvas**>(sizeof(SwCanvas*) * threads);
+    for (uint32_t i = 0; i < threads; ++i) canvases[i] = SwCanvas::gen();
+
+    //no benefit to spread out a single job
+    if (threads == 1 || cnt == 1) {
+        for (uint32_t i = 0; i < cnt; ++i) jobs[i].result = _draw(canvases[0], jobs[i], cs);
+    } else {
+        auto tasks = new SwBatchTask[cnt];
+        TaskGroup group;
+        for (uint32_t i = 0; i < cnt; ++i) {
+            tasks[i].canvases = canvases;
+            tasks[i].job = &jobs[i];
+            tasks[i].cs = cs;
+            group.request(&tasks[i]);
+        }
+        group.wait();
+        delete[](tasks);
+    }
+
+    for (uint32_t i = 0; i < threads; ++i) delete(canvases[i]);
+    tvg::free(canvases);
+
+    return Result::Success;
+#endif
+    return Result::NonSupport;
+}
+
+
+Result SwCanvas::render(Paint* paint, Rendition* renditions, uint32_t cnt, ColorSpace cs) noexcept
+{
+#ifdef THORVG_SW_RASTER_SUPPORT
+    if (!paint || !renditions || cnt == 0) return Result::InvalidArguments;
+    if (engineInit == 0 || paint->parent()) return Result::InsufficientCondition;
+
+    auto canvas = SwCanvas::gen();
+
+    //scaled by the host scene, the paint keeps its own transformation
+    auto scene = Scene::gen();
+    canvas->push(scene);
+
+    //keep the paint alive over the removal
+    paint->ref();
+    scene->push(paint);
+
+    for (uint32_t i = 0; i < cnt; ++i) {
+        auto& r = renditions[i];
+        r.result = canvas->target(r.buffer, r.stride, r.w, r.h, cs);
+        if (r.result != Result::Success) continue;
+        scene->scale(r.scale);
+        r.result = canvas->draw(true);
+        if (r.result == Result::Success) r.result = canvas->sync();
+    }
+
+    scene->remove(paint);
+    paint->unref(false);
+
+    delete(canvas);
 
     return Result::Success;
 #endif
@@ -70,13 +244,22 @@ Result SwCanvas::target(uint32_t* buffer, uint32_t stride, uint32_t w, uint32_t
 
 
 SwCanvas* SwCanvas::gen() noexcept
+{
+    return gen(false);
+}
+
+
+SwCanvas* SwCanvas::gen(bool isolated) noexcept
 {
 #ifdef THORVG_SW_RASTER_SUPPORT
     if (engineInit > 0) {
-        auto renderer = SwRenderer::gen(TaskScheduler::threads());
+        //the shared states are locked from now on, even without the worker threads
+        if (isolated) TaskScheduler::concurrent(true);
+        auto renderer = SwRenderer::gen(TaskScheduler::threads(), isolated);
         renderer->ref();
         auto ret = new SwCanvas;
         ret->pImpl->renderer = renderer;
+        ret->pImpl->inplace = isolated;
         return ret;
     }
 #endif
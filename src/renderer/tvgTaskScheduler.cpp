@@ -24,6 +24,22 @@
 #include "tvgArray.h"
 #include "tvgInlist.h"
 #include "tvgTaskScheduler.h"
+#include "tvgTrace.h"
+
+#ifdef THORVG_THREAD_SUPPORT
+    #include <chrono>
+    #if defined(_WIN32)
+        #ifndef NOMINMAX
+            #define NOMINMAX
+        #endif
+        #include <windows.h>
+    #elif defined(__linux__)
+        #include <sched.h>
+        #include <unistd.h>
+        #include <sys/resource.h>
+        #include <sys/syscall.h>
+    #endif
+#endif
 
 /************************************************************************/
 /* Internal Class Implementation                                        */
@@ -33,137 +49,580 @@ namespace tvg {
 
 #ifdef THORVG_THREAD_SUPPORT
 
-struct TaskQueue {
-    Inlist<Task>             taskDeque;
-    mutex                    mtx;
-    condition_variable       ready;
-    bool                     done = false;
+//a dependent task to be released when the task it points from is done
+struct TaskEdge
+{
+    Task* task;
+    TaskEdge* next;
+};
+
+static TaskEdge _closed;   //marks the dependents of a finished task
+static thread_local int32_t _inlined = -1;   //the thread index running its requested tasks in place, -1 if none
+static atomic<bool> _concurrent{false};      //the isolated canvases are drawn by the host threads, see SwCanvas::gen(bool)
+static thread_local int32_t _pumped = -1;    //the deque index of the pump running on this host thread, -1 if none
+
+
+//place the calling worker thread as requested, the failures are not critical
+static void _setup(const ThreadOptions& options, uint32_t i)
+{
+#if defined(_WIN32)
+    if (options.cores && options.coreCnt > 0) {
+        auto core = options.cores[i % options.coreCnt];
+        if (core < sizeof(DWORD_PTR) * 8) SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core);
+    }
+    if (options.priority != 0) {
+        SetThreadPriority(GetCurrentThread(), std::max(THREAD_PRIORITY_LOWEST, std::min(options.priority, int32_t(THREAD_PRIORITY_HIGHEST))));
+    }
+#elif defined(__linux__)
+    if (options.cores && options.coreCnt > 0) {
+        auto core = options.cores[i % options.coreCnt];
+        if (core < CPU_SETSIZE) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(core, &set);
+            if (sched_setaffinity(0, sizeof(set), &set) != 0) TVGLOG("RENDERER", "Worker(%u) can't be pinned to the core(%u)", i, core);
+        }
+    }
+    //the nice value is per thread on linux
+    if (options.priority != 0) {
+        if (setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), std::max(-20, std::min(-options.priority, 19))) != 0) {
+            TVGLOG("RENDERER", "Worker(%u) priority(%d) is not allowed", i, options.priority);
+        }
+    }
+#else
+    if (i == 0 && (options.cores || options.priority != 0)) TVGLOG("RENDERER", "Thread options are not supported on this system");
+#endif
+}
+
 
-    bool tryPop(Task** task)
+//Chase-Lev work-stealing deque. The owner pushes and pops at the bottom (LIFO),
+//the other threads steal from the top (FIFO) without taking any lock.
+struct TaskDeque
+{
+    struct Ring
     {
-        unique_lock<mutex> lock{mtx, try_to_lock};
-        if (!lock || taskDeque.empty()) return false;
-        *task = taskDeque.front();
-        return true;
+        atomic<Task*>* slots;
+        int64_t mask;
+        Ring* retired;      //the old rings might still be read by thieves, free them at the end.
+
+        Ring(int64_t size, Ring* retired) : slots(new atomic<Task*>[size]), mask(size - 1), retired(retired) {}
+        ~Ring() { delete[] slots; }
+    };
+
+    atomic<int64_t> top{0};
+    atomic<int64_t> bottom{0};
+    atomic<Ring*> ring;
+
+    TaskDeque()
+    {
+        ring.store(new Ring(256, nullptr), memory_order_relaxed);
     }
 
-    bool tryPush(Task* task)
+    ~TaskDeque()
     {
-        {
-            unique_lock<mutex> lock{mtx, try_to_lock};
-            if (!lock) return false;
-            taskDeque.back(task);
+        auto r = ring.load(memory_order_relaxed);
+        while (r) {
+            auto retired = r->retired;
+            delete(r);
+            r = retired;
         }
-        ready.notify_one();
-        return true;
     }
 
-    void complete()
+    Ring* grow(Ring* r, int64_t t, int64_t b)
     {
-        {
-            lock_guard<mutex> lock{mtx};
-            done = true;
+        auto r2 = new Ring((r->mask + 1) * 2, r);
+        for (auto i = t; i < b; ++i) {
+            r2->slots[i & r2->mask].store(r->slots[i & r->mask].load(memory_order_relaxed), memory_order_relaxed);
         }
-        ready.notify_all();
+        ring.store(r2, memory_order_release);
+        return r2;
     }
 
-    bool pop(Task** task)
+    //owner only
+    void push(Task* task)
     {
-        unique_lock<mutex> lock{mtx};
+        auto b = bottom.load(memory_order_relaxed);
+        auto t = top.load(memory_order_acquire);
+        auto r = ring.load(memory_order_relaxed);
+        if (b - t > r->mask) r = grow(r, t, b);
+        r->slots[b & r->mask].store(task, memory_order_relaxed);
+        bottom.store(b + 1, memory_order_release);
+    }
 
-        while (taskDeque.empty() && !done) {
-            ready.wait(lock);
+    //owner only
+    Task* pop()
+    {
+        auto b = bottom.load(memory_order_relaxed) - 1;
+        auto r = ring.load(memory_order_relaxed);
+        bottom.store(b, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        auto t = top.load(memory_order_relaxed);
+
+        //empty
+        if (t > b) {
+            bottom.store(b + 1, memory_order_relaxed);
+            return nullptr;
         }
 
-        if (taskDeque.empty()) return false;
+        auto task = r->slots[b & r->mask].load(memory_order_relaxed);
 
-        *task = taskDeque.front();
-        return true;
+        //the last one, race against the thieves
+        if (t == b) {
+            if (!top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed)) task = nullptr;
+            bottom.store(b + 1, memory_order_relaxed);
+        }
+        return task;
     }
 
-    void push(Task* task)
+    //any thread. returns null only if the deque is observed empty.
+    Task* steal()
     {
-        {
-            lock_guard<mutex> lock{mtx};
-            taskDeque.back(task);
+        while (true) {
+            auto t = top.load(memory_order_acquire);
+            atomic_thread_fence(memory_order_seq_cst);
+            auto b = bottom.load(memory_order_acquire);
+            if (t >= b) return nullptr;
+
+            auto r = ring.load(memory_order_acquire);
+            auto task = r->slots[t & r->mask].load(memory_order_relaxed);
+            if (top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed)) return task;
         }
-        ready.notify_one();
     }
 };
 
 
+struct TaskSchedulerImpl;
+
+//a host job running the queued tasks with the given deque until nothing is left
+struct TaskPump
+{
+    TaskSchedulerImpl* impl;
+    uint32_t slot;
+};
+
+
 struct TaskSchedulerImpl
 {
     Array<thread*>                 threads;
-    Array<TaskQueue*>              taskQueues;
-    atomic<uint32_t>               idx{0};
+    uint32_t                       workers = 0;    //the built-in threads or the pumps allowed in flight
+    Array<TaskDeque*>              deques;         //one per worker, the last one belongs to the dominant thread
+    ThreadID                       dominant;
+
+    //tasks requested by the other threads which don't own any deque
+    Inlist<Task>                   injected;
+    Inlist<Task>                   prefetched;     //the background tasks, taken once nothing else is left
+    mutex                          imtx;
+
+    //parking of the idle workers
+    mutex                          pmtx;
+    condition_variable             ready;
+    atomic<uint32_t>               sleepers{0};
+    bool                           done = false;
+    ThreadOptions                  options;
+    Array<uint32_t>                cores;          //the copy of the options cores
+
+    //the host job system replacing the built-in threads
+    Executor                       executor{};
+    Array<TaskPump>                pumps;
+    atomic<uint64_t>               slots{0};       //the deques taken by the pumps in flight
+    atomic<uint32_t>               pumping{0};     //the pumps not returned to the host yet
+
+    //blocking of the threads waiting for the task completions
+    mutex                          wmtx;
+    condition_variable             finished;
+    atomic<uint32_t>               waiters{0};
+    atomic<uint32_t>               posted{0};        //enqueued tasks count, wakes up the dominant thread waiting
+    bool                           helping = false;  //the dominant thread is running a task on behalf of the workers
+
+    TaskSchedulerImpl(const Executor& executor) : dominant(this_thread::get_id()), executor(executor)
+    {
+        workers = executor.threads;
+        deques.reserve(workers + 1);
+        pumps.reserve(workers);
+        for (uint32_t i = 0; i < workers; ++i) {
+            deques.push(new TaskDeque);
+            pumps.push({this, i});
+        }
+        deques.push(new TaskDeque);
+    }
 
-    TaskSchedulerImpl(uint32_t threadCnt)
+    TaskSchedulerImpl(uint32_t threadCnt, const ThreadOptions* options) : dominant(this_thread::get_id())
     {
+        if (options) {
+            this->options = *options;
+            if (options->cores && options->coreCnt > 0) {
+                cores.reserve(options->coreCnt);
+                for (uint32_t i = 0; i < options->coreCnt; ++i) cores.push(options->cores[i]);
+                this->options.cores = cores.data;
+            } else this->options.cores = nullptr;
+        }
+
         threads.reserve(threadCnt);
-        taskQueues.reserve(threadCnt);
+        deques.reserve(threadCnt + 1);
 
         for (uint32_t i = 0; i < threadCnt; ++i) {
-            taskQueues.push(new TaskQueue);
+            deques.push(new TaskDeque);
             threads.push(new thread);
         }
+        deques.push(new TaskDeque);
+
         for (uint32_t i = 0; i < threadCnt; ++i) {
             *threads.data[i] = thread([&, i] { run(i); });
         }
+        workers = threadCnt;
     }
 
     ~TaskSchedulerImpl()
     {
-        ARRAY_FOREACH(p, taskQueues) {
-            (*p)->complete();
+        {
+            lock_guard<mutex> lock{pmtx};
+            done = true;
         }
+        ready.notify_all();
+
         ARRAY_FOREACH(p, threads) {
             (*p)->join();
             delete(*p);
         }
-        ARRAY_FOREACH(p, taskQueues) {
+        //the pumps leaving might still touch this
+        while (pumping.load() > 0) this_thread::yield();
+        ARRAY_FOREACH(p, deques) {
             delete(*p);
         }
     }
 
+    //the deque owned by the given thread, if any
+    TaskDeque* owned(ThreadID id)
+    {
+        if (_pumped >= 0) return deques[_pumped];
+        if (id == dominant) return deques.last();
+        for (uint32_t i = 0; i < threads.count; ++i) {
+            if (threads[i]->get_id() == id) return deques[i];
+        }
+        return nullptr;
+    }
+
+    uint32_t index(TaskDeque* deque)
+    {
+        for (uint32_t i = 0; i < deques.count; ++i) {
+            if (deques[i] == deque) return i;
+        }
+        return 0;
+    }
+
+    Task* grab(uint32_t i, bool background = true)
+    {
+        //own tasks first in LIFO order, they are likely hot in cache
+        if (auto task = deques[i]->pop()) return task;
+
+        //steal the oldest one from the others
+        for (uint32_t x = 1; x < deques.count; ++x) {
+            if (auto task = deques[(i + x) % deques.count]->steal()) return task;
+        }
+
+        lock_guard<mutex> lock{imtx};
+        if (auto task = injected.front()) return task;
+        if (!background) return nullptr;
+
+        auto task = prefetched.front();
+        if (task) task->background.store(false, memory_order_relaxed);
+        return task;
+    }
+
+    //nothing is queued anywhere
+    bool idle()
+    {
+        ARRAY_FOREACH(p, deques) {
+            if ((*p)->top.load(memory_order_acquire) < (*p)->bottom.load(memory_order_acquire)) return false;
+        }
+        lock_guard<mutex> lock{imtx};
+        return injected.empty() && prefetched.empty();
+    }
+
+    static void pump(void* arg)
+    {
+        auto pump = static_cast<TaskPump*>(arg);
+        pump->impl->pump(pump->slot);
+    }
+
+    void pump(uint32_t slot)
+    {
+        _pumped = slot;
+        auto bit = uint64_t(1) << slot;
+        while (true) {
+            while (auto task = grab(slot)) execute(task, slot + 1);
+            slots.fetch_and(~bit);
+            //the tasks requested meanwhile might have found all the slots taken, pairs with the fence in spawn()
+            if (idle()) break;
+            if (slots.fetch_or(bit) & bit) break;   //another pump took over
+        }
+        _pumped = -1;
+        --pumping;
+    }
+
+    //hand a pump over to the host unless all of them are in flight
+    void spawn()
+    {
+        atomic_thread_fence(memory_order_seq_cst);
+        auto taken = slots.load();
+        while (true) {
+            uint32_t slot = 0;
+            while (slot < workers && (taken & (uint64_t(1) << slot))) ++slot;
+            if (slot == workers) return;
+            if (slots.compare_exchange_weak(taken, taken | (uint64_t(1) << slot))) {
+                ++pumping;
+                executor.submit(pump, &pumps[slot], executor.data);
+                return;
+            }
+        }
+    }
+
+    void wakeup()
+    {
+        if (executor.submit) {
+            spawn();
+            return;
+        }
+
+        //pairs with the sleepers increment before the last grab() try in run()
+        atomic_thread_fence(memory_order_seq_cst);
+        if (sleepers.load(memory_order_relaxed) == 0) return;
+        { lock_guard<mutex> lock{pmtx}; }
+        ready.notify_one();
+    }
+
+    //look for the new tasks a while before sleeping, the bursts of the short tasks come in close
+    Task* spin(unsigned i)
+    {
+        auto until = chrono::steady_clock::now() + chrono::microseconds(options.spin);
+        do {
+            if (auto task = grab(i)) return task;
+            this_thread::yield();
+        } while (chrono::steady_clock::now() < until);
+        return nullptr;
+    }
+
     void run(unsigned i)
     {
-        Task* task;
+        _setup(options, i);
 
         //Thread Loop
         while (true) {
-            auto success = false;
-            for (uint32_t x = 0; x < threads.count * 2; ++x) {
-                if (taskQueues[(i + x) % threads.count]->tryPop(&task)) {
-                    success = true;
+            auto task = grab(i);
+            if (!task && options.spin > 0) task = spin(i);
+
+            if (!task) {
+                unique_lock<mutex> lock{pmtx};
+                ++sleepers;
+                while (!(task = grab(i)) && !done) ready.wait(lock);
+                --sleepers;
+            }
+
+            if (!task) break;
+            execute(task, i + 1);
+        }
+    }
+
+    void complete(atomic<uint32_t>& counter)
+    {
+        if (--counter > 0) return;
+        if (waiters.load() == 0) return;
+        { lock_guard<mutex> lock{wmtx}; }
+        finished.notify_all();
+    }
+
+    void enqueue(Task* task)
+    {
+        if (auto deque = owned(this_thread::get_id())) {
+            deque->push(task);
+        } else {
+            lock_guard<mutex> lock{imtx};
+            injected.back(task);
+        }
+        notify();
+    }
+
+    void notify()
+    {
+        wakeup();
+
+        //the dominant thread might be blocked on this one
+        ++posted;
+        if (waiters.load() == 0) return;
+        { lock_guard<mutex> lock{wmtx}; }
+        finished.notify_all();
+    }
+
+    //link the task to its dependency if this is still in progress
+    void link(Task* task, Task* dep)
+    {
+        if (dep->running.load(memory_order_acquire) == 0) return;
+
+        auto edge = new TaskEdge{task, nullptr};
+        ++task->blockers;
+
+        auto head = dep->dependents.load(memory_order_acquire);
+        do {
+            //already done
+            if (head == &_closed) {
+                --task->blockers;
+                delete(edge);
+                return;
+            }
+            edge->next = head;
+        } while (!dep->dependents.compare_exchange_weak(head, edge, memory_order_acq_rel, memory_order_acquire));
+    }
+
+    void release(Task* task)
+    {
+        auto edge = task->dependents.exchange(&_closed, memory_order_acq_rel);
+        while (edge) {
+            auto next = edge->next;
+            if (--edge->task->blockers == 0) enqueue(edge->task);
+            delete(edge);
+            edge = next;
+        }
+    }
+
+    void execute(Task* task, unsigned tid)
+    {
+        {
+            TVG_TRACE_TASK("Task::run", tid);
+            task->run(tid);
+        }
+        release(task);
+
+        //the task might be released by its owner as soon as it's done
+        auto group = task->group;
+        complete(task->running);
+        if (group) complete(group->pending);
+    }
+
+    void wait(atomic<uint32_t>& counter)
+    {
+        /* Let the dominant thread run the queued tasks rather than sleeping.
+           It uses the thread index 0 like the synchronous mode so no nested helping is allowed. */
+        if (this_thread::get_id() == dominant && !helping) {
+            helping = true;
+            while (true) {
+                auto gen = posted.load();
+                //the background tasks could delay the awaited ones, leave them to the workers
+                while (counter.load(memory_order_acquire) > 0) {
+                    auto task = grab(deques.count - 1, false);
+                    if (!task) break;
+                    execute(task, 0);
+                }
+                if (counter.load(memory_order_acquire) == 0) break;
+
+                /* The awaited tasks might be still requested by the busy workers, which would block on them without the help,
+                   so wake up on the new tasks as well. */
+                unique_lock<mutex> lock{wmtx};
+                ++waiters;
+                while (counter.load() > 0 && posted.load() == gen) finished.wait(lock);
+                --waiters;
+            }
+            helping = false;
+            return;
+        }
+
+        //the others run the tasks of the waiting group or the awaited task pushed by themselves, so that the nested fork-join never stalls
+        if (auto deque = owned(this_thread::get_id())) {
+            auto tid = (deque == deques.last()) ? 0 : index(deque) + 1;
+            while (counter.load(memory_order_acquire) > 0) {
+                auto task = deque->pop();
+                if (!task) break;
+                //the other tasks might conflict with the suspended one
+                if (&task->running != &counter && (!task->group || &task->group->pending != &counter)) {
+                    deque->push(task);
                     break;
                 }
+                execute(task, tid);
             }
+        }
+
+        if (counter.load(memory_order_acquire) == 0) return;
+
+        unique_lock<mutex> lock{wmtx};
+        ++waiters;
+        while (counter.load() > 0) finished.wait(lock);
+        --waiters;
+    }
 
-            if (!success && !taskQueues[i]->pop(&task)) break;
-            (*task)(i + 1);
+    void request(Task* task, Task* const* deps, uint32_t cnt, TaskGroup* group)
+    {
+        //Async
+        if (workers > 0 && _inlined < 0) {
+            task->group = group;
+            task->running.store(1, memory_order_relaxed);
+            task->dependents.store(nullptr, memory_order_relaxed);
+            if (group) ++group->pending;
+
+            //hold the task until all the dependencies are linked
+            task->blockers.store(1, memory_order_relaxed);
+            for (uint32_t i = 0; i < cnt; ++i) link(task, deps[i]);
+            if (--task->blockers == 0) enqueue(task);
+        //Sync
+        } else {
+            auto tid = (_inlined < 0) ? 0 : unsigned(_inlined);
+            TVG_TRACE_TASK("Task::run", tid);
+            task->run(tid);
         }
     }
 
-    void request(Task* task)
+    void prefetch(Task* task)
     {
         //Async
-        if (threads.count > 0) {
-            task->prepare();
-            auto i = idx++;
-            for (uint32_t n = 0; n < threads.count; ++n) {
-                if (taskQueues[(i + n) % threads.count]->tryPush(task)) return;
+        if (workers > 0 && _inlined < 0) {
+            task->group = nullptr;
+            task->running.store(1, memory_order_relaxed);
+            task->dependents.store(nullptr, memory_order_relaxed);
+            task->blockers.store(0, memory_order_relaxed);
+            {
+                lock_guard<mutex> lock{imtx};
+                task->background.store(true, memory_order_relaxed);
+                prefetched.back(task);
             }
-            taskQueues[i % threads.count]->push(task);
+            notify();
         //Sync
-        } else {
-            task->run(0);
+        } else request(task, nullptr, 0, nullptr);
+    }
+
+    //take the task out of the background queue under the lock, false if it's started already
+    bool dequeue(Task* task)
+    {
+        if (!task->background.load(memory_order_relaxed)) return false;
+        task->background.store(false, memory_order_relaxed);
+        prefetched.remove(task);
+        return true;
+    }
+
+    bool promote(Task* task)
+    {
+        if (!task->background.load(memory_order_relaxed)) return false;
+        {
+            lock_guard<mutex> lock{imtx};
+            if (!dequeue(task)) return false;
+            injected.front(task);
         }
+        notify();
+        return true;
+    }
+
+    bool cancel(Task* task)
+    {
+        if (!task->background.load(memory_order_relaxed)) return false;
+        {
+            lock_guard<mutex> lock{imtx};
+            if (!dequeue(task)) return false;
+        }
+        release(task);
+        complete(task->running);
+        return true;
     }
 
     uint32_t threadCnt()
     {
-        return threads.count;
+        return workers;
     }
 };
 
@@ -171,8 +630,16 @@ struct TaskSchedulerImpl
 
 struct TaskSchedulerImpl
 {
-    TaskSchedulerImpl(TVG_UNUSED uint32_t threadCnt) {}
-    void request(Task* task) { task->run(0); }
+    TaskSchedulerImpl(TVG_UNUSED const Executor& executor) {}
+    TaskSchedulerImpl(TVG_UNUSED uint32_t threadCnt, TVG_UNUSED const ThreadOptions* options) {}
+    void request(Task* task, TVG_UNUSED Task* const* deps, TVG_UNUSED uint32_t cnt, TVG_UNUSED TaskGroup* group)
+    {
+        TVG_TRACE_TASK("Task::run", 0);
+        task->run(0);
+    }
+    void prefetch(Task* task) { request(task, nullptr, 0, nullptr); }
+    bool promote(TVG_UNUSED Task* task) { return false; }
+    bool cancel(TVG_UNUSED Task* task) { return false; }
     uint32_t threadCnt() { return 0; }
 };
 
@@ -188,10 +655,18 @@ struct TaskSchedulerImpl
 static TaskSchedulerImpl* _inst = nullptr;
 static ThreadID _tid;   //dominant thread id
 
-void TaskScheduler::init(uint32_t threads)
+void TaskScheduler::init(uint32_t threads, const ThreadOptions* options)
 {
     if (_inst) return;
-    _inst = new TaskSchedulerImpl(threads);
+    _inst = new TaskSchedulerImpl(threads, options);
+    _tid = tid();
+}
+
+
+void TaskScheduler::init(const Executor& executor)
+{
+    if (_inst) return;
+    _inst = new TaskSchedulerImpl(executor);
     _tid = tid();
 }
 
@@ -200,15 +675,50 @@ void TaskScheduler::term()
 {
     delete(_inst);
     _inst = nullptr;
+    concurrent(false);
+}
+
+
+void TaskScheduler::request(Task* task, TaskGroup* group)
+{
+    if (_inst) _inst->request(task, nullptr, 0, group);
 }
 
 
-void TaskScheduler::request(Task* task)
+void TaskScheduler::request(Task* task, Task* const* deps, uint32_t cnt, TaskGroup* group)
 {
-    if (_inst) _inst->request(task);
+    if (_inst) _inst->request(task, deps, cnt, group);
 }
 
 
+void TaskScheduler::prefetch(Task* task)
+{
+    if (_inst) _inst->prefetch(task);
+}
+
+
+bool TaskScheduler::promote(Task* task)
+{
+    if (_inst) return _inst->promote(task);
+    return false;
+}
+
+
+bool TaskScheduler::cancel(Task* task)
+{
+    if (_inst) return _inst->cancel(task);
+    return false;
+}
+
+
+#ifdef THORVG_THREAD_SUPPORT
+void TaskScheduler::wait(atomic<uint32_t>& counter)
+{
+    if (_inst) _inst->wait(counter);
+}
+#endif
+
+
 uint32_t TaskScheduler::threads()
 {
     return _inst ? _inst->threadCnt() : 0;
@@ -221,6 +731,36 @@ bool TaskScheduler::onthread()
 }
 
 
+int32_t TaskScheduler::inlining(TVG_UNUSED int32_t tid)
+{
+#ifdef THORVG_THREAD_SUPPORT
+    auto prv = _inlined;
+    _inlined = tid;
+    return prv;
+#else
+    return -1;
+#endif
+}
+
+
+bool TaskScheduler::concurrent()
+{
+#ifdef THORVG_THREAD_SUPPORT
+    return threads() > 0 || _concurrent.load(memory_order_relaxed);
+#else
+    return false;
+#endif
+}
+
+
+void TaskScheduler::concurrent(TVG_UNUSED bool on)
+{
+#ifdef THORVG_THREAD_SUPPORT
+    _concurrent.store(on, memory_order_relaxed);
+#endif
+}
+
+
 ThreadID TaskScheduler::tid()
 {
 #ifdef THORVG_THREAD_SUPPORT
@@ -35,65 +35,123 @@
 
 namespace tvg {
 
+#ifdef THORVG_THREAD_SUPPORT
+    using ThreadID = std::thread::id;
+#else
+    using ThreadID = uint8_t;
+#endif
 
+struct Task;
+struct TaskGroup;
+struct TaskEdge;
+
+struct TaskScheduler
+{
+    static uint32_t threads();
+    static void init(uint32_t threads, const ThreadOptions* options = nullptr);
+    static void init(const Executor& executor);  //run the tasks on the host job system
+    static void term();
+    static void request(Task* task, TaskGroup* group = nullptr);
+    static void request(Task* task, Task* const* deps, uint32_t cnt, TaskGroup* group = nullptr);   //run the task after the given tasks are done
+    static void prefetch(Task* task);  //run the task in the background once no other tasks are queued
+    static bool promote(Task* task);   //run the prefetched task ahead of the others if it's not started yet
+    static bool cancel(Task* task);    //drop the prefetched task if it's not started yet
+    static bool onthread();  //figure out whether on worker thread or not
+    static ThreadID tid();
+    static int32_t inlining(int32_t tid);  //run the tasks requested by this thread in place with the thread index, -1 stops it. returns the previous one.
+    static bool concurrent();  //the engine might be used by multiple threads at once, the shared states must be locked
+    static void concurrent(bool on);  //the host threads use the engine at once regardless of the workers
 #ifdef THORVG_THREAD_SUPPORT
+    static void wait(atomic<uint32_t>& counter);  //block until the counter drains. the dominant thread runs the queued tasks meanwhile.
+#endif
+};
 
-using ThreadID = std::thread::id;
+
+//runs the tasks requested by this thread in place while it's alive
+struct TaskInlining
+{
+    int32_t prv = -1;
+    bool on;
+
+    TaskInlining(bool on) : on(on)
+    {
+        if (on) prv = TaskScheduler::inlining(0);
+    }
+
+    ~TaskInlining()
+    {
+        if (on) TaskScheduler::inlining(prv);
+    }
+};
+
+
+#ifdef THORVG_THREAD_SUPPORT
 
 struct Task
 {
 private:
-    mutex                   mtx;
-    condition_variable      cv;
-    bool                    ready = true;
-    bool                    pending = false;
+    atomic<uint32_t>        running{0};
+    atomic<uint32_t>        blockers{0};            //unfinished dependencies
+    atomic<TaskEdge*>       dependents{nullptr};    //released on completion
+    TaskGroup*              group = nullptr;
+    atomic<bool>            background{false};      //queued with the lowest priority
 
 public:
     INLIST_ITEM(Task);
 
     virtual ~Task() = default;
 
-    void done()
+    bool busy() const
     {
-        if (!pending) return;
+        return running.load(memory_order_acquire) > 0;
+    }
 
-        unique_lock<mutex> lock(mtx);
-        while (!ready) cv.wait(lock);
-        pending = false;
+    void done()
+    {
+        if (!busy()) return;
+        //it's wanted right now
+        TaskScheduler::promote(this);
+        TaskScheduler::wait(running);
     }
 
 protected:
     virtual void run(unsigned tid) = 0;
 
 private:
-    void operator()(unsigned tid)
-    {
-        run(tid);
+    friend struct TaskSchedulerImpl;
+};
+
 
-        lock_guard<mutex> lock(mtx);
-        ready = true;
-        cv.notify_one();
+//fork-join: request the tasks, then block once on a single completion counter
+struct TaskGroup
+{
+    atomic<uint32_t> pending{0};
+
+    void request(Task* task)
+    {
+        TaskScheduler::request(task, this);
     }
 
-    void prepare()
+    void request(Task* task, Task* const* deps, uint32_t cnt)
     {
-        ready = false;
-        pending = true;
+        TaskScheduler::request(task, deps, cnt, this);
     }
 
-    friend struct TaskSchedulerImpl;
+    void wait()
+    {
+        if (pending.load(memory_order_acquire) > 0) TaskScheduler::wait(pending);
+    }
 };
 
 #else  //THORVG_THREAD_SUPPORT
 
-using ThreadID = uint8_t;
-
 struct Task
 {
 public:
     INLIST_ITEM(Task);
 
     virtual ~Task() = default;
+    bool busy() const { return false; }
     void done() {}
 
 protected:
@@ -103,19 +161,24 @@ private:
     friend struct TaskSchedulerImpl;
 };
 
-#endif  //THORVG_THREAD_SUPPORT
-
 
-struct TaskScheduler
+struct TaskGroup
 {
-    static uint32_t threads();
-    static void init(uint32_t threads);
-    static void term();
-    static void request(Task* task);
-    static bool onthread();  //figure out whether on worker thread or not
-    static ThreadID tid();
+    void request(Task* task)
+    {
+        TaskScheduler::request(task, this);
+    }
+
+    void request(Task* task, Task* const* deps, uint32_t cnt)
+    {
+        TaskScheduler::request(task, deps, cnt, this);
+    }
+
+    void wait() {}
 };
 
+#endif  //THORVG_THREAD_SUPPORT
+
 }  //namespace
 
 #endif //_TVG_TASK_SCHEDULER_H_
@@ -94,6 +94,12 @@ struct TextImpl : Text
         return SHAPE(shape)->bounds(renderer);
     }
 
+    bool intersects(const RenderRegion& region)
+    {
+        if (!loader) return false;
+        return PAINT(shape)->intersects(region);
+    }
+
     bool render(RenderMethod* renderer)
     {
         if (!loader) return true;
@@ -117,6 +123,11 @@ struct TextImpl : Text
         return false;
     }
 
+    RenderUpdateFlag retarget()
+    {
+        return RenderUpdateFlag::None;
+    }
+
     bool update(RenderMethod* renderer, const Matrix& transform, Array<RenderData>& clips, uint8_t opacity, RenderUpdateFlag flag, TVG_UNUSED bool clipper)
     {
         auto scale = 1.0f / load();
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "tvgTrace.h"
+
+#ifdef THORVG_TRACE_SUPPORT
+
+#include <atomic>
+#include <cstdio>
+#include "tvgArray.h"
+#include "tvgLock.h"
+
+/************************************************************************/
+/* Internal Class Implementation                                        */
+/************************************************************************/
+
+namespace {
+
+struct TraceEvent
+{
+    const char* name;
+    uint64_t begin;
+    uint64_t end;
+    uint32_t thread;    //sequential id of the recording thread
+    int32_t worker;     //scheduler thread index of the task, -1 if none
+};
+
+Key _key;
+Array<TraceEvent> _events;
+const char* _path = nullptr;
+uint64_t _origin = 0;
+std::atomic<uint32_t> _threads{0};
+
+uint32_t _thread()
+{
+    thread_local uint32_t id = _threads++;
+    return id;
+}
+
+}
+
+/************************************************************************/
+/* External Class Implementation                                        */
+/************************************************************************/
+
+bool Trace::on = false;
+
+
+void Trace::init()
+{
+    _path = getenv("THORVG_TRACE");
+    if (!_path || !*_path) return;
+    _origin = now();
+    on = true;
+}
+
+
+void Trace::record(const char* name, uint64_t begin, uint64_t end, int32_t worker)
+{
+    auto thread = _thread();
+    ScopedLock lock(_key);
+    _events.push({name, begin, end, thread, worker});
+}
+
+
+void Trace::term()
+{
+    if (!on) return;
+    on = false;
+
+    auto file = fopen(_path, "w");
+    if (!file) {
+        TVGERR("RENDERER", "Couldn't write the trace = %s", _path);
+        _events.reset();
+        return;
+    }
+
+    //the complete events ("X") of the chrome trace format, timestamps in microseconds
+    fprintf(file, "{\"traceEvents\":[\n");
+    ARRAY_FOREACH(p, _events) {
+        fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f", (p == _events.begin()) ? "" : ",\n", p->name, p->thread, double(p->begin - _origin) * 1e-3, double(p->end - p->begin) * 1e-3);
+        if (p->worker >= 0) fprintf(file, ",\"args\":{\"worker\":%d}", p->worker);
+        fprintf(file, "}");
+    }
+    fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    fclose(file);
+
+    TVGLOG("RENDERER", "Trace written = %s, %u events", _path, _events.count);
+
+    _events.reset();
+}
+
+#endif //THORVG_TRACE_SUPPORT
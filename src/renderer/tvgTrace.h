@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _TVG_TRACE_H_
+#define _TVG_TRACE_H_
+
+#include "tvgCommon.h"
+
+#ifdef THORVG_TRACE_SUPPORT
+
+#include <chrono>
+
+namespace tvg {
+
+//records the duration events of the scheduler, the loaders and the renderers into a Chrome trace (JSON).
+//the recording is active while the THORVG_TRACE environment variable names the output file.
+struct Trace
+{
+    static bool on;
+
+    static void init();
+    static void term();     //writes the recorded events out
+    static void record(const char* name, uint64_t begin, uint64_t end, int32_t worker);
+
+    static uint64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+
+struct TraceScope
+{
+    const char* name;   //must be a string literal
+    uint64_t begin = 0;
+    int32_t worker;
+
+    TraceScope(const char* name, int32_t worker = -1) : name(name), worker(worker)
+    {
+        if (Trace::on) begin = Trace::now();
+    }
+
+    ~TraceScope()
+    {
+        if (begin > 0) Trace::record(name, begin, Trace::now(), worker);
+    }
+};
+
+}
+
+#define TVG_TRACE_CONCAT2(a, b) a##b
+#define TVG_TRACE_CONCAT(a, b) TVG_TRACE_CONCAT2(a, b)
+#define TVG_TRACE(name) tvg::TraceScope TVG_TRACE_CONCAT(_tvgTrace, __LINE__)(name)
+#define TVG_TRACE_TASK(name, tid) tvg::TraceScope TVG_TRACE_CONCAT(_tvgTrace, __LINE__)(name, int32_t(tid))
+
+#else //THORVG_TRACE_SUPPORT
+
+#define TVG_TRACE(name) do {} while(0)
+#define TVG_TRACE_TASK(name, tid) do {} while(0)
+
+#endif //THORVG_TRACE_SUPPORT
+
+#endif //_TVG_TRACE_H_
@@ -141,6 +141,27 @@ WGPUBindGroup WgBindGroupLayouts::createBindGroupBuffer3Un(WGPUBuffer buff0, WGP
 }
 
 
+WGPUBindGroup WgBindGroupLayouts::createBindGroupBuffer1UnDyn(WGPUBuffer buff, uint64_t size)
+{
+    const WGPUBindGroupEntry bindGroupEntrys[] = {
+        { .binding = 0, .buffer = buff, .offset = 0, .size = size }
+    };
+    const WGPUBindGroupDescriptor bindGroupDesc { .layout = layoutBuffer1UnDyn, .entryCount = 1, .entries = bindGroupEntrys };
+    return wgpuDeviceCreateBindGroup(device, &bindGroupDesc);
+}
+
+
+WGPUBindGroup WgBindGroupLayouts::createBindGroupBuffer2RO(WGPUBuffer buff0, WGPUBuffer buff1)
+{
+    const WGPUBindGroupEntry bindGroupEntrys[] = {
+        { .binding = 0, .buffer = buff0, .size = wgpuBufferGetSize(buff0) },
+        { .binding = 1, .buffer = buff1, .size = wgpuBufferGetSize(buff1) }
+    };
+    const WGPUBindGroupDescriptor bindGroupDesc { .layout = layoutBuffer2RO, .entryCount = 2, .entries = bindGroupEntrys };
+    return wgpuDeviceCreateBindGroup(device, &bindGroupDesc);
+}
+
+
 void WgBindGroupLayouts::releaseBindGroup(WGPUBindGroup& bindGroup)
 {
     if (bindGroup) wgpuBindGroupRelease(bindGroup);
@@ -168,6 +189,8 @@ void WgBindGroupLayouts::initialize(WGPUDevice device)
     const WGPUTextureBindingLayout texture = { .sampleType = WGPUTextureSampleType_Float, .viewDimension = WGPUTextureViewDimension_2D };
     const WGPUStorageTextureBindingLayout storageTextureWO { .access = WGPUStorageTextureAccess_WriteOnly, .format = WGPUTextureFormat_RGBA8Unorm, .viewDimension = WGPUTextureViewDimension_2D };
     const WGPUBufferBindingLayout bufferUniform { .type = WGPUBufferBindingType_Uniform };
+    const WGPUBufferBindingLayout bufferUniformDyn { .type = WGPUBufferBindingType_Uniform, .hasDynamicOffset = true };
+    const WGPUBufferBindingLayout bufferStorageRO { .type = WGPUBufferBindingType_ReadOnlyStorage };
 
     // bind group layout tex sampled with buffer uniforms
     const WGPUBindGroupLayoutEntry entriesTexSampledBufferUniforms[] {
@@ -225,11 +248,30 @@ void WgBindGroupLayouts::initialize(WGPUDevice device)
     assert(layoutBuffer1Un);
     assert(layoutBuffer2Un);
     assert(layoutBuffer3Un);
+
+    // bind group layout buffer uniform with dynamic offset
+    const WGPUBindGroupLayoutEntry entriesBufferUniformDyn[] {
+        { .binding = 0, .visibility = visibility_vert, .buffer = bufferUniformDyn }
+    };
+    const WGPUBindGroupLayoutDescriptor layoutDescBufferUniform1UnDyn { .entryCount = 1, .entries = entriesBufferUniformDyn };
+    layoutBuffer1UnDyn = wgpuDeviceCreateBindGroupLayout(device, &layoutDescBufferUniform1UnDyn);
+    assert(layoutBuffer1UnDyn);
+
+    // bind group layout buffer storages RO
+    const WGPUBindGroupLayoutEntry entriesBufferStorageRO[] {
+        { .binding = 0, .visibility = WGPUShaderStage_Compute, .buffer = bufferStorageRO },
+        { .binding = 1, .visibility = WGPUShaderStage_Compute, .buffer = bufferStorageRO }
+    };
+    const WGPUBindGroupLayoutDescriptor layoutDescBufferStorages2RO { .entryCount = 2, .entries = entriesBufferStorageRO };
+    layoutBuffer2RO = wgpuDeviceCreateBindGroupLayout(device, &layoutDescBufferStorages2RO);
+    assert(layoutBuffer2RO);
 }
 
 
 void WgBindGroupLayouts::release()
 {
+    releaseBindGroupLayout(layoutBuffer2RO);
+    releaseBindGroupLayout(layoutBuffer1UnDyn);
     releaseBindGroupLayout(layoutBuffer3Un);
     releaseBindGroupLayout(layoutBuffer2Un);
     releaseBindGroupLayout(layoutBuffer1Un);
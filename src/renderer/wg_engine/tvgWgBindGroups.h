@@ -39,6 +39,8 @@ public:
     WGPUBindGroupLayout layoutBuffer1Un{};
     WGPUBindGroupLayout layoutBuffer2Un{};
     WGPUBindGroupLayout layoutBuffer3Un{};
+    WGPUBindGroupLayout layoutBuffer1UnDyn{};
+    WGPUBindGroupLayout layoutBuffer2RO{};
 
     WGPUBindGroup createBindGroupTexSampled(WGPUSampler sampler, WGPUTextureView texView);
     WGPUBindGroup createBindGroupTexSampledBuff1Un(WGPUSampler sampler, WGPUTextureView texView, WGPUBuffer buff);
@@ -52,6 +54,10 @@ public:
     WGPUBindGroup createBindGroupBuffer1Un(WGPUBuffer buff, uint64_t offset, uint64_t size);
     WGPUBindGroup createBindGroupBuffer2Un(WGPUBuffer buff0, WGPUBuffer buff1);
     WGPUBindGroup createBindGroupBuffer3Un(WGPUBuffer buff0, WGPUBuffer buff1, WGPUBuffer buff2);
+    // a single uniform of the given size, the item is selected by the dynamic offset
+    WGPUBindGroup createBindGroupBuffer1UnDyn(WGPUBuffer buff, uint64_t size);
+    // read-only storage buffers for compute shaders
+    WGPUBindGroup createBindGroupBuffer2RO(WGPUBuffer buff0, WGPUBuffer buff1);
     void releaseBindGroup(WGPUBindGroup& bindGroup);
     void releaseBindGroupLayout(WGPUBindGroupLayout& bindGroupLayout);
 
@@ -75,35 +75,82 @@ WGPUSampler WgContext::createSampler(WGPUFilterMode filter, WGPUMipmapFilterMode
 }
 
 
-bool WgContext::allocateTexture(WGPUTexture& texture, uint32_t width, uint32_t height, WGPUTextureFormat format, void* data)
+// 2 x 2 box filter of the premultiplied pixels to the next mip level
+static void _halve(const uint32_t* src, uint32_t stride, uint32_t w, uint32_t h, uint32_t* dst, uint32_t dw, uint32_t dh)
 {
-    if ((texture) && (wgpuTextureGetWidth(texture) == width) && (wgpuTextureGetHeight(texture) == height)) {
-        // update texture data
-        const WGPUImageCopyTexture imageCopyTexture{ .texture = texture };
-        const WGPUTextureDataLayout textureDataLayout{ .bytesPerRow = 4 * width, .rowsPerImage = height };
-        const WGPUExtent3D writeSize{ .width = width, .height = height, .depthOrArrayLayers = 1 };
-        wgpuQueueWriteTexture(queue, &imageCopyTexture, data, 4 * width * height, &textureDataLayout, &writeSize);
-    } else {
-        releaseTexture(texture);
-        texture = createTexture(width, height, format);
-        // update texture data
-        const WGPUImageCopyTexture imageCopyTexture{ .texture = texture };
-        const WGPUTextureDataLayout textureDataLayout{ .bytesPerRow = 4 * width, .rowsPerImage = height };
-        const WGPUExtent3D writeSize{ .width = width, .height = height, .depthOrArrayLayers = 1 };
-        wgpuQueueWriteTexture(queue, &imageCopyTexture, data, 4 * width * height, &textureDataLayout, &writeSize);
-        return true;
+    for (uint32_t y = 0; y < dh; ++y) {
+        auto r0 = src + (y * 2) * stride;
+        auto r1 = (y * 2 + 1 < h) ? r0 + stride : r0;
+        for (uint32_t x = 0; x < dw; ++x, ++dst) {
+            auto x0 = x * 2;
+            auto x1 = (x0 + 1 < w) ? x0 + 1 : x0;
+            auto lo = (r0[x0] & 0x00ff00ff) + (r0[x1] & 0x00ff00ff) + (r1[x0] & 0x00ff00ff) + (r1[x1] & 0x00ff00ff) + 0x00020002;
+            auto hi = ((r0[x0] >> 8) & 0x00ff00ff) + ((r0[x1] >> 8) & 0x00ff00ff) + ((r1[x0] >> 8) & 0x00ff00ff) + ((r1[x1] >> 8) & 0x00ff00ff) + 0x00020002;
+            *dst = ((lo >> 2) & 0x00ff00ff) | (((hi >> 2) & 0x00ff00ff) << 8);
+        }
     }
-    return false;
+}
+
 
+static void _writeTexture(WGPUQueue queue, WGPUTexture texture, uint32_t level, uint32_t width, uint32_t height, uint32_t stride, const void* data)
+{
+    const WGPUImageCopyTexture imageCopyTexture{ .texture = texture, .mipLevel = level };
+    const WGPUTextureDataLayout textureDataLayout{ .bytesPerRow = 4 * stride, .rowsPerImage = height };
+    const WGPUExtent3D writeSize{ .width = width, .height = height, .depthOrArrayLayers = 1 };
+    wgpuQueueWriteTexture(queue, &imageCopyTexture, data, 4 * (stride * (height - 1) + width), &textureDataLayout, &writeSize);
 }
 
 
-WGPUTexture WgContext::createTexture(uint32_t width, uint32_t height, WGPUTextureFormat format)
+bool WgContext::allocateTexture(WGPUTexture& texture, uint32_t width, uint32_t height, WGPUTextureFormat format, void* data, bool mipmaps, uint32_t stride)
+{
+    if (stride < width) stride = width;
+
+    // the full chain down to 1x1 for the trilinear sampling of the downscaled images
+    uint32_t mipLevels = 1;
+    if (mipmaps) {
+        for (auto size = (width > height ? width : height); size > 1; size >>= 1) ++mipLevels;
+    }
+
+    bool changed = false;
+    if (!texture || wgpuTextureGetWidth(texture) != width || wgpuTextureGetHeight(texture) != height || wgpuTextureGetMipLevelCount(texture) != mipLevels) {
+        releaseTexture(texture);
+        texture = createTexture(width, height, format, mipLevels);
+        changed = true;
+    }
+    // update texture data
+    _writeTexture(queue, texture, 0, width, height, stride, data);
+
+    // the mip levels are built on the cpu, the pixels are there already
+    if (mipLevels > 1) {
+        auto w1 = width > 1 ? width >> 1 : 1;
+        auto h1 = height > 1 ? height >> 1 : 1;
+        auto buffer = tvg::malloc<uint32_t*>(sizeof(uint32_t) * w1 * h1 * 2);
+        auto src = (const uint32_t*)data;
+        auto dst = buffer;
+        auto w = width, h = height;
+        for (uint32_t level = 1; level < mipLevels; ++level) {
+            auto dw = w > 1 ? w >> 1 : 1;
+            auto dh = h > 1 ? h >> 1 : 1;
+            _halve(src, (level == 1) ? stride : w, w, h, dst, dw, dh);
+            _writeTexture(queue, texture, level, dw, dh, dw, dst);
+            // ping-pong in the two halves of the buffer
+            src = dst;
+            dst = (dst == buffer) ? buffer + w1 * h1 : buffer;
+            w = dw;
+            h = dh;
+        }
+        tvg::free(buffer);
+    }
+    return changed;
+}
+
+
+WGPUTexture WgContext::createTexture(uint32_t width, uint32_t height, WGPUTextureFormat format, uint32_t mipLevels)
 {
     const WGPUTextureDescriptor textureDesc {
         .usage = WGPUTextureUsage_CopyDst | WGPUTextureUsage_TextureBinding,
         .dimension = WGPUTextureDimension_2D, .size = { width, height, 1 },
-        .format = format, .mipLevelCount = 1, .sampleCount = 1
+        .format = format, .mipLevelCount = mipLevels, .sampleCount = 1
     };
     return wgpuDeviceCreateTexture(device, &textureDesc);
 }
@@ -137,7 +184,7 @@ WGPUTextureView WgContext::createTextureView(WGPUTexture texture)
         .format = wgpuTextureGetFormat(texture),
         .dimension = WGPUTextureViewDimension_2D,
         .baseMipLevel = 0,
-        .mipLevelCount = 1,
+        .mipLevelCount = wgpuTextureGetMipLevelCount(texture),
         .baseArrayLayer = 0,
         .arrayLayerCount = 1,
         .aspect = WGPUTextureAspect_All
@@ -195,8 +242,10 @@ bool WgContext::allocateBufferVertex(WGPUBuffer& buffer, const float* data, uint
     if ((buffer) && (wgpuBufferGetSize(buffer) >= size))
         wgpuQueueWriteBuffer(queue, buffer, 0, data, size);
     else {
+        // grow twice at least, the stage data grows by frames
+        auto capacity = buffer ? std::max(size, wgpuBufferGetSize(buffer) * 2) : size;
         releaseBuffer(buffer);
-        const WGPUBufferDescriptor bufferDesc { .usage = WGPUBufferUsage_CopyDst | WGPUBufferUsage_Vertex, .size = size };
+        const WGPUBufferDescriptor bufferDesc { .usage = WGPUBufferUsage_CopyDst | WGPUBufferUsage_Vertex | WGPUBufferUsage_Storage, .size = capacity };
         buffer = wgpuDeviceCreateBuffer(device, &bufferDesc);
         wgpuQueueWriteBuffer(queue, buffer, 0, data, size);
         return true;
@@ -210,8 +259,10 @@ bool WgContext::allocateBufferIndex(WGPUBuffer& buffer, const uint32_t* data, ui
     if ((buffer) && (wgpuBufferGetSize(buffer) >= size))
         wgpuQueueWriteBuffer(queue, buffer, 0, data, size);
     else {
+        // grow twice at least, the stage data grows by frames
+        auto capacity = buffer ? std::max(size, wgpuBufferGetSize(buffer) * 2) : size;
         releaseBuffer(buffer);
-        const WGPUBufferDescriptor bufferDesc { .usage = WGPUBufferUsage_CopyDst | WGPUBufferUsage_Index, .size = size };
+        const WGPUBufferDescriptor bufferDesc { .usage = WGPUBufferUsage_CopyDst | WGPUBufferUsage_Index | WGPUBufferUsage_Storage, .size = capacity };
         buffer = wgpuDeviceCreateBuffer(device, &bufferDesc);
         wgpuQueueWriteBuffer(queue, buffer, 0, data, size);
         return true;
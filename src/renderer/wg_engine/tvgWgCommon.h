@@ -46,11 +46,11 @@ struct WgContext {
     
     // create common objects
     WGPUSampler createSampler(WGPUFilterMode filter, WGPUMipmapFilterMode mipmapFilter, WGPUAddressMode addrMode, uint16_t anisotropy = 1);
-    WGPUTexture createTexture(uint32_t width, uint32_t height, WGPUTextureFormat format);
+    WGPUTexture createTexture(uint32_t width, uint32_t height, WGPUTextureFormat format, uint32_t mipLevels = 1);
     WGPUTexture createTexStorage(uint32_t width, uint32_t height, WGPUTextureFormat format);
     WGPUTexture createTexAttachement(uint32_t width, uint32_t height, WGPUTextureFormat format, uint32_t sc);
     WGPUTextureView createTextureView(WGPUTexture texture);
-    bool allocateTexture(WGPUTexture& texture, uint32_t width, uint32_t height, WGPUTextureFormat format, void* data);
+    bool allocateTexture(WGPUTexture& texture, uint32_t width, uint32_t height, WGPUTextureFormat format, void* data, bool mipmaps = false, uint32_t stride = 0);
 
     // release common objects
     void releaseTextureView(WGPUTextureView& textureView);
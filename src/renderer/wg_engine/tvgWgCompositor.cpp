@@ -28,6 +28,9 @@ void WgCompositor::initialize(WgContext& context, uint32_t width, uint32_t heigh
 {
     // pipelines (external handle, do not release)
     pipelines.initialize(context);
+#ifdef THORVG_WG_COMPUTE_RASTER_SUPPORT
+    pipelines.initializeRaster(context);
+#endif
     stageBufferGeometry.initialize(context);
     // initialize opacity pool
     initPools(context);
@@ -64,6 +67,8 @@ void WgCompositor::release(WgContext& context)
     context.layouts.releaseBindGroup(bindGroupViewMat);
     context.releaseBuffer(bufferViewMat);
     // release stage buffer
+    context.layouts.releaseBindGroup(bindGroupGeometry);
+    stageBufferRaster.release(context);
     stageBufferPaint.release(context);
     stageBufferGeometry.release(context);
     // release pipelines
@@ -175,6 +180,7 @@ void WgCompositor::beginRenderPass(WGPUCommandEncoder commandEncoder, WgRenderTa
     WGPURenderPassDescriptor renderPassDesc{ .colorAttachmentCount = 1, .colorAttachments = &colorAttachment, .depthStencilAttachment = &depthStencilAttachment };
     renderPassEncoder = wgpuCommandEncoderBeginRenderPass(commandEncoder, &renderPassDesc);
     assert(renderPassEncoder);
+    passState = {};
 }
 
 
@@ -189,10 +195,56 @@ void WgCompositor::endRenderPass()
     }
 }
 
+// a new pass starts with the default states, then the commands repeating the bound state are dropped
+void WgCompositor::setPipeline(WGPURenderPipeline pipeline)
+{
+    if (passState.pipeline == pipeline) return;
+    passState.pipeline = pipeline;
+    wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipeline);
+}
+
+
+void WgCompositor::setBindGroup(uint32_t index, WGPUBindGroup bindGroup, const uint32_t* offset)
+{
+    auto dynamic = offset ? *offset : 0;
+    if (passState.bindGroups[index] == bindGroup && passState.offsets[index] == dynamic) return;
+    passState.bindGroups[index] = bindGroup;
+    passState.offsets[index] = dynamic;
+    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, index, bindGroup, offset ? 1 : 0, offset);
+}
+
+
+void WgCompositor::setScissorRect(int32_t x, int32_t y, int32_t w, int32_t h)
+{
+    RenderRegion scissor{{x, y}, {x + w, y + h}};
+    if (passState.scissored && passState.scissor == scissor) return;
+    passState.scissored = true;
+    passState.scissor = scissor;
+    wgpuRenderPassEncoderSetScissorRect(renderPassEncoder, x, y, w, h);
+}
+
+
+void WgCompositor::setStencilReference(uint32_t reference)
+{
+    if (passState.stencilReference == reference) return;
+    passState.stencilReference = reference;
+    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, reference);
+}
+
+
+void WgCompositor::setIndexBuffer()
+{
+    if (passState.ibuffer == stageBufferGeometry.ibuffer_gpu) return;
+    passState.ibuffer = stageBufferGeometry.ibuffer_gpu;
+    wgpuRenderPassEncoderSetIndexBuffer(renderPassEncoder, passState.ibuffer, WGPUIndexFormat_Uint32, 0, WGPU_WHOLE_SIZE);
+}
+
+
 void WgCompositor::reset(WgContext& context)
 {
     stageBufferGeometry.clear();
     stageBufferPaint.clear();
+    stageBufferRaster.clear();
 }
 
 
@@ -201,6 +253,12 @@ void WgCompositor::flush(WgContext& context)
     stageBufferGeometry.append(&meshDataBlit);
     stageBufferGeometry.flush(context);
     stageBufferPaint.flush(context);
+    // the geometry buffers may be reallocated on the flush
+    if (pipelines.raster) {
+        stageBufferRaster.flush(context);
+        context.layouts.releaseBindGroup(bindGroupGeometry);
+        bindGroupGeometry = context.layouts.createBindGroupBuffer2RO(stageBufferGeometry.vbuffer_gpu, stageBufferGeometry.ibuffer_gpu);
+    }
     context.submit();
 }
 
@@ -210,6 +268,19 @@ void WgCompositor::requestShape(WgRenderDataShape* renderData)
     stageBufferGeometry.append(renderData);
     renderData->renderSettingsShape.bindGroupInd = stageBufferPaint.append(renderData->renderSettingsShape.settings);
     renderData->renderSettingsStroke.bindGroupInd = stageBufferPaint.append(renderData->renderSettingsStroke.settings);
+    renderData->raster = rasterable(renderData);
+    if (renderData->raster) {
+        WgShaderTypeRasterSettings raster;
+        raster.viewport[0] = renderData->viewport.x();
+        raster.viewport[1] = renderData->viewport.y();
+        raster.viewport[2] = renderData->viewport.max.x;
+        raster.viewport[3] = renderData->viewport.max.y;
+        raster.offsets[0] = renderData->meshShape.voffset / sizeof(Point);
+        raster.offsets[1] = renderData->meshShape.ioffset / sizeof(uint32_t);
+        raster.offsets[2] = renderData->meshShape.ibuffer.count / 3;
+        raster.offsets[3] = (renderData->fillRule == FillRule::EvenOdd) ? 1 : 0;
+        renderData->rasterInd = stageBufferRaster.append(raster);
+    }
     ARRAY_FOREACH(p, renderData->clips)
         requestShape((WgRenderDataShape* )(*p));
 }
@@ -298,16 +369,16 @@ void WgCompositor::composeScene(WgContext& context, WgRenderTarget* src, WgRende
     assert(mask);
     assert(renderPassEncoder);
     RenderRegion rect = shrinkRenderRegion(cmp->aabb);
-    wgpuRenderPassEncoderSetScissorRect(renderPassEncoder, rect.x(), rect.y(), rect.w(), rect.h());
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, src->bindGroupTexure, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, mask->bindGroupTexure, 0, nullptr);
-    wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.scene_compose[(uint32_t)cmp->method]);
+    setScissorRect(rect.x(), rect.y(), rect.w(), rect.h());
+    setStencilReference(0);
+    setBindGroup(0, src->bindGroupTexure);
+    setBindGroup(1, mask->bindGroupTexure);
+    setPipeline(pipelines.compose((uint32_t)cmp->method));
     drawMeshImage(context, &meshDataBlit);
 }
 
 
-void WgCompositor::blit(WgContext& context, WGPUCommandEncoder encoder, WgRenderTarget* src, WGPUTextureView dstView)
+void WgCompositor::blit(WgContext& context, WGPUCommandEncoder encoder, WgRenderTarget* src, WGPUTextureView dstView, const RenderRegion& rect)
 {
     assert(!renderPassEncoder);
     const WGPURenderPassDepthStencilAttachment depthStencilAttachment{ 
@@ -325,8 +396,11 @@ void WgCompositor::blit(WgContext& context, WGPUCommandEncoder encoder, WgRender
     };
     const WGPURenderPassDescriptor renderPassDesc{ .colorAttachmentCount = 1, .colorAttachments = &colorAttachment, .depthStencilAttachment = &depthStencilAttachment };
     renderPassEncoder = wgpuCommandEncoderBeginRenderPass(encoder, &renderPassDesc);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, src->bindGroupTexure, 0, nullptr);
-    wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.blit);
+    passState = {};
+    // the destination content is loaded, only the given area is replaced
+    setScissorRect(rect.x(), rect.y(), rect.w(), rect.h());
+    setBindGroup(0, src->bindGroupTexure);
+    setPipeline(pipelines.blit);
     drawMeshImage(context, &meshDataBlit);
     wgpuRenderPassEncoderEnd(renderPassEncoder);
     wgpuRenderPassEncoderRelease(renderPassEncoder);
@@ -338,12 +412,13 @@ void WgCompositor::drawMesh(WgContext& context, WgMeshData* meshData)
 {
     assert(meshData);
     assert(renderPassEncoder);
-    uint64_t icount = meshData->ibuffer.count;
-    uint64_t vsize = meshData->vbuffer.count * sizeof(Point);
-    uint64_t isize = icount * sizeof(uint32_t);
-    wgpuRenderPassEncoderSetVertexBuffer(renderPassEncoder, 0, stageBufferGeometry.vbuffer_gpu, meshData->voffset, vsize);
-    wgpuRenderPassEncoderSetIndexBuffer(renderPassEncoder, stageBufferGeometry.ibuffer_gpu, WGPUIndexFormat_Uint32, meshData->ioffset, isize);
-    wgpuRenderPassEncoderDrawIndexed(renderPassEncoder, icount, 1, 0, 0, 0);
+    // the whole geometry stays bound, the mesh is picked by its first index and base vertex
+    if (passState.vbuffer != stageBufferGeometry.vbuffer_gpu) {
+        passState.vbuffer = stageBufferGeometry.vbuffer_gpu;
+        wgpuRenderPassEncoderSetVertexBuffer(renderPassEncoder, 0, passState.vbuffer, 0, WGPU_WHOLE_SIZE);
+    }
+    setIndexBuffer();
+    wgpuRenderPassEncoderDrawIndexed(renderPassEncoder, meshData->ibuffer.count, 1, meshData->ioffset / sizeof(uint32_t), meshData->voffset / sizeof(Point), 0);
 };
 
 
@@ -351,50 +426,119 @@ void WgCompositor::drawMeshImage(WgContext& context, WgMeshData* meshData)
 {
     assert(meshData);
     assert(renderPassEncoder);
-    uint64_t icount = meshData->ibuffer.count;
     uint64_t vsize = meshData->vbuffer.count * sizeof(Point);
-    uint64_t isize = icount * sizeof(uint32_t);
+    // the texture coordinates follow their vertices, the both are bound at the mesh
+    passState.vbuffer = nullptr;
     wgpuRenderPassEncoderSetVertexBuffer(renderPassEncoder, 0, stageBufferGeometry.vbuffer_gpu, meshData->voffset, vsize);
     wgpuRenderPassEncoderSetVertexBuffer(renderPassEncoder, 1, stageBufferGeometry.vbuffer_gpu, meshData->toffset, vsize);
-    wgpuRenderPassEncoderSetIndexBuffer(renderPassEncoder, stageBufferGeometry.ibuffer_gpu, WGPUIndexFormat_Uint32, meshData->ioffset, isize);
-    wgpuRenderPassEncoderDrawIndexed(renderPassEncoder, icount, 1, 0, 0, 0);
+    setIndexBuffer();
+    wgpuRenderPassEncoderDrawIndexed(renderPassEncoder, meshData->ibuffer.count, 1, meshData->ioffset / sizeof(uint32_t), 0, 0);
 };
 
 
+// the complex solid fills only, the compute pass breaks the current render pass
+bool WgCompositor::rasterable(WgRenderDataShape* renderData)
+{
+    if (!pipelines.raster || renderData->clips.count > 0 || renderData->viewport.invalid()) return false;
+    auto& settings = renderData->renderSettingsShape;
+    if (settings.skip || settings.fillType != WgRenderSettingsType::Solid || renderData->convex) return false;
+    return renderData->meshShape.ibuffer.count / 3 >= WG_RASTER_MIN_TRIANGLES;
+}
+
+
+void WgCompositor::rasterShape(WgContext& context, WgRenderDataShape* renderData)
+{
+    assert(renderData);
+    assert(renderPassEncoder);
+    WgRenderSettings& settings = renderData->renderSettingsShape;
+    const RenderRegion& vp = renderData->viewport;
+    // compute the shape coverage into the intermediate target
+    WgRenderTarget *target = currentTarget;
+    endRenderPass();
+    WGPUComputePassDescriptor computePassDesc{ .label = "Compute pass path raster" };
+    WGPUComputePassEncoder computePassEncoder = wgpuCommandEncoderBeginComputePass(commandEncoder, &computePassDesc);
+    wgpuComputePassEncoderSetBindGroup(computePassEncoder, 0, targetTemp1.bindGroupWrite, 0, nullptr);
+    wgpuComputePassEncoderSetBindGroup(computePassEncoder, 1, stageBufferPaint.bindGroup(), 1, stageBufferPaint.offset(settings.bindGroupInd));
+    wgpuComputePassEncoderSetBindGroup(computePassEncoder, 2, stageBufferRaster.bindGroup(), 1, stageBufferRaster.offset(renderData->rasterInd));
+    wgpuComputePassEncoderSetBindGroup(computePassEncoder, 3, bindGroupGeometry, 0, nullptr);
+    wgpuComputePassEncoderSetPipeline(computePassEncoder, pipelines.raster);
+    wgpuComputePassEncoderDispatchWorkgroups(computePassEncoder, (vp.w() + 15) / 16, (vp.h() + 15) / 16, 1);
+    wgpuComputePassEncoderEnd(computePassEncoder);
+    wgpuComputePassEncoderRelease(computePassEncoder);
+    // blend the premultiplied coverage over the target
+    beginRenderPass(commandEncoder, target, false);
+    setScissorRect(vp.x(), vp.y(), vp.w(), vp.h());
+    setStencilReference(0);
+    setBindGroup(0, targetTemp1.bindGroupTexure);
+    setBindGroup(1, bindGroupOpacities[255]);
+    setPipeline(pipelines.scene);
+    drawMeshImage(context, &meshDataBlit);
+}
+
+
 void WgCompositor::drawShape(WgContext& context, WgRenderDataShape* renderData)
 {
     assert(renderData);
     assert(renderPassEncoder);
     if (renderData->renderSettingsShape.skip || renderData->meshShape.vbuffer.count == 0 || renderData->viewport.invalid()) return;
+    if (renderData->raster) {
+        rasterShape(context, renderData);
+        return;
+    }
     WgRenderSettings& settings = renderData->renderSettingsShape;
-    wgpuRenderPassEncoderSetScissorRect(renderPassEncoder, renderData->viewport.x(), renderData->viewport.y(), renderData->viewport.w(), renderData->viewport.h());
+    setScissorRect(renderData->viewport.x(), renderData->viewport.y(), renderData->viewport.w(), renderData->viewport.h());
+    if (renderData->convex) {
+        drawConvexShape(context, renderData);
+        return;
+    }
     // setup stencil rules
     WGPURenderPipeline stencilPipeline = (renderData->fillRule == FillRule::NonZero) ? pipelines.nonzero : pipelines.evenodd;
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, bindGroupViewMat, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-    wgpuRenderPassEncoderSetPipeline(renderPassEncoder, stencilPipeline);
+    setStencilReference(0);
+    setBindGroup(0, bindGroupViewMat);
+    setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+    setPipeline(stencilPipeline);
     // draw to stencil (first pass)
     drawMesh(context, &renderData->meshShape);
     // setup fill rules
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, bindGroupViewMat, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
+    setStencilReference(0);
+    setBindGroup(0, bindGroupViewMat);
+    setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
     if (settings.fillType == WgRenderSettingsType::Solid) {
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.solid);
+        setBindGroup(2, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+        setPipeline(pipelines.solid);
     } else if (settings.fillType == WgRenderSettingsType::Linear) {
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, settings.gradientData.bindGroup, 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.linear);
+        setBindGroup(2, settings.gradientData.bindGroup);
+        setPipeline(pipelines.linear);
     } else if (settings.fillType == WgRenderSettingsType::Radial) {
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, settings.gradientData.bindGroup, 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.radial);
+        setBindGroup(2, settings.gradientData.bindGroup);
+        setPipeline(pipelines.radial);
     }
     // draw to color (second pass)
     drawMesh(context, &renderData->meshBBox);
 }
 
 
+// the convex fan covers every pixel once, the fill is drawn without the stencil pass
+void WgCompositor::drawConvexShape(WgContext& context, WgRenderDataShape* renderData)
+{
+    WgRenderSettings& settings = renderData->renderSettingsShape;
+    setStencilReference(0);
+    setBindGroup(0, bindGroupViewMat);
+    setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+    if (settings.fillType == WgRenderSettingsType::Solid) {
+        setBindGroup(2, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+        setPipeline(pipelines.solid_convex);
+    } else if (settings.fillType == WgRenderSettingsType::Linear) {
+        setBindGroup(2, settings.gradientData.bindGroup);
+        setPipeline(pipelines.linear_convex);
+    } else if (settings.fillType == WgRenderSettingsType::Radial) {
+        setBindGroup(2, settings.gradientData.bindGroup);
+        setPipeline(pipelines.radial_convex);
+    }
+    drawMesh(context, &renderData->meshShape);
+}
+
+
 void WgCompositor::blendShape(WgContext& context, WgRenderDataShape* renderData, BlendMethod blendMethod)
 {
     assert(renderData);
@@ -407,30 +551,30 @@ void WgCompositor::blendShape(WgContext& context, WgRenderDataShape* renderData,
     copyTexture(&targetTemp0, target);
     beginRenderPass(commandEncoder, target, false);
     // render shape with blend settings
-    wgpuRenderPassEncoderSetScissorRect(renderPassEncoder, renderData->viewport.x(), renderData->viewport.y(), renderData->viewport.w(), renderData->viewport.h());
+    setScissorRect(renderData->viewport.x(), renderData->viewport.y(), renderData->viewport.w(), renderData->viewport.h());
     // setup stencil rules
     WGPURenderPipeline stencilPipeline = (renderData->fillRule == FillRule::NonZero) ? pipelines.nonzero : pipelines.evenodd;
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, bindGroupViewMat, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-    wgpuRenderPassEncoderSetPipeline(renderPassEncoder, stencilPipeline);
+    setStencilReference(0);
+    setBindGroup(0, bindGroupViewMat);
+    setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+    setPipeline(stencilPipeline);
     // draw to stencil (first pass)
     drawMesh(context, &renderData->meshShape);
     // setup fill rules
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, bindGroupViewMat, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 3, targetTemp0.bindGroupTexure, 0, nullptr);
+    setStencilReference(0);
+    setBindGroup(0, bindGroupViewMat);
+    setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+    setBindGroup(3, targetTemp0.bindGroupTexure);
     uint32_t blendMethodInd = (uint32_t)blendMethod;
     if (settings.fillType == WgRenderSettingsType::Solid) {
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.solid_blend[blendMethodInd]);
+        setBindGroup(2, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+        setPipeline(pipelines.blend(WgBlendPipeline::Solid, blendMethodInd));
     } else if (settings.fillType == WgRenderSettingsType::Linear) {
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, settings.gradientData.bindGroup, 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.linear_blend[blendMethodInd]);
+        setBindGroup(2, settings.gradientData.bindGroup);
+        setPipeline(pipelines.blend(WgBlendPipeline::Linear, blendMethodInd));
     } else if (settings.fillType == WgRenderSettingsType::Radial) {
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, settings.gradientData.bindGroup, 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.radial_blend[blendMethodInd]);
+        setBindGroup(2, settings.gradientData.bindGroup);
+        setPipeline(pipelines.blend(WgBlendPipeline::Radial, blendMethodInd));
     }
     // draw to color (second pass)
     drawMesh(context, &renderData->meshBBox);
@@ -443,33 +587,33 @@ void WgCompositor::clipShape(WgContext& context, WgRenderDataShape* renderData)
     assert(renderPassEncoder);
     if (renderData->renderSettingsShape.skip || renderData->meshShape.vbuffer.count == 0 || renderData->viewport.invalid()) return;
     WgRenderSettings& settings = renderData->renderSettingsShape;
-    wgpuRenderPassEncoderSetScissorRect(renderPassEncoder, renderData->viewport.x(), renderData->viewport.y(), renderData->viewport.w(), renderData->viewport.h());
+    setScissorRect(renderData->viewport.x(), renderData->viewport.y(), renderData->viewport.w(), renderData->viewport.h());
     // setup stencil rules
     WGPURenderPipeline stencilPipeline = (renderData->fillRule == FillRule::NonZero) ? pipelines.nonzero : pipelines.evenodd;
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, bindGroupViewMat, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-    wgpuRenderPassEncoderSetPipeline(renderPassEncoder, stencilPipeline);
+    setStencilReference(0);
+    setBindGroup(0, bindGroupViewMat);
+    setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+    setPipeline(stencilPipeline);
     // draw to stencil (first pass)
     drawMesh(context, &renderData->meshShape);
     // merge depth and stencil buffer
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, bindGroupOpacities[128], 0, nullptr);
-    wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.merge_depth_stencil);
+    setStencilReference(0);
+    setBindGroup(2, bindGroupOpacities[128]);
+    setPipeline(pipelines.merge_depth_stencil);
     drawMesh(context, &renderData->meshBBox);
     // setup fill rules
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, bindGroupViewMat, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
+    setStencilReference(0);
+    setBindGroup(0, bindGroupViewMat);
+    setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
     if (settings.fillType == WgRenderSettingsType::Solid) {
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.solid);
+        setBindGroup(2, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+        setPipeline(pipelines.solid);
     } else if (settings.fillType == WgRenderSettingsType::Linear) {
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, settings.gradientData.bindGroup, 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.linear);
+        setBindGroup(2, settings.gradientData.bindGroup);
+        setPipeline(pipelines.linear);
     } else if (settings.fillType == WgRenderSettingsType::Radial) {
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, settings.gradientData.bindGroup, 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.radial);
+        setBindGroup(2, settings.gradientData.bindGroup);
+        setPipeline(pipelines.radial);
     }
     // draw to color (second pass)
     drawMesh(context, &renderData->meshBBox);
@@ -482,28 +626,28 @@ void WgCompositor::drawStrokes(WgContext& context, WgRenderDataShape* renderData
     assert(renderPassEncoder);
     if (renderData->renderSettingsStroke.skip || renderData->meshStrokes.vbuffer.count == 0 || renderData->viewport.invalid()) return;
     WgRenderSettings& settings = renderData->renderSettingsStroke;
-    wgpuRenderPassEncoderSetScissorRect(renderPassEncoder, renderData->viewport.x(), renderData->viewport.y(), renderData->viewport.w(), renderData->viewport.h());
+    setScissorRect(renderData->viewport.x(), renderData->viewport.y(), renderData->viewport.w(), renderData->viewport.h());
     // draw strokes to stencil (first pass)
     // setup stencil rules
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 255);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, bindGroupViewMat, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-    wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.direct);
+    setStencilReference(255);
+    setBindGroup(0, bindGroupViewMat);
+    setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+    setPipeline(pipelines.direct);
     // draw to stencil (first pass)
     drawMesh(context, &renderData->meshStrokes);
     // setup fill rules
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, bindGroupViewMat, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
+    setStencilReference(0);
+    setBindGroup(0, bindGroupViewMat);
+    setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
     if (settings.fillType == WgRenderSettingsType::Solid) {
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.solid);
+        setBindGroup(2, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+        setPipeline(pipelines.solid);
     } else if (settings.fillType == WgRenderSettingsType::Linear) {
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, settings.gradientData.bindGroup, 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.linear);
+        setBindGroup(2, settings.gradientData.bindGroup);
+        setPipeline(pipelines.linear);
     } else if (settings.fillType == WgRenderSettingsType::Radial) {
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, settings.gradientData.bindGroup, 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.radial);
+        setBindGroup(2, settings.gradientData.bindGroup);
+        setPipeline(pipelines.radial);
     }
     // draw to color (second pass)
     drawMesh(context, &renderData->meshStrokesBBox);
@@ -521,30 +665,30 @@ void WgCompositor::blendStrokes(WgContext& context, WgRenderDataShape* renderDat
     endRenderPass();
     copyTexture(&targetTemp0, target);
     beginRenderPass(commandEncoder, target, false);
-    wgpuRenderPassEncoderSetScissorRect(renderPassEncoder, renderData->viewport.x(), renderData->viewport.y(), renderData->viewport.w(), renderData->viewport.h());
+    setScissorRect(renderData->viewport.x(), renderData->viewport.y(), renderData->viewport.w(), renderData->viewport.h());
     // draw strokes to stencil (first pass)
     // setup stencil rules
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 255);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, bindGroupViewMat, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-    wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.direct);
+    setStencilReference(255);
+    setBindGroup(0, bindGroupViewMat);
+    setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+    setPipeline(pipelines.direct);
     // draw to stencil (first pass)
     drawMesh(context, &renderData->meshStrokes);
     // setup fill rules
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, bindGroupViewMat, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 3, targetTemp0.bindGroupTexure, 0, nullptr);
+    setStencilReference(0);
+    setBindGroup(0, bindGroupViewMat);
+    setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+    setBindGroup(3, targetTemp0.bindGroupTexure);
     uint32_t blendMethodInd = (uint32_t)blendMethod;
     if (settings.fillType == WgRenderSettingsType::Solid) {
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.solid_blend[blendMethodInd]);
+        setBindGroup(2, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+        setPipeline(pipelines.blend(WgBlendPipeline::Solid, blendMethodInd));
     } else if (settings.fillType == WgRenderSettingsType::Linear) {
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, settings.gradientData.bindGroup, 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.linear_blend[blendMethodInd]);
+        setBindGroup(2, settings.gradientData.bindGroup);
+        setPipeline(pipelines.blend(WgBlendPipeline::Linear, blendMethodInd));
     } else if (settings.fillType == WgRenderSettingsType::Radial) {
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, settings.gradientData.bindGroup, 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.radial_blend[blendMethodInd]);
+        setBindGroup(2, settings.gradientData.bindGroup);
+        setPipeline(pipelines.blend(WgBlendPipeline::Radial, blendMethodInd));
     }
     // draw to color (second pass)
     drawMesh(context, &renderData->meshStrokesBBox);
@@ -557,33 +701,33 @@ void WgCompositor::clipStrokes(WgContext& context, WgRenderDataShape* renderData
     assert(renderPassEncoder);
     if (renderData->renderSettingsStroke.skip || renderData->meshStrokes.vbuffer.count == 0 || renderData->viewport.invalid()) return;
     WgRenderSettings& settings = renderData->renderSettingsStroke;
-    wgpuRenderPassEncoderSetScissorRect(renderPassEncoder, renderData->viewport.x(), renderData->viewport.y(), renderData->viewport.w(), renderData->viewport.h());
+    setScissorRect(renderData->viewport.x(), renderData->viewport.y(), renderData->viewport.w(), renderData->viewport.h());
     // draw strokes to stencil (first pass)
     // setup stencil rules
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 255);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, bindGroupViewMat, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-    wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.direct);
+    setStencilReference(255);
+    setBindGroup(0, bindGroupViewMat);
+    setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+    setPipeline(pipelines.direct);
     // draw to stencil (first pass)
     drawMesh(context, &renderData->meshStrokes);
     // merge depth and stencil buffer
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, bindGroupOpacities[128], 0, nullptr);
-    wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.merge_depth_stencil);
+    setStencilReference(0);
+    setBindGroup(2, bindGroupOpacities[128]);
+    setPipeline(pipelines.merge_depth_stencil);
     drawMesh(context, &renderData->meshBBox);
     // setup fill rules
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, bindGroupViewMat, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
+    setStencilReference(0);
+    setBindGroup(0, bindGroupViewMat);
+    setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
     if (settings.fillType == WgRenderSettingsType::Solid) {
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.solid);
+        setBindGroup(2, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+        setPipeline(pipelines.solid);
     } else if (settings.fillType == WgRenderSettingsType::Linear) {
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, settings.gradientData.bindGroup, 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.linear);
+        setBindGroup(2, settings.gradientData.bindGroup);
+        setPipeline(pipelines.linear);
     } else if (settings.fillType == WgRenderSettingsType::Radial) {
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, settings.gradientData.bindGroup, 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.radial);
+        setBindGroup(2, settings.gradientData.bindGroup);
+        setPipeline(pipelines.radial);
     }
     // draw to color (second pass)
     drawMesh(context, &renderData->meshStrokesBBox);
@@ -596,19 +740,19 @@ void WgCompositor::drawImage(WgContext& context, WgRenderDataPicture* renderData
     assert(renderPassEncoder);
     if (renderData->viewport.invalid()) return;
     WgRenderSettings& settings = renderData->renderSettings;
-    wgpuRenderPassEncoderSetScissorRect(renderPassEncoder, renderData->viewport.x(), renderData->viewport.y(), renderData->viewport.w(), renderData->viewport.h());
+    setScissorRect(renderData->viewport.x(), renderData->viewport.y(), renderData->viewport.w(), renderData->viewport.h());
     // draw stencil
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 255);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, bindGroupViewMat, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-    wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.direct);
+    setStencilReference(255);
+    setBindGroup(0, bindGroupViewMat);
+    setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+    setPipeline(pipelines.direct);
     drawMeshImage(context, &renderData->meshData);
     // draw image
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, bindGroupViewMat, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, renderData->imageData.bindGroup, 0, nullptr);
-    wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.image);
+    setStencilReference(0);
+    setBindGroup(0, bindGroupViewMat);
+    setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+    setBindGroup(2, renderData->imageData.bindGroup);
+    setPipeline(pipelines.image);
     drawMeshImage(context, &renderData->meshData);
 }
 
@@ -619,26 +763,26 @@ void WgCompositor::blendImage(WgContext& context, WgRenderDataPicture* renderDat
     assert(renderPassEncoder);
     if (renderData->viewport.invalid()) return;
     WgRenderSettings& settings = renderData->renderSettings;
-    wgpuRenderPassEncoderSetScissorRect(renderPassEncoder, renderData->viewport.x(), renderData->viewport.y(), renderData->viewport.w(), renderData->viewport.h());
+    setScissorRect(renderData->viewport.x(), renderData->viewport.y(), renderData->viewport.w(), renderData->viewport.h());
     // copy current render target data to dst target
     WgRenderTarget *target = currentTarget;
     endRenderPass();
     copyTexture(&targetTemp0, target);
     beginRenderPass(commandEncoder, target, false);
     // setup stencil rules
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 255);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, bindGroupViewMat, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-    wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.direct);
+    setStencilReference(255);
+    setBindGroup(0, bindGroupViewMat);
+    setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+    setPipeline(pipelines.direct);
     drawMeshImage(context, &renderData->meshData);
     // blend image
     uint32_t blendMethodInd = (uint32_t)blendMethod;
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, bindGroupViewMat, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, renderData->imageData.bindGroup, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 3, targetTemp0.bindGroupTexure, 0, nullptr);
-    wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.image_blend[blendMethodInd]);
+    setStencilReference(0);
+    setBindGroup(0, bindGroupViewMat);
+    setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+    setBindGroup(2, renderData->imageData.bindGroup);
+    setBindGroup(3, targetTemp0.bindGroupTexure);
+    setPipeline(pipelines.blend(WgBlendPipeline::Image, blendMethodInd));
     drawMeshImage(context, &renderData->meshData);
 };
 
@@ -649,24 +793,24 @@ void WgCompositor::clipImage(WgContext& context, WgRenderDataPicture* renderData
     assert(renderPassEncoder);
     if (renderData->viewport.invalid()) return;
     WgRenderSettings& settings = renderData->renderSettings;
-    wgpuRenderPassEncoderSetScissorRect(renderPassEncoder, renderData->viewport.x(), renderData->viewport.y(), renderData->viewport.w(), renderData->viewport.h());
+    setScissorRect(renderData->viewport.x(), renderData->viewport.y(), renderData->viewport.w(), renderData->viewport.h());
     // setup stencil rules
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 255);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, bindGroupViewMat, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-    wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.direct);
+    setStencilReference(255);
+    setBindGroup(0, bindGroupViewMat);
+    setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+    setPipeline(pipelines.direct);
     drawMeshImage(context, &renderData->meshData);
     // merge depth and stencil buffer
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, bindGroupOpacities[128], 0, nullptr);
-    wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.merge_depth_stencil);
+    setStencilReference(0);
+    setBindGroup(2, bindGroupOpacities[128]);
+    setPipeline(pipelines.merge_depth_stencil);
     drawMeshImage(context, &renderData->meshData);
     // draw image
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, bindGroupViewMat, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, renderData->imageData.bindGroup, 0, nullptr);
-    wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.image);
+    setStencilReference(0);
+    setBindGroup(0, bindGroupViewMat);
+    setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+    setBindGroup(2, renderData->imageData.bindGroup);
+    setPipeline(pipelines.image);
     drawMeshImage(context, &renderData->meshData);
 }
 
@@ -678,11 +822,11 @@ void WgCompositor::drawScene(WgContext& context, WgRenderTarget* scene, WgCompos
     assert(currentTarget);
     // draw scene
     RenderRegion rect = shrinkRenderRegion(compose->aabb);
-    wgpuRenderPassEncoderSetScissorRect(renderPassEncoder, rect.x(), rect.y(), rect.w(), rect.h());
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, scene->bindGroupTexure, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, bindGroupOpacities[compose->opacity], 0, nullptr);
-    wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.scene);
+    setScissorRect(rect.x(), rect.y(), rect.w(), rect.h());
+    setStencilReference(0);
+    setBindGroup(0, scene->bindGroupTexure);
+    setBindGroup(1, bindGroupOpacities[compose->opacity]);
+    setPipeline(pipelines.scene);
     drawMeshImage(context, &meshDataBlit);
 }
 
@@ -700,32 +844,32 @@ void WgCompositor::blendScene(WgContext& context, WgRenderTarget* scene, WgCompo
     // blend scene
     uint32_t blendMethodInd = (uint32_t)compose->blend;
     RenderRegion rect = shrinkRenderRegion(compose->aabb);
-    wgpuRenderPassEncoderSetScissorRect(renderPassEncoder, rect.x(), rect.y(), rect.w(), rect.h());
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, scene->bindGroupTexure, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, targetTemp0.bindGroupTexure, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, bindGroupOpacities[compose->opacity], 0, nullptr);
-    wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.scene_blend[blendMethodInd]);
+    setScissorRect(rect.x(), rect.y(), rect.w(), rect.h());
+    setStencilReference(0);
+    setBindGroup(0, scene->bindGroupTexure);
+    setBindGroup(1, targetTemp0.bindGroupTexure);
+    setBindGroup(2, bindGroupOpacities[compose->opacity]);
+    setPipeline(pipelines.blend(WgBlendPipeline::Scene, blendMethodInd));
     drawMeshImage(context, &meshDataBlit);
 }
 
 
 void WgCompositor::markupClipPath(WgContext& context, WgRenderDataShape* renderData)
 {
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, bindGroupViewMat, 0, nullptr);
+    setBindGroup(0, bindGroupViewMat);
     // markup stencil
     if (renderData->meshStrokes.vbuffer.count > 0) {
         WgRenderSettings& settings = renderData->renderSettingsStroke;
-        wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 255);
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.direct);
+        setStencilReference(255);
+        setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+        setPipeline(pipelines.direct);
         drawMesh(context, &renderData->meshStrokes);
     } else {
         WGPURenderPipeline stencilPipeline = (renderData->fillRule == FillRule::NonZero) ? pipelines.nonzero : pipelines.evenodd;
         WgRenderSettings& settings = renderData->renderSettingsShape;
-        wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, stencilPipeline);
+        setStencilReference(0);
+        setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+        setPipeline(stencilPipeline);
         drawMesh(context, &renderData->meshShape);
     }
 }
@@ -737,18 +881,18 @@ void WgCompositor::renderClipPath(WgContext& context, WgRenderDataPaint* paint)
     assert(renderPassEncoder);
     assert(paint->clips.count > 0);
     // reset scissor recr to full screen
-    wgpuRenderPassEncoderSetScissorRect(renderPassEncoder, 0, 0, width, height);
+    setScissorRect(0, 0, width, height);
     // get render data
     WgRenderDataShape* renderData0 = (WgRenderDataShape*)paint->clips[0];
     WgRenderSettings& settings0 = renderData0->renderSettingsShape;
     // markup stencil
     markupClipPath(context, renderData0);
     // copy stencil to depth
-    wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, bindGroupViewMat, 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings0.bindGroupInd], 0, nullptr);
-    wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, bindGroupOpacities[128], 0, nullptr);
-    wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.copy_stencil_to_depth);
+    setStencilReference(0);
+    setBindGroup(0, bindGroupViewMat);
+    setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings0.bindGroupInd));
+    setBindGroup(2, bindGroupOpacities[128]);
+    setPipeline(pipelines.copy_stencil_to_depth);
     drawMesh(context, &renderData0->meshBBox);
     // merge clip pathes with AND logic
     for (auto p = paint->clips.begin() + 1; p < paint->clips.end(); ++p) {
@@ -758,34 +902,34 @@ void WgCompositor::renderClipPath(WgContext& context, WgRenderDataPaint* paint)
         // markup stencil
         markupClipPath(context, renderData);
         // copy stencil to depth (clear stencil)
-        wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, bindGroupOpacities[190], 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.copy_stencil_to_depth_interm);
+        setStencilReference(0);
+        setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+        setBindGroup(2, bindGroupOpacities[190]);
+        setPipeline(pipelines.copy_stencil_to_depth_interm);
         drawMesh(context, &renderData->meshBBox);
         // copy depth to stencil
-        wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 1);
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, bindGroupOpacities[190], 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.copy_depth_to_stencil);
+        setStencilReference(1);
+        setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+        setBindGroup(2, bindGroupOpacities[190]);
+        setPipeline(pipelines.copy_depth_to_stencil);
         drawMesh(context, &renderData->meshBBox);
         // clear depth current (keep stencil)
-        wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, bindGroupOpacities[255], 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.clear_depth);
+        setStencilReference(0);
+        setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+        setBindGroup(2, bindGroupOpacities[255]);
+        setPipeline(pipelines.clear_depth);
         drawMesh(context, &renderData->meshBBox);
         // clear depth original (keep stencil)
-        wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings0.bindGroupInd], 0, nullptr);
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, bindGroupOpacities[255], 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.clear_depth);
+        setStencilReference(0);
+        setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings0.bindGroupInd));
+        setBindGroup(2, bindGroupOpacities[255]);
+        setPipeline(pipelines.clear_depth);
         drawMesh(context, &renderData0->meshBBox);
         // copy stencil to depth (clear stencil)
-        wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, bindGroupOpacities[128], 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.copy_stencil_to_depth);
+        setStencilReference(0);
+        setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+        setBindGroup(2, bindGroupOpacities[128]);
+        setPipeline(pipelines.copy_stencil_to_depth);
         drawMesh(context, &renderData->meshBBox);
     }
 }
@@ -797,17 +941,17 @@ void WgCompositor::clearClipPath(WgContext& context, WgRenderDataPaint* paint)
     assert(renderPassEncoder);
     assert(paint->clips.count > 0);
     // reset scissor recr to full screen
-    wgpuRenderPassEncoderSetScissorRect(renderPassEncoder, 0, 0, width, height);
+    setScissorRect(0, 0, width, height);
     // get render data
     ARRAY_FOREACH(p, paint->clips) {
         WgRenderDataShape* renderData = (WgRenderDataShape*)(*p);
         WgRenderSettings& settings = renderData->renderSettingsShape;
         // set transformations
-        wgpuRenderPassEncoderSetStencilReference(renderPassEncoder, 0);
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 0, bindGroupViewMat, 0, nullptr);
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 1, stageBufferPaint[settings.bindGroupInd], 0, nullptr);
-        wgpuRenderPassEncoderSetBindGroup(renderPassEncoder, 2, bindGroupOpacities[255], 0, nullptr);
-        wgpuRenderPassEncoderSetPipeline(renderPassEncoder, pipelines.clear_depth);
+        setStencilReference(0);
+        setBindGroup(0, bindGroupViewMat);
+        setBindGroup(1, stageBufferPaint.bindGroup(), stageBufferPaint.offset(settings.bindGroupInd));
+        setBindGroup(2, bindGroupOpacities[255]);
+        setPipeline(pipelines.clear_depth);
         drawMesh(context, &renderData->meshBBox);
     }
 }
@@ -815,6 +959,7 @@ void WgCompositor::clearClipPath(WgContext& context, WgRenderDataPaint* paint)
 
 bool WgCompositor::gaussianBlur(WgContext& context, WgRenderTarget* dst, const RenderEffectGaussianBlur* params, const WgCompose* compose)
 {
+    pipelines.initializeEffects();
     assert(dst);
     assert(params);
     assert(params->rd);
@@ -865,6 +1010,7 @@ bool WgCompositor::gaussianBlur(WgContext& context, WgRenderTarget* dst, const R
 
 bool WgCompositor::dropShadow(WgContext& context, WgRenderTarget* dst, const RenderEffectDropShadow* params, const WgCompose* compose)
 {
+    pipelines.initializeEffects();
     assert(dst);
     assert(params);
     assert(params->rd);
@@ -887,7 +1033,7 @@ bool WgCompositor::dropShadow(WgContext& context, WgRenderTarget* dst, const Ren
         wgpuComputePassEncoderSetBindGroup(computePassEncoder, 1, dbuff->bindGroupWrite, 0, nullptr);
         wgpuComputePassEncoderSetBindGroup(computePassEncoder, 2, renderDataParams->bindGroupParams, 0, nullptr);
         wgpuComputePassEncoderSetBindGroup(computePassEncoder, 3, viewport->bindGroupViewport, 0, nullptr);
-        wgpuComputePassEncoderSetPipeline(computePassEncoder, pipelines.gaussian_horz);
+        wgpuComputePassEncoderSetPipeline(computePassEncoder, pipelines.gaussian_horz_alpha);
         wgpuComputePassEncoderDispatchWorkgroups(computePassEncoder, (aabb.sw() - 1) / 128 + 1, aabb.h(), 1);
         std::swap(sbuff, dbuff);
         // vertical blur
@@ -895,7 +1041,7 @@ bool WgCompositor::dropShadow(WgContext& context, WgRenderTarget* dst, const Ren
         wgpuComputePassEncoderSetBindGroup(computePassEncoder, 1, dbuff->bindGroupWrite, 0, nullptr);
         wgpuComputePassEncoderSetBindGroup(computePassEncoder, 2, renderDataParams->bindGroupParams, 0, nullptr);
         wgpuComputePassEncoderSetBindGroup(computePassEncoder, 3, viewport->bindGroupViewport, 0, nullptr);
-        wgpuComputePassEncoderSetPipeline(computePassEncoder, pipelines.gaussian_vert);
+        wgpuComputePassEncoderSetPipeline(computePassEncoder, pipelines.gaussian_vert_alpha);
         wgpuComputePassEncoderDispatchWorkgroups(computePassEncoder, aabb.sw(), (aabb.sh() - 1) / 128 + 1, 1);
         std::swap(sbuff, dbuff);
         wgpuComputePassEncoderEnd(computePassEncoder);
@@ -922,6 +1068,7 @@ bool WgCompositor::dropShadow(WgContext& context, WgRenderTarget* dst, const Ren
 
 bool WgCompositor::fillEffect(WgContext& context, WgRenderTarget* dst, const RenderEffectFill* params, const WgCompose* compose)
 {
+    pipelines.initializeEffects();
     assert(dst);
     assert(params);
     assert(params->rd);
@@ -946,6 +1093,7 @@ bool WgCompositor::fillEffect(WgContext& context, WgRenderTarget* dst, const Ren
 
 bool WgCompositor::tintEffect(WgContext& context, WgRenderTarget* dst, const RenderEffectTint* params, const WgCompose* compose)
 {
+    pipelines.initializeEffects();
     assert(dst);
     assert(params);
     assert(params->rd);
@@ -969,6 +1117,7 @@ bool WgCompositor::tintEffect(WgContext& context, WgRenderTarget* dst, const Ren
 
 bool WgCompositor::tritoneEffect(WgContext& context, WgRenderTarget* dst, const RenderEffectTritone* params, const WgCompose* compose)
 {
+    pipelines.initializeEffects();
     assert(dst);
     assert(params);
     assert(params->rd);
@@ -26,6 +26,9 @@
 #include "tvgWgRenderTarget.h"
 #include "tvgWgRenderData.h"
 
+// the paths with less triangles are cheaper in the stencil-then-cover pipelines
+#define WG_RASTER_MIN_TRIANGLES 256
+
 struct WgCompose: RenderCompositor
 {
     BlendMethod blend{};
@@ -41,6 +44,9 @@ private:
     // stage buffers
     WgStageBufferGeometry stageBufferGeometry{};
     WgStageBufferUniform<WgShaderTypePaintSettings> stageBufferPaint;
+    WgStageBufferUniform<WgShaderTypeRasterSettings> stageBufferRaster;
+    // stage geometry buffers for the compute raster
+    WGPUBindGroup bindGroupGeometry{};
     // global stencil/depth buffer handles
     WGPUTexture texDepthStencil{};
     WGPUTextureView texViewDepthStencil{};
@@ -56,6 +62,17 @@ private:
     WGPURenderPassEncoder renderPassEncoder{};
     WGPUCommandEncoder commandEncoder{};
     WgRenderTarget* currentTarget{};
+    // the states bound in the current render pass
+    struct {
+        WGPURenderPipeline pipeline;
+        WGPUBindGroup bindGroups[4];
+        uint32_t offsets[4];
+        RenderRegion scissor;
+        bool scissored;
+        uint32_t stencilReference;
+        WGPUBuffer vbuffer;  // the whole geometry at the slot 0, see drawMesh()
+        WGPUBuffer ibuffer;
+    } passState{};
     // intermediate render targets
     WgRenderTarget targetTemp0;
     WgRenderTarget targetTemp1;
@@ -71,12 +88,22 @@ private:
     void copyTexture(const WgRenderTarget* dst, const WgRenderTarget* src);
     void copyTexture(const WgRenderTarget* dst, const WgRenderTarget* src, const RenderRegion& region);
 
+    // render pass states
+    void setPipeline(WGPURenderPipeline pipeline);
+    void setBindGroup(uint32_t index, WGPUBindGroup bindGroup, const uint32_t* offset = nullptr);
+    void setScissorRect(int32_t x, int32_t y, int32_t w, int32_t h);
+    void setStencilReference(uint32_t reference);
+    void setIndexBuffer();
+
     // base meshes draw
     void drawMesh(WgContext& context, WgMeshData* meshData);
     void drawMeshImage(WgContext& context, WgMeshData* meshData);
 
     // shapes
+    bool rasterable(WgRenderDataShape* renderData);
+    void rasterShape(WgContext& context, WgRenderDataShape* renderData);
     void drawShape(WgContext& context, WgRenderDataShape* renderData);
+    void drawConvexShape(WgContext& context, WgRenderDataShape* renderData);
     void blendShape(WgContext& context, WgRenderDataShape* renderData, BlendMethod blendMethod);
     void clipShape(WgContext& context, WgRenderDataShape* renderData);
 
@@ -125,7 +152,7 @@ public:
     void composeScene(WgContext& context, WgRenderTarget* src, WgRenderTarget* mask, WgCompose* compose);
 
     // blit render target to texture view (f.e. screen buffer)
-    void blit(WgContext& context, WGPUCommandEncoder encoder, WgRenderTarget* src, WGPUTextureView dstView);
+    void blit(WgContext& context, WGPUCommandEncoder encoder, WgRenderTarget* src, WGPUTextureView dstView, const RenderRegion& rect);
 
     // effects
     bool gaussianBlur(WgContext& context, WgRenderTarget* dst, const RenderEffectGaussianBlur* params, const WgCompose* compose);
@@ -25,6 +25,75 @@
 #include <cstring>
 #include <cassert>
 
+// common pipeline settings
+static const WGPUVertexAttribute vertexAttributesPos[] { { .format = WGPUVertexFormat_Float32x2, .offset = 0, .shaderLocation = 0 } };
+static const WGPUVertexAttribute vertexAttributesTex[] { { .format = WGPUVertexFormat_Float32x2, .offset = 0, .shaderLocation = 1 } };
+static const WGPUVertexBufferLayout vertexBufferLayoutPos { .arrayStride = 8, .stepMode = WGPUVertexStepMode_Vertex, .attributeCount = 1, .attributes = vertexAttributesPos };
+static const WGPUVertexBufferLayout vertexBufferLayoutTex { .arrayStride = 8, .stepMode = WGPUVertexStepMode_Vertex, .attributeCount = 1, .attributes = vertexAttributesTex };
+static const WGPUVertexBufferLayout vertexBufferLayoutsShape[] { vertexBufferLayoutPos };
+static const WGPUVertexBufferLayout vertexBufferLayoutsImage[] { vertexBufferLayoutPos, vertexBufferLayoutTex };
+static const WGPUMultisampleState multisampleState   { .count = 4, .mask = 0xFFFFFFFF, .alphaToCoverageEnabled = false };
+static const WGPUMultisampleState multisampleStateX1 { .count = 1, .mask = 0xFFFFFFFF, .alphaToCoverageEnabled = false };
+static const WGPUTextureFormat offscreenTargetFormat = WGPUTextureFormat_RGBA8Unorm;
+
+// blend states
+static const WGPUBlendComponent blendComponentSrc { .operation = WGPUBlendOperation_Add, .srcFactor = WGPUBlendFactor_One, .dstFactor = WGPUBlendFactor_Zero };
+static const WGPUBlendComponent blendComponentNrm { .operation = WGPUBlendOperation_Add, .srcFactor = WGPUBlendFactor_One, .dstFactor = WGPUBlendFactor_OneMinusSrcAlpha };
+static const WGPUBlendState blendStateSrc { .color = blendComponentSrc, .alpha = blendComponentSrc };
+static const WGPUBlendState blendStateNrm { .color = blendComponentNrm, .alpha = blendComponentNrm };
+
+// blend shader names
+static const char* shaderBlendNames[] {
+    "fs_main_Normal",
+    "fs_main_Multiply",
+    "fs_main_Screen",
+    "fs_main_Overlay",
+    "fs_main_Darken",
+    "fs_main_Lighten",
+    "fs_main_ColorDodge",
+    "fs_main_ColorBurn",
+    "fs_main_HardLight",
+    "fs_main_SoftLight",
+    "fs_main_Difference",
+    "fs_main_Exclusion",
+    "fs_main_Normal", //TODO: a padding for reserved Hue.
+    "fs_main_Normal", //TODO: a padding for reserved Saturation.
+    "fs_main_Normal", //TODO: a padding for reserved Color.
+    "fs_main_Normal", //TODO: a padding for reserved Luminosity.
+    "fs_main_Add",
+    "fs_main_Normal"  //TODO: a padding for reserved Hardmix.
+};
+
+// compose shader names
+static const char* shaderComposeNames[] {
+    "fs_main_None",
+    "fs_main_AlphaMask",
+    "fs_main_InvAlphaMask",
+    "fs_main_LumaMask",
+    "fs_main_InvLumaMask",
+    "fs_main_AddMask",
+    "fs_main_SubtractMask",
+    "fs_main_IntersectMask",
+    "fs_main_DifferenceMask",
+    "fs_main_LightenMask",
+    "fs_main_DarkenMask"
+};
+
+// compose shader blend states
+static const WGPUBlendState composeBlends[] {
+    blendStateNrm, // None
+    blendStateNrm, // AlphaMask
+    blendStateNrm, // InvAlphaMask
+    blendStateNrm, // LumaMask
+    blendStateNrm, // InvLumaMask
+    blendStateSrc, // AddMask
+    blendStateSrc, // SubtractMask
+    blendStateSrc, // IntersectMask
+    blendStateSrc, // DifferenceMask
+    blendStateSrc, // LightenMask
+    blendStateSrc  // DarkenMask
+};
+
 WGPUShaderModule WgPipelines::createShaderModule(WGPUDevice device, const char* label, const char* code)
 {
     WGPUShaderModuleWGSLDescriptor shaderModuleWGSLDesc{};
@@ -146,38 +215,21 @@ WGPUDepthStencilState WgPipelines::makeDepthStencilState(
 
 void WgPipelines::initialize(WgContext& context)
 {
-    // common pipeline settings
-    const WGPUVertexAttribute vertexAttributePos { .format = WGPUVertexFormat_Float32x2, .offset = 0, .shaderLocation = 0 };
-    const WGPUVertexAttribute vertexAttributeTex { .format = WGPUVertexFormat_Float32x2, .offset = 0, .shaderLocation = 1 };
-    const WGPUVertexAttribute vertexAttributesPos[] { vertexAttributePos };
-    const WGPUVertexAttribute vertexAttributesTex[] { vertexAttributeTex };
-    const WGPUVertexBufferLayout vertexBufferLayoutPos { .arrayStride = 8, .stepMode = WGPUVertexStepMode_Vertex, .attributeCount = 1, .attributes = vertexAttributesPos };
-    const WGPUVertexBufferLayout vertexBufferLayoutTex { .arrayStride = 8, .stepMode = WGPUVertexStepMode_Vertex, .attributeCount = 1, .attributes = vertexAttributesTex };
-    const WGPUVertexBufferLayout vertexBufferLayoutsShape[] { vertexBufferLayoutPos };
-    const WGPUVertexBufferLayout vertexBufferLayoutsImage[] { vertexBufferLayoutPos, vertexBufferLayoutTex };
-    const WGPUMultisampleState multisampleState   { .count = 4, .mask = 0xFFFFFFFF, .alphaToCoverageEnabled = false };
-    const WGPUMultisampleState multisampleStateX1 { .count = 1, .mask = 0xFFFFFFFF, .alphaToCoverageEnabled = false };
-    const WGPUTextureFormat offscreenTargetFormat = WGPUTextureFormat_RGBA8Unorm;
-
-    // blend states
-    WGPUBlendComponent blendComponentSrc { .operation = WGPUBlendOperation_Add, .srcFactor = WGPUBlendFactor_One, .dstFactor = WGPUBlendFactor_Zero };
-    WGPUBlendComponent blendComponentNrm { .operation = WGPUBlendOperation_Add, .srcFactor = WGPUBlendFactor_One, .dstFactor = WGPUBlendFactor_OneMinusSrcAlpha };
-    const WGPUBlendState blendStateSrc { .color = blendComponentSrc, .alpha = blendComponentSrc };
-    const WGPUBlendState blendStateNrm { .color = blendComponentNrm, .alpha = blendComponentNrm };
+    device = context.device;
 
     const WgBindGroupLayouts& layouts = context.layouts;
     // bind group layouts helpers
-    const WGPUBindGroupLayout bindGroupLayoutsStencil[] { layouts.layoutBuffer1Un, layouts.layoutBuffer1Un };
-    const WGPUBindGroupLayout bindGroupLayoutsDepth[]   { layouts.layoutBuffer1Un, layouts.layoutBuffer1Un, layouts.layoutBuffer1Un };
+    const WGPUBindGroupLayout bindGroupLayoutsStencil[] { layouts.layoutBuffer1Un, layouts.layoutBuffer1UnDyn };
+    const WGPUBindGroupLayout bindGroupLayoutsDepth[]   { layouts.layoutBuffer1Un, layouts.layoutBuffer1UnDyn, layouts.layoutBuffer1Un };
     // bind group layouts normal blend
-    const WGPUBindGroupLayout bindGroupLayoutsSolid[]    { layouts.layoutBuffer1Un, layouts.layoutBuffer1Un };
-    const WGPUBindGroupLayout bindGroupLayoutsGradient[] { layouts.layoutBuffer1Un, layouts.layoutBuffer1Un, layouts.layoutTexSampled };
-    const WGPUBindGroupLayout bindGroupLayoutsImage[]    { layouts.layoutBuffer1Un, layouts.layoutBuffer1Un, layouts.layoutTexSampled };
+    const WGPUBindGroupLayout bindGroupLayoutsSolid[]    { layouts.layoutBuffer1Un, layouts.layoutBuffer1UnDyn };
+    const WGPUBindGroupLayout bindGroupLayoutsGradient[] { layouts.layoutBuffer1Un, layouts.layoutBuffer1UnDyn, layouts.layoutTexSampled };
+    const WGPUBindGroupLayout bindGroupLayoutsImage[]    { layouts.layoutBuffer1Un, layouts.layoutBuffer1UnDyn, layouts.layoutTexSampled };
     const WGPUBindGroupLayout bindGroupLayoutsScene[]    { layouts.layoutTexSampled, layouts.layoutBuffer1Un };
     // bind group layouts custom blend
-    const WGPUBindGroupLayout bindGroupLayoutsSolidBlend[]    { layouts.layoutBuffer1Un, layouts.layoutBuffer1Un, layouts.layoutBuffer1Un, layouts.layoutTexSampled };
-    const WGPUBindGroupLayout bindGroupLayoutsGradientBlend[] { layouts.layoutBuffer1Un, layouts.layoutBuffer1Un, layouts.layoutTexSampled, layouts.layoutTexSampled };
-    const WGPUBindGroupLayout bindGroupLayoutsImageBlend[]    { layouts.layoutBuffer1Un, layouts.layoutBuffer1Un, layouts.layoutTexSampled, layouts.layoutTexSampled };
+    const WGPUBindGroupLayout bindGroupLayoutsSolidBlend[]    { layouts.layoutBuffer1Un, layouts.layoutBuffer1UnDyn, layouts.layoutBuffer1UnDyn, layouts.layoutTexSampled };
+    const WGPUBindGroupLayout bindGroupLayoutsGradientBlend[] { layouts.layoutBuffer1Un, layouts.layoutBuffer1UnDyn, layouts.layoutTexSampled, layouts.layoutTexSampled };
+    const WGPUBindGroupLayout bindGroupLayoutsImageBlend[]    { layouts.layoutBuffer1Un, layouts.layoutBuffer1UnDyn, layouts.layoutTexSampled, layouts.layoutTexSampled };
     const WGPUBindGroupLayout bindGroupLayoutsSceneBlend[]    { layouts.layoutTexSampled, layouts.layoutTexSampled, layouts.layoutBuffer1Un };
     // bind group layouts scene compose
     const WGPUBindGroupLayout bindGroupLayoutsSceneCompose[] { layouts.layoutTexSampled, layouts.layoutTexSampled };
@@ -200,9 +252,9 @@ void WgPipelines::initialize(WgContext& context)
     // depth stencil state blend, compose and blit
     const WGPUDepthStencilState depthStencilStateShape = makeDepthStencilState(WGPUCompareFunction_Always, false,  WGPUCompareFunction_NotEqual, WGPUStencilOperation_Zero);
     const WGPUDepthStencilState depthStencilStateScene = makeDepthStencilState(WGPUCompareFunction_Always, false,  WGPUCompareFunction_Always, WGPUStencilOperation_Zero);
+    const WGPUDepthStencilState depthStencilStateConvex = makeDepthStencilState(WGPUCompareFunction_Always, false,  WGPUCompareFunction_Always, WGPUStencilOperation_Keep);
 
     // shaders
-    char shaderSourceBuff[16384]{};
     shader_stencil = createShaderModule(context.device, "The shader stencil", cShaderSrc_Stencil);
     shader_depth   = createShaderModule(context.device, "The shader depth", cShaderSrc_Depth);
     // shader normal blend
@@ -211,19 +263,8 @@ void WgPipelines::initialize(WgContext& context)
     shader_linear = createShaderModule(context.device, "The shader linear", cShaderSrc_Linear);
     shader_image  = createShaderModule(context.device, "The shader image",  cShaderSrc_Image);
     shader_scene  = createShaderModule(context.device, "The shader scene",  cShaderSrc_Scene);
-    // shader custom blend
-    shader_solid_blend  = createShaderModule(context.device, "The shader blend solid",  strcat(strcpy(shaderSourceBuff, cShaderSrc_Solid_Blend), cShaderSrc_BlendFuncs));
-    shader_linear_blend = createShaderModule(context.device, "The shader blend linear", strcat(strcpy(shaderSourceBuff, cShaderSrc_Linear_Blend), cShaderSrc_BlendFuncs));
-    shader_radial_blend = createShaderModule(context.device, "The shader blend radial", strcat(strcpy(shaderSourceBuff, cShaderSrc_Radial_Blend), cShaderSrc_BlendFuncs));
-    shader_image_blend  = createShaderModule(context.device, "The shader blend image",  strcat(strcpy(shaderSourceBuff, cShaderSrc_Image_Blend), cShaderSrc_BlendFuncs));
-    shader_scene_blend  = createShaderModule(context.device, "The shader blend scene",  strcat(strcpy(shaderSourceBuff, cShaderSrc_Scene_Blend), cShaderSrc_BlendFuncs));
-    // shader compose
-    shader_scene_compose = createShaderModule(context.device, "The shader scene composition", cShaderSrc_Scene_Compose);
     // shader blit
     shader_blit = createShaderModule(context.device, "The shader blit", cShaderSrc_Blit);
-    // shader effects
-    shader_gauss = createShaderModule(context.device, "The shader effects", cShaderSrc_GaussianBlur);
-    shader_effects = createShaderModule(context.device, "The shader effects", cShaderSrc_Effects);
 
     // layouts
     layout_stencil = createPipelineLayout(context.device, bindGroupLayoutsStencil, 2);
@@ -234,10 +275,11 @@ void WgPipelines::initialize(WgContext& context)
     layout_image    = createPipelineLayout(context.device, bindGroupLayoutsImage, 3);
     layout_scene    = createPipelineLayout(context.device, bindGroupLayoutsScene, 2);
     // layouts custom blend
-    layout_solid_blend    = createPipelineLayout(context.device, bindGroupLayoutsSolidBlend, 4);
-    layout_gradient_blend = createPipelineLayout(context.device, bindGroupLayoutsGradientBlend, 4);
-    layout_image_blend    = createPipelineLayout(context.device, bindGroupLayoutsImageBlend, 4);
-    layout_scene_blend    = createPipelineLayout(context.device, bindGroupLayoutsSceneBlend, 3);
+    layout_blend[(uint32_t)WgBlendPipeline::Solid]  = createPipelineLayout(context.device, bindGroupLayoutsSolidBlend, 4);
+    layout_blend[(uint32_t)WgBlendPipeline::Radial] = createPipelineLayout(context.device, bindGroupLayoutsGradientBlend, 4);
+    layout_blend[(uint32_t)WgBlendPipeline::Linear] = createPipelineLayout(context.device, bindGroupLayoutsGradientBlend, 4);
+    layout_blend[(uint32_t)WgBlendPipeline::Image]  = createPipelineLayout(context.device, bindGroupLayoutsImageBlend, 4);
+    layout_blend[(uint32_t)WgBlendPipeline::Scene]  = createPipelineLayout(context.device, bindGroupLayoutsSceneBlend, 3);
     // layout compose
     layout_scene_compose = createPipelineLayout(context.device, bindGroupLayoutsSceneCompose, 2);
     // layout blit
@@ -325,6 +367,27 @@ void WgPipelines::initialize(WgContext& context)
         layout_gradient, vertexBufferLayoutsShape, 1,
         WGPUColorWriteMask_All, offscreenTargetFormat, blendStateNrm,
         depthStencilStateShape, multisampleState);
+    // render pipeline solid convex
+    solid_convex = createRenderPipeline(
+        context.device, "The render pipeline solid convex",
+        shader_solid, "vs_main", "fs_main",
+        layout_solid, vertexBufferLayoutsShape, 1,
+        WGPUColorWriteMask_All, offscreenTargetFormat, blendStateNrm,
+        depthStencilStateConvex, multisampleState);
+    // render pipeline radial convex
+    radial_convex = createRenderPipeline(
+        context.device, "The render pipeline radial convex",
+        shader_radial, "vs_main", "fs_main",
+        layout_gradient, vertexBufferLayoutsShape, 1,
+        WGPUColorWriteMask_All, offscreenTargetFormat, blendStateNrm,
+        depthStencilStateConvex, multisampleState);
+    // render pipeline linear convex
+    linear_convex = createRenderPipeline(
+        context.device, "The render pipeline linear convex",
+        shader_linear, "vs_main", "fs_main",
+        layout_gradient, vertexBufferLayoutsShape, 1,
+        WGPUColorWriteMask_All, offscreenTargetFormat, blendStateNrm,
+        depthStencilStateConvex, multisampleState);
     // render pipeline image
     image = createRenderPipeline(
         context.device, "The render pipeline image",
@@ -340,107 +403,6 @@ void WgPipelines::initialize(WgContext& context)
         WGPUColorWriteMask_All, offscreenTargetFormat, blendStateNrm,
         depthStencilStateScene, multisampleState);
 
-    // blend shader names
-    const char* shaderBlendNames[] {
-        "fs_main_Normal",
-        "fs_main_Multiply",
-        "fs_main_Screen",
-        "fs_main_Overlay",
-        "fs_main_Darken",
-        "fs_main_Lighten",
-        "fs_main_ColorDodge",
-        "fs_main_ColorBurn",
-        "fs_main_HardLight",
-        "fs_main_SoftLight",
-        "fs_main_Difference",
-        "fs_main_Exclusion",
-        "fs_main_Normal", //TODO: a padding for reserved Hue.
-        "fs_main_Normal", //TODO: a padding for reserved Saturation.
-        "fs_main_Normal", //TODO: a padding for reserved Color.
-        "fs_main_Normal", //TODO: a padding for reserved Luminosity.
-        "fs_main_Add",
-        "fs_main_Normal"  //TODO: a padding for reserved Hardmix.
-    };
-
-    // render pipeline shape blend
-    for (uint32_t i = 0; i < 18; i++) {
-        // blend solid
-        solid_blend[i] = createRenderPipeline(
-            context.device, "The render pipeline solid blend",
-            shader_solid_blend, "vs_main", shaderBlendNames[i],
-            layout_solid_blend, vertexBufferLayoutsShape, 1,
-            WGPUColorWriteMask_All, offscreenTargetFormat, blendStateSrc,
-            depthStencilStateShape, multisampleState);
-        // blend radial
-        radial_blend[i] = createRenderPipeline(
-            context.device, "The render pipeline radial blend",
-            shader_radial_blend, "vs_main", shaderBlendNames[i],
-            layout_gradient_blend, vertexBufferLayoutsShape, 1,
-            WGPUColorWriteMask_All, offscreenTargetFormat, blendStateSrc,
-            depthStencilStateShape, multisampleState);
-        // blend linear
-        linear_blend[i] = createRenderPipeline(
-            context.device, "The render pipeline linear blend",
-            shader_linear_blend, "vs_main", shaderBlendNames[i],
-            layout_gradient_blend, vertexBufferLayoutsShape, 1,
-            WGPUColorWriteMask_All, offscreenTargetFormat, blendStateSrc,
-            depthStencilStateShape, multisampleState);
-        // blend image
-        image_blend[i] = createRenderPipeline(
-            context.device, "The render pipeline image blend",
-            shader_image_blend, "vs_main", shaderBlendNames[i],
-            layout_image_blend, vertexBufferLayoutsImage, 2,
-            WGPUColorWriteMask_All, offscreenTargetFormat, blendStateSrc,
-            depthStencilStateShape, multisampleState);
-        // blend scene
-        scene_blend[i] = createRenderPipeline(
-            context.device, "The render pipeline scene blend",
-            shader_scene_blend, "vs_main", shaderBlendNames[i],
-            layout_scene_blend, vertexBufferLayoutsImage, 2,
-            WGPUColorWriteMask_All, offscreenTargetFormat, blendStateSrc,
-            depthStencilStateScene, multisampleState);
-    }
-
-    // compose shader names
-    const char* shaderComposeNames[] {
-        "fs_main_None",
-        "fs_main_AlphaMask",
-        "fs_main_InvAlphaMask",
-        "fs_main_LumaMask",
-        "fs_main_InvLumaMask",
-        "fs_main_AddMask",
-        "fs_main_SubtractMask",
-        "fs_main_IntersectMask",
-        "fs_main_DifferenceMask",
-        "fs_main_LightenMask",
-        "fs_main_DarkenMask"
-    };
-
-    // compose shader blend states
-    const WGPUBlendState composeBlends[] {
-        blendStateNrm, // None
-        blendStateNrm, // AlphaMask
-        blendStateNrm, // InvAlphaMask
-        blendStateNrm, // LumaMask
-        blendStateNrm, // InvLumaMask
-        blendStateSrc, // AddMask
-        blendStateSrc, // SubtractMask
-        blendStateSrc, // IntersectMask
-        blendStateSrc, // DifferenceMask
-        blendStateSrc, // LightenMask
-        blendStateSrc  // DarkenMask
-    };
-
-    // render pipeline scene composition
-    for (uint32_t i = 0; i < 11; i++) {
-        scene_compose[i] = createRenderPipeline(
-            context.device, "The render pipeline scene composition",
-            shader_scene_compose, "vs_main", shaderComposeNames[i],
-            layout_scene_compose, vertexBufferLayoutsImage, 2,
-            WGPUColorWriteMask_All, offscreenTargetFormat, composeBlends[i],
-            depthStencilStateScene, multisampleState);
-    }
-
     // render pipeline blit
     blit = createRenderPipeline(
         context.device, "The render pipeline blit",
@@ -448,41 +410,109 @@ void WgPipelines::initialize(WgContext& context)
         layout_blit, vertexBufferLayoutsImage, 2,
         WGPUColorWriteMask_All, context.preferredFormat, blendStateSrc, // must be preferred screen pixel format
         depthStencilStateScene, multisampleStateX1);
+}
+
+
+// the shape basics are ready from the start, the effects are compiled on the first of them
+void WgPipelines::initializeEffects()
+{
+    if (shader_effects) return;
+    shader_gauss = createShaderModule(device, "The shader effects", cShaderSrc_GaussianBlur);
+    shader_effects = createShaderModule(device, "The shader effects", cShaderSrc_Effects);
+    gaussian_horz = createComputePipeline(device, "The compute pipeline gaussian blur horizontal", shader_gauss, "cs_main_horz", layout_gauss);
+    gaussian_vert = createComputePipeline(device, "The compute pipeline gaussian blur vertical",   shader_gauss, "cs_main_vert", layout_gauss);
+    gaussian_horz_alpha = createComputePipeline(device, "The compute pipeline gaussian blur horizontal alpha", shader_gauss, "cs_main_horz_alpha", layout_gauss);
+    gaussian_vert_alpha = createComputePipeline(device, "The compute pipeline gaussian blur vertical alpha",   shader_gauss, "cs_main_vert_alpha", layout_gauss);
+    dropshadow    = createComputePipeline(device, "The compute pipeline drop shadow blend", shader_effects, "cs_main_drop_shadow", layout_effects);
+    fill_effect   = createComputePipeline(device, "The compute pipeline fill effect", shader_effects, "cs_main_fill", layout_effects);
+    tint_effect   = createComputePipeline(device, "The compute pipeline tint effect", shader_effects, "cs_main_tint", layout_effects);
+    tritone_effect= createComputePipeline(device, "The compute pipeline tritone effect", shader_effects, "cs_main_tritone", layout_effects);
+}
+
+
+// a scene mostly uses a few of the blend methods, the pipelines of the others are never built
+WGPURenderPipeline WgPipelines::blend(WgBlendPipeline type, uint32_t method)
+{
+    auto& pipeline = blends[(uint32_t)type][method];
+    if (pipeline) return pipeline;
+
+    const char* sources[] { cShaderSrc_Solid_Blend, cShaderSrc_Radial_Blend, cShaderSrc_Linear_Blend, cShaderSrc_Image_Blend, cShaderSrc_Scene_Blend };
+    auto& shader = shader_blend[(uint32_t)type];
+    if (!shader) {
+        char shaderSourceBuff[16384]{};
+        shader = createShaderModule(device, "The shader blend", strcat(strcpy(shaderSourceBuff, sources[(uint32_t)type]), cShaderSrc_BlendFuncs));
+    }
 
-    // compute pipeline gaussian blur
-    gaussian_horz = createComputePipeline(context.device, "The compute pipeline gaussian blur horizontal", shader_gauss, "cs_main_horz", layout_gauss);
-    gaussian_vert = createComputePipeline(context.device, "The compute pipeline gaussian blur vertical",   shader_gauss, "cs_main_vert", layout_gauss);
-    dropshadow    = createComputePipeline(context.device, "The compute pipeline drop shadow blend", shader_effects, "cs_main_drop_shadow", layout_effects);
-    fill_effect   = createComputePipeline(context.device, "The compute pipeline fill effect", shader_effects, "cs_main_fill", layout_effects);
-    tint_effect   = createComputePipeline(context.device, "The compute pipeline tint effect", shader_effects, "cs_main_tint", layout_effects);
-    tritone_effect= createComputePipeline(context.device, "The compute pipeline tritone effect", shader_effects, "cs_main_tritone", layout_effects);
+    auto image = (type == WgBlendPipeline::Image || type == WgBlendPipeline::Scene);
+    auto depthStencilState = (type == WgBlendPipeline::Scene) ?
+        makeDepthStencilState(WGPUCompareFunction_Always, false, WGPUCompareFunction_Always, WGPUStencilOperation_Zero) :
+        makeDepthStencilState(WGPUCompareFunction_Always, false, WGPUCompareFunction_NotEqual, WGPUStencilOperation_Zero);
+
+    pipeline = createRenderPipeline(
+        device, "The render pipeline blend",
+        shader, "vs_main", shaderBlendNames[method],
+        layout_blend[(uint32_t)type], image ? vertexBufferLayoutsImage : vertexBufferLayoutsShape, image ? 2 : 1,
+        WGPUColorWriteMask_All, offscreenTargetFormat, blendStateSrc,
+        depthStencilState, multisampleState);
+    return pipeline;
 }
 
+
+WGPURenderPipeline WgPipelines::compose(uint32_t method)
+{
+    auto& pipeline = composes[method];
+    if (pipeline) return pipeline;
+
+    if (!shader_scene_compose) shader_scene_compose = createShaderModule(device, "The shader scene composition", cShaderSrc_Scene_Compose);
+
+    pipeline = createRenderPipeline(
+        device, "The render pipeline scene composition",
+        shader_scene_compose, "vs_main", shaderComposeNames[method],
+        layout_scene_compose, vertexBufferLayoutsImage, 2,
+        WGPUColorWriteMask_All, offscreenTargetFormat, composeBlends[method],
+        makeDepthStencilState(WGPUCompareFunction_Always, false, WGPUCompareFunction_Always, WGPUStencilOperation_Zero), multisampleState);
+    return pipeline;
+}
+
+void WgPipelines::initializeRaster(WgContext& context)
+{
+    const WgBindGroupLayouts& layouts = context.layouts;
+    const WGPUBindGroupLayout bindGroupLayoutsRaster[] { layouts.layoutTexStrorage1WO, layouts.layoutBuffer1UnDyn, layouts.layoutBuffer1UnDyn, layouts.layoutBuffer2RO };
+    shader_raster = createShaderModule(context.device, "The shader path raster", cShaderSrc_Raster);
+    layout_raster = createPipelineLayout(context.device, bindGroupLayoutsRaster, 4);
+    raster = createComputePipeline(context.device, "The compute pipeline path raster", shader_raster, "cs_main", layout_raster);
+}
+
+
 void WgPipelines::releaseGraphicHandles(WgContext& context)
 {
+    // pipeline path raster
+    releaseComputePipeline(raster);
     // pipeline effects
     releaseComputePipeline(tritone_effect);
     releaseComputePipeline(tint_effect);
     releaseComputePipeline(fill_effect);
     releaseComputePipeline(dropshadow);
+    releaseComputePipeline(gaussian_vert_alpha);
+    releaseComputePipeline(gaussian_horz_alpha);
     releaseComputePipeline(gaussian_vert);
     releaseComputePipeline(gaussian_horz);
     // pipeline blit
     releaseRenderPipeline(blit);
     // pipelines compose
-    for (uint32_t i = 0; i < 11; i++)
-        releaseRenderPipeline(scene_compose[i]);
+    for (uint32_t i = 0; i < WG_COMPOSE_METHOD_CNT; i++)
+        releaseRenderPipeline(composes[i]);
     // pipelines custom blend
-    for (uint32_t i = 0; i < 18; i++) {
-        releaseRenderPipeline(scene_blend[i]);
-        releaseRenderPipeline(image_blend[i]);
-        releaseRenderPipeline(linear_blend[i]);
-        releaseRenderPipeline(radial_blend[i]);
-        releaseRenderPipeline(solid_blend[i]);
+    for (auto& type : blends) {
+        for (uint32_t i = 0; i < WG_BLEND_METHOD_CNT; i++)
+            releaseRenderPipeline(type[i]);
     }
     // pipelines normal blend
     releaseRenderPipeline(scene);
     releaseRenderPipeline(image);
+    releaseRenderPipeline(linear_convex);
+    releaseRenderPipeline(radial_convex);
+    releaseRenderPipeline(solid_convex);
     releaseRenderPipeline(linear);
     releaseRenderPipeline(radial);
     releaseRenderPipeline(solid);
@@ -497,14 +527,13 @@ void WgPipelines::releaseGraphicHandles(WgContext& context)
     releaseRenderPipeline(evenodd);
     releaseRenderPipeline(nonzero);
     // layouts
+    releasePipelineLayout(layout_raster);
     releasePipelineLayout(layout_effects);
     releasePipelineLayout(layout_gauss);
     releasePipelineLayout(layout_blit);
     releasePipelineLayout(layout_scene_compose);
-    releasePipelineLayout(layout_scene_blend);
-    releasePipelineLayout(layout_image_blend);
-    releasePipelineLayout(layout_gradient_blend);
-    releasePipelineLayout(layout_solid_blend);
+    for (auto& layout : layout_blend)
+        releasePipelineLayout(layout);
     releasePipelineLayout(layout_scene);
     releasePipelineLayout(layout_image);
     releasePipelineLayout(layout_gradient);
@@ -512,15 +541,13 @@ void WgPipelines::releaseGraphicHandles(WgContext& context)
     releasePipelineLayout(layout_depth);
     releasePipelineLayout(layout_stencil);
     // shaders
+    releaseShaderModule(shader_raster);
     releaseShaderModule(shader_effects);
     releaseShaderModule(shader_gauss);
     releaseShaderModule(shader_blit);
     releaseShaderModule(shader_scene_compose);
-    releaseShaderModule(shader_scene_blend);
-    releaseShaderModule(shader_image_blend);
-    releaseShaderModule(shader_linear_blend);
-    releaseShaderModule(shader_radial_blend);
-    releaseShaderModule(shader_solid_blend);
+    for (auto& shader : shader_blend)
+        releaseShaderModule(shader);
     releaseShaderModule(shader_scene);
     releaseShaderModule(shader_image);
     releaseShaderModule(shader_linear);
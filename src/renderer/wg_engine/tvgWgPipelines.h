@@ -25,6 +25,12 @@
 
 #include "tvgWgCommon.h"
 
+#define WG_BLEND_METHOD_CNT 18
+#define WG_COMPOSE_METHOD_CNT 11
+
+// the kinds of the custom blend pipelines
+enum class WgBlendPipeline { Solid = 0, Radial, Linear, Image, Scene, Count };
+
 class WgPipelines {
 private:
     // shaders helpers
@@ -37,18 +43,16 @@ private:
     WGPUShaderModule shader_image{};
     WGPUShaderModule shader_scene{};
     // shaders custom blend
-    WGPUShaderModule shader_solid_blend{};
-    WGPUShaderModule shader_radial_blend{};
-    WGPUShaderModule shader_linear_blend{};
-    WGPUShaderModule shader_image_blend{};
-    WGPUShaderModule shader_scene_blend{};
+    WGPUShaderModule shader_blend[(uint32_t)WgBlendPipeline::Count]{};
     // shader scene compose
     WGPUShaderModule shader_scene_compose{};
     // shader blit
     WGPUShaderModule shader_blit{};
     // shader effects
-    WGPUShaderModule shader_gauss;
-    WGPUShaderModule shader_effects;
+    WGPUShaderModule shader_gauss{};
+    WGPUShaderModule shader_effects{};
+    // shader path raster
+    WGPUShaderModule shader_raster{};
 
     // layouts helpers
     WGPUPipelineLayout layout_stencil{};
@@ -58,11 +62,8 @@ private:
     WGPUPipelineLayout layout_gradient{};
     WGPUPipelineLayout layout_image{};
     WGPUPipelineLayout layout_scene{};
-    // layouts custom blend
-    WGPUPipelineLayout layout_solid_blend{};
-    WGPUPipelineLayout layout_gradient_blend{};
-    WGPUPipelineLayout layout_image_blend{};
-    WGPUPipelineLayout layout_scene_blend{};
+    // layouts custom blend, indexed by WgBlendPipeline
+    WGPUPipelineLayout layout_blend[(uint32_t)WgBlendPipeline::Count]{};
     // layouts scene compose
     WGPUPipelineLayout layout_scene_compose{};
     // layouts blit
@@ -70,6 +71,13 @@ private:
     // layouts effects
     WGPUPipelineLayout layout_gauss{};
     WGPUPipelineLayout layout_effects{};
+    // layouts path raster
+    WGPUPipelineLayout layout_raster{};
+
+    // the rarely used pipelines, created on their first use
+    WGPURenderPipeline blends[(uint32_t)WgBlendPipeline::Count][WG_BLEND_METHOD_CNT]{};
+    WGPURenderPipeline composes[WG_COMPOSE_METHOD_CNT]{};
+    WGPUDevice device{};
 public:
     // pipelines stencil markup
     WGPURenderPipeline nonzero{};
@@ -85,25 +93,25 @@ public:
     WGPURenderPipeline solid{};
     WGPURenderPipeline radial{};
     WGPURenderPipeline linear{};
+    // pipelines normal blend of the convex fills, no stencil test
+    WGPURenderPipeline solid_convex{};
+    WGPURenderPipeline radial_convex{};
+    WGPURenderPipeline linear_convex{};
     WGPURenderPipeline image{};
     WGPURenderPipeline scene{};
-    // pipelines custom blend
-    WGPURenderPipeline solid_blend[18]{};
-    WGPURenderPipeline radial_blend[18]{};
-    WGPURenderPipeline linear_blend[18]{};
-    WGPURenderPipeline image_blend[18]{};
-    WGPURenderPipeline scene_blend[18]{};
-    // pipelines compose
-    WGPURenderPipeline scene_compose[11]{};
     // pipeline blit
     WGPURenderPipeline blit{};
-    // effects
+    // effects (see initializeEffects)
     WGPUComputePipeline gaussian_horz{};
     WGPUComputePipeline gaussian_vert{};
+    WGPUComputePipeline gaussian_horz_alpha{};
+    WGPUComputePipeline gaussian_vert_alpha{};
     WGPUComputePipeline dropshadow{};
     WGPUComputePipeline fill_effect{};
     WGPUComputePipeline tint_effect{};
     WGPUComputePipeline tritone_effect{};
+    // path raster (optional, see initializeRaster)
+    WGPUComputePipeline raster{};
 private:
     void releaseGraphicHandles(WgContext& context);
     WGPUShaderModule createShaderModule(WGPUDevice device, const char* label, const char* code);
@@ -133,6 +141,10 @@ private:
         const WGPUCompareFunction stencilFunctionBack, const WGPUStencilOperation stencilOperationBack);
 public:
     void initialize(WgContext& context);
+    void initializeRaster(WgContext& context);
+    void initializeEffects();
+    WGPURenderPipeline blend(WgBlendPipeline type, uint32_t method);
+    WGPURenderPipeline compose(uint32_t method);
     void release(WgContext& context);
 };
 
@@ -32,6 +32,24 @@
 
 void WgImageData::update(WgContext& context, const RenderSurface* surface)
 {
+    // sample the user texture directly
+    if (surface->native) {
+        auto handle = (WGPUTexture)surface->data;
+        if (texture == handle) return;
+        if (!external) context.releaseTexture(texture);
+        texture = handle;
+        external = true;
+        context.releaseTextureView(textureView);
+        textureView = context.createTextureView(texture);
+        context.layouts.releaseBindGroup(bindGroup);
+        bindGroup = context.layouts.createBindGroupTexSampled(context.samplerLinearRepeat, textureView);
+        return;
+    }
+    // never upload into the user texture
+    if (external) {
+        texture = nullptr;
+        external = false;
+    }
     // get appropriate texture format from color space
     WGPUTextureFormat texFormat = WGPUTextureFormat_BGRA8Unorm;
     if (surface->cs == ColorSpace::ABGR8888S)
@@ -39,7 +57,7 @@ void WgImageData::update(WgContext& context, const RenderSurface* surface)
     if (surface->cs == ColorSpace::Grayscale8)
         texFormat = WGPUTextureFormat_R8Unorm;
     // allocate new texture handle
-    bool texHandleChanged = context.allocateTexture(texture, surface->w, surface->h, texFormat, surface->data);
+    bool texHandleChanged = context.allocateTexture(texture, surface->w, surface->h, texFormat, surface->data, surface->channelSize == sizeof(uint32_t), surface->stride);
     // update texture view of texture handle was changed
     if (texHandleChanged) {
         context.releaseTextureView(textureView);
@@ -51,21 +69,18 @@ void WgImageData::update(WgContext& context, const RenderSurface* surface)
 };
 
 
-void WgImageData::update(WgContext& context, const Fill* fill)
+void WgImageData::update(WgContext& context, const WgShaderTypeGradientData& ramp, FillSpread spread)
 {
-    // compute gradient data
-    WgShaderTypeGradientData gradientData;
-    gradientData.update(fill);
     // allocate new texture handle
-    bool texHandleChanged = context.allocateTexture(texture, WG_TEXTURE_GRADIENT_SIZE, 1, WGPUTextureFormat_RGBA8Unorm, gradientData.data);
+    bool texHandleChanged = context.allocateTexture(texture, WG_TEXTURE_GRADIENT_SIZE, 1, WGPUTextureFormat_RGBA8Unorm, (void*)ramp.data);
     // update texture view of texture handle was changed
     if (texHandleChanged) {
         context.releaseTextureView(textureView);
         textureView = context.createTextureView(texture);
         // get sampler by spread type
         WGPUSampler sampler = context.samplerLinearClamp;
-        if (fill->spread() == FillSpread::Reflect) sampler = context.samplerLinearMirror;
-        if (fill->spread() == FillSpread::Repeat) sampler = context.samplerLinearRepeat;
+        if (spread == FillSpread::Reflect) sampler = context.samplerLinearMirror;
+        if (spread == FillSpread::Repeat) sampler = context.samplerLinearRepeat;
         // update bind group
         context.layouts.releaseBindGroup(bindGroup);
         bindGroup = context.layouts.createBindGroupTexSampled(sampler, textureView);
@@ -77,7 +92,9 @@ void WgImageData::release(WgContext& context)
 {
     context.layouts.releaseBindGroup(bindGroup);
     context.releaseTextureView(textureView);
-    context.releaseTexture(texture);
+    if (external) texture = nullptr;
+    else context.releaseTexture(texture);
+    external = false;
 };
 
 //***********************************************************************
@@ -90,11 +107,11 @@ void WgRenderSettings::update(WgContext& context, const tvg::Matrix& transform,
     settings.options.update(cs, opacity);
 }
 
-void WgRenderSettings::update(WgContext& context, const Fill* fill)
+void WgRenderSettings::update(const Fill* fill)
 {
     assert(fill);
-    settings.gradient.update(fill);
-    gradientData.update(context, fill);
+    // the ramp is built by the task
+    this->fill = fill;
     // get gradient rasterisation settings
     rasterType = WgRenderRasterType::Gradient;
     if (fill->type() == Type::LinearGradient)
@@ -114,9 +131,33 @@ void WgRenderSettings::update(WgContext& context, const RenderColor& c)
 };
 
 
+void WgRenderSettings::build()
+{
+    if (!fill) return;
+    settings.gradient.update(fill);
+    if (!ramp) ramp = new WgShaderTypeGradientData;
+    ramp->update(fill);
+    spread = fill->spread();
+    fill = nullptr;
+    rampChanged = true;
+}
+
+
+void WgRenderSettings::upload(WgContext& context)
+{
+    if (!rampChanged) return;
+    gradientData.update(context, *ramp, spread);
+    rampChanged = false;
+}
+
+
 void WgRenderSettings::release(WgContext& context)
 {
     gradientData.release(context);
+    delete(ramp);
+    ramp = nullptr;
+    fill = nullptr;
+    rampChanged = false;
 };
 
 //***********************************************************************
@@ -158,26 +199,45 @@ void WgRenderDataShape::updateAABB(const Matrix& matrix)
 }
 
 
-void WgRenderDataShape::updateMeshes(const RenderShape &rshape, RenderUpdateFlag flag, const Matrix& matrix)
+//the larger axis scale decides the curve segments
+static float _meshScale(const Matrix& m)
+{
+    return std::max(sqrtf(m.e11 * m.e11 + m.e21 * m.e21), sqrtf(m.e12 * m.e12 + m.e22 * m.e22));
+}
+
+
+//the local space meshes are transformed by the shader, they are kept while the curves stay smooth enough on the screen
+bool WgRenderDataShape::reusable(const Matrix& matrix)
+{
+    auto scale = _meshScale(matrix);
+    return meshScale > 0.0f && scale <= meshScale * 1.25f && scale >= meshScale * 0.5f;
+}
+
+
+void WgRenderDataShape::updateMeshes(const RenderShape &rshape, RenderUpdateFlag flag, const Matrix& matrix, WgGlyphCache& glyphs)
 {
     releaseMeshes();
     strokeFirst = rshape.strokeFirst();
+    meshScale = _meshScale(matrix);
 
     // update fill shapes
     if (flag & (RenderUpdateFlag::Color | RenderUpdateFlag::Gradient | RenderUpdateFlag::Transform | RenderUpdateFlag::Path)) {
         meshShape.clear();
 
-        WgBWTessellator bwTess{&meshShape};
+        WgBWTessellator bwTess{&meshShape, tolerance};
         if (rshape.trimpath()) {
             RenderPath trimmedPath;
             if (rshape.stroke->trim.trim(rshape.path, trimmedPath))
                 bwTess.tessellate(trimmedPath, matrix);
+        } else if (rshape.glyphs && rshape.glyphs->valid(rshape.path)) {
+            bwTess.tessellate(rshape.path, *rshape.glyphs, matrix, glyphs);
         } else bwTess.tessellate(rshape.path, matrix);
 
         if (meshShape.ibuffer.count > 0) {;
             auto bbox = bwTess.getBBox();
             meshShapeBBox.bbox(bbox.min, bbox.max);
             updateBBox(bbox);
+            convex = bwTess.convex();
         } else meshShape.clear();
     }
 
@@ -185,7 +245,7 @@ void WgRenderDataShape::updateMeshes(const RenderShape &rshape, RenderUpdateFlag
     if (rshape.stroke && (flag & (RenderUpdateFlag::Stroke | RenderUpdateFlag::GradientStroke | RenderUpdateFlag::Transform))) {
         meshStrokes.clear();
 
-        WgStroker stroker{&meshStrokes, matrix};
+        WgStroker stroker{&meshStrokes, matrix, tolerance};
         stroker.stroke(&rshape);
         
         if (meshStrokes.ibuffer.count > 0) {
@@ -203,14 +263,42 @@ void WgRenderDataShape::updateMeshes(const RenderShape &rshape, RenderUpdateFlag
 }
 
 
+void WgRenderDataShape::run(TVG_UNUSED unsigned tid)
+{
+    MemoryScope scope(MemoryCategory::Engine);
+
+    // update geometry
+    if (meshFlag == RenderUpdateFlag::All) {
+        updateMeshes(*rshape, RenderUpdateFlag::All, transform, *glyphs);
+    } else if (meshFlag == RenderUpdateFlag::Transform) {
+        if ((meshShape.vbuffer.count > 0) || (meshStrokes.vbuffer.count > 0)) updateAABB(transform);
+    }
+
+    // build gradient ramps
+    renderSettingsShape.build();
+    renderSettingsStroke.build();
+
+    updateBox();
+}
+
+
+// the shape aabb follows the transformation even when the meshes are kept
+void WgRenderDataShape::updateBox()
+{
+    box = RenderRegion::intersect(viewBox, {{int32_t(nearbyint(aabb.min.x)), int32_t(nearbyint(aabb.min.y))}, {int32_t(nearbyint(aabb.max.x)), int32_t(nearbyint(aabb.max.y))}});
+    if (dirtyRegion) dirtyRegion->add(prvBox, box, dirtyScope);
+}
+
+
 void WgRenderDataShape::releaseMeshes()
 {
     meshStrokes.clear();
     meshShape.clear();
+    convex = false;
     bbox.min = {FLT_MAX, FLT_MAX};
     bbox.max = {0.0f, 0.0f};
     aabb = {{0, 0}, {0, 0}};
-    clips.clear();
+    meshScale = 0.0f;
 }
 
 
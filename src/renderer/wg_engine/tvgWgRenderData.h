@@ -23,17 +23,21 @@
 #ifndef _TVG_WG_RENDER_DATA_H_
 #define _TVG_WG_RENDER_DATA_H_
 
+#include "tvgTaskScheduler.h"
 #include "tvgWgPipelines.h"
 #include "tvgWgGeometry.h"
 #include "tvgWgShaderTypes.h"
 
+class WgGlyphCache;
+
 struct WgImageData {
     WGPUTexture texture{};
     WGPUTextureView textureView{};
     WGPUBindGroup bindGroup{};
+    bool external{};  // the texture is owned by the user
 
     void update(WgContext& context, const RenderSurface* surface);
-    void update(WgContext& context, const Fill* fill);
+    void update(WgContext& context, const WgShaderTypeGradientData& ramp, FillSpread spread);
     void release(WgContext& context);
 };
 
@@ -45,13 +49,19 @@ struct WgRenderSettings
     uint32_t bindGroupInd{};
     WgShaderTypePaintSettings settings;
     WgImageData gradientData;
+    WgShaderTypeGradientData* ramp{};  // the gradient texels, built on the worker threads
+    const Fill* fill{};  // the gradient to build, null if built
+    FillSpread spread{};
     WgRenderSettingsType fillType{};
     WgRenderRasterType rasterType{};
     bool skip{};
+    bool rampChanged{};  // the ramp is waiting for the upload
 
     void update(WgContext& context, const tvg::Matrix& transform, tvg::ColorSpace cs, uint8_t opacity);
-    void update(WgContext& context, const Fill* fill);
+    void update(const Fill* fill);
     void update(WgContext& context, const RenderColor& c);
+    void build();
+    void upload(WgContext& context);
     void release(WgContext& context);
 };
 
@@ -59,6 +69,8 @@ struct WgRenderDataPaint
 {
     BBox aabb{{},{}};
     RenderRegion viewport{};
+    RenderRegion box{};  // drawing area for the partial rendering
+    RenderDirtyRegion::Scope dirtyScope{};  // the damages spread out by the post effects of the ancestors
     Array<WgRenderDataPaint*> clips;
 
     virtual ~WgRenderDataPaint() {};
@@ -68,7 +80,8 @@ struct WgRenderDataPaint
     void updateClips(tvg::Array<tvg::RenderData> &clips);
 };
 
-struct WgRenderDataShape: public WgRenderDataPaint
+// the meshes, the gradient ramps and the bounds are built on the worker threads, the gpu resources stay on the owning thread
+struct WgRenderDataShape: public WgRenderDataPaint, public Task
 {
     WgRenderSettings renderSettingsShape{};
     WgRenderSettings renderSettingsStroke{};
@@ -78,15 +91,34 @@ struct WgRenderDataShape: public WgRenderDataPaint
     WgMeshData meshStrokes{};
     WgMeshData meshStrokesBBox{};
     bool strokeFirst{};
+    bool convex{};  //the fill fan covers every pixel once, no stencil pass is needed
     FillRule fillRule{};
     BBox bbox;
+    float meshScale{};  //the matrix scale the meshes were built with
+    uint32_t rasterInd{};  //the compute raster settings, valid if raster is set
+    bool raster{};
+
+    // the preparation requested to the task
+    const RenderShape* rshape{};
+    WgGlyphCache* glyphs{};
+    RenderDirtyRegion* dirtyRegion{};  // null if the shape doesn't damage the target
+    Matrix transform{};
+    float tolerance{};  // the curve flattening tolerance in pixels
+    RenderRegion viewBox{};  // the viewport within the target
+    RenderRegion prvBox{};  // drawing area of the previous update
+    RenderUpdateFlag meshFlag{};  // All: rebuild the meshes, Transform: move the aabb only
 
     void updateBBox(BBox bb);
     void updateAABB(const Matrix& matrix);
-    void updateMeshes(const RenderShape& rshape, RenderUpdateFlag flag, const Matrix& matrix);
+    void updateBox();
+    bool reusable(const Matrix& matrix);
+    void updateMeshes(const RenderShape& rshape, RenderUpdateFlag flag, const Matrix& matrix, WgGlyphCache& glyphs);
     void releaseMeshes();
     void release(WgContext& context) override;
     Type type() override { return Type::Shape; };
+
+protected:
+    void run(unsigned tid) override;
 };
 
 class WgRenderDataShapePool {
@@ -192,34 +224,42 @@ public:
     void flush(WgContext& context);
 };
 
-// typed uniform stage buffer with related bind groups handling
+// typed uniform stage buffer, a single bind group selects the items by the dynamic offsets
 template<typename T>
 class WgStageBufferUniform {
 private:
     Array<T> ubuffer;
     WGPUBuffer ubuffer_gpu{};
-    Array<WGPUBindGroup> bbuffer;
+    WGPUBindGroup bgroup{};
+    Array<uint32_t> offsets;
 public:
-    // append uniform data to cpu staged buffer and return related bind group index
+    // append uniform data to cpu staged buffer and return related item index
     uint32_t append(const T& value) {
         ubuffer.push(value);
         return ubuffer.count - 1;
     }
 
     void flush(WgContext& context) {
+        // keep a valid binding for the empty frames
+        if (ubuffer.reserved == 0) ubuffer.reserve(1);
         // flush data to gpu buffer from cpu memory including reserved data to prevent future gpu buffer reallocations
         bool bufferChanged = context.allocateBufferUniform(ubuffer_gpu, (void*)ubuffer.data, ubuffer.reserved*sizeof(T));
-        // if gpu buffer handle was changed we must to remove all created binding groups
-        if (bufferChanged) releaseBindGroups(context);
-        // allocate bind groups for all new data items
-        for (uint32_t i = bbuffer.count; i < ubuffer.count; i++)
-            bbuffer.push(context.layouts.createBindGroupBuffer1Un(ubuffer_gpu, i*sizeof(T), sizeof(T)));
-        assert(bbuffer.count >= ubuffer.count);
+        // the bind group is recreated along with the gpu buffer only
+        if (bufferChanged || !bgroup) {
+            context.layouts.releaseBindGroup(bgroup);
+            bgroup = context.layouts.createBindGroupBuffer1UnDyn(ubuffer_gpu, sizeof(T));
+        }
+        for (uint32_t i = offsets.count; i < ubuffer.count; i++)
+            offsets.push(i*sizeof(T));
+    }
+
+    WGPUBindGroup bindGroup() const {
+        return bgroup;
     }
 
     // please, use index that was returned from append method
-    WGPUBindGroup operator[](const uint32_t index) const {
-        return bbuffer[index];
+    const uint32_t* offset(const uint32_t index) const {
+        return &offsets[index];
     }
 
     void clear() {
@@ -228,13 +268,8 @@ public:
 
     void release(WgContext& context) {
         context.releaseBuffer(ubuffer_gpu);
-        releaseBindGroups(context);
-    }
-
-    void releaseBindGroups(WgContext& context) {
-        ARRAY_FOREACH(p, bbuffer)
-            context.layouts.releaseBindGroup(*p);
-        bbuffer.clear();
+        context.layouts.releaseBindGroup(bgroup);
+        offsets.reset();
     }
 };
 
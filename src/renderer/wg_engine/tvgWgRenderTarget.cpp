@@ -92,3 +92,16 @@ void WgRenderTargetPool::release(WgContext& context)
     height = 0;
     width = 0;
 };
+
+
+void WgRenderTargetPool::trim(WgContext& context)
+{
+    // keep them all while any of them is in use
+    if (pool.count < list.count) return;
+    ARRAY_FOREACH(p, list) {
+       (*p)->release(context);
+       delete(*p);
+    }
+    list.clear();
+    pool.clear();
+};
@@ -54,5 +54,6 @@ public:
 
     void initialize(WgContext& context, uint32_t width, uint32_t height);
     void release(WgContext& context);
+    void trim(WgContext& context);
 };
 #endif // _TVG_WG_RENDER_TARGET_H_
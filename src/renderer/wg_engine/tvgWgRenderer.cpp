@@ -30,10 +30,14 @@
 /************************************************************************/
 
 static atomic<int32_t> rendererCnt{-1};
+static atomic<uint32_t> trimCnt{0};    // the requests of releasing the idle targets, see trim()
+static atomic<uint32_t> cacheCnt{0};   // the requests of releasing the glyph meshes as well
 
 
 void WgRenderer::release()
 {
+    mGroup.wait();
+
     if (!mContext.queue) return;
 
     disposeObjects();
@@ -131,11 +135,17 @@ bool WgRenderer::surfaceConfigure(WGPUSurface surface, WgContext& context, uint3
 
 RenderData WgRenderer::prepare(const RenderShape& rshape, RenderData data, const Matrix& transform, Array<RenderData>& clips, uint8_t opacity, RenderUpdateFlag flags, bool clipper)
 {
-    auto renderDataShape = data ? (WgRenderDataShape*)data : mRenderDataShapePool.allocate(mContext);
+    MemoryScope scope(MemoryCategory::Engine);
 
-    // update geometry
-    if (!data || (flags & (RenderUpdateFlag::Path | RenderUpdateFlag::Stroke))) {
-        renderDataShape->updateMeshes(rshape, flags, transform);
+    auto renderDataShape = data ? (WgRenderDataShape*)data : mRenderDataShapePool.allocate(mContext);
+    renderDataShape->done();
+
+    // update geometry, a transformation alone keeps the meshes unless they need another curve precision
+    renderDataShape->meshFlag = RenderUpdateFlag::None;
+    if (!data || (flags & (RenderUpdateFlag::Path | RenderUpdateFlag::Stroke)) || ((flags & RenderUpdateFlag::Transform) && !renderDataShape->reusable(transform))) {
+        renderDataShape->meshFlag = RenderUpdateFlag::All;
+    } else if (flags & RenderUpdateFlag::Transform) {
+        renderDataShape->meshFlag = RenderUpdateFlag::Transform;
     }
 
     // update paint settings
@@ -147,22 +157,40 @@ RenderData WgRenderer::prepare(const RenderShape& rshape, RenderData data, const
 
     // setup fill settings
     renderDataShape->viewport = vport;
-    if (flags & RenderUpdateFlag::Gradient && rshape.fill) renderDataShape->renderSettingsShape.update(mContext, rshape.fill);
+    if (flags & RenderUpdateFlag::Gradient && rshape.fill) renderDataShape->renderSettingsShape.update(rshape.fill);
     else if (flags & RenderUpdateFlag::Color) renderDataShape->renderSettingsShape.update(mContext, rshape.color);
     if (rshape.stroke) {
-        if (flags & RenderUpdateFlag::GradientStroke && rshape.stroke->fill) renderDataShape->renderSettingsStroke.update(mContext, rshape.stroke->fill);
+        if (flags & RenderUpdateFlag::GradientStroke && rshape.stroke->fill) renderDataShape->renderSettingsStroke.update(rshape.stroke->fill);
         else if (flags & RenderUpdateFlag::Stroke) renderDataShape->renderSettingsStroke.update(mContext, rshape.stroke->color);
     }
 
     if (flags & RenderUpdateFlag::Clip) renderDataShape->updateClips(clips);
 
+    /* The meshes, the gradient ramps and the bounds are built on the worker threads,
+       the drawing box and the damage are given by the task. Clippers are not drawn, they don't damage the target. */
+    renderDataShape->rshape = &rshape;
+    renderDataShape->glyphs = &mGlyphCache;
+    renderDataShape->transform = transform;
+    renderDataShape->tolerance = tolerance;
+    renderDataShape->viewBox = RenderRegion::intersect(vport, {{0, 0}, {(int32_t)mTargetSurface.w, (int32_t)mTargetSurface.h}});
+    renderDataShape->prvBox = renderDataShape->box;
+    renderDataShape->dirtyRegion = (clipper || mDirtyRegion.deactivated()) ? nullptr : &mDirtyRegion;
+    renderDataShape->dirtyScope = mDirtyRegion.scope;
+
+    //the color only change has neither the meshes nor the gradient ramps to be built, no need to schedule it
+    if (flags == RenderUpdateFlag::Color && renderDataShape->meshFlag == RenderUpdateFlag::None) renderDataShape->updateBox();
+    else mGroup.request(renderDataShape);
+
     return renderDataShape;
 }
 
 
 RenderData WgRenderer::prepare(RenderSurface* surface, RenderData data, const Matrix& transform, Array<RenderData>& clips, uint8_t opacity, RenderUpdateFlag flags)
 {
+    MemoryScope scope(MemoryCategory::Engine);
+
     auto renderDataPicture = data ? (WgRenderDataPicture*)data : mRenderDataPicturePool.allocate(mContext);
+    auto prv = renderDataPicture->box;
 
     // update paint settings
     renderDataPicture->viewport = vport;
@@ -177,7 +205,7 @@ RenderData WgRenderer::prepare(RenderSurface* surface, RenderData data, const Ma
 
     if (flags & RenderUpdateFlag::Clip) renderDataPicture->updateClips(clips);
 
-    return renderDataPicture;
+    return dirty(renderDataPicture, prv);
 }
 
 
@@ -185,6 +213,39 @@ bool WgRenderer::preRender()
 {
     if (mContext.invalid()) return false;
 
+    // the meshes and the dirty regions are ready to draw
+    mGroup.wait();
+
+    // release the idle targets as requested
+    if (mTrimmed != trimCnt) {
+        mRenderTargetPool.trim(mContext);
+        mTrimmed = trimCnt;
+    }
+
+    if (mCacheTrimmed != cacheCnt) {
+        mGlyphCache.clear();
+        mCacheTrimmed = cacheCnt;
+    }
+
+    // collect the damaged regions of this frame
+    mDamages.clear();
+    RenderRegion full = {{0, 0}, {(int32_t)mTargetSurface.w, (int32_t)mTargetSurface.h}};
+    if (mFullDraw || mDirtyRegion.deactivated()) {
+        mDamages.push(full);
+        mDamage = full;
+    } else {
+        mDirtyRegion.commit();
+        mDamage = {};
+        for (uint32_t idx = 0; idx < mDirtyRegion.count(); ++idx) {
+            ARRAY_FOREACH(p, mDirtyRegion.get(idx)) {
+                if (mDamage.valid()) mDamage.add(*p);
+                else mDamage = *p;
+                mDamages.push(*p);
+            }
+        }
+        mDamage.intersect(full);
+    }
+
     mCompositor.reset(mContext);
 
     assert(mRenderTargetStack.count == 0);
@@ -208,11 +269,16 @@ bool WgRenderer::preRender()
 
 bool WgRenderer::renderShape(RenderData data)
 {
+    // the gradient ramps built by the task go to the gpu on the owning thread
+    auto renderDataShape = (WgRenderDataShape*)data;
+    renderDataShape->renderSettingsShape.upload(mContext);
+    renderDataShape->renderSettingsStroke.upload(mContext);
+
     WgPaintTask* paintTask = new WgPaintTask((WgRenderDataPaint*)data, mBlendMethod);
     WgSceneTask* sceneTask = mSceneTaskStack.last();
     sceneTask->children.push(paintTask);
     mRenderTaskList.push(paintTask);
-    mCompositor.requestShape((WgRenderDataShape*)data);
+    mCompositor.requestShape(renderDataShape);
     return true;
 }
 
@@ -230,19 +296,23 @@ bool WgRenderer::renderImage(RenderData data)
 
 bool WgRenderer::postRender()
 {
-    // flush stage data to gpu
-    mCompositor.flush(mContext);
+    // nothing changed, the root target keeps the last frame
+    if (mDamage.valid()) {
+        // flush stage data to gpu
+        mCompositor.flush(mContext);
 
-    // create command encoder for drawing
-    WGPUCommandEncoder commandEncoder = mContext.createCommandEncoder();
+        // create command encoder for drawing
+        WGPUCommandEncoder commandEncoder = mContext.createCommandEncoder();
 
-    // run rendering (all the fun is here)
-    WgSceneTask* sceneTaskRoot = mSceneTaskStack.last();
-    sceneTaskRoot->run(mContext, mCompositor, commandEncoder);
+        // run rendering (all the fun is here)
+        WgSceneTask* sceneTaskRoot = mSceneTaskStack.last();
+        sceneTaskRoot->run(mContext, mCompositor, commandEncoder);
 
-    // execute and release command encoder
-    mContext.submitCommandEncoder(commandEncoder);
-    mContext.releaseCommandEncoder(commandEncoder);
+        // execute and release command encoder
+        mContext.submitCommandEncoder(commandEncoder);
+        mContext.releaseCommandEncoder(commandEncoder);
+    }
+    mDirtyRegion.clear();
 
     // clear the render tasks tree
     mSceneTaskStack.pop();
@@ -263,6 +333,9 @@ bool WgRenderer::postRender()
 
 void WgRenderer::dispose(RenderData data) {
     if (!mContext.queue) return;
+    auto renderData = (WgRenderDataPaint*)data;
+    if (renderData->type() == Type::Shape) ((WgRenderDataShape*)renderData)->done();
+    if (!mDirtyRegion.deactivated()) mDirtyRegion.add(renderData->box, renderData->dirtyScope);
     ScopedLock lock(mDisposeKey);
     mDisposeRenderDatas.push(data);
 }
@@ -273,6 +346,7 @@ RenderRegion WgRenderer::region(RenderData data)
     if (!data) return {};
     auto renderData = (WgRenderDataPaint*)data;
     if (renderData->type() == Type::Shape) {
+        ((WgRenderDataShape*)renderData)->done();
         auto& v1 = renderData->aabb.min;
         auto& v2 = renderData->aabb.max;
         return {{int32_t(nearbyint(v1.x)), int32_t(nearbyint(v1.y))}, {int32_t(nearbyint(v2.x)), int32_t(nearbyint(v2.y))}};
@@ -309,6 +383,7 @@ bool WgRenderer::clear()
     if (mContext.invalid()) return false;
 
     //TODO: clear the current target buffer only if clear() is called
+    mFullDraw = true;
     return true;
 }
 
@@ -321,21 +396,27 @@ bool WgRenderer::sync()
 
     // if texture buffer used
     WGPUTexture dstTexture = targetTexture;
+    // the surface textures are not preserved, they must be fully presented
+    RenderRegion rect = mDamage;
     if (surface) {
         releaseSurfaceTexture();
         wgpuSurfaceGetCurrentTexture(surface, &surfaceTexture);
         dstTexture = surfaceTexture.texture;
+        rect = {{0, 0}, {(int32_t)mTargetSurface.w, (int32_t)mTargetSurface.h}};
     }
 
     if (!dstTexture) return false;
 
+    mFullDraw = false;
+    if (rect.invalid()) return true;
+
     // insure that surface and offscreen target have the same size
     if ((wgpuTextureGetWidth(dstTexture) == mRenderTargetRoot.width) && 
         (wgpuTextureGetHeight(dstTexture) == mRenderTargetRoot.height)) {
         WGPUTextureView dstTextureView = mContext.createTextureView(dstTexture);
         WGPUCommandEncoder commandEncoder = mContext.createCommandEncoder();
         // show root offscreen buffer
-        mCompositor.blit(mContext, commandEncoder, &mRenderTargetRoot, dstTextureView);
+        mCompositor.blit(mContext, commandEncoder, &mRenderTargetRoot, dstTextureView, rect);
         mContext.submitCommandEncoder(commandEncoder);
         mContext.releaseCommandEncoder(commandEncoder);
         mContext.releaseTextureView(dstTextureView);
@@ -372,6 +453,9 @@ bool WgRenderer::target(WGPUDevice device, WGPUInstance instance, void* target,
         mTargetSurface.w = width;
         mTargetSurface.h = height;
 
+        mDirtyRegion.init(width, height);
+        mFullDraw = true;
+
         // configure surface (must be called after context creation)
         if (type == 0) {
             surface = (WGPUSurface)target;
@@ -396,6 +480,9 @@ bool WgRenderer::target(WGPUDevice device, WGPUInstance instance, void* target,
         mTargetSurface.w = width;
         mTargetSurface.h = height;
 
+        mDirtyRegion.init(width, height);
+        mFullDraw = true;
+
         // configure surface (must be called after context creation)
         if (type == 0) {
             surface = (WGPUSurface)target;
@@ -428,6 +515,8 @@ WgRenderer::~WgRenderer()
 
 RenderCompositor* WgRenderer::target(const RenderRegion& region, TVG_UNUSED ColorSpace cs, TVG_UNUSED CompositionFlag flags)
 {
+    MemoryScope scope(MemoryCategory::Compositor);
+
     // create and setup compose data
     WgCompose* compose = new WgCompose();
     compose->aabb = region;
@@ -577,16 +666,48 @@ bool WgRenderer::postUpdate()
 }
 
 
-void WgRenderer::damage(TVG_UNUSED RenderData rd, TVG_UNUSED const RenderRegion& region)
+void WgRenderer::damage(RenderData rd, const RenderRegion& region)
 {
-    //TODO
+    if (mDirtyRegion.deactivated()) return;
+    auto renderData = static_cast<WgRenderDataPaint*>(rd);
+    mDirtyRegion.add(region, renderData ? renderData->dirtyScope : mDirtyRegion.scope);
 }
 
 
 bool WgRenderer::partial(bool disable)
 {
-    //TODO
-    return false;
+    return mDirtyRegion.deactivate(disable);
+}
+
+
+RenderDirtyRegion::Scope WgRenderer::scope(const RenderRegion& extend, const RenderRegion* clip)
+{
+    return mDirtyRegion.push(extend, clip);
+}
+
+
+void WgRenderer::scope(const RenderDirtyRegion::Scope& former)
+{
+    mDirtyRegion.pop(former);
+}
+
+
+bool WgRenderer::damages(const RenderRegion** regions, uint32_t* cnt)
+{
+    *regions = mDamages.data;
+    *cnt = mDamages.count;
+    return true;
+}
+
+
+RenderData WgRenderer::dirty(WgRenderDataPaint* renderData, const RenderRegion& prv)
+{
+    renderData->box = RenderRegion::intersect(vport, {{0, 0}, {(int32_t)mTargetSurface.w, (int32_t)mTargetSurface.h}});
+
+    renderData->dirtyScope = mDirtyRegion.scope;
+    if (!mDirtyRegion.deactivated()) mDirtyRegion.add(prv, renderData->box, renderData->dirtyScope);
+
+    return renderData;
 }
 
 
@@ -602,6 +723,14 @@ bool WgRenderer::term()
 }
 
 
+void WgRenderer::trim(bool caches)
+{
+    // the renderers release them at their next frame
+    ++trimCnt;
+    if (caches) ++cacheCnt;
+}
+
+
 WgRenderer* WgRenderer::gen(TVG_UNUSED uint32_t threads)
 {
     //initialize engine
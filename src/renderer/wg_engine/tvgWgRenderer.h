@@ -24,6 +24,7 @@
 #define _TVG_WG_RENDERER_H_
 
 #include "tvgWgRenderTask.h"
+#include "tvgWgTessellator.h"
 
 class WgRenderer : public RenderMethod
 {
@@ -60,9 +61,13 @@ public:
     //partial rendering
     void damage(RenderData rd, const RenderRegion& region) override;
     bool partial(bool disable) override;
+    RenderDirtyRegion::Scope scope(const RenderRegion& extend, const RenderRegion* clip) override;
+    void scope(const RenderDirtyRegion::Scope& former) override;
+    bool damages(const RenderRegion** regions, uint32_t* cnt) override;
 
     static WgRenderer* gen(uint32_t threads);
     static bool term();
+    static void trim(bool caches);
 
 private:
     WgRenderer();
@@ -71,6 +76,8 @@ private:
     void disposeObjects();
     void releaseSurfaceTexture();
 
+    RenderData dirty(WgRenderDataPaint* renderData, const RenderRegion& prv);
+
     void clearTargets();
     bool surfaceConfigure(WGPUSurface surface, WgContext& context, uint32_t width, uint32_t height);
 
@@ -91,6 +98,12 @@ private:
     WgRenderDataViewportPool mRenderDataViewportPool;
     WgRenderDataEffectParamsPool mRenderDataEffectParamsPool;
 
+    // glyph meshes of the texts
+    WgGlyphCache mGlyphCache;
+
+    // completion of the shape preparation tasks
+    TaskGroup mGroup;
+
     // rendering context
     WgContext mContext;
     WgCompositor mCompositor;
@@ -99,6 +112,16 @@ private:
     RenderSurface mTargetSurface;
     BlendMethod mBlendMethod{};
 
+    // partial rendering
+    RenderDirtyRegion mDirtyRegion;
+    Array<RenderRegion> mDamages;  // the regions updated by the last drawing
+    RenderRegion mDamage{};  // union of the damages
+    bool mFullDraw = true;  // the target content is unknown, redraw the full screen
+
+    // the last trim requests handled, see trim()
+    uint32_t mTrimmed = 0;
+    uint32_t mCacheTrimmed = 0;
+
     // disposable data list
     Array<RenderData> mDisposeRenderDatas{};
     Key mDisposeKey{};
@@ -708,6 +708,7 @@ const char* cShaderSrc_GaussianBlur = R"(
 const N: u32 = 128;
 const M: u32 = N * 3;
 var<workgroup> buff: array<vec4f, M>;
+var<workgroup> weights: array<f32, N>;  // the kernel is at most N taps, shared by the workgroup
 
 fn gaussian(x: f32, sigma: f32) -> f32 {
     let a = 0.39894f / sigma;
@@ -733,6 +734,9 @@ fn cs_main_horz(@builtin(global_invocation_id) gid: vec3u,
     let uid = vec2u(gid.x + u32(xmin), gid.y + u32(ymin));
     let iid = vec2i(uid);
 
+    // the kernel weights once per workgroup, not per pixel and tap
+    weights[lid.x] = gaussian(f32(lid.x) * scale, sigma);
+
     // load source to local workgroup memory
     buff[lid.x + N*0] = textureLoad(imageSrc, uid - vec2u(N, 0), 0);
     buff[lid.x + N*1] = textureLoad(imageSrc, uid + vec2u(0, 0), 0);
@@ -740,13 +744,13 @@ fn cs_main_horz(@builtin(global_invocation_id) gid: vec3u,
     workgroupBarrier();
 
     // apply filter
-    var weight = gaussian(0.0, sigma);
+    var weight = weights[0];
     var color = weight * buff[lid.x + N];
     var sum = weight;
 
     for (var i: i32 = 1; i < size; i++) {
         let ii = i32(f32(i) * scale);
-        weight = gaussian(f32(i) * scale, sigma);
+        weight = weights[i];
         let poffset = min(iid.x + ii, xmax) - iid.x;
         let noffset = max(iid.x - ii, xmin) - iid.x;
         color += (weight * buff[i32(lid.x + N) + poffset]);
@@ -776,6 +780,9 @@ fn cs_main_vert(@builtin(global_invocation_id) gid: vec3u,
     let uid = vec2u(gid.x + u32(xmin), gid.y + u32(ymin));
     let iid = vec2i(uid);
 
+    // the kernel weights once per workgroup, not per pixel and tap
+    weights[lid.y] = gaussian(f32(lid.y) * scale, sigma);
+
     // load source to local workgroup memory
     buff[lid.y + N*0] = textureLoad(imageSrc, uid - vec2u(0, N), 0);
     buff[lid.y + N*1] = textureLoad(imageSrc, uid + vec2u(0, 0), 0);
@@ -783,13 +790,13 @@ fn cs_main_vert(@builtin(global_invocation_id) gid: vec3u,
     workgroupBarrier();
 
     // apply filter
-    var weight = gaussian(0.0, sigma);
+    var weight = weights[0];
     var color = weight * buff[lid.y + N];
     var sum = weight;
 
     for (var i: i32 = 1; i < size; i++) {
         let ii = i32(f32(i) * scale);
-        weight = gaussian(f32(i) * scale, sigma);
+        weight = weights[i];
         let poffset = min(iid.y + ii, ymax) - iid.y;
         let noffset = max(iid.y - ii, ymin) - iid.y;
         color += (weight * buff[i32(lid.y + N) + poffset]);
@@ -800,6 +807,95 @@ fn cs_main_vert(@builtin(global_invocation_id) gid: vec3u,
     // store result
     textureStore(imageDst, uid, color / sum);
 }
+
+// the drop shadow variants, only the alpha channel is blurred (stored as (a, a, a, a))
+var<workgroup> abuff: array<f32, M>;
+
+@compute @workgroup_size(N, 1)
+fn cs_main_horz_alpha(@builtin(global_invocation_id) gid: vec3u,
+                      @builtin(local_invocation_id)  lid: vec3u) {
+    // settings decode
+    let sigma = settings[0].x;
+    let scale = settings[0].y;
+    let size = i32(settings[0].z);
+
+    // viewport decode
+    let xmin = i32(viewport.x);
+    let xmax = i32(viewport.z);
+
+    // tex coord
+    let uid = vec2u(gid.x + u32(xmin), gid.y + u32(viewport.y));
+    let iid = vec2i(uid);
+
+    weights[lid.x] = gaussian(f32(lid.x) * scale, sigma);
+
+    // load source alpha to local workgroup memory
+    abuff[lid.x + N*0] = textureLoad(imageSrc, uid - vec2u(N, 0), 0).a;
+    abuff[lid.x + N*1] = textureLoad(imageSrc, uid + vec2u(0, 0), 0).a;
+    abuff[lid.x + N*2] = textureLoad(imageSrc, uid + vec2u(N, 0), 0).a;
+    workgroupBarrier();
+
+    // apply filter
+    var weight = weights[0];
+    var alpha = weight * abuff[lid.x + N];
+    var sum = weight;
+
+    for (var i: i32 = 1; i < size; i++) {
+        let ii = i32(f32(i) * scale);
+        weight = weights[i];
+        let poffset = min(iid.x + ii, xmax) - iid.x;
+        let noffset = max(iid.x - ii, xmin) - iid.x;
+        alpha += (weight * abuff[i32(lid.x + N) + poffset]);
+        alpha += (weight * abuff[i32(lid.x + N) + noffset]);
+        sum += (2.0 * weight);
+    }
+
+    // store result
+    textureStore(imageDst, uid, vec4f(alpha / sum));
+}
+
+@compute @workgroup_size(1, N)
+fn cs_main_vert_alpha(@builtin(global_invocation_id) gid: vec3u,
+                      @builtin(local_invocation_id)  lid: vec3u) {
+    // settings decode
+    let sigma = settings[0].x;
+    let scale = settings[0].y;
+    let size = i32(settings[0].z);
+
+    // viewport decode
+    let ymin = i32(viewport.y);
+    let ymax = i32(viewport.w);
+
+    // tex coord
+    let uid = vec2u(gid.x + u32(viewport.x), gid.y + u32(ymin));
+    let iid = vec2i(uid);
+
+    weights[lid.y] = gaussian(f32(lid.y) * scale, sigma);
+
+    // load source alpha to local workgroup memory
+    abuff[lid.y + N*0] = textureLoad(imageSrc, uid - vec2u(0, N), 0).a;
+    abuff[lid.y + N*1] = textureLoad(imageSrc, uid + vec2u(0, 0), 0).a;
+    abuff[lid.y + N*2] = textureLoad(imageSrc, uid + vec2u(0, N), 0).a;
+    workgroupBarrier();
+
+    // apply filter
+    var weight = weights[0];
+    var alpha = weight * abuff[lid.y + N];
+    var sum = weight;
+
+    for (var i: i32 = 1; i < size; i++) {
+        let ii = i32(f32(i) * scale);
+        weight = weights[i];
+        let poffset = min(iid.y + ii, ymax) - iid.y;
+        let noffset = max(iid.y - ii, ymin) - iid.y;
+        alpha += (weight * abuff[i32(lid.y + N) + poffset]);
+        alpha += (weight * abuff[i32(lid.y + N) + noffset]);
+        sum += (2.0 * weight);
+    }
+
+    // store result
+    textureStore(imageDst, uid, vec4f(alpha / sum));
+}
 )";
 
 const char* cShaderSrc_Effects = R"(
@@ -868,4 +964,91 @@ fn cs_main_tritone(@builtin(global_invocation_id) gid: vec3u) {
     }
     textureStore(imageTrg, uid.xy, tmp * orig.a);
 }
-)";
\ No newline at end of file
+)";
+//************************************************************************
+// compute shader source: path raster
+//************************************************************************
+
+const char* cShaderSrc_Raster = R"(
+struct PaintSettings { transform: mat4x4f, options: vec4f, color: vec4f };
+// viewport: min and max in pixels, offsets: first vertex, first index, triangles count, fill rule
+struct RasterSettings { viewport: vec4u, offsets: vec4u };
+
+@group(0) @binding(0) var imageTrg : texture_storage_2d<rgba8unorm, write>;
+@group(1) @binding(0) var<uniform> uPaintSettings : PaintSettings;
+@group(2) @binding(0) var<uniform> uRasterSettings : RasterSettings;
+@group(3) @binding(0) var<storage, read> vertices : array<vec2f>;
+@group(3) @binding(1) var<storage, read> indices : array<u32>;
+
+const TILE_SIZE = 16u;
+const BIN_SIZE = 768u;
+
+// the edges touching the tile rows, shared by the whole tile
+var<workgroup> bin : array<vec4f, BIN_SIZE>;
+var<workgroup> binCount : atomic<u32>;
+
+// the triangle fan edges in pixels, the inner ones cancel out in the winding
+fn edge(tri: u32, e: u32) -> vec4f {
+    let base = uRasterSettings.offsets.y + tri * 3u;
+    let voff = uRasterSettings.offsets.x;
+    let p0 = uPaintSettings.transform * vec4f(vertices[voff + indices[base + e]], 0.0, 1.0);
+    let p1 = uPaintSettings.transform * vec4f(vertices[voff + indices[base + (e + 1u) % 3u]], 0.0, 1.0);
+    return vec4f(p0.xy, p1.xy);
+}
+
+// signed winding of 4 sub-scanlines, weighted by the pixel area right of the edge
+fn accumulate(seg: vec4f, pix: vec2f, winding: ptr<function, vec4f>) {
+    let dy = seg.w - seg.y;
+    if (dy == 0.0) { return; }
+    let ys = pix.y + vec4f(0.125, 0.375, 0.625, 0.875);
+    let inside = (ys >= vec4f(min(seg.y, seg.w))) & (ys < vec4f(max(seg.y, seg.w)));
+    let xs = seg.x + (ys - seg.y) * (seg.z - seg.x) / dy;
+    let area = clamp(pix.x + 1.0 - xs, vec4f(0.0), vec4f(1.0));
+    *winding += select(vec4f(0.0), area * sign(dy), inside);
+}
+
+@compute @workgroup_size(16, 16)
+fn cs_main(@builtin(global_invocation_id) gid: vec3u, @builtin(workgroup_id) wid: vec3u, @builtin(local_invocation_index) lid: u32) {
+    let vmin = uRasterSettings.viewport.xy;
+    let vmax = uRasterSettings.viewport.zw;
+    let count = uRasterSettings.offsets.z;
+    let tile = vec2f(vmin + wid.xy * TILE_SIZE);
+    let size = f32(TILE_SIZE);
+
+    // binning: the edges right of the tile never reach its pixels
+    if (lid == 0u) { atomicStore(&binCount, 0u); }
+    workgroupBarrier();
+    for (var tri = lid; tri < count; tri += TILE_SIZE * TILE_SIZE) {
+        for (var e = 0u; e < 3u; e++) {
+            let seg = edge(tri, e);
+            if (max(seg.y, seg.w) <= tile.y || min(seg.y, seg.w) >= tile.y + size) { continue; }
+            if (min(seg.x, seg.z) >= tile.x + size) { continue; }
+            let idx = atomicAdd(&binCount, 1u);
+            if (idx < BIN_SIZE) { bin[idx] = seg; }
+        }
+    }
+    workgroupBarrier();
+    let binned = atomicLoad(&binCount);
+
+    // coverage
+    let uid = vmin + gid.xy;
+    if (any(uid >= vmax)) { return; }
+    let pix = vec2f(uid);
+    var winding = vec4f(0.0);
+    if (binned <= BIN_SIZE) {
+        for (var i = 0u; i < binned; i++) { accumulate(bin[i], pix, &winding); }
+    } else {
+        // the bin is overflowed, walk through the whole mesh
+        for (var tri = 0u; tri < count; tri++) {
+            for (var e = 0u; e < 3u; e++) { accumulate(edge(tri, e), pix, &winding); }
+        }
+    }
+    var coverage: vec4f;
+    if (uRasterSettings.offsets.w == 0u) { coverage = min(abs(winding), vec4f(1.0)); }
+    else { coverage = vec4f(1.0) - abs(vec4f(1.0) - 2.0 * fract(winding * 0.5)); }
+
+    let Sc = uPaintSettings.color;
+    let So = uPaintSettings.options.a;
+    textureStore(imageTrg, uid, vec4f(Sc.rgb * Sc.a * So, Sc.a * So) * dot(coverage, vec4f(0.25)));
+}
+)";
@@ -48,4 +48,7 @@ extern const char* cShaderSrc_Blit;
 extern const char* cShaderSrc_GaussianBlur;
 extern const char* cShaderSrc_Effects;
 
+// compute shader sources: path raster
+extern const char* cShaderSrc_Raster;
+
 #endif // _TVG_WG_SHEDER_SRC_H_
@@ -116,4 +116,16 @@ struct WgShaderTypeEffectParams
     bool update(RenderEffectTritone* tritone);
 };
 
+// WGSL: struct RasterSettings { viewport: vec4u, offsets: vec4u };
+struct WgShaderTypeRasterSettings
+{
+    // viewport min and max in pixels
+    uint32_t viewport[4]{};
+    // [0]: first vertex, [1]: first index, [2]: triangles count, [3]: fill rule (0 - non-zero, 1 - even-odd)
+    uint32_t offsets[4]{};
+    // align to 256 bytes (see webgpu spec: minUniformBufferOffsetAlignment)
+    uint8_t _padding[256 - sizeof(viewport) - sizeof(offsets)]{};
+};
+static_assert(sizeof(WgShaderTypeRasterSettings) == 256, "Uniform shader data type size must be aligned to 256 bytes");
+
 #endif // _TVG_WG_SHADER_TYPES_H_
@@ -24,8 +24,9 @@
 #include "tvgMath.h"
 
 
-WgStroker::WgStroker(WgMeshData* buffer, const Matrix& matrix) : mBuffer(buffer), mMatrix(matrix)
+WgStroker::WgStroker(WgMeshData* buffer, const Matrix& matrix, float tolerance) : mBuffer(buffer), mMatrix(matrix), mTolerance(tolerance)
 {
+    mScale = std::max(sqrtf(matrix.e11 * matrix.e11 + matrix.e21 * matrix.e21), sqrtf(matrix.e12 * matrix.e12 + matrix.e22 * matrix.e22));
 }
 
 
@@ -193,7 +194,7 @@ void WgStroker::strokeCubicTo(const Point& cnt1, const Point& cnt2, const Point&
     relCurve.ctrl2 *= mMatrix;
     relCurve.end *= mMatrix;
 
-    auto count = relCurve.segments();
+    auto count = relCurve.segments(mTolerance);
     auto step = 1.f / count;
 
     for (uint32_t i = 0; i <= count; i++) {
@@ -258,8 +259,9 @@ void WgStroker::strokeRound(const Point &prev, const Point& curr, const Point& c
     mRightBottom.x = std::max(mRightBottom.x, std::max(center.x, std::max(prev.x, curr.x)));
     mRightBottom.y = std::max(mRightBottom.y, std::max(center.y, std::max(prev.y, curr.y)));
 
-    // Fixme: just use bezier curve to calculate step count
-    auto count = Bezier(prev, curr, strokeRadius()).segments();
+    //the arc is segmented on the screen
+    auto angle = acosf(tvg::clamp(dot(prev - center, curr - center) / (strokeRadius() * strokeRadius()), -1.0f, 1.0f));
+    auto count = arcSegments(strokeRadius() * mScale, angle, mTolerance) + 1;
     auto c = mBuffer->vbuffer.count;  mBuffer->vbuffer.push(center);
     auto pi = mBuffer->vbuffer.count; mBuffer->vbuffer.push(prev);
     auto step = 1.f / (count - 1);
@@ -290,8 +292,7 @@ void WgStroker::strokeRound(const Point &prev, const Point& curr, const Point& c
 
 void WgStroker::strokeRoundPoint(const Point &p)
 {
-    // Fixme: just use bezier curve to calculate step count
-    auto count = Bezier(p, p, strokeRadius()).segments() * 2;
+    auto count = arcSegments(strokeRadius() * mScale, 2.0f * MATH_PI, mTolerance) + 1;
     auto c = mBuffer->vbuffer.count; mBuffer->vbuffer.push(p);
     auto step = 2 * MATH_PI / (count - 1);
 
@@ -433,7 +434,105 @@ void WgStroker::strokeRound(const Point& p, const Point& outDir)
 }
 
 
-WgBWTessellator::WgBWTessellator(WgMeshData* buffer): mBuffer(buffer)
+static constexpr uint32_t GLYPH_CACHE_BUDGET = 1024 * 1024;   //the vertices kept in total, the cache is flushed beyond
+
+
+static uint32_t _hash(uint32_t id, const float* m)
+{
+    uint32_t bits[4];
+    memcpy(bits, m, sizeof(bits));
+
+    auto h = id * 0x9e3779b1u;
+    for (int i = 0; i < 4; ++i) h = (h ^ bits[i]) * 0x85ebca6bu;
+    return h ^ (h >> 15);
+}
+
+
+WgGlyphCache::~WgGlyphCache()
+{
+    clear();
+    tvg::free(mSlots);
+}
+
+
+WgGlyphCache::Entry* WgGlyphCache::find(uint32_t id, const float* m, float tolerance, uint32_t hash) const
+{
+    if (mCount == 0) return nullptr;
+    for (auto i = hash & (mCapacity - 1); mSlots[i]; i = (i + 1) & (mCapacity - 1)) {
+        auto entry = mSlots[i];
+        if (entry->id == id && entry->tolerance == tolerance && !memcmp(entry->m, m, sizeof(entry->m))) return entry;
+    }
+    return nullptr;
+}
+
+
+void WgGlyphCache::insert(Entry* entry, uint32_t hash)
+{
+    auto vertices = entry->mesh.vbuffer.count;
+    if (mVertices + vertices > GLYPH_CACHE_BUDGET) clear();
+
+    if ((mCount + 1) * 2 > mCapacity) {
+        auto old = mSlots;
+        auto oldCapacity = mCapacity;
+
+        mCapacity = mCapacity ? mCapacity * 2 : 256;
+        mSlots = tvg::calloc<Entry**>(mCapacity, sizeof(Entry*));
+
+        for (uint32_t i = 0; i < oldCapacity; ++i) {
+            if (!old[i]) continue;
+            auto j = _hash(old[i]->id, old[i]->m) & (mCapacity - 1);
+            while (mSlots[j]) j = (j + 1) & (mCapacity - 1);
+            mSlots[j] = old[i];
+        }
+        tvg::free(old);
+    }
+
+    auto i = hash & (mCapacity - 1);
+    while (mSlots[i]) i = (i + 1) & (mCapacity - 1);
+    mSlots[i] = entry;
+    ++mCount;
+    mVertices += vertices;
+}
+
+
+const WgMeshData* WgGlyphCache::mesh(const RenderGlyphRun::Glyph& glyph, const PathCommand* cmds, const Point* pts, const Matrix& matrix, float tolerance)
+{
+    float m[4] = {matrix.e11, matrix.e12, matrix.e21, matrix.e22};
+    auto hash = _hash(glyph.id, m);
+    if (auto entry = find(glyph.id, m, tolerance, hash)) return &entry->mesh;
+
+    //the glyph outline moved to the origin
+    RenderPath path;
+    path.cmds.reserve(glyph.cmdCnt);
+    memcpy(path.cmds.data, cmds, sizeof(PathCommand) * glyph.cmdCnt);
+    path.cmds.count = glyph.cmdCnt;
+    path.pts.reserve(glyph.ptsCnt);
+    for (uint32_t i = 0; i < glyph.ptsCnt; ++i) path.pts.push(pts[i] - glyph.offset);
+
+    auto entry = new Entry;
+    memcpy(entry->m, m, sizeof(entry->m));
+    entry->tolerance = tolerance;
+    entry->id = glyph.id;
+
+    WgBWTessellator bwTess{&entry->mesh, tolerance};
+    bwTess.tessellate(path, matrix);
+
+    insert(entry, hash);
+    return &entry->mesh;
+}
+
+
+void WgGlyphCache::clear()
+{
+    for (uint32_t i = 0; i < mCapacity; ++i) {
+        delete(mSlots[i]);
+        mSlots[i] = nullptr;
+    }
+    mCount = mVertices = 0;
+}
+
+
+WgBWTessellator::WgBWTessellator(WgMeshData* buffer, float tolerance): mBuffer(buffer), mTolerance(tolerance)
 {
 }
 
@@ -458,6 +557,7 @@ void WgBWTessellator::tessellate(const RenderPath& path, const Matrix& matrix)
             case PathCommand::MoveTo: {
                 firstIndex = pushVertex(pts->x, pts->y);
                 prevIndex = 0;
+                ++mContours;
                 pts++;
             } break;
             case PathCommand::LineTo: {
@@ -479,7 +579,7 @@ void WgBWTessellator::tessellate(const RenderPath& path, const Matrix& matrix)
                 relCurve.ctrl2 *= matrix;
                 relCurve.end *= matrix;
 
-                auto stepCount = relCurve.segments();
+                auto stepCount = relCurve.segments(mTolerance);
                 if (stepCount <= 1) stepCount = 2;
 
                 float step = 1.f / stepCount;
@@ -507,6 +607,29 @@ void WgBWTessellator::tessellate(const RenderPath& path, const Matrix& matrix)
 }
 
 
+//the same meshes to tessellate(path, matrix), the glyph meshes are reused
+void WgBWTessellator::tessellate(const RenderPath& path, const RenderGlyphRun& run, const Matrix& matrix, WgGlyphCache& cache)
+{
+    auto cmds = path.cmds.data;
+    auto pts = path.pts.data;
+
+    ScopedLock lock(cache.key);
+
+    ARRAY_FOREACH(p, run.glyphs) {
+        auto mesh = cache.mesh(*p, cmds, pts, matrix, mTolerance);
+        auto base = mBuffer->vbuffer.count;
+
+        mBuffer->vbuffer.grow(mesh->vbuffer.count);
+        ARRAY_FOREACH(v, mesh->vbuffer) pushVertex(v->x + p->offset.x, v->y + p->offset.y);
+        mBuffer->ibuffer.grow(mesh->ibuffer.count);
+        ARRAY_FOREACH(idx, mesh->ibuffer) mBuffer->ibuffer.push(base + *idx);
+
+        cmds += p->cmdCnt;
+        pts += p->ptsCnt;
+    }
+}
+
+
 RenderRegion WgBWTessellator::bounds() const
 {
     return {{int32_t(floor(bbox.min.x)), int32_t(floor(bbox.min.y))}, {int32_t(ceil(bbox.max.x)), int32_t(ceil(bbox.max.y))}};
@@ -519,6 +642,37 @@ BBox WgBWTessellator::getBBox() const
 }
 
 
+//a single contour turning to one side and winding once, its fan triangles never overlap
+bool WgBWTessellator::convex() const
+{
+    if (mContours != 1) return false;
+
+    auto pts = mBuffer->vbuffer.data;
+    auto cnt = mBuffer->vbuffer.count;
+    if (cnt < 3) return false;
+
+    auto turn = 0.0f;
+    auto dx = 0.0f;
+    auto flips = 0;
+
+    for (uint32_t i = 0; i < cnt; ++i) {
+        auto d1 = pts[(i + 1) % cnt] - pts[i];
+        auto d2 = pts[(i + 2) % cnt] - pts[(i + 1) % cnt];
+        auto c = cross(d1, d2);
+        if (fabsf(c) > FLOAT_EPSILON) {
+            if (turn * c < 0.0f) return false;
+            turn = c;
+        }
+        //the x direction of a convex contour turns back twice at most
+        if (d1.x != 0.0f) {
+            if (dx * d1.x < 0.0f && ++flips > 2) return false;
+            dx = d1.x;
+        }
+    }
+    return true;
+}
+
+
 uint32_t WgBWTessellator::pushVertex(float x, float y)
 {
     auto index = mBuffer->vbuffer.count;
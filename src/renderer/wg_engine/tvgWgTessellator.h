@@ -38,7 +38,7 @@ class WgStroker
         Point prevPtDir;
     };
 public:
-    WgStroker(WgMeshData* buffer, const Matrix& matrix);
+    WgStroker(WgMeshData* buffer, const Matrix& matrix, float tolerance);
     void stroke(const RenderShape *rshape);
     RenderRegion bounds() const;
     BBox getBBox() const;
@@ -65,6 +65,8 @@ private:
 
     WgMeshData* mBuffer;
     Matrix mMatrix;
+    float mScale;        //the larger axis scale of the matrix
+    float mTolerance;
     float mStrokeWidth = MIN_WG_STROKE_WIDTH;
     float mMiterLimit = 4.f;
     StrokeCap mStrokeCap = StrokeCap::Square;
@@ -74,19 +76,51 @@ private:
     Point mRightBottom = {0.0f, 0.0f};
 };
 
+//the fill meshes of the glyphs in their own space, shared among the texts of a renderer
+class WgGlyphCache
+{
+public:
+    ~WgGlyphCache();
+    const WgMeshData* mesh(const RenderGlyphRun::Glyph& glyph, const PathCommand* cmds, const Point* pts, const Matrix& matrix, float tolerance);
+    void clear();
+
+    Key key;  //the shapes are tessellated concurrently, hold it while using the meshes
+
+private:
+    struct Entry
+    {
+        WgMeshData mesh;
+        float m[4];           //the linear part of the matrix deciding the curve segments
+        float tolerance;
+        uint32_t id;
+    };
+
+    Entry* find(uint32_t id, const float* m, float tolerance, uint32_t hash) const;
+    void insert(Entry* entry, uint32_t hash);
+
+    Entry** mSlots = nullptr;
+    uint32_t mCapacity = 0;   //power of 2
+    uint32_t mCount = 0;
+    uint32_t mVertices = 0;   //the vertices of the meshes in total
+};
+
 class WgBWTessellator
 {
 public:
-    WgBWTessellator(WgMeshData* buffer);
+    WgBWTessellator(WgMeshData* buffer, float tolerance);
     void tessellate(const RenderPath& path, const Matrix& matrix);
+    void tessellate(const RenderPath& path, const RenderGlyphRun& run, const Matrix& matrix, WgGlyphCache& cache);
     RenderRegion bounds() const;
     BBox getBBox() const;
+    bool convex() const;
 private:
     uint32_t pushVertex(float x, float y);
     void pushTriangle(uint32_t a, uint32_t b, uint32_t c);
 
     WgMeshData* mBuffer;
+    float mTolerance;
     BBox bbox = {};
+    uint32_t mContours = 0;
 };
 
 #endif /* _TVG_WG_TESSELLATOR_H_ */
\ No newline at end of file
@@ -288,10 +288,8 @@ static int _pickChangedPixels(const uint8_t* lastFrame, uint8_t* frame, int numP
 
 // Creates a palette by placing all the image pixels in a k-d tree and then averaging the blocks at the bottom.
 // This is known as the "modified median split" technique
-static void _makePalette(GifWriter* writer, const uint8_t* lastFrame, const uint8_t* nextFrame, uint32_t width, uint32_t height, int bitDepth, bool transparent)
+static void _makePalette(GifWriter* writer, GifPalette& pal, const uint8_t* lastFrame, const uint8_t* nextFrame, uint32_t width, uint32_t height, int bitDepth, bool transparent)
 {
-    auto& pal = writer->pal;
-
     size_t imageSize = (size_t)(width * height * 4 * sizeof(uint8_t));
     memcpy(writer->tmpImage, nextFrame, imageSize);
 
@@ -302,6 +300,8 @@ static void _makePalette(GifWriter* writer, const uint8_t* lastFrame, const uint
     const int splitElt = lastElt/2;
     const int splitDist = splitElt/2;
 
+    // the colors left unused are cleared to be written out the same
+    memset(&pal, 0, sizeof(GifPalette));
     _splitPalette(writer->tmpImage, numPixels, 1, lastElt, splitElt, splitDist, 1, &pal);
 
     // add the bottom node for the transparency index
@@ -311,6 +311,36 @@ static void _makePalette(GifWriter* writer, const uint8_t* lastFrame, const uint
 }
 
 
+// Crops the frame to the pixels which are not left transparent
+static void _cropFrame(GifFrame* frame, uint32_t width, uint32_t height)
+{
+    uint32_t minX = width, minY = height, maxX = 0, maxY = 0;
+    auto pixel = frame->image + 3;
+
+    for (uint32_t yy = 0; yy < height; ++yy) {
+        for (uint32_t xx = 0; xx < width; ++xx, pixel += 4) {
+            if (*pixel == TRANSPARENT_IDX) continue;
+            if (xx < minX) minX = xx;
+            if (xx > maxX) maxX = xx;
+            if (yy < minY) minY = yy;
+            maxY = yy;
+        }
+    }
+
+    // nothing to draw, but the frame still needs to take its time
+    if (minX > maxX) {
+        frame->x = frame->y = 0;
+        frame->w = frame->h = 1;
+        return;
+    }
+
+    frame->x = minX;
+    frame->y = minY;
+    frame->w = maxX - minX + 1;
+    frame->h = maxY - minY + 1;
+}
+
+
 void _palettizePixel(const uint8_t* nextFrame, uint8_t* outFrame, GifPalette* pPal)
 {
     int32_t bestDiff = 1000000;
@@ -326,9 +356,9 @@ void _palettizePixel(const uint8_t* nextFrame, uint8_t* outFrame, GifPalette* pP
 
 
 // Picks palette colors for the image using simple threshholding, no dithering
-static void _thresholdImage(GifWriter* writer, const uint8_t* lastFrame, const uint8_t* nextFrame,  uint32_t width, uint32_t height, bool transparent)
+static void _thresholdImage(GifFrame* frame, const uint8_t* lastFrame, const uint8_t* lastImage, const uint8_t* nextFrame,  uint32_t width, uint32_t height, bool transparent)
 {
-    auto outFrame = writer->oldImage;
+    auto outFrame = frame->image;
     uint32_t numPixels = width*height;
 
     if (transparent) {
@@ -339,7 +369,7 @@ static void _thresholdImage(GifWriter* writer, const uint8_t* lastFrame, const u
                 outFrame[2] = 0;
                 outFrame[3] = TRANSPARENT_IDX;
             } else {
-                _palettizePixel(nextFrame, outFrame, &writer->pal);
+                _palettizePixel(nextFrame, outFrame, &frame->pal);
             }
             if (lastFrame) lastFrame += 4;
             outFrame += 4;
@@ -347,17 +377,26 @@ static void _thresholdImage(GifWriter* writer, const uint8_t* lastFrame, const u
         }
     } else {
         for (uint32_t ii = 0; ii < numPixels; ++ii) {
-            // if a previous color is available, and it matches the current color,
-            // set the pixel to transparent
-            if(lastFrame && lastFrame[0] == nextFrame[0] && lastFrame[1] == nextFrame[1] && lastFrame[2] == nextFrame[2]) {
+            // if the pixel is the same as the previous source one, keep the shown color
+            // by setting the pixel to transparent
+            if(lastFrame && lastImage[0] == nextFrame[0] && lastImage[1] == nextFrame[1] && lastImage[2] == nextFrame[2]) {
                 outFrame[0] = lastFrame[0];
                 outFrame[1] = lastFrame[1];
                 outFrame[2] = lastFrame[2];
                 outFrame[3] = TRANSPARENT_IDX;
             } else {
-                _palettizePixel(nextFrame, outFrame, &writer->pal);
+                // the shown pixel won't change by the quantized one, the last frame might be quantized over in place
+                uint8_t color[4];
+                _palettizePixel(nextFrame, color, &frame->pal);
+                if (lastFrame && lastFrame[0] == color[0] && lastFrame[1] == color[1] && lastFrame[2] == color[2]) {
+                    color[3] = TRANSPARENT_IDX;
+                }
+                memcpy(outFrame, color, 4);
+            }
+            if (lastFrame) {
+                lastFrame += 4;
+                lastImage += 4;
             }
-            if (lastFrame) lastFrame += 4;
             outFrame += 4;
             nextFrame += 4;
         }
@@ -425,10 +464,10 @@ static void _writePalette(const GifPalette* pPal, FILE* f)
 
 
 // write the image header, LZW-compress and write out the image
-static void _writeLzwImage(GifWriter* writer, uint32_t width, uint32_t height, uint32_t delay, bool transparent)
+static void _writeLzwImage(GifWriter* writer, const GifFrame* frame, uint32_t width, uint32_t height, uint32_t delay, bool transparent)
 {
     auto f = writer->f;
-    auto image = writer->oldImage;
+    auto image = frame->image;
 
     // graphics control extension
     fputc(0x21, f);
@@ -443,21 +482,22 @@ static void _writeLzwImage(GifWriter* writer, uint32_t width, uint32_t height, u
     fputc(0x2c, f); // image descriptor block
 
     // corner of image (left, top) in canvas space
-    fputc(0, f);
-    fputc(0, f);
-    fputc(0, f);
-    fputc(0, f);
-
-    fputc(width & 0xff, f);          // width and height of image
-    fputc((width >> 8) & 0xff, f);
-    fputc(height & 0xff, f);
-    fputc((height >> 8) & 0xff, f);
-
-    //fputc(0, f); // no local color table, no transparency
-    //fputc(0x80, f); // no local color table, but transparency
-
-    fputc(0x80 + BIT_DEPTH - 1, f); // local color table present, 2 ^ bitDepth entries
-    _writePalette(&writer->pal, f);
+    fputc(frame->x & 0xff, f);
+    fputc((frame->x >> 8) & 0xff, f);
+    fputc(frame->y & 0xff, f);
+    fputc((frame->y >> 8) & 0xff, f);
+
+    fputc(frame->w & 0xff, f);          // width and height of image
+    fputc((frame->w >> 8) & 0xff, f);
+    fputc(frame->h & 0xff, f);
+    fputc((frame->h >> 8) & 0xff, f);
+
+    if (writer->global) {
+        fputc(0, f); // no local color table
+    } else {
+        fputc(0x80 + BIT_DEPTH - 1, f); // local color table present, 2 ^ bitDepth entries
+        _writePalette(&frame->pal, f);
+    }
 
     const int minCodeSize = BIT_DEPTH;
     const uint32_t clearCode = 1 << BIT_DEPTH;
@@ -478,8 +518,8 @@ static void _writeLzwImage(GifWriter* writer, uint32_t width, uint32_t height, u
 
     _writeCode(f, &stat, clearCode, codeSize);  // start with a fresh LZW dictionary
 
-    for (uint32_t yy = 0; yy < height; ++yy) {
-        for (uint32_t xx=0; xx<width; ++xx) {
+    for (uint32_t yy = frame->y; yy < frame->y + frame->h; ++yy) {
+        for (uint32_t xx = frame->x; xx < frame->x + frame->w; ++xx) {
             // top-left origin
             uint8_t nextValue = image[(yy*width+xx)*4+3];
 
@@ -539,7 +579,7 @@ static void _writeLzwImage(GifWriter* writer, uint32_t width, uint32_t height, u
 /************************************************************************/
 
 
-bool gifBegin(GifWriter* writer, const char* filename, uint32_t width, uint32_t height, uint32_t delay)
+bool gifBegin(GifWriter* writer, const char* filename, uint32_t width, uint32_t height, uint32_t delay, const GifPalette* global)
 {
 #if defined(_MSC_VER) && (_MSC_VER >= 1400)
 	writer->f = 0;
@@ -550,9 +590,12 @@ bool gifBegin(GifWriter* writer, const char* filename, uint32_t width, uint32_t
     if (!writer->f) return false;
 
     writer->firstFrame = true;
+    writer->global = global ? true : false;
+    if (global) writer->pal = *global;
 
     // allocate
-    writer->oldImage = tvg::malloc<uint8_t*>(width*height*4);
+    writer->last.image = tvg::malloc<uint8_t*>(width*height*4);
+    writer->lastImage = tvg::malloc<uint8_t*>(width*height*4);
     writer->tmpImage = tvg::malloc<uint8_t*>(width*height*4);
 
     fputs("GIF89a", writer->f);
@@ -563,19 +606,26 @@ bool gifBegin(GifWriter* writer, const char* filename, uint32_t width, uint32_t
     fputc(height & 0xff, writer->f);
     fputc((height >> 8) & 0xff, writer->f);
 
-    fputc(0xf0, writer->f);  // there is an unsorted global color table of 2 entries
-    fputc(0, writer->f);     // background color
-    fputc(0, writer->f);     // pixels are square (we need to specify this because it's 1989)
-
-    // now the "global" palette (really just a dummy palette)
-    // color 0: black
-    fputc(0, writer->f);
-    fputc(0, writer->f);
-    fputc(0, writer->f);
-    // color 1: also black
-    fputc(0, writer->f);
-    fputc(0, writer->f);
-    fputc(0, writer->f);
+    if (global) {
+        fputc(0xf0 + BIT_DEPTH - 1, writer->f);  // there is an unsorted global color table of 2 ^ bitDepth entries
+        fputc(0, writer->f);     // background color
+        fputc(0, writer->f);     // pixels are square (we need to specify this because it's 1989)
+        _writePalette(global, writer->f);
+    } else {
+        fputc(0xf0, writer->f);  // there is an unsorted global color table of 2 entries
+        fputc(0, writer->f);     // background color
+        fputc(0, writer->f);     // pixels are square (we need to specify this because it's 1989)
+
+        // now the "global" palette (really just a dummy palette)
+        // color 0: black
+        fputc(0, writer->f);
+        fputc(0, writer->f);
+        fputc(0, writer->f);
+        // color 1: also black
+        fputc(0, writer->f);
+        fputc(0, writer->f);
+        fputc(0, writer->f);
+    }
 
     if(delay != 0) {
         // animation header
@@ -600,12 +650,66 @@ bool gifWriteFrame(GifWriter* writer, const uint8_t* image, uint32_t width, uint
 {
     if (!writer->f) return false;
 
-    const uint8_t* oldImage = writer->firstFrame? NULL : writer->oldImage;
+    //the previous frame is quantized over in place
+    gifQuantizeFrame(writer, &writer->last, writer->firstFrame ? NULL : &writer->last, writer->lastImage, image, width, height, transparent);
+    memcpy(writer->lastImage, image, width * height * 4);
     writer->firstFrame = false;
 
-    _makePalette(writer, oldImage, image, width, height, 8, transparent);
-    _thresholdImage(writer, oldImage, image, width, height, transparent);
-    _writeLzwImage(writer, width, height, delay, transparent);
+    return gifEncodeFrame(writer, &writer->last, width, height, delay, transparent);
+}
+
+
+void gifQuantizeFrame(GifWriter* writer, GifFrame* frame, const GifFrame* prev, const uint8_t* prevImage, const uint8_t* image, uint32_t width, uint32_t height, bool transparent)
+{
+    const uint8_t* oldImage = prev ? prev->image : NULL;
+    if (!prev) prevImage = NULL;
+
+    if (writer->global) frame->pal = writer->pal;
+    else _makePalette(writer, frame->pal, prevImage, image, width, height, 8, transparent);
+    _thresholdImage(frame, oldImage, prevImage, image, width, height, transparent);
+    _cropFrame(frame, width, height);
+}
+
+
+uint32_t gifSampleFrame(uint8_t* samples, uint32_t sampled, const uint8_t* image, uint32_t width, uint32_t height, uint32_t sample, uint32_t sampleCnt)
+{
+    auto dst = samples + sampled * 4;
+    auto numPixels = width * height;
+
+    for (auto ii = sample; ii < numPixels; ii += sampleCnt) {
+        auto src = image + ii * 4;
+        if (src[3] < TRANSPARENT_THRESHOLD) continue;
+        dst[0] = src[0];
+        dst[1] = src[1];
+        dst[2] = src[2];
+        dst += 4;
+        ++sampled;
+    }
+    return sampled;
+}
+
+
+void gifMakeGlobalPalette(GifPalette* pal, uint8_t* samples, uint32_t sampled)
+{
+    const int lastElt = 1 << BIT_DEPTH;
+    const int splitElt = lastElt/2;
+    const int splitDist = splitElt/2;
+
+    memset(pal, 0, sizeof(GifPalette));
+    _splitPalette(samples, (int)sampled, 1, lastElt, splitElt, splitDist, 1, pal);
+
+    // add the bottom node for the transparency index
+    pal->treeSplit[1 << (BIT_DEPTH-1)] = 0;
+    pal->treeSplitElt[1 << (BIT_DEPTH-1)] = 0;
+    pal->r[0] = pal->g[0] = pal->b[0] = 0;
+}
+
+
+bool gifEncodeFrame(GifWriter* writer, const GifFrame* frame, uint32_t width, uint32_t height, uint32_t delay, bool transparent)
+{
+    if (!writer->f) return false;
+
+    _writeLzwImage(writer, frame, width, height, delay, transparent);
 
     return true;
 }
@@ -617,11 +721,13 @@ bool gifEnd(GifWriter* writer)
 
     fputc(0x3b, writer->f); // end of file
     fclose(writer->f);
-    tvg::free(writer->oldImage);
+    tvg::free(writer->last.image);
+    tvg::free(writer->lastImage);
     tvg::free(writer->tmpImage);
 
     writer->f = NULL;
-    writer->oldImage = NULL;
+    writer->last.image = NULL;
+    writer->lastImage = NULL;
 
     return true;
 }
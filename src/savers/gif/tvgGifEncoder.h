@@ -40,12 +40,23 @@ typedef struct
 } GifPalette;
 
 
+// A quantized frame, the palette index of every pixel is kept in its alpha channel.
+typedef struct
+{
+    uint8_t* image;
+    GifPalette pal;
+    uint32_t x, y, w, h;    // bounding box of the pixels to write out, the others are left as they were
+} GifFrame;
+
+
 typedef struct
 {
     FILE* f;
-    uint8_t* oldImage;
     uint8_t* tmpImage;
-    GifPalette pal;
+    uint8_t* lastImage;     // the previous source frame
+    GifFrame last;
+    GifPalette pal;         // the global palette shared by all frames if any
+    bool global;
     bool firstFrame;
 } GifWriter;
 
@@ -53,7 +64,16 @@ typedef struct
 // Creates a gif file.
 // The input GIFWriter is assumed to be uninitialized.
 // The delay value is the time between frames in hundredths of a second - note that not all viewers pay much attention to this value.
-bool gifBegin(GifWriter* writer, const char* filename, uint32_t width, uint32_t height, uint32_t delay);
+// If a global palette is given, the frames are quantized with it instead of their own local palettes.
+bool gifBegin(GifWriter* writer, const char* filename, uint32_t width, uint32_t height, uint32_t delay, const GifPalette* global = nullptr);
+
+// Collects the pixels of a frame sampled for a global palette.
+// The sample-th of the sampleCnt frames takes every sampleCnt-th pixel, so that all of them fit in one image sized buffer.
+// Returns the number of the pixels in the buffer.
+uint32_t gifSampleFrame(uint8_t* samples, uint32_t sampled, const uint8_t* image, uint32_t width, uint32_t height, uint32_t sample, uint32_t sampleCnt);
+
+// Builds a global palette from the sampled pixels. The samples are reordered.
+void gifMakeGlobalPalette(GifPalette* pal, uint8_t* samples, uint32_t sampled);
 
 // Writes out a new frame to a GIF in progress.
 // The GIFWriter should have been created by GIFBegin.
@@ -61,6 +81,14 @@ bool gifBegin(GifWriter* writer, const char* filename, uint32_t width, uint32_t
 // this may be handy to save bits in animations that don't change much.
 bool gifWriteFrame(GifWriter* writer, const uint8_t* image, uint32_t width, uint32_t height, uint32_t delay, bool transparent);
 
+// The two halves of gifWriteFrame() for pipelining the frames.
+// Quantizing depends on the previous quantized frame (null for the first one) and its source image,
+// the pixels unchanged from the source are left transparent to keep the shown ones. It uses the writer scratch memory,
+// so the frames must be quantized one after another. They must be encoded in order as well,
+// but encoding a frame can overlap with quantizing the next one.
+void gifQuantizeFrame(GifWriter* writer, GifFrame* frame, const GifFrame* prev, const uint8_t* prevImage, const uint8_t* image, uint32_t width, uint32_t height, bool transparent);
+bool gifEncodeFrame(GifWriter* writer, const GifFrame* frame, uint32_t width, uint32_t height, uint32_t delay, bool transparent);
+
 
 // Writes the EOF code, closes the file handle, and frees temp memory used by a GIF.
 // Many if not most viewers will still display a GIF properly if the EOF code is missing,
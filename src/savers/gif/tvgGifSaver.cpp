@@ -30,20 +30,68 @@
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
-void GifSaver::run(unsigned tid)
+#define GIF_SLOTS 3   //a frame in rendering, one in quantizing, one in encoding
+#define GIF_SAMPLES 8 //frames sampled for a global palette
+
+//a frame in flight, it's quantized after the previous one and written out in order
+struct GifSlot
 {
-    auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
-    if (!canvas) return;
+    struct Quantize : Task
+    {
+        GifSlot* slot;
+        GifSlot* prev;
+
+        void run(TVG_UNUSED unsigned tid) override
+        {
+            auto& ctx = *slot->ctx;
+            if (prev) gifQuantizeFrame(ctx.writer, &slot->frame, &prev->frame, prev->image, slot->image, ctx.w, ctx.h, ctx.transparent);
+            else gifQuantizeFrame(ctx.writer, &slot->frame, nullptr, nullptr, slot->image, ctx.w, ctx.h, ctx.transparent);
+        }
+    } quantize;
 
+    struct Encode : Task
+    {
+        GifSlot* slot;
+
+        void run(TVG_UNUSED unsigned tid) override
+        {
+            auto& ctx = *slot->ctx;
+            gifEncodeFrame(ctx.writer, &slot->frame, ctx.w, ctx.h, ctx.delay, ctx.transparent);
+        }
+    } encode;
+
+    struct Context
+    {
+        GifWriter* writer;
+        uint32_t w, h, delay;
+        bool transparent;
+    } *ctx;
+
+    uint8_t* image = nullptr;    //rendered frame
+    GifFrame frame{};
+
+    ~GifSlot()
+    {
+        quantize.done();
+        encode.done();
+        tvg::free(image);
+        tvg::free(frame.image);
+    }
+};
+
+
+void GifSaver::run(unsigned tid)
+{
     auto w = static_cast<uint32_t>(vsize[0]);
     auto h = static_cast<uint32_t>(vsize[1]);
 
-    buffer = tvg::realloc<uint32_t*>(buffer, sizeof(uint32_t) * w * h);
-    canvas->target(buffer, w, w, h, ColorSpace::ABGR8888S);
-    canvas->push(bg);
-    bg = nullptr;
+    FramePipeline pipeline(animation, bg, w, h, ColorSpace::ABGR8888S);
+    if (!pipeline.valid()) return;
 
-    canvas->push(animation->picture());
+    //the canvas holds the background now
+    auto transparent = bg ? false : true;
+    if (bg) bg->unref();
+    bg = nullptr;
 
     //use the default fps
     if (fps > 60.0f) fps = 60.0f;   // just in case
@@ -52,26 +100,80 @@ void GifSaver::run(unsigned tid)
     }
 
     auto delay = (1.0f / fps);
-    auto transparent = bg ? false : true;
+    auto duration = animation->duration();
+
+    //trade the colors for the size and speed: one palette built from the frames sampled over the animation
+    GifPalette* global = nullptr;
+    if (quality < 100) {
+        auto sampleCnt = uint32_t(duration / delay) + 1;
+        if (sampleCnt > GIF_SAMPLES) sampleCnt = GIF_SAMPLES;
+        auto samples = tvg::malloc<uint8_t*>(sizeof(uint32_t) * w * h);
+        uint32_t sampled = 0;
+        for (uint32_t i = 0; i < sampleCnt; ++i) {
+            auto next = (i + 1 < sampleCnt) ? animation->totalFrame() * (i + 1) / sampleCnt : 0.0f;
+            auto buffer = pipeline.draw(animation->totalFrame() * i / sampleCnt, next);
+            sampled = gifSampleFrame(samples, sampled, reinterpret_cast<const uint8_t*>(buffer), w, h, i, sampleCnt);
+        }
+        global = tvg::malloc<GifPalette*>(sizeof(GifPalette));
+        gifMakeGlobalPalette(global, samples, sampled);
+        tvg::free(samples);
+    }
 
     GifWriter writer;
-    if (!gifBegin(&writer, path, w, h, uint32_t(delay * 100.f))) {
+    auto ret = gifBegin(&writer, path, w, h, uint32_t(delay * 100.f), global);
+    tvg::free(global);
+    if (!ret) {
         TVGERR("GIF_SAVER", "Failed gif encoding");
         return;
     }
 
-    auto duration = animation->duration();
+    /* Render the next frames while the previous ones are quantized and encoded on the other workers.
+       This worker blocks on the pipeline tasks, so one more is necessary to run them. */
+    if (TaskScheduler::threads() > 1) {
+        GifSlot::Context ctx = {&writer, w, h, uint32_t(delay * 100.0f), transparent};
+        GifSlot slots[GIF_SLOTS];
+        for (auto& slot : slots) {
+            slot.ctx = &ctx;
+            slot.quantize.slot = slot.encode.slot = &slot;
+            slot.image = tvg::malloc<uint8_t*>(sizeof(uint32_t) * w * h);
+            slot.frame.image = tvg::malloc<uint8_t*>(sizeof(uint32_t) * w * h);
+        }
 
-    for (auto p = 0.0f; p < duration; p += delay) {
-        auto frameNo = animation->totalFrame() * (p / duration);
-        animation->frame(frameNo);
-        canvas->update();
-        if (canvas->draw(true) == tvg::Result::Success) {
-            canvas->sync();
+        GifSlot* prev = nullptr;
+        uint32_t idx = 0;
+
+        for (auto p = 0.0f; p < duration; p += delay, ++idx) {
+            auto next = (p + delay < duration) ? animation->totalFrame() * ((p + delay) / duration) : -1.0f;
+            auto buffer = pipeline.draw(animation->totalFrame() * (p / duration), next);
+
+            //the slot of the frame GIF_SLOTS before must be flushed out, its source is read by the next one as well
+            auto& slot = slots[idx % GIF_SLOTS];
+            slots[(idx + 1) % GIF_SLOTS].quantize.done();
+            slot.encode.done();
+            memcpy(slot.image, buffer, sizeof(uint32_t) * w * h);
+
+            slot.quantize.prev = prev;
+            if (prev) {
+                Task* deps[] = {&prev->quantize};
+                TaskScheduler::request(&slot.quantize, deps, 1);
+                Task* deps2[] = {&slot.quantize, &prev->encode};
+                TaskScheduler::request(&slot.encode, deps2, 2);
+            } else {
+                TaskScheduler::request(&slot.quantize);
+                Task* deps[] = {&slot.quantize};
+                TaskScheduler::request(&slot.encode, deps, 1);
+            }
+            prev = &slot;
         }
-        if (!gifWriteFrame(&writer, reinterpret_cast<uint8_t*>(buffer), w, h, uint32_t(delay * 100.0f), transparent)) {
-            TVGERR("GIF_SAVER", "Failed gif encoding");
-            break;
+        //the last one is encoded after all the others
+        if (prev) prev->encode.done();
+    } else {
+        for (auto p = 0.0f; p < duration; p += delay) {
+            auto buffer = pipeline.draw(animation->totalFrame() * (p / duration));
+            if (!gifWriteFrame(&writer, reinterpret_cast<const uint8_t*>(buffer), w, h, uint32_t(delay * 100.0f), transparent)) {
+                TVGERR("GIF_SAVER", "Failed gif encoding");
+                break;
+            }
         }
     }
 
@@ -103,9 +205,6 @@ bool GifSaver::close()
     tvg::free(path);
     path = nullptr;
 
-    tvg::free(buffer);
-    buffer = nullptr;
-
     return true;
 }
 
@@ -117,7 +216,7 @@ bool GifSaver::save(TVG_UNUSED Paint* paint, TVG_UNUSED Paint* bg, TVG_UNUSED co
 }
 
 
-bool GifSaver::save(Animation* animation, Paint* bg, const char* filename, TVG_UNUSED uint32_t quality, uint32_t fps)
+bool GifSaver::save(Animation* animation, Paint* bg, const char* filename, uint32_t quality, uint32_t fps)
 {
     close();
 
@@ -145,6 +244,7 @@ bool GifSaver::save(Animation* animation, Paint* bg, const char* filename, TVG_U
         this->bg = bg;
     }
     this->fps = static_cast<float>(fps);
+    this->quality = quality;
 
     TaskScheduler::request(this);
 
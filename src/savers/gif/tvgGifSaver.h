@@ -32,12 +32,12 @@ namespace tvg
 class GifSaver : public SaveModule, public Task
 {
 private:
-    uint32_t* buffer = nullptr;
     Animation* animation = nullptr;
     Paint* bg = nullptr;
     char *path = nullptr;
     float vsize[2] = {0.0f, 0.0f};
     float fps = 0.0f;
+    uint32_t quality = 100;
 
     void run(unsigned tid) override;
 
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdio>
+#include "tvgStr.h"
+#include "tvgFile.h"
+#include "tvgPicture.h"
+#include "tvgFrameModule.h"
+#include "tvgLottieModel.h"
+#include "tvgLottieParser.h"
+#include "tvgLottieCompiler.h"
+#include "tvgLottieSaver.h"
+
+/************************************************************************/
+/* Internal Class Implementation                                        */
+/************************************************************************/
+
+//the whole model is parsed from the source file, the loaded one may defer its precomps
+static bool _compile(const char* path, Array<uint8_t>& out)
+{
+    FileMap file;
+    if (!file.open(path, FileMap::Writable | FileMap::Terminated)) return false;
+
+    auto content = reinterpret_cast<char*>(file.data);
+    if (LottieCompiler::compiled(content, file.size)) {
+        TVGLOG("LOTTIE_SAVER", "%s is compiled already.", path);
+        file.close();
+        return false;
+    }
+
+    auto dirName = tvg::dirname(path);
+    auto ret = false;
+    {
+        //the expressions are parsed to be found, not to be compiled
+        LottieParser parser(content, dirName, true);
+        if (parser.parse()) {
+            ret = !parser.slots && LottieCompiler::compile(parser.comp, out);
+            delete(parser.comp);
+        }
+    }
+    tvg::free(dirName);
+    file.close();
+
+    if (!ret) TVGLOG("LOTTIE_SAVER", "%s has the contents which can't be compiled.", path);
+
+    return ret;
+}
+
+
+void LottieSaver::run(TVG_UNUSED unsigned tid)
+{
+#if defined(_MSC_VER) && (_MSC_VER >= 1400)
+    FILE* f = 0;
+    fopen_s(&f, path, "wb");
+#else
+    auto f = fopen(path, "wb");
+#endif
+    if (!f) {
+        TVGERR("LOTTIE_SAVER", "Failed to open %s", path);
+        return;
+    }
+    if (fwrite(data.data, sizeof(uint8_t), data.count, f) != data.count) TVGERR("LOTTIE_SAVER", "Failed to write %s", path);
+    fclose(f);
+}
+
+
+/************************************************************************/
+/* External Class Implementation                                        */
+/************************************************************************/
+
+LottieSaver::~LottieSaver()
+{
+    close();
+}
+
+
+bool LottieSaver::close()
+{
+    this->done();
+
+    //animation holds the picture, it must be 1 at the bottom.
+    if (animation && animation->picture()->refCnt() <= 1) delete(animation);
+    animation = nullptr;
+
+    data.reset();
+
+    tvg::free(path);
+    path = nullptr;
+
+    return true;
+}
+
+
+bool LottieSaver::save(TVG_UNUSED Paint* paint, TVG_UNUSED Paint* bg, TVG_UNUSED const char* filename, TVG_UNUSED uint32_t quality)
+{
+    TVGLOG("LOTTIE_SAVER", "Paint is not supported.");
+    return false;
+}
+
+
+bool LottieSaver::save(Animation* animation, TVG_UNUSED Paint* bg, const char* filename, TVG_UNUSED uint32_t quality, TVG_UNUSED uint32_t fps)
+{
+    close();
+
+    if (!filename) return false;
+
+    //the model of a lottie file, shared by its instances without any slots nor expressions
+    auto loader = PICTURE(animation->picture())->loader;
+    if (!loader || loader->type != FileType::Lot) return false;
+
+    auto origin = static_cast<FrameModule*>(loader)->origin();
+    if (!origin) {
+        TVGLOG("LOTTIE_SAVER", "Only the lottie files without slots nor expressions are compiled.");
+        return false;
+    }
+
+    //compiled up front to report the failure
+    if (!_compile(origin, data)) return false;
+
+    this->path = duplicate(filename);
+    this->animation = animation;
+
+    TaskScheduler::request(this);
+
+    return true;
+}
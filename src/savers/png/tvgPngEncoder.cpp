@@ -0,0 +1,789 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstring>
+#include <cstdlib>
+#include "tvgTaskScheduler.h"
+#include "tvgPngEncoder.h"
+
+/************************************************************************/
+/* Internal Class Implementation                                        */
+/************************************************************************/
+
+#define PNG_MAX_SIZE (1 << 24)
+#define CHUNK_SIZE (256 * 1024)         // filtered bytes deflated by a task
+#define WINDOW_SIZE 32768               // the farthest distance, the previous chunk tail primes the dictionary of the next one
+#define HASH_BITS 15
+#define MIN_MATCH 3
+#define MAX_MATCH 258
+#define TOO_FAR 4096                    // the shortest matches don't pay for the longer distances
+#define BLOCK_TOKENS 16384              // a block of its own huffman codes per these tokens
+#define END_OF_BLOCK 256
+#define NUM_LITLENS 286
+#define NUM_DISTANCES 30
+#define NUM_CODE_LENGTHS 19
+#define MAX_CODE_LENGTH 15
+#define NUM_FILTERS 5
+#define ADLER_BASE 65521
+
+static const uint8_t codeLengthOrder[NUM_CODE_LENGTHS] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+static const uint16_t lengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t distanceBase[NUM_DISTANCES] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static const uint8_t distanceExtra[NUM_DISTANCES] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+
+// the match parameters per the level, zlib alike
+struct PngEffort
+{
+    uint32_t chain;     // candidates to try
+    uint32_t nice;      // long enough to stop the search
+    bool lazy;          // defer a match for the longer one at the next byte
+};
+
+static const PngEffort efforts[4] = {{4, 16, false}, {16, 64, false}, {64, 128, true}, {256, MAX_MATCH, true}};
+
+
+struct BitWriter
+{
+    uint8_t* data = nullptr;
+    uint32_t size = 0;
+    uint32_t reserved = 0;
+    uint64_t bits = 0;
+    uint32_t used = 0;
+
+    void grow(uint32_t n)
+    {
+        if (size + n <= reserved) return;
+        reserved = (size + n) * 2;
+        data = tvg::realloc<uint8_t*>(data, reserved);
+    }
+
+    // n <= 32
+    void put(uint32_t value, uint32_t n)
+    {
+        bits |= uint64_t(value) << used;
+        used += n;
+        if (used < 32) return;
+        grow(4);
+        data[size++] = bits & 0xff;
+        data[size++] = (bits >> 8) & 0xff;
+        data[size++] = (bits >> 16) & 0xff;
+        data[size++] = (bits >> 24) & 0xff;
+        bits >>= 32;
+        used -= 32;
+    }
+
+    // pads up to the byte boundary
+    void flush()
+    {
+        while (used > 0) {
+            grow(1);
+            data[size++] = bits & 0xff;
+            bits >>= 8;
+            used = (used > 8) ? (used - 8) : 0;
+        }
+    }
+
+    void bytes(const void* src, uint32_t n)
+    {
+        grow(n);
+        memcpy(data + size, src, n);
+        size += n;
+    }
+};
+
+
+struct HuffmanCode
+{
+    uint8_t depths[NUM_LITLENS];
+    uint16_t codes[NUM_LITLENS];    // bit reversed canonical codes
+};
+
+
+struct HuffmanLeaf
+{
+    uint32_t weight;
+    uint32_t symbol;
+};
+
+
+// a literal if the distance is zero, otherwise a match
+struct Token
+{
+    uint16_t value;     // the literal byte or the match length
+    uint16_t distance;
+};
+
+
+// the shared state of the encoding tasks
+struct PngContext
+{
+    const uint32_t* image;
+    uint8_t* filtered;      // the filter type prefixed rows, the zlib stream input
+    uint32_t width;
+    uint32_t channels;
+    uint32_t stride;        // a filtered row size
+    uint32_t rows;          // rows per chunk
+    const PngEffort* effort;
+};
+
+
+// filters the rows of a chunk, they only refer to the source image
+struct PngFilter : Task
+{
+    PngContext* ctx;
+    uint32_t begin, end;    // rows
+
+    void run(unsigned tid) override;
+};
+
+
+// deflates a chunk into an IDAT once its rows and the previous ones are filtered
+struct PngDeflate : Task
+{
+    PngContext* ctx;
+    uint32_t begin, end;    // bytes of the filtered rows
+    BitWriter bw;           // the whole IDAT chunk
+    uint32_t adler;
+
+    void run(unsigned tid) override;
+
+    ~PngDeflate()
+    {
+        tvg::free(bw.data);
+    }
+};
+
+
+static uint32_t _crc(uint32_t crc, const uint8_t* data, uint32_t size)
+{
+    struct Table
+    {
+        uint32_t values[256];
+
+        Table()
+        {
+            for (uint32_t i = 0; i < 256; ++i) {
+                auto c = i;
+                for (int k = 0; k < 8; ++k) c = (c & 1) ? (0xedb88320 ^ (c >> 1)) : (c >> 1);
+                values[i] = c;
+            }
+        }
+    };
+    static const Table table;
+
+    crc = ~crc;
+    for (uint32_t i = 0; i < size; ++i) crc = table.values[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+
+static uint32_t _adler(const uint8_t* data, uint32_t size)
+{
+    uint32_t a = 1, b = 0;
+    while (size > 0) {
+        // the largest run not to overflow before the modulo
+        auto n = (size < 5552) ? size : 5552;
+        size -= n;
+        while (n-- > 0) {
+            a += *data++;
+            b += a;
+        }
+        a %= ADLER_BASE;
+        b %= ADLER_BASE;
+    }
+    return (b << 16) | a;
+}
+
+
+// the checksum of the two joined pieces, from the checksum of each and the second size
+static uint32_t _adlerJoin(uint32_t adler1, uint32_t adler2, uint32_t size2)
+{
+    auto rem = size2 % ADLER_BASE;
+    auto a = adler1 & 0xffff;
+    auto b = (rem * a) % ADLER_BASE;
+    a += (adler2 & 0xffff) + ADLER_BASE - 1;
+    b += (adler1 >> 16) + (adler2 >> 16) + ADLER_BASE - rem;
+    if (a >= ADLER_BASE) a -= ADLER_BASE;
+    if (a >= ADLER_BASE) a -= ADLER_BASE;
+    if (b >= (ADLER_BASE << 1)) b -= (ADLER_BASE << 1);
+    if (b >= ADLER_BASE) b -= ADLER_BASE;
+    return (b << 16) | a;
+}
+
+
+static void _putBE32(uint8_t* p, uint32_t v)
+{
+    p[0] = (v >> 24) & 0xff;
+    p[1] = (v >> 16) & 0xff;
+    p[2] = (v >> 8) & 0xff;
+    p[3] = v & 0xff;
+}
+
+
+// a png chunk of the given data, its length and type prefixed and its crc suffixed
+static bool _writeChunk(FILE* f, const char* type, const uint8_t* data, uint32_t size)
+{
+    uint8_t header[8];
+    _putBE32(header, size);
+    memcpy(header + 4, type, 4);
+    uint8_t crc[4];
+    _putBE32(crc, _crc(_crc(0, header + 4, 4), data, size));
+    return fwrite(header, 1, 8, f) == 8 && (size == 0 || fwrite(data, 1, size, f) == size) && fwrite(crc, 1, 4, f) == 4;
+}
+
+
+static int _compareLeaves(const void* a, const void* b)
+{
+    auto l = static_cast<const HuffmanLeaf*>(a);
+    auto r = static_cast<const HuffmanLeaf*>(b);
+    if (l->weight != r->weight) return (l->weight < r->weight) ? -1 : 1;
+    return (l->symbol < r->symbol) ? -1 : 1;
+}
+
+
+static void _buildDepths(const uint32_t* histo, uint32_t count, uint32_t limit, uint8_t* depths)
+{
+    memset(depths, 0, count);
+
+    HuffmanLeaf leaves[NUM_LITLENS];
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (histo[i]) leaves[n++] = {histo[i], i};
+    }
+    // a single symbol still takes a bit in deflate
+    if (n <= 1) {
+        if (n == 1) depths[leaves[0].symbol] = 1;
+        return;
+    }
+    qsort(leaves, n, sizeof(HuffmanLeaf), _compareLeaves);
+
+    uint32_t weights[2 * NUM_LITLENS];
+    uint32_t parents[2 * NUM_LITLENS];
+    uint32_t levels[2 * NUM_LITLENS];
+
+    // the rare symbols are raised until the tree fits in the length limit
+    for (uint32_t floor = 1; ; floor *= 2) {
+        for (uint32_t i = 0; i < n; ++i) {
+            weights[i] = (leaves[i].weight < floor) ? floor : leaves[i].weight;
+        }
+        // two queues, the sorted leaves and the merged nodes in the order they are made
+        uint32_t leaf = 0, node = n;
+        for (uint32_t next = n; next < 2 * n - 1; ++next) {
+            uint32_t pick[2];
+            for (auto& p : pick) {
+                if (leaf < n && (node == next || weights[leaf] <= weights[node])) p = leaf++;
+                else p = node++;
+            }
+            weights[next] = weights[pick[0]] + weights[pick[1]];
+            parents[pick[0]] = parents[pick[1]] = next;
+        }
+        // the parents are made after their children
+        uint32_t maxLevel = 0;
+        levels[2 * n - 2] = 0;
+        for (int32_t i = 2 * n - 3; i >= 0; --i) {
+            levels[i] = levels[parents[i]] + 1;
+            if (levels[i] > maxLevel) maxLevel = levels[i];
+        }
+        if (maxLevel <= limit) break;
+    }
+
+    for (uint32_t i = 0; i < n; ++i) {
+        depths[leaves[i].symbol] = levels[i];
+    }
+}
+
+
+static void _buildCode(HuffmanCode* code, const uint32_t* histo, uint32_t count, uint32_t limit)
+{
+    _buildDepths(histo, count, limit, code->depths);
+
+    uint32_t lengths[MAX_CODE_LENGTH + 1] = {};
+    for (uint32_t i = 0; i < count; ++i) {
+        if (code->depths[i]) ++lengths[code->depths[i]];
+    }
+
+    uint32_t next[MAX_CODE_LENGTH + 1];
+    uint32_t value = 0;
+    next[0] = 0;
+    for (uint32_t len = 1; len <= MAX_CODE_LENGTH; ++len) {
+        value = (value + lengths[len - 1]) << 1;
+        next[len] = value;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        auto depth = code->depths[i];
+        code->codes[i] = 0;
+        if (depth == 0) continue;
+        auto canonical = next[depth]++;
+        uint32_t reversed = 0;
+        for (uint32_t k = 0; k < depth; ++k) {
+            reversed = (reversed << 1) | ((canonical >> k) & 1);
+        }
+        code->codes[i] = reversed;
+    }
+}
+
+
+// run length coding of the code lengths: 16 repeats the previous length, 17 and 18 are zero runs
+static uint32_t _tokenizeDepths(const uint8_t* depths, uint32_t count, uint8_t* tokens, uint8_t* extras)
+{
+    uint32_t n = 0;
+    uint32_t prev = 0xff;
+
+    for (uint32_t i = 0; i < count; ) {
+        auto value = depths[i];
+        uint32_t run = 1;
+        while (i + run < count && depths[i + run] == value) ++run;
+        i += run;
+
+        if (value == 0) {
+            while (run >= 11) {
+                auto repeat = (run > 138) ? 138 : run;
+                tokens[n] = 18;
+                extras[n++] = repeat - 11;
+                run -= repeat;
+            }
+            if (run >= 3) {
+                tokens[n] = 17;
+                extras[n++] = run - 3;
+                run = 0;
+            }
+        } else {
+            if (value != prev) {
+                tokens[n] = value;
+                extras[n++] = 0;
+                --run;
+            }
+            while (run >= 3) {
+                auto repeat = (run > 6) ? 6 : run;
+                tokens[n] = 16;
+                extras[n++] = repeat - 3;
+                run -= repeat;
+            }
+        }
+        while (run > 0) {
+            tokens[n] = value;
+            extras[n++] = 0;
+            --run;
+        }
+        prev = value;
+    }
+    return n;
+}
+
+
+static inline uint32_t _lengthCode(uint32_t length)
+{
+    if (length == MAX_MATCH) return 28;
+    auto v = length - MIN_MATCH;
+    if (v < 8) return v;
+    uint32_t e = 0;
+    while ((v >> (e + 3)) > 0) ++e;     // floor(log2(v)) - 2
+    return 4 * e + ((v >> e) & 3) + 4;
+}
+
+
+static inline uint32_t _distanceCode(uint32_t distance)
+{
+    auto v = distance - 1;
+    if (v < 4) return v;
+    uint32_t e = 0;
+    while ((v >> (e + 2)) > 0) ++e;     // floor(log2(v)) - 1
+    return 2 * e + ((v >> e) & 1) + 2;
+}
+
+
+// a dynamic huffman block of the tokens, not the final one
+static void _writeBlock(BitWriter& bw, const Token* tokens, uint32_t count)
+{
+    uint32_t litHisto[NUM_LITLENS] = {};
+    uint32_t distHisto[NUM_DISTANCES] = {};
+
+    for (uint32_t i = 0; i < count; ++i) {
+        auto& t = tokens[i];
+        if (t.distance == 0) ++litHisto[t.value];
+        else {
+            ++litHisto[257 + _lengthCode(t.value)];
+            ++distHisto[_distanceCode(t.distance)];
+        }
+    }
+    ++litHisto[END_OF_BLOCK];
+    // at least a distance code is described even with no matches
+    uint32_t matches = 0;
+    for (auto h : distHisto) matches += h;
+    if (matches == 0) distHisto[0] = 1;
+
+    HuffmanCode lit, dist;
+    _buildCode(&lit, litHisto, NUM_LITLENS, MAX_CODE_LENGTH);
+    _buildCode(&dist, distHisto, NUM_DISTANCES, MAX_CODE_LENGTH);
+
+    uint32_t hlit = NUM_LITLENS, hdist = NUM_DISTANCES;
+    while (hlit > 257 && lit.depths[hlit - 1] == 0) --hlit;
+    while (hdist > 1 && dist.depths[hdist - 1] == 0) --hdist;
+
+    // the code lengths of both alphabets are a single sequence
+    uint8_t depths[NUM_LITLENS + NUM_DISTANCES];
+    memcpy(depths, lit.depths, hlit);
+    memcpy(depths + hlit, dist.depths, hdist);
+
+    uint8_t lenTokens[NUM_LITLENS + NUM_DISTANCES];
+    uint8_t lenExtras[NUM_LITLENS + NUM_DISTANCES];
+    auto cnt = _tokenizeDepths(depths, hlit + hdist, lenTokens, lenExtras);
+
+    uint32_t lenHisto[NUM_CODE_LENGTHS] = {};
+    for (uint32_t i = 0; i < cnt; ++i) ++lenHisto[lenTokens[i]];
+
+    HuffmanCode lengths;
+    _buildCode(&lengths, lenHisto, NUM_CODE_LENGTHS, 7);
+
+    uint32_t hclen = NUM_CODE_LENGTHS;
+    while (hclen > 4 && lengths.depths[codeLengthOrder[hclen - 1]] == 0) --hclen;
+
+    bw.put(2 << 1, 3);      // not final, dynamic codes
+    bw.put(hlit - 257, 5);
+    bw.put(hdist - 1, 5);
+    bw.put(hclen - 4, 4);
+    for (uint32_t i = 0; i < hclen; ++i) bw.put(lengths.depths[codeLengthOrder[i]], 3);
+
+    for (uint32_t i = 0; i < cnt; ++i) {
+        auto token = lenTokens[i];
+        bw.put(lengths.codes[token], lengths.depths[token]);
+        if (token == 16) bw.put(lenExtras[i], 2);
+        else if (token == 17) bw.put(lenExtras[i], 3);
+        else if (token == 18) bw.put(lenExtras[i], 7);
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        auto& t = tokens[i];
+        if (t.distance == 0) {
+            bw.put(lit.codes[t.value], lit.depths[t.value]);
+            continue;
+        }
+        auto lcode = _lengthCode(t.value);
+        bw.put(lit.codes[257 + lcode], lit.depths[257 + lcode]);
+        if (lengthExtra[lcode]) bw.put(t.value - lengthBase[lcode], lengthExtra[lcode]);
+        auto dcode = _distanceCode(t.distance);
+        bw.put(dist.codes[dcode], dist.depths[dcode]);
+        if (distanceExtra[dcode]) bw.put(t.distance - distanceBase[dcode], distanceExtra[dcode]);
+    }
+    bw.put(lit.codes[END_OF_BLOCK], lit.depths[END_OF_BLOCK]);
+}
+
+
+static inline uint32_t _hash(const uint8_t* p)
+{
+    return ((uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16)) * 2654435761u) >> (32 - HASH_BITS);
+}
+
+
+static inline uint32_t _match(const uint8_t* a, const uint8_t* b, uint32_t max)
+{
+    uint32_t len = 0;
+    while (len < max && a[len] == b[len]) ++len;
+    return len;
+}
+
+
+/* LZ77 over the hash chains of the chunk and the window before it, the earlier chunks are just a dictionary.
+   The chunk is ended with a sync flush, the next one starts on a byte boundary. */
+static void _deflate(BitWriter& bw, const uint8_t* data, uint32_t begin, uint32_t end, const PngEffort& effort)
+{
+    auto base = (begin > WINDOW_SIZE) ? (begin - WINDOW_SIZE) : 0;
+    auto head = tvg::malloc<int32_t*>(sizeof(int32_t) * (1 << HASH_BITS));
+    auto chain = tvg::malloc<int32_t*>(sizeof(int32_t) * (end - base));
+    memset(head, 0xff, sizeof(int32_t) * (1 << HASH_BITS));
+
+    auto insert = [&](uint32_t pos) {
+        if (pos + MIN_MATCH > end) return;
+        auto h = _hash(data + pos);
+        chain[pos - base] = head[h];
+        head[h] = int32_t(pos);
+    };
+
+    auto longest = [&](uint32_t pos, uint32_t& distance) {
+        uint32_t best = 0;
+        if (pos + MIN_MATCH > end) return best;
+        auto max = (end - pos < MAX_MATCH) ? (end - pos) : MAX_MATCH;
+        auto candidate = head[_hash(data + pos)];
+        for (auto tries = effort.chain; candidate >= 0 && tries > 0; --tries) {
+            auto d = pos - uint32_t(candidate);
+            if (d > WINDOW_SIZE) break;
+            if (data[candidate + best] == data[pos + best]) {
+                auto len = _match(data + candidate, data + pos, max);
+                if (len > best && (len > MIN_MATCH || d <= TOO_FAR)) {
+                    best = len;
+                    distance = d;
+                    if (len >= effort.nice || len == max) break;
+                }
+            }
+            candidate = chain[candidate - base];
+        }
+        return (best >= MIN_MATCH) ? best : 0;
+    };
+
+    for (auto pos = base; pos < begin; ++pos) insert(pos);
+
+    auto tokens = tvg::malloc<Token*>(sizeof(Token) * BLOCK_TOKENS);
+    uint32_t count = 0;
+
+    auto emit = [&](uint32_t value, uint32_t distance) {
+        tokens[count++] = {uint16_t(value), uint16_t(distance)};
+        if (count == BLOCK_TOKENS) {
+            _writeBlock(bw, tokens, count);
+            count = 0;
+        }
+    };
+
+    for (auto pos = begin; pos < end; ) {
+        uint32_t distance = 0;
+        auto len = longest(pos, distance);
+        insert(pos);
+        // a longer match at the next byte is worth a literal
+        if (effort.lazy && len > 0 && len < effort.nice) {
+            uint32_t distance2 = 0;
+            auto len2 = longest(pos + 1, distance2);
+            if (len2 > len) {
+                emit(data[pos++], 0);
+                insert(pos);
+                len = len2;
+                distance = distance2;
+            }
+        }
+        if (len > 0) {
+            emit(len, distance);
+            for (uint32_t i = 1; i < len; ++i) insert(pos + i);
+            pos += len;
+        } else emit(data[pos++], 0);
+    }
+    if (count > 0) _writeBlock(bw, tokens, count);
+
+    // sync flush: an empty stored block
+    bw.put(0, 3);
+    bw.flush();
+    uint8_t sync[4] = {0x00, 0x00, 0xff, 0xff};
+    bw.bytes(sync, 4);
+
+    tvg::free(tokens);
+    tvg::free(chain);
+    tvg::free(head);
+}
+
+
+static inline uint8_t _paeth(uint8_t a, uint8_t b, uint8_t c)
+{
+    int32_t pa = abs(int32_t(b) - int32_t(c));
+    int32_t pb = abs(int32_t(a) - int32_t(c));
+    int32_t pc = abs(int32_t(a) + int32_t(b) - 2 * int32_t(c));
+    return (pa <= pb && pa <= pc) ? a : ((pb <= pc) ? b : c);
+}
+
+
+/* All the filters are tried out and the one of the least sum of the signed residuals is taken, the libpng heuristic.
+   The loops are branchless over the plain bytes, the compiler vectorizes them. */
+static void _filterRow(const uint8_t* cur, const uint8_t* up, uint32_t size, uint32_t bpp, uint8_t* candidates, uint8_t* out)
+{
+    auto sub = candidates;
+    auto avg = candidates + size;
+    auto paeth = candidates + 2 * size;
+    auto upper = candidates + 3 * size;
+
+    for (uint32_t i = 0; i < bpp; ++i) {
+        sub[i] = cur[i];
+        upper[i] = cur[i] - up[i];
+        avg[i] = cur[i] - (up[i] >> 1);
+        paeth[i] = cur[i] - up[i];
+    }
+    for (uint32_t i = bpp; i < size; ++i) {
+        sub[i] = cur[i] - cur[i - bpp];
+        upper[i] = cur[i] - up[i];
+        avg[i] = cur[i] - uint8_t((uint32_t(cur[i - bpp]) + uint32_t(up[i])) >> 1);
+        paeth[i] = cur[i] - _paeth(cur[i - bpp], up[i], up[i - bpp]);
+    }
+
+    const uint8_t* rows[NUM_FILTERS] = {cur, sub, upper, avg, paeth};
+    uint32_t best = 0, bestCost = UINT32_MAX;
+    for (uint32_t f = 0; f < NUM_FILTERS; ++f) {
+        uint32_t cost = 0;
+        auto row = rows[f];
+        for (uint32_t i = 0; i < size; ++i) cost += abs(int32_t(int8_t(row[i])));
+        if (cost < bestCost) {
+            best = f;
+            bestCost = cost;
+        }
+    }
+    out[0] = uint8_t(best);
+    memcpy(out + 1, rows[best], size);
+}
+
+
+static void _unpack(const uint32_t* src, uint32_t width, uint32_t channels, uint8_t* dst)
+{
+    if (channels == 4) {
+        for (uint32_t x = 0; x < width; ++x, dst += 4) {
+            dst[0] = src[x] & 0xff;
+            dst[1] = (src[x] >> 8) & 0xff;
+            dst[2] = (src[x] >> 16) & 0xff;
+            dst[3] = (src[x] >> 24) & 0xff;
+        }
+    } else {
+        for (uint32_t x = 0; x < width; ++x, dst += 3) {
+            dst[0] = src[x] & 0xff;
+            dst[1] = (src[x] >> 8) & 0xff;
+            dst[2] = (src[x] >> 16) & 0xff;
+        }
+    }
+}
+
+
+void PngFilter::run(TVG_UNUSED unsigned tid)
+{
+    auto size = ctx->stride - 1;
+    auto buffer = tvg::calloc<uint8_t*>(size, 6);   // the current and the upper rows, and the filter candidates
+    auto cur = buffer;
+    auto up = buffer + size;
+
+    if (begin > 0) _unpack(ctx->image + (begin - 1) * ctx->width, ctx->width, ctx->channels, up);
+
+    for (auto y = begin; y < end; ++y) {
+        _unpack(ctx->image + y * ctx->width, ctx->width, ctx->channels, cur);
+        _filterRow(cur, up, size, ctx->channels, buffer + 2 * size, ctx->filtered + size_t(y) * ctx->stride);
+        std::swap(cur, up);
+    }
+    tvg::free(buffer);
+}
+
+
+void PngDeflate::run(TVG_UNUSED unsigned tid)
+{
+    bw.size = 0;
+    uint8_t header[8] = {};
+    memcpy(header + 4, "IDAT", 4);
+    bw.bytes(header, 8);
+
+    //the zlib header: 32K window, the maximum compression
+    if (begin == 0) {
+        uint8_t zlib[2] = {0x78, 0xda};
+        bw.bytes(zlib, 2);
+    }
+
+    _deflate(bw, ctx->filtered, begin, end, *ctx->effort);
+
+    _putBE32(bw.data, bw.size - 8);
+    uint8_t crc[4];
+    _putBE32(crc, _crc(0, bw.data + 4, bw.size - 4));
+    bw.bytes(crc, 4);
+
+    adler = _adler(ctx->filtered + begin, end - begin);
+}
+
+
+static bool _opaque(const uint32_t* image, size_t size)
+{
+    uint32_t alpha = 0xff000000;
+    for (size_t i = 0; i < size; ++i) alpha &= image[i];
+    return alpha == 0xff000000;
+}
+
+
+/************************************************************************/
+/* External Class Implementation                                        */
+/************************************************************************/
+
+bool pngEncode(const char* filename, const uint32_t* image, uint32_t width, uint32_t height, uint32_t level)
+{
+    if (!image || width == 0 || height == 0 || width > PNG_MAX_SIZE || height > PNG_MAX_SIZE) return false;
+
+    PngContext ctx;
+    ctx.image = image;
+    ctx.width = width;
+    ctx.channels = _opaque(image, size_t(width) * height) ? 3 : 4;
+    ctx.stride = 1 + width * ctx.channels;
+    ctx.rows = (CHUNK_SIZE + ctx.stride - 1) / ctx.stride;
+    ctx.effort = &efforts[(level >= 100) ? 3 : (level * 4 / 100)];
+    ctx.filtered = tvg::malloc<uint8_t*>(size_t(ctx.stride) * height);
+    if (!ctx.filtered) return false;
+
+    //each chunk is deflated after its own and the previous rows filtered, the window reaches into the previous chunk only
+    auto cnt = (height + ctx.rows - 1) / ctx.rows;
+    auto filters = new PngFilter[cnt];
+    auto deflates = new PngDeflate[cnt];
+
+    TaskGroup group;
+    for (uint32_t i = 0; i < cnt; ++i) {
+        auto& filter = filters[i];
+        filter.ctx = &ctx;
+        filter.begin = i * ctx.rows;
+        filter.end = (filter.begin + ctx.rows < height) ? (filter.begin + ctx.rows) : height;
+        group.request(&filter);
+    }
+    for (uint32_t i = 0; i < cnt; ++i) {
+        auto& deflate = deflates[i];
+        deflate.ctx = &ctx;
+        deflate.begin = filters[i].begin * ctx.stride;
+        deflate.end = filters[i].end * ctx.stride;
+        Task* deps[2] = {&filters[i], i > 0 ? &filters[i - 1] : nullptr};
+        group.request(&deflate, deps, i > 0 ? 2 : 1);
+    }
+    group.wait();
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1400)
+    FILE* f = 0;
+    fopen_s(&f, filename, "wb");
+#else
+    auto f = fopen(filename, "wb");
+#endif
+    auto ret = (f != nullptr);
+
+    if (ret) {
+        static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+        uint8_t ihdr[13];
+        _putBE32(ihdr, width);
+        _putBE32(ihdr + 4, height);
+        ihdr[8] = 8;                                // bit depth
+        ihdr[9] = (ctx.channels == 4) ? 6 : 2;      // RGBA or RGB
+        ihdr[10] = ihdr[11] = ihdr[12] = 0;         // deflate, adaptive filtering, no interlace
+        ret = fwrite(signature, 1, 8, f) == 8 && _writeChunk(f, "IHDR", ihdr, sizeof(ihdr));
+
+        uint32_t adler = 1;
+        for (uint32_t i = 0; i < cnt && ret; ++i) {
+            auto& deflate = deflates[i];
+            ret = fwrite(deflate.bw.data, 1, deflate.bw.size, f) == deflate.bw.size;
+            adler = _adlerJoin(adler, deflate.adler, deflate.end - deflate.begin);
+        }
+
+        //the final empty block closes the stream
+        uint8_t tail[6] = {0x03, 0x00};
+        _putBE32(tail + 2, adler);
+        ret = ret && _writeChunk(f, "IDAT", tail, sizeof(tail)) && _writeChunk(f, "IEND", nullptr, 0);
+        if (fclose(f) != 0) ret = false;
+    }
+
+    delete[](deflates);
+    delete[](filters);
+    tvg::free(ctx.filtered);
+
+    return ret;
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _TVG_PNG_ENCODER_H_
+#define _TVG_PNG_ENCODER_H_
+
+#include "tvgCommon.h"
+
+// Encodes the un-premultiplied ABGR pixels into a png file, RGB if they are all opaque, otherwise RGBA.
+// The rows are filtered and deflated in independent chunks on the worker threads (pigz style),
+// the chunks are joined by the sync flushes into a single zlib stream.
+// The level(0 ~ 100) trades the encoding speed for the smaller file, the image is lossless regardless.
+bool pngEncode(const char* filename, const uint32_t* image, uint32_t width, uint32_t height, uint32_t level);
+
+#endif //_TVG_PNG_ENCODER_H_
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "tvgStr.h"
+#include "tvgPngEncoder.h"
+#include "tvgPngSaver.h"
+
+/************************************************************************/
+/* Internal Class Implementation                                        */
+/************************************************************************/
+
+void PngSaver::run(TVG_UNUSED unsigned tid)
+{
+    auto w = static_cast<uint32_t>(vsize[0]);
+    auto h = static_cast<uint32_t>(vsize[1]);
+
+    auto canvas = SwCanvas::gen();
+    if (!canvas) return;
+
+    //straight alpha as png stores it, the bytes are in the r, g, b, a order
+    auto buffer = tvg::malloc<uint32_t*>(sizeof(uint32_t) * w * h);
+    canvas->target(buffer, w, w, h, ColorSpace::ABGR8888S);
+    if (bg) canvas->push(bg);
+    canvas->push(paint);
+
+    auto drawn = canvas->draw(true) == Result::Success && canvas->sync() == Result::Success;
+    delete(canvas);
+
+    if (!drawn || !pngEncode(path, buffer, w, h, quality)) TVGERR("PNG_SAVER", "Failed png encoding");
+
+    tvg::free(buffer);
+}
+
+
+/************************************************************************/
+/* External Class Implementation                                        */
+/************************************************************************/
+
+PngSaver::~PngSaver()
+{
+    close();
+}
+
+
+bool PngSaver::close()
+{
+    this->done();
+
+    if (bg) bg->unref();
+    bg = nullptr;
+
+    if (paint) paint->unref();
+    paint = nullptr;
+
+    tvg::free(path);
+    path = nullptr;
+
+    return true;
+}
+
+
+bool PngSaver::save(Paint* paint, Paint* bg, const char* filename, uint32_t quality)
+{
+    close();
+
+    float x, y;
+    x = y = 0;
+    paint->bounds(&x, &y, &vsize[0], &vsize[1]);
+
+    //cut off the negative space
+    if (x < 0) vsize[0] += x;
+    if (y < 0) vsize[1] += y;
+
+    if (vsize[0] < FLOAT_EPSILON || vsize[1] < FLOAT_EPSILON) {
+        TVGLOG("PNG_SAVER", "Saving paint(%p) has zero view size.", paint);
+        return false;
+    }
+
+    if (!filename) return false;
+    this->path = duplicate(filename);
+
+    paint->ref();
+    this->paint = paint;
+
+    if (bg) {
+        bg->ref();
+        this->bg = bg;
+    }
+    this->quality = quality;
+
+    TaskScheduler::request(this);
+
+    return true;
+}
+
+
+bool PngSaver::save(TVG_UNUSED Animation* animation, TVG_UNUSED Paint* bg, TVG_UNUSED const char* filename, TVG_UNUSED uint32_t quality, TVG_UNUSED uint32_t fps)
+{
+    TVGLOG("PNG_SAVER", "Animation is not supported.");
+    return false;
+}
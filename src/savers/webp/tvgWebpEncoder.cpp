@@ -0,0 +1,882 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstring>
+#include <cstdlib>
+#include "tvgWebpEncoder.h"
+
+/************************************************************************/
+/* Internal Class Implementation                                        */
+/************************************************************************/
+
+#define VP8L_MAX_SIZE (1 << 14)         // 14 bits per dimension
+#define CANVAS_MAX_SIZE (1 << 24)       // 24 bits per dimension
+#define NUM_LITERALS 256
+#define NUM_LENGTHS 24
+#define NUM_DISTANCES 40
+#define NUM_CODE_LENGTHS 19
+#define NUM_PLANE_CODES 120
+#define CACHE_BITS 10
+#define MAX_ALPHABET (NUM_LITERALS + NUM_LENGTHS + (1 << CACHE_BITS))
+#define MAX_CODE_LENGTH 15
+#define MAX_LENGTH 4096
+#define MIN_LENGTH 2                    // shorter copies cost more than their literals
+#define PREDICTOR_BITS 4                // 16x16 tiles
+#define PREDICTOR_MIN_SIZE 256          // too small to pay off the predictor modes
+#define PREDICTOR_FLATNESS 70           // percent of the pixels repeating a neighbor, above which the predictor doesn't pay off
+#define NUM_PREDICTORS 14
+
+#define ANIMATION_FLAG 0x02
+#define ALPHA_FLAG 0x10
+
+static const uint8_t codeLengthOrder[NUM_CODE_LENGTHS] = {17, 18, 0, 1, 2, 3, 4, 5, 16, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+
+// the short distance codes of the 2d neighborhood, (y << 4) | (8 - x)
+static const uint8_t codeToPlane[NUM_PLANE_CODES] = {
+    0x18, 0x07, 0x17, 0x19, 0x28, 0x06, 0x27, 0x29, 0x16, 0x1a,
+    0x26, 0x2a, 0x38, 0x05, 0x37, 0x39, 0x15, 0x1b, 0x36, 0x3a,
+    0x25, 0x2b, 0x48, 0x04, 0x47, 0x49, 0x14, 0x1c, 0x35, 0x3b,
+    0x46, 0x4a, 0x24, 0x2c, 0x58, 0x45, 0x4b, 0x34, 0x3c, 0x03,
+    0x57, 0x59, 0x13, 0x1d, 0x56, 0x5a, 0x23, 0x2d, 0x44, 0x4c,
+    0x55, 0x5b, 0x33, 0x3d, 0x68, 0x02, 0x67, 0x69, 0x12, 0x1e,
+    0x66, 0x6a, 0x22, 0x2e, 0x54, 0x5c, 0x43, 0x4d, 0x65, 0x6b,
+    0x32, 0x3e, 0x78, 0x01, 0x77, 0x79, 0x53, 0x5d, 0x11, 0x1f,
+    0x64, 0x6c, 0x42, 0x4e, 0x76, 0x7a, 0x21, 0x2f, 0x75, 0x7b,
+    0x31, 0x3f, 0x63, 0x6d, 0x52, 0x5e, 0x00, 0x74, 0x7c, 0x41,
+    0x4f, 0x10, 0x20, 0x62, 0x6e, 0x30, 0x73, 0x7d, 0x51, 0x5f,
+    0x40, 0x72, 0x7e, 0x61, 0x6f, 0x50, 0x71, 0x7f, 0x60, 0x70
+};
+
+
+// LSB first bit packing of the VP8L bitstream
+struct BitWriter
+{
+    uint8_t* data;
+    uint32_t size;
+    uint32_t reserved;
+    uint64_t bits = 0;
+    uint32_t used = 0;
+
+    void grow(uint32_t n)
+    {
+        if (size + n <= reserved) return;
+        reserved = (size + n) * 2;
+        data = tvg::realloc<uint8_t*>(data, reserved);
+    }
+
+    // n <= 32
+    void put(uint32_t value, uint32_t n)
+    {
+        bits |= uint64_t(value) << used;
+        used += n;
+        if (used < 32) return;
+        grow(4);
+        data[size++] = bits & 0xff;
+        data[size++] = (bits >> 8) & 0xff;
+        data[size++] = (bits >> 16) & 0xff;
+        data[size++] = (bits >> 24) & 0xff;
+        bits >>= 32;
+        used -= 32;
+    }
+
+    void flush()
+    {
+        while (used > 0) {
+            grow(1);
+            data[size++] = bits & 0xff;
+            bits >>= 8;
+            used = (used > 8) ? (used - 8) : 0;
+        }
+    }
+};
+
+
+struct HuffmanCode
+{
+    uint8_t depths[MAX_ALPHABET];   // code lengths as written out
+    uint8_t bits[MAX_ALPHABET];     // code lengths to emit, nothing for a single symbol
+    uint16_t codes[MAX_ALPHABET];   // bit reversed canonical codes
+    uint32_t count;
+};
+
+
+struct HuffmanLeaf
+{
+    uint32_t weight;
+    uint32_t symbol;
+};
+
+
+enum TokenType : uint8_t {Literal = 0, Cached, Copy};
+
+struct Token
+{
+    uint32_t value;     // argb, cache key or distance code
+    uint16_t length;
+    TokenType type;
+};
+
+
+static int _compareLeaves(const void* a, const void* b)
+{
+    auto l = static_cast<const HuffmanLeaf*>(a);
+    auto r = static_cast<const HuffmanLeaf*>(b);
+    if (l->weight != r->weight) return (l->weight < r->weight) ? -1 : 1;
+    return (l->symbol < r->symbol) ? -1 : 1;
+}
+
+
+static void _buildDepths(const uint32_t* histo, uint32_t count, uint32_t limit, uint8_t* depths)
+{
+    memset(depths, 0, count);
+
+    auto leaves = tvg::malloc<HuffmanLeaf*>(sizeof(HuffmanLeaf) * count);
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (histo[i]) leaves[n++] = {histo[i], i};
+    }
+    if (n <= 1) {
+        if (n == 1) depths[leaves[0].symbol] = 1;
+        tvg::free(leaves);
+        return;
+    }
+    qsort(leaves, n, sizeof(HuffmanLeaf), _compareLeaves);
+
+    auto weights = tvg::malloc<uint32_t*>(sizeof(uint32_t) * (2 * n - 1));
+    auto parents = tvg::malloc<uint32_t*>(sizeof(uint32_t) * (2 * n - 1));
+    auto levels = tvg::malloc<uint32_t*>(sizeof(uint32_t) * (2 * n - 1));
+
+    // the rare symbols are raised until the tree fits in the length limit
+    for (uint32_t floor = 1; ; floor *= 2) {
+        for (uint32_t i = 0; i < n; ++i) {
+            weights[i] = (leaves[i].weight < floor) ? floor : leaves[i].weight;
+        }
+        // two queues, the sorted leaves and the merged nodes in the order they are made
+        uint32_t leaf = 0, node = n;
+        for (uint32_t next = n; next < 2 * n - 1; ++next) {
+            uint32_t pick[2];
+            for (auto& p : pick) {
+                if (leaf < n && (node == next || weights[leaf] <= weights[node])) p = leaf++;
+                else p = node++;
+            }
+            weights[next] = weights[pick[0]] + weights[pick[1]];
+            parents[pick[0]] = parents[pick[1]] = next;
+        }
+        // the parents are made after their children
+        uint32_t maxLevel = 0;
+        levels[2 * n - 2] = 0;
+        for (int32_t i = 2 * n - 3; i >= 0; --i) {
+            levels[i] = levels[parents[i]] + 1;
+            if (levels[i] > maxLevel) maxLevel = levels[i];
+        }
+        if (maxLevel <= limit) break;
+    }
+
+    for (uint32_t i = 0; i < n; ++i) {
+        depths[leaves[i].symbol] = levels[i];
+    }
+
+    tvg::free(leaves);
+    tvg::free(weights);
+    tvg::free(parents);
+    tvg::free(levels);
+}
+
+
+static void _buildCode(HuffmanCode* code, const uint32_t* histo, uint32_t count, uint32_t limit)
+{
+    code->count = count;
+    _buildDepths(histo, count, limit, code->depths);
+
+    uint32_t lengths[MAX_CODE_LENGTH + 1] = {};
+    uint32_t used = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (code->depths[i]) {
+            ++lengths[code->depths[i]];
+            ++used;
+        }
+    }
+
+    uint32_t next[MAX_CODE_LENGTH + 1];
+    uint32_t value = 0;
+    next[0] = 0;
+    for (uint32_t len = 1; len <= MAX_CODE_LENGTH; ++len) {
+        value = (value + lengths[len - 1]) << 1;
+        next[len] = value;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        auto depth = code->depths[i];
+        code->bits[i] = 0;
+        code->codes[i] = 0;
+        // a single symbol takes no bits
+        if (depth == 0 || used == 1) continue;
+        auto canonical = next[depth]++;
+        uint32_t reversed = 0;
+        for (uint32_t k = 0; k < depth; ++k) {
+            reversed = (reversed << 1) | ((canonical >> k) & 1);
+        }
+        code->codes[i] = reversed;
+        code->bits[i] = depth;
+    }
+}
+
+
+// run length coding of the code lengths: 16 repeats the previous non-zero length, 17 and 18 are zero runs
+static uint32_t _tokenizeDepths(const uint8_t* depths, uint32_t count, uint8_t* tokens, uint8_t* extras)
+{
+    uint32_t n = 0;
+    uint8_t prev = 8;
+
+    for (uint32_t i = 0; i < count; ) {
+        auto value = depths[i];
+        uint32_t run = 1;
+        while (i + run < count && depths[i + run] == value) ++run;
+        i += run;
+
+        if (value == 0) {
+            while (run >= 11) {
+                auto repeat = (run > 138) ? 138 : run;
+                tokens[n] = 18;
+                extras[n++] = repeat - 11;
+                run -= repeat;
+            }
+            if (run >= 3) {
+                tokens[n] = 17;
+                extras[n++] = run - 3;
+                run = 0;
+            }
+        } else {
+            if (value != prev) {
+                tokens[n] = value;
+                extras[n++] = 0;
+                prev = value;
+                --run;
+            }
+            while (run >= 3) {
+                auto repeat = (run > 6) ? 6 : run;
+                tokens[n] = 16;
+                extras[n++] = repeat - 3;
+                run -= repeat;
+            }
+        }
+        while (run > 0) {
+            tokens[n] = value;
+            extras[n++] = 0;
+            --run;
+        }
+    }
+    return n;
+}
+
+
+static void _storeCode(BitWriter& bw, const HuffmanCode& code)
+{
+    uint32_t symbols[2] = {0, 0};
+    uint32_t used = 0;
+    for (uint32_t i = 0; i < code.count && used < 3; ++i) {
+        if (code.depths[i]) {
+            if (used < 2) symbols[used] = i;
+            ++used;
+        }
+    }
+
+    // a simple code of one or two 8 bits symbols
+    if (used == 0) {
+        bw.put(0x01, 4);
+        return;
+    }
+    if (used <= 2 && symbols[0] < NUM_LITERALS && symbols[1] < NUM_LITERALS) {
+        bw.put(1, 1);
+        bw.put(used - 1, 1);
+        if (symbols[0] <= 1) {
+            bw.put(0, 1);
+            bw.put(symbols[0], 1);
+        } else {
+            bw.put(1, 1);
+            bw.put(symbols[0], 8);
+        }
+        if (used == 2) bw.put(symbols[1], 8);
+        return;
+    }
+
+    // a normal code, its code lengths are entropy coded as well
+    uint8_t tokens[MAX_ALPHABET];
+    uint8_t extras[MAX_ALPHABET];
+    auto cnt = _tokenizeDepths(code.depths, code.count, tokens, extras);
+
+    uint32_t histo[NUM_CODE_LENGTHS] = {};
+    for (uint32_t i = 0; i < cnt; ++i) ++histo[tokens[i]];
+
+    auto lengths = tvg::malloc<HuffmanCode*>(sizeof(HuffmanCode));
+    _buildCode(lengths, histo, NUM_CODE_LENGTHS, 7);
+
+    auto n = NUM_CODE_LENGTHS;
+    while (n > 4 && lengths->depths[codeLengthOrder[n - 1]] == 0) --n;
+
+    bw.put(0, 1);
+    bw.put(n - 4, 4);
+    for (int i = 0; i < n; ++i) bw.put(lengths->depths[codeLengthOrder[i]], 3);
+    bw.put(0, 1);   // the code lengths of the whole alphabet follow
+
+    for (uint32_t i = 0; i < cnt; ++i) {
+        auto token = tokens[i];
+        bw.put(lengths->codes[token], lengths->bits[token]);
+        if (token == 16) bw.put(extras[i], 2);
+        else if (token == 17) bw.put(extras[i], 3);
+        else if (token == 18) bw.put(extras[i], 7);
+    }
+    tvg::free(lengths);
+}
+
+
+// the lengths and the distances are coded with a prefix and its extra bits
+static void _prefix(uint32_t value, uint32_t& code, uint32_t& extraBits, uint32_t& extra)
+{
+    if (value <= 4) {
+        code = value - 1;
+        extraBits = extra = 0;
+        return;
+    }
+    --value;
+    uint32_t highest = 0;
+    while (value >> (highest + 1)) ++highest;
+    code = 2 * highest + ((value >> (highest - 1)) & 1);
+    extraBits = highest - 1;
+    extra = value & ((1 << extraBits) - 1);
+}
+
+
+static uint32_t _distanceCode(uint32_t dist, uint32_t width, const uint8_t* planeToCode)
+{
+    auto y = dist / width;
+    auto x = dist - y * width;
+    if (x <= 8 && y < 8) return planeToCode[y * 16 + 8 - x] + 1;
+    if (int32_t(x) > int32_t(width) - 8 && y < 7) return planeToCode[(y + 1) * 16 + 8 + width - x] + 1;
+    return dist + NUM_PLANE_CODES;
+}
+
+
+static inline uint32_t _match(const uint32_t* a, const uint32_t* b, uint32_t max)
+{
+    uint32_t len = 0;
+    while (len < max && a[len] == b[len]) ++len;
+    return len;
+}
+
+
+// greedy LZ77 over the left and the upper pixels only, the literals found in the color cache are replaced with their keys.
+// the rendered frames are made of flat runs and repeated rows, the farther matches rarely pay for their distance codes.
+static uint32_t _backwardRefs(const uint32_t* argb, uint32_t width, uint32_t n, uint32_t cacheBits, Token* tokens)
+{
+    uint8_t planeToCode[128];
+    for (uint32_t i = 0; i < NUM_PLANE_CODES; ++i) planeToCode[codeToPlane[i]] = i;
+
+    auto left = _distanceCode(1, width, planeToCode);
+    auto upper = _distanceCode(width, width, planeToCode);
+    auto cache = cacheBits ? tvg::calloc<uint32_t*>(1 << cacheBits, sizeof(uint32_t)) : nullptr;
+    auto shift = 32 - cacheBits;
+    uint32_t cnt = 0;
+
+    for (uint32_t i = 0; i < n; ) {
+        auto max = n - i;
+        if (max > MAX_LENGTH) max = MAX_LENGTH;
+
+        uint32_t best = 0, code = left;
+        if (i >= 1) best = _match(argb + i, argb + i - 1, max);
+        if (i >= width && best < max) {
+            auto len = _match(argb + i, argb + i - width, max);
+            if (len > best) {
+                best = len;
+                code = upper;
+            }
+        }
+
+        if (best >= MIN_LENGTH) {
+            tokens[cnt++] = {code, uint16_t(best), Copy};
+            if (cache) {
+                for (uint32_t k = 0; k < best; ++k, ++i) cache[(argb[i] * 0x1e35a7bdu) >> shift] = argb[i];
+            } else i += best;
+        } else {
+            auto key = cache ? (argb[i] * 0x1e35a7bdu) >> shift : 0;
+            if (cache && cache[key] == argb[i]) tokens[cnt++] = {key, 0, Cached};
+            else {
+                tokens[cnt++] = {argb[i], 0, Literal};
+                if (cache) cache[key] = argb[i];
+            }
+            ++i;
+        }
+    }
+
+    tvg::free(cache);
+
+    return cnt;
+}
+
+
+// an entropy coded image, the main one can have the meta codes but they are not used here
+static void _encodeImage(BitWriter& bw, const uint32_t* argb, uint32_t width, uint32_t height, uint32_t cacheBits, bool main)
+{
+    auto n = width * height;
+    auto tokens = tvg::malloc<Token*>(sizeof(Token) * n);
+    auto cnt = _backwardRefs(argb, width, n, cacheBits, tokens);
+
+    if (cacheBits) {
+        bw.put(1, 1);
+        bw.put(cacheBits, 4);
+    } else bw.put(0, 1);
+    if (main) bw.put(0, 1);
+
+    // green + lengths + cache, red, blue, alpha, distance
+    uint32_t counts[5] = {NUM_LITERALS + NUM_LENGTHS + (cacheBits ? (1u << cacheBits) : 0), NUM_LITERALS, NUM_LITERALS, NUM_LITERALS, NUM_DISTANCES};
+    auto histos = tvg::calloc<uint32_t*>(MAX_ALPHABET * 5, sizeof(uint32_t));
+    uint32_t* histo[5];
+    for (int i = 0; i < 5; ++i) histo[i] = histos + MAX_ALPHABET * i;
+
+    uint32_t code, extraBits, extra;
+    for (uint32_t i = 0; i < cnt; ++i) {
+        auto& token = tokens[i];
+        if (token.type == Literal) {
+            ++histo[0][(token.value >> 8) & 0xff];
+            ++histo[1][(token.value >> 16) & 0xff];
+            ++histo[2][token.value & 0xff];
+            ++histo[3][token.value >> 24];
+        } else if (token.type == Cached) {
+            ++histo[0][NUM_LITERALS + NUM_LENGTHS + token.value];
+        } else {
+            _prefix(token.length, code, extraBits, extra);
+            ++histo[0][NUM_LITERALS + code];
+            _prefix(token.value, code, extraBits, extra);
+            ++histo[4][code];
+        }
+    }
+
+    auto codes = tvg::malloc<HuffmanCode*>(sizeof(HuffmanCode) * 5);
+    for (int i = 0; i < 5; ++i) {
+        _buildCode(codes + i, histo[i], counts[i], MAX_CODE_LENGTH);
+        _storeCode(bw, codes[i]);
+    }
+
+    for (uint32_t i = 0; i < cnt; ++i) {
+        auto& token = tokens[i];
+        if (token.type == Literal) {
+            auto g = (token.value >> 8) & 0xff;
+            auto r = (token.value >> 16) & 0xff;
+            auto b = token.value & 0xff;
+            auto a = token.value >> 24;
+            bw.put(codes[0].codes[g], codes[0].bits[g]);
+            bw.put(codes[1].codes[r], codes[1].bits[r]);
+            bw.put(codes[2].codes[b], codes[2].bits[b]);
+            bw.put(codes[3].codes[a], codes[3].bits[a]);
+        } else if (token.type == Cached) {
+            auto symbol = NUM_LITERALS + NUM_LENGTHS + token.value;
+            bw.put(codes[0].codes[symbol], codes[0].bits[symbol]);
+        } else {
+            _prefix(token.length, code, extraBits, extra);
+            bw.put(codes[0].codes[NUM_LITERALS + code], codes[0].bits[NUM_LITERALS + code]);
+            bw.put(extra, extraBits);
+            _prefix(token.value, code, extraBits, extra);
+            bw.put(codes[4].codes[code], codes[4].bits[code]);
+            bw.put(extra, extraBits);
+        }
+    }
+
+    tvg::free(codes);
+    tvg::free(histos);
+    tvg::free(tokens);
+}
+
+
+/* Predictors, bit exact with the decoder */
+
+static inline uint32_t _average2(uint32_t a, uint32_t b)
+{
+    return (((a ^ b) & 0xfefefefeu) >> 1) + (a & b);
+}
+
+
+static inline uint32_t _clip255(int32_t v)
+{
+    return (v < 0) ? 0 : ((v > 255) ? 255 : v);
+}
+
+
+static uint32_t _clampedAddSubtractFull(uint32_t c0, uint32_t c1, uint32_t c2)
+{
+    uint32_t ret = 0;
+    for (int s = 0; s < 32; s += 8) {
+        ret |= _clip255(int32_t((c0 >> s) & 0xff) + int32_t((c1 >> s) & 0xff) - int32_t((c2 >> s) & 0xff)) << s;
+    }
+    return ret;
+}
+
+
+static uint32_t _clampedAddSubtractHalf(uint32_t c0, uint32_t c1, uint32_t c2)
+{
+    auto avg = _average2(c0, c1);
+    uint32_t ret = 0;
+    for (int s = 0; s < 32; s += 8) {
+        auto a = int32_t((avg >> s) & 0xff);
+        ret |= _clip255(a + (a - int32_t((c2 >> s) & 0xff)) / 2) << s;
+    }
+    return ret;
+}
+
+
+static uint32_t _select(uint32_t t, uint32_t l, uint32_t tl)
+{
+    int32_t diff = 0;
+    for (int s = 0; s < 32; s += 8) {
+        auto c = int32_t((tl >> s) & 0xff);
+        diff += abs(int32_t((l >> s) & 0xff) - c) - abs(int32_t((t >> s) & 0xff) - c);
+    }
+    return (diff <= 0) ? t : l;
+}
+
+
+// top[-1], top[0] and top[1] are the top-left, top and top-right pixels
+static uint32_t _predict(uint32_t mode, uint32_t left, const uint32_t* top)
+{
+    switch (mode) {
+        case 0: return 0xff000000;
+        case 1: return left;
+        case 2: return top[0];
+        case 3: return top[1];
+        case 4: return top[-1];
+        case 5: return _average2(_average2(left, top[1]), top[0]);
+        case 6: return _average2(left, top[-1]);
+        case 7: return _average2(left, top[0]);
+        case 8: return _average2(top[-1], top[0]);
+        case 9: return _average2(top[0], top[1]);
+        case 10: return _average2(_average2(left, top[-1]), _average2(top[0], top[1]));
+        case 11: return _select(top[0], left, top[-1]);
+        case 12: return _clampedAddSubtractFull(left, top[0], top[-1]);
+        default: return _clampedAddSubtractHalf(left, top[0], top[-1]);
+    }
+}
+
+
+static inline uint32_t _subPixels(uint32_t a, uint32_t b)
+{
+    auto ag = 0x00ff00ffu + (a & 0xff00ff00u) - (b & 0xff00ff00u);
+    auto rb = 0xff00ff00u + (a & 0x00ff00ffu) - (b & 0x00ff00ffu);
+    return (ag & 0xff00ff00u) | (rb & 0x00ff00ffu);
+}
+
+
+// the small residuals in either direction are cheap
+static inline uint32_t _residualCost(uint32_t r)
+{
+    uint32_t cost = 0;
+    for (int s = 0; s < 32; s += 8) {
+        auto v = (r >> s) & 0xff;
+        cost += (v < 128) ? v : (256 - v);
+    }
+    return cost;
+}
+
+
+// picks the predictor of the least residuals per tile, the first row and column have their fixed ones
+static void _predictorTransform(const uint32_t* argb, uint32_t width, uint32_t height, uint32_t* modes, uint32_t* residuals)
+{
+    auto size = 1u << PREDICTOR_BITS;
+    auto tilesX = (width + size - 1) >> PREDICTOR_BITS;
+    auto tilesY = (height + size - 1) >> PREDICTOR_BITS;
+
+    for (uint32_t ty = 0; ty < tilesY; ++ty) {
+        auto y0 = ty * size;
+        auto y1 = (y0 + size < height) ? (y0 + size) : height;
+        if (y0 == 0) y0 = 1;
+        for (uint32_t tx = 0; tx < tilesX; ++tx) {
+            auto x0 = tx * size;
+            auto x1 = (x0 + size < width) ? (x0 + size) : width;
+            if (x0 == 0) x0 = 1;
+            uint32_t best = 11, bestCost = UINT32_MAX;
+            for (uint32_t mode = 0; mode < NUM_PREDICTORS; ++mode) {
+                uint32_t cost = 0;
+                for (auto y = y0; y < y1 && cost < bestCost; ++y) {
+                    auto row = argb + y * width;
+                    for (auto x = x0; x < x1; ++x) {
+                        cost += _residualCost(_subPixels(row[x], _predict(mode, row[x - 1], row + x - width)));
+                    }
+                }
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    best = mode;
+                }
+            }
+            modes[ty * tilesX + tx] = 0xff000000 | (best << 8);
+        }
+    }
+
+    residuals[0] = _subPixels(argb[0], 0xff000000);
+    for (uint32_t x = 1; x < width; ++x) residuals[x] = _subPixels(argb[x], argb[x - 1]);
+    for (uint32_t y = 1; y < height; ++y) {
+        auto row = argb + y * width;
+        auto out = residuals + y * width;
+        auto mode = modes + (y >> PREDICTOR_BITS) * tilesX;
+        out[0] = _subPixels(row[0], row[-int32_t(width)]);
+        for (uint32_t x = 1; x < width; ++x) {
+            out[x] = _subPixels(row[x], _predict((mode[x >> PREDICTOR_BITS] >> 8) & 0xf, row[x - 1], row + x - width));
+        }
+    }
+}
+
+
+// a VP8L bitstream of the green subtracted pixels
+static void _encodeBitstream(BitWriter& bw, const uint32_t* argb, uint32_t w, uint32_t h, bool alpha, bool predictor)
+{
+    bw.put(0x2f, 8);
+    bw.put(w - 1, 14);
+    bw.put(h - 1, 14);
+    bw.put(alpha ? 1 : 0, 1);
+    bw.put(0, 3);
+
+    bw.put(1, 1);
+    bw.put(2, 2);       // subtract green
+
+    uint32_t* residuals = nullptr;
+    if (predictor) {
+        auto tilesX = (w + (1 << PREDICTOR_BITS) - 1) >> PREDICTOR_BITS;
+        auto tilesY = (h + (1 << PREDICTOR_BITS) - 1) >> PREDICTOR_BITS;
+        auto modes = tvg::malloc<uint32_t*>(sizeof(uint32_t) * tilesX * tilesY);
+        residuals = tvg::malloc<uint32_t*>(sizeof(uint32_t) * w * h);
+        _predictorTransform(argb, w, h, modes, residuals);
+        bw.put(1, 1);
+        bw.put(0, 2);   // predictor
+        bw.put(PREDICTOR_BITS - 2, 3);
+        _encodeImage(bw, modes, tilesX, tilesY, 0, false);
+        tvg::free(modes);
+    }
+    bw.put(0, 1);
+
+    _encodeImage(bw, residuals ? residuals : argb, w, h, CACHE_BITS, true);
+    bw.flush();
+
+    tvg::free(residuals);
+}
+
+
+// the bounding box of the changed pixels, false if there is none
+static bool _changedArea(const uint32_t* image, const uint32_t* prevImage, uint32_t width, uint32_t height, uint32_t& x0, uint32_t& y0, uint32_t& x1, uint32_t& y1)
+{
+    auto stride = sizeof(uint32_t) * width;
+    y0 = 0;
+    while (y0 < height && !memcmp(image + y0 * width, prevImage + y0 * width, stride)) ++y0;
+    if (y0 == height) return false;
+    y1 = height;
+    while (!memcmp(image + (y1 - 1) * width, prevImage + (y1 - 1) * width, stride)) --y1;
+
+    x0 = width;
+    x1 = 0;
+    for (auto y = y0; y < y1; ++y) {
+        auto a = image + y * width;
+        auto b = prevImage + y * width;
+        uint32_t l = 0, r = width;
+        while (l < x0 && a[l] == b[l]) ++l;
+        while (r > x1 && r > l && a[r - 1] == b[r - 1]) --r;
+        if (l < x0) x0 = l;
+        if (r > x1) x1 = r;
+    }
+    return true;
+}
+
+
+static bool _write(WebpWriter* writer, const void* data, uint32_t size)
+{
+    writer->size += size;
+    return fwrite(data, 1, size, writer->f) == size;
+}
+
+
+static void _put24(uint8_t* p, uint32_t v)
+{
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+    p[2] = (v >> 16) & 0xff;
+}
+
+
+static void _put32(uint8_t* p, uint32_t v)
+{
+    _put24(p, v);
+    p[3] = (v >> 24) & 0xff;
+}
+
+
+static bool _flush(WebpWriter* writer)
+{
+    auto& frame = writer->pending;
+    if (frame.size == 0) return true;
+
+    auto duration = (frame.duration < (1u << 24)) ? frame.duration : ((1u << 24) - 1);
+    auto padding = frame.size & 1;
+
+    uint8_t header[32];
+    memcpy(header, "ANMF", 4);
+    _put32(header + 4, 16 + 8 + frame.size + padding);
+    _put24(header + 8, frame.x / 2);
+    _put24(header + 11, frame.y / 2);
+    _put24(header + 14, frame.w - 1);
+    _put24(header + 17, frame.h - 1);
+    _put24(header + 20, duration);
+    header[23] = 0x02;      // no blending, no disposal: the area is replaced with the frame
+    memcpy(header + 24, "VP8L", 4);
+    _put32(header + 28, frame.size);
+
+    uint8_t zero = 0;
+    auto ret = _write(writer, header, sizeof(header)) && _write(writer, frame.data, frame.size) && (!padding || _write(writer, &zero, 1));
+    frame.size = 0;
+    return ret;
+}
+
+
+/************************************************************************/
+/* External Class Implementation                                        */
+/************************************************************************/
+
+bool webpBegin(WebpWriter* writer, const char* filename, uint32_t width, uint32_t height, bool transparent)
+{
+    if (width == 0 || height == 0 || width > CANVAS_MAX_SIZE || height > CANVAS_MAX_SIZE) return false;
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1400)
+    writer->f = 0;
+    fopen_s(&writer->f, filename, "wb");
+#else
+    writer->f = fopen(filename, "wb");
+#endif
+    if (!writer->f) return false;
+
+    writer->size = 0;
+    writer->pending = {};
+
+    uint8_t header[44] = {};
+    memcpy(header, "RIFF", 4);                  // the size is written at the end
+    memcpy(header + 8, "WEBP", 4);
+    memcpy(header + 12, "VP8X", 4);
+    _put32(header + 16, 10);
+    header[20] = ANIMATION_FLAG | (transparent ? ALPHA_FLAG : 0);
+    _put24(header + 24, width - 1);
+    _put24(header + 27, height - 1);
+    memcpy(header + 30, "ANIM", 4);
+    _put32(header + 34, 6);                     // transparent background, loop forever
+
+    return _write(writer, header, sizeof(header));
+}
+
+
+bool webpEncodeFrame(WebpFrame* frame, const uint32_t* image, const uint32_t* prevImage, uint32_t width, uint32_t height, uint32_t quality)
+{
+    frame->size = 0;
+
+    uint32_t x0 = 0, y0 = 0, x1 = width, y1 = height;
+    if (prevImage) {
+        if (!_changedArea(image, prevImage, width, height, x0, y0, x1, y1)) return true;
+        // the frame offsets are stored in halves
+        x0 &= ~1u;
+        y0 &= ~1u;
+    }
+    auto w = x1 - x0;
+    auto h = y1 - y0;
+    if (w > VP8L_MAX_SIZE || h > VP8L_MAX_SIZE) return false;
+
+    // near lossless: the lower quality rounds off more of the channel bits, which lengthens the runs
+    auto bits = (quality < 100) ? 1 + (100 - quality) / 25 : 0;
+    auto half = bits ? 1u << (bits - 1) : 0;
+    auto quantize = [&](uint32_t v) -> uint32_t {
+        v = ((v + half) >> bits) << bits;
+        return v > 255 ? 255 : v;
+    };
+
+    auto argb = tvg::malloc<uint32_t*>(sizeof(uint32_t) * w * h);
+    auto alpha = false;
+    for (uint32_t y = 0; y < h; ++y) {
+        auto src = image + (y0 + y) * width + x0;
+        auto dst = argb + y * w;
+        for (uint32_t x = 0; x < w; ++x) {
+            auto p = src[x];
+            if ((p >> 24) != 0xff) alpha = true;
+            if (bits) p = (quantize(p >> 24) << 24) | (quantize((p >> 16) & 0xff) << 16) | (quantize((p >> 8) & 0xff) << 8) | quantize(p & 0xff);
+            // subtract green
+            auto g = (p >> 8) & 0xff;
+            dst[x] = (p & 0xff00ff00) | ((((p >> 16) - g) & 0xff) << 16) | ((p - g) & 0xff);
+        }
+    }
+
+    /* The predictor suits the gradients and the images, while the flat colors of the vector graphics
+       are repeated better as they are. The share of the pixels repeating their neighbors tells them apart. */
+    auto predictor = false;
+    if (w * h >= PREDICTOR_MIN_SIZE && w > 1 && h > 1) {
+        uint32_t flat = 0;
+        for (uint32_t i = 1; i < w * h; ++i) {
+            if (argb[i] == argb[i - 1] || (i >= w && argb[i] == argb[i - w])) ++flat;
+        }
+        predictor = (flat * 100 < PREDICTOR_FLATNESS * (w * h));
+    }
+
+    BitWriter bw{frame->data, 0, frame->reserved};
+    _encodeBitstream(bw, argb, w, h, alpha, predictor);
+    tvg::free(argb);
+
+    frame->data = bw.data;
+    frame->size = bw.size;
+    frame->reserved = bw.reserved;
+    frame->x = x0;
+    frame->y = y0;
+    frame->w = w;
+    frame->h = h;
+
+    return true;
+}
+
+
+bool webpWriteFrame(WebpWriter* writer, WebpFrame* frame, uint32_t duration)
+{
+    if (frame->size == 0) {
+        writer->pending.duration += duration;
+        return true;
+    }
+    auto ret = _flush(writer);
+    auto tmp = writer->pending;
+    writer->pending = *frame;
+    writer->pending.duration = duration;
+    *frame = tmp;
+    return ret;
+}
+
+
+bool webpEnd(WebpWriter* writer)
+{
+    auto ret = _flush(writer);
+
+    uint8_t size[4];
+    _put32(size, writer->size - 8);
+    ret = ret && !fseek(writer->f, 4, SEEK_SET) && fwrite(size, 1, 4, writer->f) == 4;
+    if (fclose(writer->f)) ret = false;
+    writer->f = nullptr;
+
+    tvg::free(writer->pending.data);
+    writer->pending = {};
+
+    return ret;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef _TVG_WEBP_ENCODER_H_
+#define _TVG_WEBP_ENCODER_H_
+
+#include "tvgCommon.h"
+
+// An encoded frame of the animation, a lossless(VP8L) image of the pixels changed from the previous frame.
+struct WebpFrame
+{
+    uint8_t* data = nullptr;    // VP8L bitstream
+    uint32_t size = 0;          // zero if nothing has changed
+    uint32_t reserved = 0;
+    uint32_t x, y, w, h;        // the area on the canvas, x and y are even
+    uint32_t duration;          // in milliseconds
+};
+
+
+struct WebpWriter
+{
+    FILE* f;
+    WebpFrame pending;          // the last frame is held back, the unchanged frames after it just prolong it
+    uint32_t size;              // written bytes
+};
+
+
+// Creates a webp animation file of the given canvas size, looping forever.
+bool webpBegin(WebpWriter* writer, const char* filename, uint32_t width, uint32_t height, bool transparent);
+
+// Encodes a frame of the un-premultiplied ARGB pixels against the previous source image (null for the first one).
+// The frames don't depend on each other's encoding, so they can be encoded concurrently.
+// The quality 100 is lossless, the lower ones round off the channel values for the smaller file (near lossless).
+bool webpEncodeFrame(WebpFrame* frame, const uint32_t* image, const uint32_t* prevImage, uint32_t width, uint32_t height, uint32_t quality);
+
+// Appends an encoded frame, they must be written in order.
+// The frame buffer is swapped with the pending one, it's ready to encode the next frame into.
+bool webpWriteFrame(WebpWriter* writer, WebpFrame* frame, uint32_t duration);
+
+// Flushes the last frame, completes the file header and closes the file.
+bool webpEnd(WebpWriter* writer);
+
+#endif //_TVG_WEBP_ENCODER_H_
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstring>
+#include <memory>
+#include "tvgStr.h"
+#include "tvgWebpEncoder.h"
+#include "tvgWebpSaver.h"
+
+/************************************************************************/
+/* Internal Class Implementation                                        */
+/************************************************************************/
+
+//a frame in flight, the frames are encoded independently and written out in order
+struct WebpSlot : Task
+{
+    uint32_t* image = nullptr;          //rendered frame
+    const uint32_t* prev = nullptr;     //the previous rendered frame
+    WebpFrame frame;
+    uint32_t w, h, quality, duration;
+    bool encoded;
+
+    void run(TVG_UNUSED unsigned tid) override
+    {
+        encoded = webpEncodeFrame(&frame, image, prev, w, h, quality);
+    }
+
+    ~WebpSlot()
+    {
+        done();
+        tvg::free(image);
+        tvg::free(frame.data);
+    }
+};
+
+
+void WebpSaver::run(TVG_UNUSED unsigned tid)
+{
+    auto w = static_cast<uint32_t>(vsize[0]);
+    auto h = static_cast<uint32_t>(vsize[1]);
+
+    FramePipeline pipeline(animation, bg, w, h, ColorSpace::ARGB8888S);
+    if (!pipeline.valid()) return;
+
+    //the canvas holds the background now
+    auto transparent = bg ? false : true;
+    if (bg) bg->unref();
+    bg = nullptr;
+
+    //use the default fps
+    if (fps > 60.0f) fps = 60.0f;   // just in case
+    else if (tvg::zero(fps) || fps < 0.0f) {
+        fps = (animation->totalFrame() / animation->duration());
+    }
+
+    auto delay = (1.0f / fps);
+    auto duration = animation->duration();
+
+    //the frame times are rounded in milliseconds without accumulating the errors
+    auto timestamp = [&](uint32_t idx) { return uint32_t(float(idx) * delay * 1000.0f + 0.5f); };
+
+    WebpWriter writer;
+    if (!webpBegin(&writer, path, w, h, transparent)) {
+        TVGERR("WEBP_SAVER", "Failed webp encoding");
+        return;
+    }
+
+    auto ret = true;
+
+    /* Render the next frames while the previous ones are encoded on the other workers.
+       This worker blocks on the encoding tasks, so one more is necessary to run them. */
+    if (TaskScheduler::threads() > 1) {
+        auto cnt = TaskScheduler::threads() + 1;
+        auto slots = new WebpSlot[cnt];
+        for (uint32_t i = 0; i < cnt; ++i) {
+            auto& slot = slots[i];
+            slot.image = tvg::malloc<uint32_t*>(sizeof(uint32_t) * w * h);
+            slot.w = w;
+            slot.h = h;
+            slot.quality = quality;
+        }
+
+        uint32_t idx = 0;
+
+        for (auto p = 0.0f; p < duration; p += delay, ++idx) {
+            auto next = (p + delay < duration) ? animation->totalFrame() * ((p + delay) / duration) : -1.0f;
+            auto buffer = pipeline.draw(animation->totalFrame() * (p / duration), next);
+
+            //the oldest frame in flight is written out for this one
+            auto& slot = slots[idx % cnt];
+            if (idx >= cnt) {
+                slot.done();
+                ret = ret && slot.encoded && webpWriteFrame(&writer, &slot.frame, slot.duration);
+            }
+            //the next slot frame refers to this slot source as its previous one
+            slots[(idx + 1) % cnt].done();
+            memcpy(slot.image, buffer, sizeof(uint32_t) * w * h);
+
+            slot.prev = idx ? slots[(idx - 1) % cnt].image : nullptr;
+            slot.duration = timestamp(idx + 1) - timestamp(idx);
+            TaskScheduler::request(&slot);
+        }
+
+        for (auto i = (idx > cnt) ? (idx - cnt) : 0; i < idx; ++i) {
+            auto& slot = slots[i % cnt];
+            slot.done();
+            ret = ret && slot.encoded && webpWriteFrame(&writer, &slot.frame, slot.duration);
+        }
+        delete[](slots);
+    } else {
+        auto prev = tvg::malloc<uint32_t*>(sizeof(uint32_t) * w * h);
+        WebpFrame frame;
+        uint32_t idx = 0;
+
+        for (auto p = 0.0f; p < duration && ret; p += delay, ++idx) {
+            auto buffer = pipeline.draw(animation->totalFrame() * (p / duration));
+            ret = webpEncodeFrame(&frame, buffer, idx ? prev : nullptr, w, h, quality) && webpWriteFrame(&writer, &frame, timestamp(idx + 1) - timestamp(idx));
+            memcpy(prev, buffer, sizeof(uint32_t) * w * h);
+        }
+        tvg::free(frame.data);
+        tvg::free(prev);
+    }
+
+    if (!webpEnd(&writer) || !ret) TVGERR("WEBP_SAVER", "Failed webp encoding");
+}
+
+
+/************************************************************************/
+/* External Class Implementation                                        */
+/************************************************************************/
+
+WebpSaver::~WebpSaver()
+{
+    close();
+}
+
+
+bool WebpSaver::close()
+{
+    this->done();
+
+    if (bg) bg->unref();
+    bg = nullptr;
+
+    //animation holds the picture, it must be 1 at the bottom.
+    if (animation && animation->picture()->refCnt() <= 1) delete(animation);
+    animation = nullptr;
+
+    tvg::free(path);
+    path = nullptr;
+
+    return true;
+}
+
+
+bool WebpSaver::save(TVG_UNUSED Paint* paint, TVG_UNUSED Paint* bg, TVG_UNUSED const char* filename, TVG_UNUSED uint32_t quality)
+{
+    TVGLOG("WEBP_SAVER", "Paint is not supported.");
+    return false;
+}
+
+
+bool WebpSaver::save(Animation* animation, Paint* bg, const char* filename, uint32_t quality, uint32_t fps)
+{
+    close();
+
+    auto picture = animation->picture();
+    float x, y;
+    x = y = 0;
+    picture->bounds(&x, &y, &vsize[0], &vsize[1]);
+
+    //cut off the negative space
+    if (x < 0) vsize[0] += x;
+    if (y < 0) vsize[1] += y;
+
+    if (vsize[0] < FLOAT_EPSILON || vsize[1] < FLOAT_EPSILON) {
+        TVGLOG("WEBP_SAVER", "Saving animation(%p) has zero view size.", animation);
+        return false;
+    }
+
+    if (!filename) return false;
+    this->path = duplicate(filename);
+
+    this->animation = animation;
+
+    if (bg) {
+        bg->ref();
+        this->bg = bg;
+    }
+    this->fps = static_cast<float>(fps);
+    this->quality = quality;
+
+    TaskScheduler::request(this);
+
+    return true;
+}
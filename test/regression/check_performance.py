@@ -0,0 +1,51 @@
+import os
+import subprocess
+import sys
+import tomllib
+
+if len(sys.argv) != 2 or not os.path.isfile(sys.argv[1]):
+    print('Proper usage "python check_performance.py settings_performance.toml"')
+    raise ValueError("POSSIBLE_PROBLEM - Missing or invalid settings file")
+
+with open(sys.argv[1], "rb") as file:
+    settings = tomllib.load(file)["general"]
+
+folder = settings["folder_with_files_to_check"]
+scenebench = settings["scenebench_path"]
+baseline = settings["baseline"]
+report = settings["report"]
+
+
+def measure(tool: str, output: str, extra: list) -> int:
+    args = [
+        tool,
+        folder,
+        "-r", settings["resolutions"],
+        "-t", settings["threads"],
+        "-n", str(settings["frames"]),
+        "-c", str(settings["cold_repeats"]),
+        "-o", output,
+    ] + extra
+    return subprocess.call(args)
+
+
+# The baseline build is measured on the same machine, the stored reports from the other machines are hardly comparable
+if not baseline.endswith(".json"):
+    if measure(baseline, "baseline.json", []) != 0:
+        raise ValueError("POSSIBLE_PROBLEM - Measuring the baseline failed")
+    baseline = "baseline.json"
+
+ret = measure(scenebench, report, ["-b", baseline, "-x", str(settings["tolerance"])])
+
+if ret == 2:
+    print(
+        f"POSSIBLE_PROBLEM - Found performance regressions beyond {settings['tolerance']}% to the baseline",
+        file=sys.stderr,
+    )
+elif ret != 0:
+    print(
+        f"POSSIBLE_PROBLEM - Measuring the performance failed with status {ret}",
+        file=sys.stderr,
+    )
+else:
+    print("Not found performance regressions")
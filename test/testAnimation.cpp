@@ -325,4 +325,94 @@ TEST_CASE("Animation Segment", "[tvgAnimation]")
     REQUIRE(Initializer::term() == Result::Success);
 }
 
+
+TEST_CASE("Animation Bake", "[tvgAnimation]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas);
+
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        auto animation = Animation::gen();
+        REQUIRE(animation);
+
+        auto picture = animation->picture();
+
+        //Negative cases
+        REQUIRE(animation->bake(100, 100) == Result::InsufficientCondition);
+
+        REQUIRE(picture->load(TEST_DIR"/test.json") == Result::Success);
+        REQUIRE(picture->size(100, 100) == Result::Success);
+        REQUIRE(animation->bake(0, 100) == Result::InvalidArguments);
+
+        REQUIRE(animation->bake(100, 100) == Result::Success);
+        REQUIRE(canvas->push(picture) == Result::Success);
+
+        for (float i = 7.5f; i < animation->totalFrame(); i += 7.5f) {
+            REQUIRE(animation->frame(i) == Result::Success);
+            REQUIRE(animation->curFrame() == i);
+            REQUIRE(canvas->update() == Result::Success);
+            REQUIRE(canvas->draw() == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+        }
+
+        //Seek backward
+        REQUIRE(animation->frame(3.0f) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+
+        //Release the baked frames, the vector continues from the current frame
+        REQUIRE(animation->bake(0, 0) == Result::Success);
+        REQUIRE(animation->curFrame() == 3.0f);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+
+        //Changing the segment releases them as well
+        REQUIRE(animation->bake(50, 50) == Result::Success);
+        REQUIRE(animation->segment(0.0f, 10.0f) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+
+        delete(animation);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Animation Bake Pixels", "[tvgAnimation]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        uint32_t buffer[2][64*64];
+        unique_ptr<Animation> animation[2];
+
+        for (int i = 0; i < 2; ++i) {
+            animation[i] = unique_ptr<Animation>(Animation::gen());
+            REQUIRE(animation[i]->picture()->load(TEST_DIR"/test.json") == Result::Success);
+            REQUIRE(animation[i]->picture()->size(64, 64) == Result::Success);
+        }
+        REQUIRE(animation[1]->bake(64, 64) == Result::Success);
+
+        //The baked frames are identical to the drawn ones
+        for (auto no : {17.0f, 40.0f, 2.0f, 33.0f, 34.0f}) {
+            for (int i = 0; i < 2; ++i) {
+                auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+                REQUIRE(canvas->target(buffer[i], 64, 64, 64, ColorSpace::ARGB8888) == Result::Success);
+                animation[i]->frame(no);
+                REQUIRE(canvas->push(animation[i]->picture()) == Result::Success);
+                REQUIRE(canvas->draw(true) == Result::Success);
+                REQUIRE(canvas->sync() == Result::Success);
+                REQUIRE(canvas->remove(animation[i]->picture()) == Result::Success);
+            }
+            REQUIRE(memcmp(buffer[0], buffer[1], sizeof(buffer[0])) == 0);
+        }
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
 #endif
\ No newline at end of file
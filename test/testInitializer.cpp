@@ -23,9 +23,20 @@
 #include <thorvg.h>
 #include "config.h"
 #include "catch.hpp"
+#include <cstdio>
 #include <cstring>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
 
 using namespace tvg;
+using namespace std;
 
 
 TEST_CASE("Basic initialization", "[tvgInitializer]")
@@ -55,6 +66,272 @@ TEST_CASE("Version", "[tvgInitializer]")
     REQUIRE(strcmp(curVersion, THORVG_VERSION_STRING) == 0);
 }
 
+static uint32_t allocCnt = 0;
+
+static void* _alloc(size_t size, void* data)
+{
+    ++(*static_cast<uint32_t*>(data));
+    return malloc(size);
+}
+
+static void* _realloc(void* ptr, size_t size, void*)
+{
+    return realloc(ptr, size);
+}
+
+static void _free(void* ptr, void*)
+{
+    free(ptr);
+}
+
+TEST_CASE("Custom allocator", "[tvgInitializer]")
+{
+    Allocator allocator = {_alloc, _realloc, _free, &allocCnt};
+    Allocator invalid = {_alloc, nullptr, _free, nullptr};
+
+    REQUIRE(Initializer::init(0, &invalid) == Result::InvalidArguments);
+    REQUIRE(Initializer::init(0, &allocator) == Result::Success);
+
+    //Negative, another allocator is in use
+    REQUIRE(Initializer::init(0, nullptr) == Result::InsufficientCondition);
+    REQUIRE(Initializer::init(0, &allocator) == Result::Success);
+    REQUIRE(Initializer::term() == Result::Success);
+
+    auto shape = Shape::gen();
+    REQUIRE(shape->appendRect(0, 0, 100, 100) == Result::Success);
+    delete(shape);
+    REQUIRE(allocCnt > 0);
+
+    size_t bytes;
+    REQUIRE(Initializer::memory(MemoryCategory::Common, nullptr) == Result::InvalidArguments);
+#ifdef THORVG_MEMORY_STATS_SUPPORT
+    REQUIRE(Initializer::memory(MemoryCategory::Common, &bytes) == Result::Success);
+#else
+    REQUIRE(Initializer::memory(MemoryCategory::Common, &bytes) == Result::NonSupport);
+#endif
+
+    REQUIRE(Initializer::term() == Result::Success);
+
+    //Restore the system allocator
+    REQUIRE(Initializer::init(0, nullptr) == Result::Success);
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Thread options", "[tvgInitializer]")
+{
+    uint32_t cores[] = {0, 1};
+    ThreadOptions options;
+    options.cores = cores;
+    options.coreCnt = 2;
+    options.priority = -1;
+    options.spin = 50;
+
+    REQUIRE(Initializer::init(3, options) == Result::Success);
+    {
+        //the workers spinning and sleeping in turn between the draws
+        uint32_t buffer[100*100];
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+        for (int i = 0; i < 20; ++i) {
+            auto shape = Shape::gen();
+            shape->appendCircle(float(i * 5), 50, 20, 20);
+            shape->fill(255, 0, 0, 128);
+            REQUIRE(canvas->push(shape) == Result::Success);
+        }
+        for (int i = 0; i < 5; ++i) {
+            REQUIRE(canvas->update() == Result::Success);
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+            if (i == 2) this_thread::sleep_for(chrono::milliseconds(1));
+        }
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+//a minimal host job system
+struct HostJobs
+{
+    vector<thread> threads;
+    deque<pair<void(*)(void*), void*>> jobs;
+    mutex mtx;
+    condition_variable cv;
+    atomic<uint32_t> submitted{0};
+    bool done = false;
+
+    HostJobs(uint32_t cnt)
+    {
+        for (uint32_t i = 0; i < cnt; ++i) {
+            threads.emplace_back([this] {
+                while (true) {
+                    unique_lock<mutex> lock{mtx};
+                    cv.wait(lock, [this] { return done || !jobs.empty(); });
+                    if (jobs.empty()) return;
+                    auto job = jobs.front();
+                    jobs.pop_front();
+                    lock.unlock();
+                    job.first(job.second);
+                }
+            });
+        }
+    }
+
+    ~HostJobs()
+    {
+        {
+            lock_guard<mutex> lock{mtx};
+            done = true;
+        }
+        cv.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    static void submit(void (*job)(void*), void* arg, void* data)
+    {
+        auto host = static_cast<HostJobs*>(data);
+        ++host->submitted;
+        {
+            lock_guard<mutex> lock{host->mtx};
+            host->jobs.emplace_back(job, arg);
+        }
+        host->cv.notify_one();
+    }
+};
+
+static void _draw(uint32_t* buffer)
+{
+    auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+    REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+    for (int i = 0; i < 20; ++i) {
+        auto shape = Shape::gen();
+        shape->appendCircle(float(i * 5), 50, 20, 20);
+        shape->fill(255, i * 10, 0, 128);
+        REQUIRE(canvas->push(shape) == Result::Success);
+    }
+    auto picture = Picture::gen();
+    REQUIRE(picture->load(TEST_DIR"/tag.svg") == Result::Success);
+    REQUIRE(picture->size(100, 100) == Result::Success);
+    REQUIRE(canvas->push(picture) == Result::Success);
+    REQUIRE(canvas->draw(true) == Result::Success);
+    REQUIRE(canvas->sync() == Result::Success);
+}
+
+TEST_CASE("Host executor", "[tvgInitializer]")
+{
+    uint32_t expected[100*100];
+    uint32_t buffer[100*100];
+
+    REQUIRE(Initializer::init(0) == Result::Success);
+    _draw(expected);
+    REQUIRE(Initializer::term() == Result::Success);
+
+    HostJobs host(3);
+    Executor executor = {HostJobs::submit, 4, &host};
+    Executor invalid = {nullptr, 4, &host};
+
+    REQUIRE(Initializer::init(invalid) == Result::InvalidArguments);
+    REQUIRE(Initializer::init(executor) == Result::Success);
+    for (int i = 0; i < 3; ++i) {
+        _draw(buffer);
+        REQUIRE(memcmp(buffer, expected, sizeof(buffer)) == 0);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+
+#ifdef THORVG_THREAD_SUPPORT
+    REQUIRE(host.submitted > 0);
+#endif
+}
+
+TEST_CASE("Memory trimming", "[tvgInitializer]")
+{
+    REQUIRE(Initializer::trim(TrimLevel::Pools) == Result::InsufficientCondition);
+
+    REQUIRE(Initializer::init(0) == Result::Success);
+    REQUIRE(Initializer::cache(1024 * 1024) == Result::Success);
+    {
+        uint32_t expected[100*100];
+        uint32_t buffer[100*100];
+
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        auto shape = Shape::gen();
+        REQUIRE(shape->appendRect(10, 10, 80, 80) == Result::Success);
+        REQUIRE(shape->fill(255, 0, 0) == Result::Success);
+        REQUIRE(shape->strokeWidth(0.8f) == Result::Success);
+        REQUIRE(shape->strokeFill(0, 0, 255) == Result::Success);
+
+        auto mask = Shape::gen();
+        REQUIRE(mask->appendCircle(50, 50, 30, 30) == Result::Success);
+        REQUIRE(mask->fill(255, 255, 255) == Result::Success);
+        REQUIRE(shape->mask(mask, MaskMethod::Alpha) == Result::Success);
+        REQUIRE(canvas->push(shape) == Result::Success);
+
+        auto picture = Picture::gen();
+        REQUIRE(picture->load(TEST_DIR"/test.png") == Result::Success);
+        REQUIRE(picture->size(50, 50) == Result::Success);
+        REQUIRE(canvas->push(picture) == Result::Success);
+
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        memcpy(expected, buffer, sizeof(buffer));
+
+        //the released memory is allocated again on demand
+        for (auto level : {TrimLevel::Pools, TrimLevel::Caches}) {
+            REQUIRE(Initializer::trim(level) == Result::Success);
+            REQUIRE(shape->translate(0, 0) == Result::Success);
+            REQUIRE(canvas->update() == Result::Success);
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+            REQUIRE(memcmp(buffer, expected, sizeof(buffer)) == 0);
+        }
+
+        //the retained image is decoded again
+        REQUIRE(canvas->remove(picture) == Result::Success);
+        REQUIRE(Initializer::trim(TrimLevel::Caches) == Result::Success);
+        picture = Picture::gen();
+        REQUIRE(picture->load(TEST_DIR"/test.png") == Result::Success);
+        REQUIRE(picture->size(50, 50) == Result::Success);
+        REQUIRE(canvas->push(picture) == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(memcmp(buffer, expected, sizeof(buffer)) == 0);
+    }
+    REQUIRE(Initializer::cache(0) == Result::Success);
+
+#ifdef THORVG_SVG_LOADER_SUPPORT
+    //the retained document is parsed again, the cache would keep the previous content of the file
+    REQUIRE(Picture::cache(1024 * 1024) == Result::Success);
+    {
+        auto save = [](const char* svg) {
+            auto file = fopen(TEST_DIR"/trim.svg", "w");
+            REQUIRE(file);
+            fputs(svg, file);
+            fclose(file);
+        };
+        auto size = []() {
+            auto picture = unique_ptr<Picture>(Picture::gen());
+            REQUIRE(picture->load(TEST_DIR"/trim.svg") == Result::Success);
+            float w, h;
+            REQUIRE(picture->size(&w, &h) == Result::Success);
+            return w;
+        };
+
+        save("<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"100\" height=\"100\"><rect width=\"10\" height=\"10\"/></svg>");
+        REQUIRE(size() == 100.0f);
+
+        save("<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"200\" height=\"200\"><rect width=\"10\" height=\"10\"/></svg>");
+        REQUIRE(size() == 100.0f);
+
+        REQUIRE(Initializer::trim(TrimLevel::Caches) == Result::Success);
+        REQUIRE(size() == 200.0f);
+
+        remove(TEST_DIR"/trim.svg");
+    }
+    REQUIRE(Picture::cache(0) == Result::Success);
+#endif
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
 TEST_CASE("Negative termination", "[tvgInitializer]")
 {
     REQUIRE(Initializer::term() == Result::InsufficientCondition);
@@ -27,6 +27,8 @@
 #endif
 #include <fstream>
 #include <cstring>
+#include <vector>
+#include <array>
 #include "catch.hpp"
 
 using namespace tvg;
@@ -96,6 +98,122 @@ TEST_CASE("Lottie Slot 2", "[tvgLottie]")
     REQUIRE(Initializer::term() == Result::Success);
 }
 
+TEST_CASE("Lottie Slot Transform", "[tvgLottie]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        auto animation = LottieAnimation::gen();
+        REQUIRE(animation->picture()->load(TEST_DIR"/lottieslottransform.json") == Result::Success);
+        REQUIRE(canvas->push(animation->picture()) == Result::Success);
+        REQUIRE(animation->frame(1) == Result::Success);
+
+        auto draw = [&]() {
+            REQUIRE(canvas->update() == Result::Success);
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+        };
+
+        //the layer and its child layer at (20, 20) and (50, 20)
+        draw();
+        REQUIRE(buffer[20 * 100 + 20] == 0xffff0000);
+        REQUIRE(buffer[20 * 100 + 50] == 0xff0000ff);
+
+        //the overridden position applies to the current frame
+        REQUIRE(animation->override(R"({"pos":{"p":{"a":0,"k":[50,50]}}})") == Result::Success);
+        draw();
+        REQUIRE(buffer[20 * 100 + 20] == 0);
+        REQUIRE(buffer[20 * 100 + 50] == 0);
+        REQUIRE(buffer[50 * 100 + 50] == 0xffff0000);
+        REQUIRE(buffer[50 * 100 + 80] == 0xff0000ff);
+
+        //revert
+        REQUIRE(animation->override(nullptr) == Result::Success);
+        draw();
+        REQUIRE(buffer[20 * 100 + 20] == 0xffff0000);
+        REQUIRE(buffer[50 * 100 + 50] == 0);
+
+        //the unknown slots are skipped
+        REQUIRE(animation->override(R"({"none":{"p":{"a":0,"k":[0,1,0,1]}},"col":{"p":{"a":0,"k":[0,1,0,1]}}})") == Result::Success);
+        draw();
+        REQUIRE(buffer[20 * 100 + 20] == 0xff00ff00);
+        REQUIRE(buffer[20 * 100 + 50] == 0xff0000ff);
+
+        REQUIRE(canvas->remove() == Result::Success);
+        delete(animation);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Lottie Slot Values", "[tvgLottie]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        auto animation = LottieAnimation::gen();
+
+        //not loaded
+        REQUIRE(animation->override("pos", 50.0f, 50.0f) == Result::InsufficientCondition);
+
+        REQUIRE(animation->picture()->load(TEST_DIR"/lottieslottransform.json") == Result::Success);
+        REQUIRE(canvas->push(animation->picture()) == Result::Success);
+        REQUIRE(animation->frame(1) == Result::Success);
+
+        auto draw = [&]() {
+            REQUIRE(canvas->update() == Result::Success);
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+        };
+
+        //Negative
+        REQUIRE(animation->override(nullptr, 1.0f) == Result::InvalidArguments);
+        REQUIRE(animation->override("col", nullptr) == Result::InvalidArguments);
+        REQUIRE(animation->override("none", 1.0f) == Result::NonSupport);
+        REQUIRE(animation->override("col", 1.0f) == Result::NonSupport);
+        REQUIRE(animation->override("pos", 0, 255, 0) == Result::NonSupport);
+        REQUIRE(animation->override("col", "text") == Result::NonSupport);
+
+        //position and color
+        REQUIRE(animation->override("pos", 50.0f, 50.0f) == Result::Success);
+        REQUIRE(animation->override("col", 0, 255, 0) == Result::Success);
+        draw();
+        REQUIRE(buffer[20 * 100 + 20] == 0);
+        REQUIRE(buffer[50 * 100 + 50] == 0xff00ff00);
+        REQUIRE(buffer[50 * 100 + 80] == 0xff0000ff);
+
+        //scale and opacity
+        REQUIRE(animation->override("size", 200.0f, 200.0f) == Result::Success);
+        REQUIRE(animation->override("alpha", 0.0f) == Result::Success);
+        draw();
+        REQUIRE(buffer[42 * 100 + 42] == 0xff00ff00);
+        REQUIRE(buffer[50 * 100 + 80] == 0);
+
+        //the same as the json slot data
+        REQUIRE(animation->override(R"({"pos":{"p":{"a":0,"k":[20,20]}},"col":{"p":{"a":0,"k":[0,1,0,1]}}})") == Result::Success);
+        REQUIRE(animation->override("alpha", 100.0f) == Result::Success);
+        draw();
+        REQUIRE(buffer[12 * 100 + 12] == 0xff00ff00);
+        REQUIRE(buffer[20 * 100 + 80] == 0xff0000ff);
+
+        //revert
+        REQUIRE(animation->override(nullptr) == Result::Success);
+        draw();
+        REQUIRE(buffer[20 * 100 + 20] == 0xffff0000);
+        REQUIRE(buffer[12 * 100 + 12] == 0);
+        REQUIRE(buffer[20 * 100 + 50] == 0xff0000ff);
+
+        REQUIRE(canvas->remove() == Result::Success);
+        delete(animation);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
 TEST_CASE("Lottie Marker", "[tvgLottie]")
 {
     REQUIRE(Initializer::init(0) == Result::Success);
@@ -129,4 +247,506 @@ TEST_CASE("Lottie Marker", "[tvgLottie]")
     REQUIRE(Initializer::term() == Result::Success);
 }
 
-#endif
\ No newline at end of file
+TEST_CASE("Lottie Frame Cache", "[tvgLottie]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+
+    auto animation = unique_ptr<LottieAnimation>(LottieAnimation::gen());
+    REQUIRE(animation);
+
+    auto picture = animation->picture();
+
+    //Set cache before loaded
+    REQUIRE(animation->cache(1024 * 1024) == Result::InsufficientCondition);
+
+    //Animation load
+    REQUIRE(picture->load(TEST_DIR"/test.json") == Result::Success);
+
+    REQUIRE(animation->cache(1024 * 1024) == Result::Success);
+
+    //Build and replay the frames
+    for (int i = 0; i < 2; ++i) {
+        REQUIRE(animation->frame(animation->totalFrame() * 0.5f) == Result::Success);
+        REQUIRE(animation->frame(0.0f) == Result::Success);
+    }
+
+    //Tweening frames are not retained
+    REQUIRE(animation->tween(0.0f, animation->totalFrame() * 0.5f, 0.5f) == Result::Success);
+
+    //Disable the cache
+    REQUIRE(animation->cache(0) == Result::Success);
+    REQUIRE(animation->frame(animation->totalFrame() * 0.5f) == Result::Success);
+
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Lottie Shared Composition", "[tvgLottie]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas);
+
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        //The instances of the same file share the parsed model
+        auto animation1 = LottieAnimation::gen();
+        auto animation2 = unique_ptr<LottieAnimation>(LottieAnimation::gen());
+        REQUIRE(animation1);
+        REQUIRE(animation2);
+
+        REQUIRE(animation1->picture()->load(TEST_DIR"/test.json") == Result::Success);
+        REQUIRE(animation2->picture()->load(TEST_DIR"/test.json") == Result::Success);
+        REQUIRE(animation1->totalFrame() == animation2->totalFrame());
+
+        REQUIRE(canvas->push(animation1->picture()) == Result::Success);
+        REQUIRE(canvas->push(animation2->picture()) == Result::Success);
+
+        //Each instance builds its own scene
+        REQUIRE(animation1->frame(animation1->totalFrame() * 0.5f) == Result::Success);
+        REQUIRE(animation2->frame(animation2->totalFrame() * 0.25f) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+
+        //The model outlives the first instance
+        REQUIRE(canvas->remove(animation1->picture()) == Result::Success);
+        delete(animation1);
+
+        REQUIRE(animation2->frame(animation2->totalFrame() * 0.5f) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(canvas->remove() == Result::Success);
+
+        //The slots are overridden per instance
+        auto animation3 = unique_ptr<LottieAnimation>(LottieAnimation::gen());
+        auto animation4 = unique_ptr<LottieAnimation>(LottieAnimation::gen());
+        REQUIRE(animation3->picture()->load(TEST_DIR"/lottieslot.json") == Result::Success);
+        REQUIRE(animation4->picture()->load(TEST_DIR"/lottieslot.json") == Result::Success);
+        REQUIRE(animation3->override(R"({"gradient_fill":{"p":{"p":2,"k":{"a":0,"k":[0,0.1,0.1,0.2,1,1,0.1,0.2,0.1,1]}}}})") == Result::Success);
+        REQUIRE(animation4->override(nullptr) == Result::Success);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+
+#ifdef THORVG_GIF_SAVER_SUPPORT
+
+static string _save(uint32_t threads, const char* path)
+{
+    REQUIRE(Initializer::init(threads) == Result::Success);
+    {
+        auto animation = Animation::gen();
+        REQUIRE(animation->picture()->load(TEST_DIR"/test.json") == Result::Success);
+        REQUIRE(animation->picture()->size(100, 100) == Result::Success);
+
+        auto saver = unique_ptr<Saver>(Saver::gen());
+        REQUIRE(saver->save(animation, path) == Result::Success);
+        REQUIRE(saver->sync() == Result::Success);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+
+    ifstream file(path, ios::binary);
+    string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    remove(path);
+    return data;
+}
+
+
+TEST_CASE("Lottie Pipelined Saving", "[tvgLottie]")
+{
+    //The frames are built by turns with a twin instance, which must make no difference
+    auto sequential = _save(0, TEST_DIR"/test_seq.gif");
+    auto pipelined = _save(3, TEST_DIR"/test_pipe.gif");
+    REQUIRE(!sequential.empty());
+    REQUIRE(sequential == pipelined);
+}
+
+#endif
+
+struct StreamedFrames
+{
+    vector<vector<uint32_t>> buffers;
+    vector<array<int32_t, 4>> damages;
+    uint32_t limit = UINT32_MAX;
+    bool ordered = true;
+
+    static bool sink(const Saver::Frame* frame, void* data)
+    {
+        auto frames = static_cast<StreamedFrames*>(data);
+        if (frame->index != frames->buffers.size()) frames->ordered = false;
+        frames->buffers.emplace_back(frame->buffer, frame->buffer + frame->w * frame->h);
+        frames->damages.push_back({frame->damage[0], frame->damage[1], frame->damage[2], frame->damage[3]});
+        return frames->buffers.size() < frames->limit;
+    }
+};
+
+
+static void _stream(uint32_t threads, StreamedFrames& frames)
+{
+    REQUIRE(Initializer::init(threads) == Result::Success);
+    {
+        auto animation = Animation::gen();
+        REQUIRE(animation->picture()->load(TEST_DIR"/test.json") == Result::Success);
+        REQUIRE(animation->picture()->size(100, 100) == Result::Success);
+
+        auto bg = Shape::gen();
+        REQUIRE(bg->fill(255, 255, 255) == Result::Success);
+        REQUIRE(bg->appendRect(0, 0, 100, 100) == Result::Success);
+
+        auto saver = unique_ptr<Saver>(Saver::gen());
+        REQUIRE(saver->background(bg) == Result::Success);
+        REQUIRE(saver->save(animation, StreamedFrames::sink, &frames, ColorSpace::ARGB8888, 0, threads > 0 ? 2 : 0) == Result::Success);
+        REQUIRE(saver->sync() == Result::Success);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+
+TEST_CASE("Lottie Frame Sink Saving", "[tvgLottie]")
+{
+    //Negative
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto saver = unique_ptr<Saver>(Saver::gen());
+        REQUIRE(saver->save(nullptr, StreamedFrames::sink) == Result::InvalidArguments);
+
+        auto animation = Animation::gen();
+        REQUIRE(animation->picture()->load(TEST_DIR"/test.json") == Result::Success);
+        bool (*none)(const Saver::Frame*, void*) = nullptr;
+        REQUIRE(saver->save(animation, none) == Result::InvalidArguments);
+
+        animation = Animation::gen();
+        REQUIRE(animation->picture()->load(TEST_DIR"/test.json") == Result::Success);
+        REQUIRE(saver->save(animation, StreamedFrames::sink, nullptr, ColorSpace::RGB565) == Result::InvalidArguments);
+
+        //Stopped by the sink
+        StreamedFrames frames;
+        frames.limit = 5;
+        animation = Animation::gen();
+        REQUIRE(animation->picture()->load(TEST_DIR"/test.json") == Result::Success);
+        REQUIRE(saver->save(animation, StreamedFrames::sink, &frames) == Result::Success);
+        REQUIRE(saver->sync() == Result::Success);
+        REQUIRE(frames.buffers.size() == 5);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+
+    //The frames are built by turns with a twin instance and handed over on the workers, which must make no difference
+    StreamedFrames sequential, pipelined;
+    _stream(0, sequential);
+    _stream(3, pipelined);
+
+    REQUIRE(sequential.buffers.size() > 1);
+    REQUIRE(sequential.ordered);
+    REQUIRE(pipelined.ordered);
+    REQUIRE(sequential.buffers == pipelined.buffers);
+
+    //The damaged regions cover all the changes from the previous frames
+    for (auto frames : {&sequential, &pipelined}) {
+        for (size_t i = 1; i < frames->buffers.size(); ++i) {
+            auto& cur = frames->buffers[i];
+            auto& prv = frames->buffers[i - 1];
+            auto& d = frames->damages[i];
+            auto covered = true;
+            for (int32_t y = 0; y < 100 && covered; ++y) {
+                for (int32_t x = 0; x < 100; ++x) {
+                    if (cur[y * 100 + x] == prv[y * 100 + x]) continue;
+                    if (x < d[0] || y < d[1] || x >= d[2] || y >= d[3]) covered = false;
+                }
+            }
+            REQUIRE(covered);
+        }
+    }
+}
+
+TEST_CASE("Lottie Streaming", "[tvgLottie]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        //Read the whole data to feed it in chunks
+        ifstream file(TEST_DIR"/test.json", ios::in | ios::binary);
+        REQUIRE(file.is_open());
+        file.seekg(0, ios::end);
+        auto size = (uint32_t) file.tellg();
+        file.seekg(0, ios::beg);
+        auto data = (char*)malloc(size);
+        file.read(data, size);
+        file.close();
+
+        auto animation = unique_ptr<LottieAnimation>(LottieAnimation::gen());
+        REQUIRE(animation);
+        auto picture = animation->picture();
+
+        REQUIRE(animation->feed(nullptr, 0, false) == Result::InvalidArguments);
+
+        //The header is available before the whole data arrives
+        REQUIRE(animation->feed(data, 64, false) == Result::Success);
+        REQUIRE(animation->frame(0.0f) == Result::InsufficientCondition);
+
+        uint32_t offset = 64;
+        while (size - offset > 1024) {
+            REQUIRE(animation->feed(data + offset, 1024, false) == Result::Success);
+            offset += 1024;
+        }
+        float w, h;
+        REQUIRE(picture->size(&w, &h) == Result::Success);
+        REQUIRE(w > 0.0f);
+        REQUIRE(h > 0.0f);
+        REQUIRE(animation->totalFrame() > 0.0f);
+
+        //The animation is built with the last chunk
+        REQUIRE(animation->feed(data + offset, size - offset, true) == Result::Success);
+        REQUIRE(animation->frame(animation->totalFrame() * 0.5f) == Result::Success);
+
+        //The stream is completed
+        REQUIRE(animation->feed(data, size, true) == Result::InsufficientCondition);
+
+        //Invalid data
+        auto animation2 = unique_ptr<LottieAnimation>(LottieAnimation::gen());
+        REQUIRE(animation2->feed("{\"nolottie\":", 13, false) == Result::Success);
+        REQUIRE(animation2->feed("0}", 2, true) == Result::Unknown);
+        REQUIRE(animation2->totalFrame() == 0.0f);
+
+        //Already loaded by any other means
+        auto animation3 = unique_ptr<LottieAnimation>(LottieAnimation::gen());
+        REQUIRE(animation3->picture()->load(TEST_DIR"/test.json") == Result::Success);
+        REQUIRE(animation3->feed(data, size, true) == Result::InsufficientCondition);
+
+        free(data);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Lottie Layer Flattening", "[tvgLottie]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto animation = unique_ptr<LottieAnimation>(LottieAnimation::gen());
+        REQUIRE(animation);
+        auto picture = animation->picture();
+        REQUIRE(picture->load(TEST_DIR"/test2.json") == Result::Success);
+
+        for (int i = 0; i < 2; ++i) {
+            //The layer of a single shape is handed over to the shape
+            auto bar = picture->paint(Accessor::id("bar"));
+            REQUIRE(bar);
+            REQUIRE(bar->type() == Type::Shape);
+
+            float x, y, w, h;
+            REQUIRE(bar->bounds(&x, &y, &w, &h) == Result::Success);
+            REQUIRE(w > 0.0f);
+            REQUIRE(h > 0.0f);
+
+            //The layer of the shapes remains
+            auto pad = picture->paint(Accessor::id("pad1"));
+            REQUIRE(pad);
+            REQUIRE(pad->type() == Type::Scene);
+
+            REQUIRE(animation->frame(animation->totalFrame() * 0.5f * (i + 1)) == Result::Success);
+        }
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Lottie Static Layers", "[tvgLottie]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        //The model of a file is shared by its instances, which don't retain the layers
+        ifstream file(TEST_DIR"/test2.json", ios::in | ios::binary);
+        REQUIRE(file.is_open());
+        string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+        auto animation = unique_ptr<LottieAnimation>(LottieAnimation::gen());
+        REQUIRE(animation);
+        auto picture = animation->picture();
+        REQUIRE(picture->load(data.c_str(), data.size(), "lottie", nullptr, true) == Result::Success);
+
+        REQUIRE(animation->frame(1.0f) == Result::Success);
+
+        //The layer without any keyframes is built once
+        auto pad = picture->paint(Accessor::id("pad2"));
+        REQUIRE(pad);
+
+        REQUIRE(animation->frame(animation->totalFrame() * 0.5f) == Result::Success);
+        REQUIRE(picture->paint(Accessor::id("pad2")) == pad);
+
+        REQUIRE(animation->frame(2.0f) == Result::Success);
+        REQUIRE(picture->paint(Accessor::id("pad2")) == pad);
+
+        //The animated layer is still updated
+        REQUIRE(picture->paint(Accessor::id("bar")));
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Lottie Paint Lookup", "[tvgLottie]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        struct Value
+        {
+            uint32_t id;
+            const Paint* ret;
+        };
+
+        auto accessor = unique_ptr<Accessor>(Accessor::gen());
+        auto f = [](const tvg::Paint* paint, void* data) -> bool {
+            auto value = static_cast<Value*>(data);
+            if (paint->id != value->id) return true;
+            value->ret = paint;
+            return false;
+        };
+
+        //The indexed paints follow the rebuilt frames, the first one is taken among the same names
+        for (auto path : {TEST_DIR"/test2.json", TEST_DIR"/test7.json"}) {
+            auto animation = unique_ptr<LottieAnimation>(LottieAnimation::gen());
+            REQUIRE(animation);
+            auto picture = animation->picture();
+            REQUIRE(picture->load(path) == Result::Success);
+
+            for (float no = 0.0f; no < animation->totalFrame(); no += 10.0f) {
+                animation->frame(no);
+                for (auto name : {"bar", "pad1", "pad2", "Fireworks", "Shape Layer 1", "none"}) {
+                    Value value = {Accessor::id(name), nullptr};
+                    REQUIRE(accessor->set(picture, f, &value) == Result::Success);
+                    REQUIRE(picture->paint(value.id) == value.ret);
+                }
+            }
+            REQUIRE(picture->paint(picture->id) == picture);
+        }
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Lottie Text Glyphs", "[tvgLottie]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto animation = unique_ptr<LottieAnimation>(LottieAnimation::gen());
+        REQUIRE(animation);
+        auto picture = animation->picture();
+        REQUIRE(picture->load(TEST_DIR"/test9.json") == Result::Success);
+
+        auto accessor = unique_ptr<Accessor>(Accessor::gen());
+        auto f = [](const tvg::Paint* paint, void* data) -> bool {
+            if (paint->type() != Type::Shape) return true;
+            const PathCommand* cmds;
+            uint32_t cmdsCnt;
+            if (static_cast<const Shape*>(paint)->path(&cmds, &cmdsCnt, nullptr, nullptr) == Result::Success && cmdsCnt > 0) {
+                static_cast<vector<const PathCommand*>*>(data)->push_back(cmds);
+            }
+            return true;
+        };
+
+        for (int i = 0; i < 2; ++i) {
+            REQUIRE(animation->frame(10.0f * (i + 1)) == Result::Success);
+
+            //The characters of the same glyph share its outline ("START")
+            vector<const PathCommand*> outlines;
+            REQUIRE(accessor->set(picture, f, &outlines) == Result::Success);
+            auto shared = false;
+            for (size_t j = 0; j < outlines.size() && !shared; ++j) {
+                for (size_t k = j + 1; k < outlines.size(); ++k) {
+                    if (outlines[j] == outlines[k]) shared = true;
+                }
+            }
+            REQUIRE(shared);
+        }
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Lottie Adaptive Quality", "[tvgLottie]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas);
+
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        auto animation = LottieAnimation::gen();
+        REQUIRE(animation);
+        auto picture = animation->picture();
+
+        //Adapt before loaded
+        REQUIRE(animation->adapt(16.0f) == Result::InsufficientCondition);
+
+        REQUIRE(picture->load(TEST_DIR"/test6.json") == Result::Success);
+        REQUIRE(picture->size(100, 100) == Result::Success);
+        REQUIRE(canvas->push(picture) == Result::Success);
+
+        REQUIRE(animation->adapt(-1.0f) == Result::InvalidArguments);
+
+        //Any frame exceeds the budget, the quality is lowered down to the last step
+        REQUIRE(animation->adapt(0.000001f) == Result::Success);
+        REQUIRE(animation->cache(1024 * 1024) == Result::Success);
+
+        for (int i = 0; i < 30; ++i) {
+            REQUIRE(animation->frame(animation->totalFrame() * float(i % 9 + 1) * 0.1f) == Result::Success);
+            REQUIRE(canvas->update() == Result::Success);
+            REQUIRE(canvas->draw() == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+        }
+
+        //Back to the full quality
+        REQUIRE(animation->adapt(0.0f) == Result::Success);
+        REQUIRE(animation->frame(0.5f) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+
+        REQUIRE(canvas->remove() == Result::Success);
+        delete(animation);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Lottie Expressions Engine", "[tvgLottie]")
+{
+    REQUIRE(Initializer::init(4) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas);
+
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        auto animation = LottieAnimation::gen();
+        REQUIRE(animation);
+        auto animation2 = LottieAnimation::gen();
+        REQUIRE(animation2);
+
+        auto ret = LottieAnimation::expressions(128 * 1024);
+        REQUIRE((ret == Result::Success || ret == Result::NonSupport));
+
+        REQUIRE(animation->picture()->load(TEST_DIR"/test6.json") == Result::Success);
+        REQUIRE(animation2->picture()->load(TEST_DIR"/test6.json") == Result::Success);
+        REQUIRE(canvas->push(animation->picture()) == Result::Success);
+        REQUIRE(canvas->push(animation2->picture()) == Result::Success);
+
+        //Each animation evaluates its expressions in its own engine
+        for (int i = 0; i < 10; ++i) {
+            REQUIRE(animation->frame(animation->totalFrame() * float(i % 9 + 1) * 0.1f) == Result::Success);
+            REQUIRE(animation2->frame(animation2->totalFrame() * float(9 - i % 9) * 0.1f) == Result::Success);
+            REQUIRE(canvas->update() == Result::Success);
+            REQUIRE(canvas->draw() == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+        }
+
+        REQUIRE(canvas->remove() == Result::Success);
+        delete(animation);
+        delete(animation2);
+
+        //Back to the default
+        ret = LottieAnimation::expressions(0);
+        REQUIRE((ret == Result::Success || ret == Result::NonSupport));
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+#endif
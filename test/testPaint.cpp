@@ -21,6 +21,7 @@
  */
 
 #include <thorvg.h>
+#include <cstring>
 #include "config.h"
 #include "catch.hpp"
 
@@ -179,6 +180,68 @@ TEST_CASE("Bounding Box", "[tvgPaint]")
     Initializer::term();
 }
 
+TEST_CASE("Bounding Box Updates", "[tvgPaint]")
+{
+    auto scene = unique_ptr<Scene>(Scene::gen());
+    auto shape = Shape::gen();
+    REQUIRE(shape->appendRect(0.0f, 0.0f, 10.0f, 10.0f) == Result::Success);
+    REQUIRE(scene->push(shape) == Result::Success);
+
+    float x = 0, y = 0, w = 0, h = 0;
+    REQUIRE(scene->bounds(&x, &y, &w, &h) == Result::Success);
+    REQUIRE(w == 10.0f);
+    REQUIRE(shape->bounds(&x, &y, &w, &h) == Result::Success);
+    REQUIRE(w == 10.0f);
+
+    //Path changes
+    REQUIRE(shape->appendRect(0.0f, 0.0f, 30.0f, 10.0f) == Result::Success);
+    REQUIRE(shape->bounds(&x, &y, &w, &h) == Result::Success);
+    REQUIRE(w == 30.0f);
+    REQUIRE(scene->bounds(&x, &y, &w, &h) == Result::Success);
+    REQUIRE(w == 30.0f);
+
+    //Stroke changes
+    REQUIRE(shape->strokeWidth(2.0f) == Result::Success);
+    REQUIRE(scene->bounds(&x, &y, &w, &h) == Result::Success);
+    REQUIRE(x == -1.0f);
+    REQUIRE(w == 32.0f);
+
+    //Transform of the child
+    REQUIRE(shape->translate(10.0f, 0.0f) == Result::Success);
+    REQUIRE(scene->bounds(&x, &y, &w, &h) == Result::Success);
+    REQUIRE(x == 9.0f);
+
+    //Transform of the parent
+    REQUIRE(scene->translate(10.0f, 0.0f) == Result::Success);
+    REQUIRE(shape->bounds(&x, &y, &w, &h) == Result::Success);
+    REQUIRE(x == 19.0f);
+
+    //Children changes
+    auto shape2 = Shape::gen();
+    REQUIRE(shape2->appendRect(-10.0f, 0.0f, 10.0f, 10.0f) == Result::Success);
+    REQUIRE(scene->push(shape2) == Result::Success);
+    REQUIRE(scene->bounds(&x, &y, &w, &h) == Result::Success);
+    REQUIRE(x == 0.0f);
+    REQUIRE(scene->remove(shape2) == Result::Success);
+    REQUIRE(scene->bounds(&x, &y, &w, &h) == Result::Success);
+    REQUIRE(x == 19.0f);
+
+    //Nested scene
+    auto child = Scene::gen();
+    auto shape3 = Shape::gen();
+    REQUIRE(shape3->appendRect(0.0f, 0.0f, 10.0f, 100.0f) == Result::Success);
+    REQUIRE(child->push(shape3) == Result::Success);
+    REQUIRE(scene->push(child) == Result::Success);
+    REQUIRE(scene->bounds(&x, &y, &w, &h) == Result::Success);
+    REQUIRE(h == 101.0f);
+    REQUIRE(shape3->scale(2.0f) == Result::Success);
+    REQUIRE(scene->bounds(&x, &y, &w, &h) == Result::Success);
+    REQUIRE(h == 201.0f);
+    REQUIRE(scene->remove() == Result::Success);
+    REQUIRE(scene->bounds(&x, &y, &w, &h) == Result::InsufficientCondition);
+}
+
+
 TEST_CASE("Duplication", "[tvgPaint]")
 {
     auto shape = unique_ptr<Shape>(Shape::gen());
@@ -257,6 +320,103 @@ TEST_CASE("Composition", "[tvgPaint]")
     REQUIRE(comp == comp2);
 }
 
+TEST_CASE("Shape Alpha Masking", "[tvgPaint]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        auto shape = Shape::gen();
+        REQUIRE(shape->appendRect(0, 0, 100, 100) == Result::Success);
+        REQUIRE(shape->fill(255, 0, 0) == Result::Success);
+        auto mask = Shape::gen();
+        REQUIRE(mask->appendCircle(50, 50, 30, 30) == Result::Success);
+        REQUIRE(mask->fill(0, 0, 0) == Result::Success);
+        REQUIRE(shape->mask(mask, MaskMethod::Alpha) == Result::Success);
+        REQUIRE(canvas->push(shape) == Result::Success);
+
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[50 * 100 + 50] == 0xffff0000);
+        REQUIRE(buffer[50 * 100 + 10] == 0);
+        REQUIRE(buffer[10 * 100 + 10] == 0);
+
+        //the translucent mask
+        REQUIRE(mask->fill(0, 0, 0, 128) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE((buffer[50 * 100 + 50] >> 24) == 128);
+        REQUIRE(buffer[50 * 100 + 10] == 0);
+
+        //no masking
+        REQUIRE(shape->mask(nullptr, MaskMethod::None) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[50 * 100 + 50] == 0xffff0000);
+        REQUIRE(buffer[50 * 100 + 10] == 0xffff0000);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Clipping Updates", "[tvgPaint]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        auto shape = Shape::gen();
+        REQUIRE(shape->appendRect(10, 10, 80, 80) == Result::Success);
+        REQUIRE(shape->fill(255, 0, 0, 128) == Result::Success);
+        REQUIRE(shape->strokeWidth(4) == Result::Success);
+        REQUIRE(shape->strokeFill(0, 0, 255, 128) == Result::Success);
+        auto clipper = Shape::gen();
+        REQUIRE(clipper->appendCircle(50, 50, 45, 45) == Result::Success);
+        REQUIRE(shape->clip(clipper) == Result::Success);
+        REQUIRE(canvas->push(shape) == Result::Success);
+
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        auto center = buffer[50 * 100 + 50];
+        auto edge = buffer[18 * 100 + 18];  //antialiased
+        auto stroke = buffer[50 * 100 + 10];
+        REQUIRE(edge != 0);
+        REQUIRE(edge != center);
+        REQUIRE(buffer[10 * 100 + 10] == 0);
+
+        //the clipped rles are kept or regenerated, but never clipped twice
+        for (int i = 0; i < 2; ++i) {
+            REQUIRE(shape->opacity(254 + i) == Result::Success);
+            REQUIRE(canvas->update() == Result::Success);
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+        }
+        REQUIRE(buffer[50 * 100 + 50] == center);
+        REQUIRE(buffer[18 * 100 + 18] == edge);
+        REQUIRE(buffer[50 * 100 + 10] == stroke);
+
+        REQUIRE(shape->strokeFill(0, 0, 255, 128) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[50 * 100 + 50] == center);
+        REQUIRE(buffer[18 * 100 + 18] == edge);
+
+        //no clipping
+        REQUIRE(shape->clip(nullptr) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[10 * 100 + 10] != 0);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
 TEST_CASE("Blending", "[tvgPaint]")
 {
     auto shape = unique_ptr<Shape>(Shape::gen());
@@ -338,4 +498,277 @@ TEST_CASE("Refernce Count", "[tvgPaint]")
     REQUIRE(shape->unref() == 0);
 
     Initializer::term();
-}
\ No newline at end of file
+}
+
+TEST_CASE("Multiple Canvases", "[tvgPaint]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        auto canvas2 = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[100*100];
+        uint32_t buffer2[50*50];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+        REQUIRE(canvas2->target(buffer2, 50, 50, 50, ColorSpace::ARGB8888) == Result::Success);
+
+        auto scene = Scene::gen();
+        REQUIRE(scene->ref() == 1);
+        auto shape = Shape::gen();
+        REQUIRE(shape->appendRect(0, 0, 40, 40) == Result::Success);
+        REQUIRE(shape->fill(255, 0, 0, 255) == Result::Success);
+        REQUIRE(scene->push(shape) == Result::Success);
+        REQUIRE(scene->push(SceneEffect::Fill, 0, 255, 0, 255) == Result::Success);
+
+        //The main view
+        REQUIRE(canvas->push(scene) == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[20 * 100 + 20] == 0xff00ff00);
+
+        //The thumbnail, changed in the meantime
+        REQUIRE(canvas->remove(scene) == Result::Success);
+        REQUIRE(scene->scale(0.5f) == Result::Success);
+        REQUIRE(canvas2->push(scene) == Result::Success);
+        REQUIRE(canvas2->draw(true) == Result::Success);
+        REQUIRE(canvas2->sync() == Result::Success);
+        REQUIRE(buffer2[10 * 50 + 10] == 0xff00ff00);
+        REQUIRE(buffer2[30 * 50 + 30] == 0);
+
+        //Back to the main view, the changes are caught up
+        REQUIRE(canvas2->remove(scene) == Result::Success);
+        REQUIRE(scene->scale(1.0f) == Result::Success);
+        REQUIRE(shape->translate(50, 50) == Result::Success);
+        REQUIRE(canvas->push(scene) == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[20 * 100 + 20] == 0);
+        REQUIRE(buffer[70 * 100 + 70] == 0xff00ff00);
+
+        //The retained render data of the other canvas goes along with the paint
+        REQUIRE(canvas->remove(scene) == Result::Success);
+        REQUIRE(scene->unref() == 0);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Partial Clear", "[tvgPaint]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        auto back = Shape::gen();
+        REQUIRE(back->appendRect(60, 60, 30, 30) == Result::Success);
+        REQUIRE(back->fill(0, 0, 255) == Result::Success);
+        REQUIRE(canvas->push(back) == Result::Success);
+
+        auto shape = Shape::gen();
+        REQUIRE(shape->appendRect(10, 10, 20, 20) == Result::Success);
+        REQUIRE(shape->fill(255, 0, 0, 128) == Result::Success);
+        REQUIRE(canvas->push(shape) == Result::Success);
+
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+
+        //the moved shape damages its previous and current regions only
+        REQUIRE(shape->translate(20, 0) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+
+        const int32_t* regions;
+        uint32_t cnt;
+        REQUIRE(canvas->damages(&regions, &cnt) == Result::Success);
+        REQUIRE(cnt > 0);
+        for (uint32_t i = 0; i < cnt; ++i) {
+            REQUIRE(regions[i * 4 + 2] <= 50);
+            REQUIRE(regions[i * 4 + 3] <= 30);
+        }
+
+        //same as the fresh drawing
+        auto canvas2 = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer2[100*100];
+        REQUIRE(canvas2->target(buffer2, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+        REQUIRE(canvas2->push(back->duplicate()) == Result::Success);
+        REQUIRE(canvas2->push(shape->duplicate()) == Result::Success);
+        REQUIRE(canvas2->draw(true) == Result::Success);
+        REQUIRE(canvas2->sync() == Result::Success);
+        REQUIRE(memcmp(buffer, buffer2, sizeof(buffer)) == 0);
+
+        //the removed shape is cleared
+        REQUIRE(canvas->remove(shape) == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[20 * 100 + 40] == 0);
+        REQUIRE(buffer[75 * 100 + 75] == 0xff0000ff);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Partial Rendering with Scene Effects", "[tvgPaint]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        auto scene = Scene::gen();
+        auto shape = Shape::gen();
+        REQUIRE(shape->appendRect(10, 10, 20, 20) == Result::Success);
+        REQUIRE(shape->fill(255, 0, 0) == Result::Success);
+        REQUIRE(scene->push(shape) == Result::Success);
+
+        auto other = Shape::gen();
+        REQUIRE(other->appendRect(70, 70, 20, 20) == Result::Success);
+        REQUIRE(other->fill(0, 0, 255) == Result::Success);
+        REQUIRE(scene->push(other) == Result::Success);
+        REQUIRE(scene->push(SceneEffect::GaussianBlur, 2.0, 0, 0, 100) == Result::Success);
+        REQUIRE(canvas->push(scene) == Result::Success);
+
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+
+        //the damages are spread out by the blur, not the whole scene
+        REQUIRE(shape->translate(10, 0) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+
+        const int32_t* regions;
+        uint32_t cnt;
+        REQUIRE(canvas->damages(&regions, &cnt) == Result::Success);
+        REQUIRE(cnt > 0);
+        for (uint32_t i = 0; i < cnt; ++i) {
+            REQUIRE(regions[i * 4 + 2] < 70);
+            REQUIRE(regions[i * 4 + 3] < 70);
+        }
+
+        //same as the fresh drawing
+        auto canvas2 = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer2[100*100];
+        REQUIRE(canvas2->target(buffer2, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+        REQUIRE(canvas2->push(scene->duplicate()) == Result::Success);
+        REQUIRE(canvas2->draw(true) == Result::Success);
+        REQUIRE(canvas2->sync() == Result::Success);
+        REQUIRE(memcmp(buffer, buffer2, sizeof(buffer)) == 0);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+
+TEST_CASE("Luma Masking", "[tvgPaint]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        auto shape = Shape::gen();
+        REQUIRE(shape->appendRect(0, 0, 100, 100) == Result::Success);
+        REQUIRE(shape->fill(255, 255, 255) == Result::Success);
+
+        auto mask = Shape::gen();
+        REQUIRE(mask->appendRect(10, 20, 40, 30) == Result::Success);
+        REQUIRE(mask->fill(0, 255, 0) == Result::Success);
+        REQUIRE(shape->mask(mask, MaskMethod::Luma) == Result::Success);
+        REQUIRE(canvas->push(shape) == Result::Success);
+
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+
+        //the luma of the green
+        auto luma = buffer[30 * 100 + 30] >> 24;
+        REQUIRE(luma > 170);
+        REQUIRE(luma < 190);
+        REQUIRE(buffer[30 * 100 + 5] == 0);
+        REQUIRE(buffer[60 * 100 + 30] == 0);
+
+        //the pooled compositor is reused with the moved mask, same as the fresh drawing
+        REQUIRE(mask->translate(30, 30) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+
+        auto canvas2 = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer2[100*100];
+        REQUIRE(canvas2->target(buffer2, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+        REQUIRE(canvas2->push(shape->duplicate()) == Result::Success);
+        REQUIRE(canvas2->draw(true) == Result::Success);
+        REQUIRE(canvas2->sync() == Result::Success);
+        REQUIRE(memcmp(buffer, buffer2, sizeof(buffer)) == 0);
+
+        //the inverse luma
+        REQUIRE(shape->mask(mask->duplicate(), MaskMethod::InvLuma) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE((buffer[60 * 100 + 60] >> 24) == 255 - luma);
+        REQUIRE(buffer[5 * 100 + 5] == 0xffffffff);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Intersection", "[tvgPaint]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        auto circle = Shape::gen();
+        REQUIRE(circle->appendCircle(50, 50, 30, 30) == Result::Success);
+        REQUIRE(circle->fill(255, 0, 0) == Result::Success);
+
+        auto rect = Shape::gen();
+        REQUIRE(rect->appendRect(10, 10, 80, 80) == Result::Success);
+        REQUIRE(rect->strokeWidth(4) == Result::Success);
+        REQUIRE(rect->strokeFill(0, 0, 255) == Result::Success);
+
+        auto scene = Scene::gen();
+        REQUIRE(scene->push(circle) == Result::Success);
+        REQUIRE(scene->push(rect) == Result::Success);
+
+        //Not updated yet
+        REQUIRE(!circle->intersects(50, 50));
+
+        REQUIRE(canvas->push(scene) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+
+        //The coverage of the fill, not its bounding box
+        REQUIRE(circle->intersects(50, 50));
+        REQUIRE(!circle->intersects(22, 22));
+        REQUIRE(circle->intersects(0, 45, 100, 10));
+        REQUIRE(!circle->intersects(50, 50, 0, 0));
+
+        //The stroke only
+        REQUIRE(rect->intersects(10, 50));
+        REQUIRE(!rect->intersects(30, 30));
+
+        REQUIRE(scene->intersects(50, 50));
+        REQUIRE(scene->intersects(10, 50));
+        REQUIRE(!scene->intersects(20, 20));
+        REQUIRE(!scene->intersects(-10, -10, 5, 5));
+
+        //The masked out area
+        auto mask = Shape::gen();
+        REQUIRE(mask->appendRect(0, 0, 50, 100) == Result::Success);
+        REQUIRE(mask->fill(0, 0, 0) == Result::Success);
+        REQUIRE(mask->transform({1, 0.1f, 0, 0, 1, 0, 0, 0, 1}) == Result::Success);
+        REQUIRE(circle->mask(mask, MaskMethod::Alpha) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(circle->intersects(30, 50));
+        REQUIRE(!circle->intersects(75, 50));
+
+        //The invisible one
+        REQUIRE(scene->opacity(0) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(!scene->intersects(50, 50));
+        REQUIRE(!scene->intersects(10, 50));
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
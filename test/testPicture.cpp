@@ -22,7 +22,11 @@
 
 #include <thorvg.h>
 #include <fstream>
+#include <cstdio>
 #include <cstring>
+#include <atomic>
+#include <thread>
+#include <vector>
 #include "config.h"
 #include "catch.hpp"
 
@@ -97,6 +101,194 @@ TEST_CASE("Load RAW file and render", "[tvgPicture]")
     REQUIRE(Initializer::term() == Result::Success);
 }
 
+TEST_CASE("Load RAW data with stride", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas);
+
+        uint32_t buffer[100*100];
+        uint32_t expected[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        ifstream file(TEST_DIR"/rawimage_200x300.raw");
+        if (!file.is_open()) return;
+        auto data = (uint32_t*)malloc(sizeof(uint32_t) * (200*300));
+        file.read(reinterpret_cast<char *>(data), sizeof (uint32_t) * 200 * 300);
+        file.close();
+
+        //the same image padded by 56 pixels per row
+        auto padded = (uint32_t*)malloc(sizeof(uint32_t) * (256*300));
+        for (int y = 0; y < 300; ++y) {
+            memcpy(padded + y * 256, data + y * 200, sizeof(uint32_t) * 200);
+            for (int x = 200; x < 256; ++x) padded[y * 256 + x] = 0xffff0000;
+        }
+
+        auto picture = Picture::gen();
+        REQUIRE(picture);
+
+        //Negative cases
+        REQUIRE(picture->load(nullptr, 200, 300, 256, ColorSpace::ARGB8888, false) == Result::InvalidArguments);
+        REQUIRE(picture->load(padded, 200, 300, 199, ColorSpace::ARGB8888, false) == Result::InvalidArguments);
+
+        //Reference
+        REQUIRE(picture->load(data, 200, 300, ColorSpace::ARGB8888, false) == Result::Success);
+        REQUIRE(picture->size(100, 150) == Result::Success);
+        REQUIRE(canvas->push(picture) == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        memcpy(expected, buffer, sizeof(buffer));
+
+        //Shared and copied data with the stride must render the same
+        for (auto copy : {false, true}) {
+            REQUIRE(canvas->remove() == Result::Success);
+
+            picture = Picture::gen();
+            REQUIRE(picture->load(padded, 200, 300, 256, ColorSpace::ARGB8888, copy) == Result::Success);
+
+            float w, h;
+            REQUIRE(picture->size(&w, &h) == Result::Success);
+            REQUIRE(w == 200);
+            REQUIRE(h == 300);
+
+            REQUIRE(picture->size(100, 150) == Result::Success);
+            REQUIRE(canvas->push(picture) == Result::Success);
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+            REQUIRE(memcmp(expected, buffer, sizeof(buffer)) == 0);
+        }
+
+        free(padded);
+        free(data);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Refresh RAW data", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas);
+
+        uint32_t buffer[4*4];
+        REQUIRE(canvas->target(buffer, 4, 4, 4, ColorSpace::ARGB8888) == Result::Success);
+
+        uint32_t data[4*4];
+        for (int i = 0; i < 4*4; ++i) data[i] = 0xff0000ff;
+
+        auto picture = Picture::gen();
+        REQUIRE(picture);
+
+        //Negative cases
+        REQUIRE(picture->refresh(0, 0, 4, 4) == Result::InsufficientCondition);
+        REQUIRE(picture->load(data, 4, 4, ColorSpace::ARGB8888, false) == Result::Success);
+        REQUIRE(picture->refresh(0, 0, 0, 4) == Result::InvalidArguments);
+        REQUIRE(picture->refresh(0, 0, 4, -1) == Result::InvalidArguments);
+
+        REQUIRE(canvas->push(picture) == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[0] == 0xff0000ff);
+
+        //Write the data in place
+        for (int y = 0; y < 2; ++y) {
+            for (int x = 0; x < 2; ++x) data[y * 4 + x] = 0xff00ff00;
+        }
+        REQUIRE(picture->refresh(0, 0, 2, 2) == Result::Success);
+        REQUIRE(picture->refresh(-2, -2, 1, 1) == Result::Success);  //out of the image
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[0] == 0xff00ff00);
+        REQUIRE(buffer[1 * 4 + 1] == 0xff00ff00);
+        REQUIRE(buffer[3 * 4 + 3] == 0xff0000ff);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Load Texture", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas);
+
+        uint32_t buffer[4*4] = {};
+        REQUIRE(canvas->target(buffer, 4, 4, 4, ColorSpace::ARGB8888) == Result::Success);
+
+        auto picture = Picture::gen();
+        REQUIRE(picture);
+
+        //A texture name of the gpu engine, never accessed by the software engine
+        auto texture = (void*)(uintptr_t)1;
+
+        //Negative cases
+        REQUIRE(picture->texture(nullptr, 4, 4, ColorSpace::ARGB8888) == Result::InvalidArguments);
+        REQUIRE(picture->texture(texture, 0, 4, ColorSpace::ARGB8888) == Result::InvalidArguments);
+        REQUIRE(picture->texture(texture, 4, 4, ColorSpace::Unknown) == Result::InvalidArguments);
+
+        REQUIRE(picture->texture(texture, 4, 4, ColorSpace::ARGB8888) == Result::Success);
+        REQUIRE(picture->refresh(0, 0, 4, 4) == Result::InsufficientCondition);
+
+        float w, h;
+        REQUIRE(picture->size(&w, &h) == Result::Success);
+        REQUIRE(w == 4.0f);
+        REQUIRE(h == 4.0f);
+
+        //The software engine skips it
+        REQUIRE(canvas->push(picture) == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[0] == 0);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Downscaled RAW data", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas);
+
+        uint32_t buffer[16*16];
+        REQUIRE(canvas->target(buffer, 16, 16, 16, ColorSpace::ARGB8888) == Result::Success);
+
+        //Fine checker pattern, averaged to gray by the downscaling
+        auto data = (uint32_t*)malloc(sizeof(uint32_t) * 512 * 512);
+        for (int y = 0; y < 512; ++y) {
+            for (int x = 0; x < 512; ++x) data[y * 512 + x] = ((x / 2 + y / 2) & 1) ? 0xffffffff : 0xff000000;
+        }
+
+        auto picture = Picture::gen();
+        REQUIRE(picture);
+        REQUIRE(picture->load(data, 512, 512, ColorSpace::ARGB8888, false) == Result::Success);
+        REQUIRE(picture->scale(16.0f / 512.0f) == Result::Success);
+        REQUIRE(canvas->push(picture) == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+
+        for (int i = 0; i < 16 * 16; ++i) {
+            REQUIRE((buffer[i] & 0xff) > 96);
+            REQUIRE((buffer[i] & 0xff) < 160);
+        }
+
+        //The smaller copies follow the data change
+        for (int i = 0; i < 512 * 512; ++i) data[i] = 0xffffffff;
+        REQUIRE(picture->refresh(0, 0, 512, 512) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[8 * 16 + 8] == 0xffffffff);
+
+        REQUIRE(canvas->remove() == Result::Success);
+        free(data);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
 TEST_CASE("Picture Size", "[tvgPicture]")
 {
     auto picture = unique_ptr<Picture>(Picture::gen());
@@ -200,6 +392,111 @@ TEST_CASE("Load SVG Data", "[tvgPicture]")
     REQUIRE(h == 1000);
 }
 
+TEST_CASE("Load SVG with inherited styles", "[tvgPicture]")
+{
+    static const char* svg = "<svg viewBox=\"0 0 100 100\" xmlns=\"http://www.w3.org/2000/svg\"><defs><linearGradient id=\"grad\" gradientUnits=\"userSpaceOnUse\" x1=\"0\" y1=\"0\" x2=\"100\" y2=\"0\"><stop offset=\"0\" stop-color=\"#f00\"/><stop offset=\"1\" stop-color=\"#00f\"/></linearGradient></defs><g fill=\"url(#grad)\" stroke=\"#000\" stroke-dasharray=\"4 2\"><rect id=\"first\" x=\"10\" y=\"10\" width=\"30\" height=\"30\"/><rect id=\"second\" x=\"50\" y=\"50\" width=\"30\" height=\"30\"/><rect id=\"third\" x=\"10\" y=\"50\" width=\"30\" height=\"30\" stroke-dasharray=\"1\"/></g></svg>";
+
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto picture = unique_ptr<Picture>(Picture::gen());
+        REQUIRE(picture);
+        REQUIRE(picture->load(svg, strlen(svg), "svg") == Result::Success);
+
+        auto first = static_cast<const Shape*>(picture->paint(Accessor::id("first")));
+        auto second = static_cast<const Shape*>(picture->paint(Accessor::id("second")));
+        auto third = static_cast<const Shape*>(picture->paint(Accessor::id("third")));
+        REQUIRE(first);
+        REQUIRE(second);
+        REQUIRE(third);
+
+        //the children of the group share the same gradient, it stays the same for each of them
+        auto fill = static_cast<const LinearGradient*>(first->fill());
+        auto fill2 = static_cast<const LinearGradient*>(second->fill());
+        REQUIRE(fill);
+        REQUIRE(fill2);
+
+        float x1, y1, x2, y2, x3, y3, x4, y4;
+        REQUIRE(fill->linear(&x1, &y1, &x2, &y2) == Result::Success);
+        REQUIRE(fill2->linear(&x3, &y3, &x4, &y4) == Result::Success);
+        REQUIRE(x1 == x3);
+        REQUIRE(y1 == y3);
+        REQUIRE(x2 == x4);
+        REQUIRE(y2 == y4);
+
+        //the dash is inherited unless overridden
+        const float* dash;
+        REQUIRE(first->strokeDash(&dash) == 2);
+        REQUIRE(dash[0] == 4.0f);
+        REQUIRE(dash[1] == 2.0f);
+        REQUIRE(second->strokeDash(&dash) == 2);
+        REQUIRE(third->strokeDash(&dash) == 1);
+        REQUIRE(dash[0] == 1.0f);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Load SVG header only", "[tvgPicture]")
+{
+    static const char* svg = "<svg width=\"200\" viewBox=\"0 0 100 50\" xmlns=\"http://www.w3.org/2000/svg\"><rect id=\"body\" width=\"100\" height=\"50\"/></svg>";
+    static const char* svg2 = "<svg xmlns=\"http://www.w3.org/2000/svg\"><rect width=\"100\" height=\"50\"/></svg>";
+
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        //the size is given by the root, the body is parsed on the first use
+        auto picture = unique_ptr<Picture>(Picture::gen());
+        REQUIRE(picture->load(svg, strlen(svg), "svg") == Result::Success);
+
+        float w, h;
+        REQUIRE(picture->size(&w, &h) == Result::Success);
+        REQUIRE(w == 200.0f);
+        REQUIRE(h == 50.0f);
+        REQUIRE(!picture->ready());
+
+        REQUIRE(picture->paint(Accessor::id("body")));
+        REQUIRE(picture->ready());
+
+        //the size is decided by the whole document
+        auto picture2 = unique_ptr<Picture>(Picture::gen());
+        REQUIRE(picture2->load(svg2, strlen(svg2), "svg") == Result::Success);
+        REQUIRE(picture2->ready());
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Load SVG with cache", "[tvgPicture]")
+{
+    REQUIRE(Picture::cache(1024 * 1024) == Result::Success);
+
+    //the second load duplicates the cached document
+    auto picture = unique_ptr<Picture>(Picture::gen());
+    REQUIRE(picture);
+    REQUIRE(picture->load(TEST_DIR"/tag.svg") == Result::Success);
+
+    auto picture2 = unique_ptr<Picture>(Picture::gen());
+    REQUIRE(picture2);
+    REQUIRE(picture2->load(TEST_DIR"/tag.svg") == Result::Success);
+
+    float w, h, w2, h2;
+    REQUIRE(picture->size(&w, &h) == Result::Success);
+    REQUIRE(picture2->size(&w2, &h2) == Result::Success);
+    REQUIRE(w == w2);
+    REQUIRE(h == h2);
+
+    //the ids are kept in the duplicates
+    auto id = Accessor::id("lineId");
+    REQUIRE(picture->paint(id));
+    REQUIRE(picture2->paint(id));
+    REQUIRE(picture->paint(id) != picture2->paint(id));
+
+    //the loaders in use survive the eviction
+    REQUIRE(Picture::cache(0) == Result::Success);
+
+    auto picture3 = unique_ptr<Picture>(Picture::gen());
+    REQUIRE(picture3);
+    REQUIRE(picture3->load(TEST_DIR"/tag.svg") == Result::Success);
+    REQUIRE(picture3->paint(id));
+}
+
 TEST_CASE("Load SVG file and render", "[tvgPicture]")
 {
     REQUIRE(Initializer::init(0) == Result::Success);
@@ -227,6 +524,163 @@ TEST_CASE("Load SVG file and render", "[tvgPicture]")
     REQUIRE(Initializer::term() == Result::Success);
 }
 
+TEST_CASE("Batch rendering of SVG pictures", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(4) == Result::Success);
+    {
+        const char* files[] = {TEST_DIR"/logo.svg", TEST_DIR"/tag.svg", TEST_DIR"/tiger.svg"};
+        constexpr uint32_t CNT = 12;
+        constexpr uint32_t SIZE = 64;
+
+        SwCanvas::Job jobs[CNT];
+        Picture* pictures[CNT];
+        auto buffers = new uint32_t[CNT * SIZE * SIZE];
+
+        for (uint32_t i = 0; i < CNT; ++i) {
+            pictures[i] = Picture::gen();
+            REQUIRE(pictures[i]->load(files[i % 3]) == Result::Success);
+            REQUIRE(pictures[i]->size(SIZE, SIZE) == Result::Success);
+            jobs[i] = {pictures[i], buffers + i * SIZE * SIZE, SIZE, SIZE, SIZE, Result::Unknown};
+        }
+
+        //Negative
+        REQUIRE(SwCanvas::batch(nullptr, CNT, ColorSpace::ABGR8888) == Result::InvalidArguments);
+        REQUIRE(SwCanvas::batch(jobs, 0, ColorSpace::ABGR8888) == Result::InvalidArguments);
+
+        REQUIRE(SwCanvas::batch(jobs, CNT, ColorSpace::ABGR8888) == Result::Success);
+
+        //Same as the individual drawing
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[SIZE * SIZE];
+        REQUIRE(canvas->target(buffer, SIZE, SIZE, SIZE, ColorSpace::ABGR8888) == Result::Success);
+
+        for (uint32_t i = 0; i < CNT; ++i) {
+            REQUIRE(jobs[i].result == Result::Success);
+            if (i >= 3) continue;
+            auto picture = Picture::gen();
+            REQUIRE(picture->load(files[i]) == Result::Success);
+            REQUIRE(picture->size(SIZE, SIZE) == Result::Success);
+            REQUIRE(canvas->push(picture) == Result::Success);
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+            REQUIRE(memcmp(buffer, jobs[i].buffer, sizeof(buffer)) == 0);
+            REQUIRE(memcmp(jobs[i].buffer, jobs[i + 3].buffer, sizeof(buffer)) == 0);
+            REQUIRE(canvas->remove(picture) == Result::Success);
+        }
+
+        for (uint32_t i = 0; i < CNT; ++i) delete(pictures[i]);
+        delete[] buffers;
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Multi-resolution rendering of SVG pictures", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        constexpr uint32_t CNT = 3;
+        const uint32_t sizes[CNT] = {128, 64, 32};
+
+        auto buffers = new uint32_t[CNT * 128 * 128];
+
+        SwCanvas::Rendition renditions[CNT];
+        for (uint32_t i = 0; i < CNT; ++i) {
+            renditions[i] = {buffers + i * 128 * 128, sizes[i], sizes[i], sizes[i], float(sizes[i]) / 128.0f, Result::Unknown};
+        }
+
+        auto picture = unique_ptr<Picture>(Picture::gen());
+        REQUIRE(picture->load(TEST_DIR"/tiger.svg") == Result::Success);
+        REQUIRE(picture->size(128, 128) == Result::Success);
+
+        //Negative
+        REQUIRE(SwCanvas::render(nullptr, renditions, CNT, ColorSpace::ABGR8888) == Result::InvalidArguments);
+        REQUIRE(SwCanvas::render(picture.get(), nullptr, CNT, ColorSpace::ABGR8888) == Result::InvalidArguments);
+        REQUIRE(SwCanvas::render(picture.get(), renditions, 0, ColorSpace::ABGR8888) == Result::InvalidArguments);
+
+        REQUIRE(SwCanvas::render(picture.get(), renditions, CNT, ColorSpace::ABGR8888) == Result::Success);
+
+        //Same as the individual drawing
+        for (uint32_t i = 0; i < CNT; ++i) {
+            REQUIRE(renditions[i].result == Result::Success);
+
+            auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+            auto buffer = new uint32_t[sizes[i] * sizes[i]];
+            REQUIRE(canvas->target(buffer, sizes[i], sizes[i], sizes[i], ColorSpace::ABGR8888) == Result::Success);
+
+            auto picture2 = Picture::gen();
+            REQUIRE(picture2->load(TEST_DIR"/tiger.svg") == Result::Success);
+            REQUIRE(picture2->size(float(sizes[i]), float(sizes[i])) == Result::Success);
+            REQUIRE(canvas->push(picture2) == Result::Success);
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+
+            REQUIRE(memcmp(buffer, renditions[i].buffer, sizeof(uint32_t) * sizes[i] * sizes[i]) == 0);
+            delete[] buffer;
+        }
+
+        delete[] buffers;
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Isolated canvases on multiple threads", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        const char* files[] = {TEST_DIR"/logo.svg", TEST_DIR"/tag.svg", TEST_DIR"/tiger.svg"};
+        constexpr uint32_t CNT = 6;
+        constexpr uint32_t SIZE = 64;
+        constexpr uint32_t FRAMES = 4;
+
+        auto buffers = new uint32_t[CNT * SIZE * SIZE];
+        atomic<uint32_t> failed{0};
+
+        //a canvas per thread, drawn at once
+        vector<thread> threads;
+        for (uint32_t i = 0; i < CNT; ++i) {
+            threads.emplace_back([&, i] {
+                auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen(true));
+                if (!canvas || canvas->target(buffers + i * SIZE * SIZE, SIZE, SIZE, SIZE, ColorSpace::ABGR8888) != Result::Success) {
+                    ++failed;
+                    return;
+                }
+                auto picture = Picture::gen();
+                if (picture->load(files[i % 3]) != Result::Success) ++failed;
+                picture->size(SIZE, SIZE);
+                canvas->push(picture);
+                for (uint32_t f = 0; f < FRAMES; ++f) {
+                    picture->translate(float(FRAMES - 1 - f), 0.0f);
+                    if (canvas->update() != Result::Success) ++failed;
+                    if (canvas->draw(true) != Result::Success) ++failed;
+                    if (canvas->sync() != Result::Success) ++failed;
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+        REQUIRE(failed == 0);
+
+        //Same as the shared canvas
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[SIZE * SIZE];
+        REQUIRE(canvas->target(buffer, SIZE, SIZE, SIZE, ColorSpace::ABGR8888) == Result::Success);
+
+        for (uint32_t i = 0; i < 3; ++i) {
+            auto picture = Picture::gen();
+            REQUIRE(picture->load(files[i]) == Result::Success);
+            REQUIRE(picture->size(SIZE, SIZE) == Result::Success);
+            REQUIRE(canvas->push(picture) == Result::Success);
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+            REQUIRE(memcmp(buffer, buffers + i * SIZE * SIZE, sizeof(buffer)) == 0);
+            REQUIRE(memcmp(buffer, buffers + (i + 3) * SIZE * SIZE, sizeof(buffer)) == 0);
+            REQUIRE(canvas->remove(picture) == Result::Success);
+        }
+
+        delete[] buffers;
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
 #endif
 
 #ifdef THORVG_PNG_LOADER_SUPPORT
@@ -272,6 +726,117 @@ TEST_CASE("Load PNG file from data", "[tvgPicture]")
     free(data);
 }
 
+TEST_CASE("Load PNG file with retention", "[tvgPicture]")
+{
+    REQUIRE(Initializer::cache(2 * 1024 * 1024) == Result::Success);
+
+    //the decoded image outlives its picture
+    {
+        auto picture = unique_ptr<Picture>(Picture::gen());
+        REQUIRE(picture);
+        REQUIRE(picture->load(TEST_DIR"/test.png") == Result::Success);
+    }
+
+    //the second load revives the retained image
+    auto picture = unique_ptr<Picture>(Picture::gen());
+    REQUIRE(picture);
+    REQUIRE(picture->load(TEST_DIR"/test.png") == Result::Success);
+
+    float w, h;
+    REQUIRE(picture->size(&w, &h) == Result::Success);
+    REQUIRE(w == 512);
+    REQUIRE(h == 512);
+
+    //the images in use survive the eviction
+    REQUIRE(Initializer::cache(0) == Result::Success);
+
+    auto picture2 = unique_ptr<Picture>(Picture::gen());
+    REQUIRE(picture2);
+    REQUIRE(picture2->load(TEST_DIR"/test.png") == Result::Success);
+    REQUIRE(picture2->size(&w, &h) == Result::Success);
+    REQUIRE(w == 512);
+}
+
+TEST_CASE("Load shared pictures concurrently", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(4) == Result::Success);
+    {
+        //the distinct data are cached by their pointers
+        vector<uint32_t> data(300 * 4);
+        for (uint32_t i = 0; i < data.size(); ++i) data[i] = 0xff000000 | i;
+
+        atomic<int> fails{0};
+        vector<thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&data, &fails]() {
+                for (int k = 0; k < 20; ++k) {
+                    auto png = unique_ptr<Picture>(Picture::gen());
+                    auto png2 = unique_ptr<Picture>(Picture::gen());
+                    if (png->load(TEST_DIR"/test.png") != Result::Success) ++fails;
+                    if (png2->load(TEST_DIR"/test.png") != Result::Success) ++fails;
+                    for (int i = 0; i < 300; ++i) {
+                        auto raw = unique_ptr<Picture>(Picture::gen());
+                        if (raw->load(data.data() + i * 4, 2, 2, ColorSpace::ARGB8888, false) != Result::Success) ++fails;
+                    }
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+        REQUIRE(fails == 0);
+
+        //the same data share the loader
+        float w, h;
+        auto picture = unique_ptr<Picture>(Picture::gen());
+        auto picture2 = unique_ptr<Picture>(Picture::gen());
+        REQUIRE(picture->load(data.data() + 8, 2, 2, ColorSpace::ARGB8888, false) == Result::Success);
+        REQUIRE(picture2->load(data.data() + 8, 2, 2, ColorSpace::ARGB8888, false) == Result::Success);
+        REQUIRE(picture2->size(&w, &h) == Result::Success);
+        REQUIRE(w == 2);
+
+        auto png = unique_ptr<Picture>(Picture::gen());
+        REQUIRE(png->load(TEST_DIR"/test.png") == Result::Success);
+        REQUIRE(png->size(&w, &h) == Result::Success);
+        REQUIRE(w == 512);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Load PNG file with the size in advance", "[tvgPicture]")
+{
+    auto picture = unique_ptr<Picture>(Picture::gen());
+    REQUIRE(picture);
+
+    //the image is decoded in a quarter resolution still covering the size
+    REQUIRE(picture->size(100, 100) == Result::Success);
+    REQUIRE(picture->load(TEST_DIR"/test.png") == Result::Success);
+
+    float w, h;
+    REQUIRE(picture->size(&w, &h) == Result::Success);
+    REQUIRE(w == 100);
+    REQUIRE(h == 100);
+
+    //the reduced one is not shared with the others
+    auto picture2 = unique_ptr<Picture>(Picture::gen());
+    REQUIRE(picture2);
+    REQUIRE(picture2->load(TEST_DIR"/test.png") == Result::Success);
+    REQUIRE(picture2->size(&w, &h) == Result::Success);
+    REQUIRE(w == 512);
+    REQUIRE(h == 512);
+
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas);
+
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+        REQUIRE(canvas->push(picture.release()) == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
 TEST_CASE("Load PNG file and render", "[tvgPicture]")
 {
     REQUIRE(Initializer::init(0) == Result::Success);
@@ -294,6 +859,146 @@ TEST_CASE("Load PNG file and render", "[tvgPicture]")
     REQUIRE(Initializer::term() == Result::Success);
 }
 
+TEST_CASE("Prefetch PNG files", "[tvgPicture]")
+{
+    ifstream file(TEST_DIR"/test.png", ios::in | ios::binary);
+    REQUIRE(file.is_open());
+    file.seekg(0, ios::end);
+    auto size = (uint32_t) file.tellg();
+    file.seekg(0, ios::beg);
+    auto data = (char*)malloc(size);
+    file.read(data, size);
+    file.close();
+
+    //no loading
+    {
+        auto picture = unique_ptr<Picture>(Picture::gen());
+        REQUIRE(!picture->ready());
+        REQUIRE(picture->cancel() == Result::InsufficientCondition);
+    }
+
+    //synchronous loading
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto picture = unique_ptr<Picture>(Picture::gen());
+        REQUIRE(picture->prefetch(true) == Result::Success);
+        REQUIRE(picture->load(data, size, "png", "", true) == Result::Success);
+        REQUIRE(picture->ready());
+        REQUIRE(picture->cancel() == Result::InsufficientCondition);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+
+    REQUIRE(Initializer::init(2) == Result::Success);
+    {
+        constexpr uint32_t CNT = 8;
+        uint32_t expected[100*100];
+        uint32_t buffer[100*100];
+
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas->target(expected, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        auto picture = Picture::gen();
+        REQUIRE(picture->load(data, size, "png", "", true) == Result::Success);
+        REQUIRE(picture->size(100, 100) == Result::Success);
+        REQUIRE(canvas->push(picture) == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(picture->ready());
+        REQUIRE(canvas->remove() == Result::Success);
+
+        Picture* pictures[CNT];
+        for (uint32_t i = 0; i < CNT; ++i) {
+            pictures[i] = Picture::gen();
+            REQUIRE(pictures[i]->prefetch(true) == Result::Success);
+            REQUIRE(pictures[i]->load(data, size, "png", "", true) == Result::Success);
+            REQUIRE(pictures[i]->size(100, 100) == Result::Success);
+        }
+
+        //the ones not started yet are canceled, they are loaded again once they are drawn
+        for (uint32_t i = CNT / 2; i < CNT; ++i) {
+            if (pictures[i]->cancel() == Result::Success) {
+                REQUIRE(!pictures[i]->ready());
+                REQUIRE(pictures[i]->cancel() == Result::InsufficientCondition);
+            }
+        }
+        REQUIRE(pictures[0]->prefetch(false) == Result::Success);
+
+        //the drawings are same as the regular loading
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+        for (uint32_t i = 0; i < CNT; ++i) {
+            REQUIRE(canvas->push(pictures[i]) == Result::Success);
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+            REQUIRE(pictures[i]->ready());
+            REQUIRE(memcmp(buffer, expected, sizeof(buffer)) == 0);
+            REQUIRE(canvas->remove() == Result::Success);
+        }
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+
+    free(data);
+}
+
+#ifdef THORVG_PNG_SAVER_SUPPORT
+
+TEST_CASE("Save a picture into PNG", "[tvgPicture]")
+{
+    auto render = [](Paint* paint, uint32_t* buffer) {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+        auto bg = Shape::gen();
+        REQUIRE(bg->appendRect(0, 0, 100, 100) == Result::Success);
+        REQUIRE(bg->fill(255, 255, 255) == Result::Success);
+        REQUIRE(canvas->push(bg) == Result::Success);
+        REQUIRE(canvas->push(paint) == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+    };
+
+    //the chunks are deflated on the workers or in place, the results are lossless regardless of the quality
+    for (auto threads : {0, 4}) {
+        REQUIRE(Initializer::init(threads) == Result::Success);
+        {
+            uint32_t expected[100*100];
+            uint32_t buffer[100*100];
+
+            auto picture = Picture::gen();
+            REQUIRE(picture->load(TEST_DIR"/test.png") == Result::Success);
+            REQUIRE(picture->size(100, 100) == Result::Success);
+            render(picture, expected);
+
+            for (auto quality : {0, 50, 100}) {
+                auto saver = unique_ptr<Saver>(Saver::gen());
+                auto bg = Shape::gen();
+                REQUIRE(bg->appendRect(0, 0, 100, 100) == Result::Success);
+                REQUIRE(bg->fill(255, 255, 255) == Result::Success);
+                REQUIRE(saver->background(bg) == Result::Success);
+
+                auto source = Picture::gen();
+                REQUIRE(source->load(TEST_DIR"/test.png") == Result::Success);
+                REQUIRE(source->size(100, 100) == Result::Success);
+                REQUIRE(saver->save(source, TEST_DIR"/test_saved.png", quality) == Result::Success);
+                REQUIRE(saver->sync() == Result::Success);
+
+                auto saved = Picture::gen();
+                REQUIRE(saved->load(TEST_DIR"/test_saved.png") == Result::Success);
+                float w, h;
+                REQUIRE(saved->size(&w, &h) == Result::Success);
+                REQUIRE(w == 100.0f);
+                REQUIRE(h == 100.0f);
+                render(saved, buffer);
+                REQUIRE(memcmp(buffer, expected, sizeof(buffer)) == 0);
+            }
+        }
+        REQUIRE(Initializer::term() == Result::Success);
+    }
+
+    //don't leave the output in the resources
+    REQUIRE(remove(TEST_DIR"/test_saved.png") == 0);
+}
+
+#endif
+
 #endif
 
 #ifdef THORVG_JPG_LOADER_SUPPORT
@@ -342,6 +1047,42 @@ TEST_CASE("Load JPG file from data", "[tvgPicture]")
     free(data);
 }
 
+TEST_CASE("Load JPG file with the size in advance", "[tvgPicture]")
+{
+    auto picture = unique_ptr<Picture>(Picture::gen());
+    REQUIRE(picture);
+
+    //the image is decoded in a quarter resolution still covering the size
+    REQUIRE(picture->size(100, 100) == Result::Success);
+    REQUIRE(picture->load(TEST_DIR"/test.jpg") == Result::Success);
+
+    float w, h;
+    REQUIRE(picture->size(&w, &h) == Result::Success);
+    REQUIRE(w == 100);
+    REQUIRE(h == 100);
+
+    //the reduced one is not shared with the others
+    auto picture2 = unique_ptr<Picture>(Picture::gen());
+    REQUIRE(picture2);
+    REQUIRE(picture2->load(TEST_DIR"/test.jpg") == Result::Success);
+    REQUIRE(picture2->size(&w, &h) == Result::Success);
+    REQUIRE(w == 512);
+    REQUIRE(h == 512);
+
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas);
+
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+        REQUIRE(canvas->push(picture.release()) == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
 TEST_CASE("Load JPG file and render", "[tvgPicture]")
 {
     REQUIRE(Initializer::init(0) == Result::Success);
@@ -408,6 +1149,42 @@ TEST_CASE("Load WEBP file from data", "[tvgPicture]")
     free(data);
 }
 
+TEST_CASE("Load WEBP file with the size in advance", "[tvgPicture]")
+{
+    auto picture = unique_ptr<Picture>(Picture::gen());
+    REQUIRE(picture);
+
+    //the image is decoded in a quarter resolution still covering the size
+    REQUIRE(picture->size(100, 100) == Result::Success);
+    REQUIRE(picture->load(TEST_DIR"/test.webp") == Result::Success);
+
+    float w, h;
+    REQUIRE(picture->size(&w, &h) == Result::Success);
+    REQUIRE(w == 100);
+    REQUIRE(h == 100);
+
+    //the reduced one is not shared with the others
+    auto picture2 = unique_ptr<Picture>(Picture::gen());
+    REQUIRE(picture2);
+    REQUIRE(picture2->load(TEST_DIR"/test.webp") == Result::Success);
+    REQUIRE(picture2->size(&w, &h) == Result::Success);
+    REQUIRE(w == 512);
+    REQUIRE(h == 512);
+
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas);
+
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+        REQUIRE(canvas->push(picture.release()) == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
 TEST_CASE("Load WEBP file and render", "[tvgPicture]")
 {
     REQUIRE(Initializer::init(0) == Result::Success);
@@ -22,6 +22,8 @@
 
 #include <thorvg.h>
 #include <fstream>
+#include <cstdio>
+#include <cstring>
 #include "config.h"
 #include "catch.hpp"
 
@@ -73,4 +75,296 @@ TEST_CASE("Save a lottie into gif", "[tvgSavers]")
     REQUIRE(Initializer::term() == Result::Success);
 }
 #endif
-#endif
\ No newline at end of file
+
+#endif
+
+#if (defined(THORVG_GIF_SAVER_SUPPORT) || defined(THORVG_WEBP_SAVER_SUPPORT)) && defined(THORVG_LOTTIE_LOADER_SUPPORT)
+
+//reads the saved file and removes it from the resources
+static string _load(const char* path)
+{
+    ifstream file(path, ios::binary);
+    string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    remove(path);
+    return data;
+}
+
+#endif
+
+
+#if defined(THORVG_GIF_SAVER_SUPPORT) && defined(THORVG_LOTTIE_LOADER_SUPPORT)
+
+//walks the gif blocks, returns the size of the global color table and counts the frames with their local ones
+static uint32_t _gifTables(const string& data, uint32_t& frames, uint32_t& locals)
+{
+    auto p = reinterpret_cast<const uint8_t*>(data.data());
+    auto end = data.size();
+    auto table = [](uint8_t packed) { return (packed & 0x80) ? 3u << ((packed & 0x07) + 1) : 0u; };
+    auto skip = [&](size_t& pos) {
+        while (pos < end && p[pos]) pos += p[pos] + 1;
+        ++pos;
+    };
+
+    frames = locals = 0;
+    if (end < 13 || data.substr(0, 6) != "GIF89a") return 0;
+
+    auto global = table(p[10]);
+    size_t pos = 13 + global;
+
+    while (pos < end) {
+        if (p[pos] == 0x21) {           //extension
+            pos += 2;
+            skip(pos);
+        } else if (p[pos] == 0x2c) {    //image descriptor
+            if (pos + 10 > end) break;
+            auto local = table(p[pos + 9]);
+            ++frames;
+            if (local) ++locals;
+            pos += 10 + local + 1;      //lzw minimum code size
+            skip(pos);
+        } else break;                   //trailer
+    }
+    REQUIRE(pos < end);
+    REQUIRE(p[pos] == 0x3b);
+    return global;
+}
+
+
+TEST_CASE("Save a lottie into gif with a global palette", "[tvgSavers]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto saver = unique_ptr<Saver>(Saver::gen());
+        REQUIRE(saver);
+
+        auto bg = Shape::gen();
+        REQUIRE(bg->fill(255, 255, 255) == Result::Success);
+        REQUIRE(bg->appendRect(0, 0, 100, 100) == Result::Success);
+        REQUIRE(saver->background(bg) == Result::Success);
+
+        uint32_t frames, locals;
+
+        //every frame has its own palette
+        auto animation = Animation::gen();
+        REQUIRE(animation);
+        REQUIRE(animation->picture()->load(TEST_DIR"/test.json") == Result::Success);
+        REQUIRE(animation->picture()->size(100, 100) == Result::Success);
+        REQUIRE(saver->save(animation, TEST_DIR"/test_saved.gif") == Result::Success);
+        REQUIRE(saver->sync() == Result::Success);
+
+        _gifTables(_load(TEST_DIR"/test_saved.gif"), frames, locals);
+        REQUIRE(frames > 0);
+        REQUIRE(locals == frames);
+
+        //the frames share the global one
+        auto animation2 = Animation::gen();
+        REQUIRE(animation2);
+        REQUIRE(animation2->picture()->load(TEST_DIR"/test.json") == Result::Success);
+        REQUIRE(animation2->picture()->size(100, 100) == Result::Success);
+        REQUIRE(saver->save(animation2, TEST_DIR"/test_saved.gif", 50) == Result::Success);
+        REQUIRE(saver->sync() == Result::Success);
+
+        REQUIRE(_gifTables(_load(TEST_DIR"/test_saved.gif"), frames, locals) == 256 * 3);
+        REQUIRE(frames > 0);
+        REQUIRE(locals == 0);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+#endif
+
+
+#if defined(THORVG_WEBP_SAVER_SUPPORT) && defined(THORVG_LOTTIE_LOADER_SUPPORT)
+
+static uint32_t _get32(const string& data, size_t pos)
+{
+    auto p = reinterpret_cast<const uint8_t*>(data.data() + pos);
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24);
+}
+
+
+TEST_CASE("Save a lottie into webp", "[tvgSavers]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto animation = Animation::gen();
+        REQUIRE(animation);
+        REQUIRE(animation->picture()->load(TEST_DIR"/test.json") == Result::Success);
+        REQUIRE(animation->picture()->size(100, 100) == Result::Success);
+
+        auto saver = unique_ptr<Saver>(Saver::gen());
+        REQUIRE(saver);
+        REQUIRE(saver->save(animation, TEST_DIR"/test_saved.webp") == Result::Success);
+        REQUIRE(saver->sync() == Result::Success);
+        REQUIRE(_load(TEST_DIR"/test_saved.webp").substr(0, 4) == "RIFF");
+
+        //near lossless
+        auto animation2 = Animation::gen();
+        REQUIRE(animation2);
+        REQUIRE(animation2->picture()->load(TEST_DIR"/test.json") == Result::Success);
+        REQUIRE(animation2->picture()->size(100, 100) == Result::Success);
+        REQUIRE(saver->save(animation2, TEST_DIR"/test_saved.webp", 75) == Result::Success);
+        REQUIRE(saver->sync() == Result::Success);
+        REQUIRE(_load(TEST_DIR"/test_saved.webp").substr(0, 4) == "RIFF");
+
+        //lossless with a background
+        auto animation3 = Animation::gen();
+        REQUIRE(animation3);
+        REQUIRE(animation3->picture()->load(TEST_DIR"/test.json") == Result::Success);
+        REQUIRE(animation3->picture()->size(100, 100) == Result::Success);
+
+        auto bg = Shape::gen();
+        REQUIRE(bg->fill(255, 255, 255) == Result::Success);
+        REQUIRE(bg->appendRect(0, 0, 100, 100) == Result::Success);
+        REQUIRE(saver->background(bg) == Result::Success);
+        REQUIRE(saver->save(animation3, TEST_DIR"/test_saved.webp") == Result::Success);
+        REQUIRE(saver->sync() == Result::Success);
+
+        auto data = _load(TEST_DIR"/test_saved.webp");
+
+        //RIFF header, then the animation header and the frames
+        REQUIRE(data.size() > 44);
+        REQUIRE(data.substr(0, 4) == "RIFF");
+        REQUIRE(_get32(data, 4) == data.size() - 8);
+        REQUIRE(data.substr(8, 4) == "WEBP");
+        REQUIRE(data.substr(12, 4) == "VP8X");
+        REQUIRE((data[20] & 0x02) != 0);   //animation
+        REQUIRE(data.substr(30, 4) == "ANIM");
+
+        size_t first = 0;
+        uint32_t frames = 0;
+        for (size_t pos = 44; pos < data.size(); ++frames) {
+            REQUIRE(pos + 32 <= data.size());
+            REQUIRE(data.substr(pos, 4) == "ANMF");
+            REQUIRE(data.substr(pos + 24, 4) == "VP8L");
+            if (frames == 0) first = pos;
+            auto size = _get32(data, pos + 4);
+            pos += 8 + size + (size & 1);
+            REQUIRE(pos <= data.size());
+        }
+        REQUIRE(frames > 0);
+
+        //the first frame covers the whole canvas
+        auto frame = reinterpret_cast<const uint8_t*>(data.data() + first + 8);
+        REQUIRE((frame[0] | (frame[1] << 8) | (frame[2] << 16)) == 0);
+        REQUIRE((frame[3] | (frame[4] << 8) | (frame[5] << 16)) == 0);
+        REQUIRE((frame[6] | (frame[7] << 8) | (frame[8] << 16)) == 99);
+        REQUIRE((frame[9] | (frame[10] << 8) | (frame[11] << 16)) == 99);
+
+        //it decodes back to the rendered pixels as a still image
+        auto bitstream = _get32(data, first + 28);
+        string still = "RIFF____WEBP" + data.substr(first + 24, 8 + bitstream + (bitstream & 1));
+        auto riff = uint32_t(still.size() - 8);
+        for (int i = 0; i < 4; ++i) still[4 + i] = char((riff >> (i * 8)) & 0xff);
+
+        auto render = [](Paint* paint, uint32_t* buffer) {
+            auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+            REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888S) == Result::Success);
+            auto bg = Shape::gen();
+            REQUIRE(bg->appendRect(0, 0, 100, 100) == Result::Success);
+            REQUIRE(bg->fill(255, 255, 255) == Result::Success);
+            REQUIRE(canvas->push(bg) == Result::Success);
+            REQUIRE(canvas->push(paint) == Result::Success);
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+        };
+
+        uint32_t expected[100*100];
+        auto reference = Picture::gen();
+        REQUIRE(reference->load(TEST_DIR"/test.json") == Result::Success);
+        REQUIRE(reference->size(100, 100) == Result::Success);
+        render(reference, expected);
+
+        uint32_t decoded[100*100];
+        auto picture = Picture::gen();
+        REQUIRE(picture->load(still.data(), uint32_t(still.size()), "webp", nullptr, true) == Result::Success);
+        render(picture, decoded);
+
+        REQUIRE(memcmp(decoded, expected, sizeof(decoded)) == 0);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+#endif
+
+
+#ifdef THORVG_LOTTIE_SAVER_SUPPORT
+
+TEST_CASE("Save a lottie into tvglot", "[tvgSavers]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto saver = unique_ptr<Saver>(Saver::gen());
+        REQUIRE(saver);
+
+        auto animation = Animation::gen();
+        REQUIRE(animation->picture()->load(TEST_DIR"/test.json") == Result::Success);
+        REQUIRE(saver->save(animation, TEST_DIR"/test.tvglot") == Result::Success);
+        REQUIRE(saver->sync() == Result::Success);
+
+        //neither the slots, the expressions nor the paints are compiled
+        auto animation2 = Animation::gen();
+        REQUIRE(animation2->picture()->load(TEST_DIR"/lottieslot.json") == Result::Success);
+        REQUIRE(saver->save(animation2, TEST_DIR"/test_slot.tvglot") == Result::Unknown);
+
+        auto animation3 = Animation::gen();
+        REQUIRE(animation3->picture()->load(TEST_DIR"/test6.json") == Result::Success);
+        REQUIRE(saver->save(animation3, TEST_DIR"/test_exp.tvglot") == Result::Unknown);
+
+        REQUIRE(saver->save(Shape::gen(), TEST_DIR"/test_paint.tvglot") == Result::Unknown);
+
+        ifstream file(TEST_DIR"/test.tvglot", ios::binary);
+        string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+        REQUIRE(data.substr(0, 6) == "TVGLOT");
+
+        auto render = [](Animation* animation, float no, uint32_t* buffer) {
+            auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+            REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+            animation->frame(no);
+            REQUIRE(canvas->push(animation->picture()) == Result::Success);
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+            REQUIRE(canvas->remove(animation->picture()) == Result::Success);
+        };
+
+        //the compiled model animates as the parsed one
+        auto reference = unique_ptr<Animation>(Animation::gen());
+        REQUIRE(reference->picture()->load(TEST_DIR"/test.json") == Result::Success);
+        REQUIRE(reference->picture()->size(100, 100) == Result::Success);
+
+        auto compiled = unique_ptr<Animation>(Animation::gen());
+        REQUIRE(compiled->picture()->load(TEST_DIR"/test.tvglot") == Result::Success);
+        REQUIRE(compiled->picture()->size(100, 100) == Result::Success);
+
+        auto loaded = unique_ptr<Animation>(Animation::gen());
+        REQUIRE(loaded->picture()->load(data.data(), uint32_t(data.size()), "lot", nullptr, false) == Result::Success);
+        REQUIRE(loaded->picture()->size(100, 100) == Result::Success);
+
+        REQUIRE(compiled->totalFrame() == reference->totalFrame());
+        REQUIRE(compiled->duration() == reference->duration());
+
+        uint32_t expected[100*100], buffer[100*100];
+        for (auto no = 0.0f; no < reference->totalFrame(); no += 7.0f) {
+            render(reference.get(), no, expected);
+            render(compiled.get(), no, buffer);
+            REQUIRE(memcmp(buffer, expected, sizeof(buffer)) == 0);
+            render(loaded.get(), no, buffer);
+            REQUIRE(memcmp(buffer, expected, sizeof(buffer)) == 0);
+        }
+
+        //a damaged one is rejected
+        data[data.size() / 2] ^= 0xff;
+        auto picture = unique_ptr<Picture>(Picture::gen());
+        REQUIRE(picture->load(data.data(), uint32_t(data.size()), "lot", nullptr, true) == Result::NonSupport);
+
+        //a compiled one isn't compiled again
+        auto animation4 = Animation::gen();
+        REQUIRE(animation4->picture()->load(TEST_DIR"/test.tvglot") == Result::Success);
+        REQUIRE(saver->save(animation4, TEST_DIR"/test_twice.tvglot") == Result::Unknown);
+
+        remove(TEST_DIR"/test.tvglot");
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+#endif
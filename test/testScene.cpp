@@ -21,6 +21,9 @@
  */
 
 #include <thorvg.h>
+#include <atomic>
+#include <thread>
+#include <cstring>
 #include "config.h"
 #include "catch.hpp"
 
@@ -103,3 +106,329 @@ TEST_CASE("Scene Clear And Reuse Shape", "[tvgScene]")
     }
     REQUIRE(Initializer::term() == Result::Success);
 }
+
+TEST_CASE("Scene Profiling", "[tvgScene]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[100*100];
+        canvas->target(buffer, 100, 100, 100, ColorSpace::ABGR8888);
+
+        Canvas::Profile profile;
+
+        //Negative, the profiling is off
+        REQUIRE(canvas->profile(&profile) == Result::InsufficientCondition);
+        REQUIRE(canvas->profiling(true) == Result::Success);
+        REQUIRE(canvas->profile(nullptr) == Result::InvalidArguments);
+
+        auto scene = Scene::gen();
+        auto shape = Shape::gen();
+        REQUIRE(shape->appendCircle(50, 50, 25, 25) == Result::Success);
+        REQUIRE(shape->fill(255, 255, 255) == Result::Success);
+        REQUIRE(scene->push(shape) == Result::Success);
+        REQUIRE(canvas->push(scene) == Result::Success);
+
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+
+        //Negative, not synced yet
+        REQUIRE(canvas->profile(&profile) == Result::InsufficientCondition);
+        REQUIRE(canvas->profiling(false) == Result::InsufficientCondition);
+
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(canvas->profile(&profile) == Result::Success);
+        REQUIRE(profile.shapes == 1);
+        REQUIRE(profile.spans > 0);
+        REQUIRE(profile.gpu == 0.0f);
+
+        //A new frame resets the statistics
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(canvas->profile(&profile) == Result::Success);
+        REQUIRE(profile.shapes == 0);
+
+        REQUIRE(canvas->profiling(false) == Result::Success);
+        REQUIRE(canvas->profile(&profile) == Result::InsufficientCondition);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+
+TEST_CASE("Scene Composition Regions", "[tvgScene]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[200*200];
+        REQUIRE(canvas->target(buffer, 200, 200, 200, ColorSpace::ARGB8888) == Result::Success);
+
+        //a translucent scene at the corner, partially out of the canvas
+        auto scene = Scene::gen();
+        auto shape = Shape::gen();
+        REQUIRE(shape->appendRect(150, 150, 80, 80) == Result::Success);
+        REQUIRE(shape->fill(255, 255, 255) == Result::Success);
+        REQUIRE(scene->push(shape) == Result::Success);
+        REQUIRE(scene->opacity(128) == Result::Success);
+        REQUIRE(canvas->push(scene) == Result::Success);
+
+        //a masked shape nested in the other composition region
+        auto outer = Scene::gen();
+        auto inner = Scene::gen();
+        auto rect = Shape::gen();
+        REQUIRE(rect->appendRect(20, 100, 40, 40) == Result::Success);
+        REQUIRE(rect->fill(255, 0, 0) == Result::Success);
+        auto mask = Shape::gen();
+        REQUIRE(mask->appendRect(30, 90, 20, 60) == Result::Success);
+        REQUIRE(mask->fill(0, 0, 0) == Result::Success);
+        REQUIRE(rect->mask(mask, MaskMethod::Alpha) == Result::Success);
+        REQUIRE(inner->push(rect) == Result::Success);
+        REQUIRE(inner->opacity(254) == Result::Success);
+        auto shape2 = Shape::gen();
+        REQUIRE(shape2->appendRect(0, 0, 100, 100) == Result::Success);
+        REQUIRE(shape2->fill(0, 0, 255) == Result::Success);
+        REQUIRE(outer->push(shape2) == Result::Success);
+        REQUIRE(outer->push(inner) == Result::Success);
+        REQUIRE(outer->opacity(254) == Result::Success);
+        REQUIRE(canvas->push(outer) == Result::Success);
+
+        //the second frame reuses the pooled compositors
+        for (int i = 0; i < 2; ++i) {
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+
+            REQUIRE((buffer[170 * 200 + 170] >> 24) == 128);
+            REQUIRE(buffer[199 * 200 + 199] == buffer[170 * 200 + 170]);
+            REQUIRE(buffer[140 * 200 + 140] == 0);
+
+            REQUIRE((buffer[50 * 200 + 50] & 0x00ffff00) == 0);
+            REQUIRE((buffer[50 * 200 + 50] & 0x000000ff) > 0xf0);
+            REQUIRE((buffer[120 * 200 + 40] & 0x00ffffff) > 0x00f00000);
+            REQUIRE(buffer[120 * 200 + 25] == 0);
+            REQUIRE(buffer[120 * 200 + 55] == 0);
+        }
+
+        //no leftovers of the previous mask in the reused compositor
+        REQUIRE(inner->translate(10, 0) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[120 * 200 + 35] == 0);
+        REQUIRE((buffer[120 * 200 + 55] & 0x00ffffff) > 0x00f00000);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+
+static void _drawn(Canvas*, Result result, void* data)
+{
+    if (result == Result::Success) ++*static_cast<atomic<int>*>(data);
+}
+
+
+TEST_CASE("Scene Asynchronous Drawing", "[tvgScene]")
+{
+    for (uint32_t threads = 0; threads < 3; ++threads) {
+        REQUIRE(Initializer::init(threads) == Result::Success);
+        {
+            uint32_t expected[100*100];
+            uint32_t buffer[100*100];
+            atomic<int> drawn{0};
+
+            auto build = [](SwCanvas* canvas) {
+                auto scene = Scene::gen();
+                for (int i = 0; i < 10; ++i) {
+                    auto shape = Shape::gen();
+                    shape->appendCircle(10.0f + i * 8.0f, 50, 20, 30);
+                    shape->fill(25 * i, 255 - 25 * i, 128, 200);
+                    scene->push(shape);
+                }
+                return canvas->push(scene);
+            };
+
+            //reference with the blocking draw
+            auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+            REQUIRE(canvas->target(expected, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+            REQUIRE(build(canvas.get()) == Result::Success);
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+
+            canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+
+            //Negative, nothing to draw
+            REQUIRE(canvas->submit(true, _drawn, &drawn) == Result::InsufficientCondition);
+            REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+            REQUIRE(canvas->submit(true, _drawn, &drawn) == Result::InsufficientCondition);
+            REQUIRE(canvas->ready() == Result::Success);
+
+            REQUIRE(build(canvas.get()) == Result::Success);
+
+            for (int frame = 0; frame < 3; ++frame) {
+                REQUIRE(canvas->submit(true, _drawn, &drawn) == Result::Success);
+
+                //Negative, the drawing is in progress
+                REQUIRE(canvas->submit() == Result::InsufficientCondition);
+                REQUIRE(canvas->draw() == Result::InsufficientCondition);
+                REQUIRE(canvas->update() == Result::InsufficientCondition);
+
+                while (canvas->ready() != Result::Success) this_thread::yield();
+                REQUIRE(canvas->sync() == Result::Success);
+                REQUIRE(canvas->ready() == Result::Success);
+                REQUIRE(drawn == frame + 1);
+                REQUIRE(memcmp(buffer, expected, sizeof(buffer)) == 0);
+            }
+        }
+        REQUIRE(Initializer::term() == Result::Success);
+    }
+}
+
+
+TEST_CASE("Large Scene Scrolling", "[tvgScene]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        uint32_t expected[100*100];
+        uint32_t buffer[100*100];
+
+        //a grid of 40x40 shapes, far larger than the viewport
+        auto build = [](Scene* scene) {
+            for (int i = 0; i < 1600; ++i) {
+                auto shape = Shape::gen();
+                shape->appendRect(float(i % 40) * 25.0f, float(i / 40) * 25.0f, 20, 20, 4, 4);
+                shape->fill(i % 256, (i * 7) % 256, 128, 255);
+                if (i % 3 == 0) {
+                    shape->strokeWidth(4);
+                    shape->strokeFill(0, 0, 0, 255);
+                }
+                scene->push(shape);
+            }
+        };
+
+        auto scene = Scene::gen();
+        build(scene);
+
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+        REQUIRE(canvas->push(scene) == Result::Success);
+
+        for (int frame = 0; frame < 8; ++frame) {
+            auto x = -float(frame * 113 % 900);
+            auto y = -float(frame * 71 % 900);
+
+            REQUIRE(scene->translate(x, y) == Result::Success);
+            //the changes of the culled out shapes must be kept
+            if (frame == 4) {
+                for (auto paint : scene->paints()) static_cast<Shape*>(const_cast<Paint*>(paint))->fill(255, 0, 0, 255);
+            }
+            REQUIRE(canvas->update() == Result::Success);
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+
+            //reference with a fresh scene
+            auto canvas2 = unique_ptr<SwCanvas>(SwCanvas::gen());
+            REQUIRE(canvas2->target(expected, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+            auto scene2 = Scene::gen();
+            build(scene2);
+            if (frame >= 4) {
+                for (auto paint : scene2->paints()) static_cast<Shape*>(const_cast<Paint*>(paint))->fill(255, 0, 0, 255);
+            }
+            REQUIRE(scene2->translate(x, y) == Result::Success);
+            REQUIRE(canvas2->push(scene2) == Result::Success);
+            REQUIRE(canvas2->draw(true) == Result::Success);
+            REQUIRE(canvas2->sync() == Result::Success);
+
+            REQUIRE(memcmp(buffer, expected, sizeof(buffer)) == 0);
+        }
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+
+TEST_CASE("Scene Color Effects Fusion", "[tvgScene]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        uint32_t fused[100*100];
+        uint32_t separated[100*100];
+
+        //the zero sigma blur is a no-op in between, it breaks the run of the color effects
+        auto draw = [](uint32_t* buffer, bool fusion) {
+            auto scene = Scene::gen();
+            for (int i = 0; i < 10; ++i) {
+                auto shape = Shape::gen();
+                shape->appendCircle(10.0f + i * 8.0f, 50, 20, 30);
+                shape->fill(25 * i, 255 - 25 * i, 128, 200);
+                scene->push(shape);
+            }
+            scene->push(SceneEffect::Fill, 40, 80, 160, 220);
+            if (!fusion) scene->push(SceneEffect::GaussianBlur, 0.0, 0, 0, 0);
+            scene->push(SceneEffect::Tint, 10, 20, 30, 220, 200, 180, 60.0);
+            if (!fusion) scene->push(SceneEffect::GaussianBlur, 0.0, 0, 0, 0);
+            scene->push(SceneEffect::Tritone, 0, 0, 64, 128, 128, 128, 255, 240, 200, 80);
+
+            auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+            REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+            REQUIRE(canvas->push(scene) == Result::Success);
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+        };
+
+        draw(fused, true);
+        draw(separated, false);
+
+        REQUIRE(memcmp(fused, separated, sizeof(fused)) == 0);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Scene Occlusion", "[tvgScene]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        //the circle hidden under the opaque card
+        auto circle = Shape::gen();
+        REQUIRE(circle->appendCircle(50, 50, 20, 20) == Result::Success);
+        REQUIRE(circle->fill(255, 0, 0) == Result::Success);
+        REQUIRE(canvas->push(circle) == Result::Success);
+
+        auto card = Shape::gen();
+        REQUIRE(card->appendRect(20.4f, 20.4f, 60, 60) == Result::Success);
+        REQUIRE(card->fill(0, 0, 255) == Result::Success);
+        REQUIRE(canvas->push(card) == Result::Success);
+
+        auto top = Shape::gen();
+        REQUIRE(top->appendRect(40, 40, 20, 20) == Result::Success);
+        REQUIRE(top->fill(0, 255, 0, 128) == Result::Success);
+        REQUIRE(canvas->push(top) == Result::Success);
+
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[35 * 100 + 50] == 0xff0000ff);
+        REQUIRE(buffer[50 * 100 + 50] == 0xff00807f);
+        REQUIRE(buffer[10 * 100 + 10] == 0);
+
+        //the translucent card doesn't hide it
+        REQUIRE(card->opacity(128) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE((buffer[35 * 100 + 50] & 0x00ff0000) > 0);
+
+        //neither does the masked one
+        REQUIRE(card->opacity(255) == Result::Success);
+        auto mask = Shape::gen();
+        REQUIRE(mask->appendRect(0, 0, 100, 100) == Result::Success);
+        REQUIRE(mask->fill(0, 0, 0, 128) == Result::Success);
+        REQUIRE(card->mask(mask, MaskMethod::Alpha) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE((buffer[35 * 100 + 50] & 0x00ff0000) > 0);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
@@ -21,6 +21,7 @@
  */
 
 #include <thorvg.h>
+#include <cstring>
 #include "config.h"
 #include "catch.hpp"
 
@@ -129,6 +130,187 @@ TEST_CASE("Appending Paths", "[tvgShape]")
     REQUIRE(pts2Cnt == 0);
 }
 
+TEST_CASE("Modifying Points", "[tvgShape]")
+{
+    auto shape = unique_ptr<Shape>(Shape::gen());
+    REQUIRE(shape);
+
+    Point pts[2] = {{10, 20}, {30, 40}};
+
+    //Negative cases
+    REQUIRE(shape->points(nullptr, 0, 1) == Result::InvalidArguments);
+    REQUIRE(shape->points(pts, 0, 0) == Result::InvalidArguments);
+    REQUIRE(shape->points(pts, 0, 1) == Result::InsufficientCondition);
+
+    REQUIRE(shape->moveTo(0, 0) == Result::Success);
+    REQUIRE(shape->lineTo(1, 1) == Result::Success);
+    REQUIRE(shape->lineTo(2, 2) == Result::Success);
+
+    REQUIRE(shape->points(pts, 2, 2) == Result::InsufficientCondition);
+    REQUIRE(shape->points(pts, 4, 1) == Result::InsufficientCondition);
+    REQUIRE(shape->points(pts, 1, 2) == Result::Success);
+
+    const PathCommand* cmds;
+    const Point* pts2;
+    uint32_t cmdsCnt, ptsCnt;
+    REQUIRE(shape->path(&cmds, &cmdsCnt, &pts2, &ptsCnt) == Result::Success);
+    REQUIRE(cmdsCnt == 3);
+    REQUIRE(ptsCnt == 3);
+    REQUIRE(cmds[2] == PathCommand::LineTo);
+    REQUIRE(pts2[0].x == 0.0f);
+    REQUIRE(pts2[1].x == 10.0f);
+    REQUIRE(pts2[1].y == 20.0f);
+    REQUIRE(pts2[2].x == 30.0f);
+    REQUIRE(pts2[2].y == 40.0f);
+
+    //The updated geometry is drawn
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        auto rect = Shape::gen();
+        REQUIRE(rect->appendRect(0, 0, 50, 50) == Result::Success);
+        REQUIRE(rect->fill(255, 0, 0, 255) == Result::Success);
+        REQUIRE(canvas->push(rect) == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[25 * 100 + 25] == 0xffff0000);
+        REQUIRE(buffer[75 * 100 + 75] == 0);
+
+        Point moved[4] = {{100, 50}, {50, 50}, {50, 100}, {100, 100}};
+        REQUIRE(rect->points(moved, 0, 4) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[25 * 100 + 25] == 0);
+        REQUIRE(buffer[75 * 100 + 75] == 0xffff0000);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+
+TEST_CASE("Duplicated Paths", "[tvgShape]")
+{
+    auto shape = unique_ptr<Shape>(Shape::gen());
+    REQUIRE(shape->appendRect(0, 0, 100, 100) == Result::Success);
+
+    auto dup = unique_ptr<Shape>(static_cast<Shape*>(shape->duplicate()));
+    auto dup2 = unique_ptr<Shape>(static_cast<Shape*>(dup->duplicate()));
+
+    const PathCommand* cmds;
+    const PathCommand* cmds2;
+    const Point* pts;
+    const Point* pts2;
+    uint32_t cmdsCnt, ptsCnt;
+
+    REQUIRE(shape->path(&cmds, nullptr, &pts, nullptr) == Result::Success);
+    REQUIRE(dup->path(&cmds2, &cmdsCnt, &pts2, &ptsCnt) == Result::Success);
+    REQUIRE(cmdsCnt == 5);
+    REQUIRE(ptsCnt == 4);
+    REQUIRE(memcmp(cmds, cmds2, sizeof(PathCommand) * cmdsCnt) == 0);
+    REQUIRE(memcmp(pts, pts2, sizeof(Point) * ptsCnt) == 0);
+
+    //The changes don't affect the others
+    REQUIRE(dup->lineTo(200, 200) == Result::Success);
+    REQUIRE(shape->path(nullptr, &cmdsCnt, nullptr, &ptsCnt) == Result::Success);
+    REQUIRE(cmdsCnt == 5);
+    REQUIRE(ptsCnt == 4);
+    REQUIRE(dup->path(nullptr, &cmdsCnt, nullptr, &ptsCnt) == Result::Success);
+    REQUIRE(cmdsCnt == 6);
+    REQUIRE(ptsCnt == 5);
+
+    REQUIRE(shape->reset() == Result::Success);
+    REQUIRE(shape->path(nullptr, &cmdsCnt, nullptr, &ptsCnt) == Result::Success);
+    REQUIRE(cmdsCnt == 0);
+    REQUIRE(ptsCnt == 0);
+
+    REQUIRE(dup2->path(&cmds, &cmdsCnt, &pts, &ptsCnt) == Result::Success);
+    REQUIRE(cmdsCnt == 5);
+    REQUIRE(ptsCnt == 4);
+    REQUIRE(pts[0].x == 100.0f);
+    REQUIRE(pts[2].y == 100.0f);
+
+    REQUIRE(dup2->appendCircle(50, 50, 10, 10) == Result::Success);
+    REQUIRE(dup2->path(nullptr, &cmdsCnt, nullptr, &ptsCnt) == Result::Success);
+    REQUIRE(cmdsCnt == 11);
+    REQUIRE(ptsCnt == 17);
+}
+
+
+TEST_CASE("Attaching Paths", "[tvgShape]")
+{
+    PathCommand cmds[5] = {PathCommand::MoveTo, PathCommand::LineTo, PathCommand::LineTo, PathCommand::LineTo, PathCommand::Close};
+    Point pts[4] = {{10, 10}, {90, 10}, {90, 90}, {10, 90}};
+    int released = 0;
+    auto release = [](void* data) { ++*static_cast<int*>(data); };
+
+    auto shape = unique_ptr<Shape>(Shape::gen());
+
+    //Negative cases
+    REQUIRE(shape->attachPath(nullptr, 5, pts, 4, release, &released) == Result::InvalidArguments);
+    REQUIRE(shape->attachPath(cmds, 0, pts, 4, release, &released) == Result::InvalidArguments);
+    REQUIRE(shape->attachPath(cmds, 5, nullptr, 4, release, &released) == Result::InvalidArguments);
+    REQUIRE(shape->attachPath(cmds, 5, pts, 0, release, &released) == Result::InvalidArguments);
+    REQUIRE(released == 0);
+
+    //The arrays are referred, not copied
+    REQUIRE(shape->appendRect(0, 0, 10, 10) == Result::Success);
+    REQUIRE(shape->attachPath(cmds, 5, pts, 4, release, &released) == Result::Success);
+
+    const PathCommand* cmds2;
+    const Point* pts2;
+    uint32_t cmdsCnt, ptsCnt;
+    REQUIRE(shape->path(&cmds2, &cmdsCnt, &pts2, &ptsCnt) == Result::Success);
+    REQUIRE(cmds2 == cmds);
+    REQUIRE(pts2 == pts);
+    REQUIRE(cmdsCnt == 5);
+    REQUIRE(ptsCnt == 4);
+
+    //Rendering
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        auto dup = static_cast<Shape*>(shape->duplicate());
+        REQUIRE(dup->fill(255, 255, 255) == Result::Success);
+        REQUIRE(canvas->push(dup) == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[50 * 100 + 50] == 0xffffffff);
+        REQUIRE(buffer[5 * 100 + 5] == 0);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+
+    //Modifications make a private copy, the arrays are intact
+    auto dup = unique_ptr<Shape>(static_cast<Shape*>(shape->duplicate()));
+    REQUIRE(shape->lineTo(50, 50) == Result::Success);
+    REQUIRE(shape->path(&cmds2, &cmdsCnt, &pts2, &ptsCnt) == Result::Success);
+    REQUIRE(pts2 != pts);
+    REQUIRE(cmdsCnt == 6);
+    REQUIRE(ptsCnt == 5);
+    REQUIRE(released == 0);
+
+    REQUIRE(dup->points(pts + 1, 0, 1) == Result::Success);
+    REQUIRE(dup->path(nullptr, nullptr, &pts2, nullptr) == Result::Success);
+    REQUIRE(pts2[0].x == 90.0f);
+    REQUIRE(pts[0].x == 10.0f);
+    REQUIRE(released == 1);
+
+    //Released once by the reset
+    REQUIRE(shape->attachPath(cmds, 5, pts, 4, release, &released) == Result::Success);
+    REQUIRE(shape->reset() == Result::Success);
+    REQUIRE(released == 2);
+
+    //Released once by the destruction
+    REQUIRE(shape->attachPath(cmds, 5, pts, 4, release, &released) == Result::Success);
+    shape.reset();
+    REQUIRE(released == 3);
+}
+
 TEST_CASE("Stroking", "[tvgShape]")
 {
     auto shape = unique_ptr<Shape>(Shape::gen());
@@ -232,3 +414,515 @@ TEST_CASE("Shape Filling", "[tvgShape]")
     REQUIRE(shape->fillRule(FillRule::EvenOdd) == Result::Success);
     REQUIRE(shape->fillRule() == FillRule::EvenOdd);
 }
+
+
+TEST_CASE("Curve Flatness", "[tvgShape]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[100*100];
+        uint32_t smooth[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        //Negative
+        REQUIRE(canvas->flatness(0.0f) == Result::InvalidArguments);
+        REQUIRE(canvas->flatness(-1.0f) == Result::InvalidArguments);
+
+        auto shape = Shape::gen();
+        REQUIRE(shape->appendCircle(50, 50, 40, 40) == Result::Success);
+        REQUIRE(shape->fill(255, 255, 255) == Result::Success);
+        REQUIRE(canvas->push(shape) == Result::Success);
+
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        memcpy(smooth, buffer, sizeof(buffer));
+
+        //Coarse segments, the edges move while the inside stays
+        REQUIRE(canvas->flatness(2.0f) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(memcmp(smooth, buffer, sizeof(buffer)) != 0);
+        REQUIRE(buffer[50 * 100 + 50] == smooth[50 * 100 + 50]);
+
+        //Back to the default
+        REQUIRE(canvas->flatness(0.125f) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(memcmp(smooth, buffer, sizeof(buffer)) == 0);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Coverage Tiles", "[tvgShape]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[100*100];
+        uint32_t spans[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        //Solid
+        auto shape1 = Shape::gen();
+        REQUIRE(shape1->moveTo(10, 10) == Result::Success);
+        REQUIRE(shape1->cubicTo(90, 0, 100, 60, 50, 90) == Result::Success);
+        REQUIRE(shape1->lineTo(5, 60) == Result::Success);
+        REQUIRE(shape1->close() == Result::Success);
+        REQUIRE(shape1->fill(255, 0, 0) == Result::Success);
+        REQUIRE(canvas->push(shape1) == Result::Success);
+
+        //Translucent, even-odd
+        auto shape2 = Shape::gen();
+        REQUIRE(shape2->moveTo(50, 3) == Result::Success);
+        REQUIRE(shape2->lineTo(79, 93) == Result::Success);
+        REQUIRE(shape2->lineTo(3, 37) == Result::Success);
+        REQUIRE(shape2->lineTo(97, 37) == Result::Success);
+        REQUIRE(shape2->lineTo(21, 93) == Result::Success);
+        REQUIRE(shape2->close() == Result::Success);
+        REQUIRE(shape2->fill(0, 255, 0, 127) == Result::Success);
+        REQUIRE(shape2->fillRule(FillRule::EvenOdd) == Result::Success);
+        REQUIRE(canvas->push(shape2) == Result::Success);
+
+        //Blending
+        auto shape3 = Shape::gen();
+        REQUIRE(shape3->moveTo(30, 20) == Result::Success);
+        REQUIRE(shape3->cubicTo(110, 30, 60, 110, 20, 80) == Result::Success);
+        REQUIRE(shape3->close() == Result::Success);
+        REQUIRE(shape3->fill(0, 0, 255, 200) == Result::Success);
+        REQUIRE(shape3->blend(BlendMethod::Multiply) == Result::Success);
+        REQUIRE(canvas->push(shape3) == Result::Success);
+
+        //Masking
+        auto shape4 = Shape::gen();
+        REQUIRE(shape4->moveTo(0, 50) == Result::Success);
+        REQUIRE(shape4->cubicTo(30, 20, 70, 80, 100, 50) == Result::Success);
+        REQUIRE(shape4->lineTo(100, 100) == Result::Success);
+        REQUIRE(shape4->lineTo(0, 100) == Result::Success);
+        REQUIRE(shape4->close() == Result::Success);
+        REQUIRE(shape4->fill(255, 255, 0) == Result::Success);
+        auto mask = Shape::gen();
+        REQUIRE(mask->moveTo(0, 0) == Result::Success);
+        REQUIRE(mask->lineTo(100, 40) == Result::Success);
+        REQUIRE(mask->lineTo(0, 100) == Result::Success);
+        REQUIRE(mask->close() == Result::Success);
+        REQUIRE(mask->fill(0, 0, 0, 180) == Result::Success);
+        REQUIRE(shape4->mask(mask, MaskMethod::Alpha) == Result::Success);
+        REQUIRE(canvas->push(shape4) == Result::Success);
+
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        memcpy(spans, buffer, sizeof(buffer));
+
+        //The same pixels
+        REQUIRE(canvas->tiles(true) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(memcmp(spans, buffer, sizeof(buffer)) == 0);
+
+        //Moved and recolored
+        REQUIRE(shape1->translate(7, 3) == Result::Success);
+        REQUIRE(shape2->fill(0, 255, 0, 90) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        memcpy(spans, buffer, sizeof(buffer));
+
+        REQUIRE(canvas->tiles(false) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(memcmp(spans, buffer, sizeof(buffer)) == 0);
+
+        //Beyond the span coordinates
+        auto tall = unique_ptr<uint32_t[]>(new uint32_t[16 * 70000]);
+        REQUIRE(canvas->target(tall.get(), 16, 16, 70000, ColorSpace::ARGB8888) == Result::Success);
+        REQUIRE(canvas->tiles(true) == Result::Success);
+        REQUIRE(canvas->remove() == Result::Success);
+
+        auto shape5 = Shape::gen();
+        REQUIRE(shape5->moveTo(0, 0) == Result::Success);
+        REQUIRE(shape5->lineTo(16, 0) == Result::Success);
+        REQUIRE(shape5->lineTo(12, 70000) == Result::Success);
+        REQUIRE(shape5->lineTo(4, 70000) == Result::Success);
+        REQUIRE(shape5->close() == Result::Success);
+        REQUIRE(shape5->fill(255, 0, 0) == Result::Success);
+        REQUIRE(canvas->push(shape5) == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(tall[100 * 16 + 8] == 0xffff0000);
+        REQUIRE(tall[68000 * 16 + 8] == 0xffff0000);
+        REQUIRE(tall[68000 * 16] == 0);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Primitive Shapes", "[tvgShape]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        auto area = [&]() {
+            uint32_t sum = 0;
+            for (int i = 0; i < 100 * 100; ++i) sum += buffer[i] >> 24;
+            return sum;
+        };
+
+        //Axis-aligned circle
+        auto circle = Shape::gen();
+        REQUIRE(circle->appendCircle(50, 50, 40, 40) == Result::Success);
+        REQUIRE(circle->fill(255, 255, 255) == Result::Success);
+        REQUIRE(canvas->push(circle) == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+
+        REQUIRE(buffer[50 * 100 + 50] == 0xffffffff);
+        REQUIRE(buffer[12 * 100 + 12] == 0);
+        REQUIRE((buffer[21 * 100 + 78] >> 24) > 0);
+        REQUIRE((buffer[21 * 100 + 78] >> 24) < 255);
+        auto aligned = area();
+
+        //Rotated, the same coverage by the rasterizer
+        REQUIRE(circle->rotate(45.0f) == Result::Success);
+        REQUIRE(circle->translate(50, -20.710678f) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+
+        auto rotated = area();
+        REQUIRE(aligned > rotated * 0.995f);
+        REQUIRE(aligned < rotated * 1.005f);
+
+        REQUIRE(canvas->remove() == Result::Success);
+
+        //Axis-aligned line
+        auto line = Shape::gen();
+        REQUIRE(line->moveTo(10, 20.5f) == Result::Success);
+        REQUIRE(line->lineTo(90, 20.5f) == Result::Success);
+        REQUIRE(line->strokeWidth(1.0f) == Result::Success);
+        REQUIRE(line->strokeCap(StrokeCap::Butt) == Result::Success);
+        REQUIRE(line->strokeFill(255, 255, 255) == Result::Success);
+        REQUIRE(canvas->push(line) == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+
+        REQUIRE(buffer[20 * 100 + 10] == 0xffffffff);
+        REQUIRE(buffer[20 * 100 + 89] == 0xffffffff);
+        REQUIRE(buffer[20 * 100 + 9] == 0);
+        REQUIRE(buffer[20 * 100 + 90] == 0);
+        REQUIRE(buffer[19 * 100 + 50] == 0);
+        REQUIRE(buffer[21 * 100 + 50] == 0);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Hairline Strokes", "[tvgShape]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        auto area = [&]() {
+            uint32_t sum = 0;
+            for (int i = 0; i < 100 * 100; ++i) sum += buffer[i] >> 24;
+            return sum;
+        };
+
+        auto shape = Shape::gen();
+        REQUIRE(shape->moveTo(10, 10) == Result::Success);
+        REQUIRE(shape->lineTo(90, 30) == Result::Success);
+        REQUIRE(shape->lineTo(15, 60) == Result::Success);
+        REQUIRE(shape->lineTo(85, 90) == Result::Success);
+        REQUIRE(shape->moveTo(20, 70) == Result::Success);
+        REQUIRE(shape->lineTo(40, 90.5f) == Result::Success);
+        REQUIRE(shape->lineTo(20, 90.5f) == Result::Success);
+        REQUIRE(shape->close() == Result::Success);
+        REQUIRE(shape->appendCircle(65, 60, 12, 8) == Result::Success);
+        REQUIRE(shape->strokeFill(255, 255, 255) == Result::Success);
+        REQUIRE(canvas->push(shape) == Result::Success);
+
+        for (auto join : {StrokeJoin::Miter, StrokeJoin::Round, StrokeJoin::Bevel}) {
+            for (auto cap : {StrokeCap::Butt, StrokeCap::Round, StrokeCap::Square}) {
+                REQUIRE(shape->strokeJoin(join) == Result::Success);
+                REQUIRE(shape->strokeCap(cap) == Result::Success);
+
+                //the direct coverage of the thin stroke
+                REQUIRE(shape->strokeWidth(1.0f) == Result::Success);
+                REQUIRE(canvas->update() == Result::Success);
+                REQUIRE(canvas->draw(true) == Result::Success);
+                REQUIRE(canvas->sync() == Result::Success);
+                auto hairline = area();
+
+                REQUIRE(buffer[90 * 100 + 30] == 0xffffffff);
+                REQUIRE(buffer[85 * 100 + 25] == 0);
+
+                //almost the same with the stroke outline
+                REQUIRE(shape->strokeWidth(1.02f) == Result::Success);
+                REQUIRE(canvas->update() == Result::Success);
+                REQUIRE(canvas->draw(true) == Result::Success);
+                REQUIRE(canvas->sync() == Result::Success);
+                auto outline = area();
+
+                REQUIRE(hairline > outline * 0.95f);
+                REQUIRE(hairline < outline * 1.02f);
+            }
+        }
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+
+TEST_CASE("Packed Target Colorspaces", "[tvgShape]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+
+        //RGB565
+        uint16_t buffer16[100*100];
+        REQUIRE(canvas->target(reinterpret_cast<uint32_t*>(buffer16), 100, 100, 100, ColorSpace::RGB565) == Result::Success);
+        REQUIRE(canvas->dither(true) == Result::Success);
+
+        auto shape = Shape::gen();
+        REQUIRE(shape->appendRect(0, 0, 50, 50) == Result::Success);
+        REQUIRE(shape->fill(255, 0, 0) == Result::Success);
+        REQUIRE(canvas->push(shape) == Result::Success);
+
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer16[25 * 100 + 25] == 0xf800);
+        REQUIRE(buffer16[75 * 100 + 75] == 0x0000);
+
+        //A8
+        uint8_t buffer8[100*100];
+        REQUIRE(canvas->target(reinterpret_cast<uint32_t*>(buffer8), 100, 100, 100, ColorSpace::Grayscale8) == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer8[25 * 100 + 25] == 255);
+        REQUIRE(buffer8[75 * 100 + 75] == 0);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+static void _flushBand(const uint32_t* buffer, uint32_t y, uint32_t lines, void* data)
+{
+    memcpy(static_cast<uint32_t*>(data) + y * 100, buffer, lines * 100 * sizeof(uint32_t));
+}
+
+TEST_CASE("Banded Target", "[tvgShape]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        uint32_t whole[100*100];
+        uint32_t banded[100*100];
+        uint32_t band[100*7];
+
+        auto draw = [](SwCanvas* canvas) {
+            auto shape = Shape::gen();
+            REQUIRE(shape->appendCircle(50, 50, 40, 30) == Result::Success);
+            REQUIRE(shape->fill(255, 0, 0, 127) == Result::Success);
+            REQUIRE(shape->strokeWidth(3) == Result::Success);
+            REQUIRE(shape->strokeFill(0, 0, 255) == Result::Success);
+            REQUIRE(canvas->push(shape) == Result::Success);
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+        };
+
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas->target(whole, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+        draw(canvas.get());
+
+        auto canvas2 = unique_ptr<SwCanvas>(SwCanvas::gen());
+
+        //Negative
+        REQUIRE(canvas2->target(band, 100, 100, 100, 0, ColorSpace::ARGB8888, _flushBand, banded) == Result::InvalidArguments);
+        REQUIRE(canvas2->target(band, 100, 100, 100, 7, ColorSpace::ARGB8888, nullptr, banded) == Result::InvalidArguments);
+
+        //The last band is shorter
+        REQUIRE(canvas2->target(band, 100, 100, 100, 7, ColorSpace::ARGB8888, _flushBand, banded) == Result::Success);
+        draw(canvas2.get());
+
+        REQUIRE(memcmp(whole, banded, sizeof(whole)) == 0);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Gradient Opacity", "[tvgShape]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        Fill::ColorStop stops[2] = {{0.0f, 255, 0, 0, 255}, {1.0f, 0, 0, 255, 255}};
+
+        auto shape = Shape::gen();
+        REQUIRE(shape->appendRect(0, 0, 100, 50) == Result::Success);
+        auto fill = LinearGradient::gen();
+        REQUIRE(fill->linear(0, 0, 100, 0) == Result::Success);
+        REQUIRE(fill->colorStops(stops, 2) == Result::Success);
+        REQUIRE(shape->fill(fill) == Result::Success);
+        REQUIRE(canvas->push(shape) == Result::Success);
+
+        //Stroke gradient
+        auto shape2 = Shape::gen();
+        REQUIRE(shape2->moveTo(0, 75) == Result::Success);
+        REQUIRE(shape2->lineTo(100, 75) == Result::Success);
+        REQUIRE(shape2->strokeWidth(10) == Result::Success);
+        auto fill2 = LinearGradient::gen();
+        REQUIRE(fill2->linear(0, 0, 100, 0) == Result::Success);
+        REQUIRE(fill2->colorStops(stops, 2) == Result::Success);
+        REQUIRE(shape2->strokeFill(fill2) == Result::Success);
+        REQUIRE(canvas->push(shape2) == Result::Success);
+
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE((buffer[25 * 100 + 50] >> 24) == 255);
+        REQUIRE((buffer[75 * 100 + 50] >> 24) == 255);
+
+        //Only the opacities are changed
+        REQUIRE(shape->opacity(127) == Result::Success);
+        REQUIRE(shape2->opacity(127) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE((buffer[25 * 100 + 50] >> 24) == 127);
+        REQUIRE((buffer[75 * 100 + 50] >> 24) == 127);
+
+        //Back to the opaque, the tables are reused
+        REQUIRE(shape->opacity(255) == Result::Success);
+        REQUIRE(shape2->opacity(255) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE((buffer[25 * 100 + 50] >> 24) == 255);
+        REQUIRE((buffer[75 * 100 + 50] >> 24) == 255);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Viewport Culling", "[tvgShape]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        //Out of the viewport
+        auto shape = Shape::gen();
+        REQUIRE(shape->appendRect(0, 0, 50, 50) == Result::Success);
+        REQUIRE(shape->fill(255, 0, 0, 255) == Result::Success);
+        REQUIRE(shape->translate(200, 0) == Result::Success);
+        REQUIRE(canvas->push(shape) == Result::Success);
+
+        //Only the stroke reaches the viewport
+        auto shape2 = Shape::gen();
+        REQUIRE(shape2->moveTo(0, -10) == Result::Success);
+        REQUIRE(shape2->lineTo(100, -10) == Result::Success);
+        REQUIRE(shape2->strokeWidth(40) == Result::Success);
+        REQUIRE(shape2->strokeFill(0, 0, 255, 255) == Result::Success);
+        REQUIRE(canvas->push(shape2) == Result::Success);
+
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[25 * 100 + 25] == 0);
+        REQUIRE(buffer[5 * 100 + 50] == 0xff0000ff);
+
+        //Back into the viewport
+        REQUIRE(shape->translate(0, 0) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[25 * 100 + 25] == 0xffff0000);
+
+        //Moved out again
+        REQUIRE(shape->translate(0, -100) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[25 * 100 + 25] == 0);
+
+        //The viewport follows the shape
+        REQUIRE(canvas->viewport(0, 0, 50, 50) == Result::Success);
+        REQUIRE(shape->translate(0, 0) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[25 * 100 + 25] == 0xffff0000);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Color Updates", "[tvgShape]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        auto shape = Shape::gen();
+        REQUIRE(shape->appendRect(10, 10, 60, 60) == Result::Success);
+        REQUIRE(shape->fill(255, 0, 0, 255) == Result::Success);
+        REQUIRE(shape->strokeWidth(4) == Result::Success);
+        REQUIRE(shape->strokeFill(0, 0, 255, 255) == Result::Success);
+        REQUIRE(canvas->push(shape) == Result::Success);
+
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[40 * 100 + 40] == 0xffff0000);
+        REQUIRE(buffer[10 * 100 + 40] == 0xff0000ff);
+
+        //The fill color only
+        REQUIRE(shape->fill(0, 255, 0, 255) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[40 * 100 + 40] == 0xff00ff00);
+        REQUIRE(buffer[10 * 100 + 40] == 0xff0000ff);
+
+        //The opacity only
+        REQUIRE(shape->opacity(0) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[40 * 100 + 40] == 0);
+        REQUIRE(buffer[10 * 100 + 40] == 0);
+
+        REQUIRE(shape->opacity(255) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[40 * 100 + 40] == 0xff00ff00);
+
+        REQUIRE(shape->opacity(128) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE((buffer[40 * 100 + 40] >> 24) == 128);
+        REQUIRE((buffer[10 * 100 + 40] >> 24) == 128);
+
+        //Turned into a gradient
+        auto fill = LinearGradient::gen();
+        Fill::ColorStop stops[2] = {{0, 0, 0, 255, 255}, {1, 0, 0, 255, 255}};
+        REQUIRE(fill->colorStops(stops, 2) == Result::Success);
+        REQUIRE(fill->linear(0, 0, 100, 0) == Result::Success);
+        REQUIRE(shape->fill(fill) == Result::Success);
+        REQUIRE(shape->opacity(255) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(buffer[40 * 100 + 40] == 0xff0000ff);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
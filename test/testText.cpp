@@ -164,4 +164,85 @@ TEST_CASE("Text with composite glyphs", "[tvgText]")
     Initializer::term();
 }
 
+TEST_CASE("Text with reused glyphs", "[tvgText]")
+{
+    Initializer::init(0);
+
+    REQUIRE(Text::load(TEST_DIR"/Arial.ttf") == tvg::Result::Success);
+
+    auto text = unique_ptr<Text>(Text::gen());
+    REQUIRE(text->font("Arial", 80) == tvg::Result::Success);
+
+    float x, y, w, h;
+    REQUIRE(text->text("0123") == tvg::Result::Success);
+    REQUIRE(text->bounds(&x, &y, &w, &h) == tvg::Result::Success);
+
+    //the same glyphs in another string and in another text with the shared font
+    REQUIRE(text->text("3210 3210") == tvg::Result::Success);
+    REQUIRE(text->text("0123") == tvg::Result::Success);
+
+    float x2, y2, w2, h2;
+    REQUIRE(text->bounds(&x2, &y2, &w2, &h2) == tvg::Result::Success);
+    REQUIRE(x == x2);
+    REQUIRE(y == y2);
+    REQUIRE(w == w2);
+    REQUIRE(h == h2);
+
+    auto text2 = unique_ptr<Text>(Text::gen());
+    REQUIRE(text2->font("Arial", 80) == tvg::Result::Success);
+    REQUIRE(text2->text("0123") == tvg::Result::Success);
+    REQUIRE(text2->bounds(&x2, &y2, &w2, &h2) == tvg::Result::Success);
+    REQUIRE(x == x2);
+    REQUIRE(y == y2);
+    REQUIRE(w == w2);
+    REQUIRE(h == h2);
+
+    REQUIRE(Text::unload(TEST_DIR"/Arial.ttf") == tvg::Result::Success);
+
+    Initializer::term();
+}
+
+TEST_CASE("Text Drawing in small sizes", "[tvgText]")
+{
+    Initializer::init(0);
+
+    auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+    REQUIRE(canvas);
+
+    uint32_t buffer[100*100];
+    REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+    REQUIRE(Text::load(TEST_DIR"/Arial.ttf") == tvg::Result::Success);
+
+    auto text = Text::gen();
+    REQUIRE(text);
+    REQUIRE(text->font("Arial", 12) == tvg::Result::Success);
+    REQUIRE(text->text("AVAWTo 1.1.1") == tvg::Result::Success);
+    REQUIRE(text->fill(255, 255, 255) == tvg::Result::Success);
+    REQUIRE(canvas->push(text) == Result::Success);
+
+    //the glyphs in the subpixel positions, partially out of the canvas
+    for (auto x : {-10.25f, 0.0f, 0.5f, 60.3f}) {
+        memset(buffer, 0, sizeof(buffer));
+        REQUIRE(text->translate(x, 40.6f) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+
+        auto drawn = false;
+        for (auto p : buffer) {
+            if (p) {
+                drawn = true;
+                break;
+            }
+        }
+        REQUIRE(drawn);
+    }
+
+    REQUIRE(canvas->remove() == Result::Success);
+    REQUIRE(Text::unload(TEST_DIR"/Arial.ttf") == tvg::Result::Success);
+
+    Initializer::term();
+}
+
 #endif
@@ -24,6 +24,9 @@
 #include <string.h>
 #include <vector>
 #include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
 #include <thorvg.h>
 #ifdef _WIN32
     #define WIN32_LEAN_AND_MEAN
@@ -51,10 +54,13 @@ private:
    uint32_t height = 600;
    uint8_t r, g, b;        //background color
    bool background = false;
+   int jobs = 1;           //concurrent conversions
+   vector<string> files;   //collected lottie files
+   mutex printer;
 
    void helpMsg()
    {
-      cout << "Usage: \n   tvg-lottie2gif [Lottie file] or [Lottie folder] [-r resolution] [-f fps] [-b background color]\n\nExamples: \n    $ tvg-lottie2gif input.json\n    $ tvg-lottie2gif input.json -r 600x600\n    $ tvg-lottie2gif input.json -f 30\n    $ tvg-lottie2gif input.json -r 600x600 -f 30\n    $ tvg-lottie2gif lottiefolder\n    $ tvg-lottie2gif lottiefolder -r 600x600 -f 30 -b fa7410\n\n";
+      cout << "Usage: \n   tvg-lottie2gif [Lottie file] or [Lottie folder] [-r resolution] [-f fps] [-b background color] [-j jobs]\n\nExamples: \n    $ tvg-lottie2gif input.json\n    $ tvg-lottie2gif input.json -r 600x600\n    $ tvg-lottie2gif input.json -f 30\n    $ tvg-lottie2gif input.json -r 600x600 -f 30\n    $ tvg-lottie2gif lottiefolder\n    $ tvg-lottie2gif lottiefolder -r 600x600 -f 30 -b fa7410\n    $ tvg-lottie2gif lottiefolder -r 600x600 -j 8\n\n";
    }
 
    bool validate(string& lottieName)
@@ -70,8 +76,6 @@ private:
 
    bool convert(string& in, string& out)
    {
-      if (Initializer::init(0) != Result::Success) return false;
-
       auto animation = Animation::gen();
       auto picture = animation->picture();
       if (picture->load(in.c_str()) != Result::Success) return false;
@@ -93,8 +97,6 @@ private:
       if (saver->save(animation, out.c_str(), 100, fps) != Result::Success) return false;
       if (saver->sync() != Result::Success) return false;
 
-      if (Initializer::term() != Result::Success) return false;
-
       return true;
    }
 
@@ -104,13 +106,44 @@ private:
       auto gifName = lottieName;
       gifName.replace(gifName.length() - 4, 4, "gif");
 
-      if (convert(lottieName, gifName)) {
+      auto ret = convert(lottieName, gifName);
+
+      lock_guard<mutex> lock(printer);
+      if (ret) {
          cout << "Generated Gif file : " << gifName << endl;
       } else {
          cout << "Failed Converting Gif file : " << lottieName << endl;
       }
    }
 
+   void convert()
+   {
+      if (files.empty()) return;
+
+      if (jobs > (int) files.size()) jobs = files.size();
+
+      if (Initializer::init(0) != Result::Success) {
+         cout << "Error: Engine is not supported" << endl;
+         return;
+      }
+
+      //Every job converts with its own animation and saver and picks the next file once done.
+      atomic<size_t> next{0};
+
+      auto run = [&]() {
+         for (auto idx = next++; idx < files.size(); idx = next++) {
+            convert(files[idx]);
+         }
+      };
+
+      vector<thread> workers;
+      for (int i = 1; i < jobs; ++i) workers.emplace_back(run);
+      run();
+      for (auto& worker : workers) worker.join();
+
+      Initializer::term();
+   }
+
    const char* realPath(const char* path)
    {
 #ifdef _WIN32
@@ -159,7 +192,7 @@ private:
                 lottieName = string(path);
                 lottieName += '\\';
                 lottieName += fd.cFileName;
-                convert(lottieName);
+                files.push_back(lottieName);
             }
         } while (FindNextFile(h, &fd));
 
@@ -187,7 +220,7 @@ private:
                 svgName = string(path);
                 svgName += '/';
                 svgName += entry->d_name;
-                convert(svgName);
+                files.push_back(svgName);
             }
         }
 #endif
@@ -239,6 +272,17 @@ public:
                g = (uint8_t)((bgColor & 0x00ff00) >> 8);
                b = (uint8_t)((bgColor & 0x0000ff));
                background = true;
+            } else if (p[1] == 'j') {
+               //concurrent jobs
+               if (!p_arg) {
+                  cout << "Error: Missing jobs count. Expected eg. -j 4." << endl;
+                  return 1;
+               }
+               jobs = atoi(p_arg);
+               if (jobs <= 0) {
+                  cout << "Error: Jobs count (" << p_arg << ") is corrupted. Expected eg. -j 4." << endl;
+                  return 1;
+               }
             } else {
                cout << "Warning: Unknown flag (" << p << ")." << endl;
             }
@@ -269,9 +313,12 @@ public:
          else {
             string lottieName(input);
             if (!validate(lottieName)) continue;
-            convert(lottieName);
+            files.push_back(lottieName);
          }
       }
+
+      convert();
+
       return 0;
    }
 };
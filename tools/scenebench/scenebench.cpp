@@ -0,0 +1,574 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <thorvg.h>
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+    #ifndef PATH_MAX
+        #define PATH_MAX MAX_PATH
+    #endif
+#else
+    #include <dirent.h>
+    #include <unistd.h>
+    #include <limits.h>
+    #include <sys/stat.h>
+    #include <sys/resource.h>
+#endif
+
+using namespace std;
+using namespace tvg;
+
+
+struct Resolution
+{
+    uint32_t w, h;
+};
+
+struct Record
+{
+    string name;
+    Resolution resolution;
+    uint32_t threads;
+    uint32_t frames;
+    double first;           //time-to-first-frame: load + update + draw (ms)
+    double load, update, draw;  //the stages of the first frame, the fastest among the cold repeats (ms)
+    double p50, p95, p99;   //warm frame times (ms)
+    long peak;              //peak resident memory of the process so far (KB)
+    long memory;            //memory held by the engine after the first frame (KB), 0 without the memory statistics
+};
+
+
+//the stable measurements compared with the baseline, the tail latencies are too noisy for it
+static constexpr struct
+{
+    const char* key;
+    double floor;           //the differences below this are regarded as the noise
+} metrics[] = {
+    {"load", 0.05}, {"update", 0.05}, {"draw", 0.05}, {"p50", 0.05}, {"memory_kb", 64}
+};
+
+static double metric(const Record& record, int idx)
+{
+    switch (idx) {
+        case 0: return record.load;
+        case 1: return record.update;
+        case 2: return record.draw;
+        case 3: return record.p50;
+        default: return double(record.memory);
+    }
+}
+
+
+struct App
+{
+private:
+    char full[PATH_MAX];                //full path
+    vector<string> files;               //the collected assets
+    vector<Resolution> resolutions = {{512, 512}};
+    vector<uint32_t> threads = {0};
+    vector<Record> records;
+    vector<uint32_t> buffer;
+    uint32_t frames = 60;               //warm frames per asset
+    uint32_t repeats = 1;               //cold loads per asset
+    const char* output = nullptr;       //json report
+    const char* baseline = nullptr;     //json report to compare with
+    float tolerance = 10.0f;            //allowed slowdown to the baseline (%)
+
+    void helpMsg()
+    {
+        cout << "Usage: \n   tvg-scenebench [SVG/Lottie file] or [folder] [-r resolutions] [-t threads] [-n frames] [-c cold repeats] [-o json] [-b baseline json] [-x tolerance %]\n\nExamples: \n    $ tvg-scenebench input.svg\n    $ tvg-scenebench lottiefolder -r 256x256,1024x1024\n    $ tvg-scenebench resources -t 0,4,8 -n 120\n    $ tvg-scenebench resources -o report.json\n    $ tvg-scenebench resources -c 5 -b report.json -x 20\n\n";
+    }
+
+    static double now()
+    {
+        return chrono::duration<double, milli>(chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static long peakMemory()
+    {
+#ifdef _WIN32
+        return 0;
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    #ifdef __APPLE__
+        return usage.ru_maxrss / 1024;
+    #else
+        return usage.ru_maxrss;
+    #endif
+#endif
+    }
+
+    static long engineMemory()
+    {
+        size_t total = 0;
+        for (auto category : {MemoryCategory::Common, MemoryCategory::Loader, MemoryCategory::Engine, MemoryCategory::Compositor}) {
+            size_t bytes;
+            if (Initializer::memory(category, &bytes) != Result::Success) return 0;
+            total += bytes;
+        }
+        return long(total / 1024);
+    }
+
+    static double percentile(const vector<double>& sorted, float p)
+    {
+        if (sorted.empty()) return 0.0;
+        auto idx = static_cast<size_t>(p * (sorted.size() - 1) + 0.5f);
+        return sorted[std::min(idx, sorted.size() - 1)];
+    }
+
+    bool validate(const string& name)
+    {
+        auto extn = [&](const char* ext) {
+            auto len = strlen(ext);
+            return name.size() > len && name.compare(name.size() - len, len, ext) == 0;
+        };
+        return extn(".svg") || extn(".json") || extn(".lot");
+    }
+
+    //the canvas draws the picture fitted to the resolution, the animations run through their frames
+    bool measure(const string& path, const Resolution& res, uint32_t threadCnt, Record& record)
+    {
+        buffer.resize(res.w * res.h);
+
+        SwCanvas* canvas = nullptr;
+        Animation* animation = nullptr;
+        Picture* picture = nullptr;
+
+        //cold: load and the first frame, the last one is kept for the warm frames
+        for (uint32_t i = 0; i < repeats; ++i) {
+            if (canvas) {
+                delete(canvas);
+                picture->unref();
+                delete(animation);
+            }
+
+            canvas = SwCanvas::gen();
+            if (!canvas) return false;
+            animation = Animation::gen();
+            picture = animation->picture();
+            picture->ref();  //kept among the warm frames
+
+            auto begin = now();
+
+            if (canvas->target(buffer.data(), res.w, res.w, res.h, ColorSpace::ARGB8888) != Result::Success || picture->load(path.c_str()) != Result::Success) {
+                delete(canvas);
+                picture->unref();
+                delete(animation);
+                return false;
+            }
+
+            float w, h;
+            picture->size(&w, &h);
+            auto scale = std::min(res.w / w, res.h / h);
+            picture->size(w * scale, h * scale);
+
+            auto loaded = now();
+
+            //the deferred loading, such as the svg body, is done in the update
+            canvas->push(picture);
+            canvas->update();
+
+            auto updated = now();
+
+            canvas->draw(false);
+            canvas->sync();
+
+            auto drawn = now();
+
+            if (i == 0 || drawn - begin < record.first) record.first = drawn - begin;
+            if (i == 0 || loaded - begin < record.load) record.load = loaded - begin;
+            if (i == 0 || updated - loaded < record.update) record.update = updated - loaded;
+            if (i == 0 || drawn - updated < record.draw) record.draw = drawn - updated;
+        }
+
+        record.memory = engineMemory();
+
+        //warm: the following frames
+        auto totalFrame = animation->totalFrame();
+        vector<double> samples;
+        samples.reserve(frames);
+
+        for (uint32_t i = 0; i < frames; ++i) {
+            auto t = now();
+            if (totalFrame > 0.0f) {
+                animation->frame(fmodf(float(i + 1), totalFrame));
+                canvas->update();
+            } else {
+                //static contents are prepared again from the scratch
+                canvas->remove(picture);
+                canvas->push(picture);
+            }
+            canvas->draw(true);
+            canvas->sync();
+            samples.push_back(now() - t);
+        }
+
+        sort(samples.begin(), samples.end());
+
+        record.name = path;
+        record.resolution = res;
+        record.threads = threadCnt;
+        record.frames = frames;
+        record.p50 = percentile(samples, 0.50f);
+        record.p95 = percentile(samples, 0.95f);
+        record.p99 = percentile(samples, 0.99f);
+        record.peak = peakMemory();
+
+        delete(canvas);
+        picture->unref();
+        delete(animation);
+
+        return true;
+    }
+
+    void run()
+    {
+        for (auto threadCnt : threads) {
+            if (Initializer::init(threadCnt) != Result::Success) {
+                cout << "Error: Engine initialization failed with " << threadCnt << " threads." << endl;
+                continue;
+            }
+            for (auto& res : resolutions) {
+                for (auto& file : files) {
+                    Record record;
+                    if (measure(file, res, threadCnt, record)) {
+                        printf("%-48s %5ux%-5u t%-2u first %8.2fms (load %.2f update %.2f draw %.2f)  p50 %7.2fms  p95 %7.2fms  p99 %7.2fms  peak %ldKB\n",
+                               file.c_str(), res.w, res.h, threadCnt, record.first, record.load, record.update, record.draw, record.p50, record.p95, record.p99, record.peak);
+                        records.push_back(record);
+                    } else {
+                        cout << "Failed measuring : " << file << endl;
+                    }
+                }
+            }
+            Initializer::term();
+        }
+    }
+
+    bool report()
+    {
+        auto out = fopen(output, "w");
+        if (!out) {
+            cout << "Error: Couldn't open \"" << output << "\"." << endl;
+            return false;
+        }
+
+        fprintf(out, "{\n  \"engine\": \"sw\",\n  \"frames\": %u,\n  \"results\": [\n", frames);
+        for (size_t i = 0; i < records.size(); ++i) {
+            auto& r = records[i];
+            string name;
+            for (auto c : r.name) {
+                if (c == '"' || c == '\\') name += '\\';
+                name += c;
+            }
+            fprintf(out, "    {\"file\": \"%s\", \"width\": %u, \"height\": %u, \"threads\": %u, \"first\": %.3f, \"load\": %.3f, \"update\": %.3f, \"draw\": %.3f, \"p50\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"peak_kb\": %ld, \"memory_kb\": %ld}%s\n",
+                    name.c_str(), r.resolution.w, r.resolution.h, r.threads, r.first, r.load, r.update, r.draw, r.p50, r.p95, r.p99, r.peak, r.memory, (i + 1 < records.size()) ? "," : "");
+        }
+        fprintf(out, "  ]\n}\n");
+        fclose(out);
+
+        cout << "Generated report : " << output << endl;
+        return true;
+    }
+
+    static bool number(const string& line, const char* key, double& value)
+    {
+        auto pos = line.find(string("\"") + key + "\": ");
+        if (pos == string::npos) return false;
+        value = strtod(line.c_str() + pos + strlen(key) + 4, nullptr);
+        return true;
+    }
+
+    static string basename(const string& path)
+    {
+        auto pos = path.find_last_of("/\\");
+        return (pos == string::npos) ? path : path.substr(pos + 1);
+    }
+
+    //the results of the report are matched by the file names, so that a report from another location can be compared
+    bool compare()
+    {
+        auto in = fopen(baseline, "r");
+        if (!in) {
+            cout << "Error: Couldn't open \"" << baseline << "\"." << endl;
+            return false;
+        }
+
+        vector<Record> bases;
+        char buf[PATH_MAX + 512];
+        while (fgets(buf, sizeof(buf), in)) {
+            string line(buf);
+            auto begin = line.find("\"file\": \"");
+            if (begin == string::npos) continue;
+            Record r{};
+            for (auto i = begin + 9; i < line.size() && line[i] != '"'; ++i) {
+                if (line[i] == '\\') ++i;
+                r.name += line[i];
+            }
+            double w = 0, h = 0, threads = 0, memory = 0;
+            number(line, "width", w);
+            number(line, "height", h);
+            number(line, "threads", threads);
+            number(line, "load", r.load);
+            number(line, "update", r.update);
+            number(line, "draw", r.draw);
+            number(line, "p50", r.p50);
+            number(line, "memory_kb", memory);
+            r.name = basename(r.name);
+            r.resolution = {uint32_t(w), uint32_t(h)};
+            r.threads = uint32_t(threads);
+            r.memory = long(memory);
+            bases.push_back(r);
+        }
+        fclose(in);
+
+        uint32_t compared = 0, regressed = 0;
+        for (auto& r : records) {
+            auto name = basename(r.name);
+            for (auto& b : bases) {
+                if (b.name != name || b.resolution.w != r.resolution.w || b.resolution.h != r.resolution.h || b.threads != r.threads) continue;
+                for (int i = 0; i < int(sizeof(metrics) / sizeof(metrics[0])); ++i) {
+                    auto before = metric(b, i);
+                    auto after = metric(r, i);
+                    //the memory is unknown without the statistics, the older reports miss the new metrics
+                    if (before <= 0.0 || after <= 0.0) continue;
+                    if (after - before <= metrics[i].floor || after <= before * (1.0 + tolerance * 0.01)) continue;
+                    printf("Regression: %s %ux%u t%u %s %.3f -> %.3f (+%.1f%%)\n", name.c_str(), r.resolution.w, r.resolution.h, r.threads, metrics[i].key, before, after, (after / before - 1.0) * 100.0);
+                    ++regressed;
+                }
+                ++compared;
+                break;
+            }
+        }
+
+        cout << "Compared " << compared << " results with the baseline : " << regressed << " regressions beyond " << tolerance << "%." << endl;
+        return regressed == 0;
+    }
+
+    const char* realPath(const char* path)
+    {
+#ifdef _WIN32
+        return _fullpath(full, path, PATH_MAX);
+#else
+        return realpath(path, full);
+#endif
+    }
+
+    bool isDirectory(const char* path)
+    {
+#ifdef _WIN32
+        DWORD attr = GetFileAttributes(path);
+        if (attr == INVALID_FILE_ATTRIBUTES) return false;
+        return attr & FILE_ATTRIBUTE_DIRECTORY;
+#else
+        struct stat buf;
+        if (stat(path, &buf) != 0) return false;
+        return S_ISDIR(buf.st_mode);
+#endif
+    }
+
+    bool handleDirectory(const string& path)
+    {
+#ifdef _WIN32
+        //open directory
+        WIN32_FIND_DATA fd;
+        HANDLE h = FindFirstFileEx((path + "\\*").c_str(), FindExInfoBasic, &fd, FindExSearchNameMatch, NULL, 0);
+        if (h == INVALID_HANDLE_VALUE) {
+            cout << "Couldn't open directory \"" << path.c_str() << "\"." << endl;
+            return false;
+        }
+        //List directories
+        do {
+            if (*fd.cFileName == '.' || *fd.cFileName == '$') continue;
+            string name = path + '\\' + fd.cFileName;
+            //sub directory
+            if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) handleDirectory(name);
+            //file
+            else if (validate(name)) files.push_back(name);
+        } while (FindNextFile(h, &fd));
+
+        FindClose(h);
+#else
+        //open directory
+        auto dir = opendir(path.c_str());
+        if (!dir) {
+            cout << "Couldn't open directory \"" << path.c_str() << "\"." << endl;
+            return false;
+        }
+        //List directories
+        while (auto entry = readdir(dir)) {
+            if (*entry->d_name == '.' || *entry->d_name == '$') continue;
+            string name = path + '/' + entry->d_name;
+            //sub directory
+            if (entry->d_type == DT_DIR) handleDirectory(name);
+            //file
+            else if (validate(name)) files.push_back(name);
+        }
+        closedir(dir);
+#endif
+        return true;
+    }
+
+    template<typename T, typename F>
+    bool parseList(const char* arg, vector<T>& list, F parse)
+    {
+        list.clear();
+        string str(arg);
+        size_t begin = 0;
+        while (begin <= str.size()) {
+            auto end = str.find(',', begin);
+            if (end == string::npos) end = str.size();
+            T value;
+            if (!parse(str.substr(begin, end - begin).c_str(), value)) return false;
+            list.push_back(value);
+            begin = end + 1;
+        }
+        return !list.empty();
+    }
+
+public:
+    int setup(int argc, char** argv)
+    {
+        //Collect input files
+        vector<const char*> inputs;
+
+        for (int i = 1; i < argc; ++i) {
+            const char* p = argv[i];
+            if (*p == '-') {
+                const char* p_arg = (i + 1 < argc) ? argv[++i] : nullptr;
+                if (!p_arg) {
+                    cout << "Error: Missing the value of (" << p << ")." << endl;
+                    return 1;
+                }
+                //resolutions
+                if (p[1] == 'r') {
+                    auto ret = parseList(p_arg, resolutions, [](const char* s, Resolution& res) {
+                        auto x = strchr(s, 'x');
+                        if (!x) return false;
+                        auto w = atoi(s), h = atoi(x + 1);
+                        if (w <= 0 || h <= 0) return false;
+                        res = {uint32_t(w), uint32_t(h)};
+                        return true;
+                    });
+                    if (!ret) {
+                        cout << "Error: Resolutions (" << p_arg << ") are corrupted. Expected eg. -r 256x256,1024x1024." << endl;
+                        return 1;
+                    }
+                //thread counts
+                } else if (p[1] == 't') {
+                    auto ret = parseList(p_arg, threads, [](const char* s, uint32_t& cnt) {
+                        auto v = atoi(s);
+                        if (v < 0) return false;
+                        cnt = uint32_t(v);
+                        return true;
+                    });
+                    if (!ret) {
+                        cout << "Error: Thread counts (" << p_arg << ") are corrupted. Expected eg. -t 0,4." << endl;
+                        return 1;
+                    }
+                //warm frames
+                } else if (p[1] == 'n') {
+                    auto v = atoi(p_arg);
+                    if (v <= 0) {
+                        cout << "Error: Frame count (" << p_arg << ") is corrupted. Expected eg. -n 60." << endl;
+                        return 1;
+                    }
+                    frames = uint32_t(v);
+                //cold repeats
+                } else if (p[1] == 'c') {
+                    auto v = atoi(p_arg);
+                    if (v <= 0) {
+                        cout << "Error: Repeat count (" << p_arg << ") is corrupted. Expected eg. -c 5." << endl;
+                        return 1;
+                    }
+                    repeats = uint32_t(v);
+                //json report
+                } else if (p[1] == 'o') {
+                    output = p_arg;
+                //baseline report
+                } else if (p[1] == 'b') {
+                    baseline = p_arg;
+                //tolerance
+                } else if (p[1] == 'x') {
+                    auto v = atof(p_arg);
+                    if (v < 0.0) {
+                        cout << "Error: Tolerance (" << p_arg << ") is corrupted. Expected eg. -x 10." << endl;
+                        return 1;
+                    }
+                    tolerance = float(v);
+                } else {
+                    cout << "Warning: Unknown flag (" << p << ")." << endl;
+                }
+            } else {
+                inputs.push_back(argv[i]);
+            }
+        }
+
+        //No Input
+        if (inputs.empty()) {
+            helpMsg();
+            return 0;
+        }
+
+        for (auto input : inputs) {
+            auto path = realPath(input);
+            if (!path) {
+                cout << "Invalid file or path name: \"" << input << "\"" << endl;
+                continue;
+            }
+            if (isDirectory(path)) handleDirectory(path);
+            else if (validate(path)) files.push_back(path);
+        }
+
+        if (files.empty()) {
+            cout << "Error: No SVG/Lottie files found." << endl;
+            return 1;
+        }
+
+        sort(files.begin(), files.end());
+
+        run();
+
+        if (output && !report()) return 1;
+
+        //the regressions beyond the tolerance fail the run
+        if (baseline && !compare()) return 2;
+
+        return 0;
+    }
+};
+
+
+int main(int argc, char **argv)
+{
+    App app;
+    return app.setup(argc, argv);
+}
@@ -22,6 +22,8 @@
 
 #include <iostream>
 #include <thread>
+#include <mutex>
+#include <atomic>
 #include <thorvg.h>
 #include <vector>
 #ifdef _WIN32
@@ -44,11 +46,28 @@
 
 using namespace std;
 
+//Serialize the messages of the concurrent jobs
+static mutex printer;
+
+static void print(const string& msg)
+{
+    lock_guard<mutex> lock(printer);
+    cout << msg << endl;
+}
+
 struct PngBuilder
 {
+    ~PngBuilder()
+    {
+        sync();
+    }
+
     void build(const string& fileName, const uint32_t width, const uint32_t height, uint32_t* buffer)
     {
-        //Used ARGB8888 so have to move pixels now
+        //Only one encoding in flight per renderer
+        sync();
+
+        //Used ARGB8888 so have to move pixels now. This copy frees the canvas buffer for the next file.
         vector<unsigned char> image;
         image.resize(width * height * 4);
         for (unsigned y = 0; y < height; y++) {
@@ -61,11 +80,23 @@ struct PngBuilder
             }
         }
 
-        unsigned error = lodepng::encode(fileName, image, width, height);
+        //Encode in the background while the next file is rendered
+        encoder = thread([fileName, width, height](vector<unsigned char> image) {
+            unsigned error = lodepng::encode(fileName, image, width, height);
+
+            //if there's an error, display it
+            if (error) print("encoder error " + to_string(error) + ": " + lodepng_error_text(error));
+            else print("Generated PNG file: " + fileName);
+        }, std::move(image));
+    }
 
-        //if there's an error, display it
-        if (error) cout << "encoder error " << error << ": " << lodepng_error_text(error) << endl;
+    void sync()
+    {
+        if (encoder.joinable()) encoder.join();
     }
+
+private:
+    thread encoder;
 };
 
 struct Renderer
@@ -74,9 +105,9 @@ public:
     int render(const char* path, int w, int h, const string& dst, uint32_t bgColor)
     {
         //Canvas
-        if (!canvas) createCanvas();
+        if (!canvas) canvas = unique_ptr<tvg::SwCanvas>(tvg::SwCanvas::gen());
         if (!canvas) {
-            cout << "Error: Canvas failure" << endl;
+            print("Error: Canvas failure");
             return 1;
         }
 
@@ -84,13 +115,13 @@ public:
         auto picture = tvg::Picture::gen();
         tvg::Result result = picture->load(path);
         if (result == tvg::Result::Unknown) {
-            cout << "Error: Couldn't load image " << path << endl;
+            print("Error: Couldn't load image " + string(path));
             return 1;
         } else if (result == tvg::Result::InvalidArguments) {
-            cout << "Error: Couldn't load image(Invalid path or invalid SVG image) : " << path << endl;
+            print("Error: Couldn't load image(Invalid path or invalid SVG image) : " + string(path));
             return 1;
         } else if (result == tvg::Result::NonSupport) {
-            cout << "Error: Couldn't load image(Not supported extension) : " << path << endl;
+            print("Error: Couldn't load image(Not supported extension) : " + string(path));
             return 1;
         }
 
@@ -111,8 +142,8 @@ public:
                     h = HEIGHT_8K;
                     w = static_cast<uint32_t>(h * scale);
                 }
-                cout << "Warning: The SVG width and/or height values exceed the 8k resolution. "
-                        "To avoid the heap overflow, the conversion to the PNG file made in " << w << " x " << h << " resolution." << endl;
+                print("Warning: The SVG width and/or height values exceed the 8k resolution. "
+                      "To avoid the heap overflow, the conversion to the PNG file made in " + to_string(w) + " x " + to_string(h) + " resolution.");
                 picture->size(static_cast<float>(w), static_cast<float>(h));
             }
         } else {
@@ -122,12 +153,12 @@ public:
         //Buffer
         createBuffer(w, h);
         if (!buffer) {
-            cout << "Error: Buffer failure" << endl;
+            print("Error: Buffer failure");
             return 1;
         }
 
         if (canvas->target(buffer, w, w, h, tvg::ColorSpace::ARGB8888S) != tvg::Result::Success) {
-            cout << "Error: Canvas target failure" << endl;
+            print("Error: Canvas target failure");
             return 1;
         }
 
@@ -149,37 +180,24 @@ public:
         canvas->draw(true);
         canvas->sync();
 
+        //The canvas is reused by the next file of this job
+        canvas->remove();
+
         //Build Png
-        PngBuilder builder;
         builder.build(dst, w, h, buffer);
 
-        cout << "Generated PNG file: " << dst << endl;
-
         return 0;
     }
 
     void terminate()
     {
-        tvg::Initializer::term();
+        builder.sync();
+        canvas = nullptr;
         free(buffer);
+        buffer = nullptr;
     }
 
 private:
-    void createCanvas()
-    {
-        //Threads Count
-        auto threads = thread::hardware_concurrency();
-        if (threads > 0) --threads; 
-
-        //Initialize ThorVG Engine
-        if (tvg::Initializer::init(threads) != tvg::Result::Success) {
-            cout << "Error: Engine is not supported" << endl;
-        }
-
-        //Create a Canvas
-        canvas = unique_ptr<tvg::SwCanvas>(tvg::SwCanvas::gen());
-    }
-
     void createBuffer(int w, int h)
     {
         uint32_t size = w * h;
@@ -192,6 +210,7 @@ private:
     }
 
 private:
+    PngBuilder builder;
     unique_ptr<tvg::SwCanvas> canvas = nullptr;
     uint32_t* buffer = nullptr;
     uint32_t bufferSize = 0;
@@ -235,6 +254,19 @@ public:
 
                     bgColor = (uint32_t) strtol(p_arg, NULL, 16);
 
+                } else if (p[1] == 'j') {
+                    //concurrent jobs
+                    if (!p_arg) {
+                        cout << "Error: Missing jobs count. Expected eg. -j 4." << endl;
+                        return 1;
+                    }
+
+                    jobs = atoi(p_arg);
+                    if (jobs <= 0) {
+                        cout << "Error: Jobs count (" << p_arg << ") is corrupted. Expected eg. -j 4." << endl;
+                        return 1;
+                    }
+
                 } else {
                     cout << "Warning: Unknown flag (" << p << ")." << endl;
                 }
@@ -260,7 +292,7 @@ public:
 
                     } else if (svgFile(path)) {
                         //load single file
-                        if ((ret = renderFile(real_path))) break;
+                        files.push_back(real_path);
                     } else {
                         //not a directory and not .svg file
                         cout << "Error: File \"" << path << "\" is not a proper svg file." << endl;
@@ -272,23 +304,23 @@ public:
             }
         }
 
-        //Terminate renderer
-        renderer.terminate();
+        if (!ret) ret = convert();
 
         return ret;
     }
 
 private:
-    Renderer renderer;
+    vector<string> files;
     uint32_t bgColor = 0xffffffff;
     uint32_t width = 0;
     uint32_t height = 0;
+    int jobs = 1;
     char full[PATH_MAX];
 
 private:
     int help()
     {
-        cout << "Usage:\n   tvg-svg2png [SVG file] or [SVG folder] [-r resolution] [-b bgColor]\n\nFlags:\n    -r set the output image resolution.\n    -b set the output image background color.\n\nExamples:\n    $ tvg-svg2png input.svg\n    $ tvg-svg2png input.svg -r 200x200\n    $ tvg-svg2png input.svg -r 200x200 -b ff00ff\n    $ tvg-svg2png input1.svg input2.svg -r 200x200 -b ff00ff\n    $ tvg-svg2png . -r 200x200\n\nNote:\n    In the case, where the width and height in the SVG file determine the size of the image in resolution higher than 8k (7680 x 4320), limiting the resolution to this value is enforced.\n\n";
+        cout << "Usage:\n   tvg-svg2png [SVG file] or [SVG folder] [-r resolution] [-b bgColor] [-j jobs]\n\nFlags:\n    -r set the output image resolution.\n    -b set the output image background color.\n    -j set the number of files converted concurrently.\n\nExamples:\n    $ tvg-svg2png input.svg\n    $ tvg-svg2png input.svg -r 200x200\n    $ tvg-svg2png input.svg -r 200x200 -b ff00ff\n    $ tvg-svg2png input1.svg input2.svg -r 200x200 -b ff00ff\n    $ tvg-svg2png . -r 200x200\n    $ tvg-svg2png . -r 200x200 -j 8\n\nNote:\n    In the case, where the width and height in the SVG file determine the size of the image in resolution higher than 8k (7680 x 4320), limiting the resolution to this value is enforced.\n\n";
         return 1;
     }
 
@@ -328,17 +360,54 @@ private:
 #endif
     }
 
-    int renderFile(const char* path)
+    int renderFile(Renderer& renderer, const string& path)
     {
-        if (!path) return 1;
-
         //destination png file
-        const char* dot = strrchr(path, '.');
-        if (!dot) return 1;
-        string dst(path, dot - path);
-        dst += ".png";
+        auto dot = path.rfind('.');
+        if (dot == string::npos) return 1;
+        string dst = path.substr(0, dot) + ".png";
 
-        return renderer.render(path, width, height, dst, bgColor);
+        return renderer.render(path.c_str(), width, height, dst, bgColor);
+    }
+
+    int convert()
+    {
+        if (files.empty()) return 0;
+
+        if (jobs > (int) files.size()) jobs = files.size();
+
+        //Threads Count, the jobs share the cores with the engine workers
+        int threads = (int) thread::hardware_concurrency() - jobs;
+        if (threads < 0) threads = 0;
+
+        //Initialize ThorVG Engine
+        if (tvg::Initializer::init(threads) != tvg::Result::Success) {
+            cout << "Error: Engine is not supported" << endl;
+            return 1;
+        }
+
+        //Every job owns its canvas, buffer and png encoder and picks the next file once done.
+        atomic<size_t> next{0};
+        atomic<int> ret{0};
+
+        auto run = [&]() {
+            Renderer renderer;
+            while (!ret) {
+                auto idx = next++;
+                if (idx >= files.size()) break;
+                if (renderFile(renderer, files[idx])) ret = 1;
+            }
+            renderer.terminate();
+        };
+
+        vector<thread> workers;
+        for (int i = 1; i < jobs; ++i) workers.emplace_back(run);
+        run();
+        for (auto& worker : workers) worker.join();
+
+        tvg::Initializer::term();
+
+        return ret;
     }
 
     int handleDirectory(const string& path)
@@ -366,8 +435,7 @@ private:
                 string fullpath = string(path);
                 fullpath += '\\';
                 fullpath += fd.cFileName;
-                ret = renderFile(fullpath.c_str());
-                if (ret) break;
+                files.push_back(fullpath);
             }
         } while (FindNextFile(h, &fd));
 
@@ -396,8 +464,7 @@ private:
                 string fullpath = string(path);
                 fullpath += '/';
                 fullpath += entry->d_name;
-                ret = renderFile(fullpath.c_str());
-                if (ret) break;
+                files.push_back(fullpath);
             }
         }
         closedir(dir);
@@ -17,6 +17,10 @@ if [ ! -d "./build_wasm" ]; then
     elif [[ "$BACKEND" == "sw" ]]; then
       sed "s|EMSDK:|$EMSDK|g" ./cross/wasm32_sw.txt > /tmp/.wasm_cross.txt
       meson setup -Db_lto=true -Ddefault_library=static -Dstatic=true -Dloaders="all" -Dsavers="all" -Dthreads=false -Dbindings="wasm_beta" -Dpartial=false --cross-file /tmp/.wasm_cross.txt build_wasm
+    elif [[ "$BACKEND" == "sw_mt" ]]; then
+      #the multi-threaded, simd128 variant requires the cross-origin isolation(SharedArrayBuffer) on the hosting page
+      sed "s|EMSDK:|$EMSDK|g" ./cross/wasm32_sw_mt.txt > /tmp/.wasm_cross.txt
+      meson setup -Db_lto=true -Ddefault_library=static -Dstatic=true -Dloaders="all" -Dsavers="all" -Dthreads=true -Dsimd=true -Dbindings="wasm_beta" -Dpartial=false --cross-file /tmp/.wasm_cross.txt build_wasm
     elif [[ "$BACKEND" == "gl" ]]; then
       sed "s|EMSDK:|$EMSDK|g" ./cross/wasm32_gl.txt > /tmp/.wasm_cross.txt
       meson setup -Db_lto=true -Ddefault_library=static -Dstatic=true -Dloaders="all" -Dsavers="all" -Dthreads=false -Dbindings="wasm_beta" -Dpartial=false -Dengines="gl" --cross-file /tmp/.wasm_cross.txt build_wasm